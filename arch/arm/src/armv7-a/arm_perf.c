@@ -27,6 +27,8 @@
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
 
+#include <errno.h>
+
 #include "arm_internal.h"
 #include "arm_timer.h"
 #include "sctlr.h"
@@ -98,3 +100,76 @@ void up_perf_convert(clock_t elapsed, struct timespec *ts)
   ts->tv_nsec = NSEC_PER_SEC * (uint64_t)left / g_cpu_freq;
 }
 #endif
+
+#ifdef CONFIG_ARCH_HAVE_PMU
+
+/* The ARMv7 common event numbers of the PMU_EVENT_*, the stall events are
+ * implementation defined on ARMv7 and not offered.
+ */
+
+static int pmu_event_number(int event)
+{
+  switch (event)
+    {
+      case PMU_EVENT_CYCLES:
+        return 0x11;                   /* CPU_CYCLES */
+      case PMU_EVENT_INSTRUCTIONS:
+        return 0x08;                   /* INST_RETIRED */
+      case PMU_EVENT_CACHE_MISSES:
+        return 0x03;                   /* L1D_CACHE_REFILL */
+      case PMU_EVENT_BRANCH_MISSES:
+        return 0x10;                   /* BR_MIS_PRED */
+      default:
+        return -ENOTSUP;
+    }
+}
+
+/****************************************************************************
+ * Name: up_pmu_*
+ *
+ * Description:
+ *   The event counters of the calling core, see include/nuttx/arch.h.
+ *
+ ****************************************************************************/
+
+int up_pmu_ncounters(void)
+{
+  return (cp15_pmu_rdpmcr() & PMCR_N_MASK) >> PMCR_N_SHIFT;
+}
+
+int up_pmu_start(int counter, int event)
+{
+  int number;
+
+  if (counter < 0 || counter >= up_pmu_ncounters())
+    {
+      return -EINVAL;
+    }
+
+  number = pmu_event_number(event);
+  if (number < 0 || (CP15_GET(PMCEID0) & (1 << number)) == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  cp15_pmu_wrcecr(1 << counter);
+  cp15_pmu_wriecr(1 << counter);
+  cp15_pmu_wrecsr(counter);
+  cp15_pmu_wretsr(number);
+  cp15_pmu_pmcr(PMCR_E);
+  cp15_pmu_cesr(1 << counter);
+
+  return 32;
+}
+
+void up_pmu_stop(int counter)
+{
+  cp15_pmu_wrcecr(1 << counter);
+}
+
+uint64_t up_pmu_read(int counter)
+{
+  cp15_pmu_wrecsr(counter);
+  return cp15_pmu_rdecr();
+}
+#endif
@@ -99,6 +99,12 @@ struct arch_addrenv_s
   /* The page directory root (ttbr0) value */
 
   uintptr_t ttbr0;
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+  /* The ASID and its generation, zero until the first selection */
+
+  uint64_t  asid;
+#endif
 };
 
 typedef struct arch_addrenv_s arch_addrenv_t;
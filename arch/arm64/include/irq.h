@@ -213,6 +213,13 @@
 #define REG_FPSR            (0)
 #define REG_FPCR            (1)
 
+/* 64 bit register after fpsr/fpcr: CPACR_EL1.FPEN of the context with
+ * CONFIG_ARCH_LAZYFPU, zero if it has not used the FPU and nothing was
+ * saved.
+ */
+
+#define REG_FPU_TRAP        (65)
+
 /* FPU registers(Q0~Q31, 128bit): 32x2 = 64
  * FPU FPSR/SPSR(32 bit) : 1
  * FPU TRAP: 1
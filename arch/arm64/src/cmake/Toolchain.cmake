@@ -26,7 +26,11 @@ set(CMAKE_C_COMPILER_FORCED TRUE)
 set(CMAKE_CXX_COMPILER_FORCED TRUE)
 
 if(CONFIG_ARCH_ARMV8A)
-  add_compile_options(-march=armv8-a)
+  if(CONFIG_ARCH_HAVE_CRC32)
+    add_compile_options(-march=armv8-a+crc)
+  else()
+    add_compile_options(-march=armv8-a)
+  endif()
 elseif(CONFIG_ARCH_ARMV8R)
   if(CONFIG_ARCH_FPU)
     add_compile_options(-march=armv8-r)
@@ -109,6 +109,22 @@ uintptr_t arm64_get_pgtable(arch_addrenv_t *addrenv, uintptr_t vaddr);
 int arm64_map_pages(arch_addrenv_t *addrenv, uintptr_t *pages,
                     unsigned int npages, uintptr_t vaddr, uint64_t prot);
 
+/****************************************************************************
+ * Name: arm64_asid_select
+ *
+ * Description:
+ *   Switch TTBR0 to the address environment, tagged with its ASID instead
+ *   of flushing the TLB.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment to select.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+void arm64_asid_select(arch_addrenv_t *addrenv);
+#endif
+
 /****************************************************************************
  * Name: arm64_unmap_pages
  *
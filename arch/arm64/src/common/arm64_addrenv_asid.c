@@ -0,0 +1,259 @@
+/****************************************************************************
+ * arch/arm64/src/common/arm64_addrenv_asid.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include <arch/barriers.h>
+
+#include "addrenv.h"
+#include "arm64_mmu.h"
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* TCR_EL1.AS selects 8 bit ASIDs, see arm64_mmu.c.  ASID 0 is never given
+ * out, it tags the boot page tables.  The bits above the ASID of
+ * arch_addrenv_t's asid count the generations.
+ */
+
+#define ARM64_ASID_BITS       8
+#define ARM64_NASIDS          (1 << ARM64_ASID_BITS)
+#define ARM64_ASID_MASK       (ARM64_NASIDS - 1)
+#define ARM64_ASID_GENERATION ((uint64_t)ARM64_NASIDS)
+
+#define ARM64_ASID_ISSET(i)   ((g_asid_map[(i) >> 5] & (1u << ((i) & 31))) != 0)
+#define ARM64_ASID_SET(i)     (g_asid_map[(i) >> 5] |= 1u << ((i) & 31))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static spinlock_t g_asid_lock = SP_UNLOCKED;
+
+/* The current generation and the ASIDs given out in it */
+
+static uint64_t g_asid_generation = ARM64_ASID_GENERATION;
+static uint32_t g_asid_map[ARM64_NASIDS / 32];
+static unsigned int g_asid_next = 1;
+
+/* The ASID each CPU runs with, and the one it ran with when the last
+ * generation started.  The latter are kept in the new generation, the
+ * CPU may still hold TLB entries of them.
+ */
+
+static uint64_t g_asid_active[CONFIG_SMP_NCPUS];
+static uint64_t g_asid_reserved[CONFIG_SMP_NCPUS];
+
+/* The CPUs that must flush their TLB before they use the new generation */
+
+static cpu_set_t g_asid_flush;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm64_asid_rollover
+ *
+ * Description:
+ *   Start a new generation of ASIDs when all are given out.
+ *
+ ****************************************************************************/
+
+static void arm64_asid_rollover(void)
+{
+  uint64_t asid;
+  int cpu;
+
+  g_asid_generation += ARM64_ASID_GENERATION;
+  memset(g_asid_map, 0, sizeof(g_asid_map));
+  ARM64_ASID_SET(0);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      /* A CPU that did not switch since the last rollover keeps the ASID
+       * reserved then.
+       */
+
+      asid = g_asid_active[cpu];
+      if (asid == 0)
+        {
+          asid = g_asid_reserved[cpu];
+        }
+
+      g_asid_active[cpu]   = 0;
+      g_asid_reserved[cpu] = asid;
+      ARM64_ASID_SET(asid & ARM64_ASID_MASK);
+      CPU_SET(cpu, &g_asid_flush);
+    }
+
+  g_asid_next = 1;
+}
+
+/****************************************************************************
+ * Name: arm64_asid_reserved
+ *
+ * Description:
+ *   Move a reserved ASID to the current generation.
+ *
+ ****************************************************************************/
+
+static bool arm64_asid_reserved(uint64_t old, uint64_t asid)
+{
+  bool reserved = false;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (g_asid_reserved[cpu] == old)
+        {
+          g_asid_reserved[cpu] = asid;
+          reserved = true;
+        }
+    }
+
+  return reserved;
+}
+
+/****************************************************************************
+ * Name: arm64_asid_new
+ *
+ * Description:
+ *   Give an address environment an ASID of the current generation, the one
+ *   that it had if that is still free.
+ *
+ ****************************************************************************/
+
+static uint64_t arm64_asid_new(uint64_t old)
+{
+  unsigned int index = old & ARM64_ASID_MASK;
+
+  if (old != 0)
+    {
+      if (arm64_asid_reserved(old, g_asid_generation | index))
+        {
+          return g_asid_generation | index;
+        }
+
+      if (!ARM64_ASID_ISSET(index))
+        {
+          ARM64_ASID_SET(index);
+          return g_asid_generation | index;
+        }
+    }
+
+  for (index = g_asid_next; index < ARM64_NASIDS; index++)
+    {
+      if (!ARM64_ASID_ISSET(index))
+        {
+          break;
+        }
+    }
+
+  if (index == ARM64_NASIDS)
+    {
+      /* The reserved ASIDs leave at least one free */
+
+      arm64_asid_rollover();
+      for (index = 1; ARM64_ASID_ISSET(index); index++)
+        {
+        }
+    }
+
+  ARM64_ASID_SET(index);
+  g_asid_next = index + 1;
+  return g_asid_generation | index;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arm64_asid_select
+ *
+ * Description:
+ *   Switch TTBR0 to the address environment with its ASID, without a TLB
+ *   flush.  An address environment gets an ASID when it is first selected
+ *   and a new one when a generation of ASIDs later ran out.  Only then is
+ *   the TLB flushed, once on each CPU.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment to select.
+ *
+ ****************************************************************************/
+
+void arm64_asid_select(arch_addrenv_t *addrenv)
+{
+  irqstate_t flags;
+  uint64_t asid;
+  bool flush;
+  int cpu;
+
+  flags = spin_lock_irqsave(&g_asid_lock);
+
+  cpu  = this_cpu();
+  asid = addrenv->asid;
+  if (((asid ^ g_asid_generation) >> ARM64_ASID_BITS) != 0)
+    {
+      asid = arm64_asid_new(asid);
+      addrenv->asid = asid;
+    }
+
+  flush = CPU_ISSET(cpu, &g_asid_flush);
+  CPU_CLR(cpu, &g_asid_flush);
+  g_asid_active[cpu] = asid;
+
+  spin_unlock_irqrestore(&g_asid_lock, flags);
+
+  /* Flush before the switch, the ASID in use now is still reserved and
+   * cannot have stale entries.
+   */
+
+  if (flush)
+    {
+      mmu_invalidate_tlbs();
+    }
+
+  write_sysreg((addrenv->ttbr0 & ~TTBR_ASID_MASK) |
+               ((asid & ARM64_ASID_MASK) << TTBR_ASID_SHIFT), ttbr0_el1);
+  UP_ISB();
+}
+
+#endif /* CONFIG_ARCH_ADDRENV_ASID */
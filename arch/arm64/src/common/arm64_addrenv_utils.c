@@ -26,6 +26,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+
 #include <nuttx/arch.h>
 #include <nuttx/addrenv.h>
 #include <nuttx/irq.h>
@@ -39,6 +41,92 @@
 
 #ifdef CONFIG_BUILD_KERNEL
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A run of pages that is mapped with the contiguous hint */
+
+#if CONFIG_ARCH_ADDRENV_CONTIG_NPAGES > 0
+#  if CONFIG_ARCH_ADDRENV_CONTIG_NPAGES != 16 || CONFIG_MM_PGSIZE != 4096
+#    error The contiguous hint of the 4 KB granule spans 16 pages
+#  endif
+#  define ARM64_CONT_NPAGES CONFIG_ARCH_ADDRENV_CONTIG_NPAGES
+#  define ARM64_CONT_MASK   (ARM64_CONT_NPAGES * MM_PGSIZE - 1)
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#if CONFIG_ARCH_ADDRENV_CONTIG_NPAGES > 0
+
+/****************************************************************************
+ * Name: arm64_is_contiguous
+ *
+ * Description:
+ *   Return true if the pages of a run, starting at pages, are physically
+ *   contiguous and aligned like the run.
+ *
+ ****************************************************************************/
+
+static bool arm64_is_contiguous(uintptr_t *pages, unsigned int npages)
+{
+  int i;
+
+  if (npages < ARM64_CONT_NPAGES || (pages[0] & ARM64_CONT_MASK) != 0)
+    {
+      return false;
+    }
+
+  for (i = 1; i < ARM64_CONT_NPAGES; i++)
+    {
+      if (pages[i] != pages[0] + i * MM_PGSIZE)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: arm64_break_contiguous
+ *
+ * Description:
+ *   Drop the contiguous hint of the run that contains vaddr before a page
+ *   of it is unmapped.  The whole run is unmapped and flushed first, as
+ *   break-before-make requires, then the pages outside of [start, end) are
+ *   mapped again without the hint.
+ *
+ ****************************************************************************/
+
+static void arm64_break_contiguous(uintptr_t ptlast, uintptr_t vaddr,
+                                   uintptr_t start, uintptr_t end)
+{
+  uintptr_t entries[ARM64_CONT_NPAGES];
+  uintptr_t base = vaddr & ~ARM64_CONT_MASK;
+  uintptr_t va;
+  int i;
+
+  for (i = 0, va = base; i < ARM64_CONT_NPAGES; i++, va += MM_PGSIZE)
+    {
+      entries[i] = mmu_ln_getentry(MMU_PGT_LEVEL_MAX, ptlast, va);
+      mmu_ln_clear(MMU_PGT_LEVEL_MAX, ptlast, va);
+    }
+
+  for (i = 0, va = base; i < ARM64_CONT_NPAGES; i++, va += MM_PGSIZE)
+    {
+      if (va < start || va >= end)
+        {
+          mmu_ln_restore(MMU_PGT_LEVEL_MAX, ptlast, va,
+                         entries[i] & ~PTE_BLOCK_DESC_CONT);
+        }
+    }
+}
+
+#endif /* CONFIG_ARCH_ADDRENV_CONTIG_NPAGES > 0 */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -136,6 +224,9 @@ int arm64_map_pages(arch_addrenv_t *addrenv, uintptr_t *pages,
   uintptr_t ptlast;
   uintptr_t ptlevel;
   uintptr_t paddr;
+#if CONFIG_ARCH_ADDRENV_CONTIG_NPAGES > 0
+  unsigned int contig = 0;
+#endif
 
   ptlevel = MMU_PGT_LEVEL_MAX;
 
@@ -151,10 +242,32 @@ int arm64_map_pages(arch_addrenv_t *addrenv, uintptr_t *pages,
           return -ENOMEM;
         }
 
+#if CONFIG_ARCH_ADDRENV_CONTIG_NPAGES > 0
+      /* An aligned run of contiguous pages takes one TLB entry */
+
+      if ((vaddr & ARM64_CONT_MASK) == 0 &&
+          arm64_is_contiguous(pages, npages))
+        {
+          contig = ARM64_CONT_NPAGES;
+        }
+#endif
+
       /* Then add the reference */
 
       paddr = *pages++;
-      mmu_ln_setentry(ptlevel, ptlast, paddr, vaddr, prot);
+#if CONFIG_ARCH_ADDRENV_CONTIG_NPAGES > 0
+      if (contig > 0)
+        {
+          mmu_ln_setentry(ptlevel, ptlast, paddr, vaddr,
+                          prot | PTE_BLOCK_DESC_CONT);
+          contig--;
+        }
+      else
+#endif
+        {
+          mmu_ln_setentry(ptlevel, ptlast, paddr, vaddr, prot);
+        }
+
       vaddr += MM_PGSIZE;
     }
 
@@ -186,6 +299,10 @@ int arm64_unmap_pages(arch_addrenv_t *addrenv, uintptr_t vaddr,
   uintptr_t ptprev;
   uintptr_t ptlevel;
   uintptr_t paddr;
+#if CONFIG_ARCH_ADDRENV_CONTIG_NPAGES > 0
+  uintptr_t start = vaddr;
+  uintptr_t end = vaddr + npages * MM_PGSIZE;
+#endif
 
   /* Get the current level MAX_LEVELS-1 entry corresponding to this vaddr */
 
@@ -211,6 +328,14 @@ int arm64_unmap_pages(arch_addrenv_t *addrenv, uintptr_t vaddr,
           return -EFAULT;
         }
 
+#if CONFIG_ARCH_ADDRENV_CONTIG_NPAGES > 0
+      if ((mmu_ln_getentry(ptlevel + 1, ptlast, vaddr) &
+           PTE_BLOCK_DESC_CONT) != 0)
+        {
+          arm64_break_contiguous(ptlast, vaddr, start, end);
+        }
+#endif
+
       /* Then wipe the reference */
 
       mmu_ln_clear(ptlevel + 1, ptlast, vaddr);
@@ -165,6 +165,10 @@
 #define MODE_EL1            (0x1)
 #define MODE_EL0            (0x0)
 
+/* CPACR_EL1, Architectural Feature Access Control Register */
+
+#define CPACR_EL1_FPEN_NOTRAP       (0x3 << 20)
+
 #ifndef __ASSEMBLY__
 
 /****************************************************************************
@@ -245,9 +249,6 @@
 #define CPTR_TCPAC_BIT              BIT(31)
 #define CPTR_EL2_RES1               BIT(13) | BIT(12) | BIT(9) | (0xff)
 
-/* CPACR_EL1, Architectural Feature Access Control Register */
-#define CPACR_EL1_FPEN_NOTRAP       (0x3 << 20)
-
 /* SCR_EL3, Secure Configuration Register */
 #define SCR_NS_BIT                  BIT(0)
 #define SCR_IRQ_BIT                 BIT(1)
@@ -33,7 +33,9 @@
 #include <debug.h>
 #include <assert.h>
 #include <sched.h>
+#include <nuttx/addrenv.h>
 #include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/tls.h>
 #include <nuttx/board.h>
@@ -336,6 +338,15 @@ static int arm64_el1_abort(uint64_t *regs, uint64_t esr)
   uint64_t                  far = read_sysreg(far_el1);
   struct fatal_handle_info *inf = g_fatal_handler + (esr & ESR_ELX_FSC);
 
+#ifdef CONFIG_FS_FILEMAP
+  /* The page may belong to a demand paged file mapping */
+
+  if (filemap_fault(far) == OK)
+    {
+      return 0;
+    }
+#endif
+
   return inf->handle_fn(regs, far, esr);
 }
 
@@ -405,6 +416,10 @@ static int arm64_el1_exception_handler(uint64_t esr,
 
       case ESR_ELX_EC_DABT_CUR:
       case ESR_ELX_EC_IABT_CUR:
+#ifdef CONFIG_FS_FILEMAP
+      case ESR_ELX_EC_DABT_LOW:
+      case ESR_ELX_EC_IABT_LOW:
+#endif
         {
           ret = arm64_el1_abort(regs, esr);
           break;
@@ -572,6 +587,25 @@ uint64_t *arm64_fatal_handler(uint64_t *regs)
       PANIC_WITH_REGS("panic", regs);
     }
 
+  /* A handled fault may have stopped the task, e.g. until a page of a file
+   * mapping is read.  Switch to the new task as arm64_doirq() does.
+   */
+
+  tcb = this_task();
+  if (regs != tcb->xcp.regs)
+    {
+      struct tcb_s **running_task = &g_running_tasks[this_cpu()];
+
+#ifdef CONFIG_ARCH_ADDRENV
+      addrenv_switch(tcb);
+#endif
+
+      nxsched_switch_context(*running_task, tcb);
+
+      *running_task = tcb;
+      regs = tcb->xcp.regs;
+    }
+
   /* Clear irq flag */
 
   write_sysreg((uintptr_t)tcb & ~1ul, tpidr_el1);
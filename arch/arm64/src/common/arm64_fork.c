@@ -185,6 +185,12 @@ pid_t arm64_fork(const struct fork_s *context)
 #ifdef CONFIG_ARCH_FPU
   child->xcp.fpu_regs = (void *)(newsp - FPU_CONTEXT_SIZE);
   memcpy(child->xcp.fpu_regs, context->fpu, FPU_CONTEXT_SIZE);
+
+#ifdef CONFIG_ARCH_LAZYFPU
+  /* The parent has used the FPU to save it, so does the child */
+
+  child->xcp.fpu_regs[REG_FPU_TRAP] = CPACR_EL1_FPEN_NOTRAP;
+#endif
 #endif
 
   child->xcp.regs             = (void *)(newsp - XCPTCONTEXT_SIZE);
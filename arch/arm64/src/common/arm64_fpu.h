@@ -75,6 +75,11 @@ void arm64_fpu_enable(void);
 void arm64_fpu_save(uint64_t *context);
 void arm64_fpu_restore(uint64_t *context);
 
+#ifdef CONFIG_ARCH_LAZYFPU
+void arm64_fpu_lazy_save(uint64_t *context);
+void arm64_fpu_lazy_restore(uint64_t *context);
+#endif
+
 #endif /* __ASSEMBLY__ */
 
 #endif /* __ARCH_ARM64_SRC_COMMON_ARM64_FPU_H */
@@ -117,6 +117,7 @@
 #define PTE_BLOCK_DESC_AF           (1ULL << 10) /* A-flag */
 #define PTE_BLOCK_DESC_NG           (1ULL << 11) /* Non-global */
 #define PTE_BLOCK_DESC_DIRTY        (1ULL << 51) /* D-flag */
+#define PTE_BLOCK_DESC_CONT         (1ULL << 52) /* Contiguous */
 #define PTE_BLOCK_DESC_PXN          (1ULL << 53) /* Kernel execute never */
 #define PTE_BLOCK_DESC_UXN          (1ULL << 54) /* User execute never */
 
@@ -408,10 +409,18 @@ static inline uintptr_t mmu_ttbr_reg(uintptr_t pgbase, uint16_t asid)
 
 static inline void mmu_invalidate_tlb_by_vaddr(uintptr_t vaddr)
 {
+  /* The entries of other address environments are tagged with their own
+   * ASID when the TLB is not flushed on the switch, flush all ASIDs.
+   */
+
   __asm__ __volatile__
     (
       "dsb ishst\n"
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+      "tlbi vaale1is, %0\n"
+#else
       "tlbi vale1is, %0\n"
+#endif
       "dsb ish\n"
       "isb"
       :
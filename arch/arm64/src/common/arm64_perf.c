@@ -24,8 +24,11 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/arch.h>
 #include <nuttx/clock.h>
 
+#include <errno.h>
+
 #include "arm64_pmu.h"
 
 #ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
@@ -82,3 +85,89 @@ void up_perf_convert(clock_t elapsed, struct timespec *ts)
   ts->tv_nsec = NSEC_PER_SEC * left / g_cpu_freq;
 }
 #endif
+
+#ifdef CONFIG_ARCH_HAVE_PMU
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* The ARMv8 common event numbers of the PMU_EVENT_* */
+
+static int pmu_event_number(int event)
+{
+  switch (event)
+    {
+      case PMU_EVENT_CYCLES:
+        return 0x11;                   /* CPU_CYCLES */
+      case PMU_EVENT_INSTRUCTIONS:
+        return 0x08;                   /* INST_RETIRED */
+      case PMU_EVENT_CACHE_MISSES:
+        return 0x03;                   /* L1D_CACHE_REFILL */
+      case PMU_EVENT_BRANCH_MISSES:
+        return 0x10;                   /* BR_MIS_PRED */
+      case PMU_EVENT_STALL_FRONTEND:
+        return 0x23;                   /* STALL_FRONTEND */
+      case PMU_EVENT_STALL_BACKEND:
+        return 0x24;                   /* STALL_BACKEND */
+      default:
+        return -ENOTSUP;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int up_pmu_ncounters(void)
+{
+  return (pmu_get_control() & PMCR_EL0_N_MASK) >> PMCR_EL0_N_SHIFT;
+}
+
+int up_pmu_start(int counter, int event)
+{
+  uint64_t ceid;
+  int number;
+
+  if (counter < 0 || counter >= up_pmu_ncounters())
+    {
+      return -EINVAL;
+    }
+
+  number = pmu_event_number(event);
+  if (number < 0)
+    {
+      return number;
+    }
+
+  /* Not all cores implement all common events */
+
+  ceid = number < 0x20 ? pmu_get_ceid0() : pmu_get_ceid1();
+  if ((ceid & (1ul << (number & 0x1f))) == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  /* Count at EL0 and EL1, the overflow is handled by the caller */
+
+  pmu_cntr_disable(1ul << counter);
+  pmu_cntr_irq_disable(1ul << counter);
+  pmu_cntr_select(counter);
+  pmu_cntr_set_xevtyper(number);
+  pmu_cntr_control_config(pmu_get_control() | PMCR_EL0_E);
+  pmu_cntr_enable(1ul << counter);
+
+  return 32;
+}
+
+void up_pmu_stop(int counter)
+{
+  pmu_cntr_disable(1ul << counter);
+}
+
+uint64_t up_pmu_read(int counter)
+{
+  pmu_cntr_select(counter);
+  return pmu_cntr_get_xevcntr();
+}
+#endif
@@ -56,6 +56,8 @@
 
 /* PMCR_EL0 */
 
+#define PMCR_EL0_N_SHIFT         (11)         /* Number of event counters */
+#define PMCR_EL0_N_MASK          (0x1ful << PMCR_EL0_N_SHIFT)
 #define PMCR_EL0_LC              (1ul << 6)   /* Long cycle counter enable */
 #define PMCR_EL0_DP              (1ul << 5)   /* Disable cycle counter when event counting is prohibited */
 #define PMCR_EL0_X               (1ul << 4)   /* Enable export of events */
@@ -269,6 +271,80 @@ static inline void pmu_cntr_irq_disable(uint64_t mask)
   write_sysreg(mask, pmintenclr_el1);
 }
 
+/****************************************************************************
+ * Name: pmu_get_control
+ *
+ * Description:
+ *   Read the counter configuration, PMCR_EL0.
+ *
+ ****************************************************************************/
+
+static inline uint64_t pmu_get_control(void)
+{
+  return read_sysreg(pmcr_el0);
+}
+
+/****************************************************************************
+ * Name: pmu_cntr_disable
+ *
+ * Description:
+ *   Disable counters.
+ *
+ * Parameters:
+ *   mask - Counters to disable.
+ *
+ ****************************************************************************/
+
+static inline void pmu_cntr_disable(uint64_t mask)
+{
+  write_sysreg(mask, pmcntenclr_el0);
+}
+
+/****************************************************************************
+ * Name: pmu_get_ceid
+ *
+ * Description:
+ *   Read the common events that are implemented, bit n of PMCEID0_EL0 for
+ *   event n and bit n of PMCEID1_EL0 for event 0x20 + n.
+ *
+ ****************************************************************************/
+
+static inline uint64_t pmu_get_ceid0(void)
+{
+  return read_sysreg(pmceid0_el0);
+}
+
+static inline uint64_t pmu_get_ceid1(void)
+{
+  return read_sysreg(pmceid1_el0);
+}
+
+/****************************************************************************
+ * Name: pmu_cntr_set_xevtyper
+ *
+ * Description:
+ *   Sets the event counted by the counter selected with pmu_cntr_select().
+ *
+ ****************************************************************************/
+
+static inline void pmu_cntr_set_xevtyper(uint64_t mask)
+{
+  write_sysreg(mask, pmxevtyper_el0);
+}
+
+/****************************************************************************
+ * Name: pmu_cntr_get_xevcntr
+ *
+ * Description:
+ *   Reads the counter selected with pmu_cntr_select().
+ *
+ ****************************************************************************/
+
+static inline uint64_t pmu_cntr_get_xevcntr(void)
+{
+  return read_sysreg(pmxevcntr_el0);
+}
+
 #ifdef CONFIG_ARCH_CLUSTER_PMU
 
 /****************************************************************************
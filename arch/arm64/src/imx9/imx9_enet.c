@@ -3040,6 +3040,7 @@ static inline int imx9_initphy(struct imx9_driver_s *priv, bool renogphy)
 
 static void imx9_initbuffers(struct imx9_driver_s *priv)
 {
+  struct iovec iov[2];
   uintptr_t addr;
   int i;
 
@@ -3079,12 +3080,11 @@ static void imx9_initbuffers(struct imx9_driver_s *priv)
 
   UP_DSB();
 
-  up_clean_dcache((uintptr_t)priv->txdesc,
-                  (uintptr_t)priv->txdesc +
-                  IMX9_ENET_NTXBUFFERS * sizeof(priv->txdesc[0]));
-  up_clean_dcache((uintptr_t)priv->rxdesc,
-                  (uintptr_t)priv->rxdesc +
-                  IMX9_ENET_NRXBUFFERS * sizeof(priv->rxdesc[0]));
+  iov[0].iov_base = priv->txdesc;
+  iov[0].iov_len  = IMX9_ENET_NTXBUFFERS * sizeof(priv->txdesc[0]);
+  iov[1].iov_base = priv->rxdesc;
+  iov[1].iov_len  = IMX9_ENET_NRXBUFFERS * sizeof(priv->rxdesc[0]);
+  up_clean_dcache_iov(iov, 2);
 
   /* We start with RX descriptor 0 and with no TX descriptors in use */
 
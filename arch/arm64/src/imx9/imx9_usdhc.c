@@ -1045,6 +1045,7 @@ static void imx9_receive(struct imx9_dev_s *priv)
 static void imx9_recvdma(struct imx9_dev_s *priv)
 {
   unsigned int watermark;
+  struct iovec iov;
 
   if (priv->unaligned_rx)
     {
@@ -1069,8 +1070,9 @@ static void imx9_recvdma(struct imx9_dev_s *priv)
     {
       /* In an aligned case, we have always received all blocks */
 
-      up_invalidate_dcache((uintptr_t)priv->buffer,
-                           (uintptr_t)priv->buffer + priv->remaining);
+      iov.iov_base = priv->buffer;
+      iov.iov_len  = priv->remaining;
+      up_invalidate_dcache_iov(&iov, 1);
       priv->remaining = 0;
     }
 
@@ -3055,8 +3057,11 @@ static int imx9_dmarecvsetup(struct sdio_dev_s *dev,
     }
   else
     {
-      up_invalidate_dcache((uintptr_t)buffer,
-                           (uintptr_t)buffer + buflen);
+      struct iovec iov;
+
+      iov.iov_base = buffer;
+      iov.iov_len  = buflen;
+      up_invalidate_dcache_iov(&iov, 1);
 
       priv->unaligned_rx = false;
     }
@@ -3120,6 +3125,10 @@ static int imx9_dmasendsetup(struct sdio_dev_s *dev,
                               const uint8_t *buffer, size_t buflen)
 {
   struct imx9_dev_s *priv = (struct imx9_dev_s *)dev;
+#if !defined(CONFIG_ARM64_DCACHE_DISABLE)
+  struct iovec iov;
+#endif
+
   DEBUGASSERT(priv != NULL && buffer != NULL && buflen > 0);
   DEBUGASSERT(((uint64_t) buffer & 3) == 0);
 
@@ -3135,7 +3144,9 @@ static int imx9_dmasendsetup(struct sdio_dev_s *dev,
 
   /* Flush cache to physical memory when not in DTCM memory */
 
-  up_clean_dcache((uintptr_t)buffer, (uintptr_t)buffer + buflen);
+  iov.iov_base = (void *)buffer;
+  iov.iov_len  = buflen;
+  up_clean_dcache_iov(&iov, 1);
 
 #endif
   priv->buffer    = (uint32_t *)buffer;
@@ -138,6 +138,17 @@ struct arch_addrenv_s
   /* The page directory root (satp) value */
 
   uintptr_t satp;
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+  /* The ASID and its generation, zero until the first selection, and the
+   * hart that last selected it.
+   */
+
+  uint64_t  asid;
+#ifdef CONFIG_SMP
+  uint8_t   asidcpu;
+#endif
+#endif
 };
 
 typedef struct arch_addrenv_s arch_addrenv_t;
@@ -289,6 +289,10 @@ if(CONFIG_RISCV_TOOLCHAIN STREQUAL GNU_RVG)
     endif()
   endif()
 
+  if(CONFIG_ARCH_RV_ISA_ZBB)
+    set(ARCHCPUEXTFLAGS ${ARCHCPUEXTFLAGS}_zbb)
+  endif()
+
   if(CONFIG_ARCH_RV_EXPERIMENTAL_EXTENSIONS)
     set(ARCHCPUEXTFLAGS
         ${ARCHCPUEXTFLAGS}_${CONFIG_ARCH_RV_EXPERIMENTAL_EXTENSIONS})
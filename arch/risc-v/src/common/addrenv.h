@@ -109,6 +109,22 @@ uintptr_t riscv_get_pgtable(arch_addrenv_t *addrenv, uintptr_t vaddr);
 int riscv_map_pages(arch_addrenv_t *addrenv, uintptr_t *pages,
                     unsigned int npages, uintptr_t vaddr, int prot);
 
+/****************************************************************************
+ * Name: riscv_asid_select
+ *
+ * Description:
+ *   Switch satp to the address environment, tagged with its ASID instead
+ *   of flushing the TLB.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment to select.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+void riscv_asid_select(arch_addrenv_t *addrenv);
+#endif
+
 /****************************************************************************
  * Name: riscv_unmap_pages
  *
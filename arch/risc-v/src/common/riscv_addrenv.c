@@ -721,7 +721,17 @@ ssize_t up_addrenv_heapsize(const arch_addrenv_t *addrenv)
 int up_addrenv_select(const arch_addrenv_t *addrenv)
 {
   DEBUGASSERT(addrenv && addrenv->satp);
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+  /* The ASID is given out here on first use, it is not part of what
+   * identifies the address environment.
+   */
+
+  riscv_asid_select((arch_addrenv_t *)addrenv);
+#else
   mmu_write_satp(addrenv->satp);
+#endif
+
   return OK;
 }
 
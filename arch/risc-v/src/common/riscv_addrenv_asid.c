@@ -0,0 +1,358 @@
+/****************************************************************************
+ * arch/risc-v/src/common/riscv_addrenv_asid.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include "addrenv.h"
+#include "riscv_mmu.h"
+
+#ifdef CONFIG_ARCH_ADDRENV_ASID
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* At most 8 bits of the ASIDs that the hart implements are used, that
+ * keeps the map small.  ASID 0 is never given out, it tags the kernel page
+ * tables.  The bits above the ASID of arch_addrenv_t's asid count the
+ * generations.
+ */
+
+#define RISCV_ASID_MAXBITS    8
+#define RISCV_NASIDS          (1 << RISCV_ASID_MAXBITS)
+#define RISCV_ASID_MASK       (RISCV_NASIDS - 1)
+#define RISCV_ASID_GENERATION ((uint64_t)RISCV_NASIDS)
+
+#define RISCV_ASID_ISSET(i)   ((g_asid_map[(i) >> 5] & (1u << ((i) & 31))) != 0)
+#define RISCV_ASID_SET(i)     (g_asid_map[(i) >> 5] |= 1u << ((i) & 31))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static spinlock_t g_asid_lock = SP_UNLOCKED;
+
+/* The number of ASIDs in use, 0 if the TLB is flushed on each switch and
+ * -1 before the hart was probed.
+ */
+
+static int g_asid_count = -1;
+
+/* The current generation and the ASIDs given out in it */
+
+static uint64_t g_asid_generation = RISCV_ASID_GENERATION;
+static uint32_t g_asid_map[RISCV_NASIDS / 32];
+static int g_asid_next = 1;
+
+/* The ASID each hart runs with, and the one it ran with when the last
+ * generation started.  The latter are kept in the new generation, the
+ * hart may still hold TLB entries of them.
+ */
+
+static uint64_t g_asid_active[CONFIG_SMP_NCPUS];
+static uint64_t g_asid_reserved[CONFIG_SMP_NCPUS];
+
+/* The harts that must flush their TLB before they use the new generation */
+
+static cpu_set_t g_asid_flush;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: riscv_asid_probe
+ *
+ * Description:
+ *   Count the ASIDs of the hart, the ASID bits that it implements keep the
+ *   ones written to them.
+ *
+ ****************************************************************************/
+
+static int riscv_asid_probe(void)
+{
+  uintptr_t satp = mmu_read_satp();
+  uintptr_t asid;
+  int bits;
+
+  /* The MMU cache of the T-Head C906 is flushed on each switch anyway */
+
+  if (mmu_flush_cache != NULL)
+    {
+      return 0;
+    }
+
+  __asm__ __volatile__
+    (
+      "csrw satp, %1\n"
+      "csrr %0, satp\n"
+      "csrw satp, %2\n"
+      "sfence.vma x0, x0\n"
+      : "=&r" (asid)
+      : "r" (satp | SATP_ASID_MASK), "r" (satp)
+      : "memory"
+    );
+
+  asid = (asid & SATP_ASID_MASK) >> SATP_ASID_SHIFT;
+  for (bits = 0; bits < RISCV_ASID_MAXBITS && (asid & 1) != 0; bits++)
+    {
+      asid >>= 1;
+    }
+
+  /* Each hart may keep one ASID reserved, and ASID 0 is not used */
+
+  if ((1 << bits) <= CONFIG_SMP_NCPUS + 1)
+    {
+      return 0;
+    }
+
+  return 1 << bits;
+}
+
+/****************************************************************************
+ * Name: riscv_asid_rollover
+ *
+ * Description:
+ *   Start a new generation of ASIDs when all are given out.
+ *
+ ****************************************************************************/
+
+static void riscv_asid_rollover(void)
+{
+  uint64_t asid;
+  int cpu;
+
+  g_asid_generation += RISCV_ASID_GENERATION;
+  memset(g_asid_map, 0, sizeof(g_asid_map));
+  RISCV_ASID_SET(0);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      /* A hart that did not switch since the last rollover keeps the ASID
+       * reserved then.
+       */
+
+      asid = g_asid_active[cpu];
+      if (asid == 0)
+        {
+          asid = g_asid_reserved[cpu];
+        }
+
+      g_asid_active[cpu]   = 0;
+      g_asid_reserved[cpu] = asid;
+      RISCV_ASID_SET(asid & RISCV_ASID_MASK);
+      CPU_SET(cpu, &g_asid_flush);
+    }
+
+  g_asid_next = 1;
+}
+
+/****************************************************************************
+ * Name: riscv_asid_reserved
+ *
+ * Description:
+ *   Move a reserved ASID to the current generation.
+ *
+ ****************************************************************************/
+
+static bool riscv_asid_reserved(uint64_t old, uint64_t asid)
+{
+  bool reserved = false;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (g_asid_reserved[cpu] == old)
+        {
+          g_asid_reserved[cpu] = asid;
+          reserved = true;
+        }
+    }
+
+  return reserved;
+}
+
+/****************************************************************************
+ * Name: riscv_asid_new
+ *
+ * Description:
+ *   Give an address environment an ASID of the current generation, the one
+ *   that it had if that is still free.
+ *
+ ****************************************************************************/
+
+static uint64_t riscv_asid_new(uint64_t old)
+{
+  int index = old & RISCV_ASID_MASK;
+
+  if (old != 0)
+    {
+      if (riscv_asid_reserved(old, g_asid_generation | index))
+        {
+          return g_asid_generation | index;
+        }
+
+      if (!RISCV_ASID_ISSET(index))
+        {
+          RISCV_ASID_SET(index);
+          return g_asid_generation | index;
+        }
+    }
+
+  for (index = g_asid_next; index < g_asid_count; index++)
+    {
+      if (!RISCV_ASID_ISSET(index))
+        {
+          break;
+        }
+    }
+
+  if (index == g_asid_count)
+    {
+      /* The reserved ASIDs leave at least one free */
+
+      riscv_asid_rollover();
+      for (index = 1; RISCV_ASID_ISSET(index); index++)
+        {
+        }
+    }
+
+  RISCV_ASID_SET(index);
+  g_asid_next = index + 1;
+  return g_asid_generation | index;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: riscv_asid_select
+ *
+ * Description:
+ *   Switch satp to the address environment with its ASID, without a TLB
+ *   flush.  An address environment gets an ASID when it is first selected
+ *   and a new one when a generation of ASIDs later ran out.  Only then is
+ *   the TLB flushed, once on each hart.  Harts that implement too few ASID
+ *   bits flush on each switch as before.
+ *
+ * Input Parameters:
+ *   addrenv - The address environment to select.
+ *
+ ****************************************************************************/
+
+void riscv_asid_select(arch_addrenv_t *addrenv)
+{
+  irqstate_t flags;
+  uint64_t asid;
+  bool flush;
+  int cpu;
+
+  flags = spin_lock_irqsave(&g_asid_lock);
+
+  if (g_asid_count < 0)
+    {
+      g_asid_count = riscv_asid_probe();
+    }
+
+  if (g_asid_count == 0)
+    {
+      spin_unlock_irqrestore(&g_asid_lock, flags);
+      mmu_write_satp(addrenv->satp);
+      return;
+    }
+
+  cpu   = this_cpu();
+  asid  = addrenv->asid;
+  flush = false;
+
+  if (((asid ^ g_asid_generation) >> RISCV_ASID_MAXBITS) != 0)
+    {
+      asid = riscv_asid_new(asid);
+      addrenv->asid = asid;
+    }
+#ifdef CONFIG_SMP
+  else if (addrenv->asidcpu != cpu)
+    {
+      /* sfence.vma only reaches the local hart, this one may hold entries
+       * from when the address environment last ran here.
+       */
+
+      flush = true;
+    }
+
+  addrenv->asidcpu = cpu;
+#endif
+
+  if (CPU_ISSET(cpu, &g_asid_flush))
+    {
+      /* Flush before the switch, the ASID in use now is still reserved and
+       * cannot have stale entries.
+       */
+
+      CPU_CLR(cpu, &g_asid_flush);
+      mmu_invalidate_tlbs();
+      flush = false;
+    }
+
+  g_asid_active[cpu] = asid;
+
+  spin_unlock_irqrestore(&g_asid_lock, flags);
+
+  __asm__ __volatile__
+    (
+      "csrw satp, %0\n"
+      "fence rw, rw\n"
+      "fence.i\n"
+      :
+      : "r" ((addrenv->satp & ~SATP_ASID_MASK) |
+             ((uintptr_t)(asid & RISCV_ASID_MASK) << SATP_ASID_SHIFT))
+      : "memory"
+    );
+
+  if (flush)
+    {
+      __asm__ __volatile__
+        (
+          "sfence.vma x0, %0\n"
+          :
+          : "r" ((uintptr_t)(asid & RISCV_ASID_MASK))
+          : "memory"
+        );
+    }
+}
+
+#endif /* CONFIG_ARCH_ADDRENV_ASID */
@@ -32,6 +32,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/fs/fs.h>
 #ifdef CONFIG_PAGING
 #  include <nuttx/pgalloc.h>
 #endif
@@ -248,6 +249,35 @@ int riscv_fillpage(int mcause, void *regs, void *args)
 }
 #endif /* CONFIG_PAGING */
 
+/****************************************************************************
+ * Name: riscv_filemap
+ *
+ * Description:
+ *   Page fault handler when demand paged file mappings are enabled.  Faults
+ *   on file mappings are passed on to filemap_fault(), all others to the
+ *   usual handler of the exception.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FILEMAP
+static int riscv_filemap(int mcause, void *regs, void *args)
+{
+  if (filemap_fault(READ_CSR(CSR_TVAL)) == OK)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_PAGING
+  if (mcause != RISCV_IRQ_INSTRUCTIONPF)
+    {
+      return riscv_fillpage(mcause, regs, args);
+    }
+#endif
+
+  return riscv_exception(mcause, regs, args);
+}
+#endif
+
 /****************************************************************************
  * Name: riscv_exception_attach
  *
@@ -290,12 +320,16 @@ void riscv_exception_attach(void)
   irq_attach(RISCV_IRQ_ECALLM, riscv_exception, NULL);
 #endif
 
+#ifdef CONFIG_FS_FILEMAP
+  irq_attach(RISCV_IRQ_INSTRUCTIONPF, riscv_filemap, NULL);
+  irq_attach(RISCV_IRQ_LOADPF, riscv_filemap, NULL);
+  irq_attach(RISCV_IRQ_STOREPF, riscv_filemap, NULL);
+#elif defined(CONFIG_PAGING)
   irq_attach(RISCV_IRQ_INSTRUCTIONPF, riscv_exception, NULL);
-
-#ifdef CONFIG_PAGING
   irq_attach(RISCV_IRQ_LOADPF, riscv_fillpage, NULL);
   irq_attach(RISCV_IRQ_STOREPF, riscv_fillpage, NULL);
 #else
+  irq_attach(RISCV_IRQ_INSTRUCTIONPF, riscv_exception, NULL);
   irq_attach(RISCV_IRQ_LOADPF, riscv_exception, NULL);
   irq_attach(RISCV_IRQ_STOREPF, riscv_exception, NULL);
 #endif
@@ -0,0 +1,146 @@
+/****************************************************************************
+ * arch/risc-v/src/common/riscv_pmu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+
+#include "riscv_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Only cycle and instret are defined by the privileged specification, the
+ * events of the hpmcounters are implementation defined and cannot be
+ * mapped to the PMU_EVENT_* here.  Both counters are read only and always
+ * running, so a "counter" only remembers which of them it reads.
+ */
+
+#define RISCV_PMU_NCOUNTERS 2
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Every CPU is programmed with the same events, one table serves them */
+
+static uint8_t g_riscv_pmu_event[RISCV_PMU_NCOUNTERS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_RV32
+static uint64_t riscv_pmu_cycle(void)
+{
+  uint32_t high;
+  uint32_t low;
+
+  do
+    {
+      high = READ_CSR(CSR_CYCLEH);
+      low  = READ_CSR(CSR_CYCLE);
+    }
+  while (high != READ_CSR(CSR_CYCLEH));
+
+  return ((uint64_t)high << 32) | low;
+}
+
+static uint64_t riscv_pmu_instret(void)
+{
+  uint32_t high;
+  uint32_t low;
+
+  do
+    {
+      high = READ_CSR(CSR_INSTRETH);
+      low  = READ_CSR(CSR_INSTRET);
+    }
+  while (high != READ_CSR(CSR_INSTRETH));
+
+  return ((uint64_t)high << 32) | low;
+}
+#else
+#  define riscv_pmu_cycle()   READ_CSR(CSR_CYCLE)
+#  define riscv_pmu_instret() READ_CSR(CSR_INSTRET)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_pmu_*
+ *
+ * Description:
+ *   The event counters of the calling hart, see include/nuttx/arch.h.  In
+ *   S-mode the SBI firmware must give access to cycle and instret through
+ *   mcounteren.
+ *
+ ****************************************************************************/
+
+int up_pmu_ncounters(void)
+{
+  return RISCV_PMU_NCOUNTERS;
+}
+
+int up_pmu_start(int counter, int event)
+{
+  if (counter < 0 || counter >= RISCV_PMU_NCOUNTERS)
+    {
+      return -EINVAL;
+    }
+
+  if (event != PMU_EVENT_CYCLES && event != PMU_EVENT_INSTRUCTIONS)
+    {
+      return -ENOTSUP;
+    }
+
+  g_riscv_pmu_event[counter] = event;
+  return 64;
+}
+
+void up_pmu_stop(int counter)
+{
+  g_riscv_pmu_event[counter] = PMU_EVENT_NONE;
+}
+
+uint64_t up_pmu_read(int counter)
+{
+  switch (g_riscv_pmu_event[counter])
+    {
+      case PMU_EVENT_CYCLES:
+        return riscv_pmu_cycle();
+      case PMU_EVENT_INSTRUCTIONS:
+        return riscv_pmu_instret();
+      default:
+        return 0;
+    }
+}
@@ -0,0 +1,246 @@
+/****************************************************************************
+ * arch/sim/src/sim/posix/sim_hostdoorbell.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim_internal.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The doorbells interrupt with the real time signals after the one that
+ * the C library may use.  The last one is not below NR_IRQS.
+ */
+
+#define HOST_DOORBELL_FIRST  (SIGRTMIN + 1)
+#define HOST_DOORBELL_LAST   (SIGRTMAX - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct host_doorbell_s
+{
+  volatile uint32_t *seq;      /* Advanced by the peer on each kick */
+  volatile uint32_t *waiting;  /* Set while this side sleeps on seq */
+  pthread_t          target;   /* The thread that takes the interrupt */
+  pthread_t          thread;
+  int                irq;
+  bool               busypoll;
+  volatile bool      stop;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct host_doorbell_s *g_doorbell[32];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static long host_futex(volatile uint32_t *addr, int op, uint32_t val,
+                       const struct timespec *timeout)
+{
+  return syscall(SYS_futex, addr, op, val, timeout, NULL, 0);
+}
+
+/****************************************************************************
+ * Name: host_doorbell_thread
+ *
+ * Description:
+ *   Wait until the peer advances the sequence and raise the interrupt of
+ *   the doorbell.  This is a host thread, it must not take the signals
+ *   that drive the simulation.
+ *
+ ****************************************************************************/
+
+static void *host_doorbell_thread(void *arg)
+{
+  struct host_doorbell_s *db = arg;
+  struct timespec timeout;
+  uint32_t last;
+  uint32_t seq;
+  sigset_t set;
+
+  sigfillset(&set);
+  pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+  /* Sleep at most this long, to see the stop request */
+
+  timeout.tv_sec  = 0;
+  timeout.tv_nsec = 100 * 1000 * 1000;
+
+  last = __atomic_load_n(db->seq, __ATOMIC_ACQUIRE);
+
+  while (!db->stop)
+    {
+      seq = __atomic_load_n(db->seq, __ATOMIC_ACQUIRE);
+      if (seq != last)
+        {
+          last = seq;
+          pthread_kill(db->target, db->irq);
+          continue;
+        }
+
+      if (db->busypoll)
+        {
+          continue;
+        }
+
+      /* Tell the peer to wake us, then check again before sleeping so
+       * that a kick in between is not lost.
+       */
+
+      __atomic_store_n(db->waiting, 1, __ATOMIC_SEQ_CST);
+      if (__atomic_load_n(db->seq, __ATOMIC_SEQ_CST) == last)
+        {
+          host_futex(db->seq, FUTEX_WAIT, last, &timeout);
+        }
+
+      __atomic_store_n(db->waiting, 0, __ATOMIC_RELAXED);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: host_doorbell_watch
+ *
+ * Description:
+ *   Start a host thread that raises an interrupt on the calling thread each
+ *   time that the peer advances seq with host_doorbell_ring().  seq and
+ *   waiting are in memory shared with the peer.
+ *
+ * Input Parameters:
+ *   seq      - The sequence that the peer advances.
+ *   waiting  - The flag that tells the peer to wake the thread.
+ *   busypoll - Spin on seq instead of sleeping, for the lowest latency.
+ *
+ * Returned Value:
+ *   The interrupt number on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int host_doorbell_watch(volatile uint32_t *seq, volatile uint32_t *waiting,
+                        bool busypoll)
+{
+  struct host_doorbell_s *db;
+  int irq;
+  int ret;
+
+  for (irq = HOST_DOORBELL_FIRST; irq <= HOST_DOORBELL_LAST; irq++)
+    {
+      if (g_doorbell[irq - HOST_DOORBELL_FIRST] == NULL)
+        {
+          break;
+        }
+    }
+
+  if (irq > HOST_DOORBELL_LAST ||
+      irq - HOST_DOORBELL_FIRST >= sizeof(g_doorbell) / sizeof(*g_doorbell))
+    {
+      return -EBUSY;
+    }
+
+  db = host_uninterruptible(calloc, 1, sizeof(*db));
+  if (db == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  db->seq      = seq;
+  db->waiting  = waiting;
+  db->target   = pthread_self();
+  db->irq      = irq;
+  db->busypoll = busypoll;
+
+  ret = host_uninterruptible(pthread_create, &db->thread, NULL,
+                             host_doorbell_thread, db);
+  if (ret != 0)
+    {
+      host_uninterruptible_no_return(free, db);
+      return -ret;
+    }
+
+  g_doorbell[irq - HOST_DOORBELL_FIRST] = db;
+  return irq;
+}
+
+/****************************************************************************
+ * Name: host_doorbell_unwatch
+ *
+ * Description:
+ *   Stop the thread of a doorbell, before its shared memory is freed.
+ *
+ ****************************************************************************/
+
+void host_doorbell_unwatch(int irq)
+{
+  struct host_doorbell_s *db = g_doorbell[irq - HOST_DOORBELL_FIRST];
+
+  db->stop = true;
+  host_futex(db->seq, FUTEX_WAKE, INT_MAX, NULL);
+  host_uninterruptible_no_return(pthread_join, db->thread, NULL);
+
+  g_doorbell[irq - HOST_DOORBELL_FIRST] = NULL;
+  host_uninterruptible_no_return(free, db);
+}
+
+/****************************************************************************
+ * Name: host_doorbell_ring
+ *
+ * Description:
+ *   Advance seq and wake the thread of the peer if it is sleeping.  The
+ *   system call is skipped while the peer is busy.
+ *
+ ****************************************************************************/
+
+void host_doorbell_ring(volatile uint32_t *seq, volatile uint32_t *waiting)
+{
+  __atomic_fetch_add(seq, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(waiting, __ATOMIC_SEQ_CST))
+    {
+      host_futex(seq, FUTEX_WAKE, INT_MAX, NULL);
+    }
+}
@@ -65,7 +65,11 @@
 #include <sys/time.h>
 #include <sys/uio.h>
 
+#include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -87,6 +91,17 @@
 
 #define DEVTAP        "/dev/net/tun"
 
+#ifdef CONFIG_SIM_NETDEV_TAP_THREAD
+/* A frame with a VLAN tag */
+
+#  define TAPDEV_FRAMESIZE (CONFIG_SIM_NETDEV_MTU + 18)
+#  define TAPDEV_RXRING    CONFIG_SIM_NETDEV_TAP_RXRING
+
+#  if (TAPDEV_RXRING & (TAPDEV_RXRING - 1)) != 0
+#    error CONFIG_SIM_NETDEV_TAP_RXRING must be a power of 2
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -102,6 +117,26 @@ struct sel_arg_struct
   struct timeval *tvp;
 };
 
+#ifdef CONFIG_SIM_NETDEV_TAP_THREAD
+/* Frames received by the host thread.  The thread only advances head and
+ * the simulation only advances tail, so the ring needs no lock.
+ */
+
+struct tapdev_frame_s
+{
+  unsigned int  len;
+  unsigned char data[TAPDEV_FRAMESIZE];
+};
+
+struct tapdev_ring_s
+{
+  unsigned int          head;
+  unsigned int          tail;
+  pthread_t             thread;
+  struct tapdev_frame_s frame[TAPDEV_RXRING];
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -118,6 +153,10 @@ static void *g_priv[CONFIG_SIM_NETDEV_NUMBER];
 static void (*g_tx_done_intr_cb[CONFIG_SIM_NETDEV_NUMBER])(void *priv);
 static void (*g_rx_ready_intr_cb[CONFIG_SIM_NETDEV_NUMBER])(void *priv);
 
+#ifdef CONFIG_SIM_NETDEV_TAP_THREAD
+static struct tapdev_ring_s *g_rxring[CONFIG_SIM_NETDEV_NUMBER];
+#endif
+
 #ifdef CONFIG_SIM_NET_HOST_ROUTE
 #  ifdef CONFIG_NET_IPv4
 static struct rtentry ghostroute[CONFIG_SIM_NETDEV_NUMBER];
@@ -183,6 +222,95 @@ static void set_macaddr(int devidx)
   sim_netdriver_setmacaddr(devidx, mac);
 }
 
+#ifdef CONFIG_SIM_NETDEV_TAP_THREAD
+/****************************************************************************
+ * Name: tapdev_rxthread
+ *
+ * Description:
+ *   Move the frames from a TAP device to its ring.  This is a host thread,
+ *   it must not call into NuttX and must not take the host signals that
+ *   drive the simulation.
+ *
+ ****************************************************************************/
+
+static void *tapdev_rxthread(void *arg)
+{
+  int devidx = (int)(intptr_t)arg;
+  struct tapdev_ring_s *ring = g_rxring[devidx];
+  struct tapdev_frame_s *frame;
+  struct pollfd pfd;
+  unsigned int head;
+  sigset_t set;
+  int ret;
+
+  sigfillset(&set);
+  pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+  pfd.fd     = gtapdevfd[devidx];
+  pfd.events = POLLIN;
+
+  for (; ; )
+    {
+      head = ring->head;
+      if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >=
+          TAPDEV_RXRING)
+        {
+          /* The simulation is behind, leave the frames in the device */
+
+          usleep(100);
+          continue;
+        }
+
+      frame = &ring->frame[head & (TAPDEV_RXRING - 1)];
+      ret = read(pfd.fd, frame->data, TAPDEV_FRAMESIZE);
+      if (ret > 0)
+        {
+          frame->len = ret;
+          __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+        }
+      else if (ret == 0 || errno == EAGAIN)
+        {
+          poll(&pfd, 1, -1);
+        }
+      else if (errno != EINTR)
+        {
+          syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -errno);
+          break;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tapdev_rxthread_start
+ ****************************************************************************/
+
+static void tapdev_rxthread_start(int devidx)
+{
+  struct tapdev_ring_s *ring;
+  int ret;
+
+  ring = calloc(1, sizeof(struct tapdev_ring_s));
+  if (ring == NULL)
+    {
+      syslog(LOG_ERR, "TAPDEV: Can't allocate the receive ring\n");
+      return;
+    }
+
+  g_rxring[devidx] = ring;
+  ret = pthread_create(&ring->thread, NULL, tapdev_rxthread,
+                       (void *)(intptr_t)devidx);
+  if (ret != 0)
+    {
+      syslog(LOG_ERR, "TAPDEV: Can't create the receive thread: %d\n",
+             ret);
+      g_rxring[devidx] = NULL;
+      free(ring);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -279,6 +407,12 @@ void sim_tapdev_init(int devidx, void *priv,
       sim_netdriver_setmtu(devidx, ifr.ifr_mtu);
     }
 
+  /* Reads only happen when a frame is there, but never block the
+   * simulation on a frame that the host took back.
+   */
+
+  fcntl(tapdevfd, F_SETFL, fcntl(tapdevfd, F_GETFL) | O_NONBLOCK);
+
   gtapdevfd[devidx] = tapdevfd;
   g_priv[devidx] = priv;
 
@@ -293,6 +427,10 @@ void sim_tapdev_init(int devidx, void *priv,
   /* Set the MAC address */
 
   set_macaddr(devidx);
+
+#ifdef CONFIG_SIM_NETDEV_TAP_THREAD
+  tapdev_rxthread_start(devidx);
+#endif
 }
 
 int sim_tapdev_avail(int devidx)
@@ -307,6 +445,15 @@ int sim_tapdev_avail(int devidx)
       return 0;
     }
 
+#ifdef CONFIG_SIM_NETDEV_TAP_THREAD
+  if (g_rxring[devidx] != NULL)
+    {
+      struct tapdev_ring_s *ring = g_rxring[devidx];
+
+      return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) != ring->tail;
+    }
+#endif
+
   /* Wait for data on the tap device (or a timeout) */
 
   tv.tv_sec  = 0;
@@ -323,15 +470,44 @@ unsigned int sim_tapdev_read(int devidx, unsigned char *buf,
 {
   int ret;
 
-  if (!sim_tapdev_avail(devidx))
+  if (gtapdevfd[devidx] < 0)
     {
       return 0;
     }
 
+#ifdef CONFIG_SIM_NETDEV_TAP_THREAD
+  if (g_rxring[devidx] != NULL)
+    {
+      struct tapdev_ring_s *ring = g_rxring[devidx];
+      struct tapdev_frame_s *frame;
+
+      if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == ring->tail)
+        {
+          return 0;
+        }
+
+      frame = &ring->frame[ring->tail & (TAPDEV_RXRING - 1)];
+      ret = frame->len < buflen ? frame->len : buflen;
+      memcpy(buf, frame->data, ret);
+      __atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_RELEASE);
+
+      dump_ethhdr("read", buf, ret);
+      return ret;
+    }
+#endif
+
+  /* The device is non-blocking, the caller has already checked that a
+   * frame is there.
+   */
+
   ret = read(gtapdevfd[devidx], buf, buflen);
   if (ret < 0)
     {
-      syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -ret);
+      if (errno != EAGAIN)
+        {
+          syslog(LOG_ERR, "TAPDEV: read failed: %d\n", -errno);
+        }
+
       return 0;
     }
 
@@ -254,6 +254,15 @@ void host_sleepuntil(uint64_t nsec);
 int host_timerirq(void);
 int host_settimer(uint64_t nsec);
 
+/* sim_hostdoorbell.c *******************************************************/
+
+#ifdef CONFIG_SIM_RPMSG_DOORBELL
+int host_doorbell_watch(volatile uint32_t *seq, volatile uint32_t *waiting,
+                        bool busypoll);
+void host_doorbell_unwatch(int irq);
+void host_doorbell_ring(volatile uint32_t *seq, volatile uint32_t *waiting);
+#endif
+
 /* sim_sigdeliver.c *********************************************************/
 
 void sim_sigdeliver(void);
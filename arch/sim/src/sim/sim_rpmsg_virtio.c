@@ -26,7 +26,9 @@
 
 #include <string.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/drivers/addrenv.h>
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/rpmsg/rpmsg_virtio_lite.h>
@@ -40,6 +42,12 @@
 
 #define SIM_RPMSG_VIRTIO_WORK_DELAY   1
 
+#ifdef CONFIG_SIM_RPMSG_DOORBELL_BUSYPOLL
+#  define SIM_RPMSG_VIRTIO_BUSYPOLL   true
+#else
+#  define SIM_RPMSG_VIRTIO_BUSYPOLL   false
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -47,10 +55,12 @@
 struct sim_rpmsg_virtio_shmem_s
 {
   volatile uintptr_t             base;
-  volatile unsigned int          seqs;
-  volatile unsigned int          seqm;
+  volatile uint32_t              seqs;
+  volatile uint32_t              seqm;
   volatile unsigned int          boots;
   volatile unsigned int          bootm;
+  volatile uint32_t              waits;
+  volatile uint32_t              waitm;
   struct rpmsg_virtio_lite_rsc_s rsc;
   char                           buf[0x10000];
 };
@@ -66,6 +76,7 @@ struct sim_rpmsg_virtio_dev_s
   struct simple_addrenv_s         addrenv[2];
   char                            cpuname[RPMSG_NAME_SIZE + 1];
   char                            shmemname[RPMSG_NAME_SIZE + 1];
+  int                             irq;
 
   /* Wdog for transmit */
 
@@ -76,6 +87,10 @@ struct sim_rpmsg_virtio_dev_s
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SIM_RPMSG_DOORBELL
+static void sim_rpmsg_virtio_doorbell(struct sim_rpmsg_virtio_dev_s *priv);
+#endif
+
 static const char *
 sim_rpmsg_virtio_get_cpuname(struct rpmsg_virtio_lite_s *dev)
 {
@@ -139,6 +154,10 @@ sim_rpmsg_virtio_get_resource(struct rpmsg_virtio_lite_s *dev)
       simple_addrenv_initialize(&priv->addrenv[0]);
     }
 
+#ifdef CONFIG_SIM_RPMSG_DOORBELL
+  sim_rpmsg_virtio_doorbell(priv);
+#endif
+
   return rsc;
 }
 
@@ -164,29 +183,82 @@ sim_rpmsg_virtio_register_callback(struct rpmsg_virtio_lite_s *dev,
   return 0;
 }
 
-static void sim_rpmsg_virtio_work(wdparm_t arg)
+static void sim_rpmsg_virtio_check_seq(struct sim_rpmsg_virtio_dev_s *dev)
 {
-  struct sim_rpmsg_virtio_dev_s *dev = (struct sim_rpmsg_virtio_dev_s *)arg;
+  bool should_notify = false;
+
+  if (dev->master && dev->seq != dev->shmem->seqs)
+    {
+      dev->seq = dev->shmem->seqs;
+      should_notify = true;
+    }
+  else if (!dev->master && dev->seq != dev->shmem->seqm)
+    {
+      dev->seq = dev->shmem->seqm;
+      should_notify = true;
+    }
+
+  if (should_notify && dev->callback != NULL)
+    {
+      dev->callback(dev->arg, RPMSG_VIRTIO_LITE_NOTIFY_ALL);
+    }
+}
+
+#ifdef CONFIG_SIM_RPMSG_DOORBELL
+static int sim_rpmsg_virtio_interrupt(int irq, void *context, void *arg)
+{
+  struct sim_rpmsg_virtio_dev_s *dev = arg;
 
   if (dev->shmem != NULL)
     {
-      bool should_notify = false;
+      sim_rpmsg_virtio_check_seq(dev);
+    }
 
-      if (dev->master && dev->seq != dev->shmem->seqs)
-        {
-          dev->seq = dev->shmem->seqs;
-          should_notify = true;
-        }
-      else if (!dev->master && dev->seq != dev->shmem->seqm)
-        {
-          dev->seq = dev->shmem->seqm;
-          should_notify = true;
-        }
+  return OK;
+}
 
-      if (should_notify && dev->callback != NULL)
-        {
-          dev->callback(dev->arg, RPMSG_VIRTIO_LITE_NOTIFY_ALL);
-        }
+/* Take the kicks of the peer as interrupts, the wdog is the fallback if
+ * the host thread can not be started.
+ */
+
+static void sim_rpmsg_virtio_doorbell(struct sim_rpmsg_virtio_dev_s *priv)
+{
+  int irq;
+
+  if (priv->irq > 0)
+    {
+      return;
+    }
+
+  if (priv->master)
+    {
+      irq = host_doorbell_watch(&priv->shmem->seqs, &priv->shmem->waitm,
+                                SIM_RPMSG_VIRTIO_BUSYPOLL);
+    }
+  else
+    {
+      irq = host_doorbell_watch(&priv->shmem->seqm, &priv->shmem->waits,
+                                SIM_RPMSG_VIRTIO_BUSYPOLL);
+    }
+
+  if (irq < 0)
+    {
+      return;
+    }
+
+  irq_attach(irq, sim_rpmsg_virtio_interrupt, priv);
+  up_enable_irq(irq);
+  priv->irq = irq;
+}
+#endif
+
+static void sim_rpmsg_virtio_work(wdparm_t arg)
+{
+  struct sim_rpmsg_virtio_dev_s *dev = (struct sim_rpmsg_virtio_dev_s *)arg;
+
+  if (dev->shmem != NULL)
+    {
+      sim_rpmsg_virtio_check_seq(dev);
     }
 
   wd_start(&dev->wdog, SIM_RPMSG_VIRTIO_WORK_DELAY,
@@ -199,6 +271,16 @@ static int sim_rpmsg_virtio_notify(struct rpmsg_virtio_lite_s *dev,
   struct sim_rpmsg_virtio_dev_s *priv =
     container_of(dev, struct sim_rpmsg_virtio_dev_s, dev);
 
+#ifdef CONFIG_SIM_RPMSG_DOORBELL
+  if (priv->master)
+    {
+      host_doorbell_ring(&priv->shmem->seqm, &priv->shmem->waits);
+    }
+  else
+    {
+      host_doorbell_ring(&priv->shmem->seqs, &priv->shmem->waitm);
+    }
+#else
   if (priv->master)
     {
       priv->shmem->seqm++;
@@ -207,6 +289,7 @@ static int sim_rpmsg_virtio_notify(struct rpmsg_virtio_lite_s *dev,
     {
       priv->shmem->seqs++;
     }
+#endif
 
   return 0;
 }
@@ -25,6 +25,8 @@
  ****************************************************************************/
 
 #include <nuttx/nuttx.h>
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
 #include <nuttx/drivers/addrenv.h>
 #include <nuttx/rptun/rptun.h>
 #include <nuttx/list.h>
@@ -45,6 +47,12 @@
 #define SIM_RPTUN_STATUS_OK          0x02
 #define SIM_RPTUN_STATUS_NEED_RESET  0x04
 
+#ifdef CONFIG_SIM_RPMSG_DOORBELL_BUSYPOLL
+#  define SIM_RPTUN_BUSYPOLL         true
+#else
+#  define SIM_RPTUN_BUSYPOLL         false
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -56,6 +64,8 @@ struct sim_rptun_shmem_s
   volatile uint32_t         seqm;
   volatile uint32_t         boots;
   volatile uint32_t         bootm;
+  volatile uint32_t         waits;
+  volatile uint32_t         waitm;
   struct rptun_rsc_s        rsc;
   char                      buf[0x10000];
 };
@@ -73,12 +83,22 @@ struct sim_rptun_dev_s
   char                      cpuname[RPMSG_NAME_SIZE + 1];
   char                      shmemname[RPMSG_NAME_SIZE + 1];
   pid_t                     pid;
+  int                       irq;
 
   /* Wdog for transmit */
 
   struct wdog_s             wdog;
 };
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_SIM_RPMSG_DOORBELL
+static void sim_rptun_doorbell_start(struct sim_rptun_dev_s *priv);
+static void sim_rptun_doorbell_stop(struct sim_rptun_dev_s *priv);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -193,6 +213,10 @@ sim_rptun_get_resource(struct rptun_dev_s *dev)
       simple_addrenv_initialize(&priv->addrenv[0]);
     }
 
+#ifdef CONFIG_SIM_RPMSG_DOORBELL
+  sim_rptun_doorbell_start(priv);
+#endif
+
   return &priv->shmem->rsc;
 }
 
@@ -258,6 +282,10 @@ static int sim_rptun_stop(struct rptun_dev_s *dev)
 
   if (priv->shmem && (priv->shmem->boots & SIM_RPTUN_STATUS_OK))
     {
+#ifdef CONFIG_SIM_RPMSG_DOORBELL
+      sim_rptun_doorbell_stop(priv);
+#endif
+
       host_freeshmem(priv->shmem);
       priv->shmem = NULL;
       host_unlinkshmem(priv->shmemname);
@@ -271,6 +299,16 @@ static int sim_rptun_notify(struct rptun_dev_s *dev, uint32_t vqid)
   struct sim_rptun_dev_s *priv = container_of(dev,
                                  struct sim_rptun_dev_s, rptun);
 
+#ifdef CONFIG_SIM_RPMSG_DOORBELL
+  if (priv->master)
+    {
+      host_doorbell_ring(&priv->shmem->seqm, &priv->shmem->waits);
+    }
+  else
+    {
+      host_doorbell_ring(&priv->shmem->seqs, &priv->shmem->waitm);
+    }
+#else
   if (priv->master)
     {
       priv->shmem->seqm++;
@@ -279,6 +317,7 @@ static int sim_rptun_notify(struct rptun_dev_s *dev, uint32_t vqid)
     {
       priv->shmem->seqs++;
     }
+#endif
 
   return 0;
 }
@@ -327,35 +366,100 @@ static void sim_rptun_check_reset(struct sim_rptun_dev_s *priv)
     }
 }
 
+static void sim_rptun_check_seq(struct sim_rptun_dev_s *dev)
+{
+  bool should_notify = false;
+
+  if (dev->master && dev->seq != dev->shmem->seqs)
+    {
+      dev->seq = dev->shmem->seqs;
+      should_notify = true;
+    }
+  else if (!dev->master && dev->seq != dev->shmem->seqm)
+    {
+      dev->seq = dev->shmem->seqm;
+      should_notify = true;
+    }
+
+  if (should_notify && dev->callback != NULL)
+    {
+      dev->callback(dev->arg, RPTUN_NOTIFY_ALL);
+    }
+}
+
+#ifdef CONFIG_SIM_RPMSG_DOORBELL
+static int sim_rptun_interrupt(int irq, void *context, void *arg)
+{
+  struct sim_rptun_dev_s *dev = arg;
+
+  if (dev->shmem != NULL)
+    {
+      sim_rptun_check_seq(dev);
+    }
+
+  return OK;
+}
+
+/* Take the kicks of the peer as interrupts from a host thread that
+ * waits on the sequence, the wdog still checks the commands and is the
+ * fallback if the thread can not be started.
+ */
+
+static void sim_rptun_doorbell_start(struct sim_rptun_dev_s *priv)
+{
+  int irq;
+
+  if (priv->irq > 0)
+    {
+      return;
+    }
+
+  if (priv->master)
+    {
+      irq = host_doorbell_watch(&priv->shmem->seqs, &priv->shmem->waitm,
+                                SIM_RPTUN_BUSYPOLL);
+    }
+  else
+    {
+      irq = host_doorbell_watch(&priv->shmem->seqm, &priv->shmem->waits,
+                                SIM_RPTUN_BUSYPOLL);
+    }
+
+  if (irq < 0)
+    {
+      return;
+    }
+
+  irq_attach(irq, sim_rptun_interrupt, priv);
+  up_enable_irq(irq);
+  priv->irq = irq;
+}
+
+static void sim_rptun_doorbell_stop(struct sim_rptun_dev_s *priv)
+{
+  if (priv->irq > 0)
+    {
+      up_disable_irq(priv->irq);
+      host_doorbell_unwatch(priv->irq);
+      irq_detach(priv->irq);
+      priv->irq = 0;
+    }
+}
+#endif
+
 static void sim_rptun_work(wdparm_t arg)
 {
   struct sim_rptun_dev_s *dev = (struct sim_rptun_dev_s *)arg;
 
   if (dev->shmem != NULL)
     {
-      bool should_notify = false;
-
       sim_rptun_check_cmd(dev);
 
       /* Check if master/slave need to reset */
 
       sim_rptun_check_reset(dev);
 
-      if (dev->master && dev->seq != dev->shmem->seqs)
-        {
-          dev->seq = dev->shmem->seqs;
-          should_notify = true;
-        }
-      else if (!dev->master && dev->seq != dev->shmem->seqm)
-        {
-          dev->seq = dev->shmem->seqm;
-          should_notify = true;
-        }
-
-      if (should_notify && dev->callback != NULL)
-        {
-          dev->callback(dev->arg, RPTUN_NOTIFY_ALL);
-        }
+      sim_rptun_check_seq(dev);
     }
 
   wd_start(&dev->wdog, SIM_RPTUN_WORK_DELAY, sim_rptun_work, (wdparm_t)dev);
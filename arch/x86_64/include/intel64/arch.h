@@ -271,6 +271,13 @@
 #define MSR_IA32_TSC_DEADLINE          0x6e0
 #define MSR_IA32_TSC_ADJUST            0x3b
 
+#define MSR_IA32_PMC0                  0x0c1      /* General purpose counters */
+#define MSR_IA32_PERFEVTSEL0           0x186      /* Their event selection */
+#  define PERFEVTSEL_USR               (1 << 16)  /* Count at CPL > 0 */
+#  define PERFEVTSEL_OS                (1 << 17)  /* Count at CPL 0 */
+#  define PERFEVTSEL_EN                (1 << 22)  /* Enable the counter */
+#define MSR_IA32_PERF_GLOBAL_CTRL      0x38f      /* Architectural PMU v2 */
+
 #define MSR_IA32_APIC_BASE             0x01b
 #  define MSR_IA32_APIC_EN             0x800
 #  define MSR_IA32_APIC_X2APIC         0x400
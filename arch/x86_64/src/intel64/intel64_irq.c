@@ -62,6 +62,9 @@ struct intel64_irq_priv_s
 {
   bool busy;
   bool msi;
+#ifdef CONFIG_SMP
+  uint8_t cpu;  /* The CPU that MSI/MSI-X is sent to */
+#endif
 };
 
 /****************************************************************************
@@ -658,6 +661,40 @@ int up_prioritize_irq(int irq, int priority)
 }
 #endif
 
+/****************************************************************************
+ * Name: up_affinity_irq
+ *
+ * Description:
+ *   Set an IRQ affinity by software.  Only MSI/MSI-X vectors are routed,
+ *   to the first CPU in cpuset.  The device is told when the vector is
+ *   connected again, see pci_affinity_irq().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+void up_affinity_irq(int irq, cpu_set_t cpuset)
+{
+  irqstate_t flags;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if (CPU_ISSET(cpu, &cpuset))
+        {
+          break;
+        }
+    }
+
+  flags = spin_lock_irqsave(&g_irq_spinlock);
+  if (cpu < CONFIG_SMP_NCPUS && g_irq_priv[irq].msi)
+    {
+      g_irq_priv[irq].cpu = cpu;
+    }
+
+  spin_unlock_irqrestore(&g_irq_spinlock, flags);
+}
+#endif
+
 /****************************************************************************
  * Name: up_trigger_irq
  *
@@ -739,6 +776,9 @@ int up_alloc_irq_msi(uint8_t busno, uint32_t devfn, int *pirq, int num)
       ASSERT(g_irq_priv[irq + i].busy == false);
       g_irq_priv[irq + i].busy = true;
       g_irq_priv[irq + i].msi  = true;
+#ifdef CONFIG_SMP
+      g_irq_priv[irq + i].cpu  = up_cpu_index();
+#endif
       pirq[i] = irq + i;
     }
 
@@ -785,8 +825,14 @@ int up_connect_irq(const int *irq, int num, uintptr_t *mar, uint32_t *mdr)
 
   if (mar != NULL)
     {
+#ifdef CONFIG_SMP
+      *mar = X86_64_MAR_DEST |
+        (x86_64_cpu_to_loapic(g_irq_priv[irq[0]].cpu) <<
+         PCI_MSI_DATA_CPUID_SHIFT);
+#else
       *mar = X86_64_MAR_DEST |
         (up_apic_cpu_id() << PCI_MSI_DATA_CPUID_SHIFT);
+#endif
     }
 
   if (mdr != NULL)
@@ -27,6 +27,8 @@
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
 
+#include <errno.h>
+
 #include "x86_64_internal.h"
 
 #ifdef CONFIG_ARCH_HAVE_PERF_EVENTS
@@ -68,3 +70,105 @@ void up_perf_convert(clock_t elapsed, struct timespec *ts)
 }
 #endif
 
+#ifdef CONFIG_ARCH_HAVE_PMU
+
+/* The architectural events of CPUID leaf 0xa that match the PMU_EVENT_*:
+ * the event select and unit mask, and the bit of CPUID.0AH:EBX that says
+ * when the event is not available.  There is no architectural stall event.
+ */
+
+static int pmu_event_number(int event, FAR int *unavail)
+{
+  switch (event)
+    {
+      case PMU_EVENT_CYCLES:
+        *unavail = 0;
+        return 0x003c;                 /* Unhalted core cycles */
+      case PMU_EVENT_INSTRUCTIONS:
+        *unavail = 1;
+        return 0x00c0;                 /* Instructions retired */
+      case PMU_EVENT_CACHE_MISSES:
+        *unavail = 4;
+        return 0x412e;                 /* LLC misses */
+      case PMU_EVENT_BRANCH_MISSES:
+        *unavail = 6;
+        return 0x00c5;                 /* Branch mispredicts retired */
+      default:
+        return -ENOTSUP;
+    }
+}
+
+/****************************************************************************
+ * Name: up_pmu_*
+ *
+ * Description:
+ *   The general purpose counters of the architectural PMU of the calling
+ *   core, see include/nuttx/arch.h.  CPUs without one (CPUID leaf 0xa
+ *   version 0) report no counter.
+ *
+ ****************************************************************************/
+
+int up_pmu_ncounters(void)
+{
+  uint32_t eax;
+  uint32_t ebx;
+  uint32_t ecx;
+  uint32_t edx;
+
+  x86_64_cpuid(0xa, 0, &eax, &ebx, &ecx, &edx);
+  return (eax & 0xff) == 0 ? 0 : (eax >> 8) & 0xff;
+}
+
+int up_pmu_start(int counter, int event)
+{
+  uint32_t eax;
+  uint32_t ebx;
+  uint32_t ecx;
+  uint32_t edx;
+  int unavail;
+  int number;
+
+  if (counter < 0 || counter >= up_pmu_ncounters())
+    {
+      return -EINVAL;
+    }
+
+  number = pmu_event_number(event, &unavail);
+  if (number < 0)
+    {
+      return number;
+    }
+
+  /* EBX has a bit per event for the first EAX[31:24] events */
+
+  x86_64_cpuid(0xa, 0, &eax, &ebx, &ecx, &edx);
+  if (unavail >= ((eax >> 24) & 0xff) || (ebx & (1 << unavail)) != 0)
+    {
+      return -ENOTSUP;
+    }
+
+  write_msr(MSR_IA32_PERFEVTSEL0 + counter, 0);
+  write_msr(MSR_IA32_PMC0 + counter, 0);
+  write_msr(MSR_IA32_PERFEVTSEL0 + counter,
+            number | PERFEVTSEL_USR | PERFEVTSEL_OS | PERFEVTSEL_EN);
+
+  if ((eax & 0xff) >= 2)
+    {
+      write_msr(MSR_IA32_PERF_GLOBAL_CTRL,
+                read_msr(MSR_IA32_PERF_GLOBAL_CTRL) | (1ul << counter));
+    }
+
+  return (eax >> 16) & 0xff;
+}
+
+void up_pmu_stop(int counter)
+{
+  write_msr(MSR_IA32_PERFEVTSEL0 + counter, 0);
+}
+
+uint64_t up_pmu_read(int counter)
+{
+  return read_msr(MSR_IA32_PMC0 + counter);
+}
+#endif
+
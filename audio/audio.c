@@ -95,6 +95,8 @@ static ssize_t  audio_write(FAR struct file *filep,
 static int      audio_ioctl(FAR struct file *filep,
                             int cmd,
                             unsigned long arg);
+static int      audio_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
 #ifdef CONFIG_AUDIO_MULTI_SESSION
 static int      audio_start(FAR struct audio_upperhalf_s *upper,
                             FAR void *session);
@@ -123,6 +125,7 @@ static const struct file_operations g_audioops =
   audio_write, /* write */
   NULL,        /* seek */
   audio_ioctl, /* ioctl */
+  audio_mmap,  /* mmap */
 };
 
 /****************************************************************************
@@ -666,6 +669,38 @@ static int audio_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: audio_mmap
+ *
+ * Description:
+ *   Map the ring buffer of the lower half, if it supports streaming from a
+ *   mapped ring.
+ *
+ ****************************************************************************/
+
+static int audio_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct audio_upperhalf_s *upper = inode->i_private;
+  FAR struct audio_lowerhalf_s *lower = upper->dev;
+  int ret;
+
+  if (lower->ops->mmap == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  ret = nxmutex_lock(&upper->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = lower->ops->mmap(lower, map);
+  nxmutex_unlock(&upper->lock);
+  return ret;
+}
+
 /****************************************************************************
  * Name: audio_dequeuebuffer
  *
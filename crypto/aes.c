@@ -36,6 +36,16 @@
 #include <sys/types.h>
 #include <crypto/aes.h>
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_SW_AES_ACCEL
+/* Set by aes_accel_initialize() when the CPU can do better */
+
+FAR const struct aes_accel_s *aes_accel;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -845,6 +855,31 @@ void aes_ct_bitslice_decrypt(unsigned num_rounds,
 
 int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 {
+#ifdef CONFIG_CRYPTO_SW_AES_ACCEL
+  ctx->accel = aes_accel;
+  if (ctx->accel != NULL)
+    {
+      FAR uint8_t *rk = (FAR uint8_t *)ctx->sk_exp;
+      uint32_t skey[60];
+      unsigned u;
+
+      ctx->num_rounds = aes_keysched_base(skey, key, len);
+      if (ctx->num_rounds == 0)
+        {
+          return -1;
+        }
+
+      for (u = 0; u < ((ctx->num_rounds + 1) << 2); u++)
+        {
+          enc32le(rk + (u << 2), skey[u]);
+        }
+
+      explicit_bzero(skey, sizeof(skey));
+      ctx->accel->setkey(ctx);
+      return 0;
+    }
+#endif
+
   ctx->num_rounds = aes_ct_keysched(ctx->sk, key, len);
   if (ctx->num_rounds == 0)
     {
@@ -858,6 +893,14 @@ int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef CONFIG_CRYPTO_SW_AES_ACCEL
+  if (ctx->accel != NULL)
+    {
+      ctx->accel->encrypt_ecb(ctx, src, dst, num_blocks);
+      return;
+    }
+#endif
+
   while (num_blocks > 0)
     {
       uint32_t q[8];
@@ -908,6 +951,14 @@ void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
 void aes_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef CONFIG_CRYPTO_SW_AES_ACCEL
+  if (ctx->accel != NULL)
+    {
+      ctx->accel->decrypt_ecb(ctx, src, dst, num_blocks);
+      return;
+    }
+#endif
+
   while (num_blocks > 0)
     {
       uint32_t q[8];
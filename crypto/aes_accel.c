@@ -0,0 +1,427 @@
+/****************************************************************************
+ * crypto/aes_accel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <endian.h>
+#include <debug.h>
+
+#include <crypto/aes.h>
+#include <crypto/gmac.h>
+
+#if defined(__aarch64__) && defined(CONFIG_ARCH_FPU) && \
+    !defined(CONFIG_ARCH_SIM) && \
+    (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#  include <arm_neon.h>
+#  define AES_ACCEL_ARMV8CE 1
+#elif defined(__x86_64__)
+#  define AES_ACCEL_AESNI 1
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Offset of the decryption round keys in AES_CTX.sk_exp[], right after
+ * the largest (AES-256) encryption schedule.
+ */
+
+#define AES_ACCEL_DKEYS        ((AES_MAXROUNDS + 1) * 16)
+
+/* ID_AA64ISAR0_EL1.AES: 1 - AESE/AESD/AESMC/AESIMC, 2 - PMULL as well */
+
+#define ID_AA64ISAR0_AES(r)    (((r) >> 4) & 0xf)
+
+/* CPUID.01H:ECX */
+
+#define CPUID_ECX_PCLMULQDQ    (1 << 1)
+#define CPUID_ECX_AES          (1 << 25)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef AES_ACCEL_AESNI
+typedef uint64_t aes_v128_t __attribute__((vector_size(16)));
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#if defined(AES_ACCEL_ARMV8CE) || defined(AES_ACCEL_AESNI)
+static void aes_accel_setkey(FAR AES_CTX *ctx);
+static void aes_accel_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                                  FAR uint8_t *dst, size_t num_blocks);
+static void aes_accel_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                                  FAR uint8_t *dst, size_t num_blocks);
+static void ghash_update_clmul(FAR GHASH_CTX *ctx, FAR uint8_t *x,
+                               size_t len);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if defined(AES_ACCEL_ARMV8CE) || defined(AES_ACCEL_AESNI)
+static const struct aes_accel_s g_aes_accel =
+{
+  aes_accel_setkey,
+  aes_accel_encrypt_ecb,
+  aes_accel_decrypt_ecb
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef AES_ACCEL_ARMV8CE
+
+static void aes_accel_setkey(FAR AES_CTX *ctx)
+{
+  FAR uint8_t *ek = (FAR uint8_t *)ctx->sk_exp;
+  FAR uint8_t *dk = ek + AES_ACCEL_DKEYS;
+  unsigned nr = ctx->num_rounds;
+  unsigned i;
+
+  /* Equivalent inverse cipher: the encryption keys in reverse order with
+   * InvMixColumns applied to all but the first and the last one.
+   */
+
+  vst1q_u8(dk, vld1q_u8(ek + nr * 16));
+  for (i = 1; i < nr; i++)
+    {
+      vst1q_u8(dk + i * 16, vaesimcq_u8(vld1q_u8(ek + (nr - i) * 16)));
+    }
+
+  vst1q_u8(dk + nr * 16, vld1q_u8(ek));
+}
+
+static void aes_accel_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                                  FAR uint8_t *dst, size_t num_blocks)
+{
+  FAR const uint8_t *rk = (FAR const uint8_t *)ctx->sk_exp;
+  unsigned nr = ctx->num_rounds;
+
+  while (num_blocks-- > 0)
+    {
+      uint8x16_t x = vld1q_u8(src);
+      unsigned i;
+
+      for (i = 0; i < nr - 1; i++)
+        {
+          x = vaesmcq_u8(vaeseq_u8(x, vld1q_u8(rk + i * 16)));
+        }
+
+      x = vaeseq_u8(x, vld1q_u8(rk + i * 16));
+      x = veorq_u8(x, vld1q_u8(rk + nr * 16));
+      vst1q_u8(dst, x);
+
+      src += 16;
+      dst += 16;
+    }
+}
+
+static void aes_accel_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                                  FAR uint8_t *dst, size_t num_blocks)
+{
+  FAR const uint8_t *rk = (FAR const uint8_t *)ctx->sk_exp +
+                          AES_ACCEL_DKEYS;
+  unsigned nr = ctx->num_rounds;
+
+  while (num_blocks-- > 0)
+    {
+      uint8x16_t x = vld1q_u8(src);
+      unsigned i;
+
+      for (i = 0; i < nr - 1; i++)
+        {
+          x = vaesimcq_u8(vaesdq_u8(x, vld1q_u8(rk + i * 16)));
+        }
+
+      x = vaesdq_u8(x, vld1q_u8(rk + i * 16));
+      x = veorq_u8(x, vld1q_u8(rk + nr * 16));
+      vst1q_u8(dst, x);
+
+      src += 16;
+      dst += 16;
+    }
+}
+
+static inline void clmul64(uint64_t a, uint64_t b,
+                           FAR uint64_t *lo, FAR uint64_t *hi)
+{
+  uint64x2_t r;
+
+  r = vreinterpretq_u64_p128(vmull_p64((poly64_t)a, (poly64_t)b));
+
+  *lo = vgetq_lane_u64(r, 0);
+  *hi = vgetq_lane_u64(r, 1);
+}
+
+static bool aes_accel_probe(FAR bool *clmul)
+{
+  uint64_t isar0;
+
+  __asm__ volatile ("mrs %0, id_aa64isar0_el1" : "=r"(isar0));
+
+  *clmul = ID_AA64ISAR0_AES(isar0) >= 2;
+  return ID_AA64ISAR0_AES(isar0) >= 1;
+}
+
+#elif defined(AES_ACCEL_AESNI)
+
+static inline aes_v128_t aesni_load(FAR const uint8_t *p)
+{
+  aes_v128_t v;
+
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static void aes_accel_setkey(FAR AES_CTX *ctx)
+{
+  FAR uint8_t *ek = (FAR uint8_t *)ctx->sk_exp;
+  FAR uint8_t *dk = ek + AES_ACCEL_DKEYS;
+  unsigned nr = ctx->num_rounds;
+  unsigned i;
+
+  /* Equivalent inverse cipher, as expected by AESDEC */
+
+  memcpy(dk, ek + nr * 16, 16);
+  for (i = 1; i < nr; i++)
+    {
+      aes_v128_t k = aesni_load(ek + (nr - i) * 16);
+
+      __asm__ ("aesimc %1, %0" : "=x"(k) : "x"(k));
+      memcpy(dk + i * 16, &k, 16);
+    }
+
+  memcpy(dk + nr * 16, ek, 16);
+}
+
+static void aes_accel_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                                  FAR uint8_t *dst, size_t num_blocks)
+{
+  FAR const uint8_t *rk = (FAR const uint8_t *)ctx->sk_exp;
+  unsigned nr = ctx->num_rounds;
+
+  while (num_blocks-- > 0)
+    {
+      aes_v128_t x = aesni_load(src) ^ aesni_load(rk);
+      aes_v128_t k;
+      unsigned i;
+
+      for (i = 1; i < nr; i++)
+        {
+          k = aesni_load(rk + i * 16);
+          __asm__ ("aesenc %1, %0" : "+x"(x) : "x"(k));
+        }
+
+      k = aesni_load(rk + nr * 16);
+      __asm__ ("aesenclast %1, %0" : "+x"(x) : "x"(k));
+      memcpy(dst, &x, 16);
+
+      src += 16;
+      dst += 16;
+    }
+}
+
+static void aes_accel_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
+                                  FAR uint8_t *dst, size_t num_blocks)
+{
+  FAR const uint8_t *rk = (FAR const uint8_t *)ctx->sk_exp +
+                          AES_ACCEL_DKEYS;
+  unsigned nr = ctx->num_rounds;
+
+  while (num_blocks-- > 0)
+    {
+      aes_v128_t x = aesni_load(src) ^ aesni_load(rk);
+      aes_v128_t k;
+      unsigned i;
+
+      for (i = 1; i < nr; i++)
+        {
+          k = aesni_load(rk + i * 16);
+          __asm__ ("aesdec %1, %0" : "+x"(x) : "x"(k));
+        }
+
+      k = aesni_load(rk + nr * 16);
+      __asm__ ("aesdeclast %1, %0" : "+x"(x) : "x"(k));
+      memcpy(dst, &x, 16);
+
+      src += 16;
+      dst += 16;
+    }
+}
+
+static inline void clmul64(uint64_t a, uint64_t b,
+                           FAR uint64_t *lo, FAR uint64_t *hi)
+{
+  aes_v128_t x;
+  aes_v128_t y;
+
+  x[0] = a;
+  x[1] = 0;
+  y[0] = b;
+  y[1] = 0;
+
+  __asm__ ("pclmulqdq $0x00, %1, %0" : "+x"(x) : "x"(y));
+  *lo = x[0];
+  *hi = x[1];
+}
+
+static bool aes_accel_probe(FAR bool *clmul)
+{
+  uint32_t eax = 1;
+  uint32_t ebx;
+  uint32_t ecx = 0;
+  uint32_t edx;
+
+  __asm__ volatile ("cpuid"
+                    : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+
+  *clmul = (ecx & CPUID_ECX_PCLMULQDQ) != 0;
+  return (ecx & CPUID_ECX_AES) != 0;
+}
+
+#endif
+
+#if defined(AES_ACCEL_ARMV8CE) || defined(AES_ACCEL_AESNI)
+
+static inline uint64_t ghash_load64(FAR const uint8_t *p)
+{
+  uint64_t v;
+
+  memcpy(&v, p, sizeof(v));
+  return be64toh(v);
+}
+
+static inline void ghash_store64(FAR uint8_t *p, uint64_t v)
+{
+  v = htobe64(v);
+  memcpy(p, &v, sizeof(v));
+}
+
+/* GHASH with a carry-less multiplier: the blocks are read as big endian
+ * 128-bit numbers, multiplied with Karatsuba, shifted left by one for the
+ * bit reflected representation and reduced modulo x^128 + x^7 + x^2 + x + 1
+ * without any table (Gueron & Kounavis, "Intel Carry-Less Multiplication
+ * Instruction and its Usage for Computing the GCM Mode", algorithm 5).
+ */
+
+static void ghash_update_clmul(FAR GHASH_CTX *ctx, FAR uint8_t *x,
+                               size_t len)
+{
+  uint64_t h1 = ghash_load64(ctx->H);
+  uint64_t h0 = ghash_load64(ctx->H + 8);
+  uint64_t s1 = ghash_load64(ctx->Z);
+  uint64_t s0 = ghash_load64(ctx->Z + 8);
+
+  for (; len >= GMAC_BLOCK_LEN; len -= GMAC_BLOCK_LEN)
+    {
+      uint64_t p0lo;
+      uint64_t p0hi;
+      uint64_t p1lo;
+      uint64_t p1hi;
+      uint64_t pmlo;
+      uint64_t pmhi;
+      uint64_t r0;
+      uint64_t r1;
+      uint64_t r2;
+      uint64_t r3;
+      uint64_t d;
+
+      s1 ^= ghash_load64(x);
+      s0 ^= ghash_load64(x + 8);
+      x  += GMAC_BLOCK_LEN;
+
+      clmul64(s0, h0, &p0lo, &p0hi);
+      clmul64(s1, h1, &p1lo, &p1hi);
+      clmul64(s0 ^ s1, h0 ^ h1, &pmlo, &pmhi);
+      pmlo ^= p0lo ^ p1lo;
+      pmhi ^= p0hi ^ p1hi;
+
+      r0 = p0lo;
+      r1 = p0hi ^ pmlo;
+      r2 = p1lo ^ pmhi;
+      r3 = p1hi;
+
+      r3 = (r3 << 1) | (r2 >> 63);
+      r2 = (r2 << 1) | (r1 >> 63);
+      r1 = (r1 << 1) | (r0 >> 63);
+      r0 <<= 1;
+
+      d  = r1 ^ (r0 << 63) ^ (r0 << 62) ^ (r0 << 57);
+      s1 = r3 ^ d ^ (d >> 1) ^ (d >> 2) ^ (d >> 7);
+      s0 = r2 ^ r0 ^ (r0 >> 1) ^ (d << 63) ^ (r0 >> 2) ^ (d << 62) ^
+           (r0 >> 7) ^ (d << 57);
+    }
+
+  ghash_store64(ctx->S, s1);
+  ghash_store64(ctx->S + 8, s0);
+  memcpy(ctx->Z, ctx->S, GMAC_BLOCK_LEN);
+}
+
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aes_accel_initialize
+ *
+ * Description:
+ *   Check what the CPU offers and switch the software AES and the GHASH of
+ *   GCM/GMAC to the matching kernels.  Must run before the first key is
+ *   set, keys set before keep using the portable code.
+ *
+ ****************************************************************************/
+
+void aes_accel_initialize(void)
+{
+#if defined(AES_ACCEL_ARMV8CE) || defined(AES_ACCEL_AESNI)
+  bool clmul;
+
+  if (aes_accel_probe(&clmul))
+    {
+      aes_accel = &g_aes_accel;
+      cryptinfo("AES instructions enabled\n");
+    }
+
+  if (clmul)
+    {
+      ghash_update = ghash_update_clmul;
+      cryptinfo("carry-less multiply enabled for GHASH\n");
+    }
+#endif
+}
@@ -34,7 +34,9 @@
 #include <poll.h>
 #include <debug.h>
 #include <errno.h>
+#include <crypto/aes.h>
 #include <crypto/cryptodev.h>
+#include <crypto/sha2.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/mutex.h>
 #include <nuttx/kmalloc.h>
@@ -563,6 +565,7 @@ int crypto_invoke(FAR struct cryptop *crp)
     {
       crp->crp_etype = -EINVAL;
       nxmutex_unlock(&g_crypto_lock);
+      crypto_done(crp);
       return 0;
     }
 
@@ -587,7 +590,14 @@ int crypto_invoke(FAR struct cryptop *crp)
   crypto_drivers[hid].cc_bytes += crp->crp_ilen;
 
   error = crypto_drivers[hid].cc_process(crp);
-  if (error)
+  if (error == -EINPROGRESS && crp->crp_callback != NULL)
+    {
+      /* The driver calls crypto_done() when the request is completed */
+
+      nxmutex_unlock(&g_crypto_lock);
+      return 0;
+    }
+  else if (error)
     {
       if (error == -ERESTART)
         {
@@ -603,6 +613,7 @@ int crypto_invoke(FAR struct cryptop *crp)
     }
 
   nxmutex_unlock(&g_crypto_lock);
+  crypto_done(crp);
   return 0;
 
 migrate:
@@ -621,9 +632,21 @@ migrate:
 
   crp->crp_etype = -EAGAIN;
   nxmutex_unlock(&g_crypto_lock);
+  crypto_done(crp);
   return 0;
 }
 
+/* Complete a crypto request, may be called from an interrupt handler. */
+
+void crypto_done(FAR struct cryptop *crp)
+{
+  crp->crp_flags |= CRYPTO_F_DONE;
+  if (crp->crp_callback != NULL)
+    {
+      crp->crp_callback(crp);
+    }
+}
+
 /* Release a set of crypto descriptors. */
 
 void crypto_freereq(FAR struct cryptop *crp)
@@ -726,6 +749,14 @@ out:
 
 int up_cryptoinitialize(void)
 {
+#ifdef CONFIG_CRYPTO_SW_AES_ACCEL
+  aes_accel_initialize();
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA_ACCEL
+  sha_accel_initialize();
+#endif
+
 #ifdef CONFIG_CRYPTO_ALGTEST
   int ret = crypto_test();
   if (ret)
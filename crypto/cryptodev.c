@@ -47,11 +47,25 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/drivers/drivers.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
 
 #include <crypto/xform.h>
 #include <crypto/cryptodev.h>
 #include <crypto/cryptosoft.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LPWORK
+#  define CRYPTODEV_WORK LPWORK
+#else
+#  define CRYPTODEV_WORK HPWORK
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -72,11 +86,30 @@ int cryptodevallowsoft = 0;
  * Private Types
  ****************************************************************************/
 
+/* A symmetric operation in flight, queued on its session when async */
+
+struct cryptodev_req
+{
+  TAILQ_ENTRY(cryptodev_req) next;
+  FAR struct csession *cse;
+  FAR struct cryptop *crp;
+  sem_t done;         /* Posted when a synchronous operation completes */
+  bool async;
+  uint32_t reqid;
+  int status;
+};
+
 struct csession
 {
   TAILQ_ENTRY(csession) next;
   uint64_t sid;
   uint32_t ses;
+  FAR struct fcrypt *fcr;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  TAILQ_HEAD(cryptodev_reqlist, cryptodev_req) pending;
+  struct work_s work;
+  int nreqs;          /* Operations queued or in flight */
+#endif
 
   uint32_t cipher;
   uint32_t mac;
@@ -96,6 +129,10 @@ struct fcrypt
 {
   TAILQ_HEAD(csessionlist, csession) csessions;
   TAILQ_HEAD(cryptkoplist, cryptkop) crpk_ret;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  TAILQ_HEAD(cryptodev_retlist, cryptodev_req) crp_ret;
+  spinlock_t lock;    /* Protects the pending and crp_ret lists */
+#endif
   int sesn;
   FAR struct pollfd *fds;
 };
@@ -137,6 +174,11 @@ static int csefree(FAR struct csession *);
 
 static int cryptodev_op(FAR struct csession *,
                         FAR struct crypt_op *);
+static int cryptodev_cb(FAR struct cryptop *);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int cryptodev_getstatus(FAR struct fcrypt *, FAR struct crypt_op *);
+static void cryptodev_cancel(FAR struct csession *);
+#endif
 static int cryptodev_key(FAR struct fcrypt *, FAR struct crypt_kop *);
 static int cryptodevkey_cb(FAR struct cryptkop *);
 static int cryptodev_getkeystatus(FAR struct fcrypt *,
@@ -209,11 +251,13 @@ static int cryptof_ioctl(FAR struct file *filep,
   FAR struct fcrypt *fcr = filep->f_priv;
   FAR struct csession *cse;
   FAR struct session_op *sop;
+  FAR struct crypt_mop *mop;
   FAR struct crypt_op *cop;
   bool txform = false;
   bool thash = false;
   uint64_t sid;
   uint32_t ses;
+  unsigned i;
   int error = 0;
 
   switch (cmd)
@@ -355,6 +399,13 @@ bail:
             return -EINVAL;
           }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+        if (cse->nreqs > 0)
+          {
+            return -EBUSY;
+          }
+#endif
+
         csedelete(fcr, cse);
         error = csefree(cse);
         break;
@@ -368,6 +419,31 @@ bail:
 
         error = cryptodev_op(cse, cop);
         break;
+      case CIOCCRYPTM:
+        mop = (FAR struct crypt_mop *)arg;
+        for (i = 0; i < mop->count; i++)
+          {
+            cse = csefind(fcr, mop->ops[i].ses);
+            if (cse == NULL)
+              {
+                error = -EINVAL;
+                break;
+              }
+
+            error = cryptodev_op(cse, &mop->ops[i]);
+            if (error < 0)
+              {
+                break;
+              }
+          }
+
+        mop->count = i;
+        break;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      case CIOCCRYPTRET:
+        error = cryptodev_getstatus(fcr, (FAR struct crypt_op *)arg);
+        break;
+#endif
       case CIOCKEY:
         error = cryptodev_key(fcr, (FAR struct crypt_kop *)arg);
         break;
@@ -377,6 +453,21 @@ bail:
       case CIOCASYMFEAT:
         error = crypto_getfeat((FAR int *)arg);
         break;
+#ifdef CONFIG_CRYPTO_IMGHASH
+      case CIOCIMGHASH:
+        {
+          FAR struct crypt_img *img = (FAR struct crypt_img *)arg;
+          FAR struct file *imgfilep;
+
+          error = file_get(img->fd, &imgfilep);
+          if (error >= 0)
+            {
+              error = crypto_imghash(imgfilep, img);
+              file_put(imgfilep);
+            }
+        }
+        break;
+#endif
       default:
         error = -ENOTTY;
     }
@@ -384,14 +475,185 @@ bail:
   return error;
 }
 
+/* Hand a request to its driver, the completion is reported to
+ * cryptodev_cb() through crypto_done().
+ */
+
+static void cryptodev_dispatch(FAR struct cryptop *crp)
+{
+  uint32_t hid;
+  int error;
+
+  /* try the fast path first */
+
+  crp->crp_flags = CRYPTO_F_IOV | CRYPTO_F_NOQUEUE;
+  hid = (crp->crp_sid >> 32) & 0xffffffff;
+  if (hid >= crypto_drivers_num)
+    {
+      goto dispatch;
+    }
+
+  if (crypto_drivers[hid].cc_flags & CRYPTOCAP_F_SOFTWARE)
+    {
+      goto dispatch;
+    }
+
+  if (crypto_drivers[hid].cc_process == NULL)
+    {
+      goto dispatch;
+    }
+
+  error = crypto_drivers[hid].cc_process(crp);
+  if (error == -EINPROGRESS)
+    {
+      return;
+    }
+  else if (error)
+    {
+      /* clear error */
+
+      crp->crp_etype = 0;
+      goto dispatch;
+    }
+
+  crypto_done(crp);
+  return;
+
+dispatch:
+  crp->crp_flags = CRYPTO_F_IOV;
+  crypto_invoke(crp);
+}
+
+static int cryptodev_cb(FAR struct cryptop *crp)
+{
+  FAR struct cryptodev_req *req = crp->crp_opaque;
+  FAR struct csession *cse = req->cse;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct fcrypt *fcr = cse->fcr;
+  irqstate_t flags;
+#endif
+
+  req->status = cse->error ? cse->error : crp->crp_etype;
+  if (!req->async)
+    {
+      nxsem_post(&req->done);
+      return OK;
+    }
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  flags = spin_lock_irqsave(&fcr->lock);
+  TAILQ_INSERT_TAIL(&fcr->crp_ret, req, next);
+  cse->nreqs--;
+  spin_unlock_irqrestore(&fcr->lock, flags);
+
+  if (fcr->fds != NULL)
+    {
+      poll_notify(&fcr->fds, 1, POLLIN);
+    }
+#endif
+
+  return OK;
+}
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static void cryptodev_worker(FAR void *arg)
+{
+  FAR struct csession *cse = arg;
+  FAR struct cryptodev_req *req;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&cse->fcr->lock);
+      req = TAILQ_FIRST(&cse->pending);
+      if (req != NULL)
+        {
+          TAILQ_REMOVE(&cse->pending, req, next);
+        }
+
+      spin_unlock_irqrestore(&cse->fcr->lock, flags);
+      if (req == NULL)
+        {
+          break;
+        }
+
+      cryptodev_dispatch(req->crp);
+    }
+}
+
+static int cryptodev_getstatus(FAR struct fcrypt *fcr,
+                               FAR struct crypt_op *cop)
+{
+  FAR struct cryptodev_req *req;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&fcr->lock);
+  req = TAILQ_FIRST(&fcr->crp_ret);
+  if (req != NULL)
+    {
+      TAILQ_REMOVE(&fcr->crp_ret, req, next);
+    }
+
+  spin_unlock_irqrestore(&fcr->lock, flags);
+  if (req == NULL)
+    {
+      return -EAGAIN;
+    }
+
+  cop->reqid = req->reqid;
+  cop->status = req->status;
+  crypto_freereq(req->crp);
+  kmm_free(req);
+  return OK;
+}
+
+/* Drop the queued operations of a session and wait for those in flight */
+
+static void cryptodev_cancel(FAR struct csession *cse)
+{
+  FAR struct cryptodev_req *req;
+  irqstate_t flags;
+
+  work_cancel_sync(CRYPTODEV_WORK, &cse->work);
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&cse->fcr->lock);
+      req = TAILQ_FIRST(&cse->pending);
+      if (req != NULL)
+        {
+          TAILQ_REMOVE(&cse->pending, req, next);
+          cse->nreqs--;
+        }
+
+      spin_unlock_irqrestore(&cse->fcr->lock, flags);
+      if (req == NULL)
+        {
+          break;
+        }
+
+      crypto_freereq(req->crp);
+      kmm_free(req);
+    }
+
+  while (cse->nreqs > 0)
+    {
+      nxsched_usleep(1000);
+    }
+}
+#endif
+
 static int cryptodev_op(FAR struct csession *cse,
                         FAR struct crypt_op *cop)
 {
   FAR struct cryptop *crp = NULL;
   FAR struct cryptodesc *crde = NULL;
   FAR struct cryptodesc *crda = NULL;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct cryptodev_req *req;
+#endif
+  struct cryptodev_req sreq;
   int error = OK;
-  uint32_t hid;
 
   /* number of requests, not logical and */
 
@@ -461,7 +723,6 @@ static int cryptodev_op(FAR struct csession *cse,
   crp->crp_ilen = cop->len;
   crp->crp_buf = cop->src;
   crp->crp_sid = cse->sid;
-  crp->crp_opaque = cse;
 
   if (cop->iv)
     {
@@ -496,56 +757,61 @@ static int cryptodev_op(FAR struct csession *cse,
       crp->crp_mac = cop->mac;
     }
 
-  /* try the fast path first */
+  crp->crp_callback = cryptodev_cb;
 
-  crp->crp_flags = CRYPTO_F_IOV | CRYPTO_F_NOQUEUE;
-  hid = (crp->crp_sid >> 32) & 0xffffffff;
-  if (hid >= crypto_drivers_num)
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  if (cop->flags & COP_FLAG_ASYNC)
     {
-      goto dispatch;
-    }
+      FAR struct fcrypt *fcr = cse->fcr;
+      irqstate_t flags;
 
-  if (crypto_drivers[hid].cc_flags & CRYPTOCAP_F_SOFTWARE)
-    {
-      goto dispatch;
-    }
+      req = kmm_zalloc(sizeof(*req));
+      if (req == NULL)
+        {
+          error = -ENOMEM;
+          goto bail;
+        }
 
-  if (crypto_drivers[hid].cc_process == NULL)
-    {
-      goto dispatch;
-    }
+      req->cse = cse;
+      req->crp = crp;
+      req->async = true;
+      req->reqid = cop->reqid;
+      crp->crp_opaque = req;
 
-  error = crypto_drivers[hid].cc_process(crp);
-  if (error)
-    {
-      /* clear error */
+      /* The operations of a session are done in order by its work */
 
-      crp->crp_etype = 0;
-      goto dispatch;
-    }
+      flags = spin_lock_irqsave(&fcr->lock);
+      TAILQ_INSERT_TAIL(&cse->pending, req, next);
+      cse->nreqs++;
+      spin_unlock_irqrestore(&fcr->lock, flags);
 
-  goto processed;
-dispatch:
-  crp->crp_flags = CRYPTO_F_IOV;
-  crypto_invoke(crp);
-processed:
+      if (work_available(&cse->work))
+        {
+          work_queue(CRYPTODEV_WORK, &cse->work, cryptodev_worker, cse, 0);
+        }
 
-  if (crde && (cop->flags & COP_FLAG_UPDATE) == 0)
-    {
-      crde->crd_flags &= ~CRD_F_IV_EXPLICIT;
+      return OK;
     }
-
-  if (cse->error)
+#else
+  if (cop->flags & COP_FLAG_ASYNC)
     {
-      error = cse->error;
+      error = -ENOSYS;
       goto bail;
     }
+#endif
 
-  if (crp->crp_etype != 0)
-    {
-      error = crp->crp_etype;
-      goto bail;
-    }
+  sreq.cse = cse;
+  sreq.crp = crp;
+  sreq.async = false;
+  nxsem_init(&sreq.done, 0, 0);
+  crp->crp_opaque = &sreq;
+
+  /* A hardware engine may complete the operation from its interrupt */
+
+  cryptodev_dispatch(crp);
+  nxsem_wait_uninterruptible(&sreq.done);
+  nxsem_destroy(&sreq.done);
+  error = sreq.status;
 
 bail:
   if (crp)
@@ -810,7 +1076,11 @@ static int cryptof_poll(FAR struct file *filep,
 
   if (setup)
     {
-      if (!TAILQ_EMPTY(&fcr->crpk_ret))
+      if (!TAILQ_EMPTY(&fcr->crpk_ret)
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+          || !TAILQ_EMPTY(&fcr->crp_ret)
+#endif
+         )
         {
           poll_notify(&fds, 1, POLLIN);
           return OK;
@@ -838,14 +1108,29 @@ static int cryptof_close(FAR struct file *filep)
   FAR struct fcrypt *fcr = filep->f_priv;
   FAR struct csession *cse;
   FAR struct cryptkop *krp;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct cryptodev_req *req;
+#endif
   int i;
 
   while ((cse = TAILQ_FIRST(&fcr->csessions)))
     {
       TAILQ_REMOVE(&fcr->csessions, cse, next);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      cryptodev_cancel(cse);
+#endif
       (void)csefree(cse);
     }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  while ((req = TAILQ_FIRST(&fcr->crp_ret)))
+    {
+      TAILQ_REMOVE(&fcr->crp_ret, req, next);
+      crypto_freereq(req->crp);
+      kmm_free(req);
+    }
+#endif
+
   while ((krp = TAILQ_FIRST(&fcr->crpk_ret)))
     {
       TAILQ_REMOVE(&fcr->crpk_ret, krp, krp_next);
@@ -901,6 +1186,11 @@ static int cryptof_open(FAR struct file *filep)
     }
 
   TAILQ_INIT(&fcrd->csessions);
+  TAILQ_INIT(&fcrd->crpk_ret);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  TAILQ_INIT(&fcrd->crp_ret);
+  spin_lock_init(&fcrd->lock);
+#endif
   TAILQ_FOREACH(cse, &fcr->csessions, next)
     {
       bzero(&crie, sizeof(crie));
@@ -1027,6 +1317,10 @@ static int cryptoioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
         TAILQ_INIT(&fcr->csessions);
         TAILQ_INIT(&fcr->crpk_ret);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+        TAILQ_INIT(&fcr->crp_ret);
+        spin_lock_init(&fcr->lock);
+#endif
 
         fd = file_allocate_from_inode(&g_cryptoinode, 0, 0, fcr, 0);
         if (fd < 0)
@@ -1091,9 +1385,13 @@ static FAR struct csession *csecreate(FAR struct fcrypt *fcr, uint64_t sid,
 {
   FAR struct csession *cse;
 
-  cse = kmm_malloc(sizeof(struct csession));
+  cse = kmm_zalloc(sizeof(struct csession));
   if (cse != NULL)
     {
+      cse->fcr = fcr;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      TAILQ_INIT(&cse->pending);
+#endif
       cse->key = key;
       cse->keylen = keylen / 8;
       cse->mackey = mackey;
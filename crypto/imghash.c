@@ -0,0 +1,380 @@
+/****************************************************************************
+ * crypto/imghash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <sys/param.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <crypto/cryptodev.h>
+#include <crypto/xform.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Hash the chunks on the low priority work queue if there is one, or on
+ * the high priority one.  Without a work queue they are hashed in line,
+ * still in the same order and with the same result.
+ */
+
+#if defined(CONFIG_SCHED_LPWORK)
+#  define IMGHASH_WORK LPWORK
+#elif defined(CONFIG_SCHED_HPWORK)
+#  define IMGHASH_WORK HPWORK
+#endif
+
+/* RFC 6962 domain separation of leaves and inner nodes */
+
+#define IMGHASH_LEAF           0x00
+#define IMGHASH_NODE           0x01
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct imghash_s;
+
+struct imghash_buf_s
+{
+  FAR struct imghash_s *h;
+  FAR uint8_t *data;
+  size_t len;
+  size_t leaf;                       /* Merkle mode: index of the leaf */
+  sem_t done;                        /* Posted when data may be reused */
+  union authctx ctx;                 /* Merkle mode: context of the leaf */
+#ifdef IMGHASH_WORK
+  struct work_s work;
+#endif
+};
+
+struct imghash_s
+{
+  FAR const struct auth_hash *axf;
+  bool merkle;
+  union authctx ctx;                 /* Linear mode: the running hash */
+  FAR uint8_t *leaves;               /* Merkle mode: the leaf digests */
+  struct imghash_buf_s buf[CONFIG_CRYPTO_IMGHASH_NBUFFERS];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR const struct auth_hash *imghash_xform(uint32_t mac)
+{
+  switch (mac)
+    {
+      case CRYPTO_MD5:
+        return &auth_hash_md5;
+      case CRYPTO_SHA1:
+        return &auth_hash_sha1;
+      case CRYPTO_SHA2_224:
+        return &auth_hash_sha2_224;
+      case CRYPTO_SHA2_256:
+        return &auth_hash_sha2_256;
+      case CRYPTO_SHA2_384:
+        return &auth_hash_sha2_384;
+      case CRYPTO_SHA2_512:
+        return &auth_hash_sha2_512;
+      default:
+        return NULL;
+    }
+}
+
+static void imghash_worker(FAR void *arg)
+{
+  FAR struct imghash_buf_s *b = arg;
+  FAR struct imghash_s *h = b->h;
+  FAR const struct auth_hash *axf = h->axf;
+  uint8_t prefix = IMGHASH_LEAF;
+
+  if (h->merkle)
+    {
+      axf->init(&b->ctx);
+      axf->update(&b->ctx, &prefix, 1);
+      axf->update(&b->ctx, b->data, b->len);
+      axf->final(h->leaves + b->leaf * axf->hashsize, &b->ctx);
+    }
+  else
+    {
+      axf->update(&h->ctx, b->data, b->len);
+    }
+
+  nxsem_post(&b->done);
+}
+
+static void imghash_submit(FAR struct imghash_buf_s *b)
+{
+#ifdef IMGHASH_WORK
+  work_queue(IMGHASH_WORK, &b->work, imghash_worker, b, 0);
+#else
+  imghash_worker(b);
+#endif
+}
+
+/* Wait until the hash of a buffer is done without taking the buffer */
+
+static void imghash_sync(FAR struct imghash_buf_s *b)
+{
+  nxsem_wait_uninterruptible(&b->done);
+  nxsem_post(&b->done);
+}
+
+/* Fold the leaf digests pairwise into the root, a lone node at the end of
+ * a level moves up unchanged.
+ */
+
+static void imghash_merkle_root(FAR struct imghash_s *h, size_t nleaves,
+                                FAR uint8_t *digest)
+{
+  FAR const struct auth_hash *axf = h->axf;
+  size_t hsz = axf->hashsize;
+  uint8_t prefix = IMGHASH_NODE;
+  size_t i;
+
+  if (nleaves == 0)
+    {
+      axf->init(&h->ctx);
+      axf->final(digest, &h->ctx);
+      return;
+    }
+
+  while (nleaves > 1)
+    {
+      for (i = 0; i < nleaves / 2; i++)
+        {
+          axf->init(&h->ctx);
+          axf->update(&h->ctx, &prefix, 1);
+          axf->update(&h->ctx, h->leaves + 2 * i * hsz, 2 * hsz);
+          axf->final(h->leaves + i * hsz, &h->ctx);
+        }
+
+      if (nleaves & 1)
+        {
+          memmove(h->leaves + i * hsz, h->leaves + (nleaves - 1) * hsz,
+                  hsz);
+        }
+
+      nleaves = (nleaves + 1) / 2;
+    }
+
+  memcpy(digest, h->leaves, hsz);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: crypto_imghash
+ *
+ * Description:
+ *   Hash img->len bytes (up to the end of the file if zero) of an opened
+ *   file, block or MTD device from img->offset on, and store the digest in
+ *   img->digest.  The next chunk is read while the previous ones are being
+ *   hashed on the work queue, so flash and CPU time overlap and, with
+ *   CIMG_FLAG_MERKLE, the leaves of the tree are spread over the work queue
+ *   threads and therefore over the CPUs.
+ *
+ *   The Merkle tree follows RFC 6962: each img->chunk sized piece is a leaf
+ *   H(0x00 || data), inner nodes are H(0x01 || left || right).
+ *
+ * Returned Value:
+ *   OK on success, or a negated errno: -EINVAL for a bad algorithm or
+ *   chunk size, -ENODATA if the file ends before img->len bytes, or the
+ *   error of the read.
+ *
+ ****************************************************************************/
+
+int crypto_imghash(FAR struct file *filep, FAR struct crypt_img *img)
+{
+  FAR struct imghash_s *h;
+  FAR struct imghash_buf_s *prev = NULL;
+  FAR uint8_t *data;
+  size_t chunk = img->chunk ? img->chunk : CONFIG_CRYPTO_IMGHASH_CHUNKSIZE;
+  size_t remain = img->len;
+  size_t nleaves = 0;
+  off_t offset = img->offset;
+  ssize_t nread;
+  int ret = OK;
+  int i;
+
+  if (img->len != 0 && img->len < chunk)
+    {
+      chunk = img->len;
+    }
+
+  if (chunk == 0 || (img->flags & ~CIMG_FLAG_MERKLE) != 0)
+    {
+      return -EINVAL;
+    }
+
+  h = kmm_zalloc(sizeof(*h));
+  if (h == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  h->axf = imghash_xform(img->mac);
+  h->merkle = (img->flags & CIMG_FLAG_MERKLE) != 0;
+  if (h->axf == NULL)
+    {
+      kmm_free(h);
+      return -EINVAL;
+    }
+
+  data = kmm_malloc(chunk * CONFIG_CRYPTO_IMGHASH_NBUFFERS);
+  if (data == NULL)
+    {
+      kmm_free(h);
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_CRYPTO_IMGHASH_NBUFFERS; i++)
+    {
+      h->buf[i].h = h;
+      h->buf[i].data = data + i * chunk;
+      nxsem_init(&h->buf[i].done, 0, 1);
+    }
+
+  if (!h->merkle)
+    {
+      h->axf->init(&h->ctx);
+    }
+
+  for (i = 0; ; i = (i + 1) % CONFIG_CRYPTO_IMGHASH_NBUFFERS)
+    {
+      FAR struct imghash_buf_s *b = &h->buf[i];
+      size_t len = img->len != 0 ? MIN(chunk, remain) : chunk;
+
+      if (img->len != 0 && remain == 0)
+        {
+          break;
+        }
+
+      /* Wait for the last hash of this buffer, then refill it while the
+       * other buffers are being hashed.
+       */
+
+      nxsem_wait_uninterruptible(&b->done);
+
+      nread = file_pread(filep, b->data, len, offset);
+      if (nread < 0)
+        {
+          ret = nread;
+          nxsem_post(&b->done);
+          break;
+        }
+      else if (nread == 0)
+        {
+          ret = img->len != 0 ? -ENODATA : OK;
+          nxsem_post(&b->done);
+          break;
+        }
+
+      offset += nread;
+      remain -= img->len != 0 ? nread : 0;
+      b->len = nread;
+
+      if (h->merkle)
+        {
+          FAR uint8_t *leaves;
+
+          /* Leaf digests fill up in whatever order the threads finish,
+           * so grow the array only with all of them idle.
+           */
+
+          if (nleaves % 64 == 0)
+            {
+              int j;
+
+              for (j = 0; j < CONFIG_CRYPTO_IMGHASH_NBUFFERS; j++)
+                {
+                  if (j != i)
+                    {
+                      imghash_sync(&h->buf[j]);
+                    }
+                }
+
+              leaves = kmm_realloc(h->leaves,
+                                   (nleaves + 64) * h->axf->hashsize);
+              if (leaves == NULL)
+                {
+                  ret = -ENOMEM;
+                  nxsem_post(&b->done);
+                  break;
+                }
+
+              h->leaves = leaves;
+            }
+
+          b->leaf = nleaves++;
+        }
+      else if (prev != NULL)
+        {
+          /* The running hash needs the chunks in order */
+
+          imghash_sync(prev);
+        }
+
+      imghash_submit(b);
+      prev = b;
+    }
+
+  for (i = 0; i < CONFIG_CRYPTO_IMGHASH_NBUFFERS; i++)
+    {
+      nxsem_wait_uninterruptible(&h->buf[i].done);
+      nxsem_destroy(&h->buf[i].done);
+    }
+
+  if (ret >= 0)
+    {
+      if (h->merkle)
+        {
+          imghash_merkle_root(h, nleaves, (FAR uint8_t *)img->digest);
+        }
+      else
+        {
+          h->axf->final((FAR uint8_t *)img->digest, &h->ctx);
+        }
+    }
+
+  kmm_free(h->leaves);
+  kmm_free(data);
+  explicit_bzero(h, sizeof(*h));
+  kmm_free(h);
+  return ret;
+}
@@ -86,6 +86,16 @@
     }                                     \
   while (0)
 
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* Allow overriding with a CPU specific block function */
+
+CODE void (*sha1_blocks)(FAR uint32_t *,
+                         FAR const unsigned char *,
+                         unsigned int) = sha1blocks_mi;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -222,6 +232,18 @@ void sha1transform(FAR uint32_t *state,
   a = b = c = d = e = 0;
 }
 
+/* Hash nblocks consecutive 512-bit blocks */
+
+void sha1blocks_mi(FAR uint32_t *state, FAR const unsigned char *buffer,
+                   unsigned int nblocks)
+{
+  while (nblocks-- > 0)
+    {
+      sha1transform(state, buffer);
+      buffer += SHA1_BLOCK_LENGTH;
+    }
+}
+
 /* SHA1Init - Initialize new context */
 
 void sha1init(FAR SHA1_CTX *context)
@@ -251,10 +273,12 @@ void sha1update(FAR SHA1_CTX *context,
   if ((j + len) > 63)
     {
       memcpy(&context->buffer[j], data, (i = 64 - j));
-      sha1transform(context->state, context->buffer);
-      for (; i + 63 < len; i += 64)
+      (*sha1_blocks)(context->state, context->buffer, 1);
+      if (i + 63 < len)
         {
-          sha1transform(context->state, &data[i]);
+          j = (len - i) / 64;
+          (*sha1_blocks)(context->state, &data[i], j);
+          i += j * 64;
         }
 
       j = 0;
@@ -168,8 +168,15 @@
 
 void sha512last(FAR SHA2_CTX *);
 void sha256transform(FAR uint32_t *, FAR const uint8_t *);
+void sha256blocks_mi(FAR uint32_t *, FAR const uint8_t *, size_t);
 void sha512transform(FAR uint64_t *, FAR const uint8_t *);
 
+/* Allow overriding with a CPU specific block function */
+
+CODE void (*sha256_blocks)(FAR uint32_t *,
+                           FAR const uint8_t *,
+                           size_t) = sha256blocks_mi;
+
 /* SHA-XYZ INITIAL HASH VALUES AND CONSTANTS */
 
 /* Hash constant words K for SHA-256: */
@@ -518,6 +525,16 @@ void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+void sha256blocks_mi(FAR uint32_t *state, FAR const uint8_t *data,
+                     size_t nblocks)
+{
+  while (nblocks-- > 0)
+    {
+      sha256transform(state, data);
+      data += SHA256_BLOCK_LENGTH;
+    }
+}
+
 void sha256update(FAR SHA2_CTX *context,
                   FAR const void *dataptr,
                   size_t len)
@@ -548,7 +565,7 @@ void sha256update(FAR SHA2_CTX *context,
           context->bitcount[0] += freespace << 3;
           len -= freespace;
           data += freespace;
-          sha256transform(context->state.st32, context->buffer);
+          (*sha256_blocks)(context->state.st32, context->buffer, 1);
         }
       else
         {
@@ -564,14 +581,16 @@ void sha256update(FAR SHA2_CTX *context,
         }
     }
 
-  while (len >= SHA256_BLOCK_LENGTH)
+  if (len >= SHA256_BLOCK_LENGTH)
     {
       /* Process as many complete blocks as we can */
 
-      sha256transform(context->state.st32, data);
-      context->bitcount[0] += SHA256_BLOCK_LENGTH << 3;
-      len -= SHA256_BLOCK_LENGTH;
-      data += SHA256_BLOCK_LENGTH;
+      freespace = len - len % SHA256_BLOCK_LENGTH;
+      (*sha256_blocks)(context->state.st32, data,
+                       freespace / SHA256_BLOCK_LENGTH);
+      context->bitcount[0] += (uint64_t)freespace << 3;
+      len -= freespace;
+      data += freespace;
     }
 
   if (len > 0)
@@ -622,7 +641,7 @@ void sha256last(FAR SHA2_CTX *context)
 
           /* Do second-to-last transform: */
 
-          sha256transform(context->state.st32, context->buffer);
+          (*sha256_blocks)(context->state.st32, context->buffer, 1);
 
           /* And set-up for the last transform: */
 
@@ -648,7 +667,7 @@ void sha256last(FAR SHA2_CTX *context)
 
   /* Final transform: */
 
-  sha256transform(context->state.st32, context->buffer);
+  (*sha256_blocks)(context->state.st32, context->buffer, 1);
 }
 
 void sha256final(FAR uint8_t *digest, FAR SHA2_CTX *context)
@@ -0,0 +1,562 @@
+/****************************************************************************
+ * crypto/sha_accel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <debug.h>
+
+#include <crypto/sha1.h>
+#include <crypto/sha2.h>
+
+#if defined(__aarch64__) && defined(CONFIG_ARCH_FPU) && \
+    !defined(CONFIG_ARCH_SIM) && \
+    (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#  include <arm_neon.h>
+#  define SHA_ACCEL_ARMV8CE 1
+#elif defined(__x86_64__)
+#  define SHA_ACCEL_SHANI 1
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* ID_AA64ISAR0_EL1.SHA1 and .SHA2 */
+
+#define ID_AA64ISAR0_SHA1(r)   (((r) >> 8) & 0xf)
+#define ID_AA64ISAR0_SHA2(r)   (((r) >> 12) & 0xf)
+
+/* CPUID.01H:ECX and CPUID.(EAX=07H,ECX=0):EBX */
+
+#define CPUID_ECX_SSSE3        (1 << 9)
+#define CPUID_ECX_SSE41        (1 << 19)
+#define CPUID_EBX_SHA          (1 << 29)
+
+#ifdef SHA_ACCEL_SHANI
+
+/* The SSE/SHA instructions used below, in AT&T operand order (the
+ * destination is the last operand and doubles as the first source).
+ */
+
+#  define PSHUFB(d, s) \
+  __asm__ ("pshufb %1, %0" : "+x"(d) : "x"(s))
+#  define PSHUFD(d, s, i) \
+  __asm__ ("pshufd $" #i ", %1, %0" : "=x"(d) : "x"(s))
+#  define PALIGNR(d, s, i) \
+  __asm__ ("palignr $" #i ", %1, %0" : "+x"(d) : "x"(s))
+#  define PBLENDW(d, s, i) \
+  __asm__ ("pblendw $" #i ", %1, %0" : "+x"(d) : "x"(s))
+
+#  define SHA1RNDS4(d, s, i) \
+  __asm__ ("sha1rnds4 $" #i ", %1, %0" : "+x"(d) : "x"(s))
+#  define SHA1NEXTE(d, s) \
+  __asm__ ("sha1nexte %1, %0" : "+x"(d) : "x"(s))
+#  define SHA1MSG1(d, s) \
+  __asm__ ("sha1msg1 %1, %0" : "+x"(d) : "x"(s))
+#  define SHA1MSG2(d, s) \
+  __asm__ ("sha1msg2 %1, %0" : "+x"(d) : "x"(s))
+
+#  define SHA256RNDS2(d, s, k) \
+  __asm__ ("sha256rnds2 %2, %1, %0" : "+x"(d) : "x"(s), "Yz"(k))
+#  define SHA256MSG1(d, s) \
+  __asm__ ("sha256msg1 %1, %0" : "+x"(d) : "x"(s))
+#  define SHA256MSG2(d, s) \
+  __asm__ ("sha256msg2 %1, %0" : "+x"(d) : "x"(s))
+
+/* Four SHA-1 rounds, g is the group of rounds (0-19), ec/en the E register
+ * of this and of the next group, mc the schedule of this group and mn, mp,
+ * mp2 those of the next, the previous and the one before.
+ */
+
+#  define SHA1_QROUND(g, ec, en, mp2, mp, mc, mn) \
+  do \
+    { \
+      if ((g) < 4) \
+        { \
+          mc = sha_load(data + (g) * 16); \
+          PSHUFB(mc, mask); \
+        } \
+      if ((g) == 0) \
+        { \
+          ec += mc; \
+        } \
+      else \
+        { \
+          SHA1NEXTE(ec, mc); \
+        } \
+      en = abcd; \
+      if ((g) >= 3 && (g) <= 18) \
+        { \
+          SHA1MSG2(mn, mc); \
+        } \
+      SHA1RNDS4(abcd, ec, (g) / 5); \
+      if ((g) >= 1 && (g) <= 16) \
+        { \
+          SHA1MSG1(mp, mc); \
+        } \
+      if ((g) >= 2 && (g) <= 17) \
+        { \
+          mp2 ^= mc; \
+        } \
+    } \
+  while (0)
+
+/* Four SHA-256 rounds, mp/mc/mn are the schedule of the previous, this
+ * and the next group of rounds.
+ */
+
+#  define SHA256_QROUND(g, mp, mc, mn) \
+  do \
+    { \
+      if ((g) < 4) \
+        { \
+          mc = sha_load(data + (g) * 16); \
+          PSHUFB(mc, mask); \
+        } \
+      msg = mc + sha_load(&g_sha256_k[(g) * 4]); \
+      SHA256RNDS2(state1, state0, msg); \
+      if ((g) >= 3 && (g) <= 14) \
+        { \
+          tmp = mc; \
+          PALIGNR(tmp, mp, 4); \
+          mn += tmp; \
+          SHA256MSG2(mn, mc); \
+        } \
+      PSHUFD(msg, msg, 0x0e); \
+      SHA256RNDS2(state0, state1, msg); \
+      if ((g) >= 1 && (g) <= 12) \
+        { \
+          SHA256MSG1(mp, mc); \
+        } \
+    } \
+  while (0)
+
+#endif /* SHA_ACCEL_SHANI */
+
+#ifdef SHA_ACCEL_ARMV8CE
+
+/* Four SHA-1 rounds with hash function f, mc is the schedule of this group
+ * of rounds and m1-m3 those of the next three.
+ */
+
+#  define SHA1_QROUND(g, f, mc, m1, m2, m3) \
+  do \
+    { \
+      uint32x4_t wk = vaddq_u32(mc, vdupq_n_u32(g_sha1_k[(g) / 5])); \
+      uint32_t enext = vsha1h_u32(vgetq_lane_u32(abcd, 0)); \
+      abcd = f(abcd, e, wk); \
+      e = enext; \
+      if ((g) < 16) \
+        { \
+          mc = vsha1su1q_u32(vsha1su0q_u32(mc, m1, m2), m3); \
+        } \
+    } \
+  while (0)
+
+#  define SHA256_QROUND(g, mc, m1, m2, m3) \
+  do \
+    { \
+      uint32x4_t wk = vaddq_u32(mc, vld1q_u32(&g_sha256_k[(g) * 4])); \
+      uint32x4_t abcd = state0; \
+      if ((g) < 12) \
+        { \
+          mc = vsha256su1q_u32(vsha256su0q_u32(mc, m1), m2, m3); \
+        } \
+      state0 = vsha256hq_u32(state0, state1, wk); \
+      state1 = vsha256h2q_u32(state1, abcd, wk); \
+    } \
+  while (0)
+
+#endif /* SHA_ACCEL_ARMV8CE */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef SHA_ACCEL_SHANI
+typedef uint32_t sha_v128_t __attribute__((vector_size(16)));
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if defined(SHA_ACCEL_SHANI) || defined(SHA_ACCEL_ARMV8CE)
+static const uint32_t g_sha256_k[64] aligned_data(16) =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+#endif
+
+#ifdef SHA_ACCEL_SHANI
+
+/* PSHUFB masks: byte swap every word (SHA-256), the whole block (SHA-1) */
+
+static const uint8_t g_bswap32_mask[16] aligned_data(16) =
+{
+  3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12
+};
+
+static const uint8_t g_bswap128_mask[16] aligned_data(16) =
+{
+  15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0
+};
+
+#endif
+
+#ifdef SHA_ACCEL_ARMV8CE
+static const uint32_t g_sha1_k[4] =
+{
+  0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef SHA_ACCEL_SHANI
+
+static inline sha_v128_t sha_load(FAR const void *p)
+{
+  sha_v128_t v;
+
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static void sha1_blocks_accel(FAR uint32_t *state,
+                              FAR const unsigned char *data,
+                              unsigned int nblocks)
+{
+  sha_v128_t mask = sha_load(g_bswap128_mask);
+  sha_v128_t abcd = sha_load(state);
+  sha_v128_t e0;
+  sha_v128_t e1;
+  sha_v128_t m0;
+  sha_v128_t m1;
+  sha_v128_t m2;
+  sha_v128_t m3;
+
+  memset(&e0, 0, sizeof(e0));
+  e0[3] = state[4];
+  e1 = m0 = m1 = m2 = m3 = e0;
+  PSHUFD(abcd, abcd, 0x1b);
+
+  while (nblocks-- > 0)
+    {
+      sha_v128_t abcd_save = abcd;
+      sha_v128_t e0_save = e0;
+
+      SHA1_QROUND(0,  e0, e1, m2, m3, m0, m1);
+      SHA1_QROUND(1,  e1, e0, m3, m0, m1, m2);
+      SHA1_QROUND(2,  e0, e1, m0, m1, m2, m3);
+      SHA1_QROUND(3,  e1, e0, m1, m2, m3, m0);
+      SHA1_QROUND(4,  e0, e1, m2, m3, m0, m1);
+      SHA1_QROUND(5,  e1, e0, m3, m0, m1, m2);
+      SHA1_QROUND(6,  e0, e1, m0, m1, m2, m3);
+      SHA1_QROUND(7,  e1, e0, m1, m2, m3, m0);
+      SHA1_QROUND(8,  e0, e1, m2, m3, m0, m1);
+      SHA1_QROUND(9,  e1, e0, m3, m0, m1, m2);
+      SHA1_QROUND(10, e0, e1, m0, m1, m2, m3);
+      SHA1_QROUND(11, e1, e0, m1, m2, m3, m0);
+      SHA1_QROUND(12, e0, e1, m2, m3, m0, m1);
+      SHA1_QROUND(13, e1, e0, m3, m0, m1, m2);
+      SHA1_QROUND(14, e0, e1, m0, m1, m2, m3);
+      SHA1_QROUND(15, e1, e0, m1, m2, m3, m0);
+      SHA1_QROUND(16, e0, e1, m2, m3, m0, m1);
+      SHA1_QROUND(17, e1, e0, m3, m0, m1, m2);
+      SHA1_QROUND(18, e0, e1, m0, m1, m2, m3);
+      SHA1_QROUND(19, e1, e0, m1, m2, m3, m0);
+
+      SHA1NEXTE(e0, e0_save);
+      abcd += abcd_save;
+      data += SHA1_BLOCK_LENGTH;
+    }
+
+  PSHUFD(abcd, abcd, 0x1b);
+  memcpy(state, &abcd, sizeof(abcd));
+  state[4] = e0[3];
+}
+
+static void sha256_blocks_accel(FAR uint32_t *state,
+                                FAR const uint8_t *data, size_t nblocks)
+{
+  sha_v128_t mask = sha_load(g_bswap32_mask);
+  sha_v128_t state0;
+  sha_v128_t state1;
+  sha_v128_t tmp;
+  sha_v128_t msg;
+  sha_v128_t m0;
+  sha_v128_t m1;
+  sha_v128_t m2;
+  sha_v128_t m3;
+
+  /* The instructions want the state as ABEF and CDGH */
+
+  tmp = sha_load(state);
+  state1 = sha_load(state + 4);
+  PSHUFD(tmp, tmp, 0xb1);
+  PSHUFD(state1, state1, 0x1b);
+  state0 = tmp;
+  PALIGNR(state0, state1, 8);
+  PBLENDW(state1, tmp, 0xf0);
+
+  m3 = tmp;
+
+  while (nblocks-- > 0)
+    {
+      sha_v128_t abef_save = state0;
+      sha_v128_t cdgh_save = state1;
+
+      SHA256_QROUND(0,  m3, m0, m1);
+      SHA256_QROUND(1,  m0, m1, m2);
+      SHA256_QROUND(2,  m1, m2, m3);
+      SHA256_QROUND(3,  m2, m3, m0);
+      SHA256_QROUND(4,  m3, m0, m1);
+      SHA256_QROUND(5,  m0, m1, m2);
+      SHA256_QROUND(6,  m1, m2, m3);
+      SHA256_QROUND(7,  m2, m3, m0);
+      SHA256_QROUND(8,  m3, m0, m1);
+      SHA256_QROUND(9,  m0, m1, m2);
+      SHA256_QROUND(10, m1, m2, m3);
+      SHA256_QROUND(11, m2, m3, m0);
+      SHA256_QROUND(12, m3, m0, m1);
+      SHA256_QROUND(13, m0, m1, m2);
+      SHA256_QROUND(14, m1, m2, m3);
+      SHA256_QROUND(15, m2, m3, m0);
+
+      state0 += abef_save;
+      state1 += cdgh_save;
+      data += SHA256_BLOCK_LENGTH;
+    }
+
+  PSHUFD(tmp, state0, 0x1b);
+  PSHUFD(state1, state1, 0xb1);
+  state0 = tmp;
+  PBLENDW(state0, state1, 0xf0);
+  PALIGNR(state1, tmp, 8);
+  memcpy(state, &state0, sizeof(state0));
+  memcpy(state + 4, &state1, sizeof(state1));
+}
+
+static void sha_accel_probe(FAR bool *sha1, FAR bool *sha256)
+{
+  uint32_t eax = 0;
+  uint32_t ebx;
+  uint32_t ecx = 0;
+  uint32_t edx;
+  uint32_t max;
+
+  *sha1 = false;
+  *sha256 = false;
+
+  __asm__ volatile ("cpuid"
+                    : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+  max = eax;
+  if (max < 7)
+    {
+      return;
+    }
+
+  eax = 1;
+  ecx = 0;
+  __asm__ volatile ("cpuid"
+                    : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+  if ((ecx & (CPUID_ECX_SSSE3 | CPUID_ECX_SSE41)) !=
+      (CPUID_ECX_SSSE3 | CPUID_ECX_SSE41))
+    {
+      return;
+    }
+
+  eax = 7;
+  ecx = 0;
+  __asm__ volatile ("cpuid"
+                    : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+
+  *sha1 = (ebx & CPUID_EBX_SHA) != 0;
+  *sha256 = *sha1;
+}
+
+#elif defined(SHA_ACCEL_ARMV8CE)
+
+static inline uint32x4_t sha_load_be(FAR const uint8_t *p)
+{
+  return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p)));
+}
+
+static void sha1_blocks_accel(FAR uint32_t *state,
+                              FAR const unsigned char *data,
+                              unsigned int nblocks)
+{
+  uint32x4_t abcd = vld1q_u32(state);
+  uint32_t e = state[4];
+
+  while (nblocks-- > 0)
+    {
+      uint32x4_t abcd_save = abcd;
+      uint32_t e_save = e;
+      uint32x4_t m0 = sha_load_be(data);
+      uint32x4_t m1 = sha_load_be(data + 16);
+      uint32x4_t m2 = sha_load_be(data + 32);
+      uint32x4_t m3 = sha_load_be(data + 48);
+
+      SHA1_QROUND(0,  vsha1cq_u32, m0, m1, m2, m3);
+      SHA1_QROUND(1,  vsha1cq_u32, m1, m2, m3, m0);
+      SHA1_QROUND(2,  vsha1cq_u32, m2, m3, m0, m1);
+      SHA1_QROUND(3,  vsha1cq_u32, m3, m0, m1, m2);
+      SHA1_QROUND(4,  vsha1cq_u32, m0, m1, m2, m3);
+      SHA1_QROUND(5,  vsha1pq_u32, m1, m2, m3, m0);
+      SHA1_QROUND(6,  vsha1pq_u32, m2, m3, m0, m1);
+      SHA1_QROUND(7,  vsha1pq_u32, m3, m0, m1, m2);
+      SHA1_QROUND(8,  vsha1pq_u32, m0, m1, m2, m3);
+      SHA1_QROUND(9,  vsha1pq_u32, m1, m2, m3, m0);
+      SHA1_QROUND(10, vsha1mq_u32, m2, m3, m0, m1);
+      SHA1_QROUND(11, vsha1mq_u32, m3, m0, m1, m2);
+      SHA1_QROUND(12, vsha1mq_u32, m0, m1, m2, m3);
+      SHA1_QROUND(13, vsha1mq_u32, m1, m2, m3, m0);
+      SHA1_QROUND(14, vsha1mq_u32, m2, m3, m0, m1);
+      SHA1_QROUND(15, vsha1pq_u32, m3, m0, m1, m2);
+      SHA1_QROUND(16, vsha1pq_u32, m0, m1, m2, m3);
+      SHA1_QROUND(17, vsha1pq_u32, m1, m2, m3, m0);
+      SHA1_QROUND(18, vsha1pq_u32, m2, m3, m0, m1);
+      SHA1_QROUND(19, vsha1pq_u32, m3, m0, m1, m2);
+
+      abcd = vaddq_u32(abcd, abcd_save);
+      e += e_save;
+      data += SHA1_BLOCK_LENGTH;
+    }
+
+  vst1q_u32(state, abcd);
+  state[4] = e;
+}
+
+static void sha256_blocks_accel(FAR uint32_t *state,
+                                FAR const uint8_t *data, size_t nblocks)
+{
+  uint32x4_t state0 = vld1q_u32(state);
+  uint32x4_t state1 = vld1q_u32(state + 4);
+
+  while (nblocks-- > 0)
+    {
+      uint32x4_t abcd_save = state0;
+      uint32x4_t efgh_save = state1;
+      uint32x4_t m0 = sha_load_be(data);
+      uint32x4_t m1 = sha_load_be(data + 16);
+      uint32x4_t m2 = sha_load_be(data + 32);
+      uint32x4_t m3 = sha_load_be(data + 48);
+
+      SHA256_QROUND(0,  m0, m1, m2, m3);
+      SHA256_QROUND(1,  m1, m2, m3, m0);
+      SHA256_QROUND(2,  m2, m3, m0, m1);
+      SHA256_QROUND(3,  m3, m0, m1, m2);
+      SHA256_QROUND(4,  m0, m1, m2, m3);
+      SHA256_QROUND(5,  m1, m2, m3, m0);
+      SHA256_QROUND(6,  m2, m3, m0, m1);
+      SHA256_QROUND(7,  m3, m0, m1, m2);
+      SHA256_QROUND(8,  m0, m1, m2, m3);
+      SHA256_QROUND(9,  m1, m2, m3, m0);
+      SHA256_QROUND(10, m2, m3, m0, m1);
+      SHA256_QROUND(11, m3, m0, m1, m2);
+      SHA256_QROUND(12, m0, m1, m2, m3);
+      SHA256_QROUND(13, m1, m2, m3, m0);
+      SHA256_QROUND(14, m2, m3, m0, m1);
+      SHA256_QROUND(15, m3, m0, m1, m2);
+
+      state0 = vaddq_u32(state0, abcd_save);
+      state1 = vaddq_u32(state1, efgh_save);
+      data += SHA256_BLOCK_LENGTH;
+    }
+
+  vst1q_u32(state, state0);
+  vst1q_u32(state + 4, state1);
+}
+
+static void sha_accel_probe(FAR bool *sha1, FAR bool *sha256)
+{
+  uint64_t isar0;
+
+  __asm__ volatile ("mrs %0, id_aa64isar0_el1" : "=r"(isar0));
+
+  *sha1 = ID_AA64ISAR0_SHA1(isar0) >= 1;
+  *sha256 = ID_AA64ISAR0_SHA2(isar0) >= 1;
+}
+
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha_accel_initialize
+ *
+ * Description:
+ *   Point the SHA-1 and SHA-256 block functions at the CPU's hash
+ *   instructions when it has them.  Contexts keep no per-backend state, so
+ *   this may be called at any time.
+ *
+ ****************************************************************************/
+
+void sha_accel_initialize(void)
+{
+#if defined(SHA_ACCEL_SHANI) || defined(SHA_ACCEL_ARMV8CE)
+  bool sha1;
+  bool sha256;
+
+  sha_accel_probe(&sha1, &sha256);
+  if (sha1)
+    {
+      sha1_blocks = sha1_blocks_accel;
+      cryptinfo("SHA-1 instructions enabled\n");
+    }
+
+  if (sha256)
+    {
+      sha256_blocks = sha256_blocks_accel;
+      cryptinfo("SHA-256 instructions enabled\n");
+    }
+#endif
+}
@@ -32,6 +32,7 @@
 #include <stdbool.h>
 #include <unistd.h>
 #include <string.h>
+#include <strings.h>
 #include <fcntl.h>
 #include <assert.h>
 #include <errno.h>
@@ -39,6 +40,7 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/analog/adc.h>
 #include <nuttx/analog/ioctl.h>
 #include <nuttx/random.h>
@@ -67,6 +69,17 @@ static int     adc_poll(FAR struct file *filep, FAR struct pollfd *fds,
                         bool setup);
 static int     adc_reset_fifo(FAR struct adc_dev_s *dev);
 static int     adc_samples_on_read(FAR struct adc_dev_s *dev);
+#ifdef CONFIG_ADC_BLOCK
+static ssize_t adc_read_blocks(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen);
+static int     adc_mmap(FAR struct file *filep,
+                        FAR struct mm_map_entry_s *map);
+static int     adc_get_block(FAR struct adc_dev_s *dev);
+static int     adc_receive_block(FAR struct adc_dev_s *dev, int index,
+                                 size_t nbytes, uint64_t timestamp);
+static int     adc_release_block(FAR struct adc_dev_s *dev,
+                                 unsigned long index);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -80,7 +93,11 @@ static const struct file_operations g_adc_fops =
   NULL,         /* write */
   NULL,         /* seek */
   adc_ioctl,    /* ioctl */
+#ifdef CONFIG_ADC_BLOCK
+  adc_mmap,     /* mmap */
+#else
   NULL,         /* mmap */
+#endif
   NULL,         /* truncate */
   adc_poll      /* poll */
 };
@@ -89,7 +106,11 @@ static const struct adc_callback_s g_adc_callback =
 {
   adc_receive,       /* au_receive */
   adc_receive_batch, /* au_receive_batch */
-  adc_reset          /* au_reset */
+  adc_reset,         /* au_reset */
+#ifdef CONFIG_ADC_BLOCK
+  adc_get_block,     /* au_get_block */
+  adc_receive_block  /* au_receive_block */
+#endif
 };
 
 /****************************************************************************
@@ -141,6 +162,18 @@ static int adc_open(FAR struct file *filep)
               /* Yes.. perform one time hardware initialization. */
 
               irqstate_t flags = enter_critical_section();
+
+#ifdef CONFIG_ADC_BLOCK
+              /* All blocks are free before the hardware takes its first */
+
+              dev->ad_blkfree = dev->ad_nblocks == 0 ? 0 :
+                                UINT32_MAX >> (32 - dev->ad_nblocks);
+              dev->ad_blkuser = 0;
+              dev->ad_blkseq  = 0;
+              dev->ad_blkhead = 0;
+              dev->ad_nready  = 0;
+#endif
+
               ret = dev->ad_ops->ao_setup(dev);
               if (ret == OK)
                 {
@@ -235,6 +268,13 @@ static ssize_t adc_read(FAR struct file *filep, FAR char *buffer,
 
   ainfo("buflen: %d\n", (int)buflen);
 
+#ifdef CONFIG_ADC_BLOCK
+  if (dev->ad_blkbuf != NULL)
+    {
+      return adc_read_blocks(filep, buffer, buflen);
+    }
+#endif
+
   /* Determine the size of the messages to return.
    *
    * REVISIT:  What if buflen is 8 does that mean 4 messages of size 2?  Or
@@ -448,6 +488,36 @@ static int adc_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+#ifdef CONFIG_ADC_BLOCK
+      case ANIOC_GET_BLOCKINFO:
+        {
+          FAR struct adc_blockinfo_s *info =
+            (FAR struct adc_blockinfo_s *)((uintptr_t)arg);
+
+          if (dev->ad_blkbuf == NULL)
+            {
+              ret = -ENOTTY;
+            }
+          else if (info == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              info->ab_blksize = dev->ad_blksize;
+              info->ab_nblocks = dev->ad_nblocks;
+              ret = OK;
+            }
+        }
+        break;
+
+      case ANIOC_RELEASE_BLOCK:
+        {
+          ret = adc_release_block(dev, arg);
+        }
+        break;
+#endif
+
       default:
         {
           /* Those IOCTLs might be used in arch specific section */
@@ -655,7 +725,11 @@ static int adc_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       /* Should we immediately notify on any of the requested events? */
 
-      if (dev->ad_recv.af_head != dev->ad_recv.af_tail)
+      if (dev->ad_recv.af_head != dev->ad_recv.af_tail
+#ifdef CONFIG_ADC_BLOCK
+          || dev->ad_nready > 0
+#endif
+         )
         {
           poll_notify(&fds, 1, POLLIN);
         }
@@ -692,6 +766,17 @@ static int adc_reset_fifo(FAR struct adc_dev_s *dev)
 
   fifo->af_head = fifo->af_tail;
 
+#ifdef CONFIG_ADC_BLOCK
+  /* Drop the filled blocks that were not read yet */
+
+  while (dev->ad_nready > 0)
+    {
+      dev->ad_blkfree |= 1ul << dev->ad_blkready[dev->ad_blkhead];
+      dev->ad_blkhead  = (dev->ad_blkhead + 1) % dev->ad_nblocks;
+      dev->ad_nready--;
+    }
+#endif
+
   leave_critical_section(flags);
 
   return OK;
@@ -725,6 +810,207 @@ static int adc_samples_on_read(FAR struct adc_dev_s *dev)
   return ret;
 }
 
+#ifdef CONFIG_ADC_BLOCK
+/****************************************************************************
+ * Name: adc_read_blocks
+ *
+ * Description:
+ *   Return the descriptors of the filled blocks, oldest first.  The
+ *   blocks belong to the caller until they are released.
+ *
+ ****************************************************************************/
+
+static ssize_t adc_read_blocks(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct inode     *inode = filep->f_inode;
+  FAR struct adc_dev_s *dev   = inode->i_private;
+  irqstate_t            flags;
+  size_t                nread = 0;
+  uint8_t               index;
+  int                   ret;
+
+  if (buflen < sizeof(struct adc_block_s))
+    {
+      return -EINVAL;
+    }
+
+  ret = nxmutex_lock(&dev->ad_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (dev->ad_nready == 0)
+    {
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          ret = -EAGAIN;
+          goto errout;
+        }
+
+      dev->ad_nrxwaiters++;
+      ret = nxsem_wait(&dev->ad_recv.af_sem);
+      dev->ad_nrxwaiters--;
+      if (ret < 0)
+        {
+          goto errout;
+        }
+    }
+
+  flags = enter_critical_section();
+
+  while (dev->ad_nready > 0 && nread + sizeof(struct adc_block_s) <= buflen)
+    {
+      index            = dev->ad_blkready[dev->ad_blkhead];
+      dev->ad_blkhead  = (dev->ad_blkhead + 1) % dev->ad_nblocks;
+      dev->ad_nready--;
+      dev->ad_blkuser |= 1ul << index;
+
+      memcpy(&buffer[nread], &dev->ad_blkdesc[index],
+             sizeof(struct adc_block_s));
+      nread += sizeof(struct adc_block_s);
+    }
+
+  leave_critical_section(flags);
+  ret = nread;
+
+errout:
+  nxmutex_unlock(&dev->ad_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: adc_mmap
+ *
+ * Description:
+ *   Map the block buffer, so that the samples are read where the hardware
+ *   wrote them.
+ *
+ ****************************************************************************/
+
+static int adc_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode     *inode = filep->f_inode;
+  FAR struct adc_dev_s *dev   = inode->i_private;
+  size_t                len   = dev->ad_nblocks * dev->ad_blksize;
+
+  if (dev->ad_blkbuf == NULL)
+    {
+      return -ENODEV;
+    }
+
+  if (map->offset >= 0 && map->offset < len &&
+      map->length && map->offset + map->length <= len)
+    {
+      map->vaddr = (FAR char *)dev->ad_blkbuf + map->offset;
+      return OK;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: adc_get_block
+ ****************************************************************************/
+
+static int adc_get_block(FAR struct adc_dev_s *dev)
+{
+  irqstate_t flags = enter_critical_section();
+  int index = ffs(dev->ad_blkfree) - 1;
+
+  if (index >= 0)
+    {
+      dev->ad_blkfree &= ~(1ul << index);
+    }
+
+  leave_critical_section(flags);
+  return index < 0 ? -ENOMEM : index;
+}
+
+/****************************************************************************
+ * Name: adc_receive_block
+ ****************************************************************************/
+
+static int adc_receive_block(FAR struct adc_dev_s *dev, int index,
+                             size_t nbytes, uint64_t timestamp)
+{
+  FAR struct adc_block_s *blk;
+  struct timespec         ts;
+  irqstate_t              flags;
+  uint32_t                seq;
+  int                     next;
+
+  if (index < 0 || index >= dev->ad_nblocks || nbytes > dev->ad_blksize)
+    {
+      return -EINVAL;
+    }
+
+  if (timestamp == 0)
+    {
+      clock_systime_timespec(&ts);
+      timestamp = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+    }
+
+  flags = enter_critical_section();
+  seq   = dev->ad_blkseq++;
+
+  /* Without a free block the reader is behind, the hardware overwrites
+   * this one and the reader sees the gap in the sequence numbers.
+   */
+
+  next = adc_get_block(dev);
+  if (next < 0)
+    {
+      leave_critical_section(flags);
+      return index;
+    }
+
+  blk               = &dev->ad_blkdesc[index];
+  blk->ab_seq       = seq;
+  blk->ab_index     = index;
+  blk->ab_offset    = index * dev->ad_blksize;
+  blk->ab_nbytes    = nbytes;
+  blk->ab_timestamp = timestamp;
+
+  dev->ad_blkready[(dev->ad_blkhead + dev->ad_nready) % dev->ad_nblocks] =
+    index;
+  dev->ad_nready++;
+
+  adc_notify(dev);
+  leave_critical_section(flags);
+  return next;
+}
+
+/****************************************************************************
+ * Name: adc_release_block
+ ****************************************************************************/
+
+static int adc_release_block(FAR struct adc_dev_s *dev,
+                             unsigned long index)
+{
+  irqstate_t flags;
+  int ret = -EINVAL;
+
+  if (dev->ad_blkbuf == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  flags = enter_critical_section();
+
+  if (index < dev->ad_nblocks && (dev->ad_blkuser & (1ul << index)) != 0)
+    {
+      dev->ad_blkuser &= ~(1ul << index);
+      dev->ad_blkfree |= 1ul << index;
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif /* CONFIG_ADC_BLOCK */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -742,6 +1028,18 @@ int adc_register(FAR const char *path, FAR struct adc_dev_s *dev)
 
   DEBUGASSERT(path != NULL && dev != NULL);
 
+#ifdef CONFIG_ADC_BLOCK
+  if (dev->ad_blkbuf != NULL &&
+      (dev->ad_nblocks < 2 ||
+       dev->ad_nblocks > CONFIG_ADC_BLOCK_MAXBLOCKS ||
+       dev->ad_blksize == 0))
+    {
+      aerr("ERROR: Bad block layout: %u x %zu\n",
+           dev->ad_nblocks, dev->ad_blksize);
+      return -EINVAL;
+    }
+#endif
+
   /* Bind the upper-half callbacks to the lower half ADC driver */
 
   DEBUGASSERT(dev->ad_ops != NULL && dev->ad_ops->ao_bind != NULL);
@@ -48,6 +48,8 @@ struct audio_dma_s
   uint8_t fifo_width;
   bool playback;
   bool xrun;
+  bool mmap;              /* The application streams from the mapped ring */
+  uint32_t periods;       /* Periods done since the start */
   struct dq_queue_s pendq;
   apb_samp_t buffer_size;
   apb_samp_t buffer_num;
@@ -101,6 +103,8 @@ static int audio_dma_enqueuebuffer(struct audio_lowerhalf_s *dev,
                                    struct ap_buffer_s *apb);
 static int audio_dma_ioctl(struct audio_lowerhalf_s *dev, int cmd,
                            unsigned long arg);
+static int audio_dma_mmap(struct audio_lowerhalf_s *dev,
+                          struct mm_map_entry_s *map);
 static void audio_dma_callback(struct dma_chan_s *chan, void *arg,
                                ssize_t len);
 
@@ -127,12 +131,34 @@ static const struct audio_ops_s g_audio_dma_ops =
   .ioctl = audio_dma_ioctl,
   .reserve = audio_dma_reserve,
   .release = audio_dma_release,
+  .mmap = audio_dma_mmap,
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+static int audio_dma_alloc_ring(struct audio_dma_s *audio_dma)
+{
+  if (!audio_dma->alloc_addr)
+    {
+      audio_dma->alloc_addr = kumm_memalign(32,
+                                            audio_dma->buffer_num *
+                                            audio_dma->buffer_size);
+      if (!audio_dma->alloc_addr)
+        {
+          return -ENOMEM;
+        }
+
+      if (audio_dma->playback)
+        audio_dma->src_addr = up_addrenv_va_to_pa(audio_dma->alloc_addr);
+      else
+        audio_dma->dst_addr = up_addrenv_va_to_pa(audio_dma->alloc_addr);
+    }
+
+  return OK;
+}
+
 static int audio_dma_getcaps(struct audio_lowerhalf_s *dev, int type,
                              struct audio_caps_s *caps)
 {
@@ -284,6 +310,14 @@ static int audio_dma_start(struct audio_lowerhalf_s *dev)
 {
   struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
 
+  audio_dma->periods = 0;
+  if (audio_dma->mmap && audio_dma->playback)
+    {
+      up_clean_dcache((uintptr_t)audio_dma->alloc_addr,
+                      (uintptr_t)audio_dma->alloc_addr +
+                      audio_dma->buffer_num * audio_dma->buffer_size);
+    }
+
   return DMA_START_CYCLIC(audio_dma->chan, audio_dma_callback, audio_dma,
                           audio_dma->dst_addr, audio_dma->src_addr,
                           audio_dma->buffer_num * audio_dma->buffer_size,
@@ -346,7 +380,7 @@ static int audio_dma_resume(struct audio_lowerhalf_s *dev)
 {
   struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
 
-  if (dq_empty(&audio_dma->pendq))
+  if (!audio_dma->mmap && dq_empty(&audio_dma->pendq))
     {
       return -EINVAL;
     }
@@ -366,25 +400,14 @@ static int audio_dma_allocbuffer(struct audio_lowerhalf_s *dev,
       return -EINVAL;
     }
 
-  if (audio_dma->alloc_index == audio_dma->buffer_num)
+  if (audio_dma->mmap || audio_dma->alloc_index == audio_dma->buffer_num)
     {
       return -ENOMEM;
     }
 
-  if (!audio_dma->alloc_addr)
+  if (audio_dma_alloc_ring(audio_dma) < 0)
     {
-      audio_dma->alloc_addr = kumm_memalign(32,
-                                            audio_dma->buffer_num *
-                                            audio_dma->buffer_size);
-      if (!audio_dma->alloc_addr)
-        {
-          return -ENOMEM;
-        }
-
-      if (audio_dma->playback)
-        audio_dma->src_addr = up_addrenv_va_to_pa(audio_dma->alloc_addr);
-      else
-        audio_dma->dst_addr = up_addrenv_va_to_pa(audio_dma->alloc_addr);
+      return -ENOMEM;
     }
 
   apb = kumm_zalloc(sizeof(struct ap_buffer_s));
@@ -461,6 +484,9 @@ static int audio_dma_ioctl(struct audio_lowerhalf_s *dev, int cmd,
 {
   struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
   struct ap_buffer_info_s *bufinfo;
+  irqstate_t flags;
+  uint64_t pos;
+  size_t offset;
 
   switch (cmd)
     {
@@ -482,6 +508,26 @@ static int audio_dma_ioctl(struct audio_lowerhalf_s *dev, int cmd,
         kumm_free(audio_dma->alloc_addr);
         audio_dma->alloc_addr = NULL;
         audio_dma->alloc_index = 0;
+        audio_dma->mmap = false;
+
+        return OK;
+
+      /* Report where the DMA is in the ring.  A wrap that the callback has
+       * not seen yet leaves the position a period behind, never ahead.
+       */
+
+      case AUDIOIOC_GETPOSITION:
+        flags  = enter_critical_section();
+        pos    = (uint64_t)audio_dma->periods * audio_dma->buffer_size;
+        offset = 0;
+        if (audio_dma->chan->ops->residual != NULL)
+          {
+            offset = DMA_RESIDUAL(audio_dma->chan) % audio_dma->buffer_size;
+            offset = offset ? audio_dma->buffer_size - offset : 0;
+          }
+
+        leave_critical_section(flags);
+        *(uint64_t *)arg = pos + offset;
 
         return OK;
     }
@@ -507,6 +553,77 @@ static int audio_dma_release(struct audio_lowerhalf_s *dev)
   return OK;
 }
 
+static int audio_dma_mmap(struct audio_lowerhalf_s *dev,
+                          struct mm_map_entry_s *map)
+{
+  struct audio_dma_s *audio_dma = (struct audio_dma_s *)dev;
+  size_t size = audio_dma->buffer_num * audio_dma->buffer_size;
+
+  /* The ring cannot be shared with enqueued buffers */
+
+  if (audio_dma->alloc_index != 0)
+    {
+      return -EBUSY;
+    }
+
+  if (map->offset < 0 || map->length == 0 ||
+      map->offset + map->length > size)
+    {
+      return -EINVAL;
+    }
+
+  if (audio_dma_alloc_ring(audio_dma) < 0)
+    {
+      return -ENOMEM;
+    }
+
+  audio_dma->mmap = true;
+  map->vaddr = audio_dma->alloc_addr + map->offset;
+  return OK;
+}
+
+/* A period of the mapped ring is done.  There is no buffer to hand back,
+ * the DMA just goes round the ring and the application follows it.
+ */
+
+static void audio_dma_period(struct audio_dma_s *audio_dma)
+{
+  struct audio_msg_s msg;
+  uint8_t *period;
+
+  if (audio_dma->playback)
+    {
+      /* The period after the one the DMA has just started on must have
+       * been written by now.
+       */
+
+      period = audio_dma->alloc_addr +
+               (audio_dma->periods + 1) % audio_dma->buffer_num *
+               audio_dma->buffer_size;
+      up_clean_dcache((uintptr_t)period,
+                      (uintptr_t)period + audio_dma->buffer_size);
+    }
+  else
+    {
+      period = audio_dma->alloc_addr +
+               (audio_dma->periods - 1) % audio_dma->buffer_num *
+               audio_dma->buffer_size;
+      up_invalidate_dcache((uintptr_t)period,
+                           (uintptr_t)period + audio_dma->buffer_size);
+    }
+
+  msg.msg_id = AUDIO_MSG_PERIOD;
+  msg.u.data = audio_dma->periods;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  audio_dma->dev.upper(audio_dma->dev.priv, AUDIO_CALLBACK_MESSAGE,
+                       (struct ap_buffer_s *)&msg, OK, NULL);
+#else
+  audio_dma->dev.upper(audio_dma->dev.priv, AUDIO_CALLBACK_MESSAGE,
+                       (struct ap_buffer_s *)&msg, OK);
+#endif
+}
+
 static void audio_dma_callback(struct dma_chan_s *chan,
                                void *arg, ssize_t len)
 {
@@ -514,6 +631,13 @@ static void audio_dma_callback(struct dma_chan_s *chan,
   struct ap_buffer_s *apb;
   bool final = false;
 
+  audio_dma->periods++;
+  if (audio_dma->mmap)
+    {
+      audio_dma_period(audio_dma);
+      return;
+    }
+
   apb = (struct ap_buffer_s *)dq_remfirst(&audio_dma->pendq);
   if (!apb)
     {
@@ -42,10 +42,35 @@
 
 #define MAX_OPENCNT       (255)                  /* Limit of uint8_t */
 
+#if CONFIG_BCH_CACHE_SECTORS > 1
+#  define BCH_CACHE_NSETS    (CONFIG_BCH_CACHE_SECTORS / CONFIG_BCH_CACHE_WAYS)
+#  define BCH_CACHE_NENTRIES (BCH_CACHE_NSETS * CONFIG_BCH_CACHE_WAYS)
+
+/* Mark the sector that was last returned by bchlib_readsector() dirty */
+
+#  define bchlib_markdirty(bch) ((bch)->current->dirty = true)
+#else
+#  define bchlib_markdirty(bch) ((bch)->dirty = true)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#if CONFIG_BCH_CACHE_SECTORS > 1
+/* One sector of the BCH cache.  Entry 'way * BCH_CACHE_NSETS + set' holds
+ * a sector of that set, so that consecutive sectors cached in the same way
+ * are also consecutive in memory.
+ */
+
+struct bch_cache_s
+{
+  size_t sector;           /* The cached sector, (size_t)-1 if none */
+  uint32_t stamp;          /* Time of the last access */
+  bool dirty;              /* true: The sector must be written back */
+};
+#endif
+
 struct bchlib_s
 {
   FAR struct inode *inode; /* I-node of the block driver */
@@ -54,10 +79,23 @@ struct bchlib_s
   size_t sector;           /* The current sector in the buffer */
   mutex_t lock;            /* For atomic accesses to this structure */
   uint8_t refs;            /* Number of references */
+#if CONFIG_BCH_CACHE_SECTORS <= 1
   bool dirty;              /* true: Data has been written to the buffer */
+#endif
   bool readonly;           /* true: Only read operations are supported */
   bool unlinked;           /* true: The driver has been unlinked */
-  FAR uint8_t *buffer;     /* One sector buffer */
+  FAR uint8_t *buffer;     /* Buffer of the current sector */
+
+#if CONFIG_BCH_CACHE_SECTORS > 1
+  FAR uint8_t *cachebuf;   /* Memory of all sectors in the cache */
+  uint32_t stamp;          /* Access time counter of the cache */
+  size_t ranext;           /* The sector following the last miss */
+
+  /* The cache entries and the entry holding the current sector */
+
+  struct bch_cache_s cache[BCH_CACHE_NENTRIES];
+  FAR struct bch_cache_s *current;
+#endif
 
 #if defined(CONFIG_BCH_ENCRYPTION)
   uint8_t key[CONFIG_BCH_ENCRYPTION_KEY_SIZE];  /* Encryption key */
@@ -85,6 +123,10 @@ EXTERN const struct file_operations g_bch_fops;
 
 EXTERN int  bchlib_flushsector(FAR struct bchlib_s *bch, bool discard);
 EXTERN int  bchlib_readsector(FAR struct bchlib_s *bch, size_t sector);
+#if CONFIG_BCH_CACHE_SECTORS > 1
+EXTERN int  bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                              size_t nsectors, bool discard);
+#endif
 
 #undef EXTERN
 #if defined(__cplusplus)
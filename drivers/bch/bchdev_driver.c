@@ -439,7 +439,15 @@ static int bch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         {
           /* Invalidate the sector so next read is from the device- */
 
+#if CONFIG_BCH_CACHE_SECTORS > 1
+          ret = bchlib_flushsector(bch, true);
+          if (ret < 0)
+            {
+              break;
+            }
+#else
           bch->sector = (size_t)-1;
+#endif
           goto ioctl_default;
         }
 
@@ -29,6 +29,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
@@ -62,10 +63,11 @@ static void bch_xor(uint32_t *R, uint32_t *A, uint32_t *B)
  ****************************************************************************/
 
 #if defined(CONFIG_BCH_ENCRYPTION)
-static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
+static int bch_cypher(FAR struct bchlib_s *bch, FAR uint8_t *data,
+                      size_t sector, int encrypt)
 {
   int blocks = bch->sectsize / 16;
-  FAR uint32_t *buffer = (FAR uint32_t *)bch->buffer;
+  FAR uint32_t *buffer = (FAR uint32_t *)data;
   int i;
 
   for (i = 0; i < blocks; i++, buffer += 16 / sizeof(uint32_t) )
@@ -73,7 +75,7 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
       uint32_t T[4];
       uint32_t X[4] =
       {
-        bch->sector, 0, 0, i
+        sector, 0, 0, i
       };
 
       aes_cypher(X, X, 16, NULL, bch->key, CONFIG_BCH_ENCRYPTION_KEY_SIZE,
@@ -91,10 +93,355 @@ static int bch_cypher(FAR struct bchlib_s *bch, int encrypt)
 }
 #endif
 
+#if CONFIG_BCH_CACHE_SECTORS > 1
+/****************************************************************************
+ * Name: bch_cache_buffer
+ *
+ * Description:
+ *   Return the memory holding the sector of a cache entry
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *bch_cache_buffer(FAR struct bchlib_s *bch,
+                                     FAR struct bch_cache_s *entry)
+{
+  return bch->cachebuf + (size_t)(entry - bch->cache) * bch->sectsize;
+}
+
+/****************************************************************************
+ * Name: bch_cache_lookup
+ *
+ * Description:
+ *   Return the cache entry holding 'sector' or NULL if it is not cached
+ *
+ ****************************************************************************/
+
+static FAR struct bch_cache_s *bch_cache_lookup(FAR struct bchlib_s *bch,
+                                                size_t sector)
+{
+  FAR struct bch_cache_s *entry = &bch->cache[sector % BCH_CACHE_NSETS];
+  int way;
+
+  for (way = 0; way < CONFIG_BCH_CACHE_WAYS; way++)
+    {
+      if (entry->sector == sector)
+        {
+          return entry;
+        }
+
+      entry += BCH_CACHE_NSETS;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: bch_cache_victim
+ *
+ * Description:
+ *   Return the entry of the set of 'sector' to be replaced: an unused
+ *   entry if there is one, otherwise the least recently used entry.
+ *
+ ****************************************************************************/
+
+static FAR struct bch_cache_s *bch_cache_victim(FAR struct bchlib_s *bch,
+                                                size_t sector)
+{
+  FAR struct bch_cache_s *entry = &bch->cache[sector % BCH_CACHE_NSETS];
+  FAR struct bch_cache_s *victim = entry;
+  int way;
+
+  for (way = 0; way < CONFIG_BCH_CACHE_WAYS; way++)
+    {
+      if (entry->sector == (size_t)-1)
+        {
+          return entry;
+        }
+
+      if ((int32_t)(entry->stamp - victim->stamp) < 0)
+        {
+          victim = entry;
+        }
+
+      entry += BCH_CACHE_NSETS;
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: bch_cache_writeback
+ *
+ * Description:
+ *   Write a dirty cache entry back to the media.  The dirty entries of the
+ *   same way that hold the sectors just before and after it are adjacent
+ *   in memory and are written back with the same multi-sector write.
+ *
+ ****************************************************************************/
+
+static int bch_cache_writeback(FAR struct bchlib_s *bch,
+                               FAR struct bch_cache_s *entry)
+{
+  FAR struct inode *inode = bch->inode;
+  FAR struct bch_cache_s *first = entry;
+  FAR struct bch_cache_s *last = entry;
+  FAR uint8_t *buffer;
+  size_t fset;
+  size_t lset;
+  size_t nsectors;
+  ssize_t ret;
+
+  fset = (size_t)(entry - bch->cache) % BCH_CACHE_NSETS;
+  lset = fset;
+
+  while (fset > 0 && (first - 1)->dirty &&
+         (first - 1)->sector + 1 == first->sector)
+    {
+      first--;
+      fset--;
+    }
+
+  while (lset + 1 < BCH_CACHE_NSETS && (last + 1)->dirty &&
+         (last + 1)->sector == last->sector + 1)
+    {
+      last++;
+      lset++;
+    }
+
+  nsectors = lset - fset + 1;
+  buffer   = bch_cache_buffer(bch, first);
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  /* Encrypt data as necessary */
+
+  for (entry = first; entry <= last; entry++)
+    {
+      bch_cypher(bch, bch_cache_buffer(bch, entry), entry->sector,
+                 CYPHER_ENCRYPT);
+    }
+#endif
+
+  /* Write the sectors to the media */
+
+  ret = inode->u.i_bops->write(inode, buffer, first->sector, nsectors);
+
+#if defined(CONFIG_BCH_ENCRYPTION)
+  for (entry = first; entry <= last; entry++)
+    {
+      bch_cypher(bch, bch_cache_buffer(bch, entry), entry->sector,
+                 CYPHER_DECRYPT);
+    }
+#endif
+
+  if (ret < 0)
+    {
+      ferr("Write failed: %zd\n", ret);
+      return (int)ret;
+    }
+
+  /* The sectors are now in sync with the media */
+
+  for (entry = first; entry <= last; entry++)
+    {
+      entry->dirty = false;
+    }
+
+  return OK;
+}
+#endif /* CONFIG_BCH_CACHE_SECTORS > 1 */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#if CONFIG_BCH_CACHE_SECTORS > 1
+/****************************************************************************
+ * Name: bchlib_flushrange
+ *
+ * Description:
+ *   Write back the dirty cached sectors in the range [sector, sector +
+ *   nsectors) and, if 'discard' is true, drop them from the cache.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushrange(FAR struct bchlib_s *bch, size_t sector,
+                      size_t nsectors, bool discard)
+{
+  FAR struct bch_cache_s *entry;
+  int ret;
+
+  if (bch->cachebuf == NULL)
+    {
+      return OK;
+    }
+
+  for (entry = bch->cache; entry < &bch->cache[BCH_CACHE_NENTRIES];
+       entry++)
+    {
+      if (entry->sector == (size_t)-1 || entry->sector < sector ||
+          entry->sector - sector >= nsectors)
+        {
+          continue;
+        }
+
+      if (entry->dirty)
+        {
+          ret = bch_cache_writeback(bch, entry);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      if (discard)
+        {
+          entry->sector = (size_t)-1;
+          if (entry == bch->current)
+            {
+              bch->current = NULL;
+              bch->sector  = (size_t)-1;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bchlib_flushsector
+ *
+ * Description:
+ *   Flush all dirty sectors of the cache
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
+{
+  return bchlib_flushrange(bch, 0, SIZE_MAX, discard);
+}
+
+/****************************************************************************
+ * Name: bchlib_readsector
+ *
+ * Description:
+ *   Make 'sector' the current sector, loading it into the cache if
+ *   necessary.  bch->buffer then holds the sector contents.
+ *
+ * Assumptions:
+ *   Caller must assume mutual exclusion
+ *
+ ****************************************************************************/
+
+int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
+{
+  FAR struct inode *inode;
+  FAR struct bch_cache_s *entry;
+  size_t nsectors;
+  size_t i;
+  ssize_t ret;
+
+  if (bch->cachebuf == NULL)
+    {
+#if CONFIG_BCH_BUFFER_ALIGNMENT != 0
+      bch->cachebuf = kmm_memalign(CONFIG_BCH_BUFFER_ALIGNMENT,
+                                   BCH_CACHE_NENTRIES * bch->sectsize);
+#else
+      bch->cachebuf = kmm_malloc(BCH_CACHE_NENTRIES * bch->sectsize);
+#endif
+      if (bch->cachebuf == NULL)
+        {
+          ferr("Failed to allocate sector cache\n");
+          return -ENOMEM;
+        }
+
+      for (i = 0; i < BCH_CACHE_NENTRIES; i++)
+        {
+          bch->cache[i].sector = (size_t)-1;
+          bch->cache[i].dirty  = false;
+        }
+    }
+
+  entry = bch_cache_lookup(bch, sector);
+  if (entry == NULL)
+    {
+      inode        = bch->inode;
+      bch->current = NULL;
+      bch->sector  = (size_t)-1;
+
+      entry = bch_cache_victim(bch, sector);
+      if (entry->dirty)
+        {
+          ret = bch_cache_writeback(bch, entry);
+          if (ret < 0)
+            {
+              ferr("Flush failed: %zd\n", ret);
+              return (int)ret;
+            }
+        }
+
+      nsectors = 1;
+
+#if CONFIG_BCH_CACHE_READAHEAD > 1
+      /* This miss continues the previous one, read the following sectors
+       * into the next entries of the same way with the same request.  Stop
+       * at the end of the way, at a dirty entry, or at a sector that is
+       * already cached.
+       */
+
+      if (sector == bch->ranext)
+        {
+          while (nsectors < CONFIG_BCH_CACHE_READAHEAD &&
+                 sector % BCH_CACHE_NSETS + nsectors < BCH_CACHE_NSETS &&
+                 sector + nsectors < bch->nsectors &&
+                 !entry[nsectors].dirty &&
+                 bch_cache_lookup(bch, sector + nsectors) == NULL)
+            {
+              nsectors++;
+            }
+        }
+#endif
+
+      ret = inode->u.i_bops->read(inode, bch_cache_buffer(bch, entry),
+                                  sector, nsectors);
+      if (ret < 0)
+        {
+          for (i = 0; i < nsectors; i++)
+            {
+              entry[i].sector = (size_t)-1;
+            }
+
+          ferr("Read failed: %zd\n", ret);
+          return (int)ret;
+        }
+
+      for (i = 0; i < nsectors; i++)
+        {
+          entry[i].sector = sector + i;
+          entry[i].stamp  = bch->stamp;
+#if defined(CONFIG_BCH_ENCRYPTION)
+          bch_cypher(bch, bch_cache_buffer(bch, &entry[i]), sector + i,
+                     CYPHER_DECRYPT);
+#endif
+        }
+
+      bch->ranext = sector + nsectors;
+    }
+
+  entry->stamp = ++bch->stamp;
+  bch->current = entry;
+  bch->sector  = sector;
+  bch->buffer  = bch_cache_buffer(bch, entry);
+  return OK;
+}
+
+#else /* CONFIG_BCH_CACHE_SECTORS > 1 */
+
 /****************************************************************************
  * Name: bchlib_flushsector
  *
@@ -122,7 +469,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
 #if defined(CONFIG_BCH_ENCRYPTION)
       /* Encrypt data as necessary */
 
-      bch_cypher(bch, CYPHER_ENCRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_ENCRYPT);
 #endif
 
       /* Write the sector to the media */
@@ -139,7 +486,7 @@ int bchlib_flushsector(FAR struct bchlib_s *bch, bool discard)
        * TODO: Add configuration switch for extra sector buffer
        */
 
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_DECRYPT);
 #endif
 
       /* The sector is now in sync with the media */
@@ -205,9 +552,10 @@ int bchlib_readsector(FAR struct bchlib_s *bch, size_t sector)
 
       bch->sector = sector;
 #if defined(CONFIG_BCH_ENCRYPTION)
-      bch_cypher(bch, CYPHER_DECRYPT);
+      bch_cypher(bch, bch->buffer, bch->sector, CYPHER_DECRYPT);
 #endif
     }
 
   return (int)ret;
 }
+#endif /* CONFIG_BCH_CACHE_SECTORS > 1 */
@@ -148,6 +148,24 @@ ssize_t bchlib_read(FAR void *handle, FAR char *buffer, off_t offset,
           nsectors = bch->nsectors - sector;
         }
 
+      /* The media must be up to date before it is read directly */
+
+#if CONFIG_BCH_CACHE_SECTORS > 1
+      ret = bchlib_flushrange(bch, sector, nsectors, false);
+#else
+      ret = OK;
+      if (sector <= bch->sector && bch->sector < sector + nsectors)
+        {
+          ret = bchlib_flushsector(bch, false);
+        }
+#endif
+
+      if (ret < 0)
+        {
+          ferr("ERROR: Flush failed: %d\n", ret);
+          return ret;
+        }
+
       ret = bch->inode->u.i_bops->read(bch->inode, (FAR uint8_t *)buffer,
                                        sector, nsectors);
       if (ret < 0)
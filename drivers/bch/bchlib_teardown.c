@@ -72,10 +72,17 @@ int bchlib_teardown(FAR void *handle)
 
   /* Free the BCH state structure */
 
+#if CONFIG_BCH_CACHE_SECTORS > 1
+  if (bch->cachebuf)
+    {
+      kmm_free(bch->cachebuf);
+    }
+#else
   if (bch->buffer)
     {
       kmm_free(bch->buffer);
     }
+#endif
 
   nxmutex_destroy(&bch->lock);
   kmm_free(bch);
@@ -107,7 +107,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
         }
 
       memcpy(&bch->buffer[sectoffset], buffer, nbytes);
-      bch->dirty = true;
+      bchlib_markdirty(bch);
 
       /* Adjust pointers and counts */
 
@@ -144,8 +144,9 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       nbytes = len > bch->sectsize ? bch->sectsize : len;
       memcpy(bch->buffer, buffer, nbytes);
-      bch->dirty = true;
+      bchlib_markdirty(bch);
 
+#if CONFIG_BCH_CACHE_SECTORS <= 1
       /* Write the sector back to the block device */
 
       ret = bchlib_flushsector(bch, false);
@@ -154,6 +155,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
           ferr("ERROR: Flush failed: %d\n", ret);
           return ret;
         }
+#endif
 
       /* Adjust pointers and counts */
 
@@ -177,8 +179,12 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
 
       /* Flush the dirty sector to keep the sector sequence */
 
+#if CONFIG_BCH_CACHE_SECTORS > 1
+      ret = bchlib_flushrange(bch, sector, nsectors, true);
+#else
       ret = bchlib_flushsector(bch, sector <= bch->sector &&
                                bch->sector < (sector + nsectors));
+#endif
       if (ret < 0)
         {
           ferr("ERROR: Flush failed: %d\n", ret);
@@ -225,7 +231,7 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, off_t offset,
       /* Copy the head end of the sector from the user buffer */
 
       memcpy(bch->buffer, buffer, len);
-      bch->dirty = true;
+      bchlib_markdirty(bch);
 
       /* Adjust counts */
 
@@ -148,6 +148,21 @@
 #define CTUCANFD_RXSTAT_RXFRC_SHIFT  (4)      /* RX buffer frame count */
 #define CTUCANFD_RXSTAT_RXFRC_MASK   (0x7ff << CTUCANFD_RXSTAT_RXFRC_SHIFT)
 
+/* FILTER_CONTROL and FILTER_STATUS, n is 0 to 2 for the bit-mask filters
+ * A to C.  The identifier of the filters is in the format of the frame ID
+ * register.
+ */
+
+#define CTUCANFD_FLTR_NB(n)          (1 << (4 * (n)))     /* Accept CAN base frames */
+#define CTUCANFD_FLTR_NE(n)          (1 << (4 * (n) + 1)) /* Accept CAN extended frames */
+#define CTUCANFD_FLTR_FB(n)          (1 << (4 * (n) + 2)) /* Accept CAN FD base frames */
+#define CTUCANFD_FLTR_FE(n)          (1 << (4 * (n) + 3)) /* Accept CAN FD extended frames */
+#define CTUCANFD_FLTR_SF(n)          (1 << (16 + (n)))    /* Filter is present */
+#define CTUCANFD_FLTR_NMASK          (3)                  /* Number of bit-mask filters */
+
+#define CTUCANFD_FLTR_MSK(n)         (CTUCANFD_FLTR_A_MSK + 8 * (n))
+#define CTUCANFD_FLTR_VAL(n)         (CTUCANFD_FLTR_A_VAL + 8 * (n))
+
 /* TX_STATUS */
 
 #define CTUCANFD_TXSTAT_SHIFT        (4)   /* TXyS shift */
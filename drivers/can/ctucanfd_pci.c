@@ -30,6 +30,7 @@
 #include <debug.h>
 #include <errno.h>
 #include <stdio.h>
+#include <strings.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
@@ -104,6 +105,14 @@ struct ctucanfd_can_s
   /* This holds the information visible to the NuttX network */
 
   struct netdev_lowerhalf_s dev;
+
+#  ifdef CONFIG_NET_CAN_HWFILTER
+  /* The acceptance filters, restored when the interface is brought up */
+
+  uint32_t                 fltr_msk[CTUCANFD_FLTR_NMASK];
+  uint32_t                 fltr_val[CTUCANFD_FLTR_NMASK];
+  uint32_t                 fltr_ctrl; /* Zero if all frames are accepted */
+#  endif
 #endif
 
   FAR struct pci_device_s *pcidev;
@@ -186,6 +195,13 @@ static int  ctucanfd_sock_ioctl(FAR struct netdev_lowerhalf_s *dev, int cmd,
 static FAR netpkt_t *ctucanfd_sock_error(FAR struct netdev_lowerhalf_s *dev);
 #  endif
 
+#  ifdef CONFIG_NET_CAN_HWFILTER
+static void ctucanfd_sock_fltrapply(FAR struct ctucanfd_can_s *priv);
+static int  ctucanfd_sock_canfilter(FAR struct netdev_lowerhalf_s *dev,
+                                    FAR const struct can_filter *filters,
+                                    int nfilters);
+#  endif
+
 static void ctucanfd_sock_interrupt(FAR struct ctucanfd_driver_s *priv);
 #endif
 
@@ -229,6 +245,9 @@ static const struct netdev_ops_s g_ctucanfd_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   .ioctl    = ctucanfd_sock_ioctl,
 #endif
+#ifdef CONFIG_NET_CAN_HWFILTER
+  .canfilter = ctucanfd_sock_canfilter,
+#endif
 };
 #endif
 
@@ -994,6 +1013,9 @@ static int ctucanfd_sock_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   ctucanfd_reset(priv);
   ctucanfd_setup(priv);
+#  ifdef CONFIG_NET_CAN_HWFILTER
+  ctucanfd_sock_fltrapply(priv);
+#  endif
 
   ctucanfd_txint(priv, true);
   ctucanfd_rxint(priv, true);
@@ -1056,6 +1078,183 @@ static int ctucanfd_sock_ioctl(FAR struct netdev_lowerhalf_s *dev, int cmd,
 
 #  endif  /* CONFIG_NETDEV_IOCTL */
 
+#  ifdef CONFIG_NET_CAN_HWFILTER
+/*****************************************************************************
+ * Name: ctucanfd_sock_fltrapply
+ *
+ * Description:
+ *   Write the saved acceptance filters to the controller.
+ *
+ *****************************************************************************/
+
+static void ctucanfd_sock_fltrapply(FAR struct ctucanfd_can_s *priv)
+{
+  uint32_t regval;
+  int      i;
+
+  for (i = 0; i < CTUCANFD_FLTR_NMASK; i++)
+    {
+      if ((priv->fltr_ctrl &
+           (CTUCANFD_FLTR_NB(i) | CTUCANFD_FLTR_NE(i))) != 0)
+        {
+          ctucanfd_putreg(priv, CTUCANFD_FLTR_MSK(i), priv->fltr_msk[i]);
+          ctucanfd_putreg(priv, CTUCANFD_FLTR_VAL(i), priv->fltr_val[i]);
+        }
+    }
+
+  ctucanfd_putreg(priv, CTUCANFD_FLTR, priv->fltr_ctrl);
+
+  regval = ctucanfd_getreg(priv, CTUCANFD_SET_MODE);
+  if (priv->fltr_ctrl != 0)
+    {
+      regval |= CTUCANFD_MODE_AFM;
+    }
+  else
+    {
+      regval &= ~CTUCANFD_MODE_AFM;
+    }
+
+  ctucanfd_putreg(priv, CTUCANFD_SET_MODE, regval);
+}
+
+/*****************************************************************************
+ * Name: ctucanfd_sock_canfilter
+ *
+ * Description:
+ *   Program the bit-mask filters to pass at least the frames that pass one
+ *   of the CAN_RAW filters.  Each filter becomes a value and a mask in the
+ *   frame ID register format, for base frames, extended frames or both,
+ *   then the pairs that differ least are merged until they fit in the
+ *   filters of the controller.  A merged filter passes a superset of its
+ *   parts, the sockets still filter in software.
+ *
+ *****************************************************************************/
+
+static int ctucanfd_sock_canfilter(FAR struct netdev_lowerhalf_s *dev,
+                                   FAR const struct can_filter *filters,
+                                   int nfilters)
+{
+  FAR struct ctucanfd_can_s *priv = (FAR struct ctucanfd_can_s *)dev;
+  uint32_t msk[2 * CONFIG_NET_CAN_HWFILTER_MAX];
+  uint32_t val[2 * CONFIG_NET_CAN_HWFILTER_MAX];
+  bool     base[2 * CONFIG_NET_CAN_HWFILTER_MAX];
+  bool     ext[2 * CONFIG_NET_CAN_HWFILTER_MAX];
+  uint32_t merged;
+  uint32_t status;
+  int      hwfltr[CTUCANFD_FLTR_NMASK];
+  int      nhw = 0;
+  int      best;
+  int      besti = 0;
+  int      bestj = 0;
+  int      n = 0;
+  int      i;
+  int      j;
+
+  status = ctucanfd_getreg(priv, CTUCANFD_FLTR);
+  for (i = 0; i < CTUCANFD_FLTR_NMASK; i++)
+    {
+      if ((status & CTUCANFD_FLTR_SF(i)) != 0)
+        {
+          hwfltr[nhw++] = i;
+        }
+    }
+
+  if (nhw == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  if (nfilters > CONFIG_NET_CAN_HWFILTER_MAX)
+    {
+      return -E2BIG;
+    }
+
+  for (i = 0; i < nfilters; i++)
+    {
+      canid_t id   = filters[i].can_id;
+      canid_t mask = filters[i].can_mask;
+
+      if ((mask & CAN_EFF_FLAG) == 0 || (id & CAN_EFF_FLAG) == 0)
+        {
+          val[n]   = (id & CAN_SFF_MASK) << 18;
+          msk[n]   = (mask & CAN_SFF_MASK) << 18;
+          base[n]  = true;
+          ext[n++] = false;
+        }
+
+      if ((mask & CAN_EFF_FLAG) == 0 || (id & CAN_EFF_FLAG) != 0)
+        {
+          val[n]   = id & CAN_EFF_MASK;
+          msk[n]   = mask & CAN_EFF_MASK;
+          base[n]  = false;
+          ext[n++] = true;
+        }
+    }
+
+  while (n > nhw)
+    {
+      /* Merge the pair whose merged mask keeps the most bits */
+
+      best = -1;
+      for (i = 0; i < n; i++)
+        {
+          for (j = i + 1; j < n; j++)
+            {
+              merged = msk[i] & msk[j] & ~(val[i] ^ val[j]);
+              if ((int)popcount(merged) > best)
+                {
+                  best  = popcount(merged);
+                  besti = i;
+                  bestj = j;
+                }
+            }
+        }
+
+      msk[besti] &= msk[bestj] & ~(val[besti] ^ val[bestj]);
+      val[besti] &= msk[besti];
+      base[besti] |= base[bestj];
+      ext[besti]  |= ext[bestj];
+
+      n--;
+      msk[bestj]  = msk[n];
+      val[bestj]  = val[n];
+      base[bestj] = base[n];
+      ext[bestj]  = ext[n];
+    }
+
+  priv->fltr_ctrl = 0;
+
+  for (i = 0; i < n; i++)
+    {
+      if (msk[i] == 0)
+        {
+          /* Passes all frames */
+
+          priv->fltr_ctrl = 0;
+          break;
+        }
+
+      priv->fltr_msk[hwfltr[i]] = msk[i];
+      priv->fltr_val[hwfltr[i]] = val[i] & msk[i];
+
+      if (base[i])
+        {
+          priv->fltr_ctrl |= CTUCANFD_FLTR_NB(hwfltr[i]) |
+                             CTUCANFD_FLTR_FB(hwfltr[i]);
+        }
+
+      if (ext[i])
+        {
+          priv->fltr_ctrl |= CTUCANFD_FLTR_NE(hwfltr[i]) |
+                             CTUCANFD_FLTR_FE(hwfltr[i]);
+        }
+    }
+
+  ctucanfd_sock_fltrapply(priv);
+  return OK;
+}
+#  endif  /* CONFIG_NET_CAN_HWFILTER */
+
 /*****************************************************************************
  * Name: ctucanfd_sock_transmit
  *****************************************************************************/
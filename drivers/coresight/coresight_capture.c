@@ -0,0 +1,190 @@
+/****************************************************************************
+ * drivers/coresight/coresight_capture.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <errno.h>
+#include <debug.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+
+#include <nuttx/coresight/coresight_capture.h>
+
+#include "coresight_common.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CORESIGHT_CAPTURE_BUFSIZE 512
+#define CORESIGHT_CAPTURE_PATHLEN 32
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: coresight_capture_start
+ *
+ * Description:
+ *   Set the filter of the source and enable the trace path from the
+ *   source to the sink.
+ *
+ * Input Parameters:
+ *   srcdev  - The ETM of the CPU to trace.
+ *   sinkdev - The ETB or TMC sink that keeps the trace.
+ *   filter  - The trace filter, NULL to trace everything.
+ *
+ * Returned Value:
+ *   Zero on success; a negative value on failure.
+ *
+ ****************************************************************************/
+
+int coresight_capture_start(FAR struct coresight_dev_s *srcdev,
+                            FAR struct coresight_dev_s *sinkdev,
+                            FAR const struct coresight_filter_s *filter)
+{
+  FAR const struct coresight_source_ops_s *ops;
+  struct coresight_filter_s none =
+    {
+      CORESIGHT_FILTER_NONE
+    };
+
+  int ret;
+
+  if (srcdev->type != CORESIGHT_DEV_TYPE_SOURCE ||
+      sinkdev->type != CORESIGHT_DEV_TYPE_SINK)
+    {
+      return -EINVAL;
+    }
+
+  /* Clear the filter of a previous capture if there is none */
+
+  ops = srcdev->ops->source_ops;
+  if (ops->filter != NULL)
+    {
+      ret = ops->filter(srcdev, filter != NULL ? filter : &none);
+      if (ret < 0)
+        {
+          cserr("%s filter failed: %d\n", srcdev->name, ret);
+          return ret;
+        }
+    }
+  else if (filter != NULL && (filter->mode != CORESIGHT_FILTER_NONE ||
+                              filter->cycacc))
+    {
+      return -ENOTSUP;
+    }
+
+  return coresight_enable(srcdev, sinkdev);
+}
+
+/****************************************************************************
+ * Name: coresight_capture_stop
+ ****************************************************************************/
+
+void coresight_capture_stop(FAR struct coresight_dev_s *srcdev)
+{
+  coresight_disable(srcdev);
+}
+
+/****************************************************************************
+ * Name: coresight_capture_dump
+ *
+ * Description:
+ *   Copy the raw trace of the sink from its character driver to a file.
+ *
+ * Input Parameters:
+ *   sinkdev - The sink of coresight_capture_start().
+ *   path    - The file to create or truncate.
+ *
+ * Returned Value:
+ *   The number of bytes written on success; a negative value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t coresight_capture_dump(FAR struct coresight_dev_s *sinkdev,
+                               FAR const char *path)
+{
+  char devpath[CORESIGHT_CAPTURE_PATHLEN];
+  struct file in;
+  struct file out;
+  FAR char *buffer;
+  ssize_t total = 0;
+  ssize_t nread;
+  ssize_t ret;
+
+  buffer = kmm_malloc(CORESIGHT_CAPTURE_BUFSIZE);
+  if (buffer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* The sinks read their buffer out when they are opened */
+
+  snprintf(devpath, sizeof(devpath), "/dev/%s", sinkdev->name);
+  ret = file_open(&in, devpath, O_RDONLY | O_CLOEXEC);
+  if (ret < 0)
+    {
+      cserr("open %s failed: %zd\n", devpath, ret);
+      goto errout_with_buffer;
+    }
+
+  ret = file_open(&out, path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                  0666);
+  if (ret < 0)
+    {
+      cserr("open %s failed: %zd\n", path, ret);
+      goto errout_with_in;
+    }
+
+  for (; ; )
+    {
+      nread = file_read(&in, buffer, CORESIGHT_CAPTURE_BUFSIZE);
+      if (nread <= 0)
+        {
+          ret = nread;
+          break;
+        }
+
+      ret = file_write(&out, buffer, nread);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      total += ret;
+    }
+
+  file_close(&out);
+
+errout_with_in:
+  file_close(&in);
+
+errout_with_buffer:
+  kmm_free(buffer);
+  return ret < 0 ? ret : total;
+}
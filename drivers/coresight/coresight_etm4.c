@@ -24,6 +24,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/param.h>
+
 #include <errno.h>
 #include <debug.h>
 #include <nuttx/arch.h>
@@ -580,6 +582,8 @@
 
 static int etm4_enable(FAR struct coresight_dev_s *csdev);
 static void etm4_disable(FAR struct coresight_dev_s *csdev);
+static int etm4_filter(FAR struct coresight_dev_s *csdev,
+                       FAR const struct coresight_filter_s *filter);
 
 /****************************************************************************
  * Private Data
@@ -589,6 +593,7 @@ static const struct coresight_source_ops_s g_etm4_source_ops =
 {
   .enable  = etm4_enable,
   .disable = etm4_disable,
+  .filter  = etm4_filter,
 };
 
 static const struct coresight_ops_s g_etm4_ops =
@@ -1157,6 +1162,85 @@ static void etm4_disable(FAR struct coresight_dev_s *csdev)
   etm4_disclaim_device(etmdev);
 }
 
+/****************************************************************************
+ * Name: etm4_filter
+ *
+ * Description:
+ *   Set the instruction trace filter of the next enable.  A range uses the
+ *   first pair of address comparators as an include range, start-stop uses
+ *   them as the single address comparators of the ViewInst start-stop
+ *   logic, which then begins in the stopped state.
+ *
+ * Input Parameters:
+ *   csdev  - Pointer to the coresight device structure.
+ *   filter - The filter.
+ *
+ * Returned Value:
+ *   Zero on success; a negative value on failure.
+ *
+ ****************************************************************************/
+
+static int etm4_filter(FAR struct coresight_dev_s *csdev,
+                       FAR const struct coresight_filter_s *filter)
+{
+  FAR struct coresight_etm4_dev_s *etmdev =
+    (FAR struct coresight_etm4_dev_s *)csdev;
+  FAR struct etm4_config_s *config = &etmdev->cfg;
+
+  if (csdev->refcnt > 0)
+    {
+      return -EBUSY;
+    }
+
+  if ((filter->mode != CORESIGHT_FILTER_NONE && etmdev->nr_addr_cmp == 0) ||
+      (filter->cycacc && !etmdev->trccci))
+    {
+      return -ENOTSUP;
+    }
+
+  config->viiectlr    = 0;
+  config->vissctlr    = 0;
+  config->vinst_ctrl |= TRCVICTLR_SSSTATUS;
+
+  switch (filter->mode)
+    {
+      case CORESIGHT_FILTER_NONE:
+        break;
+
+      case CORESIGHT_FILTER_RANGE:
+        config->addr_val[0] = filter->start;
+        config->addr_val[1] = filter->end;
+        config->addr_acc[0] = 0;
+        config->addr_acc[1] = 0;
+        config->viiectlr    = BIT(0);
+        break;
+
+      case CORESIGHT_FILTER_STARTSTOP:
+        config->addr_val[0] = filter->start;
+        config->addr_val[1] = filter->end;
+        config->addr_acc[0] = 0;
+        config->addr_acc[1] = 0;
+        config->vissctlr    = BIT(0) | BIT(16 + 1);
+        config->vinst_ctrl &= ~TRCVICTLR_SSSTATUS;
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  if (filter->cycacc)
+    {
+      config->cfg   |= TRCCONFIGR_CCI;
+      config->ccctlr = MAX(ETM4_CYC_THRESHOLD_DEFAULT, etmdev->ccitmin);
+    }
+  else
+    {
+      config->cfg &= ~TRCCONFIGR_CCI;
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: etm4_enable_trace_filtering
  *
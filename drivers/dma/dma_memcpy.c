@@ -0,0 +1,272 @@
+/****************************************************************************
+ * drivers/dma/dma_memcpy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sched.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/cache.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/dma/dma.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A registered memory to memory channel */
+
+struct dma_memcpy_chan_s
+{
+  FAR struct dma_chan_s *chan;
+  dma_memcpy_callback_t callback;
+  FAR void *arg;
+  uintptr_t dst;                    /* The copy that is running */
+  size_t len;
+  bool busy;
+};
+
+/* A dma_memcpy() that waits for its channel */
+
+struct dma_memcpy_wait_s
+{
+  sem_t sem;
+  ssize_t result;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct dma_memcpy_chan_s g_dma_memcpy[CONFIG_DMA_MEMCPY_NCHANS];
+static int g_dma_memcpy_nchans;
+static spinlock_t g_dma_memcpy_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_memcpy_width
+ *
+ * Description:
+ *   The widest transfer that the alignment of the copy allows.
+ *
+ ****************************************************************************/
+
+static unsigned int dma_memcpy_width(uintptr_t dst, uintptr_t src,
+                                     size_t len)
+{
+  uintptr_t bits = dst | src | len;
+  unsigned int width;
+
+  for (width = 8; width > 1; width >>= 1)
+    {
+      if ((bits & (width - 1)) == 0)
+        {
+          break;
+        }
+    }
+
+  return width;
+}
+
+/****************************************************************************
+ * Name: dma_memcpy_done
+ *
+ * Description:
+ *   The DMA completion callback, free the channel before passing the
+ *   result on so that the user callback can start the next copy.
+ *
+ ****************************************************************************/
+
+static void dma_memcpy_done(FAR struct dma_chan_s *chan, FAR void *arg,
+                            ssize_t len)
+{
+  FAR struct dma_memcpy_chan_s *mchan = arg;
+  dma_memcpy_callback_t callback = mchan->callback;
+  FAR void *cbarg = mchan->arg;
+  irqstate_t flags;
+
+  /* Drop what the CPU may have prefetched while the copy was running */
+
+  up_invalidate_dcache(mchan->dst, mchan->dst + mchan->len);
+
+  flags = spin_lock_irqsave(&g_dma_memcpy_lock);
+  mchan->busy = false;
+  spin_unlock_irqrestore(&g_dma_memcpy_lock, flags);
+
+  callback(cbarg, len);
+}
+
+/****************************************************************************
+ * Name: dma_memcpy_wakeup
+ ****************************************************************************/
+
+static void dma_memcpy_wakeup(FAR void *arg, ssize_t len)
+{
+  FAR struct dma_memcpy_wait_s *wait = arg;
+
+  wait->result = len;
+  nxsem_post(&wait->sem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dma_memcpy_register
+ ****************************************************************************/
+
+int dma_memcpy_register(FAR struct dma_dev_s *dev, unsigned int ident)
+{
+  FAR struct dma_chan_s *chan;
+  irqstate_t flags;
+
+  chan = DMA_GET_CHAN(dev, ident);
+  if (chan == NULL)
+    {
+      return -ENODEV;
+    }
+
+  flags = spin_lock_irqsave(&g_dma_memcpy_lock);
+  if (g_dma_memcpy_nchans >= CONFIG_DMA_MEMCPY_NCHANS)
+    {
+      spin_unlock_irqrestore(&g_dma_memcpy_lock, flags);
+      DMA_PUT_CHAN(dev, chan);
+      return -ENOSPC;
+    }
+
+  g_dma_memcpy[g_dma_memcpy_nchans++].chan = chan;
+  spin_unlock_irqrestore(&g_dma_memcpy_lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dma_memcpy_async
+ ****************************************************************************/
+
+int dma_memcpy_async(FAR void *dst, FAR const void *src, size_t len,
+                     dma_memcpy_callback_t callback, FAR void *arg)
+{
+  FAR struct dma_memcpy_chan_s *mchan = NULL;
+  struct dma_config_s cfg;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  if (len == 0 || callback == NULL)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave(&g_dma_memcpy_lock);
+  for (i = 0; i < g_dma_memcpy_nchans; i++)
+    {
+      if (!g_dma_memcpy[i].busy)
+        {
+          mchan       = &g_dma_memcpy[i];
+          mchan->busy = true;
+          break;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_dma_memcpy_lock, flags);
+
+  if (mchan == NULL)
+    {
+      return -EBUSY;
+    }
+
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.direction = DMA_MEM_TO_MEM;
+  cfg.dst_width = dma_memcpy_width((uintptr_t)dst, (uintptr_t)src, len);
+  cfg.src_width = cfg.dst_width;
+  cfg.dst_step  = cfg.dst_width;
+  cfg.src_step  = cfg.src_width;
+
+  mchan->callback = callback;
+  mchan->arg      = arg;
+  mchan->dst      = (uintptr_t)dst;
+  mchan->len      = len;
+
+  /* The engine reads the memory, not the cache, and the dirty lines of the
+   * destination must not be written back over the copy.
+   */
+
+  up_clean_dcache((uintptr_t)src, (uintptr_t)src + len);
+  up_flush_dcache((uintptr_t)dst, (uintptr_t)dst + len);
+
+  ret = DMA_CONFIG(mchan->chan, &cfg);
+  if (ret >= 0)
+    {
+      ret = DMA_START(mchan->chan, dma_memcpy_done, mchan,
+                      (uintptr_t)dst, (uintptr_t)src, len);
+    }
+
+  if (ret < 0)
+    {
+      flags = spin_lock_irqsave(&g_dma_memcpy_lock);
+      mchan->busy = false;
+      spin_unlock_irqrestore(&g_dma_memcpy_lock, flags);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dma_memcpy
+ ****************************************************************************/
+
+FAR void *dma_memcpy(FAR void *dst, FAR const void *src, size_t len)
+{
+  struct dma_memcpy_wait_s wait;
+
+  if (len >= CONFIG_DMA_MEMCPY_THRESHOLD && !up_interrupt_context() &&
+      !sched_idletask())
+    {
+      nxsem_init(&wait.sem, 0, 0);
+
+      if (dma_memcpy_async(dst, src, len, dma_memcpy_wakeup, &wait) >= 0)
+        {
+          nxsem_wait_uninterruptible(&wait.sem);
+          if (wait.result == (ssize_t)len)
+            {
+              nxsem_destroy(&wait.sem);
+              return dst;
+            }
+        }
+
+      nxsem_destroy(&wait.sem);
+    }
+
+  return memcpy(dst, src, len);
+}
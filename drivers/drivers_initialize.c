@@ -36,6 +36,7 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/net/loopback.h>
 #include <nuttx/net/tun.h>
+#include <nuttx/net/netbench.h>
 #include <nuttx/net/telnet.h>
 #include <nuttx/note/note_driver.h>
 #include <nuttx/pci/pci.h>
@@ -151,6 +152,10 @@ void drivers_initialize(void)
   devascii_register();  /* Non-standard /dev/ascii */
 #endif
 
+#if defined(CONFIG_DEV_KBENCH)
+  devkbench_register(); /* Non-standard /dev/kbench */
+#endif
+
 #if defined(CONFIG_DRIVERS_NOTE)
   note_initialize();    /* Non-standard /dev/note */
 #endif
@@ -231,6 +236,12 @@ void drivers_initialize(void)
   tun_initialize();
 #endif
 
+#ifdef CONFIG_NET_BENCH
+  /* Initialize the benchmark network device */
+
+  netbench_initialize();
+#endif
+
 #ifdef CONFIG_NETDEV_TELNET
   /* Initialize the Telnet session factory */
 
@@ -0,0 +1,213 @@
+/****************************************************************************
+ * drivers/i2c/i2c_async.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <nuttx/i2c/i2c_master.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct i2c_async_s
+{
+  FAR struct i2c_master_s *dev;       /* The bus the requests go to */
+  FAR struct kwork_wqueue_s *wqueue;  /* The thread that runs them */
+  struct work_s work;
+  spinlock_t lock;                    /* Protects queue and running */
+  sq_queue_t queue;                   /* Requests not started yet */
+  bool running;                       /* The worker is draining queue */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR struct i2c_request_s *i2c_async_next(FAR struct i2c_async_s *bus)
+{
+  FAR struct i2c_request_s *req;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&bus->lock);
+  req = (FAR struct i2c_request_s *)sq_remfirst(&bus->queue);
+  if (req == NULL)
+    {
+      bus->running = false;
+    }
+
+  spin_unlock_irqrestore(&bus->lock, flags);
+  return req;
+}
+
+/* Run the queued requests one after the other, including the ones the
+ * callbacks queue, and go back to sleep only with the queue empty.
+ */
+
+static void i2c_async_worker(FAR void *arg)
+{
+  FAR struct i2c_async_s *bus = arg;
+  FAR struct i2c_request_s *req;
+  int ret;
+
+  while ((req = i2c_async_next(bus)) != NULL)
+    {
+      ret = I2C_TRANSFER(bus->dev, req->msgs, req->count);
+      req->callback(req, ret >= 0 ? OK : ret);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: i2c_async_initialize
+ *
+ * Description:
+ *   Create the request queue of an I2C bus, with the thread that performs
+ *   the queued transfers.
+ *
+ * Input Parameters:
+ *   dev - The I2C master the requests are sent to
+ *
+ * Returned Value:
+ *   The queue handle on success, NULL if out of memory.
+ *
+ ****************************************************************************/
+
+FAR struct i2c_async_s *i2c_async_initialize(FAR struct i2c_master_s *dev)
+{
+  FAR struct i2c_async_s *bus;
+
+  DEBUGASSERT(dev != NULL);
+
+  bus = kmm_zalloc(sizeof(struct i2c_async_s));
+  if (bus == NULL)
+    {
+      return NULL;
+    }
+
+  bus->wqueue = work_queue_create("i2c_async", CONFIG_I2C_ASYNC_PRIORITY,
+                                  NULL, CONFIG_I2C_ASYNC_STACKSIZE, 1);
+  if (bus->wqueue == NULL)
+    {
+      kmm_free(bus);
+      return NULL;
+    }
+
+  bus->dev = dev;
+  spin_lock_init(&bus->lock);
+  sq_init(&bus->queue);
+  return bus;
+}
+
+/****************************************************************************
+ * Name: i2c_async_uninitialize
+ *
+ * Description:
+ *   Destroy a queue created by i2c_async_initialize().  The requests that
+ *   were not started yet complete with -ECANCELED, the caller must make
+ *   sure that none is running.
+ *
+ * Input Parameters:
+ *   bus - The queue handle
+ *
+ ****************************************************************************/
+
+void i2c_async_uninitialize(FAR struct i2c_async_s *bus)
+{
+  FAR struct i2c_request_s *req;
+
+  work_queue_free(bus->wqueue);
+
+  while ((req = (FAR struct i2c_request_s *)sq_remfirst(&bus->queue)))
+    {
+      req->callback(req, -ECANCELED);
+    }
+
+  kmm_free(bus);
+}
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue req for I2C_TRANSFER() on the bus and return at once.  The
+ *   requests are performed in order by the thread of the queue, and the
+ *   callback of each one is called from that thread with the result of
+ *   the transfer.  A callback may queue the next request, which starts
+ *   right after it returns.
+ *
+ *   This may be called from an interrupt handler, e.g. to read a sensor
+ *   from its data ready interrupt.  req and the messages and buffers it
+ *   points to belong to the queue until the callback is called.
+ *
+ * Input Parameters:
+ *   bus - The queue handle
+ *   req - The request, with msgs, count and callback set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_async_s *bus,
+                       FAR struct i2c_request_s *req)
+{
+  irqstate_t flags;
+  bool start;
+  int ret = OK;
+
+  DEBUGASSERT(req->msgs != NULL && req->count > 0 && req->callback);
+
+  flags = spin_lock_irqsave(&bus->lock);
+  sq_addlast(&req->node, &bus->queue);
+  start = !bus->running;
+  bus->running = true;
+  spin_unlock_irqrestore(&bus->lock, flags);
+
+  if (start)
+    {
+      ret = work_queue_wq(bus->wqueue, &bus->work, i2c_async_worker,
+                          bus, 0);
+      if (ret < 0)
+        {
+          flags = spin_lock_irqsave(&bus->lock);
+          sq_rem(&req->node, &bus->queue);
+          bus->running = false;
+          spin_unlock_irqrestore(&bus->lock, flags);
+        }
+    }
+
+  return ret;
+}
@@ -0,0 +1,371 @@
+/****************************************************************************
+ * drivers/input/input_buffer.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/input/input_buffer.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Largest header that evsize() is given */
+
+#define INPUT_HDRSIZE 16
+
+/* The ring is allocated where the reader can map it */
+
+#ifdef CONFIG_BUILD_KERNEL
+#  define ring_zalloc(s) kmm_zalloc(s)
+#  define ring_free(p)   kmm_free(p)
+#else
+#  define ring_zalloc(s) kumm_zalloc(s)
+#  define ring_free(p)   kumm_free(p)
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ring_alloc
+ ****************************************************************************/
+
+static FAR struct input_ring_s *ring_alloc(size_t size)
+{
+  FAR struct input_ring_s *ring;
+  size_t n = 1;
+
+  if (size == 0 || size > UINT32_MAX / 2)
+    {
+      return NULL;
+    }
+
+  while (n < size)
+    {
+      n <<= 1;
+    }
+
+  ring = ring_zalloc(SIZEOF_INPUT_RING_S(n));
+  if (ring != NULL)
+    {
+      ring->size = n;
+    }
+
+  return ring;
+}
+
+/****************************************************************************
+ * Name: ring_copyin and ring_copyout
+ ****************************************************************************/
+
+static void ring_copyin(FAR struct input_ring_s *ring, uint32_t pos,
+                        FAR const void *src, size_t len)
+{
+  size_t off = pos & (ring->size - 1);
+  size_t n = MIN(len, ring->size - off);
+
+  memcpy(&ring->data[off], src, n);
+  memcpy(ring->data, (FAR const char *)src + n, len - n);
+}
+
+static void ring_copyout(FAR struct input_ring_s *ring, uint32_t pos,
+                         FAR void *dst, size_t len)
+{
+  size_t off = pos & (ring->size - 1);
+  size_t n = MIN(len, ring->size - off);
+
+  memcpy(dst, &ring->data[off], n);
+  memcpy((FAR char *)dst + n, ring->data, len - n);
+}
+
+/****************************************************************************
+ * Name: buffer_evsize
+ *
+ * Description:
+ *   Return the size of the event at pos, which is followed by used bytes.
+ *
+ ****************************************************************************/
+
+static size_t buffer_evsize(FAR struct input_buffer_s *buffer,
+                            uint32_t pos, uint32_t used)
+{
+  union
+    {
+      uint64_t align;
+      uint8_t  bytes[INPUT_HDRSIZE];
+    } hdr;
+
+  size_t n = buffer->hdrsize;
+
+  if (buffer->evsize != NULL)
+    {
+      ring_copyout(buffer->ring, pos, hdr.bytes, MIN(n, used));
+      n = buffer->evsize(hdr.bytes);
+    }
+
+  return n > 0 && n <= used ? n : used;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: input_buffer_init
+ ****************************************************************************/
+
+int input_buffer_init(FAR struct input_buffer_s *buffer, size_t size,
+                      size_t hdrsize, input_evsize_t evsize)
+{
+  DEBUGASSERT(hdrsize > 0 && (evsize == NULL || hdrsize <= INPUT_HDRSIZE));
+
+  buffer->ring = ring_alloc(size);
+  if (buffer->ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  buffer->evsize  = evsize;
+  buffer->hdrsize = hdrsize;
+  buffer->mapped  = false;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: input_buffer_uninit
+ ****************************************************************************/
+
+void input_buffer_uninit(FAR struct input_buffer_s *buffer)
+{
+  ring_free(buffer->ring);
+  buffer->ring = NULL;
+}
+
+/****************************************************************************
+ * Name: input_buffer_resize
+ ****************************************************************************/
+
+int input_buffer_resize(FAR struct input_buffer_s *buffer, size_t size)
+{
+  FAR struct input_ring_s *ring;
+
+  if (buffer->mapped)
+    {
+      return -EBUSY;
+    }
+
+  if (size < buffer->hdrsize)
+    {
+      return -EINVAL;
+    }
+
+  ring = ring_alloc(size);
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring_free(buffer->ring);
+  buffer->ring = ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: input_buffer_is_empty
+ ****************************************************************************/
+
+bool input_buffer_is_empty(FAR struct input_buffer_s *buffer)
+{
+  return buffer->ring->head == buffer->ring->tail;
+}
+
+/****************************************************************************
+ * Name: input_buffer_write
+ ****************************************************************************/
+
+void input_buffer_write(FAR struct input_buffer_s *buffer,
+                        FAR const void *event, size_t len)
+{
+  FAR struct input_ring_s *ring = buffer->ring;
+  uint32_t used = ring->head - ring->tail;
+
+  if (len > ring->size)
+    {
+      ring->dropped++;
+      return;
+    }
+
+  if (buffer->mapped)
+    {
+      /* The reader owns the tail, drop the new event */
+
+      if (used > ring->size || ring->size - used < len)
+        {
+          ring->dropped++;
+          return;
+        }
+    }
+  else
+    {
+      while (ring->size - used < len)
+        {
+          uint32_t n = buffer_evsize(buffer, ring->tail, used);
+
+          ring->tail += n;
+          ring->dropped++;
+          used -= n;
+        }
+    }
+
+  ring_copyin(ring, ring->head, event, len);
+
+  /* The event must be complete before a mapped reader sees it */
+
+  SMP_WMB();
+  ring->head += len;
+}
+
+/****************************************************************************
+ * Name: input_buffer_read
+ ****************************************************************************/
+
+ssize_t input_buffer_read(FAR struct input_buffer_s *buffer,
+                          FAR char *data, size_t len)
+{
+  FAR struct input_ring_s *ring = buffer->ring;
+  uint32_t used = ring->head - ring->tail;
+  size_t total = 0;
+  size_t n;
+
+  if (used > ring->size)
+    {
+      /* A mapped reader broke the tail */
+
+      ring->tail = ring->head;
+      return 0;
+    }
+
+  if (buffer->evsize == NULL)
+    {
+      /* Fixed size events are moved in one go */
+
+      total = MIN(used, len - len % buffer->hdrsize);
+      ring_copyout(ring, ring->tail, data, total);
+      ring->tail += total;
+      used -= total;
+    }
+  else
+    {
+      while (used > 0)
+        {
+          n = buffer_evsize(buffer, ring->tail, used);
+          if (n > len - total)
+            {
+              break;
+            }
+
+          ring_copyout(ring, ring->tail, data + total, n);
+          ring->tail += n;
+          used  -= n;
+          total += n;
+        }
+    }
+
+  if (total == 0 && used > 0)
+    {
+      /* Return the start of an event that does not fit and drop the rest,
+       * so that the next read starts with a whole event again.
+       */
+
+      n = buffer_evsize(buffer, ring->tail, used);
+      total = MIN(len, n);
+      ring_copyout(ring, ring->tail, data, total);
+      ring->tail += n;
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: input_buffer_ioctl
+ ****************************************************************************/
+
+int input_buffer_ioctl(FAR struct input_buffer_s *buffer, int cmd,
+                       unsigned long arg)
+{
+  switch (cmd)
+    {
+      case INPUTIOC_SETBUFSIZE:
+        return input_buffer_resize(buffer, (size_t)arg);
+
+      case INPUTIOC_GETBUFSIZE:
+        {
+          FAR size_t *size = (FAR size_t *)((uintptr_t)arg);
+
+          if (size == NULL)
+            {
+              return -EINVAL;
+            }
+
+          *size = SIZEOF_INPUT_RING_S(buffer->ring->size);
+          return OK;
+        }
+
+      default:
+        return -ENOTTY;
+    }
+}
+
+/****************************************************************************
+ * Name: input_buffer_mmap
+ ****************************************************************************/
+
+int input_buffer_mmap(FAR struct input_buffer_s *buffer,
+                      FAR struct mm_map_entry_s *map)
+{
+#ifdef CONFIG_BUILD_KERNEL
+  return -ENOSYS;
+#else
+  if (map->offset != 0 || map->length == 0 ||
+      map->length > SIZEOF_INPUT_RING_S(buffer->ring->size))
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr     = buffer->ring;
+  buffer->mapped = true;
+  return OK;
+#endif
+}
@@ -31,12 +31,12 @@
 #include <fcntl.h>
 #include <poll.h>
 
+#include <nuttx/input/input_buffer.h>
 #include <nuttx/input/keyboard.h>
 #include <nuttx/input/kbd_codec.h>
 #include <nuttx/input/virtio-input-event-codes.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/list.h>
-#include <nuttx/circbuf.h>
 #include <nuttx/mutex.h>
 
 /****************************************************************************
@@ -49,11 +49,11 @@
 
 struct keyboard_opriv_s
 {
-  sem_t              waitsem;
-  mutex_t            lock;
-  struct circbuf_s   circ;
-  struct list_node   node;
-  FAR struct pollfd *fds;
+  sem_t                 waitsem;
+  mutex_t               lock;
+  struct input_buffer_s buffer;
+  struct list_node      node;
+  FAR struct pollfd    *fds;
 };
 
 /* This structure is for keyboard upper half driver */
@@ -77,6 +77,10 @@ static ssize_t keyboard_read(FAR struct file *filep, FAR char *buffer,
                              size_t len);
 static ssize_t keyboard_write(FAR struct file *filep, FAR const char *buffer,
                               size_t len);
+static int     keyboard_ioctl(FAR struct file *filep, int cmd,
+                              unsigned long arg);
+static int     keyboard_mmap(FAR struct file *filep,
+                             FAR struct mm_map_entry_s *map);
 static int     keyboard_poll(FAR struct file *filep, FAR struct pollfd *fds,
                              bool setup);
 
@@ -91,8 +95,8 @@ static const struct file_operations g_keyboard_fops =
   keyboard_read,  /* read */
   keyboard_write, /* write */
   NULL,           /* seek */
-  NULL,           /* ioctl */
-  NULL,           /* mmap */
+  keyboard_ioctl, /* ioctl */
+  keyboard_mmap,  /* mmap */
   NULL,           /* truncate */
   keyboard_poll   /* poll */
 };
@@ -127,8 +131,9 @@ static int keyboard_open(FAR struct file *filep)
 
   /* Initializes the buffer for each open file */
 
-  ret = circbuf_init(&opriv->circ, NULL,
-                     upper->nums * sizeof(struct keyboard_event_s));
+  ret = input_buffer_init(&opriv->buffer,
+                          upper->nums * sizeof(struct keyboard_event_s),
+                          sizeof(struct keyboard_event_s), NULL);
   if (ret < 0)
     {
       kmm_free(opriv);
@@ -143,7 +148,7 @@ static int keyboard_open(FAR struct file *filep)
       ret = upper->lower->open(upper->lower);
       if (ret < 0)
         {
-          circbuf_uninit(&opriv->circ);
+          input_buffer_uninit(&opriv->buffer);
           kmm_free(opriv);
           nxmutex_unlock(&upper->lock);
           return ret;
@@ -188,7 +193,7 @@ static int keyboard_close(FAR struct file *filep)
     }
 
   list_delete(&opriv->node);
-  circbuf_uninit(&opriv->circ);
+  input_buffer_uninit(&opriv->buffer);
   nxsem_destroy(&opriv->waitsem);
   nxmutex_destroy(&opriv->lock);
   kmm_free(opriv);
@@ -218,7 +223,7 @@ static ssize_t keyboard_read(FAR struct file *filep,
 
   /* Is there keyboard data now? */
 
-  while (circbuf_is_empty(&opriv->circ))
+  while (input_buffer_is_empty(&opriv->buffer))
     {
       if ((filep->f_oflags & O_NONBLOCK) != 0)
         {
@@ -242,13 +247,54 @@ static ssize_t keyboard_read(FAR struct file *filep,
         }
     }
 
-  ret = circbuf_read(&opriv->circ, buff, len);
+  ret = input_buffer_read(&opriv->buffer, buff, len);
 
 out:
   nxmutex_unlock(&opriv->lock);
   return ret;
 }
 
+/****************************************************************************
+ * Name: keyboard_ioctl
+ ****************************************************************************/
+
+static int keyboard_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct keyboard_opriv_s *opriv = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&opriv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = input_buffer_ioctl(&opriv->buffer, cmd, arg);
+  nxmutex_unlock(&opriv->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: keyboard_mmap
+ ****************************************************************************/
+
+static int keyboard_mmap(FAR struct file *filep,
+                         FAR struct mm_map_entry_s *map)
+{
+  FAR struct keyboard_opriv_s *opriv = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&opriv->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = input_buffer_mmap(&opriv->buffer, map);
+  nxmutex_unlock(&opriv->lock);
+  return ret;
+}
+
 /****************************************************************************
  * Name: keyboard_poll
  ****************************************************************************/
@@ -278,7 +324,7 @@ static int keyboard_poll(FAR struct file *filep,
           goto errout;
         }
 
-      if (!circbuf_is_empty(&opriv->circ))
+      if (!input_buffer_is_empty(&opriv->buffer))
         {
           poll_notify(&fds, 1, POLLIN);
         }
@@ -408,8 +454,8 @@ void keyboard_event(FAR struct keyboard_lowerhalf_s *lower, uint32_t keycode,
     {
       if (nxmutex_lock(&opriv->lock) == 0)
         {
-          circbuf_overwrite(&opriv->circ, &key,
-                            sizeof(struct keyboard_event_s));
+          input_buffer_write(&opriv->buffer, &key,
+                             sizeof(struct keyboard_event_s));
           nxsem_get_value(&opriv->waitsem, &semcount);
           if (semcount < 1)
             {
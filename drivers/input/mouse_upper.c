@@ -30,12 +30,12 @@
 #include <fcntl.h>
 #include <poll.h>
 
+#include <nuttx/input/input_buffer.h>
 #include <nuttx/input/mouse.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/list.h>
-#include <nuttx/circbuf.h>
 
 /****************************************************************************
  * Private Types
@@ -43,11 +43,11 @@
 
 struct mouse_openpriv_s
 {
-  struct circbuf_s   circbuf; /* Store mouse point data in circle buffer */
-  struct list_node   node;    /* Opened file buffer linked list node */
-  FAR struct pollfd *fds;     /* Polling structure of waiting thread */
-  sem_t              waitsem; /* Used to wait for the availability of data */
-  mutex_t            lock;    /* Manages exclusive access to this structure */
+  struct input_buffer_s buffer;  /* Store mouse reports in event buffer */
+  struct list_node      node;    /* Opened file buffer linked list node */
+  FAR struct pollfd    *fds;     /* Polling structure of waiting thread */
+  sem_t                 waitsem; /* Used to wait for the availability of data */
+  mutex_t               lock;    /* Manages exclusive access to this structure */
 };
 
 /* This structure is for mouse upper half driver */
@@ -70,6 +70,8 @@ static ssize_t mouse_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen);
 static int     mouse_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
+static int     mouse_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map);
 static int     mouse_poll(FAR struct file *filep, FAR struct pollfd *fds,
                           bool setup);
 
@@ -85,7 +87,7 @@ static const struct file_operations g_mouse_fops =
   NULL,           /* write */
   NULL,           /* seek */
   mouse_ioctl,    /* ioctl */
-  NULL,           /* mmap */
+  mouse_mmap,     /* mmap */
   NULL,           /* truncate */
   mouse_poll      /* poll */
 };
@@ -119,8 +121,9 @@ static int mouse_open(FAR struct file *filep)
       return -ENOMEM;
     }
 
-  ret = circbuf_init(&openpriv->circbuf, NULL,
-                     upper->nums * sizeof(struct mouse_report_s));
+  ret = input_buffer_init(&openpriv->buffer,
+                          upper->nums * sizeof(struct mouse_report_s),
+                          sizeof(struct mouse_report_s), NULL);
   if (ret < 0)
     {
       kmm_free(openpriv);
@@ -170,7 +173,7 @@ static int mouse_close(FAR struct file *filep)
     }
 
   list_delete(&openpriv->node);
-  circbuf_uninit(&openpriv->circbuf);
+  input_buffer_uninit(&openpriv->buffer);
   nxsem_destroy(&openpriv->waitsem);
   nxmutex_destroy(&openpriv->lock);
   kmm_free(openpriv);
@@ -200,7 +203,7 @@ static ssize_t mouse_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
-  while (circbuf_is_empty(&openpriv->circbuf))
+  while (input_buffer_is_empty(&openpriv->buffer))
     {
       if (filep->f_oflags & O_NONBLOCK)
         {
@@ -224,7 +227,7 @@ static ssize_t mouse_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
-  ret = circbuf_read(&openpriv->circbuf, buffer, len);
+  ret = input_buffer_read(&openpriv->buffer, buffer, len);
 
 out:
   nxmutex_unlock(&openpriv->lock);
@@ -237,11 +240,26 @@ out:
 
 static int mouse_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
-  FAR struct inode             *inode = filep->f_inode;
-  FAR struct mouse_upperhalf_s *upper = inode->i_private;
-  FAR struct mouse_lowerhalf_s *lower = upper->lower;
+  FAR struct mouse_openpriv_s  *openpriv = filep->f_priv;
+  FAR struct inode             *inode    = filep->f_inode;
+  FAR struct mouse_upperhalf_s *upper    = inode->i_private;
+  FAR struct mouse_lowerhalf_s *lower    = upper->lower;
   int ret;
 
+  /* The event buffer belongs to this file alone */
+
+  if (_INPUTIOCVALID(cmd))
+    {
+      ret = nxmutex_lock(&openpriv->lock);
+      if (ret >= 0)
+        {
+          ret = input_buffer_ioctl(&openpriv->buffer, cmd, arg);
+          nxmutex_unlock(&openpriv->lock);
+        }
+
+      return ret;
+    }
+
   ret = nxmutex_lock(&upper->lock);
   if (ret < 0)
     {
@@ -261,6 +279,25 @@ static int mouse_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: mouse_mmap
+ ****************************************************************************/
+
+static int mouse_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
+{
+  FAR struct mouse_openpriv_s *openpriv = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&openpriv->lock);
+  if (ret >= 0)
+    {
+      ret = input_buffer_mmap(&openpriv->buffer, map);
+      nxmutex_unlock(&openpriv->lock);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: mouse_poll
  ****************************************************************************/
@@ -291,7 +328,7 @@ static int mouse_poll(FAR struct file *filep,
           goto errout;
         }
 
-      if (!circbuf_is_empty(&openpriv->circbuf))
+      if (!input_buffer_is_empty(&openpriv->buffer))
         {
           eventset |= POLLIN;
         }
@@ -330,8 +367,10 @@ void mouse_event(FAR void *priv, FAR const struct mouse_report_s *sample)
 
   list_for_every_entry(&upper->head, openpriv, struct mouse_openpriv_s, node)
     {
-      circbuf_overwrite(&openpriv->circbuf, sample,
-                        sizeof(struct mouse_report_s));
+      nxmutex_lock(&openpriv->lock);
+      input_buffer_write(&openpriv->buffer, sample,
+                         sizeof(struct mouse_report_s));
+      nxmutex_unlock(&openpriv->lock);
 
       nxsem_get_value(&openpriv->waitsem, &semcount);
       if (semcount < 1)
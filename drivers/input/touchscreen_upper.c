@@ -36,11 +36,11 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <nuttx/input/input_buffer.h>
 #include <nuttx/input/touchscreen.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/list.h>
-#include <nuttx/circbuf.h>
 
 /****************************************************************************
  * Private Types
@@ -48,11 +48,11 @@
 
 struct touch_openpriv_s
 {
-  struct circbuf_s   circbuf; /* Store touch point data in circle buffer */
-  struct list_node   node;    /* Opened file buffer linked list node */
-  FAR struct pollfd *fds;     /* Polling structure of waiting thread */
-  sem_t              waitsem; /* Used to wait for the availability of data */
-  mutex_t            lock;    /* Manages exclusive access to this structure */
+  struct input_buffer_s buffer;  /* Store touch samples in event buffer */
+  struct list_node      node;    /* Opened file buffer linked list node */
+  FAR struct pollfd    *fds;     /* Polling structure of waiting thread */
+  sem_t                 waitsem; /* Used to wait for the availability of data */
+  mutex_t               lock;    /* Manages exclusive access to this structure */
 };
 
 /* This structure is for touchscreen upper half driver */
@@ -78,6 +78,8 @@ static ssize_t touch_write(FAR struct file *filep, FAR const char *buffer,
                            size_t buflen);
 static int     touch_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg);
+static int     touch_mmap(FAR struct file *filep,
+                          FAR struct mm_map_entry_s *map);
 static int     touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
                           bool setup);
 
@@ -97,7 +99,7 @@ static const struct file_operations g_touch_fops =
   touch_write,    /* write */
   NULL,           /* seek */
   touch_ioctl,    /* ioctl */
-  NULL,           /* mmap */
+  touch_mmap,     /* mmap */
   NULL,           /* truncate */
   touch_poll      /* poll */
 };
@@ -106,6 +108,17 @@ static const struct file_operations g_touch_fops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: touch_evsize
+ ****************************************************************************/
+
+static size_t touch_evsize(FAR const void *event)
+{
+  FAR const struct touch_sample_s *sample = event;
+
+  return SIZEOF_TOUCH_SAMPLE_S(sample->npoints);
+}
+
 /****************************************************************************
  * Name: touch_open
  ****************************************************************************/
@@ -124,8 +137,9 @@ static int touch_open(FAR struct file *filep)
       return -ENOMEM;
     }
 
-  ret = circbuf_init(&openpriv->circbuf, NULL,
-                     upper->nums * SIZEOF_TOUCH_SAMPLE_S(lower->maxpoint));
+  ret = input_buffer_init(&openpriv->buffer, upper->nums *
+                          SIZEOF_TOUCH_SAMPLE_S(lower->maxpoint),
+                          sizeof(int), touch_evsize);
   if (ret < 0)
     {
       kmm_free(openpriv);
@@ -135,7 +149,7 @@ static int touch_open(FAR struct file *filep)
   ret = nxmutex_lock(&upper->lock);
   if (ret < 0)
     {
-      circbuf_uninit(&openpriv->circbuf);
+      input_buffer_uninit(&openpriv->buffer);
       kmm_free(openpriv);
       return ret;
     }
@@ -182,7 +196,7 @@ static int touch_close(FAR struct file *filep)
     }
 
   list_delete(&openpriv->node);
-  circbuf_uninit(&openpriv->circbuf);
+  input_buffer_uninit(&openpriv->buffer);
   nxsem_destroy(&openpriv->waitsem);
   nxmutex_destroy(&openpriv->lock);
   kmm_free(openpriv);
@@ -236,7 +250,7 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
-  while (circbuf_is_empty(&openpriv->circbuf))
+  while (input_buffer_is_empty(&openpriv->buffer))
     {
       if (filep->f_oflags & O_NONBLOCK)
         {
@@ -260,7 +274,7 @@ static ssize_t touch_read(FAR struct file *filep, FAR char *buffer,
         }
     }
 
-  ret = circbuf_read(&openpriv->circbuf, buffer, len);
+  ret = input_buffer_read(&openpriv->buffer, buffer, len);
 
 out:
   nxmutex_unlock(&openpriv->lock);
@@ -279,6 +293,20 @@ static int touch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   FAR struct touch_lowerhalf_s *lower    = upper->lower;
   int ret;
 
+  /* The event buffer belongs to this file alone */
+
+  if (_INPUTIOCVALID(cmd))
+    {
+      ret = nxmutex_lock(&openpriv->lock);
+      if (ret >= 0)
+        {
+          ret = input_buffer_ioctl(&openpriv->buffer, cmd, arg);
+          nxmutex_unlock(&openpriv->lock);
+        }
+
+      return ret;
+    }
+
   ret = nxmutex_lock(&upper->lock);
   if (ret < 0)
     {
@@ -333,6 +361,25 @@ static int touch_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: touch_mmap
+ ****************************************************************************/
+
+static int touch_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
+{
+  FAR struct touch_openpriv_s *openpriv = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&openpriv->lock);
+  if (ret >= 0)
+    {
+      ret = input_buffer_mmap(&openpriv->buffer, map);
+      nxmutex_unlock(&openpriv->lock);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: touch_poll
  ****************************************************************************/
@@ -363,7 +410,7 @@ static int touch_poll(FAR struct file *filep, FAR struct pollfd *fds,
           goto errout;
         }
 
-      if (!circbuf_is_empty(&openpriv->circbuf))
+      if (!input_buffer_is_empty(&openpriv->buffer))
         {
           eventset |= POLLIN;
         }
@@ -414,8 +461,8 @@ static void touch_event_notify(FAR struct touch_upperhalf_s *upper,
     }
 
   nxmutex_lock(&openpriv->lock);
-  circbuf_overwrite(&openpriv->circbuf, sample,
-                    SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
+  input_buffer_write(&openpriv->buffer, sample,
+                     SIZEOF_TOUCH_SAMPLE_S(sample->npoints));
 
   nxsem_get_value(&openpriv->waitsem, &n);
   if (n < 1)
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
@@ -35,7 +36,9 @@
 #include <nuttx/board.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/lcd/lcd.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/video/fb.h>
+#include <nuttx/wqueue.h>
 
 #ifdef CONFIG_LCD_FRAMEBUFFER
 
@@ -47,6 +50,16 @@
 
 #define VIDEO_PLANE 0
 
+/* The updates of a frame are written out by a work queue */
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+#  if defined(CONFIG_SCHED_LPWORK)
+#    define LCDFB_WORK LPWORK
+#  else
+#    define LCDFB_WORK HPWORK
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -65,6 +78,12 @@ struct lcdfb_dev_s
   fb_coord_t yres;                  /* Vertical resolution in pixel rows */
   fb_coord_t stride;                /* Width of a row in bytes */
   uint8_t display;                  /* Display number */
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+  spinlock_t lock;                  /* Protects damage and ndamage */
+  uint8_t ndamage;                  /* Number of damaged areas */
+  struct fb_area_s damage[CONFIG_LCD_FRAMEBUFFER_NDAMAGE];
+  struct work_s work;               /* Writes the damage to the LCD */
+#endif
 };
 
 /****************************************************************************
@@ -154,17 +173,17 @@ static FAR struct lcdfb_dev_s *lcdfb_find(int display)
 }
 
 /****************************************************************************
- * Name: lcdfb_updateearea
+ * Name: lcdfb_putarea
  *
  * Description:
- * Update the LCD when there is a change to the framebuffer.
+ *   Write an area of the framebuffer (all of it if area is NULL) to the
+ *   LCD.
  *
  ****************************************************************************/
 
-static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
-                             FAR const struct fb_area_s *area)
+static int lcdfb_putarea(FAR struct lcdfb_dev_s *priv,
+                         FAR const struct fb_area_s *area)
 {
-  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
   FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
   FAR uint8_t *run = priv->fbmem;
   fb_coord_t row;
@@ -257,12 +276,187 @@ static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
         }
     }
 
-  if (pinfo->redraw != NULL)
+  return OK;
+}
+
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+
+/****************************************************************************
+ * Name: lcdfb_union
+ *
+ * Description:
+ *   Grow a to the bounding box of a and b, and return its size in pixels.
+ *
+ ****************************************************************************/
+
+static uint32_t lcdfb_union(FAR struct fb_area_s *a,
+                            FAR const struct fb_area_s *b)
+{
+  fb_coord_t x2 = MAX(a->x + a->w, b->x + b->w);
+  fb_coord_t y2 = MAX(a->y + a->h, b->y + b->h);
+
+  a->x = MIN(a->x, b->x);
+  a->y = MIN(a->y, b->y);
+  a->w = x2 - a->x;
+  a->h = y2 - a->y;
+  return (uint32_t)a->w * a->h;
+}
+
+/****************************************************************************
+ * Name: lcdfb_damage
+ *
+ * Description:
+ *   Add an area to the damage of the next frame.  Two areas are merged
+ *   when their bounding box is no bigger than both together, i.e. when
+ *   writing them in one go costs no more pixels than one by one.  With all
+ *   slots in use, the area joins the one it grows the least.
+ *
+ ****************************************************************************/
+
+static void lcdfb_damage(FAR struct lcdfb_dev_s *priv,
+                         FAR const struct fb_area_s *area)
+{
+  struct fb_area_s rect = *area;
+  struct fb_area_s merged;
+  uint32_t growth;
+  uint32_t best = UINT32_MAX;
+  uint32_t size;
+  int ibest = 0;
+  int i;
+
+  for (i = 0; i < priv->ndamage; i++)
+    {
+      merged = priv->damage[i];
+      size = lcdfb_union(&merged, &rect);
+      if (size <= (uint32_t)rect.w * rect.h +
+                  (uint32_t)priv->damage[i].w * priv->damage[i].h)
+        {
+          /* The merged area may now catch areas already checked */
+
+          rect = merged;
+          priv->damage[i] = priv->damage[--priv->ndamage];
+          i = -1;
+        }
+    }
+
+  if (priv->ndamage < CONFIG_LCD_FRAMEBUFFER_NDAMAGE)
+    {
+      priv->damage[priv->ndamage++] = rect;
+      return;
+    }
+
+  for (i = 0; i < priv->ndamage; i++)
+    {
+      merged = priv->damage[i];
+      growth = lcdfb_union(&merged, &rect) -
+               (uint32_t)priv->damage[i].w * priv->damage[i].h;
+      if (growth < best)
+        {
+          best  = growth;
+          ibest = i;
+        }
+    }
+
+  lcdfb_union(&priv->damage[ibest], &rect);
+}
+
+/****************************************************************************
+ * Name: lcdfb_damage_worker
+ *
+ * Description:
+ *   Write the damage collected since the last frame to the LCD.
+ *
+ ****************************************************************************/
+
+static void lcdfb_damage_worker(FAR void *arg)
+{
+  FAR struct lcdfb_dev_s *priv = arg;
+  FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
+  struct fb_area_s damage[CONFIG_LCD_FRAMEBUFFER_NDAMAGE];
+  irqstate_t flags;
+  int ndamage;
+  int i;
+
+  flags = spin_lock_irqsave(&priv->lock);
+  ndamage = priv->ndamage;
+  memcpy(damage, priv->damage, ndamage * sizeof(struct fb_area_s));
+  priv->ndamage = 0;
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  for (i = 0; i < ndamage; i++)
+    {
+      lcdfb_putarea(priv, &damage[i]);
+    }
+
+  if (ndamage > 0 && pinfo->redraw != NULL)
     {
       pinfo->redraw(pinfo->dev);
     }
+}
+#endif /* CONFIG_LCD_FRAMEBUFFER_DAMAGE */
+
+/****************************************************************************
+ * Name: lcdfb_updateearea
+ *
+ * Description:
+ *   Update the LCD when there is a change to the framebuffer.  With
+ *   CONFIG_LCD_FRAMEBUFFER_DAMAGE the area is only recorded here, and the
+ *   areas of one frame period are merged and written out together.
+ *
+ ****************************************************************************/
+
+static int lcdfb_updateearea(FAR struct fb_vtable_s *vtable,
+                             FAR const struct fb_area_s *area)
+{
+  FAR struct lcdfb_dev_s *priv = (FAR struct lcdfb_dev_s *)vtable;
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+  struct fb_area_s rect;
+  irqstate_t flags;
+
+  if (area == NULL)
+    {
+      rect.x = 0;
+      rect.y = 0;
+      rect.w = priv->xres;
+      rect.h = priv->yres;
+    }
+  else
+    {
+      if (area->x >= priv->xres || area->y >= priv->yres ||
+          area->w == 0 || area->h == 0)
+        {
+          return OK;
+        }
+
+      rect.x = area->x;
+      rect.y = area->y;
+      rect.w = MIN(area->w, priv->xres - area->x);
+      rect.h = MIN(area->h, priv->yres - area->y);
+    }
+
+  flags = spin_lock_irqsave(&priv->lock);
+  lcdfb_damage(priv, &rect);
+  spin_unlock_irqrestore(&priv->lock, flags);
+
+  if (work_available(&priv->work))
+    {
+      return work_queue(LCDFB_WORK, &priv->work, lcdfb_damage_worker, priv,
+                        MSEC2TICK(CONFIG_LCD_FRAMEBUFFER_FRAMEMS));
+    }
 
   return OK;
+#else
+  FAR struct lcd_planeinfo_s *pinfo = &priv->pinfo;
+  int ret;
+
+  ret = lcdfb_putarea(priv, area);
+  if (ret >= 0 && pinfo->redraw != NULL)
+    {
+      pinfo->redraw(pinfo->dev);
+    }
+
+  return ret;
+#endif
 }
 
 /****************************************************************************
@@ -623,6 +817,9 @@ int up_fbinitialize(int display)
   /* Initialize the LCD-independent fields of the state structure */
 
   priv->display             = display;
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+  spin_lock_init(&priv->lock);
+#endif
 
   priv->vtable.getvideoinfo = lcdfb_getvideoinfo,
   priv->vtable.getplaneinfo = lcdfb_getplaneinfo,
@@ -719,11 +916,15 @@ int up_fbinitialize(int display)
   area.w = priv->xres;
   area.h = priv->yres;
 
-  ret = lcdfb_updateearea(&priv->vtable, &area);
+  ret = lcdfb_putarea(priv, &area);
   if (ret < 0)
     {
       lcderr("FB update failed: %d\n", ret);
     }
+  else if (priv->pinfo.redraw != NULL)
+    {
+      priv->pinfo.redraw(priv->pinfo.dev);
+    }
 
   /* Turn the LCD on at 75% power */
 
@@ -819,6 +1020,10 @@ void up_fbuninitialize(int display)
               g_lcdfb = priv->flink;
             }
 
+#ifdef CONFIG_LCD_FRAMEBUFFER_DAMAGE
+          work_cancel_sync(LCDFB_WORK, &priv->work);
+#endif
+
 #ifndef CONFIG_LCD_EXTERNINIT
           /* Uninitialize the LCD */
 
@@ -135,7 +135,10 @@ static void lcddrv_spiif_deselect(FAR struct lcddrv_lcd_s *lcd)
  * Name: lcddrv_spiif_sendmulti
  *
  * Description:
- *   Send a number of pixel words to the lcd driver gram.
+ *   Send a number of pixel words to the lcd driver gram.  With 4-wire SPI
+ *   the words go out as one block of 16 bit frames, so the controller sends
+ *   the high byte first and the DMA of the controller does the byte
+ *   swapping of little endian RGB565 pixels.
  *
  * Input Parameters:
  *   lcd    - Reference to the lcddrv_lcd_s driver structure
@@ -150,10 +153,10 @@ static void lcddrv_spiif_deselect(FAR struct lcddrv_lcd_s *lcd)
 static int lcddrv_spiif_sendmulti(FAR struct lcddrv_lcd_s *lcd,
                                   FAR const uint16_t *wd, uint32_t nwords)
 {
-  uint32_t t;
   FAR struct lcddrv_spiif_lcd_s *priv = (FAR struct lcddrv_spiif_lcd_s *)lcd;
-
 #ifdef CONFIG_LCD_LCDDRV_3WIRE
+  uint32_t t;
+
   SPI_SETBITS(priv->spi, 9);
   for (t = 0; t < nwords; t++)
     {
@@ -163,10 +166,7 @@ static int lcddrv_spiif_sendmulti(FAR struct lcddrv_lcd_s *lcd,
     }
 #else
   SPI_SETBITS(priv->spi, 16);
-  for (t = 0; t < nwords; t++)
-    {
-      SPI_SEND(priv->spi, *wd++);
-    }
+  SPI_SNDBLOCK(priv->spi, wd, nwords);
 #endif
 
   SPI_SETBITS(priv->spi, 8);
@@ -0,0 +1,280 @@
+/****************************************************************************
+ * drivers/lcd/spi_lcd.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/lcd/spi_lcd.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_lcd_callback
+ *
+ * Description:
+ *   A sequence of a batch is done, on the thread of the bus queue.  The
+ *   batch is free again after its last sequence.
+ *
+ ****************************************************************************/
+
+static void spi_lcd_callback(FAR struct spi_request_s *req, int result)
+{
+  FAR struct spi_lcd_batch_s *batch = req->priv;
+  FAR struct spi_lcd_s *lcd = batch->lcd;
+
+  if (result < 0 && lcd->result == OK)
+    {
+      lcd->result = result;
+    }
+
+  if (req == &batch->pixreq || batch->pixseq.ntrans == 0)
+    {
+      nxsem_post(&lcd->free);
+    }
+}
+
+/****************************************************************************
+ * Name: spi_lcd_take
+ *
+ * Description:
+ *   Return the batch being built, waiting for a free one if none is.
+ *
+ ****************************************************************************/
+
+static FAR struct spi_lcd_batch_s *spi_lcd_take(FAR struct spi_lcd_s *lcd)
+{
+  FAR struct spi_lcd_batch_s *batch = &lcd->batch[lcd->head];
+
+  if (!lcd->building)
+    {
+      nxsem_wait_uninterruptible(&lcd->free);
+
+      batch->cmdseq.ntrans = 0;
+      batch->pixseq.ntrans = 0;
+      batch->nparams       = 0;
+      lcd->building        = true;
+    }
+
+  return batch;
+}
+
+/****************************************************************************
+ * Name: spi_lcd_submit
+ *
+ * Description:
+ *   Queue the commands and then the pixels of the batch being built.
+ *
+ ****************************************************************************/
+
+static int spi_lcd_submit(FAR struct spi_lcd_s *lcd)
+{
+  FAR struct spi_lcd_batch_s *batch = &lcd->batch[lcd->head];
+  int ret = OK;
+
+  lcd->building = false;
+  lcd->head     = (lcd->head + 1) % SPI_LCD_NBATCH;
+
+  if (batch->cmdseq.ntrans == 0 && batch->pixseq.ntrans == 0)
+    {
+      nxsem_post(&lcd->free);
+      return OK;
+    }
+
+  if (batch->cmdseq.ntrans > 0)
+    {
+      ret = spi_transfer_async(lcd->bus, &batch->cmdreq);
+      if (ret < 0)
+        {
+          /* Do not send pixels to a window that was not set */
+
+          batch->pixseq.ntrans = 0;
+          spi_lcd_callback(&batch->cmdreq, ret);
+          return ret;
+        }
+    }
+
+  if (batch->pixseq.ntrans > 0)
+    {
+      ret = spi_transfer_async(lcd->bus, &batch->pixreq);
+      if (ret < 0)
+        {
+          spi_lcd_callback(&batch->pixreq, ret);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_lcd_initialize
+ ****************************************************************************/
+
+int spi_lcd_initialize(FAR struct spi_lcd_s *lcd, FAR struct spi_dev_s *spi,
+                       FAR const struct spi_sequence_s *config)
+{
+  int i;
+
+  DEBUGASSERT(config->nbits == 8 || config->nbits == 16);
+
+  memset(lcd, 0, sizeof(struct spi_lcd_s));
+
+  lcd->bus = spi_async_initialize(spi);
+  if (lcd->bus == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxsem_init(&lcd->free, 0, SPI_LCD_NBATCH);
+
+  for (i = 0; i < SPI_LCD_NBATCH; i++)
+    {
+      FAR struct spi_lcd_batch_s *batch = &lcd->batch[i];
+
+      batch->lcd             = lcd;
+      batch->cmdseq          = *config;
+      batch->cmdseq.nbits    = 8;
+      batch->cmdseq.trans    = batch->cmdtrans;
+      batch->cmdreq.seq      = &batch->cmdseq;
+      batch->cmdreq.callback = spi_lcd_callback;
+      batch->cmdreq.priv     = batch;
+      batch->pixseq          = *config;
+      batch->pixseq.trans    = &batch->pixtrans;
+      batch->pixreq.seq      = &batch->pixseq;
+      batch->pixreq.callback = spi_lcd_callback;
+      batch->pixreq.priv     = batch;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spi_lcd_command
+ ****************************************************************************/
+
+int spi_lcd_command(FAR struct spi_lcd_s *lcd, uint8_t cmd,
+                    FAR const uint8_t *params, size_t nparams)
+{
+  FAR struct spi_lcd_batch_s *batch;
+  FAR struct spi_trans_s *trans;
+  int ret;
+
+  if (nparams >= SPI_LCD_NPARAMS)
+    {
+      return -EINVAL;
+    }
+
+  batch = spi_lcd_take(lcd);
+  if (batch->cmdseq.ntrans + 2 > SPI_LCD_NTRANS ||
+      batch->nparams + 1 + nparams > SPI_LCD_NPARAMS)
+    {
+      ret = spi_lcd_submit(lcd);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      batch = spi_lcd_take(lcd);
+    }
+
+  trans = &batch->cmdtrans[batch->cmdseq.ntrans++];
+  memset(trans, 0, sizeof(struct spi_trans_s));
+  trans->cmd      = true;
+  trans->nwords   = 1;
+  trans->txbuffer = &batch->params[batch->nparams];
+  batch->params[batch->nparams++] = cmd;
+
+  if (nparams > 0)
+    {
+      trans = &batch->cmdtrans[batch->cmdseq.ntrans++];
+      memset(trans, 0, sizeof(struct spi_trans_s));
+      trans->nwords   = nparams;
+      trans->txbuffer = &batch->params[batch->nparams];
+      memcpy(&batch->params[batch->nparams], params, nparams);
+      batch->nparams += nparams;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spi_lcd_pixels
+ ****************************************************************************/
+
+int spi_lcd_pixels(FAR struct spi_lcd_s *lcd, FAR const void *buffer,
+                   size_t nbytes)
+{
+  FAR struct spi_lcd_batch_s *batch = spi_lcd_take(lcd);
+
+  memset(&batch->pixtrans, 0, sizeof(struct spi_trans_s));
+  batch->pixtrans.nwords   = nbytes / (batch->pixseq.nbits / 8);
+  batch->pixtrans.txbuffer = buffer;
+  batch->pixseq.ntrans     = 1;
+
+  return spi_lcd_submit(lcd);
+}
+
+/****************************************************************************
+ * Name: spi_lcd_wait
+ ****************************************************************************/
+
+int spi_lcd_wait(FAR struct spi_lcd_s *lcd)
+{
+  int ret;
+  int i;
+
+  if (lcd->bus == NULL)
+    {
+      return OK;
+    }
+
+  if (lcd->building)
+    {
+      spi_lcd_submit(lcd);
+    }
+
+  for (i = 0; i < SPI_LCD_NBATCH; i++)
+    {
+      nxsem_wait_uninterruptible(&lcd->free);
+    }
+
+  for (i = 0; i < SPI_LCD_NBATCH; i++)
+    {
+      nxsem_post(&lcd->free);
+    }
+
+  ret = lcd->result;
+  lcd->result = OK;
+  return ret;
+}
@@ -38,6 +38,7 @@
 #include <nuttx/spi/spi.h>
 #include <nuttx/lcd/lcd.h>
 #include <nuttx/lcd/st7789.h>
+#include <nuttx/lcd/spi_lcd.h>
 
 #include "st7789.h"
 
@@ -196,6 +197,12 @@ struct st7789_dev_s
    */
 
   uint16_t runbuffer[ST7789_LUT_SIZE];
+
+#ifdef CONFIG_LCD_ST7789_ASYNC
+  /* Queue of the area writes, any other access waits until it is empty */
+
+  struct spi_lcd_s queue;
+#endif
 };
 
   /* 3 wire interface for ST7789 requires the driver to send information
@@ -240,6 +247,11 @@ static void st7789_rdram(FAR struct st7789_dev_s *dev,
                          FAR uint16_t *buff, size_t size);
 #endif
 static void st7789_fill(FAR struct st7789_dev_s *dev, uint16_t color);
+#ifdef CONFIG_LCD_ST7789_ASYNC
+static int st7789_queuearea(FAR struct st7789_dev_s *dev,
+                            uint16_t x0, uint16_t y0,
+                            uint16_t x1, uint16_t y1);
+#endif
 
 /* LCD Data Transfer Methods */
 
@@ -301,6 +313,12 @@ static struct st7789_dev_s g_lcddev;
 
 static void st7789_select(FAR struct spi_dev_s *spi, int bits)
 {
+#ifdef CONFIG_LCD_ST7789_ASYNC
+  /* Let the queued area writes go out first */
+
+  spi_lcd_wait(&g_lcddev.queue);
+#endif
+
   /* Select ST7789 chip (locking the SPI bus in case there are multiple
    * devices competing for the SPI bus
    */
@@ -732,6 +750,58 @@ static void st7789_fill(FAR struct st7789_dev_s *dev, uint16_t color)
   st7789_deselect(dev->spi);
 }
 
+/****************************************************************************
+ * Name: st7789_queuearea
+ *
+ * Description:
+ *   Queue the commands that set the area of an upcoming write to RAM.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_LCD_ST7789_ASYNC
+static int st7789_queuearea(FAR struct st7789_dev_s *dev,
+                            uint16_t x0, uint16_t y0,
+                            uint16_t x1, uint16_t y1)
+{
+  uint8_t param[4];
+  int ret;
+
+#ifdef CONFIG_LCD_DYN_ORIENTATION
+  x0 += dev->xoff;
+  x1 += dev->xoff;
+  y0 += dev->yoff;
+  y1 += dev->yoff;
+#else
+  x0 += ST7789_XOFFSET;
+  x1 += ST7789_XOFFSET;
+  y0 += ST7789_YOFFSET;
+  y1 += ST7789_YOFFSET;
+#endif
+
+  param[0] = y0 >> 8;
+  param[1] = y0 & 0xff;
+  param[2] = y1 >> 8;
+  param[3] = y1 & 0xff;
+  ret = spi_lcd_command(&dev->queue, ST7789_RASET, param, sizeof(param));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  param[0] = x0 >> 8;
+  param[1] = x0 & 0xff;
+  param[2] = x1 >> 8;
+  param[3] = x1 & 0xff;
+  ret = spi_lcd_command(&dev->queue, ST7789_CASET, param, sizeof(param));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return spi_lcd_command(&dev->queue, ST7789_RAMWR, NULL, 0);
+}
+#endif
+
 /****************************************************************************
  * Name:  st7789_putrun
  *
@@ -752,14 +822,27 @@ static int st7789_putrun(FAR struct lcd_dev_s *dev,
                          FAR const uint8_t *buffer, size_t npixels)
 {
   FAR struct st7789_dev_s *priv = (FAR struct st7789_dev_s *)dev;
+#ifdef CONFIG_LCD_ST7789_ASYNC
+  int ret;
+#endif
 
   ginfo("row: %d col: %d npixels: %d\n", row, col, npixels);
   DEBUGASSERT(buffer && ((uintptr_t)buffer & 1) == 0);
 
+#ifdef CONFIG_LCD_ST7789_ASYNC
+  ret = st7789_queuearea(priv, col, row, col + npixels - 1, row);
+  if (ret >= 0)
+    {
+      ret = spi_lcd_pixels(&priv->queue, buffer, npixels * ST7789_BYTESPP);
+    }
+
+  return ret;
+#else
   st7789_setarea(priv, col, row, col + npixels - 1, row);
   st7789_wrram(priv, buffer, npixels * ST7789_BYTESPP, 0, 1);
 
   return OK;
+#endif
 }
 
 /****************************************************************************
@@ -791,12 +874,37 @@ static int st7789_putarea(FAR struct lcd_dev_s *dev,
   size_t cols = col_end - col_start + 1;
   size_t rows = row_end - row_start + 1;
   size_t row_size = cols * ST7789_BYTESPP;
+#ifdef CONFIG_LCD_ST7789_ASYNC
+  int ret;
+#endif
 
   ginfo("row_start: %d row_end: %d col_start: %d col_end: %d\n",
          row_start, row_end, col_start, col_end);
 
   DEBUGASSERT(buffer && ((uintptr_t)buffer & 1) == 0);
 
+#ifdef CONFIG_LCD_ST7789_ASYNC
+  ret = st7789_queuearea(priv, col_start, row_start, col_end, row_end);
+  if (stride == row_size)
+    {
+      if (ret >= 0)
+        {
+          ret = spi_lcd_pixels(&priv->queue, buffer, rows * row_size);
+        }
+    }
+  else
+    {
+      size_t i;
+
+      for (i = 0; ret >= 0 && i < rows; i++)
+        {
+          ret = spi_lcd_pixels(&priv->queue, buffer + i * stride,
+                               row_size);
+        }
+    }
+
+  return ret;
+#else
   st7789_setarea(priv, col_start, row_start, col_end, row_end);
 
   /* If the stride is the same of the row, a single SPI transfer is enough.
@@ -820,6 +928,7 @@ static int st7789_putarea(FAR struct lcd_dev_s *dev,
     }
 
   return OK;
+#endif
 }
 
 /****************************************************************************
@@ -1011,6 +1120,9 @@ FAR struct lcd_dev_s *st7789_lcdinitialize(FAR struct spi_dev_s *spi)
 #endif
 {
   FAR struct st7789_dev_s *priv = &g_lcddev;
+#ifdef CONFIG_LCD_ST7789_ASYNC
+  struct spi_sequence_s config;
+#endif
 
   /* Initialize the driver data structure */
 
@@ -1042,6 +1154,28 @@ FAR struct lcd_dev_s *st7789_lcdinitialize(FAR struct spi_dev_s *spi)
   st7789_display(priv, true);
   st7789_fill(priv, CONFIG_LCD_ST7789_DEFAULT_COLOR);
 
+#ifdef CONFIG_LCD_ST7789_ASYNC
+  /* The rest goes through the queue */
+
+  memset(&config, 0, sizeof(config));
+  config.dev       = SPIDEV_DISPLAY(0);
+  config.mode      = CONFIG_LCD_ST7789_SPIMODE;
+  config.nbits     = ST7789_BYTESPP * 8;
+  config.frequency = CONFIG_LCD_ST7789_FREQUENCY;
+#  ifdef CONFIG_SPI_DELAY_CONTROL
+  config.a         = CONFIG_LCD_ST7789_START_DELAY;
+  config.b         = CONFIG_LCD_ST7789_STOP_DELAY;
+  config.c         = CONFIG_LCD_ST7789_CS_DELAY;
+  config.i         = CONFIG_LCD_ST7789_IFDELAY;
+#  endif
+
+  if (spi_lcd_initialize(&priv->queue, spi, &config) < 0)
+    {
+      lcderr("ERROR: Failed to create the SPI queue\n");
+      return NULL;
+    }
+#endif
+
   return &priv->dev;
 }
 
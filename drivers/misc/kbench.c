@@ -0,0 +1,461 @@
+/****************************************************************************
+ * drivers/misc/kbench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/kthread.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/drivers/drivers.h>
+
+#include "kbench.h"
+
+#ifdef CONFIG_DEV_KBENCH
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct kbench_entry_s
+{
+  FAR const char *name;
+  kbench_run_t    run;
+};
+
+/* The results of one open of /dev/kbench */
+
+struct kbench_file_s
+{
+  bool   done;                            /* The results are in buf */
+  char   buf[CONFIG_DEV_KBENCH_BUFSIZE];
+  size_t len;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     kbench_open(FAR struct file *filep);
+static int     kbench_close(FAR struct file *filep);
+static ssize_t kbench_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen);
+static ssize_t kbench_write(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct kbench_entry_s g_kbench[] =
+{
+  { "yield",    kbench_yield   },
+  { "sem",      kbench_sem     },
+  { "semwake",  kbench_semwake },
+#ifndef CONFIG_DISABLE_MQUEUE
+  { "mq",       kbench_mq      },
+#endif
+  { "wdog",     kbench_wdog    },
+  { "heap",     kbench_heap    },
+  { "mempool",  kbench_mempool },
+#ifdef CONFIG_MM_IOB
+  { "iob",      kbench_iob     },
+#endif
+#ifdef KBENCH_PIPE
+  { "pipe",     kbench_pipe    },
+#endif
+#ifdef CONFIG_NET_LOCAL_STREAM
+  { "local",    kbench_local   },
+#endif
+#ifdef KBENCH_TCP
+  { "tcp",      kbench_tcp     },
+#endif
+#ifdef KBENCH_UDP
+  { "udp",      kbench_udp     },
+#endif
+#ifdef KBENCH_FS
+  { "fs",       kbench_fs      },
+#endif
+};
+
+/* Only one run at a time, the benchmarks share their helper state */
+
+static mutex_t g_kbench_lock = NXMUTEX_INITIALIZER;
+
+/* What the next open runs, selected by the last write */
+
+static FAR const struct kbench_entry_s *g_kbench_entry; /* NULL for all */
+static size_t g_kbench_count;
+static char g_kbench_args[CONFIG_DEV_KBENCH_ARGSIZE];
+
+static const struct file_operations g_kbench_fops =
+{
+  kbench_open,   /* open */
+  kbench_close,  /* close */
+  kbench_read,   /* read */
+  kbench_write,  /* write */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_run
+ *
+ * Description:
+ *   Run the selected benchmarks with the caller pinned to its current CPU,
+ *   so that the helper threads run on the same CPU.
+ *
+ ****************************************************************************/
+
+static void kbench_run(FAR struct kbench_file_s *priv)
+{
+  struct kbench_s kb;
+#ifdef CONFIG_SMP
+  cpu_set_t saved;
+  cpu_set_t cpuset;
+#endif
+  size_t i;
+  int ret;
+
+  kb.buf   = priv->buf;
+  kb.size  = sizeof(priv->buf);
+  kb.len   = snprintf(kb.buf, kb.size,
+                      "# name param count total_ns ns_per_op "
+                      "[p50_ns p99_ns p999_ns]\n");
+
+  nxmutex_lock(&g_kbench_lock);
+  kb.count = g_kbench_count;
+  kb.args  = g_kbench_args;
+
+#ifdef CONFIG_SMP
+  nxsched_get_affinity(0, sizeof(cpu_set_t), &saved);
+  CPU_ZERO(&cpuset);
+  CPU_SET(up_cpu_index(), &cpuset);
+  nxsched_set_affinity(0, sizeof(cpu_set_t), &cpuset);
+#endif
+
+  for (i = 0; i < nitems(g_kbench); i++)
+    {
+      if (g_kbench_entry != NULL && g_kbench_entry != &g_kbench[i])
+        {
+          continue;
+        }
+
+      ret = g_kbench[i].run(&kb);
+      if (ret < 0 && kb.len < kb.size)
+        {
+          ret = snprintf(kb.buf + kb.len, kb.size - kb.len,
+                         "# %s failed: %d\n", g_kbench[i].name, ret);
+          if (ret > 0 && ret < kb.size - kb.len)
+            {
+              kb.len += ret;
+            }
+        }
+    }
+
+#ifdef CONFIG_SMP
+  nxsched_set_affinity(0, sizeof(cpu_set_t), &saved);
+#endif
+
+  nxmutex_unlock(&g_kbench_lock);
+
+  priv->len  = kb.len;
+  priv->done = true;
+}
+
+/****************************************************************************
+ * Name: kbench_open
+ ****************************************************************************/
+
+static int kbench_open(FAR struct file *filep)
+{
+  FAR struct kbench_file_s *priv;
+
+  priv = kmm_zalloc(sizeof(struct kbench_file_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_close
+ ****************************************************************************/
+
+static int kbench_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_read
+ *
+ * Description:
+ *   The first read runs the benchmarks, the results are then read as
+ *   lines of "name param count total_ns ns_per_op".
+ *
+ ****************************************************************************/
+
+static ssize_t kbench_read(FAR struct file *filep, FAR char *buffer,
+                           size_t buflen)
+{
+  FAR struct kbench_file_s *priv = filep->f_priv;
+
+  if (!priv->done)
+    {
+      kbench_run(priv);
+    }
+
+  if (filep->f_pos >= priv->len)
+    {
+      return 0;
+    }
+
+  if (buflen > priv->len - filep->f_pos)
+    {
+      buflen = priv->len - filep->f_pos;
+    }
+
+  memcpy(buffer, priv->buf + filep->f_pos, buflen);
+  filep->f_pos += buflen;
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: kbench_write
+ *
+ * Description:
+ *   Select what the reads of /dev/kbench run from now on: "all" or the
+ *   name of one benchmark, optionally followed by the number of
+ *   iterations and the arguments of the benchmark.
+ *
+ ****************************************************************************/
+
+static ssize_t kbench_write(FAR struct file *filep, FAR const char *buffer,
+                            size_t buflen)
+{
+  FAR const struct kbench_entry_s *entry = NULL;
+  char line[32 + CONFIG_DEV_KBENCH_ARGSIZE];
+  FAR char *count;
+  FAR char *args;
+  size_t len;
+  size_t i;
+
+  len = MIN(buflen, sizeof(line) - 1);
+  memcpy(line, buffer, len);
+  line[len] = '\0';
+  line[strcspn(line, "\n")] = '\0';
+
+  count = strpbrk(line, " \t");
+  if (count != NULL)
+    {
+      *count++ = '\0';
+    }
+
+  if (strcmp(line, "all") != 0)
+    {
+      for (i = 0; i < nitems(g_kbench); i++)
+        {
+          if (strcmp(line, g_kbench[i].name) == 0)
+            {
+              entry = &g_kbench[i];
+              break;
+            }
+        }
+
+      if (entry == NULL)
+        {
+          return -ENOENT;
+        }
+    }
+
+  nxmutex_lock(&g_kbench_lock);
+  g_kbench_entry = entry;
+  g_kbench_count = count != NULL ? strtoul(count, &args, 0) : 0;
+  strlcpy(g_kbench_args, count != NULL ? args + strspn(args, " \t") : "",
+          sizeof(g_kbench_args));
+  nxmutex_unlock(&g_kbench_lock);
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_report
+ ****************************************************************************/
+
+void kbench_report(FAR struct kbench_s *kb, FAR const char *name,
+                   size_t param, size_t count, clock_t elapsed)
+{
+  struct timespec ts;
+  uint64_t ns;
+  int ret;
+
+  if (kb->len >= kb->size)
+    {
+      return;
+    }
+
+  up_perf_convert(elapsed, &ts);
+  ns = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+
+  ret = snprintf(kb->buf + kb->len, kb->size - kb->len,
+                 "%s %zu %zu %" PRIu64 " %" PRIu64 "\n", name, param,
+                 count, ns, count > 0 ? ns / count : 0);
+  if (ret > 0 && ret < kb->size - kb->len)
+    {
+      kb->len += ret;
+    }
+}
+
+/****************************************************************************
+ * Name: kbench_compare
+ ****************************************************************************/
+
+static int kbench_compare(FAR const void *a, FAR const void *b)
+{
+  clock_t x = *(FAR const clock_t *)a;
+  clock_t y = *(FAR const clock_t *)b;
+
+  return x < y ? -1 : x > y;
+}
+
+/****************************************************************************
+ * Name: kbench_report_latency
+ ****************************************************************************/
+
+void kbench_report_latency(FAR struct kbench_s *kb, FAR const char *name,
+                           size_t param, FAR clock_t *samples,
+                           size_t count, clock_t elapsed)
+{
+  static const uint16_t permille[] =
+  {
+    500, 990, 999
+  };
+
+  struct timespec ts;
+  uint64_t pct[nitems(permille)];
+  uint64_t ns;
+  int ret;
+  int i;
+
+  if (kb->len >= kb->size || count == 0)
+    {
+      return;
+    }
+
+  qsort(samples, count, sizeof(clock_t), kbench_compare);
+
+  for (i = 0; i < nitems(permille); i++)
+    {
+      up_perf_convert(samples[count * permille[i] / 1000], &ts);
+      pct[i] = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+    }
+
+  up_perf_convert(elapsed, &ts);
+  ns = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+
+  ret = snprintf(kb->buf + kb->len, kb->size - kb->len,
+                 "%s %zu %zu %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64
+                 " %" PRIu64 "\n", name, param, count, ns, ns / count,
+                 pct[0], pct[1], pct[2]);
+  if (ret > 0 && ret < kb->size - kb->len)
+    {
+      kb->len += ret;
+    }
+}
+
+/****************************************************************************
+ * Name: kbench_count
+ ****************************************************************************/
+
+size_t kbench_count(FAR struct kbench_s *kb, size_t dflt)
+{
+  return kb->count > 0 ? kb->count : dflt;
+}
+
+/****************************************************************************
+ * Name: kbench_spawn
+ ****************************************************************************/
+
+int kbench_spawn(FAR const char *name, int prio, main_t entry)
+{
+  struct sched_param param;
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+#endif
+  int pid;
+
+  nxsched_get_param(0, &param);
+  prio += param.sched_priority;
+  prio  = MAX(SCHED_PRIORITY_MIN, MIN(prio, SCHED_PRIORITY_MAX));
+
+  pid = kthread_create(name, prio, CONFIG_DEV_KBENCH_STACKSIZE, entry,
+                       NULL);
+#ifdef CONFIG_SMP
+  if (pid > 0 && nxsched_get_affinity(0, sizeof(cpu_set_t), &cpuset) >= 0)
+    {
+      nxsched_set_affinity(pid, sizeof(cpu_set_t), &cpuset);
+    }
+#endif
+
+  return pid;
+}
+
+/****************************************************************************
+ * Name: devkbench_register
+ *
+ * Description:
+ *   Register /dev/kbench
+ *
+ ****************************************************************************/
+
+void devkbench_register(void)
+{
+  register_driver("/dev/kbench", &g_kbench_fops, 0666, NULL);
+}
+
+#endif /* CONFIG_DEV_KBENCH */
@@ -0,0 +1,178 @@
+/****************************************************************************
+ * drivers/misc/kbench.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __DRIVERS_MISC_KBENCH_H
+#define __DRIVERS_MISC_KBENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+
+#ifdef CONFIG_DEV_KBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The allocation benchmarks hold this many blocks at a time */
+
+#define KBENCH_BATCH 32
+
+/* The benchmarks that the configuration supports */
+
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+#  define KBENCH_PIPE
+#endif
+
+#if defined(CONFIG_NET_LOOPBACK) && defined(CONFIG_NET_IPv4)
+#  if defined(CONFIG_NET_TCP) && defined(CONFIG_NET_TCPBACKLOG)
+#    define KBENCH_TCP
+#  endif
+#  ifdef CONFIG_NET_UDP
+#    define KBENCH_UDP
+#  endif
+#endif
+
+#if defined(KBENCH_PIPE) || defined(CONFIG_NET_LOCAL_STREAM) || \
+    defined(KBENCH_TCP)
+#  define KBENCH_STREAM
+#endif
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+#  define KBENCH_FS
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One run of the benchmarks, the results are appended to buf */
+
+struct kbench_s
+{
+  FAR char       *buf;   /* The results */
+  size_t          size;  /* Size of buf */
+  size_t          len;   /* Length of the results in buf */
+  size_t          count; /* Iterations asked for, zero for the default */
+  FAR const char *args;  /* Arguments of the benchmark, never NULL */
+};
+
+/* Run one benchmark and report each of its results with kbench_report() */
+
+typedef CODE int (*kbench_run_t)(FAR struct kbench_s *kb);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_report
+ *
+ * Description:
+ *   Append one result, count operations of the benchmark name with the
+ *   parameter param took elapsed up_perf_gettime() ticks.
+ *
+ ****************************************************************************/
+
+void kbench_report(FAR struct kbench_s *kb, FAR const char *name,
+                   size_t param, size_t count, clock_t elapsed);
+
+/****************************************************************************
+ * Name: kbench_count
+ *
+ * Description:
+ *   The number of iterations to run, dflt unless the run asks for another.
+ *
+ ****************************************************************************/
+
+size_t kbench_count(FAR struct kbench_s *kb, size_t dflt);
+
+/****************************************************************************
+ * Name: kbench_report_latency
+ *
+ * Description:
+ *   As kbench_report(), followed by the 50th, 99th and 99.9th percentile
+ *   of the count latencies in samples, in the same ticks.  The samples are
+ *   sorted.
+ *
+ ****************************************************************************/
+
+void kbench_report_latency(FAR struct kbench_s *kb, FAR const char *name,
+                           size_t param, FAR clock_t *samples,
+                           size_t count, clock_t elapsed);
+
+/****************************************************************************
+ * Name: kbench_spawn
+ *
+ * Description:
+ *   Start the helper thread of a benchmark, on the CPUs that the caller
+ *   may run on.  prio is added to the priority of the caller.
+ *
+ * Returned Value:
+ *   The pid of the thread or a negated errno value.
+ *
+ ****************************************************************************/
+
+int kbench_spawn(FAR const char *name, int prio, main_t entry);
+
+/* The benchmarks */
+
+int kbench_yield(FAR struct kbench_s *kb);
+int kbench_sem(FAR struct kbench_s *kb);
+int kbench_semwake(FAR struct kbench_s *kb);
+#ifndef CONFIG_DISABLE_MQUEUE
+int kbench_mq(FAR struct kbench_s *kb);
+#endif
+int kbench_wdog(FAR struct kbench_s *kb);
+
+int kbench_heap(FAR struct kbench_s *kb);
+int kbench_mempool(FAR struct kbench_s *kb);
+#ifdef CONFIG_MM_IOB
+int kbench_iob(FAR struct kbench_s *kb);
+#endif
+
+#ifdef KBENCH_PIPE
+int kbench_pipe(FAR struct kbench_s *kb);
+#endif
+#ifdef CONFIG_NET_LOCAL_STREAM
+int kbench_local(FAR struct kbench_s *kb);
+#endif
+#ifdef KBENCH_TCP
+int kbench_tcp(FAR struct kbench_s *kb);
+#endif
+#ifdef KBENCH_UDP
+int kbench_udp(FAR struct kbench_s *kb);
+#endif
+
+#ifdef KBENCH_FS
+int kbench_fs(FAR struct kbench_s *kb);
+#endif
+
+#endif /* CONFIG_DEV_KBENCH */
+#endif /* __DRIVERS_MISC_KBENCH_H */
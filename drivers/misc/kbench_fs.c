@@ -0,0 +1,501 @@
+/****************************************************************************
+ * drivers/misc/kbench_fs.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+
+#include "kbench.h"
+
+#if defined(CONFIG_DEV_KBENCH) && defined(KBENCH_FS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define KBENCH_FS_BLKSIZE  4096
+#define KBENCH_FS_FSYNCS   64   /* At most, they are slow on flash */
+#define KBENCH_FS_MOUNTS   10
+#define KBENCH_FS_NAMELEN  64
+
+/* Flags of kbench_fs_io() */
+
+#define KBENCH_FS_WRITE    (1 << 0)
+#define KBENCH_FS_RANDOM   (1 << 1)
+#define KBENCH_FS_FSYNC    (1 << 2)   /* file_fsync() after each block */
+#define KBENCH_FS_SYNCEND  (1 << 3)   /* file_fsync() once at the end */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct kbench_fs_s
+{
+  FAR struct kbench_s *kb;
+  FAR clock_t *samples;       /* Latency of each operation */
+  FAR uint8_t *buf;           /* One block */
+  struct file file;           /* The file or device under test */
+  size_t count;               /* Blocks per pass */
+  size_t nblocks;             /* Blocks in the file or device */
+  uint32_t seed;              /* Of the random offsets */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_fs_random
+ ****************************************************************************/
+
+static uint32_t kbench_fs_random(FAR struct kbench_fs_s *fs)
+{
+  fs->seed ^= fs->seed << 13;
+  fs->seed ^= fs->seed >> 17;
+  fs->seed ^= fs->seed << 5;
+  return fs->seed;
+}
+
+/****************************************************************************
+ * Name: kbench_fs_io
+ *
+ * Description:
+ *   Read or write count blocks in order from the start or at random block
+ *   offsets, the latency of each block and the total.
+ *
+ ****************************************************************************/
+
+static int kbench_fs_io(FAR struct kbench_fs_s *fs, FAR const char *name,
+                        size_t count, int flags)
+{
+  clock_t elapsed = 0;
+  clock_t start;
+  off_t offset;
+  ssize_t nbytes;
+  size_t i;
+  int ret;
+
+  offset = file_seek(&fs->file, 0, SEEK_SET);
+  if (offset < 0)
+    {
+      return offset;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      if (flags & KBENCH_FS_RANDOM)
+        {
+          offset = (off_t)(kbench_fs_random(fs) % fs->nblocks) *
+                   KBENCH_FS_BLKSIZE;
+          offset = file_seek(&fs->file, offset, SEEK_SET);
+          if (offset < 0)
+            {
+              return offset;
+            }
+        }
+
+      start = up_perf_gettime();
+      if (flags & KBENCH_FS_WRITE)
+        {
+          nbytes = file_write(&fs->file, fs->buf, KBENCH_FS_BLKSIZE);
+        }
+      else
+        {
+          nbytes = file_read(&fs->file, fs->buf, KBENCH_FS_BLKSIZE);
+        }
+
+      if (nbytes >= 0 && (flags & KBENCH_FS_FSYNC))
+        {
+          ret = file_fsync(&fs->file);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      fs->samples[i] = up_perf_gettime() - start;
+      elapsed += fs->samples[i];
+
+      if (nbytes != KBENCH_FS_BLKSIZE)
+        {
+          return nbytes < 0 ? nbytes : -EIO;
+        }
+    }
+
+  /* What a sequential write costs includes getting it to the media */
+
+  if (flags & KBENCH_FS_SYNCEND)
+    {
+      start = up_perf_gettime();
+      ret = file_fsync(&fs->file);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      elapsed += up_perf_gettime() - start;
+    }
+
+  kbench_report_latency(fs->kb, name, KBENCH_FS_BLKSIZE, fs->samples,
+                        count, elapsed);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_fs_data
+ *
+ * Description:
+ *   The data tests on <dir>/kbench.dat, which is written first so that the
+ *   reads find count blocks.
+ *
+ ****************************************************************************/
+
+static int kbench_fs_data(FAR struct kbench_fs_s *fs, FAR const char *dir)
+{
+  char path[KBENCH_FS_NAMELEN];
+  int ret;
+
+  snprintf(path, sizeof(path), "%s/kbench.dat", dir);
+  ret = file_open(&fs->file, path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  fs->nblocks = fs->count;
+
+  ret = kbench_fs_io(fs, "fs_seqwrite", fs->count,
+                     KBENCH_FS_WRITE | KBENCH_FS_SYNCEND);
+  if (ret >= 0)
+    {
+      ret = kbench_fs_io(fs, "fs_fsync", MIN(fs->count, KBENCH_FS_FSYNCS),
+                         KBENCH_FS_WRITE | KBENCH_FS_RANDOM |
+                         KBENCH_FS_FSYNC);
+    }
+
+  if (ret >= 0)
+    {
+      ret = kbench_fs_io(fs, "fs_seqread", fs->count, 0);
+    }
+
+  if (ret >= 0)
+    {
+      ret = kbench_fs_io(fs, "fs_randread", fs->count, KBENCH_FS_RANDOM);
+    }
+
+  if (ret >= 0)
+    {
+      ret = kbench_fs_io(fs, "fs_randwrite", fs->count,
+                         KBENCH_FS_WRITE | KBENCH_FS_RANDOM |
+                         KBENCH_FS_SYNCEND);
+    }
+
+  file_close(&fs->file);
+  nx_unlink(path);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kbench_fs_meta
+ *
+ * Description:
+ *   Create count empty files in dir, stat them and unlink them, the latency
+ *   of each.
+ *
+ ****************************************************************************/
+
+static int kbench_fs_meta(FAR struct kbench_fs_s *fs, FAR const char *dir)
+{
+  static FAR const char * const names[] =
+  {
+    "fs_create", "fs_stat", "fs_unlink"
+  };
+
+  char path[KBENCH_FS_NAMELEN];
+  struct file file;
+  struct stat st;
+  clock_t elapsed;
+  clock_t start;
+  size_t created;
+  size_t i;
+  int ret = OK;
+  int op;
+
+  for (created = 0; created < fs->count; created++)
+    {
+      snprintf(path, sizeof(path), "%s/kbench%zu", dir, created);
+      start = up_perf_gettime();
+      ret = file_open(&file, path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+      if (ret >= 0)
+        {
+          ret = file_close(&file);
+        }
+
+      fs->samples[created] = up_perf_gettime() - start;
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  for (op = 0; op < nitems(names); op++)
+    {
+      elapsed = 0;
+      for (i = 0; op > 0 && ret >= 0 && i < created; i++)
+        {
+          snprintf(path, sizeof(path), "%s/kbench%zu", dir, i);
+          start = up_perf_gettime();
+          ret = op == 1 ? nx_stat(path, &st, 1) : nx_unlink(path);
+          fs->samples[i] = up_perf_gettime() - start;
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      for (i = 0; i < created; i++)
+        {
+          elapsed += fs->samples[i];
+        }
+
+      kbench_report_latency(fs->kb, names[op], 0, fs->samples, created,
+                            elapsed);
+    }
+
+  /* Do not leave files behind after a failure */
+
+  if (op < 2)
+    {
+      for (i = 0; i < created; i++)
+        {
+          snprintf(path, sizeof(path), "%s/kbench%zu", dir, i);
+          nx_unlink(path);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: kbench_fs_mount
+ *
+ * Description:
+ *   Unmount dir and mount source of fstype on it again, the latency of the
+ *   mounts.
+ *
+ ****************************************************************************/
+
+static int kbench_fs_mount(FAR struct kbench_fs_s *fs, FAR const char *dir,
+                           FAR const char *source, FAR const char *fstype)
+{
+  clock_t elapsed = 0;
+  clock_t start;
+  size_t i;
+  int ret;
+
+  for (i = 0; i < KBENCH_FS_MOUNTS; i++)
+    {
+      ret = nx_umount2(dir, 0);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      start = up_perf_gettime();
+      ret = nx_mount(source, dir, fstype, 0, NULL);
+      fs->samples[i] = up_perf_gettime() - start;
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      elapsed += fs->samples[i];
+    }
+
+  kbench_report_latency(fs->kb, "fs_mount", 0, fs->samples,
+                        KBENCH_FS_MOUNTS, elapsed);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_fs_raw
+ *
+ * Description:
+ *   The data tests on a block or MTD device, within its first count blocks.
+ *   The writes destroy what is on the device and only run if asked for.
+ *
+ ****************************************************************************/
+
+static int kbench_fs_raw(FAR struct kbench_fs_s *fs, FAR const char *dev,
+                         bool rw)
+{
+  struct stat st;
+  int ret;
+
+  ret = file_open(&fs->file, dev, rw ? O_RDWR : O_RDONLY);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_fstat(&fs->file, &st);
+  if (ret >= 0 && st.st_size > 0)
+    {
+      fs->count = MIN(fs->count, st.st_size / KBENCH_FS_BLKSIZE);
+    }
+
+  fs->nblocks = fs->count;
+  if (ret >= 0 && fs->count == 0)
+    {
+      ret = -EINVAL;
+    }
+
+  if (ret >= 0)
+    {
+      ret = kbench_fs_io(fs, "raw_seqread", fs->count, 0);
+    }
+
+  if (ret >= 0)
+    {
+      ret = kbench_fs_io(fs, "raw_randread", fs->count, KBENCH_FS_RANDOM);
+    }
+
+  if (ret >= 0 && rw)
+    {
+      ret = kbench_fs_io(fs, "raw_seqwrite", fs->count,
+                         KBENCH_FS_WRITE | KBENCH_FS_SYNCEND);
+    }
+
+  if (ret >= 0 && rw)
+    {
+      ret = kbench_fs_io(fs, "raw_randwrite", fs->count,
+                         KBENCH_FS_WRITE | KBENCH_FS_RANDOM |
+                         KBENCH_FS_SYNCEND);
+    }
+
+  file_close(&fs->file);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_fs
+ *
+ * Description:
+ *   The arguments are "<dir> [<source> <fstype>]" for a mounted file
+ *   system, the mount time is measured if source and fstype are given, or
+ *   "<device> [rw]" for a block or MTD device.  Nothing is run without
+ *   them, so that "all" does not need them.
+ *
+ ****************************************************************************/
+
+int kbench_fs(FAR struct kbench_s *kb)
+{
+  struct kbench_fs_s fs;
+  char args[CONFIG_DEV_KBENCH_ARGSIZE];
+  FAR char *argv[3];
+  FAR char *save;
+  struct stat st;
+  int argc;
+  int ret;
+
+  strlcpy(args, kb->args, sizeof(args));
+  for (argc = 0; argc < nitems(argv); argc++)
+    {
+      argv[argc] = strtok_r(argc == 0 ? args : NULL, " \t", &save);
+      if (argv[argc] == NULL)
+        {
+          break;
+        }
+    }
+
+  if (argc == 0)
+    {
+      return OK;
+    }
+
+  ret = nx_stat(argv[0], &st, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(&fs, 0, sizeof(fs));
+  fs.kb    = kb;
+  fs.count = kbench_count(kb, 256);
+  fs.seed  = 2463534242u;
+
+  fs.samples = kmm_malloc(MAX(fs.count, KBENCH_FS_MOUNTS) *
+                          sizeof(clock_t));
+  fs.buf     = kmm_malloc(KBENCH_FS_BLKSIZE);
+  if (fs.samples == NULL || fs.buf == NULL)
+    {
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  memset(fs.buf, 0x5a, KBENCH_FS_BLKSIZE);
+
+  if (!S_ISDIR(st.st_mode))
+    {
+      ret = kbench_fs_raw(&fs, argv[0],
+                          argc > 1 && strcmp(argv[1], "rw") == 0);
+      goto out;
+    }
+
+  ret = kbench_fs_data(&fs, argv[0]);
+  if (ret >= 0)
+    {
+      ret = kbench_fs_meta(&fs, argv[0]);
+    }
+
+  if (ret >= 0 && argc == 3)
+    {
+      ret = kbench_fs_mount(&fs, argv[0], argv[1], argv[2]);
+    }
+
+out:
+  kmm_free(fs.samples);
+  kmm_free(fs.buf);
+  return ret;
+}
+
+#endif /* CONFIG_DEV_KBENCH && KBENCH_FS */
@@ -0,0 +1,279 @@
+/****************************************************************************
+ * drivers/misc/kbench_mm.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/mempool.h>
+
+#include "kbench.h"
+
+#ifdef CONFIG_DEV_KBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_MM_TLSF_MANAGER)
+#  define KBENCH_HEAP_NAME "tlsf"
+#elif defined(CONFIG_MM_DEFAULT_MANAGER)
+#  define KBENCH_HEAP_NAME "mm_heap"
+#else
+#  define KBENCH_HEAP_NAME "heap"
+#endif
+
+#define KBENCH_MEMPOOL_BLKSIZE 64
+#define KBENCH_IOB_COPYLEN     1500
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const size_t g_kbench_heapsizes[] =
+{
+  16, 64, 256, 1024, 4096
+};
+
+/* Too large for the stack with the per-CPU caches */
+
+static struct mempool_s g_kbench_pool;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_mempool_alloc
+ ****************************************************************************/
+
+static FAR void *kbench_mempool_alloc(FAR struct mempool_s *pool,
+                                      size_t size)
+{
+  return kmm_malloc(size);
+}
+
+/****************************************************************************
+ * Name: kbench_mempool_free
+ ****************************************************************************/
+
+static void kbench_mempool_free(FAR struct mempool_s *pool, FAR void *addr)
+{
+  kmm_free(addr);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_heap
+ *
+ * Description:
+ *   kmm_malloc() and kmm_free() of KBENCH_BATCH blocks at a time, the time
+ *   of one pair for each size.
+ *
+ ****************************************************************************/
+
+int kbench_heap(FAR struct kbench_s *kb)
+{
+  FAR void *blks[KBENCH_BATCH];
+  clock_t elapsed;
+  clock_t start;
+  size_t rounds;
+  size_t size;
+  size_t i;
+  size_t j;
+  size_t k;
+
+  rounds = kbench_count(kb, 10000) / KBENCH_BATCH + 1;
+
+  for (i = 0; i < nitems(g_kbench_heapsizes); i++)
+    {
+      size    = g_kbench_heapsizes[i];
+      elapsed = 0;
+
+      for (j = 0; j < rounds; j++)
+        {
+          start = up_perf_gettime();
+          for (k = 0; k < KBENCH_BATCH; k++)
+            {
+              blks[k] = kmm_malloc(size);
+            }
+
+          for (k = 0; k < KBENCH_BATCH; k++)
+            {
+              kmm_free(blks[k]);
+            }
+
+          elapsed += up_perf_gettime() - start;
+
+          /* kmm_free() takes NULL, so only check once the batch is gone */
+
+          if (blks[0] == NULL || blks[KBENCH_BATCH - 1] == NULL)
+            {
+              return -ENOMEM;
+            }
+        }
+
+      kbench_report(kb, KBENCH_HEAP_NAME, size, rounds * KBENCH_BATCH,
+                    elapsed);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_mempool
+ *
+ * Description:
+ *   mempool_allocate() and mempool_release() of KBENCH_BATCH blocks at a
+ *   time, the time of one pair.
+ *
+ ****************************************************************************/
+
+int kbench_mempool(FAR struct kbench_s *kb)
+{
+  FAR struct mempool_s *pool = &g_kbench_pool;
+  FAR void *blks[KBENCH_BATCH];
+  clock_t start;
+  size_t rounds;
+  size_t j;
+  size_t k;
+  int ret;
+
+  memset(pool, 0, sizeof(struct mempool_s));
+  pool->blocksize   = KBENCH_MEMPOOL_BLKSIZE;
+  pool->initialsize = 2 * KBENCH_BATCH * KBENCH_MEMPOOL_BLKSIZE;
+  pool->alloc       = kbench_mempool_alloc;
+  pool->free        = kbench_mempool_free;
+
+  ret = mempool_init(pool, "kbench");
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  rounds = kbench_count(kb, 10000) / KBENCH_BATCH + 1;
+
+  start = up_perf_gettime();
+  for (j = 0; j < rounds; j++)
+    {
+      for (k = 0; k < KBENCH_BATCH; k++)
+        {
+          blks[k] = mempool_allocate(pool);
+        }
+
+      for (k = 0; k < KBENCH_BATCH; k++)
+        {
+          mempool_release(pool, blks[k]);
+        }
+    }
+
+  kbench_report(kb, "mempool", KBENCH_MEMPOOL_BLKSIZE,
+                rounds * KBENCH_BATCH, up_perf_gettime() - start);
+  mempool_deinit(pool);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_iob
+ *
+ * Description:
+ *   iob_tryalloc() and iob_free() of one IOB, then the same with a packet
+ *   copied in with iob_copyin() and freed with iob_free_chain().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_IOB
+int kbench_iob(FAR struct kbench_s *kb)
+{
+  FAR uint8_t *data;
+  FAR struct iob_s *iob;
+  clock_t start;
+  size_t count;
+  size_t i;
+  int ret = OK;
+
+  count = kbench_count(kb, 10000);
+
+  start = up_perf_gettime();
+  for (i = 0; i < count; i++)
+    {
+      iob = iob_tryalloc(false);
+      if (iob == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      iob_free(iob);
+    }
+
+  kbench_report(kb, "iob_alloc", 0, count, up_perf_gettime() - start);
+
+  data = kmm_zalloc(KBENCH_IOB_COPYLEN);
+  if (data == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  start = up_perf_gettime();
+  for (i = 0; i < count; i++)
+    {
+      iob = iob_tryalloc(false);
+      if (iob == NULL)
+        {
+          ret = -ENOMEM;
+          break;
+        }
+
+      ret = iob_copyin(iob, data, KBENCH_IOB_COPYLEN, 0, false);
+      iob_free_chain(iob);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  if (ret >= 0)
+    {
+      kbench_report(kb, "iob_copyin", KBENCH_IOB_COPYLEN, count,
+                    up_perf_gettime() - start);
+      ret = OK;
+    }
+
+  kmm_free(data);
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_DEV_KBENCH */
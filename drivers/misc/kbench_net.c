@@ -0,0 +1,515 @@
+/****************************************************************************
+ * drivers/misc/kbench_net.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "kbench.h"
+
+#if defined(KBENCH_STREAM) || defined(KBENCH_UDP)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define KBENCH_NET_MAXCHUNK 1024
+
+/* A lost datagram ends the UDP benchmark after this time */
+
+#define KBENCH_UDP_TIMEOUT  1
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Shared with the helper thread, the runs are serialized */
+
+struct kbench_net_s
+{
+  sem_t done;                   /* Posted when the helper is done */
+  FAR struct file *file;        /* The read end, or NULL for sock */
+  FAR struct socket *sock;      /* The read end or the UDP echo socket */
+  size_t chunk;                 /* Bytes per read or datagram */
+  size_t total;                 /* Bytes to read or datagrams to echo */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct kbench_net_s g_kbench_net =
+{
+  SEM_INITIALIZER(0),
+};
+
+static const size_t g_kbench_chunks[] =
+{
+  64, KBENCH_NET_MAXCHUNK
+};
+
+static uint8_t g_kbench_txbuf[KBENCH_NET_MAXCHUNK];
+static uint8_t g_kbench_rxbuf[KBENCH_NET_MAXCHUNK];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef KBENCH_STREAM
+
+/****************************************************************************
+ * Name: kbench_stream_helper
+ *
+ * Description:
+ *   Read until all bytes arrived or the write end is gone.
+ *
+ ****************************************************************************/
+
+static int kbench_stream_helper(int argc, FAR char *argv[])
+{
+  FAR struct kbench_net_s *kn = &g_kbench_net;
+  ssize_t nbytes = -ENOSYS;
+  size_t total = 0;
+
+  while (total < kn->total)
+    {
+      if (kn->file != NULL)
+        {
+          nbytes = file_read(kn->file, g_kbench_rxbuf, kn->chunk);
+        }
+#ifdef CONFIG_NET
+      else
+        {
+          nbytes = psock_recv(kn->sock, g_kbench_rxbuf, kn->chunk, 0);
+        }
+#endif
+
+      if (nbytes <= 0)
+        {
+          break;
+        }
+
+      total += nbytes;
+    }
+
+  nxsem_post(&kn->done);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: kbench_stream
+ *
+ * Description:
+ *   Write count chunks of each size to file or sock while the helper reads
+ *   them from the other end, the time until the helper has all of them.
+ *
+ ****************************************************************************/
+
+static int kbench_stream(FAR struct kbench_s *kb, FAR const char *name,
+                         FAR struct file *file, FAR struct socket *sock)
+{
+  FAR struct kbench_net_s *kn = &g_kbench_net;
+  ssize_t nbytes = -ENOSYS;
+  clock_t start;
+  size_t count;
+  size_t i;
+  size_t j;
+  int ret;
+
+  count = kbench_count(kb, 1000);
+
+  for (i = 0; i < nitems(g_kbench_chunks); i++)
+    {
+      kn->chunk = g_kbench_chunks[i];
+      kn->total = count * kn->chunk;
+
+      ret = kbench_spawn("kbench_stream", 0, kbench_stream_helper);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      start = up_perf_gettime();
+      for (j = 0; j < count; j++)
+        {
+          if (file != NULL)
+            {
+              nbytes = file_write(file, g_kbench_txbuf, kn->chunk);
+            }
+#ifdef CONFIG_NET
+          else
+            {
+              nbytes = psock_send(sock, g_kbench_txbuf, kn->chunk, 0);
+            }
+#endif
+
+          /* The helper sees the end of the stream once the caller closes
+           * the write end.
+           */
+
+          if (nbytes < 0)
+            {
+              return nbytes;
+            }
+        }
+
+      nxsem_wait_uninterruptible(&kn->done);
+      kbench_report(kb, name, kn->chunk, count, up_perf_gettime() - start);
+    }
+
+  return OK;
+}
+#endif /* KBENCH_STREAM */
+
+/****************************************************************************
+ * Name: kbench_loopback
+ *
+ * Description:
+ *   Open a socket of the given type, bind it to 127.0.0.1 and return its
+ *   address.
+ *
+ ****************************************************************************/
+
+#if defined(KBENCH_TCP) || defined(KBENCH_UDP)
+static int kbench_loopback(FAR struct socket *sock, int type,
+                           FAR struct sockaddr_in *addr)
+{
+  socklen_t addrlen = sizeof(struct sockaddr_in);
+  int ret;
+
+  ret = psock_socket(AF_INET, type, 0, sock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(addr, 0, sizeof(struct sockaddr_in));
+  addr->sin_family      = AF_INET;
+  addr->sin_addr.s_addr = HTONL(INADDR_LOOPBACK);
+
+  ret = psock_bind(sock, (FAR struct sockaddr *)addr, addrlen);
+  if (ret >= 0)
+    {
+      ret = psock_getsockname(sock, (FAR struct sockaddr *)addr, &addrlen);
+    }
+
+  if (ret < 0)
+    {
+      psock_close(sock);
+    }
+
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_udp_helper
+ *
+ * Description:
+ *   Send each datagram back to where it came from.
+ *
+ ****************************************************************************/
+
+#ifdef KBENCH_UDP
+static int kbench_udp_helper(int argc, FAR char *argv[])
+{
+  FAR struct kbench_net_s *kn = &g_kbench_net;
+  struct sockaddr_in from;
+  socklen_t fromlen;
+  ssize_t nbytes;
+  size_t i;
+
+  for (i = 0; i < kn->total; i++)
+    {
+      fromlen = sizeof(from);
+      nbytes  = psock_recvfrom(kn->sock, g_kbench_rxbuf, kn->chunk, 0,
+                               (FAR struct sockaddr *)&from, &fromlen);
+      if (nbytes < 0 ||
+          psock_sendto(kn->sock, g_kbench_rxbuf, nbytes, 0,
+                       (FAR struct sockaddr *)&from, fromlen) < 0)
+        {
+          break;
+        }
+    }
+
+  nxsem_post(&kn->done);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_pipe
+ *
+ * Description:
+ *   The throughput of a pipe.
+ *
+ ****************************************************************************/
+
+#ifdef KBENCH_PIPE
+int kbench_pipe(FAR struct kbench_s *kb)
+{
+  FAR struct kbench_net_s *kn = &g_kbench_net;
+  FAR struct file *filep[2];
+  struct file files[2];
+  int ret;
+
+  memset(files, 0, sizeof(files));
+  filep[0] = &files[0];
+  filep[1] = &files[1];
+
+  ret = file_pipe(filep, CONFIG_DEV_PIPE_SIZE, 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  kn->file = filep[0];
+  ret = kbench_stream(kb, "pipe", filep[1], NULL);
+
+  file_close(filep[1]);
+  file_close(filep[0]);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_local
+ *
+ * Description:
+ *   The throughput of a pair of local stream sockets.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+int kbench_local(FAR struct kbench_s *kb)
+{
+  FAR struct kbench_net_s *kn = &g_kbench_net;
+  FAR struct socket *psocks[2];
+  struct socket socks[2];
+  int ret;
+
+  memset(socks, 0, sizeof(socks));
+  psocks[0] = &socks[0];
+  psocks[1] = &socks[1];
+
+  ret = psock_socketpair(AF_LOCAL, SOCK_STREAM, 0, psocks);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  kn->file = NULL;
+  kn->sock = psocks[0];
+  ret = kbench_stream(kb, "local_stream", NULL, psocks[1]);
+
+  psock_close(psocks[1]);
+  psock_close(psocks[0]);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_tcp
+ *
+ * Description:
+ *   The throughput of a TCP connection over the loopback device.
+ *
+ ****************************************************************************/
+
+#ifdef KBENCH_TCP
+int kbench_tcp(FAR struct kbench_s *kb)
+{
+  FAR struct kbench_net_s *kn = &g_kbench_net;
+  struct sockaddr_in addr;
+  struct socket listener;
+  struct socket client;
+  struct socket server;
+  int ret;
+
+  memset(&listener, 0, sizeof(listener));
+  memset(&client, 0, sizeof(client));
+  memset(&server, 0, sizeof(server));
+
+  ret = kbench_loopback(&listener, SOCK_STREAM, &addr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The backlog holds the connection until it is accepted */
+
+  ret = psock_listen(&listener, 1);
+  if (ret < 0)
+    {
+      goto errout_with_listener;
+    }
+
+  ret = psock_socket(AF_INET, SOCK_STREAM, 0, &client);
+  if (ret < 0)
+    {
+      goto errout_with_listener;
+    }
+
+  ret = psock_connect(&client, (FAR struct sockaddr *)&addr, sizeof(addr));
+  if (ret >= 0)
+    {
+      ret = psock_accept(&listener, NULL, NULL, &server, 0);
+    }
+
+  if (ret < 0)
+    {
+      goto errout_with_client;
+    }
+
+  kn->file = NULL;
+  kn->sock = &server;
+  ret = kbench_stream(kb, "tcp", NULL, &client);
+
+  psock_close(&server);
+
+errout_with_client:
+  psock_close(&client);
+
+errout_with_listener:
+  psock_close(&listener);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_udp
+ *
+ * Description:
+ *   UDP datagrams echoed over the loopback device, the time of a round
+ *   trip.  One datagram is in flight at a time, so none is dropped for a
+ *   lack of buffers.
+ *
+ ****************************************************************************/
+
+#ifdef KBENCH_UDP
+int kbench_udp(FAR struct kbench_s *kb)
+{
+  FAR struct kbench_net_s *kn = &g_kbench_net;
+  struct sockaddr_in caddr;
+  struct sockaddr_in saddr;
+  struct socket client;
+  struct socket server;
+  struct timeval tv;
+  clock_t elapsed;
+  clock_t start;
+  size_t count;
+  size_t i;
+  size_t j;
+  int ret;
+
+  memset(&client, 0, sizeof(client));
+  memset(&server, 0, sizeof(server));
+
+  ret = kbench_loopback(&server, SOCK_DGRAM, &saddr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = kbench_loopback(&client, SOCK_DGRAM, &caddr);
+  if (ret < 0)
+    {
+      goto errout_with_server;
+    }
+
+  tv.tv_sec  = KBENCH_UDP_TIMEOUT;
+  tv.tv_usec = 0;
+  psock_setsockopt(&client, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  psock_setsockopt(&server, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  count    = kbench_count(kb, 1000);
+  kn->sock = &server;
+
+  for (i = 0; i < nitems(g_kbench_chunks); i++)
+    {
+      kn->chunk = g_kbench_chunks[i];
+      kn->total = count;
+
+      ret = kbench_spawn("kbench_udp", 0, kbench_udp_helper);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      start = up_perf_gettime();
+      for (j = 0; j < count; j++)
+        {
+          ret = psock_sendto(&client, g_kbench_txbuf, kn->chunk, 0,
+                             (FAR struct sockaddr *)&saddr, sizeof(saddr));
+          if (ret >= 0)
+            {
+              ret = psock_recv(&client, g_kbench_rxbuf, kn->chunk, 0);
+            }
+
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      elapsed = up_perf_gettime() - start;
+
+      /* The helper times out as well if a datagram was lost */
+
+      nxsem_wait_uninterruptible(&kn->done);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      kbench_report(kb, "udp_roundtrip", kn->chunk, count, elapsed);
+      ret = OK;
+    }
+
+  psock_close(&client);
+
+errout_with_server:
+  psock_close(&server);
+  return ret;
+}
+#endif
+
+#endif /* KBENCH_STREAM || KBENCH_UDP */
@@ -0,0 +1,419 @@
+/****************************************************************************
+ * drivers/misc/kbench_sched.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wdog.h>
+#include <nuttx/fs/fs.h>
+
+#include "kbench.h"
+
+#ifdef CONFIG_DEV_KBENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define KBENCH_MQ_MSGSIZE 16
+
+/* The watchdogs never expire during the benchmark */
+
+#define KBENCH_WDOG_DELAY SEC2TICK(3600)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Shared with the helper threads, the runs are serialized */
+
+struct kbench_sched_s
+{
+  sem_t   req;                  /* Posted by the benchmark */
+  sem_t   rsp;                  /* Posted by the helper */
+  size_t  count;                /* Iterations of the helper */
+  clock_t start;                /* When the benchmark posted req */
+  clock_t sum;                  /* Latencies measured by the helper */
+#ifndef CONFIG_DISABLE_MQUEUE
+  struct file mq[2];            /* Requests and responses */
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct kbench_sched_s g_kbench_sched =
+{
+  SEM_INITIALIZER(0),
+  SEM_INITIALIZER(0),
+};
+
+static const size_t g_kbench_ntimers[] =
+{
+  1, 16, 256
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_yield_helper
+ ****************************************************************************/
+
+static int kbench_yield_helper(int argc, FAR char *argv[])
+{
+  FAR struct kbench_sched_s *ks = &g_kbench_sched;
+  size_t i;
+
+  for (i = 0; i < ks->count; i++)
+    {
+      sched_yield();
+    }
+
+  nxsem_post(&ks->rsp);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: kbench_sem_helper
+ ****************************************************************************/
+
+static int kbench_sem_helper(int argc, FAR char *argv[])
+{
+  FAR struct kbench_sched_s *ks = &g_kbench_sched;
+  size_t i;
+
+  for (i = 0; i < ks->count; i++)
+    {
+      nxsem_wait_uninterruptible(&ks->req);
+      nxsem_post(&ks->rsp);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: kbench_semwake_helper
+ ****************************************************************************/
+
+static int kbench_semwake_helper(int argc, FAR char *argv[])
+{
+  FAR struct kbench_sched_s *ks = &g_kbench_sched;
+  size_t i;
+
+  for (i = 0; i < ks->count; i++)
+    {
+      nxsem_wait_uninterruptible(&ks->req);
+      ks->sum += up_perf_gettime() - ks->start;
+      nxsem_post(&ks->rsp);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: kbench_mq_helper
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_MQUEUE
+static int kbench_mq_helper(int argc, FAR char *argv[])
+{
+  FAR struct kbench_sched_s *ks = &g_kbench_sched;
+  char msg[KBENCH_MQ_MSGSIZE];
+  unsigned int prio;
+  size_t i;
+
+  for (i = 0; i < ks->count; i++)
+    {
+      file_mq_receive(&ks->mq[0], msg, sizeof(msg), &prio);
+      file_mq_send(&ks->mq[1], msg, sizeof(msg), prio);
+    }
+
+  nxsem_post(&ks->rsp);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_wdog_handler
+ ****************************************************************************/
+
+static void kbench_wdog_handler(wdparm_t arg)
+{
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kbench_yield
+ *
+ * Description:
+ *   sched_yield() between two threads of the same priority, the time of
+ *   one context switch.
+ *
+ ****************************************************************************/
+
+int kbench_yield(FAR struct kbench_s *kb)
+{
+  FAR struct kbench_sched_s *ks = &g_kbench_sched;
+  clock_t start;
+  size_t i;
+  int ret;
+
+  ks->count = kbench_count(kb, 10000);
+  ret = kbench_spawn("kbench_yield", 0, kbench_yield_helper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  start = up_perf_gettime();
+  for (i = 0; i < ks->count; i++)
+    {
+      sched_yield();
+    }
+
+  nxsem_wait_uninterruptible(&ks->rsp);
+  kbench_report(kb, "yield", 0, 2 * ks->count, up_perf_gettime() - start);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_sem
+ *
+ * Description:
+ *   Semaphore ping-pong between two threads of the same priority, the time
+ *   of a round trip.
+ *
+ ****************************************************************************/
+
+int kbench_sem(FAR struct kbench_s *kb)
+{
+  FAR struct kbench_sched_s *ks = &g_kbench_sched;
+  clock_t start;
+  size_t i;
+  int ret;
+
+  ks->count = kbench_count(kb, 10000);
+  ret = kbench_spawn("kbench_sem", 0, kbench_sem_helper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  start = up_perf_gettime();
+  for (i = 0; i < ks->count; i++)
+    {
+      nxsem_post(&ks->req);
+      nxsem_wait_uninterruptible(&ks->rsp);
+    }
+
+  kbench_report(kb, "sem_pingpong", 0, ks->count,
+                up_perf_gettime() - start);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_semwake
+ *
+ * Description:
+ *   The time from nxsem_post() until a waiter of a higher priority returns
+ *   from nxsem_wait().
+ *
+ ****************************************************************************/
+
+int kbench_semwake(FAR struct kbench_s *kb)
+{
+  FAR struct kbench_sched_s *ks = &g_kbench_sched;
+  size_t i;
+  int ret;
+
+  ks->count = kbench_count(kb, 10000);
+  ks->sum   = 0;
+  ret = kbench_spawn("kbench_semwake", 1, kbench_semwake_helper);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < ks->count; i++)
+    {
+      ks->start = up_perf_gettime();
+      nxsem_post(&ks->req);
+      nxsem_wait_uninterruptible(&ks->rsp);
+    }
+
+  kbench_report(kb, "sem_wakeup", 0, ks->count, ks->sum);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: kbench_mq
+ *
+ * Description:
+ *   A message sent to a thread of the same priority and sent back, the time
+ *   of a round trip.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_MQUEUE
+int kbench_mq(FAR struct kbench_s *kb)
+{
+  FAR struct kbench_sched_s *ks = &g_kbench_sched;
+  char msg[KBENCH_MQ_MSGSIZE];
+  struct mq_attr attr;
+  unsigned int prio;
+  clock_t start;
+  size_t i;
+  int ret;
+
+  memset(&attr, 0, sizeof(attr));
+  memset(msg, 0, sizeof(msg));
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = KBENCH_MQ_MSGSIZE;
+
+  ret = file_mq_open(&ks->mq[0], "kbench_req", O_RDWR | O_CREAT, 0600,
+                     &attr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_mq_open(&ks->mq[1], "kbench_rsp", O_RDWR | O_CREAT, 0600,
+                     &attr);
+  if (ret < 0)
+    {
+      goto errout_with_req;
+    }
+
+  ks->count = kbench_count(kb, 10000);
+  ret = kbench_spawn("kbench_mq", 0, kbench_mq_helper);
+  if (ret < 0)
+    {
+      goto errout_with_rsp;
+    }
+
+  start = up_perf_gettime();
+  for (i = 0; i < ks->count; i++)
+    {
+      file_mq_send(&ks->mq[0], msg, sizeof(msg), 0);
+      file_mq_receive(&ks->mq[1], msg, sizeof(msg), &prio);
+    }
+
+  kbench_report(kb, "mq_roundtrip", KBENCH_MQ_MSGSIZE, ks->count,
+                up_perf_gettime() - start);
+
+  /* The helper is done with the queues once it posts */
+
+  nxsem_wait_uninterruptible(&ks->rsp);
+  ret = OK;
+
+errout_with_rsp:
+  file_mq_close(&ks->mq[1]);
+  file_mq_unlink("kbench_rsp");
+
+errout_with_req:
+  file_mq_close(&ks->mq[0]);
+  file_mq_unlink("kbench_req");
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: kbench_wdog
+ *
+ * Description:
+ *   Restart one watchdog while the others are active, the cost of wd_start()
+ *   for a number of pending timers.
+ *
+ ****************************************************************************/
+
+int kbench_wdog(FAR struct kbench_s *kb)
+{
+  FAR struct wdog_s *wdogs;
+  struct wdog_s probe;
+  clock_t start;
+  size_t count;
+  size_t n;
+  size_t i;
+  size_t j;
+
+  count = kbench_count(kb, 1000);
+  memset(&probe, 0, sizeof(probe));
+
+  for (i = 0; i < nitems(g_kbench_ntimers); i++)
+    {
+      n = g_kbench_ntimers[i];
+      wdogs = kmm_zalloc(n * sizeof(struct wdog_s));
+      if (wdogs == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      for (j = 0; j < n; j++)
+        {
+          wd_start(&wdogs[j], KBENCH_WDOG_DELAY + j,
+                   kbench_wdog_handler, 0);
+        }
+
+      /* Go through the whole list, the insert point moves on each time */
+
+      start = up_perf_gettime();
+      for (j = 0; j < count; j++)
+        {
+          wd_start(&probe, KBENCH_WDOG_DELAY + j % (n + 1),
+                   kbench_wdog_handler, 0);
+        }
+
+      kbench_report(kb, "wd_start", n, count, up_perf_gettime() - start);
+
+      wd_cancel(&probe);
+      for (j = 0; j < n; j++)
+        {
+          wd_cancel(&wdogs[j]);
+        }
+
+      kmm_free(wdogs);
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_DEV_KBENCH */
@@ -393,11 +393,11 @@ static ssize_t rpmsgblk_write(FAR struct inode *inode,
       start_sector += msg->nsectors;
       written      += msg->nsectors;
 
-      ret = rpmsg_send_nocopy(&priv->ept, msg,
-                              sizeof(*msg) - 1 + msg->nsectors * sectorsize);
+      ret = rpmsg_send_tx_payload(&priv->ept, msg,
+                                  sizeof(*msg) - 1 +
+                                  msg->nsectors * sectorsize);
       if (ret < 0)
         {
-          rpmsg_release_tx_buffer(&priv->ept, msg);
           goto out;
         }
     }
@@ -857,16 +857,11 @@ static int rpmsgblk_send_recv(FAR struct rpmsgblk_s *priv,
     }
   else
     {
-      ret = rpmsg_send_nocopy(&priv->ept, msg, len);
+      ret = rpmsg_send_tx_payload(&priv->ept, msg, len);
     }
 
   if (ret < 0)
     {
-      if (copy == false)
-        {
-          rpmsg_release_tx_buffer(&priv->ept, msg);
-        }
-
       goto fail;
     }
 
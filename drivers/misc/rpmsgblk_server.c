@@ -227,13 +227,9 @@ static int rpmsgblk_read_handler(FAR struct rpmsg_endpoint *ept,
                                (FAR unsigned char *)rsp->buf,
                                msg->startsector, nsectors);
       rsp->header.result = ret;
-      if (rpmsg_send_nocopy(ept, rsp, (ret < 0 ? 0 : ret * msg->sectorsize) +
-                                      sizeof(*rsp) - 1) < 0)
-        {
-          rpmsg_release_tx_buffer(ept, rsp);
-        }
-
-      if (ret <= 0)
+      if (rpmsg_send_tx_payload(ept, rsp,
+                                (ret < 0 ? 0 : ret * msg->sectorsize) +
+                                sizeof(*rsp) - 1) < 0 || ret <= 0)
         {
           ferr("mtd block read failed\n");
           break;
@@ -366,13 +362,7 @@ static int rpmsgblk_mmc_cmd_handler(FAR struct rpmsg_endpoint *ept,
 
   rsp->header.result = server->bops->ioctl(server->blknode, rsp->request,
                                            (unsigned long)rsp->buf);
-  ret = rpmsg_send_nocopy(ept, rsp, rsplen);
-  if (ret < 0)
-    {
-      rpmsg_release_tx_buffer(ept, rsp);
-    }
-
-  return ret;
+  return rpmsg_send_tx_payload(ept, rsp, rsplen);
 }
 
 /****************************************************************************
@@ -441,13 +431,7 @@ static int rpmsgblk_mmc_multi_cmd_handler(FAR struct rpmsg_endpoint *ept,
 
   rsp->header.result = server->bops->ioctl(server->blknode, rsp->request,
                                            (unsigned long)rsp->buf);
-  ret = rpmsg_send_nocopy(ept, rsp, rsplen);
-  if (ret < 0)
-    {
-      rpmsg_release_tx_buffer(ept, rsp);
-    }
-
-  return ret;
+  return rpmsg_send_tx_payload(ept, rsp, rsplen);
 }
 
 /****************************************************************************
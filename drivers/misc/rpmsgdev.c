@@ -827,16 +827,11 @@ static int rpmsgdev_send_recv(FAR struct rpmsgdev_s *priv,
     }
   else
     {
-      ret = rpmsg_send_nocopy(&priv->ept, msg, len);
+      ret = rpmsg_send_tx_payload(&priv->ept, msg, len);
     }
 
   if (ret < 0)
     {
-      if (copy == false)
-        {
-          rpmsg_release_tx_buffer(&priv->ept, msg);
-        }
-
       goto fail;
     }
 
@@ -242,8 +242,9 @@ static int rpmsgdev_read_handler(FAR struct rpmsg_endpoint *ept,
       ret = file_read(filep, rsp->buf, space);
 
       rsp->header.result = ret;
-      rpmsg_send_nocopy(ept, rsp, (ret < 0 ? 0 : ret) + sizeof(*rsp) - 1);
-      if (ret <= 0 || msg->header.command == RPMSGDEV_READ_NOFRAG)
+      space = (ret < 0 ? 0 : ret) + sizeof(*rsp) - 1;
+      if (rpmsg_send_tx_payload(ept, rsp, space) < 0 ||
+          ret <= 0 || msg->header.command == RPMSGDEV_READ_NOFRAG)
         {
           break;
         }
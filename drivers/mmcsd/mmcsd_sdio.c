@@ -96,6 +96,10 @@
 
 #define MMCSD_BLOCK_WDATADELAY  CONFIG_MMCSD_BLOCK_WDATADELAY
 
+/* Delay between two polls of the card status while busy polling */
+
+#define MMCSD_READY_POLLSTEP    (20)
+
 #define IS_EMPTY(priv) (priv->type == MMCSD_CARDTYPE_UNKNOWN)
 
 #if CONFIG_MMCSD_MULTIBLOCK_LIMIT == 0
@@ -204,6 +208,10 @@ static ssize_t mmcsd_write(FAR struct inode *inode,
                            FAR const unsigned char *buffer,
                            blkcnt_t startsector,
                            unsigned int nsectors);
+static ssize_t mmcsd_readv(FAR struct inode *inode,
+                           FAR const struct blkvec_s *vec, int nvec);
+static ssize_t mmcsd_writev(FAR struct inode *inode,
+                            FAR const struct blkvec_s *vec, int nvec);
 static int     mmcsd_geometry(FAR struct inode *inode,
                               FAR struct geometry *geometry);
 static int     mmcsd_ioctl(FAR struct inode *inode, int cmd,
@@ -243,7 +251,12 @@ static const struct block_operations g_bops =
   mmcsd_read,     /* read     */
   mmcsd_write,    /* write    */
   mmcsd_geometry, /* geometry */
-  mmcsd_ioctl     /* ioctl    */
+  mmcsd_ioctl,    /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  NULL,           /* unlink   */
+#endif
+  mmcsd_readv,    /* readv    */
+  mmcsd_writev    /* writev   */
 };
 
 static FAR const char *g_partname[MMCSD_PART_COUNT] =
@@ -1316,6 +1329,9 @@ static int mmcsd_transferready(FAR struct mmcsd_state_s *priv)
 {
   clock_t starttime;
   clock_t elapsed;
+#if CONFIG_MMCSD_READY_POLLTIME > 0
+  unsigned int polltime = 0;
+#endif
   uint32_t r1;
   int ret;
 
@@ -1398,15 +1414,27 @@ static int mmcsd_transferready(FAR struct mmcsd_state_s *priv)
           return -EINVAL;
         }
 
-      /* Do not hog the CPU */
+      /* Do not hog the CPU, unless the card is expected to become ready
+       * sooner than a sleep would return.
+       */
 
+#if CONFIG_MMCSD_READY_POLLTIME > 0
+      if (polltime < CONFIG_MMCSD_READY_POLLTIME)
+        {
+          up_udelay(MMCSD_READY_POLLSTEP);
+          polltime += MMCSD_READY_POLLSTEP;
+        }
+      else
+#endif
+        {
 #ifdef CONFIG_MMCSD_CHECK_READY_STATUS_WITHOUT_SLEEP
-      /* Use sched_yield when tick is big to avoid low writing speed */
+          /* Use sched_yield when tick is big to avoid low writing speed */
 
-      sched_yield();
+          sched_yield();
 #else
-      MMCSD_USLEEP(1000);
+          MMCSD_USLEEP(1000);
 #endif
+        }
 
       /* We are still in the programming state. Calculate the elapsed
        * time... we can't stay in this loop forever!
@@ -2357,6 +2385,63 @@ static int mmcsd_close(FAR struct inode *inode)
   return OK;
 }
 
+/****************************************************************************
+ * Name: mmcsd_readlocked
+ *
+ * Description:
+ *   Read contiguous sectors with as few multiple block transfers as
+ *   possible.  The caller holds the driver lock.
+ *
+ ****************************************************************************/
+
+static ssize_t mmcsd_readlocked(FAR struct mmcsd_part_s *part,
+                                FAR unsigned char *buffer,
+                                blkcnt_t startsector, unsigned int nsectors)
+{
+  FAR struct mmcsd_state_s *priv = part->priv;
+  size_t sector;
+  size_t endsector;
+  ssize_t nread;
+
+  endsector = startsector + nsectors;
+  for (sector = startsector; sector < endsector; sector += nread)
+    {
+      /* Read this sector into the user buffer */
+
+#if MMCSD_MULTIBLOCK_LIMIT == 1
+      /* Read each block using only the single block transfer method */
+
+      nread = mmcsd_readsingle(part, buffer, sector);
+#else
+      nread = endsector - sector;
+      if (nread > MMCSD_MULTIBLOCK_LIMIT)
+        {
+          nread = MMCSD_MULTIBLOCK_LIMIT;
+        }
+
+      if (nread == 1)
+        {
+          nread = mmcsd_readsingle(part, buffer, sector);
+        }
+      else
+        {
+          nread = mmcsd_readmultiple(part, buffer, sector, nread);
+        }
+
+#endif
+      if (nread < 0)
+        {
+          return nread;
+        }
+
+      /* Increment the buffer pointer by the sector size */
+
+      buffer += nread * priv->blocksize;
+    }
+
+  return nsectors;
+}
+
 /****************************************************************************
  * Name: mmcsd_read
  *
@@ -2371,9 +2456,6 @@ static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
 {
   FAR struct mmcsd_state_s *priv;
   FAR struct mmcsd_part_s *part;
-  size_t sector;
-  size_t endsector;
-  ssize_t nread;
   ssize_t ret = nsectors;
 
   DEBUGASSERT(inode->i_private);
@@ -2391,50 +2473,116 @@ static ssize_t mmcsd_read(FAR struct inode *inode, unsigned char *buffer,
           return ret;
         }
 
-      ret = nsectors;
-      endsector = startsector + nsectors;
-      for (sector = startsector; sector < endsector; sector += nread)
+      ret = mmcsd_readlocked(part, buffer, startsector, nsectors);
+      mmcsd_unlock(priv);
+    }
+
+  /* On success, return the number of blocks read */
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mmcsd_readv
+ *
+ * Description:
+ *   Read several ranges of sectors while holding the card once.  The
+ *   ranges come sorted and merged from block_readv(), so each one is a
+ *   single multiple block transfer.
+ *
+ ****************************************************************************/
+
+static ssize_t mmcsd_readv(FAR struct inode *inode,
+                           FAR const struct blkvec_s *vec, int nvec)
+{
+  FAR struct mmcsd_state_s *priv;
+  FAR struct mmcsd_part_s *part;
+  ssize_t total = 0;
+  ssize_t ret;
+  int i;
+
+  DEBUGASSERT(inode->i_private);
+  part = inode->i_private;
+  priv = part->priv;
+
+  ret = mmcsd_lock(priv);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < nvec; i++)
+    {
+      ret = mmcsd_readlocked(part, vec[i].buffer, vec[i].start,
+                             vec[i].nsectors);
+      if (ret < 0)
         {
-          /* Read this sector into the user buffer */
+          break;
+        }
+
+      total += ret;
+    }
+
+  mmcsd_unlock(priv);
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: mmcsd_writelocked
+ *
+ * Description:
+ *   Write contiguous sectors with as few multiple block transfers as
+ *   possible.  The caller holds the driver lock.
+ *
+ ****************************************************************************/
+
+static ssize_t mmcsd_writelocked(FAR struct mmcsd_part_s *part,
+                                 FAR const unsigned char *buffer,
+                                 blkcnt_t startsector,
+                                 unsigned int nsectors)
+{
+  FAR struct mmcsd_state_s *priv = part->priv;
+  size_t sector;
+  size_t endsector;
+  ssize_t nwrite;
+
+  endsector = startsector + nsectors;
+  for (sector = startsector; sector < endsector; sector += nwrite)
+    {
+      /* Write this sector into the user buffer */
 
 #if MMCSD_MULTIBLOCK_LIMIT == 1
-          /* Read each block using only the single block transfer method */
+      /* Write each block using only the single block transfer method */
 
-          nread = mmcsd_readsingle(part, buffer, sector);
+      nwrite = mmcsd_writesingle(part, buffer, sector);
 #else
-          nread = endsector - sector;
-          if (nread > MMCSD_MULTIBLOCK_LIMIT)
-            {
-              nread = MMCSD_MULTIBLOCK_LIMIT;
-            }
+      nwrite = endsector - sector;
+      if (nwrite > MMCSD_MULTIBLOCK_LIMIT)
+        {
+          nwrite = MMCSD_MULTIBLOCK_LIMIT;
+        }
 
-          if (nread == 1)
-            {
-              nread = mmcsd_readsingle(part, buffer, sector);
-            }
-          else
-            {
-              nread = mmcsd_readmultiple(part, buffer, sector, nread);
-            }
+      if (nwrite == 1)
+        {
+          nwrite = mmcsd_writesingle(part, buffer, sector);
+        }
+      else
+        {
+          nwrite = mmcsd_writemultiple(part, buffer, sector, nwrite);
+        }
 
 #endif
-          if (nread < 0)
-            {
-              ret = nread;
-              break;
-            }
-
-          /* Increment the buffer pointer by the sector size */
-
-          buffer += nread * priv->blocksize;
+      if (nwrite < 0)
+        {
+          return nwrite;
         }
 
-      mmcsd_unlock(priv);
-    }
+      /* Increment the buffer pointer by the sector size */
 
-  /* On success, return the number of blocks read */
+      buffer += nwrite * priv->blocksize;
+    }
 
-  return ret;
+  return nsectors;
 }
 
 /****************************************************************************
@@ -2452,9 +2600,6 @@ static ssize_t mmcsd_write(FAR struct inode *inode,
 {
   FAR struct mmcsd_state_s *priv;
   FAR struct mmcsd_part_s *part;
-  size_t sector;
-  size_t endsector;
-  ssize_t nwrite;
   ssize_t ret = nsectors;
 
   DEBUGASSERT(inode->i_private);
@@ -2472,50 +2617,56 @@ static ssize_t mmcsd_write(FAR struct inode *inode,
           return ret;
         }
 
-      ret = nsectors;
-      endsector = startsector + nsectors;
-      for (sector = startsector; sector < endsector; sector += nwrite)
-        {
-          /* Write this sector into the user buffer */
+      ret = mmcsd_writelocked(part, buffer, startsector, nsectors);
+      mmcsd_unlock(priv);
+    }
 
-#if MMCSD_MULTIBLOCK_LIMIT == 1
-          /* Write each block using only the single block transfer method */
+  /* On success, return the number of blocks written */
 
-          nwrite = mmcsd_writesingle(part, buffer, sector);
-#else
-          nwrite = endsector - sector;
-          if (nwrite > MMCSD_MULTIBLOCK_LIMIT)
-            {
-              nwrite = MMCSD_MULTIBLOCK_LIMIT;
-            }
+  return ret;
+}
 
-          if (nwrite == 1)
-            {
-              nwrite = mmcsd_writesingle(part, buffer, sector);
-            }
-          else
-            {
-              nwrite = mmcsd_writemultiple(part, buffer, sector, nwrite);
-            }
+/****************************************************************************
+ * Name: mmcsd_writev
+ *
+ * Description:
+ *   Write several ranges of sectors while holding the card once.
+ *
+ ****************************************************************************/
 
-#endif
-          if (nwrite < 0)
-            {
-              ret = nwrite;
-              break;
-            }
+static ssize_t mmcsd_writev(FAR struct inode *inode,
+                            FAR const struct blkvec_s *vec, int nvec)
+{
+  FAR struct mmcsd_state_s *priv;
+  FAR struct mmcsd_part_s *part;
+  ssize_t total = 0;
+  ssize_t ret;
+  int i;
 
-          /* Increment the buffer pointer by the sector size */
+  DEBUGASSERT(inode->i_private);
+  part = inode->i_private;
+  priv = part->priv;
+
+  ret = mmcsd_lock(priv);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-          buffer += nwrite * priv->blocksize;
+  for (i = 0; i < nvec; i++)
+    {
+      ret = mmcsd_writelocked(part, vec[i].buffer, vec[i].start,
+                              vec[i].nsectors);
+      if (ret < 0)
+        {
+          break;
         }
 
-      mmcsd_unlock(priv);
+      total += ret;
     }
 
-  /* On success, return the number of blocks written */
-
-  return ret;
+  mmcsd_unlock(priv);
+  return total > 0 ? total : ret;
 }
 
 /****************************************************************************
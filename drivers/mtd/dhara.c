@@ -32,8 +32,12 @@
 
 #include <nuttx/nuttx.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/lib/lib.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/drivers/rwbuffer.h>
 
 #include <dhara/map.h>
 #include <dhara/nand.h>
@@ -42,6 +46,10 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#if defined(CONFIG_DHARA_BGGC) && !defined(CONFIG_SCHED_LPWORK)
+#  error "CONFIG_DHARA_BGGC requires CONFIG_SCHED_LPWORK"
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -63,6 +71,12 @@ struct dhara_dev_s
 
   FAR struct mtd_dev_s *mtd;      /* Contained MTD interface */
   struct mtd_geometry_s geo;      /* Device geometry */
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  struct rwbuffer_s     rwb;      /* Write buffer support */
+#endif
+#ifdef CONFIG_DHARA_BGGC
+  struct work_s         work;     /* Background garbage collection */
+#endif
   uint16_t              blkper;   /* R/W blocks per erase block */
   uint16_t              refs;     /* Number of references */
   bool                  unlinked; /* The driver has been unlinked */
@@ -87,6 +101,10 @@ typedef struct dhara_dev_s dhara_dev_t;
 
 static int     dhara_open(FAR struct inode *inode);
 static int     dhara_close(FAR struct inode *inode);
+static ssize_t dhara_reload(FAR void *priv, FAR uint8_t *buffer,
+                            off_t startblock, size_t nblocks);
+static ssize_t dhara_flush(FAR void *priv, FAR const uint8_t *buffer,
+                           off_t startblock, size_t nblocks);
 static ssize_t dhara_read(FAR struct inode *inode,
                           FAR unsigned char *buffer,
                           blkcnt_t start_sector,
@@ -288,6 +306,99 @@ static void dhara_update_readcache(FAR dhara_dev_t *dev,
     }
 }
 
+/****************************************************************************
+ * Name: dhara_gc_worker
+ *
+ * Description:
+ *   The map collects garbage by itself once the journal has grown to the
+ *   capacity of the map, which makes the write that hits that point pay
+ *   for it.  Do this work ahead of time while the device is idle, one
+ *   erase block worth of pages at a time, and stop when the collected
+ *   pages were all still in use.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DHARA_BGGC
+static void dhara_gc_worker(FAR void *arg)
+{
+  FAR dhara_dev_t *dev = arg;
+  dhara_sector_t limit;
+  dhara_page_t start;
+  dhara_page_t size;
+  dhara_error_t err;
+  int i;
+
+  nxmutex_lock(&dev->lock);
+
+  limit = dhara_map_capacity(&dev->map);
+  limit = limit > CONFIG_DHARA_BGGC_PAGES ?
+          limit - CONFIG_DHARA_BGGC_PAGES : 0;
+  start = size = dhara_journal_size(&dev->map.journal);
+
+  for (i = 0; i < dev->blkper && size >= limit; i++)
+    {
+      if (dhara_map_gc(&dev->map, &err) < 0)
+        {
+          ferr("Garbage collection failed err: %s\n", dhara_strerror(err));
+          break;
+        }
+
+      size = dhara_journal_size(&dev->map.journal);
+    }
+
+  nxmutex_unlock(&dev->lock);
+
+  /* Continue later if there is more to collect and this round made
+   * progress.
+   */
+
+  if (i == dev->blkper && size >= limit && size < start)
+    {
+      work_queue(LPWORK, &dev->work, dhara_gc_worker, dev, 0);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: dhara_schedule_gc
+ *
+ * Description:
+ *   (Re)start the idle timer of the background garbage collection after
+ *   the map has been modified.
+ *
+ ****************************************************************************/
+
+static void dhara_schedule_gc(FAR dhara_dev_t *dev)
+{
+#ifdef CONFIG_DHARA_BGGC
+  work_queue(LPWORK, &dev->work, dhara_gc_worker, dev,
+             MSEC2TICK(CONFIG_DHARA_BGGC_DELAY));
+#else
+  UNUSED(dev);
+#endif
+}
+
+/****************************************************************************
+ * Name: dhara_free
+ *
+ * Description: Free the device after the last close of an unlinked device
+ *
+ ****************************************************************************/
+
+static void dhara_free(FAR dhara_dev_t *dev)
+{
+#ifdef CONFIG_DHARA_BGGC
+  work_cancel_sync(LPWORK, &dev->work);
+#endif
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  rwb_uninitialize(&dev->rwb);
+#endif
+  nxmutex_destroy(&dev->lock);
+  dhara_deinit_readcache(dev);
+  kmm_free(dev->pagebuf);
+  kmm_free(dev);
+}
+
 /****************************************************************************
  * Name: dhara_open
  *
@@ -321,40 +432,37 @@ static int dhara_close(FAR struct inode *inode)
 
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
+
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  rwb_flush(&dev->rwb);
+#endif
+
   nxmutex_lock(&dev->lock);
   dev->refs--;
   nxmutex_unlock(&dev->lock);
 
   if (dev->refs == 0 && dev->unlinked)
     {
-      nxmutex_destroy(&dev->lock);
-      dhara_deinit_readcache(dev);
-      kmm_free(dev->pagebuf);
-      kmm_free(dev);
+      dhara_free(dev);
     }
 
   return 0;
 }
 
 /****************************************************************************
- * Name: dhara_read
+ * Name: dhara_reload
  *
- * Description:  Read the specified number of sectors
+ * Description:  Read the specified number of sectors from the map
  *
  ****************************************************************************/
 
-static ssize_t dhara_read(FAR struct inode *inode,
-                          FAR unsigned char *buffer,
-                          blkcnt_t start_sector,
-                          unsigned int nsectors)
+static ssize_t dhara_reload(FAR void *priv, FAR uint8_t *buffer,
+                            off_t start_sector, size_t nsectors)
 {
-  FAR dhara_dev_t *dev;
+  FAR dhara_dev_t *dev = priv;
   size_t nread = 0;
   int ret = 0;
 
-  DEBUGASSERT(inode->i_private);
-  dev = inode->i_private;
-
   nxmutex_lock(&dev->lock);
   while (nsectors-- > 0)
     {
@@ -381,24 +489,43 @@ static ssize_t dhara_read(FAR struct inode *inode,
 }
 
 /****************************************************************************
- * Name: dhara_write
+ * Name: dhara_read
  *
- * Description: Write (or buffer) the specified number of sectors
+ * Description:  Read the specified number of sectors
  *
  ****************************************************************************/
 
-static ssize_t dhara_write(FAR struct inode *inode,
-                           FAR const unsigned char *buffer,
-                           blkcnt_t start_sector,
-                           unsigned int nsectors)
+static ssize_t dhara_read(FAR struct inode *inode,
+                          FAR unsigned char *buffer,
+                          blkcnt_t start_sector,
+                          unsigned int nsectors)
 {
   FAR dhara_dev_t *dev;
-  size_t nwrite = 0;
-  int ret = 0;
 
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  return rwb_read(&dev->rwb, start_sector, nsectors, buffer);
+#else
+  return dhara_reload(dev, buffer, start_sector, nsectors);
+#endif
+}
+
+/****************************************************************************
+ * Name: dhara_flush
+ *
+ * Description: Write the specified number of sectors to the map
+ *
+ ****************************************************************************/
+
+static ssize_t dhara_flush(FAR void *priv, FAR const uint8_t *buffer,
+                           off_t start_sector, size_t nsectors)
+{
+  FAR dhara_dev_t *dev = priv;
+  size_t nwrite = 0;
+  int ret = 0;
+
   nxmutex_lock(&dev->lock);
   while (nsectors-- > 0)
     {
@@ -421,9 +548,112 @@ static ssize_t dhara_write(FAR struct inode *inode,
     }
 
   nxmutex_unlock(&dev->lock);
+  dhara_schedule_gc(dev);
   return nwrite ? nwrite : ret;
 }
 
+/****************************************************************************
+ * Name: dhara_write
+ *
+ * Description: Write (or buffer) the specified number of sectors
+ *
+ ****************************************************************************/
+
+static ssize_t dhara_write(FAR struct inode *inode,
+                           FAR const unsigned char *buffer,
+                           blkcnt_t start_sector,
+                           unsigned int nsectors)
+{
+  FAR dhara_dev_t *dev;
+
+  DEBUGASSERT(inode->i_private);
+  dev = inode->i_private;
+
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  return rwb_write(&dev->rwb, start_sector, nsectors, buffer);
+#else
+  return dhara_flush(dev, buffer, start_sector, nsectors);
+#endif
+}
+
+/****************************************************************************
+ * Name: dhara_trim
+ *
+ * Description: Drop the specified sectors from the map
+ *
+ ****************************************************************************/
+
+static int dhara_trim(FAR dhara_dev_t *dev,
+                      FAR const struct blk_trim_s *trim)
+{
+  dhara_sector_t sector;
+  dhara_error_t err;
+  int ret = 0;
+
+  if (trim == NULL ||
+      trim->startsector + trim->nsectors > dhara_map_capacity(&dev->map))
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  /* Write out the buffered sectors first, so that they can not bring a
+   * trimmed sector back later.
+   */
+
+  rwb_flush(&dev->rwb);
+#endif
+
+  nxmutex_lock(&dev->lock);
+  for (sector = trim->startsector;
+       sector < trim->startsector + trim->nsectors; sector++)
+    {
+      ret = dhara_map_trim(&dev->map, sector, &err);
+      if (ret < 0)
+        {
+          ret = dhara_convert_result(err);
+          ferr("Trim of block %lu failed err: %s\n",
+               (unsigned long)sector, dhara_strerror(err));
+          break;
+        }
+    }
+
+  nxmutex_unlock(&dev->lock);
+  dhara_schedule_gc(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dhara_sync
+ *
+ * Description: Flush the write buffer and checkpoint the map
+ *
+ ****************************************************************************/
+
+static int dhara_sync(FAR dhara_dev_t *dev)
+{
+  dhara_error_t err;
+  int ret = 0;
+
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  ret = rwb_flush(&dev->rwb);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
+  nxmutex_lock(&dev->lock);
+  if (dhara_map_sync(&dev->map, &err) < 0)
+    {
+      ret = dhara_convert_result(err);
+      ferr("Sync failed err: %s\n", dhara_strerror(err));
+    }
+
+  nxmutex_unlock(&dev->lock);
+  return ret;
+}
+
 /****************************************************************************
  * Name: dhara_geometry
  *
@@ -448,7 +678,6 @@ static int dhara_geometry(FAR struct inode *inode,
       geometry->geo_sectorsize   = dev->geo.blocksize;
 
       strcpy(geometry->geo_model, dev->geo.model);
-      nxmutex_unlock(&dev->lock);
       return 0;
     }
 
@@ -472,6 +701,16 @@ static int dhara_ioctl(FAR struct inode *inode,
   DEBUGASSERT(inode->i_private);
   dev = inode->i_private;
 
+  if (cmd == BIOC_FLUSH)
+    {
+      return dhara_sync(dev);
+    }
+  else if (cmd == BIOC_TRIM)
+    {
+      return dhara_trim(dev, (FAR const struct blk_trim_s *)
+                             (uintptr_t)arg);
+    }
+
   /* No other block driver ioctl commands are not recognized by this
    * driver.  Other possible MTD driver ioctl commands are passed through
    * to the MTD driver (unchanged).
@@ -506,10 +745,7 @@ static int dhara_unlink(FAR struct inode *inode)
 
   if (dev->refs == 0)
     {
-      nxmutex_destroy(&dev->lock);
-      dhara_deinit_readcache(dev);
-      kmm_free(dev->pagebuf);
-      kmm_free(dev);
+      dhara_free(dev);
     }
 
   return 0;
@@ -750,6 +986,24 @@ int dhara_initialize_by_path(FAR const char *path,
 
   dhara_map_resume(&dev->map, NULL);
 
+#ifdef CONFIG_DHARA_WRITEBUFFER
+  /* Configure write buffering */
+
+  dev->rwb.blocksize   = dev->geo.blocksize;
+  dev->rwb.nblocks     = dhara_map_capacity(&dev->map);
+  dev->rwb.dev         = (FAR void *)dev;
+  dev->rwb.wrflush     = dhara_flush;
+  dev->rwb.rhreload    = dhara_reload;
+  dev->rwb.wrmaxblocks = dev->blkper;
+
+  ret = rwb_initialize(&dev->rwb);
+  if (ret < 0)
+    {
+      ferr("rwb_initialize failed: %d\n", ret);
+      goto err;
+    }
+#endif
+
   /* Inode private data is a reference to the
    * DHARA_MTDBLOCK device structure
    */
@@ -758,6 +1012,9 @@ int dhara_initialize_by_path(FAR const char *path,
   if (ret < 0)
     {
       ferr("register_blockdriver failed: %d\n", ret);
+#ifdef CONFIG_DHARA_WRITEBUFFER
+      rwb_uninitialize(&dev->rwb);
+#endif
       goto err;
     }
 
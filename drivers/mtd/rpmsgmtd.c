@@ -398,8 +398,9 @@ static ssize_t rpmsgmtd_bwrite(FAR struct mtd_dev_s *dev, off_t startblock,
       startblock += msg->nblocks;
       written    += msg->nblocks;
 
-      ret = rpmsg_send_nocopy(&priv->ept, msg,
-                              sizeof(*msg) - 1 + msg->nblocks * blocksize);
+      ret = rpmsg_send_tx_payload(&priv->ept, msg,
+                                  sizeof(*msg) - 1 +
+                                  msg->nblocks * blocksize);
       if (ret < 0)
         {
           goto out;
@@ -543,7 +544,8 @@ static ssize_t rpmsgmtd_write(FAR struct mtd_dev_s *dev, off_t offset,
       msg->nbytes         = space;
       memcpy(msg->buf, buffer, space);
 
-      ret = rpmsg_send_nocopy(&priv->ept, msg, sizeof(*msg) - 1 + space);
+      ret = rpmsg_send_tx_payload(&priv->ept, msg,
+                                  sizeof(*msg) - 1 + space);
       if (ret < 0)
         {
           goto out;
@@ -744,7 +746,7 @@ static int rpmsgmtd_send_recv(FAR struct rpmsgmtd_s *priv,
     }
   else
     {
-      ret = rpmsg_send_nocopy(&priv->ept, msg, len);
+      ret = rpmsg_send_tx_payload(&priv->ept, msg, len);
     }
 
   if (ret < 0)
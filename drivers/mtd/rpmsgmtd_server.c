@@ -165,11 +165,10 @@ static int rpmsgmtd_bread_handler(FAR struct rpmsg_endpoint *ept,
                       rsp->buf);
 
       rsp->header.result = ret;
-      rpmsg_send_nocopy(ept, rsp, (ret < 0 ? 0 : ret * msg->blocksize) +
-                        sizeof(*rsp) - 1);
-      if (ret < 0)
+      if (rpmsg_send_tx_payload(ept, rsp,
+                                (ret < 0 ? 0 : ret * msg->blocksize) +
+                                sizeof(*rsp) - 1) < 0 || ret < 0)
         {
-          rpmsg_release_tx_buffer(ept, rsp);
           ferr("mtd block read failed\n");
           break;
         }
@@ -247,10 +246,10 @@ static int rpmsgmtd_read_handler(FAR struct rpmsg_endpoint *ept,
                      (FAR uint8_t *)rsp->buf);
 
       rsp->header.result = ret;
-      rpmsg_send_nocopy(ept, rsp, (ret < 0 ? 0 : ret) + sizeof(*rsp) - 1);
-      if (ret < 0)
+      space = (ret < 0 ? 0 : ret) + sizeof(*rsp) - 1;
+      if (rpmsg_send_tx_payload(ept, rsp, space) < 0 ||
+          ret < 0)
         {
-          rpmsg_release_tx_buffer(ept, rsp);
           break;
         }
 
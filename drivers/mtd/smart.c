@@ -45,6 +45,8 @@
 #include <nuttx/crc16.h>
 #include <nuttx/crc32.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mtd/mtd.h>
@@ -59,6 +61,12 @@
 #  define CONFIG_SMART_LOCAL_CHECKFREE
 #endif
 
+#ifdef CONFIG_MTD_SMART_BGGC
+#  define SMART_BGGC_WATERMARK(d) ((uint32_t)(d)->totalsectors * \
+                                   CONFIG_MTD_SMART_BGGC_WATERMARK / 100)
+#  define SMART_BGGC_DELAY        MSEC2TICK(CONFIG_MTD_SMART_BGGC_DELAY)
+#endif
+
 #define SMART_STATUS_COMMITTED    0x80
 #define SMART_STATUS_RELEASED     0x40
 #define SMART_STATUS_CRC          0x20
@@ -299,6 +307,10 @@ struct smart_struct_s
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
 #endif
+#ifdef CONFIG_MTD_SMART_BGGC
+  mutex_t               lock;             /* Serializes the ioctls and the collection */
+  struct work_s         gcwork;           /* Background garbage collection */
+#endif
 };
 
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
@@ -4014,6 +4026,55 @@ retry:
   return physicalsector;
 }
 
+/****************************************************************************
+ * Name: smart_find_collectblock
+ *
+ * Description:  Returns the erase block with the most released sectors and
+ *               their count in *released, or 0xffff if no block has any.
+ *
+ ****************************************************************************/
+
+static uint16_t smart_find_collectblock(FAR struct smart_struct_s *dev,
+                                        FAR uint16_t *released)
+{
+  uint16_t collectblock = 0xffff;
+  uint16_t releasemax = 0;
+  int x;
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+  uint8_t count;
+#endif
+
+  for (x = 0; x < dev->neraseblocks; x++)
+    {
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+      /* Don't collect blocks that have been worn completely */
+
+      if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+      count = smart_get_count(dev, dev->releasecount, x);
+      if (count > releasemax)
+        {
+          releasemax = count;
+          collectblock = x;
+        }
+#else
+      if (dev->releasecount[x] > releasemax)
+        {
+          releasemax = dev->releasecount[x];
+          collectblock = x;
+        }
+#endif
+    }
+
+  *released = releasemax;
+  return collectblock;
+}
+
 /****************************************************************************
  * Name: smart_garbagecollect
  *
@@ -4028,11 +4089,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
   uint16_t collectblock;
   uint16_t releasemax;
   bool collect = true;
-  int x;
   int ret;
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-  uint8_t count;
-#endif
 
   while (collect)
     {
@@ -4061,34 +4118,7 @@ static int smart_garbagecollect(FAR struct smart_struct_s *dev)
         {
           /* Find the block with the most released sectors */
 
-          collectblock = 0xffff;
-          releasemax = 0;
-          for (x = 0; x < dev->neraseblocks; x++)
-            {
-#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
-              /* Don't collect blocks that have been worn completely */
-
-              if (smart_get_wear_level(dev, x) >= SMART_WEAR_REORG_THRESHOLD)
-                {
-                  continue;
-                }
-#endif
-
-#ifdef CONFIG_MTD_SMART_PACK_COUNTS
-              count = smart_get_count(dev, dev->releasecount, x);
-              if (count > releasemax)
-                {
-                  releasemax = count;
-                  collectblock = x;
-                }
-#else
-              if (dev->releasecount[x] > releasemax)
-                {
-                  releasemax = dev->releasecount[x];
-                  collectblock = x;
-                }
-#endif
-            }
+          collectblock = smart_find_collectblock(dev, &releasemax);
 
 #if 0
           releasemax = smart_get_count(dev, dev->releasecount, collectblock);
@@ -5477,6 +5507,75 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_bggc_needed
+ *
+ * Description:  Tests if the free sectors are below the background
+ *               collection watermark and enough sectors were released to
+ *               gain at least half an erase block.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_BGGC
+static bool smart_bggc_needed(FAR struct smart_struct_s *dev)
+{
+  return dev->formatstatus == SMART_FMT_STAT_FORMATTED &&
+         dev->freesectors < SMART_BGGC_WATERMARK(dev) &&
+         dev->releasesectors >= (dev->availsectperblk >> 1);
+}
+
+/****************************************************************************
+ * Name: smart_bggc_work
+ *
+ * Description:  Collects one erase block on the low priority work queue and
+ *               queues itself again while the free sectors are still below
+ *               the watermark.  Only blocks with at least half of their
+ *               sectors released are worth relocating ahead of time, the
+ *               rest is left to smart_garbagecollect().
+ *
+ ****************************************************************************/
+
+static void smart_bggc_work(FAR void *arg)
+{
+  FAR struct smart_struct_s *dev = arg;
+  uint16_t collectblock;
+  uint16_t released;
+  bool again = false;
+
+  nxmutex_lock(&dev->lock);
+  if (smart_bggc_needed(dev))
+    {
+      collectblock = smart_find_collectblock(dev, &released);
+      if (collectblock != 0xffff &&
+          released >= (dev->availsectperblk >> 1))
+        {
+          finfo("Background collecting block %d, released=%d, "
+                "totalfree=%d\n", collectblock, released,
+                dev->freesectors);
+
+          if (smart_relocate_block(dev, collectblock) == OK)
+            {
+              again = smart_bggc_needed(dev);
+            }
+
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+          if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+            {
+              smart_write_wearstatus(dev);
+            }
+#endif
+        }
+    }
+
+  if (again)
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_work, dev, 0);
+    }
+
+  nxmutex_unlock(&dev->lock);
+}
+#endif
+
 /****************************************************************************
  * Name: smart_ioctl
  *
@@ -5502,6 +5601,12 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   dev = inode->i_private;
 #endif
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  /* The background collection changes the maps of the device too */
+
+  nxmutex_lock(&dev->lock);
+#endif
+
   /* Process the ioctl's we care about first, pass any we don't respond
    * to directly to the underlying MTD device.
    */
@@ -5641,6 +5746,20 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+#ifdef CONFIG_MTD_SMART_BGGC
+  /* Each operation below the watermark pushes the collection back, it runs
+   * once the device has been idle for a while.
+   */
+
+  if (smart_bggc_needed(dev))
+    {
+      work_queue(LPWORK, &dev->gcwork, smart_bggc_work, dev,
+                 SMART_BGGC_DELAY);
+    }
+
+  nxmutex_unlock(&dev->lock);
+#endif
+
   return ret;
 }
 
@@ -6183,6 +6302,9 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
       /* Initialize the SMART device structure */
 
       dev->mtd = mtd;
+#ifdef CONFIG_MTD_SMART_BGGC
+      nxmutex_init(&dev->lock);
+#endif
 
       /* Get the device geometry. (casting to uintptr_t first eliminates
        * complaints on some architectures where the sizeof long is different
@@ -6332,6 +6454,9 @@ errout:
     }
 #endif
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  nxmutex_destroy(&dev->lock);
+#endif
   kmm_free(dev);
   return ret;
 }
@@ -6461,6 +6586,11 @@ static int smart_loteardown(FAR const char *devname)
 
   close_blockdriver(inode);
 
+#ifdef CONFIG_MTD_SMART_BGGC
+  work_cancel_sync(LPWORK, &dev->gcwork);
+  nxmutex_destroy(&dev->lock);
+#endif
+
   /* Now teardown the filemtd */
 
   filemtd_teardown(dev->mtd);
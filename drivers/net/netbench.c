@@ -0,0 +1,668 @@
+/****************************************************************************
+ * drivers/net/netbench.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <net/if.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/udp.h>
+#include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/net/netbench.h>
+
+#ifdef CONFIG_NET_BENCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The generated flows are UDP datagrams from 198.18.0.1, the benchmarking
+ * network of RFC 2544, to the address of the device, port NETBENCH_PORT
+ * plus the index of the flow.
+ */
+
+#define NETBENCH_SRCADDR     HTONL(0xc6120001)
+#define NETBENCH_PORT        10000
+#define NETBENCH_MAXFLOWS    64
+
+#define NETBENCH_HDRLEN      (ETH_HDRLEN + IPv4_HDRLEN + UDP_HDRLEN)
+#define NETBENCH_MAXPAYLOAD  (CONFIG_NET_ETH_PKTSIZE - NETBENCH_HDRLEN)
+
+/* Sent packets are freed at once, the stack frees the received ones */
+
+#define NETBENCH_TXQUOTA     2
+#define NETBENCH_RXQUOTA     CONFIG_NET_BENCH_BURST
+
+/* The defaults of "start" */
+
+#define NETBENCH_COUNT       100000
+#define NETBENCH_PAYLOAD     64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The time spent in one stage */
+
+struct netbench_stage_s
+{
+  uint32_t packets;
+  clock_t  ticks;                 /* up_perf_gettime() ticks */
+};
+
+struct netbench_s
+{
+  struct netdev_lowerhalf_s dev;  /* Must be first */
+  struct work_s work;             /* Releases the next burst */
+
+  /* The run, protected by the lock of the network device */
+
+  bool     running;
+  bool     rxpending;             /* A packet is in the stack */
+  uint32_t count;                 /* Packets to generate */
+  uint32_t pps;                   /* Packets per second, 0 for no limit */
+  uint32_t credit;                /* Packets per second not yet sent */
+  uint32_t budget;                /* Packets left in the burst */
+  uint16_t flows;                 /* Number of destination ports */
+  uint16_t framelen;
+  uint16_t chksum[NETBENCH_MAXFLOWS];
+  uint8_t  frame[CONFIG_NET_ETH_PKTSIZE];
+
+  /* The results */
+
+  struct netbench_stage_s gen;    /* Allocate and fill the packets */
+  struct netbench_stage_s input;  /* The stack up to the socket */
+  struct netbench_stage_s tx;     /* Sink the sent packets */
+  uint32_t drops;                 /* No packet could be allocated */
+  int      iobmin;                /* Fewest free IOBs seen */
+  clock_t  rxlast;                /* When the last packet was returned */
+  clock_t  start;
+  clock_t  end;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int  netbench_ifup(FAR struct netdev_lowerhalf_s *dev);
+static int  netbench_ifdown(FAR struct netdev_lowerhalf_s *dev);
+static int  netbench_transmit(FAR struct netdev_lowerhalf_s *dev,
+                              FAR netpkt_t *pkt);
+static FAR netpkt_t *netbench_receive(FAR struct netdev_lowerhalf_s *dev);
+
+static ssize_t netbench_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+static ssize_t netbench_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct netdev_ops_s g_netbench_ops =
+{
+  .ifup     = netbench_ifup,
+  .ifdown   = netbench_ifdown,
+  .transmit = netbench_transmit,
+  .receive  = netbench_receive,
+};
+
+static const struct file_operations g_netbench_fops =
+{
+  NULL,           /* open */
+  NULL,           /* close */
+  netbench_read,  /* read */
+  netbench_write, /* write */
+};
+
+static FAR struct netbench_s *g_netbench;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_chksum
+ *
+ * Description:
+ *   Add data to the one's complement sum of 16-bit big endian words.
+ *
+ ****************************************************************************/
+
+static uint32_t netbench_chksum(uint32_t sum, FAR const uint8_t *data,
+                                size_t len)
+{
+  for (; len > 1; data += 2, len -= 2)
+    {
+      sum += ((uint32_t)data[0] << 8) | data[1];
+    }
+
+  if (len > 0)
+    {
+      sum += (uint32_t)data[0] << 8;
+    }
+
+  while ((sum >> 16) != 0)
+    {
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+
+  return sum;
+}
+
+/****************************************************************************
+ * Name: netbench_setup
+ *
+ * Description:
+ *   Build the frame of the flows with the payload len and the UDP checksum
+ *   of each flow.
+ *
+ ****************************************************************************/
+
+static void netbench_setup(FAR struct netbench_s *priv, uint16_t len)
+{
+  FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)priv->frame;
+  FAR struct ipv4_hdr_s *ip;
+  FAR struct udp_hdr_s *udp;
+  in_addr_t srcaddr = NETBENCH_SRCADDR;
+  uint16_t udplen = UDP_HDRLEN + len;
+  uint32_t sum;
+  int i;
+
+  ip  = (FAR struct ipv4_hdr_s *)(priv->frame + ETH_HDRLEN);
+  udp = (FAR struct udp_hdr_s *)(priv->frame + ETH_HDRLEN + IPv4_HDRLEN);
+
+  memset(priv->frame, 0, NETBENCH_HDRLEN);
+  memcpy(eth->dest, priv->dev.netdev.d_mac.ether.ether_addr_octet, 6);
+  eth->src[0] = 0x02;
+  eth->src[5] = 0x01;
+  eth->type   = HTONS(ETHTYPE_IP);
+
+  ip->vhl    = 0x45;
+  ip->len[0] = (IPv4_HDRLEN + udplen) >> 8;
+  ip->len[1] = (IPv4_HDRLEN + udplen) & 0xff;
+  ip->ttl    = 64;
+  ip->proto  = IP_PROTO_UDP;
+  memcpy(ip->srcipaddr, &srcaddr, sizeof(in_addr_t));
+  memcpy(ip->destipaddr, &priv->dev.netdev.d_ipaddr, sizeof(in_addr_t));
+  ip->ipchksum = HTONS(~netbench_chksum(0, (FAR uint8_t *)ip,
+                                        IPv4_HDRLEN) & 0xffff);
+
+  for (i = 0; i < len; i++)
+    {
+      priv->frame[NETBENCH_HDRLEN + i] = i;
+    }
+
+  udp->srcport = HTONS(NETBENCH_PORT);
+  udp->udplen  = HTONS(udplen);
+
+  for (i = 0; i < priv->flows; i++)
+    {
+      udp->destport = HTONS(NETBENCH_PORT + i);
+
+      sum = netbench_chksum(IP_PROTO_UDP + udplen,
+                            (FAR uint8_t *)ip->srcipaddr,
+                            2 * sizeof(in_addr_t));
+      sum = netbench_chksum(sum, (FAR uint8_t *)udp, udplen);
+      sum = ~sum & 0xffff;
+      priv->chksum[i] = HTONS(sum == 0 ? 0xffff : sum);
+    }
+
+  priv->framelen = NETBENCH_HDRLEN + len;
+}
+
+/****************************************************************************
+ * Name: netbench_work
+ *
+ * Description:
+ *   Release the next burst of packets, as many as the rate allows.
+ *
+ ****************************************************************************/
+
+static void netbench_work(FAR void *arg)
+{
+  FAR struct netbench_s *priv = arg;
+  uint32_t budget;
+
+  netdev_lock(&priv->dev.netdev);
+  if (!priv->running)
+    {
+      netdev_unlock(&priv->dev.netdev);
+      return;
+    }
+
+  if (priv->pps == 0)
+    {
+      budget = CONFIG_NET_BENCH_BURST;
+    }
+  else
+    {
+      priv->credit += priv->pps;
+      budget        = priv->credit / TICK_PER_SEC;
+      priv->credit -= budget * TICK_PER_SEC;
+      budget        = MIN(budget, CONFIG_NET_BENCH_BURST);
+    }
+
+  priv->budget = budget;
+  netdev_unlock(&priv->dev.netdev);
+
+  if (budget > 0)
+    {
+      netdev_lower_rxready(&priv->dev);
+    }
+  else
+    {
+      work_queue(LPWORK, &priv->work, netbench_work, priv, 1);
+    }
+}
+
+/****************************************************************************
+ * Name: netbench_ifup
+ ****************************************************************************/
+
+static int netbench_ifup(FAR struct netdev_lowerhalf_s *dev)
+{
+  netdev_lower_carrier_on(dev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_ifdown
+ ****************************************************************************/
+
+static int netbench_ifdown(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct netbench_s *priv = (FAR struct netbench_s *)dev;
+
+  priv->running = false;
+  work_cancel(LPWORK, &priv->work);
+  netdev_lower_carrier_off(dev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_transmit
+ *
+ * Description:
+ *   Sink a packet sent by the stack.
+ *
+ ****************************************************************************/
+
+static int netbench_transmit(FAR struct netdev_lowerhalf_s *dev,
+                             FAR netpkt_t *pkt)
+{
+  FAR struct netbench_s *priv = (FAR struct netbench_s *)dev;
+  clock_t start = up_perf_gettime();
+
+  netpkt_free(dev, pkt, NETPKT_TX);
+
+  priv->tx.packets++;
+  priv->tx.ticks += up_perf_gettime() - start;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: netbench_receive
+ *
+ * Description:
+ *   Generate the next packet of the burst.  The upper half passes each
+ *   packet to the stack before it asks for the next one, the time between
+ *   two calls is the input time of the stack.  A burst ends before the
+ *   receive budget of the upper half, so the input of the last packet is
+ *   timed by the call that ends the burst.
+ *
+ ****************************************************************************/
+
+static FAR netpkt_t *netbench_receive(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct netbench_s *priv = (FAR struct netbench_s *)dev;
+  FAR struct udp_hdr_s *udp;
+  FAR netpkt_t *pkt;
+  clock_t now = up_perf_gettime();
+  uint32_t flow;
+  int navail;
+
+  if (priv->rxpending)
+    {
+      priv->input.packets++;
+      priv->input.ticks += now - priv->rxlast;
+      priv->rxpending    = false;
+    }
+
+  if (!priv->running)
+    {
+      return NULL;
+    }
+
+  if (priv->gen.packets >= priv->count)
+    {
+      priv->running = false;
+      priv->end     = now;
+      return NULL;
+    }
+
+  if (priv->budget == 0)
+    {
+      if (work_available(&priv->work))
+        {
+          work_queue(LPWORK, &priv->work, netbench_work, priv,
+                     priv->pps > 0 ? 1 : 0);
+        }
+
+      return NULL;
+    }
+
+  pkt = netpkt_alloc(dev, NETPKT_RX);
+  if (pkt == NULL)
+    {
+      priv->drops++;
+      priv->budget = 0;
+      return NULL;
+    }
+
+  flow = priv->gen.packets % priv->flows;
+  udp  = (FAR struct udp_hdr_s *)(priv->frame + ETH_HDRLEN + IPv4_HDRLEN);
+  udp->destport  = HTONS(NETBENCH_PORT + flow);
+  udp->udpchksum = priv->chksum[flow];
+
+  if (netpkt_copyin(dev, pkt, priv->frame, priv->framelen, 0) < 0)
+    {
+      netpkt_free(dev, pkt, NETPKT_RX);
+      priv->drops++;
+      priv->budget = 0;
+      return NULL;
+    }
+
+  navail = iob_navail(false);
+  priv->iobmin = MIN(priv->iobmin, navail);
+  priv->budget--;
+
+  priv->rxpending    = true;
+  priv->rxlast       = up_perf_gettime();
+  priv->gen.packets++;
+  priv->gen.ticks   += priv->rxlast - now;
+  return pkt;
+}
+
+/****************************************************************************
+ * Name: netbench_start
+ ****************************************************************************/
+
+static int netbench_start(FAR struct netbench_s *priv, uint32_t count,
+                          uint32_t pps, uint32_t len, uint32_t flows)
+{
+  FAR struct net_driver_s *dev = &priv->dev.netdev;
+  int ret = OK;
+
+  if (count == 0 || len > NETBENCH_MAXPAYLOAD || flows == 0 ||
+      flows > NETBENCH_MAXFLOWS)
+    {
+      return -EINVAL;
+    }
+
+  netdev_lock(dev);
+  if (priv->running)
+    {
+      ret = -EBUSY;
+    }
+  else if (!IFF_IS_UP(dev->d_flags) || dev->d_ipaddr == 0)
+    {
+      ret = -ENETDOWN;
+    }
+  else
+    {
+      priv->count     = count;
+      priv->pps       = pps;
+      priv->flows     = flows;
+      priv->credit    = 0;
+      priv->budget    = 0;
+      priv->drops     = 0;
+      priv->rxpending = false;
+      memset(&priv->gen, 0, sizeof(priv->gen));
+      memset(&priv->input, 0, sizeof(priv->input));
+      memset(&priv->tx, 0, sizeof(priv->tx));
+      netbench_setup(priv, len);
+
+      priv->iobmin  = iob_navail(false);
+      priv->running = true;
+      priv->start   = up_perf_gettime();
+      priv->end     = priv->start;
+    }
+
+  netdev_unlock(dev);
+
+  if (ret >= 0)
+    {
+      work_queue(LPWORK, &priv->work, netbench_work, priv, 0);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: netbench_ns
+ ****************************************************************************/
+
+static uint64_t netbench_ns(clock_t ticks)
+{
+  struct timespec ts;
+
+  up_perf_convert(ticks, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: netbench_read
+ *
+ * Description:
+ *   Return the results of the last run, one line per value.  The stages
+ *   are "stage packets ticks ns".
+ *
+ ****************************************************************************/
+
+static ssize_t netbench_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct netbench_s *priv = g_netbench;
+  FAR const struct netbench_stage_s *stage;
+  FAR const char *name;
+  char buf[384];
+  clock_t elapsed;
+  size_t len;
+  int i;
+
+  netdev_lock(&priv->dev.netdev);
+  elapsed = (priv->running ? up_perf_gettime() : priv->end) - priv->start;
+
+  len = snprintf(buf, sizeof(buf),
+                 "# stage packets ticks ns\n");
+  for (i = 0; i < 3; i++)
+    {
+      stage = i == 0 ? &priv->gen : i == 1 ? &priv->input : &priv->tx;
+      name  = i == 0 ? "gen" : i == 1 ? "input" : "tx";
+      len  += snprintf(buf + len, sizeof(buf) - len,
+                       "%s %" PRIu32 " %" PRIu64 " %" PRIu64 "\n",
+                       name, stage->packets, (uint64_t)stage->ticks,
+                       netbench_ns(stage->ticks));
+    }
+
+  len += snprintf(buf + len, sizeof(buf) - len,
+                  "drops %" PRIu32 "\n"
+                  "iob_min %d\n"
+                  "elapsed_ns %" PRIu64 "\n"
+                  "running %d\n",
+                  priv->drops, priv->iobmin, netbench_ns(elapsed),
+                  priv->running);
+  netdev_unlock(&priv->dev.netdev);
+
+  len = MIN(len, sizeof(buf) - 1);
+  if (filep->f_pos >= len)
+    {
+      return 0;
+    }
+
+  buflen = MIN(buflen, len - filep->f_pos);
+  memcpy(buffer, buf + filep->f_pos, buflen);
+  filep->f_pos += buflen;
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: netbench_write
+ *
+ * Description:
+ *   Control the runs: "start [count [pps [len [flows]]]]" or "stop".
+ *
+ ****************************************************************************/
+
+static ssize_t netbench_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen)
+{
+  FAR struct netbench_s *priv = g_netbench;
+  unsigned long args[4];
+  char line[64];
+  FAR char *ptr;
+  FAR char *end;
+  size_t len;
+  int ret;
+  int i;
+
+  len = MIN(buflen, sizeof(line) - 1);
+  memcpy(line, buffer, len);
+  line[len] = '\0';
+
+  if (strncmp(line, "stop", 4) == 0)
+    {
+      netdev_lock(&priv->dev.netdev);
+      if (priv->running)
+        {
+          priv->running = false;
+          priv->end     = up_perf_gettime();
+        }
+
+      netdev_unlock(&priv->dev.netdev);
+      return buflen;
+    }
+
+  if (strncmp(line, "start", 5) != 0)
+    {
+      return -EINVAL;
+    }
+
+  args[0] = NETBENCH_COUNT;
+  args[1] = 0;
+  args[2] = NETBENCH_PAYLOAD;
+  args[3] = 1;
+
+  ptr = line + 5;
+  for (i = 0; i < nitems(args); i++)
+    {
+      unsigned long value = strtoul(ptr, &end, 0);
+      if (end == ptr)
+        {
+          break;
+        }
+
+      args[i] = value;
+      ptr     = end;
+    }
+
+  ret = netbench_start(priv, args[0], args[1], args[2], args[3]);
+  return ret < 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netbench_initialize
+ *
+ * Description:
+ *   Register the benchmark network device and its control device
+ *   /dev/netbench.
+ *
+ ****************************************************************************/
+
+int netbench_initialize(void)
+{
+  FAR struct netbench_s *priv;
+  FAR struct netdev_lowerhalf_s *dev;
+  int ret;
+
+  priv = kmm_zalloc(sizeof(struct netbench_s));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* A locally administered address, "NB" */
+
+  dev = &priv->dev;
+  dev->netdev.d_mac.ether.ether_addr_octet[0] = 0x02;
+  dev->netdev.d_mac.ether.ether_addr_octet[1] = 'N';
+  dev->netdev.d_mac.ether.ether_addr_octet[2] = 'B';
+
+  dev->ops              = &g_netbench_ops;
+  dev->quota[NETPKT_TX] = NETBENCH_TXQUOTA;
+  dev->quota[NETPKT_RX] = NETBENCH_RXQUOTA;
+
+  ret = netdev_lower_register(dev, NET_LL_ETHERNET);
+  if (ret < 0)
+    {
+      kmm_free(priv);
+      return ret;
+    }
+
+  g_netbench = priv;
+  ret = register_driver("/dev/netbench", &g_netbench_fops, 0666, NULL);
+  if (ret < 0)
+    {
+      netdev_lower_unregister(dev);
+      g_netbench = NULL;
+      kmm_free(priv);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_NET_BENCH */
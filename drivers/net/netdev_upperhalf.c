@@ -26,8 +26,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <debug.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -39,6 +41,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/net/vlan.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
@@ -51,6 +54,33 @@
 
 #define NETDEV_THREAD_NAME_FMT "netdev-%s"
 
+#if CONFIG_NETDEV_RX_BUDGET > 0
+#  define NETDEV_RX_BUDGET CONFIG_NETDEV_RX_BUDGET
+#else
+#  define NETDEV_RX_BUDGET INT_MAX
+#endif
+
+/* TSO packets may exceed the MTU, the hardware segments them */
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define netpkt_is_tso(pkt) \
+     ((netpkt_offload(pkt)->flags & NETPKT_TX_TSO) != 0)
+#else
+#  define netpkt_is_tso(pkt) false
+#endif
+
+#ifdef CONFIG_NETDEV_GRO
+#  define GRO_GET16(p) (((uint16_t)(p)[0] << 8) | (p)[1])
+#  define GRO_GET32(p) (((uint32_t)GRO_GET16(p) << 16) | GRO_GET16((p) + 2))
+#  define GRO_PUT16(p, v) \
+     do \
+       { \
+         (p)[0] = (uint8_t)((v) >> 8); \
+         (p)[1] = (uint8_t)(v); \
+       } \
+     while (0)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -88,6 +118,11 @@ struct netdev_upperhalf_s
 
   bool txing;
 
+  /* Packets collected for the next transmit_batch call */
+
+  FAR netpkt_t *txbatch[CONFIG_NETDEV_BATCH_SIZE];
+  int ntxbatch;
+
   /* Deferring process to work queue or thread */
 
   union
@@ -97,6 +132,20 @@ struct netdev_upperhalf_s
   };
 };
 
+#ifdef CONFIG_NETDEV_GRO
+/* The headers of a received TCP segment that may be coalesced */
+
+struct netdev_gro_s
+{
+  FAR uint8_t *l3;                 /* The IPv4 or IPv6 header */
+  FAR struct tcp_hdr_s *tcp;       /* The TCP header */
+  uint16_t l4off;                  /* Offset of the TCP header from l3 */
+  uint16_t hdrlen;                 /* Length of the L3 and TCP headers */
+  uint16_t paylen;                 /* Length of the TCP payload */
+  bool ipv4;                       /* IPv4, else IPv6 */
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -255,6 +304,65 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
   return quota > 0;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_txflush
+ *
+ * Description:
+ *   Hand the collected TX packets to the transmit_batch operation of the
+ *   lower half, on the TX queue of the current CPU.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *
+ * Returned Value:
+ *   OK if all packets were taken, otherwise a negated errno value.  The
+ *   packets that were not taken are dropped.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_txflush(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  int queue = 0;
+  int ret;
+  int i;
+
+  if (upper->ntxbatch == 0)
+    {
+      return OK;
+    }
+
+  if (NETDEV_NQUEUES(lower) > 1)
+    {
+      queue = this_cpu() % NETDEV_NQUEUES(lower);
+    }
+
+  ret = lower->ops->transmit_batch(lower, queue, upper->txbatch,
+                                   upper->ntxbatch);
+  for (i = ret < 0 ? 0 : ret; i < upper->ntxbatch; i++)
+    {
+      NETDEV_TXERRORS(&lower->netdev);
+      netpkt_free(lower, upper->txbatch[i], NETPKT_TX);
+    }
+
+  if (ret >= 0 && ret < upper->ntxbatch)
+    {
+      ret = -EBUSY;
+    }
+
+  upper->ntxbatch = 0;
+  if (ret < 0)
+    {
+      nerr("ERROR: Transmit failed: %d\n", ret);
+      return ret;
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: netdev_upper_txpoll
  *
@@ -299,11 +407,27 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
 
   pkt = netpkt_get(dev, NETPKT_TX);
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev) &&
+      !netpkt_is_tso(pkt))
     {
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
     }
+  else if (lower->ops->transmit_batch != NULL)
+    {
+      /* Collect the packet, the batch is sent once it is full or when
+       * the TX poll ends.
+       */
+
+      upper->txbatch[upper->ntxbatch++] = pkt;
+      if (upper->ntxbatch < CONFIG_NETDEV_BATCH_SIZE)
+        {
+          return NETDEV_TX_CONTINUE;
+        }
+
+      ret = netdev_upper_txflush(upper);
+      return ret < 0 ? ret : NETDEV_TX_CONTINUE;
+    }
   else
     {
       ret = lower->ops->transmit(lower, pkt);
@@ -389,6 +513,7 @@ static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
       upper->txing = true;
       while (netdev_upper_can_tx(upper) &&
              netdev_upper_tx(dev) == NETDEV_TX_CONTINUE);
+      netdev_upper_txflush(upper);
       upper->txing = false;
     }
 
@@ -413,8 +538,8 @@ static void netdev_upper_txavail_work(FAR struct netdev_upperhalf_s *upper)
     defined(CONFIG_DRIVERS_IEEE80211) || defined(CONFIG_NET_MBIM)
 static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
 {
-#if CONFIG_IOB_NCHAINS > 0
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
+#if CONFIG_IOB_NCHAINS > 0
   int ret;
 
   if ((ret = iob_tryadd_queue(dev->d_iob, &upper->txq)) >= 0)
@@ -427,9 +552,12 @@ static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
       nwarn("WARNING: Failed to queue TX packet, dropping: %d\n", ret);
     }
 #else
-  /* Fall back to send the packet directly if we don't have IOB queue. */
+  /* Fall back to send the packet directly if we don't have IOB queue.
+   * A packet collected for transmit_batch must be flushed right away.
+   */
 
   netdev_upper_txpoll(dev);
+  netdev_upper_txflush(upper);
 #endif
 }
 #endif
@@ -482,18 +610,22 @@ static void
 netdev_upper_vlan_foreach(FAR struct netdev_upperhalf_s *upper,
                           CODE void (*cb)(FAR struct netdev_lowerhalf_s *))
 {
+  FAR struct netdev_lowerhalf_s *vlan;
   int i;
 
-  net_lock();
+  /* This runs for every TX completion, so don't serialize on the global
+   * network lock.  The VLAN table is only changed when a VLAN device is
+   * registered or unregistered; read each entry once.
+   */
+
   for (i = 0; i < CONFIG_NET_VLAN_COUNT; i++)
     {
-      if (upper->vlan[i].dev)
+      vlan = upper->vlan[i].dev;
+      if (vlan != NULL)
         {
-          cb(upper->vlan[i].dev);
+          cb(vlan);
         }
     }
-
-  net_unlock();
 }
 #endif
 
@@ -688,91 +820,514 @@ static void ip_input(FAR struct net_driver_s *dev)
 #endif
 
 /****************************************************************************
- * Function: netdev_upper_rxpoll_work
+ * Function: netdev_upper_input
  *
  * Description:
- *   Try to receive packets from device and pass packets into IP
- *   stack and send packets which is from IP stack if necessary.
+ *   Pass one received packet into the network stack.
  *
  * Input Parameters:
  *   upper - Reference to the upper half driver structure
+ *   pkt   - The received packet
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static void netdev_upper_input(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt)
 {
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR struct net_driver_s       *dev   = &lower->netdev;
-  FAR netpkt_t                  *pkt;
-
-  /* Loop while receive() successfully retrieves valid Ethernet frames. */
 
-  netdev_lock(dev);
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  if (!IFF_IS_UP(dev->d_flags))
     {
-      if (!IFF_IS_UP(dev->d_flags))
-        {
-          /* Interface down, drop frame */
+      /* Interface down, drop frame */
 
-          NETDEV_RXDROPPED(dev);
-          netpkt_free(lower, pkt, NETPKT_RX);
-          nerr("ERROR: Dropped frame due to lower dev not up\n");
-          continue;
-        }
+      NETDEV_RXDROPPED(dev);
+      netpkt_free(lower, pkt, NETPKT_RX);
+      nerr("ERROR: Dropped frame due to lower dev not up\n");
+      return;
+    }
 
-      netpkt_put(dev, pkt, NETPKT_RX);
-      NETDEV_RXPACKETS(dev);
+  netpkt_put(dev, pkt, NETPKT_RX);
+  NETDEV_RXPACKETS(dev);
 
 #ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
+  /* When packet sockets are enabled, feed the frame into the tap */
 
-      pkt_input(dev);
+  pkt_input(dev);
 #endif
 
-      switch (dev->d_lltype)
-        {
+  switch (dev->d_lltype)
+    {
 #ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
+    case NET_LL_LOOPBACK:
 #endif
 #ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
+    case NET_LL_ETHERNET:
 #endif
 #ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
+    case NET_LL_IEEE80211:
 #endif
 #if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
     defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
+      eth_input(dev);
+      break;
 #endif
 #ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
+    case NET_LL_MBIM:
+      ip_input(dev);
+      break;
 #endif
 #ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+}
+
+#ifdef CONFIG_NETDEV_GRO
+/****************************************************************************
+ * Name: netdev_upper_gro_parse
+ *
+ * Description:
+ *   Find the headers of a received Ethernet frame that carries a plain TCP
+ *   segment: no IP options or fragmentation, some payload, only ACK and
+ *   possibly PSH set, and checksums that the hardware already verified.
+ *
+ * Returned Value:
+ *   true if the frame is such a segment and seg describes it.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro_parse(FAR struct netdev_lowerhalf_s *lower,
+                                   FAR netpkt_t *pkt,
+                                   FAR struct netdev_gro_s *seg)
+{
+  FAR struct eth_hdr_s *eth;
+  unsigned int iplen;
+  unsigned int tcplen;
+
+  if (lower->netdev.d_lltype != NET_LL_ETHERNET ||
+      (netpkt_offload(pkt)->flags & NETPKT_RX_CSUM_OK) == 0)
+    {
+      return false;
+    }
+
+  eth     = (FAR struct eth_hdr_s *)netpkt_getdata(lower, pkt);
+  seg->l3 = IOB_DATA(pkt);
+
+#ifdef CONFIG_NET_IPv4
+  if (eth->type == HTONS(ETHTYPE_IP))
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)seg->l3;
+
+      if (pkt->io_len < IPv4_HDRLEN + TCP_HDRLEN || ipv4->vhl != 0x45 ||
+          ipv4->proto != IP_PROTO_TCP ||
+          (GRO_GET16(ipv4->ipoffset) & ~IP_FLAG_DONTFRAG) != 0)
+        {
+          return false;
+        }
+
+      iplen      = GRO_GET16(ipv4->len);
+      seg->l4off = IPv4_HDRLEN;
+      seg->ipv4  = true;
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if (eth->type == HTONS(ETHTYPE_IP6))
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)seg->l3;
+
+      if (pkt->io_len < IPv6_HDRLEN + TCP_HDRLEN ||
+          (ipv6->vtc & IP_VERSION_MASK) != IPv6_VERSION ||
+          ipv6->proto != IP_PROTO_TCP)
+        {
+          return false;
+        }
+
+      iplen      = IPv6_HDRLEN + GRO_GET16(ipv6->len);
+      seg->l4off = IPv6_HDRLEN;
+      seg->ipv4  = false;
+    }
+  else
+#endif
+    {
+      return false;
+    }
+
+  /* Padded runt frames are not worth the trouble */
+
+  seg->tcp    = (FAR struct tcp_hdr_s *)(seg->l3 + seg->l4off);
+  tcplen      = (seg->tcp->tcpoffset >> 4) << 2;
+  seg->hdrlen = seg->l4off + tcplen;
+
+  if (tcplen < TCP_HDRLEN || pkt->io_len < seg->hdrlen ||
+      iplen != pkt->io_pktlen || iplen <= seg->hdrlen ||
+      (seg->tcp->flags & ~TCP_PSH) != TCP_ACK)
+    {
+      return false;
+    }
+
+  seg->paylen = iplen - seg->hdrlen;
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_merge
+ *
+ * Description:
+ *   Append the payload of pkt to held if pkt is the next in-order segment
+ *   of the same flow, with the same L2, IP and TCP headers except for the
+ *   lengths, the IPv4 identification, the sequence number and the
+ *   checksums.  Like LRO hardware, the merged packet keeps the TCP options
+ *   of the first segment and records its payload size in gsosize.
+ *
+ * Returned Value:
+ *   true if pkt was merged into held and must not be used any more.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro_merge(FAR struct netdev_lowerhalf_s *lower,
+                                   FAR netpkt_t *held, FAR netpkt_t *pkt)
+{
+  FAR struct iob_pktmeta_s *meta = netpkt_offload(held);
+  struct netdev_gro_s h;
+  struct netdev_gro_s s;
+  unsigned int iplen;
+  uint16_t gsosize;
+
+  if (!netdev_upper_gro_parse(lower, held, &h) ||
+      !netdev_upper_gro_parse(lower, pkt, &s) || h.ipv4 != s.ipv4 ||
+      h.hdrlen != s.hdrlen ||
+      (h.tcp->flags & TCP_PSH) != 0)
+    {
+      return false;
+    }
+
+  /* A segment shorter than the first one ends the merged packet */
+
+  gsosize = (meta->flags & NETPKT_RX_LRO) != 0 ? meta->gsosize : h.paylen;
+  iplen   = h.hdrlen + h.paylen + s.paylen;
+
+  if ((h.paylen % gsosize) != 0 || s.paylen > gsosize ||
+      iplen > CONFIG_NETDEV_GRO_MAXSIZE ||
+      GRO_GET32(h.tcp->seqno) + h.paylen != GRO_GET32(s.tcp->seqno))
+    {
+      return false;
+    }
+
+  if (memcmp(netpkt_getdata(lower, held), netpkt_getdata(lower, pkt),
+             ETH_HDRLEN) != 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (h.ipv4)
+    {
+      /* vhl and tos, then ttl, proto and the addresses */
+
+      if (memcmp(h.l3, s.l3, 2) != 0 ||
+          memcmp(h.l3 + 8, s.l3 + 8, 2) != 0 ||
+          memcmp(h.l3 + 12, s.l3 + 12, 8) != 0)
+        {
+          return false;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!h.ipv4)
+    {
+      /* The version, traffic class and flow label, then all but the
+       * payload length.
+       */
+
+      if (memcmp(h.l3, s.l3, 4) != 0 ||
+          memcmp(h.l3 + 6, s.l3 + 6, IPv6_HDRLEN - 6) != 0)
+        {
+          return false;
+        }
+    }
+#endif
+
+  /* The ports, the acknowledgment, offset, window, urgent pointer and
+   * options, all but the sequence number, flags and checksum.
+   */
+
+  if (memcmp(h.tcp, s.tcp, 4) != 0 ||
+      memcmp(h.tcp->ackno, s.tcp->ackno, 5) != 0 ||
+      memcmp(h.tcp->wnd, s.tcp->wnd, 2) != 0 ||
+      memcmp(h.tcp->urgp, s.tcp->urgp, h.hdrlen - h.l4off - 18) != 0)
+    {
+      return false;
+    }
+
+  h.tcp->flags |= s.tcp->flags & TCP_PSH;
+
+#ifdef CONFIG_NET_IPv4
+  if (h.ipv4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)h.l3;
+
+      GRO_PUT16(ipv4->len, iplen);
+      ipv4->ipchksum = 0;
+      ipv4->ipchksum = ~ipv4_chksum(ipv4);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!h.ipv4)
+    {
+      GRO_PUT16(((FAR struct ipv6_hdr_s *)h.l3)->len, iplen - IPv6_HDRLEN);
+    }
+#endif
+
+  meta->flags  |= NETPKT_RX_LRO;
+  meta->gsosize = gsosize;
+
+  /* The payload joins the chain of held, which the stack frees as one
+   * packet, so the buffer of pkt leaves the driver like a packet that was
+   * passed up.
+   */
+
+  iob_concat(held, iob_trimhead(pkt, s.hdrlen));
+  atomic_fetch_add(&lower->quota_ptr[NETPKT_RX], 1);
+  return true;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_input
+ *
+ * Description:
+ *   Merge a received packet into the packet held back in *held if
+ *   possible.  Otherwise pass the held packet up and hold this one, a
+ *   packet that cannot be merged at all is passed up at once.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_gro_input(FAR struct netdev_upperhalf_s *upper,
+                                   FAR netpkt_t **held, FAR netpkt_t *pkt)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  struct netdev_gro_s seg;
+
+  if (*held != NULL)
+    {
+      if (netdev_upper_gro_merge(lower, *held, pkt))
+        {
+          return;
+        }
+
+      netdev_upper_input(upper, *held);
+      *held = NULL;
+    }
+
+  if (IFF_IS_UP(lower->netdev.d_flags) &&
+      netdev_upper_gro_parse(lower, pkt, &seg) &&
+      (seg.tcp->flags & TCP_PSH) == 0)
+    {
+      *held = pkt;
+    }
+  else
+    {
+      netdev_upper_input(upper, pkt);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Function: netdev_upper_rxpoll_work
+ *
+ * Description:
+ *   Try to receive packets from device and pass packets into IP
+ *   stack and send packets which is from IP stack if necessary.
+ *
+ *   Lower halves with receive_batch are polled on the RX queues first,
+ *   first + stride, ... taking at most 'budget' packets from each queue.
+ *
+ * Input Parameters:
+ *   upper  - Reference to the upper half driver structure
+ *   first  - The first RX queue to poll
+ *   stride - The distance to the next RX queue to poll
+ *   budget - The maximum number of packets to take from one RX queue
+ *
+ * Returned Value:
+ *   true if the budget was used up on some queue, so more packets may be
+ *   pending.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper,
+                                     int first, int stride, int budget)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s       *dev   = &lower->netdev;
+  FAR netpkt_t                  *pkts[CONFIG_NETDEV_BATCH_SIZE];
+#ifdef CONFIG_NETDEV_GRO
+  FAR netpkt_t                  *held  = NULL;
+#endif
+  bool                           more  = false;
+  int                            count;
+  int                            queue;
+  int                            npkts;
+  int                            i;
+
+  netdev_lock(dev);
+  if (lower->ops->receive_batch == NULL)
+    {
+      /* Loop while receive() successfully retrieves valid frames. */
+
+      for (count = 0; count < budget; count++)
+        {
+          pkts[0] = lower->ops->receive(lower);
+          if (pkts[0] == NULL)
+            {
+              break;
+            }
+
+#ifdef CONFIG_NETDEV_GRO
+          netdev_upper_gro_input(upper, &held, pkts[0]);
+#else
+          netdev_upper_input(upper, pkts[0]);
+#endif
+        }
+
+      more = count >= budget;
+    }
+  else
+    {
+      for (queue = first; queue < NETDEV_NQUEUES(lower); queue += stride)
+        {
+          for (count = 0; count < budget; count += npkts)
+            {
+              npkts = MIN(budget - count, CONFIG_NETDEV_BATCH_SIZE);
+              npkts = lower->ops->receive_batch(lower, queue, pkts, npkts);
+              if (npkts <= 0)
+                {
+                  break;
+                }
+
+              for (i = 0; i < npkts; i++)
+                {
+#ifdef CONFIG_NETDEV_GRO
+                  netdev_upper_gro_input(upper, &held, pkts[i]);
+#else
+                  netdev_upper_input(upper, pkts[i]);
 #endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
+                }
+            }
+
+          more |= count >= budget;
         }
     }
 
+#ifdef CONFIG_NETDEV_GRO
+  /* The segments of a flow are coalesced until the end of the poll */
+
+  if (held != NULL)
+    {
+      netdev_upper_input(upper, held);
+    }
+#endif
+
   netdev_unlock(dev);
+  return more;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_poll
+ *
+ * Description:
+ *   Poll the RX queues first, first + stride, ... and then do TX.
+ *
+ * Input Parameters:
+ *   upper  - Reference to the upper half driver structure
+ *   first  - The first RX queue to poll
+ *   stride - The distance to the next RX queue to poll
+ *
+ * Returned Value:
+ *   true if the RX budget was used up and the poll should be repeated.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_poll(FAR struct netdev_upperhalf_s *upper,
+                              int first, int stride)
+{
+  bool more;
+
+  /* RX may release quota and driver buffer, so do RX first. */
+
+  more = netdev_upper_rxpoll_work(upper, first, stride, NETDEV_RX_BUDGET);
+  netdev_upper_txavail_work(upper);
+  return more;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_busypoll
+ *
+ * Description:
+ *   Receive the pending packets in the thread of a socket that busy polls.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+static int netdev_upper_busypoll(FAR struct net_driver_s *dev)
+{
+  netdev_upper_rxpoll_work(dev->d_private, 0, 1, NETDEV_RX_BUDGET);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_canfilter
+ *
+ * Description:
+ *   Program the acceptance filters of a CAN controller.
+ *
+ * Input Parameters:
+ *   dev      - Reference to the NuttX driver state structure
+ *   filters  - The CAN_RAW filters of the sockets of the device
+ *   nfilters - The number of filters, 0 to pass all frames
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+static int netdev_upper_canfilter(FAR struct net_driver_s *dev,
+                                  FAR const struct can_filter *filters,
+                                  int nfilters)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+
+  return upper->lower->ops->canfilter(upper->lower, filters, nfilters);
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_work
  *
  * Description:
- *   Perform an out-of-cycle poll on a dedicated thread or the worker thread.
+ *   Perform an out-of-cycle poll on the worker thread.
  *
  * Input Parameters:
  *   arg - Reference to the upper half driver structure (cast to void *)
@@ -783,17 +1338,22 @@ static void netdev_upper_work(FAR void *arg)
 {
   FAR struct netdev_upperhalf_s *upper = arg;
 
-  /* RX may release quota and driver buffer, so do RX first. */
+  if (netdev_upper_poll(upper, 0, 1))
+    {
+      /* The RX budget is used up, let other work run before continuing */
 
-  netdev_upper_rxpoll_work(upper);
-  netdev_upper_txavail_work(upper);
+      work_queue(upper->lower->priority, upper->work, netdev_upper_work,
+                 upper, 0);
+    }
 }
 
 /****************************************************************************
  * Name: netdev_upper_loop
  *
  * Description:
- *   The loop for dedicated thread.
+ *   The loop for dedicated thread.  The thread of CPU n in
+ *   NETDEV_RX_THREAD_RSS mode polls the RX queues n, n + CONFIG_SMP_NCPUS,
+ *   ...; otherwise all RX queues are polled.
  *
  ****************************************************************************/
 
@@ -803,6 +1363,8 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
     (FAR struct netdev_upperhalf_s *)((uintptr_t)strtoul(argv[1], NULL, 16));
   int cpu = atoi(argv[2]);
   FAR struct netdev_thread_s *t = &upper->thread[cpu];
+  int first = 0;
+  int stride = 1;
 
   if (upper->lower->rxtype == NETDEV_RX_THREAD_RSS)
     {
@@ -811,11 +1373,19 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
       CPU_ZERO(&cpuset);
       CPU_SET(cpu, &cpuset);
       sched_setaffinity(t->tid, sizeof(cpu_set_t), &cpuset);
+
+      first  = cpu;
+      stride = CONFIG_SMP_NCPUS;
     }
 
   while (nxsem_wait(&t->sem) == OK && t->tid != INVALID_PROCESS_ID)
     {
-      netdev_upper_work(upper);
+      /* Keep polling while the RX budget is used up, TX is served in
+       * between.
+       */
+
+      while (netdev_upper_poll(upper, first, stride) &&
+             t->tid != INVALID_PROCESS_ID);
     }
 
   nwarn("WARNING: Netdev work thread quitting.");
@@ -830,11 +1400,14 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
  *   Called when there is any work to do.
  *
  * Input Parameters:
- *   dev - Reference to the NuttX driver state structure
+ *   dev   - Reference to the NuttX driver state structure
+ *   queue - The RX queue with work to do, or -1 to use the thread of the
+ *           current CPU in NETDEV_RX_THREAD_RSS mode
  *
  ****************************************************************************/
 
-static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
+static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev,
+                                           int queue)
 {
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   int cpu = 0;
@@ -854,7 +1427,7 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
         }
         break;
       case NETDEV_RX_THREAD_RSS:
-        cpu = this_cpu();
+        cpu = queue < 0 ? this_cpu() : queue % CONFIG_SMP_NCPUS;
       case NETDEV_RX_THREAD:
         {
           FAR struct netdev_thread_s *t = &upper->thread[cpu];
@@ -1428,8 +2001,27 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 #endif
 #ifdef CONFIG_NETDEV_IOCTL
   dev->netdev.d_ioctl   = netdev_upper_ioctl;
+#endif
+#ifdef CONFIG_NET_BUSY_POLL
+  /* Packets are received in interrupt context with NETDEV_RX_DIRECT */
+
+  if (dev->rxtype != NETDEV_RX_DIRECT)
+    {
+      dev->netdev.d_busypoll = netdev_upper_busypoll;
+    }
+
+#endif
+#ifdef CONFIG_NET_CAN_HWFILTER
+  if (dev->ops->canfilter != NULL)
+    {
+      dev->netdev.d_canfilter = netdev_upper_canfilter;
+    }
+
 #endif
   dev->netdev.d_private = upper;
+#ifdef CONFIG_NETDEV_OFFLOAD
+  dev->netdev.d_features = dev->features;
+#endif
 
   ret = netdev_register(&dev->netdev, lltype);
   if (ret < 0)
@@ -1585,11 +2177,41 @@ void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 
   if (dev->rxtype == NETDEV_RX_DIRECT)
     {
-      netdev_upper_rxpoll_work(dev->netdev.d_private);
+      netdev_upper_rxpoll_work(dev->netdev.d_private, 0, 1, INT_MAX);
+    }
+  else
+    {
+      netdev_upper_queue_work(&dev->netdev, -1);
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer that packets are ready to read on one RX
+ *   queue.  In NETDEV_RX_THREAD_RSS mode, only the thread serving that
+ *   queue is woken up.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The RX queue
+ *
+ ****************************************************************************/
+
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue)
+{
+  DEBUGASSERT(queue >= 0 && queue < NETDEV_NQUEUES(dev));
+
+  if (dev->rxtype == NETDEV_RX_DIRECT)
+    {
+      netdev_upper_rxpoll_work(dev->netdev.d_private, queue,
+                               NETDEV_NQUEUES(dev), INT_MAX);
     }
   else
     {
-      netdev_upper_queue_work(&dev->netdev);
+      netdev_upper_queue_work(&dev->netdev, queue);
     }
 }
 
@@ -1616,7 +2238,7 @@ void netdev_lower_txdone(FAR struct netdev_lowerhalf_s *dev)
     }
   else
     {
-      netdev_upper_queue_work(&dev->netdev);
+      netdev_upper_queue_work(&dev->netdev, -1);
     }
 
   NETDEV_TXDONE(&dev->netdev);
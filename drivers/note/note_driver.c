@@ -39,6 +39,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/note/note_driver.h>
 #include <nuttx/note/noteram_driver.h>
+#include <nuttx/note/notemmap_driver.h>
 #include <nuttx/note/notelog_driver.h>
 #include <nuttx/note/notestream_driver.h>
 #include <nuttx/spinlock.h>
@@ -53,7 +54,8 @@
 
 #if defined(CONFIG_DRIVERS_NOTERAM) +  defined(CONFIG_DRIVERS_NOTELOG) + \
     defined(CONFIG_DRIVERS_NOTESNAP) + defined(CONFIG_DRIVERS_NOTERTT) + \
-    defined(CONFIG_SEGGER_SYSVIEW) > CONFIG_DRIVERS_NOTE_MAX
+    defined(CONFIG_SEGGER_SYSVIEW) + defined(CONFIG_DRIVERS_NOTEMMAP) > \
+    CONFIG_DRIVERS_NOTE_MAX
 #  error "Maximum channel number exceeds. "
 #endif
 
@@ -154,6 +156,9 @@ FAR static struct note_driver_s *
 #ifdef CONFIG_DRIVERS_NOTERAM
   (FAR struct note_driver_s *)&g_noteram_driver,
 #endif
+#ifdef CONFIG_DRIVERS_NOTEMMAP
+  (FAR struct note_driver_s *)&g_notemmap_driver,
+#endif
 #ifdef CONFIG_DRIVERS_NOTELOG
   (FAR struct note_driver_s *)&g_notelog_driver,
 #endif
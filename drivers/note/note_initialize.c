@@ -29,6 +29,7 @@
 #include <nuttx/instrument.h>
 #include <nuttx/note/note_driver.h>
 #include <nuttx/note/noteram_driver.h>
+#include <nuttx/note/notemmap_driver.h>
 #include <nuttx/note/notectl_driver.h>
 #include <nuttx/note/notesnap_driver.h>
 #include <nuttx/note/notestream_driver.h>
@@ -158,6 +159,15 @@ int note_initialize(void)
     }
 #endif
 
+#ifdef CONFIG_DRIVERS_NOTEMMAP
+  ret = notemmap_register();
+  if (ret < 0)
+    {
+      serr("notemmap_register failed %d\n", ret);
+      return ret;
+    }
+#endif
+
 #ifdef CONFIG_DRIVERS_NOTEFILE
   ret = notefile_register(CONFIG_DRIVERS_NOTEFILE_PATH);
   if (ret < 0)
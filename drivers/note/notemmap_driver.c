@@ -0,0 +1,282 @@
+/****************************************************************************
+ * drivers/note/notemmap_driver.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/note/note_driver.h>
+#include <nuttx/note/notemmap_driver.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NCPUS         CONFIG_SMP_NCPUS
+#define NOTEMMAP_SIZE CONFIG_DRIVERS_NOTEMMAP_BUFSIZE
+#define NOTEMMAP_MASK (NOTEMMAP_SIZE - 1)
+
+#if (NOTEMMAP_SIZE & NOTEMMAP_MASK) != 0 || \
+    NOTEMMAP_SIZE < NOTEMMAP_PAGE_ALIGN
+#  error "CONFIG_DRIVERS_NOTEMMAP_BUFSIZE must be a power of two >= 64"
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The control page and the data of one CPU, as seen by the reader */
+
+struct notemmap_ring_s
+{
+  struct notemmap_page_s page;
+  uint8_t data[NOTEMMAP_SIZE];
+};
+
+struct notemmap_driver_s
+{
+  struct note_driver_s driver;
+  FAR struct notemmap_ring_s *ring;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int notemmap_mmap(FAR struct file *filep,
+                         FAR struct mm_map_entry_s *map);
+static void notemmap_add(FAR struct note_driver_s *drv,
+                         FAR const void *note, size_t len);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_notemmap_fops =
+{
+  NULL,          /* open */
+  NULL,          /* close */
+  NULL,          /* read */
+  NULL,          /* write */
+  NULL,          /* seek */
+  NULL,          /* ioctl */
+  notemmap_mmap, /* mmap */
+};
+
+/* The page is a multiple of NOTEMMAP_PAGE_ALIGN bytes and the data size
+ * a larger power of two, so every ring of the array stays aligned.
+ */
+
+static struct notemmap_ring_s g_notemmap_ring[NCPUS]
+  aligned_data(NOTEMMAP_PAGE_ALIGN);
+
+static const struct note_driver_ops_s g_notemmap_ops =
+{
+  notemmap_add
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct notemmap_driver_s g_notemmap_driver =
+{
+  {
+#ifdef CONFIG_SCHED_INSTRUMENTATION_FILTER
+    "mmap",
+    {
+      {
+        CONFIG_SCHED_INSTRUMENTATION_FILTER_DEFAULT_MODE,
+#  ifdef CONFIG_SMP
+        CONFIG_SCHED_INSTRUMENTATION_CPUSET
+#  endif
+      },
+    },
+#endif
+    &g_notemmap_ops
+  },
+  g_notemmap_ring
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_BUILD_KERNEL
+static int notemmap_munmap(FAR struct task_group_s *group,
+                           FAR struct mm_map_entry_s *entry,
+                           FAR void *start, size_t length)
+{
+  if (group && entry)
+    {
+      vm_unmap_region(entry->vaddr, entry->length);
+      mm_map_remove(get_current_mm(), entry);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: notemmap_mmap
+ *
+ * Description:
+ *   Map the rings of all CPUs.  The mapping must be writable, since the
+ *   reader returns the consumed space by storing data_tail.
+ *
+ ****************************************************************************/
+
+static int notemmap_mmap(FAR struct file *filep,
+                         FAR struct mm_map_entry_s *map)
+{
+  FAR struct notemmap_driver_s *drv = filep->f_inode->i_private;
+  size_t size = sizeof(g_notemmap_ring);
+
+  if (map->offset >= 0 && map->offset < size &&
+      map->length && map->offset + map->length <= size)
+    {
+#ifdef CONFIG_BUILD_KERNEL
+      map->vaddr = vm_map_region((uintptr_t)drv->ring + map->offset,
+                                 size);
+      map->length = size;
+      map->munmap = notemmap_munmap;
+      mm_map_add(get_current_mm(), map);
+#else
+      map->vaddr = (FAR char *)drv->ring + map->offset;
+#endif
+      return OK;
+    }
+
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: notemmap_add
+ *
+ * Description:
+ *   Append a note to the ring of this CPU.  Each ring has exactly one
+ *   writer, the CPU itself with interrupts disabled, and one reader that
+ *   only moves data_tail, so no lock is taken and CPUs never contend.
+ *
+ * Input Parameters:
+ *   drv  - The note driver
+ *   note - The note to add
+ *   len  - The length of the note
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void notemmap_add(FAR struct note_driver_s *drv,
+                         FAR const void *note, size_t len)
+{
+  FAR struct notemmap_ring_s *ring;
+  FAR const uint8_t *src = note;
+  irqstate_t flags;
+  uint32_t head;
+  uint32_t tail;
+  size_t space;
+  size_t off;
+  size_t n;
+
+  space = NOTE_ALIGN(len);
+  flags = up_irq_save();
+  ring  = &((FAR struct notemmap_driver_s *)drv)->ring[this_cpu()];
+  head  = ring->page.data_head;
+  tail  = ring->page.data_tail;
+
+  /* Drop the note if the reader has not freed enough space.  The reader
+   * stores data_tail only after it has finished reading, so the space
+   * below it may be overwritten right away.
+   */
+
+  if (space > NOTEMMAP_SIZE - (uint32_t)(head - tail))
+    {
+      ring->page.lost++;
+      up_irq_restore(flags);
+      return;
+    }
+
+  off = head & NOTEMMAP_MASK;
+  n   = MIN(len, NOTEMMAP_SIZE - off);
+  memcpy(&ring->data[off], src, n);
+  memcpy(ring->data, src + n, len - n);
+
+  /* Make the note visible before the new head */
+
+  UP_WMB();
+  ring->page.data_head = head + space;
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notemmap_register
+ *
+ * Description:
+ *   Register the mmap note driver at /dev/note/mmap.  An application maps
+ *   the per-CPU rings into its address space and consumes the note data
+ *   in place, without any system call per note.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int notemmap_register(void)
+{
+  int i;
+
+  for (i = 0; i < NCPUS; i++)
+    {
+      FAR struct notemmap_page_s *page = &g_notemmap_ring[i].page;
+
+      page->cpu         = i;
+      page->data_offset = offsetof(struct notemmap_ring_s, data);
+      page->data_size   = NOTEMMAP_SIZE;
+      page->magic       = NOTEMMAP_MAGIC;
+    }
+
+  return register_driver("/dev/note/mmap", &g_notemmap_fops, 0666,
+                         &g_notemmap_driver);
+}
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/types.h>
 #include <sched.h>
 #include <fcntl.h>
@@ -37,6 +38,7 @@
 #include <poll.h>
 
 #include <nuttx/spinlock.h>
+#include <nuttx/clock.h>
 #include <nuttx/sched.h>
 #include <nuttx/sched_note.h>
 #include <nuttx/kmalloc.h>
@@ -78,6 +80,24 @@
 #  define TASK_NAME_SIZE 16
 #endif
 
+/* The largest compact header: type, CPU and priority bytes, then the PID,
+ * the timestamp delta and the payload length as varints.
+ */
+
+#define NOTERAM_COMPACT_HDRSIZE  (3 + 5 + 10 + 2)
+
+/* With the compact format, the name of NOTE_START is only recorded if it
+ * can be found again through note_get_taskname() when the note is read.
+ * Notes forwarded from a remote CPU carry foreign PIDs and keep their name.
+ */
+
+#if defined(CONFIG_DRIVERS_NOTERAM_COMPACT) && CONFIG_TASK_NAME_SIZE > 0 && \
+    defined(CONFIG_SCHED_INSTRUMENTATION_SWITCH) && \
+    CONFIG_DRIVERS_NOTE_TASKNAME_BUFSIZE > 0 && \
+    !defined(CONFIG_DRIVERS_NOTERPMSG_SERVER)
+#  define NOTERAM_COMPACT_TASKNAME
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -93,6 +113,16 @@ struct noteram_driver_s
   volatile unsigned int ni_read;
   spinlock_t lock;
   FAR struct pollfd *pfd;
+#ifdef CONFIG_DRIVERS_NOTERAM_COMPACT
+
+  /* Timestamp of the last note of each CPU before the head, the tail and
+   * the read index, the bases of the timestamp deltas at these indices.
+   */
+
+  clock_t ni_headtime[NCPUS];
+  clock_t ni_tailtime[NCPUS];
+  clock_t ni_readtime[NCPUS];
+#endif
 };
 
 /* The structure to hold the context data of trace dump */
@@ -211,6 +241,10 @@ static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
 {
   drv->ni_tail = drv->ni_head;
   drv->ni_read = drv->ni_head;
+#ifdef CONFIG_DRIVERS_NOTERAM_COMPACT
+  memcpy(drv->ni_tailtime, drv->ni_headtime, sizeof(drv->ni_headtime));
+  memcpy(drv->ni_readtime, drv->ni_headtime, sizeof(drv->ni_headtime));
+#endif
 
   if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
     {
@@ -300,6 +334,237 @@ static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
   return head - read;
 }
 
+/****************************************************************************
+ * Name: noteram_copyin
+ *
+ * Description:
+ *   Copy data into the circular buffer at the specified index, handling
+ *   wraparound
+ *
+ * Input Parameters:
+ *   ndx - The circular buffer index to copy to
+ *   buf - The data to copy
+ *   len - The length of the data
+ *
+ * Returned Value:
+ *   The circular buffer index following the data
+ *
+ ****************************************************************************/
+
+static unsigned int noteram_copyin(FAR struct noteram_driver_s *drv,
+                                   unsigned int ndx, FAR const void *buf,
+                                   size_t len)
+{
+  size_t space = drv->ni_bufsize - ndx;
+
+  space = space < len ? space : len;
+  memcpy(drv->ni_buffer + ndx, buf, space);
+  memcpy(drv->ni_buffer, (FAR const uint8_t *)buf + space, len - space);
+  return noteram_next(drv, ndx, len);
+}
+
+#ifdef CONFIG_DRIVERS_NOTERAM_COMPACT
+
+/****************************************************************************
+ * Name: noteram_putvarint
+ *
+ * Description:
+ *   Encode a value as a little endian base 128 varint: seven bits per byte,
+ *   with the top bit set in all bytes but the last one.
+ *
+ * Input Parameters:
+ *   buf   - The buffer to encode to
+ *   value - The value to encode
+ *
+ * Returned Value:
+ *   The number of bytes written
+ *
+ ****************************************************************************/
+
+static size_t noteram_putvarint(FAR uint8_t *buf, uint64_t value)
+{
+  size_t len = 0;
+
+  while (value >= 0x80)
+    {
+      buf[len++] = (uint8_t)value | 0x80;
+      value >>= 7;
+    }
+
+  buf[len++] = (uint8_t)value;
+  return len;
+}
+
+/****************************************************************************
+ * Name: noteram_getvarint
+ *
+ * Description:
+ *   Decode a varint from the circular buffer at the specified index.
+ *
+ * Input Parameters:
+ *   ndx   - The circular buffer index of the varint
+ *   value - Location to return the decoded value
+ *
+ * Returned Value:
+ *   The circular buffer index following the varint
+ *
+ ****************************************************************************/
+
+static unsigned int noteram_getvarint(FAR struct noteram_driver_s *drv,
+                                      unsigned int ndx,
+                                      FAR uint64_t *value)
+{
+  unsigned int shift = 0;
+  uint64_t result = 0;
+  uint8_t byte;
+
+  do
+    {
+      byte    = drv->ni_buffer[ndx];
+      ndx     = noteram_next(drv, ndx, 1);
+      result |= (uint64_t)(byte & 0x7f) << shift;
+      shift  += 7;
+    }
+  while ((byte & 0x80) != 0);
+
+  *value = result;
+  return ndx;
+}
+
+/****************************************************************************
+ * Name: noteram_compact_encode
+ *
+ * Description:
+ *   Encode the common header of a note in the compact format:
+ *
+ *     uint8_t type, uint8_t cpu, uint8_t priority,
+ *     varint pid, zigzag varint timestamp delta, varint payload length
+ *
+ *   The timestamp delta is relative to the previous note of the same CPU,
+ *   and may be negative if an interrupt added its note first.
+ *
+ * Input Parameters:
+ *   note    - The note to encode
+ *   payload - The length of the note data following the common header
+ *   hdr     - The buffer for the compact header
+ *
+ * Returned Value:
+ *   The length of the compact header
+ *
+ ****************************************************************************/
+
+static size_t noteram_compact_encode(FAR struct noteram_driver_s *drv,
+                                     FAR const struct note_common_s *note,
+                                     size_t payload, FAR uint8_t *hdr)
+{
+  int64_t delta = (sclock_t)(note->nc_systime -
+                             drv->ni_headtime[note->nc_cpu % NCPUS]);
+  size_t len = 3;
+
+  hdr[0] = note->nc_type;
+  hdr[1] = note->nc_cpu;
+  hdr[2] = note->nc_priority;
+  len += noteram_putvarint(&hdr[len], (uint32_t)note->nc_pid);
+  len += noteram_putvarint(&hdr[len],
+                           ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+  len += noteram_putvarint(&hdr[len], payload);
+
+  DEBUGASSERT(len <= NOTERAM_COMPACT_HDRSIZE);
+  return len;
+}
+
+/****************************************************************************
+ * Name: noteram_compact_decode
+ *
+ * Description:
+ *   Decode the compact header at the specified index back into a common
+ *   note header, and advance the timestamp base of its CPU.
+ *
+ * Input Parameters:
+ *   ndx     - The circular buffer index of the compact header
+ *   time    - The per-CPU timestamp bases at this index
+ *   note    - Location to return the common header, except nc_length
+ *   payload - Location to return the length of the note data
+ *
+ * Returned Value:
+ *   The circular buffer index of the note data
+ *
+ ****************************************************************************/
+
+static unsigned int
+noteram_compact_decode(FAR struct noteram_driver_s *drv, unsigned int ndx,
+                       FAR clock_t *time, FAR struct note_common_s *note,
+                       FAR size_t *payload)
+{
+  uint64_t value;
+
+  note->nc_type     = drv->ni_buffer[ndx];
+  ndx               = noteram_next(drv, ndx, 1);
+  note->nc_cpu      = drv->ni_buffer[ndx];
+  ndx               = noteram_next(drv, ndx, 1);
+  note->nc_priority = drv->ni_buffer[ndx];
+  ndx               = noteram_next(drv, ndx, 1);
+
+  ndx = noteram_getvarint(drv, ndx, &value);
+  note->nc_pid = (pid_t)value;
+
+  ndx = noteram_getvarint(drv, ndx, &value);
+  time += note->nc_cpu % NCPUS;
+  *time += (clock_t)((value >> 1) ^ (0 - (value & 1)));
+  note->nc_systime = *time;
+
+  ndx = noteram_getvarint(drv, ndx, &value);
+  *payload = value;
+  return ndx;
+}
+
+/****************************************************************************
+ * Name: noteram_compact_taskname
+ *
+ * Description:
+ *   Restore the task name of a NOTE_START note that was stored without it.
+ *   This is done after the buffer lock is released, since the name lookup
+ *   may have to enter the critical section.
+ *
+ * Input Parameters:
+ *   buffer  - The note returned by noteram_get()
+ *   buflen  - The length of the buffer
+ *   notelen - The length of the note
+ *
+ * Returned Value:
+ *   The length of the note including the task name
+ *
+ ****************************************************************************/
+
+#ifdef NOTERAM_COMPACT_TASKNAME
+static ssize_t noteram_compact_taskname(FAR uint8_t *buffer, size_t buflen,
+                                        ssize_t notelen)
+{
+  FAR struct note_common_s *note = (FAR struct note_common_s *)buffer;
+  FAR char *buf = (FAR char *)(note + 1);
+  FAR char *name;
+
+  if (notelen != sizeof(struct note_common_s) ||
+      note->nc_type != NOTE_START ||
+      buflen <= sizeof(struct note_common_s))
+    {
+      return notelen;
+    }
+
+  buflen = MIN(buflen - sizeof(struct note_common_s), TASK_NAME_SIZE);
+  name = note_get_taskname(note->nc_pid, buf, buflen);
+  if (name != buf)
+    {
+      strlcpy(buf, name, buflen);
+    }
+
+  notelen += strlen(buf) + 1;
+  note->nc_length = notelen;
+  return notelen;
+}
+#endif
+#endif /* CONFIG_DRIVERS_NOTERAM_COMPACT */
+
 /****************************************************************************
  * Name: noteram_remove
  *
@@ -321,12 +586,36 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
 {
   unsigned int tail;
   unsigned int length;
+#ifdef CONFIG_DRIVERS_NOTERAM_COMPACT
+  struct note_common_s note;
+  size_t payload;
+  int cpu;
+#endif
 
   /* Get the tail index of the circular buffer */
 
   tail = drv->ni_tail;
   DEBUGASSERT(tail < drv->ni_bufsize);
 
+#ifdef CONFIG_DRIVERS_NOTERAM_COMPACT
+  /* Decode the compact header to step over the note and to keep the
+   * timestamp base of the tail up to date.
+   */
+
+  tail = noteram_compact_decode(drv, tail, drv->ni_tailtime, &note,
+                                &payload);
+  tail = noteram_next(drv, tail, payload);
+  cpu  = note.nc_cpu % NCPUS;
+
+  if (drv->ni_read == drv->ni_tail)
+    {
+      drv->ni_read = tail;
+      drv->ni_readtime[cpu] = drv->ni_tailtime[cpu];
+    }
+
+  drv->ni_tail = tail;
+#else
+
   /* Get the length of the note at the tail index */
 
   length = NOTE_ALIGN(drv->ni_buffer[tail]);
@@ -344,6 +633,7 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
     }
 
   drv->ni_tail = noteram_next(drv, tail, length);
+#endif
 }
 
 /****************************************************************************
@@ -366,11 +656,16 @@ static void noteram_remove(FAR struct noteram_driver_s *drv)
 static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
                            FAR uint8_t *buffer, size_t buflen)
 {
-  FAR struct note_common_s *note;
   unsigned int remaining;
   unsigned int read;
   ssize_t notelen;
   size_t circlen;
+#ifdef CONFIG_DRIVERS_NOTERAM_COMPACT
+  struct note_common_s cmn;
+  size_t payload;
+#else
+  FAR struct note_common_s *note;
+#endif
 
   DEBUGASSERT(buffer != NULL);
 
@@ -387,6 +682,25 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
   read = drv->ni_read;
   DEBUGASSERT(read < drv->ni_bufsize);
 
+#ifdef CONFIG_DRIVERS_NOTERAM_COMPACT
+  /* Expand the compact header into the common note header */
+
+  read = noteram_compact_decode(drv, read, drv->ni_readtime, &cmn,
+                                &payload);
+  drv->ni_read = noteram_next(drv, read, payload);
+
+  notelen = sizeof(struct note_common_s) + payload;
+  if (buflen < notelen)
+    {
+      return -EFBIG;
+    }
+
+  cmn.nc_length = notelen;
+  memcpy(buffer, &cmn, sizeof(cmn));
+  buffer += sizeof(cmn);
+
+  remaining = payload;
+#else
   /* Get the length of the note at the read index */
 
   note = (FAR struct note_common_s *)&drv->ni_buffer[read];
@@ -406,9 +720,12 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
       return -EFBIG;
     }
 
+  remaining = (unsigned int)notelen;
+  drv->ni_read = noteram_next(drv, read, NOTE_ALIGN(notelen));
+#endif
+
   /* Loop until the note has been transferred to the user buffer */
 
-  remaining = (unsigned int)notelen;
   while (remaining > 0)
     {
       /* Copy the next byte at the read index */
@@ -421,8 +738,6 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
       remaining--;
     }
 
-  drv->ni_read = noteram_next(drv, drv->ni_read, NOTE_ALIGN(notelen));
-
   return notelen;
 }
 
@@ -439,6 +754,10 @@ static int noteram_open(FAR struct file *filep)
   /* Reset the read index of the circular buffer */
 
   drv->ni_read = drv->ni_tail;
+#ifdef CONFIG_DRIVERS_NOTERAM_COMPACT
+  memcpy(drv->ni_readtime, drv->ni_tailtime, sizeof(drv->ni_tailtime));
+#endif
+
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -476,6 +795,12 @@ static ssize_t noteram_read(FAR struct file *filep, FAR char *buffer,
       flags = spin_lock_irqsave_notrace(&drv->lock);
       ret = noteram_get(drv, (FAR uint8_t *)buffer, buflen);
       spin_unlock_irqrestore_notrace(&drv->lock, flags);
+#ifdef NOTERAM_COMPACT_TASKNAME
+      if (ret > 0)
+        {
+          ret = noteram_compact_taskname((FAR uint8_t *)buffer, buflen, ret);
+        }
+#endif
     }
   else
     {
@@ -699,9 +1024,14 @@ static void noteram_add(FAR struct note_driver_s *driver,
 {
   FAR const char *buf = note;
   FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+#ifdef CONFIG_DRIVERS_NOTERAM_COMPACT
+  FAR const struct note_common_s *cmn = note;
+  uint8_t hdr[NOTERAM_COMPACT_HDRSIZE];
+  size_t hdrlen;
+#endif
   unsigned int head;
   unsigned int remain;
-  unsigned int space;
+  unsigned int reclen;
   irqstate_t flags;
 
   flags = spin_lock_irqsave_notrace(&drv->lock);
@@ -713,9 +1043,30 @@ static void noteram_add(FAR struct note_driver_s *driver,
     }
 
   DEBUGASSERT(note != NULL && notelen < drv->ni_bufsize);
+
+#ifdef CONFIG_DRIVERS_NOTERAM_COMPACT
+  /* Replace the common header by the compact one */
+
+  DEBUGASSERT(notelen >= sizeof(struct note_common_s));
+  buf     += sizeof(struct note_common_s);
+  notelen -= sizeof(struct note_common_s);
+
+#  ifdef NOTERAM_COMPACT_TASKNAME
+  if (cmn->nc_type == NOTE_START)
+    {
+      notelen = 0;
+    }
+#  endif
+
+  hdrlen = noteram_compact_encode(drv, cmn, notelen, hdr);
+  reclen = hdrlen + notelen;
+#else
+  reclen = NOTE_ALIGN(notelen);
+#endif
+
   remain = drv->ni_bufsize - noteram_length(drv);
 
-  if (remain <= NOTE_ALIGN(notelen))
+  if (remain <= reclen)
     {
       if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
         {
@@ -734,15 +1085,17 @@ static void noteram_add(FAR struct note_driver_s *driver,
           noteram_remove(drv);
           remain = drv->ni_bufsize - noteram_length(drv);
         }
-      while (remain <= NOTE_ALIGN(notelen));
+      while (remain <= reclen);
     }
 
   head = drv->ni_head;
-  space = drv->ni_bufsize - head;
-  space = space < notelen ? space : notelen;
-  memcpy(drv->ni_buffer + head, note, space);
-  memcpy(drv->ni_buffer, buf + space, notelen - space);
-  drv->ni_head = noteram_next(drv, head, NOTE_ALIGN(notelen));
+#ifdef CONFIG_DRIVERS_NOTERAM_COMPACT
+  head = noteram_copyin(drv, head, hdr, hdrlen);
+  drv->ni_headtime[cmn->nc_cpu % NCPUS] = cmn->nc_systime;
+#endif
+
+  noteram_copyin(drv, head, buf, notelen);
+  drv->ni_head = noteram_next(drv, drv->ni_head, reclen);
   spin_unlock_irqrestore_notrace(&drv->lock, flags);
   poll_notify(&drv->pfd, 1, POLLIN);
 }
@@ -1371,6 +1724,11 @@ noteram_initialize(FAR const char *devpath, size_t bufsize, bool overwrite)
   drv->ni_tail = 0;
   drv->ni_read = 0;
   drv->pfd = NULL;
+#ifdef CONFIG_DRIVERS_NOTERAM_COMPACT
+  memset(drv->ni_headtime, 0, sizeof(drv->ni_headtime));
+  memset(drv->ni_tailtime, 0, sizeof(drv->ni_tailtime));
+  memset(drv->ni_readtime, 0, sizeof(drv->ni_readtime));
+#endif
 
   ret = note_driver_register(&drv->driver);
   if (ret < 0)
@@ -0,0 +1,250 @@
+/****************************************************************************
+ * drivers/note/notering.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <assert.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/sched_note.h>
+#include <nuttx/note/notering.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NCPUS CONFIG_SMP_NCPUS
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notering_filtered
+ *
+ * Description:
+ *   Return true if notes of the type are shed at the level.  The task and
+ *   CPU notes come first in enum note_type_e and the dump, printf and heap
+ *   notes last.
+ *
+ ****************************************************************************/
+
+static bool notering_filtered(uint8_t level, uint8_t type)
+{
+  switch (level)
+    {
+      case NOTERING_SHED_NONE:
+        return false;
+
+      case NOTERING_SHED_DUMP:
+        return type >= NOTE_HEAP_ADD;
+
+      default:
+        return type > NOTE_CPU_RESUMED;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: notering_init
+ ****************************************************************************/
+
+void notering_init(FAR struct notering_s *ring, FAR uint8_t *data,
+                   size_t size)
+{
+  int i;
+
+  DEBUGASSERT(size > 0 && (size & (size - 1)) == 0);
+
+  memset(ring, 0, sizeof(struct notering_s));
+  ring->size = size;
+
+  for (i = 0; i < NCPUS; i++)
+    {
+      ring->cpu[i].data = data + i * size;
+    }
+}
+
+/****************************************************************************
+ * Name: notering_add
+ ****************************************************************************/
+
+bool notering_add(FAR struct notering_s *ring, FAR const void *note,
+                  size_t notelen)
+{
+  FAR const struct note_common_s *common = note;
+  FAR const uint8_t *src = note;
+  FAR struct notering_cpu_s *cpu;
+  irqstate_t flags;
+  uint32_t head;
+  size_t off;
+  size_t n;
+
+  flags = up_irq_save();
+  cpu   = &ring->cpu[this_cpu()];
+
+  if (notering_filtered(ring->level, common->nc_type))
+    {
+      cpu->shed++;
+      up_irq_restore(flags);
+      return false;
+    }
+
+  head = cpu->head;
+  if (notelen > ring->size - (uint32_t)(head - cpu->tail))
+    {
+      cpu->lost++;
+      up_irq_restore(flags);
+      return false;
+    }
+
+  off = head & (ring->size - 1);
+  n   = MIN(notelen, ring->size - off);
+  memcpy(&cpu->data[off], src, n);
+  memcpy(cpu->data, src + n, notelen - n);
+
+  /* Make the note visible before the new head */
+
+  UP_WMB();
+  cpu->head = head + notelen;
+  up_irq_restore(flags);
+  return true;
+}
+
+/****************************************************************************
+ * Name: notering_read
+ ****************************************************************************/
+
+size_t notering_read(FAR struct notering_s *ring, FAR uint8_t *buffer,
+                     size_t buflen)
+{
+  size_t total = 0;
+  int i;
+
+  for (i = 0; i < NCPUS; i++)
+    {
+      FAR struct notering_cpu_s *cpu = &ring->cpu[(ring->next + i) % NCPUS];
+      uint32_t head = cpu->head;
+      uint32_t tail = cpu->tail;
+      bool full = false;
+
+      /* Read the notes only after the head that covers them */
+
+      UP_RMB();
+
+      while (tail != head)
+        {
+          size_t off = tail & (ring->size - 1);
+          size_t len = cpu->data[off];
+          size_t n;
+
+          /* The first byte of each note is its length */
+
+          DEBUGASSERT(len > 0 && len <= head - tail);
+          if (len > buflen - total)
+            {
+              full = true;
+              break;
+            }
+
+          n = MIN(len, ring->size - off);
+          memcpy(buffer + total, &cpu->data[off], n);
+          memcpy(buffer + total + n, cpu->data, len - n);
+          total += len;
+          tail  += len;
+        }
+
+      /* The notes must be copied before the CPU may overwrite them */
+
+      UP_DMB();
+      cpu->tail = tail;
+
+      if (full)
+        {
+          break;
+        }
+    }
+
+  ring->next = (ring->next + 1) % NCPUS;
+  return total;
+}
+
+/****************************************************************************
+ * Name: notering_adapt
+ ****************************************************************************/
+
+void notering_adapt(FAR struct notering_s *ring)
+{
+  uint32_t used = 0;
+  uint32_t lost = 0;
+  int i;
+
+  for (i = 0; i < NCPUS; i++)
+    {
+      FAR struct notering_cpu_s *cpu = &ring->cpu[i];
+
+      used  = MAX(used, (uint32_t)(cpu->head - cpu->tail));
+      lost += cpu->lost;
+    }
+
+  if ((lost != ring->lost || used > ring->size / 4 * 3) &&
+      ring->level < NOTERING_SHED_HOT)
+    {
+      ring->level++;
+    }
+  else if (used < ring->size / 4 && ring->level > NOTERING_SHED_NONE)
+    {
+      ring->level--;
+    }
+
+  ring->lost = lost;
+}
+
+/****************************************************************************
+ * Name: notering_dropped
+ ****************************************************************************/
+
+void notering_dropped(FAR struct notering_s *ring, FAR uint32_t *lost,
+                      FAR uint32_t *shed)
+{
+  int i;
+
+  *lost = 0;
+  *shed = 0;
+
+  for (i = 0; i < NCPUS; i++)
+    {
+      *lost += ring->cpu[i].lost;
+      *shed += ring->cpu[i].shed;
+    }
+}
@@ -25,10 +25,10 @@
  ****************************************************************************/
 
 #include <nuttx/note/note_driver.h>
+#include <nuttx/note/notering.h>
 #include <nuttx/rpmsg/rpmsg.h>
 #include <nuttx/sched_note.h>
 #include <nuttx/wqueue.h>
-#include <nuttx/spinlock.h>
 
 #include "noterpmsg.h"
 
@@ -38,6 +38,11 @@
 
 #define NOTE_RPMSG_WORK_DELAY MSEC2TICK(CONFIG_DRIVERS_NOTERPMSG_WORK_DELAY)
 
+#if (CONFIG_DRIVERS_NOTERPMSG_BUFSIZE & \
+     (CONFIG_DRIVERS_NOTERPMSG_BUFSIZE - 1)) != 0
+#  error "CONFIG_DRIVERS_NOTERPMSG_BUFSIZE must be a power of two"
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -45,12 +50,9 @@
 struct noterpmsg_driver_s
 {
   struct note_driver_s  driver;
-  volatile size_t       head;
-  volatile size_t       tail;
-  uint8_t               buffer[CONFIG_DRIVERS_NOTERPMSG_BUFSIZE];
+  struct notering_s     ring;
   struct work_s         work;
   struct rpmsg_endpoint ept;
-  spinlock_t            lock;
 };
 
 /****************************************************************************
@@ -69,6 +71,9 @@ static const struct note_driver_ops_s g_noterpmsg_ops =
   noterpmsg_add
 };
 
+static uint8_t g_noterpmsg_buffer[CONFIG_SMP_NCPUS]
+                                 [CONFIG_DRIVERS_NOTERPMSG_BUFSIZE];
+
 struct noterpmsg_driver_s g_noterpmsg_driver =
 {
   {
@@ -91,104 +96,43 @@ struct noterpmsg_driver_s g_noterpmsg_driver =
  * Private Functions
  ****************************************************************************/
 
-static inline size_t noterpmsg_next(FAR struct noterpmsg_driver_s *drv,
-                                    size_t pos, size_t offset)
-{
-  pos += offset;
-  if (pos >= CONFIG_DRIVERS_NOTERPMSG_BUFSIZE)
-    {
-      pos -= CONFIG_DRIVERS_NOTERPMSG_BUFSIZE;
-    }
-
-  return pos;
-}
-
-static inline size_t noterpmsg_length(FAR struct noterpmsg_driver_s *drv)
-{
-  size_t head = drv->head;
-  size_t tail = drv->tail;
-
-  if (tail > head)
-    {
-      head += CONFIG_DRIVERS_NOTERPMSG_BUFSIZE;
-    }
-
-  return head - tail;
-}
+/****************************************************************************
+ * Name: noterpmsg_work
+ *
+ * Description:
+ *   Drain the rings into as many payload buffers as the remote has room
+ *   for, then look again after the work delay.  Notes are never sent from
+ *   note_add(), so tracing does not wait for the remote.
+ *
+ ****************************************************************************/
 
-static inline void noterpmsg_remove(FAR struct noterpmsg_driver_s *drv)
+static void noterpmsg_work(FAR void *priv)
 {
-  size_t tail = drv->tail;
-  uint8_t notelen = drv->buffer[tail];
-
-  DEBUGASSERT(notelen <= noterpmsg_length(drv));
-  drv->tail = noterpmsg_next(drv, tail, notelen);
-}
+  FAR struct noterpmsg_driver_s *drv = priv;
 
-static bool noterpmsg_transfer(FAR struct noterpmsg_driver_s *drv,
-                               bool wait)
-{
   for (; ; )
     {
       FAR uint8_t *buffer;
       uint32_t space;
       size_t len;
 
-      len = noterpmsg_length(drv);
-      if (len == 0)
-        {
-          return true;
-        }
-
-      buffer = rpmsg_get_tx_payload_buffer(&drv->ept, &space, wait);
+      buffer = rpmsg_get_tx_payload_buffer(&drv->ept, &space, false);
       if (buffer == NULL)
         {
-          return false;
+          break;
         }
 
-      if (space < len)
-        {
-          /* Find the len of large entire note data */
-
-          size_t pos = drv->tail;
-          uint8_t notelen = drv->buffer[pos];
-
-          len = 0;
-          while (len + notelen <= space)
-            {
-              pos = noterpmsg_next(drv, pos, notelen);
-              len += notelen;
-              notelen = drv->buffer[pos];
-            }
-        }
-
-      space = CONFIG_DRIVERS_NOTERPMSG_BUFSIZE - drv->tail;
-      space = space < len ? space : len;
-
-      memcpy(buffer, drv->buffer + drv->tail, space);
-      memcpy(buffer + space, drv->buffer, len - space);
-
-      if (rpmsg_send_nocopy(&drv->ept, buffer, len) < 0)
+      len = notering_read(&drv->ring, buffer, space);
+      if (len == 0 || rpmsg_send_nocopy(&drv->ept, buffer, len) < 0)
         {
           rpmsg_release_tx_buffer(&drv->ept, buffer);
+          break;
         }
-
-      drv->tail = noterpmsg_next(drv, drv->tail, len);
-    }
-}
-
-static void noterpmsg_work(FAR void *priv)
-{
-  FAR struct noterpmsg_driver_s *drv = priv;
-  irqstate_t flags = spin_lock_irqsave_notrace(&drv->lock);
-
-  if (!noterpmsg_transfer(drv, false))
-    {
-      work_queue(HPWORK, &drv->work, noterpmsg_work, drv,
-                 NOTE_RPMSG_WORK_DELAY);
     }
 
-  spin_unlock_irqrestore_notrace(&drv->lock, flags);
+  notering_adapt(&drv->ring);
+  work_queue(LPWORK, &drv->work, noterpmsg_work, drv,
+             NOTE_RPMSG_WORK_DELAY);
 }
 
 static void noterpmsg_add(FAR struct note_driver_s *driver,
@@ -196,47 +140,8 @@ static void noterpmsg_add(FAR struct note_driver_s *driver,
 {
   FAR struct noterpmsg_driver_s *drv =
     (FAR struct noterpmsg_driver_s *)driver;
-  irqstate_t flags;
-  size_t space;
-
-  flags = spin_lock_irqsave_notrace(&drv->lock);
-
-  space = CONFIG_DRIVERS_NOTERPMSG_BUFSIZE - noterpmsg_length(drv);
-  if (space < notelen)
-    {
-      if (!up_interrupt_context() && !sched_idletask())
-        {
-          noterpmsg_transfer(drv, true);
-        }
-      else
-        {
-          /* Overwrite */
-
-          do
-            {
-              noterpmsg_remove(drv);
-              space = CONFIG_DRIVERS_NOTERPMSG_BUFSIZE -
-                      noterpmsg_length(drv);
-            }
-          while (space < notelen);
-        }
-    }
-
-  space = CONFIG_DRIVERS_NOTERPMSG_BUFSIZE - drv->head;
-  space = space < notelen ? space : notelen;
-
-  memcpy(drv->buffer + drv->head, note, space);
-  memcpy(drv->buffer, note + space, notelen - space);
-
-  drv->head = noterpmsg_next(drv, drv->head, notelen);
-
-  if (work_available(&drv->work))
-    {
-      work_queue(HPWORK, &drv->work, noterpmsg_work, drv,
-                 NOTE_RPMSG_WORK_DELAY);
-    }
 
-  spin_unlock_irqrestore_notrace(&drv->lock, flags);
+  notering_add(&drv->ring, note, notelen);
 }
 
 static int noterpmsg_ept_cb(FAR struct rpmsg_endpoint *ept,
@@ -256,14 +161,13 @@ static void noterpmsg_device_created(FAR struct rpmsg_device *rdev,
              rpmsg_get_cpuname(rdev)) == 0)
     {
       drv->ept.priv = drv;
-      spin_lock_init(&drv->lock);
 
       ret = rpmsg_create_ept(&drv->ept, rdev, NOTERPMSG_EPT_NAME,
                              RPMSG_ADDR_ANY, RPMSG_ADDR_ANY,
                              noterpmsg_ept_cb, NULL);
       if (ret >= 0)
         {
-          work_queue(HPWORK, &drv->work, noterpmsg_work, drv, 0);
+          work_queue(LPWORK, &drv->work, noterpmsg_work, drv, 0);
         }
     }
 }
@@ -276,6 +180,7 @@ static void noterpmsg_device_destroy(FAR struct rpmsg_device *rdev,
   if (strcmp(CONFIG_DRIVERS_NOTERPMSG_SERVER_NAME,
              rpmsg_get_cpuname(rdev)) == 0)
     {
+      work_cancel_sync(LPWORK, &drv->work);
       rpmsg_destroy_ept(&drv->ept);
     }
 }
@@ -300,6 +205,8 @@ static void noterpmsg_device_destroy(FAR struct rpmsg_device *rdev,
 
 int noterpmsg_init(void)
 {
+  notering_init(&g_noterpmsg_driver.ring, &g_noterpmsg_buffer[0][0],
+                CONFIG_DRIVERS_NOTERPMSG_BUFSIZE);
   return rpmsg_register_callback(&g_noterpmsg_driver,
                                  noterpmsg_device_created,
                                  noterpmsg_device_destroy,
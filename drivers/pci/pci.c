@@ -1336,36 +1336,30 @@ static void pci_disable_msix(FAR struct pci_device_s *dev, uint8_t msix,
 }
 
 /****************************************************************************
- * Name: pci_enable_msix
+ * Name: pci_get_msix_table
  *
  * Description:
- *   Configure and enable MSI-X.
+ *   Get the mapped address of the MSI-X table.
  *
  * Input Parameters:
- *   dev  - device
- *   irq  - allocated vectors
- *   num  - number of vectors
- *   msix - MSI-X base address
+ *   dev     - device
+ *   msix    - MSI-X base address
+ *   tblsize - returned number of table entries
  *
  * Return value:
- *   OK on success or a negative error code on failure
+ *   The address of the first table entry
  *
  ****************************************************************************/
 
-static int pci_enable_msix(FAR struct pci_device_s *dev, FAR int *irq,
-                           int num, uint8_t msix)
+static uintptr_t pci_get_msix_table(FAR struct pci_device_s *dev,
+                                    uint8_t msix, FAR uint16_t *tblsize)
 {
-  uint32_t  mdr       = 0;
   uint16_t  flags     = 0;
-  uintptr_t mar       = 0;
   uintptr_t tbladdr   = 0;
   uintptr_t tblend    = 0;
   uint32_t  tbloffset = 0;
   uint32_t  tblbar    = 0;
   uint32_t  tbl       = 0;
-  uint16_t  tblsize   = 0;
-  int       i         = 0;
-  int       ret       = OK;
 
   /* Get Flags */
 
@@ -1373,7 +1367,7 @@ static int pci_enable_msix(FAR struct pci_device_s *dev, FAR int *irq,
 
   /* Table Size is N - 1 encoded */
 
-  tblsize = (flags & PCI_MSIX_FLAGS_QSIZE) + 1;
+  *tblsize = (flags & PCI_MSIX_FLAGS_QSIZE) + 1;
 
   /* Get MSI-X table */
 
@@ -1388,13 +1382,47 @@ static int pci_enable_msix(FAR struct pci_device_s *dev, FAR int *irq,
 
   /* Map MSI-X table */
 
-  tblend = tbladdr + tblsize * PCI_MSIX_ENTRY_SIZE;
+  tblend = tbladdr + *tblsize * PCI_MSIX_ENTRY_SIZE;
 
   if (dev->bus->ctrl->ops->map)
     {
       tbladdr = dev->bus->ctrl->ops->map(dev->bus, tbladdr, tblend);
     }
 
+  return tbladdr;
+}
+
+/****************************************************************************
+ * Name: pci_enable_msix
+ *
+ * Description:
+ *   Configure and enable MSI-X.
+ *
+ * Input Parameters:
+ *   dev  - device
+ *   irq  - allocated vectors
+ *   num  - number of vectors
+ *   msix - MSI-X base address
+ *
+ * Return value:
+ *   OK on success or a negative error code on failure
+ *
+ ****************************************************************************/
+
+static int pci_enable_msix(FAR struct pci_device_s *dev, FAR int *irq,
+                           int num, uint8_t msix)
+{
+  uint32_t  mdr       = 0;
+  uint16_t  flags     = 0;
+  uintptr_t mar       = 0;
+  uintptr_t tbladdr   = 0;
+  uint16_t  tblsize   = 0;
+  int       i         = 0;
+  int       ret       = OK;
+
+  pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
+  tbladdr = pci_get_msix_table(dev, msix, &tblsize);
+
   /* Limit tblsize */
 
   if (num > tblsize)
@@ -2034,6 +2062,127 @@ int pci_connect_irq(FAR struct pci_device_s *dev, FAR int *irq, int num)
     }
 }
 
+#ifdef CONFIG_PCI_IRQ_AFFINITY
+/****************************************************************************
+ * Name: pci_affinity_irq
+ *
+ * Description:
+ *   Route a vector connected by pci_connect_irq() to the CPUs in cpuset.
+ *   With MSI-X only the table entry of the vector is written again.  The
+ *   vectors of MSI share one message address, all of them are routed.
+ *
+ * Input Parameters:
+ *   dev    - PCI device
+ *   irq    - connected vectors
+ *   num    - number of vectors
+ *   index  - the vector to route
+ *   cpuset - the CPUs that may take the vector
+ *
+ * Return value:
+ *   OK on success or a negative errno on failure.
+ *
+ ****************************************************************************/
+
+int pci_affinity_irq(FAR struct pci_device_s *dev, FAR int *irq, int num,
+                     int index, cpu_set_t cpuset)
+{
+  FAR const struct pci_ops_s *ops = dev->bus->ctrl->ops;
+  uintptr_t mar = 0;
+  uint32_t  mdr = 0;
+  uint16_t  flags = 0;
+  uint8_t   msi = 0;
+  uint8_t   msix = 0;
+  int       ret;
+  int       i;
+
+  if (index < 0 || index >= num || CPU_COUNT(&cpuset) == 0)
+    {
+      return -EINVAL;
+    }
+
+  if (ops->connect_irq == NULL)
+    {
+      return -ENOTSUP;
+    }
+
+  pci_get_msi_base(dev, &msi, &msix);
+
+#ifdef CONFIG_PCI_MSIX
+  if (msix != 0)
+    {
+      pci_read_config_word(dev, msix + PCI_MSIX_FLAGS, &flags);
+    }
+
+  if ((flags & PCI_MSIX_FLAGS_ENABLE) != 0)
+    {
+      uintptr_t tbladdr;
+      uint16_t  tblsize;
+
+      tbladdr = pci_get_msix_table(dev, msix, &tblsize);
+      if (index >= tblsize)
+        {
+          return -EINVAL;
+        }
+
+      up_affinity_irq(irq[index], cpuset);
+      ret = ops->connect_irq(dev->bus, &irq[index], 1, &mar, &mdr);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      /* The entry is masked while its message is changed */
+
+      tbladdr += index * PCI_MSIX_ENTRY_SIZE;
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_VECTOR_CTRL,
+                           PCI_MSIX_ENTRY_CTRL_MASKBIT);
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_LOWER_ADDR, mar);
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_UPPER_ADDR,
+                           ((uint64_t)mar >> 32));
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_DATA, mdr);
+      pci_write_mmio_dword(dev, tbladdr + PCI_MSIX_ENTRY_VECTOR_CTRL, 0);
+      return OK;
+    }
+#endif
+
+  if (msi == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  pci_read_config_word(dev, msi + PCI_MSI_FLAGS, &flags);
+  if ((flags & PCI_MSI_FLAGS_ENABLE) == 0)
+    {
+      return -ENOTSUP;
+    }
+
+  for (i = 0; i < num; i++)
+    {
+      up_affinity_irq(irq[i], cpuset);
+    }
+
+  ret = ops->connect_irq(dev->bus, irq, num, &mar, &mdr);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  pci_write_config_dword(dev, msi + PCI_MSI_ADDRESS_LO, mar);
+  if ((flags & PCI_MSI_FLAGS_64BIT) != 0)
+    {
+      pci_write_config_dword(dev, msi + PCI_MSI_ADDRESS_HI,
+                             ((uint64_t)mar >> 32));
+      pci_write_config_dword(dev, msi + PCI_MSI_DATA_64, mdr);
+    }
+  else
+    {
+      pci_write_config_word(dev, msi + PCI_MSI_DATA_32, mdr);
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: pci_register_driver
  *
@@ -45,6 +45,7 @@
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/waitqueue.h>
 
 #include "pipe_common.h"
 
@@ -85,6 +86,47 @@ static void pipecommon_wakeup(FAR sem_t *sem)
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_wakeup_readers
+ *
+ * Description:
+ *   Wake up all of the waiting readers, including the one that left its
+ *   buffer for a direct copy.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup_readers(FAR struct pipe_dev_s *dev)
+{
+  pipecommon_wakeup_readers(dev);
+
+#ifdef CONFIG_DEV_PIPE_DIRECT
+  if (dev->d_rdbuf != NULL)
+    {
+      pipecommon_wakeup(&dev->d_rdxsem);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: pipecommon_relock
+ *
+ * Description:
+ *   Retake the pipe lock after splice() or tee() did its I/O unlocked.  The
+ *   buffer is reserved until the lock is held again, so this may not fail.
+ *
+ ****************************************************************************/
+
+static void pipecommon_relock(FAR struct pipe_dev_s *dev)
+{
+  int ret;
+
+  do
+    {
+      ret = nxrmutex_lock(&dev->d_bflock);
+    }
+  while (ret < 0);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -107,8 +149,12 @@ FAR struct pipe_dev_s *pipecommon_allocdev(size_t bufsize)
       /* Initialize the private structure */
 
       nxrmutex_init(&dev->d_bflock);
+      nxwaitq_init(&dev->d_pollwq);
       nxsem_init(&dev->d_rdsem, 0, 0);
       nxsem_init(&dev->d_wrsem, 0, 0);
+#ifdef CONFIG_DEV_PIPE_DIRECT
+      nxsem_init(&dev->d_rdxsem, 0, 0);
+#endif
       dev->d_bufsize = bufsize;
     }
 
@@ -124,6 +170,9 @@ void pipecommon_freedev(FAR struct pipe_dev_s *dev)
   nxrmutex_destroy(&dev->d_bflock);
   nxsem_destroy(&dev->d_rdsem);
   nxsem_destroy(&dev->d_wrsem);
+#ifdef CONFIG_DEV_PIPE_DIRECT
+  nxsem_destroy(&dev->d_rdxsem);
+#endif
   kmm_free(dev);
 }
 
@@ -180,7 +229,7 @@ int pipecommon_open(FAR struct file *filep)
 
       if (dev->d_nwriters == 1)
         {
-          pipecommon_wakeup(&dev->d_rdsem);
+          pipecommon_wakeup_readers(dev);
         }
     }
 
@@ -347,9 +396,9 @@ int pipecommon_close(FAR struct file *filep)
             {
               /* Inform poll readers that other end closed. */
 
-              poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLHUP);
+              nxwaitq_notify(&dev->d_pollwq, POLLHUP);
 
-              pipecommon_wakeup(&dev->d_rdsem);
+              pipecommon_wakeup_readers(dev);
             }
         }
 
@@ -365,8 +414,7 @@ int pipecommon_close(FAR struct file *filep)
                 {
                   /* Inform poll writers that other end closed. */
 
-                  poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS,
-                              POLLERR);
+                  nxwaitq_notify(&dev->d_pollwq, POLLERR);
                   pipecommon_wakeup(&dev->d_wrsem);
                 }
             }
@@ -417,6 +465,9 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR struct inode      *inode = filep->f_inode;
   FAR struct pipe_dev_s *dev   = inode->i_private;
   ssize_t                nread = 0;
+#ifdef CONFIG_DEV_PIPE_DIRECT
+  bool                   direct;
+#endif
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -438,13 +489,18 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ret;
     }
 
-  /* If the pipe is empty, then wait for something to be written to it */
+  /* If the pipe is empty, then wait for something to be written to it.
+   * Data that splice() or tee() is draining stays in the buffer until
+   * they are done, so wait for them, too.
+   */
 
-  while (circbuf_is_empty(&dev->d_buffer))
+  while (circbuf_is_empty(&dev->d_buffer) ||
+         PIPE_IS_SPLICEOUT(dev->d_flags))
     {
       /* If there are no writers on the pipe, then return end of file */
 
-      if (dev->d_nwriters <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+      if (circbuf_is_empty(&dev->d_buffer) && dev->d_nwriters <= 0 &&
+          PIPE_IS_POLICY_0(dev->d_flags))
         {
           nxrmutex_unlock(&dev->d_bflock);
           return 0;
@@ -458,10 +514,56 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
           return -EAGAIN;
         }
 
+#ifdef CONFIG_DEV_PIPE_DIRECT
+      /* Offer the caller's buffer to the next writer, unless another
+       * reader already waits with its own.
+       */
+
+      direct = dev->d_rdbuf == NULL && !PIPE_IS_SPLICEOUT(dev->d_flags);
+      if (direct)
+        {
+          dev->d_rdbuf  = buffer;
+          dev->d_rdlen  = len;
+          dev->d_rdxfer = 0;
+        }
+#endif
+
       /* Otherwise, wait for something to be written to the pipe */
 
       nxrmutex_unlock(&dev->d_bflock);
+#ifdef CONFIG_DEV_PIPE_DIRECT
+      ret = nxsem_wait(direct ? &dev->d_rdxsem : &dev->d_rdsem);
+#else
       ret = nxsem_wait(&dev->d_rdsem);
+#endif
+
+#ifdef CONFIG_DEV_PIPE_DIRECT
+      if (direct)
+        {
+          /* The buffer must be taken back even if the wait failed, a
+           * writer may have filled it meanwhile.
+           */
+
+          pipecommon_relock(dev);
+          nread         = dev->d_rdxfer;
+          dev->d_rdbuf  = NULL;
+          dev->d_rdxfer = 0;
+
+          if (nread > 0 || ret < 0)
+            {
+              nxrmutex_unlock(&dev->d_bflock);
+              if (nread > 0)
+                {
+                  pipe_dumpbuffer("From PIPE:", buffer, nread);
+                  return nread;
+                }
+
+              return ret;
+            }
+
+          continue;
+        }
+#endif
 
       if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
         {
@@ -485,7 +587,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   if (circbuf_used(&dev->d_buffer) <= (dev->d_bufsize - dev->d_polloutthrd))
     {
-      poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLOUT);
+      nxwaitq_notify(&dev->d_pollwq, POLLOUT);
     }
 
   /* Notify all waiting writers that bytes have been removed from the
@@ -566,9 +668,43 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
           return nwritten == 0 ? -EPIPE : nwritten;
         }
 
-      /* Would the next write overflow the circular buffer? */
+#ifdef CONFIG_DEV_PIPE_DIRECT
+      /* A reader waits on the empty buffer with a buffer of its own, copy
+       * straight into it.  Nothing is queued ahead, so the order holds.
+       */
+
+      if (dev->d_rdbuf != NULL && dev->d_rdxfer == 0 &&
+          circbuf_is_empty(&dev->d_buffer) &&
+          !PIPE_IS_SPLICEIN(dev->d_flags))
+        {
+          size_t n = MIN(len - nwritten, dev->d_rdlen);
+
+          memcpy(dev->d_rdbuf, buffer + nwritten, n);
+          dev->d_rdxfer = n;
+          nwritten     += n;
+
+          /* Wake up just the owner of the buffer, the other readers still
+           * have nothing to read.
+           */
+
+          pipecommon_wakeup(&dev->d_rdxsem);
+
+          if ((size_t)nwritten == len)
+            {
+              nxrmutex_unlock(&dev->d_bflock);
+              return len;
+            }
+
+          last = nwritten;
+        }
+#endif
+
+      /* Would the next write overflow the circular buffer?  The space
+       * after the head also belongs to splice() while it fills it.
+       */
 
-      if (!circbuf_is_full(&dev->d_buffer))
+      if (!circbuf_is_full(&dev->d_buffer) &&
+          !PIPE_IS_SPLICEIN(dev->d_flags))
         {
           /* Loop until all of the bytes have been written */
 
@@ -583,15 +719,14 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
               if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
                 {
-                  poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS,
-                              POLLIN);
+                  nxwaitq_notify(&dev->d_pollwq, POLLIN);
                 }
 
               /* Yes.. Notify all of the waiting readers that more data is
                * available.
                */
 
-              pipecommon_wakeup(&dev->d_rdsem);
+              pipecommon_wakeup_readers(dev);
 
               /* Return the number of bytes written */
 
@@ -611,13 +746,13 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
                * FIFO.
                */
 
-              poll_notify(dev->d_fds, CONFIG_DEV_PIPE_NPOLLWAITERS, POLLIN);
+              nxwaitq_notify(&dev->d_pollwq, POLLIN);
 
               /* Yes.. Notify all of the waiting readers that more data is
                * available.
                */
 
-              pipecommon_wakeup(&dev->d_rdsem);
+              pipecommon_wakeup_readers(dev);
             }
 
           last = nwritten;
@@ -667,7 +802,6 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
   pollevent_t            eventset;
   pipe_ndx_t             nbytes;
   int                    ret;
-  int                    i;
 
   DEBUGASSERT(dev && fds);
 
@@ -679,33 +813,9 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
       return ret;
     }
 
-  if (setup)
+  ret = nxwaitq_poll(&dev->d_pollwq, fds, setup);
+  if (setup && ret >= 0)
     {
-      /* This is a request to set up the poll.  Find an available
-       * slot for the poll structure reference
-       */
-
-      for (i = 0; i < CONFIG_DEV_PIPE_NPOLLWAITERS; i++)
-        {
-          /* Find an available slot */
-
-          if (!dev->d_fds[i])
-            {
-              /* Bind the poll structure and this slot */
-
-              dev->d_fds[i] = fds;
-              fds->priv     = &dev->d_fds[i];
-              break;
-            }
-        }
-
-      if (i >= CONFIG_DEV_PIPE_NPOLLWAITERS)
-        {
-          fds->priv = NULL;
-          ret       = -EBUSY;
-          goto errout;
-        }
-
       /* Should immediately notify on any of the requested events?
        * First, determine how many bytes are in the buffer
        */
@@ -749,27 +859,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       poll_notify(&fds, 1, eventset);
     }
-  else
-    {
-      /* This is a request to tear down the poll. */
-
-      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
-
-#ifdef CONFIG_DEBUG_FEATURES
-      if (!slot)
-        {
-          ret = -EIO;
-          goto errout;
-        }
-#endif
-
-      /* Remove all memory of the poll setup */
 
-      *slot     = NULL;
-      fds->priv = NULL;
-    }
-
-errout:
   nxrmutex_unlock(&dev->d_bflock);
   return ret;
 }
@@ -865,6 +955,13 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
               break;
             }
 
+          if (PIPE_IS_SPLICEIN(dev->d_flags) ||
+              PIPE_IS_SPLICEOUT(dev->d_flags))
+            {
+              ret = -EBUSY;
+              break;
+            }
+
           size = MIN(size, CONFIG_DEV_PIPE_MAXSIZE);
           ret = circbuf_resize(&dev->d_buffer, size);
           if (ret != 0)
@@ -947,4 +1044,247 @@ int pipecommon_unlink(FAR struct inode *inode)
 }
 #endif
 
+/****************************************************************************
+ * Name: file_ispipe
+ *
+ * Description:
+ *   Return true if 'filep' refers to a pipe or FIFO.
+ *
+ ****************************************************************************/
+
+bool file_ispipe(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+
+  return inode != NULL && INODE_IS_DRIVER(inode) && inode->u.i_ops &&
+         inode->u.i_ops->read == pipecommon_read;
+}
+
+/****************************************************************************
+ * Name: pipe_splice_from
+ *
+ * Description:
+ *   Move up to 'len' bytes from the pipe to 'filep'.  The data is written
+ *   straight from the pipe buffer, so it is copied once instead of twice
+ *   as with read() plus write().  If 'tee' is true, the data is left in the
+ *   pipe.
+ *
+ * Input Parameters:
+ *   pipe   - The read end of the pipe
+ *   filep  - The file to write to
+ *   offset - The offset in 'filep' to write at, or NULL for the file
+ *            position.  It is updated on return.
+ *   len    - The maximum number of bytes to move
+ *   flags  - SPLICE_F_* flags
+ *   tee    - Copy the data instead of moving it
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of file, or a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t pipe_splice_from(FAR struct file *pipe, FAR struct file *filep,
+                         FAR off_t *offset, size_t len, unsigned int flags,
+                         bool tee)
+{
+  FAR struct pipe_dev_s *dev = pipe->f_inode->i_private;
+  FAR void *buffer;
+  ssize_t ret;
+  size_t size;
+
+  DEBUGASSERT(dev);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (circbuf_is_empty(&dev->d_buffer) ||
+         PIPE_IS_SPLICEOUT(dev->d_flags))
+    {
+      if (circbuf_is_empty(&dev->d_buffer) && dev->d_nwriters <= 0 &&
+          PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return 0;
+        }
+
+      if ((pipe->f_oflags & O_NONBLOCK) || (flags & SPLICE_F_NONBLOCK))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_rdsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  /* Reserve the readable data and write it out without holding the lock,
+   * the output may block for a long time.
+   */
+
+  buffer = circbuf_get_readptr(&dev->d_buffer, &size);
+  size   = MIN(size, len);
+  dev->d_flags |= PIPE_FLAG_SPLICEOUT;
+  nxrmutex_unlock(&dev->d_bflock);
+
+  if (offset != NULL)
+    {
+      ret = file_pwrite(filep, buffer, size, *offset);
+      if (ret > 0)
+        {
+          *offset += ret;
+        }
+    }
+  else
+    {
+      ret = file_write(filep, buffer, size);
+    }
+
+  pipecommon_relock(dev);
+  dev->d_flags &= ~PIPE_FLAG_SPLICEOUT;
+
+  if (!tee && ret > 0)
+    {
+      circbuf_readcommit(&dev->d_buffer, ret);
+
+      if (circbuf_used(&dev->d_buffer) <=
+          (dev->d_bufsize - dev->d_polloutthrd))
+        {
+          nxwaitq_notify(&dev->d_pollwq, POLLOUT);
+        }
+
+      pipecommon_wakeup(&dev->d_wrsem);
+    }
+
+  /* Readers and other splicers may be waiting for the reservation */
+
+  pipecommon_wakeup_readers(dev);
+  nxrmutex_unlock(&dev->d_bflock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pipe_splice_to
+ *
+ * Description:
+ *   Move up to 'len' bytes from 'filep' to the pipe.  The data is read
+ *   straight into the pipe buffer.
+ *
+ * Input Parameters:
+ *   pipe   - The write end of the pipe
+ *   filep  - The file to read from
+ *   offset - The offset in 'filep' to read at, or NULL for the file
+ *            position.  It is updated on return.
+ *   len    - The maximum number of bytes to move
+ *   flags  - SPLICE_F_* flags
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of file, or a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t pipe_splice_to(FAR struct file *pipe, FAR struct file *filep,
+                       FAR off_t *offset, size_t len, unsigned int flags)
+{
+  FAR struct pipe_dev_s *dev = pipe->f_inode->i_private;
+  FAR void *buffer;
+  ssize_t ret;
+  size_t size;
+
+  DEBUGASSERT(dev);
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  ret = nxrmutex_lock(&dev->d_bflock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      if (dev->d_nreaders <= 0 && PIPE_IS_POLICY_0(dev->d_flags))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EPIPE;
+        }
+
+      if (!circbuf_is_full(&dev->d_buffer) &&
+          !PIPE_IS_SPLICEIN(dev->d_flags))
+        {
+          break;
+        }
+
+      if ((pipe->f_oflags & O_NONBLOCK) || (flags & SPLICE_F_NONBLOCK))
+        {
+          nxrmutex_unlock(&dev->d_bflock);
+          return -EAGAIN;
+        }
+
+      nxrmutex_unlock(&dev->d_bflock);
+      ret = nxsem_wait(&dev->d_wrsem);
+      if (ret < 0 || (ret = nxrmutex_lock(&dev->d_bflock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  buffer = circbuf_get_writeptr(&dev->d_buffer, &size);
+  size   = MIN(size, len);
+  dev->d_flags |= PIPE_FLAG_SPLICEIN;
+  nxrmutex_unlock(&dev->d_bflock);
+
+  if (offset != NULL)
+    {
+      ret = file_pread(filep, buffer, size, *offset);
+      if (ret > 0)
+        {
+          *offset += ret;
+        }
+    }
+  else
+    {
+      ret = file_read(filep, buffer, size);
+    }
+
+  pipecommon_relock(dev);
+  dev->d_flags &= ~PIPE_FLAG_SPLICEIN;
+
+  if (ret > 0)
+    {
+      pipe_dumpbuffer("To PIPE:", buffer, ret);
+      circbuf_writecommit(&dev->d_buffer, ret);
+
+      if (circbuf_used(&dev->d_buffer) > dev->d_pollinthrd)
+        {
+          nxwaitq_notify(&dev->d_pollwq, POLLIN);
+        }
+
+      pipecommon_wakeup_readers(dev);
+    }
+
+  /* Writers and other splicers may be waiting for the reservation */
+
+  pipecommon_wakeup(&dev->d_wrsem);
+  nxrmutex_unlock(&dev->d_bflock);
+  return ret;
+}
+
 #endif /* CONFIG_PIPES */
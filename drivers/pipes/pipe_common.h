@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 #include <nuttx/mutex.h>
 #include <nuttx/circbuf.h>
+#include <nuttx/waitqueue.h>
 #include <sys/types.h>
 
 #include <stdint.h>
@@ -73,12 +74,6 @@
 #  define CONFIG_DEV_FIFO_SIZE 0
 #endif
 
-/* Maximum number of threads than can be waiting for POLL events */
-
-#ifndef CONFIG_DEV_PIPE_NPOLLWAITERS
-#  define CONFIG_DEV_PIPE_NPOLLWAITERS 2
-#endif
-
 /* Maximum number of open's supported on pipe */
 
 #define CONFIG_DEV_PIPE_MAXUSER 255
@@ -87,6 +82,8 @@
 
 #define PIPE_FLAG_POLICY    (1 << 0) /* Bit 0: Policy=Free buffer when empty */
 #define PIPE_FLAG_UNLINKED  (1 << 1) /* Bit 1: The driver has been unlinked */
+#define PIPE_FLAG_SPLICEIN  (1 << 2) /* Bit 2: splice() fills the buffer */
+#define PIPE_FLAG_SPLICEOUT (1 << 3) /* Bit 3: splice() or tee() drain it */
 
 #define PIPE_POLICY_0(f)    do { (f) &= ~PIPE_FLAG_POLICY; } while (0)
 #define PIPE_POLICY_1(f)    do { (f) |= PIPE_FLAG_POLICY; } while (0)
@@ -96,6 +93,9 @@
 #define PIPE_UNLINK(f)      do { (f) |= PIPE_FLAG_UNLINKED; } while (0)
 #define PIPE_IS_UNLINKED(f) (((f) & PIPE_FLAG_UNLINKED) != 0)
 
+#define PIPE_IS_SPLICEIN(f)  (((f) & PIPE_FLAG_SPLICEIN) != 0)
+#define PIPE_IS_SPLICEOUT(f) (((f) & PIPE_FLAG_SPLICEOUT) != 0)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -131,12 +131,18 @@ struct pipe_dev_s
   int16_t          d_crefs;       /* References to dev */
   struct circbuf_s d_buffer;      /* Buffer allocated when device opened */
 
-  /* The following is a list if poll structures of threads waiting for
-   * driver events. The 'struct pollfd' reference for each open is also
-   * retained in the f_priv field of the 'struct file'.
+#ifdef CONFIG_DEV_PIPE_DIRECT
+  /* A reader waiting on the empty buffer may leave its own buffer here for
+   * a writer to fill directly.
    */
 
-  FAR struct pollfd *d_fds[CONFIG_DEV_PIPE_NPOLLWAITERS];
+  sem_t            d_rdxsem;      /* The reader of d_rdbuf waits here */
+  FAR char        *d_rdbuf;       /* Buffer of the waiting reader, or NULL */
+  size_t           d_rdlen;       /* Size of d_rdbuf */
+  size_t           d_rdxfer;      /* Bytes written into d_rdbuf */
+#endif
+
+  waitq_t          d_pollwq;      /* Threads waiting for POLL events */
 };
 
 /****************************************************************************
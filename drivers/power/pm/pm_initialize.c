@@ -84,6 +84,8 @@ void pm_initialize(void)
       gov = pm_activity_governor_initialize();
 #elif defined(CONFIG_PM_GOVERNOR_STABILITY)
       gov = pm_stability_governor_initialize();
+#elif defined(CONFIG_PM_GOVERNOR_PREDICTIVE)
+      gov = pm_predictive_governor_initialize();
 #else
       static struct pm_governor_s null;
       gov = &null;
@@ -0,0 +1,349 @@
+/****************************************************************************
+ * drivers/power/pm/predictive_governor.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/hrtimer.h>
+#include <nuttx/wdog.h>
+#include <nuttx/power/pm.h>
+
+#include "pm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PREDICTIVE_NHISTORY CONFIG_PM_GOVERNOR_PREDICTIVE_HISTORY
+
+/* The typical interval is given up when the spread of the samples is
+ * wider than this, in microseconds, and than a sixth of their average.
+ */
+
+#define PREDICTIVE_SPREAD   20
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pm_predictive_governor_domain_s
+{
+  /* When the domain went idle, zero while it is running (us) */
+
+  uint64_t enter;
+
+  /* The durations of the last idle periods, a ring (us) */
+
+  uint32_t history[PREDICTIVE_NHISTORY];
+  uint8_t  next;
+  uint8_t  count;
+};
+
+struct pm_predictive_governor_s
+{
+  struct pm_predictive_governor_domain_s domain[CONFIG_PM_NDOMAINS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* PM governor methods */
+
+static void predictive_governor_statechanged(int domain,
+                                             enum pm_state_e newstate);
+static enum pm_state_e predictive_governor_checkstate(int domain);
+static void predictive_governor_activity(int domain, int count);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct pm_governor_s g_predictive_governor_ops =
+{
+  NULL,                             /* initialize */
+  NULL,                             /* deinitialize */
+  predictive_governor_statechanged, /* statechanged */
+  predictive_governor_checkstate,   /* checkstate */
+  predictive_governor_activity,     /* activity */
+  NULL                              /* priv */
+};
+
+/* The shortest idle time that pays off entering each state, and the time
+ * it takes to leave it (us).
+ */
+
+static const uint32_t g_predictive_residency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_PREDICTIVE_IDLE_RESIDENCY,
+  CONFIG_PM_GOVERNOR_PREDICTIVE_STANDBY_RESIDENCY,
+  CONFIG_PM_GOVERNOR_PREDICTIVE_SLEEP_RESIDENCY,
+};
+
+static const uint32_t g_predictive_latency[PM_COUNT] =
+{
+  0,
+  CONFIG_PM_GOVERNOR_PREDICTIVE_IDLE_LATENCY,
+  CONFIG_PM_GOVERNOR_PREDICTIVE_STANDBY_LATENCY,
+  CONFIG_PM_GOVERNOR_PREDICTIVE_SLEEP_LATENCY,
+};
+
+static struct pm_predictive_governor_s g_predictive_governor;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: predictive_governor_now
+ ****************************************************************************/
+
+static uint64_t predictive_governor_now(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return clock_time2usec(&ts);
+}
+
+/****************************************************************************
+ * Name: predictive_governor_horizon
+ *
+ * Description:
+ *   The time until the next timer wakes the system up (us).
+ *
+ ****************************************************************************/
+
+static uint64_t predictive_governor_horizon(void)
+{
+#ifdef CONFIG_HRTIMER
+  /* The watchdogs run from an hrtimer too */
+
+  uint64_t timeout = hrtimer_gettimeout_next();
+
+  return timeout == UINT64_MAX ? UINT64_MAX : timeout / NSEC_PER_USEC;
+#else
+  clock_t timeout = wd_gettime_next();
+
+  return timeout == CLOCK_MAX ? UINT64_MAX : TICK2USEC((uint64_t)timeout);
+#endif
+}
+
+/****************************************************************************
+ * Name: predictive_governor_typical
+ *
+ * Description:
+ *   The typical idle duration of the recent history (us), UINT64_MAX if
+ *   the durations are too scattered to predict the next one.  The longest
+ *   samples are dropped one at a time, down to three quarters of them,
+ *   until the rest are close enough to their average.
+ *
+ ****************************************************************************/
+
+static uint64_t
+predictive_governor_typical(FAR struct pm_predictive_governor_domain_s *gdom)
+{
+  uint64_t threshold = UINT64_MAX;
+  uint64_t variance;
+  uint64_t avg;
+  uint64_t max;
+  uint64_t sum;
+  int count;
+  int i;
+
+  if (gdom->count < PREDICTIVE_NHISTORY)
+    {
+      return UINT64_MAX;
+    }
+
+  for (; ; )
+    {
+      sum   = 0;
+      max   = 0;
+      count = 0;
+
+      for (i = 0; i < PREDICTIVE_NHISTORY; i++)
+        {
+          if (gdom->history[i] <= threshold)
+            {
+              sum += gdom->history[i];
+              max  = MAX(max, gdom->history[i]);
+              count++;
+            }
+        }
+
+      avg      = sum / count;
+      variance = 0;
+
+      for (i = 0; i < PREDICTIVE_NHISTORY; i++)
+        {
+          if (gdom->history[i] <= threshold)
+            {
+              int64_t diff = (int64_t)gdom->history[i] - (int64_t)avg;
+
+              variance += diff * diff;
+            }
+        }
+
+      variance /= count;
+
+      /* The standard deviation is small, absolutely or next to the
+       * average.
+       */
+
+      if (variance <= PREDICTIVE_SPREAD * PREDICTIVE_SPREAD ||
+          avg * avg > 36 * variance)
+        {
+          return avg;
+        }
+
+      if (count * 4 <= PREDICTIVE_NHISTORY * 3)
+        {
+          return UINT64_MAX;
+        }
+
+      threshold = max - 1;
+    }
+}
+
+/****************************************************************************
+ * Name: predictive_governor_statechanged
+ *
+ * Description:
+ *   pm_idle() changes to the state before it waits for an interrupt and
+ *   restores it on the way out, the time in between is recorded.
+ *
+ ****************************************************************************/
+
+static void predictive_governor_statechanged(int domain,
+                                             enum pm_state_e newstate)
+{
+  FAR struct pm_predictive_governor_domain_s *gdom;
+  uint64_t now = predictive_governor_now();
+
+  gdom = &g_predictive_governor.domain[domain];
+
+  if (newstate != PM_RESTORE)
+    {
+      gdom->enter = now;
+    }
+  else if (gdom->enter != 0)
+    {
+      gdom->history[gdom->next] = MIN(now - gdom->enter, UINT32_MAX);
+      gdom->next  = (gdom->next + 1) % PREDICTIVE_NHISTORY;
+      gdom->count = MIN(gdom->count + 1, PREDICTIVE_NHISTORY);
+      gdom->enter = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: predictive_governor_checkstate
+ ****************************************************************************/
+
+static enum pm_state_e predictive_governor_checkstate(int domain)
+{
+  FAR struct pm_predictive_governor_domain_s *gdom;
+  FAR struct pm_domain_s *pdom;
+  uint64_t predicted;
+  irqstate_t flags;
+  int state;
+
+  gdom = &g_predictive_governor.domain[domain];
+  pdom = &g_pmdomains[domain];
+  state = PM_NORMAL;
+
+  /* We disable interrupts since pm_stay()/pm_relax() could be simultaneously
+   * invoked, which modifies the stay count which we are about to read
+   */
+
+  flags = spin_lock_irqsave(&pdom->lock);
+
+  /* Find the lowest power-level which is not locked. */
+
+  while (dq_empty(&pdom->wakelock[state]) && state < (PM_COUNT - 1))
+    {
+      state++;
+    }
+
+  /* The idle time ends with the next timer at the latest, or earlier if
+   * the recent idle times say so.
+   */
+
+  predicted = MIN(predictive_governor_horizon(),
+                  predictive_governor_typical(gdom));
+
+  spin_unlock_irqrestore(&pdom->lock, flags);
+
+  /* The deepest state that pays off, and is left in time */
+
+  while (state > PM_NORMAL &&
+         (g_predictive_residency[state] > predicted ||
+          (CONFIG_PM_GOVERNOR_PREDICTIVE_MAXLATENCY > 0 &&
+           g_predictive_latency[state] >
+           CONFIG_PM_GOVERNOR_PREDICTIVE_MAXLATENCY)))
+    {
+      state--;
+    }
+
+  /* Return the found state */
+
+  return state;
+}
+
+/****************************************************************************
+ * Name: predictive_governor_activity
+ ****************************************************************************/
+
+static void predictive_governor_activity(int domain, int count)
+{
+  pm_staytimeout(domain, PM_NORMAL, (count ? count : 1) * 1000);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pm_predictive_governor_initialize
+ *
+ * Description:
+ *   Return the predictive governor instance.
+ *
+ * Returned Value:
+ *   A pointer to the governor struct.
+ *
+ ****************************************************************************/
+
+FAR const struct pm_governor_s *pm_predictive_governor_initialize(void)
+{
+  return &g_predictive_governor_ops;
+}
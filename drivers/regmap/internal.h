@@ -30,6 +30,12 @@
 #include <nuttx/regmap/regmap.h>
 #include <nuttx/mutex.h>
 
+#ifdef CONFIG_REGMAP_ASYNC
+#  include <nuttx/queue.h>
+#  include <nuttx/spinlock.h>
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -81,9 +87,83 @@ struct regmap_s
 
   int reg_stride;
 
+#ifdef CONFIG_REGMAP_CACHE
+  /* Flat register cache, one entry per register address / reg_stride.
+   * The valid and dirty bitmaps have one bit per entry.
+   */
+
+  FAR uint32_t *cache;
+  FAR uint8_t *cache_valid;
+  FAR uint8_t *cache_dirty;
+  unsigned int cache_size;
+  regmap_volatile_t volatile_reg;
+  bool cache_only;
+  bool cache_bypass;
+#endif
+
+#ifdef CONFIG_REGMAP_ASYNC
+  /* Raw writes queued by regmap_raw_write_async() */
+
+  sq_queue_t async_list;
+  spinlock_t async_lock;
+  struct work_s async_work;
+  int async_ret;
+#endif
+
   /* Prevent fragmentation */
 
   mutex_t mutex[0];
 };
 
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_REGMAP_CACHE
+
+/* Allocate and free the cache of the map, regcache_init() does nothing if
+ * the configuration has no cache.
+ */
+
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config);
+void regcache_exit(FAR struct regmap_s *map);
+
+/* Look up a register, -ENOENT if the device must be read; -EBUSY if it
+ * can not be read in cache only mode.
+ */
+
+int regcache_read(FAR struct regmap_s *map, unsigned int reg,
+                  FAR unsigned int *val);
+
+/* Called before a register is written to the device.  Returns 1 if the
+ * write was absorbed in cache only mode, 0 if it must go to the device.
+ */
+
+int regcache_write(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int val);
+
+/* Record a value that was read from or written to the device */
+
+void regcache_update(FAR struct regmap_s *map, unsigned int reg,
+                     unsigned int val);
+
+/* Forget count registers from reg after a raw write */
+
+void regcache_drop(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int count);
+
+#  define regcache_enabled(map) ((map)->cache != NULL)
+#  define regcache_only(map) ((map)->cache_only)
+#else
+#  define regcache_init(map, config) (OK)
+#  define regcache_exit(map)
+#  define regcache_read(map, reg, val) (-ENOENT)
+#  define regcache_write(map, reg, val) (0)
+#  define regcache_update(map, reg, val)
+#  define regcache_drop(map, reg, count)
+#  define regcache_enabled(map) (false)
+#  define regcache_only(map) (false)
+#endif
+
 #endif /* __DRIVERS_REGMAP_INTERNAL_H */
@@ -28,6 +28,8 @@
 #include <nuttx/lib/math32.h>
 #include <nuttx/kmalloc.h>
 
+#include <string.h>
+#include <errno.h>
 #include <debug.h>
 
 #include "internal.h"
@@ -41,6 +43,23 @@
 
 #define REGMAP_DEFAULT_BIT 8
 
+/* Raw writes up to this size are built on the stack */
+
+#define REGMAP_RAW_STACK 32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_REGMAP_ASYNC
+struct regmap_async_s
+{
+  sq_entry_t entry;
+  size_t len;
+  uint8_t data[1];
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -61,6 +80,170 @@ static void regmap_unlock_mutex(FAR void *context)
   nxmutex_unlock(&map->mutex[0]);
 }
 
+static int regmap_get_val(FAR const void *buf, int val_bytes,
+                          unsigned int i, FAR unsigned int *val)
+{
+  switch (val_bytes)
+    {
+      case 1:
+        *val = ((FAR const uint8_t *)buf)[i];
+        break;
+      case 2:
+        *val = ((FAR const uint16_t *)buf)[i];
+        break;
+      case 4:
+        *val = ((FAR const uint32_t *)buf)[i];
+        break;
+      default:
+        return -EINVAL;
+    }
+
+  return OK;
+}
+
+static int regmap_put_val(FAR void *buf, int val_bytes,
+                          unsigned int i, unsigned int val)
+{
+  switch (val_bytes)
+    {
+      case 1:
+        ((FAR uint8_t *)buf)[i] = val;
+        break;
+      case 2:
+        ((FAR uint16_t *)buf)[i] = val;
+        break;
+      case 4:
+        ((FAR uint32_t *)buf)[i] = val;
+        break;
+      default:
+        return -EINVAL;
+    }
+
+  return OK;
+}
+
+/* The accesses below are made with the map locked and go through the
+ * cache, if it is enabled.
+ */
+
+static int regmap_write_locked(FAR struct regmap_s *map, unsigned int reg,
+                               unsigned int val)
+{
+  int ret;
+
+  ret = regcache_write(map, reg, val);
+  if (ret != 0)
+    {
+      return ret < 0 ? ret : OK;
+    }
+
+  ret = map->reg_write(map->bus, reg, val);
+  if (ret >= 0)
+    {
+      regcache_update(map, reg, val);
+    }
+
+  return ret;
+}
+
+static int regmap_read_locked(FAR struct regmap_s *map, unsigned int reg,
+                              FAR unsigned int *val)
+{
+  int ret;
+
+  ret = regcache_read(map, reg, val);
+  if (ret != -ENOENT)
+    {
+      return ret;
+    }
+
+  *val = 0;
+  ret = map->reg_read(map->bus, reg, val);
+  if (ret >= 0)
+    {
+      regcache_update(map, reg, *val);
+    }
+
+  return ret;
+}
+
+/* Send the register address and the data in one block write, the address
+ * is sent as regmap_bulk_read() does.
+ */
+
+static int regmap_raw_write_locked(FAR struct regmap_s *map,
+                                   unsigned int reg,
+                                   FAR const void *val, size_t val_len)
+{
+  uint8_t stack[REGMAP_RAW_STACK];
+  FAR uint8_t *buf = stack;
+  size_t size = map->reg_bytes + val_len;
+  int ret;
+
+  if (map->write == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  if (regcache_only(map))
+    {
+      return -EBUSY;
+    }
+
+  if (size > sizeof(stack))
+    {
+      buf = kmm_malloc(size);
+      if (buf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  memcpy(buf, &reg, map->reg_bytes);
+  memcpy(buf + map->reg_bytes, val, val_len);
+
+  ret = map->write(map->bus, buf, size);
+
+  if (buf != stack)
+    {
+      kmm_free(buf);
+    }
+
+  return ret;
+}
+
+#ifdef CONFIG_REGMAP_ASYNC
+static void regmap_async_worker(FAR void *arg)
+{
+  FAR struct regmap_s *map = arg;
+  FAR struct regmap_async_s *async;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&map->async_lock);
+      async = (FAR struct regmap_async_s *)sq_remfirst(&map->async_list);
+      spin_unlock_irqrestore(&map->async_lock, flags);
+
+      if (async == NULL)
+        {
+          break;
+        }
+
+      map->lock(map);
+      ret = map->write(map->bus, async->data, async->len);
+      if (ret < 0 && map->async_ret == 0)
+        {
+          map->async_ret = ret;
+        }
+
+      map->unlock(map);
+      kmm_free(async);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -108,6 +291,7 @@ FAR struct regmap_s *regmap_init(FAR struct regmap_bus_s *bus,
 
       map->lock   = regmap_lock_unlock_none;
       map->unlock = regmap_lock_unlock_none;
+      map->disable_locking = true;
     }
   else
     {
@@ -140,6 +324,22 @@ FAR struct regmap_s *regmap_init(FAR struct regmap_bus_s *bus,
   map->read  = bus->read;
   map->write = bus->write;
 
+#ifdef CONFIG_REGMAP_ASYNC
+  sq_init(&map->async_list);
+  spin_lock_init(&map->async_lock);
+#endif
+
+  if (regcache_init(map, config) < 0)
+    {
+      if (!map->disable_locking)
+        {
+          nxmutex_destroy(&map->mutex[0]);
+        }
+
+      kmm_free(map);
+      return NULL;
+    }
+
   return map;
 }
 
@@ -173,7 +373,7 @@ int regmap_write(FAR struct regmap_s *map, unsigned int reg,
 
   map->lock(map);
 
-  ret = map->reg_write(map->bus, reg, val);
+  ret = regmap_write_locked(map, reg, val);
 
   map->unlock(map);
 
@@ -208,38 +408,43 @@ int regmap_bulk_write(FAR struct regmap_s *map, unsigned int reg,
   size_t val_bytes = map->val_bytes;
   int ret = -ENOSYS;
   unsigned int ival;
-  FAR uint8_t *ptr;
   int i;
 
   DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
 
   map->lock(map);
-  if (map->write != NULL)
+
+  /* All registers go in one block write if the bus has it, unless the
+   * writes are held in the cache.
+   */
+
+  if (map->write != NULL && !regcache_only(map))
     {
-      ret = map->write(map->bus, val, val_bytes * val_count);
+      ret = regmap_raw_write_locked(map, reg, val, val_bytes * val_count);
+      for (i = 0; i < val_count && regcache_enabled(map); i++)
+        {
+          if (ret < 0 || regmap_get_val(val, val_bytes, i, &ival) < 0)
+            {
+              regcache_drop(map, reg + (i * map->reg_stride), 1);
+            }
+          else
+            {
+              regcache_update(map, reg + (i * map->reg_stride), ival);
+            }
+        }
+
       goto out;
     }
 
   for (i = 0; i < val_count; i++)
     {
-      ptr = (FAR uint8_t *)val + (i * val_bytes);
-      switch (val_bytes)
+      ret = regmap_get_val(val, val_bytes, i, &ival);
+      if (ret < 0)
         {
-          case 1:
-            ival = *(FAR uint8_t *)ptr;
-            break;
-          case 2:
-            ival = *(FAR uint16_t *)ptr;
-            break;
-          case 4:
-            ival = *(FAR uint32_t *)ptr;
-            break;
-          default:
-            ret = -EINVAL;
-            goto out;
+          break;
         }
 
-      ret = map->reg_write(map->bus, reg + (i * map->reg_stride), ival);
+      ret = regmap_write_locked(map, reg + (i * map->reg_stride), ival);
       if (ret < 0)
         {
           break;
@@ -274,13 +479,25 @@ out:
 
 int regmap_read(FAR struct regmap_s *map, unsigned int reg, FAR void *val)
 {
+  unsigned int ival;
   int ret;
 
   DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
 
   map->lock(map);
 
-  ret = map->reg_read(map->bus, reg, val);
+  if (!regcache_enabled(map))
+    {
+      ret = map->reg_read(map->bus, reg, val);
+    }
+  else
+    {
+      ret = regmap_read_locked(map, reg, &ival);
+      if (ret >= 0)
+        {
+          regmap_put_val(val, map->val_bytes, 0, ival);
+        }
+    }
 
   map->unlock(map);
   return ret;
@@ -359,6 +576,187 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write of the bits of mask in a register.  The value comes
+ *   from the cache if the register is cached, and nothing is written if
+ *   the bits do not change.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - the bits to be updated.
+ *   val  - the new value of these bits.
+ *
+ * Returned Value:
+ *   Zero (OK) or positive on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val)
+{
+  unsigned int orig;
+  unsigned int tmp;
+  int ret;
+
+  DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
+
+  map->lock(map);
+
+  ret = regmap_read_locked(map, reg, &orig);
+  if (ret >= 0)
+    {
+      tmp = (orig & ~mask) | (val & mask);
+      if (tmp != orig)
+        {
+          ret = regmap_write_locked(map, reg, tmp);
+        }
+    }
+
+  map->unlock(map);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: regmap_raw_write
+ *
+ * Description:
+ *   Write val_len bytes in the format of the device to the registers from
+ *   reg in one bus transfer.  The cached values of these registers are
+ *   dropped.
+ *
+ * Input Parameters:
+ *   map     - regmap handler, from regmap bus init function return.
+ *   reg     - first register address to be written.
+ *   val     - the data.
+ *   val_len - the length of the data in bytes.
+ *
+ * Returned Value:
+ *   Zero (OK) or positive on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_raw_write(FAR struct regmap_s *map, unsigned int reg,
+                     FAR const void *val, size_t val_len)
+{
+  int ret;
+
+  DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
+
+  map->lock(map);
+
+  ret = regmap_raw_write_locked(map, reg, val, val_len);
+  if (ret != -EBUSY)
+    {
+      regcache_drop(map, reg, REGMAP_DIVUP(val_len, map->val_bytes));
+    }
+
+  map->unlock(map);
+  return ret;
+}
+
+#ifdef CONFIG_REGMAP_ASYNC
+
+/****************************************************************************
+ * Name: regmap_raw_write_async
+ *
+ * Description:
+ *   As regmap_raw_write(), but the data is copied and written later from
+ *   the low priority work queue.  The writes are done in order.
+ *
+ ****************************************************************************/
+
+int regmap_raw_write_async(FAR struct regmap_s *map, unsigned int reg,
+                           FAR const void *val, size_t val_len)
+{
+  FAR struct regmap_async_s *async;
+  irqstate_t flags;
+
+  DEBUGASSERT(REGMAP_ALIGNED(reg, map->reg_stride));
+
+  /* The worker takes the lock of the map for each write */
+
+  if (map->disable_locking)
+    {
+      return -ENOTSUP;
+    }
+
+  if (map->write == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  async = kmm_malloc(sizeof(*async) + map->reg_bytes + val_len);
+  if (async == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  async->len = map->reg_bytes + val_len;
+  memcpy(async->data, &reg, map->reg_bytes);
+  memcpy(async->data + map->reg_bytes, val, val_len);
+
+  map->lock(map);
+
+  if (regcache_only(map))
+    {
+      map->unlock(map);
+      kmm_free(async);
+      return -EBUSY;
+    }
+
+  regcache_drop(map, reg, REGMAP_DIVUP(val_len, map->val_bytes));
+
+  flags = spin_lock_irqsave(&map->async_lock);
+  sq_addlast(&async->entry, &map->async_list);
+  spin_unlock_irqrestore(&map->async_lock, flags);
+
+  map->unlock(map);
+
+  if (work_available(&map->async_work))
+    {
+      work_queue(LPWORK, &map->async_work, regmap_async_worker, map, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: regmap_async_complete
+ *
+ * Description:
+ *   Wait until all writes queued by regmap_raw_write_async() are done and
+ *   return the error of the first one that failed.
+ *
+ ****************************************************************************/
+
+int regmap_async_complete(FAR struct regmap_s *map)
+{
+  int ret;
+
+  if (map->disable_locking)
+    {
+      return OK;
+    }
+
+  /* Wait for the worker and do what it left in the queue */
+
+  work_cancel_sync(LPWORK, &map->async_work);
+  regmap_async_worker(map);
+
+  map->lock(map);
+  ret = map->async_ret;
+  map->async_ret = 0;
+  map->unlock(map);
+
+  return ret;
+}
+
+#endif /* CONFIG_REGMAP_ASYNC */
+
 /****************************************************************************
  * Name: regmap_exit
  *
@@ -374,6 +772,12 @@ int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
 
 void regmap_exit(FAR struct regmap_s *map)
 {
+#ifdef CONFIG_REGMAP_ASYNC
+  regmap_async_complete(map);
+#endif
+
+  regcache_exit(map);
+
   if (!map->disable_locking)
     {
       nxmutex_destroy(&map->mutex[0]);
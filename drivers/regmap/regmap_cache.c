@@ -0,0 +1,321 @@
+/****************************************************************************
+ * drivers/regmap/regmap_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/regmap/regmap.h>
+
+#include "internal.h"
+
+#ifdef CONFIG_REGMAP_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define REGCACHE_BITMAP_BYTES(n) (((n) + 7) / 8)
+
+#define REGCACHE_TEST(b, i)      (((b)[(i) >> 3] & (1 << ((i) & 7))) != 0)
+#define REGCACHE_SET(b, i)       ((b)[(i) >> 3] |= 1 << ((i) & 7))
+#define REGCACHE_CLEAR(b, i)     ((b)[(i) >> 3] &= ~(1 << ((i) & 7)))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: regcache_index
+ *
+ * Description:
+ *   Return the cache entry of a register, or -1 if it is not cached.
+ *
+ ****************************************************************************/
+
+static int regcache_index(FAR struct regmap_s *map, unsigned int reg)
+{
+  unsigned int index = reg / map->reg_stride;
+
+  if (index >= map->cache_size)
+    {
+      return -1;
+    }
+
+  if (map->volatile_reg != NULL && map->volatile_reg(reg))
+    {
+      return -1;
+    }
+
+  return index;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: regcache_init
+ ****************************************************************************/
+
+int regcache_init(FAR struct regmap_s *map,
+                  FAR const struct regmap_config_s *config)
+{
+  size_t bitmap;
+
+  if (config->cache_type == REGCACHE_NONE)
+    {
+      return OK;
+    }
+
+  if (config->cache_type != REGCACHE_FLAT)
+    {
+      return -EINVAL;
+    }
+
+  map->cache_size = config->max_register / map->reg_stride + 1;
+  bitmap = REGCACHE_BITMAP_BYTES(map->cache_size);
+
+  map->cache = kmm_zalloc(map->cache_size * sizeof(uint32_t) + 2 * bitmap);
+  if (map->cache == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  map->cache_valid  = (FAR uint8_t *)(map->cache + map->cache_size);
+  map->cache_dirty  = map->cache_valid + bitmap;
+  map->volatile_reg = config->volatile_reg;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: regcache_exit
+ ****************************************************************************/
+
+void regcache_exit(FAR struct regmap_s *map)
+{
+  kmm_free(map->cache);
+  map->cache = NULL;
+}
+
+/****************************************************************************
+ * Name: regcache_read
+ ****************************************************************************/
+
+int regcache_read(FAR struct regmap_s *map, unsigned int reg,
+                  FAR unsigned int *val)
+{
+  int index;
+
+  if (map->cache_bypass)
+    {
+      return -ENOENT;
+    }
+
+  index = regcache_index(map, reg);
+  if (index >= 0 && REGCACHE_TEST(map->cache_valid, index))
+    {
+      *val = map->cache[index];
+      return OK;
+    }
+
+  return map->cache_only ? -EBUSY : -ENOENT;
+}
+
+/****************************************************************************
+ * Name: regcache_write
+ ****************************************************************************/
+
+int regcache_write(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int val)
+{
+  int index;
+
+  if (map->cache_bypass || !map->cache_only)
+    {
+      return 0;
+    }
+
+  index = regcache_index(map, reg);
+  if (index < 0)
+    {
+      return -EBUSY;
+    }
+
+  map->cache[index] = val;
+  REGCACHE_SET(map->cache_valid, index);
+  REGCACHE_SET(map->cache_dirty, index);
+  return 1;
+}
+
+/****************************************************************************
+ * Name: regcache_update
+ ****************************************************************************/
+
+void regcache_update(FAR struct regmap_s *map, unsigned int reg,
+                     unsigned int val)
+{
+  int index;
+
+  if (map->cache_bypass)
+    {
+      return;
+    }
+
+  index = regcache_index(map, reg);
+  if (index >= 0)
+    {
+      map->cache[index] = val;
+      REGCACHE_SET(map->cache_valid, index);
+      REGCACHE_CLEAR(map->cache_dirty, index);
+    }
+}
+
+/****************************************************************************
+ * Name: regcache_drop
+ ****************************************************************************/
+
+void regcache_drop(FAR struct regmap_s *map, unsigned int reg,
+                   unsigned int count)
+{
+  unsigned int index = reg / map->reg_stride;
+
+  while (count-- > 0 && index < map->cache_size)
+    {
+      REGCACHE_CLEAR(map->cache_valid, index);
+      REGCACHE_CLEAR(map->cache_dirty, index);
+      index++;
+    }
+}
+
+/****************************************************************************
+ * Name: regcache_cache_only
+ *
+ * Description:
+ *   While enabled, writes of the cached registers only update the cache
+ *   and are marked dirty, accesses to the device fail with -EBUSY.
+ *
+ ****************************************************************************/
+
+void regcache_cache_only(FAR struct regmap_s *map, bool enable)
+{
+  map->lock(map);
+  DEBUGASSERT(!enable || !map->cache_bypass);
+  map->cache_only = enable;
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regcache_cache_bypass
+ *
+ * Description:
+ *   While enabled, all accesses go to the device and the cache is left
+ *   alone.
+ *
+ ****************************************************************************/
+
+void regcache_cache_bypass(FAR struct regmap_s *map, bool enable)
+{
+  map->lock(map);
+  DEBUGASSERT(!enable || !map->cache_only);
+  map->cache_bypass = enable;
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regcache_mark_dirty
+ *
+ * Description:
+ *   Mark all cached registers dirty so that regcache_sync() writes all of
+ *   them back.
+ *
+ ****************************************************************************/
+
+void regcache_mark_dirty(FAR struct regmap_s *map)
+{
+  if (map->cache == NULL)
+    {
+      return;
+    }
+
+  map->lock(map);
+  memcpy(map->cache_dirty, map->cache_valid,
+         REGCACHE_BITMAP_BYTES(map->cache_size));
+  map->unlock(map);
+}
+
+/****************************************************************************
+ * Name: regcache_sync
+ *
+ * Description:
+ *   Write the dirty registers of the cache to the device.  The registers
+ *   that were not written stay dirty.
+ *
+ ****************************************************************************/
+
+int regcache_sync(FAR struct regmap_s *map)
+{
+  unsigned int index;
+  int ret = OK;
+
+  if (map->cache == NULL)
+    {
+      return OK;
+    }
+
+  map->lock(map);
+
+  if (map->cache_only)
+    {
+      map->unlock(map);
+      return -EBUSY;
+    }
+
+  for (index = 0; index < map->cache_size; index++)
+    {
+      if (!REGCACHE_TEST(map->cache_dirty, index))
+        {
+          continue;
+        }
+
+      ret = map->reg_write(map->bus, index * map->reg_stride,
+                           map->cache[index]);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      REGCACHE_CLEAR(map->cache_dirty, index);
+    }
+
+  map->unlock(map);
+  return ret < 0 ? ret : OK;
+}
+
+#endif /* CONFIG_REGMAP_CACHE */
@@ -24,10 +24,12 @@
  * Included Files
  ****************************************************************************/
 
+#include <debug.h>
 #include <stdio.h>
 
 #include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 
 #include <metal/mutex.h>
 #include <metal/sys.h>
@@ -43,6 +45,14 @@
 #define RPMSG_PORT_BUF_TO_NODE(q,b) ((q)->node + ((FAR void *)(b) - (q)->buf) / (q)->len)
 #define RPMSG_PORT_NODE_TO_BUF(q,n) ((q)->buf + (((n) - (q)->node)) * (q)->len)
 
+/* Frames packed into one batch start at an 8 bytes boundary, and at most
+ * RPMSG_PORT_BATCH_NSKIP endpoints can be passed over while searching for
+ * a frame that still fits into the batch.
+ */
+
+#define RPMSG_PORT_BATCH_ALIGN      8
+#define RPMSG_PORT_BATCH_NSKIP      4
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -124,6 +134,68 @@ rpmsg_port_remove_node(FAR struct rpmsg_port_list_s *list)
   return node;
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_remove_fit_node
+ *
+ * Description:
+ *   Remove the first buffer of the ready list whose frame (without the
+ *   port header) is no longer than len.  The frames of an endpoint which
+ *   has been passed over are passed over too, so that the messages of one
+ *   endpoint are never reordered.
+ *
+ ****************************************************************************/
+
+static FAR struct rpmsg_port_header_s *
+rpmsg_port_remove_fit_node(FAR struct rpmsg_port_queue_s *queue,
+                           uint16_t len)
+{
+  uint32_t skipped[RPMSG_PORT_BATCH_NSKIP];
+  FAR struct rpmsg_port_header_s *hdr;
+  FAR struct rpmsg_hdr *rphdr;
+  FAR struct list_node *node;
+  irqstate_t flags;
+  int nskipped = 0;
+  int i;
+
+  flags = spin_lock_irqsave(&queue->ready.lock);
+  list_for_every(&queue->ready.head, node)
+    {
+      hdr = RPMSG_PORT_NODE_TO_BUF(queue, node);
+      rphdr = (FAR struct rpmsg_hdr *)hdr->buf;
+
+      for (i = 0; i < nskipped; i++)
+        {
+          if (skipped[i] == rphdr->src)
+            {
+              break;
+            }
+        }
+
+      if (i < nskipped)
+        {
+          continue;
+        }
+
+      if (hdr->len - sizeof(struct rpmsg_port_header_s) <= len)
+        {
+          list_delete(node);
+          queue->ready.num--;
+          spin_unlock_irqrestore(&queue->ready.lock, flags);
+          return hdr;
+        }
+
+      if (nskipped == RPMSG_PORT_BATCH_NSKIP)
+        {
+          break;
+        }
+
+      skipped[nskipped++] = rphdr->src;
+    }
+
+  spin_unlock_irqrestore(&queue->ready.lock, flags);
+  return NULL;
+}
+
 /****************************************************************************
  * Name: rpmsg_port_destroy_queue
  *
@@ -722,6 +794,116 @@ void rpmsg_port_queue_add_buffer(FAR struct rpmsg_port_queue_s *queue,
   rpmsg_port_post(&queue->ready.sem);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_queue_batch
+ ****************************************************************************/
+
+int rpmsg_port_queue_batch(FAR struct rpmsg_port_queue_s *queue,
+                           FAR struct rpmsg_port_header_s *hdr,
+                           int nframes)
+{
+  FAR struct rpmsg_port_header_s *next;
+  uint16_t pos = ALIGN_UP(hdr->len, RPMSG_PORT_BATCH_ALIGN);
+  uint16_t len;
+  int n = 1;
+
+  while (n < nframes && pos + sizeof(struct rpmsg_hdr) <= queue->len)
+    {
+      next = rpmsg_port_remove_fit_node(queue, queue->len - pos);
+      if (next == NULL)
+        {
+          break;
+        }
+
+      len = next->len - sizeof(struct rpmsg_port_header_s);
+      memcpy((FAR uint8_t *)hdr + pos, next->buf, len);
+      rpmsg_port_queue_return_buffer(queue, next);
+
+      hdr->len = pos + len;
+      pos = ALIGN_UP(hdr->len, RPMSG_PORT_BATCH_ALIGN);
+      n++;
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: rpmsg_port_queue_unbatch
+ ****************************************************************************/
+
+void rpmsg_port_queue_unbatch(FAR struct rpmsg_port_queue_s *queue,
+                              FAR struct rpmsg_port_header_s *hdr,
+                              uint16_t cmd)
+{
+  FAR struct rpmsg_hdr *rphdr = (FAR struct rpmsg_hdr *)hdr->buf;
+  FAR struct rpmsg_port_header_s *next;
+  FAR struct list_node *node;
+  struct list_node frames;
+  uint16_t total = hdr->len;
+  irqstate_t flags;
+  uint16_t pos;
+  uint16_t len;
+  int n = 1;
+
+  list_initialize(&frames);
+
+  /* The first frame stays where it is, the following ones are copied out
+   * into buffers of their own before any of them becomes visible to the
+   * consumer, because returning the first buffer may hand it out again.
+   */
+
+  len = sizeof(struct rpmsg_hdr) + rphdr->len;
+  if (sizeof(struct rpmsg_port_header_s) + len <= total)
+    {
+      hdr->cmd = cmd;
+      hdr->len = sizeof(struct rpmsg_port_header_s) + len;
+      pos = ALIGN_UP(hdr->len, RPMSG_PORT_BATCH_ALIGN);
+
+      while (pos + sizeof(struct rpmsg_hdr) <= total)
+        {
+          rphdr = (FAR struct rpmsg_hdr *)((FAR uint8_t *)hdr + pos);
+          len = sizeof(struct rpmsg_hdr) + rphdr->len;
+          if (pos + len > total)
+            {
+              rpmsgerr("malformed batch frame at %u\n", pos);
+              break;
+            }
+
+          next = rpmsg_port_queue_get_available_buffer(queue, false);
+          if (next == NULL)
+            {
+              rpmsgerr("no rx buffer, batch frame dropped at %u\n", pos);
+              break;
+            }
+
+          next->crc = 0;
+          next->cmd = cmd;
+          next->avail = 0;
+          next->len = sizeof(struct rpmsg_port_header_s) + len;
+          memcpy(next->buf, rphdr, len);
+          list_add_tail(&frames, RPMSG_PORT_BUF_TO_NODE(queue, next));
+
+          pos = ALIGN_UP(pos + len, RPMSG_PORT_BATCH_ALIGN);
+          n++;
+        }
+    }
+  else
+    {
+      rpmsgerr("malformed batch frame, len %u\n", total);
+    }
+
+  flags = spin_lock_irqsave(&queue->ready.lock);
+  list_add_tail(&queue->ready.head, RPMSG_PORT_BUF_TO_NODE(queue, hdr));
+  while ((node = list_remove_head(&frames)) != NULL)
+    {
+      list_add_tail(&queue->ready.head, node);
+    }
+
+  queue->ready.num += n;
+  spin_unlock_irqrestore(&queue->ready.lock, flags);
+  rpmsg_port_post(&queue->ready.sem);
+}
+
 /****************************************************************************
  * Name: rpmsg_port_drop_packets
  ****************************************************************************/
@@ -272,6 +272,52 @@ uint16_t rpmsg_port_queue_nused(FAR struct rpmsg_port_queue_s *queue)
   return atomic_read(&queue->ready.num);
 }
 
+/****************************************************************************
+ * Name: rpmsg_port_queue_batch
+ *
+ * Description:
+ *   Pack more frames of the ready list of the queue behind a frame which
+ *   has been taken from it already, so that they cross the link in one
+ *   transfer.  The frames are appended without their port headers, each
+ *   one aligned to 8 bytes, and the len of hdr is updated to cover them.
+ *   Queued frames which fit are taken out of order across endpoints, but
+ *   never within one endpoint.
+ *
+ * Input Parameters:
+ *   queue   - The tx queue hdr was taken from.
+ *   hdr     - The first frame, it must be a buffer of queue.
+ *   nframes - The maximum number of frames hdr may carry.
+ *
+ * Returned Value:
+ *   The number of frames hdr carries, one if nothing could be packed.
+ *
+ ****************************************************************************/
+
+int rpmsg_port_queue_batch(FAR struct rpmsg_port_queue_s *queue,
+                           FAR struct rpmsg_port_header_s *hdr,
+                           int nframes);
+
+/****************************************************************************
+ * Name: rpmsg_port_queue_unbatch
+ *
+ * Description:
+ *   Split a frame built by rpmsg_port_queue_batch() into one buffer per
+ *   message and add them, in order, to the ready list of the queue.
+ *
+ * Input Parameters:
+ *   queue - The rx queue hdr belongs to.
+ *   hdr   - The batch frame received.
+ *   cmd   - The cmd to be set to every resulting frame.
+ *
+ * Returned Value:
+ *   No return value.
+ *
+ ****************************************************************************/
+
+void rpmsg_port_queue_unbatch(FAR struct rpmsg_port_queue_s *queue,
+                              FAR struct rpmsg_port_header_s *hdr,
+                              uint16_t cmd);
+
 /****************************************************************************
  * Name: rpmsg_port_drop_packets
  ****************************************************************************/
@@ -27,6 +27,7 @@
 #include <debug.h>
 #include <errno.h>
 #include <stdio.h>
+#include <sys/param.h>
 
 #include <nuttx/nuttx.h>
 #include <nuttx/crc16.h>
@@ -63,6 +64,7 @@ enum rpmsg_port_spi_cmd_e
   RPMSG_PORT_SPI_CMD_SUSPEND,
   RPMSG_PORT_SPI_CMD_RESUME,
   RPMSG_PORT_SPI_CMD_SHUTDOWN,
+  RPMSG_PORT_SPI_CMD_BATCH,
 };
 
 enum rpmsg_port_spi_state_e
@@ -195,6 +197,9 @@ static void rpmsg_port_spi_register_cb(FAR struct rpmsg_port_s *port,
 static void rpmsg_port_spi_exchange(FAR struct rpmsg_port_spi_s *rpspi)
 {
   FAR struct rpmsg_port_header_s *txhdr;
+#if CONFIG_RPMSG_PORT_SPI_BATCH_NFRAMES > 1
+  int nframes;
+#endif
   int pending;
 
   IOEXP_WRITEPIN(rpspi->ioe, rpspi->mreq, 0);
@@ -223,6 +228,14 @@ static void rpmsg_port_spi_exchange(FAR struct rpmsg_port_spi_s *rpspi)
 
       txhdr->cmd = RPMSG_PORT_SPI_CMD_DATA;
       rpspi->txhdr = txhdr;
+
+#if CONFIG_RPMSG_PORT_SPI_BATCH_NFRAMES > 1
+      nframes = MIN(rpspi->txavail, CONFIG_RPMSG_PORT_SPI_BATCH_NFRAMES);
+      if (rpmsg_port_queue_batch(&rpspi->port.txq, txhdr, nframes) > 1)
+        {
+          txhdr->cmd = RPMSG_PORT_SPI_CMD_BATCH;
+        }
+#endif
     }
   else
     {
@@ -332,10 +345,19 @@ static void rpmsg_port_spi_complete_handler(FAR void *arg)
       if (rpspi->rxhdr->cmd == RPMSG_PORT_SPI_CMD_SHUTDOWN)
         {
           rpspi->state = RPMSG_PORT_SPI_STATE_DISCONNECTING;
-          rpmsg_port_spi_drop_packets(rpspi, RPMSG_PORT_SPI_DROP_ALL);
+          rpmsg_port_drop_packets(&rpspi->port, RPMSG_PORT_DROP_ALL);
+        }
+
+      if (rpspi->rxhdr->cmd == RPMSG_PORT_SPI_CMD_BATCH)
+        {
+          rpmsg_port_queue_unbatch(&rpspi->port.rxq, rpspi->rxhdr,
+                                   RPMSG_PORT_SPI_CMD_DATA);
+        }
+      else
+        {
+          rpmsg_port_queue_add_buffer(&rpspi->port.rxq, rpspi->rxhdr);
         }
 
-      rpmsg_port_queue_add_buffer(&rpspi->port.rxq, rpspi->rxhdr);
       rpspi->rxhdr = rpmsg_port_queue_get_available_buffer(
         &rpspi->port.rxq, false);
       DEBUGASSERT(rpspi->rxhdr != NULL);
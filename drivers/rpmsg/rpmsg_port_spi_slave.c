@@ -27,6 +27,7 @@
 #include <debug.h>
 #include <errno.h>
 #include <stdio.h>
+#include <sys/param.h>
 
 #include <nuttx/atomic.h>
 #include <nuttx/crc16.h>
@@ -63,6 +64,7 @@ enum rpmsg_port_spi_cmd_e
   RPMSG_PORT_SPI_CMD_SUSPEND,
   RPMSG_PORT_SPI_CMD_RESUME,
   RPMSG_PORT_SPI_CMD_SHUTDOWN,
+  RPMSG_PORT_SPI_CMD_BATCH,
 };
 
 enum rpmsg_port_spi_state_e
@@ -165,6 +167,9 @@ static const struct spi_slave_devops_s g_rpmsg_port_spi_slave_ops =
 static void rpmsg_port_spi_exchange(FAR struct rpmsg_port_spi_s *rpspi)
 {
   FAR struct rpmsg_port_header_s *txhdr;
+#if CONFIG_RPMSG_PORT_SPI_BATCH_NFRAMES > 1
+  int nframes;
+#endif
 
   if (atomic_fetch_add(&rpspi->transferring, 1))
     {
@@ -185,6 +190,14 @@ static void rpmsg_port_spi_exchange(FAR struct rpmsg_port_spi_s *rpspi)
 
       txhdr->cmd = RPMSG_PORT_SPI_CMD_DATA;
       rpspi->txhdr = txhdr;
+
+#if CONFIG_RPMSG_PORT_SPI_BATCH_NFRAMES > 1
+      nframes = MIN(rpspi->txavail, CONFIG_RPMSG_PORT_SPI_BATCH_NFRAMES);
+      if (rpmsg_port_queue_batch(&rpspi->port.txq, txhdr, nframes) > 1)
+        {
+          txhdr->cmd = RPMSG_PORT_SPI_CMD_BATCH;
+        }
+#endif
     }
   else
     {
@@ -396,7 +409,16 @@ static void rpmsg_port_spi_slave_notify(FAR struct spi_slave_dev_s *dev,
           rpmsg_port_drop_packets(&rpspi->port, RPMSG_PORT_DROP_ALL);
         }
 
-      rpmsg_port_queue_add_buffer(&rpspi->port.rxq, rpspi->rxhdr);
+      if (rpspi->rxhdr->cmd == RPMSG_PORT_SPI_CMD_BATCH)
+        {
+          rpmsg_port_queue_unbatch(&rpspi->port.rxq, rpspi->rxhdr,
+                                   RPMSG_PORT_SPI_CMD_DATA);
+        }
+      else
+        {
+          rpmsg_port_queue_add_buffer(&rpspi->port.rxq, rpspi->rxhdr);
+        }
+
       rpspi->rxhdr = rpmsg_port_queue_get_available_buffer(
         &rpspi->port.rxq, false);
       DEBUGASSERT(rpspi->rxhdr != NULL);
@@ -45,7 +45,7 @@
 
 #define RPMSG_VIRTIO_IVSHMEM_WDOG_DELAY    MSEC2TICK(1)
 
-#define RPMSG_VIRTIO_VRING_ALIGNMENT       8
+#define RPMSG_VIRTIO_VRING_ALIGNMENT       CONFIG_RPMSG_VIRTIO_IVSHMEM_VRING_ALIGN
 
 /****************************************************************************
  * Private Types
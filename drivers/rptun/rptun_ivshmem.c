@@ -183,11 +183,11 @@ rptun_ivshmem_get_resource(FAR struct rptun_dev_s *dev)
       rsc->rpmsg_vdev.config_len    = sizeof(struct fw_rsc_config);
       rsc->rpmsg_vdev.num_of_vrings = 2;
       rsc->rpmsg_vring0.da          = FW_RSC_U32_ADDR_ANY;
-      rsc->rpmsg_vring0.align       = 8;
+      rsc->rpmsg_vring0.align       = CONFIG_RPTUN_IVSHMEM_VRING_ALIGN;
       rsc->rpmsg_vring0.num         = CONFIG_RPTUN_IVSHMEM_BUFFNUM;
       rsc->rpmsg_vring0.notifyid    = RSC_NOTIFY_ID_ANY;
       rsc->rpmsg_vring1.da          = FW_RSC_U32_ADDR_ANY;
-      rsc->rpmsg_vring1.align       = 8;
+      rsc->rpmsg_vring1.align       = CONFIG_RPTUN_IVSHMEM_VRING_ALIGN;
       rsc->rpmsg_vring1.num         = CONFIG_RPTUN_IVSHMEM_BUFFNUM;
       rsc->rpmsg_vring1.notifyid    = RSC_NOTIFY_ID_ANY;
       rsc->config.r2h_buf_size      = CONFIG_RPTUN_IVSHMEM_BUFFSIZE;
@@ -28,6 +28,32 @@
 #include <nuttx/segger/note_rtt.h>
 #include <nuttx/segger/rtt.h>
 
+#ifdef CONFIG_NOTE_RTT_DEFERRED
+#  include <sys/param.h>
+#  include <nuttx/note/notering.h>
+#  include <nuttx/wqueue.h>
+
+#  include <SEGGER_RTT.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NOTE_RTT_DEFERRED
+#  define NOTERTT_WORK_DELAY MSEC2TICK(CONFIG_NOTE_RTT_WORK_DELAY)
+
+/* Notes are written to the channel this many bytes at a time, at least
+ * one note of the largest size.
+ */
+
+#  define NOTERTT_BATCH      512
+
+#  if (CONFIG_NOTE_RTT_RING_SIZE & (CONFIG_NOTE_RTT_RING_SIZE - 1)) != 0
+#    error "CONFIG_NOTE_RTT_RING_SIZE must be a power of two"
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -36,6 +62,11 @@ struct notertt_s
 {
   struct note_driver_s driver;
   struct lib_rttoutstream_s stream;
+#ifdef CONFIG_NOTE_RTT_DEFERRED
+  struct notering_s ring;
+  struct work_s work;
+  uint8_t buffer[NOTERTT_BATCH];
+#endif
 };
 
 /****************************************************************************
@@ -54,6 +85,10 @@ static const struct note_driver_ops_s g_notertt_ops =
   notertt_add,
 };
 
+#ifdef CONFIG_NOTE_RTT_DEFERRED
+static uint8_t g_notertt_ring[CONFIG_SMP_NCPUS][CONFIG_NOTE_RTT_RING_SIZE];
+#endif
+
 struct notertt_s g_notertt =
 {
   {
@@ -95,9 +130,47 @@ static void notertt_add(FAR struct note_driver_s *drv,
                         FAR const void *buf, size_t notelen)
 {
   FAR struct notertt_s *note = (FAR struct notertt_s *)drv;
+#ifdef CONFIG_NOTE_RTT_DEFERRED
+  notering_add(&note->ring, buf, notelen);
+#else
   lib_stream_puts(&note->stream, buf, notelen);
+#endif
 }
 
+/****************************************************************************
+ * Name: notertt_work
+ *
+ * Description:
+ *   Write the rings to the channel while it has room, the channel is only
+ *   written here so the room cannot shrink meanwhile.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NOTE_RTT_DEFERRED
+static void notertt_work(FAR void *arg)
+{
+  FAR struct notertt_s *note = arg;
+  size_t space;
+  size_t len;
+
+  for (; ; )
+    {
+      space = SEGGER_RTT_GetAvailWriteSpace(note->stream.channel);
+      len   = notering_read(&note->ring, note->buffer,
+                            MIN(space, NOTERTT_BATCH));
+      if (len == 0)
+        {
+          break;
+        }
+
+      lib_stream_puts(&note->stream, note->buffer, len);
+    }
+
+  notering_adapt(&note->ring);
+  work_queue(LPWORK, &note->work, notertt_work, note, NOTERTT_WORK_DELAY);
+}
+#endif
+
 /****************************************************************************
  * Name: notertt_register
  *
@@ -117,5 +190,11 @@ int notertt_register(void)
   lib_rttoutstream_open(&g_notertt.stream,
                         CONFIG_NOTE_RTT_CHANNEL,
                         CONFIG_NOTE_RTT_BUFFER_SIZE_UP);
+#ifdef CONFIG_NOTE_RTT_DEFERRED
+  notering_init(&g_notertt.ring, &g_notertt_ring[0][0],
+                CONFIG_NOTE_RTT_RING_SIZE);
+  work_queue(LPWORK, &g_notertt.work, notertt_work, &g_notertt, 0);
+#endif
+
   return note_driver_register(&g_notertt.driver);
 }
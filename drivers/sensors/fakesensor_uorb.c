@@ -278,16 +278,8 @@ static int fakesensor_batch(FAR struct sensor_lowerhalf_s *lower,
 {
   FAR struct fakesensor_s *sensor = container_of(lower,
                                                  struct fakesensor_s, lower);
-  uint32_t max_latency = sensor->lower.nbuffer * sensor->interval;
-  if (*latency_us > max_latency)
-    {
-      *latency_us = max_latency;
-    }
-  else if (*latency_us < sensor->interval && *latency_us > 0)
-    {
-      *latency_us = sensor->interval;
-    }
 
+  sensor_batch_latency(latency_us, sensor->interval, sensor->lower.nbuffer);
   sensor->batch = *latency_us;
   return OK;
 }
@@ -36,6 +36,7 @@
 
 #include <poll.h>
 #include <fcntl.h>
+#include <nuttx/arch.h>
 #include <nuttx/list.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/circbuf.h>
@@ -121,6 +122,9 @@ struct sensor_upperhalf_s
   struct circbuf_s   buffer;             /* The circular buffer of data */
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_mmap_s *ring;        /* The ring shared with mmap() users */
+#endif
 };
 
 /****************************************************************************
@@ -137,6 +141,10 @@ static ssize_t sensor_write(FAR struct file *filep, FAR const char *buffer,
                             size_t buflen);
 static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
+#ifdef CONFIG_SENSORS_MMAP
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
@@ -228,7 +236,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -569,6 +581,35 @@ static ssize_t sensor_do_samples(FAR struct sensor_upperhalf_s *upper,
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static void sensor_mmap_push(FAR struct sensor_upperhalf_s *upper,
+                             FAR const void *data, unsigned long nevent)
+{
+  FAR struct sensor_mmap_s *ring = upper->ring;
+  FAR const uint8_t *src = data;
+  FAR uint8_t *base = (FAR uint8_t *)ring->data;
+  uint32_t count = ring->count;
+
+  /* Publishers are serialized by upper->lock, seq only has to tell the
+   * lock free readers that the elements are changing under them.
+   */
+
+  ring->seq++;
+  SMP_WMB();
+
+  while (nevent-- > 0)
+    {
+      memcpy(base + (count++ % ring->nbuffer) * ring->esize, src,
+             ring->esize);
+      src += ring->esize;
+    }
+
+  ring->count = count;
+  SMP_WMB();
+  ring->seq++;
+}
+#endif
+
 static void sensor_pollnotify_one(FAR struct sensor_user_s *user,
                                   pollevent_t eventset,
                                   sensor_role_t role)
@@ -914,6 +955,13 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       case SNIOC_SET_BUFFER_NUMBER:
         {
           nxrmutex_lock(&upper->lock);
+#ifdef CONFIG_SENSORS_MMAP
+          if (upper->ring != NULL)
+            {
+              ret = -EBUSY;
+            }
+          else
+#endif
           if (!circbuf_is_init(&upper->buffer))
             {
               if (arg1 >= lower->nbuffer)
@@ -1022,6 +1070,52 @@ static int sensor_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  size_t size;
+  int ret = OK;
+
+  nxrmutex_lock(&upper->lock);
+
+  /* The ring is created by the first mapping and lives as long as the
+   * topic, it starts out empty.  It is a user heap allocation so that
+   * it is also readable from user space in the protected build.
+   */
+
+  size = sizeof(struct sensor_mmap_s) + lower->nbuffer * upper->state.esize;
+  if (upper->ring == NULL)
+    {
+      upper->ring = kumm_zalloc(size);
+      if (upper->ring == NULL)
+        {
+          ret = -ENOMEM;
+          goto out;
+        }
+
+      upper->ring->esize   = upper->state.esize;
+      upper->ring->nbuffer = lower->nbuffer;
+    }
+
+  if (map->offset < 0 || map->length == 0 || map->offset >= size ||
+      map->length > size - map->offset)
+    {
+      ret = -EINVAL;
+      goto out;
+    }
+
+  map->vaddr = (FAR char *)upper->ring + map->offset;
+
+out:
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static int sensor_poll(FAR struct file *filep,
                        FAR struct pollfd *fds, bool setup)
 {
@@ -1145,6 +1239,13 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
 
   circbuf_overwrite(&upper->buffer, data, bytes);
   sensor_generate_timing(upper, envcount);
+#ifdef CONFIG_SENSORS_MMAP
+  if (upper->ring != NULL)
+    {
+      sensor_mmap_push(upper, data, envcount);
+    }
+#endif
+
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
       if (sensor_is_updated(upper, user))
@@ -1218,6 +1319,82 @@ void sensor_remap_vector_raw16(FAR const int16_t *in, FAR int16_t *out,
   memcpy(out, tmp, sizeof(tmp));
 }
 
+/****************************************************************************
+ * Name: sensor_batch_latency
+ *
+ * Description:
+ *   Clamp a requested batch latency to what the hardware FIFO can hold and
+ *   return the number of samples per batch.
+ *
+ * Input Parameters:
+ *   latency_us - The latency asked by the upper half, updated in place.
+ *   interval   - The sample interval in us.
+ *   fifo_depth - The number of samples the hardware FIFO can hold.
+ *
+ * Returned Value:
+ *   The number of samples to collect per batch, zero if not batching.
+ *
+ ****************************************************************************/
+
+uint32_t sensor_batch_latency(FAR uint32_t *latency_us, uint32_t interval,
+                              uint32_t fifo_depth)
+{
+  uint32_t n;
+
+  if (*latency_us == 0 || interval == 0 || fifo_depth == 0)
+    {
+      *latency_us = 0;
+      return 0;
+    }
+
+  n = *latency_us / interval;
+  if (n == 0)
+    {
+      n = 1;
+    }
+  else if (n > fifo_depth)
+    {
+      n = fifo_depth;
+    }
+
+  *latency_us = n * interval;
+  return n;
+}
+
+/****************************************************************************
+ * Name: sensor_batch_timestamp
+ *
+ * Description:
+ *   Stamp n samples drained from a FIFO, spacing them back from the time
+ *   of the newest one by the sample interval.
+ *
+ * Input Parameters:
+ *   data     - The samples, oldest first.
+ *   esize    - The size of one sample.
+ *   n        - The number of samples.
+ *   newest   - The timestamp of the last sample.
+ *   interval - The sample interval in us.
+ *
+ ****************************************************************************/
+
+void sensor_batch_timestamp(FAR void *data, size_t esize, uint32_t n,
+                            uint64_t newest, uint32_t interval)
+{
+  FAR uint8_t *sample = data;
+  uint64_t timestamp;
+  uint32_t i;
+
+  DEBUGASSERT(esize >= sizeof(uint64_t));
+
+  timestamp = newest - (uint64_t)interval * (n ? n - 1 : 0);
+  for (i = 0; i < n; i++)
+    {
+      memcpy(sample, &timestamp, sizeof(timestamp));
+      sample += esize;
+      timestamp += interval;
+    }
+}
+
 /****************************************************************************
  * Name: sensor_register
  *
@@ -1449,5 +1626,12 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
       circbuf_uninit(&upper->timing);
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  if (upper->ring != NULL)
+    {
+      kumm_free(upper->ring);
+    }
+#endif
+
   kmm_free(upper);
 }
@@ -545,8 +545,8 @@ void sensor_rpmsg_push_event_persist(FAR struct sensor_rpmsg_dev_s *dev,
       cell->len     = ret;
       cell->cookie  = stub->cookie;
       cell->nbuffer = dev->lower.nbuffer;
-      rpmsg_send_nocopy(&sre->ept, msg, sizeof(*msg) +
-                        ((sizeof(*cell) + ret + 0x7) & ~0x7));
+      rpmsg_send_tx_payload(&sre->ept, msg, sizeof(*msg) +
+                            ((sizeof(*cell) + ret + 0x7) & ~0x7));
     }
   else
     {
@@ -852,6 +852,16 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
       state.interval = 0;
     }
 
+  /* A subscriber in batch mode accepts its samples up to latency late,
+   * keep half of that for the message and leave the other half to the
+   * FIFO of the sensor itself.
+   */
+
+  if (state.latency != UINT32_MAX && state.latency > state.interval)
+    {
+      state.interval = state.latency;
+    }
+
   sre = container_of(stub->ept, struct sensor_rpmsg_ept_s, ept);
   nxrmutex_lock(&sre->lock);
 
@@ -879,7 +889,14 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
         {
           if (sre->buffer)
             {
-              rpmsg_send_nocopy(&sre->ept, sre->buffer, sre->written);
+              ret = rpmsg_send_tx_payload(&sre->ept, sre->buffer,
+                                          sre->written);
+              if (ret < 0)
+                {
+                  snerr("ERROR: push event rpmsg send failed:%d, %s\n",
+                        ret, rpmsg_get_cpuname(sre->ept.rdev));
+                }
+
               sre->buffer = NULL;
             }
 
@@ -922,11 +939,12 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
     }
 
   /* If buffer timeout is expired, do rpmsg_send_nocopy, otherwise using
-   * delay work to send data.
+   * delay work to send data.  Nothing is left to send when the samples
+   * were all dropped by the interval of the subscriber.
    */
 
   now = sensor_get_timestamp();
-  if (sre->expire <= now && sre->buffer)
+  if (sre->buffer && sre->expire <= now)
     {
       ret = rpmsg_send_nocopy(&sre->ept, sre->buffer, sre->written);
       if (ret < 0)
@@ -938,7 +956,7 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
 
       sre->buffer = NULL;
     }
-  else
+  else if (sre->buffer)
     {
       if (sre->expire == UINT64_MAX ||
           sre->expire - now > state.interval / 2)
@@ -79,6 +79,14 @@
 
 #define POLL_DELAY_USEC 1000
 
+/* Word at a time test for a given byte, see uart_word_special() */
+
+#define UART_WORD_ONES  ((uintptr_t)-1 / 0xff)
+#define UART_WORD_HAS0(w) \
+  (((w) - UART_WORD_ONES) & ~(w) & (UART_WORD_ONES << 7))
+#define UART_WORD_HAS(w, c) \
+  UART_WORD_HAS0((w) ^ (UART_WORD_ONES * (uint8_t)(c)))
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -201,6 +209,37 @@ static bool uart_is_termios_hw_change(FAR struct file *filep,
   return false;
 }
 
+/****************************************************************************
+ * Name: uart_word_special
+ *
+ * Description:
+ *   Return true if any byte of an aligned word of received data might be
+ *   one of the special characters, so that uart_check_special() can step
+ *   over the plain words without looking at every byte.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGTSTP) || \
+    defined(CONFIG_TTY_FORCE_PANIC) || defined(CONFIG_TTY_LAUNCH)
+static inline_function bool uart_word_special(uintptr_t word)
+{
+  return false
+#ifdef CONFIG_TTY_FORCE_PANIC
+    || UART_WORD_HAS(word, CONFIG_TTY_FORCE_PANIC_CHAR)
+#endif
+#ifdef CONFIG_TTY_LAUNCH
+    || UART_WORD_HAS(word, CONFIG_TTY_LAUNCH_CHAR)
+#endif
+#ifdef CONFIG_TTY_SIGINT
+    || UART_WORD_HAS(word, CONFIG_TTY_SIGINT_CHAR)
+#endif
+#ifdef CONFIG_TTY_SIGTSTP
+    || UART_WORD_HAS(word, CONFIG_TTY_SIGTSTP_CHAR)
+#endif
+    ;
+}
+#endif
+
 /****************************************************************************
  * Name: uart_poll_notify
  ****************************************************************************/
@@ -964,7 +1003,32 @@ static ssize_t uart_readv(FAR struct file *filep, FAR struct uio *uio)
        */
 
       tail = rxbuf->tail;
-      if (rxbuf->head != tail)
+      if (rxbuf->head != tail &&
+          (dev->tc_iflag & (INLCR | IGNCR | ICRNL)) == 0 &&
+          (dev->tc_lflag & (ICANON | ECHO)) == 0)
+        {
+          sbuf_size_t end = rxbuf->head;
+          size_t nbytes;
+
+          /* Nothing to translate or echo, so copy the whole contiguous
+           * run straight out of the ring, which is also the RX DMA buffer
+           * when the lower half receives with DMA.
+           */
+
+          nbytes = (end > tail ? end : rxbuf->size) - tail;
+          nbytes = MIN(nbytes, buflen - recvd);
+          uio_copyfrom(uio, recvd, &rxbuf->buffer[tail], nbytes);
+          recvd += nbytes;
+
+          tail += nbytes;
+          if (tail >= rxbuf->size)
+            {
+              tail = 0;
+            }
+
+          rxbuf->tail = tail;
+        }
+      else if (rxbuf->head != tail)
         {
           /* Take the next character from the tail of the buffer */
 
@@ -2297,6 +2361,23 @@ int uart_check_special(FAR uart_dev_t *dev, FAR const char *buf, size_t size)
 
   for (i = 0; i < size; i++)
     {
+      /* Skip whole aligned words that hold none of the characters */
+
+      while (size - i >= sizeof(uintptr_t) &&
+             ((uintptr_t)&buf[i] & (sizeof(uintptr_t) - 1)) == 0 &&
+             !uart_word_special(*(FAR const uintptr_t *)&buf[i]))
+        {
+#ifdef CONFIG_TTY_FORCE_PANIC
+          dev->panic_count = 0;
+#endif
+          i += sizeof(uintptr_t);
+        }
+
+      if (i >= size)
+        {
+          break;
+        }
+
 #ifdef CONFIG_TTY_FORCE_PANIC
       if (buf[i] == CONFIG_TTY_FORCE_PANIC_CHAR)
         {
@@ -360,4 +360,68 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_dmapos
+ *
+ * Description:
+ *   Account for the bytes a circular RX DMA has written into the RX
+ *   circular buffer.  The lower half runs one never ending DMA over the
+ *   whole of dev->recv.buffer instead of arming uart_recvchars_dma()
+ *   regions, and calls this from its half transfer, full transfer and line
+ *   idle interrupts with the offset the DMA will write next, so there is
+ *   no gap between transfers and no bounce buffer to copy from.
+ *
+ *   The DMA does not know where the reader is.  If it laps the reader the
+ *   oldest data is lost, only as much as fits is accounted for and the
+ *   lower half is asked to assert RX flow control if it has any.
+ *
+ * Assumptions/Limitations:
+ *   This function may be called from an interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_dmapos(FAR uart_dev_t *dev, size_t pos)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+  size_t head = rxbuf->head;
+  size_t nbytes;
+  size_t nfree;
+
+  pos   %= rxbuf->size;
+  nbytes = (pos + rxbuf->size - head) % rxbuf->size;
+  nfree  = (rxbuf->tail + rxbuf->size - head - 1) % rxbuf->size;
+
+  if (nbytes > nfree)
+    {
+      nbytes = nfree;
+    }
+
+  if (nbytes == 0)
+    {
+      return;
+    }
+
+  /* Describe the new data as a completed transfer of one or two regions
+   * and let uart_recvchars_done() do the rest.
+   */
+
+  xfer->buffer  = &rxbuf->buffer[head];
+  xfer->length  = rxbuf->size - head;
+  xfer->nbuffer = rxbuf->buffer;
+  xfer->nlength = head;
+  xfer->nbytes  = nbytes;
+
+  uart_recvchars_done(dev);
+
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+  if (nbytes == nfree)
+    {
+      uart_rxflowcontrol(dev, rxbuf->size - 1, true);
+    }
+#endif
+}
+#endif
+
 #endif /* CONFIG_SERIAL_TXDMA || CONFIG_SERIAL_RXDMA */
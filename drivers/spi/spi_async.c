@@ -0,0 +1,211 @@
+/****************************************************************************
+ * drivers/spi/spi_async.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <nuttx/spi/spi_transfer.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct spi_async_s
+{
+  FAR struct spi_dev_s *dev;          /* The bus the requests go to */
+  FAR struct kwork_wqueue_s *wqueue;  /* The thread that runs them */
+  struct work_s work;
+  spinlock_t lock;                    /* Protects queue and running */
+  sq_queue_t queue;                   /* Requests not started yet */
+  bool running;                       /* The worker is draining queue */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR struct spi_request_s *spi_async_next(FAR struct spi_async_s *bus)
+{
+  FAR struct spi_request_s *req;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&bus->lock);
+  req = (FAR struct spi_request_s *)sq_remfirst(&bus->queue);
+  if (req == NULL)
+    {
+      bus->running = false;
+    }
+
+  spin_unlock_irqrestore(&bus->lock, flags);
+  return req;
+}
+
+/* spi_transfer() locks the bus for each sequence, so the drivers that
+ * still call it directly get the bus in between two queued requests.
+ */
+
+static void spi_async_worker(FAR void *arg)
+{
+  FAR struct spi_async_s *bus = arg;
+  FAR struct spi_request_s *req;
+  int ret;
+
+  while ((req = spi_async_next(bus)) != NULL)
+    {
+      ret = spi_transfer(bus->dev, req->seq);
+      req->callback(req, ret);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spi_async_initialize
+ *
+ * Description:
+ *   Create the request queue of a SPI bus, with the thread that performs
+ *   the queued transfers.
+ *
+ * Input Parameters:
+ *   dev - The SPI bus the requests are sent to
+ *
+ * Returned Value:
+ *   The queue handle on success, NULL if out of memory.
+ *
+ ****************************************************************************/
+
+FAR struct spi_async_s *spi_async_initialize(FAR struct spi_dev_s *dev)
+{
+  FAR struct spi_async_s *bus;
+
+  DEBUGASSERT(dev != NULL);
+
+  bus = kmm_zalloc(sizeof(struct spi_async_s));
+  if (bus == NULL)
+    {
+      return NULL;
+    }
+
+  bus->wqueue = work_queue_create("spi_async", CONFIG_SPI_ASYNC_PRIORITY,
+                                  NULL, CONFIG_SPI_ASYNC_STACKSIZE, 1);
+  if (bus->wqueue == NULL)
+    {
+      kmm_free(bus);
+      return NULL;
+    }
+
+  bus->dev = dev;
+  spin_lock_init(&bus->lock);
+  sq_init(&bus->queue);
+  return bus;
+}
+
+/****************************************************************************
+ * Name: spi_async_uninitialize
+ *
+ * Description:
+ *   Destroy a queue created by spi_async_initialize().  The requests that
+ *   were not started yet complete with -ECANCELED, the caller must make
+ *   sure that none is running.
+ *
+ * Input Parameters:
+ *   bus - The queue handle
+ *
+ ****************************************************************************/
+
+void spi_async_uninitialize(FAR struct spi_async_s *bus)
+{
+  FAR struct spi_request_s *req;
+
+  work_queue_free(bus->wqueue);
+
+  while ((req = (FAR struct spi_request_s *)sq_remfirst(&bus->queue)))
+    {
+      req->callback(req, -ECANCELED);
+    }
+
+  kmm_free(bus);
+}
+
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue req for spi_transfer() on the bus and return at once.  The queue
+ *   thread selects the device of each sequence in turn and calls back with
+ *   the result when the sequence is done; a request queued from a
+ *   callback runs without the thread going back to sleep.
+ *
+ *   Safe to call from interrupt context.  The sequence, its transactions
+ *   and their buffers must stay valid until the callback.
+ *
+ * Input Parameters:
+ *   bus - The queue handle
+ *   req - The request, with seq and callback set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer_async(FAR struct spi_async_s *bus,
+                       FAR struct spi_request_s *req)
+{
+  irqstate_t flags;
+  bool start;
+  int ret = OK;
+
+  DEBUGASSERT(req->seq != NULL && req->callback != NULL);
+
+  flags = spin_lock_irqsave(&bus->lock);
+  sq_addlast(&req->node, &bus->queue);
+  start = !bus->running;
+  bus->running = true;
+  spin_unlock_irqrestore(&bus->lock, flags);
+
+  if (start)
+    {
+      ret = work_queue_wq(bus->wqueue, &bus->work, spi_async_worker,
+                          bus, 0);
+      if (ret < 0)
+        {
+          flags = spin_lock_irqsave(&bus->lock);
+          sq_rem(&req->node, &bus->queue);
+          bus->running = false;
+          spin_unlock_irqrestore(&bus->lock, flags);
+        }
+    }
+
+  return ret;
+}
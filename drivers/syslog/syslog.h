@@ -30,6 +30,30 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <time.h>
+
+#include <nuttx/compiler.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* With CONFIG_SYSLOG_BINARY the interrupt buffer holds records: a message
+ * that still has to be formatted, its packed arguments follow the header,
+ * or plain text, when sr_fmt is NULL and the text follows the header.
+ */
+
+#ifdef CONFIG_SYSLOG_BINARY
+begin_packed_struct struct syslog_record_s
+{
+  uint16_t             sr_size;     /* Size of the record with its data */
+  uint8_t              sr_priority; /* LOG_* priority of the message */
+  uint8_t              sr_cpu;      /* CPU the message came from */
+  pid_t                sr_pid;      /* Thread the message came from */
+  struct timespec      sr_ts;       /* Time of the message */
+  FAR const IPTR char *sr_fmt;      /* Format string, NULL for text */
+} end_packed_struct;
+#endif
 
 /****************************************************************************
  * Public Data
@@ -191,6 +215,8 @@ void syslog_register(void);
  *   Add one more character to the interrupt buffer.  In the event of
  *   buffer overflowed, the character will be dropped.  The indication
  *   "[truncated]\n" will be appended to the end of the interrupt buffer.
+ *   With CONFIG_SYSLOG_DEFERRED the buffer is also written out on the low
+ *   priority work queue and a message that does not fit is counted.
  *
  * Input Parameters:
  *   ch - The character to add to the interrupt buffer (must be positive).
@@ -229,6 +255,36 @@ void syslog_add_intbuffer(FAR const char *buffer, size_t buflen);
 void syslog_flush_intbuffer(bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_add_record
+ *
+ * Description:
+ *   Add a message record, header and packed arguments, to the interrupt
+ *   buffer or count it as dropped if it does not fit.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+void syslog_add_record(FAR const struct syslog_record_s *rec);
+#endif
+
+/****************************************************************************
+ * Name: syslog_write_record
+ *
+ * Description:
+ *   Format a message record, prefix included, and write it out to the
+ *   channels.  The packed arguments follow the header in memory.
+ *
+ * Input Parameters:
+ *   rec   - The record
+ *   force - Use the force() method of the channel vs. the putc() method.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+void syslog_write_record(FAR const struct syslog_record_s *rec, bool force);
+#endif
+
 /****************************************************************************
  * Name: syslog_write_foreach
  *
@@ -28,12 +28,17 @@
 
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 
 #include <nuttx/syslog/syslog.h>
+#include <nuttx/atomic.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/ringbuf.h>
 #include <nuttx/spinlock.h>
-#include <nuttx/circbuf.h>
+#include <nuttx/wqueue.h>
 
 #include "syslog.h"
 
@@ -43,22 +48,41 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#if CONFIG_SYSLOG_INTBUFSIZE > 65535
+#if CONFIG_SYSLOG_INTBUFSIZE > 32768
 #  undef  CONFIG_SYSLOG_INTBUFSIZE
-#  define CONFIG_SYSLOG_INTBUFSIZE 65535
+#  define CONFIG_SYSLOG_INTBUFSIZE 32768
+#endif
+
+#if (CONFIG_SYSLOG_INTBUFSIZE & (CONFIG_SYSLOG_INTBUFSIZE - 1)) != 0
+#  error "CONFIG_SYSLOG_INTBUFSIZE must be a power of two"
+#endif
+
+/* The size of the record header in front of each entry */
+
+#ifdef CONFIG_SYSLOG_BINARY
+#  define SYSLOG_HDRSIZE sizeof(struct syslog_record_s)
+#else
+#  define SYSLOG_HDRSIZE 0
 #endif
 
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-/* This structure encapsulates the interrupt buffer state */
+/* This structure encapsulates the interrupt buffer state.  The producers
+ * add characters without taking a lock, the lock only serializes the
+ * flushes, which consume the ring.
+ */
 
 struct syslog_intbuffer_s
 {
-  struct circbuf_s circ;
+  struct ringbuf_s ring;
   spinlock_t       splock;
   uint8_t          buffer[CONFIG_SYSLOG_INTBUFSIZE];
+#ifdef CONFIG_SYSLOG_DEFERRED
+  atomic_t         dropped;  /* Messages dropped since the last report */
+  struct work_s    work;     /* Drains the buffer */
+#endif
 };
 
 /****************************************************************************
@@ -67,7 +91,7 @@ struct syslog_intbuffer_s
 
 static struct syslog_intbuffer_s g_syslog_intbuffer =
 {
-  CIRCBUF_INITIALIZER(g_syslog_intbuffer.buffer,
+  RINGBUF_INITIALIZER(g_syslog_intbuffer.buffer,
                       sizeof(g_syslog_intbuffer.buffer)),
   SP_UNLOCKED,
 };
@@ -76,6 +100,103 @@ static struct syslog_intbuffer_s g_syslog_intbuffer =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: syslog_intbuffer_copy
+ *
+ * Description:
+ *   Copy out 'len' bytes from position 'pos' of the ring, across its end.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+static void syslog_intbuffer_copy(uint32_t pos, FAR void *dest, size_t len)
+{
+  FAR struct ringbuf_s *ring = &g_syslog_intbuffer.ring;
+  size_t off = pos & ring->mask;
+  size_t n = MIN(len, ring->mask + 1 - off);
+
+  memcpy(dest, ring->base + off, n);
+  memcpy((FAR uint8_t *)dest + n, ring->base, len - n);
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_intbuffer_output
+ *
+ * Description:
+ *   Write out the oldest entry of the interrupt buffer to the channels
+ *   without releasing it: a contiguous run of at most buflen characters,
+ *   or one record with CONFIG_SYSLOG_BINARY.
+ *
+ * Returned Value:
+ *   The number of bytes to release, zero if the buffer is empty.
+ *
+ ****************************************************************************/
+
+static size_t syslog_intbuffer_output(bool force, size_t buflen)
+{
+  FAR struct ringbuf_s *ring = &g_syslog_intbuffer.ring;
+#ifdef CONFIG_SYSLOG_BINARY
+  uint8_t rec[SYSLOG_HDRSIZE + CONFIG_SYSLOG_BINARY_ARGSIZE];
+  FAR struct syslog_record_s *hdr = (FAR struct syslog_record_s *)rec;
+  uint32_t tail = atomic_read(&ring->tail);
+  size_t used = ringbuf_used(ring);
+  size_t off;
+  size_t len;
+
+  if (used < SYSLOG_HDRSIZE)
+    {
+      return 0;
+    }
+
+  syslog_intbuffer_copy(tail, hdr, SYSLOG_HDRSIZE);
+  if (hdr->sr_size < SYSLOG_HDRSIZE || hdr->sr_size > used)
+    {
+      /* Nothing sane to parse any more, drop it all */
+
+      return used;
+    }
+
+  if (hdr->sr_fmt != NULL)
+    {
+      if (hdr->sr_size <= sizeof(rec))
+        {
+          syslog_intbuffer_copy(tail, rec, hdr->sr_size);
+          syslog_write_record(hdr, force);
+        }
+
+      return hdr->sr_size;
+    }
+
+  /* Plain text, write it out in place */
+
+  off = (tail + SYSLOG_HDRSIZE) & ring->mask;
+  len = hdr->sr_size - SYSLOG_HDRSIZE;
+  used = MIN(len, ring->mask + 1 - off);
+
+  syslog_write_foreach((FAR char *)ring->base + off, used, force);
+  if (len > used)
+    {
+      syslog_write_foreach((FAR char *)ring->base, len - used, force);
+    }
+
+  UNUSED(buflen);
+  return hdr->sr_size;
+#else
+  FAR char *buffer;
+  size_t size;
+
+  buffer = ringbuf_read_peek(ring, &size);
+  if (size > 0)
+    {
+      size = MIN(size, buflen);
+      syslog_write_foreach(buffer, size, force);
+    }
+
+  return size;
+#endif
+}
+
 /****************************************************************************
  * Name: syslog_flush_internal
  *
@@ -90,33 +211,122 @@ static struct syslog_intbuffer_s g_syslog_intbuffer =
  *   None
  *
  * Assumptions:
- *   Interrupts may or may not be disabled.
+ *   The caller holds the flush lock, so that this is the only consumer.
  *
  ****************************************************************************/
 
 static void syslog_flush_internal(bool force, size_t buflen)
 {
-  FAR char *buffer;
   size_t size;
 
-  /* This logic is performed with the scheduler disabled to protect from
-   * concurrent modification by other tasks.
-   */
-
   do
     {
-      buffer = circbuf_get_readptr(&g_syslog_intbuffer.circ, &size);
+      size = syslog_intbuffer_output(force, buflen);
       if (size > 0)
         {
-          size = (size >= buflen) ? buflen : size;
-          syslog_write_foreach(buffer, size, force);
-          circbuf_readcommit(&g_syslog_intbuffer.circ, size);
-          buflen -= size;
+          ringbuf_read_commit(&g_syslog_intbuffer.ring, size);
+          buflen -= MIN(size, buflen);
         }
     }
   while (size > 0 && buflen > 0);
 }
 
+/****************************************************************************
+ * Name: syslog_deferred_worker
+ *
+ * Description:
+ *   Write the buffered output out to the channels on the low priority work
+ *   queue.  The lock is only held to claim and to release the data, never
+ *   while a channel writes, so producers and interrupts are not held up by
+ *   a slow channel.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+static void syslog_deferred_worker(FAR void *arg)
+{
+  FAR struct ringbuf_s *ring = &g_syslog_intbuffer.ring;
+  irqstate_t flags;
+  char msg[32];
+  uint32_t tail;
+  size_t size;
+  int dropped;
+
+  for (; ; )
+    {
+      tail = atomic_read(&ring->tail);
+      size = syslog_intbuffer_output(false, SIZE_MAX);
+      if (size == 0)
+        {
+          break;
+        }
+
+      /* A forced flush may have consumed the data meanwhile */
+
+      flags = spin_lock_irqsave_notrace(&g_syslog_intbuffer.splock);
+      if ((uint32_t)atomic_read(&ring->tail) == tail)
+        {
+          ringbuf_read_commit(ring, size);
+        }
+
+      spin_unlock_irqrestore_notrace(&g_syslog_intbuffer.splock, flags);
+    }
+
+  dropped = atomic_xchg(&g_syslog_intbuffer.dropped, 0);
+  if (dropped > 0)
+    {
+      size = snprintf(msg, sizeof(msg), "[%d messages dropped]\n",
+                      dropped);
+      syslog_write_foreach(msg, size, false);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: syslog_intbuffer_push
+ *
+ * Description:
+ *   Add a header and its data to the interrupt buffer and have the work
+ *   queue write them out, or count them as dropped if they do not fit.
+ *
+ * Assumptions:
+ *   The local interrupts are disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+static void syslog_intbuffer_push(FAR const void *hdr, size_t hlen,
+                                  FAR const void *data, size_t dlen)
+{
+  FAR struct ringbuf_s *ring = &g_syslog_intbuffer.ring;
+  uint32_t pos;
+
+  if (!ringbuf_mp_reserve(ring, hlen + dlen, &pos))
+    {
+      atomic_fetch_add(&g_syslog_intbuffer.dropped, 1);
+      return;
+    }
+
+  if (hlen > 0)
+    {
+      ringbuf_copyat(ring, pos, hdr, hlen);
+    }
+
+  if (dlen > 0)
+    {
+      ringbuf_copyat(ring, pos + hlen, data, dlen);
+    }
+
+  ringbuf_mp_commit(ring, pos, hlen + dlen);
+
+  if (work_available(&g_syslog_intbuffer.work))
+    {
+      work_queue(LPWORK, &g_syslog_intbuffer.work,
+                 syslog_deferred_worker, NULL, 0);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -138,43 +348,103 @@ static void syslog_flush_internal(bool force, size_t buflen)
  * Assumptions:
  *   - Called either from (1) interrupt handling logic with interrupts
  *     disabled or from an IDLE thread with interrupts enabled.
- *   - Requires caution because there may be an interrupted execution of
- *     syslog_flush_intbuffer():  Only the outndx can be modified.
+ *   - Producers on other CPUs and an interrupted execution of
+ *     syslog_flush_intbuffer() may access the buffer concurrently.
  *
  ****************************************************************************/
 
 void syslog_add_intbuffer(FAR const char *buffer, size_t buflen)
 {
+  FAR struct ringbuf_s *ring = &g_syslog_intbuffer.ring;
+#ifdef CONFIG_SYSLOG_BINARY
+  struct syslog_record_s hdr;
+#endif
   irqstate_t flags;
   size_t space;
+  uint32_t pos;
 
-  /* Disable concurrent modification from interrupt handling logic */
+#ifdef CONFIG_SYSLOG_BINARY
+  memset(&hdr, 0, sizeof(hdr));
+#endif
 
-  flags = spin_lock_irqsave_notrace(&g_syslog_intbuffer.splock);
+  /* Keep the interrupt handlers of this CPU from claiming space while our
+   * claim is pending.  This does not exclude the other CPUs.
+   */
 
-  space = circbuf_space(&g_syslog_intbuffer.circ);
+  flags = up_irq_save();
 
-  if (space >= buflen)
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Drop what does not fit rather than wait for the channels, unless the
+   * system is going down and nobody else will write it out.
+   */
+
+  if (!OSINIT_IS_PANIC())
     {
-      circbuf_write(&g_syslog_intbuffer.circ, buffer, buflen);
+#ifdef CONFIG_SYSLOG_BINARY
+      hdr.sr_size = SYSLOG_HDRSIZE + buflen;
+      syslog_intbuffer_push(&hdr, SYSLOG_HDRSIZE, buffer, buflen);
+#else
+      syslog_intbuffer_push(NULL, 0, buffer, buflen);
+#endif
+      up_irq_restore(flags);
+      return;
     }
-  else if (buflen <= sizeof(g_syslog_intbuffer.buffer))
+#endif
+
+  if (SYSLOG_HDRSIZE + buflen > sizeof(g_syslog_intbuffer.buffer))
     {
-      syslog_flush_internal(true, buflen - space);
-      circbuf_write(&g_syslog_intbuffer.circ, buffer, buflen);
+      /* Flush the buffer and write out what cannot be buffered directly */
+
+      syslog_flush_intbuffer(true);
+      space = SYSLOG_HDRSIZE + buflen - sizeof(g_syslog_intbuffer.buffer);
+      syslog_write_foreach(buffer, space, true);
+      buffer += space;
+      buflen -= space;
     }
-  else
+
+  while (!ringbuf_mp_reserve(ring, SYSLOG_HDRSIZE + buflen, &pos))
     {
-      syslog_flush_internal(true, sizeof(g_syslog_intbuffer.buffer));
-      space = buflen - sizeof(g_syslog_intbuffer.buffer);
-      syslog_write_foreach(buffer, space, true);
-      circbuf_write(&g_syslog_intbuffer.circ,
-                    buffer + space, buflen - space);
+      irqstate_t lflags;
+
+      /* Not enough space, force the oldest characters out */
+
+      space = ringbuf_space(ring);
+      lflags = spin_lock_irqsave_notrace(&g_syslog_intbuffer.splock);
+      syslog_flush_internal(true, SYSLOG_HDRSIZE + buflen > space ?
+                                  SYSLOG_HDRSIZE + buflen - space : 1);
+      spin_unlock_irqrestore_notrace(&g_syslog_intbuffer.splock, lflags);
     }
 
-  spin_unlock_irqrestore_notrace(&g_syslog_intbuffer.splock, flags);
+#ifdef CONFIG_SYSLOG_BINARY
+  hdr.sr_size = SYSLOG_HDRSIZE + buflen;
+  ringbuf_copyat(ring, pos, &hdr, SYSLOG_HDRSIZE);
+#endif
+
+  ringbuf_copyat(ring, pos + SYSLOG_HDRSIZE, buffer, buflen);
+  ringbuf_mp_commit(ring, pos, SYSLOG_HDRSIZE + buflen);
+  up_irq_restore(flags);
 }
 
+/****************************************************************************
+ * Name: syslog_add_record
+ *
+ * Description:
+ *   Add a message record, header and packed arguments, to the interrupt
+ *   buffer for the work queue to format, or count it as dropped if it does
+ *   not fit.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+void syslog_add_record(FAR const struct syslog_record_s *rec)
+{
+  irqstate_t flags = up_irq_save();
+
+  syslog_intbuffer_push(rec, rec->sr_size, NULL, 0);
+  up_irq_restore(flags);
+}
+#endif
+
 /****************************************************************************
  * Name: syslog_flush_intbuffer
  *
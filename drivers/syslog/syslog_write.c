@@ -30,6 +30,7 @@
 #include <assert.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/init.h>
 #include <nuttx/sched.h>
 #include <nuttx/syslog/syslog.h>
 
@@ -241,6 +242,16 @@ ssize_t syslog_write(FAR const char *buffer, size_t buflen)
 {
   bool force = !syslog_safe_to_block();
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Once the work queue runs, leave all output to it */
+
+  if (OSINIT_IDLELOOP() && !OSINIT_IS_PANIC())
+    {
+      syslog_add_intbuffer(buffer, buflen);
+      return buflen;
+    }
+#endif
+
 #ifdef CONFIG_SYSLOG_INTBUFFER
   if (force)
     {
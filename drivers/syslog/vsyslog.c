@@ -27,17 +27,63 @@
 #include <nuttx/config.h>
 
 #include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
 #include <syslog.h>
 #include <errno.h>
 
 #include <nuttx/arch.h>
 #include <nuttx/init.h>
 #include <nuttx/clock.h>
+#include <nuttx/sched.h>
 #include <nuttx/streams.h>
 #include <nuttx/syslog/syslog.h>
 
 #include "syslog.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Only look up what the prefix shows, the task lists may not be there yet
+ * early in the start-up sequence.
+ */
+
+#ifdef CONFIG_SMP
+#  define SYSLOG_CPU  this_cpu()
+#else
+#  define SYSLOG_CPU  0
+#endif
+
+#ifdef CONFIG_SYSLOG_PROCESSID
+#  define SYSLOG_PID  nxsched_gettid()
+#else
+#  define SYSLOG_PID  0
+#endif
+
+#ifdef CONFIG_SYSLOG_PROCESS_NAME
+#  define SYSLOG_NAME get_task_name(nxsched_self())
+#else
+#  define SYSLOG_NAME NULL
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Writes a formatted record straight to the channels */
+
+#ifdef CONFIG_SYSLOG_BINARY
+struct syslog_recstream_s
+{
+  struct lib_outstream_s common;
+  bool                   force;
+  int                    last_ch;
+  size_t                 len;
+  char                   buffer[64];
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -65,94 +111,54 @@ static FAR const char * const g_priority_str[] =
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nx_vsyslog
+ * Name: syslog_prefix
  *
  * Description:
- *   nx_vsyslog() handles the system logging system calls. It is functionally
- *   equivalent to vsyslog() except that (1) the per-process priority
- *   filtering has already been performed and the va_list parameter is
- *   passed by reference.  That is because the va_list is a structure in
- *   some compilers and passing of structures in the NuttX sycalls does
- *   not work.
+ *   Output the configured prefix of a message: time stamp, CPU, thread,
+ *   priority and so on.
  *
  ****************************************************************************/
 
-int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+static int syslog_prefix(FAR struct lib_outstream_s *stream, int priority,
+                         FAR const struct timespec *ts, int cpu, pid_t pid,
+                         FAR const char *name)
 {
-  struct lib_syslograwstream_s stream;
   int ret = 0;
-#ifdef CONFIG_SYSLOG_PROCESS_NAME
-  FAR struct tcb_s *tcb = nxsched_self();
-#endif
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  struct timespec ts;
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
+#if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   struct tm tm;
   char date_buf[CONFIG_SYSLOG_TIMESTAMP_BUFFER];
-#  endif
-#endif
-
-  /* Wrap the low-level output in a stream object and let lib_vsprintf
-   * do the work.
-   */
 
-  lib_syslograwstream_open(&stream);
-
-#ifdef CONFIG_SYSLOG_TIMESTAMP
-  ts.tv_sec = 0;
-  ts.tv_nsec = 0;
-
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   memset(&tm, 0, sizeof(tm));
-#  endif
-
-  /* Get the current time.  Since debug output may be generated very early
-   * in the start-up sequence, hardware timer support may not yet be
-   * available.
-   */
-
-  if (OSINIT_HW_READY())
+  if (ts->tv_sec != 0 || ts->tv_nsec != 0)
     {
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
-      /* Use CLOCK_REALTIME if so configured */
-
-      clock_gettime(CLOCK_REALTIME, &ts);
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
+      localtime_r(&ts->tv_sec, &tm);
 #  else
-      /* Prefer monotonic when enabled, as it can be synchronized to
-       * RTC with clock_resynchronize.
-       */
-
-      clock_gettime(CLOCK_MONOTONIC, &ts);
-#  endif
-
-      /* Prepend the message with the current time, if available */
-
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
-#    if defined(CONFIG_SYSLOG_TIMESTAMP_LOCALTIME)
-      localtime_r(&ts.tv_sec, &tm);
-#    else
-      gmtime_r(&ts.tv_sec, &tm);
-#    endif
+      gmtime_r(&ts->tv_sec, &tm);
 #  endif
     }
 
-#  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
   date_buf[0] = '\0';
   strftime(date_buf, CONFIG_SYSLOG_TIMESTAMP_BUFFER,
            CONFIG_SYSLOG_TIMESTAMP_FORMAT, &tm);
-#  endif
 #endif
 
+  UNUSED(priority);
+  UNUSED(ts);
+  UNUSED(cpu);
+  UNUSED(pid);
+  UNUSED(name);
+
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT) || defined(CONFIG_SYSLOG_TIMESTAMP) || \
     defined(CONFIG_SMP) || defined(CONFIG_SYSLOG_PROCESSID) || \
     defined(CONFIG_SYSLOG_PRIORITY) || defined(CONFIG_SYSLOG_PREFIX) || \
     defined(CONFIG_SYSLOG_PROCESS_NAME)
 
-  ret = lib_sprintf_internal(&stream.common,
+  ret = lib_sprintf_internal(stream,
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
   /* Reset the terminal style. */
 
@@ -206,24 +212,24 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_TIMESTAMP
 #  if defined(CONFIG_SYSLOG_TIMESTAMP_FORMATTED)
 #    if defined(CONFIG_SYSLOG_TIMESTAMP_FORMAT_MICROSECOND)
-                             , date_buf, ts.tv_nsec / NSEC_PER_USEC
+                             , date_buf, ts->tv_nsec / NSEC_PER_USEC
 #    else
                              , date_buf
 #    endif
 #  else
-                             , (uintmax_t)ts.tv_sec
-                             , ts.tv_nsec / NSEC_PER_USEC
+                             , (uintmax_t)ts->tv_sec
+                             , ts->tv_nsec / NSEC_PER_USEC
 #  endif
 #endif
 
 #if defined(CONFIG_SMP)
-                             , this_cpu()
+                             , cpu
 #endif
 
 #if defined(CONFIG_SYSLOG_PROCESSID)
   /* Prepend the Thread ID */
 
-                             , nxsched_gettid()
+                             , pid
 #endif
 
 #if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
@@ -247,12 +253,224 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #ifdef CONFIG_SYSLOG_PROCESS_NAME
   /* Prepend the thread name */
 
-                             , get_task_name(tcb)
+                             , name
 #endif
                     );
 
 #endif /* CONFIG_SYSLOG_COLOR_OUTPUT || CONFIG_SYSLOG_TIMESTAMP || ... */
 
+  return ret;
+}
+
+/****************************************************************************
+ * Name: syslog_recstream_*
+ *
+ * Description:
+ *   A small buffered stream that hands its output to
+ *   syslog_write_foreach(), used by syslog_write_record() which runs where
+ *   syslog_write() would only queue the output again.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+static int syslog_recstream_flush(FAR struct lib_outstream_s *self)
+{
+  FAR struct syslog_recstream_s *stream = (FAR void *)self;
+
+  if (stream->len > 0)
+    {
+      syslog_write_foreach(stream->buffer, stream->len, stream->force);
+      stream->len = 0;
+    }
+
+  return OK;
+}
+
+static void syslog_recstream_putc(FAR struct lib_outstream_s *self, int ch)
+{
+  FAR struct syslog_recstream_s *stream = (FAR void *)self;
+
+  stream->buffer[stream->len++] = ch;
+  stream->last_ch = ch;
+  self->nput++;
+
+  if (stream->len >= sizeof(stream->buffer))
+    {
+      syslog_recstream_flush(self);
+    }
+}
+
+static ssize_t syslog_recstream_puts(FAR struct lib_outstream_s *self,
+                                     FAR const void *buf, size_t len)
+{
+  FAR const char *ptr = buf;
+  size_t i;
+
+  for (i = 0; i < len; i++)
+    {
+      syslog_recstream_putc(self, ptr[i]);
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: syslog_add_binary
+ *
+ * Description:
+ *   Queue the message as a record of its format string and its packed
+ *   arguments instead of formatting it.
+ *
+ * Returned Value:
+ *   Zero if the record has been queued or dropped, a negated errno value
+ *   if the message has to be formatted right away.
+ *
+ ****************************************************************************/
+
+static int syslog_add_binary(int priority, FAR const struct timespec *ts,
+                             FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  uint8_t buf[sizeof(struct syslog_record_s) +
+              CONFIG_SYSLOG_BINARY_ARGSIZE];
+  FAR struct syslog_record_s *rec = (FAR struct syslog_record_s *)buf;
+  va_list copy;
+  ssize_t len;
+
+  va_copy(copy, *ap);
+  len = lib_vbspack(rec + 1, CONFIG_SYSLOG_BINARY_ARGSIZE, fmt, copy);
+  va_end(copy);
+
+  if (len < 0)
+    {
+      return len;
+    }
+
+  rec->sr_size     = sizeof(*rec) + len;
+  rec->sr_priority = priority;
+  rec->sr_cpu      = this_cpu();
+  rec->sr_pid      = nxsched_gettid();
+  rec->sr_ts       = *ts;
+  rec->sr_fmt      = fmt;
+
+  syslog_add_record(rec);
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_write_record
+ *
+ * Description:
+ *   Format a message record queued by nx_vsyslog() with its prefix and
+ *   write it out to the channels.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_BINARY
+void syslog_write_record(FAR const struct syslog_record_s *rec, bool force)
+{
+  struct syslog_recstream_s stream;
+  struct timespec ts = rec->sr_ts;
+  FAR struct tcb_s *tcb;
+
+  memset(&stream, 0, sizeof(stream));
+  stream.common.putc  = syslog_recstream_putc;
+  stream.common.puts  = syslog_recstream_puts;
+  stream.common.flush = syslog_recstream_flush;
+  stream.force        = force;
+
+  /* The thread may have gone since */
+
+  tcb = nxsched_get_tcb(rec->sr_pid);
+
+  syslog_prefix(&stream.common, rec->sr_priority, &ts,
+                rec->sr_cpu, rec->sr_pid,
+                tcb != NULL ? get_task_name(tcb) : "?");
+  lib_bsprintf(&stream.common, rec->sr_fmt, rec + 1);
+
+  if (stream.last_ch != '\n')
+    {
+      lib_stream_putc(&stream.common, '\n');
+    }
+
+#if defined(CONFIG_SYSLOG_COLOR_OUTPUT)
+  lib_stream_puts(&stream.common, "\e[0m", sizeof("\e[0m"));
+#endif
+
+  syslog_recstream_flush(&stream.common);
+}
+#endif
+
+/****************************************************************************
+ * Name: nx_vsyslog
+ *
+ * Description:
+ *   nx_vsyslog() handles the system logging system calls. It is functionally
+ *   equivalent to vsyslog() except that (1) the per-process priority
+ *   filtering has already been performed and the va_list parameter is
+ *   passed by reference.  That is because the va_list is a structure in
+ *   some compilers and passing of structures in the NuttX sycalls does
+ *   not work.
+ *
+ *   With CONFIG_SYSLOG_BINARY the message is normally queued unformatted
+ *   and zero is returned.
+ *
+ ****************************************************************************/
+
+int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  struct lib_syslograwstream_s stream;
+  struct timespec ts;
+  int ret = 0;
+
+  ts.tv_sec = 0;
+  ts.tv_nsec = 0;
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  /* Get the current time.  Since debug output may be generated very early
+   * in the start-up sequence, hardware timer support may not yet be
+   * available.
+   */
+
+  if (OSINIT_HW_READY())
+    {
+#  if defined(CONFIG_SYSLOG_TIMESTAMP_REALTIME)
+      /* Use CLOCK_REALTIME if so configured */
+
+      clock_gettime(CLOCK_REALTIME, &ts);
+#  else
+      /* Prefer monotonic when enabled, as it can be synchronized to
+       * RTC with clock_resynchronize.
+       */
+
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+#  endif
+    }
+#endif
+
+#ifdef CONFIG_SYSLOG_BINARY
+  /* Leave the formatting to the work queue once it runs the output */
+
+  if (OSINIT_IDLELOOP() && !OSINIT_IS_PANIC() &&
+      syslog_add_binary(priority, &ts, fmt, ap) >= 0)
+    {
+      return 0;
+    }
+#endif
+
+  /* Wrap the low-level output in a stream object and let lib_vsprintf
+   * do the work.
+   */
+
+  lib_syslograwstream_open(&stream);
+
+  ret = syslog_prefix(&stream.common, priority, &ts, SYSLOG_CPU,
+                      SYSLOG_PID, SYSLOG_NAME);
+
   /* Generate the output */
 
   ret += lib_vsprintf_internal(&stream.common, fmt, *ap);
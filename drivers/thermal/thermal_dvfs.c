@@ -0,0 +1,458 @@
+/****************************************************************************
+ * drivers/thermal/thermal_dvfs.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/clk/clk.h>
+#include <nuttx/thermal.h>
+
+#include "thermal_core.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define DVFS_PERIOD   MSEC2TICK(CONFIG_THERMAL_DVFS_PERIOD)
+
+/* The loads are in permille */
+
+#define DVFS_UP_LOAD  (CONFIG_THERMAL_DVFS_UP_THRESHOLD * 10)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One clock domain, the CPUs that share a clock */
+
+struct thermal_dvfs_s
+{
+  FAR struct thermal_cooling_device_s *cdev;
+  FAR struct clk_s *clk;
+  FAR const uint32_t *freqs;        /* The frequencies, lowest first */
+  unsigned int nfreqs;
+  cpu_set_t cpus;                   /* The CPUs clocked by clk */
+  mutex_t lock;                     /* Protects the fields below */
+  struct work_s work;               /* Samples the load */
+  bool stopped;                     /* Do not sample the load any more */
+  unsigned int cur;                 /* Index of the current frequency */
+  unsigned int max;                 /* Highest index the zones allow */
+  unsigned int load;                /* Load of the busiest CPU */
+
+  /* The load of each idle thread at the last sample */
+
+  struct cpuload_s last[CONFIG_SMP_NCPUS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int dvfs_get_max_state(FAR struct thermal_cooling_device_s *cdev,
+                              FAR unsigned int *state);
+static int dvfs_get_state    (FAR struct thermal_cooling_device_s *cdev,
+                              FAR unsigned int *state);
+static int dvfs_set_state    (FAR struct thermal_cooling_device_s *cdev,
+                              unsigned int state);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct thermal_cooling_device_ops_s g_dvfs_cdev_ops =
+{
+  .set_state     = dvfs_set_state,
+  .get_state     = dvfs_get_state,
+  .get_max_state = dvfs_get_max_state,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dvfs_set_freq
+ *
+ * Description:
+ *   Switch the clock to the frequency of the index.
+ *
+ ****************************************************************************/
+
+static int dvfs_set_freq(FAR struct thermal_dvfs_s *dvfs,
+                         unsigned int index)
+{
+  int ret;
+
+  ret = clk_set_rate(dvfs->clk, dvfs->freqs[index]);
+  if (ret < 0)
+    {
+      therr("Set rate %" PRIu32 " failed: %d\n", dvfs->freqs[index], ret);
+      return ret;
+    }
+
+  dvfs->cur = index;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dvfs_set_capacity
+ *
+ * Description:
+ *   Tell the scheduler the capacity of the CPUs, the highest frequency
+ *   that the thermal zones allow.  An idle CPU runs at a low frequency,
+ *   but it is not throttled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPU_CAPACITY
+static void dvfs_set_capacity(FAR struct thermal_dvfs_s *dvfs)
+{
+  unsigned int capacity;
+  int cpu;
+
+  capacity = (uint64_t)dvfs->freqs[dvfs->max] * SCHED_CAPACITY_SCALE /
+             dvfs->freqs[dvfs->nfreqs - 1];
+  if (capacity == 0)
+    {
+      capacity = 1;
+    }
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if ((dvfs->cpus & (1 << cpu)) != 0)
+        {
+          nxsched_set_cpu_capacity(cpu, capacity);
+        }
+    }
+}
+#else
+#  define dvfs_set_capacity(dvfs)
+#endif
+
+/****************************************************************************
+ * Name: dvfs_sample
+ *
+ * Description:
+ *   Measure the load of the busiest CPU since the last sample.  Each CPU
+ *   adds its ticks to the total, so the idle thread of a CPU that did
+ *   nothing has 1 / CONFIG_SMP_NCPUS of the ticks added.  The counts are
+ *   halved from time to time and drop when a task exits, the previous
+ *   load is kept then.
+ *
+ ****************************************************************************/
+
+static void dvfs_sample(FAR struct thermal_dvfs_s *dvfs)
+{
+  FAR struct cpuload_s *last;
+  struct cpuload_s cpuload;
+  unsigned int load = 0;
+  bool valid = true;
+  uint64_t idle;
+  clock_t total;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      if ((dvfs->cpus & (1 << cpu)) == 0 ||
+          clock_cpuload(cpu, &cpuload) < 0)
+        {
+          continue;
+        }
+
+      last = &dvfs->last[cpu];
+      if (cpuload.total <= last->total || cpuload.active < last->active)
+        {
+          valid = false;
+        }
+      else
+        {
+          total = cpuload.total - last->total;
+          idle  = (uint64_t)(cpuload.active - last->active) *
+                  CONFIG_SMP_NCPUS * 1000;
+
+          if (idle < (uint64_t)total * 1000)
+            {
+              load = MAX(load, 1000 - (unsigned int)(idle / total));
+            }
+        }
+
+      *last = cpuload;
+    }
+
+  if (valid)
+    {
+      dvfs->load = load;
+    }
+}
+
+/****************************************************************************
+ * Name: dvfs_target
+ *
+ * Description:
+ *   Choose the frequency for the load.  At the threshold the highest one
+ *   allowed is taken at once, below it the frequency goes down one step
+ *   at a time towards the lowest one that keeps the load under the
+ *   threshold.
+ *
+ ****************************************************************************/
+
+static unsigned int dvfs_target(FAR struct thermal_dvfs_s *dvfs)
+{
+  uint64_t need;
+  unsigned int index;
+
+  if (dvfs->load >= DVFS_UP_LOAD)
+    {
+      return dvfs->max;
+    }
+
+  need = (uint64_t)dvfs->freqs[dvfs->cur] * dvfs->load / DVFS_UP_LOAD;
+  for (index = 0; index < dvfs->max && dvfs->freqs[index] < need;
+       index++);
+
+  if (index < dvfs->cur)
+    {
+      index = dvfs->cur - 1;
+    }
+
+  return MIN(index, dvfs->max);
+}
+
+/****************************************************************************
+ * Name: dvfs_work
+ ****************************************************************************/
+
+static void dvfs_work(FAR void *arg)
+{
+  FAR struct thermal_dvfs_s *dvfs = arg;
+  unsigned int target;
+
+  nxmutex_lock(&dvfs->lock);
+  if (dvfs->stopped)
+    {
+      nxmutex_unlock(&dvfs->lock);
+      return;
+    }
+
+  dvfs_sample(dvfs);
+  target = dvfs_target(dvfs);
+  if (target != dvfs->cur)
+    {
+      dvfs_set_freq(dvfs, target);
+    }
+
+  work_queue_next(LPWORK, &dvfs->work, dvfs_work, dvfs, DVFS_PERIOD);
+  nxmutex_unlock(&dvfs->lock);
+}
+
+/****************************************************************************
+ * Name: dvfs_get_max_state
+ ****************************************************************************/
+
+static int dvfs_get_max_state(FAR struct thermal_cooling_device_s *cdev,
+                              FAR unsigned int *state)
+{
+  FAR struct thermal_dvfs_s *dvfs = cdev->devdata;
+
+  *state = dvfs->nfreqs - 1;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dvfs_get_state
+ ****************************************************************************/
+
+static int dvfs_get_state(FAR struct thermal_cooling_device_s *cdev,
+                          FAR unsigned int *state)
+{
+  FAR struct thermal_dvfs_s *dvfs = cdev->devdata;
+
+  nxmutex_lock(&dvfs->lock);
+  *state = dvfs->nfreqs - 1 - dvfs->max;
+  nxmutex_unlock(&dvfs->lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: dvfs_set_state
+ *
+ * Description:
+ *   Cooling state N takes the N highest frequencies away.  A lower limit
+ *   is applied at once, not at the next sample.
+ *
+ ****************************************************************************/
+
+static int dvfs_set_state(FAR struct thermal_cooling_device_s *cdev,
+                          unsigned int state)
+{
+  FAR struct thermal_dvfs_s *dvfs = cdev->devdata;
+  int ret = OK;
+
+  if (state >= dvfs->nfreqs)
+    {
+      return -EINVAL;
+    }
+
+  nxmutex_lock(&dvfs->lock);
+  dvfs->max = dvfs->nfreqs - 1 - state;
+  if (dvfs->cur > dvfs->max)
+    {
+      ret = dvfs_set_freq(dvfs, dvfs->max);
+    }
+
+  dvfs_set_capacity(dvfs);
+  nxmutex_unlock(&dvfs->lock);
+
+  thinfo("DVFS %s limited to %" PRIu32 "\n", cdev->name,
+         dvfs->freqs[dvfs->nfreqs - 1 - state]);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: thermal_dvfs_register
+ *
+ * Description:
+ *   Scale the clock of a group of CPUs with their load and register the
+ *   group as a cooling device.
+ *
+ * Input Parameters:
+ *   name    - The name of the cooling device.
+ *   clkname - The clock of the CPUs, see clk_get().
+ *   cpus    - The CPUs clocked by clkname.
+ *   freqs   - The frequencies in Hz, lowest first.  This must stay valid
+ *             until the group is unregistered.
+ *   nfreqs  - The number of frequencies, at least 2.
+ *
+ * Returned Value:
+ *   The group, or NULL on a failure.
+ *
+ ****************************************************************************/
+
+FAR struct thermal_dvfs_s *
+thermal_dvfs_register(FAR const char *name, FAR const char *clkname,
+                      cpu_set_t cpus, FAR const uint32_t *freqs,
+                      unsigned int nfreqs)
+{
+  FAR struct thermal_dvfs_s *dvfs;
+  unsigned int i;
+
+  if (freqs == NULL || nfreqs < 2 || cpus == 0)
+    {
+      therr("Invalid DVFS frequency table!\n");
+      return NULL;
+    }
+
+  for (i = 1; i < nfreqs; i++)
+    {
+      if (freqs[i] <= freqs[i - 1])
+        {
+          therr("DVFS frequencies must be increasing!\n");
+          return NULL;
+        }
+    }
+
+  dvfs = kmm_zalloc(sizeof(*dvfs));
+  if (dvfs == NULL)
+    {
+      therr("No memory for DVFS registering!\n");
+      return NULL;
+    }
+
+  dvfs->clk = clk_get(clkname);
+  if (dvfs->clk == NULL)
+    {
+      therr("Get clock %s failed!\n", clkname);
+      goto errout;
+    }
+
+  nxmutex_init(&dvfs->lock);
+  dvfs->freqs  = freqs;
+  dvfs->nfreqs = nfreqs;
+  dvfs->cpus   = cpus;
+  dvfs->max    = nfreqs - 1;
+
+  /* Start at the highest frequency, the load brings it down */
+
+  if (dvfs_set_freq(dvfs, dvfs->max) < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  dvfs->cdev = thermal_cooling_device_register(name, dvfs,
+                                               &g_dvfs_cdev_ops);
+  if (dvfs->cdev == NULL)
+    {
+      goto errout_with_lock;
+    }
+
+  work_queue(LPWORK, &dvfs->work, dvfs_work, dvfs, DVFS_PERIOD);
+  return dvfs;
+
+errout_with_lock:
+  nxmutex_destroy(&dvfs->lock);
+errout:
+  kmm_free(dvfs);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: thermal_dvfs_unregister
+ *
+ * Description:
+ *   Stop scaling the clock and unregister the cooling device.  The clock
+ *   is left at its current frequency.
+ *
+ ****************************************************************************/
+
+void thermal_dvfs_unregister(FAR struct thermal_dvfs_s *dvfs)
+{
+  nxmutex_lock(&dvfs->lock);
+  dvfs->stopped = true;
+  nxmutex_unlock(&dvfs->lock);
+
+  work_cancel_sync(LPWORK, &dvfs->work);
+  thermal_cooling_device_unregister(dvfs->cdev);
+
+#ifdef CONFIG_SCHED_CPU_CAPACITY
+  dvfs->max = dvfs->nfreqs - 1;
+  dvfs_set_capacity(dvfs);
+#endif
+
+  nxmutex_destroy(&dvfs->lock);
+  kmm_free(dvfs);
+}
@@ -22,20 +22,43 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/types.h>
+#include <sys/param.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/timers/ptp_clock.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_PTP_CLOCK_SERVO
+#  define PTP_SERVO_INTERVAL  CONFIG_PTP_CLOCK_SERVO_INTERVAL_MS
+#  define PTP_SERVO_STEP      (CONFIG_PTP_CLOCK_SERVO_STEP_US * 1000ll)
+#  define PTP_SERVO_MAXFREQ   (CONFIG_CLOCK_ADJTIME_SLEWLIMIT_PPM * 1000ll)
+
+/* Without cross timestamps, the offset is taken from the reading of the
+ * PTP clock that the system clock readings bracket the closest.
+ */
+
+#  define PTP_SERVO_SAMPLES   5
+
+/* The gains of the PI servo in thousandths, those of phc2sys */
+
+#  define PTP_SERVO_KP        700
+#  define PTP_SERVO_KI        300
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -48,6 +71,12 @@ struct ptp_upperhalf_s
   mutex_t                     lock;     /* Manages exclusive access to file operations */
   long                        max_adj;  /* The maximum frequency adjustment */
   long                        adj_freq; /* remembers the frequency adjustment */
+#ifdef CONFIG_PTP_CLOCK_SERVO
+  struct work_s               servo;    /* Disciplines the system clock */
+  int64_t                     drift;    /* Integral term of the servo, ppb */
+  int64_t                     utcoff;   /* CLOCK_REALTIME minus the clock, ns */
+  bool                        locked;   /* The system clock has been stepped */
+#endif
 };
 
 /****************************************************************************
@@ -63,6 +92,12 @@ static int     ptp_clock_ioctl(FAR struct file *filep, int cmd,
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_PTP_CLOCK_SERVO
+/* The clock that disciplines CLOCK_REALTIME, one at a time */
+
+static FAR struct ptp_upperhalf_s *g_ptp_servo;
+#endif
+
 static const struct file_operations g_ptp_clock_file_ops =
 {
   NULL,            /* open */
@@ -163,6 +198,150 @@ static int ptp_clock_adjtime(FAR struct ptp_lowerhalf_s *lower,
   return ret;
 }
 
+#ifdef CONFIG_PTP_CLOCK_SERVO
+static int64_t ptp_clock_ts2ns(FAR const struct timespec *ts)
+{
+  return (int64_t)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+/* Measure how far CLOCK_REALTIME lags behind the clock, in nanoseconds */
+
+static int ptp_clock_sysoffset(FAR struct ptp_lowerhalf_s *lower,
+                               FAR int64_t *offset)
+{
+  struct system_device_crosststamp xtstamp;
+  struct timespec pre;
+  struct timespec post;
+  struct timespec ts;
+  int64_t best = INT64_MAX;
+  int64_t delay;
+  int ret;
+  int i;
+
+  if (lower->ops->getcrosststamp != NULL)
+    {
+      ret = lower->ops->getcrosststamp(lower, &xtstamp);
+      if (ret >= 0)
+        {
+          *offset = ptp_clock_ts2ns(&xtstamp.device) -
+                    ptp_clock_ts2ns(&xtstamp.realtime);
+        }
+
+      return ret;
+    }
+
+  if (lower->ops->gettime == NULL)
+    {
+      return -ENOTSUP;
+    }
+
+  for (i = 0; i < PTP_SERVO_SAMPLES; i++)
+    {
+      nxclock_gettime(CLOCK_REALTIME, &pre);
+      ret = lower->ops->gettime(lower, &ts, NULL);
+      nxclock_gettime(CLOCK_REALTIME, &post);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      delay = ptp_clock_ts2ns(&post) - ptp_clock_ts2ns(&pre);
+      if (delay < best)
+        {
+          best    = delay;
+          *offset = ptp_clock_ts2ns(&ts) - ptp_clock_ts2ns(&pre) -
+                    delay / 2;
+        }
+    }
+
+  return OK;
+}
+
+/* One step of the PI servo that steers CLOCK_REALTIME towards the clock.
+ * Offsets beyond CONFIG_PTP_CLOCK_SERVO_STEP_US are stepped, the smaller
+ * ones corrected through the frequency of the system clock.
+ */
+
+static void ptp_clock_servo_work(FAR void *arg)
+{
+  FAR struct ptp_upperhalf_s *upper = arg;
+  struct timespec ts;
+  int64_t offset;
+  int64_t ppb;
+  int ret;
+
+  nxmutex_lock(&upper->lock);
+  if (g_ptp_servo != upper)
+    {
+      nxmutex_unlock(&upper->lock);
+      return;
+    }
+
+  ret = ptp_clock_sysoffset(upper->lower, &offset);
+  if (ret < 0)
+    {
+      ptperr("ERROR: Failed to read the clock: %d\n", ret);
+      goto out;
+    }
+
+  offset += upper->utcoff;
+  if (!upper->locked || offset > PTP_SERVO_STEP || offset < -PTP_SERVO_STEP)
+    {
+      nxclock_gettime(CLOCK_REALTIME, &ts);
+      offset += ptp_clock_ts2ns(&ts);
+      ts.tv_sec  = offset / NSEC_PER_SEC;
+      ts.tv_nsec = offset % NSEC_PER_SEC;
+      nxclock_settime(CLOCK_REALTIME, &ts);
+      upper->locked = true;
+      goto out;
+    }
+
+  upper->drift += offset * PTP_SERVO_KI / PTP_SERVO_INTERVAL;
+  upper->drift  = MIN(MAX(upper->drift, -PTP_SERVO_MAXFREQ),
+                      PTP_SERVO_MAXFREQ);
+
+  ppb = upper->drift + offset * PTP_SERVO_KP / PTP_SERVO_INTERVAL;
+  nxclock_adjfreq(MIN(MAX(ppb, -PTP_SERVO_MAXFREQ), PTP_SERVO_MAXFREQ));
+
+out:
+  work_queue(LPWORK, &upper->servo, ptp_clock_servo_work, upper,
+             MSEC2TICK(PTP_SERVO_INTERVAL));
+  nxmutex_unlock(&upper->lock);
+}
+
+/* Start or stop disciplining CLOCK_REALTIME, called with the lock held.
+ * A stopped servo leaves the system clock at the frequency it learned.
+ */
+
+static int ptp_clock_syncsystem(FAR struct ptp_upperhalf_s *upper,
+                                FAR const int *utcoff)
+{
+  if (utcoff == NULL)
+    {
+      if (g_ptp_servo == upper)
+        {
+          g_ptp_servo = NULL;
+          work_cancel(LPWORK, &upper->servo);
+          nxclock_adjfreq(upper->drift);
+        }
+
+      return OK;
+    }
+
+  if (g_ptp_servo != NULL && g_ptp_servo != upper)
+    {
+      return -EBUSY;
+    }
+
+  upper->utcoff = *utcoff * (int64_t)NSEC_PER_SEC;
+  upper->drift  = 0;
+  upper->locked = false;
+  g_ptp_servo   = upper;
+
+  return work_queue(LPWORK, &upper->servo, ptp_clock_servo_work, upper, 0);
+}
+#endif
+
 static int ptp_clock_ioctl(FAR struct file *filep, int cmd,
                            unsigned long arg)
 {
@@ -339,6 +518,15 @@ static int ptp_clock_ioctl(FAR struct file *filep, int cmd,
         }
         break;
 
+#ifdef CONFIG_PTP_CLOCK_SERVO
+      case PTP_CLOCK_SYNCSYSTEM:
+        {
+          ret = ptp_clock_syncsystem(upper,
+                                     (FAR const int *)(uintptr_t)arg);
+        }
+        break;
+#endif
+
       default:
         {
           if (lower->ops->control)
@@ -476,6 +664,14 @@ void ptp_clock_unregister(FAR struct ptp_lowerhalf_s *lower, int devno)
 
       snprintf(path, sizeof(path), "/dev/ptp%d", devno);
       unregister_driver(path);
+
+#ifdef CONFIG_PTP_CLOCK_SERVO
+      nxmutex_lock(&upper->lock);
+      ptp_clock_syncsystem(upper, NULL);
+      nxmutex_unlock(&upper->lock);
+      work_cancel_sync(LPWORK, &upper->servo);
+#endif
+
       nxmutex_destroy(&upper->lock);
       kmm_free(upper);
     }
@@ -39,6 +39,7 @@
 #include <sys/poll.h>
 
 #include <nuttx/net/netdev_lowerhalf.h>
+#include <nuttx/queue.h>
 #include <nuttx/usb/usbdev.h>
 #include <nuttx/usb/cdc.h>
 #include <nuttx/usb/cdcncm.h>
@@ -75,7 +76,18 @@
 /* TX timeout = 1 minute */
 
 #define CDCNCM_TXTIMEOUT             (60*CLK_TCK)
-#define CDCNCM_DGRAM_COMBINE_PERIOD   1
+
+#ifndef CONFIG_CDCNCM_NWRREQS
+#  define CONFIG_CDCNCM_NWRREQS         2
+#endif
+
+#ifndef CONFIG_CDCNCM_NRDREQS
+#  define CONFIG_CDCNCM_NRDREQS         2
+#endif
+
+#ifndef CONFIG_CDCNCM_TXCOMBINE_USEC
+#  define CONFIG_CDCNCM_TXCOMBINE_USEC  1000
+#endif
 
 #define NTB_DEFAULT_IN_SIZE           16384
 #define NTB_OUT_SIZE                  16384
@@ -159,6 +171,14 @@ enum ncm_notify_state_e
   NCM_NOTIFY_RESPONSE_AVAILABLE, /* Issue RESPONSE_AVAILABLE next */
 };
 
+/* Container that wraps one request of the bulk endpoints */
+
+struct cdcncm_req_s
+{
+  FAR struct cdcncm_req_s *flink;    /* Implements a singly linked list */
+  FAR struct usbdev_req_s *req;      /* The contained request */
+};
+
 struct ndp_parser_opts_s
 {
   uint32_t nthsign;          /* NCM Transfer Header signature */
@@ -307,11 +327,14 @@ struct cdcncm_driver_s
   FAR struct usbdev_ep_s     *epbulkout;   /* Bulk OUT endpoint */
   uint8_t                     config;      /* Selected configuration number */
 
-  FAR struct usbdev_req_s    *rdreq;       /* Single read request */
-  bool                        rxpending;   /* Packet available in rdreq */
+  struct cdcncm_req_s         rdreqs[CONFIG_CDCNCM_NRDREQS];
+  sq_queue_t                  rddone;      /* Filled read requests */
 
-  FAR struct usbdev_req_s    *wrreq;       /* Single write request */
-  sem_t                       wrreq_idle;  /* Is the wrreq available? */
+  struct cdcncm_req_s         wrreqs[CONFIG_CDCNCM_NWRREQS];
+  sq_queue_t                  wrfree;      /* Write requests not in use */
+  FAR struct usbdev_req_s    *wrreq;       /* Write request being filled */
+  sem_t                       wrreq_idle;  /* Counts the wrfree requests */
+  uint8_t                     nwrbusy;     /* Write requests in flight */
   bool                        txdone;      /* Did a write request complete? */
   enum ncm_notify_state_e     notify;      /* State of notify */
   FAR const struct ndp_parser_opts_s
@@ -371,7 +394,8 @@ static int     cdcmbim_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
 /* Interrupt handling */
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *priv);
+static void cdcncm_receive(FAR struct cdcncm_driver_s *priv,
+                           FAR struct usbdev_req_s *req);
 static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv);
 
 static void cdcncm_interrupt_work(FAR void *arg);
@@ -820,6 +844,38 @@ errout:
 }
 #endif
 
+/****************************************************************************
+ * Name: cdcncm_wrreq_get
+ *
+ * Description:
+ *   Make a free write request the one being filled, waiting until one of
+ *   those in flight completes if there is none.
+ *
+ * Input Parameters:
+ *   self - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void cdcncm_wrreq_get(FAR struct cdcncm_driver_s *self)
+{
+  FAR struct cdcncm_req_s *container;
+  irqstate_t flags;
+
+  while (nxsem_wait(&self->wrreq_idle) != OK)
+    {
+    }
+
+  flags     = enter_critical_section();
+  container = (FAR struct cdcncm_req_s *)sq_remfirst(&self->wrfree);
+  leave_critical_section(flags);
+
+  DEBUGASSERT(container != NULL);
+  self->wrreq = container->req;
+}
+
 /****************************************************************************
  * Name: cdcncm_transmit_format
  *
@@ -855,6 +911,10 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
 
   if (self->dgramcount == 0)
     {
+      /* Take a free write request for the new NTB */
+
+      cdcncm_wrreq_get(self);
+
       /* Fill NCB */
 
       tmp = self->wrreq->buf;
@@ -894,45 +954,59 @@ static void cdcncm_transmit_format(FAR struct cdcncm_driver_s *self,
 }
 
 /****************************************************************************
- * Name: cdcncm_transmit_work
+ * Name: cdcncm_transmit
  *
  * Description:
- *   Send NTB to the USB device for ethernet frame transmission
+ *   Send the NTB being filled to the USB device for ethernet frame
+ *   transmission
  *
  * Input Parameters:
- *   arg - Reference to the driver state structure
+ *   self - Reference to the driver state structure
  *
  * Returned Value:
  *   None
  *
+ * Assumptions:
+ *   The network device is locked.
+ *
  ****************************************************************************/
 
-static void cdcncm_transmit_work(FAR void *arg)
+static void cdcncm_transmit(FAR struct cdcncm_driver_s *self)
 {
-  FAR struct cdcncm_driver_s *self = arg;
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
+  FAR struct usbdev_req_s *req = self->wrreq;
   FAR uint8_t *tmp;
   const int dgramidxlen = 2 * opts->dgramitemlen;
   const int ndpalign = g_ntbparameters.ndpinalignment;
+  irqstate_t flags;
   int ncblen;
   int ndpindex;
   int totallen;
 
-  /* Wait until the USB device request for Ethernet frame transmissions
-   * becomes available.
-   */
+  /* The NTB may have been sent already before the combine period ended */
 
-  while (nxsem_wait(&self->wrreq_idle) != OK)
+  if (self->dgramcount == 0)
     {
+      return;
     }
 
   ncblen   = opts->nthsize;
   ndpindex = NCM_ALIGN(ncblen, ndpalign);
 
+  /* A transfer that is a multiple of the packet size would need a zero
+   * length packet to end it, pad it with one byte instead.  An NTB of the
+   * maximum size needs neither, the host reads no more than that.
+   */
+
+  totallen = self->dgramaddr - req->buf;
+  if (totallen % self->epbulkin->maxpacket == 0 && totallen < NTB_OUT_SIZE)
+    {
+      req->buf[totallen++] = 0;
+    }
+
   /* Fill NCB */
 
-  tmp      = self->wrreq->buf + 8; /* Offset to block length */
-  totallen = self->dgramaddr - self->wrreq->buf;
+  tmp = req->buf + 8; /* Offset to block length */
   cdcncm_put(&tmp, opts->blocklen, totallen);
 
   /* Fill NDP */
@@ -947,9 +1021,45 @@ static void cdcncm_transmit_work(FAR void *arg)
   cdcncm_put(&tmp, opts->dgramitemlen, 0);
   cdcncm_put(&tmp, opts->dgramitemlen, 0);
 
-  self->wrreq->len = totallen;
+  req->len    = totallen;
+  self->wrreq = NULL;
+
+  flags = enter_critical_section();
+  self->nwrbusy++;
+  leave_critical_section(flags);
+
+  if (EP_SUBMIT(self->epbulkin, req) < 0)
+    {
+      flags = enter_critical_section();
+      self->nwrbusy--;
+      sq_addlast((FAR sq_entry_t *)req->priv, &self->wrfree);
+      leave_critical_section(flags);
 
-  EP_SUBMIT(self->epbulkin, self->wrreq);
+      nxsem_post(&self->wrreq_idle);
+    }
+}
+
+/****************************************************************************
+ * Name: cdcncm_transmit_work
+ *
+ * Description:
+ *   Send the NTB being filled when its combine period has ended
+ *
+ * Input Parameters:
+ *   arg - Reference to the driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void cdcncm_transmit_work(FAR void *arg)
+{
+  FAR struct cdcncm_driver_s *self = arg;
+
+  netdev_lock(&self->dev.netdev);
+  cdcncm_transmit(self);
+  netdev_unlock(&self->dev.netdev);
 }
 
 /****************************************************************************
@@ -1001,16 +1111,18 @@ static int cdcncm_packet_handler(FAR struct cdcncm_driver_s *self,
  *
  * Input Parameters:
  *   self - Reference to the driver state structure
+ *   req  - The read request holding the received NTB
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
+static void cdcncm_receive(FAR struct cdcncm_driver_s *self,
+                           FAR struct usbdev_req_s *req)
 {
   FAR const struct ndp_parser_opts_s *opts = self->parseropts;
-  FAR uint8_t *tmp = self->rdreq->buf;
+  FAR uint8_t *tmp = req->buf;
   uint32_t ntbmax = g_ntbparameters.ntboutmaxsize;
   uint32_t blocklen;
   uint32_t ndplen;
@@ -1021,7 +1133,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
   if (GETUINT32(tmp) != opts->nthsign)
     {
-      uerr("Wrong NTH SIGN, skblen %zu\n", self->rdreq->xfrd);
+      uerr("Wrong NTH SIGN, skblen %zu\n", req->xfrd);
       return;
     }
 
@@ -1061,7 +1173,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
           return;
         }
 
-      tmp = self->rdreq->buf + ndpindex;
+      tmp = req->buf + ndpindex;
 
       if (GETUINT32(tmp) != self->ndpsign)
         {
@@ -1105,7 +1217,7 @@ static void cdcncm_receive(FAR struct cdcncm_driver_s *self)
 
           /* Copy the data from the hardware to self->rx_queue. */
 
-          cdcncm_packet_handler(self, self->rdreq->buf + index, dglen);
+          cdcncm_packet_handler(self, req->buf + index, dglen);
 
           ndplen -= 2 * (opts->dgramitemlen);
         }
@@ -1155,18 +1267,29 @@ static void cdcncm_txdone(FAR struct cdcncm_driver_s *priv)
 static void cdcncm_interrupt_work(FAR void *arg)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)arg;
+  FAR struct cdcncm_req_s *container;
   irqstate_t flags;
 
-  /* Check if we received an incoming packet, if so, call cdcncm_receive() */
+  /* Pass the datagrams of each received NTB to the network and give its
+   * request back to the bulk OUT endpoint.
+   */
 
-  if (self->rxpending)
+  for (; ; )
     {
-      cdcncm_receive(self);
+      flags     = enter_critical_section();
+      container = (FAR struct cdcncm_req_s *)sq_remfirst(&self->rddone);
+      leave_critical_section(flags);
+
+      if (container == NULL)
+        {
+          break;
+        }
+
+      cdcncm_receive(self, container->req);
       netdev_lower_rxready(&self->dev);
 
       flags = enter_critical_section();
-      self->rxpending = false;
-      EP_SUBMIT(self->epbulkout, self->rdreq);
+      EP_SUBMIT(self->epbulkout, container->req);
       leave_critical_section(flags);
     }
 
@@ -1181,6 +1304,19 @@ static void cdcncm_interrupt_work(FAR void *arg)
       self->txdone = false;
       leave_critical_section(flags);
 
+      /* Send the datagrams that were combined while the previous NTBs
+       * were in flight.
+       */
+
+      netdev_lock(&self->dev.netdev);
+      if (self->dgramcount > 0)
+        {
+          work_cancel(ETHWORK, &self->delaywork);
+          cdcncm_transmit(self);
+        }
+
+      netdev_unlock(&self->dev.netdev);
+
       cdcncm_txdone(self);
     }
   else
@@ -1297,13 +1433,26 @@ static int cdcncm_send(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt)
   if ((self->wrreq->buf + NTB_OUT_SIZE - self->dgramaddr <
        self->dev.netdev.d_pktsize) || self->dgramcount >= TX_MAX_NUM_DPE)
     {
+      /* The NTB is full */
+
       work_cancel(ETHWORK, &self->delaywork);
-      cdcncm_transmit_work(self);
+      cdcncm_transmit(self);
     }
-  else
+  else if (self->nwrbusy == 0)
     {
-      work_queue(ETHWORK, &self->delaywork, cdcncm_transmit_work, self,
-                 MSEC2TICK(CDCNCM_DGRAM_COMBINE_PERIOD));
+      /* Nothing is in flight that would send the NTB when it completes,
+       * wait for more datagrams from the first one on, but not longer.
+       */
+
+      if (CONFIG_CDCNCM_TXCOMBINE_USEC == 0)
+        {
+          cdcncm_transmit(self);
+        }
+      else if (self->dgramcount == 1)
+        {
+          work_queue(ETHWORK, &self->delaywork, cdcncm_transmit_work, self,
+                     USEC2TICK(CONFIG_CDCNCM_TXCOMBINE_USEC));
+        }
     }
 
   return OK;
@@ -1474,6 +1623,7 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
                               FAR struct usbdev_req_s *req)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+  irqstate_t flags;
 
   uinfo("buf: %p, flags 0x%hhx, len %zu, xfrd %zu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
@@ -1482,8 +1632,10 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
     {
       case 0:  /* Normal completion */
         {
-          DEBUGASSERT(!self->rxpending);
-          self->rxpending = true;
+          flags = enter_critical_section();
+          sq_addlast((FAR sq_entry_t *)req->priv, &self->rddone);
+          leave_critical_section(flags);
+
           work_queue(ETHWORK, &self->irqwork,
                      cdcncm_interrupt_work, self, 0);
         }
@@ -1495,7 +1647,7 @@ static void cdcncm_rdcomplete(FAR struct usbdev_ep_s *ep,
       default: /* Some other error occurred */
         {
           uerr("req->result: %hd\n", req->result);
-          EP_SUBMIT(self->epbulkout, self->rdreq);
+          EP_SUBMIT(self->epbulkout, req);
         }
         break;
     }
@@ -1514,15 +1666,21 @@ static void cdcncm_wrcomplete(FAR struct usbdev_ep_s *ep,
                               FAR struct usbdev_req_s *req)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)ep->priv;
+  irqstate_t flags;
   int rc;
 
   uinfo("buf: %p, flags 0x%hhx, len %zu, xfrd %zu, result %hd\n",
         req->buf, req->flags, req->len, req->xfrd, req->result);
 
-  /* The single USB device write request is available for upcoming
-   * transmissions again.
+  /* The USB device write request is available for upcoming transmissions
+   * again.
    */
 
+  flags = enter_critical_section();
+  sq_addlast((FAR sq_entry_t *)req->priv, &self->wrfree);
+  self->nwrbusy--;
+  leave_critical_section(flags);
+
   rc = nxsem_post(&self->wrreq_idle);
 
   if (rc != OK)
@@ -1585,6 +1743,7 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 {
   struct usb_ss_epdesc_s epdesc;
   int ret;
+  int i;
 
   if (config == self->config)
     {
@@ -1637,14 +1796,16 @@ static int cdcncm_setconfig(FAR struct cdcncm_driver_s *self, uint8_t config)
 
   /* Queue read requests in the bulk OUT endpoint */
 
-  DEBUGASSERT(!self->rxpending);
+  sq_init(&self->rddone);
 
-  self->rdreq->callback = cdcncm_rdcomplete,
-  ret = EP_SUBMIT(self->epbulkout, self->rdreq);
-  if (ret != OK)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      uerr("EP_SUBMIT failed. ret %d\n", ret);
-      goto error;
+      ret = EP_SUBMIT(self->epbulkout, self->rdreqs[i].req);
+      if (ret != OK)
+        {
+          uerr("EP_SUBMIT failed. ret %d\n", ret);
+          goto error;
+        }
     }
 
   /* We are successfully configured */
@@ -2479,7 +2640,9 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
                        FAR struct usbdev_s *dev)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  FAR struct cdcncm_req_s *container;
   int ret = OK;
+  int i;
 
   uinfo("\n");
 
@@ -2537,31 +2700,47 @@ static int cdcncm_bind(FAR struct usbdevclass_driver_s *driver,
 
   /* Pre-allocate read requests. The buffer size is NTB_DEFAULT_IN_SIZE. */
 
-  self->rdreq = usbdev_allocreq(self->epbulkout, NTB_DEFAULT_IN_SIZE);
-  if (self->rdreq == NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
+      container      = &self->rdreqs[i];
+      container->req = usbdev_allocreq(self->epbulkout,
+                                       NTB_DEFAULT_IN_SIZE);
+      if (container->req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
+
+      container->req->priv     = container;
+      container->req->callback = cdcncm_rdcomplete;
     }
 
-  self->rdreq->callback = cdcncm_rdcomplete;
+  /* Pre-allocate write requests. Buffer size is NTB_OUT_SIZE */
 
-  /* Pre-allocate a single write request. Buffer size is NTB_OUT_SIZE */
+  sq_init(&self->wrfree);
+  self->wrreq   = NULL;
+  self->nwrbusy = 0;
 
-  self->wrreq = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
-  if (self->wrreq == NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      uerr("Out of memory\n");
-      ret = -ENOMEM;
-      goto error;
-    }
+      container      = &self->wrreqs[i];
+      container->req = usbdev_allocreq(self->epbulkin, NTB_OUT_SIZE);
+      if (container->req == NULL)
+        {
+          uerr("Out of memory\n");
+          ret = -ENOMEM;
+          goto error;
+        }
 
-  self->wrreq->callback = cdcncm_wrcomplete;
+      container->req->priv     = container;
+      container->req->callback = cdcncm_wrcomplete;
+      sq_addlast((FAR sq_entry_t *)container, &self->wrfree);
+    }
 
-  /* The single write request just allocated is available now. */
+  /* The write requests just allocated are available now. */
 
-  ret = nxsem_init(&self->wrreq_idle, 0, 1);
+  ret = nxsem_init(&self->wrreq_idle, 0, CONFIG_CDCNCM_NWRREQS);
 
   if (ret != OK)
     {
@@ -2594,6 +2773,7 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
                           FAR struct usbdev_s *dev)
 {
   FAR struct cdcncm_driver_s *self = (FAR struct cdcncm_driver_s *)driver;
+  int i;
 
 #ifdef CONFIG_DEBUG_FEATURES
   if (!driver || !dev)
@@ -2633,10 +2813,13 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * been returned to the free list at this time -- we don't check)
    */
 
-  if (self->rdreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NRDREQS; i++)
     {
-      usbdev_freereq(self->epbulkout, self->rdreq);
-      self->rdreq = NULL;
+      if (self->rdreqs[i].req != NULL)
+        {
+          usbdev_freereq(self->epbulkout, self->rdreqs[i].req);
+          self->rdreqs[i].req = NULL;
+        }
     }
 
   /* Free the bulk OUT endpoint */
@@ -2651,12 +2834,18 @@ static void cdcncm_unbind(FAR struct usbdevclass_driver_s *driver,
    * of them)
    */
 
-  if (self->wrreq != NULL)
+  for (i = 0; i < CONFIG_CDCNCM_NWRREQS; i++)
     {
-      usbdev_freereq(self->epbulkin, self->wrreq);
-      self->wrreq = NULL;
+      if (self->wrreqs[i].req != NULL)
+        {
+          usbdev_freereq(self->epbulkin, self->wrreqs[i].req);
+          self->wrreqs[i].req = NULL;
+        }
     }
 
+  self->wrreq      = NULL;
+  self->dgramcount = 0;
+
   /* Free the bulk IN endpoint */
 
   if (self->epbulkin)
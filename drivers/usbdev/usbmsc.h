@@ -88,6 +88,18 @@
 #  define CONFIG_USBMSC_NRDREQS 4
 #endif
 
+/* Number of sectors that the I/O buffer holds */
+
+#if defined(CONFIG_USBMSC_WRMULTIPLE) && defined(CONFIG_USBMSC_RDMULTIPLE)
+#  define USBMSC_IOSECTORS MAX(CONFIG_USBMSC_NWRREQS, CONFIG_USBMSC_RDSECTORS)
+#elif defined(CONFIG_USBMSC_WRMULTIPLE)
+#  define USBMSC_IOSECTORS CONFIG_USBMSC_NWRREQS
+#elif defined(CONFIG_USBMSC_RDMULTIPLE)
+#  define USBMSC_IOSECTORS CONFIG_USBMSC_RDSECTORS
+#else
+#  define USBMSC_IOSECTORS 1
+#endif
+
 /* Logical endpoint numbers / max packet sizes */
 
 #ifndef CONFIG_USBMSC_COMPOSITE
@@ -410,9 +422,9 @@ struct usbmsc_dev_s
   uint8_t           cbwdir:2;         /* Direction from CBW. See USBMSC_FLAGS_DIR* definitions */
   uint8_t           cdblen;           /* Length of cdb[] from CBW */
   uint8_t           cbwlun;           /* LUN from the CBW */
-  uint16_t          nsectbytes;       /* Bytes buffered in iobuffer[] */
+  uint32_t          nsectbytes;       /* Bytes buffered in iobuffer[] */
   uint16_t          nreqbytes;        /* Bytes buffered in head write requests */
-  uint16_t          iosize;           /* Size of iobuffer[] */
+  uint32_t          iosize;           /* Size of iobuffer[] */
   uint32_t          cbwlen;           /* Length of data from CBW */
   uint32_t          cbwtag;           /* Tag from the CBW */
   union
@@ -423,6 +435,9 @@ struct usbmsc_dev_s
   uint32_t          sector;           /* Current sector (relative to lun->startsector) */
   uint32_t          residue;          /* Untransferred amount reported in the CSW */
   uint8_t          *iobuffer;         /* Buffer for data transfers */
+  FAR struct usbmsc_lun_s *iolun;     /* LUN of the sectors read into iobuffer[] */
+  uint32_t          iosector;         /* First sector read into iobuffer[] */
+  uint32_t          iosectors;        /* Number of sectors read, 0 if none */
 
   /* Write request list */
 
@@ -1268,8 +1268,11 @@ static inline int usbmsc_cmdverify10(FAR struct usbmsc_dev_s *priv)
         }
       else
         {
-          /* Try to read the requested blocks */
+          /* Try to read the requested blocks.  They overwrite the sectors
+           * buffered for reading.
+           */
 
+          priv->iosectors = 0;
           for (i = 0, sector = lba + lun->startsector;
                i < blocks;
                i++, sector++)
@@ -1934,6 +1937,9 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
 
   priv->nsectbytes   = 0;
   priv->nreqbytes    = 0;
+#ifndef CONFIG_USBMSC_RDAHEAD
+  priv->iosectors    = 0;
+#endif
 
   /* Get exclusive access to the block driver */
 
@@ -2214,6 +2220,61 @@ static int usbmsc_cmdparsestate(FAR struct usbmsc_dev_s *priv)
   return ret;
 }
 
+/****************************************************************************
+ * Name: usbmsc_readsectors
+ *
+ * Description:
+ *   Make sure that priv->sector is in the I/O buffer, reading as many
+ *   sectors from it on as the buffer holds and the command needs, or, with
+ *   CONFIG_USBMSC_RDAHEAD, as the buffer holds and the LUN has.
+ *
+ * Returned Value:
+ *   Zero or the number of sectors read on success; a negated errno value
+ *   on failure.
+ *
+ ****************************************************************************/
+
+static ssize_t usbmsc_readsectors(FAR struct usbmsc_dev_s *priv)
+{
+  FAR struct usbmsc_lun_s *lun = priv->lun;
+  uint32_t nsectors = priv->iosize / lun->sectorsize;
+  ssize_t nread;
+
+  if (priv->iolun == lun && priv->iosectors > 0 &&
+      priv->sector >= priv->iosector &&
+      priv->sector - priv->iosector < priv->iosectors)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_USBMSC_RDAHEAD
+  if (priv->sector < lun->nsectors)
+    {
+      nsectors = MIN(nsectors, MAX(priv->u.xfrlen,
+                                   lun->nsectors - priv->sector));
+    }
+  else
+#endif
+    {
+      nsectors = MIN(nsectors, priv->u.xfrlen);
+    }
+
+  priv->iosectors = 0;
+  nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, nsectors);
+  if (nread > 0)
+    {
+      priv->iolun     = lun;
+      priv->iosector  = priv->sector;
+      priv->iosectors = nread;
+    }
+  else if (nread == 0)
+    {
+      nread = -EIO;
+    }
+
+  return nread;
+}
+
 /****************************************************************************
  * Name: usbmsc_cmdreadstate
  *
@@ -2261,13 +2322,13 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
     {
       usbtrace(TRACE_CLASSSTATE(USBMSC_CLASSSTATE_CMDREAD), priv->u.xfrlen);
 
-      /* Is the I/O buffer empty? */
+      /* Is the current sector finished? */
 
       if (priv->nsectbytes <= 0)
         {
-          /* Yes.. read the next sector */
+          /* Yes.. read the next sectors unless the next one is buffered */
 
-          nread = USBMSC_DRVR_READ(lun, priv->iobuffer, priv->sector, 1);
+          nread = usbmsc_readsectors(priv);
           if (nread < 0)
             {
               usbtrace(TRACE_CLSERROR(USBMSC_TRACEERR_CMDREADREADFAIL),
@@ -2304,13 +2365,15 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
       req = privreq->req;
 
       /* Transfer all of the data that will (1) fit into the request buffer,
-       * OR (2) all of the data available in the sector buffer.
+       * OR (2) all of the data available in the sector buffer.  The current
+       * sector is the one before priv->sector.
        */
 
-      src    = &priv->iobuffer[lun->sectorsize - priv->nsectbytes];
+      src    = &priv->iobuffer[(priv->sector - priv->iosector) *
+                               lun->sectorsize - priv->nsectbytes];
       dest   = &req->buf[priv->nreqbytes];
 
-      nbytes = MIN(priv->epbulkin->maxpacket - priv->nreqbytes,
+      nbytes = MIN(CONFIG_USBMSC_BULKINREQLEN - priv->nreqbytes,
                    priv->nsectbytes);
 
       /* Copy the data from the sector buffer to the USB request and update
@@ -2326,7 +2389,7 @@ static int usbmsc_cmdreadstate(FAR struct usbmsc_dev_s *priv)
        * then submit the request
        */
 
-      if (priv->nreqbytes >= priv->epbulkin->maxpacket ||
+      if (priv->nreqbytes >= CONFIG_USBMSC_BULKINREQLEN ||
           (priv->u.xfrlen <= 0 && priv->nsectbytes <= 0))
         {
           /* Remove the request that we just filled from wrreqlist (we've
@@ -2408,6 +2471,10 @@ static int usbmsc_cmdwritestate(FAR struct usbmsc_dev_s *priv)
   int nbytes;
   int ret;
 
+  /* The data to write overwrites the sectors buffered for reading */
+
+  priv->iosectors = 0;
+
   /* Loop transferring data until either (1) all of the data has been
    * transferred, or (2) we have written all of the data in the available
    * read requests.
@@ -53,6 +53,7 @@
 #include <nuttx/usb/cdc.h>
 #include <nuttx/usb/usb.h>
 #include <nuttx/usb/usbhost.h>
+#include <nuttx/usb/usbhost_xfrq.h>
 
 #define CDCMBIM_NETBUF_SIZE 8192
 
@@ -204,11 +205,9 @@ struct usbhost_cdcmbim_s
   spinlock_t              spinlock;     /* Used to protect critical section */
   struct work_s           ntwork;       /* Notification work */
   struct work_s           comm_rxwork;  /* Communication interface RX work */
-  struct work_s           bulk_rxwork;
   struct work_s           txpollwork;
   struct work_s           destroywork;
   int16_t                 nnbytes;      /* Number of bytes received in notification */
-  int16_t                 bulkinbytes;
   uint16_t                comm_rxlen;   /* Number of bytes in the RX buffer */
   uint16_t                comm_rxmsgs;  /* Number of messages available to be read */
   uint16_t                comm_rxpos;   /* Read position for input buffer */
@@ -221,11 +220,11 @@ struct usbhost_cdcmbim_s
   FAR uint8_t            *data_rxbuf;   /* Allocated RX buffer for network datagrams */
   FAR uint8_t            *comm_rxbuf;   /* Allocated RX buffer comm IN messages */
   FAR uint8_t            *notification; /* Allocated RX buffer for async notifications */
-  FAR uint8_t            *rxnetbuf;     /* Allocated RX buffer for NTB frames */
   FAR uint8_t            *txnetbuf;     /* Allocated TX buffer for NTB frames */
   usbhost_ep_t            intin;        /* Interrupt endpoint */
   usbhost_ep_t            bulkin;       /* Bulk IN endpoint */
   usbhost_ep_t            bulkout;      /* Bulk OUT endpoint */
+  struct usbhost_xfrq_s   rxq;          /* NTB buffers of the bulk IN endpoint */
   uint16_t                bulkmxpacket; /* Max packet size for Bulk OUT endpoint */
   uint16_t                ntbseq;       /* NTB sequence number */
 
@@ -259,8 +258,8 @@ static inline void usbhost_mkdevname(FAR struct usbhost_cdcmbim_s *priv,
 static void usbhost_notification_work(FAR void *arg);
 static void usbhost_notification_callback(FAR void *arg, ssize_t nbytes);
 static void usbhost_rxdata_work(FAR void *arg);
-static void usbhost_bulkin_work(FAR void *arg);
-static void usbhost_bulkin_callback(FAR void *arg, ssize_t nbytes);
+static void usbhost_bulkin_done(FAR void *arg, FAR uint8_t *buffer,
+                                ssize_t nbytes);
 
 static void usbhost_destroy(FAR void *arg);
 
@@ -715,41 +714,19 @@ static inline void usbhost_mkdevname(FAR struct usbhost_cdcmbim_s *priv,
   snprintf(devname, DEV_NAMELEN, DEV_FORMAT, priv->minor);
 }
 
-static void usbhost_bulkin_callback(FAR void *arg, ssize_t nbytes)
-{
-  FAR struct usbhost_cdcmbim_s *priv = (FAR struct usbhost_cdcmbim_s *)arg;
-  uint32_t delay = 0;
-
-  DEBUGASSERT(priv);
-
-  if (priv->disconnected)
-    {
-      return;
-    }
-
-  priv->bulkinbytes = (int16_t)nbytes;
-
-  if (nbytes < 0)
-    {
-      if (nbytes != -EAGAIN)
-        {
-          uerr("ERROR: Transfer failed: %d\n", nbytes);
-        }
-
-      delay = MSEC2TICK(30);
-    }
-
-  if (work_available(&priv->bulk_rxwork))
-    {
-      work_queue(LPWORK, &priv->bulk_rxwork,
-                 usbhost_bulkin_work, priv, delay);
-    }
-}
+/****************************************************************************
+ * Name: usbhost_bulkin_done
+ *
+ * Description:
+ *   Hand the datagrams of a received NTB to the network.  The receive queue
+ *   already has the next NTB coming in.
+ *
+ ****************************************************************************/
 
-static void usbhost_bulkin_work(FAR void *arg)
+static void usbhost_bulkin_done(FAR void *arg, FAR uint8_t *buffer,
+                                ssize_t nbytes)
 {
   FAR struct usbhost_cdcmbim_s *priv;
-  FAR struct usbhost_hubport_s *hport;
   FAR struct usb_cdc_ncm_nth16_s *nth;
   uint16_t ndpoffset;
   uint16_t dgram_len;
@@ -759,9 +736,6 @@ static void usbhost_bulkin_work(FAR void *arg)
   priv = (FAR struct usbhost_cdcmbim_s *)arg;
   DEBUGASSERT(priv);
 
-  hport = priv->usbclass.hport;
-  DEBUGASSERT(hport);
-
   if (priv->disconnected || !priv->bifup)
     {
       return;
@@ -769,15 +743,15 @@ static void usbhost_bulkin_work(FAR void *arg)
 
   nxmutex_lock(&priv->lock);
 
-  if (priv->bulkinbytes < (int16_t)(sizeof(struct usb_cdc_ncm_nth16_s) +
-                                    sizeof(struct usb_cdc_ncm_ndp16_s)))
+  if (nbytes < (ssize_t)(sizeof(struct usb_cdc_ncm_nth16_s) +
+                         sizeof(struct usb_cdc_ncm_ndp16_s)))
     {
       goto out;
     }
 
   /* Parse the NTB header */
 
-  nth = (FAR struct usb_cdc_ncm_nth16_s *)priv->rxnetbuf;
+  nth = (FAR struct usb_cdc_ncm_nth16_s *)buffer;
 
   if (usbhost_getle32(nth->signature) != USB_CDC_NCM_NTH16_SIGNATURE)
     {
@@ -787,16 +761,16 @@ static void usbhost_bulkin_work(FAR void *arg)
 
   block_len = usbhost_getle16(nth->block_length);
 
-  if (block_len > priv->bulkinbytes)
+  if (block_len > nbytes)
     {
       uerr("Block length larger than rx buffer\n");
       goto out;
     }
 
   ndpoffset = usbhost_getle16(nth->ndp_index);
-  if (ndpoffset > priv->bulkinbytes)
+  if (ndpoffset > nbytes)
     {
-      uerr("NDP offset too far %u > %u\n", ndpoffset, priv->bulkinbytes);
+      uerr("NDP offset too far %u > %zd\n", ndpoffset, nbytes);
       goto out;
     }
 
@@ -806,7 +780,7 @@ static void usbhost_bulkin_work(FAR void *arg)
     {
       FAR struct usb_cdc_ncm_dpe16_s *dpe;
       FAR struct usb_cdc_ncm_ndp16_s *ndp
-        = (FAR struct usb_cdc_ncm_ndp16_s *)(priv->rxnetbuf + ndpoffset);
+        = (FAR struct usb_cdc_ncm_ndp16_s *)(buffer + ndpoffset);
 
       ndpoffset = usbhost_getle16(ndp->next_ndp_index);
 
@@ -817,19 +791,16 @@ static void usbhost_bulkin_work(FAR void *arg)
           dgram_off = usbhost_getle16(dpe->index);
           dgram_len = usbhost_getle16(dpe->length);
 
-          if (dgram_off + dgram_len <= priv->bulkinbytes)
+          if (dgram_off + dgram_len <= nbytes)
             {
-              cdcmbim_receive(priv, priv->rxnetbuf + dgram_off, dgram_len);
+              cdcmbim_receive(priv, buffer + dgram_off, dgram_len);
             }
         }
     }
   while (ndpoffset);
 
 out:
-    DRVR_ASYNCH(hport->drvr, priv->bulkin,
-                (FAR uint8_t *)priv->rxnetbuf, CDCMBIM_NETBUF_SIZE,
-                usbhost_bulkin_callback, priv);
-    nxmutex_unlock(&priv->lock);
+  nxmutex_unlock(&priv->lock);
 }
 
 /****************************************************************************
@@ -1104,6 +1075,10 @@ static void usbhost_destroy(FAR void *arg)
 
   usbhost_freedevno(priv);
 
+  /* Stop the bulk IN transfers before the endpoint goes away */
+
+  usbhost_xfrq_uninitialize(&priv->rxq);
+
   /* Free the endpoints */
 
   if (priv->intin)
@@ -1791,11 +1766,13 @@ static int usbhost_alloc_buffers(FAR struct usbhost_cdcmbim_s *priv)
       goto errout;
     }
 
-  ret = DRVR_IOALLOC(hport->drvr, &priv->rxnetbuf, CDCMBIM_NETBUF_SIZE);
+  ret = usbhost_xfrq_initialize(&priv->rxq, hport->drvr, priv->bulkin,
+                                CONFIG_USBHOST_CDCMBIM_NRXBUFS,
+                                CDCMBIM_NETBUF_SIZE, usbhost_bulkin_done,
+                                priv);
   if (ret < 0)
     {
-      uerr("ERROR: DRVR_IOALLOC of net rx buf failed: %d (%d bytes)\n",
-           ret, 2048);
+      uerr("ERROR: failed to allocate the net rx buffers: %d\n", ret);
       goto errout;
     }
 
@@ -1850,10 +1827,7 @@ static void usbhost_free_buffers(FAR struct usbhost_cdcmbim_s *priv)
       (void)DRVR_IOFREE(hport->drvr, priv->notification);
     }
 
-  if (priv->rxnetbuf)
-    {
-      (void)DRVR_IOFREE(hport->drvr, priv->rxnetbuf);
-    }
+  usbhost_xfrq_uninitialize(&priv->rxq);
 
   if (priv->txnetbuf)
     {
@@ -1863,7 +1837,6 @@ static void usbhost_free_buffers(FAR struct usbhost_cdcmbim_s *priv)
   priv->ctrlreq      = NULL;
   priv->comm_rxbuf   = NULL;
   priv->notification = NULL;
-  priv->rxnetbuf     = NULL;
   priv->txnetbuf     = NULL;
 }
 
@@ -2318,8 +2291,6 @@ static int cdcmbim_ifup(FAR struct net_driver_s *dev)
 {
   FAR struct usbhost_cdcmbim_s *priv =
       (FAR struct usbhost_cdcmbim_s *)dev->d_private;
-  FAR struct usbhost_hubport_s *hport = priv->usbclass.hport;
-  int ret;
 
 #ifdef CONFIG_NET_IPv4
   ninfo("Bringing up: %u.%u.%u.%u\n",
@@ -2333,20 +2304,10 @@ static int cdcmbim_ifup(FAR struct net_driver_s *dev)
         dev->d_ipv6addr[6], dev->d_ipv6addr[7]);
 #endif
 
-  /* Start RX asynch on bulk in */
-
-  if (priv->bulkin)
-    {
-      ret = DRVR_ASYNCH(hport->drvr, priv->bulkin,
-                        priv->rxnetbuf, CDCMBIM_NETBUF_SIZE,
-                        usbhost_bulkin_callback, priv);
-      if (ret < 0)
-        {
-          uerr("ERROR: DRVR_ASYNCH failed on bulkin: %d\n", ret);
-        }
-    }
+  /* Start receiving NTBs on bulk in */
 
   priv->bifup = true;
+  usbhost_xfrq_start(&priv->rxq);
   return OK;
 }
 
@@ -2379,6 +2340,12 @@ static int cdcmbim_ifdown(FAR struct net_driver_s *dev)
   priv->bifup = false;
 
   spin_unlock_irqrestore(&priv->spinlock, flags);
+
+  /* Stop receiving, this is called with the device locked and so must not
+   * wait for the receive queue.
+   */
+
+  usbhost_xfrq_stop(&priv->rxq);
   return OK;
 }
 
@@ -0,0 +1,339 @@
+/****************************************************************************
+ * drivers/usbhost/usbhost_xfrq.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* Queues of receive buffers of IN endpoints */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/usb/usbhost.h>
+#include <nuttx/usb/usbhost_xfrq.h>
+
+#ifdef CONFIG_USBHOST_XFRQ
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A failed transfer is posted again after this delay */
+
+#define USBHOST_XFRQ_ERRDELAY MSEC2TICK(30)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void usbhost_xfrq_work(FAR void *arg);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: usbhost_xfrq_callback
+ *
+ * Description:
+ *   Completion of the transfer in flight, this may run in the interrupt
+ *   handler of the host controller.  The buffer in flight is always the
+ *   one after the filled ones.
+ *
+ ****************************************************************************/
+
+static void usbhost_xfrq_callback(FAR void *arg, ssize_t nbytes)
+{
+  FAR struct usbhost_xfrq_s *xfrq = (FAR struct usbhost_xfrq_s *)arg;
+  irqstate_t flags;
+  clock_t delay = 0;
+  bool running;
+  int index;
+
+  flags = spin_lock_irqsave(&xfrq->lock);
+  xfrq->busy = false;
+  running = xfrq->running;
+
+  if (running && nbytes >= 0)
+    {
+      index = (xfrq->head + xfrq->nready) % xfrq->nbuffers;
+      xfrq->nbytes[index] = nbytes;
+      xfrq->nready++;
+    }
+
+  spin_unlock_irqrestore(&xfrq->lock, flags);
+
+  if (!running)
+    {
+      return;
+    }
+
+  if (nbytes < 0)
+    {
+      if (nbytes != -EAGAIN)
+        {
+          uerr("ERROR: Transfer failed: %zd\n", nbytes);
+        }
+
+      delay = USBHOST_XFRQ_ERRDELAY;
+    }
+
+  if (work_available(&xfrq->work))
+    {
+      work_queue(LPWORK, &xfrq->work, usbhost_xfrq_work, xfrq, delay);
+    }
+}
+
+/****************************************************************************
+ * Name: usbhost_xfrq_submit
+ *
+ * Description:
+ *   Post the next free buffer unless a transfer is in flight already.
+ *
+ ****************************************************************************/
+
+static void usbhost_xfrq_submit(FAR struct usbhost_xfrq_s *xfrq)
+{
+  irqstate_t flags;
+  int index;
+  int ret;
+
+  flags = spin_lock_irqsave(&xfrq->lock);
+  if (!xfrq->running || xfrq->busy || xfrq->nready >= xfrq->nbuffers)
+    {
+      spin_unlock_irqrestore(&xfrq->lock, flags);
+      return;
+    }
+
+  index = (xfrq->head + xfrq->nready) % xfrq->nbuffers;
+  xfrq->busy = true;
+  spin_unlock_irqrestore(&xfrq->lock, flags);
+
+  ret = DRVR_ASYNCH(xfrq->drvr, xfrq->ep, xfrq->buffer[index],
+                    xfrq->buflen, usbhost_xfrq_callback, xfrq);
+  if (ret < 0)
+    {
+      uerr("ERROR: DRVR_ASYNCH failed: %d\n", ret);
+
+      flags = spin_lock_irqsave(&xfrq->lock);
+      xfrq->busy = false;
+      spin_unlock_irqrestore(&xfrq->lock, flags);
+
+      work_queue(LPWORK, &xfrq->work, usbhost_xfrq_work, xfrq,
+                 USBHOST_XFRQ_ERRDELAY);
+    }
+}
+
+/****************************************************************************
+ * Name: usbhost_xfrq_work
+ *
+ * Description:
+ *   Keep a transfer in flight and hand out the filled buffers.  The next
+ *   transfer is posted before each buffer is handed out, a buffer is free
+ *   again only when done returned.
+ *
+ ****************************************************************************/
+
+static void usbhost_xfrq_work(FAR void *arg)
+{
+  FAR struct usbhost_xfrq_s *xfrq = (FAR struct usbhost_xfrq_s *)arg;
+  irqstate_t flags;
+  ssize_t nbytes;
+  int index;
+
+  for (; ; )
+    {
+      usbhost_xfrq_submit(xfrq);
+
+      flags = spin_lock_irqsave(&xfrq->lock);
+      if (!xfrq->running || xfrq->nready == 0)
+        {
+          spin_unlock_irqrestore(&xfrq->lock, flags);
+          break;
+        }
+
+      index  = xfrq->head;
+      nbytes = xfrq->nbytes[index];
+      spin_unlock_irqrestore(&xfrq->lock, flags);
+
+      xfrq->done(xfrq->arg, xfrq->buffer[index], nbytes);
+
+      flags = spin_lock_irqsave(&xfrq->lock);
+      xfrq->head = (index + 1) % xfrq->nbuffers;
+      xfrq->nready--;
+      spin_unlock_irqrestore(&xfrq->lock, flags);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: usbhost_xfrq_initialize
+ *
+ * Description:
+ *   Allocate nbuffers I/O buffers of buflen bytes for the IN endpoint ep.
+ *   No transfer is posted before usbhost_xfrq_start().
+ *
+ * Input Parameters:
+ *   xfrq     - The queue to initialize.
+ *   drvr     - The host controller of the endpoint.
+ *   ep       - The IN endpoint.
+ *   nbuffers - The number of buffers, 1 to USBHOST_XFRQ_MAXBUFFERS.
+ *   buflen   - The size of each buffer, the length of each transfer.
+ *   done     - Handles each filled buffer.
+ *   arg      - The argument of done.
+ *
+ * Returned Value:
+ *   On success, zero (OK) is returned. On a failure, a negated errno value
+ *   is returned indicating the nature of the failure.
+ *
+ ****************************************************************************/
+
+int usbhost_xfrq_initialize(FAR struct usbhost_xfrq_s *xfrq,
+                            FAR struct usbhost_driver_s *drvr,
+                            usbhost_ep_t ep, int nbuffers, size_t buflen,
+                            usbhost_xfrq_done_t done, FAR void *arg)
+{
+  int ret;
+  int i;
+
+  DEBUGASSERT(xfrq != NULL && drvr != NULL && done != NULL);
+
+  if (nbuffers < 1 || nbuffers > USBHOST_XFRQ_MAXBUFFERS)
+    {
+      return -EINVAL;
+    }
+
+  memset(xfrq, 0, sizeof(struct usbhost_xfrq_s));
+  spin_lock_init(&xfrq->lock);
+
+  xfrq->drvr     = drvr;
+  xfrq->ep       = ep;
+  xfrq->done     = done;
+  xfrq->arg      = arg;
+  xfrq->buflen   = buflen;
+  xfrq->nbuffers = nbuffers;
+
+  for (i = 0; i < nbuffers; i++)
+    {
+      ret = DRVR_IOALLOC(drvr, &xfrq->buffer[i], buflen);
+      if (ret < 0)
+        {
+          uerr("ERROR: DRVR_IOALLOC of %zu bytes failed: %d\n", buflen, ret);
+          usbhost_xfrq_uninitialize(xfrq);
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: usbhost_xfrq_uninitialize
+ *
+ * Description:
+ *   Stop the queue, wait until it is idle and free its buffers.  This must
+ *   be called before the endpoint is freed.  A queue that is zeroed or was
+ *   already uninitialized is left alone.
+ *
+ ****************************************************************************/
+
+void usbhost_xfrq_uninitialize(FAR struct usbhost_xfrq_s *xfrq)
+{
+  int i;
+
+  if (xfrq->drvr == NULL)
+    {
+      return;
+    }
+
+  /* Once the work is idle nothing posts a transfer any more, cancel the
+   * one that it may have posted after usbhost_xfrq_stop().
+   */
+
+  usbhost_xfrq_stop(xfrq);
+  work_cancel_sync(LPWORK, &xfrq->work);
+  DRVR_CANCEL(xfrq->drvr, xfrq->ep);
+
+  for (i = 0; i < xfrq->nbuffers; i++)
+    {
+      if (xfrq->buffer[i] != NULL)
+        {
+          DRVR_IOFREE(xfrq->drvr, xfrq->buffer[i]);
+          xfrq->buffer[i] = NULL;
+        }
+    }
+
+  xfrq->drvr = NULL;
+}
+
+/****************************************************************************
+ * Name: usbhost_xfrq_start
+ *
+ * Description:
+ *   Begin posting the buffers to the endpoint.  Buffers that were filled
+ *   before the queue was stopped are handed out first.
+ *
+ ****************************************************************************/
+
+void usbhost_xfrq_start(FAR struct usbhost_xfrq_s *xfrq)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&xfrq->lock);
+  xfrq->running = true;
+  spin_unlock_irqrestore(&xfrq->lock, flags);
+
+  work_queue(LPWORK, &xfrq->work, usbhost_xfrq_work, xfrq, 0);
+}
+
+/****************************************************************************
+ * Name: usbhost_xfrq_stop
+ *
+ * Description:
+ *   Stop posting the buffers and cancel the transfer in flight.  This does
+ *   not wait and may be called with locks held that the done callback
+ *   takes.
+ *
+ ****************************************************************************/
+
+void usbhost_xfrq_stop(FAR struct usbhost_xfrq_s *xfrq)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&xfrq->lock);
+  xfrq->running = false;
+  spin_unlock_irqrestore(&xfrq->lock, flags);
+
+  work_cancel(LPWORK, &xfrq->work);
+  DRVR_CANCEL(xfrq->drvr, xfrq->ep);
+}
+
+#endif /* CONFIG_USBHOST_XFRQ */
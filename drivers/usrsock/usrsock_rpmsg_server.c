@@ -252,13 +252,7 @@ static int usrsock_rpmsg_send_data_ack(FAR struct rpmsg_endpoint *ept,
   ack->valuelen          = valuelen;
   ack->valuelen_nontrunc = valuelen_nontrunc;
 
-  ret = rpmsg_send_nocopy(ept, ack, sizeof(*ack) + valuelen + datalen);
-  if (ret < 0)
-    {
-      rpmsg_release_tx_buffer(ept, ack);
-    }
-
-  return ret;
+  return rpmsg_send_tx_payload(ept, ack, sizeof(*ack) + valuelen + datalen);
 }
 
 static int usrsock_rpmsg_send_frag_ack(FAR struct rpmsg_endpoint *ept,
@@ -274,7 +268,7 @@ static int usrsock_rpmsg_send_frag_ack(FAR struct rpmsg_endpoint *ept,
   ack->reqack.result      = result;
   ack->datalen            = datalen;
 
-  return rpmsg_send_nocopy(ept, ack, sizeof(*ack) + datalen);
+  return rpmsg_send_tx_payload(ept, ack, sizeof(*ack) + datalen);
 }
 
 static int usrsock_rpmsg_send_event(FAR struct rpmsg_endpoint *ept,
@@ -1004,13 +998,7 @@ static int usrsock_rpmsg_send_dns_event(FAR void *arg,
   dns->addrlen = addrlen;
   memcpy(dns + 1, addr, addrlen);
 
-  ret = rpmsg_send_nocopy(ept, dns, sizeof(*dns) + addrlen);
-  if (ret < 0)
-    {
-      rpmsg_release_tx_buffer(ept, dns);
-    }
-
-  return ret;
+  return rpmsg_send_tx_payload(ept, dns, sizeof(*dns) + addrlen);
 }
 #endif
 
@@ -30,6 +30,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <poll.h>
+#include <sys/mman.h>
 
 #include <nuttx/mutex.h>
 #include <nuttx/video/v4l2_cap.h>
@@ -97,6 +98,21 @@ struct capture_wait_capture_s
 
 typedef struct capture_wait_capture_s capture_wait_capture_t;
 
+/* A V4L2_MEMORY_DMABUF buffer.  It is mapped when first queued and the
+ * mapping is reused for as long as the same open file comes back at the
+ * same index.
+ */
+
+struct capture_dmabuf_s
+{
+  FAR struct file *filep;
+  FAR void        *vaddr;
+  uint32_t         length;
+  int              fd;
+};
+
+typedef struct capture_dmabuf_s capture_dmabuf_t;
+
 struct capture_type_inf_s
 {
   mutex_t                lock_state;
@@ -109,6 +125,7 @@ struct capture_type_inf_s
   struct v4l2_fract      frame_interval;
   video_framebuff_t      bufinf;
   FAR uint8_t            *bufheap;   /* for V4L2_MEMORY_MMAP buffers */
+  capture_dmabuf_t       dmabuf[V4L2_REQBUFS_COUNT_MAX];
   FAR struct pollfd      *fds;
   uint32_t               seqnum;
 };
@@ -202,6 +219,10 @@ static void change_capture_state(FAR capture_mng_t *cmng,
 static bool is_taking_still_picture(FAR capture_mng_t *cmng);
 static bool is_bufsize_sufficient(FAR capture_mng_t *cmng, uint32_t bufsize);
 static void cleanup_resources(FAR capture_mng_t *cmng);
+static int import_dmabuf(FAR capture_type_inf_t *type_inf,
+                         FAR struct v4l2_buffer *buf,
+                         FAR unsigned long *addr);
+static void release_dmabuf(FAR capture_type_inf_t *type_inf);
 static bool is_sem_waited(FAR sem_t *sem);
 static int save_scene_param(FAR capture_mng_t *cmng,
                             enum v4l2_scene_mode mode,
@@ -1179,9 +1200,88 @@ static void initialize_resources(FAR capture_mng_t *cmng)
   initialize_scenes_parameter(cmng);
 }
 
+static int import_dmabuf(FAR capture_type_inf_t *type_inf,
+                         FAR struct v4l2_buffer *buf,
+                         FAR unsigned long *addr)
+{
+  FAR capture_dmabuf_t *dmabuf;
+  FAR struct file *filep;
+  FAR void *vaddr;
+  int ret;
+
+  if (buf->index >= V4L2_REQBUFS_COUNT_MAX)
+    {
+      return -EINVAL;
+    }
+
+  ret = file_get(buf->m.fd, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  dmabuf = &type_inf->dmabuf[buf->index];
+  if (dmabuf->filep == filep && dmabuf->length >= buf->length)
+    {
+      file_put(filep);
+      dmabuf->fd = buf->m.fd;
+      *addr = (unsigned long)dmabuf->vaddr;
+      return OK;
+    }
+
+  /* Only a file whose driver maps it directly can be shared, any other
+   * would be copied into memory by file_mmap().
+   */
+
+  if (filep->f_inode == NULL || filep->f_inode->u.i_ops->mmap == NULL)
+    {
+      file_put(filep);
+      return -EINVAL;
+    }
+
+  ret = file_mmap(filep, NULL, buf->length, PROT_READ | PROT_WRITE,
+                  MAP_SHARED, 0, &vaddr);
+  if (ret < 0)
+    {
+      file_put(filep);
+      return ret;
+    }
+
+  if (dmabuf->filep != NULL)
+    {
+      file_munmap(dmabuf->vaddr, dmabuf->length);
+      file_put(dmabuf->filep);
+    }
+
+  dmabuf->filep  = filep;
+  dmabuf->vaddr  = vaddr;
+  dmabuf->length = buf->length;
+  dmabuf->fd     = buf->m.fd;
+  *addr = (unsigned long)vaddr;
+  return OK;
+}
+
+static void release_dmabuf(FAR capture_type_inf_t *type_inf)
+{
+  FAR capture_dmabuf_t *dmabuf;
+  int i;
+
+  for (i = 0; i < V4L2_REQBUFS_COUNT_MAX; i++)
+    {
+      dmabuf = &type_inf->dmabuf[i];
+      if (dmabuf->filep != NULL)
+        {
+          file_munmap(dmabuf->vaddr, dmabuf->length);
+          file_put(dmabuf->filep);
+          dmabuf->filep = NULL;
+        }
+    }
+}
+
 static void cleanup_streamresources(FAR capture_type_inf_t *type_inf,
                                     FAR capture_mng_t *cmng)
 {
+  release_dmabuf(type_inf);
   video_framebuff_uninit(&type_inf->bufinf);
   nxsem_destroy(&type_inf->wait_capture.dqbuf_wait_flg);
   nxmutex_destroy(&type_inf->lock_state);
@@ -2169,6 +2269,7 @@ static int capture_reqbufs(FAR struct file *filep,
           reqbufs->count = V4L2_REQBUFS_COUNT_MAX;
         }
 
+      release_dmabuf(type_inf);
       video_framebuff_change_mode(&type_inf->bufinf, reqbufs->mode);
       ret = video_framebuff_realloc_container(&type_inf->bufinf,
                                               reqbufs->count);
@@ -2246,7 +2347,9 @@ static int capture_qbuf(FAR struct file *filep,
   FAR capture_type_inf_t *type_inf;
   FAR vbuf_container_t *container;
   enum capture_state_e next_capture_state;
+  unsigned long userptr = buf->m.userptr;
   irqstate_t flags;
+  int ret;
 
   if (cmng == NULL || buf == NULL)
     {
@@ -2264,6 +2367,17 @@ static int capture_qbuf(FAR struct file *filep,
       return -EINVAL;
     }
 
+  if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      /* The frame is captured straight into the imported buffer */
+
+      ret = import_dmabuf(type_inf, buf, &userptr);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
   container = video_framebuff_get_container(&type_inf->bufinf);
   if (container == NULL)
     {
@@ -2271,6 +2385,7 @@ static int capture_qbuf(FAR struct file *filep,
     }
 
   memcpy(&container->buf, buf, sizeof(struct v4l2_buffer));
+  container->buf.m.userptr = userptr;
   if (buf->memory == V4L2_MEMORY_MMAP)
     {
       /* only use userptr inside the container */
@@ -2394,6 +2509,11 @@ static int capture_dqbuf(FAR struct file *filep,
     }
 
   memcpy(buf, &container->buf, sizeof(struct v4l2_buffer));
+  if (buf->memory == V4L2_MEMORY_DMABUF)
+    {
+      buf->m.fd = type_inf->dmabuf[buf->index].fd;
+    }
+
   video_framebuff_free_container(&type_inf->bufinf, container);
 
   return OK;
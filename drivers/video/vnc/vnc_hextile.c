@@ -0,0 +1,673 @@
+/****************************************************************************
+ * drivers/video/vnc/vnc_hextile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+
+#include <sys/param.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest encoded tile, a Raw one of 16x16 pixels */
+
+#define HEXTILE_MAXTILE(bpp) \
+  (1 + VNC_TILESIZE * VNC_TILESIZE * (bpp))
+
+/* A tile hash of zero means that the client view of the tile is unknown */
+
+#define HEXTILE_NOHASH      0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct vnc_hextile_s
+{
+  FAR struct vnc_session_s *session;
+  unsigned int bpp;            /* Remote bytes per pixel */
+  bool bigendian;              /* Remote byte order */
+  bool bgvalid;                /* The background carries over */
+  bool fgvalid;                /* The foreground carries over */
+  uint32_t bg;                 /* Background of the previous tile */
+  uint32_t fg;                 /* Foreground of the previous tile */
+  size_t pos;                  /* Bytes in session->outbuf */
+
+  union
+  {
+    vnc_convert8_t bpp8;
+    vnc_convert16_t bpp16;
+    vnc_convert32_t bpp32;
+  } convert;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile_hash
+ *
+ * Description:
+ *   Return the FNV-1a hash of the local pixels of a whole tile.
+ *
+ ****************************************************************************/
+
+static uint32_t vnc_hextile_hash(FAR struct vnc_session_s *session,
+                                 fb_coord_t x, fb_coord_t y)
+{
+  FAR const lfb_color_t *src;
+  uint32_t hash = 2166136261u;
+  int i;
+  int j;
+
+  for (j = 0; j < VNC_TILESIZE; j++)
+    {
+      src = (FAR const lfb_color_t *)
+        (session->fb + RFB_STRIDE * (y + j) + RFB_BYTESPERPIXEL * x);
+
+      for (i = 0; i < VNC_TILESIZE; i++)
+        {
+          hash = (hash ^ src[i]) * 16777619u;
+        }
+    }
+
+  return hash != HEXTILE_NOHASH ? hash : 1;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_load
+ *
+ * Description:
+ *   Convert the pixels of a tile to the remote format into tilebuf.
+ *
+ ****************************************************************************/
+
+static void vnc_hextile_load(FAR struct vnc_hextile_s *ctx,
+                             fb_coord_t x, fb_coord_t y,
+                             fb_coord_t w, fb_coord_t h)
+{
+  FAR struct vnc_session_s *session = ctx->session;
+  FAR uint32_t *dest = session->tilebuf;
+  FAR const lfb_color_t *src;
+  fb_coord_t i;
+  fb_coord_t j;
+
+  for (j = 0; j < h; j++)
+    {
+      src = (FAR const lfb_color_t *)
+        (session->fb + RFB_STRIDE * (y + j) + RFB_BYTESPERPIXEL * x);
+
+      for (i = 0; i < w; i++)
+        {
+          if (ctx->bpp == 1)
+            {
+              *dest++ = ctx->convert.bpp8(src[i]);
+            }
+          else if (ctx->bpp == 2)
+            {
+              *dest++ = ctx->convert.bpp16(src[i]);
+            }
+          else
+            {
+              *dest++ = ctx->convert.bpp32(src[i]);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_putpixel
+ ****************************************************************************/
+
+static FAR uint8_t *vnc_hextile_putpixel(FAR struct vnc_hextile_s *ctx,
+                                         FAR uint8_t *dest, uint32_t pixel)
+{
+  if (ctx->bpp == 1)
+    {
+      *dest = (uint8_t)pixel;
+    }
+  else if (ctx->bpp == 2)
+    {
+      if (ctx->bigendian)
+        {
+          rfb_putbe16(dest, pixel);
+        }
+      else
+        {
+          rfb_putle16(dest, pixel);
+        }
+    }
+  else
+    {
+      if (ctx->bigendian)
+        {
+          rfb_putbe32(dest, pixel);
+        }
+      else
+        {
+          rfb_putle32(dest, pixel);
+        }
+    }
+
+  return dest + ctx->bpp;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_raw
+ ****************************************************************************/
+
+static size_t vnc_hextile_raw(FAR struct vnc_hextile_s *ctx,
+                              FAR uint8_t *dest, fb_coord_t x, fb_coord_t y,
+                              fb_coord_t w, fb_coord_t h)
+{
+  FAR uint8_t *ptr = dest;
+  int n = w * h;
+  int i;
+
+  vnc_hextile_load(ctx, x, y, w, h);
+
+  *ptr++ = RFB_SUBENCODING_RAW;
+  for (i = 0; i < n; i++)
+    {
+      ptr = vnc_hextile_putpixel(ctx, ptr, ctx->session->tilebuf[i]);
+    }
+
+  /* Neither color may be carried over a Raw tile */
+
+  ctx->bgvalid = false;
+  ctx->fgvalid = false;
+  return ptr - dest;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_tile
+ *
+ * Description:
+ *   Encode one tile of up to 16x16 pixels into dest.  Tiles of one color
+ *   are sent as their background only, tiles of two colors as foreground
+ *   sub-rectangles, tiles of more colors as colored sub-rectangles, each
+ *   unless the Raw tile is not larger.
+ *
+ * Returned Value:
+ *   The size of the encoded tile.
+ *
+ ****************************************************************************/
+
+static size_t vnc_hextile_tile(FAR struct vnc_hextile_s *ctx,
+                               FAR uint8_t *dest, fb_coord_t x, fb_coord_t y,
+                               fb_coord_t w, fb_coord_t h)
+{
+  FAR uint32_t *tile = ctx->session->tilebuf;
+  FAR uint8_t *ptr;
+  FAR uint8_t *nsubrects;
+  size_t rawsize = 1 + w * h * ctx->bpp;
+  uint32_t c0;
+  uint32_t c1;
+  uint32_t bg;
+  uint32_t fg = 0;
+  uint8_t flags = 0;
+  bool colored = false;
+  int n0 = 0;
+  int n1 = 0;
+  int n = w * h;
+  int nrects = 0;
+  int i;
+  int j;
+
+  vnc_hextile_load(ctx, x, y, w, h);
+
+  /* Count the two first colors and check for more */
+
+  c0 = tile[0];
+  c1 = c0;
+  for (i = 0; i < n; i++)
+    {
+      if (tile[i] == c0)
+        {
+          n0++;
+        }
+      else if (n1 == 0 || tile[i] == c1)
+        {
+          c1 = tile[i];
+          n1++;
+        }
+      else
+        {
+          colored = true;
+        }
+    }
+
+  bg = n0 >= n1 ? c0 : c1;
+  ptr = dest + 1;
+
+  if (!ctx->bgvalid || ctx->bg != bg)
+    {
+      flags |= RFB_SUBENCODING_BACK;
+      ptr = vnc_hextile_putpixel(ctx, ptr, bg);
+      ctx->bg = bg;
+      ctx->bgvalid = true;
+    }
+
+  if (n1 == 0)
+    {
+      /* A solid tile */
+
+      *dest = flags;
+      return ptr - dest;
+    }
+
+  flags |= RFB_SUBENCODING_ANY;
+  if (colored)
+    {
+      flags |= RFB_SUBENCODING_COLORED;
+    }
+  else
+    {
+      fg = bg == c0 ? c1 : c0;
+      if (!ctx->fgvalid || ctx->fg != fg)
+        {
+          flags |= RFB_SUBENCODING_FORE;
+          ptr = vnc_hextile_putpixel(ctx, ptr, fg);
+        }
+    }
+
+  nsubrects = ptr++;
+
+  /* Cover the pixels that are not background with sub-rectangles, each
+   * as wide and then as high as the color allows.  Covered pixels become
+   * background.
+   */
+
+  for (j = 0; j < h; j++)
+    {
+      for (i = 0; i < w; i++)
+        {
+          uint32_t c = tile[j * w + i];
+          int x2 = i + 1;
+          int y2 = j + 1;
+          int k;
+          int m;
+
+          if (c == bg)
+            {
+              continue;
+            }
+
+          while (x2 < w && tile[j * w + x2] == c)
+            {
+              x2++;
+            }
+
+          for (; y2 < h; y2++)
+            {
+              for (k = i; k < x2; k++)
+                {
+                  if (tile[y2 * w + k] != c)
+                    {
+                      break;
+                    }
+                }
+
+              if (k < x2)
+                {
+                  break;
+                }
+            }
+
+          for (k = j; k < y2; k++)
+            {
+              for (m = i; m < x2; m++)
+                {
+                  tile[k * w + m] = bg;
+                }
+            }
+
+          if (colored)
+            {
+              ptr = vnc_hextile_putpixel(ctx, ptr, c);
+            }
+
+          *ptr++ = (i << 4) | j;
+          *ptr++ = ((x2 - i - 1) << 4) | (y2 - j - 1);
+          nrects++;
+
+          if (ptr - dest >= rawsize)
+            {
+              return vnc_hextile_raw(ctx, dest, x, y, w, h);
+            }
+        }
+    }
+
+  *dest = flags;
+  *nsubrects = nrects;
+
+  /* A colored tile leaves no valid foreground behind */
+
+  ctx->fg = fg;
+  ctx->fgvalid = !colored;
+  return ptr - dest;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_flush
+ *
+ * Description:
+ *   Send the encoded data collected in session->outbuf.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_flush(FAR struct vnc_hextile_s *ctx)
+{
+  FAR const uint8_t *src = ctx->session->outbuf;
+  ssize_t nsent;
+
+  while (ctx->pos > 0)
+    {
+      nsent = psock_send(&ctx->session->connect, src, ctx->pos, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send Hextile FrameBufferUpdate failed: %d\n",
+               (int)nsent);
+          return (int)nsent;
+        }
+
+      src      += nsent;
+      ctx->pos -= nsent;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_rect
+ *
+ * Description:
+ *   Encode and send one Hextile rectangle.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_rect(FAR struct vnc_hextile_s *ctx,
+                            fb_coord_t x, fb_coord_t y,
+                            fb_coord_t w, fb_coord_t h)
+{
+  FAR uint8_t *outbuf = ctx->session->outbuf;
+  FAR struct rfb_rectangle_s *rrect;
+  size_t maxtile = HEXTILE_MAXTILE(ctx->bpp);
+  fb_coord_t tx;
+  int ret;
+
+  if (ctx->pos + SIZEOF_RFB_RECTANGE_S(0) + maxtile >
+      VNCSERVER_UPDATE_BUFSIZE)
+    {
+      ret = vnc_hextile_flush(ctx);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  rrect = (FAR struct rfb_rectangle_s *)(outbuf + ctx->pos);
+  rfb_putbe16(rrect->xpos,     x);
+  rfb_putbe16(rrect->ypos,     y);
+  rfb_putbe16(rrect->width,    w);
+  rfb_putbe16(rrect->height,   h);
+  rfb_putbe32(rrect->encoding, RFB_ENCODING_HEXTILE);
+  ctx->pos += SIZEOF_RFB_RECTANGE_S(0);
+
+  /* Colors are carried over between the tiles of a rectangle only */
+
+  ctx->bgvalid = false;
+  ctx->fgvalid = false;
+
+  for (tx = 0; tx < w; tx += VNC_TILESIZE)
+    {
+      if (ctx->pos + maxtile > VNCSERVER_UPDATE_BUFSIZE)
+        {
+          ret = vnc_hextile_flush(ctx);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      ctx->pos += vnc_hextile_tile(ctx, outbuf + ctx->pos, x + tx, y,
+                                   MIN(w - tx, VNC_TILESIZE), h);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.  The rectangle
+ *  is cut along the 16x16 tile grid of the screen, and whole tiles whose
+ *  content hashes the same as when they were last sent are skipped.  The
+ *  tiles of a grid row that are sent go out as one rectangle per run.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect    - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on failure that
+ *   indicates the nature of the failure.  A failure is only returned
+ *   in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct fb_area_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  struct vnc_hextile_s ctx;
+  bool send[VNC_TILECOLS];
+  fb_coord_t x0 = rect->x;
+  fb_coord_t x1 = MIN(rect->x + rect->w, CONFIG_VNCSERVER_SCREENWIDTH);
+  fb_coord_t y1 = MIN(rect->y + rect->h, CONFIG_VNCSERVER_SCREENHEIGHT);
+  fb_coord_t y;
+  fb_coord_t h;
+  uint8_t colorfmt;
+  int nrect;
+  int col;
+  int ret;
+
+  ctx.session   = session;
+  ctx.bpp       = (session->bpp + 7) >> 3;
+  ctx.bigendian = session->bigendian;
+  ctx.pos       = 0;
+
+  colorfmt = session->colorfmt;
+  switch (colorfmt)
+    {
+      case FB_FMT_RGB8_222:
+        ctx.convert.bpp8 = vnc_convert_rgb8_222;
+        break;
+
+      case FB_FMT_RGB8_332:
+        ctx.convert.bpp8 = vnc_convert_rgb8_332;
+        break;
+
+      case FB_FMT_RGB16_555:
+        ctx.convert.bpp16 = vnc_convert_rgb16_555;
+        break;
+
+      case FB_FMT_RGB16_565:
+        ctx.convert.bpp16 = vnc_convert_rgb16_565;
+        break;
+
+      case FB_FMT_RGB32:
+        ctx.convert.bpp32 = vnc_convert_rgb32_888;
+        break;
+
+      default:
+        gerr("ERROR: Unrecognized color format: %d\n", session->colorfmt);
+        return -EINVAL;
+    }
+
+  /* A Raw tile has to fit in the update buffer, or the client view of the
+   * tiles no longer matches their hashes.
+   */
+
+  if (SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0)) +
+      HEXTILE_MAXTILE(ctx.bpp) > VNCSERVER_UPDATE_BUFSIZE)
+    {
+      session->tilereset = true;
+      ret = vnc_rre(session, rect);
+      return ret != 0 ? ret : vnc_raw(session, rect);
+    }
+
+  if (session->tilereset)
+    {
+      session->tilereset = false;
+      memset(session->tilehash, HEXTILE_NOHASH, sizeof(session->tilehash));
+    }
+
+  for (y = rect->y; y < y1 && colorfmt == session->colorfmt; y += h)
+    {
+      int row = y / VNC_TILESIZE;
+      fb_coord_t ty = row * VNC_TILESIZE;
+      bool full;
+
+      h = MIN(ty + VNC_TILESIZE, y1) - y;
+
+      /* Decide which tiles of this grid row to send.  A tile that is only
+       * partly sent has an unknown client view afterwards.
+       */
+
+      nrect = 0;
+      for (col = x0 / VNC_TILESIZE; col * VNC_TILESIZE < x1; col++)
+        {
+          FAR uint32_t *stored =
+            &session->tilehash[row * VNC_TILECOLS + col];
+          fb_coord_t tx = col * VNC_TILESIZE;
+
+          full = tx >= x0 && tx + VNC_TILESIZE <= x1 && ty == y &&
+                 h == VNC_TILESIZE;
+          if (full)
+            {
+              uint32_t hash = vnc_hextile_hash(session, tx, ty);
+
+              send[col] = hash != *stored;
+              *stored   = hash;
+            }
+          else
+            {
+              send[col] = true;
+              *stored   = HEXTILE_NOHASH;
+            }
+
+          if (send[col] && (col == x0 / VNC_TILESIZE || !send[col - 1]))
+            {
+              nrect++;
+            }
+        }
+
+      if (nrect == 0)
+        {
+          continue;
+        }
+
+      /* One FramebufferUpdate per grid row with a rectangle per run */
+
+      if (ctx.pos + SIZEOF_RFB_FRAMEBUFFERUPDATE_S(0) >
+          VNCSERVER_UPDATE_BUFSIZE)
+        {
+          ret = vnc_hextile_flush(&ctx);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      update = (FAR struct rfb_framebufferupdate_s *)
+        (session->outbuf + ctx.pos);
+      update->msgtype = RFB_FBUPDATE_MSG;
+      update->padding = 0;
+      rfb_putbe16(update->nrect, nrect);
+      ctx.pos += SIZEOF_RFB_FRAMEBUFFERUPDATE_S(0);
+
+      for (col = x0 / VNC_TILESIZE; col * VNC_TILESIZE < x1; col++)
+        {
+          fb_coord_t start;
+          fb_coord_t end;
+
+          if (!send[col])
+            {
+              continue;
+            }
+
+          start = MAX(col * VNC_TILESIZE, x0);
+          while (col + 1 < VNC_TILECOLS && (col + 1) * VNC_TILESIZE < x1 &&
+                 send[col + 1])
+            {
+              col++;
+            }
+
+          end = MIN((col + 1) * VNC_TILESIZE, x1);
+          ret = vnc_hextile_rect(&ctx, start, y, end - start, h);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      updinfo("Sent row {(%d, %d),(%d, %d)} as %d rects\n",
+              x0, y, rect->w, h, nrect);
+    }
+
+  return vnc_hextile_flush(&ctx);
+}
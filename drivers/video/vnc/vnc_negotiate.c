@@ -518,6 +518,9 @@ int vnc_client_pixelformat(FAR struct vnc_session_s *session,
       return -ENOSYS;
     }
 
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  session->tilereset = true;
+#endif
   session->change = true;
   return OK;
 }
@@ -293,6 +293,15 @@ int vnc_receiver(FAR struct vnc_session_s *session)
                   rect.w = rfb_getbe16(update->width);
                   rect.h = rfb_getbe16(update->height);
 
+#ifdef CONFIG_VNCSERVER_HEXTILE
+                  /* A full update must not skip unchanged tiles */
+
+                  if (!update->incremental)
+                    {
+                      session->tilereset = true;
+                    }
+#endif
+
                   ret = vnc_update_rectangle(session, &rect, false);
                   if (ret < 0)
                     {
@@ -471,6 +480,10 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
   /* Assume that there are no common encodings (other than RAW) */
 
   session->rre = false;
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  session->hextile = false;
+  session->tilereset = true;
+#endif
 
   /* Loop for each client supported encoding */
 
@@ -487,6 +500,12 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+#ifdef CONFIG_VNCSERVER_HEXTILE
+      else if (encoding == RFB_ENCODING_HEXTILE)
+        {
+          session->hextile = true;
+        }
+#endif
     }
 
   session->change = true;
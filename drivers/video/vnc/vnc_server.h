@@ -137,6 +137,14 @@
 #  define CONFIG_VNCSERVER_UPDATE_BUFSIZE 4096
 #endif
 
+/* Hextile tiles, the grid of the screen they are hashed in */
+
+#define VNC_TILESIZE        16
+#define VNC_TILECOLS \
+  ((CONFIG_VNCSERVER_SCREENWIDTH + VNC_TILESIZE - 1) / VNC_TILESIZE)
+#define VNC_TILEROWS \
+  ((CONFIG_VNCSERVER_SCREENHEIGHT + VNC_TILESIZE - 1) / VNC_TILESIZE)
+
 #define VNCSERVER_UPDATE_BUFSIZE \
   (CONFIG_VNCSERVER_UPDATE_BUFSIZE + SIZEOF_RFB_FRAMEBUFFERUPDATE_S(0))
 
@@ -209,6 +217,10 @@ struct vnc_session_s
   volatile uint8_t bpp;        /* Remote bits per pixel */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  volatile bool hextile;       /* True: Remote supports Hextile encoding */
+  volatile bool tilereset;     /* True: Client view of the tiles unknown */
+#endif
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -244,6 +256,13 @@ struct vnc_session_s
 
   uint8_t inbuf[CONFIG_VNCSERVER_INBUFFER_SIZE];
   uint8_t outbuf[VNCSERVER_UPDATE_BUFSIZE];
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  /* Hextile encoding: hashes of the tiles last sent and one tile */
+
+  uint32_t tilehash[VNC_TILEROWS * VNC_TILECOLS];
+  uint32_t tilebuf[VNC_TILESIZE * VNC_TILESIZE];
+#endif
 };
 
 /* This structure is used to communicate start-up status between the server
@@ -466,6 +485,29 @@ int vnc_receiver(FAR struct vnc_session_s *session);
 
 int vnc_rre(FAR struct vnc_session_s *session, FAR struct fb_area_s *rect);
 
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding, skipping the
+ *  tiles that have not changed since they were last sent.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on failure that
+ *   indicates the nature of the failure.  A failure is only returned
+ *   in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct fb_area_s *rect);
+#endif
+
 /****************************************************************************
  * Name: vnc_raw
  *
@@ -408,14 +408,29 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.x, srcrect->rect.y,
               srcrect->rect.w, srcrect->rect.h);
 
-      /* Attempt to use RRE encoding */
+#ifdef CONFIG_VNCSERVER_HEXTILE
+      /* Prefer Hextile, it only sends the tiles that have changed.  The
+       * other encodings would leave the tile hashes behind.
+       */
 
-      ret = vnc_rre(session, &srcrect->rect);
-      if (ret == 0)
+      if (session->hextile)
+        {
+          ret = vnc_hextile(session, &srcrect->rect);
+        }
+      else
+#endif
         {
-          /* Perform the framebuffer update using the default RAW encoding */
+          /* Attempt to use RRE encoding */
 
-          ret = vnc_raw(session, &srcrect->rect);
+          ret = vnc_rre(session, &srcrect->rect);
+          if (ret == 0)
+            {
+              /* Perform the framebuffer update using the default RAW
+               * encoding
+               */
+
+              ret = vnc_raw(session, &srcrect->rect);
+            }
         }
 
       /* Release the update structure */
@@ -27,9 +27,11 @@
 #include <debug.h>
 #include <errno.h>
 #include <stdio.h>
+#include <sys/param.h>
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/virtio/virtio.h>
@@ -46,15 +48,25 @@
 
 /* Block feature bits */
 
+#define VIRTIO_BLK_F_SIZE_MAX       1  /* Max size of any single segment */
 #define VIRTIO_BLK_F_RO             5  /* Disk is read-only */
 #define VIRTIO_BLK_F_BLK_SIZE       6  /* Block size of disk is available */
 #define VIRTIO_BLK_F_FLUSH          9  /* Cache flush command support */
+#define VIRTIO_BLK_F_MQ             12 /* Support more than one vq */
+#define VIRTIO_BLK_F_DISCARD        13 /* Discard command support */
+#define VIRTIO_BLK_F_WRITE_ZEROES   14 /* Write zeroes command support */
 
 /* Block request type */
 
 #define VIRTIO_BLK_T_IN             0  /* READ */
 #define VIRTIO_BLK_T_OUT            1  /* WRITE */
 #define VIRTIO_BLK_T_FLUSH          4  /* FLUSH */
+#define VIRTIO_BLK_T_DISCARD        11 /* DISCARD */
+#define VIRTIO_BLK_T_WRITE_ZEROES   13 /* WRITE ZEROES */
+
+/* Discard and write zeroes segment flags */
+
+#define VIRTIO_BLK_WRITE_ZEROES_FLAG_UNMAP (1 << 0)
 
 /* Block request return status */
 
@@ -67,6 +79,14 @@
 #define VIRTIO_BLK_SECTOR_BITS      9
 #define VIRTIO_BLK_SECTOR_SIZE      (1UL << VIRTIO_BLK_SECTOR_BITS)
 
+/* Max requests in flight for one read or write, notified at once */
+
+#define VIRTIO_BLK_BATCH            8
+
+#ifndef CONFIG_DRIVERS_VIRTIO_BLK_QUEUES
+#  define CONFIG_DRIVERS_VIRTIO_BLK_QUEUES 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -87,6 +107,15 @@ begin_packed_struct struct virtio_blk_resp_s
   uint8_t status;
 } end_packed_struct;
 
+/* Discard and write zeroes request segment */
+
+begin_packed_struct struct virtio_blk_discard_s
+{
+  uint64_t sector;
+  uint32_t num_sectors;
+  uint32_t flags;
+} end_packed_struct;
+
 begin_packed_struct struct virtio_blk_config_s
 {
   uint64_t capacity;
@@ -118,9 +147,12 @@ begin_packed_struct struct virtio_blk_config_s
 struct virtio_blk_priv_s
 {
   FAR struct virtio_device     *vdev;           /* Virtio device */
-  spinlock_t                    lock;           /* Lock */
+  spinlock_t                    lock[CONFIG_DRIVERS_VIRTIO_BLK_QUEUES];
+  int                           nqueues;        /* Virtqueues in use */
   uint64_t                      nsectors;       /* Sectore numbers */
   uint32_t                      block_size;     /* Block size */
+  uint32_t                      max_blocks;     /* Max blocks per request */
+  uint32_t                      max_trim;       /* Max sectors per trim */
   char                          name[NAME_MAX]; /* Device name */
 };
 
@@ -146,6 +178,8 @@ static int     virtio_blk_geometry(FAR struct inode *inode,
 static int     virtio_blk_ioctl(FAR struct inode *inode, int cmd,
                                 unsigned long arg);
 static int     virtio_blk_flush(FAR struct virtio_blk_priv_s *priv);
+static int     virtio_blk_trim(FAR struct virtio_blk_priv_s *priv,
+                               FAR const struct blk_trim_s *trim);
 
 /* Other functions */
 
@@ -188,24 +222,25 @@ static int g_virtio_blk_idx = 0;
  * Name: virtio_blk_wait_complete
  *
  * Description:
- *   Wait the virtio block request complete
+ *   Wait the count virtio block requests queued with respsem complete
  *
  ****************************************************************************/
 
 static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
-                                     FAR sem_t *respsem)
+                                     FAR sem_t *respsem, int count)
 {
   FAR struct virtio_blk_priv_s *priv = vq->vq_dev->priv;
   FAR sem_t *sem;
 
   if (up_interrupt_context() || OSINIT_IS_PANIC())
     {
-      for (; ; )
+      while (count > 0)
         {
-          sem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
+          sem = virtqueue_get_buffer_lock(vq, NULL, NULL,
+                                          &priv->lock[vq->vq_queue_index]);
           if (sem == respsem)
             {
-              break;
+              count--;
             }
           else if (sem != NULL)
             {
@@ -215,15 +250,77 @@ static void virtio_blk_wait_complete(FAR struct virtqueue *vq,
     }
   else
     {
-      nxsem_wait_uninterruptible(respsem);
+      while (count-- > 0)
+        {
+          nxsem_wait_uninterruptible(respsem);
+        }
     }
 }
 
+/****************************************************************************
+ * Name: virtio_blk_getvq
+ *
+ * Description:
+ *   Get the virtqueue of the current CPU
+ *
+ ****************************************************************************/
+
+static FAR struct virtqueue *
+virtio_blk_getvq(FAR struct virtio_blk_priv_s *priv)
+{
+  return priv->vdev->vrings_info[this_cpu() % priv->nqueues].vq;
+}
+
+/****************************************************************************
+ * Name: virtio_blk_request
+ *
+ * Description:
+ *   Send one request and wait for it, the last buffer is the status.
+ *
+ ****************************************************************************/
+
+static int virtio_blk_request(FAR struct virtio_blk_priv_s *priv,
+                              FAR struct virtqueue_buf *vb, int nbufs)
+{
+  FAR struct virtqueue *vq = virtio_blk_getvq(priv);
+  FAR spinlock_t *lock = &priv->lock[vq->vq_queue_index];
+  FAR struct virtio_blk_resp_s *resp = vb[nbufs - 1].buf;
+  irqstate_t flags;
+  sem_t respsem;
+  int ret;
+
+  nxsem_init(&respsem, 0, 0);
+  resp->status = VIRTIO_BLK_S_IOERR;
+
+  flags = spin_lock_irqsave(lock);
+  ret = virtqueue_add_buffer(vq, vb, nbufs - 1, 1, &respsem);
+  if (ret < 0)
+    {
+      spin_unlock_irqrestore(lock, flags);
+      return ret;
+    }
+
+  virtqueue_kick(vq);
+  spin_unlock_irqrestore(lock, flags);
+
+  /* Wait for the request completion */
+
+  nxsem_wait_uninterruptible(&respsem);
+  if (resp->status == VIRTIO_BLK_S_UNSUPP)
+    {
+      return -ENOTSUP;
+    }
+
+  return resp->status == VIRTIO_BLK_S_OK ? OK : -EIO;
+}
+
 /****************************************************************************
  * Name: virtio_blk_rdwr
  *
  * Description:
- *   Common function for read and write
+ *   Common function for read and write.  The transfer is split into
+ *   requests of at most max_blocks, and up to VIRTIO_BLK_BATCH of them are
+ *   queued before notifying the device, so they are served in parallel.
  *
  ****************************************************************************/
 
@@ -231,70 +328,105 @@ static ssize_t virtio_blk_rdwr(FAR struct virtio_blk_priv_s *priv,
                                FAR void *buffer, blkcnt_t startsector,
                                unsigned int nsectors, bool write)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
+  FAR struct virtqueue *vq = virtio_blk_getvq(priv);
+  FAR spinlock_t *lock = &priv->lock[vq->vq_queue_index];
+  struct virtio_blk_resp_s resp[VIRTIO_BLK_BATCH];
+  struct virtio_blk_req_s req[VIRTIO_BLK_BATCH];
   FAR struct virtqueue_buf vb[3];
-  struct virtio_blk_resp_s resp;
-  struct virtio_blk_req_s req;
+  FAR uint8_t *buf = buffer;
+  unsigned int done = 0;
+  unsigned int count;
   irqstate_t flags;
   sem_t respsem;
-  ssize_t ret;
+  ssize_t ret = OK;
   int readnum;
+  int nreq;
+  int i;
 
   nxsem_init(&respsem, 0, 0);
-
-  /* Build the block request */
-
-  req.type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
-  req.reserved = 0;
-  req.sector   = startsector * priv->block_size >> VIRTIO_BLK_SECTOR_BITS;
-  resp.status  = VIRTIO_BLK_S_IOERR;
-
-  /* Fill the virtqueue buffer:
-   * Buffer 0: the block out header;
-   * Buffer 1: the read/write buffer;
-   * Buffer 2: the block in header, return the status.
-   */
-
-  vb[0].buf = &req;
-  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
-  vb[1].buf = buffer;
-  vb[1].len = nsectors * priv->block_size;
-  vb[2].buf = &resp;
-  vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
   readnum = write ? 2 : 1;
 
   if (up_interrupt_context())
     {
-      virtqueue_disable_cb_lock(vq, &priv->lock);
+      virtqueue_disable_cb_lock(vq, lock);
     }
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum, &respsem);
-  if (ret < 0)
+  while (done < nsectors)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      vrterr("virtqueue_add_buffer failed, ret=%zd\n", ret);
-      goto err;
-    }
+      flags = spin_lock_irqsave(lock);
+      for (nreq = 0; nreq < VIRTIO_BLK_BATCH && done < nsectors; nreq++)
+        {
+          count = MIN(nsectors - done, priv->max_blocks);
+
+          /* Build the block request */
+
+          req[nreq].type     = write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
+          req[nreq].reserved = 0;
+          req[nreq].sector   = (startsector + done) * priv->block_size >>
+                               VIRTIO_BLK_SECTOR_BITS;
+          resp[nreq].status  = VIRTIO_BLK_S_IOERR;
+
+          /* Fill the virtqueue buffer:
+           * Buffer 0: the block out header;
+           * Buffer 1: the read/write buffer;
+           * Buffer 2: the block in header, return the status.
+           */
+
+          vb[0].buf = &req[nreq];
+          vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
+          vb[1].buf = buf + (size_t)done * priv->block_size;
+          vb[1].len = count * priv->block_size;
+          vb[2].buf = &resp[nreq];
+          vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+
+          ret = virtqueue_add_buffer(vq, vb, readnum, 3 - readnum,
+                                     &respsem);
+          if (ret < 0)
+            {
+              break;
+            }
 
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
+          done += count;
+        }
 
-  /* Wait for the request completion */
+      if (nreq == 0)
+        {
+          spin_unlock_irqrestore(lock, flags);
+          vrterr("virtqueue_add_buffer failed, ret=%zd\n", ret);
+          goto err;
+        }
 
-  virtio_blk_wait_complete(vq, &respsem);
+      /* A full virtqueue only limits the batch, the rest of the transfer
+       * is queued after these requests complete.
+       */
 
-  if (resp.status != VIRTIO_BLK_S_OK)
-    {
-      vrterr("%s Error\n", write ? "Write" : "Read");
-      ret = -EIO;
+      ret = OK;
+      virtqueue_kick(vq);
+      spin_unlock_irqrestore(lock, flags);
+
+      /* Wait for the request completion */
+
+      virtio_blk_wait_complete(vq, &respsem, nreq);
+
+      for (i = 0; i < nreq; i++)
+        {
+          if (resp[i].status != VIRTIO_BLK_S_OK)
+            {
+              vrterr("%s Error\n", write ? "Write" : "Read");
+              ret = -EIO;
+            }
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
     }
 
 err:
   if (up_interrupt_context())
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock);
+      virtqueue_enable_cb_lock(vq, lock);
     }
 
   return ret >= 0 ? nsectors : ret;
@@ -407,47 +539,94 @@ static int virtio_blk_geometry(FAR struct inode *inode,
 
 static int virtio_blk_flush(FAR struct virtio_blk_priv_s *priv)
 {
-  FAR struct virtio_device *vdev = priv->vdev;
-  FAR struct virtqueue *vq = vdev->vrings_info[0].vq;
   FAR struct virtqueue_buf vb[2];
   struct virtio_blk_resp_s resp;
   struct virtio_blk_req_s req;
-  irqstate_t flags;
-  sem_t respsem;
   int ret;
 
-  nxsem_init(&respsem, 0, 0);
-
   /* Build the block request */
 
   req.type     = VIRTIO_BLK_T_FLUSH;
   req.reserved = 0;
   req.sector   = 0;
-  resp.status  = VIRTIO_BLK_S_IOERR;
 
   vb[0].buf = &req;
   vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
   vb[1].buf = &resp;
   vb[1].len = VIRTIO_BLK_RESP_HEADER_SIZE;
 
-  flags = spin_lock_irqsave(&priv->lock);
-  ret = virtqueue_add_buffer(vq, vb, 1, 1, &respsem);
+  ret = virtio_blk_request(priv, vb, 2);
   if (ret < 0)
     {
-      spin_unlock_irqrestore(&priv->lock, flags);
-      return ret;
+      vrterr("Flush Error\n");
     }
 
-  virtqueue_kick(vq);
-  spin_unlock_irqrestore(&priv->lock, flags);
+  return ret;
+}
 
-  /* Wait for the request completion */
+/****************************************************************************
+ * Name: virtio_blk_trim
+ *
+ * Description:
+ *   Discard a range of sectors, with write zeroes plus unmap when the
+ *   device has no discard command.
+ *
+ ****************************************************************************/
 
-  nxsem_wait_uninterruptible(&respsem);
-  if (resp.status != VIRTIO_BLK_S_OK)
+static int virtio_blk_trim(FAR struct virtio_blk_priv_s *priv,
+                           FAR const struct blk_trim_s *trim)
+{
+  FAR struct virtqueue_buf vb[3];
+  struct virtio_blk_discard_s seg;
+  struct virtio_blk_resp_s resp;
+  struct virtio_blk_req_s req;
+  uint64_t remain;
+  uint32_t flags = 0;
+  int ret = OK;
+
+  if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_RO))
     {
-      vrterr("Flush Error\n");
-      ret = -EIO;
+      return -EPERM;
+    }
+
+  if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_DISCARD))
+    {
+      req.type = VIRTIO_BLK_T_DISCARD;
+    }
+  else
+    {
+      req.type = VIRTIO_BLK_T_WRITE_ZEROES;
+      flags    = VIRTIO_BLK_WRITE_ZEROES_FLAG_UNMAP;
+    }
+
+  req.reserved = 0;
+  req.sector   = 0;
+  seg.sector   = trim->startsector * priv->block_size >>
+                 VIRTIO_BLK_SECTOR_BITS;
+  remain       = trim->nsectors * priv->block_size >>
+                 VIRTIO_BLK_SECTOR_BITS;
+
+  vb[0].buf = &req;
+  vb[0].len = VIRTIO_BLK_REQ_HEADER_SIZE;
+  vb[1].buf = &seg;
+  vb[1].len = sizeof(seg);
+  vb[2].buf = &resp;
+  vb[2].len = VIRTIO_BLK_RESP_HEADER_SIZE;
+
+  while (remain > 0)
+    {
+      seg.num_sectors = MIN(remain, priv->max_trim);
+      seg.flags       = flags;
+
+      ret = virtio_blk_request(priv, vb, 3);
+      if (ret < 0)
+        {
+          vrterr("Trim Error, ret=%d\n", ret);
+          break;
+        }
+
+      seg.sector += seg.num_sectors;
+      remain     -= seg.num_sectors;
     }
 
   return ret;
@@ -474,6 +653,15 @@ static int virtio_blk_ioctl(FAR struct inode *inode, int cmd,
             ret = virtio_blk_flush(priv);
           }
         break;
+
+      case BIOC_TRIM:
+        if (virtio_has_feature(priv->vdev, VIRTIO_BLK_F_DISCARD) ||
+            virtio_has_feature(priv->vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+          {
+            ret = virtio_blk_trim(priv,
+                                  (FAR const struct blk_trim_s *)arg);
+          }
+        break;
     }
 
   return ret;
@@ -490,7 +678,8 @@ static void virtio_blk_done(FAR struct virtqueue *vq)
 
   for (; ; )
     {
-      respsem = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock);
+      respsem = virtqueue_get_buffer_lock(vq, NULL, NULL,
+                                          &priv->lock[vq->vq_queue_index]);
       if (respsem == NULL)
         {
           break;
@@ -507,25 +696,48 @@ static void virtio_blk_done(FAR struct virtqueue *vq)
 static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqname[1];
-  vq_callback callback[1];
+  FAR const char *vqname[CONFIG_DRIVERS_VIRTIO_BLK_QUEUES];
+  vq_callback callback[CONFIG_DRIVERS_VIRTIO_BLK_QUEUES];
+  uint16_t nqueues = 1;
   int ret;
+  int i;
 
   priv->vdev = vdev;
   vdev->priv = priv;
-  spin_lock_init(&priv->lock);
+  for (i = 0; i < CONFIG_DRIVERS_VIRTIO_BLK_QUEUES; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+    }
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
-  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_RO) |
+  virtio_negotiate_features(vdev, (1UL << VIRTIO_BLK_F_SIZE_MAX) |
+                                  (1UL << VIRTIO_BLK_F_RO) |
                                   (1UL << VIRTIO_BLK_F_BLK_SIZE) |
-                                  (1UL << VIRTIO_BLK_F_FLUSH), NULL);
+                                  (1UL << VIRTIO_BLK_F_FLUSH) |
+#if CONFIG_DRIVERS_VIRTIO_BLK_QUEUES > 1
+                                  (1UL << VIRTIO_BLK_F_MQ) |
+#endif
+                                  (1UL << VIRTIO_BLK_F_DISCARD) |
+                                  (1UL << VIRTIO_BLK_F_WRITE_ZEROES), NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqname[0]   = "virtio_blk_vq";
-  callback[0] = virtio_blk_done;
-  ret = virtio_create_virtqueues(vdev, 0, 1, vqname, callback, NULL);
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_MQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_blk_config_s,
+                                num_queues, &nqueues);
+    }
+
+  priv->nqueues = MAX(MIN(nqueues, CONFIG_DRIVERS_VIRTIO_BLK_QUEUES), 1);
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      vqname[i]   = "virtio_blk_vq";
+      callback[i] = virtio_blk_done;
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, priv->nqueues, vqname, callback,
+                                 NULL);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -533,7 +745,11 @@ static int virtio_blk_init(FAR struct virtio_blk_priv_s *priv,
     }
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
-  virtqueue_enable_cb(vdev->vrings_info[0].vq);
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      virtqueue_enable_cb(vdev->vrings_info[i].vq);
+    }
+
   return ret;
 }
 
@@ -593,6 +809,35 @@ static int virtio_blk_probe(FAR struct virtio_device *vdev)
       priv->block_size = VIRTIO_BLK_SECTOR_SIZE;
     }
 
+  /* Limit the blocks of one request to the max segment size */
+
+  priv->max_blocks = UINT32_MAX;
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_SIZE_MAX))
+    {
+      uint32_t size_max;
+
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                size_max, &size_max);
+      priv->max_blocks = MAX(size_max / priv->block_size, 1);
+    }
+
+  priv->max_trim = UINT32_MAX;
+  if (virtio_has_feature(vdev, VIRTIO_BLK_F_DISCARD))
+    {
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                max_discard_sectors, &priv->max_trim);
+    }
+  else if (virtio_has_feature(vdev, VIRTIO_BLK_F_WRITE_ZEROES))
+    {
+      virtio_read_config_member(priv->vdev, struct virtio_blk_config_s,
+                                max_write_zeroes_sectors, &priv->max_trim);
+    }
+
+  if (priv->max_trim == 0)
+    {
+      priv->max_trim = UINT32_MAX;
+    }
+
   /* Register block driver */
 
   snprintf(priv->name, NAME_MAX, "/dev/virtblk%d", g_virtio_blk_idx);
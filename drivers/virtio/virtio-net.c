@@ -29,6 +29,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/ip.h>
@@ -44,7 +45,26 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM       0
+#define VIRTIO_NET_F_GUEST_CSUM 1
+#define VIRTIO_NET_F_MAC        5
+#define VIRTIO_NET_F_CTRL_VQ    17
+#define VIRTIO_NET_F_MQ         22
+
+/* Virtio net control virtqueue commands and status */
+
+#define VIRTIO_NET_CTRL_OK              0
+#define VIRTIO_NET_CTRL_MQ              4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET 0
+
+/* Times to poll the control virtqueue for the command status, 10us each */
+
+#define VIRTIO_NET_CTRL_POLLS   100000
+
+/* Virtio net header flags */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM 1
+#define VIRTIO_NET_HDR_F_DATA_VALID 2
 
 /* Virtio net header size and packet buffer size */
 
@@ -52,11 +72,19 @@
 #define VIRTIO_NET_LLHDRSIZE  (sizeof(struct virtio_net_llhdr_s))
 #define VIRTIO_NET_BUFSIZE    (CONFIG_NET_ETH_PKTSIZE + CONFIG_NET_GUARDSIZE)
 
-/* Virtio net virtqueue index and number */
+/* Virtio net virtqueue index and number, RX queue n is the virtqueue 2n
+ * and TX queue n is the virtqueue 2n + 1.  The control virtqueue follows
+ * the last queue pair supported by the device.
+ */
 
-#define VIRTIO_NET_RX         0
-#define VIRTIO_NET_TX         1
-#define VIRTIO_NET_NUM        2
+#ifndef CONFIG_DRIVERS_VIRTIO_NET_QUEUE_PAIRS
+#  define CONFIG_DRIVERS_VIRTIO_NET_QUEUE_PAIRS 1
+#endif
+
+#define VIRTIO_NET_RXQ(n)     (2 * (n))
+#define VIRTIO_NET_TXQ(n)     (2 * (n) + 1)
+#define VIRTIO_NET_IS_RXQ(id) ((id) % 2 == 0)
+#define VIRTIO_NET_NUM        (2 * CONFIG_DRIVERS_VIRTIO_NET_QUEUE_PAIRS)
 
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
@@ -99,6 +127,18 @@ begin_packed_struct struct virtio_net_config_s
   uint32_t supported_hash_types;
 } end_packed_struct;
 
+/* Control command to set the number of queue pairs in use, the device
+ * writes the status to ack.
+ */
+
+begin_packed_struct struct virtio_net_ctrl_mq_s
+{
+  uint8_t  cls;
+  uint8_t  cmd;
+  uint16_t virtqueue_pairs;
+  uint8_t  ack;
+} end_packed_struct;
+
 struct virtio_net_priv_s
 {
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -118,6 +158,9 @@ struct virtio_net_priv_s
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
   int                       bufnum;    /* TX and RX Buffer number */
+  int                       rxnum;     /* RX Buffer number of each queue */
+  int                       npairs;    /* Queue pairs in use */
+  int                       rxposted[CONFIG_DRIVERS_VIRTIO_NET_QUEUE_PAIRS];
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -165,6 +208,12 @@ static int virtio_net_ioctl(FAR struct netdev_lowerhalf_s *dev,
                             int cmd, unsigned long arg);
 #endif
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev);
+static int virtio_net_transmit_batch(FAR struct netdev_lowerhalf_s *dev,
+                                     int queue, FAR netpkt_t **pkts,
+                                     int npkts);
+static int virtio_net_receive_batch(FAR struct netdev_lowerhalf_s *dev,
+                                    int queue, FAR netpkt_t **pkts,
+                                    int npkts);
 
 static int  virtio_net_probe(FAR struct virtio_device *vdev);
 static void virtio_net_remove(FAR struct virtio_device *vdev);
@@ -194,7 +243,9 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+  virtio_net_transmit_batch,
+  virtio_net_receive_batch
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -232,6 +283,19 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
   memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
   hdr->pkt = pkt;
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Let the device complete the checksum prepared by the network stack */
+
+  if (!VIRTIO_NET_IS_RXQ(vq_id) &&
+      (netpkt_offload(pkt)->flags & NETPKT_TX_CSUM) != 0)
+    {
+      hdr->vhdr.flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+      hdr->vhdr.csum_start  = NET_LL_HDRLEN(&dev->netdev) +
+                              netpkt_offload(pkt)->l4off;
+      hdr->vhdr.csum_offset = netpkt_offload(pkt)->csumoff;
+    }
+#endif
+
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
 
   if (virtio_has_feature(priv->vdev, VIRTIO_F_ANY_LAYOUT))
@@ -266,7 +330,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     }
 
   vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  if (VIRTIO_NET_IS_RXQ(vq_id))
     {
       return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
                                        &priv->lock[vq_id]);
@@ -282,14 +346,16 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev,
+                              int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  int vq_id = VIRTIO_NET_RXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR netpkt_t *pkt;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  for (i = 0; priv->rxposted[queue] < priv->rxnum; i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
@@ -312,31 +378,40 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      if (virtio_net_addbuffer(dev, vq, pkt, vq_id) < 0)
+        {
+          netpkt_free(dev, pkt, NETPKT_RX);
+          break;
+        }
+
+      priv->rxposted[queue]++;
     }
 
+  /* Notify the other side once for all the buffers added */
+
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(vq, &priv->lock[vq_id]);
     }
 }
 
 /****************************************************************************
- * Name: virtio_net_txfree
+ * Name: virtio_net_txreclaim
  ****************************************************************************/
 
-static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_txreclaim(FAR struct netdev_lowerhalf_s *dev,
+                                 int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  int vq_id = VIRTIO_NET_TXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR struct virtio_net_llhdr_s *hdr;
 
   while (1)
     {
       /* Get buffer from tx virtqueue */
 
-      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
+      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL, &priv->lock[vq_id]);
       if (hdr == NULL)
         {
           break;
@@ -347,6 +422,21 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
     }
 }
 
+/****************************************************************************
+ * Name: virtio_net_txfree
+ ****************************************************************************/
+
+static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
+{
+  FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
+
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtio_net_txreclaim(dev, i);
+    }
+}
+
 /****************************************************************************
  * Name: virtio_net_ifup
  ****************************************************************************/
@@ -354,6 +444,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -370,9 +461,12 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (i = 0; i < priv->npairs; i++)
+    {
+      virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RXQ(i)].vq,
+                               &priv->lock[VIRTIO_NET_RXQ(i)]);
+      virtio_net_rxfill(dev, i);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -395,7 +489,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < 2 * priv->npairs; i++)
     {
       virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
                                 &priv->lock[i]);
@@ -415,84 +509,178 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 }
 
 /****************************************************************************
- * Name: virtio_net_send
+ * Name: virtio_net_transmit_batch
  ****************************************************************************/
 
-static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
-                           FAR netpkt_t *pkt)
+static int virtio_net_transmit_batch(FAR struct netdev_lowerhalf_s *dev,
+                                     int queue, FAR netpkt_t **pkts,
+                                     int npkts)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
-
-  /* Check the send length */
+  int vq_id = VIRTIO_NET_TXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
+  int ret = OK;
+  int i;
 
-  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE)
+  for (i = 0; i < npkts; i++)
     {
-      vrterr("net send buffer too large\n");
-      return -EINVAL;
+      /* Check the send length */
+
+      if (netpkt_getdatalen(dev, pkts[i]) > VIRTIO_NET_BUFSIZE)
+        {
+          vrterr("net send buffer too large\n");
+          ret = -EINVAL;
+          break;
+        }
+
+      /* Add buffer to vq */
+
+      ret = virtio_net_addbuffer(dev, vq, pkts[i], vq_id);
+      if (ret < 0)
+        {
+          break;
+        }
     }
 
-  /* Add buffer to vq and notify the other side */
+  /* Notify the other side once for the whole batch */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  if (i > 0)
+    {
+      virtqueue_kick_lock(vq, &priv->lock[vq_id]);
+    }
 
   /* Try return Netpkt TX buffer to upper-half. */
 
-  virtio_net_txfree(dev);
+  virtio_net_txreclaim(dev, queue);
 
   /* If we have no buffer left, enable TX done callback. */
 
   if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      virtqueue_enable_cb_lock(vq, &priv->lock[vq_id]);
     }
 
-  return OK;
+  return i > 0 ? i : ret;
 }
 
 /****************************************************************************
- * Name: virtio_net_recv
+ * Name: virtio_net_send
  ****************************************************************************/
 
-static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt)
+{
+  int ret = virtio_net_transmit_batch(dev, 0, &pkt, 1);
+
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: virtio_net_getpkt
+ ****************************************************************************/
+
+static FAR netpkt_t *virtio_net_getpkt(FAR struct netdev_lowerhalf_s *dev,
+                                       int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  int vq_id = VIRTIO_NET_RXQ(queue);
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[vq_id].vq;
   FAR struct virtio_net_llhdr_s *hdr;
   irqstate_t flags;
   uint32_t len;
 
-  /* Fill the free Netpkt RX buffer to the RX virtqueue */
-
-  virtio_net_rxfill(dev);
-
   /* Get received buffer form RX virtqueue */
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
-  hdr = virtqueue_get_buffer(vq, &len, NULL);
-  if (hdr == NULL)
+  flags = spin_lock_irqsave(&priv->lock[vq_id]);
+  for (; ; )
     {
-      /* If we have no buffer left, enable RX callback. */
+      hdr = virtqueue_get_buffer(vq, &len, NULL);
+      if (hdr != NULL)
+        {
+          break;
+        }
 
-      virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      /* If we have no buffer left, enable RX callback.  A buffer used
+       * before the callback is enabled raises no notification (with
+       * VIRTIO_RING_F_EVENT_IDX), so take it here instead.
+       */
 
-      vrtinfo("get NULL buffer\n");
-      return NULL;
+      if (virtqueue_enable_cb(vq) == 0)
+        {
+          break;
+        }
+
+      virtqueue_disable_cb(vq);
     }
-  else
+
+  spin_unlock_irqrestore(&priv->lock[vq_id], flags);
+
+  if (hdr == NULL)
     {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      vrtinfo("get NULL buffer\n");
+      return NULL;
     }
 
+  priv->rxposted[queue]--;
+
   /* Set the received pkt length */
 
   netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* A packet still needing its checksum comes from another guest on the
+   * same host and was never on the wire, so both are taken as valid.
+   */
+
+  if ((hdr->vhdr.flags & (VIRTIO_NET_HDR_F_NEEDS_CSUM |
+                          VIRTIO_NET_HDR_F_DATA_VALID)) != 0)
+    {
+      netpkt_offload(hdr->pkt)->flags |= NETPKT_RX_CSUM_OK;
+    }
+#endif
+
   vrtinfo("Recv, hdr=%p, pkt=%p, len=%" PRIu32 "\n", hdr, hdr->pkt, len);
   return hdr->pkt;
 }
 
+/****************************************************************************
+ * Name: virtio_net_recv
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  /* Fill the free Netpkt RX buffer to the RX virtqueue */
+
+  virtio_net_rxfill(dev, 0);
+  return virtio_net_getpkt(dev, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_receive_batch
+ ****************************************************************************/
+
+static int virtio_net_receive_batch(FAR struct netdev_lowerhalf_s *dev,
+                                    int queue, FAR netpkt_t **pkts,
+                                    int npkts)
+{
+  int i;
+
+  /* Fill the free Netpkt RX buffer to the RX virtqueue */
+
+  virtio_net_rxfill(dev, queue);
+
+  for (i = 0; i < npkts; i++)
+    {
+      pkts[i] = virtio_net_getpkt(dev, queue);
+      if (pkts[i] == NULL)
+        {
+          break;
+        }
+    }
+
+  return i;
+}
+
 #ifdef CONFIG_NET_MCASTGROUP
 /****************************************************************************
  * Name: virtio_net_addmac
@@ -535,8 +723,9 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
-  netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+  netdev_lower_rxready_queue((FAR struct netdev_lowerhalf_s *)priv,
+                             vq->vq_queue_index / 2);
 }
 
 /****************************************************************************
@@ -547,10 +736,72 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+/****************************************************************************
+ * Name: virtio_net_set_pairs
+ *
+ * Description:
+ *   Tell the device how many queue pairs are used through the control
+ *   virtqueue.  Only called at probe time, so poll for the status.
+ *
+ ****************************************************************************/
+
+static int virtio_net_set_pairs(FAR struct virtio_net_priv_s *priv,
+                                int ctrl)
+{
+  FAR struct virtqueue *vq = priv->vdev->vrings_info[ctrl].vq;
+  FAR struct virtio_net_ctrl_mq_s *mq;
+  struct virtqueue_buf vb[3];
+  int ret;
+  int i;
+
+  mq = virtio_zalloc_buf(priv->vdev, sizeof(*mq), 16);
+  if (mq == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mq->cls             = VIRTIO_NET_CTRL_MQ;
+  mq->cmd             = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  mq->virtqueue_pairs = priv->npairs;
+  mq->ack             = UINT8_MAX;
+
+  vb[0].buf = &mq->cls;
+  vb[0].len = 2;
+  vb[1].buf = &mq->virtqueue_pairs;
+  vb[1].len = sizeof(mq->virtqueue_pairs);
+  vb[2].buf = &mq->ack;
+  vb[2].len = sizeof(mq->ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 2, 1, mq);
+  if (ret < 0)
+    {
+      virtio_free_buf(priv->vdev, mq);
+      return ret;
+    }
+
+  virtqueue_kick(vq);
+
+  for (i = 0; i < VIRTIO_NET_CTRL_POLLS; i++)
+    {
+      if (virtqueue_get_buffer(vq, NULL, NULL) != NULL)
+        {
+          ret = mq->ack == VIRTIO_NET_CTRL_OK ? OK : -EIO;
+          virtio_free_buf(priv->vdev, mq);
+          return ret;
+        }
+
+      up_udelay(10);
+    }
+
+  /* The device still owns the buffer, leave it alone */
+
+  return -ETIMEDOUT;
+}
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -558,28 +809,90 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char **vqnames;
+  FAR vq_callback *callbacks;
+  uint16_t maxpairs = 1;
+  int nvqs = 2;
   int ret;
+  int i;
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
-  priv->vdev = vdev;
-  vdev->priv = priv;
+  for (i = 0; i < VIRTIO_NET_NUM; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+    }
+
+  priv->vdev   = vdev;
+  priv->npairs = 1;
+  vdev->priv   = priv;
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
+#ifdef CONFIG_NETDEV_OFFLOAD
+                                  (1UL << VIRTIO_NET_F_CSUM) |
+                                  (1UL << VIRTIO_NET_F_GUEST_CSUM) |
+#endif
+#if CONFIG_DRIVERS_VIRTIO_NET_QUEUE_PAIRS > 1
+                                  (1UL << VIRTIO_NET_F_CTRL_VQ) |
+                                  (1UL << VIRTIO_NET_F_MQ) |
+#endif
+                                  VIRTIO_RING_F_EVENT_IDX |
                                   (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+  /* The control virtqueue comes after all the queue pairs of the device,
+   * so the pairs not used are created too but never filled.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_MQ))
+    {
+      virtio_read_config(vdev,
+                         offsetof(struct virtio_net_config_s,
+                                  max_virtqueue_pairs),
+                         &maxpairs, sizeof(maxpairs));
+      if (maxpairs > 1)
+        {
+          priv->npairs = MIN(maxpairs,
+                             CONFIG_DRIVERS_VIRTIO_NET_QUEUE_PAIRS);
+          nvqs         = 2 * maxpairs + 1;
+        }
+    }
+
+  vqnames = kmm_zalloc(nvqs * (sizeof(*vqnames) + sizeof(*callbacks)));
+  if (vqnames == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  callbacks = (FAR vq_callback *)(vqnames + nvqs);
+  for (i = 0; i < nvqs; i++)
+    {
+      if (i == 2 * maxpairs)
+        {
+          vqnames[i] = "virtio_net_ctrl";
+        }
+      else if (VIRTIO_NET_IS_RXQ(i))
+        {
+          vqnames[i] = "virtio_net_rx";
+          if (i / 2 < priv->npairs)
+            {
+              callbacks[i] = virtio_net_rxready;
+            }
+        }
+      else
+        {
+          vqnames[i] = "virtio_net_tx";
+          if (i / 2 < priv->npairs)
+            {
+              callbacks[i] = virtio_net_txdone;
+            }
+        }
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks, NULL);
+  kmm_free(vqnames);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -588,6 +901,16 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+  if (priv->npairs > 1)
+    {
+      ret = virtio_net_set_pairs(priv, 2 * maxpairs);
+      if (ret < 0)
+        {
+          vrtwarn("Set %d queue pairs failed, ret=%d\n", priv->npairs, ret);
+          priv->npairs = 1;
+        }
+    }
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
@@ -597,10 +920,17 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   priv->bufnum = CONFIG_IOB_NBUFFERS / VIRTIO_NET_MAX_NIOB / 4;
 #endif
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_RX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
-  priv->bufnum = MIN(vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
-                     (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+  for (i = 0; i < 2 * priv->npairs; i++)
+    {
+      priv->bufnum = MIN(vdev->vrings_info[i].info.num_descs /
+                         (VIRTIO_NET_MAX_NIOB + 1), priv->bufnum);
+    }
+
+  /* The RX buffers are shared by the RX queues, TX buffers go to the
+   * queue of the sending CPU.
+   */
+
+  priv->rxnum = MAX(priv->bufnum / priv->npairs, 1);
   return OK;
 }
 
@@ -668,10 +998,23 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   /* Initialize the netdev lower half */
 
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
-  netdev->quota[NETPKT_RX] = priv->bufnum;
+  netdev->quota[NETPKT_RX] = priv->rxnum * priv->npairs;
   netdev->quota[NETPKT_TX] = priv->bufnum;
+  netdev->nqueues = priv->npairs;
   netdev->ops = &g_virtio_net_ops;
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CSUM))
+    {
+      netdev->features |= NETDEV_FEATURE_TXCSUM;
+    }
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_GUEST_CSUM))
+    {
+      netdev->features |= NETDEV_FEATURE_RXCSUM;
+    }
+#endif
+
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
    * no more WiFi interfaces will be created.
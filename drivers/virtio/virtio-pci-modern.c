@@ -345,7 +345,7 @@ virtio_pci_modern_create_virtqueue(FAR struct virtio_pci_device_s *vpdev,
 
 #if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
   pci_write_io_word(vpdev->dev, (uintptr_t)&cfg->queue_msix_vector,
-                    VIRTIO_PCI_INT_VQ);
+                    VIRTIO_PCI_QUEUE_VECTOR(vpdev, vq->vq_queue_index));
   pci_read_io_word(vpdev->dev, (uintptr_t)&cfg->queue_msix_vector,
                    &msix_vector);
   if (msix_vector == VIRTIO_PCI_MSI_NO_VECTOR)
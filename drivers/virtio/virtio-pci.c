@@ -88,9 +88,15 @@ static const struct virtio_memory_ops g_virtio_pci_mmops =
 
 /****************************************************************************
  * Name: virtio_pci_vq_callback
+ *
+ * Description:
+ *   Handle the virtqueues of the vector, or all of them if vector is
+ *   negative.
+ *
  ****************************************************************************/
 
-static void virtio_pci_vq_callback(FAR struct virtio_pci_device_s *vpdev)
+static void virtio_pci_vq_callback(FAR struct virtio_pci_device_s *vpdev,
+                                   int vector)
 {
   FAR struct virtio_vring_info *vrings_info = vpdev->vdev.vrings_info;
   FAR struct virtqueue *vq;
@@ -98,6 +104,13 @@ static void virtio_pci_vq_callback(FAR struct virtio_pci_device_s *vpdev)
 
   for (i = 0; i < vpdev->vdev.vrings_num; i++)
     {
+#if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
+      if (vector >= 0 && VIRTIO_PCI_QUEUE_VECTOR(vpdev, i) != vector)
+        {
+          continue;
+        }
+#endif
+
       vq = vrings_info[i].vq;
       if (vq->vq_used_cons_idx != vq->vq_ring.used->idx &&
           vq->callback != NULL)
@@ -115,8 +128,17 @@ static void virtio_pci_vq_callback(FAR struct virtio_pci_device_s *vpdev)
 static int virtio_pci_interrupt(int irq, FAR void *context, FAR void *arg)
 {
   FAR struct virtio_pci_device_s *vpdev = arg;
+  int vector;
+
+  for (vector = VIRTIO_PCI_INT_VQ; vector < vpdev->nirq - 1; vector++)
+    {
+      if (vpdev->irq[vector] == irq)
+        {
+          break;
+        }
+    }
 
-  virtio_pci_vq_callback(vpdev);
+  virtio_pci_vq_callback(vpdev, vector);
   return OK;
 }
 
@@ -142,7 +164,7 @@ static void virtio_pci_wdog(wdparm_t arg)
   FAR struct virtio_pci_device_s *vpdev =
     (FAR struct virtio_pci_device_s *)arg;
 
-  virtio_pci_vq_callback(vpdev);
+  virtio_pci_vq_callback(vpdev, -1);
   wd_start(&vpdev->wdog, VIRTIO_PCI_WORK_DELAY, virtio_pci_wdog,
            (wdparm_t)vpdev);
 }
@@ -176,6 +198,10 @@ static int virtio_pci_probe(FAR struct pci_device_s *dev)
 {
   FAR struct virtio_pci_device_s *vpdev;
   FAR struct virtio_device *vdev;
+#if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
+  int nirq = VIRTIO_PCI_INT_VQ + 1;
+  int i;
+#endif
   int ret;
 
   /* We only own devices >= 0x1000 and <= 0x107f: leave the rest. */
@@ -224,29 +250,55 @@ static int virtio_pci_probe(FAR struct pci_device_s *dev)
 
 #if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
 
-  /* Irq init */
+  /* Irq init, the virtqueues may have vectors of their own with MSI-X */
+
+#ifdef CONFIG_PCI_MSIX
+  if (pci_find_capability(dev, PCI_CAP_ID_MSIX) != 0)
+    {
+      nirq = VIRTIO_PCI_INT_NUM;
+    }
+#endif
 
-  ret = pci_alloc_irq(vpdev->dev, vpdev->irq, VIRTIO_PCI_INT_NUM);
-  if (ret != VIRTIO_PCI_INT_NUM)
+  ret = pci_alloc_irq(vpdev->dev, vpdev->irq, nirq);
+  if (ret <= VIRTIO_PCI_INT_VQ)
     {
       vrterr("Failed to allocate MSI, ret=%d\n", ret);
       goto err_with_enable;
     }
 
-  vrtinfo("Interrupt mode: attaching MSI %d to %p, %d to %p\n",
+  vpdev->nirq = ret;
+
+  vrtinfo("Interrupt mode: attaching MSI %d to %p, %d-%d to %p\n",
           vpdev->irq[VIRTIO_PCI_INT_CFG], virtio_pci_config_changed,
-          vpdev->irq[VIRTIO_PCI_INT_VQ], virtio_pci_interrupt);
+          vpdev->irq[VIRTIO_PCI_INT_VQ], vpdev->irq[vpdev->nirq - 1],
+          virtio_pci_interrupt);
 
-  ret = pci_connect_irq(vpdev->dev, vpdev->irq, VIRTIO_PCI_INT_NUM);
+  ret = pci_connect_irq(vpdev->dev, vpdev->irq, vpdev->nirq);
   if (ret < 0)
     {
       vrterr("Failed to connect MSI %d\n", ret);
       goto err_with_irq;
     }
 
+#ifdef CONFIG_PCI_IRQ_AFFINITY
+  /* Spread the vectors of the virtqueues over the CPUs */
+
+  for (i = VIRTIO_PCI_INT_VQ + 1; i < vpdev->nirq; i++)
+    {
+      cpu_set_t cpuset;
+
+      CPU_ZERO(&cpuset);
+      CPU_SET((i - VIRTIO_PCI_INT_VQ) % CONFIG_SMP_NCPUS, &cpuset);
+      pci_affinity_irq(dev, vpdev->irq, vpdev->nirq, i, cpuset);
+    }
+#endif
+
   irq_attach(vpdev->irq[VIRTIO_PCI_INT_CFG],
              virtio_pci_config_changed, vpdev);
-  irq_attach(vpdev->irq[VIRTIO_PCI_INT_VQ], virtio_pci_interrupt, vpdev);
+  for (i = VIRTIO_PCI_INT_VQ; i < vpdev->nirq; i++)
+    {
+      irq_attach(vpdev->irq[i], virtio_pci_interrupt, vpdev);
+    }
 #else
   vrtinfo("Polling mode\n");
 #endif
@@ -265,10 +317,13 @@ static int virtio_pci_probe(FAR struct pci_device_s *dev)
 
 err_with_attach:
 #if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
-  irq_detach(vpdev->irq[VIRTIO_PCI_INT_CFG]);
-  irq_detach(vpdev->irq[VIRTIO_PCI_INT_VQ]);
+  for (i = 0; i < vpdev->nirq; i++)
+    {
+      irq_detach(vpdev->irq[i]);
+    }
+
 err_with_irq:
-  pci_release_irq(vpdev->dev, vpdev->irq, VIRTIO_PCI_INT_NUM);
+  pci_release_irq(vpdev->dev, vpdev->irq, vpdev->nirq);
 #endif
 err_with_enable:
   pci_clear_master(dev);
@@ -285,13 +340,19 @@ err:
 static void virtio_pci_remove(FAR struct pci_device_s *dev)
 {
   FAR struct virtio_pci_device_s *vpdev = dev->priv;
+#if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
+  int i;
+#endif
 
   virtio_unregister_device(&vpdev->vdev);
 
 #if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
-  irq_detach(vpdev->irq[VIRTIO_PCI_INT_CFG]);
-  irq_detach(vpdev->irq[VIRTIO_PCI_INT_VQ]);
-  pci_release_irq(vpdev->dev, vpdev->irq, VIRTIO_PCI_INT_NUM);
+  for (i = 0; i < vpdev->nirq; i++)
+    {
+      irq_detach(vpdev->irq[i]);
+    }
+
+  pci_release_irq(vpdev->dev, vpdev->irq, vpdev->nirq);
 #endif
 
   pci_clear_master(dev);
@@ -414,8 +475,10 @@ int virtio_pci_create_virtqueues(FAR struct virtio_device *vdev,
       goto err;
     }
 
-  up_enable_irq(vpdev->irq[VIRTIO_PCI_INT_CFG]);
-  up_enable_irq(vpdev->irq[VIRTIO_PCI_INT_VQ]);
+  for (i = 0; i < vpdev->nirq; i++)
+    {
+      up_enable_irq(vpdev->irq[i]);
+    }
 #else
   ret = wd_start(&vpdev->wdog, VIRTIO_PCI_WORK_DELAY, virtio_pci_wdog,
                 (wdparm_t)vpdev);
@@ -445,8 +508,11 @@ void virtio_pci_delete_virtqueues(FAR struct virtio_device *vdev)
   unsigned int i;
 
 #if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
-  up_disable_irq(vpdev->irq[VIRTIO_PCI_INT_CFG]);
-  up_disable_irq(vpdev->irq[VIRTIO_PCI_INT_VQ]);
+  for (i = 0; i < vpdev->nirq; i++)
+    {
+      up_disable_irq(vpdev->irq[i]);
+    }
+
   vpdev->ops->config_vector(vpdev, false);
 #else
   wd_cancel(&vpdev->wdog);
@@ -46,7 +46,13 @@
 
 #define VIRTIO_PCI_INT_CFG               0
 #define VIRTIO_PCI_INT_VQ                1
-#define VIRTIO_PCI_INT_NUM               2
+#define VIRTIO_PCI_INT_NUM               \
+  (VIRTIO_PCI_INT_VQ + CONFIG_DRIVERS_VIRTIO_PCI_QUEUE_VECTORS)
+
+/* The vector of the virtqueue idx with nirq vectors allocated */
+
+#define VIRTIO_PCI_QUEUE_VECTOR(vpdev, idx) \
+  (VIRTIO_PCI_INT_VQ + (idx) % ((vpdev)->nirq - VIRTIO_PCI_INT_VQ))
 
 /****************************************************************************
  * Public Data
@@ -87,6 +93,7 @@ struct virtio_pci_device_s
                                                */
 #if CONFIG_DRIVERS_VIRTIO_PCI_POLLING_PERIOD <= 0
   int                                irq[VIRTIO_PCI_INT_NUM];
+  int                                nirq;    /* Vectors allocated */
 #else
   struct wdog_s                      wdog;
 #endif
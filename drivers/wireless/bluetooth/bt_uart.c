@@ -92,12 +92,26 @@ static ssize_t btuart_read(FAR struct btuart_upperhalf_s *upper,
   return ntotal;
 }
 
-static void btuart_rxwork(FAR void *arg)
+/****************************************************************************
+ * Name: btuart_rxparse
+ *
+ * Description:
+ *   Pass the complete H4 packets at the start of the buffer to the stack
+ *   and return the number of bytes used.  The packets are passed in place
+ *   and the rest is moved once by the caller.  A byte that does not start
+ *   an H4 packet and a packet that can never fit in the buffer are
+ *   dropped, so that the stream can get back in sync.
+ *
+ ****************************************************************************/
+
+static size_t btuart_rxparse(FAR struct btuart_upperhalf_s *upper)
 {
-  FAR struct btuart_upperhalf_s *upper;
+  FAR uint8_t *pkt;
   enum bt_buf_type_e type;
   unsigned int pktlen;
-  ssize_t nread;
+  size_t hdrlen;
+  size_t offset = 0;
+  size_t avail;
   union
     {
       struct bt_hci_evt_hdr_s evt;
@@ -107,84 +121,120 @@ static void btuart_rxwork(FAR void *arg)
 
   *hdr;
 
-  upper = (FAR struct btuart_upperhalf_s *)arg;
-
-  nread = btuart_read(upper, &upper->rxbuf[upper->rxlen],
-                      sizeof(upper->rxbuf) - upper->rxlen);
-  if (nread <= 0)
+  while (offset < upper->rxlen)
     {
-      wlerr("ERROR: btuart_read failed: %zd\n", nread);
-      return;
-    }
+      pkt   = &upper->rxbuf[offset];
+      avail = upper->rxlen - offset;
+      hdr   = (FAR void *)&pkt[H4_HEADER_SIZE];
 
-  upper->rxlen += (uint16_t)nread;
+      switch (pkt[0])
+        {
+        case H4_EVT:
+          hdrlen = sizeof(struct bt_hci_evt_hdr_s);
+          break;
 
-  while (upper->rxlen)
-    {
-      hdr = (FAR void *)&upper->rxbuf[H4_HEADER_SIZE];
+        case H4_ACL:
+          hdrlen = sizeof(struct bt_hci_acl_hdr_s);
+          break;
 
-      switch (upper->rxbuf[0])
+        case H4_ISO:
+          hdrlen = sizeof(struct bt_hci_iso_hdr_s);
+          break;
+
+        default:
+          wlerr("ERROR: Unknown H4 type %u\n", pkt[0]);
+          offset++;
+          continue;
+        }
+
+      if (avail < H4_HEADER_SIZE + hdrlen)
         {
-        case H4_EVT:
-          if (upper->rxlen < H4_HEADER_SIZE +
-              sizeof(struct bt_hci_evt_hdr_s))
-            {
-              wlwarn("WARNING: Incomplete HCI event header\n");
-              return;
-            }
+          wlinfo("Incomplete HCI header\n");
+          break;
+        }
 
+      switch (pkt[0])
+        {
+        case H4_EVT:
           type = BT_EVT;
-          pktlen = H4_HEADER_SIZE +
-                   sizeof(struct bt_hci_evt_hdr_s) + hdr->evt.len;
+          pktlen = hdr->evt.len;
           break;
 
         case H4_ACL:
-          if (upper->rxlen < H4_HEADER_SIZE +
-              sizeof(struct bt_hci_acl_hdr_s))
-            {
-              wlwarn("WARNING: Incomplete HCI ACL header\n");
-              return;
-            }
-
           type = BT_ACL_IN;
-          pktlen = H4_HEADER_SIZE +
-                   sizeof(struct bt_hci_acl_hdr_s) + hdr->acl.len;
+          pktlen = BT_LE162HOST(hdr->acl.len);
           break;
 
-        case H4_ISO:
-          if (upper->rxlen < H4_HEADER_SIZE +
-              sizeof(struct bt_hci_iso_hdr_s))
-            {
-              wlwarn("WARNING: Incomplete HCI ISO header\n");
-              return;
-            }
-
+        default:
           type = BT_ISO_IN;
-          pktlen = H4_HEADER_SIZE +
-                   sizeof(struct bt_hci_iso_hdr_s) + hdr->iso.len;
+          pktlen = BT_LE162HOST(hdr->iso.len);
           break;
+        }
 
-        default:
-          wlerr("ERROR: Unknown H4 type %u\n", upper->rxbuf[0]);
-          return;
+      pktlen += H4_HEADER_SIZE + hdrlen;
+      if (pktlen > sizeof(upper->rxbuf))
+        {
+          wlerr("ERROR: Packet too large: %u\n", pktlen);
+          offset++;
+          continue;
         }
 
-      if (upper->rxlen < pktlen)
+      if (avail < pktlen)
         {
-          wlwarn("WARNING: Incomplete packet: rxlen=%u, pktlen=%u\n",
-                 upper->rxlen, pktlen);
-          return;
+          wlinfo("Incomplete packet: avail=%zu, pktlen=%u\n",
+                 avail, pktlen);
+          break;
         }
 
       /* Pass buffer to the stack */
 
-      BT_DUMP("Received", upper->rxbuf, pktlen);
-      bt_netdev_receive(&upper->dev, type, &upper->rxbuf[H4_HEADER_SIZE],
+      BT_DUMP("Received", pkt, pktlen);
+      bt_netdev_receive(&upper->dev, type, &pkt[H4_HEADER_SIZE],
                         pktlen - H4_HEADER_SIZE);
 
-      upper->rxlen -= pktlen;
-      memmove(upper->rxbuf, upper->rxbuf + pktlen, upper->rxlen);
+      offset += pktlen;
+    }
+
+  return offset;
+}
+
+static void btuart_rxwork(FAR void *arg)
+{
+  FAR struct btuart_upperhalf_s *upper;
+  size_t space;
+  size_t used;
+  ssize_t nread;
+
+  upper = (FAR struct btuart_upperhalf_s *)arg;
+
+  /* Read until the lower half has no more data, the packets of each read
+   * are passed to the stack before the next one.
+   */
+
+  do
+    {
+      space = sizeof(upper->rxbuf) - upper->rxlen;
+      nread = btuart_read(upper, &upper->rxbuf[upper->rxlen], space);
+      if (nread <= 0)
+        {
+          if (nread < 0)
+            {
+              wlerr("ERROR: btuart_read failed: %zd\n", nread);
+            }
+
+          return;
+        }
+
+      upper->rxlen += (uint16_t)nread;
+
+      used = btuart_rxparse(upper);
+      if (used > 0)
+        {
+          upper->rxlen -= used;
+          memmove(upper->rxbuf, upper->rxbuf + used, upper->rxlen);
+        }
     }
+  while ((size_t)nread == space);
 }
 
 static void btuart_rxcallback(FAR const struct btuart_lowerhalf_s *lower,
@@ -0,0 +1,984 @@
+/****************************************************************************
+ * fs/aio/aio_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioring.h>
+#include <sys/param.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/mm/map.h>
+#ifdef CONFIG_NET
+#  include <nuttx/net/net.h>
+#endif
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_IORING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IORING_ALIGN(n)  (((n) + sizeof(uint64_t) - 1) & \
+                          ~(sizeof(uint64_t) - 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct ioring_s;
+
+/* One submitted operation.  There is one per completion queue entry, so
+ * a completion always finds room in the completion queue.
+ */
+
+struct ioring_req_s
+{
+  sq_entry_t               rq_node;   /* Free or ready list */
+  FAR struct ioring_req_s *rq_link;   /* Next operation of a linked chain */
+  FAR struct ioring_s     *rq_ring;   /* The ring of the operation */
+  FAR struct file         *rq_filep;  /* The file, with a reference */
+  struct ioring_sqe        rq_sqe;    /* Copy of the submission */
+  struct pollfd            rq_pfd;    /* Waits for the file to be ready */
+  pollevent_t              rq_events; /* The events to wait for, or 0 */
+  bool                     rq_armed;  /* The poll callback may queue it */
+  bool                     rq_polled; /* rq_pfd is set up */
+};
+
+struct ioring_s
+{
+  mutex_t                  lock;      /* Serializes submissions and
+                                       * completions */
+  spinlock_t               spinlock;  /* Protects readyq and rq_armed */
+  sem_t                    waitsem;   /* Wakes up ioring_enter() */
+  struct work_s            work;      /* Runs the ready operations */
+  FAR struct ioring_rings *rings;     /* Shared with the application */
+  FAR struct ioring_sqe   *sqes;
+  FAR struct ioring_cqe   *cqes;
+  size_t                   size;      /* Size of the shared memory */
+  uint32_t                 sqmask;    /* Kernel copies of the geometry */
+  uint32_t                 cqmask;
+  uint32_t                 sqhead;    /* Kernel copy of sq.head */
+  uint32_t                 cqtail;    /* Kernel copy of cq.tail */
+  uint32_t                 inflight;  /* Submitted, not yet completed */
+  uint16_t                 nwaiters;  /* Threads in ioring_enter() */
+  bool                     closing;
+  sq_queue_t               freeq;     /* Unused requests */
+  sq_queue_t               readyq;    /* Requests to run on the worker */
+  FAR struct pollfd       *fds[CONFIG_FS_IORING_NPOLLWAITERS];
+  FAR struct ioring_req_s *reqs;      /* cqmask + 1 requests */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int ioring_file_close(FAR struct file *filep);
+static int ioring_file_mmap(FAR struct file *filep,
+                            FAR struct mm_map_entry_s *map);
+static int ioring_file_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                            bool setup);
+
+static void ioring_worker(FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_ioring_fops =
+{
+  NULL,              /* open */
+  ioring_file_close, /* close */
+  NULL,              /* read */
+  NULL,              /* write */
+  NULL,              /* seek */
+  NULL,              /* ioctl */
+  ioring_file_mmap,  /* mmap */
+  NULL,              /* truncate */
+  ioring_file_poll   /* poll */
+};
+
+static struct inode g_ioring_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_DRIVER, /* i_flags */
+  {
+    &g_ioring_fops        /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_cqcount
+ *
+ * Description:
+ *   Return the number of completions not yet consumed by the application.
+ *
+ ****************************************************************************/
+
+static uint32_t ioring_cqcount(FAR struct ioring_s *ring)
+{
+  FAR atomic_t *head = (FAR atomic_t *)&ring->rings->cq.head;
+
+  return ring->cqtail - (uint32_t)atomic_read_acquire(head);
+}
+
+/****************************************************************************
+ * Name: ioring_notify
+ *
+ * Description:
+ *   Wake up the threads waiting for completions.  Called with the ring lock
+ *   held.
+ *
+ ****************************************************************************/
+
+static void ioring_notify(FAR struct ioring_s *ring)
+{
+  while (ring->nwaiters > 0)
+    {
+      ring->nwaiters--;
+      nxsem_post(&ring->waitsem);
+    }
+
+  poll_notify(ring->fds, CONFIG_FS_IORING_NPOLLWAITERS, POLLIN);
+}
+
+/****************************************************************************
+ * Name: ioring_post
+ *
+ * Description:
+ *   Publish one completion and release its request.  Called with the ring
+ *   lock held.
+ *
+ ****************************************************************************/
+
+static void ioring_post(FAR struct ioring_s *ring,
+                        FAR struct ioring_req_s *req, int res)
+{
+  FAR struct ioring_cqe *cqe = &ring->cqes[ring->cqtail & ring->cqmask];
+
+  cqe->user_data = req->rq_sqe.user_data;
+  cqe->res       = res;
+  cqe->flags     = 0;
+  atomic_set_release((FAR atomic_t *)&ring->rings->cq.tail,
+                     ++ring->cqtail);
+
+  if (req->rq_filep != NULL)
+    {
+      file_put(req->rq_filep);
+      req->rq_filep = NULL;
+    }
+
+  ring->inflight--;
+  sq_addlast(&req->rq_node, &ring->freeq);
+}
+
+/****************************************************************************
+ * Name: ioring_ready
+ *
+ * Description:
+ *   Queue the requests of a list for the worker.
+ *
+ ****************************************************************************/
+
+static void ioring_ready(FAR struct ioring_s *ring, FAR sq_queue_t *list)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  sq_cat(list, &ring->readyq);
+  if (!ring->closing)
+    {
+      work_queue(LPWORK, &ring->work, ioring_worker, ring, 0);
+    }
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+}
+
+/****************************************************************************
+ * Name: ioring_complete
+ *
+ * Description:
+ *   Complete a request that ran on the worker and start the next one of
+ *   its chain, or cancel the rest of the chain if this one failed.
+ *
+ ****************************************************************************/
+
+static void ioring_complete(FAR struct ioring_s *ring,
+                            FAR struct ioring_req_s *req, int res)
+{
+  FAR struct ioring_req_s *link = req->rq_link;
+  FAR struct ioring_req_s *next;
+  sq_queue_t list;
+
+  nxmutex_lock(&ring->lock);
+
+  ioring_post(ring, req, res);
+  while (res < 0 && link != NULL)
+    {
+      next = link->rq_link;
+      ioring_post(ring, link, -ECANCELED);
+      link = next;
+    }
+
+  ioring_notify(ring);
+  nxmutex_unlock(&ring->lock);
+
+  if (link != NULL)
+    {
+      sq_init(&list);
+      sq_addlast(&link->rq_node, &list);
+      ioring_ready(ring, &list);
+    }
+}
+
+/****************************************************************************
+ * Name: ioring_pollcb
+ *
+ * Description:
+ *   The file of a request became ready.  This may be called from the
+ *   interrupt handler of the driver.
+ *
+ ****************************************************************************/
+
+static void ioring_pollcb(FAR struct pollfd *fds)
+{
+  FAR struct ioring_req_s *req = fds->arg;
+  FAR struct ioring_s *ring = req->rq_ring;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  if (req->rq_armed)
+    {
+      req->rq_armed = false;
+      sq_addlast(&req->rq_node, &ring->readyq);
+      if (!ring->closing)
+        {
+          work_queue(LPWORK, &ring->work, ioring_worker, ring, 0);
+        }
+    }
+
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+}
+
+/****************************************************************************
+ * Name: ioring_arm
+ *
+ * Description:
+ *   Wait for the file of a request to be ready without blocking the
+ *   worker.  The request is queued again by ioring_pollcb(), possibly
+ *   before this function returns.
+ *
+ ****************************************************************************/
+
+static int ioring_arm(FAR struct ioring_s *ring,
+                      FAR struct ioring_req_s *req)
+{
+  irqstate_t flags;
+  bool queued;
+  int ret;
+
+  memset(&req->rq_pfd, 0, sizeof(req->rq_pfd));
+  req->rq_pfd.fd     = req->rq_sqe.fd;
+  req->rq_pfd.events = req->rq_events;
+  req->rq_pfd.arg    = req;
+  req->rq_pfd.cb     = ioring_pollcb;
+
+  req->rq_polled = true;
+  flags = spin_lock_irqsave(&ring->spinlock);
+  req->rq_armed = true;
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  ret = file_poll(req->rq_filep, &req->rq_pfd, true);
+  if (ret < 0)
+    {
+      flags = spin_lock_irqsave(&ring->spinlock);
+      queued = !req->rq_armed;
+      req->rq_armed = false;
+      spin_unlock_irqrestore(&ring->spinlock, flags);
+
+      if (!queued)
+        {
+          req->rq_polled = false;
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ioring_perform
+ *
+ * Description:
+ *   Perform the operation of a request.
+ *
+ ****************************************************************************/
+
+static int ioring_perform(FAR struct ioring_req_s *req)
+{
+  FAR struct ioring_sqe *sqe = &req->rq_sqe;
+  FAR struct file *filep = req->rq_filep;
+
+  switch (sqe->opcode)
+    {
+      case IORING_OP_NOP:
+        return 0;
+
+      case IORING_OP_READ:
+        return sqe->off < 0 ?
+               file_read(filep, sqe->addr, sqe->len) :
+               file_pread(filep, sqe->addr, sqe->len, sqe->off);
+
+      case IORING_OP_WRITE:
+        return sqe->off < 0 ?
+               file_write(filep, sqe->addr, sqe->len) :
+               file_pwrite(filep, sqe->addr, sqe->len, sqe->off);
+
+      case IORING_OP_FSYNC:
+        return file_fsync(filep);
+
+      case IORING_OP_POLL:
+        return req->rq_pfd.revents;
+
+#ifdef CONFIG_NET
+      case IORING_OP_SEND:
+      case IORING_OP_RECV:
+        {
+          FAR struct socket *psock = file_socket(filep);
+
+          if (psock == NULL)
+            {
+              return -ENOTSOCK;
+            }
+
+          return sqe->opcode == IORING_OP_SEND ?
+                 psock_send(psock, sqe->addr, sqe->len, sqe->op_flags) :
+                 psock_recv(psock, sqe->addr, sqe->len, sqe->op_flags);
+        }
+#endif
+
+      default:
+        return -EOPNOTSUPP;
+    }
+}
+
+/****************************************************************************
+ * Name: ioring_run
+ *
+ * Description:
+ *   Run a ready request on the worker.  An operation on a file that can
+ *   be polled first waits for the file to be ready, so that it does not
+ *   block the worker for the data of a socket, pipe or character device.
+ *   Regular files and block devices are always ready and their operations
+ *   run to completion here.
+ *
+ ****************************************************************************/
+
+static void ioring_run(FAR struct ioring_s *ring,
+                       FAR struct ioring_req_s *req)
+{
+  int ret;
+
+  if (req->rq_polled)
+    {
+      file_poll(req->rq_filep, &req->rq_pfd, false);
+      req->rq_polled = false;
+    }
+
+  if (ring->closing)
+    {
+      ret = -ECANCELED;
+    }
+  else
+    {
+      if (req->rq_events != 0 && req->rq_pfd.revents == 0)
+        {
+          ret = ioring_arm(ring, req);
+          if (ret >= 0)
+            {
+              return;
+            }
+
+          if (req->rq_sqe.opcode == IORING_OP_POLL)
+            {
+              goto out;
+            }
+
+          /* The file cannot be polled, so the operation may block */
+        }
+
+      ret = ioring_perform(req);
+      if (ret == -EAGAIN && req->rq_events != 0)
+        {
+          /* The file was ready but another reader or writer was faster */
+
+          if (ioring_arm(ring, req) >= 0)
+            {
+              return;
+            }
+        }
+    }
+
+out:
+  ioring_complete(ring, req, ret);
+}
+
+/****************************************************************************
+ * Name: ioring_worker
+ ****************************************************************************/
+
+static void ioring_worker(FAR void *arg)
+{
+  FAR struct ioring_s *ring = arg;
+  FAR struct ioring_req_s *req;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&ring->spinlock);
+      req = (FAR struct ioring_req_s *)sq_remfirst(&ring->readyq);
+      spin_unlock_irqrestore(&ring->spinlock, flags);
+
+      if (req == NULL)
+        {
+          break;
+        }
+
+      ioring_run(ring, req);
+    }
+}
+
+/****************************************************************************
+ * Name: ioring_prepare
+ *
+ * Description:
+ *   Validate a submission and take a reference to its file.  This runs in
+ *   the context of the caller of ioring_enter(), so the file descriptor is
+ *   looked up in its file descriptor list.
+ *
+ ****************************************************************************/
+
+static int ioring_prepare(FAR struct ioring_req_s *req)
+{
+  FAR struct ioring_sqe *sqe = &req->rq_sqe;
+  FAR struct inode *inode;
+  int ret;
+
+  req->rq_link        = NULL;
+  req->rq_filep       = NULL;
+  req->rq_events      = 0;
+  req->rq_armed       = false;
+  req->rq_polled      = false;
+  req->rq_pfd.revents = 0;
+
+  switch (sqe->opcode)
+    {
+      case IORING_OP_NOP:
+        return OK;
+
+      case IORING_OP_READ:
+      case IORING_OP_RECV:
+        req->rq_events = POLLIN;
+        break;
+
+      case IORING_OP_WRITE:
+      case IORING_OP_SEND:
+        req->rq_events = POLLOUT;
+        break;
+
+      case IORING_OP_POLL:
+        if (sqe->op_flags == 0)
+          {
+            return -EINVAL;
+          }
+
+        req->rq_events = sqe->op_flags;
+        break;
+
+      case IORING_OP_FSYNC:
+        break;
+
+      default:
+        return -EINVAL;
+    }
+
+  ret = file_get(sqe->fd, &req->rq_filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Regular files and block devices are always ready */
+
+  inode = req->rq_filep->f_inode;
+  if (sqe->opcode != IORING_OP_POLL &&
+      (INODE_IS_MOUNTPT(inode) || INODE_IS_BLOCK(inode) ||
+       INODE_IS_MTD(inode)))
+    {
+      req->rq_events = 0;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ioring_submit
+ *
+ * Description:
+ *   Consume up to 'to_submit' entries of the submission queue.  Called
+ *   with the ring lock held.  An entry with IORING_SQE_LINK is chained to
+ *   the next entry of the same call.
+ *
+ ****************************************************************************/
+
+static int ioring_submit(FAR struct ioring_s *ring, unsigned int to_submit)
+{
+  FAR struct ioring_rings *rings = ring->rings;
+  FAR struct ioring_req_s *prev = NULL;
+  FAR struct ioring_req_s *req;
+  bool cancel = false;
+  bool posted = false;
+  sq_queue_t list;
+  uint32_t head;
+  uint32_t tail;
+  unsigned int n;
+  int ret;
+
+  sq_init(&list);
+
+  head = ring->sqhead;
+  tail = (uint32_t)atomic_read_acquire((FAR atomic_t *)&rings->sq.tail);
+
+  for (n = 0; n < to_submit && head != tail; n++, head++)
+    {
+      /* Leave room in the completion queue for every request */
+
+      if (ring->inflight + ioring_cqcount(ring) > ring->cqmask)
+        {
+          break;
+        }
+
+      req = (FAR struct ioring_req_s *)sq_remfirst(&ring->freeq);
+      DEBUGASSERT(req != NULL);
+
+      memcpy(&req->rq_sqe, &ring->sqes[head & ring->sqmask],
+             sizeof(struct ioring_sqe));
+      ring->inflight++;
+
+      ret = cancel ? -ECANCELED : ioring_prepare(req);
+      if (ret < 0)
+        {
+          /* The following entries of the chain are canceled */
+
+          cancel = (req->rq_sqe.flags & IORING_SQE_LINK) != 0;
+          ioring_post(ring, req, ret);
+          posted = true;
+          prev   = NULL;
+          continue;
+        }
+
+      if (prev != NULL)
+        {
+          prev->rq_link = req;
+        }
+      else
+        {
+          sq_addlast(&req->rq_node, &list);
+        }
+
+      prev = (req->rq_sqe.flags & IORING_SQE_LINK) != 0 ? req : NULL;
+    }
+
+  ring->sqhead = head;
+  atomic_set_release((FAR atomic_t *)&rings->sq.head, head);
+
+  if (posted)
+    {
+      ioring_notify(ring);
+    }
+
+  if (!sq_empty(&list))
+    {
+      ioring_ready(ring, &list);
+    }
+
+  if (n == 0 && to_submit > 0 && head != tail)
+    {
+      return -EBUSY;
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: ioring_destroy
+ ****************************************************************************/
+
+static void ioring_destroy(FAR struct ioring_s *ring)
+{
+  FAR struct ioring_req_s *req;
+  irqstate_t flags;
+  uint32_t i;
+
+  flags = spin_lock_irqsave(&ring->spinlock);
+  ring->closing = true;
+  spin_unlock_irqrestore(&ring->spinlock, flags);
+
+  /* Wait for the operation in progress, the worker stops after it */
+
+  work_cancel_sync(LPWORK, &ring->work);
+
+  for (i = 0; i <= ring->cqmask; i++)
+    {
+      req = &ring->reqs[i];
+      if (req->rq_polled)
+        {
+          file_poll(req->rq_filep, &req->rq_pfd, false);
+        }
+
+      if (req->rq_filep != NULL)
+        {
+          file_put(req->rq_filep);
+        }
+    }
+
+  nxsem_destroy(&ring->waitsem);
+  nxmutex_destroy(&ring->lock);
+  kumm_free(ring->rings);
+  fs_heap_free(ring);
+}
+
+/****************************************************************************
+ * Name: ioring_file_close
+ ****************************************************************************/
+
+static int ioring_file_close(FAR struct file *filep)
+{
+  ioring_destroy(filep->f_priv);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ioring_file_mmap
+ ****************************************************************************/
+
+static int ioring_file_mmap(FAR struct file *filep,
+                            FAR struct mm_map_entry_s *map)
+{
+  FAR struct ioring_s *ring = filep->f_priv;
+
+  if (map->offset != 0 || map->length > ring->size)
+    {
+      return -EINVAL;
+    }
+
+  map->vaddr = ring->rings;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ioring_file_poll
+ ****************************************************************************/
+
+static int ioring_file_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                            bool setup)
+{
+  FAR struct ioring_s *ring = filep->f_priv;
+  int ret = OK;
+  int i;
+
+  nxmutex_lock(&ring->lock);
+
+  if (!setup)
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      if (slot != NULL)
+        {
+          *slot = NULL;
+          fds->priv = NULL;
+        }
+
+      goto out;
+    }
+
+  for (i = 0; i < CONFIG_FS_IORING_NPOLLWAITERS; i++)
+    {
+      if (ring->fds[i] == NULL)
+        {
+          ring->fds[i] = fds;
+          fds->priv    = &ring->fds[i];
+          break;
+        }
+    }
+
+  if (i >= CONFIG_FS_IORING_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      ret       = -EBUSY;
+      goto out;
+    }
+
+  if (ioring_cqcount(ring) > 0)
+    {
+      poll_notify(&fds, 1, POLLIN);
+    }
+
+out:
+  nxmutex_unlock(&ring->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ioring_setup
+ *
+ * Description:
+ *   Create a submission and completion ring.  The submission queue has
+ *   'entries' rounded up to a power of two entries and the completion
+ *   queue twice as many.  Both are placed in memory that the caller maps
+ *   with mmap() of the returned file descriptor.
+ *
+ * Input Parameters:
+ *   entries - The minimum number of submission queue entries
+ *   params  - The location to return the geometry of the ring
+ *   flags   - IORING_SETUP_CLOEXEC or zero
+ *
+ * Returned Value:
+ *   The file descriptor of the ring on success; -1 with the errno set on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int ioring_setup(unsigned int entries, FAR struct ioring_params *params,
+                 int flags)
+{
+  FAR struct ioring_s *ring;
+  uint32_t sqentries;
+  uint32_t cqentries;
+  uint32_t sqoff;
+  uint32_t cqoff;
+  uint32_t i;
+  int ret;
+
+  if (entries == 0 || entries > CONFIG_FS_IORING_MAXENTRIES ||
+      params == NULL || (flags & ~IORING_SETUP_CLOEXEC) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  sqentries = 1;
+  while (sqentries < entries)
+    {
+      sqentries <<= 1;
+    }
+
+  cqentries = 2 * sqentries;
+
+  sqoff = IORING_ALIGN(sizeof(struct ioring_rings));
+  cqoff = sqoff + sqentries * sizeof(struct ioring_sqe);
+
+  ring = fs_heap_zalloc(sizeof(struct ioring_s) +
+                        cqentries * sizeof(struct ioring_req_s));
+  if (ring == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ring->size  = cqoff + cqentries * sizeof(struct ioring_cqe);
+  ring->rings = kumm_zalloc(ring->size);
+  if (ring->rings == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_ring;
+    }
+
+  nxmutex_init(&ring->lock);
+  spin_lock_init(&ring->spinlock);
+  nxsem_init(&ring->waitsem, 0, 0);
+
+  ring->sqes   = (FAR struct ioring_sqe *)((FAR char *)ring->rings + sqoff);
+  ring->cqes   = (FAR struct ioring_cqe *)((FAR char *)ring->rings + cqoff);
+  ring->sqmask = sqentries - 1;
+  ring->cqmask = cqentries - 1;
+  ring->reqs   = (FAR struct ioring_req_s *)(ring + 1);
+
+  for (i = 0; i < cqentries; i++)
+    {
+      ring->reqs[i].rq_ring = ring;
+      sq_addlast(&ring->reqs[i].rq_node, &ring->freeq);
+    }
+
+  ring->rings->sq.mask    = sqentries - 1;
+  ring->rings->sq.entries = sqentries;
+  ring->rings->cq.mask    = cqentries - 1;
+  ring->rings->cq.entries = cqentries;
+
+  ret = file_allocate_from_inode(&g_ioring_inode, O_RDWR | flags, 0,
+                                 ring, 0);
+  if (ret < 0)
+    {
+      goto errout_with_rings;
+    }
+
+  params->sq_entries = sqentries;
+  params->cq_entries = cqentries;
+  params->sq_off     = sqoff;
+  params->cq_off     = cqoff;
+  params->size       = ring->size;
+  return ret;
+
+errout_with_rings:
+  nxsem_destroy(&ring->waitsem);
+  nxmutex_destroy(&ring->lock);
+  kumm_free(ring->rings);
+errout_with_ring:
+  fs_heap_free(ring);
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: ioring_enter
+ *
+ * Description:
+ *   Submit the queued entries of a ring and optionally wait for
+ *   completions.  All the entries are submitted by a single call, which
+ *   is what lets a batch of operations cost one system call.
+ *
+ * Input Parameters:
+ *   fd           - The file descriptor returned by ioring_setup()
+ *   to_submit    - The maximum number of entries to submit
+ *   min_complete - With IORING_ENTER_GETEVENTS, the number of unconsumed
+ *                  completions to wait for
+ *   flags        - IORING_ENTER_GETEVENTS or zero
+ *
+ * Returned Value:
+ *   The number of entries submitted on success; -1 with the errno set on
+ *   failure.  EBUSY means that no entry could be submitted because the
+ *   completion queue could overflow.
+ *
+ ****************************************************************************/
+
+int ioring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                 unsigned int flags)
+{
+  FAR struct ioring_s *ring;
+  FAR struct file *filep;
+  int submitted;
+  int ret;
+
+  if ((flags & ~IORING_ENTER_GETEVENTS) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  ret = file_get(fd, &filep);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (filep->f_inode != &g_ioring_inode)
+    {
+      ret = -EINVAL;
+      goto errout_with_filep;
+    }
+
+  ring = filep->f_priv;
+  ret  = nxmutex_lock(&ring->lock);
+  if (ret < 0)
+    {
+      goto errout_with_filep;
+    }
+
+  ret = submitted = ioring_submit(ring, to_submit);
+  if (ret >= 0 && (flags & IORING_ENTER_GETEVENTS) != 0)
+    {
+      min_complete = MIN(min_complete, ring->cqmask + 1);
+      while (ioring_cqcount(ring) < min_complete && ring->inflight > 0)
+        {
+          ring->nwaiters++;
+          nxmutex_unlock(&ring->lock);
+
+          ret = nxsem_wait(&ring->waitsem);
+
+          nxmutex_lock(&ring->lock);
+          if (ret < 0)
+            {
+              /* Report the entries already submitted, if any */
+
+              ret = submitted > 0 ? submitted : ret;
+              break;
+            }
+
+          ret = submitted;
+        }
+    }
+
+  nxmutex_unlock(&ring->lock);
+
+errout_with_filep:
+  file_put(filep);
+  if (ret >= 0)
+    {
+      return ret;
+    }
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+#endif /* CONFIG_FS_IORING */
@@ -55,6 +55,10 @@
 
 #define CROMFS_MAX_LINKS 64
 
+#ifndef CONFIG_FS_CROMFS_CACHE_NBLOCKS
+#  define CONFIG_FS_CROMFS_CACHE_NBLOCKS 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -66,14 +70,27 @@ struct cromfs_dir_s
   uint32_t cr_curroffset;     /* Current offset into the directory contents */
 };
 
+/* One decompressed block of an open file */
+
+struct cromfs_cache_s
+{
+  uint32_t cc_offset;                       /* Cached block offset (zero means none) */
+  uint16_t cc_ulen;                         /* Length of decompressed data in cache */
+  FAR uint8_t *cc_buffer;                   /* Cached, decompressed data */
+};
+
 /* This structure represents an open, regular file */
 
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
-  uint32_t ff_offset;                       /* Cached block offset (zero means none) */
-  uint16_t ff_ulen;                         /* Length of decompressed data in cache */
-  FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+  FAR struct lzf_header_s *ff_blkhdr;       /* Header of the last block read */
+  uint32_t ff_blkoffs;                      /* File offset of that block */
+  FAR uint8_t *ff_buffer;                   /* Memory of all cache buffers */
+
+  /* Decompressed blocks, the most recently used first */
+
+  struct cromfs_cache_s ff_cache[CONFIG_FS_CROMFS_CACHE_NBLOCKS];
 };
 
 /* This is the form of the callback from cromfs_foreach_node(): */
@@ -133,6 +150,16 @@ static int      cromfs_compare_node(FAR const struct cromfs_volume_s *fs,
                                     FAR const struct cromfs_node_s *node,
                                     uint32_t offset,
                                     FAR void *arg);
+static FAR struct cromfs_file_s *
+                cromfs_alloc_file(FAR const struct cromfs_volume_s *fs,
+                                  FAR const struct cromfs_node_s *node);
+static FAR struct cromfs_cache_s *
+                cromfs_find_block(FAR struct cromfs_file_s *ff,
+                                  uint32_t voloffs);
+static FAR struct cromfs_cache_s *
+                cromfs_load_block(FAR const struct cromfs_volume_s *fs,
+                                  FAR struct cromfs_file_s *ff,
+                                  FAR const uint8_t *src, uint16_t clen);
 static int      cromfs_find_node(FAR const struct cromfs_volume_s *fs,
                                  FAR const char *relpath,
                                  FAR struct cromfs_nodeinfo_s *info,
@@ -649,6 +676,111 @@ static int cromfs_compare_node(FAR const struct cromfs_volume_s *fs,
   return 0;  /* Keep looking in this directory */
 }
 
+/****************************************************************************
+ * Name: cromfs_alloc_file
+ *
+ * Description:
+ *   Allocate an open file instance for the node and its decompression
+ *   buffers.
+ *
+ ****************************************************************************/
+
+static FAR struct cromfs_file_s *
+cromfs_alloc_file(FAR const struct cromfs_volume_s *fs,
+                  FAR const struct cromfs_node_s *node)
+{
+  FAR struct cromfs_file_s *ff;
+  int i;
+
+  ff = fs_heap_zalloc(sizeof(struct cromfs_file_s));
+  if (ff == NULL)
+    {
+      return NULL;
+    }
+
+  /* Create the file buffers to support partial block accesses */
+
+  ff->ff_buffer = fs_heap_malloc(CONFIG_FS_CROMFS_CACHE_NBLOCKS *
+                                 fs->cv_bsize);
+  if (ff->ff_buffer == NULL)
+    {
+      fs_heap_free(ff);
+      return NULL;
+    }
+
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      ff->ff_cache[i].cc_buffer = ff->ff_buffer + i * fs->cv_bsize;
+    }
+
+  ff->ff_node = node;
+  return ff;
+}
+
+/****************************************************************************
+ * Name: cromfs_find_block
+ *
+ * Description:
+ *   Return the cache entry holding the block at 'voloffs', making it the
+ *   most recently used one, or NULL if the block is not cached.
+ *
+ ****************************************************************************/
+
+static FAR struct cromfs_cache_s *
+cromfs_find_block(FAR struct cromfs_file_s *ff, uint32_t voloffs)
+{
+  struct cromfs_cache_s entry;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      if (ff->ff_cache[i].cc_offset == voloffs)
+        {
+          entry = ff->ff_cache[i];
+          memmove(&ff->ff_cache[1], &ff->ff_cache[0],
+                  i * sizeof(struct cromfs_cache_s));
+          ff->ff_cache[0] = entry;
+          return &ff->ff_cache[0];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: cromfs_load_block
+ *
+ * Description:
+ *   Return the cache entry holding the compressed block at 'src',
+ *   decompressing it into the least recently used entry if it is not
+ *   cached.
+ *
+ ****************************************************************************/
+
+static FAR struct cromfs_cache_s *
+cromfs_load_block(FAR const struct cromfs_volume_s *fs,
+                  FAR struct cromfs_file_s *ff,
+                  FAR const uint8_t *src, uint16_t clen)
+{
+  FAR struct cromfs_cache_s *cache;
+  uint32_t voloffs;
+
+  voloffs = cromfs_addr2offset(fs, src);
+  cache   = cromfs_find_block(ff, voloffs);
+  if (cache == NULL)
+    {
+      /* Recycle the least recently used entry */
+
+      ff->ff_cache[CONFIG_FS_CROMFS_CACHE_NBLOCKS - 1].cc_offset = voloffs;
+      cache = cromfs_find_block(ff, voloffs);
+
+      cache->cc_ulen = lzf_decompress(src, clen, cache->cc_buffer,
+                                      fs->cv_bsize);
+    }
+
+  return cache;
+}
+
 /****************************************************************************
  * Name: cromfs_find_node
  *
@@ -790,26 +922,13 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
    * file.
    */
 
-  ff = fs_heap_zalloc(sizeof(struct cromfs_file_s));
+  ff = cromfs_alloc_file(fs, (FAR const struct cromfs_node_s *)
+                             cromfs_offset2addr(fs, offset));
   if (ff == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  ff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
-  if (!ff->ff_buffer)
-    {
-      fs_heap_free(ff);
-      return -ENOMEM;
-    }
-
-  /* Save the node in the open file instance */
-
-  ff->ff_node = (FAR const struct cromfs_node_s *)
-    cromfs_offset2addr(fs, offset);
-
   /* Save the index as the open-specific state in filep->f_priv */
 
   filep->f_priv = (FAR void *)ff;
@@ -850,6 +969,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   FAR struct inode *inode;
   FAR const struct cromfs_volume_s *fs;
   FAR struct cromfs_file_s *ff;
+  FAR struct cromfs_cache_s *cache;
   FAR struct lzf_header_s *currhdr;
   FAR struct lzf_header_s *nexthdr;
   FAR uint8_t *dest;
@@ -902,10 +1022,23 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   dest      = (FAR uint8_t *)buffer;
   remaining = buflen;
   fpos      = filep->f_pos;
-  blkoffs   = 0;
   ulen      = 0;
-  nexthdr   = (FAR struct lzf_header_s *)
-               cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+
+  /* Sequential reads resume the search at the last block read instead of
+   * walking the headers from the start of the file again.
+   */
+
+  if (ff->ff_blkhdr != NULL && fpos >= ff->ff_blkoffs)
+    {
+      blkoffs = ff->ff_blkoffs;
+      nexthdr = ff->ff_blkhdr;
+    }
+  else
+    {
+      blkoffs = 0;
+      nexthdr = (FAR struct lzf_header_s *)
+                cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
+    }
 
   /* Look until we find the compressed block containing the start of the
    * requested data.
@@ -954,6 +1087,9 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
         }
       while (fpos >= (blkoffs + ulen));
 
+      ff->ff_blkhdr  = currhdr;
+      ff->ff_blkoffs = blkoffs;
+
       /* Check if we need to decompress the next block into the user
        * buffer.
        */
@@ -1002,25 +1138,24 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
               src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
               voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
+              cache   = cromfs_find_block(ff, voloffs);
+              if (cache != NULL)
                 {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
+                  DEBUGASSERT(cache->cc_ulen >= copysize);
+                  memcpy(dest, cache->cc_buffer, copysize);
+                }
+              else
+                {
+                  DEBUGVERIFY(lzf_decompress(src, clen, dest,
+                                             fs->cv_bsize) >= copysize);
                 }
 
               finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32
-                    " ulen=%" PRIu16 " ff_offset=%" PRIu32 " copysize=%u\n",
-                    voloffs, blkoffs, ulen, ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
+                    " ulen=%" PRIu16 " cached=%d copysize=%u\n",
+                    voloffs, blkoffs, ulen, cache != NULL, copysize);
             }
           else
             {
-              uint32_t voloffs;
-
               /* No, we will need to decompress into the our intermediate
                * decompression buffer.
                */
@@ -1039,29 +1174,19 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
               DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
 
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
+              src   = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+              cache = cromfs_load_block(fs, ff, src, clen);
 
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
-
-              finfo("voloffs=%" PRIu32 " blkoffs=%" PRIu32 " ulen=%" PRIu16
-                    " clen=%" PRIu16 " ff_offset=%" PRIu32
+              finfo("blkoffs=%" PRIu32 " ulen=%" PRIu16
+                    " clen=%" PRIu16 " cc_offset=%" PRIu32
                     "  copyoffs=%u copysize=%u\n",
-                    voloffs, blkoffs, ulen, clen, ff->ff_offset,
+                    blkoffs, ulen, clen, cache->cc_offset,
                     copyoffs, copysize);
-              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
+              DEBUGASSERT(cache->cc_ulen >= (copyoffs + copysize));
 
               /* Then copy to user buffer */
 
-              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+              memcpy(dest, &cache->cc_buffer[copyoffs], copysize);
             }
         }
 
@@ -1123,25 +1248,12 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
    * same node.
    */
 
-  newff = fs_heap_zalloc(sizeof(struct cromfs_file_s));
+  newff = cromfs_alloc_file(fs, oldff->ff_node);
   if (newff == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Create a file buffer to support partial sector accesses */
-
-  newff->ff_buffer = fs_heap_malloc(fs->cv_bsize);
-  if (newff->ff_buffer == NULL)
-    {
-      fs_heap_free(newff);
-      return -ENOMEM;
-    }
-
-  /* Save the node in the open file instance */
-
-  newff->ff_node = oldff->ff_node;
-
   /* Copy the index from the old to the new file structure */
 
   newp->f_priv = newff;
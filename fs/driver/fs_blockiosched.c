@@ -0,0 +1,487 @@
+/****************************************************************************
+ * fs/driver/fs_blockiosched.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A block driver that passes the requests on to another one and schedules
+ * them by the priority of the calling thread.  The transfers are split in
+ * chunks and the device is handed to the waiting request of the highest
+ * priority after each chunk, so that a long transfer of a low priority
+ * thread does not hold off a short one of a higher priority.  A request
+ * that has waited past its deadline goes first, whatever its priority, so
+ * that the low priority ones are not starved either.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mount.h>
+#include <sys/param.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/list.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_BLOCKIOSCHED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IOSCHED_CHUNK       CONFIG_FS_BLOCKIOSCHED_CHUNK
+#define IOSCHED_RDDEADLINE  MSEC2TICK(CONFIG_FS_BLOCKIOSCHED_READ_DEADLINE)
+#define IOSCHED_WRDEADLINE  MSEC2TICK(CONFIG_FS_BLOCKIOSCHED_WRITE_DEADLINE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A request waiting for the device, on the stack of the waiting thread */
+
+struct iosched_req_s
+{
+  struct list_node node;           /* In the queue of the device */
+  sem_t sem;                       /* Posted when the device is handed over */
+  clock_t deadline;                /* When it goes first */
+  uint8_t priority;                /* Priority of the waiting thread */
+};
+
+struct iosched_struct_s
+{
+  FAR struct inode *origin;        /* The device the requests go to */
+  spinlock_t lock;                 /* Protects the fields below */
+  struct list_node queue;          /* Waiting requests, by priority */
+  blksize_t sectorsize;            /* Size of one sector */
+  bool busy;                       /* A request owns the device */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     iosched_open(FAR struct inode *inode);
+static int     iosched_close(FAR struct inode *inode);
+static ssize_t iosched_read(FAR struct inode *inode,
+                            FAR unsigned char *buffer,
+                            blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t iosched_write(FAR struct inode *inode,
+                             FAR const unsigned char *buffer,
+                             blkcnt_t start_sector, unsigned int nsectors);
+static int     iosched_geometry(FAR struct inode *inode,
+                                FAR struct geometry *geometry);
+static int     iosched_ioctl(FAR struct inode *inode, int cmd,
+                             unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     iosched_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_iosched_bops =
+{
+  iosched_open,     /* open     */
+  iosched_close,    /* close    */
+  iosched_read,     /* read     */
+  iosched_write,    /* write    */
+  iosched_geometry, /* geometry */
+  iosched_ioctl,    /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  iosched_unlink,   /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iosched_acquire
+ *
+ * Description:
+ *   Wait until the device is handed to the calling thread.  The requests
+ *   wait in the order of their priority, those of the same priority in the
+ *   order they came.
+ *
+ ****************************************************************************/
+
+static void iosched_acquire(FAR struct iosched_struct_s *dev,
+                            clock_t delay)
+{
+  struct iosched_req_s req;
+  FAR struct iosched_req_s *curr;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&dev->lock);
+  if (!dev->busy)
+    {
+      dev->busy = true;
+      spin_unlock_irqrestore(&dev->lock, flags);
+      return;
+    }
+
+  nxsem_init(&req.sem, 0, 0);
+  req.deadline = clock_systime_ticks() + delay;
+  req.priority = nxsched_self()->sched_priority;
+
+  list_for_every_entry(&dev->queue, curr, struct iosched_req_s, node)
+    {
+      if (curr->priority < req.priority)
+        {
+          break;
+        }
+    }
+
+  list_add_before(&curr->node, &req.node);
+  spin_unlock_irqrestore(&dev->lock, flags);
+
+  /* The device is ours once the semaphore is posted, the request must not
+   * leave the queue in any other way.
+   */
+
+  nxsem_wait_uninterruptible(&req.sem);
+  nxsem_destroy(&req.sem);
+}
+
+/****************************************************************************
+ * Name: iosched_release
+ *
+ * Description:
+ *   Hand the device to the next request: the one that is the most overdue
+ *   if any has waited past its deadline, else the one of the highest
+ *   priority.
+ *
+ ****************************************************************************/
+
+static void iosched_release(FAR struct iosched_struct_s *dev)
+{
+  FAR struct iosched_req_s *next = NULL;
+  FAR struct iosched_req_s *curr;
+  clock_t now = clock_systime_ticks();
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&dev->lock);
+
+  list_for_every_entry(&dev->queue, curr, struct iosched_req_s, node)
+    {
+      if (clock_compare(curr->deadline, now) &&
+          (next == NULL || clock_compare(curr->deadline, next->deadline)))
+        {
+          next = curr;
+        }
+    }
+
+  if (next == NULL)
+    {
+      next = list_peek_head_type(&dev->queue, struct iosched_req_s, node);
+    }
+
+  if (next != NULL)
+    {
+      list_delete(&next->node);
+    }
+  else
+    {
+      dev->busy = false;
+    }
+
+  spin_unlock_irqrestore(&dev->lock, flags);
+
+  if (next != NULL)
+    {
+      nxsem_post(&next->sem);
+    }
+}
+
+/****************************************************************************
+ * Name: iosched_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int iosched_open(FAR struct inode *inode)
+{
+  FAR struct iosched_struct_s *dev = inode->i_private;
+  FAR struct inode *origin = dev->origin;
+
+  if (origin->u.i_bops->open)
+    {
+      return origin->u.i_bops->open(origin);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: iosched_close
+ *
+ * Description: close the block device
+ *
+ ****************************************************************************/
+
+static int iosched_close(FAR struct inode *inode)
+{
+  FAR struct iosched_struct_s *dev = inode->i_private;
+  FAR struct inode *origin = dev->origin;
+
+  if (origin->u.i_bops->close)
+    {
+      return origin->u.i_bops->close(origin);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: iosched_read
+ *
+ * Description:
+ *   Read the specified number of sectors, one chunk at a time.
+ *
+ ****************************************************************************/
+
+static ssize_t iosched_read(FAR struct inode *inode,
+                            FAR unsigned char *buffer,
+                            blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct iosched_struct_s *dev = inode->i_private;
+  FAR struct inode *origin = dev->origin;
+  ssize_t nread = 0;
+  ssize_t ret = 0;
+
+  while (nread < nsectors)
+    {
+      iosched_acquire(dev, IOSCHED_RDDEADLINE);
+      ret = origin->u.i_bops->read(origin, buffer, start_sector + nread,
+                                   MIN(nsectors - nread, IOSCHED_CHUNK));
+      iosched_release(dev);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      buffer += ret * dev->sectorsize;
+      nread  += ret;
+    }
+
+  return nread > 0 ? nread : ret;
+}
+
+/****************************************************************************
+ * Name: iosched_write
+ *
+ * Description:
+ *   Write the specified number of sectors, one chunk at a time.
+ *
+ ****************************************************************************/
+
+static ssize_t iosched_write(FAR struct inode *inode,
+                             FAR const unsigned char *buffer,
+                             blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct iosched_struct_s *dev = inode->i_private;
+  FAR struct inode *origin = dev->origin;
+  ssize_t nwritten = 0;
+  ssize_t ret = 0;
+
+  if (origin->u.i_bops->write == NULL)
+    {
+      return -EACCES;
+    }
+
+  while (nwritten < nsectors)
+    {
+      iosched_acquire(dev, IOSCHED_WRDEADLINE);
+      ret = origin->u.i_bops->write(origin, buffer,
+                                    start_sector + nwritten,
+                                    MIN(nsectors - nwritten,
+                                        IOSCHED_CHUNK));
+      iosched_release(dev);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      buffer   += ret * dev->sectorsize;
+      nwritten += ret;
+    }
+
+  return nwritten > 0 ? nwritten : ret;
+}
+
+/****************************************************************************
+ * Name: iosched_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int iosched_geometry(FAR struct inode *inode,
+                            FAR struct geometry *geometry)
+{
+  FAR struct iosched_struct_s *dev = inode->i_private;
+  FAR struct inode *origin = dev->origin;
+
+  return origin->u.i_bops->geometry(origin, geometry);
+}
+
+/****************************************************************************
+ * Name: iosched_ioctl
+ *
+ * Description:
+ *   Pass the command on to the device once it is handed to the caller, a
+ *   flush takes its turn as a write does.
+ *
+ ****************************************************************************/
+
+static int iosched_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct iosched_struct_s *dev = inode->i_private;
+  FAR struct inode *origin = dev->origin;
+  int ret;
+
+  if (origin->u.i_bops->ioctl == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  iosched_acquire(dev, IOSCHED_WRDEADLINE);
+  ret = origin->u.i_bops->ioctl(origin, cmd, arg);
+  iosched_release(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: iosched_free
+ ****************************************************************************/
+
+static void iosched_free(FAR struct iosched_struct_s *dev)
+{
+  DEBUGASSERT(!dev->busy && list_is_empty(&dev->queue));
+
+  if (dev->origin != NULL)
+    {
+      inode_release(dev->origin);
+    }
+
+  fs_heap_free(dev);
+}
+
+/****************************************************************************
+ * Name: iosched_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int iosched_unlink(FAR struct inode *inode)
+{
+  iosched_free(inode->i_private);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: register_blockiosched
+ *
+ * Description:
+ *   Register a block driver that passes the requests on to another one,
+ *   scheduled by the priority of the calling threads.  The filesystems and
+ *   partitions that share the device should all be on the new driver, the
+ *   origin must not be used directly while it exists.
+ *
+ * Input Parameters:
+ *   path   - The path to the new inode
+ *   mode   - The access mode of the new inode
+ *   origin - The path to the block driver the requests go to
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int register_blockiosched(FAR const char *path, mode_t mode,
+                          FAR const char *origin)
+{
+  FAR struct iosched_struct_s *dev;
+  struct geometry geo;
+  int ret;
+
+  dev = fs_heap_zalloc(sizeof(struct iosched_struct_s));
+  if (dev == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  spin_lock_init(&dev->lock);
+  list_initialize(&dev->queue);
+
+  ret = find_blockdriver(origin, 0, &dev->origin);
+  if (ret == -EACCES)
+    {
+      ret = find_blockdriver(origin, MS_RDONLY, &dev->origin);
+    }
+
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to find %s: %d\n", origin, ret);
+      goto errout;
+    }
+
+  ret = dev->origin->u.i_bops->geometry(dev->origin, &geo);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  dev->sectorsize = geo.geo_sectorsize;
+
+  ret = register_blockdriver(path, &g_iosched_bops, mode, dev);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return OK;
+
+errout:
+  iosched_free(dev);
+  return ret;
+}
+
+#endif /* CONFIG_FS_BLOCKIOSCHED */
@@ -28,6 +28,7 @@
 
 #include <errno.h>
 #include <sys/mount.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 
 #include <nuttx/fs/fs.h>
@@ -39,6 +40,14 @@
 #include "inode/inode.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of ranges translated to the parent device at a time */
+
+#define PART_NVEC 8
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -69,6 +78,10 @@ static int     part_ioctl(FAR struct inode *inode, int cmd,
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 static int     part_unlink(FAR struct inode *inode);
 #endif
+static ssize_t part_readv(FAR struct inode *inode,
+                          FAR const struct blkvec_s *vec, int nvec);
+static ssize_t part_writev(FAR struct inode *inode,
+                           FAR const struct blkvec_s *vec, int nvec);
 
 /****************************************************************************
  * Private Data
@@ -81,10 +94,12 @@ static const struct block_operations g_part_bops =
   part_read,     /* read     */
   part_write,    /* write    */
   part_geometry, /* geometry */
-  part_ioctl     /* ioctl    */
+  part_ioctl,    /* ioctl    */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
-  , part_unlink  /* unlink   */
+  part_unlink,   /* unlink   */
 #endif
+  part_readv,    /* readv    */
+  part_writev    /* writev   */
 };
 
 /****************************************************************************
@@ -182,6 +197,77 @@ static ssize_t part_write(FAR struct inode *inode,
   return parent->u.i_bops->write(parent, buffer, start_sector, nsectors);
 }
 
+/****************************************************************************
+ * Name: part_xferv
+ *
+ * Description:
+ *   Translate the ranges to the parent device in chunks and pass them on
+ *   as one vectored transfer, so that the parent can merge them.
+ *
+ ****************************************************************************/
+
+static ssize_t part_xferv(FAR struct inode *inode,
+                          FAR const struct blkvec_s *vec, int nvec,
+                          bool write)
+{
+  FAR struct part_struct_s *dev = inode->i_private;
+  struct blkvec_s chunk[PART_NVEC];
+  ssize_t total = 0;
+  ssize_t ret = 0;
+  int n;
+  int i;
+
+  while (nvec > 0)
+    {
+      n = MIN(nvec, PART_NVEC);
+      for (i = 0; i < n; i++)
+        {
+          if (vec[i].start >= dev->nsectors ||
+              vec[i].nsectors > dev->nsectors - vec[i].start)
+            {
+              return total > 0 ? total : -EINVAL;
+            }
+
+          chunk[i].buffer   = vec[i].buffer;
+          chunk[i].start    = vec[i].start + dev->firstsector;
+          chunk[i].nsectors = vec[i].nsectors;
+        }
+
+      ret = write ? block_writev(dev->parent, chunk, n) :
+                    block_readv(dev->parent, chunk, n);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      total += ret;
+      vec   += n;
+      nvec  -= n;
+    }
+
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Name: part_readv
+ ****************************************************************************/
+
+static ssize_t part_readv(FAR struct inode *inode,
+                          FAR const struct blkvec_s *vec, int nvec)
+{
+  return part_xferv(inode, vec, nvec, false);
+}
+
+/****************************************************************************
+ * Name: part_writev
+ ****************************************************************************/
+
+static ssize_t part_writev(FAR struct inode *inode,
+                           FAR const struct blkvec_s *vec, int nvec)
+{
+  return part_xferv(inode, vec, nvec, true);
+}
+
 /****************************************************************************
  * Name: part_geometry
  *
@@ -239,6 +325,26 @@ static int part_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
         }
         break;
 
+      case BIOC_TRIM:
+        {
+          FAR struct blk_trim_s *trim = (FAR struct blk_trim_s *)ptr_arg;
+          struct blk_trim_s ptrim;
+
+          if (trim == NULL || trim->startsector >= dev->nsectors ||
+              trim->nsectors > dev->nsectors - trim->startsector)
+            {
+              ret = -EINVAL;
+            }
+          else if (parent->u.i_bops->ioctl)
+            {
+              ptrim.startsector = trim->startsector + dev->firstsector;
+              ptrim.nsectors    = trim->nsectors;
+              ret = parent->u.i_bops->ioctl(parent, cmd,
+                                            (unsigned long)&ptrim);
+            }
+        }
+        break;
+
       default:
         if (parent->u.i_bops->ioctl)
           {
@@ -0,0 +1,802 @@
+/****************************************************************************
+ * fs/driver/fs_blocksnapshot.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* A copy-on-write view of a block device.  The sectors written to the
+ * snapshot go to a delta store on a second block device, the origin is
+ * left as it was.  Dropping the delta rolls the snapshot back to the
+ * origin at once, merging it writes the changed sectors to the origin.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mount.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/mutex.h>
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_BLOCKSNAPSHOT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The map of the delta grows by this many entries at a time */
+
+#define SNAP_MAPINCR  32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One sector of the origin that was written to the snapshot */
+
+struct snap_map_s
+{
+  blkcnt_t sector;                 /* Sector of the origin */
+  blkcnt_t slot;                   /* Sector of the store holding it */
+};
+
+struct snap_struct_s
+{
+  mutex_t lock;                    /* Protects the delta */
+  FAR struct inode *origin;        /* The device the snapshot is taken of */
+  FAR struct inode *store;         /* Holds the changed sectors */
+  blkcnt_t nsectors;               /* Number of sectors of the origin */
+  blkcnt_t nslots;                 /* Number of sectors of the store */
+  blkcnt_t nextslot;               /* Where the search for a slot begins */
+  blksize_t sectorsize;            /* Size of one sector */
+  bool originwr;                   /* The origin can be merged into */
+  bool storewr;                    /* The snapshot can be written */
+  size_t nmap;                     /* Number of changed sectors */
+  size_t maxmap;                   /* Number of allocated map entries */
+  FAR struct snap_map_s *map;      /* Changed sectors in sector order */
+  FAR uint8_t *slots;              /* Bit map of the used store sectors */
+  FAR uint8_t *buffer;             /* One sector, for merging */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     snap_open(FAR struct inode *inode);
+static int     snap_close(FAR struct inode *inode);
+static ssize_t snap_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                         blkcnt_t start_sector, unsigned int nsectors);
+static ssize_t snap_write(FAR struct inode *inode,
+                          FAR const unsigned char *buffer,
+                          blkcnt_t start_sector, unsigned int nsectors);
+static int     snap_geometry(FAR struct inode *inode,
+                             FAR struct geometry *geometry);
+static int     snap_ioctl(FAR struct inode *inode, int cmd,
+                          unsigned long arg);
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int     snap_unlink(FAR struct inode *inode);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_snap_bops =
+{
+  snap_open,     /* open     */
+  snap_close,    /* close    */
+  snap_read,     /* read     */
+  snap_write,    /* write    */
+  snap_geometry, /* geometry */
+  snap_ioctl,    /* ioctl    */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  snap_unlink,   /* unlink   */
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: snap_find
+ *
+ * Description:
+ *   Return the index of the first map entry at or after sector.
+ *
+ ****************************************************************************/
+
+static size_t snap_find(FAR struct snap_struct_s *dev, blkcnt_t sector)
+{
+  size_t lo = 0;
+  size_t hi = dev->nmap;
+  size_t mid;
+
+  while (lo < hi)
+    {
+      mid = (lo + hi) / 2;
+      if (dev->map[mid].sector < sector)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  return lo;
+}
+
+/****************************************************************************
+ * Name: snap_allocslot
+ *
+ * Description:
+ *   Take a free sector of the store, or return -ENOSPC if it is full.
+ *
+ ****************************************************************************/
+
+static int snap_allocslot(FAR struct snap_struct_s *dev,
+                          FAR blkcnt_t *pslot)
+{
+  blkcnt_t slot = dev->nextslot;
+  blkcnt_t i;
+
+  for (i = 0; i < dev->nslots; i++)
+    {
+      if ((dev->slots[slot >> 3] & (1 << (slot & 7))) == 0)
+        {
+          dev->slots[slot >> 3] |= 1 << (slot & 7);
+          dev->nextslot = slot + 1 < dev->nslots ? slot + 1 : 0;
+          *pslot = slot;
+          return OK;
+        }
+
+      if (++slot >= dev->nslots)
+        {
+          slot = 0;
+        }
+    }
+
+  return -ENOSPC;
+}
+
+/****************************************************************************
+ * Name: snap_insert
+ *
+ * Description:
+ *   Map sector to a new store sector at entry index of the map.
+ *
+ ****************************************************************************/
+
+static int snap_insert(FAR struct snap_struct_s *dev, size_t index,
+                       blkcnt_t sector)
+{
+  FAR struct snap_map_s *map;
+  blkcnt_t slot;
+  int ret;
+
+  if (dev->nmap == dev->maxmap)
+    {
+      map = fs_heap_realloc(dev->map, (dev->maxmap + SNAP_MAPINCR) *
+                                      sizeof(struct snap_map_s));
+      if (map == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      dev->map     = map;
+      dev->maxmap += SNAP_MAPINCR;
+    }
+
+  ret = snap_allocslot(dev, &slot);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memmove(&dev->map[index + 1], &dev->map[index],
+          (dev->nmap - index) * sizeof(struct snap_map_s));
+  dev->map[index].sector = sector;
+  dev->map[index].slot   = slot;
+  dev->nmap++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snap_reset
+ *
+ * Description:
+ *   Drop the delta, the snapshot reads as the origin again.
+ *
+ ****************************************************************************/
+
+static void snap_reset(FAR struct snap_struct_s *dev)
+{
+  dev->nmap     = 0;
+  dev->nextslot = 0;
+  memset(dev->slots, 0, (dev->nslots + 7) / 8);
+}
+
+/****************************************************************************
+ * Name: snap_merge
+ *
+ * Description:
+ *   Copy the changed sectors to the origin and drop the delta.  The delta
+ *   is only dropped once all of them were copied, the snapshot reads the
+ *   same if this fails half way.
+ *
+ ****************************************************************************/
+
+static int snap_merge(FAR struct snap_struct_s *dev)
+{
+  FAR struct inode *origin = dev->origin;
+  FAR struct inode *store = dev->store;
+  ssize_t ret;
+  size_t i;
+
+  if (!dev->originwr)
+    {
+      return -EACCES;
+    }
+
+  for (i = 0; i < dev->nmap; i++)
+    {
+      ret = store->u.i_bops->read(store, dev->buffer, dev->map[i].slot, 1);
+      if (ret == 1)
+        {
+          ret = origin->u.i_bops->write(origin, dev->buffer,
+                                        dev->map[i].sector, 1);
+        }
+
+      if (ret != 1)
+        {
+          ferr("ERROR: Merging sector %" PRIuOFF " failed: %zd\n",
+               (off_t)dev->map[i].sector, ret);
+          return ret < 0 ? ret : -EIO;
+        }
+    }
+
+  if (origin->u.i_bops->ioctl != NULL)
+    {
+      origin->u.i_bops->ioctl(origin, BIOC_FLUSH, 0);
+    }
+
+  snap_reset(dev);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: snap_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int snap_open(FAR struct inode *inode)
+{
+  FAR struct snap_struct_s *dev = inode->i_private;
+  FAR struct inode *origin = dev->origin;
+  FAR struct inode *store = dev->store;
+  int ret = OK;
+
+  if (origin->u.i_bops->open)
+    {
+      ret = origin->u.i_bops->open(origin);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (store->u.i_bops->open)
+    {
+      ret = store->u.i_bops->open(store);
+      if (ret < 0 && origin->u.i_bops->close)
+        {
+          origin->u.i_bops->close(origin);
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: snap_close
+ *
+ * Description: close the block device
+ *
+ ****************************************************************************/
+
+static int snap_close(FAR struct inode *inode)
+{
+  FAR struct snap_struct_s *dev = inode->i_private;
+  FAR struct inode *origin = dev->origin;
+  FAR struct inode *store = dev->store;
+  int ret = OK;
+
+  if (store->u.i_bops->close)
+    {
+      ret = store->u.i_bops->close(store);
+    }
+
+  if (origin->u.i_bops->close)
+    {
+      int ret2 = origin->u.i_bops->close(origin);
+      if (ret >= 0)
+        {
+          ret = ret2;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: snap_read
+ *
+ * Description:
+ *   Read the specified number of sectors.  The runs of unchanged sectors
+ *   are read from the origin, the changed ones from the store.
+ *
+ ****************************************************************************/
+
+static ssize_t snap_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                         blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct snap_struct_s *dev = inode->i_private;
+  FAR struct inode *origin = dev->origin;
+  FAR struct inode *store = dev->store;
+  blkcnt_t sector = start_sector;
+  blkcnt_t end;
+  blkcnt_t run;
+  ssize_t ret;
+  size_t i;
+
+  if (start_sector >= dev->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  if (start_sector + nsectors > dev->nsectors)
+    {
+      nsectors = dev->nsectors - start_sector;
+    }
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  end = start_sector + nsectors;
+  i   = snap_find(dev, start_sector);
+
+  while (sector < end)
+    {
+      if (i < dev->nmap && dev->map[i].sector == sector)
+        {
+          /* Changed sectors with consecutive store sectors in one go */
+
+          run = 1;
+          while (sector + run < end && i + run < dev->nmap &&
+                 dev->map[i + run].sector == sector + run &&
+                 dev->map[i + run].slot == dev->map[i].slot + run)
+            {
+              run++;
+            }
+
+          ret = store->u.i_bops->read(store, buffer, dev->map[i].slot,
+                                      run);
+          i  += run;
+        }
+      else
+        {
+          run = (i < dev->nmap ? MIN(dev->map[i].sector, end) : end) -
+                sector;
+          ret = origin->u.i_bops->read(origin, buffer, sector, run);
+        }
+
+      if (ret != run)
+        {
+          break;
+        }
+
+      buffer += run * dev->sectorsize;
+      sector += run;
+    }
+
+  nxmutex_unlock(&dev->lock);
+
+  if (sector > start_sector)
+    {
+      return sector - start_sector;
+    }
+
+  return ret < 0 ? ret : -EIO;
+}
+
+/****************************************************************************
+ * Name: snap_write
+ *
+ * Description:
+ *   Write the specified number of sectors to the store, a sector that was
+ *   not changed before takes a new store sector.  With
+ *   CONFIG_FS_BLOCKSNAPSHOT_DEDUP a sector written with the content it has
+ *   on the origin gives its store sector back instead.
+ *
+ ****************************************************************************/
+
+static ssize_t snap_write(FAR struct inode *inode,
+                          FAR const unsigned char *buffer,
+                          blkcnt_t start_sector, unsigned int nsectors)
+{
+  FAR struct snap_struct_s *dev = inode->i_private;
+  FAR struct inode *store = dev->store;
+  blkcnt_t sector = start_sector;
+  blkcnt_t end;
+  ssize_t ret;
+  size_t i;
+#ifdef CONFIG_FS_BLOCKSNAPSHOT_DEDUP
+  FAR struct inode *origin = dev->origin;
+  blkcnt_t slot;
+  bool same;
+#endif
+
+  if (!dev->storewr)
+    {
+      return -EACCES;
+    }
+
+  if (start_sector >= dev->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  if (start_sector + nsectors > dev->nsectors)
+    {
+      nsectors = dev->nsectors - start_sector;
+    }
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  end = start_sector + nsectors;
+  i   = snap_find(dev, start_sector);
+
+  for (; sector < end; sector++, buffer += dev->sectorsize)
+    {
+      bool mapped = i < dev->nmap && dev->map[i].sector == sector;
+
+#ifdef CONFIG_FS_BLOCKSNAPSHOT_DEDUP
+      ret = origin->u.i_bops->read(origin, dev->buffer, sector, 1);
+      same = ret == 1 && memcmp(dev->buffer, buffer, dev->sectorsize) == 0;
+
+      if (same)
+        {
+          if (mapped)
+            {
+              slot = dev->map[i].slot;
+              dev->slots[slot >> 3] &= ~(1 << (slot & 7));
+              dev->nmap--;
+              memmove(&dev->map[i], &dev->map[i + 1],
+                      (dev->nmap - i) * sizeof(struct snap_map_s));
+            }
+
+          continue;
+        }
+#endif
+
+      if (!mapped)
+        {
+          ret = snap_insert(dev, i, sector);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      ret = store->u.i_bops->write(store, buffer, dev->map[i].slot, 1);
+      if (ret != 1)
+        {
+          ret = ret < 0 ? ret : -EIO;
+          break;
+        }
+
+      i++;
+    }
+
+  nxmutex_unlock(&dev->lock);
+
+  if (sector > start_sector)
+    {
+      return sector - start_sector;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: snap_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int snap_geometry(FAR struct inode *inode,
+                         FAR struct geometry *geometry)
+{
+  FAR struct snap_struct_s *dev = inode->i_private;
+  FAR struct inode *origin = dev->origin;
+  int ret;
+
+  ret = origin->u.i_bops->geometry(origin, geometry);
+  if (ret >= 0)
+    {
+      geometry->geo_writeenabled = dev->storewr;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: snap_ioctl
+ ****************************************************************************/
+
+static int snap_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct snap_struct_s *dev = inode->i_private;
+  FAR struct inode *store = dev->store;
+  int ret;
+
+  ret = nxmutex_lock(&dev->lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case BIOC_SNAPINFO:
+        {
+          FAR struct blk_snapinfo_s *info =
+            (FAR struct blk_snapinfo_s *)((uintptr_t)arg);
+
+          if (info == NULL)
+            {
+              ret = -EINVAL;
+              break;
+            }
+
+          info->nsectors = dev->nsectors;
+          info->nslots   = dev->nslots;
+          info->nchanged = dev->nmap;
+        }
+        break;
+
+      case BIOC_SNAPDROP:
+        snap_reset(dev);
+        break;
+
+      case BIOC_SNAPMERGE:
+        ret = snap_merge(dev);
+        break;
+
+      case BIOC_FLUSH:
+        ret = OK;
+        if (store->u.i_bops->ioctl != NULL)
+          {
+            ret = store->u.i_bops->ioctl(store, cmd, arg);
+          }
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&dev->lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: snap_free
+ ****************************************************************************/
+
+static void snap_free(FAR struct snap_struct_s *dev)
+{
+  if (dev->origin != NULL)
+    {
+      inode_release(dev->origin);
+    }
+
+  if (dev->store != NULL)
+    {
+      inode_release(dev->store);
+    }
+
+  nxmutex_destroy(&dev->lock);
+  fs_heap_free(dev->map);
+  fs_heap_free(dev->slots);
+  fs_heap_free(dev->buffer);
+  fs_heap_free(dev);
+}
+
+/****************************************************************************
+ * Name: snap_unlink
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+static int snap_unlink(FAR struct inode *inode)
+{
+  snap_free(inode->i_private);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: snap_finddriver
+ *
+ * Description:
+ *   Find a block driver, read-write if it can be written.
+ *
+ ****************************************************************************/
+
+static int snap_finddriver(FAR const char *path, FAR struct inode **inode,
+                           FAR struct geometry *geo)
+{
+  int ret;
+
+  ret = find_blockdriver(path, 0, inode);
+  if (ret == -EACCES)
+    {
+      ret = find_blockdriver(path, MS_RDONLY, inode);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = (*inode)->u.i_bops->geometry(*inode, geo);
+  if (ret >= 0 && (geo->geo_nsectors == 0 || geo->geo_sectorsize <= 0))
+    {
+      ret = -EINVAL;
+    }
+
+  if (ret < 0)
+    {
+      inode_release(*inode);
+      *inode = NULL;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: register_blocksnapshot
+ *
+ * Description:
+ *   Register a copy-on-write snapshot of a block driver.  The snapshot
+ *   reads as the origin until it is written, the changed sectors are kept
+ *   in the store and the origin is not modified.  The origin must not be
+ *   written directly while the snapshot exists.  The delta is kept in RAM
+ *   and is lost when the snapshot is unlinked.
+ *
+ * Input Parameters:
+ *   snapshot - The path to the snapshot inode
+ *   mode     - The access mode of the snapshot inode
+ *   origin   - The path to the block driver the snapshot is taken of
+ *   store    - The path to the block driver that holds the changed
+ *              sectors, with the sector size of the origin
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+int register_blocksnapshot(FAR const char *snapshot, mode_t mode,
+                           FAR const char *origin, FAR const char *store)
+{
+  FAR struct snap_struct_s *dev;
+  struct geometry geo;
+  int ret;
+
+  dev = fs_heap_zalloc(sizeof(struct snap_struct_s));
+  if (dev == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&dev->lock);
+
+  ret = snap_finddriver(origin, &dev->origin, &geo);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to find %s: %d\n", origin, ret);
+      goto errout;
+    }
+
+  dev->nsectors   = geo.geo_nsectors;
+  dev->sectorsize = geo.geo_sectorsize;
+  dev->originwr   = geo.geo_writeenabled &&
+                    dev->origin->u.i_bops->write != NULL;
+
+  ret = snap_finddriver(store, &dev->store, &geo);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to find %s: %d\n", store, ret);
+      goto errout;
+    }
+
+  if (geo.geo_sectorsize != dev->sectorsize)
+    {
+      ferr("ERROR: Sector size of %s is not %d\n",
+           store, (int)dev->sectorsize);
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  dev->nslots  = geo.geo_nsectors;
+  dev->storewr = geo.geo_writeenabled &&
+                 dev->store->u.i_bops->write != NULL;
+
+  dev->slots  = fs_heap_zalloc((dev->nslots + 7) / 8);
+  dev->buffer = fs_heap_malloc(dev->sectorsize);
+  if (dev->slots == NULL || dev->buffer == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ret = register_blockdriver(snapshot, &g_snap_bops, mode, dev);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return OK;
+
+errout:
+  snap_free(dev);
+  return ret;
+}
+
+#endif /* CONFIG_FS_BLOCKSNAPSHOT */
@@ -0,0 +1,168 @@
+/****************************************************************************
+ * fs/driver/fs_blockvec.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: block_sortvec
+ *
+ * Description:
+ *   Sort the ranges by sector and merge the adjacent ones whose buffers
+ *   are contiguous.  An insertion sort is used because the vectors are
+ *   short and usually already in order.
+ *
+ * Returned Value:
+ *   The number of ranges left.
+ *
+ ****************************************************************************/
+
+static int block_sortvec(FAR struct blkvec_s *vec, int nvec,
+                         size_t sectorsize)
+{
+  struct blkvec_s tmp;
+  int i;
+  int j;
+
+  for (i = 1; i < nvec; i++)
+    {
+      tmp = vec[i];
+      for (j = i; j > 0 && vec[j - 1].start > tmp.start; j--)
+        {
+          vec[j] = vec[j - 1];
+        }
+
+      vec[j] = tmp;
+    }
+
+  for (i = 0, j = 1; j < nvec; j++)
+    {
+      if (vec[i].start + vec[i].nsectors == vec[j].start &&
+          vec[i].buffer + vec[i].nsectors * sectorsize == vec[j].buffer)
+        {
+          vec[i].nsectors += vec[j].nsectors;
+        }
+      else
+        {
+          vec[++i] = vec[j];
+        }
+    }
+
+  return nvec > 0 ? i + 1 : 0;
+}
+
+/****************************************************************************
+ * Name: block_xferv
+ ****************************************************************************/
+
+static ssize_t block_xferv(FAR struct inode *inode, FAR struct blkvec_s *vec,
+                           int nvec, bool write)
+{
+  FAR const struct block_operations *bops;
+  struct geometry geo;
+  ssize_t total = 0;
+  ssize_t ret;
+  int i;
+
+  if (inode == NULL || !INODE_IS_BLOCK(inode) || vec == NULL || nvec < 0)
+    {
+      return -EINVAL;
+    }
+
+  bops = inode->u.i_bops;
+  if (bops->geometry == NULL ||
+      (write ? bops->write == NULL : bops->read == NULL))
+    {
+      return -ENOSYS;
+    }
+
+  ret = bops->geometry(inode, &geo);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nvec = block_sortvec(vec, nvec, geo.geo_sectorsize);
+
+  if (write ? bops->writev != NULL : bops->readv != NULL)
+    {
+      return write ? bops->writev(inode, vec, nvec) :
+                     bops->readv(inode, vec, nvec);
+    }
+
+  for (i = 0; i < nvec; i++)
+    {
+      ret = write ? bops->write(inode, vec[i].buffer, vec[i].start,
+                                vec[i].nsectors) :
+                    bops->read(inode, vec[i].buffer, vec[i].start,
+                               vec[i].nsectors);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      total += ret;
+      if (ret < vec[i].nsectors)
+        {
+          break;
+        }
+    }
+
+  return total > 0 ? total : ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: block_readv
+ ****************************************************************************/
+
+ssize_t block_readv(FAR struct inode *inode, FAR struct blkvec_s *vec,
+                    int nvec)
+{
+  return block_xferv(inode, vec, nvec, false);
+}
+
+/****************************************************************************
+ * Name: block_writev
+ ****************************************************************************/
+
+ssize_t block_writev(FAR struct inode *inode, FAR struct blkvec_s *vec,
+                     int nvec)
+{
+  return block_xferv(inode, vec, nvec, true);
+}
@@ -30,6 +30,7 @@
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <sys/mount.h>
+#include <sys/param.h>
 
 #include <stdlib.h>
 #include <unistd.h>
@@ -553,6 +554,78 @@ out:
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_contiguous
+ *
+ * Description:
+ *   Limit a direct transfer of 'nsectors' sectors from the current sector
+ *   of the file to the physically contiguous ones.  The transfer may go
+ *   beyond the current cluster as long as the next clusters of the chain
+ *   are the adjacent ones, so that it is a single request to the block
+ *   driver (for example a single multiple block command to an SD card)
+ *   instead of one request per cluster.
+ *
+ * Returned Value:
+ *   The number of sectors that can be transferred.  The last cluster
+ *   reached and the number of clusters crossed are returned for
+ *   fat_advance().
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+static unsigned int fat_contiguous(FAR struct fat_mountpt_s *fs,
+                                   FAR struct fat_file_s *ff,
+                                   unsigned int nsectors,
+                                   FAR off_t *cluster,
+                                   FAR unsigned int *nclusters)
+{
+  unsigned int count = ff->ff_sectorsincluster;
+  off_t next;
+
+  *cluster   = ff->ff_currentcluster;
+  *nclusters = 0;
+
+  while (count < nsectors)
+    {
+      next = fat_getcluster(fs, *cluster);
+      if (next != *cluster + 1 || next >= fs->fs_nclusters + 2)
+        {
+          break;
+        }
+
+      *cluster = next;
+      (*nclusters)++;
+      count += fs->fs_fatsecperclus;
+    }
+
+  return MIN(count, nsectors);
+}
+
+/****************************************************************************
+ * Name: fat_advance
+ *
+ * Description:
+ *   Update the current sector and cluster of the file after a direct
+ *   transfer limited by fat_contiguous().
+ *
+ ****************************************************************************/
+
+static void fat_advance(FAR struct fat_mountpt_s *fs,
+                        FAR struct fat_file_s *ff, unsigned int nsectors,
+                        off_t cluster, unsigned int nclusters)
+{
+  ff->ff_sectorsincluster += nclusters * fs->fs_fatsecperclus - nsectors;
+  ff->ff_currentsector    += nsectors;
+
+  if (nclusters > 0)
+    {
+      ff->ff_currentcluster = cluster;
+      ff->ff_pos += (off_t)nclusters * fs->fs_fatsecperclus *
+                    fs->fs_hwsectorsize;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fat_get_sectors
  *
@@ -763,6 +836,8 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  unsigned int nclusters;
+  off_t cluster;
   bool force_indirect = false;
 #endif
 
@@ -869,12 +944,17 @@ fat_read_restart:
            *
            * Limit the number of sectors that we read on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and the adjacent clusters that follow it
            */
 
           if (nsectors > ff->ff_sectorsincluster)
             {
-              nsectors = ff->ff_sectorsincluster;
+              nsectors = fat_contiguous(fs, ff, nsectors, &cluster,
+                                        &nclusters);
+            }
+          else
+            {
+              nclusters = 0;
             }
 
           /* We are not sure of the state of the file buffer so
@@ -909,9 +989,8 @@ fat_read_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          bytesread                = nsectors * fs->fs_hwsectorsize;
+          fat_advance(fs, ff, nsectors, cluster, nclusters);
+          bytesread = nsectors * fs->fs_hwsectorsize;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -983,6 +1062,8 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  unsigned int nclusters;
+  off_t cluster;
   bool force_indirect = false;
 #endif
 
@@ -1067,12 +1148,18 @@ fat_write_restart:
            *
            * Limit the number of sectors that we write on this time
            * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * in this cluster and the adjacent, already allocated clusters
+           * that follow it
            */
 
           if (nsectors > ff->ff_sectorsincluster)
             {
-              nsectors = ff->ff_sectorsincluster;
+              nsectors = fat_contiguous(fs, ff, nsectors, &cluster,
+                                        &nclusters);
+            }
+          else
+            {
+              nclusters = 0;
             }
 
           /* We are not sure of the state of the sector cache so the
@@ -1108,10 +1195,9 @@ fat_write_restart:
               goto errout_with_lock;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
-          ff->ff_currentsector    += nsectors;
-          writesize                = nsectors * fs->fs_hwsectorsize;
-          ff->ff_bflags           |= FFBUFF_MODIFIED;
+          fat_advance(fs, ff, nsectors, cluster, nclusters);
+          writesize      = nsectors * fs->fs_hwsectorsize;
+          ff->ff_bflags |= FFBUFF_MODIFIED;
         }
       else
 #endif /* CONFIG_FAT_FORCE_INDIRECT */
@@ -2358,6 +2444,20 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#if CONFIG_FAT_CACHE_SECTORS > 0
+  if (fs->fs_cachebuf)
+    {
+      fs_heap_free(fs->fs_cachebuf);
+    }
+#endif
+
+#ifdef CONFIG_FAT_FREE_BITMAP
+  if (fs->fs_freemap)
+    {
+      fs_heap_free(fs->fs_freemap);
+    }
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return OK;
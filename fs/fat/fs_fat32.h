@@ -862,6 +862,16 @@
  * is mounted with a fat32 filesystem.
  */
 
+#if CONFIG_FAT_CACHE_SECTORS > 0
+/* This structure describes one entry of the FAT/directory sector cache */
+
+struct fat_cache_s
+{
+  off_t    sector;                 /* Cached sector number, or -1 if unused */
+  uint32_t stamp;                  /* Time of last access, for LRU replacement */
+};
+#endif
+
 struct fat_file_s;
 struct fat_mountpt_s
 {
@@ -891,6 +901,15 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one
                                     * sector from the device */
+#if CONFIG_FAT_CACHE_SECTORS > 0
+  uint8_t *fs_cachebuf;            /* Memory of the sector cache */
+  uint32_t fs_cachestamp;          /* Incremented on each cache access */
+  struct fat_cache_s fs_cache[CONFIG_FAT_CACHE_SECTORS];
+#endif
+#ifdef CONFIG_FAT_FREE_BITMAP
+  uint32_t *fs_freemap;            /* One bit per cluster, set if allocated */
+  bool     fs_freemapvalid;        /* true: fs_freemap matches the FAT */
+#endif
 };
 
 /* This structure represents on open file under the mountpoint.  An instance
@@ -1039,6 +1058,10 @@ EXTERN int    fat_hwread(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
                          off_t sector, unsigned int nsectors);
 EXTERN int    fat_hwwrite(FAR struct fat_mountpt_s *fs, FAR uint8_t *buffer,
                           off_t sector, unsigned int nsectors);
+#ifdef CONFIG_FAT_TRIM
+EXTERN void   fat_hwtrim(FAR struct fat_mountpt_s *fs, off_t sector,
+                         unsigned int nsectors);
+#endif
 
 /* Cluster / cluster chain access helpers */
 
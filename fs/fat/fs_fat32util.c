@@ -32,6 +32,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
 #include <assert.h>
 #include <errno.h>
@@ -44,10 +45,272 @@
 #include "inode/inode.h"
 #include "fs_fat32.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Memory holding the sector of a cache entry */
+
+#define FAT_CACHE_DATA(fs, e) \
+  ((fs)->fs_cachebuf + ((e) - (fs)->fs_cache) * (fs)->fs_hwsectorsize)
+
+/* Size of the free cluster bitmap in 32-bit words.  One bit for each FAT
+ * entry, including the two reserved entries.
+ */
+
+#define FAT_FREEMAP_WORDS(fs) (((fs)->fs_nclusters + 2 + 31) >> 5)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#if CONFIG_FAT_CACHE_SECTORS > 0
+/****************************************************************************
+ * Name: fat_cachelookup
+ *
+ * Description:
+ *   Return the sector cache entry holding 'sector', or NULL if the sector
+ *   is not cached.
+ *
+ ****************************************************************************/
+
+static FAR struct fat_cache_s *fat_cachelookup(FAR struct fat_mountpt_s *fs,
+                                                off_t sector)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_CACHE_SECTORS; i++)
+    {
+      if (fs->fs_cache[i].sector == sector)
+        {
+          return &fs->fs_cache[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: fat_cacheread
+ *
+ * Description:
+ *   Read 'sector' into fs_buffer, from the sector cache if possible.  A
+ *   sector read from the media replaces the least recently used entry.
+ *
+ ****************************************************************************/
+
+static int fat_cacheread(FAR struct fat_mountpt_s *fs, off_t sector)
+{
+  FAR struct fat_cache_s *entry;
+  int ret;
+  int i;
+
+  entry = fat_cachelookup(fs, sector);
+  if (entry != NULL)
+    {
+      memcpy(fs->fs_buffer, FAT_CACHE_DATA(fs, entry), fs->fs_hwsectorsize);
+      entry->stamp = ++fs->fs_cachestamp;
+      return OK;
+    }
+
+  ret = fat_hwread(fs, fs->fs_buffer, sector, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Replace an unused entry or else the least recently used one */
+
+  entry = &fs->fs_cache[0];
+  for (i = 1; i < CONFIG_FAT_CACHE_SECTORS && entry->sector >= 0; i++)
+    {
+      if (fs->fs_cache[i].sector < 0 ||
+          fs->fs_cachestamp - fs->fs_cache[i].stamp >
+          fs->fs_cachestamp - entry->stamp)
+        {
+          entry = &fs->fs_cache[i];
+        }
+    }
+
+  memcpy(FAT_CACHE_DATA(fs, entry), fs->fs_buffer, fs->fs_hwsectorsize);
+  entry->sector = sector;
+  entry->stamp  = ++fs->fs_cachestamp;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fat_cacheupdate
+ *
+ * Description:
+ *   Keep the sector cache coherent with a write of 'nsectors' sectors
+ *   starting at 'sector'.  If 'buffer' is NULL the write failed and the
+ *   cached copies are discarded instead.
+ *
+ ****************************************************************************/
+
+static void fat_cacheupdate(FAR struct fat_mountpt_s *fs,
+                            FAR const uint8_t *buffer, off_t sector,
+                            unsigned int nsectors)
+{
+  FAR struct fat_cache_s *entry;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_CACHE_SECTORS; i++)
+    {
+      entry = &fs->fs_cache[i];
+      if (entry->sector < sector || entry->sector >= sector + nsectors)
+        {
+          continue;
+        }
+
+      if (buffer == NULL)
+        {
+          entry->sector = -1;
+        }
+      else
+        {
+          memcpy(FAT_CACHE_DATA(fs, entry),
+                 buffer + (entry->sector - sector) * fs->fs_hwsectorsize,
+                 fs->fs_hwsectorsize);
+        }
+    }
+}
+#endif
+
+#ifdef CONFIG_FAT_FREE_BITMAP
+/****************************************************************************
+ * Name: fat_freemapsearch
+ *
+ * Description:
+ *   Return the first cluster in the range [first, last) that the free
+ *   cluster bitmap shows as unallocated, or 0 if there is none.
+ *
+ ****************************************************************************/
+
+static uint32_t fat_freemapsearch(FAR struct fat_mountpt_s *fs,
+                                  uint32_t first, uint32_t last)
+{
+  uint32_t cluster = first;
+  uint32_t word;
+
+  while (cluster < last)
+    {
+      word = ~fs->fs_freemap[cluster >> 5] >> (cluster & 31);
+      if (word != 0)
+        {
+          cluster += ffs((int)word) - 1;
+          return cluster < last ? cluster : 0;
+        }
+
+      cluster = (cluster | 31) + 1;
+    }
+
+  return 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_findfreecluster
+ *
+ * Description:
+ *   Find a free cluster, searching forward from the cluster after
+ *   'startcluster' and wrapping around to the beginning of the FAT.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: free cluster number
+ *
+ ****************************************************************************/
+
+static int32_t fat_findfreecluster(FAR struct fat_mountpt_s *fs,
+                                   uint32_t startcluster)
+{
+  uint32_t newcluster;
+  off_t    startsector;
+
+#ifdef CONFIG_FAT_FREE_BITMAP
+  /* Build the free cluster bitmap on first use */
+
+  if (fs->fs_freemap != NULL && !fs->fs_freemapvalid)
+    {
+      int ret = fat_computefreeclusters(fs);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (fs->fs_freemap != NULL)
+    {
+      newcluster = fat_freemapsearch(fs, startcluster + 1,
+                                     fs->fs_nclusters + 2);
+      if (newcluster == 0)
+        {
+          newcluster = fat_freemapsearch(fs, 2, startcluster + 1);
+        }
+
+      return newcluster;
+    }
+#endif
+
+  /* Loop until (1) we discover that there are not free clusters
+   * (return 0), an errors occurs (return -errno), or (3) we find
+   * the next cluster (return the new cluster number).
+   */
+
+  newcluster = startcluster;
+  for (; ; )
+    {
+      /* Examine the next cluster in the FAT */
+
+      newcluster++;
+      if (newcluster >= fs->fs_nclusters + 2)
+        {
+          /* If we hit the end of the available clusters, then
+           * wrap back to the beginning because we might have
+           * started at a non-optimal place.  But don't continue
+           * past the start cluster.
+           */
+
+          newcluster = 2;
+          if (newcluster > startcluster)
+            {
+              /* We are back past the starting cluster, then there
+               * is no free cluster.
+               */
+
+              return 0;
+            }
+        }
+
+      /* We have a candidate cluster.  Check if the cluster number is
+       * mapped to a group of sectors.
+       */
+
+      startsector = fat_getcluster(fs, newcluster);
+      if (startsector == 0)
+        {
+          /* Found have found a free cluster */
+
+          return newcluster;
+        }
+      else if (startsector < 0)
+        {
+          /* Some error occurred, return the error number */
+
+          return startsector;
+        }
+
+      /* We wrap all the back to the starting cluster?  If so, then
+       * there are no free clusters.
+       */
+
+      if (newcluster == startcluster)
+        {
+          return 0;
+        }
+    }
+}
+
 /****************************************************************************
  * Name: fat_checkfsinfo
  *
@@ -480,6 +743,9 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
 {
   FAR struct inode *inode;
   struct geometry geo;
+#if CONFIG_FAT_CACHE_SECTORS > 0
+  int ndx;
+#endif
   int ret;
 
   /* Assume that the mount is successful */
@@ -520,6 +786,25 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
       goto errout;
     }
 
+#if CONFIG_FAT_CACHE_SECTORS > 0
+  /* Allocate the FAT/directory sector cache.  Only fs_buffer is used for
+   * I/O, so this need not be DMA-capable memory.
+   */
+
+  fs->fs_cachebuf = fs_heap_malloc(CONFIG_FAT_CACHE_SECTORS *
+                                   fs->fs_hwsectorsize);
+  if (!fs->fs_cachebuf)
+    {
+      ret = -ENOMEM;
+      goto errout_with_buffer;
+    }
+
+  for (ndx = 0; ndx < CONFIG_FAT_CACHE_SECTORS; ndx++)
+    {
+      fs->fs_cache[ndx].sector = -1;
+    }
+#endif
+
   /* Search FAT boot record on the drive.  First check the MBR at sector
    * zero.  This could be either the boot record or a partition that refers
    * to the boot record.
@@ -626,6 +911,20 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
         }
     }
 
+#ifdef CONFIG_FAT_FREE_BITMAP
+  /* Allocate the free cluster bitmap.  It is filled in the first time that
+   * the free clusters are counted or searched.  Without it, the FAT on the
+   * media is searched instead.
+   */
+
+  fs->fs_freemap = fs_heap_malloc(FAT_FREEMAP_WORDS(fs) * sizeof(uint32_t));
+  fs->fs_freemapvalid = false;
+  if (fs->fs_freemap == NULL)
+    {
+      fwarn("WARNING: No memory for the free cluster bitmap\n");
+    }
+#endif
+
   /* Enforce computation of free clusters if configured */
 
 #ifdef CONFIG_FAT_COMPUTE_FSINFO
@@ -658,6 +957,14 @@ int fat_mount(struct fat_mountpt_s *fs, bool writeable)
   return OK;
 
 errout_with_buffer:
+#ifdef CONFIG_FAT_FREE_BITMAP
+  fs_heap_free(fs->fs_freemap);
+  fs->fs_freemap = NULL;
+#endif
+#if CONFIG_FAT_CACHE_SECTORS > 0
+  fs_heap_free(fs->fs_cachebuf);
+  fs->fs_cachebuf = NULL;
+#endif
   fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
   fs->fs_buffer = NULL;
 
@@ -772,12 +1079,46 @@ int fat_hwwrite(struct fat_mountpt_s *fs, uint8_t *buffer, off_t sector,
             {
               ret = nsectorswritten;
             }
+
+#if CONFIG_FAT_CACHE_SECTORS > 0
+          /* A failed write may still have changed some of the sectors */
+
+          fat_cacheupdate(fs, ret == OK ? buffer : NULL, sector, nsectors);
+#endif
         }
     }
 
   return ret;
 }
 
+/****************************************************************************
+ * Name: fat_hwtrim
+ *
+ * Description:
+ *   Tell the block driver that the specified sectors are no longer used.
+ *   This is only a hint, so errors are ignored.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_TRIM
+void fat_hwtrim(struct fat_mountpt_s *fs, off_t sector,
+                unsigned int nsectors)
+{
+  struct blk_trim_s trim;
+
+  if (fs && fs->fs_blkdriver)
+    {
+      struct inode *inode = fs->fs_blkdriver;
+      if (inode && inode->u.i_bops && inode->u.i_bops->ioctl)
+        {
+          trim.startsector = sector;
+          trim.nsectors    = nsectors;
+          inode->u.i_bops->ioctl(inode, BIOC_TRIM, (unsigned long)&trim);
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fat_cluster2sector
  *
@@ -1100,6 +1441,22 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
             return -EINVAL;
         }
 
+#ifdef CONFIG_FAT_FREE_BITMAP
+      /* Keep the free cluster bitmap in sync with the FAT */
+
+      if (fs->fs_freemap != NULL && clusterno >= 2)
+        {
+          if (nextcluster != 0)
+            {
+              fs->fs_freemap[clusterno >> 5] |= 1ul << (clusterno & 31);
+            }
+          else
+            {
+              fs->fs_freemap[clusterno >> 5] &= ~(1ul << (clusterno & 31));
+            }
+        }
+#endif
+
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
@@ -1120,6 +1477,10 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
 int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
 {
   int32_t nextcluster;
+#ifdef CONFIG_FAT_TRIM
+  uint32_t runstart = 0;
+  uint32_t runlength = 0;
+#endif
   int    ret;
 
   /* Loop while there are clusters in the chain */
@@ -1144,6 +1505,22 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
           return ret;
         }
 
+#ifdef CONFIG_FAT_TRIM
+      /* Trim runs of adjacent clusters with one request */
+
+      if (runlength > 0 && cluster != runstart + runlength)
+        {
+          fat_hwtrim(fs, fat_cluster2sector(fs, runstart),
+                     runlength * fs->fs_fatsecperclus);
+          runlength = 0;
+        }
+
+      if (runlength++ == 0)
+        {
+          runstart = cluster;
+        }
+#endif
+
       /* Update FSINFINFO data */
 
       if (fs->fs_fsifreecount != 0xffffffff)
@@ -1157,6 +1534,14 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
       cluster = nextcluster;
     }
 
+#ifdef CONFIG_FAT_TRIM
+  if (runlength > 0)
+    {
+      fat_hwtrim(fs, fat_cluster2sector(fs, runstart),
+                 runlength * fs->fs_fatsecperclus);
+    }
+#endif
+
   return OK;
 }
 
@@ -1226,66 +1611,20 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
-   */
+  /* Find a free cluster */
 
-  newcluster = startcluster;
-  for (; ; )
+  ret = fat_findfreecluster(fs, startcluster);
+  if (ret <= 0)
     {
-      /* Examine the next cluster in the FAT */
+      /* An error occurred or there is no free cluster */
 
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters + 2)
-        {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
-
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
-        }
-
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
-
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
-
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
-
-          return startsector;
-        }
-
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
-
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+      return ret;
     }
 
-  /* We get here only if we break out with an available cluster
-   * number in 'newcluster'  Now mark that cluster as in-use.
+  newcluster = ret;
+
+  /* We get here only if we found an available cluster number in
+   * 'newcluster'.  Now mark that cluster as in-use.
    */
 
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
@@ -1789,14 +2128,18 @@ int fat_fscacheflush(struct fat_mountpt_s *fs)
       if (fs->fs_currentsector >= fs->fs_fatbase &&
           fs->fs_currentsector < fs->fs_fatbase + fs->fs_nfatsects)
         {
+          off_t sector = fs->fs_currentsector;
           int i;
 
-          /* Yes, then make the change in the FAT copy as well */
+          /* Yes, then make the change in the FAT copy as well.
+           * fs_currentsector is left on the first FAT so that the next
+           * access to the same FAT sector is still served by fs_buffer.
+           */
 
           for (i = fs->fs_fatnumfats; i >= 2; i--)
             {
-              fs->fs_currentsector += fs->fs_nfatsects;
-              ret = fat_hwwrite(fs, fs->fs_buffer, fs->fs_currentsector, 1);
+              sector += fs->fs_nfatsects;
+              ret = fat_hwwrite(fs, fs->fs_buffer, sector, 1);
               if (ret < 0)
                 {
                   return ret;
@@ -1844,7 +2187,11 @@ int fat_fscacheread(struct fat_mountpt_s *fs, off_t sector)
 
       /* Then read the specified sector into the cache */
 
+#if CONFIG_FAT_CACHE_SECTORS > 0
+      ret = fat_cacheread(fs, sector);
+#else
       ret = fat_hwread(fs, fs->fs_buffer, sector, 1);
+#endif
       if (ret < 0)
         {
           return ret;
@@ -2038,27 +2385,55 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
   /* We have to count the number of free clusters */
 
   uint32_t nfreeclusters = 0;
+  uint32_t cluster;
+  uint32_t next;
+
+#ifdef CONFIG_FAT_FREE_BITMAP
+  /* Rebuild the free cluster bitmap while the FAT is scanned.  The two
+   * reserved FAT entries are never free.
+   */
+
+  if (fs->fs_freemap != NULL)
+    {
+      memset(fs->fs_freemap, 0, FAT_FREEMAP_WORDS(fs) * sizeof(uint32_t));
+      fs->fs_freemap[0]   = 3;
+      fs->fs_freemapvalid = false;
+    }
+#endif
+
   if (fs->fs_type == FSTYPE_FAT12)
     {
       off_t sector;
 
       /* Examine every cluster in the fat */
 
-      for (sector = 2; sector < fs->fs_nclusters + 2; sector++)
+      for (cluster = 2; cluster < fs->fs_nclusters + 2; cluster++)
         {
           /* If the cluster is unassigned, then increment the count of free
            * clusters
            */
 
-          if ((uint16_t)fat_getcluster(fs, sector) == 0)
+          sector = fat_getcluster(fs, cluster);
+          if (sector < 0)
+            {
+              return sector;
+            }
+
+          next = (uint32_t)sector;
+          if (next == 0)
             {
               nfreeclusters++;
             }
+#ifdef CONFIG_FAT_FREE_BITMAP
+          else if (fs->fs_freemap != NULL)
+            {
+              fs->fs_freemap[cluster >> 5] |= 1ul << (cluster & 31);
+            }
+#endif
         }
     }
   else
     {
-      unsigned int cluster;
       off_t        fatsector;
       unsigned int offset;
       int          ret;
@@ -2066,9 +2441,11 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
       fatsector    = fs->fs_fatbase;
       offset       = fs->fs_hwsectorsize;
 
-      /* Examine each cluster in the fat */
+      /* Examine each entry in the fat, starting with the two reserved
+       * entries that precede the first cluster.
+       */
 
-      for (cluster = fs->fs_nclusters; cluster > 0; cluster--)
+      for (cluster = 0; cluster < fs->fs_nclusters + 2; cluster++)
         {
           /* If we are starting a new sector, then read the new sector in
            * fs_buffer
@@ -2096,25 +2473,37 @@ int fat_computefreeclusters(struct fat_mountpt_s *fs)
 
           if (fs->fs_type == FSTYPE_FAT16)
             {
-              if (FAT_GETFAT16(fs->fs_buffer, offset) == 0)
-                {
-                  nfreeclusters++;
-                }
-
+              next    = FAT_GETFAT16(fs->fs_buffer, offset);
               offset += 2;
             }
           else
             {
-              if (FAT_GETFAT32(fs->fs_buffer, offset) == 0)
-                {
-                  nfreeclusters++;
-                }
-
+              next    = FAT_GETFAT32(fs->fs_buffer, offset) & 0x0fffffff;
               offset += 4;
             }
+
+          if (cluster < 2)
+            {
+              continue;
+            }
+
+          if (next == 0)
+            {
+              nfreeclusters++;
+            }
+#ifdef CONFIG_FAT_FREE_BITMAP
+          else if (fs->fs_freemap != NULL)
+            {
+              fs->fs_freemap[cluster >> 5] |= 1ul << (cluster & 31);
+            }
+#endif
         }
     }
 
+#ifdef CONFIG_FAT_FREE_BITMAP
+  fs->fs_freemapvalid = true;
+#endif
+
   fs->fs_fsifreecount = nfreeclusters;
   if (fs->fs_type == FSTYPE_FAT32)
     {
@@ -91,6 +91,14 @@ void fs_initialize(void)
 
   file_initlk();
 
+#ifdef CONFIG_FS_PAGECACHE
+  pagecache_initialize();
+#endif
+
+#ifdef CONFIG_FS_DCACHE
+  dcache_initialize();
+#endif
+
 #ifdef CONFIG_FS_AIO
   /* Initialize for asynchronous I/O */
 
@@ -0,0 +1,540 @@
+/****************************************************************************
+ * fs/inode/fs_dcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_DCACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A mountpoint whose lookups may be cached */
+
+struct dcache_mount_s
+{
+  struct list_node  dm_node;      /* In g_dcache_mounts */
+  FAR struct inode *dm_mountpt;   /* The mountpoint */
+  unsigned int      dm_gen;       /* Bumped when the volume changes */
+  bool              dm_cached;    /* Only changed through the VFS */
+};
+
+/* A cached lookup of a path relative to a mountpoint */
+
+struct dcache_entry_s
+{
+  struct list_node  de_hash;      /* In its hash bucket */
+  struct list_node  de_lru;       /* In g_dcache_lru, most recent first */
+  FAR struct dcache_mount_s *de_mount;
+  unsigned int      de_gen;       /* dm_gen when a positive entry was made */
+  bool              de_negative;  /* The path does not exist */
+  struct stat       de_stat;      /* The stat() result of a positive entry */
+  char              de_relpath[1];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static mutex_t g_dcache_lock = NXMUTEX_INITIALIZER;
+static struct list_node g_dcache_hash[CONFIG_FS_DCACHE_NENTRIES];
+static struct list_node g_dcache_lru = LIST_INITIAL_VALUE(g_dcache_lru);
+static struct list_node g_dcache_mounts =
+  LIST_INITIAL_VALUE(g_dcache_mounts);
+static unsigned int g_dcache_nentries;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dcache_canonical
+ *
+ * Description:
+ *   Only paths in canonical form are cached, so that each file has a
+ *   single key and invalidating the key invalidates every lookup of the
+ *   file: no empty, "." or ".." segments and no trailing '/'.
+ *
+ ****************************************************************************/
+
+static bool dcache_canonical(FAR const char *relpath)
+{
+  FAR const char *name = relpath;
+
+  if (*relpath == '\0')
+    {
+      return false;
+    }
+
+  for (; ; )
+    {
+      size_t len = strcspn(name, "/");
+
+      if (len == 0 || (name[0] == '.' &&
+          (len == 1 || (len == 2 && name[1] == '.'))))
+        {
+          return false;
+        }
+
+      if (name[len] == '\0')
+        {
+          return true;
+        }
+
+      name += len + 1;
+    }
+}
+
+/****************************************************************************
+ * Name: dcache_bucket
+ ****************************************************************************/
+
+static FAR struct list_node *dcache_bucket(FAR struct inode *mountpt,
+                                           FAR const char *relpath)
+{
+  uint32_t hash = (uint32_t)(uintptr_t)mountpt;
+
+  while (*relpath != '\0')
+    {
+      hash = hash * 31 + (uint8_t)*relpath++;
+    }
+
+  return &g_dcache_hash[hash % CONFIG_FS_DCACHE_NENTRIES];
+}
+
+/****************************************************************************
+ * Name: dcache_mount
+ *
+ * Description:
+ *   Find the mountpoint record, creating it if 'create'.  Only the file
+ *   systems on local media, whose directories cannot change behind the
+ *   back of the VFS, are cached.
+ *
+ ****************************************************************************/
+
+static FAR struct dcache_mount_s *dcache_mount(FAR struct inode *mountpt,
+                                               bool create)
+{
+  FAR struct dcache_mount_s *dm;
+  struct statfs buf;
+
+  list_for_every_entry(&g_dcache_mounts, dm, struct dcache_mount_s,
+                       dm_node)
+    {
+      if (dm->dm_mountpt == mountpt)
+        {
+          return dm;
+        }
+    }
+
+  if (!create)
+    {
+      return NULL;
+    }
+
+  dm = fs_heap_zalloc(sizeof(struct dcache_mount_s));
+  if (dm == NULL)
+    {
+      return NULL;
+    }
+
+  dm->dm_mountpt = mountpt;
+  if (mountpt->u.i_mops->statfs != NULL &&
+      mountpt->u.i_mops->statfs(mountpt, &buf) >= 0)
+    {
+      switch (buf.f_type)
+        {
+          case MSDOS_SUPER_MAGIC:
+          case LITTLEFS_SUPER_MAGIC:
+          case MNEMOFS_SUPER_MAGIC:
+          case ROMFS_MAGIC:
+          case SMARTFS_MAGIC:
+            dm->dm_cached = true;
+            break;
+
+          default:
+            break;
+        }
+    }
+
+  list_add_tail(&g_dcache_mounts, &dm->dm_node);
+  return dm;
+}
+
+/****************************************************************************
+ * Name: dcache_find
+ ****************************************************************************/
+
+static FAR struct dcache_entry_s *dcache_find(FAR struct dcache_mount_s *dm,
+                                              FAR const char *relpath)
+{
+  FAR struct list_node *bucket = dcache_bucket(dm->dm_mountpt, relpath);
+  FAR struct dcache_entry_s *entry;
+
+  list_for_every_entry(bucket, entry, struct dcache_entry_s, de_hash)
+    {
+      if (entry->de_mount == dm && strcmp(entry->de_relpath, relpath) == 0)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: dcache_free
+ ****************************************************************************/
+
+static void dcache_free(FAR struct dcache_entry_s *entry)
+{
+  list_delete(&entry->de_hash);
+  list_delete(&entry->de_lru);
+  g_dcache_nentries--;
+  fs_heap_free(entry);
+}
+
+/****************************************************************************
+ * Name: dcache_covers
+ *
+ * Description:
+ *   Return true if 'relpath' is 'name' or lies below it.  The comparison
+ *   ignores case, since some of the cached file systems do.
+ *
+ ****************************************************************************/
+
+static bool dcache_covers(FAR const char *name, size_t len,
+                          FAR const char *relpath)
+{
+  return strncasecmp(relpath, name, len) == 0 &&
+         (relpath[len] == '\0' || relpath[len] == '/');
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dcache_initialize
+ *
+ * Description:
+ *   Initialize the lookup cache.
+ *
+ ****************************************************************************/
+
+void dcache_initialize(void)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_DCACHE_NENTRIES; i++)
+    {
+      list_initialize(&g_dcache_hash[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: dcache_lookup
+ *
+ * Description:
+ *   Look up a path relative to a mountpoint in the cache.
+ *
+ * Input Parameters:
+ *   mountpt - The mountpoint inode
+ *   relpath - The path relative to the mountpoint
+ *   buf     - Receives the cached stat() result, may be NULL
+ *   gen     - Receives the generation to pass to dcache_enter() on a miss
+ *
+ * Returned Value:
+ *   OK if the path is known to exist, -ENOENT if it is known not to exist
+ *   and -ENOSYS if the cache cannot tell, e.g. on remote file systems.
+ *
+ ****************************************************************************/
+
+int dcache_lookup(FAR struct inode *mountpt, FAR const char *relpath,
+                  FAR struct stat *buf, FAR unsigned int *gen)
+{
+  FAR struct dcache_entry_s *entry;
+  FAR struct dcache_mount_s *dm;
+  int ret = -ENOSYS;
+
+  *gen = 0;
+  if (!dcache_canonical(relpath) || nxmutex_lock(&g_dcache_lock) < 0)
+    {
+      return ret;
+    }
+
+  dm = dcache_mount(mountpt, true);
+  if (dm == NULL || !dm->dm_cached)
+    {
+      goto out;
+    }
+
+  *gen  = dm->dm_gen;
+  entry = dcache_find(dm, relpath);
+  if (entry == NULL)
+    {
+      goto out;
+    }
+
+  /* A positive entry is stale as soon as anything changed on the volume,
+   * since the size and times of its file may have changed.
+   */
+
+  if (entry->de_negative)
+    {
+      ret = -ENOENT;
+    }
+  else if (entry->de_gen == dm->dm_gen)
+    {
+      if (buf != NULL)
+        {
+          memcpy(buf, &entry->de_stat, sizeof(struct stat));
+        }
+
+      ret = OK;
+    }
+  else
+    {
+      dcache_free(entry);
+      goto out;
+    }
+
+  list_delete(&entry->de_lru);
+  list_add_head(&g_dcache_lru, &entry->de_lru);
+
+out:
+  nxmutex_unlock(&g_dcache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: dcache_enter
+ *
+ * Description:
+ *   Cache the result of a lookup that missed the cache.  The entry is not
+ *   made if the volume changed since the lookup, as the result may already
+ *   be stale.
+ *
+ * Input Parameters:
+ *   mountpt - The mountpoint inode
+ *   relpath - The path relative to the mountpoint
+ *   buf     - The stat() result, or NULL if the path does not exist
+ *   gen     - The generation returned by dcache_lookup()
+ *
+ ****************************************************************************/
+
+void dcache_enter(FAR struct inode *mountpt, FAR const char *relpath,
+                  FAR const struct stat *buf, unsigned int gen)
+{
+  FAR struct dcache_entry_s *entry;
+  FAR struct dcache_mount_s *dm;
+  size_t len;
+
+  if (!dcache_canonical(relpath) || nxmutex_lock(&g_dcache_lock) < 0)
+    {
+      return;
+    }
+
+  dm = dcache_mount(mountpt, false);
+  if (dm == NULL || !dm->dm_cached || dm->dm_gen != gen)
+    {
+      goto out;
+    }
+
+  entry = dcache_find(dm, relpath);
+  if (entry != NULL)
+    {
+      dcache_free(entry);
+    }
+
+  /* Recycle the least recently used entry when the cache is full */
+
+  if (g_dcache_nentries >= CONFIG_FS_DCACHE_NENTRIES)
+    {
+      dcache_free(list_last_entry(&g_dcache_lru, struct dcache_entry_s,
+                                  de_lru));
+    }
+
+  len   = strlen(relpath);
+  entry = fs_heap_malloc(sizeof(struct dcache_entry_s) + len);
+  if (entry == NULL)
+    {
+      goto out;
+    }
+
+  entry->de_mount    = dm;
+  entry->de_gen      = gen;
+  entry->de_negative = buf == NULL;
+  if (buf != NULL)
+    {
+      memcpy(&entry->de_stat, buf, sizeof(struct stat));
+    }
+
+  memcpy(entry->de_relpath, relpath, len + 1);
+  list_add_head(dcache_bucket(mountpt, relpath), &entry->de_hash);
+  list_add_head(&g_dcache_lru, &entry->de_lru);
+  g_dcache_nentries++;
+
+out:
+  nxmutex_unlock(&g_dcache_lock);
+}
+
+/****************************************************************************
+ * Name: dcache_open
+ *
+ * Description:
+ *   Update the cache after a file system open() that missed the cache:
+ *   creating or truncating a file invalidates its path, and a failure
+ *   with -ENOENT is cached.
+ *
+ ****************************************************************************/
+
+void dcache_open(FAR struct inode *mountpt, FAR const char *relpath,
+                 int oflags, int result, unsigned int gen)
+{
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      dcache_invalidate(mountpt, relpath);
+    }
+  else if (result == -ENOENT)
+    {
+      dcache_enter(mountpt, relpath, NULL, gen);
+    }
+}
+
+/****************************************************************************
+ * Name: dcache_invalidate
+ *
+ * Description:
+ *   Forget a path and everything below it, after it has been created,
+ *   removed or renamed.
+ *
+ ****************************************************************************/
+
+void dcache_invalidate(FAR struct inode *mountpt, FAR const char *relpath)
+{
+  FAR struct dcache_entry_s *entry;
+  FAR struct dcache_entry_s *tmp;
+  FAR struct dcache_mount_s *dm;
+  size_t len = strlen(relpath);
+
+  while (len > 0 && relpath[len - 1] == '/')
+    {
+      len--;
+    }
+
+  nxmutex_lock(&g_dcache_lock);
+
+  dm = dcache_mount(mountpt, false);
+  if (dm != NULL)
+    {
+      dm->dm_gen++;
+      list_for_every_entry_safe(&g_dcache_lru, entry, tmp,
+                                struct dcache_entry_s, de_lru)
+        {
+          if (entry->de_mount == dm &&
+              (len == 0 || dcache_covers(relpath, len, entry->de_relpath)))
+            {
+              dcache_free(entry);
+            }
+        }
+    }
+
+  nxmutex_unlock(&g_dcache_lock);
+}
+
+/****************************************************************************
+ * Name: dcache_modified
+ *
+ * Description:
+ *   Invalidate the positive entries of a mountpoint after one of its files
+ *   has been written, truncated, synced or had its attributes changed.
+ *
+ ****************************************************************************/
+
+void dcache_modified(FAR struct inode *mountpt)
+{
+  FAR struct dcache_mount_s *dm;
+
+  nxmutex_lock(&g_dcache_lock);
+
+  dm = dcache_mount(mountpt, false);
+  if (dm != NULL)
+    {
+      dm->dm_gen++;
+    }
+
+  nxmutex_unlock(&g_dcache_lock);
+}
+
+/****************************************************************************
+ * Name: dcache_umount
+ *
+ * Description:
+ *   Forget everything about a mountpoint that is being unmounted.
+ *
+ ****************************************************************************/
+
+void dcache_umount(FAR struct inode *mountpt)
+{
+  FAR struct dcache_entry_s *entry;
+  FAR struct dcache_entry_s *tmp;
+  FAR struct dcache_mount_s *dm;
+
+  nxmutex_lock(&g_dcache_lock);
+
+  dm = dcache_mount(mountpt, false);
+  if (dm != NULL)
+    {
+      list_for_every_entry_safe(&g_dcache_lru, entry, tmp,
+                                struct dcache_entry_s, de_lru)
+        {
+          if (entry->de_mount == dm)
+            {
+              dcache_free(entry);
+            }
+        }
+
+      list_delete(&dm->dm_node);
+      fs_heap_free(dm);
+    }
+
+  nxmutex_unlock(&g_dcache_lock);
+}
+
+#endif /* CONFIG_FS_DCACHE */
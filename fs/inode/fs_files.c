@@ -54,12 +54,87 @@
 #include "inode/inode.h"
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The alignment of the per-CPU lookup flags */
+
+#ifndef FDLIST_READER_ALIGN
+#  define FDLIST_READER_ALIGN 64
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+/* Set while a CPU reads a file descriptor list without holding its lock.
+ * Each flag has its own cache line, so the lookups on different CPUs do
+ * not share any written memory when they use different files.
+ */
+
+struct fdlist_reader_s
+{
+  atomic_t active aligned_data(FDLIST_READER_ALIGN);
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static struct fdlist_reader_s g_fdlist_readers[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: fdlist_synchronize
+ *
+ * Description:
+ *   Wait until no CPU is within a lock-free lookup that may have started
+ *   before the caller changed a file descriptor list.  After it returns,
+ *   the file removed from the list and any obsolete array of rows are
+ *   no longer referenced by a lookup, unless the lookup took its own
+ *   reference to the file.
+ *
+ ****************************************************************************/
+
+static void fdlist_synchronize(void)
+{
+#ifdef CONFIG_SMP
+  int cpu;
+
+  /* Order the update of the list before the reads of the flags.  The
+   * lookup orders the write of its flag before the read of the list in
+   * the same way, so at least one of the two sees the other.
+   */
+
+  UP_DMB();
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      while (atomic_read_acquire(&g_fdlist_readers[cpu].active) != 0)
+        {
+          /* The lookup runs with interrupts disabled and is short */
+        }
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: fdlist_get_by_index
+ *
+ * Description:
+ *   Return the file at a row and column of the list with a reference
+ *   taken.  This does not take the list lock: the installed file holds a
+ *   reference of the list which is only dropped after
+ *   fdlist_synchronize(), so the count cannot reach zero under the lookup.
+ *
  ****************************************************************************/
 
 static void fdlist_get_by_index(FAR struct fdlist *list,
@@ -69,8 +144,18 @@ static void fdlist_get_by_index(FAR struct fdlist *list,
 {
   FAR struct fd *fdp1;
   irqstate_t flags;
+#ifdef CONFIG_SMP
+  FAR atomic_t *active;
+#endif
+
+  flags = up_irq_save();
+
+#ifdef CONFIG_SMP
+  active = &g_fdlist_readers[this_cpu()].active;
+  atomic_set(active, 1);
+  UP_DMB();
+#endif
 
-  flags = spin_lock_irqsave_notrace(&list->fl_lock);
   fdp1 = &list->fl_fds[l1][l2];
   *filep = fdp1->f_file;
   if (*filep != NULL)
@@ -78,7 +163,11 @@ static void fdlist_get_by_index(FAR struct fdlist *list,
       atomic_fetch_add(&(*filep)->f_refs, 1);
     }
 
-  spin_unlock_irqrestore_notrace(&list->fl_lock, flags);
+#ifdef CONFIG_SMP
+  atomic_set_release(active, 0);
+#endif
+
+  up_irq_restore(flags);
   if (fdp != NULL)
     {
       *fdp = fdp1;
@@ -161,14 +250,20 @@ static int fdlist_extend(FAR struct fdlist *list, size_t row)
       memcpy(fds, list->fl_fds, list->fl_rows * sizeof(FAR struct fd *));
     }
 
+  /* The lock-free lookup reads fl_rows before fl_fds, so the new array
+   * must be visible before the new number of rows.
+   */
+
   tmp = list->fl_fds;
   list->fl_fds = fds;
+  UP_DMB();
   list->fl_rows = row;
 
   spin_unlock_irqrestore_notrace(&list->fl_lock, flags);
 
   if (tmp != NULL && tmp != &list->fl_prefd)
     {
+      fdlist_synchronize();
       fs_heap_free(tmp);
     }
 
@@ -199,7 +294,12 @@ static void fdlist_uninstall(FAR struct fdlist *list, FAR struct fd *fdp)
     }
 
   spin_unlock_irqrestore_notrace(&list->fl_lock, flags);
-  file_put(filep);
+
+  if (filep != NULL)
+    {
+      fdlist_synchronize();
+      file_put(filep);
+    }
 }
 
 static void fdlist_install(FAR struct fdlist *list, int fd,
@@ -234,7 +334,12 @@ static void fdlist_install(FAR struct fdlist *list, int fd,
     }
 
   spin_unlock_irqrestore_notrace(&list->fl_lock, flags);
-  file_put(filep1);
+
+  if (filep1 != NULL)
+    {
+      fdlist_synchronize();
+      file_put(filep1);
+    }
 }
 
 /****************************************************************************
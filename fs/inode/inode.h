@@ -463,6 +463,32 @@ int pseudofile_create(FAR struct inode **node, FAR const char *path,
 bool inode_is_pseudofile(FAR struct inode *inode);
 #endif
 
+/****************************************************************************
+ * Name: dcache_*
+ *
+ * Description:
+ *   The lookup cache of the paths below the mountpoints, see fs_dcache.c.
+ *   dcache_lookup() returns OK if the path is known to exist, -ENOENT if it
+ *   is known not to exist and -ENOSYS if it is not cached; on a miss, the
+ *   result of the file system lookup is cached with dcache_enter() or
+ *   dcache_open().  The other functions keep the cache coherent with the
+ *   changes made through the VFS.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_DCACHE
+void dcache_initialize(void);
+int dcache_lookup(FAR struct inode *mountpt, FAR const char *relpath,
+                  FAR struct stat *buf, FAR unsigned int *gen);
+void dcache_enter(FAR struct inode *mountpt, FAR const char *relpath,
+                  FAR const struct stat *buf, unsigned int gen);
+void dcache_open(FAR struct inode *mountpt, FAR const char *relpath,
+                 int oflags, int result, unsigned int gen);
+void dcache_invalidate(FAR struct inode *mountpt, FAR const char *relpath);
+void dcache_modified(FAR struct inode *mountpt);
+void dcache_umount(FAR struct inode *mountpt);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
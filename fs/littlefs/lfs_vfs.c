@@ -35,6 +35,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
 
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -81,6 +82,11 @@ struct littlefs_mountpt_s
   struct lfs_config     cfg;
   struct lfs            lfs;
   bool                  readonly;
+  bool                  sizevalid; /* size holds the used block count */
+  lfs_size_t            size;
+#ifdef CONFIG_FS_LITTLEFS_PRESCAN
+  struct work_s         work;      /* Background lookahead scan */
+#endif
 };
 
 /* NuttX specific file attributes.
@@ -1181,6 +1187,92 @@ static int littlefs_read_block(FAR const struct lfs_config *c,
   return ret >= 0 ? OK : ret;
 }
 
+/****************************************************************************
+ * Name: littlefs_prescan_cb
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_LITTLEFS_PRESCAN
+static int littlefs_prescan_cb(FAR void *data, lfs_block_t block)
+{
+  FAR struct littlefs_mountpt_s *fs = data;
+  FAR struct lfs *lfs = &fs->lfs;
+  lfs_block_t off;
+
+  /* Mark the block in the lookahead window the way lfs_alloc() does */
+
+  off = (block - lfs->free.off + fs->cfg.block_count) % fs->cfg.block_count;
+  if (off < lfs->free.size)
+    {
+      lfs->free.buffer[off / 32] |= 1u << (off % 32);
+    }
+
+  fs->size++;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: littlefs_prescan
+ *
+ * Description:
+ *   Do the traversal that the next allocation would need ahead of time:
+ *   if the lookahead window is used up, move it forward and fill it just
+ *   like lfs_alloc() does, so that lfs_alloc() finds free blocks without
+ *   traversing the file system.  The number of blocks in use is counted
+ *   on the way for statfs().
+ *
+ ****************************************************************************/
+
+static void littlefs_prescan(FAR void *arg)
+{
+  FAR struct littlefs_mountpt_s *fs = arg;
+  FAR struct lfs *lfs = &fs->lfs;
+  bool refill;
+  int ret;
+
+  if (nxmutex_lock(&fs->lock) < 0)
+    {
+      return;
+    }
+
+  refill = !fs->readonly && lfs->free.i == lfs->free.size &&
+           lfs->free.ack > 0;
+  if (refill)
+    {
+      lfs->free.off  = (lfs->free.off + lfs->free.size) %
+                       fs->cfg.block_count;
+      lfs->free.size = lfs_min(8 * fs->cfg.lookahead_size, lfs->free.ack);
+      lfs->free.i    = 0;
+      memset(lfs->free.buffer, 0, fs->cfg.lookahead_size);
+    }
+  else if (fs->sizevalid)
+    {
+      nxmutex_unlock(&fs->lock);
+      return;
+    }
+
+  fs->size = 0;
+  ret = lfs_fs_traverse(lfs, littlefs_prescan_cb, fs);
+  if (ret < 0)
+    {
+      /* Leave the window to lfs_alloc() again */
+
+      if (refill)
+        {
+          lfs->free.size = 0;
+          lfs->free.i    = 0;
+        }
+
+      fs->sizevalid = false;
+    }
+  else
+    {
+      fs->sizevalid = true;
+    }
+
+  nxmutex_unlock(&fs->lock);
+}
+#endif
+
 /****************************************************************************
  * Name: littlefs_write_block
  ****************************************************************************/
@@ -1199,6 +1291,18 @@ static int littlefs_write_block(FAR const struct lfs_config *c,
       return -EROFS;
     }
 
+  /* Any write may change the number of blocks in use */
+
+  fs->sizevalid = false;
+
+#ifdef CONFIG_FS_LITTLEFS_PRESCAN
+  if (fs->lfs.free.i == fs->lfs.free.size && work_available(&fs->work))
+    {
+      work_queue(LPWORK, &fs->work, littlefs_prescan, fs,
+                 MSEC2TICK(CONFIG_FS_LITTLEFS_PRESCAN_DELAY));
+    }
+#endif
+
   block = (block * c->block_size + off) / geo->blocksize;
   size  = size / geo->blocksize;
 
@@ -1440,6 +1544,11 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
         }
     }
 
+#ifdef CONFIG_FS_LITTLEFS_PRESCAN
+  work_queue(LPWORK, &fs->work, littlefs_prescan, fs,
+             MSEC2TICK(CONFIG_FS_LITTLEFS_PRESCAN_DELAY));
+#endif
+
   *handle = fs;
   return OK;
 
@@ -1470,6 +1579,10 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
   FAR struct inode *drv = fs->drv;
   int ret;
 
+#ifdef CONFIG_FS_LITTLEFS_PRESCAN
+  work_cancel_sync(LPWORK, &fs->work);
+#endif
+
   /* Unmount */
 
   ret = nxmutex_lock(&fs->lock);
@@ -1541,7 +1654,22 @@ static int littlefs_statfs(FAR struct inode *mountpt, FAR struct statfs *buf)
       return ret;
     }
 
-  ret = littlefs_convert_result(lfs_fs_size(&fs->lfs));
+  /* The traversal of lfs_fs_size() is only needed after a write */
+
+  if (fs->sizevalid)
+    {
+      ret = fs->size;
+    }
+  else
+    {
+      ret = littlefs_convert_result(lfs_fs_size(&fs->lfs));
+      if (ret >= 0)
+        {
+          fs->size      = ret;
+          fs->sizevalid = true;
+        }
+    }
+
   if (ret > 0)
     {
       /* Clamp to prevent underflow - lfs_fs_size can return more than
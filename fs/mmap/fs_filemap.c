@@ -0,0 +1,817 @@
+/****************************************************************************
+ * fs/mmap/fs_filemap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mman.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mutex.h>
+#include <nuttx/pgalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/fs.h>
+
+#include "sched/sched.h"
+#include "fs_filemap.h"
+#include "fs_heap.h"
+
+#ifdef CONFIG_FS_FILEMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Besides the physical page address, which is always page aligned, an
+ * entry of fm_pages[] may hold one of these values.
+ */
+
+#define FILEMAP_NONE         ((uintptr_t)0) /* Not read yet */
+#define FILEMAP_PENDING      ((uintptr_t)1) /* Queued for reading */
+#define FILEMAP_ERROR        ((uintptr_t)2) /* Reading failed */
+
+#define FILEMAP_RESIDENT(p)  ((p) > FILEMAP_ERROR)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The pages of a mapped file, shared by all the mappings of the file */
+
+struct filemap_s
+{
+  FAR struct filemap_s *fm_flink;  /* Next mapped file */
+  FAR void *fm_pcache;             /* Page cache file, identifies the file */
+  struct file fm_file;             /* Private open file used for the I/O */
+  off_t fm_size;                   /* Size of the file when mapped */
+  unsigned int fm_npages;          /* Number of entries in fm_pages */
+  FAR uintptr_t *fm_pages;         /* The physical page of each file page */
+  unsigned int fm_nmaps;           /* Number of mappings of the file */
+  bool fm_writable;                /* A shared writable mapping exists */
+};
+
+/* One mapping of a file into the address space of a process */
+
+struct filemap_vma_s
+{
+  FAR struct filemap_vma_s *vm_flink;
+  FAR struct task_group_s *vm_group; /* The process of the mapping */
+  uintptr_t vm_vaddr;                /* First mapped virtual address */
+  size_t vm_length;                  /* Length of the region, page aligned */
+  unsigned int vm_pgoff;             /* File page mapped at vm_vaddr */
+  FAR struct filemap_s *vm_map;      /* The mapped file */
+};
+
+/* A task that is stopped until a page is read */
+
+struct filemap_wait_s
+{
+  FAR struct filemap_s *fw_map;    /* The mapped file */
+  unsigned int fw_pgoff;           /* The page being read */
+  pid_t fw_pid;                    /* The stopped task, 0 if unused */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* g_filemap_lock serializes mmap(), munmap(), msync() and the worker, and
+ * protects the list of mapped files.  The mappings, the waits and the
+ * entries of fm_pages[] are also used by the page fault handler, and are
+ * protected by a critical section instead.
+ */
+
+static mutex_t g_filemap_lock = NXMUTEX_INITIALIZER;
+static FAR struct filemap_s *g_filemap_files;
+static FAR struct filemap_vma_s *g_filemap_vmas;
+static struct filemap_wait_s g_filemap_waits[CONFIG_FS_FILEMAP_NWAITS];
+static struct work_s g_filemap_work;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: filemap_fill
+ *
+ * Description:
+ *   Allocate a physical page and read a page of the file into it.  The
+ *   part of the page beyond the end of the file is zeroed.
+ *
+ ****************************************************************************/
+
+static uintptr_t filemap_fill(FAR struct filemap_s *fm, unsigned int pgoff)
+{
+  FAR uint8_t *kaddr;
+  uintptr_t page;
+  ssize_t nread;
+  size_t length;
+  size_t done = 0;
+  off_t offset;
+
+  page = mm_pgalloc(1);
+  if (page == 0)
+    {
+      ferr("ERROR: Out of pages\n");
+      return FILEMAP_ERROR;
+    }
+
+  kaddr  = (FAR uint8_t *)up_addrenv_page_vaddr(page);
+  offset = (off_t)pgoff << MM_PGSHIFT;
+  length = MIN(fm->fm_size - offset, MM_PGSIZE);
+
+  while (done < length)
+    {
+      nread = file_pread(&fm->fm_file, kaddr + done, length - done,
+                         offset + done);
+      if (nread == -EINTR)
+        {
+          continue;
+        }
+      else if (nread < 0)
+        {
+          ferr("ERROR: Read failed: offset=%" PRIdOFF " ret=%zd\n",
+               offset, nread);
+          mm_pgfree(page, 1);
+          return FILEMAP_ERROR;
+        }
+      else if (nread == 0)
+        {
+          break;
+        }
+
+      done += nread;
+    }
+
+  memset(kaddr + done, 0, MM_PGSIZE - done);
+  return page;
+}
+
+/****************************************************************************
+ * Name: filemap_writeback
+ *
+ * Description:
+ *   Write the resident pages from 'first' up to 'last' back to the file.
+ *   The file is not extended beyond the size that it had when mapped.
+ *
+ ****************************************************************************/
+
+static int filemap_writeback(FAR struct filemap_s *fm, unsigned int first,
+                             unsigned int last)
+{
+  FAR const uint8_t *kaddr;
+  unsigned int pgoff;
+  uintptr_t page;
+  ssize_t nwritten;
+  size_t length;
+  size_t done;
+  off_t offset;
+  int ret = OK;
+
+  if ((fm->fm_file.f_oflags & O_WROK) == 0)
+    {
+      return OK;
+    }
+
+  for (pgoff = first; pgoff < MIN(last, fm->fm_npages); pgoff++)
+    {
+      page = fm->fm_pages[pgoff];
+      if (!FILEMAP_RESIDENT(page))
+        {
+          continue;
+        }
+
+      kaddr  = (FAR const uint8_t *)up_addrenv_page_vaddr(page);
+      offset = (off_t)pgoff << MM_PGSHIFT;
+      length = MIN(fm->fm_size - offset, MM_PGSIZE);
+
+      for (done = 0; done < length; done += nwritten)
+        {
+          nwritten = file_pwrite(&fm->fm_file, kaddr + done, length - done,
+                                 offset + done);
+          if (nwritten == -EINTR)
+            {
+              nwritten = 0;
+            }
+          else if (nwritten <= 0)
+            {
+              ferr("ERROR: Write failed: offset=%" PRIdOFF " ret=%zd\n",
+                   offset, nwritten);
+              ret = nwritten < 0 ? nwritten : -EIO;
+              break;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: filemap_wakeup
+ *
+ * Description:
+ *   Release a wait and let its task run again.  The task retries the
+ *   faulting access, which either finds the page or faults again.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void filemap_wakeup(FAR struct filemap_wait_s *wait)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  FAR struct tcb_s *tcb;
+
+  tcb = nxsched_get_tcb(wait->fw_pid);
+  wait->fw_pid = 0;
+
+  if (tcb != NULL && tcb->task_state == TSTATE_TASK_STOPPED)
+    {
+      dq_rem((FAR dq_entry_t *)tcb, list_stoppedtasks());
+      if (nxsched_add_readytorun(tcb))
+        {
+          up_switch_context(this_task(), rtcb);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: filemap_worker
+ *
+ * Description:
+ *   Read the pages that the stopped tasks are waiting for, and restart the
+ *   tasks.
+ *
+ ****************************************************************************/
+
+static void filemap_worker(FAR void *arg)
+{
+  FAR struct filemap_wait_s *wait;
+  FAR struct filemap_s *fm;
+  irqstate_t flags;
+  unsigned int pgoff;
+  uintptr_t page;
+  int i;
+
+  nxmutex_lock(&g_filemap_lock);
+
+  for (i = 0; i < CONFIG_FS_FILEMAP_NWAITS; i++)
+    {
+      wait  = &g_filemap_waits[i];
+      flags = enter_critical_section();
+      if (wait->fw_pid == 0)
+        {
+          leave_critical_section(flags);
+          continue;
+        }
+
+      fm    = wait->fw_map;
+      pgoff = wait->fw_pgoff;
+      page  = fm->fm_pages[pgoff];
+      leave_critical_section(flags);
+
+      /* Several tasks may wait for the same page, only the first wait
+       * reads it.
+       */
+
+      if (page == FILEMAP_PENDING)
+        {
+          page = filemap_fill(fm, pgoff);
+        }
+
+      flags = enter_critical_section();
+      fm->fm_pages[pgoff] = page;
+      filemap_wakeup(wait);
+      leave_critical_section(flags);
+    }
+
+  nxmutex_unlock(&g_filemap_lock);
+}
+
+/****************************************************************************
+ * Name: filemap_release
+ *
+ * Description:
+ *   Drop a mapping of the file.  When the last one goes, the pages are
+ *   written back if there was a shared writable mapping, and freed.
+ *
+ * Assumptions:
+ *   g_filemap_lock is held.
+ *
+ ****************************************************************************/
+
+static void filemap_release(FAR struct filemap_s *fm)
+{
+  FAR struct filemap_s **prev;
+  irqstate_t flags;
+  unsigned int pgoff;
+  int i;
+
+  DEBUGASSERT(fm->fm_nmaps > 0);
+  if (--fm->fm_nmaps > 0)
+    {
+      return;
+    }
+
+  if (fm->fm_writable)
+    {
+      filemap_writeback(fm, 0, fm->fm_npages);
+    }
+
+  /* Restart any task still waiting, it faults again on an unmapped
+   * address.
+   */
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_FS_FILEMAP_NWAITS; i++)
+    {
+      if (g_filemap_waits[i].fw_pid != 0 &&
+          g_filemap_waits[i].fw_map == fm)
+        {
+          filemap_wakeup(&g_filemap_waits[i]);
+        }
+    }
+
+  leave_critical_section(flags);
+
+  for (prev = &g_filemap_files; *prev != fm; prev = &(*prev)->fm_flink);
+  *prev = fm->fm_flink;
+
+  for (pgoff = 0; pgoff < fm->fm_npages; pgoff++)
+    {
+      if (FILEMAP_RESIDENT(fm->fm_pages[pgoff]))
+        {
+          mm_pgfree(fm->fm_pages[pgoff], 1);
+        }
+    }
+
+  file_close(&fm->fm_file);
+  fs_heap_free(fm->fm_pages);
+  fs_heap_free(fm);
+}
+
+/****************************************************************************
+ * Name: filemap_get
+ *
+ * Description:
+ *   Find or create the mapped file of an open file, covering at least
+ *   'size' bytes of the file.
+ *
+ * Assumptions:
+ *   g_filemap_lock is held.
+ *
+ ****************************************************************************/
+
+static int filemap_get(FAR struct file *filep, off_t size, bool writable,
+                       FAR struct filemap_s **map)
+{
+  FAR struct filemap_s *fm;
+  FAR uintptr_t *pages;
+  FAR uintptr_t *old;
+  struct file file;
+  irqstate_t flags;
+  unsigned int npages;
+  int ret;
+
+  for (fm = g_filemap_files; fm != NULL; fm = fm->fm_flink)
+    {
+      if (fm->fm_pcache == filep->f_pcache)
+        {
+          break;
+        }
+    }
+
+  if (fm == NULL)
+    {
+      fm = fs_heap_zalloc(sizeof(struct filemap_s));
+      if (fm == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      ret = file_dup2(filep, &fm->fm_file);
+      if (ret < 0)
+        {
+          fs_heap_free(fm);
+          return ret;
+        }
+
+      fm->fm_pcache   = filep->f_pcache;
+      fm->fm_flink    = g_filemap_files;
+      g_filemap_files = fm;
+    }
+
+  /* The file may have grown since it was first mapped */
+
+  npages = MM_NPAGES(size);
+  if (npages > fm->fm_npages)
+    {
+      pages = fs_heap_zalloc(npages * sizeof(uintptr_t));
+      if (pages == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      flags = enter_critical_section();
+      if (fm->fm_pages != NULL)
+        {
+          memcpy(pages, fm->fm_pages, fm->fm_npages * sizeof(uintptr_t));
+        }
+
+      old           = fm->fm_pages;
+      fm->fm_pages  = pages;
+      fm->fm_npages = npages;
+      leave_critical_section(flags);
+
+      fs_heap_free(old);
+    }
+
+  fm->fm_size = MAX(fm->fm_size, size);
+
+  /* Writing the pages back needs an open file with write access */
+
+  if (writable && (fm->fm_file.f_oflags & O_WROK) == 0)
+    {
+      memset(&file, 0, sizeof(file));
+      ret = file_dup2(filep, &file);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      file_close(&fm->fm_file);
+      memcpy(&fm->fm_file, &file, sizeof(file));
+    }
+
+  fm->fm_writable |= writable;
+  fm->fm_nmaps++;
+  *map = fm;
+  return OK;
+
+errout:
+  fm->fm_nmaps++;
+  filemap_release(fm);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: filemap_msync
+ ****************************************************************************/
+
+static int filemap_msync(FAR struct mm_map_entry_s *entry, FAR void *start,
+                         size_t length, int flags)
+{
+  FAR struct filemap_vma_s *vma = entry->priv.p;
+  FAR struct filemap_s *fm = vma->vm_map;
+  size_t offset;
+  int ret;
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (length > entry->length - offset)
+    {
+      length = entry->length - offset;
+    }
+
+  ret = nxmutex_lock(&g_filemap_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = filemap_writeback(fm, vma->vm_pgoff + (offset >> MM_PGSHIFT),
+                          vma->vm_pgoff + MM_NPAGES(offset + length));
+  if (ret >= 0 && (flags & MS_SYNC) != 0 &&
+      (fm->fm_file.f_oflags & O_WROK) != 0)
+    {
+      ret = file_fsync(&fm->fm_file);
+    }
+
+  nxmutex_unlock(&g_filemap_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: filemap_munmap
+ ****************************************************************************/
+
+static int filemap_munmap(FAR struct task_group_s *group,
+                          FAR struct mm_map_entry_s *entry,
+                          FAR void *start, size_t length)
+{
+  FAR struct filemap_vma_s *vma = entry->priv.p;
+  irqstate_t flags;
+  size_t offset;
+  size_t newlen;
+  int ret = OK;
+
+  /* As with rammap(), only the end of a mapping can be unmapped */
+
+  offset = (uintptr_t)start - (uintptr_t)entry->vaddr;
+  if (offset + length < entry->length)
+    {
+      ferr("ERROR: Cannot umap without unmapping to the end\n");
+      return -ENOSYS;
+    }
+
+  newlen = MM_PGALIGNUP(offset);
+  nxmutex_lock(&g_filemap_lock);
+
+  /* Without a group the process is being deleted, and its address
+   * environment goes away with it.
+   */
+
+  if (group != NULL && newlen < vma->vm_length)
+    {
+      up_shmdt(vma->vm_vaddr + newlen,
+               MM_NPAGES(vma->vm_length - newlen));
+      vm_release_region(get_group_mm(group),
+                        (FAR void *)(vma->vm_vaddr + newlen),
+                        vma->vm_length - newlen);
+    }
+
+  flags = enter_critical_section();
+  if (newlen == 0)
+    {
+      FAR struct filemap_vma_s **prev;
+
+      for (prev = &g_filemap_vmas; *prev != vma;
+           prev = &(*prev)->vm_flink);
+      *prev = vma->vm_flink;
+    }
+  else
+    {
+      vma->vm_length = newlen;
+    }
+
+  leave_critical_section(flags);
+
+  if (newlen == 0)
+    {
+      filemap_release(vma->vm_map);
+      fs_heap_free(vma);
+      ret = mm_map_remove(get_group_mm(group), entry);
+    }
+  else
+    {
+      entry->length = offset;
+    }
+
+  nxmutex_unlock(&g_filemap_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: filemap
+ *
+ * Description:
+ *   Map a file of a cached file system into the user address space of the
+ *   calling process.  Only the virtual address region is reserved, the
+ *   pages are read and mapped by filemap_fault() when they are accessed.
+ *
+ * Input Parameters:
+ *   filep - The open file to map
+ *   entry - The mmap entry information, with the offset, length, prot and
+ *           flags of the mapping filled in
+ *
+ * Returned Value:
+ *   On success, filemap returns 0 and entry->vaddr points to the mapping.
+ *   -ENOTTY is returned if the file cannot be mapped this way, e.g. it is
+ *   not cached, the offset is not page aligned or it is a private writable
+ *   mapping.  Otherwise a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int filemap(FAR struct file *filep, FAR struct mm_map_entry_s *entry)
+{
+  FAR struct task_group_s *group = this_task()->group;
+  FAR struct filemap_vma_s *vma;
+  FAR struct filemap_s *fm;
+  struct stat buf;
+  irqstate_t flags;
+  bool writable;
+  int ret;
+
+  /* Private writable mappings need pages of their own, leave them to
+   * rammap().
+   */
+
+  if (filep->f_pcache == NULL || !MM_ISALIGNED(entry->offset) ||
+      ((entry->flags & MAP_PRIVATE) != 0 &&
+       (entry->prot & PROT_WRITE) != 0))
+    {
+      return -ENOTTY;
+    }
+
+  writable = (entry->flags & MAP_SHARED) != 0 &&
+             (entry->prot & PROT_WRITE) != 0;
+
+  ret = file_fstat(filep, &buf);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  vma = fs_heap_zalloc(sizeof(struct filemap_vma_s));
+  if (vma == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = nxmutex_lock(&g_filemap_lock);
+  if (ret < 0)
+    {
+      goto errout_with_vma;
+    }
+
+  ret = filemap_get(filep, buf.st_size, writable, &fm);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  vma->vm_group  = group;
+  vma->vm_length = MM_PGALIGNUP(entry->length);
+  vma->vm_pgoff  = entry->offset >> MM_PGSHIFT;
+  vma->vm_map    = fm;
+  vma->vm_vaddr  = (uintptr_t)vm_alloc_region(get_group_mm(group), NULL,
+                                              vma->vm_length);
+  if (vma->vm_vaddr == 0)
+    {
+      ret = -ENOMEM;
+      goto errout_with_map;
+    }
+
+  entry->vaddr   = (FAR void *)vma->vm_vaddr;
+  entry->priv.p  = vma;
+  entry->munmap  = filemap_munmap;
+  entry->msync   = filemap_msync;
+
+  ret = mm_map_add(get_group_mm(group), entry);
+  if (ret < 0)
+    {
+      goto errout_with_region;
+    }
+
+  /* From now on, the page fault handler maps the pages of the region */
+
+  flags = enter_critical_section();
+  vma->vm_flink  = g_filemap_vmas;
+  g_filemap_vmas = vma;
+  leave_critical_section(flags);
+
+  nxmutex_unlock(&g_filemap_lock);
+  return OK;
+
+errout_with_region:
+  vm_release_region(get_group_mm(group), entry->vaddr, vma->vm_length);
+errout_with_map:
+  filemap_release(fm);
+errout_with_lock:
+  nxmutex_unlock(&g_filemap_lock);
+errout_with_vma:
+  fs_heap_free(vma);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: filemap_fault
+ *
+ * Description:
+ *   Resolve a page fault on a file mapping of the current process.  If the
+ *   page of the file is resident it is mapped at once.  Otherwise it is
+ *   queued for reading and the current task is stopped; it is restarted
+ *   on the faulting instruction when the page has been read.
+ *
+ * Input Parameters:
+ *   vaddr - The faulting virtual address
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the task may retry the access.  -EFAULT is
+ *   returned if the address is not in a file mapping, or beyond the end of
+ *   the file, and another negated errno value if the page cannot be
+ *   provided.  In these cases the fault is fatal for the task.
+ *
+ * Assumptions:
+ *   Called from the page fault exception handler, in interrupt context.
+ *
+ ****************************************************************************/
+
+int filemap_fault(uintptr_t vaddr)
+{
+  FAR struct tcb_s *tcb = this_task();
+  FAR struct filemap_wait_s *wait = NULL;
+  FAR struct filemap_vma_s *vma;
+  FAR struct filemap_s *fm;
+  irqstate_t flags;
+  unsigned int pgoff;
+  uintptr_t page;
+  int ret;
+  int i;
+
+  vaddr = vaddr & ~MM_PGMASK;
+  flags = enter_critical_section();
+
+  for (vma = g_filemap_vmas; vma != NULL; vma = vma->vm_flink)
+    {
+      if (vma->vm_group == tcb->group && vaddr >= vma->vm_vaddr &&
+          vaddr - vma->vm_vaddr < vma->vm_length)
+        {
+          break;
+        }
+    }
+
+  if (vma == NULL)
+    {
+      ret = -EFAULT;
+      goto out;
+    }
+
+  fm    = vma->vm_map;
+  pgoff = vma->vm_pgoff + ((vaddr - vma->vm_vaddr) >> MM_PGSHIFT);
+  if (pgoff >= fm->fm_npages)
+    {
+      ret = -EFAULT;
+      goto out;
+    }
+
+  page = fm->fm_pages[pgoff];
+  if (FILEMAP_RESIDENT(page))
+    {
+      ret = up_shmat(&page, 1, vaddr);
+      goto out;
+    }
+  else if (page == FILEMAP_ERROR)
+    {
+      ret = -EIO;
+      goto out;
+    }
+
+  for (i = 0; i < CONFIG_FS_FILEMAP_NWAITS; i++)
+    {
+      if (g_filemap_waits[i].fw_pid == 0)
+        {
+          wait = &g_filemap_waits[i];
+          break;
+        }
+    }
+
+  if (wait == NULL)
+    {
+      ferr("ERROR: Too many page faults pending\n");
+      ret = -ENOMEM;
+      goto out;
+    }
+
+  wait->fw_map        = fm;
+  wait->fw_pgoff      = pgoff;
+  wait->fw_pid        = tcb->pid;
+  fm->fm_pages[pgoff] = FILEMAP_PENDING;
+
+  work_queue(LPWORK, &g_filemap_work, filemap_worker, NULL, 0);
+  nxsched_suspend(tcb);
+  ret = OK;
+
+out:
+  leave_critical_section(flags);
+  return ret;
+}
+
+#endif /* CONFIG_FS_FILEMAP */
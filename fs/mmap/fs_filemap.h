@@ -0,0 +1,67 @@
+/****************************************************************************
+ * fs/mmap/fs_filemap.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __FS_MMAP_FS_FILEMAP_H
+#define __FS_MMAP_FS_FILEMAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <nuttx/mm/map.h>
+
+#ifdef CONFIG_FS_FILEMAP
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: filemap
+ *
+ * Description:
+ *   Map a file of a cached file system into the user address space of the
+ *   calling process.  Only the virtual address region is reserved, the
+ *   pages are read and mapped by filemap_fault() when they are accessed.
+ *
+ * Input Parameters:
+ *   filep - The open file to map
+ *   entry - The mmap entry information, with the offset, length, prot and
+ *           flags of the mapping filled in
+ *
+ * Returned Value:
+ *   On success, filemap returns 0 and entry->vaddr points to the mapping.
+ *   -ENOTTY is returned if the file cannot be mapped this way, e.g. it is
+ *   not cached, the offset is not page aligned or it is a private writable
+ *   mapping.  Otherwise a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int filemap(FAR struct file *filep, FAR struct mm_map_entry_s *entry);
+#else
+#  define filemap(file, entry) (-ENOTTY)
+#endif /* CONFIG_FS_FILEMAP */
+
+#endif /* __FS_MMAP_FS_FILEMAP_H */
@@ -39,6 +39,7 @@
 
 #include "inode/inode.h"
 #include "fs_rammap.h"
+#include "fs_filemap.h"
 
 /****************************************************************************
  * Private Functions
@@ -161,6 +162,15 @@ static int file_mmap_(FAR struct file *filep, FAR void *start,
       ret = filep->f_inode->u.i_ops->mmap(filep, &entry);
     }
 
+  if (ret == -ENOTTY && type == MAP_USER)
+    {
+      /* Map the pages of the file into the process when they are accessed,
+       * if the MMU allows it.
+       */
+
+      ret = filemap(filep, &entry);
+    }
+
   if (ret == -ENOTTY)
     {
       /* Caller request the private mapping. Or not directly mappable,
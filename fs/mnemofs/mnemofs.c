@@ -162,6 +162,10 @@ static int     mnemofs_rename(FAR struct inode *mountpt,
 static int     mnemofs_stat(FAR struct inode *mountpt,
                             FAR const char *relpath, FAR struct stat *buf);
 
+#ifdef CONFIG_MNEMOFS_BGFLUSH
+static void    mnemofs_bgflush(FAR void *arg);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -777,6 +781,17 @@ static ssize_t mnemofs_write(FAR struct file *filep, FAR const char *buffer,
       MFS_EXTRA_LOG("WRITE", "Completed writing to LRU.");
     }
 
+#ifdef CONFIG_MNEMOFS_BGFLUSH
+  /* Flush the LRU in the background unless it is closed or synced first.
+   */
+
+  if (work_available(&sb->flush_work))
+    {
+      work_queue(LPWORK, &sb->flush_work, mnemofs_bgflush, sb,
+                 MSEC2TICK(CONFIG_MNEMOFS_BGFLUSH_DELAY));
+    }
+#endif
+
   /* Update offset and size. */
 
   f->com->off += buflen;
@@ -1992,6 +2007,10 @@ static int mnemofs_unbind(FAR void *handle, FAR struct inode **driver,
   *driver = sb->drv;
   MFS_LOG("UNBIND", "Driver %p.", driver);
 
+#ifdef CONFIG_MNEMOFS_BGFLUSH
+  work_cancel_sync(LPWORK, &sb->flush_work);
+#endif
+
   mfs_jrnl_free(sb);
   mfs_ba_free(sb);
 
@@ -2620,6 +2639,39 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_MNEMOFS_BGFLUSH
+/****************************************************************************
+ * Name: mnemofs_bgflush
+ *
+ * Description:
+ *   Flush the LRU and commit the journal from the low priority work queue,
+ *   some time after a write.
+ *
+ * Input Parameters:
+ *   arg - Superblock instance of the device.
+ *
+ ****************************************************************************/
+
+static void mnemofs_bgflush(FAR void *arg)
+{
+  FAR struct mfs_sb_s *sb = arg;
+  int                  ret;
+
+  if (nxmutex_lock(&MFS_LOCK(sb)) < 0)
+    {
+      return;
+    }
+
+  ret = mnemofs_flush(sb);
+  if (predict_false(ret < 0))
+    {
+      MFS_LOG("BGFLUSH", "Background flush failed: %d.", ret);
+    }
+
+  nxmutex_unlock(&MFS_LOCK(sb));
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -2670,6 +2722,10 @@ int mnemofs_flush(FAR struct mfs_sb_s *sb)
       finfo("Finished Iteration.");
     }
 
+  /* The logs of all the nodes flushed above share the journal pages. */
+
+  ret = mfs_jrnl_commit(sb);
+
 errout:
   return ret;
 }
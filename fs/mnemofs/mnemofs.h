@@ -61,6 +61,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/list.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/wqueue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -182,6 +183,9 @@ struct mfs_jrnl_state_s
   mfs_t    log_cblkidx;   /* Current (last) block index. */
   mfs_t    log_spg;       /* First log's page */
   mfs_t    log_sblkidx;   /* First jrnl blk index. TODO: jrnlarr > 1 blk. */
+  mfs_t    log_wpg;       /* Page number of the current page */
+  mfs_t    log_pgoff;     /* Bytes of logs in log_pgbuf */
+  FAR char *log_pgbuf;    /* Logs of the current page not yet written */
   mfs_t    jrnlarr_pg;
   mfs_t    jrnlarr_pgoff;
   uint16_t n_blks;        /* TODO: Does not include the master node. */
@@ -207,6 +211,9 @@ struct mfs_sb_s
   struct list_node        lru;
   struct list_node        of;            /* open files. */
   bool                    flush;
+#ifdef CONFIG_MNEMOFS_BGFLUSH
+  struct work_s           flush_work;    /* Background flush */
+#endif
 };
 
 /* This is for *dir VFS methods. */
@@ -630,7 +637,9 @@ int mfs_jrnl_updatedinfo(FAR const struct mfs_sb_s * const sb,
  * Name: mfs_jrnl_wrlog
  *
  * Description:
- *   Write a log for LRU node when its popped from the LRU.
+ *   Write a log for LRU node when its popped from the LRU.  Logs are
+ *   gathered in the current journal page, which is programmed once it is
+ *   full or by mfs_jrnl_commit().
  *
  * Input Parameters:
  *   sb      - Superblock instance of the device.
@@ -657,6 +666,25 @@ int mfs_jrnl_wrlog(FAR struct mfs_sb_s * const sb,
                    FAR const struct mfs_node_s *node,
                    const struct mfs_ctz_s loc_new, const mfs_t sz_new);
 
+/****************************************************************************
+ * Name: mfs_jrnl_commit
+ *
+ * Description:
+ *   Program the logs gathered in the current journal page, if any, so that
+ *   all logs written so far are on the flash.  The next log starts a new
+ *   page.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ * Returned Value:
+ *   0   - OK
+ *   < 0 - Error
+ *
+ ****************************************************************************/
+
+int mfs_jrnl_commit(FAR struct mfs_sb_s * const sb);
+
 /****************************************************************************
  * Name: mfs_jrnl_flush
  *
@@ -707,8 +735,8 @@ struct mfs_jrnl_log_s
 };
 
 int mfs_jrnl_rdlog(FAR const struct mfs_sb_s *const sb,
-                      FAR mfs_t *blkidx, FAR mfs_t *pg_in_blk,
-                      FAR struct mfs_jrnl_log_s *log);
+                   FAR mfs_t *blkidx, FAR mfs_t *pg_in_blk,
+                   FAR mfs_t *pg_off, FAR struct mfs_jrnl_log_s *log);
 
 void mfs_jrnl_log_free(FAR const struct mfs_jrnl_log_s * const log);
 
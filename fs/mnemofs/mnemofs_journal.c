@@ -67,8 +67,13 @@
  * with an array containing the block numbers of all blocks in the journal
  * including the first block. Then the logs start.
  *
- * The logs take up size in multiples of pages. There might be unitilzed
- * space at the end of a log.
+ * Each log is preceded by its size. Logs are packed in a page for as long
+ * as they fit, a size of 0 or the end of the page means the next log is
+ * at the start of the next page, and a page which starts with a size of 0
+ * ends the journal. The logs of the current page are gathered in memory
+ * and the page is programmed only once, when it is full or when the logs
+ * are committed, so the logs of a group of LRU nodes that are flushed
+ * together take one page program rather than one each.
  *
  * All logs are followed by a byte-long hash of the log.
  ****************************************************************************/
@@ -112,6 +117,10 @@ FAR static const char *deser_log(FAR const char * const in,
                                  FAR struct mfs_jrnl_log_s * const x);
 FAR static char       *ser_log(FAR const struct mfs_jrnl_log_s * const x,
                                FAR char * const out);
+static int             jrnl_read(FAR const struct mfs_sb_s * const sb,
+                                 FAR char *buf, mfs_t sz, mfs_t pg,
+                                 mfs_t pgoff);
+static void            jrnl_nextpg(FAR struct mfs_sb_s * const sb);
 
 /****************************************************************************
  * Private Data
@@ -136,6 +145,7 @@ FAR static char       *ser_log(FAR const struct mfs_jrnl_log_s * const x,
  *   sb        - Superblock instance of the device.
  *   blkidx    - Journal Block Index of the current block.
  *   pg_in_blk - Page offset in the block.
+ *   pg_off    - Byte offset in the page.
  *   log       - To populate with the log.
  *
  * Returned Value:
@@ -147,43 +157,72 @@ FAR static char       *ser_log(FAR const struct mfs_jrnl_log_s * const x,
  *   the initial requested area is inside the journal. It will malfunction
  *   if not used properly. Usually this is used in an iterative manner, and
  *   hence the first time blkidx and pg_in_blk are initialized, they should
- *   be derived from the values in MFS_JRNL(sb) respectively.
+ *   be derived from the values in MFS_JRNL(sb) respectively, and pg_off
+ *   should be 0.
  *
- *   This updates the blkidx and pg_in_blk to point to the next log, and
- *   returns an -ENOSPC when end of journal is reached in traversal.
+ *   This updates the blkidx, pg_in_blk and pg_off to point to the next log,
+ *   and returns an -ENOSPC when end of journal is reached in traversal.
  *
  *   Free the log after use.
  *
  ****************************************************************************/
 
 int mfs_jrnl_rdlog(FAR const struct mfs_sb_s *const sb,
-                      FAR mfs_t *blkidx, FAR mfs_t *pg_in_blk,
-                      FAR struct mfs_jrnl_log_s *log)
+                   FAR mfs_t *blkidx, FAR mfs_t *pg_in_blk,
+                   FAR mfs_t *pg_off, FAR struct mfs_jrnl_log_s *log)
 {
   int       ret       = OK;
   char      tmp[4];
-  mfs_t     log_sz;
+  mfs_t     log_sz    = 0;
   mfs_t     jrnl_pg;
   mfs_t     jrnl_blk;
   FAR char *buf       = NULL;
 
-  DEBUGASSERT(*pg_in_blk % MFS_PGSZ(sb) == 0);
+  DEBUGASSERT(*pg_off <= MFS_PGSZ(sb));
 
-  jrnl_blk = mfs_jrnl_blkidx2blk(sb, *blkidx);
-  jrnl_pg  = MFS_BLK2PG(sb, jrnl_blk) + *pg_in_blk;
+  for (; ; )
+    {
+      jrnl_blk = mfs_jrnl_blkidx2blk(sb, *blkidx);
+      jrnl_pg  = MFS_BLK2PG(sb, jrnl_blk) + *pg_in_blk;
 
-  /* First 4 bytes contain the size of the entire log. */
+      /* First 4 bytes contain the size of the entire log. */
 
-  ret = mfs_read_page(sb, tmp, 4, jrnl_pg, 0);
-  if (predict_false(ret < 0))
-    {
-      goto errout;
+      if (*pg_off + 4 <= MFS_PGSZ(sb))
+        {
+          ret = jrnl_read(sb, tmp, 4, jrnl_pg, *pg_off);
+          if (predict_false(ret < 0))
+            {
+              goto errout;
+            }
+
+          mfs_deser_mfs(tmp, &log_sz);
+          if (log_sz != 0)
+            {
+              break;
+            }
+
+          if (*pg_off == 0)
+            {
+              ret = -ENOSPC;
+              goto errout;
+            }
+        }
+
+      /* No more logs in this page, the next one is in the next page. */
+
+      *pg_off = 0;
+      (*pg_in_blk)++;
+
+      if (*pg_in_blk >= MFS_PGINBLK(sb))
+        {
+          *pg_in_blk = 0;
+          (*blkidx)++;
+        }
     }
 
-  mfs_deser_mfs(tmp, &log_sz);
-  if (log_sz == 0)
+  if (predict_false(*pg_off + 4 + log_sz > MFS_PGSZ(sb)))
     {
-      ret = -ENOSPC;
+      ret = -EINVAL;
       goto errout;
     }
 
@@ -194,7 +233,7 @@ int mfs_jrnl_rdlog(FAR const struct mfs_sb_s *const sb,
       goto errout;
     }
 
-  ret = mfs_read_page(sb, buf, log_sz, jrnl_pg, 4);
+  ret = jrnl_read(sb, buf, log_sz, jrnl_pg, *pg_off + 4);
   if (predict_false(ret < 0))
     {
       goto errout_with_buf;
@@ -208,13 +247,7 @@ int mfs_jrnl_rdlog(FAR const struct mfs_sb_s *const sb,
       goto errout_with_buf;
     }
 
-  (*pg_in_blk)++;
-
-  if (*pg_in_blk >= MFS_PGINBLK(sb))
-    {
-      *pg_in_blk = 0;
-      (*blkidx)++;
-    }
+  *pg_off += 4 + log_sz;
 
 errout_with_buf:
   fs_heap_free(buf);
@@ -314,6 +347,77 @@ FAR static const char *deser_log(FAR const char * const in,
   return i;
 }
 
+/****************************************************************************
+ * Name: jrnl_read
+ *
+ * Description:
+ *   Read from a journal page. The current page is read from the logs
+ *   gathered in memory, as it is not programmed yet.
+ *
+ * Input Parameters:
+ *   sb    - Superblock instance of the device.
+ *   buf   - Buffer to read into.
+ *   sz    - Number of bytes to read.
+ *   pg    - Page number.
+ *   pgoff - Offset in the page.
+ *
+ * Returned Value:
+ *   >= 0 - OK
+ *   < 0  - Error
+ *
+ ****************************************************************************/
+
+static int jrnl_read(FAR const struct mfs_sb_s * const sb, FAR char *buf,
+                     mfs_t sz, mfs_t pg, mfs_t pgoff)
+{
+  if (pg != MFS_JRNL(sb).log_wpg)
+    {
+      return mfs_read_page(sb, buf, sz, pg, pgoff);
+    }
+
+  if (MFS_JRNL(sb).log_pgbuf == NULL)
+    {
+      memset(buf, 0, sz);
+    }
+  else
+    {
+      memcpy(buf, MFS_JRNL(sb).log_pgbuf + pgoff, sz);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: jrnl_nextpg
+ *
+ * Description:
+ *   Move the current journal page to the next page of the journal.
+ *
+ * Input Parameters:
+ *   sb - Superblock instance of the device.
+ *
+ ****************************************************************************/
+
+static void jrnl_nextpg(FAR struct mfs_sb_s * const sb)
+{
+  MFS_JRNL(sb).log_cpg++;
+
+  if (MFS_JRNL(sb).log_cpg % MFS_PGINBLK(sb) == 0)
+    {
+      MFS_JRNL(sb).log_cblkidx++;
+    }
+
+  MFS_JRNL(sb).log_wpg   = MFS_BLK2PG(sb, mfs_jrnl_blkidx2blk(sb,
+                                          MFS_JRNL(sb).log_cblkidx)) +
+                           MFS_JRNL(sb).log_cpg % MFS_PGINBLK(sb);
+  MFS_JRNL(sb).log_pgoff = 0;
+
+  if (MFS_JRNL(sb).log_pgbuf != NULL)
+    {
+      memset(MFS_JRNL(sb).log_pgbuf, 0, MFS_PGSZ(sb));
+    }
+}
+
 /****************************************************************************
  * Name: mfs_jrnl_log_free
  *
@@ -344,6 +448,7 @@ int mfs_jrnl_init(FAR struct mfs_sb_s * const sb, mfs_t blk)
   mfs_t             sz;
   mfs_t             blkidx;
   mfs_t             pg_in_blk;
+  mfs_t             pg_off     = 0;
   struct mfs_jrnl_log_s log;
 
   /* Magic sequence is already used to find the block, so not required. */
@@ -366,6 +471,8 @@ int mfs_jrnl_init(FAR struct mfs_sb_s * const sb, mfs_t blk)
   MFS_JRNL(sb).log_sblkidx   = MFS_JRNL(sb).log_cblkidx;
   MFS_JRNL(sb).jrnlarr_pg    = MFS_BLK2PG(sb, blk); /* Assuming pgsz > 10 */
   MFS_JRNL(sb).jrnlarr_pgoff = MFS_JRNL_SUFFIXSZ;
+  MFS_JRNL(sb).log_wpg       = MFS_NPGS(sb); /* No page in memory yet. */
+  MFS_JRNL(sb).log_pgoff     = 0;
 
   /* Number of logs */
 
@@ -375,7 +482,7 @@ int mfs_jrnl_init(FAR struct mfs_sb_s * const sb, mfs_t blk)
 
   while (true)
     {
-      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_blk, &log);
+      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_blk, &pg_off, &log);
       if (predict_false(ret < 0 && ret != -ENOSPC))
         {
           goto errout;
@@ -401,6 +508,24 @@ int mfs_jrnl_init(FAR struct mfs_sb_s * const sb, mfs_t blk)
       mfs_jrnl_log_free(&log);
     }
 
+  /* New logs go after the last one, in a new page if the page of the last
+   * one is programmed already.
+   */
+
+  MFS_JRNL(sb).log_cblkidx = blkidx;
+  MFS_JRNL(sb).log_cpg     = blkidx * MFS_PGINBLK(sb) + pg_in_blk;
+
+  if (pg_off != 0)
+    {
+      jrnl_nextpg(sb);
+    }
+  else
+    {
+      MFS_JRNL(sb).log_wpg = MFS_BLK2PG(sb,
+                                        mfs_jrnl_blkidx2blk(sb, blkidx)) +
+                             pg_in_blk;
+    }
+
   /* Master node */
 
   MFS_JRNL(sb).mblk1 = mfs_jrnl_blkidx2blk(sb, MFS_JRNL(sb).n_blks);
@@ -504,11 +629,20 @@ int mfs_jrnl_fmt(FAR struct mfs_sb_s * const sb, FAR mfs_t *blk1,
   MFS_JRNL(sb).log_cblkidx   = 0;
   MFS_JRNL(sb).log_spg       = MFS_JRNL(sb).log_cpg;
   MFS_JRNL(sb).log_sblkidx   = MFS_JRNL(sb).log_cblkidx;
+  MFS_JRNL(sb).log_wpg       = MFS_JRNL(sb).log_cpg;
+  MFS_JRNL(sb).log_pgoff     = 0;
   MFS_JRNL(sb).jrnlarr_pg    = MFS_BLK2PG(sb, blk);
   MFS_JRNL(sb).jrnlarr_pgoff = MFS_JRNL_SUFFIXSZ;
   MFS_JRNL(sb).mblk1         = *blk1;
   MFS_JRNL(sb).mblk2         = *blk2;
 
+  /* The logs in memory belonged to the old journal. */
+
+  if (MFS_JRNL(sb).log_pgbuf != NULL)
+    {
+      memset(MFS_JRNL(sb).log_pgbuf, 0, MFS_PGSZ(sb));
+    }
+
 errout_with_buf:
   fs_heap_free(buf);
 
@@ -524,6 +658,11 @@ void mfs_jrnl_free(FAR struct mfs_sb_s * const sb)
       mfs_jrnl_flush(sb);
     }
 
+  mfs_jrnl_commit(sb);
+
+  fs_heap_free(MFS_JRNL(sb).log_pgbuf);
+  MFS_JRNL(sb).log_pgbuf = NULL;
+
   finfo("Journal Freed.");
 }
 
@@ -575,6 +714,7 @@ int mfs_jrnl_updatedinfo(FAR const struct mfs_sb_s * const sb,
   mfs_t             blkidx;
   mfs_t             counter     = 0;
   mfs_t             pg_in_block;
+  mfs_t             pg_off      = 0;
   struct mfs_jrnl_log_s tmplog;
 
   /* TODO: Allow optional filling of updated timestamps, etc. */
@@ -586,7 +726,7 @@ int mfs_jrnl_updatedinfo(FAR const struct mfs_sb_s * const sb,
 
   while (blkidx < MFS_JRNL(sb).n_blks && counter < MFS_JRNL(sb).n_logs)
     {
-      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_block, &tmplog);
+      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_block, &pg_off, &tmplog);
       if (predict_false(ret < 0 && ret != -ENOSPC))
         {
           goto errout;
@@ -627,19 +767,39 @@ int mfs_jrnl_wrlog(FAR struct mfs_sb_s * const sb,
                    const struct mfs_ctz_s loc_new, const mfs_t sz_new)
 {
   int                    ret      = OK;
-  mfs_t                  jrnl_pg;
-  FAR char              *buf      = NULL;
   FAR char              *tmp      = NULL;
   const mfs_t            log_sz   = sizeof(mfs_t) + MFS_LOGSZ(node->depth);
   struct mfs_jrnl_log_s  log;
 
-  buf = fs_heap_zalloc(log_sz); /* For size before log. */
-  if (predict_false(buf == NULL))
+  /* A log larger than one page is rejected. */
+
+  if (predict_false(log_sz > MFS_PGSZ(sb)))
     {
-      ret = -ENOMEM;
+      ret = -E2BIG;
       goto errout;
     }
 
+  if (MFS_JRNL(sb).log_pgbuf == NULL)
+    {
+      MFS_JRNL(sb).log_pgbuf = fs_heap_zalloc(MFS_PGSZ(sb));
+      if (predict_false(MFS_JRNL(sb).log_pgbuf == NULL))
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+    }
+
+  /* A full page is programmed, the log goes to the next one. */
+
+  if (MFS_JRNL(sb).log_pgoff + log_sz > MFS_PGSZ(sb))
+    {
+      ret = mfs_jrnl_commit(sb);
+      if (predict_false(ret < 0))
+        {
+          goto errout;
+        }
+    }
+
   /* Serialize */
 
   log.depth       = node->depth;
@@ -650,39 +810,35 @@ int mfs_jrnl_wrlog(FAR struct mfs_sb_s * const sb,
   log.st_ctim_new = node->st_ctim;
   log.path        = node->path;    /* Fine as temporarily usage. */
 
-  tmp = buf;
+  tmp = MFS_JRNL(sb).log_pgbuf + MFS_JRNL(sb).log_pgoff;
   tmp = mfs_ser_mfs(log_sz - sizeof(mfs_t), tmp); /* First 4 bytes have sz */
   tmp = ser_log(&log, tmp);
 
-  /* Store */
+  MFS_JRNL(sb).log_pgoff += log_sz;
+  MFS_JRNL(sb).n_logs++;
 
-  jrnl_pg  = MFS_JRNL(sb).log_cpg;
+errout:
+  return ret;
+}
 
-  /* TODO: It assumes it takes only one page per log. */
+int mfs_jrnl_commit(FAR struct mfs_sb_s * const sb)
+{
+  ssize_t ret;
 
-  ret = mfs_write_page(sb, buf, log_sz, jrnl_pg, 0);
-  if (predict_false(ret < 0))
+  if (MFS_JRNL(sb).log_pgoff == 0)
     {
-      goto errout_with_buf;
+      return OK;
     }
 
-  ret = OK;
-
-  jrnl_pg++;
-
-  if (jrnl_pg % MFS_PGINBLK(sb) == 0)
+  ret = mfs_write_page(sb, MFS_JRNL(sb).log_pgbuf, MFS_JRNL(sb).log_pgoff,
+                       MFS_JRNL(sb).log_wpg, 0);
+  if (predict_false(ret < 0))
     {
-      MFS_JRNL(sb).log_cblkidx++;
+      return ret;
     }
 
-  MFS_JRNL(sb).log_cpg = jrnl_pg;
-  MFS_JRNL(sb).n_logs++;
-
-errout_with_buf:
-  fs_heap_free(buf);
-
-errout:
-  return ret;
+  jrnl_nextpg(sb);
+  return OK;
 }
 
 int mfs_jrnl_flush(FAR struct mfs_sb_s * const sb)
@@ -723,8 +879,10 @@ int mfs_jrnl_flush(FAR struct mfs_sb_s * const sb)
   mfs_t                    log_itr       = 0;
   mfs_t                    pg_in_blk     = MFS_JRNL(sb).log_spg \
                                            % MFS_PGINBLK(sb);
+  mfs_t                    pg_off        = 0;
   mfs_t                    tmp_blkidx;
   mfs_t                    tmp_pg_in_blk;
+  mfs_t                    tmp_pg_off;
   mfs_t                    mn_blk1;
   mfs_t                    mn_blk2;
   mfs_t                    i;
@@ -738,7 +896,7 @@ int mfs_jrnl_flush(FAR struct mfs_sb_s * const sb)
 
   while (log_itr < MFS_JRNL(sb).n_logs)
     {
-      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_blk, &log);
+      ret = mfs_jrnl_rdlog(sb, &blkidx, &pg_in_blk, &pg_off, &log);
       if (predict_false(ret < 0))
         {
           DEBUGASSERT(ret != -ENOSPC); /* While condition is sufficient. */
@@ -754,6 +912,7 @@ int mfs_jrnl_flush(FAR struct mfs_sb_s * const sb)
 
       tmp_blkidx    = blkidx;
       tmp_pg_in_blk = pg_in_blk;
+      tmp_pg_off    = pg_off;
 
       path = fs_heap_zalloc(log.depth * sizeof(struct mfs_path_s));
       if (predict_false(path == NULL))
@@ -766,7 +925,8 @@ int mfs_jrnl_flush(FAR struct mfs_sb_s * const sb)
 
       for (; ; )
         {
-          ret = mfs_jrnl_rdlog(sb, &tmp_blkidx, &tmp_pg_in_blk, &tmp_log);
+          ret = mfs_jrnl_rdlog(sb, &tmp_blkidx, &tmp_pg_in_blk,
+                               &tmp_pg_off, &tmp_log);
           if (ret == -ENOSPC)
             {
               break;
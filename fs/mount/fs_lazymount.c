@@ -0,0 +1,543 @@
+/****************************************************************************
+ * fs/mount/fs_lazymount.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mount.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+
+#include "inode/inode.h"
+#include "mount/mount.h"
+#include "fs_heap.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bind in the background on the low priority work queue if there is one,
+ * else on the high priority one.  Without either the bind happens on the
+ * first access.
+ */
+
+#if defined(CONFIG_SCHED_LPWORK)
+#  define LAZYMOUNT_WORK LPWORK
+#elif defined(CONFIG_SCHED_HPWORK)
+#  define LAZYMOUNT_WORK HPWORK
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A mount whose bind is still pending or has failed.  The mountpoint inode
+ * carries g_lazymount_operations and this structure as its private data
+ * until the bind succeeds, then the real operations and handle replace
+ * them and the structure is dropped from g_lazymounts.  crefs counts the
+ * mount itself, the queued work and the callers waiting for the bind.
+ */
+
+struct lazymount_s
+{
+  FAR struct lazymount_s *flink;
+  FAR struct inode *mountpt;                 /* The mountpoint */
+  FAR struct inode *drvr;                    /* Driver reference of the fs */
+  FAR const struct mountpt_operations *mops; /* The real operations */
+  FAR const void *data;                      /* Argument of bind */
+  mutex_t lock;                              /* Serializes the bind */
+  int crefs;                                 /* Under g_lazylock */
+  int result;                                /* Result of the bind */
+  bool done;                                 /* The bind has run */
+#ifdef LAZYMOUNT_WORK
+  struct work_s work;
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int lazymount_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode);
+static int lazymount_opendir(FAR struct inode *mountpt,
+                             FAR const char *relpath,
+                             FAR struct fs_dirent_s **dir);
+static int lazymount_unbind(FAR void *handle, FAR struct inode **blkdriver,
+                            unsigned int flags);
+static int lazymount_statfs(FAR struct inode *mountpt,
+                            FAR struct statfs *buf);
+static int lazymount_unlink(FAR struct inode *mountpt,
+                            FAR const char *relpath);
+static int lazymount_mkdir(FAR struct inode *mountpt,
+                           FAR const char *relpath, mode_t mode);
+static int lazymount_rmdir(FAR struct inode *mountpt,
+                           FAR const char *relpath);
+static int lazymount_rename(FAR struct inode *mountpt,
+                            FAR const char *oldrelpath,
+                            FAR const char *newrelpath);
+static int lazymount_stat(FAR struct inode *mountpt, FAR const char *relpath,
+                          FAR struct stat *buf);
+static int lazymount_chstat(FAR struct inode *mountpt,
+                            FAR const char *relpath,
+                            FAR const struct stat *buf, int flags);
+static int lazymount_syncfs(FAR struct inode *mountpt);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Only the operations that take a path can reach a mountpoint before it is
+ * bound, everything else needs an open file or directory first.
+ */
+
+static const struct mountpt_operations g_lazymount_operations =
+{
+  lazymount_open,       /* open */
+  NULL,                 /* close */
+  NULL,                 /* read */
+  NULL,                 /* write */
+  NULL,                 /* seek */
+  NULL,                 /* ioctl */
+  NULL,                 /* mmap */
+  NULL,                 /* truncate */
+  NULL,                 /* poll */
+  NULL,                 /* readv */
+  NULL,                 /* writev */
+
+  NULL,                 /* sync */
+  NULL,                 /* dup */
+  NULL,                 /* fstat */
+  NULL,                 /* fchstat */
+
+  lazymount_opendir,    /* opendir */
+  NULL,                 /* closedir */
+  NULL,                 /* readdir */
+  NULL,                 /* rewinddir */
+
+  NULL,                 /* bind */
+  lazymount_unbind,     /* unbind */
+  lazymount_statfs,     /* statfs */
+
+  lazymount_unlink,     /* unlink */
+  lazymount_mkdir,      /* mkdir */
+  lazymount_rmdir,      /* rmdir */
+  lazymount_rename,     /* rename */
+  lazymount_stat,       /* stat */
+  lazymount_chstat,     /* chstat */
+  lazymount_syncfs      /* syncfs */
+};
+
+static FAR struct lazymount_s *g_lazymounts;
+static mutex_t g_lazylock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Unlink a mount from g_lazymounts, it is on the list from
+ * lazymount_start() until it is bound or unmounted.
+ */
+
+static void lazymount_remove(FAR struct lazymount_s *lm)
+{
+  FAR struct lazymount_s **prev;
+
+  nxmutex_lock(&g_lazylock);
+  for (prev = &g_lazymounts; *prev != NULL; prev = &(*prev)->flink)
+    {
+      if (*prev == lm)
+        {
+          *prev = lm->flink;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_lazylock);
+}
+
+static void lazymount_put(FAR struct lazymount_s *lm)
+{
+  bool last;
+
+  nxmutex_lock(&g_lazylock);
+  last = --lm->crefs == 0;
+  nxmutex_unlock(&g_lazylock);
+
+  if (last)
+    {
+      nxmutex_destroy(&lm->lock);
+      fs_heap_free(lm);
+    }
+}
+
+/* Run the bind unless it already has, then return its result */
+
+static int lazymount_bind(FAR struct lazymount_s *lm)
+{
+  FAR void *handle = NULL;
+  int ret;
+
+  nxmutex_lock(&lm->lock);
+  if (!lm->done)
+    {
+      finfo("Binding %p\n", lm->mountpt);
+
+      ret = lm->mops->bind(lm->drvr, lm->data, &handle);
+      if (ret < 0)
+        {
+          ferr("ERROR: Bind method failed: %d\n", ret);
+        }
+
+      /* Publish the real operations under the inode lock, so that unmount
+       * sees either the pending mount or the bound file system.
+       */
+
+      inode_lock();
+      if (ret >= 0)
+        {
+          lm->mountpt->u.i_mops  = lm->mops;
+          lm->mountpt->i_private = handle;
+          lazymount_remove(lm);
+        }
+
+      lm->result = ret;
+      lm->done   = true;
+      inode_unlock();
+
+      /* The mount no longer needs the structure, the caller still holds
+       * a reference.
+       */
+
+      if (ret >= 0)
+        {
+          lazymount_put(lm);
+        }
+    }
+
+  ret = lm->result;
+  nxmutex_unlock(&lm->lock);
+  return ret;
+}
+
+/* Wait for the bind of a mountpoint reached through the lazy operations.
+ * Once it succeeded the mountpoint carries the real operations.
+ */
+
+static int lazymount_wait(FAR struct inode *mountpt)
+{
+  FAR struct lazymount_s *lm;
+  int ret = OK;
+
+  nxmutex_lock(&g_lazylock);
+  for (lm = g_lazymounts; lm != NULL; lm = lm->flink)
+    {
+      if (lm->mountpt == mountpt)
+        {
+          lm->crefs++;
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_lazylock);
+
+  if (lm != NULL)
+    {
+      ret = lazymount_bind(lm);
+      lazymount_put(lm);
+    }
+
+  return ret;
+}
+
+#ifdef LAZYMOUNT_WORK
+static void lazymount_worker(FAR void *arg)
+{
+  FAR struct lazymount_s *lm = arg;
+
+  lazymount_bind(lm);
+  lazymount_put(lm);
+}
+#endif
+
+static int lazymount_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct inode *inode = filep->f_inode;
+  int ret;
+
+  ret = lazymount_wait(inode);
+  if (ret >= 0)
+    {
+      ret = inode->u.i_mops->open != NULL ?
+            inode->u.i_mops->open(filep, relpath, oflags, mode) : -ENOSYS;
+    }
+
+  return ret;
+}
+
+static int lazymount_opendir(FAR struct inode *mountpt,
+                             FAR const char *relpath,
+                             FAR struct fs_dirent_s **dir)
+{
+  int ret;
+
+  ret = lazymount_wait(mountpt);
+  if (ret >= 0)
+    {
+      ret = mountpt->u.i_mops->opendir != NULL ?
+            mountpt->u.i_mops->opendir(mountpt, relpath, dir) : -ENOSYS;
+    }
+
+  return ret;
+}
+
+/* Called by umount2() with the inode lock held, so a bind that is running
+ * right now cannot be waited for.
+ */
+
+static int lazymount_unbind(FAR void *handle, FAR struct inode **blkdriver,
+                            unsigned int flags)
+{
+  FAR struct lazymount_s *lm = handle;
+
+  if (nxmutex_trylock(&lm->lock) < 0)
+    {
+      return -EBUSY;
+    }
+
+  /* Either the bind has not started or it failed, the reference on the
+   * driver goes back to the caller.
+   */
+
+  DEBUGASSERT(!lm->done || lm->result < 0);
+  lm->done   = true;
+  lm->result = -ENODEV;
+  *blkdriver = lm->drvr;
+  lm->drvr   = NULL;
+  lazymount_remove(lm);
+
+  nxmutex_unlock(&lm->lock);
+  lazymount_put(lm);
+  return OK;
+}
+
+static int lazymount_statfs(FAR struct inode *mountpt,
+                            FAR struct statfs *buf)
+{
+  int ret;
+
+  ret = lazymount_wait(mountpt);
+  if (ret >= 0)
+    {
+      ret = mountpt->u.i_mops->statfs != NULL ?
+            mountpt->u.i_mops->statfs(mountpt, buf) : -ENOSYS;
+    }
+
+  return ret;
+}
+
+static int lazymount_unlink(FAR struct inode *mountpt,
+                            FAR const char *relpath)
+{
+  int ret;
+
+  ret = lazymount_wait(mountpt);
+  if (ret >= 0)
+    {
+      ret = mountpt->u.i_mops->unlink != NULL ?
+            mountpt->u.i_mops->unlink(mountpt, relpath) : -ENOSYS;
+    }
+
+  return ret;
+}
+
+static int lazymount_mkdir(FAR struct inode *mountpt,
+                           FAR const char *relpath, mode_t mode)
+{
+  int ret;
+
+  ret = lazymount_wait(mountpt);
+  if (ret >= 0)
+    {
+      ret = mountpt->u.i_mops->mkdir != NULL ?
+            mountpt->u.i_mops->mkdir(mountpt, relpath, mode) : -ENOSYS;
+    }
+
+  return ret;
+}
+
+static int lazymount_rmdir(FAR struct inode *mountpt,
+                           FAR const char *relpath)
+{
+  int ret;
+
+  ret = lazymount_wait(mountpt);
+  if (ret >= 0)
+    {
+      ret = mountpt->u.i_mops->rmdir != NULL ?
+            mountpt->u.i_mops->rmdir(mountpt, relpath) : -ENOSYS;
+    }
+
+  return ret;
+}
+
+static int lazymount_rename(FAR struct inode *mountpt,
+                            FAR const char *oldrelpath,
+                            FAR const char *newrelpath)
+{
+  int ret;
+
+  ret = lazymount_wait(mountpt);
+  if (ret >= 0)
+    {
+      ret = mountpt->u.i_mops->rename != NULL ?
+            mountpt->u.i_mops->rename(mountpt, oldrelpath, newrelpath) :
+            -ENOSYS;
+    }
+
+  return ret;
+}
+
+static int lazymount_stat(FAR struct inode *mountpt, FAR const char *relpath,
+                          FAR struct stat *buf)
+{
+  int ret;
+
+  ret = lazymount_wait(mountpt);
+  if (ret >= 0)
+    {
+      ret = mountpt->u.i_mops->stat != NULL ?
+            mountpt->u.i_mops->stat(mountpt, relpath, buf) : -ENOSYS;
+    }
+
+  return ret;
+}
+
+static int lazymount_chstat(FAR struct inode *mountpt,
+                            FAR const char *relpath,
+                            FAR const struct stat *buf, int flags)
+{
+  int ret;
+
+  ret = lazymount_wait(mountpt);
+  if (ret >= 0)
+    {
+      ret = mountpt->u.i_mops->chstat != NULL ?
+            mountpt->u.i_mops->chstat(mountpt, relpath, buf, flags) :
+            -ENOSYS;
+    }
+
+  return ret;
+}
+
+static int lazymount_syncfs(FAR struct inode *mountpt)
+{
+  int ret;
+
+  ret = lazymount_wait(mountpt);
+  if (ret >= 0)
+    {
+      ret = mountpt->u.i_mops->syncfs != NULL ?
+            mountpt->u.i_mops->syncfs(mountpt) : OK;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lazymount_create
+ *
+ * Description:
+ *   Prepare a mount with MS_LAZYMOUNT in place of the bind.  On success
+ *   *handle and *mops are what the mountpoint inode has to carry until the
+ *   bind is done, the reference on drvr passes to the pending mount.  The
+ *   data is used as is by the later bind and must stay valid until then.
+ *
+ ****************************************************************************/
+
+int lazymount_create(FAR struct inode *drvr,
+                     FAR const struct mountpt_operations **mops,
+                     FAR const void *data, FAR void **handle)
+{
+  FAR struct lazymount_s *lm;
+
+  lm = fs_heap_zalloc(sizeof(struct lazymount_s));
+  if (lm == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxmutex_init(&lm->lock);
+  lm->crefs = 1;
+  lm->drvr  = drvr;
+  lm->mops  = *mops;
+  lm->data  = data;
+
+  *mops   = &g_lazymount_operations;
+  *handle = lm;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lazymount_start
+ *
+ * Description:
+ *   Start the bind of a mount prepared by lazymount_create() once its
+ *   mountpoint inode is set up.  Called with the inode lock held, before
+ *   anyone can look the mountpoint up.
+ *
+ ****************************************************************************/
+
+void lazymount_start(FAR struct inode *mountpt)
+{
+  FAR struct lazymount_s *lm = mountpt->i_private;
+
+  DEBUGASSERT(mountpt->u.i_mops == &g_lazymount_operations);
+
+  lm->mountpt = mountpt;
+
+  nxmutex_lock(&g_lazylock);
+  lm->flink    = g_lazymounts;
+  g_lazymounts = lm;
+#ifdef LAZYMOUNT_WORK
+  lm->crefs++;
+#endif
+  nxmutex_unlock(&g_lazylock);
+
+#ifdef LAZYMOUNT_WORK
+  work_queue(LAZYMOUNT_WORK, &lm->work, lazymount_worker, lm, 0);
+#endif
+}
@@ -37,6 +37,7 @@
 
 #include "driver/driver.h"
 #include "inode/inode.h"
+#include "mount/mount.h"
 #include "vfs/vfs.h"
 
 /****************************************************************************
@@ -304,7 +305,8 @@ int nx_mount(FAR const char *source, FAR const char *target,
   /* Find the specified filesystem. Try the block driver filesystems first */
 
   if (source != NULL && source[0] != '\0' &&
-      find_blockdriver(source, mountflags, &drvr_inode) >= 0)
+      find_blockdriver(source, mountflags & ~MS_LAZYMOUNT,
+                       &drvr_inode) >= 0)
     {
       /* Find the block based file system */
 
@@ -345,7 +347,8 @@ int nx_mount(FAR const char *source, FAR const char *target,
           else
             {
               inode_release(drvr_inode);
-              ret = mtd_proxy(source, mountflags, &drvr_inode);
+              ret = mtd_proxy(source, mountflags & ~MS_LAZYMOUNT,
+                              &drvr_inode);
               if (ret < 0)
                 {
                   goto errout_with_inode;
@@ -426,13 +429,25 @@ int nx_mount(FAR const char *source, FAR const char *target,
 
   inode_unlock();
 
-  /* On failure, the bind method returns -errorcode */
+  /* On failure, the bind method returns -errorcode.  A lazy mount only
+   * records what to bind and does it once the mountpoint exists.
+   */
 
+#ifdef CONFIG_FS_LAZYMOUNT
+  if ((mountflags & MS_LAZYMOUNT) != 0)
+    {
+      ret = lazymount_create(drvr_inode, &mops, data, &fshandle);
+    }
+  else
+#endif
+    {
 #if defined(BDFS_SUPPORT) || defined(MDFS_SUPPORT)
-  ret = mops->bind(drvr_inode, data, &fshandle);
+      ret = mops->bind(drvr_inode, data, &fshandle);
 #else
-  ret = mops->bind(NULL, data, &fshandle);
+      ret = mops->bind(NULL, data, &fshandle);
 #endif
+    }
+
   inode_lock();
   if (ret < 0)
     {
@@ -487,6 +502,14 @@ int nx_mount(FAR const char *source, FAR const char *target,
 
   mountpt_inode->u.i_mops  = mops;
   mountpt_inode->i_private = fshandle;
+
+#ifdef CONFIG_FS_LAZYMOUNT
+  if ((mountflags & MS_LAZYMOUNT) != 0)
+    {
+      lazymount_start(mountpt_inode);
+    }
+#endif
+
   inode_unlock();
 
   /* We can release our reference to the blkdrver_inode, if the filesystem
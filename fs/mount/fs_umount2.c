@@ -110,6 +110,16 @@ int nx_umount2(FAR const char *target, unsigned int flags)
    * performed, or a negated error code on a failure.
    */
 
+#ifdef CONFIG_FS_PAGECACHE
+  /* Discard the pages kept for the files that are no longer open */
+
+  pagecache_umount(mountpt_inode);
+#endif
+
+#ifdef CONFIG_FS_DCACHE
+  dcache_umount(mountpt_inode);
+#endif
+
   /* Hold the semaphore through the unbind logic */
 
   inode_lock();
@@ -88,5 +88,42 @@ int foreach_mountpoint(foreach_mountpoint_t handler, FAR void *arg);
 
 FAR const char *fs_gettype(FAR struct statfs *statbuf);
 
+#ifdef CONFIG_FS_LAZYMOUNT
+
+/****************************************************************************
+ * Name: lazymount_create
+ *
+ * Description:
+ *   Used by nx_mount() in place of the bind method for a mount with
+ *   MS_LAZYMOUNT.  *mops is replaced with the operations that wait for the
+ *   bind and *handle receives the pending mount, both go into the
+ *   mountpoint inode.  The reference on drvr passes to the pending mount
+ *   and the data must stay valid until the bind has run.
+ *
+ * Returned Value:
+ *   Zero on success, -ENOMEM if the pending mount cannot be allocated.
+ *
+ ****************************************************************************/
+
+struct inode;
+struct mountpt_operations;
+
+int lazymount_create(FAR struct inode *drvr,
+                     FAR const struct mountpt_operations **mops,
+                     FAR const void *data, FAR void **handle);
+
+/****************************************************************************
+ * Name: lazymount_start
+ *
+ * Description:
+ *   Start binding a mountpoint set up with lazymount_create() in the
+ *   background.  Accesses that arrive first do the bind themselves, or
+ *   wait until it is done.  Called with the inode lock held.
+ *
+ ****************************************************************************/
+
+void lazymount_start(FAR struct inode *mountpt);
+#endif
+
 #endif /* CONFIG_DISABLE_MOUNTPOINT */
 #endif /* __FS_MOUNT_MOUNT_H */
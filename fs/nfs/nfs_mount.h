@@ -58,10 +58,33 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_NFS_LOOKUP_CACHE
+#  define CONFIG_NFS_LOOKUP_CACHE 0
+#endif
+
+/* Longest name kept in the lookup cache */
+
+#define NFS_LOOKUP_NAMELEN 31
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+/* One cached LOOKUP result: the handle and attributes of 'name' in the
+ * directory 'dir'.
+ */
+
+struct nfs_lookup_s
+{
+  clock_t                   lc_stamp;         /* Time of the LOOKUP, 0 if unused */
+  struct file_handle        lc_dir;           /* Handle of the directory */
+  struct file_handle        lc_fhandle;       /* Handle of the entry */
+  struct nfs_fattr          lc_fattr;         /* Attributes of the entry */
+  char                      lc_name[NFS_LOOKUP_NAMELEN + 1];
+};
+#endif
+
 /* Mount structure. One mount structure is allocated for each NFS mount. This
  * structure holds NFS specific information for mount.
  */
@@ -80,6 +103,9 @@ struct nfsmount
   uint16_t                  nm_wsize;         /* Max size of write RPC */
   uint16_t                  nm_readdirsize;   /* Size of a readdir RPC */
   uint16_t                  nm_buflen;        /* Size of I/O buffer */
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+  struct nfs_lookup_s       nm_lookup[CONFIG_NFS_LOOKUP_CACHE];
+#endif
 
   /* Set aside memory on the stack to hold the largest call message.
    * NOTE that for the case of the write call message, it is the reply
@@ -99,6 +125,7 @@ struct nfsmount
     struct rpc_call_fs      fsstat;
     struct rpc_call_setattr setattr;
     struct rpc_call_fs      fsinfo;
+    struct rpc_call_commit  commit;
     struct rpc_reply_write  write;
   } nm_msgbuffer;
 
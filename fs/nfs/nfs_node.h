@@ -49,6 +49,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
+
 #include "nfs_proto.h"
 
 /****************************************************************************
@@ -71,6 +73,13 @@ struct nfsnode
   struct timespec     n_ctime;      /* File creation time */
   nfsfh_t             n_fhandle;    /* NFS File Handle */
   uint64_t            n_size;       /* Current size of file */
+#ifdef CONFIG_NFS_UNSTABLE_WRITE
+  bool                n_commit;     /* Unstable writes await a COMMIT */
+
+  /* Write verifier returned by the first unstable write */
+
+  uint8_t             n_verf[NFSX_V3WRITEVERF];
+#endif
 };
 
 #endif /* __FS_NFS_NFS_NODE_H */
@@ -518,6 +518,19 @@ struct RMDIR3resok
   struct wcc_data    dir_wcc;
 };
 
+struct COMMIT3args
+{
+  struct file_handle fhandle;                       /* Variable length */
+  nfsuint64          offset;
+  uint32_t           count;
+};
+
+struct COMMIT3resok
+{
+  struct wcc_data    file_wcc;
+  uint8_t            verf[NFSX_V3WRITEVERF];
+};
+
 struct READDIR3args
 {
   struct file_handle dir;                           /* Variable length */
@@ -38,6 +38,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+
 #include "rpc.h"
 #include "nfs.h"
 #include "nfs_proto.h"
@@ -101,6 +103,104 @@ static inline int nfs_pathsegment(FAR const char **path, FAR char *buffer,
     }
 }
 
+/****************************************************************************
+ * Name: nfs_lookup_find
+ *
+ * Description:
+ *   Look for an unexpired LOOKUP result of 'filename' in the directory
+ *   'fhandle'.  On a hit, fhandle and attributes are replaced by those of
+ *   the entry.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+static bool nfs_lookup_find(FAR struct nfsmount *nmp,
+                            FAR const char *filename,
+                            FAR struct file_handle *fhandle,
+                            FAR struct nfs_fattr *attributes)
+{
+  FAR struct nfs_lookup_s *lc;
+  clock_t now = clock_systime_ticks();
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_LOOKUP_CACHE; i++)
+    {
+      lc = &nmp->nm_lookup[i];
+      if (lc->lc_stamp == 0)
+        {
+          continue;
+        }
+
+      if (now - lc->lc_stamp >= SEC2TICK(CONFIG_NFS_LOOKUP_TIMEO))
+        {
+          lc->lc_stamp = 0;
+          continue;
+        }
+
+      if (lc->lc_dir.length == fhandle->length &&
+          memcmp(&lc->lc_dir.handle, &fhandle->handle,
+                 fhandle->length) == 0 &&
+          strcmp(lc->lc_name, filename) == 0)
+        {
+          memcpy(fhandle, &lc->lc_fhandle, sizeof(struct file_handle));
+          if (attributes)
+            {
+              memcpy(attributes, &lc->lc_fattr, sizeof(struct nfs_fattr));
+            }
+
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nfs_lookup_add
+ *
+ * Description:
+ *   Remember a LOOKUP result, replacing the oldest entry.
+ *
+ ****************************************************************************/
+
+static void nfs_lookup_add(FAR struct nfsmount *nmp,
+                           FAR const struct file_handle *dir,
+                           FAR const char *filename,
+                           FAR const struct file_handle *fhandle,
+                           FAR const struct nfs_fattr *attributes)
+{
+  FAR struct nfs_lookup_s *lc = &nmp->nm_lookup[0];
+  int i;
+
+  if (strlen(filename) > NFS_LOOKUP_NAMELEN)
+    {
+      return;
+    }
+
+  for (i = 1; i < CONFIG_NFS_LOOKUP_CACHE && lc->lc_stamp != 0; i++)
+    {
+      if (nmp->nm_lookup[i].lc_stamp == 0 ||
+          (sclock_t)(nmp->nm_lookup[i].lc_stamp - lc->lc_stamp) < 0)
+        {
+          lc = &nmp->nm_lookup[i];
+        }
+    }
+
+  memcpy(&lc->lc_dir, dir, sizeof(struct file_handle));
+  memcpy(&lc->lc_fhandle, fhandle, sizeof(struct file_handle));
+  memcpy(&lc->lc_fattr, attributes, sizeof(struct nfs_fattr));
+  strlcpy(lc->lc_name, filename, sizeof(lc->lc_name));
+
+  /* Zero marks an unused entry */
+
+  lc->lc_stamp = clock_systime_ticks();
+  if (lc->lc_stamp == 0)
+    {
+      lc->lc_stamp = 1;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -198,6 +298,9 @@ int nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
                FAR struct nfs_fattr *obj_attributes,
                FAR struct nfs_fattr *dir_attributes)
 {
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+  struct file_handle dir;
+#endif
   FAR uint32_t *ptr;
   uint32_t value;
   int reqlen;
@@ -215,6 +318,18 @@ int nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
       return -E2BIG;
     }
 
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+  /* Cached results carry no directory attributes */
+
+  if (dir_attributes == NULL &&
+      nfs_lookup_find(nmp, filename, fhandle, obj_attributes))
+    {
+      return OK;
+    }
+
+  memcpy(&dir, fhandle, sizeof(struct file_handle));
+#endif
+
   /* Initialize the request */
 
   ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.lookup.lookup;
@@ -286,6 +401,11 @@ int nfs_lookup(FAR struct nfsmount *nmp, FAR const char *filename,
           memcpy(obj_attributes, ptr, sizeof(struct nfs_fattr));
         }
 
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+      nfs_lookup_add(nmp, &dir, filename, fhandle,
+                     (FAR const struct nfs_fattr *)ptr);
+#endif
+
       ptr += uint32_increment(sizeof(struct nfs_fattr));
     }
 
@@ -528,3 +648,23 @@ void nfs_attrupdate(FAR struct nfsnode *np, FAR struct nfs_fattr *attributes)
   fxdr_nfsv3time(&attributes->fa_mtime, &np->n_mtime);
   fxdr_nfsv3time(&attributes->fa_ctime, &np->n_ctime);
 }
+
+/****************************************************************************
+ * Name: nfs_lookup_invalidate
+ *
+ * Description:
+ *   Forget all cached LOOKUP results after the file system was modified.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFS_LOOKUP_CACHE > 0
+void nfs_lookup_invalidate(FAR struct nfsmount *nmp)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NFS_LOOKUP_CACHE; i++)
+    {
+      nmp->nm_lookup[i].lc_stamp = 0;
+    }
+}
+#endif
@@ -336,6 +336,7 @@ static int nfs_filecreate(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
 
   /* Send the NFS request. */
 
+  nfs_lookup_invalidate(nmp);
   nfs_statistics(NFSPROC_CREATE);
   ret = nfs_request(nmp, NFSPROC_CREATE,
                     &nmp->nm_msgbuffer.create, reqlen,
@@ -503,6 +504,7 @@ static int nfs_filechstat(FAR struct nfsmount *nmp, FAR struct nfsnode *np,
 
   /* Perform the SETATTR RPC */
 
+  nfs_lookup_invalidate(nmp);
   nfs_statistics(NFSPROC_SETATTR);
   ret = nfs_request(nmp, NFSPROC_SETATTR,
                     &nmp->nm_msgbuffer.setattr, reqlen,
@@ -764,6 +766,90 @@ errout_with_lock:
   return ret;
 }
 
+/****************************************************************************
+ * Name: nfs_filecommit
+ *
+ * Description:
+ *   Ask the server to commit the unstable writes of the file to stable
+ *   storage.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.  -EIO means that
+ *   the server lost some of the data written since the last COMMIT.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NFS_UNSTABLE_WRITE
+static int nfs_filecommit(FAR struct nfsmount *nmp, FAR struct nfsnode *np)
+{
+  FAR uint32_t *ptr;
+  uint32_t      tmp;
+  size_t        reqlen;
+  int           ret;
+
+  if (!np->n_commit)
+    {
+      return OK;
+    }
+
+  /* Commit the whole file: offset 0 and count 0 */
+
+  ptr     = (FAR uint32_t *)&nmp->nm_msgbuffer.commit.commit;
+  reqlen  = 0;
+
+  *ptr++  = txdr_unsigned((uint32_t)np->n_fhsize);
+  reqlen += sizeof(uint32_t);
+
+  memcpy(ptr, &np->n_fhandle, np->n_fhsize);
+  reqlen += uint32_alignup(np->n_fhsize);
+  ptr    += uint32_increment(np->n_fhsize);
+
+  txdr_hyper((uint64_t)0, ptr);
+  ptr    += 2;
+  reqlen += 2 * sizeof(uint32_t);
+
+  *ptr    = 0;
+  reqlen += sizeof(uint32_t);
+
+  nfs_statistics(NFSPROC_COMMIT);
+  ret = nfs_request(nmp, NFSPROC_COMMIT,
+                    &nmp->nm_msgbuffer.commit, reqlen,
+                    nmp->nm_iobuffer, nmp->nm_buflen);
+  if (ret)
+    {
+      ferr("ERROR: nfs_request failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Skip the WCC attributes before the operation and use the ones after */
+
+  ptr = (FAR uint32_t *)
+    &((FAR struct rpc_reply_commit *)nmp->nm_iobuffer)->commit;
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      ptr += uint32_increment(sizeof(struct wcc_attr));
+    }
+
+  tmp = *ptr++;
+  if (tmp != 0)
+    {
+      nfs_attrupdate(np, (FAR struct nfs_fattr *)ptr);
+      ptr += uint32_increment(sizeof(struct nfs_fattr));
+    }
+
+  np->n_commit = false;
+  if (memcmp(ptr, np->n_verf, NFSX_V3WRITEVERF) != 0)
+    {
+      ferr("ERROR: Server restarted, unstable writes lost\n");
+      return -EIO;
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: nfs_close
  *
@@ -821,6 +907,14 @@ static int nfs_close(FAR struct file *filep)
 
   else
     {
+#ifdef CONFIG_NFS_UNSTABLE_WRITE
+      /* Commit the writes before the last reference goes away, the error
+       * is the only chance to tell the application that data was lost.
+       */
+
+      int errcode = nfs_filecommit(nmp, np);
+#endif
+
       /* Assume file structure won't be found. This should never happen. */
 
       ret = -EINVAL;
@@ -855,6 +949,13 @@ static int nfs_close(FAR struct file *filep)
               break;
             }
         }
+
+#ifdef CONFIG_NFS_UNSTABLE_WRITE
+      if (ret == OK && errcode < 0)
+        {
+          ret = errcode;
+        }
+#endif
     }
 
   filep->f_priv = NULL;
@@ -1056,6 +1157,11 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
   uint32_t             tmp;
   int                  commit = 0;
   int                  committed = NFSV3WRITE_FILESYNC;
+#ifdef CONFIG_NFS_UNSTABLE_WRITE
+  int                  stable = NFSV3WRITE_UNSTABLE;
+#else
+  int                  stable = NFSV3WRITE_FILESYNC;
+#endif
   int                  ret;
 
   finfo("Write %zu bytes to offset %jd\n",
@@ -1137,7 +1243,7 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
       /* Copy the count and stable values */
 
       *ptr++  = txdr_unsigned(writesize);
-      *ptr++  = txdr_unsigned(committed);
+      *ptr++  = txdr_unsigned(stable);
       reqlen += 2*sizeof(uint32_t);
 
       /* Copy a chunk of the user data into the I/O buffer */
@@ -1149,6 +1255,7 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
 
       /* Perform the write */
 
+      nfs_lookup_invalidate(nmp);
       nfs_statistics(NFSPROC_WRITE);
       ret = nfs_request(nmp, NFSPROC_WRITE,
                         nmp->nm_iobuffer, reqlen,
@@ -1200,7 +1307,9 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
 
       /* Determine the lowest commitment level obtained by any of the RPCs. */
 
-      commit = *ptr++;
+      commit = fxdr_unsigned(uint32_t, *ptr);
+      ptr++;
+
       if (committed == NFSV3WRITE_FILESYNC)
         {
           committed = commit;
@@ -1211,6 +1320,19 @@ static ssize_t nfs_write(FAR struct file *filep, FAR const char *buffer,
           committed = commit;
         }
 
+#ifdef CONFIG_NFS_UNSTABLE_WRITE
+      /* Keep the verifier of the first unstable write.  If the server
+       * restarts before the COMMIT, the verifier changes and the COMMIT
+       * reports the loss.
+       */
+
+      if (commit != NFSV3WRITE_FILESYNC && !np->n_commit)
+        {
+          memcpy(np->n_verf, ptr, NFSX_V3WRITEVERF);
+          np->n_commit = true;
+        }
+#endif
+
       /* Update the read state data */
 
       filep->f_pos += writesize;
@@ -1298,7 +1420,30 @@ static off_t nfs_seek(FAR struct file *filep, off_t offset, int whence)
 
 static int nfs_sync(FAR struct file *filep)
 {
+#ifdef CONFIG_NFS_UNSTABLE_WRITE
+  FAR struct nfsmount *nmp;
+  FAR struct nfsnode  *np;
+  int                  ret;
+
+  DEBUGASSERT(filep->f_priv != NULL);
+
+  nmp = filep->f_inode->i_private;
+  np  = (FAR struct nfsnode *)filep->f_priv;
+
+  DEBUGASSERT(nmp != NULL);
+
+  ret = nxmutex_lock(&nmp->nm_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nfs_filecommit(nmp, np);
+  nxmutex_unlock(&nmp->nm_lock);
+  return ret;
+#else
   return 0;
+#endif
 }
 
 /****************************************************************************
@@ -2507,6 +2652,7 @@ static int nfs_remove(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Perform the REMOVE RPC call */
 
+  nfs_lookup_invalidate(nmp);
   nfs_statistics(NFSPROC_REMOVE);
   ret = nfs_request(nmp, NFSPROC_REMOVE,
                     &nmp->nm_msgbuffer.removef, reqlen,
@@ -2630,6 +2776,7 @@ static int nfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Perform the MKDIR RPC */
 
+  nfs_lookup_invalidate(nmp);
   nfs_statistics(NFSPROC_MKDIR);
   ret = nfs_request(nmp, NFSPROC_MKDIR,
                     &nmp->nm_msgbuffer.mkdir, reqlen,
@@ -2717,6 +2864,7 @@ static int nfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Perform the RMDIR RPC */
 
+  nfs_lookup_invalidate(nmp);
   nfs_statistics(NFSPROC_RMDIR);
   ret = nfs_request(nmp, NFSPROC_RMDIR,
                     &nmp->nm_msgbuffer.rmdir, reqlen,
@@ -2830,6 +2978,7 @@ static int nfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
 
   /* Perform the RENAME RPC */
 
+  nfs_lookup_invalidate(nmp);
   nfs_statistics(NFSPROC_RENAME);
   ret = nfs_request(nmp, NFSPROC_RENAME,
                     &nmp->nm_msgbuffer.renamef, reqlen,
@@ -329,6 +329,12 @@ struct rpc_call_fs
   struct FS3args fs;
 };
 
+struct rpc_call_commit
+{
+  struct rpc_call_header ch;
+  struct COMMIT3args commit;
+};
+
 /* Generic RPC reply headers */
 
 struct rpc_reply_header
@@ -414,6 +420,12 @@ struct rpc_reply_rmdir
   struct RMDIR3resok rmdir;
 };
 
+struct rpc_reply_commit
+{
+  struct nfs_reply_header rh;
+  struct COMMIT3resok commit;
+};
+
 struct rpc_reply_readdir
 {
   struct nfs_reply_header rh;
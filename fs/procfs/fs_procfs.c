@@ -56,21 +56,29 @@
  * External Definitions
  ****************************************************************************/
 
+extern const struct procfs_operations g_boottrace_operations;
 extern const struct procfs_operations g_clk_operations;
 extern const struct procfs_operations g_cpuinfo_operations;
 extern const struct procfs_operations g_cpuload_operations;
 extern const struct procfs_operations g_critmon_operations;
+extern const struct procfs_operations g_critsite_operations;
 extern const struct procfs_operations g_fdt_operations;
+extern const struct procfs_operations g_ftrace_operations;
+extern const struct procfs_operations g_heapprof_operations;
 extern const struct procfs_operations g_iobinfo_operations;
 extern const struct procfs_operations g_irq_operations;
+extern const struct procfs_operations g_latency_operations;
 extern const struct procfs_operations g_meminfo_operations;
 extern const struct procfs_operations g_memdump_operations;
 extern const struct procfs_operations g_mempool_operations;
 extern const struct procfs_operations g_module_operations;
 extern const struct procfs_operations g_pm_operations;
+extern const struct procfs_operations g_pmu_operations;
+extern const struct procfs_operations g_sampler_operations;
 extern const struct procfs_operations g_proc_operations;
 extern const struct procfs_operations g_tcbinfo_operations;
 extern const struct procfs_operations g_thermal_operations;
+extern const struct procfs_operations g_tracepoint_operations;
 extern const struct procfs_operations g_uptime_operations;
 extern const struct procfs_operations g_version_operations;
 extern const struct procfs_operations g_pressure_operations;
@@ -104,6 +112,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "[0-9]*",       &g_proc_operations,     PROCFS_DIR_TYPE    },
 #endif
 
+#ifdef CONFIG_SCHED_BOOTTRACE
+  { "boottrace",    &g_boottrace_operations, PROCFS_FILE_TYPE  },
+#endif
+
 #if defined(CONFIG_CLK) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CLK)
   { "clk",          &g_clk_operations,      PROCFS_FILE_TYPE   },
 #endif
@@ -121,6 +133,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "critmon",      &g_critmon_operations,  PROCFS_FILE_TYPE   },
 #endif
 
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+  { "critsite",     &g_critsite_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_DEVICE_TREE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_FDT)
   { "fdt",          &g_fdt_operations,      PROCFS_FILE_TYPE   },
 #endif
@@ -141,6 +157,14 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/usage",     &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_FTRACE
+  { "ftrace",       &g_ftrace_operations,   PROCFS_FILE_TYPE   },
+#endif
+
+#ifdef CONFIG_MM_HEAPPROF
+  { "heapprof",     &g_heapprof_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_MM_IOB) && !defined(CONFIG_FS_PROCFS_EXCLUDE_IOBINFO)
   { "iobinfo",      &g_iobinfo_operations,  PROCFS_FILE_TYPE   },
 #endif
@@ -149,6 +173,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "irqs",         &g_irq_operations,      PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY
+  { "latency",      &g_latency_operations,  PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMINFO
 #  ifndef CONFIG_FS_PROCFS_EXCLUDE_MEMDUMP
   { "memdump",      &g_memdump_operations,  PROCFS_FILE_TYPE   },
@@ -182,11 +210,19 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "pm/**",        &g_pm_operations,       PROCFS_UNKOWN_TYPE },
 #endif
 
+#ifdef CONFIG_SCHED_PMU
+  { "pmu",          &g_pmu_operations,      PROCFS_FILE_TYPE   },
+#endif
+
 #ifdef CONFIG_FS_PROCFS_INCLUDE_PRESSURE
   { "pressure",     &g_pressure_operations, PROCFS_DIR_TYPE    },
   { "pressure/**",  &g_pressure_operations, PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_SAMPLER
+  { "sampler",      &g_sampler_operations,  PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_PROCESS
   { "self",         &g_proc_operations,     PROCFS_DIR_TYPE    },
   { "self/**",      &g_proc_operations,     PROCFS_UNKOWN_TYPE },
@@ -201,6 +237,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "thermal/**",   &g_thermal_operations,  PROCFS_UNKOWN_TYPE },
 #endif
 
+#ifdef CONFIG_SCHED_TRACEPOINTS
+  { "tracepoints",  &g_tracepoint_operations, PROCFS_FILE_TYPE },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_UPTIME
   { "uptime",       &g_uptime_operations,   PROCFS_FILE_TYPE   },
 #endif
@@ -0,0 +1,298 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsboottrace.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_BOOTTRACE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BOOTTRACE_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct boottrace_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[BOOTTRACE_LINELEN];   /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     boottrace_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     boottrace_close(FAR struct file *filep);
+static ssize_t boottrace_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     boottrace_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     boottrace_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_boottrace_operations =
+{
+  boottrace_open,   /* open */
+  boottrace_close,  /* close */
+  boottrace_read,   /* read */
+  NULL,             /* write */
+  NULL,             /* poll */
+  boottrace_dup,    /* dup */
+  NULL,             /* opendir */
+  NULL,             /* closedir */
+  NULL,             /* readdir */
+  NULL,             /* rewinddir */
+  boottrace_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static unsigned long boottrace_usec(clock_t time)
+{
+  struct timespec ts;
+
+  perf_convert(time, &ts);
+  return (unsigned long)ts.tv_sec * USEC_PER_SEC +
+         ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: boottrace_open
+ ****************************************************************************/
+
+static int boottrace_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct boottrace_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = fs_heap_zalloc(sizeof(struct boottrace_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boottrace_close
+ ****************************************************************************/
+
+static int boottrace_close(FAR struct file *filep)
+{
+  FAR struct boottrace_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boottrace_read
+ ****************************************************************************/
+
+static ssize_t boottrace_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct boottrace_file_s *procfile;
+  FAR const struct boottrace_s *trace;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int count;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* The first line is the headers, then one line per phase */
+
+  linesize  = procfs_snprintf(procfile->line, BOOTTRACE_LINELEN,
+                              "%10s %10s %10s %3s %s\n",
+                              "BEGIN(us)", "END(us)", "TIME(us)",
+                              "CPU", "PHASE");
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  trace = nxboot_trace(&count);
+  for (i = 0; i < count; i++)
+    {
+      buffer   += copysize;
+      buflen   -= copysize;
+
+      linesize  = procfs_snprintf(procfile->line, BOOTTRACE_LINELEN,
+                                  "%10lu %10lu %10lu %3u %s\n",
+                                  boottrace_usec(trace[i].begin),
+                                  boottrace_usec(trace[i].end),
+                                  boottrace_usec(trace[i].end -
+                                                 trace[i].begin),
+                                  trace[i].cpu, trace[i].name);
+      copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: boottrace_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int boottrace_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct boottrace_file_s *oldattr;
+  FAR struct boottrace_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct boottrace_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct boottrace_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: boottrace_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int boottrace_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "boottrace" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_BOOTTRACE */
@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -59,7 +60,7 @@
  * to handle the longest line generated by this logic.
  */
 
-#define CRITMON_LINELEN 64
+#define CRITMON_LINELEN 96
 
 /****************************************************************************
  * Private Types
@@ -85,6 +86,10 @@ static int     critmon_open(FAR struct file *filep, FAR const char *relpath,
 static int     critmon_close(FAR struct file *filep);
 static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+static ssize_t critsite_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+#endif
 static int     critmon_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     critmon_stat(FAR const char *relpath, FAR struct stat *buf);
@@ -116,6 +121,26 @@ const struct procfs_operations g_critmon_operations =
   critmon_stat        /* stat */
 };
 
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+const struct procfs_operations g_critsite_operations =
+{
+  critmon_open,       /* open */
+  critmon_close,      /* close */
+  critsite_read,      /* read */
+  NULL,               /* write */
+  NULL,               /* poll */
+
+  critmon_dup,        /* dup */
+
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+
+  critmon_stat        /* stat */
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -331,6 +356,72 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
   return ret;
 }
 
+/****************************************************************************
+ * Name: critsite_read
+ *
+ * Description:
+ *   One line per critical section caller: the caller address, the number
+ *   of entries, how many of them had to wait for another CPU, and the
+ *   maximum holding, total holding and total waiting times.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+static ssize_t critsite_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct critmon_file_s *attr;
+  FAR struct critmon_site_s *site;
+  struct timespec maxtime;
+  struct timespec total;
+  struct timespec wait;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize = 0;
+  off_t offset;
+  int i;
+
+  attr = (FAR struct critmon_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset = filep->f_pos;
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_CSECTION_SITES && buflen > 0;
+       i++)
+    {
+      site = &g_crit_sites[i];
+      if (site->caller == NULL)
+        {
+          continue;
+        }
+
+      perf_convert(site->max, &maxtime);
+      perf_convert(site->total, &total);
+      perf_convert(site->wait, &wait);
+
+      linesize = procfs_snprintf(attr->line, CRITMON_LINELEN,
+                                 "%p,%" PRIu32 ",%" PRIu32
+                                 ",%lu.%09lu,%lu.%09lu,%lu.%09lu\n",
+                                 site->caller, site->count, site->contended,
+                                 (unsigned long)maxtime.tv_sec,
+                                 (unsigned long)maxtime.tv_nsec,
+                                 (unsigned long)total.tv_sec,
+                                 (unsigned long)total.tv_nsec,
+                                 (unsigned long)wait.tv_sec,
+                                 (unsigned long)wait.tv_nsec);
+      copysize = procfs_memcpy(attr->line, linesize, buffer, buflen,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      buflen    -= copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_dup
  *
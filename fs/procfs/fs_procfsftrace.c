@@ -0,0 +1,438 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsftrace.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/param.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/allsyms.h>
+#include <nuttx/arch.h>
+#include <nuttx/ftrace.h>
+#include <nuttx/symtab.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_FTRACE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define FTRACE_LINELEN 192
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Where the reader of one open "file" is */
+
+enum ftrace_state_e
+{
+  FTRACE_HEADER = 0,
+  FTRACE_EVENTS,
+  FTRACE_TRAILER,
+  FTRACE_DONE
+};
+
+/* This structure describes one open "file" */
+
+struct ftrace_file_s
+{
+  struct procfs_file_s base;  /* Base open file structure */
+  bool paused;                /* Opened for reading, the tracer is paused */
+  uint8_t state;              /* See enum ftrace_state_e */
+  bool comma;                 /* An event was written */
+  int cpu;                    /* The CPU of the next record */
+  size_t pos;                 /* The next record of cpu */
+  size_t linelen;             /* Length of line */
+  size_t linepos;             /* Bytes of line already read */
+  char line[FTRACE_LINELEN];  /* Buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     ftrace_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     ftrace_close(FAR struct file *filep);
+static ssize_t ftrace_read_file(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t ftrace_write_file(FAR struct file *filep,
+                 FAR const char *buffer, size_t buflen);
+static int     ftrace_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     ftrace_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_ftrace_operations =
+{
+  ftrace_open,        /* open */
+  ftrace_close,       /* close */
+  ftrace_read_file,   /* read */
+  ftrace_write_file,  /* write */
+  NULL,               /* poll */
+  ftrace_dup,         /* dup */
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+  ftrace_stat         /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftrace_us
+ *
+ * Description:
+ *   Convert up_perf_gettime() ticks to the microseconds of the trace event
+ *   format, with three decimals.
+ *
+ ****************************************************************************/
+
+static int ftrace_us(FAR char *buf, size_t len, clock_t ticks)
+{
+  struct timespec ts;
+  uint64_t ns;
+
+  up_perf_convert(ticks, &ts);
+  ns = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+  return snprintf(buf, len, "%" PRIu64 ".%03u", ns / 1000,
+                  (unsigned int)(ns % 1000));
+}
+
+/****************************************************************************
+ * Name: ftrace_nextline
+ *
+ * Description:
+ *   Format the next line of the trace, false at the end.  The trace is in
+ *   the JSON trace event format that Perfetto and chrome://tracing load,
+ *   one event per record: "B" and "E" for entries and exits, "X" with the
+ *   duration in graph mode.
+ *
+ ****************************************************************************/
+
+static bool ftrace_nextline(FAR struct ftrace_file_s *procfile)
+{
+  struct ftrace_entry_s entry;
+  FAR const char *name = NULL;
+  char addr[2 + 2 * sizeof(uintptr_t) + 1];
+  char ts[24];
+  char dur[24];
+  int ret;
+
+  procfile->linepos = 0;
+  procfile->linelen = 0;
+
+  switch (procfile->state)
+    {
+      case FTRACE_HEADER:
+        ret = snprintf(procfile->line, FTRACE_LINELEN,
+                       "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        procfile->state = FTRACE_EVENTS;
+        break;
+
+      case FTRACE_EVENTS:
+        while (!ftrace_read(procfile->cpu, &procfile->pos, &entry))
+          {
+            procfile->pos = 0;
+            if (++procfile->cpu >= CONFIG_SMP_NCPUS)
+              {
+                procfile->state = FTRACE_TRAILER;
+                return ftrace_nextline(procfile);
+              }
+          }
+
+#ifdef CONFIG_ALLSYMS
+        {
+          FAR const struct symtab_s *sym;
+          size_t size;
+
+          sym = allsyms_findbyvalue((FAR void *)entry.func, &size);
+          if (sym != NULL)
+            {
+              name = sym->sym_name;
+            }
+        }
+#endif
+
+        if (name == NULL)
+          {
+            snprintf(addr, sizeof(addr), "0x%" PRIxPTR, entry.func);
+            name = addr;
+          }
+
+        ftrace_us(ts, sizeof(ts), entry.time);
+        dur[0] = '\0';
+        if (entry.type == FTRACE_GRAPH)
+          {
+            strlcpy(dur, ",\"dur\":", sizeof(dur));
+            ftrace_us(dur + 7, sizeof(dur) - 7, entry.duration);
+          }
+
+        ret = snprintf(procfile->line, FTRACE_LINELEN,
+                       "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%s%s,"
+                       "\"pid\":0,\"tid\":%d,\"args\":{\"cpu\":%d,"
+                       "\"depth\":%u}}\n",
+                       procfile->comma ? "," : "", name,
+                       entry.type == FTRACE_ENTER ? 'B' :
+                       entry.type == FTRACE_EXIT ? 'E' : 'X', ts, dur,
+                       (int)entry.pid, procfile->cpu, entry.depth);
+        procfile->comma = true;
+        break;
+
+      case FTRACE_TRAILER:
+        ret = snprintf(procfile->line, FTRACE_LINELEN, "]}\n");
+        procfile->state = FTRACE_DONE;
+        break;
+
+      default:
+        return false;
+    }
+
+  procfile->linelen = MIN(ret, FTRACE_LINELEN - 1);
+  return true;
+}
+
+/****************************************************************************
+ * Name: ftrace_open
+ ****************************************************************************/
+
+static int ftrace_open(FAR struct file *filep, FAR const char *relpath,
+                       int oflags, mode_t mode)
+{
+  FAR struct ftrace_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = fs_heap_zalloc(sizeof(struct ftrace_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The records do not move while they are read */
+
+  if ((oflags & O_RDOK) != 0)
+    {
+      procfile->paused = true;
+      ftrace_pause(true);
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftrace_close
+ ****************************************************************************/
+
+static int ftrace_close(FAR struct file *filep)
+{
+  FAR struct ftrace_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  if (procfile->paused)
+    {
+      ftrace_pause(false);
+    }
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftrace_read_file
+ *
+ * Description:
+ *   The trace is read from the start to the end, seeking is not
+ *   supported.
+ *
+ ****************************************************************************/
+
+static ssize_t ftrace_read_file(FAR struct file *filep, FAR char *buffer,
+                                size_t buflen)
+{
+  FAR struct ftrace_file_s *procfile;
+  size_t totalsize = 0;
+  size_t copysize;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  while (totalsize < buflen)
+    {
+      if (procfile->linepos >= procfile->linelen &&
+          !ftrace_nextline(procfile))
+        {
+          break;
+        }
+
+      copysize = MIN(buflen - totalsize,
+                     procfile->linelen - procfile->linepos);
+      memcpy(buffer + totalsize, procfile->line + procfile->linepos,
+             copysize);
+      procfile->linepos += copysize;
+      totalsize         += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: ftrace_write_file
+ *
+ * Description:
+ *   One ftrace_command() per line.
+ *
+ ****************************************************************************/
+
+static ssize_t ftrace_write_file(FAR struct file *filep,
+                                 FAR const char *buffer, size_t buflen)
+{
+  char line[64];
+  size_t len;
+  int ret;
+
+  len = MIN(buflen, sizeof(line) - 1);
+  memcpy(line, buffer, len);
+  line[len] = '\0';
+  line[strcspn(line, "\n")] = '\0';
+
+  ret = ftrace_command(line);
+  return ret < 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Name: ftrace_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int ftrace_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct ftrace_file_s *oldattr;
+  FAR struct ftrace_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct ftrace_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct ftrace_file_s));
+  if (newattr->paused)
+    {
+      ftrace_pause(true);
+    }
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ftrace_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int ftrace_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_FTRACE */
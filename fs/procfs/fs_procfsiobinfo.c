@@ -59,6 +59,13 @@
 
 #define IOBINFO_LINELEN 80
 
+/* Additional I/O buffer classes are reported in a second table */
+
+#if CONFIG_IOB_PERCPU_CACHE > 0 || CONFIG_IOB_SMALL_NBUFFERS > 0 || \
+    CONFIG_IOB_ELASTIC_NBUFFERS > 0
+#  define IOBINFO_CLASSES
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -223,6 +230,64 @@ static ssize_t iobinfo_read(FAR struct file *filep, FAR char *buffer,
                              &offset);
   totalsize += copysize;
 
+#ifdef IOBINFO_CLASSES
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  /* The third line is the headers of the per-class statistics */
+
+  linesize   = 0;
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  linesize  += procfs_snprintf(iobfile->line + linesize,
+                               IOBINFO_LINELEN - linesize,
+                               "%10s", "ncached");
+#endif
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  linesize  += procfs_snprintf(iobfile->line + linesize,
+                               IOBINFO_LINELEN - linesize,
+                               "%10s%11s", "nsmall", "nsmallfree");
+#endif
+#if CONFIG_IOB_ELASTIC_NBUFFERS > 0
+  linesize  += procfs_snprintf(iobfile->line + linesize,
+                               IOBINFO_LINELEN - linesize,
+                               "%10s", "nelastic");
+#endif
+  linesize  += procfs_snprintf(iobfile->line + linesize,
+                               IOBINFO_LINELEN - linesize, "\n");
+
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+
+  buffer    += copysize;
+  buflen    -= copysize;
+
+  /* The fourth line is the per-class statistics */
+
+  linesize   = 0;
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  linesize  += procfs_snprintf(iobfile->line + linesize,
+                               IOBINFO_LINELEN - linesize,
+                               "%10d", stats.ncached);
+#endif
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  linesize  += procfs_snprintf(iobfile->line + linesize,
+                               IOBINFO_LINELEN - linesize,
+                               "%10d%11d", stats.nsmall, stats.nsmallfree);
+#endif
+#if CONFIG_IOB_ELASTIC_NBUFFERS > 0
+  linesize  += procfs_snprintf(iobfile->line + linesize,
+                               IOBINFO_LINELEN - linesize,
+                               "%10d", stats.nelastic);
+#endif
+  linesize  += procfs_snprintf(iobfile->line + linesize,
+                               IOBINFO_LINELEN - linesize, "\n");
+
+  copysize   = procfs_memcpy(iobfile->line, linesize, buffer, buflen,
+                             &offset);
+  totalsize += copysize;
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
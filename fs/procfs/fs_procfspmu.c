@@ -0,0 +1,369 @@
+/****************************************************************************
+ * fs/procfs/fs_procfspmu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_PMU)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* One line holds a CPU number and one column per counter */
+
+#define PMU_COLUMN  16
+#define PMU_LINELEN (8 + CONFIG_SCHED_PMU_NCOUNTERS * (PMU_COLUMN + 1) + 2)
+
+/* The longest event list that a write may hold */
+
+#define PMU_WRITELEN 128
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct pmu_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[PMU_LINELEN];         /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     pmu_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     pmu_close(FAR struct file *filep);
+static ssize_t pmu_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t pmu_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     pmu_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     pmu_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_pmu_operations =
+{
+  pmu_open,       /* open */
+  pmu_close,      /* close */
+  pmu_read,       /* read */
+  pmu_write,      /* write */
+  NULL,           /* poll */
+  pmu_dup,        /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  pmu_stat        /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pmu_open
+ ****************************************************************************/
+
+static int pmu_open(FAR struct file *filep, FAR const char *relpath,
+                    int oflags, mode_t mode)
+{
+  FAR struct pmu_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = fs_heap_zalloc(sizeof(struct pmu_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pmu_close
+ ****************************************************************************/
+
+static int pmu_close(FAR struct file *filep)
+{
+  FAR struct pmu_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pmu_read
+ *
+ * Description:
+ *   A header with the events being counted, then one line per CPU.
+ *
+ ****************************************************************************/
+
+static ssize_t pmu_read(FAR struct file *filep, FAR char *buffer,
+                        size_t buflen)
+{
+  FAR struct pmu_file_s *procfile;
+  uint64_t counts[CONFIG_SCHED_PMU_NCOUNTERS];
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int event;
+  int cpu;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  linesize = procfs_snprintf(procfile->line, PMU_LINELEN, "%-7s", "CPU");
+  for (i = 0; i < CONFIG_SCHED_PMU_NCOUNTERS; i++)
+    {
+      event = nxsched_pmu_event(i);
+      if (event != PMU_EVENT_NONE)
+        {
+          linesize += procfs_snprintf(procfile->line + linesize,
+                                      PMU_LINELEN - linesize, " %*s",
+                                      PMU_COLUMN, nxsched_pmu_name(event));
+        }
+    }
+
+  linesize += procfs_snprintf(procfile->line + linesize,
+                              PMU_LINELEN - linesize, "\n");
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && totalsize < buflen; cpu++)
+    {
+      buffer   += copysize;
+      buflen   -= copysize;
+
+      nxsched_pmu_cpu(cpu, counts);
+      linesize  = procfs_snprintf(procfile->line, PMU_LINELEN, "%-7d", cpu);
+      for (i = 0; i < CONFIG_SCHED_PMU_NCOUNTERS; i++)
+        {
+          if (nxsched_pmu_event(i) != PMU_EVENT_NONE)
+            {
+              linesize += procfs_snprintf(procfile->line + linesize,
+                                          PMU_LINELEN - linesize,
+                                          " %*" PRIu64, PMU_COLUMN,
+                                          counts[i]);
+            }
+        }
+
+      linesize  += procfs_snprintf(procfile->line + linesize,
+                                   PMU_LINELEN - linesize, "\n");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: pmu_write
+ *
+ * Description:
+ *   Take the list of events to count, their names separated by spaces or
+ *   commas, e.g. "cycles instructions cache-misses".  "none" stops the
+ *   counting.  The counts start again from zero.
+ *
+ ****************************************************************************/
+
+static ssize_t pmu_write(FAR struct file *filep, FAR const char *buffer,
+                         size_t buflen)
+{
+  int events[CONFIG_SCHED_PMU_NCOUNTERS];
+  FAR const char *name;
+  size_t len;
+  size_t pos = 0;
+  int nevents = 0;
+  int event;
+  int ret;
+
+  if (buflen > PMU_WRITELEN)
+    {
+      return -EINVAL;
+    }
+
+  while (pos < buflen)
+    {
+      if (isspace(buffer[pos]) || buffer[pos] == ',')
+        {
+          pos++;
+          continue;
+        }
+
+      for (len = 0; pos + len < buflen && !isspace(buffer[pos + len]) &&
+                    buffer[pos + len] != ','; len++);
+
+      for (event = PMU_EVENT_NONE; event < PMU_EVENT_MAX; event++)
+        {
+          name = nxsched_pmu_name(event);
+          if (strlen(name) == len && strncmp(buffer + pos, name, len) == 0)
+            {
+              break;
+            }
+        }
+
+      if (event >= PMU_EVENT_MAX)
+        {
+          return -EINVAL;
+        }
+      else if (event != PMU_EVENT_NONE)
+        {
+          if (nevents >= CONFIG_SCHED_PMU_NCOUNTERS)
+            {
+              return -E2BIG;
+            }
+
+          events[nevents++] = event;
+        }
+
+      pos += len;
+    }
+
+  ret = nxsched_pmu_setup(events, nevents);
+  return ret < 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Name: pmu_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int pmu_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct pmu_file_s *oldattr;
+  FAR struct pmu_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct pmu_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct pmu_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pmu_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int pmu_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_PMU */
@@ -26,9 +26,12 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <poll.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 
 #include <nuttx/fs/procfs.h>
@@ -36,10 +39,24 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/queue.h>
+#include <nuttx/sched.h>
 #include <nuttx/spinlock.h>
+#include <nuttx/wdog.h>
 
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PRESSURE
+#  define PRESSURE_NFILES (1 + SCHED_PRESSURE_NRES)
+#  define PRESSURE_TRIGGER_TICKS \
+     MAX(MSEC2TICK(CONFIG_FS_PROCFS_PRESSURE_TRIGGER_PERIOD), 1)
+#else
+#  define PRESSURE_NFILES 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -52,6 +69,15 @@ struct pressure_file_s
   size_t threshold;                 /* Memory notification threshold */
   clock_t lasttick;                 /* Last time notified */
   clock_t interval;                 /* Notification interval in us */
+#ifdef CONFIG_SCHED_PRESSURE
+  int type;                         /* Resource stalled on, -1 for memory */
+  uint64_t stall;                   /* Trigger threshold in us, 0 if none */
+  clock_t window;                   /* Trigger window in ticks */
+  clock_t winstart;                 /* Start of the current window */
+  uint64_t wintotal;                /* Stalled time at winstart */
+  bool notified;                    /* Triggered in the current window */
+  bool pending;                     /* Triggered while nobody polled */
+#endif
 };
 
 /****************************************************************************
@@ -63,6 +89,24 @@ static spinlock_t g_pressure_lock;
 static size_t g_remaining;
 static size_t g_largest;
 
+/* The files, the stall ones are named after enum sched_pressure_e */
+
+static FAR const char * const g_pressure_names[PRESSURE_NFILES] =
+{
+  "memory",
+#ifdef CONFIG_SCHED_PRESSURE
+  "cpu",
+  "io",
+  "net"
+#endif
+};
+
+#ifdef CONFIG_SCHED_PRESSURE
+static dq_queue_t g_pressure_stall_queue;
+static struct wdog_s g_pressure_timer;
+static int g_pressure_ntriggers;
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -109,6 +153,213 @@ const struct procfs_operations g_pressure_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: pressure_lookup
+ *
+ * Description:
+ *   The index in g_pressure_names of the file at relpath, or -ENOENT.
+ *
+ ****************************************************************************/
+
+static int pressure_lookup(FAR const char *relpath)
+{
+  int i;
+
+  if (strncmp(relpath, "pressure/", 9) == 0)
+    {
+      for (i = 0; i < PRESSURE_NFILES; i++)
+        {
+          if (strcmp(relpath + 9, g_pressure_names[i]) == 0)
+            {
+              return i;
+            }
+        }
+    }
+
+  return -ENOENT;
+}
+
+#ifdef CONFIG_SCHED_PRESSURE
+/****************************************************************************
+ * Name: pressure_queue
+ ****************************************************************************/
+
+static FAR dq_queue_t *pressure_queue(FAR struct pressure_file_s *priv)
+{
+  return priv->type < 0 ? &g_pressure_memory_queue :
+                          &g_pressure_stall_queue;
+}
+
+/****************************************************************************
+ * Name: pressure_trigger
+ *
+ * Description:
+ *   Check the stall triggers, every CONFIG_FS_PROCFS_PRESSURE_TRIGGER_PERIOD
+ *   milliseconds while at least one is set.  A trigger fires at most once
+ *   per window, once the stalled time in the window reaches its threshold.
+ *
+ ****************************************************************************/
+
+static void pressure_trigger(wdparm_t arg)
+{
+  struct sched_pressure_s info[SCHED_PRESSURE_NRES];
+  clock_t current = clock_systime_ticks();
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *tmp;
+  uint32_t flags;
+  uint64_t total;
+  int i;
+
+  for (i = 0; i < SCHED_PRESSURE_NRES; i++)
+    {
+      nxsched_pressure_read(i, &info[i]);
+    }
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+
+  dq_for_every_safe(&g_pressure_stall_queue, entry, tmp)
+    {
+      FAR struct pressure_file_s *pressure =
+          container_of(entry, struct pressure_file_s, entry);
+
+      if (pressure->stall == 0)
+        {
+          continue;
+        }
+
+      total = info[pressure->type].total;
+      if (current - pressure->winstart >= pressure->window)
+        {
+          pressure->winstart = current;
+          pressure->wintotal = total;
+          pressure->notified = false;
+          continue;
+        }
+
+      if (pressure->notified || total - pressure->wintotal < pressure->stall)
+        {
+          continue;
+        }
+
+      pressure->notified = true;
+
+      /* Keep the event for the next poll() if nobody is waiting */
+
+      if (pressure->fds == NULL)
+        {
+          pressure->pending = true;
+          continue;
+        }
+
+      spin_unlock_irqrestore(&g_pressure_lock, flags);
+      poll_notify(&pressure->fds, 1, POLLPRI);
+      flags = spin_lock_irqsave(&g_pressure_lock);
+    }
+
+  i = g_pressure_ntriggers;
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+
+  if (i > 0)
+    {
+      wd_start_next(&g_pressure_timer, PRESSURE_TRIGGER_TICKS,
+                    pressure_trigger, arg);
+    }
+}
+
+/****************************************************************************
+ * Name: pressure_stall_read
+ ****************************************************************************/
+
+static ssize_t pressure_stall_read(FAR struct file *filep, FAR char *buffer,
+                                   size_t buflen)
+{
+  FAR struct pressure_file_s *priv = filep->f_priv;
+  struct sched_pressure_s info;
+  char buf[128];
+  off_t offset;
+  ssize_t ret;
+
+  nxsched_pressure_read(priv->type, &info);
+
+  ret = procfs_snprintf(buf, sizeof(buf),
+                        "some avg10=%" PRIu32 ".%02" PRIu32
+                        " avg60=%" PRIu32 ".%02" PRIu32
+                        " avg300=%" PRIu32 ".%02" PRIu32
+                        " total=%" PRIu64 "\n",
+                        info.avg[0] / 100, info.avg[0] % 100,
+                        info.avg[1] / 100, info.avg[1] % 100,
+                        info.avg[2] / 100, info.avg[2] % 100,
+                        info.total);
+
+  offset = filep->f_pos;
+  ret    = procfs_memcpy(buf, ret, buffer, buflen, &offset);
+
+  filep->f_pos += ret;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pressure_stall_write
+ *
+ * Description:
+ *   "some <stall> <window>", both in microseconds, sets a trigger that
+ *   raises POLLPRI once the resource was stalled for stall microseconds
+ *   within a window.
+ *
+ ****************************************************************************/
+
+static ssize_t pressure_stall_write(FAR struct file *filep,
+                                    FAR const char *buffer, size_t buflen)
+{
+  FAR struct pressure_file_s *priv = filep->f_priv;
+  struct sched_pressure_s info;
+  FAR char *endptr;
+  uint64_t stall;
+  unsigned long window;
+  uint32_t flags;
+  bool start;
+
+  if (buffer == NULL || buflen < 5 || strncmp(buffer, "some ", 5) != 0)
+    {
+      return -EINVAL;
+    }
+
+  stall  = strtoull(buffer + 5, &endptr, 0);
+  window = strtoul(endptr, NULL, 0);
+  if (stall == 0 || stall > window)
+    {
+      return -EINVAL;
+    }
+
+  nxsched_pressure_read(priv->type, &info);
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+  if (priv->stall == 0)
+    {
+      g_pressure_ntriggers++;
+    }
+
+  start          = g_pressure_ntriggers == 1;
+  priv->stall    = stall;
+  priv->window   = MAX(USEC2TICK(window), 1);
+  priv->winstart = clock_systime_ticks();
+  priv->wintotal = info.total;
+  priv->notified = false;
+  priv->pending  = false;
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+
+  if (start && !WDOG_ISACTIVE(&g_pressure_timer))
+    {
+      wd_start(&g_pressure_timer, PRESSURE_TRIGGER_TICKS,
+               pressure_trigger, 0);
+    }
+
+  return buflen;
+}
+#else
+#  define pressure_queue(priv) (&g_pressure_memory_queue)
+#endif
+
 /****************************************************************************
  * Name: pressure_open
  ****************************************************************************/
@@ -118,8 +369,10 @@ static int pressure_open(FAR struct file *filep, FAR const char *relpath,
 {
   FAR struct pressure_file_s *priv;
   uint32_t flags;
+  int index;
 
-  if (strcmp(relpath, "pressure/memory") != 0)
+  index = pressure_lookup(relpath);
+  if (index < 0)
     {
       ferr("ERROR: relpath is invalid: %s\n", relpath);
       return -ENOENT;
@@ -131,10 +384,14 @@ static int pressure_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#ifdef CONFIG_SCHED_PRESSURE
+  priv->type = index - 1;
+#endif
+
   flags = spin_lock_irqsave(&g_pressure_lock);
   priv->interval = CLOCK_MAX;
   filep->f_priv = priv;
-  dq_addfirst(&priv->entry, &g_pressure_memory_queue);
+  dq_addfirst(&priv->entry, pressure_queue(priv));
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   return OK;
 }
@@ -149,7 +406,14 @@ static int pressure_close(FAR struct file *filep)
   uint32_t flags;
 
   flags = spin_lock_irqsave(&g_pressure_lock);
-  dq_rem(&priv->entry, &g_pressure_memory_queue);
+  dq_rem(&priv->entry, pressure_queue(priv));
+#ifdef CONFIG_SCHED_PRESSURE
+  if (priv->stall != 0)
+    {
+      g_pressure_ntriggers--;
+    }
+#endif
+
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   fs_heap_free(priv);
   return OK;
@@ -169,6 +433,13 @@ static ssize_t pressure_read(FAR struct file *filep, FAR char *buffer,
   off_t offset;
   ssize_t ret;
 
+#ifdef CONFIG_SCHED_PRESSURE
+  if (((FAR struct pressure_file_s *)filep->f_priv)->type >= 0)
+    {
+      return pressure_stall_read(filep, buffer, buflen);
+    }
+#endif
+
   flags   = spin_lock_irqsave(&g_pressure_lock);
   remain  = g_remaining;
   largest = g_largest;
@@ -202,6 +473,13 @@ static ssize_t pressure_write(FAR struct file *filep, FAR const char *buffer,
   clock_t interval;
   uint32_t flags;
 
+#ifdef CONFIG_SCHED_PRESSURE
+  if (priv->type >= 0)
+    {
+      return pressure_stall_write(filep, buffer, buflen);
+    }
+#endif
+
   if (buffer == NULL)
     {
       return -EINVAL;
@@ -256,6 +534,22 @@ static int pressure_poll(FAR struct file *filep, FAR struct pollfd *fds,
           priv->fds = fds;
           fds->priv = &priv->fds;
 
+#ifdef CONFIG_SCHED_PRESSURE
+          /* A stall trigger may have fired before the poll() */
+
+          if (priv->type >= 0)
+            {
+              if (priv->pending)
+                {
+                  priv->pending = false;
+                  spin_unlock_irqrestore(&g_pressure_lock, flags);
+                  poll_notify(&priv->fds, 1, POLLPRI);
+                  return OK;
+                }
+            }
+          else
+#endif
+
           /* If the remaining memory is less than the threshold and
            * lasttick is CLOCK_MAX, it means the event is triggered for
            * the first time and we should always send a notification.
@@ -304,7 +598,14 @@ static int pressure_dup(FAR const struct file *oldp, FAR struct file *newp)
 
   flags = spin_lock_irqsave(&g_pressure_lock);
   memcpy(newpriv, oldpriv, sizeof(struct pressure_file_s));
-  dq_addfirst(&newpriv->entry, &g_pressure_memory_queue);
+  dq_addfirst(&newpriv->entry, pressure_queue(newpriv));
+#ifdef CONFIG_SCHED_PRESSURE
+  if (newpriv->stall != 0)
+    {
+      g_pressure_ntriggers++;
+    }
+#endif
+
   newpriv->fds = NULL;
   newp->f_priv = newpriv;
   spin_unlock_irqrestore(&g_pressure_lock, flags);
@@ -330,7 +631,7 @@ static int pressure_opendir(FAR const char *relpath,
     }
 
   level->level    = 1;
-  level->nentries = 1;
+  level->nentries = PRESSURE_NFILES;
 
   *dir = (FAR struct fs_dirent_s *)level;
   return OK;
@@ -365,7 +666,8 @@ static int pressure_readdir(FAR struct fs_dirent_s *dir,
     }
 
   entry->d_type = DTYPE_FILE;
-  strncpy(entry->d_name, "memory", sizeof(entry->d_name));
+  strncpy(entry->d_name, g_pressure_names[level->index],
+          sizeof(entry->d_name));
   level->index++;
   return OK;
 }
@@ -396,7 +698,7 @@ static int pressure_stat(const char *relpath, struct stat *buf)
     {
       buf->st_mode = S_IFDIR | S_IROTH | S_IRGRP | S_IRUSR;
     }
-  else if (strcmp(relpath, "pressure/memory") == 0)
+  else if (pressure_lookup(relpath) >= 0)
     {
       buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWOTH |
                      S_IWGRP | S_IWUSR;
@@ -28,6 +28,7 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/param.h>
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -99,6 +100,12 @@ enum proc_node_e
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_PMU
+  PROC_PMU,                           /* Hardware event counts */
+#endif
+#ifdef CONFIG_SCHED_RUSAGE
+  PROC_RUSAGE,                        /* Resource usage */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   PROC_HEAP,                          /* Task heap info */
 #endif
@@ -190,6 +197,16 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_PMU
+static ssize_t proc_pmu(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
+#ifdef CONFIG_SCHED_RUSAGE
+static ssize_t proc_rusage(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
 static ssize_t proc_heap(FAR struct proc_file_s *procfile,
                          FAR struct tcb_s *tcb, FAR char *buffer,
@@ -302,6 +319,20 @@ static const struct proc_node_s g_critmon =
 };
 #endif
 
+#ifdef CONFIG_SCHED_PMU
+static const struct proc_node_s g_pmu =
+{
+  "pmu",           "pmu",     (uint8_t)PROC_PMU,         DTYPE_FILE        /* Hardware event counts */
+};
+#endif
+
+#ifdef CONFIG_SCHED_RUSAGE
+static const struct proc_node_s g_rusage =
+{
+  "rusage",        "rusage",  (uint8_t)PROC_RUSAGE,      DTYPE_FILE        /* Resource usage */
+};
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static const struct proc_node_s g_heap =
 {
@@ -356,6 +387,12 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
 #endif
+#ifdef CONFIG_SCHED_PMU
+  &g_pmu,          /* Hardware event counts */
+#endif
+#ifdef CONFIG_SCHED_RUSAGE
+  &g_rusage,       /* Resource usage */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -385,6 +422,12 @@ static const struct proc_node_s * const g_level0info[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_PMU
+  &g_pmu,          /* Hardware event counts */
+#endif
+#ifdef CONFIG_SCHED_RUSAGE
+  &g_rusage,       /* Resource usage */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -880,6 +923,104 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_pmu
+ *
+ * Description:
+ *   One "event count" line per hardware event that is being counted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PMU
+static ssize_t proc_pmu(FAR struct proc_file_s *procfile,
+                        FAR struct tcb_s *tcb, FAR char *buffer,
+                        size_t buflen, off_t offset)
+{
+  uint64_t counts[CONFIG_SCHED_PMU_NCOUNTERS];
+  size_t remaining = buflen;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize = 0;
+  int event;
+  int i;
+
+  nxsched_pmu_task(tcb, counts);
+
+  for (i = 0; i < CONFIG_SCHED_PMU_NCOUNTERS && remaining > 0; i++)
+    {
+      event = nxsched_pmu_event(i);
+      if (event == PMU_EVENT_NONE)
+        {
+          continue;
+        }
+
+      linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                                   "%-16s%" PRIu64 "\n",
+                                   nxsched_pmu_name(event), counts[i]);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 remaining, &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+    }
+
+  return totalsize;
+}
+#endif
+
+/****************************************************************************
+ * Name: proc_rusage
+ *
+ * Description:
+ *   The resource accounting counters of the thread, one per line.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_RUSAGE
+static ssize_t proc_rusage(FAR struct proc_file_s *procfile,
+                           FAR struct tcb_s *tcb, FAR char *buffer,
+                           size_t buflen, off_t offset)
+{
+  static FAR const char * const names[] =
+  {
+    "nvcsw:", "nivcsw:", "rchar:", "wchar:", "sockrx:", "socktx:",
+    "heapused:", "heappeak:"
+  };
+
+  uint64_t values[nitems(names)];
+  size_t remaining = buflen;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize = 0;
+  int i;
+
+  values[0] = tcb->nvcsw;
+  values[1] = tcb->nivcsw;
+  values[2] = tcb->rchar;
+  values[3] = tcb->wchar;
+  values[4] = tcb->sockrx;
+  values[5] = tcb->socktx;
+  values[6] = tcb->heapused;
+  values[7] = tcb->heappeak;
+
+  for (i = 0; i < nitems(names) && remaining > 0; i++)
+    {
+      linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                                   "%-12s%" PRIu64 "\n", names[i],
+                                   values[i]);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 remaining, &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+    }
+
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_heap
  ****************************************************************************/
@@ -1628,6 +1769,16 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 #endif
+#ifdef CONFIG_SCHED_PMU
+    case PROC_PMU: /* Hardware event counts */
+      ret = proc_pmu(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
+#ifdef CONFIG_SCHED_RUSAGE
+    case PROC_RUSAGE: /* Resource usage */
+      ret = proc_rusage(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
     case PROC_HEAP: /* Task heap info */
       ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
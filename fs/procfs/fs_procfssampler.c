@@ -0,0 +1,369 @@
+/****************************************************************************
+ * fs/procfs/fs_procfssampler.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_SAMPLER)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic: the task name, one
+ * address per frame and the count.
+ */
+
+#define SAMPLER_LINELEN \
+  (CONFIG_TASK_NAME_SIZE + 32 + CONFIG_SCHED_SAMPLER_DEPTH * 20)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct sampler_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[SAMPLER_LINELEN];     /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     sampler_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     sampler_close(FAR struct file *filep);
+static ssize_t sampler_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t sampler_write(FAR struct file *filep, FAR const char *buffer,
+                 size_t buflen);
+static int     sampler_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     sampler_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_sampler_operations =
+{
+  sampler_open,   /* open */
+  sampler_close,  /* close */
+  sampler_read,   /* read */
+  sampler_write,  /* write */
+  NULL,           /* poll */
+  sampler_dup,    /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  sampler_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sampler_format
+ *
+ * Description:
+ *   Format one call stack as a folded line, "task;outermost;...;innermost
+ *   count".  The task is named by its pid once it has exited.
+ *
+ ****************************************************************************/
+
+static size_t sampler_format(FAR char *line,
+                             FAR const struct sched_sample_s *sample)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  size_t linesize;
+  int i;
+
+  flags = enter_critical_section();
+  tcb = nxsched_get_tcb(sample->pid);
+  if (tcb != NULL)
+    {
+      linesize = procfs_snprintf(line, SAMPLER_LINELEN, "%s",
+                                 get_task_name(tcb));
+    }
+  else
+    {
+      linesize = procfs_snprintf(line, SAMPLER_LINELEN, "[%d]",
+                                 (int)sample->pid);
+    }
+
+  leave_critical_section(flags);
+
+  for (i = sample->depth - 1; i >= 0; i--)
+    {
+      linesize += procfs_snprintf(line + linesize,
+                                  SAMPLER_LINELEN - linesize,
+                                  ";%p", sample->pcs[i]);
+    }
+
+  linesize += procfs_snprintf(line + linesize, SAMPLER_LINELEN - linesize,
+                              " %" PRIu32 "\n", sample->count);
+  return linesize;
+}
+
+/****************************************************************************
+ * Name: sampler_open
+ ****************************************************************************/
+
+static int sampler_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, mode_t mode)
+{
+  FAR struct sampler_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = fs_heap_zalloc(sizeof(struct sampler_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sampler_close
+ ****************************************************************************/
+
+static int sampler_close(FAR struct file *filep)
+{
+  FAR struct sampler_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sampler_read
+ ****************************************************************************/
+
+static ssize_t sampler_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct sampler_file_s *procfile;
+  struct sched_sample_s sample;
+  size_t linesize;
+  size_t copysize = 0;
+  size_t totalsize = 0;
+  uint32_t dropped;
+  off_t offset;
+  int cpu;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* One line per call stack and CPU, the flame graph tools add up the
+   * lines of the same stack.
+   */
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      for (i = 0; totalsize < buflen &&
+                  nxsched_sampler_read(cpu, i, &sample) == OK; i++)
+        {
+          if (sample.count == 0)
+            {
+              continue;
+            }
+
+          buffer    += copysize;
+          buflen    -= copysize;
+
+          linesize   = sampler_format(procfile->line, &sample);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+
+  /* Account the samples that did not fit as a stack of their own */
+
+  dropped = nxsched_sampler_dropped();
+  if (dropped > 0 && totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, SAMPLER_LINELEN,
+                                   "[dropped] %" PRIu32 "\n", dropped);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: sampler_write
+ *
+ * Description:
+ *   "start" and "stop" the sampling, "reset" forgets what was sampled.
+ *
+ ****************************************************************************/
+
+static ssize_t sampler_write(FAR struct file *filep, FAR const char *buffer,
+                             size_t buflen)
+{
+  int ret = OK;
+
+  if (buflen >= 5 && strncmp(buffer, "start", 5) == 0)
+    {
+      ret = nxsched_sampler_start();
+    }
+  else if (buflen >= 4 && strncmp(buffer, "stop", 4) == 0)
+    {
+      nxsched_sampler_stop();
+    }
+  else if (buflen >= 5 && strncmp(buffer, "reset", 5) == 0)
+    {
+      nxsched_sampler_reset();
+    }
+  else
+    {
+      ret = -EINVAL;
+    }
+
+  return ret < 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Name: sampler_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int sampler_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct sampler_file_s *oldattr;
+  FAR struct sampler_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct sampler_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct sampler_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: sampler_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int sampler_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_SAMPLER */
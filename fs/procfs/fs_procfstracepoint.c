@@ -0,0 +1,297 @@
+/****************************************************************************
+ * fs/procfs/fs_procfstracepoint.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/param.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/tracepoint.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    defined(CONFIG_SCHED_TRACEPOINTS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define TRACEPOINT_LINELEN 48
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct tracepoint_file_s
+{
+  struct procfs_file_s base;       /* Base open file structure */
+  char line[TRACEPOINT_LINELEN];   /* Buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     tracepoint_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     tracepoint_close(FAR struct file *filep);
+static ssize_t tracepoint_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t tracepoint_write(FAR struct file *filep,
+                 FAR const char *buffer, size_t buflen);
+static int     tracepoint_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     tracepoint_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_tracepoint_operations =
+{
+  tracepoint_open,   /* open */
+  tracepoint_close,  /* close */
+  tracepoint_read,   /* read */
+  tracepoint_write,  /* write */
+  NULL,              /* poll */
+  tracepoint_dup,    /* dup */
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+  tracepoint_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tracepoint_open
+ ****************************************************************************/
+
+static int tracepoint_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode)
+{
+  FAR struct tracepoint_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = fs_heap_zalloc(sizeof(struct tracepoint_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tracepoint_close
+ ****************************************************************************/
+
+static int tracepoint_close(FAR struct file *filep)
+{
+  FAR struct tracepoint_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tracepoint_read
+ *
+ * Description:
+ *   One line per tracepoint, "name enabled".
+ *
+ ****************************************************************************/
+
+static ssize_t tracepoint_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct tracepoint_file_s *procfile;
+  size_t linesize;
+  size_t copysize = 0;
+  size_t totalsize = 0;
+  off_t offset;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  for (i = 0; totalsize < buflen && i < TRACEPOINT_NKEYS; i++)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, TRACEPOINT_LINELEN,
+                                   "%s %d\n", tracepoint_name(i),
+                                   g_tracepoint_keys[i]);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 buflen, &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: tracepoint_write
+ *
+ * Description:
+ *   "name 1" enables the tracepoint name, "name 0" disables it, "all"
+ *   stands for all of them.
+ *
+ ****************************************************************************/
+
+static ssize_t tracepoint_write(FAR struct file *filep,
+                                FAR const char *buffer, size_t buflen)
+{
+  char line[TRACEPOINT_LINELEN];
+  FAR char *value;
+  size_t len;
+  int ret;
+
+  len = MIN(buflen, sizeof(line) - 1);
+  memcpy(line, buffer, len);
+  line[len] = '\0';
+
+  value = strchr(line, ' ');
+  if (value == NULL)
+    {
+      return -EINVAL;
+    }
+
+  *value++ = '\0';
+  ret = tracepoint_enable(line, strtol(value, NULL, 0) != 0);
+  return ret < 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Name: tracepoint_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int tracepoint_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct tracepoint_file_s *oldattr;
+  FAR struct tracepoint_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct tracepoint_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct tracepoint_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tracepoint_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int tracepoint_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * CONFIG_SCHED_TRACEPOINTS */
@@ -60,6 +60,8 @@
 #define RPMSGFS_STAT            20
 #define RPMSGFS_FCHSTAT         21
 #define RPMSGFS_CHSTAT          22
+#define RPMSGFS_READ_SHMEM      23
+#define RPMSGFS_WRITE_SHMEM     24
 
 /****************************************************************************
  * Public Types
@@ -96,6 +98,18 @@ begin_packed_struct struct rpmsgfs_read_s
 
 #define rpmsgfs_write_s rpmsgfs_read_s
 
+/* Bulk transfer: the data stays in the buffer of the client at addr,
+ * which the server accesses directly.
+ */
+
+begin_packed_struct struct rpmsgfs_shmem_s
+{
+  struct rpmsgfs_header_s header;
+  int32_t                 fd;
+  uint32_t                count;
+  uint64_t                addr;
+} end_packed_struct;
+
 begin_packed_struct struct rpmsgfs_lseek_s
 {
   struct rpmsgfs_header_s header;
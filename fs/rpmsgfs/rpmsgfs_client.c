@@ -32,6 +32,7 @@
 #include <termios.h>
 #include <fcntl.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/rpmsg/rpmsg.h>
@@ -120,6 +121,10 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_default_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_default_handler,
+#ifdef CONFIG_FS_RPMSGFS_SHMEM
+  [RPMSGFS_READ_SHMEM]  = rpmsgfs_default_handler,
+  [RPMSGFS_WRITE_SHMEM] = rpmsgfs_default_handler,
+#endif
 };
 
 /****************************************************************************
@@ -460,6 +465,36 @@ int rpmsgfs_client_close(FAR void *handle, int fd)
           (struct rpmsgfs_header_s *)&msg, sizeof(msg), NULL);
 }
 
+#ifdef CONFIG_FS_RPMSGFS_SHMEM
+static ssize_t rpmsgfs_client_shmem(FAR void *handle, uint32_t command,
+                                    int fd, FAR void *buf, size_t count)
+{
+  struct rpmsgfs_shmem_s msg =
+  {
+    .fd    = fd,
+    .count = count,
+    .addr  = (uintptr_t)buf,
+  };
+
+  ssize_t ret;
+
+  /* Write back the data to send, and drop any dirty line of a receive
+   * buffer before the server fills it.
+   */
+
+  up_flush_dcache((uintptr_t)buf, (uintptr_t)buf + count);
+
+  ret = rpmsgfs_send_recv(handle, command, true,
+          (struct rpmsgfs_header_s *)&msg, sizeof(msg), NULL);
+  if (command == RPMSGFS_READ_SHMEM && ret > 0)
+    {
+      up_invalidate_dcache((uintptr_t)buf, (uintptr_t)buf + ret);
+    }
+
+  return ret;
+}
+#endif
+
 ssize_t rpmsgfs_client_read(FAR void *handle, int fd,
                             FAR void *buf, size_t count)
 {
@@ -479,6 +514,14 @@ ssize_t rpmsgfs_client_read(FAR void *handle, int fd,
       return 0;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_SHMEM
+  if (count >= CONFIG_FS_RPMSGFS_SHMEM_THRESHOLD)
+    {
+      return rpmsgfs_client_shmem(handle, RPMSGFS_READ_SHMEM, fd,
+                                  buf, count);
+    }
+#endif
+
   memset(&cookie, 0, sizeof(cookie));
 
   nxsem_init(&cookie.sem, 0, 0);
@@ -522,6 +565,14 @@ ssize_t rpmsgfs_client_write(FAR void *handle, int fd,
       return 0;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_SHMEM
+  if (count >= CONFIG_FS_RPMSGFS_SHMEM_THRESHOLD)
+    {
+      return rpmsgfs_client_shmem(handle, RPMSGFS_WRITE_SHMEM, fd,
+                                  (FAR void *)buf, count);
+    }
+#endif
+
   memset(&cookie, 0, sizeof(cookie));
   nxsem_init(&cookie.sem, 0, 0);
 
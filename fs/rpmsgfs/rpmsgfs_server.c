@@ -34,6 +34,7 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/cache.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -72,6 +73,11 @@ static int rpmsgfs_read_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgfs_write_handler(FAR struct rpmsg_endpoint *ept,
                                  FAR void *data, size_t len,
                                  uint32_t src, FAR void *priv);
+#ifdef CONFIG_FS_RPMSGFS_SHMEM
+static int rpmsgfs_shmem_handler(FAR struct rpmsg_endpoint *ept,
+                                 FAR void *data, size_t len,
+                                 uint32_t src, FAR void *priv);
+#endif
 static int rpmsgfs_lseek_handler(FAR struct rpmsg_endpoint *ept,
                                  FAR void *data, size_t len,
                                  uint32_t src, FAR void *priv);
@@ -165,6 +171,10 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_fchstat_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_chstat_handler,
+#ifdef CONFIG_FS_RPMSGFS_SHMEM
+  [RPMSGFS_READ_SHMEM]  = rpmsgfs_shmem_handler,
+  [RPMSGFS_WRITE_SHMEM] = rpmsgfs_shmem_handler,
+#endif
 };
 
 /****************************************************************************
@@ -443,6 +453,56 @@ static int rpmsgfs_write_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+#ifdef CONFIG_FS_RPMSGFS_SHMEM
+static int rpmsgfs_shmem_handler(FAR struct rpmsg_endpoint *ept,
+                                 FAR void *data, size_t len,
+                                 uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_shmem_s *msg = data;
+  FAR uint8_t *buf = (FAR uint8_t *)(uintptr_t)msg->addr;
+  bool write = msg->header.command == RPMSGFS_WRITE_SHMEM;
+  FAR struct file *filep;
+  ssize_t ret = -ENOENT;
+  size_t done = 0;
+
+  filep = rpmsgfs_get_file(priv, msg->fd);
+  if (filep != NULL)
+    {
+      if (write)
+        {
+          up_invalidate_dcache((uintptr_t)buf, (uintptr_t)buf + msg->count);
+        }
+
+      while (done < msg->count)
+        {
+          if (write)
+            {
+              ret = file_write(filep, buf + done, msg->count - done);
+            }
+          else
+            {
+              ret = file_read(filep, buf + done, msg->count - done);
+            }
+
+          if (ret <= 0)
+            {
+              break;
+            }
+
+          done += ret;
+        }
+
+      if (!write)
+        {
+          up_clean_dcache((uintptr_t)buf, (uintptr_t)buf + done);
+        }
+    }
+
+  msg->header.result = done > 0 ? done : ret;
+  return rpmsg_send(ept, msg, sizeof(*msg));
+}
+#endif
+
 static int rpmsgfs_lseek_handler(FAR struct rpmsg_endpoint *ept,
                                  FAR void *data, size_t len,
                                  uint32_t src, FAR void *priv)
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/param.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
 #include <stdint.h>
@@ -58,6 +59,11 @@
 #  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
+#if CONFIG_FS_TMPFS_PAGESIZE > 0
+#  define TMPFS_PAGESIZE      CONFIG_FS_TMPFS_PAGESIZE
+#  define TMPFS_NPAGES(size)  (((size) + TMPFS_PAGESIZE - 1) / TMPFS_PAGESIZE)
+#endif
+
 #define tmpfs_lock(fs) \
            nxrmutex_lock(&fs->tfs_lock)
 #define tmpfs_lock_object(to) \
@@ -96,6 +102,15 @@ static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
               unsigned int nentries);
 static int  tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo);
+static void tmpfs_read_data(FAR struct tmpfs_file_s *tfo,
+              FAR uint8_t *buffer, size_t pos, size_t len);
+static int  tmpfs_write_data(FAR struct tmpfs_file_s *tfo,
+              FAR const uint8_t *buffer, size_t pos, size_t len);
+#if CONFIG_FS_TMPFS_PAGESIZE > 0
+static FAR uint8_t *tmpfs_page_data(FAR struct tmpfs_file_s *tfo,
+              size_t pos, size_t len);
+#endif
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_release_file(FAR struct tmpfs_file_s *tfo);
@@ -272,6 +287,191 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s *tdo,
  * Name: tmpfs_realloc_file
  ****************************************************************************/
 
+#if CONFIG_FS_TMPFS_PAGESIZE > 0
+static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
+                              size_t newsize)
+{
+  FAR uint8_t **newpages;
+  size_t nentries;
+  size_t npages;
+  size_t offset;
+  size_t i;
+
+  npages = TMPFS_NPAGES(newsize);
+  if (npages > tfo->tfo_npages)
+    {
+      /* Only the page table is reallocated.  It grows geometrically so
+       * that appending to a file does not reallocate it every page.
+       */
+
+      nentries = MAX(npages, 2 * tfo->tfo_npages);
+      newpages = fs_heap_realloc(tfo->tfo_pages,
+                                 nentries * sizeof(FAR uint8_t *));
+      if (newpages == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      memset(&newpages[tfo->tfo_npages], 0,
+             (nentries - tfo->tfo_npages) * sizeof(FAR uint8_t *));
+
+      tfo->tfo_alloc  += (nentries - tfo->tfo_npages) *
+                         sizeof(FAR uint8_t *);
+      tfo->tfo_npages  = nentries;
+      tfo->tfo_pages   = newpages;
+    }
+  else if (newsize == 0)
+    {
+      tmpfs_free_data(tfo);
+    }
+  else if (newsize < tfo->tfo_size)
+    {
+      /* Free the pages past the new end of the file.  The data beyond the
+       * end of the file is kept zero, as it becomes visible if the file
+       * grows again.
+       */
+
+      for (i = npages; i < TMPFS_NPAGES(tfo->tfo_size); i++)
+        {
+          if (tfo->tfo_pages[i] != NULL)
+            {
+              fs_heap_free(tfo->tfo_pages[i]);
+              tfo->tfo_pages[i] = NULL;
+              tfo->tfo_alloc   -= TMPFS_PAGESIZE;
+            }
+        }
+
+      offset = newsize % TMPFS_PAGESIZE;
+      if (offset > 0 && tfo->tfo_pages[npages - 1] != NULL)
+        {
+          memset(tfo->tfo_pages[npages - 1] + offset, 0,
+                 TMPFS_PAGESIZE - offset);
+        }
+    }
+
+  tfo->tfo_size = newsize;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tmpfs_page_data
+ *
+ * Description:
+ *   Return the address of the data at 'pos' if 'len' bytes from there are
+ *   in one page, allocating the page if it is a hole.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_page_data(FAR struct tmpfs_file_s *tfo,
+                                    size_t pos, size_t len)
+{
+  FAR uint8_t **page;
+  size_t offset = pos % TMPFS_PAGESIZE;
+
+  if (len == 0 || offset + len > TMPFS_PAGESIZE ||
+      pos / TMPFS_PAGESIZE >= tfo->tfo_npages)
+    {
+      return NULL;
+    }
+
+  page = &tfo->tfo_pages[pos / TMPFS_PAGESIZE];
+  if (*page == NULL)
+    {
+      *page = fs_heap_zalloc(TMPFS_PAGESIZE);
+      if (*page == NULL)
+        {
+          return NULL;
+        }
+
+      tfo->tfo_alloc += TMPFS_PAGESIZE;
+    }
+
+  return *page + offset;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_data
+ ****************************************************************************/
+
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo)
+{
+  size_t i;
+
+  for (i = 0; i < tfo->tfo_npages; i++)
+    {
+      fs_heap_free(tfo->tfo_pages[i]);
+    }
+
+  fs_heap_free(tfo->tfo_pages);
+  tfo->tfo_pages  = NULL;
+  tfo->tfo_npages = 0;
+  tfo->tfo_alloc  = 0;
+  tfo->tfo_size   = 0;
+}
+
+/****************************************************************************
+ * Name: tmpfs_read_data
+ ****************************************************************************/
+
+static void tmpfs_read_data(FAR struct tmpfs_file_s *tfo,
+                            FAR uint8_t *buffer, size_t pos, size_t len)
+{
+  FAR const uint8_t *page;
+  size_t offset;
+  size_t nbytes;
+
+  while (len > 0)
+    {
+      page   = tfo->tfo_pages[pos / TMPFS_PAGESIZE];
+      offset = pos % TMPFS_PAGESIZE;
+      nbytes = MIN(len, TMPFS_PAGESIZE - offset);
+
+      /* Holes read back as zero */
+
+      if (page != NULL)
+        {
+          memcpy(buffer, page + offset, nbytes);
+        }
+      else
+        {
+          memset(buffer, 0, nbytes);
+        }
+
+      buffer += nbytes;
+      pos    += nbytes;
+      len    -= nbytes;
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_data
+ ****************************************************************************/
+
+static int tmpfs_write_data(FAR struct tmpfs_file_s *tfo,
+                            FAR const uint8_t *buffer, size_t pos,
+                            size_t len)
+{
+  FAR uint8_t *data;
+  size_t nbytes;
+
+  while (len > 0)
+    {
+      nbytes = MIN(len, TMPFS_PAGESIZE - pos % TMPFS_PAGESIZE);
+      data   = tmpfs_page_data(tfo, pos, nbytes);
+      if (data == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      memcpy(data, buffer, nbytes);
+      buffer += nbytes;
+      pos    += nbytes;
+      len    -= nbytes;
+    }
+
+  return OK;
+}
+#else
 static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
                               size_t newsize)
 {
@@ -346,6 +546,56 @@ static int tmpfs_realloc_file(FAR struct tmpfs_file_s *tfo,
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_free_data
+ ****************************************************************************/
+
+static void tmpfs_free_data(FAR struct tmpfs_file_s *tfo)
+{
+  fs_heap_free(tfo->tfo_data);
+  tfo->tfo_data  = NULL;
+  tfo->tfo_alloc = 0;
+  tfo->tfo_size  = 0;
+}
+
+/****************************************************************************
+ * Name: tmpfs_read_data
+ ****************************************************************************/
+
+static void tmpfs_read_data(FAR struct tmpfs_file_s *tfo,
+                            FAR uint8_t *buffer, size_t pos, size_t len)
+{
+  if (tfo->tfo_data != NULL)
+    {
+      memcpy(buffer, &tfo->tfo_data[pos], len);
+    }
+  else
+    {
+      DEBUGASSERT(tfo->tfo_size == 0 && len == 0);
+    }
+}
+
+/****************************************************************************
+ * Name: tmpfs_write_data
+ ****************************************************************************/
+
+static int tmpfs_write_data(FAR struct tmpfs_file_s *tfo,
+                            FAR const uint8_t *buffer, size_t pos,
+                            size_t len)
+{
+  if (tfo->tfo_data != NULL)
+    {
+      memcpy(&tfo->tfo_data[pos], buffer, len);
+    }
+  else
+    {
+      DEBUGASSERT(tfo->tfo_size == 0 && len == 0);
+    }
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
  ****************************************************************************/
@@ -383,7 +633,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
     {
       tmpfs_unlock_file(tfo);
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       fs_heap_free(tfo);
     }
 
@@ -582,7 +832,12 @@ tmpfs_alloc_file(FAR struct tmpfs_directory_s *parent)
   tfo->tfo_parent = parent;
   tfo->tfo_flags  = 0;
   tfo->tfo_size   = 0;
+#if CONFIG_FS_TMPFS_PAGESIZE > 0
+  tfo->tfo_npages = 0;
+  tfo->tfo_pages  = NULL;
+#else
   tfo->tfo_data   = NULL;
+#endif
 
   nxrmutex_init(&tfo->tfo_lock);
   tmpfs_lock_file(tfo);
@@ -1189,7 +1444,11 @@ static int tmpfs_statfs_callout(FAR struct tmpfs_directory_s *tdo,
 
       tmptfo             = (FAR struct tmpfs_file_s *)to;
       tmpbuf->tsf_alloc += sizeof(struct tmpfs_file_s);
-      tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+      if (to->to_alloc > tmptfo->tfo_size)
+        {
+          tmpbuf->tsf_avail += to->to_alloc - tmptfo->tfo_size;
+        }
+
       tmpbuf->tsf_files++;
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
@@ -1265,7 +1524,7 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           return TMPFS_UNLINKED;
         }
 
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
     }
   else /* if (to->to_type == TMPFS_DIRECTORY) */
     {
@@ -1586,15 +1845,8 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Copy data from the memory object to the user buffer */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(buffer, &tfo->tfo_data[startpos], nread);
-      filep->f_pos += nread;
-    }
-  else
-    {
-      DEBUGASSERT(tfo->tfo_size == 0 && nread == 0);
-    }
+  tmpfs_read_data(tfo, (FAR uint8_t *)buffer, startpos, nread);
+  filep->f_pos += nread;
 
   /* Release the lock on the file */
 
@@ -1611,6 +1863,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 {
   FAR struct tmpfs_file_s *tfo;
   ssize_t nwritten;
+  size_t oldsize;
   off_t startpos;
   off_t endpos;
   int ret;
@@ -1644,6 +1897,7 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   nwritten = buflen;
   endpos   = startpos + buflen;
+  oldsize  = tfo->tfo_size;
 
   if (endpos > tfo->tfo_size)
     {
@@ -1656,15 +1910,18 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
         }
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the user buffer to the memory object */
 
-  if (tfo->tfo_data != NULL)
-    {
-      memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
-    }
-  else
+  ret = tmpfs_write_data(tfo, (FAR const uint8_t *)buffer, startpos,
+                         nwritten);
+  if (ret < 0)
     {
-      DEBUGASSERT(tfo->tfo_size == 0 && nwritten == 0);
+      if (tfo->tfo_size > oldsize)
+        {
+          tmpfs_realloc_file(tfo, oldsize);
+        }
+
+      goto errout_with_lock;
     }
 
   filep->f_pos = endpos;
@@ -1788,7 +2045,22 @@ static int tmpfs_mmap(FAR struct file *filep, FAR struct mm_map_entry_s *map)
   if (map->offset >= 0 && map->offset < tfo->tfo_size &&
       map->length && map->offset + map->length <= tfo->tfo_size)
     {
+#if CONFIG_FS_TMPFS_PAGESIZE > 0
+      /* Only a range within one page can be mapped directly, let the
+       * caller fall back to a copy otherwise.
+       */
+
+      tmpfs_lock_file(tfo);
+      map->vaddr = tmpfs_page_data(tfo, map->offset, map->length);
+      tmpfs_unlock_file(tfo);
+
+      if (map->vaddr == NULL)
+        {
+          return -ENOTTY;
+        }
+#else
       map->vaddr = tfo->tfo_data + map->offset;
+#endif
       map->priv.p = tfo;
       map->munmap = tmpfs_unmap;
       ret = mm_map_add(get_current_mm(), map);
@@ -1842,8 +2114,18 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     {
       FAR uintptr_t *ptr = (FAR uintptr_t *)arg;
 
+#if CONFIG_FS_TMPFS_PAGESIZE > 0
+      /* The file can only be used in place if it fits in one page */
+
+      tmpfs_lock_file(tfo);
+      *ptr = (uintptr_t)tmpfs_page_data(tfo, 0, tfo->tfo_size);
+      tmpfs_unlock_file(tfo);
+
+      return *ptr != 0 ? OK : -ENOTTY;
+#else
       *ptr = (uintptr_t)tfo->tfo_data;
       return OK;
+#endif
     }
 
   return ret;
@@ -1976,14 +2258,16 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
           goto errout_with_lock;
         }
 
+#if CONFIG_FS_TMPFS_PAGESIZE == 0
       /* If the size has increased, then we need to zero the newly added
-       * memory.
+       * memory.  Pages are zero beyond the end of the file already.
        */
 
       if (length > oldsize)
         {
           memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
         }
+#endif
 
       ret = OK;
     }
@@ -2430,7 +2714,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   else
     {
       nxrmutex_destroy(&tfo->tfo_lock);
-      fs_heap_free(tfo->tfo_data);
+      tmpfs_free_data(tfo);
       fs_heap_free(tfo);
     }
 
@@ -86,6 +86,9 @@ static int chstat_recursive(FAR const char *path,
           /* Perform the chstat() operation */
 
           ret = inode->u.i_mops->chstat(inode, desc.relpath, buf, flags);
+#ifdef CONFIG_FS_DCACHE
+          dcache_invalidate(inode, desc.relpath);
+#endif
         }
       else
         {
@@ -114,6 +114,17 @@ int file_close(FAR struct file *filep)
   if (inode)
     {
       file_closelk(filep);
+#ifdef CONFIG_FS_PAGECACHE
+      pagecache_close(filep);
+#endif
+#ifdef CONFIG_FS_DCACHE
+      /* Closing a file opened for writing may update its size and times */
+
+      if (INODE_IS_MOUNTPT(inode) && (filep->f_oflags & O_WROK) != 0)
+        {
+          dcache_modified(inode);
+        }
+#endif
 
       /* Close the file, driver, or mountpoint. */
 
@@ -175,6 +186,10 @@ int file_close(FAR struct file *filep)
 
 int nx_close(int fd)
 {
+#ifdef CONFIG_FS_POLL_CACHE
+  poll_cache_close(fd);
+#endif
+
   return fdlist_close(nxsched_get_fdlist_from_tcb(this_task()), fd);
 }
 
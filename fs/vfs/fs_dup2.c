@@ -36,6 +36,7 @@
 
 #include "inode/inode.h"
 #include "sched/sched.h"
+#include "vfs.h"
 
 /****************************************************************************
  * Public Functions
@@ -142,6 +143,12 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
         {
           inode_release(inode);
         }
+#ifdef CONFIG_FS_PAGECACHE
+      else
+        {
+          pagecache_dup(filep1, filep2);
+        }
+#endif
     }
 
   return ret;
@@ -42,6 +42,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/tls.h>
 
 #include "inode/inode.h"
@@ -54,8 +55,9 @@
 struct epoll_node_s
 {
   struct list_node         node;
+  struct list_node         rnode;   /* Entry in the ready list */
   epoll_data_t             data;
-  bool                     notified;
+  bool                     ready;   /* rnode is in use, protected by rlock */
   struct pollfd            pfd;
   FAR struct file         *filep;
   FAR struct epoll_head_s *eph;
@@ -69,13 +71,17 @@ struct epoll_head_s
   int                   crefs;
   mutex_t               lock;
   sem_t                 sem;
+  spinlock_t            rlock;    /* Protects the ready list, which is also
+                                   * modified by the poll callback.
+                                   */
   struct list_node      setup;    /* The setup list, store all the setuped
-                                   * epoll node.
+                                   * epoll node.  The poll callback of these
+                                   * nodes stays installed until the node is
+                                   * deleted or fires with EPOLLONESHOT.
                                    */
-  struct list_node      teardown; /* The teardown list, store all the epoll
-                                   * node notified after epoll_wait finish,
-                                   * these epoll node should be setup again
-                                   * to check the pending poll notification.
+  struct list_node      ready;    /* The ready list, store all the epoll
+                                   * node whose poll callback reported events
+                                   * not yet returned by epoll_wait.
                                    */
   struct list_node      oneshot;  /* The oneshot list, store all the epoll
                                    * node notified after epoll_wait and with
@@ -102,7 +108,7 @@ static int epoll_do_open(FAR struct file *filep);
 static int epoll_do_close(FAR struct file *filep);
 static int epoll_do_poll(FAR struct file *filep,
                          FAR struct pollfd *fds, bool setup);
-static int epoll_setup(FAR epoll_head_t *eph);
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn);
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents);
 
@@ -204,11 +210,6 @@ static int epoll_do_close(FAR struct file *filep)
           file_put(epn->filep);
         }
 
-      list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-        {
-          file_put(epn->filep);
-        }
-
       list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
         {
           file_put(epn->filep);
@@ -250,13 +251,14 @@ static int epoll_do_create(int size, int flags)
   eph->size = size;
   nxmutex_init(&eph->lock);
   nxsem_init(&eph->sem, 0, 0);
+  spin_lock_init(&eph->rlock);
 
   /* List initialize */
 
   epn = (FAR epoll_node_t *)(eph + 1);
 
   list_initialize(&eph->setup);
-  list_initialize(&eph->teardown);
+  list_initialize(&eph->ready);
   list_initialize(&eph->oneshot);
   list_initialize(&eph->extend);
   list_initialize(&eph->free);
@@ -282,61 +284,49 @@ static int epoll_do_create(int size, int flags)
 }
 
 /****************************************************************************
- * Name: epoll_setup
+ * Name: epoll_unready
  *
  * Description:
- *   Setup all the fd.
+ *   Remove the epoll node from the ready list and forget its pending
+ *   events.  The poll callback of the node must have been torn down.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
+ *   epn       - The epoll node
  *
  * Returned Value:
- *   Positive on success, negative on fail
+ *   None
  *
  ****************************************************************************/
 
-static int epoll_setup(FAR epoll_head_t *eph)
+static void epoll_unready(FAR epoll_head_t *eph, FAR epoll_node_t *epn)
 {
-  FAR epoll_node_t *tepn;
-  FAR epoll_node_t *epn;
-  int ret;
-
-  ret = nxmutex_lock(&eph->lock);
-  if (ret < 0)
-    {
-      return ret;
-    }
+  irqstate_t flags;
 
-  list_for_every_entry_safe(&eph->teardown, epn, tepn, epoll_node_t, node)
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (epn->ready)
     {
-      /* Setup again to check the notified pollfd last epoll_wait() to
-       * cover the situation several poll event pending on one fd.
-       */
-
-      epn->notified    = false;
-      epn->pfd.revents = 0;
-      ret = file_poll(epn->filep, &epn->pfd, true);
-      if (ret < 0)
-        {
-          ferr("epoll setup failed, filep=%p, events=%08" PRIx32 ", "
-               "ret=%d\n", epn->filep, epn->pfd.events, ret);
-          break;
-        }
-
-      list_delete(&epn->node);
-      list_add_tail(&eph->setup, &epn->node);
+      list_delete(&epn->rnode);
+      epn->ready = false;
     }
 
-  nxmutex_unlock(&eph->lock);
-  return ret;
+  epn->pfd.revents = 0;
+  spin_unlock_irqrestore(&eph->rlock, flags);
 }
 
 /****************************************************************************
  * Name: epoll_teardown
  *
  * Description:
- *   Teardown all the notified fd and check the notified fd's event with user
- *   expected event.
+ *   Collect the events of the ready fds.  Only the ready list is visited,
+ *   so the cost depends on the number of ready fds, not on the number of
+ *   registered ones.
+ *
+ *   An EPOLLET fd keeps its poll callback and is reported again only on
+ *   the next notification.  An EPOLLONESHOT fd is torn down and moved to
+ *   the oneshot list until it is re-armed by EPOLL_CTL_MOD.  A level
+ *   triggered fd is setup again, which puts it back on the ready list if
+ *   it is still ready.
  *
  * Input Parameters:
  *   eph       - The epoll head pointer
@@ -352,42 +342,71 @@ static int epoll_setup(FAR epoll_head_t *eph)
 static int epoll_teardown(FAR epoll_head_t *eph, FAR struct epoll_event *evs,
                           int maxevents)
 {
-  FAR epoll_node_t *tepn;
+  struct list_node rearm;
   FAR epoll_node_t *epn;
+  irqstate_t flags;
+  int ret;
   int i = 0;
 
+  list_initialize(&rearm);
   nxmutex_lock(&eph->lock);
 
-  list_for_every_entry_safe(&eph->setup, epn, tepn, epoll_node_t, node)
+  flags = spin_lock_irqsave(&eph->rlock);
+  while (i < maxevents && !list_is_empty(&eph->ready))
     {
-      /* Only check the notified fd */
+      epn = container_of(list_remove_head(&eph->ready), epoll_node_t,
+                         rnode);
+      if (epn->pfd.revents != 0)
+        {
+          evs[i].data     = epn->data;
+          evs[i++].events = epn->pfd.revents;
+        }
+
+      epn->pfd.revents = 0;
+
+      /* The node stays marked ready until it is setup again, so the poll
+       * callback does not touch rnode meanwhile.
+       */
 
-      if (!epn->notified)
+      if ((epn->pfd.events & (EPOLLET | EPOLLONESHOT)) == EPOLLET)
         {
-          continue;
+          epn->ready = false;
         }
+      else
+        {
+          list_add_tail(&rearm, &epn->rnode);
+        }
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
 
-      /* Teradown all the notified fd */
+  while (!list_is_empty(&rearm))
+    {
+      epn = container_of(list_peek_head(&rearm), epoll_node_t, rnode);
 
       file_poll(epn->filep, &epn->pfd, false);
-      list_delete(&epn->node);
+      epoll_unready(eph, epn);
 
-      if (epn->pfd.revents != 0 && i < maxevents)
+      if ((epn->pfd.events & EPOLLONESHOT) != 0)
         {
-          evs[i].data     = epn->data;
-          evs[i++].events = epn->pfd.revents;
-          if ((epn->pfd.events & EPOLLONESHOT) != 0)
-            {
-              list_add_tail(&eph->oneshot, &epn->node);
-            }
-          else
-            {
-              list_add_tail(&eph->teardown, &epn->node);
-            }
+          list_delete(&epn->node);
+          list_add_tail(&eph->oneshot, &epn->node);
+          continue;
         }
-      else
+
+      /* Setup again to check whether the fd is still ready.  If that
+       * fails, the node is parked on the oneshot list until it is re-armed
+       * by EPOLL_CTL_MOD.
+       */
+
+      ret = file_poll(epn->filep, &epn->pfd, true);
+      if (ret < 0)
         {
-          list_add_tail(&eph->teardown, &epn->node);
+          ferr("epoll setup failed, filep=%p, events=%08" PRIx32 ", "
+               "ret=%d\n", epn->filep, epn->pfd.events, ret);
+          epoll_unready(eph, epn);
+          list_delete(&epn->node);
+          list_add_tail(&eph->oneshot, &epn->node);
         }
     }
 
@@ -426,16 +445,30 @@ static void epoll_cleanup(FAR void *arg)
 static void epoll_default_cb(FAR struct pollfd *fds)
 {
   FAR epoll_node_t *epn = fds->arg;
+  FAR epoll_head_t *eph = epn->eph;
+  irqstate_t flags;
   int semcount = 0;
 
-  epn->notified = true;
-  if (fds->revents != 0)
+  if (fds->revents == 0)
     {
-      nxsem_get_value(&epn->eph->sem, &semcount);
-      if (semcount < 1)
-        {
-          nxsem_post(&epn->eph->sem);
-        }
+      return;
+    }
+
+  /* Queue the node on the ready list, once */
+
+  flags = spin_lock_irqsave(&eph->rlock);
+  if (!epn->ready)
+    {
+      list_add_tail(&eph->ready, &epn->rnode);
+      epn->ready = true;
+    }
+
+  spin_unlock_irqrestore(&eph->rlock, flags);
+
+  nxsem_get_value(&eph->sem, &semcount);
+  if (semcount < 1)
+    {
+      nxsem_post(&eph->sem);
     }
 }
 
@@ -540,15 +573,6 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
               }
           }
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                ret = -EEXIST;
-                goto err;
-              }
-          }
-
         list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
           {
             if (epn->pfd.fd == fd)
@@ -585,7 +609,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         epn = container_of(list_remove_head(&eph->free), epoll_node_t, node);
         epn->eph         = eph;
         epn->data        = ev->data;
-        epn->notified    = false;
+        epn->ready       = false;
         epn->pfd.events  = ev->events | POLLALWAYS;
         epn->pfd.fd      = fd;
         epn->pfd.arg     = epn;
@@ -602,6 +626,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
         ret = file_poll(epn->filep, &epn->pfd, true);
         if (ret < 0)
           {
+            epoll_unready(eph, epn);
             file_put(epn->filep);
             list_add_tail(&eph->free, &epn->node);
             goto err;
@@ -617,17 +642,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
             if (epn->pfd.fd == fd)
               {
                 file_poll(epn->filep, &epn->pfd, false);
-                file_put(epn->filep);
-                list_delete(&epn->node);
-                list_add_tail(&eph->free, &epn->node);
-                goto out;
-              }
-          }
-
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
+                epoll_unready(eph, epn);
                 file_put(epn->filep);
                 list_delete(&epn->node);
                 list_add_tail(&eph->free, &epn->node);
@@ -654,18 +669,20 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
           {
             if (epn->pfd.fd == fd)
               {
+                epn->data = ev->data;
                 if (epn->pfd.events != (ev->events | POLLALWAYS))
                   {
                     file_poll(epn->filep, &epn->pfd, false);
+                    epoll_unready(eph, epn);
 
-                    epn->notified    = false;
-                    epn->data        = ev->data;
                     epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.revents = 0;
 
                     ret = file_poll(epn->filep, &epn->pfd, true);
                     if (ret < 0)
                       {
+                        epoll_unready(eph, epn);
+                        list_delete(&epn->node);
+                        list_add_tail(&eph->oneshot, &epn->node);
                         goto err;
                       }
                   }
@@ -674,36 +691,10 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
               }
           }
 
-        list_for_every_entry(&eph->teardown, epn, epoll_node_t, node)
-          {
-            if (epn->pfd.fd == fd)
-              {
-                if (epn->pfd.events != (ev->events | POLLALWAYS))
-                  {
-                    epn->notified    = false;
-                    epn->data        = ev->data;
-                    epn->pfd.events  = ev->events | POLLALWAYS;
-                    epn->pfd.revents = 0;
-
-                    ret = file_poll(epn->filep, &epn->pfd, true);
-                    if (ret < 0)
-                      {
-                        goto err;
-                      }
-
-                    list_delete(&epn->node);
-                    list_add_tail(&eph->setup, &epn->node);
-                  }
-
-                goto out;
-              }
-          }
-
         list_for_every_entry(&eph->oneshot, epn, epoll_node_t, node)
           {
             if (epn->pfd.fd == fd)
               {
-                epn->notified    = false;
                 epn->data        = ev->data;
                 epn->pfd.events  = ev->events | POLLALWAYS;
                 epn->pfd.revents = 0;
@@ -711,6 +702,7 @@ int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
                 ret = file_poll(epn->filep, &epn->pfd, true);
                 if (ret < 0)
                   {
+                    epoll_unready(eph, epn);
                     goto err;
                   }
 
@@ -758,10 +750,13 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
     }
 
 retry:
-  ret = epoll_setup(eph);
-  if (ret < 0)
+  ret = epoll_teardown(eph, evs, maxevents);
+  if (ret > 0)
     {
-      goto err;
+      /* Some fds are already ready, there is no need to wait */
+
+      file_put(filep);
+      return ret;
     }
 
   /* Wait the poll ready */
@@ -843,10 +838,13 @@ int epoll_wait(int epfd, FAR struct epoll_event *evs,
     }
 
 retry:
-  ret = epoll_setup(eph);
-  if (ret < 0)
+  ret = epoll_teardown(eph, evs, maxevents);
+  if (ret > 0)
     {
-      goto err;
+      /* Some fds are already ready, there is no need to wait */
+
+      file_put(filep);
+      return ret;
     }
 
   /* Push a cancellation point onto the stack.  This will be called if
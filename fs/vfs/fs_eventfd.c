@@ -33,6 +33,7 @@
 
 #include <debug.h>
 #include <nuttx/mutex.h>
+#include <nuttx/waitqueue.h>
 #include <sys/ioctl.h>
 #include <sys/eventfd.h>
 
@@ -43,29 +44,15 @@
  * Private Types
  ****************************************************************************/
 
-typedef struct eventfd_waiter_sem_s
-{
-  sem_t sem;
-  FAR struct eventfd_waiter_sem_s *next;
-} eventfd_waiter_sem_t;
-
 /* This structure describes the internal state of the driver */
 
 struct eventfd_priv_s
 {
   mutex_t                   lock;    /* Enforces device exclusive access */
-  FAR eventfd_waiter_sem_t *rdsems;  /* List of blocking readers */
-  FAR eventfd_waiter_sem_t *wrsems;  /* List of blocking writers */
+  waitq_t                   rdwq;    /* Blocking readers and poll waiters */
+  waitq_t                   wrwq;    /* Blocking writers */
   eventfd_t                 counter; /* eventfd counter */
   uint8_t                   crefs;   /* References counts on eventfd (max: 255) */
-
-  /* The following is a list if poll structures of threads waiting for
-   * driver events.
-   */
-
-#ifdef CONFIG_EVENT_FD_POLL
-  FAR struct pollfd *fds[CONFIG_EVENT_FD_NPOLLWAITERS];
-#endif
 };
 
 /****************************************************************************
@@ -84,10 +71,6 @@ static int eventfd_do_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 #endif
 
-static int eventfd_blocking_io(FAR struct eventfd_priv_s *dev,
-                               FAR eventfd_waiter_sem_t  *sem,
-                               FAR eventfd_waiter_sem_t **slist);
-
 static FAR struct eventfd_priv_s *eventfd_allocdev(void);
 static void eventfd_destroy(FAR struct eventfd_priv_s *dev);
 
@@ -137,6 +120,8 @@ static FAR struct eventfd_priv_s *eventfd_allocdev(void)
       /* Initialize the private structure */
 
       nxmutex_init(&dev->lock);
+      nxwaitq_init(&dev->rdwq);
+      nxwaitq_init(&dev->wrwq);
       nxmutex_lock(&dev->lock);
       dev->crefs++;
     }
@@ -216,62 +201,10 @@ static int eventfd_do_close(FAR struct file *filep)
   return OK;
 }
 
-static int eventfd_blocking_io(FAR struct eventfd_priv_s *dev,
-                               FAR eventfd_waiter_sem_t  *sem,
-                               FAR eventfd_waiter_sem_t **slist)
-{
-  int ret;
-
-  sem->next = *slist;
-  *slist = sem;
-
-  nxmutex_unlock(&dev->lock);
-
-  /* Wait for eventfd to notify */
-
-  ret = nxsem_wait(&sem->sem);
-
-  if (ret < 0)
-    {
-      FAR eventfd_waiter_sem_t *cur_sem;
-
-      /* Interrupted wait, unregister semaphore
-       * TODO ensure that lock wait does not fail (ECANCELED)
-       */
-
-      nxmutex_lock(&dev->lock);
-
-      cur_sem = *slist;
-      if (cur_sem == sem)
-        {
-          *slist = sem->next;
-        }
-      else
-        {
-          while (cur_sem)
-            {
-              if (cur_sem->next == sem)
-                {
-                  cur_sem->next = sem->next;
-                  break;
-                }
-
-              cur_sem = cur_sem->next;
-            }
-        }
-
-      nxmutex_unlock(&dev->lock);
-      return ret;
-    }
-
-  return nxmutex_lock(&dev->lock);
-}
-
 static ssize_t eventfd_do_read(FAR struct file *filep, FAR char *buffer,
                                size_t len)
 {
   FAR struct eventfd_priv_s *dev = filep->f_priv;
-  FAR eventfd_waiter_sem_t *cur_sem;
   ssize_t ret;
 
   if (len < sizeof(eventfd_t) || buffer == NULL)
@@ -289,27 +222,25 @@ static ssize_t eventfd_do_read(FAR struct file *filep, FAR char *buffer,
 
   if (dev->counter == 0)
     {
-      eventfd_waiter_sem_t sem;
-
       if (filep->f_oflags & O_NONBLOCK)
         {
           nxmutex_unlock(&dev->lock);
           return -EAGAIN;
         }
 
-      nxsem_init(&sem.sem, 0, 0);
+      /* One writer wakes one reader, the readers do not all race for
+       * the counter.
+       */
+
       do
         {
-          ret = eventfd_blocking_io(dev, &sem, &dev->rdsems);
+          ret = nxwaitq_wait(&dev->rdwq, &dev->lock, true);
           if (ret < 0)
             {
-              nxsem_destroy(&sem.sem);
               return ret;
             }
         }
       while (dev->counter == 0);
-
-      nxsem_destroy(&sem.sem);
     }
 
   /* Device ready for read */
@@ -318,6 +249,13 @@ static ssize_t eventfd_do_read(FAR struct file *filep, FAR char *buffer,
     {
       *(FAR eventfd_t *)buffer = 1;
       dev->counter -= 1;
+
+      /* Let the next reader take the rest */
+
+      if (dev->counter > 0)
+        {
+          nxwaitq_wake(&dev->rdwq, false);
+        }
     }
   else
     {
@@ -328,19 +266,12 @@ static ssize_t eventfd_do_read(FAR struct file *filep, FAR char *buffer,
 #ifdef CONFIG_EVENT_FD_POLL
   /* Notify all poll/select waiters */
 
-  poll_notify(dev->fds, CONFIG_EVENT_FD_NPOLLWAITERS, POLLOUT);
+  nxwaitq_notify(&dev->rdwq, POLLOUT);
 #endif
 
   /* Notify all waiting writers that counter have been decremented */
 
-  cur_sem = dev->wrsems;
-  while (cur_sem != NULL)
-    {
-      nxsem_post(&cur_sem->sem);
-      cur_sem = cur_sem->next;
-    }
-
-  dev->wrsems = NULL;
+  nxwaitq_wake(&dev->wrwq, true);
 
   nxmutex_unlock(&dev->lock);
   return sizeof(eventfd_t);
@@ -350,7 +281,6 @@ static ssize_t eventfd_do_write(FAR struct file *filep,
                                 FAR const char *buffer, size_t len)
 {
   FAR struct eventfd_priv_s *dev = filep->f_priv;
-  FAR eventfd_waiter_sem_t *cur_sem;
   eventfd_t new_counter;
   ssize_t ret;
 
@@ -371,8 +301,6 @@ static ssize_t eventfd_do_write(FAR struct file *filep,
 
   if (new_counter < dev->counter)
     {
-      eventfd_waiter_sem_t sem;
-
       /* Overflow detected */
 
       if (filep->f_oflags & O_NONBLOCK)
@@ -381,20 +309,16 @@ static ssize_t eventfd_do_write(FAR struct file *filep,
           return -EAGAIN;
         }
 
-      nxsem_init(&sem.sem, 0, 0);
       do
         {
-          ret = eventfd_blocking_io(dev, &sem, &dev->wrsems);
+          ret = nxwaitq_wait(&dev->wrwq, &dev->lock, false);
           if (ret < 0)
             {
-              nxsem_destroy(&sem.sem);
               return ret;
             }
         }
       while ((new_counter = dev->counter + *(FAR eventfd_t *)buffer)
             < dev->counter);
-
-      nxsem_destroy(&sem.sem);
     }
 
   /* Ready to write, update counter */
@@ -404,19 +328,12 @@ static ssize_t eventfd_do_write(FAR struct file *filep,
 #ifdef CONFIG_EVENT_FD_POLL
   /* Notify all poll/select waiters */
 
-  poll_notify(dev->fds, CONFIG_EVENT_FD_NPOLLWAITERS, POLLIN);
+  nxwaitq_notify(&dev->rdwq, POLLIN);
 #endif
 
-  /* Notify all of the waiting readers */
-
-  cur_sem = dev->rdsems;
-  while (cur_sem != NULL)
-    {
-      nxsem_post(&cur_sem->sem);
-      cur_sem = cur_sem->next;
-    }
+  /* Wake one of the waiting readers */
 
-  dev->rdsems = NULL;
+  nxwaitq_wake(&dev->rdwq, false);
 
   nxmutex_unlock(&dev->lock);
   return sizeof(eventfd_t);
@@ -428,7 +345,6 @@ static int eventfd_do_poll(FAR struct file *filep, FAR struct pollfd *fds,
 {
   FAR struct eventfd_priv_s *dev = filep->f_priv;
   int ret;
-  int i;
   pollevent_t eventset;
 
   ret = nxmutex_lock(&dev->lock);
@@ -437,43 +353,9 @@ static int eventfd_do_poll(FAR struct file *filep, FAR struct pollfd *fds,
       return ret;
     }
 
-  ret = OK;
-
-  if (!setup)
-    {
-      /* This is a request to tear down the poll. */
-
-      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
-
-      /* Remove all memory of the poll setup */
-
-      *slot     = NULL;
-      fds->priv = NULL;
-      goto out;
-    }
-
-  /* This is a request to set up the poll. Find an available
-   * slot for the poll structure reference
-   */
-
-  for (i = 0; i < CONFIG_EVENT_FD_NPOLLWAITERS; i++)
-    {
-      /* Find an available slot */
-
-      if (!dev->fds[i])
-        {
-          /* Bind the poll structure and this slot */
-
-          dev->fds[i] = fds;
-          fds->priv   = &dev->fds[i];
-          break;
-        }
-    }
-
-  if (i >= CONFIG_EVENT_FD_NPOLLWAITERS)
+  ret = nxwaitq_poll(&dev->rdwq, fds, setup);
+  if (!setup || ret < 0)
     {
-      fds->priv = NULL;
-      ret       = -EBUSY;
       goto out;
     }
 
@@ -176,6 +176,9 @@ int file_fchstat(FAR struct file *filep, FAR struct stat *buf, int flags)
           /* Perform the fchstat() operation */
 
           ret = inode->u.i_mops->fchstat(filep, buf, flags);
+#ifdef CONFIG_FS_DCACHE
+          dcache_modified(inode);
+#endif
         }
       else
         {
@@ -36,6 +36,7 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/net/net.h>
 #include "inode/inode.h"
+#include "vfs.h"
 
 /****************************************************************************
  * Private Functions
@@ -197,6 +198,12 @@ int file_fstat(FAR struct file *filep, FAR struct stat *buf)
           /* Perform the fstat() operation */
 
           ret = inode->u.i_mops->fstat(filep, buf);
+#ifdef CONFIG_FS_PAGECACHE
+          if (ret >= 0)
+            {
+              pagecache_stat(filep, NULL, buf);
+            }
+#endif
         }
     }
   else
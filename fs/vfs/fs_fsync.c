@@ -37,6 +37,7 @@
 #include <nuttx/fs/ioctl.h>
 
 #include "inode/inode.h"
+#include "vfs.h"
 
 /****************************************************************************
  * Public Functions
@@ -68,6 +69,18 @@ int file_fsync(FAR struct file *filep)
 #ifndef CONFIG_DISABLE_MOUNTPOINT
       if (INODE_IS_MOUNTPT(inode))
         {
+#ifdef CONFIG_FS_DCACHE
+          dcache_modified(inode);
+#endif
+
+#ifdef CONFIG_FS_PAGECACHE
+          ret = pagecache_fsync(filep);
+          if (ret != -ENOSYS)
+            {
+              return ret;
+            }
+#endif
+
           if (inode->u.i_mops && inode->u.i_mops->sync)
             {
               /* Yes, then tell the mountpoint to sync this file */
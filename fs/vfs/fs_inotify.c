@@ -96,6 +96,7 @@ struct inotify_global_s
   int      watch_cookie;       /* Watch cookie */
   uint32_t read_count;         /* Number of read events */
   uint32_t write_count;        /* Number of write events */
+  uint32_t generation;         /* Changed with the watches, never 0 */
   struct   hsearch_data hash;  /* Hash table for watch lists */
 };
 
@@ -143,13 +144,31 @@ static struct inode g_inotify_inode =
 
 static struct inotify_global_s g_inotify =
 {
-  .lock = NXMUTEX_INITIALIZER,
+  .lock       = NXMUTEX_INITIALIZER,
+  .generation = 1,
 };
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: inotify_new_generation
+ *
+ * Description:
+ *   Forget which files were found not watched, the watches or the paths
+ *   changed.
+ *
+ ****************************************************************************/
+
+static void inotify_new_generation(void)
+{
+  if (++g_inotify.generation == 0)
+    {
+      g_inotify.generation = 1;
+    }
+}
+
 /****************************************************************************
  * Name: notify_add_count
  *
@@ -162,6 +181,7 @@ static void inotify_add_count(uint32_t mask)
 {
   g_inotify.read_count += (mask & IN_ACCESS) ? 1 : 0;
   g_inotify.write_count += (mask & IN_MODIFY) ? 1 : 0;
+  inotify_new_generation();
 }
 
 /****************************************************************************
@@ -232,6 +252,23 @@ inotify_alloc_event(int wd, uint32_t mask, uint32_t cookie,
   return event;
 }
 
+/****************************************************************************
+ * Name: inotify_same_file
+ *
+ * Description:
+ *   Check whether a queued event is about the watched file wd, or about
+ *   its entry name if it is a directory.
+ *
+ ****************************************************************************/
+
+static bool inotify_same_file(FAR struct inotify_event_s *event, int wd,
+                              FAR const char *name)
+{
+  return event->event.wd == wd &&
+         ((name == NULL && event->event.len == 0) ||
+          (name && event->event.len && !strcmp(name, event->event.name)));
+}
+
 /****************************************************************************
  * Name: inotify_queue_event
  *
@@ -254,13 +291,34 @@ static void inotify_queue_event(FAR struct inotify_device_s *dev, int wd,
 
       last = list_last_entry(&dev->events,
                              struct inotify_event_s, node);
-      if (last->event.mask == mask && last->event.wd == wd &&
-          last->event.cookie == cookie &&
-          ((name == NULL && last->event.len == 0) ||
-           (name && last->event.len && !strcmp(name, last->event.name))))
+      if (last->event.mask == mask && last->event.cookie == cookie &&
+          inotify_same_file(last, wd, name))
         {
           return;
         }
+
+#ifdef CONFIG_FS_NOTIFY_COALESCE
+      /* Drop an access or modification if the same one of the same file
+       * is still queued, with no other event of that file after it.
+       */
+
+      if ((mask & ~IN_ISDIR) == IN_ACCESS || (mask & ~IN_ISDIR) == IN_MODIFY)
+        {
+          list_for_every_entry_reverse(&dev->events, last,
+                                       struct inotify_event_s, node)
+            {
+              if (inotify_same_file(last, wd, name))
+                {
+                  if (last->event.mask == mask)
+                    {
+                      return;
+                    }
+
+                  break;
+                }
+            }
+        }
+#endif
     }
 
   if (dev->event_count > CONFIG_FS_NOTIFY_MAX_EVENTS)
@@ -849,7 +907,7 @@ inotify_queue_watch_list_event(FAR struct inotify_watch_list_s *list,
  *
  ****************************************************************************/
 
-static void inotify_queue_parent_event(FAR char *path, uint32_t mask,
+static bool inotify_queue_parent_event(FAR char *path, uint32_t mask,
                                        uint32_t cookie)
 {
   FAR struct inotify_watch_list_s *list;
@@ -858,15 +916,18 @@ static void inotify_queue_parent_event(FAR char *path, uint32_t mask,
   name = basename(path);
   if (name == NULL || name == path)
     {
-      return;
+      return false;
     }
 
   *(name - 1) = '\0';
   list = inotify_get_watch_list(path);
-  if (list != NULL)
+  if (list == NULL)
     {
-      inotify_queue_watch_list_event(list, mask | IN_ISDIR, cookie, name);
+      return false;
     }
+
+  inotify_queue_watch_list_event(list, mask | IN_ISDIR, cookie, name);
+  return true;
 }
 
 /****************************************************************************
@@ -875,26 +936,30 @@ static void inotify_queue_parent_event(FAR char *path, uint32_t mask,
  * Description:
  *   Send the notification by the path.
  *
+ * Returned Value:
+ *   False if neither the path nor its directory is watched.
+ *
  ****************************************************************************/
 
-static void notify_queue_path_event(FAR const char *path, uint32_t mask)
+static bool notify_queue_path_event(FAR const char *path, uint32_t mask)
 {
   FAR struct inotify_watch_list_s *list;
   FAR char *abspath;
   FAR char *pathbuffer;
   uint32_t cookie = 0;
+  bool watched;
 
   pathbuffer = lib_get_pathbuffer();
   if (pathbuffer == NULL)
     {
-      return;
+      return true;
     }
 
   abspath = lib_realpath(path, pathbuffer, true);
   if (abspath == NULL)
     {
       lib_put_pathbuffer(pathbuffer);
-      return;
+      return true;
     }
 
   if (mask & IN_MOVE)
@@ -908,11 +973,11 @@ static void notify_queue_path_event(FAR const char *path, uint32_t mask)
     }
 
   list = inotify_get_watch_list(abspath);
-  inotify_queue_parent_event(abspath, mask, cookie);
+  watched = inotify_queue_parent_event(abspath, mask, cookie);
   lib_put_pathbuffer(pathbuffer);
   if (list == NULL)
     {
-      return;
+      return watched;
     }
 
   if (mask & IN_MOVED_FROM)
@@ -936,6 +1001,8 @@ static void notify_queue_path_event(FAR const char *path, uint32_t mask)
     {
       inotify_queue_watch_list_event(list, mask, cookie, NULL);
     }
+
+  return true;
 }
 
 /****************************************************************************
@@ -983,8 +1050,17 @@ static inline void notify_queue_filep_event(FAR struct file *filep,
       return;
     }
 
+  /* Nothing to do if the file was found not watched and the watches did
+   * not change since.
+   */
+
   nxmutex_lock(&g_inotify.lock);
   ret = notify_check_mask(mask);
+  if (filep->f_notifygen == g_inotify.generation)
+    {
+      ret = -ENOENT;
+    }
+
   nxmutex_unlock(&g_inotify.lock);
   if (ret < 0)
     {
@@ -1010,7 +1086,11 @@ static inline void notify_queue_filep_event(FAR struct file *filep,
     }
 
   nxmutex_lock(&g_inotify.lock);
-  notify_queue_path_event(pathbuffer, mask);
+  if (!notify_queue_path_event(pathbuffer, mask))
+    {
+      filep->f_notifygen = g_inotify.generation;
+    }
+
   lib_put_pathbuffer(pathbuffer);
   nxmutex_unlock(&g_inotify.lock);
 }
@@ -1513,5 +1593,9 @@ void notify_rename(FAR const char *oldpath, bool oldisdir,
   nxmutex_lock(&g_inotify.lock);
   notify_queue_path_event(oldpath, oldmask);
   notify_queue_path_event(newpath, newmask);
+
+  /* The open files below the paths have other paths now */
+
+  inotify_new_generation();
   nxmutex_unlock(&g_inotify.lock);
 }
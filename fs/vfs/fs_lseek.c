@@ -33,6 +33,7 @@
 #include <assert.h>
 
 #include "inode/inode.h"
+#include "vfs.h"
 
 /****************************************************************************
  * Public Functions
@@ -64,6 +65,16 @@ off_t file_seek(FAR struct file *filep, off_t offset, int whence)
   DEBUGASSERT(filep);
   inode =  filep->f_inode;
 
+#ifdef CONFIG_FS_PAGECACHE
+  /* The file system does not know the size of a cached file */
+
+  ret = pagecache_seek(filep, offset, whence);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
   /* Invoke the file seek method if available */
 
   if (inode && inode->u.i_ops && inode->u.i_ops->seek)
@@ -111,6 +111,10 @@ int mkdir(const char *pathname, mode_t mode)
               errcode = -ret;
               goto errout_with_inode;
             }
+
+#ifdef CONFIG_FS_DCACHE
+          dcache_invalidate(inode, desc.relpath);
+#endif
         }
       else
         {
@@ -245,7 +245,43 @@ static int file_vopen(FAR struct file *filep, FAR const char *path,
     {
       if (inode->u.i_mops->open != NULL)
         {
+#ifdef CONFIG_FS_DCACHE
+          unsigned int gen = 0;
+#endif
+
+#ifdef CONFIG_FS_PAGECACHE
+          if ((oflags & O_TRUNC) != 0)
+            {
+              pagecache_sync(path);
+            }
+#endif
+
+#ifdef CONFIG_FS_DCACHE
+          /* A path known not to exist fails without asking the file
+           * system, unless it is to be created.
+           */
+
+          if ((oflags & O_CREAT) == 0 &&
+              dcache_lookup(inode, desc.relpath, NULL, &gen) == -ENOENT)
+            {
+              ret = -ENOENT;
+            }
+          else
+            {
+              ret = inode->u.i_mops->open(filep, desc.relpath, oflags,
+                                          mode);
+              dcache_open(inode, desc.relpath, oflags, ret, gen);
+            }
+#else
           ret = inode->u.i_mops->open(filep, desc.relpath, oflags, mode);
+#endif
+
+#ifdef CONFIG_FS_PAGECACHE
+          if (ret >= 0)
+            {
+              pagecache_open(filep, path, desc.relpath);
+            }
+#endif
         }
     }
 #endif
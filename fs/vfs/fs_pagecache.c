@@ -0,0 +1,1415 @@
+/****************************************************************************
+ * fs/vfs/fs_pagecache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <search.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+
+#include "inode/inode.h"
+#include "fs_heap.h"
+#include "vfs.h"
+
+#ifdef CONFIG_FS_PAGECACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PAGECACHE_SIZE       CONFIG_FS_PAGECACHE_PAGESIZE
+#define PAGECACHE_POS(index) ((off_t)(index) * PAGECACHE_SIZE)
+
+/* The number of mountpoints whose file system type is remembered */
+
+#define PAGECACHE_NMOUNTS    4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pagecache_file_s;
+
+/* One cached page of a file */
+
+struct pagecache_page_s
+{
+  struct list_node             pg_node;  /* In the file's list, by index */
+  struct list_node             pg_lru;   /* In g_pagecache_lru */
+  FAR struct pagecache_file_s *pg_file;  /* The file the page belongs to */
+  off_t                        pg_index; /* Page number in the file */
+  bool                         pg_dirty; /* Not yet written back */
+  uint8_t                      pg_data[PAGECACHE_SIZE];
+};
+
+/* The cache of one file, shared by all the opens of its path.  The pages
+ * are kept after the last close, so that opening the file again finds
+ * them, until they are reclaimed or the file changes.
+ */
+
+struct pagecache_file_s
+{
+  struct list_node  pc_node;    /* In g_pagecache_files */
+  struct list_node  pc_pages;   /* Cached pages, in index order */
+  FAR char         *pc_path;    /* Hash key, NULL once invalidated */
+  FAR struct inode *pc_mountpt; /* The mountpoint holding the file */
+  struct file       pc_file;    /* Private handle for fill and write-back */
+  off_t             pc_size;    /* File size, including the dirty data */
+  off_t             pc_next;    /* Next page of a sequential read */
+  struct timespec   pc_mtime;   /* Modification time at the last close */
+  unsigned int      pc_nusers;  /* Open files using the cache */
+  unsigned int      pc_ndirty;  /* Number of dirty pages */
+};
+
+struct pagecache_mount_s
+{
+  FAR struct inode *pm_inode;   /* The mountpoint */
+  bool              pm_cached;  /* Its files may be cached */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static mutex_t g_pagecache_lock = NXMUTEX_INITIALIZER;
+static struct hsearch_data g_pagecache_table;
+static struct list_node g_pagecache_files =
+  LIST_INITIAL_VALUE(g_pagecache_files);
+
+/* All pages, the most recently used first */
+
+static struct list_node g_pagecache_lru =
+  LIST_INITIAL_VALUE(g_pagecache_lru);
+static unsigned int g_pagecache_npages;
+
+static struct pagecache_mount_s g_pagecache_mounts[PAGECACHE_NMOUNTS];
+static unsigned int g_pagecache_nextmount;
+
+static struct work_s g_pagecache_work;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_free_entry
+ ****************************************************************************/
+
+static void pagecache_free_entry(FAR ENTRY *entry)
+{
+  /* The entry data is released by pagecache_release() */
+
+  fs_heap_free(entry->key);
+}
+
+/****************************************************************************
+ * Name: pagecache_cacheable
+ *
+ * Description:
+ *   Return true if the files of the mountpoint may be cached.  Only the
+ *   file systems on block and MTD devices are:  caching tmpfs or procfs
+ *   would only waste memory, and those of remote file systems would not be
+ *   coherent.
+ *
+ ****************************************************************************/
+
+static bool pagecache_cacheable(FAR struct inode *mountpt)
+{
+  FAR struct pagecache_mount_s *pm;
+  struct statfs buf;
+  int i;
+
+  for (i = 0; i < PAGECACHE_NMOUNTS; i++)
+    {
+      if (g_pagecache_mounts[i].pm_inode == mountpt)
+        {
+          return g_pagecache_mounts[i].pm_cached;
+        }
+    }
+
+  pm = &g_pagecache_mounts[g_pagecache_nextmount];
+  g_pagecache_nextmount = (g_pagecache_nextmount + 1) % PAGECACHE_NMOUNTS;
+
+  pm->pm_inode  = mountpt;
+  pm->pm_cached = false;
+
+  if (mountpt->u.i_mops->statfs == NULL ||
+      mountpt->u.i_mops->statfs(mountpt, &buf) < 0)
+    {
+      return false;
+    }
+
+  switch (buf.f_type)
+    {
+      case MSDOS_SUPER_MAGIC:
+      case LITTLEFS_SUPER_MAGIC:
+      case MNEMOFS_SUPER_MAGIC:
+      case ROMFS_MAGIC:
+      case SMARTFS_MAGIC:
+        pm->pm_cached = true;
+        break;
+
+      default:
+        break;
+    }
+
+  return pm->pm_cached;
+}
+
+/****************************************************************************
+ * Name: pagecache_find
+ ****************************************************************************/
+
+static FAR struct pagecache_file_s *pagecache_find(FAR const char *path)
+{
+  FAR ENTRY *hretvalue;
+  ENTRY item;
+
+  item.key  = (FAR char *)path;
+  item.data = NULL;
+
+  if (hsearch_r(item, FIND, &hretvalue, &g_pagecache_table) == 1)
+    {
+      return hretvalue->data;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: pagecache_create
+ ****************************************************************************/
+
+static FAR struct pagecache_file_s *
+pagecache_create(FAR const char *path, FAR struct inode *mountpt)
+{
+  FAR struct pagecache_file_s *pc;
+  FAR ENTRY *hretvalue;
+  ENTRY item;
+
+  pc = fs_heap_zalloc(sizeof(*pc));
+  if (pc == NULL)
+    {
+      return NULL;
+    }
+
+  item.key = fs_heap_strdup(path);
+  if (item.key == NULL)
+    {
+      fs_heap_free(pc);
+      return NULL;
+    }
+
+  item.data = pc;
+
+  if (hsearch_r(item, ENTER, &hretvalue, &g_pagecache_table) == 0)
+    {
+      fs_heap_free(item.key);
+      fs_heap_free(pc);
+      return NULL;
+    }
+
+  list_initialize(&pc->pc_pages);
+  list_add_tail(&g_pagecache_files, &pc->pc_node);
+  pc->pc_path    = item.key;
+  pc->pc_mountpt = mountpt;
+  return pc;
+}
+
+/****************************************************************************
+ * Name: pagecache_unhash
+ *
+ * Description:
+ *   Remove the file from the hash table, so that a later open of the path
+ *   gets a new entry.
+ *
+ ****************************************************************************/
+
+static void pagecache_unhash(FAR struct pagecache_file_s *pc)
+{
+  ENTRY item;
+
+  if (pc->pc_path != NULL)
+    {
+      item.key = pc->pc_path;
+      hsearch_r(item, DELETE, NULL, &g_pagecache_table);
+      pc->pc_path = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: pagecache_release
+ ****************************************************************************/
+
+static void pagecache_release(FAR struct pagecache_file_s *pc)
+{
+  DEBUGASSERT(pc->pc_nusers == 0 && list_is_empty(&pc->pc_pages));
+
+  pagecache_unhash(pc);
+  list_delete(&pc->pc_node);
+  fs_heap_free(pc);
+}
+
+/****************************************************************************
+ * Name: pagecache_freepage
+ ****************************************************************************/
+
+static void pagecache_freepage(FAR struct pagecache_page_s *page)
+{
+  if (page->pg_dirty)
+    {
+      page->pg_file->pc_ndirty--;
+    }
+
+  list_delete(&page->pg_node);
+  list_delete(&page->pg_lru);
+  g_pagecache_npages--;
+  fs_heap_free(page);
+}
+
+/****************************************************************************
+ * Name: pagecache_drop
+ *
+ * Description:
+ *   Discard the cached pages from 'index' on, dirty or not.
+ *
+ ****************************************************************************/
+
+static void pagecache_drop(FAR struct pagecache_file_s *pc, off_t index)
+{
+  FAR struct pagecache_page_s *page;
+  FAR struct pagecache_page_s *tmp;
+
+  list_for_every_entry_safe(&pc->pc_pages, page, tmp,
+                            struct pagecache_page_s, pg_node)
+    {
+      if (page->pg_index >= index)
+        {
+          pagecache_freepage(page);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pagecache_openfile
+ *
+ * Description:
+ *   Open the private handle that is used to fill the pages and to write
+ *   them back.  It is opened for writing if the file system allows it, so
+ *   that the cache does not depend on the access mode of any user.
+ *
+ ****************************************************************************/
+
+static int pagecache_openfile(FAR struct pagecache_file_s *pc,
+                              FAR struct file *filep,
+                              FAR const char *relpath)
+{
+  FAR struct inode *inode = pc->pc_mountpt;
+  int ret;
+
+  memset(filep, 0, sizeof(*filep));
+  inode_addref(inode);
+  filep->f_inode  = inode;
+  filep->f_oflags = O_RDWR;
+
+  ret = inode->u.i_mops->open(filep, relpath, O_RDWR, 0);
+  if (ret < 0)
+    {
+      filep->f_oflags = O_RDONLY;
+      ret = inode->u.i_mops->open(filep, relpath, O_RDONLY, 0);
+    }
+
+  if (ret < 0)
+    {
+      filep->f_inode = NULL;
+      inode_release(inode);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_closefile
+ ****************************************************************************/
+
+static void pagecache_closefile(FAR struct pagecache_file_s *pc)
+{
+  FAR struct file *filep = &pc->pc_file;
+  FAR struct inode *inode = filep->f_inode;
+
+  if (inode->u.i_mops->close != NULL)
+    {
+      inode->u.i_mops->close(filep);
+    }
+
+  filep->f_inode = NULL;
+  inode_release(inode);
+}
+
+/****************************************************************************
+ * Name: pagecache_fill
+ *
+ * Description:
+ *   Read a page from the file system.  The part past the end of the file
+ *   is left zeroed.
+ *
+ ****************************************************************************/
+
+static int pagecache_fill(FAR struct pagecache_file_s *pc,
+                          FAR struct pagecache_page_s *page)
+{
+  FAR struct file *filep = &pc->pc_file;
+  FAR const struct mountpt_operations *mops = filep->f_inode->u.i_mops;
+  size_t nfilled = 0;
+  ssize_t nread;
+  off_t pos;
+
+  pos = mops->seek(filep, PAGECACHE_POS(page->pg_index), SEEK_SET);
+  if (pos < 0)
+    {
+      return pos;
+    }
+
+  while (nfilled < PAGECACHE_SIZE)
+    {
+      nread = mops->read(filep, (FAR char *)page->pg_data + nfilled,
+                         PAGECACHE_SIZE - nfilled);
+      if (nread == -EINTR)
+        {
+          continue;
+        }
+      else if (nread <= 0)
+        {
+          return nread;
+        }
+
+      nfilled += nread;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_writeback
+ ****************************************************************************/
+
+static int pagecache_writeback(FAR struct pagecache_page_s *page)
+{
+  FAR struct pagecache_file_s *pc = page->pg_file;
+  FAR struct file *filep = &pc->pc_file;
+  FAR const struct mountpt_operations *mops = filep->f_inode->u.i_mops;
+  off_t pos = PAGECACHE_POS(page->pg_index);
+  size_t nwritten = 0;
+  ssize_t ret;
+  size_t len;
+
+  DEBUGASSERT(page->pg_dirty);
+
+#ifdef CONFIG_FS_DCACHE
+  dcache_modified(filep->f_inode);
+#endif
+
+  /* The page may be partly or wholly beyond a truncated end of the file */
+
+  if (pos < pc->pc_size)
+    {
+      len = MIN(PAGECACHE_SIZE, pc->pc_size - pos);
+
+      ret = mops->seek(filep, pos, SEEK_SET);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      while (nwritten < len)
+        {
+          ret = mops->write(filep, (FAR const char *)page->pg_data +
+                            nwritten, len - nwritten);
+          if (ret == -EINTR)
+            {
+              continue;
+            }
+          else if (ret < 0)
+            {
+              ferr("ERROR: Write back of %s at %" PRIdOFF " failed: %zd\n",
+                   pc->pc_path ? pc->pc_path : "(unlinked)", pos, ret);
+              return ret;
+            }
+
+          nwritten += ret;
+        }
+    }
+
+  page->pg_dirty = false;
+  pc->pc_ndirty--;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_flush
+ *
+ * Description:
+ *   Write back the dirty pages of a file, in order.
+ *
+ ****************************************************************************/
+
+static int pagecache_flush(FAR struct pagecache_file_s *pc)
+{
+  FAR struct pagecache_page_s *page;
+  int result = OK;
+  int ret;
+
+  if (pc->pc_ndirty == 0)
+    {
+      return OK;
+    }
+
+  list_for_every_entry(&pc->pc_pages, page, struct pagecache_page_s,
+                       pg_node)
+    {
+      if (page->pg_dirty)
+        {
+          ret = pagecache_writeback(page);
+          if (ret < 0 && result == OK)
+            {
+              result = ret;
+            }
+        }
+    }
+
+  return result;
+}
+
+/****************************************************************************
+ * Name: pagecache_reclaim
+ *
+ * Description:
+ *   Free the least recently used page that can be freed.  A dirty page is
+ *   written back first.  Returns false if no page could be freed.
+ *
+ ****************************************************************************/
+
+static bool pagecache_reclaim(void)
+{
+  FAR struct pagecache_file_s *pc;
+  FAR struct pagecache_page_s *page;
+
+  list_for_every_entry_reverse(&g_pagecache_lru, page,
+                               struct pagecache_page_s, pg_lru)
+    {
+      if (page->pg_dirty && pagecache_writeback(page) < 0)
+        {
+          continue;
+        }
+
+      pc = page->pg_file;
+      pagecache_freepage(page);
+
+      if (pc->pc_nusers == 0 && list_is_empty(&pc->pc_pages))
+        {
+          pagecache_release(pc);
+        }
+
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: pagecache_getpage
+ *
+ * Description:
+ *   Return the page 'index' of the file, allocating it on a miss.  A new
+ *   page is read from the file system if 'fill' is true, and zeroed
+ *   otherwise.
+ *
+ ****************************************************************************/
+
+static int pagecache_getpage(FAR struct pagecache_file_s *pc, off_t index,
+                             bool fill, FAR struct pagecache_page_s **ppage)
+{
+  FAR struct pagecache_page_s *page;
+  FAR struct pagecache_page_s *tmp;
+  FAR struct list_node *next = &pc->pc_pages;
+  int ret;
+
+  list_for_every_entry(&pc->pc_pages, page, struct pagecache_page_s,
+                       pg_node)
+    {
+      if (page->pg_index == index)
+        {
+          list_delete(&page->pg_lru);
+          list_add_head(&g_pagecache_lru, &page->pg_lru);
+          *ppage = page;
+          return OK;
+        }
+      else if (page->pg_index > index)
+        {
+          next = &page->pg_node;
+          break;
+        }
+    }
+
+  /* A miss.  Allocate a page, giving back the least recently used ones
+   * when the cache is at its limit or the heap is exhausted.
+   */
+
+  for (; ; )
+    {
+      if (g_pagecache_npages < CONFIG_FS_PAGECACHE_NPAGES)
+        {
+          page = fs_heap_malloc(sizeof(*page));
+          if (page != NULL)
+            {
+              break;
+            }
+        }
+
+      if (!pagecache_reclaim())
+        {
+          return -ENOMEM;
+        }
+
+      /* Reclaiming may have freed the page that 'next' refers to */
+
+      next = &pc->pc_pages;
+      list_for_every_entry(&pc->pc_pages, tmp, struct pagecache_page_s,
+                           pg_node)
+        {
+          if (tmp->pg_index > index)
+            {
+              next = &tmp->pg_node;
+              break;
+            }
+        }
+    }
+
+  memset(page->pg_data, 0, PAGECACHE_SIZE);
+  page->pg_file  = pc;
+  page->pg_index = index;
+  page->pg_dirty = false;
+
+  if (fill)
+    {
+      ret = pagecache_fill(pc, page);
+      if (ret < 0)
+        {
+          fs_heap_free(page);
+          return ret;
+        }
+    }
+
+  list_add_before(next, &page->pg_node);
+  list_add_head(&g_pagecache_lru, &page->pg_lru);
+  g_pagecache_npages++;
+
+  *ppage = page;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pagecache_readahead
+ ****************************************************************************/
+
+static void pagecache_readahead(FAR struct pagecache_file_s *pc,
+                                off_t index)
+{
+  FAR struct pagecache_page_s *page;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_PAGECACHE_READAHEAD; i++, index++)
+    {
+      if (PAGECACHE_POS(index) >= pc->pc_size ||
+          pagecache_getpage(pc, index, true, &page) < 0)
+        {
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pagecache_worker
+ *
+ * Description:
+ *   Write back the dirty pages of all files, a while after a write.
+ *
+ ****************************************************************************/
+
+static void pagecache_worker(FAR void *arg)
+{
+  FAR struct pagecache_file_s *pc;
+
+  if (nxmutex_lock(&g_pagecache_lock) < 0)
+    {
+      return;
+    }
+
+  list_for_every_entry(&g_pagecache_files, pc, struct pagecache_file_s,
+                       pc_node)
+    {
+      pagecache_flush(pc);
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+/****************************************************************************
+ * Name: pagecache_prefix
+ *
+ * Description:
+ *   Return true if 'path' is 'prefix' or a path below it.
+ *
+ ****************************************************************************/
+
+static bool pagecache_prefix(FAR const char *path, FAR const char *prefix)
+{
+  size_t len = strlen(prefix);
+
+  while (len > 1 && prefix[len - 1] == '/')
+    {
+      len--;
+    }
+
+  return strncmp(path, prefix, len) == 0 &&
+         (path[len] == '\0' || path[len] == '/');
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pagecache_initialize
+ *
+ * Description:
+ *   Initialize the page cache.
+ *
+ ****************************************************************************/
+
+void pagecache_initialize(void)
+{
+  g_pagecache_table.free_entry = pagecache_free_entry;
+  hcreate_r(CONFIG_FS_PAGECACHE_NFILES, &g_pagecache_table);
+}
+
+/****************************************************************************
+ * Name: pagecache_open
+ *
+ * Description:
+ *   Attach a newly opened file on a mountpoint to the cache of its path.
+ *   The file is simply not cached if that is not possible.
+ *
+ * Input Parameters:
+ *   filep   - The opened file
+ *   path    - The absolute path of the file
+ *   relpath - The path relative to the mountpoint
+ *
+ ****************************************************************************/
+
+void pagecache_open(FAR struct file *filep, FAR const char *path,
+                    FAR const char *relpath)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct pagecache_file_s *pc;
+  struct file file;
+  struct stat buf;
+  int ret;
+
+  filep->f_pcache = NULL;
+
+  if ((filep->f_oflags & O_DIRECT) != 0 ||
+      inode->u.i_mops->read == NULL || inode->u.i_mops->seek == NULL ||
+      inode->u.i_mops->fstat == NULL)
+    {
+      return;
+    }
+
+  if (nxmutex_lock(&g_pagecache_lock) < 0)
+    {
+      return;
+    }
+
+  if (!pagecache_cacheable(inode))
+    {
+      goto out;
+    }
+
+  pc = pagecache_find(path);
+  if (pc == NULL)
+    {
+      pc = pagecache_create(path, inode);
+      if (pc == NULL)
+        {
+          goto out;
+        }
+    }
+
+  if (pc->pc_nusers == 0)
+    {
+      ret = pagecache_openfile(pc, &pc->pc_file, relpath);
+      if (ret >= 0)
+        {
+          ret = inode->u.i_mops->fstat(&pc->pc_file, &buf);
+          if (ret < 0)
+            {
+              pagecache_closefile(pc);
+            }
+        }
+
+      if (ret < 0)
+        {
+          pagecache_drop(pc, 0);
+          pagecache_release(pc);
+          goto out;
+        }
+
+      /* Pages kept from an earlier open are stale if the file was changed
+       * behind the cache.
+       */
+
+      if (buf.st_size != pc->pc_size ||
+          buf.st_mtim.tv_sec != pc->pc_mtime.tv_sec ||
+          buf.st_mtim.tv_nsec != pc->pc_mtime.tv_nsec)
+        {
+          pagecache_drop(pc, 0);
+        }
+
+      pc->pc_size = buf.st_size;
+      pc->pc_next = 0;
+    }
+  else if ((filep->f_oflags & O_TRUNC) != 0)
+    {
+      /* The file system has truncated the file behind the private handle,
+       * which pagecache_sync() has left clean.  Open it again, so that it
+       * sees the new file.
+       */
+
+      pagecache_drop(pc, 0);
+      pc->pc_size = 0;
+
+      if (pagecache_openfile(pc, &file, relpath) >= 0)
+        {
+          pagecache_closefile(pc);
+          memcpy(&pc->pc_file, &file, sizeof(file));
+        }
+      else
+        {
+          ferr("ERROR: Cannot reopen %s\n", path);
+        }
+    }
+
+  pc->pc_nusers++;
+  filep->f_pcache = pc;
+
+out:
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+/****************************************************************************
+ * Name: pagecache_sync
+ *
+ * Description:
+ *   Write back and sync the cache of 'path', before the file system
+ *   changes the file behind the cache, i.e. when it is opened with
+ *   O_TRUNC.
+ *
+ ****************************************************************************/
+
+void pagecache_sync(FAR const char *path)
+{
+  FAR struct pagecache_file_s *pc;
+  FAR const struct mountpt_operations *mops;
+
+  if (nxmutex_lock(&g_pagecache_lock) < 0)
+    {
+      return;
+    }
+
+  pc = pagecache_find(path);
+  if (pc != NULL && pc->pc_nusers > 0)
+    {
+      mops = pc->pc_file.f_inode->u.i_mops;
+      pagecache_flush(pc);
+      if (mops->sync != NULL)
+        {
+          mops->sync(&pc->pc_file);
+        }
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+/****************************************************************************
+ * Name: pagecache_dup
+ *
+ * Description:
+ *   Let 'filep2', a duplicate of 'filep1', use the cache of 'filep1'.
+ *
+ ****************************************************************************/
+
+void pagecache_dup(FAR struct file *filep1, FAR struct file *filep2)
+{
+  FAR struct pagecache_file_s *pc = filep1->f_pcache;
+
+  filep2->f_pcache = pc;
+  if (pc != NULL)
+    {
+      nxmutex_lock(&g_pagecache_lock);
+      pc->pc_nusers++;
+      nxmutex_unlock(&g_pagecache_lock);
+    }
+}
+
+/****************************************************************************
+ * Name: pagecache_close
+ *
+ * Description:
+ *   Detach a file that is being closed from the cache.  When the last user
+ *   of the cache goes away, the dirty pages are written back and the clean
+ *   ones are kept.
+ *
+ ****************************************************************************/
+
+void pagecache_close(FAR struct file *filep)
+{
+  FAR struct pagecache_file_s *pc = filep->f_pcache;
+  FAR const struct mountpt_operations *mops;
+  struct stat buf;
+
+  if (pc == NULL)
+    {
+      return;
+    }
+
+  filep->f_pcache = NULL;
+
+  nxmutex_lock(&g_pagecache_lock);
+  DEBUGASSERT(pc->pc_nusers > 0);
+
+  if (--pc->pc_nusers == 0)
+    {
+      mops = pc->pc_file.f_inode->u.i_mops;
+
+      pagecache_flush(pc);
+      if (mops->sync != NULL)
+        {
+          mops->sync(&pc->pc_file);
+        }
+
+      /* Remember the state of the file, to detect later changes that are
+       * not made through the cache.
+       */
+
+      if (pc->pc_ndirty == 0 && pc->pc_path != NULL &&
+          mops->fstat(&pc->pc_file, &buf) >= 0 && buf.st_size == pc->pc_size)
+        {
+          pc->pc_mtime = buf.st_mtim;
+        }
+      else
+        {
+          pagecache_drop(pc, 0);
+        }
+
+      pagecache_closefile(pc);
+
+      if (list_is_empty(&pc->pc_pages))
+        {
+          pagecache_release(pc);
+        }
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+/****************************************************************************
+ * Name: pagecache_readv
+ *
+ * Description:
+ *   Read from the cache of the file.  Pages that are missing are read from
+ *   the file system;  when the file is read sequentially, the following
+ *   CONFIG_FS_PAGECACHE_READAHEAD pages are read as well.
+ *
+ * Returned Value:
+ *   The number of bytes read, 0 at the end of the file, a negated errno
+ *   value on failure, or -ENOSYS if the file is not cached.
+ *
+ ****************************************************************************/
+
+ssize_t pagecache_readv(FAR struct file *filep,
+                        FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct pagecache_file_s *pc = filep->f_pcache;
+  FAR struct pagecache_page_s *page;
+  FAR uint8_t *buffer;
+  ssize_t ntotal = 0;
+  size_t offset;
+  size_t len;
+  size_t n;
+  off_t index;
+  int ret;
+  int i;
+
+  if (pc == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      buffer = iov[i].iov_base;
+      len    = iov[i].iov_len;
+
+      while (len > 0 && filep->f_pos < pc->pc_size)
+        {
+          index  = filep->f_pos / PAGECACHE_SIZE;
+          offset = filep->f_pos % PAGECACHE_SIZE;
+          n      = MIN(len, PAGECACHE_SIZE - offset);
+          n      = MIN(n, pc->pc_size - filep->f_pos);
+
+          ret = pagecache_getpage(pc, index, true, &page);
+          if (ret < 0)
+            {
+              goto out;
+            }
+
+          memcpy(buffer, page->pg_data + offset, n);
+          buffer       += n;
+          len          -= n;
+          ntotal       += n;
+          filep->f_pos += n;
+
+          /* Keep the next pages cached while the file is read
+           * sequentially.
+           */
+
+          if (index == pc->pc_next)
+            {
+              pagecache_readahead(pc, index + 1);
+            }
+
+          pc->pc_next = index + 1;
+        }
+    }
+
+out:
+  nxmutex_unlock(&g_pagecache_lock);
+  return ntotal > 0 ? ntotal : ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_writev
+ *
+ * Description:
+ *   Write to the cache of the file.  The pages are written back to the
+ *   file system CONFIG_FS_PAGECACHE_FLUSHDELAY milliseconds later, or on
+ *   fsync(), on the last close, or when they are reclaimed.
+ *
+ * Returned Value:
+ *   The number of bytes written, a negated errno value on failure, or
+ *   -ENOSYS if the file is not cached.
+ *
+ ****************************************************************************/
+
+ssize_t pagecache_writev(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt)
+{
+  FAR struct pagecache_file_s *pc = filep->f_pcache;
+  FAR struct pagecache_page_s *page;
+  FAR const uint8_t *buffer;
+  ssize_t ntotal = 0;
+  size_t offset;
+  size_t len;
+  size_t n;
+  off_t index;
+  bool fill;
+  int ret = OK;
+  int i;
+
+  if (pc == NULL || (pc->pc_file.f_oflags & O_WROK) == 0 ||
+      pc->pc_file.f_inode->u.i_mops->write == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if ((filep->f_oflags & O_APPEND) != 0)
+    {
+      filep->f_pos = pc->pc_size;
+    }
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      buffer = iov[i].iov_base;
+      len    = iov[i].iov_len;
+
+      while (len > 0)
+        {
+          index  = filep->f_pos / PAGECACHE_SIZE;
+          offset = filep->f_pos % PAGECACHE_SIZE;
+          n      = MIN(len, PAGECACHE_SIZE - offset);
+
+          /* A new page must be read first, unless the write replaces all
+           * of the file data in it.
+           */
+
+          fill = PAGECACHE_POS(index) < pc->pc_size &&
+                 (offset > 0 || (n < PAGECACHE_SIZE &&
+                                 filep->f_pos + n < pc->pc_size));
+
+          ret = pagecache_getpage(pc, index, fill, &page);
+          if (ret < 0)
+            {
+              goto out;
+            }
+
+          memcpy(page->pg_data + offset, buffer, n);
+          if (!page->pg_dirty)
+            {
+              page->pg_dirty = true;
+              pc->pc_ndirty++;
+            }
+
+          buffer       += n;
+          len          -= n;
+          ntotal       += n;
+          filep->f_pos += n;
+
+          if (filep->f_pos > pc->pc_size)
+            {
+              pc->pc_size = filep->f_pos;
+            }
+        }
+    }
+
+out:
+  if (ntotal > 0 && work_available(&g_pagecache_work))
+    {
+      work_queue(LPWORK, &g_pagecache_work, pagecache_worker, NULL,
+                 MSEC2TICK(CONFIG_FS_PAGECACHE_FLUSHDELAY));
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+  return ntotal > 0 ? ntotal : ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_seek
+ *
+ * Description:
+ *   Set the position of a cached file.  The file system is not involved,
+ *   it does not know the size of the file until the pages are written
+ *   back.
+ *
+ * Returned Value:
+ *   The new position, a negated errno value on failure, or -ENOSYS if the
+ *   file is not cached.
+ *
+ ****************************************************************************/
+
+off_t pagecache_seek(FAR struct file *filep, off_t offset, int whence)
+{
+  FAR struct pagecache_file_s *pc = filep->f_pcache;
+  int ret;
+
+  if (pc == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (whence)
+    {
+      case SEEK_SET:
+        break;
+
+      case SEEK_CUR:
+        offset += filep->f_pos;
+        break;
+
+      case SEEK_END:
+        offset += pc->pc_size;
+        break;
+
+      default:
+        offset = -1;
+        break;
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+
+  if (offset < 0)
+    {
+      return -EINVAL;
+    }
+
+  filep->f_pos = offset;
+  return offset;
+}
+
+/****************************************************************************
+ * Name: pagecache_truncate
+ *
+ * Description:
+ *   Truncate a cached file.  The dirty pages are written back first and
+ *   the file system truncates the file through the private handle, the
+ *   one that knows the real size of the file.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure, or -ENOSYS if the
+ *   file is not cached.
+ *
+ ****************************************************************************/
+
+int pagecache_truncate(FAR struct file *filep, off_t length)
+{
+  FAR struct pagecache_file_s *pc = filep->f_pcache;
+  FAR struct pagecache_page_s *page;
+  FAR const struct mountpt_operations *mops;
+  size_t offset;
+  int ret;
+
+  if (pc == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  mops = pc->pc_file.f_inode->u.i_mops;
+  if ((pc->pc_file.f_oflags & O_WROK) == 0 || mops->truncate == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = pagecache_flush(pc);
+  if (ret >= 0)
+    {
+      ret = mops->truncate(&pc->pc_file, length);
+    }
+
+  if (ret >= 0)
+    {
+      /* Drop the pages past the end and clear the tail of the last one,
+       * it must read as zeroes if the file grows again.
+       */
+
+      offset = length % PAGECACHE_SIZE;
+      pagecache_drop(pc, (length + PAGECACHE_SIZE - 1) / PAGECACHE_SIZE);
+
+      if (offset > 0 && length < pc->pc_size)
+        {
+          list_for_every_entry(&pc->pc_pages, page,
+                               struct pagecache_page_s, pg_node)
+            {
+              if (page->pg_index == length / PAGECACHE_SIZE)
+                {
+                  memset(page->pg_data + offset, 0,
+                         PAGECACHE_SIZE - offset);
+                  break;
+                }
+            }
+        }
+
+      pc->pc_size = length;
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_fsync
+ *
+ * Description:
+ *   Write back the dirty pages of a cached file and sync it.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure, or -ENOSYS if the
+ *   file is not cached.
+ *
+ ****************************************************************************/
+
+int pagecache_fsync(FAR struct file *filep)
+{
+  FAR struct pagecache_file_s *pc = filep->f_pcache;
+  FAR const struct mountpt_operations *mops;
+  int ret;
+
+  if (pc == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  ret = nxmutex_lock(&g_pagecache_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  mops = pc->pc_file.f_inode->u.i_mops;
+  ret  = pagecache_flush(pc);
+  if (ret >= 0 && mops->sync != NULL)
+    {
+      ret = mops->sync(&pc->pc_file);
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pagecache_stat
+ *
+ * Description:
+ *   Correct the size reported by fstat() or stat() for the data that is
+ *   not written back yet.  Either 'filep' or 'path' identifies the file.
+ *
+ ****************************************************************************/
+
+void pagecache_stat(FAR struct file *filep, FAR const char *path,
+                    FAR struct stat *buf)
+{
+  FAR struct pagecache_file_s *pc;
+
+  if (nxmutex_lock(&g_pagecache_lock) < 0)
+    {
+      return;
+    }
+
+  pc = filep != NULL ? filep->f_pcache : pagecache_find(path);
+  if (pc != NULL && pc->pc_nusers > 0)
+    {
+      buf->st_size = pc->pc_size;
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+/****************************************************************************
+ * Name: pagecache_invalidate
+ *
+ * Description:
+ *   Forget the cache of 'path' and of all the paths below it, which have
+ *   been unlinked or renamed.  Files that are still open keep using their
+ *   cache (under the old name) until they are closed.
+ *
+ ****************************************************************************/
+
+void pagecache_invalidate(FAR const char *path)
+{
+  FAR struct pagecache_file_s *pc;
+  FAR struct pagecache_file_s *tmp;
+
+  nxmutex_lock(&g_pagecache_lock);
+
+  list_for_every_entry_safe(&g_pagecache_files, pc, tmp,
+                            struct pagecache_file_s, pc_node)
+    {
+      if (pc->pc_path != NULL && pagecache_prefix(pc->pc_path, path))
+        {
+          pagecache_unhash(pc);
+          if (pc->pc_nusers == 0)
+            {
+              pagecache_drop(pc, 0);
+              pagecache_release(pc);
+            }
+        }
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+/****************************************************************************
+ * Name: pagecache_umount
+ *
+ * Description:
+ *   Discard the pages of the files on a mountpoint that is unmounted.
+ *
+ ****************************************************************************/
+
+void pagecache_umount(FAR struct inode *mountpt)
+{
+  FAR struct pagecache_file_s *pc;
+  FAR struct pagecache_file_s *tmp;
+  int i;
+
+  nxmutex_lock(&g_pagecache_lock);
+
+  list_for_every_entry_safe(&g_pagecache_files, pc, tmp,
+                            struct pagecache_file_s, pc_node)
+    {
+      if (pc->pc_mountpt == mountpt && pc->pc_nusers == 0)
+        {
+          pagecache_drop(pc, 0);
+          pagecache_release(pc);
+        }
+    }
+
+  for (i = 0; i < PAGECACHE_NMOUNTS; i++)
+    {
+      if (g_pagecache_mounts[i].pm_inode == mountpt)
+        {
+          g_pagecache_mounts[i].pm_inode = NULL;
+        }
+    }
+
+  nxmutex_unlock(&g_pagecache_lock);
+}
+
+#endif /* CONFIG_FS_PAGECACHE */
@@ -37,6 +37,7 @@
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
+#include <nuttx/sched.h>
 #include <nuttx/tls.h>
 
 #include <arch/irq.h>
@@ -54,6 +55,28 @@ struct pollfd_s
   nfds_t nfds;
 };
 
+#ifdef CONFIG_FS_POLL_CACHE
+/* One descriptor of the poll set that a thread polled last.  The poll
+ * callback stays installed between the calls of poll(), a non-zero revents
+ * tells that the driver reported something since it was last setup.
+ */
+
+struct pollcache_fd_s
+{
+  struct pollfd    pfd;       /* Registered with the driver */
+  FAR struct file *filep;     /* NULL if pfd.fd is negative */
+};
+
+struct pollcache_s
+{
+  sem_t  sem;                 /* Posted by the poll callbacks */
+  bool   busy;                /* In use by a poll() of the thread */
+  nfds_t nfds;                /* Number of cached descriptors */
+  nfds_t size;                /* Number of allocated descriptors */
+  struct pollcache_fd_s fds[1];
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -215,6 +238,376 @@ static void poll_cleanup(FAR void *arg)
   poll_teardown(fdsinfo->fds, fdsinfo->nfds, &count);
 }
 
+#ifdef CONFIG_FS_POLL_CACHE
+
+/****************************************************************************
+ * Name: poll_cache_teardown
+ *
+ * Description:
+ *   Teardown the poll operation of each cached descriptor and drop the
+ *   references to the files.
+ *
+ ****************************************************************************/
+
+static void poll_cache_teardown(FAR struct pollcache_s *cache)
+{
+  FAR struct pollcache_fd_s *cfd;
+  nfds_t i;
+
+  for (i = 0; i < cache->nfds; i++)
+    {
+      cfd = &cache->fds[i];
+      if (cfd->filep != NULL)
+        {
+          file_poll(cfd->filep, &cfd->pfd, false);
+          file_put(cfd->filep);
+          cfd->filep = NULL;
+        }
+    }
+
+  cache->nfds = 0;
+}
+
+/****************************************************************************
+ * Name: poll_cache_match
+ *
+ * Description:
+ *   Check whether the poll set is the cached one, that is the same events
+ *   of the same open files in the same order.
+ *
+ ****************************************************************************/
+
+static bool poll_cache_match(FAR struct pollcache_s *cache,
+                             FAR const struct pollfd *fds, nfds_t nfds)
+{
+  FAR struct pollcache_fd_s *cfd;
+  FAR struct file *filep;
+  nfds_t i;
+
+  if (cache->nfds != nfds)
+    {
+      return false;
+    }
+
+  for (i = 0; i < nfds; i++)
+    {
+      cfd = &cache->fds[i];
+      if (cfd->pfd.fd != fds[i].fd || cfd->pfd.events != fds[i].events)
+        {
+          return false;
+        }
+
+      /* The descriptor may have been closed and reused meanwhile */
+
+      if (fds[i].fd >= 0)
+        {
+          if (file_get(fds[i].fd, &filep) < 0)
+            {
+              return false;
+            }
+
+          file_put(filep);
+          if (filep != cfd->filep)
+            {
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: poll_cache_setup
+ *
+ * Description:
+ *   Setup the poll operation of one cached descriptor.
+ *
+ ****************************************************************************/
+
+static int poll_cache_setup(FAR struct pollcache_s *cache,
+                            FAR struct pollcache_fd_s *cfd)
+{
+  cfd->pfd.arg     = &cache->sem;
+  cfd->pfd.cb      = poll_default_cb;
+  cfd->pfd.revents = 0;
+  cfd->pfd.priv    = NULL;
+
+  return file_poll(cfd->filep, &cfd->pfd, true);
+}
+
+/****************************************************************************
+ * Name: poll_cache_fill
+ *
+ * Description:
+ *   Replace the cached poll set of the thread by a new one and setup the
+ *   poll operation of each descriptor.
+ *
+ * Returned Value:
+ *   The cache, or NULL if the set could not be setup.  The thread has no
+ *   cache any more in that case.
+ *
+ ****************************************************************************/
+
+static FAR struct pollcache_s *poll_cache_fill(FAR struct tcb_s *tcb,
+                                              FAR const struct pollfd *fds,
+                                              nfds_t nfds)
+{
+  FAR struct pollcache_s *cache = tcb->pollcache;
+  FAR struct pollcache_fd_s *cfd;
+  nfds_t i;
+  int ret;
+
+  if (cache != NULL)
+    {
+      poll_cache_teardown(cache);
+      if (cache->size < nfds)
+        {
+          poll_cache_release(tcb);
+          cache = NULL;
+        }
+    }
+
+  if (cache == NULL)
+    {
+      cache = fs_heap_malloc(sizeof(struct pollcache_s) +
+                             (nfds - 1) * sizeof(struct pollcache_fd_s));
+      if (cache == NULL)
+        {
+          return NULL;
+        }
+
+      nxsem_init(&cache->sem, 0, 0);
+      cache->busy  = false;
+      cache->nfds  = 0;
+      cache->size  = nfds;
+      tcb->pollcache = cache;
+    }
+
+  for (i = 0; i < nfds; i++)
+    {
+      cfd = &cache->fds[i];
+      cfd->pfd.fd      = fds[i].fd;
+      cfd->pfd.events  = fds[i].events;
+      cfd->pfd.revents = 0;
+      cfd->filep       = NULL;
+      cache->nfds      = i + 1;
+
+      if (fds[i].fd < 0)
+        {
+          continue;
+        }
+
+      ret = file_get(fds[i].fd, &cfd->filep);
+      if (ret >= 0)
+        {
+          ret = poll_cache_setup(cache, cfd);
+          if (ret < 0)
+            {
+              file_put(cfd->filep);
+              cfd->filep = NULL;
+            }
+        }
+
+      if (ret < 0)
+        {
+          poll_cache_release(tcb);
+          return NULL;
+        }
+    }
+
+  return cache;
+}
+
+/****************************************************************************
+ * Name: poll_cache_rearm
+ *
+ * Description:
+ *   Setup again the descriptors that were notified since they were setup,
+ *   so that their revents tell the current state.  The other descriptors
+ *   were not ready and their drivers did not report anything since, they
+ *   are left alone.
+ *
+ ****************************************************************************/
+
+static int poll_cache_rearm(FAR struct pollcache_s *cache)
+{
+  FAR struct pollcache_fd_s *cfd;
+  nfds_t i;
+  int ret;
+
+  for (i = 0; i < cache->nfds; i++)
+    {
+      cfd = &cache->fds[i];
+      if (cfd->filep != NULL && cfd->pfd.revents != 0)
+        {
+          file_poll(cfd->filep, &cfd->pfd, false);
+          ret = poll_cache_setup(cache, cfd);
+          if (ret < 0)
+            {
+              file_put(cfd->filep);
+              cfd->filep = NULL;
+              return ret;
+            }
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: poll_cache_count
+ *
+ * Description:
+ *   Return the count of the cached descriptors with non-zero poll events.
+ *
+ ****************************************************************************/
+
+static int poll_cache_count(FAR struct pollcache_s *cache)
+{
+  int count = 0;
+  nfds_t i;
+
+  for (i = 0; i < cache->nfds; i++)
+    {
+      if (cache->fds[i].pfd.revents != 0)
+        {
+          count++;
+        }
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: poll_cache
+ *
+ * Description:
+ *   Poll with the cached poll set of the thread.  The poll callbacks of
+ *   the set stay installed when poll() returns, so a thread that polls the
+ *   same set again and again only sets up the descriptors that were
+ *   reported, instead of all of them on each call.
+ *
+ * Input Parameters:
+ *   fds     - List of structures describing file descriptors to be
+ *             monitored
+ *   nfds    - The number of entries in the list
+ *   timeout - The timeout of poll() in milliseconds
+ *   result  - The location to return the result of poll(), the number of
+ *             ready descriptors or a negated errno value.
+ *
+ * Returned Value:
+ *   True if the poll was done, false if poll() has to set up the fds
+ *   itself.
+ *
+ ****************************************************************************/
+
+static bool poll_cache(FAR struct pollfd *fds, nfds_t nfds, int timeout,
+                       FAR int *result)
+{
+  FAR struct tcb_s *tcb = nxsched_self();
+  FAR struct pollcache_s *cache = tcb->pollcache;
+  clock_t deadline = 0;
+  clock_t now;
+  int count;
+  int ret = OK;
+  nfds_t i;
+
+  /* A small set costs little to setup each time.  A signal handler may
+   * poll while the thread is waiting in poll(), it can not use the cache.
+   */
+
+  if (nfds < CONFIG_FS_POLL_CACHE_MINFDS ||
+      (cache != NULL && cache->busy))
+    {
+      return false;
+    }
+
+  /* Forget the wake-ups of notifications that were already seen, any
+   * later one shows in the revents checked below.
+   */
+
+  if (cache != NULL)
+    {
+      while (nxsem_trywait(&cache->sem) >= 0);
+    }
+
+  if (cache != NULL && poll_cache_match(cache, fds, nfds))
+    {
+      if (poll_cache_rearm(cache) < 0)
+        {
+          poll_cache_release(tcb);
+          return false;
+        }
+    }
+  else
+    {
+      cache = poll_cache_fill(tcb, fds, nfds);
+      if (cache == NULL)
+        {
+          return false;
+        }
+    }
+
+  cache->busy = true;
+
+  if (timeout > 0)
+    {
+      deadline = clock_systime_ticks() + MSEC2TICK((clock_t)timeout);
+    }
+
+  for (; ; )
+    {
+      count = poll_cache_count(cache);
+      if (count > 0 || timeout == 0)
+        {
+          break;
+        }
+
+      if (timeout > 0)
+        {
+          now = clock_systime_ticks();
+          if (clock_compare(deadline, now))
+            {
+              break;
+            }
+
+          ret = nxsem_tickwait(&cache->sem, deadline - now);
+        }
+      else
+        {
+          ret = nxsem_wait(&cache->sem);
+        }
+
+      if (ret < 0)
+        {
+          /* Return zero (OK) in the event of a timeout */
+
+          if (ret == -ETIMEDOUT)
+            {
+              count = poll_cache_count(cache);
+              ret = OK;
+            }
+
+          break;
+        }
+    }
+
+  cache->busy = false;
+
+  if (ret == OK)
+    {
+      for (i = 0; i < nfds; i++)
+        {
+          fds[i].revents = cache->fds[i].pfd.revents;
+        }
+    }
+
+  *result = ret < 0 ? ret : count;
+  return true;
+}
+#endif /* CONFIG_FS_POLL_CACHE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -383,6 +776,74 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
   return ret;
 }
 
+#ifdef CONFIG_FS_POLL_CACHE
+
+/****************************************************************************
+ * Name: poll_cache_release
+ *
+ * Description:
+ *   Teardown and free the cached poll set of a thread.  This is called when
+ *   the thread exits.
+ *
+ * Input Parameters:
+ *   tcb - The thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_cache_release(FAR struct tcb_s *tcb)
+{
+  FAR struct pollcache_s *cache = tcb->pollcache;
+
+  if (cache != NULL)
+    {
+      tcb->pollcache = NULL;
+      poll_cache_teardown(cache);
+      nxsem_destroy(&cache->sem);
+      fs_heap_free(cache);
+    }
+}
+
+/****************************************************************************
+ * Name: poll_cache_close
+ *
+ * Description:
+ *   Drop the cached poll set of the calling thread if it contains fd.  The
+ *   cache holds a reference to the file, without this a file closed by the
+ *   thread that polled it would stay open until the next poll().
+ *
+ * Input Parameters:
+ *   fd - The file descriptor being closed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_cache_close(int fd)
+{
+  FAR struct tcb_s *tcb = nxsched_self();
+  FAR struct pollcache_s *cache = tcb->pollcache;
+  nfds_t i;
+
+  if (cache == NULL || cache->busy || fd < 0)
+    {
+      return;
+    }
+
+  for (i = 0; i < cache->nfds; i++)
+    {
+      if (cache->fds[i].pfd.fd == fd)
+        {
+          poll_cache_release(tcb);
+          break;
+        }
+    }
+}
+#endif /* CONFIG_FS_POLL_CACHE */
+
 /****************************************************************************
  * Name: poll
  *
@@ -427,6 +888,19 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
 
   enter_cancellation_point();
 
+#ifdef CONFIG_FS_POLL_CACHE
+  if (poll_cache(fds, nfds, timeout, &ret))
+    {
+      if (ret >= 0)
+        {
+          count = ret;
+          ret = OK;
+        }
+
+      goto out_with_cancelpt;
+    }
+#endif
+
 #ifdef CONFIG_BUILD_KERNEL
   /* Allocate kernel memory for the fds */
 
@@ -538,7 +1012,9 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
   /* Free the temporary buffer */
 
   fs_heap_free(kfds);
+#endif
 
+#if defined(CONFIG_BUILD_KERNEL) || defined(CONFIG_FS_POLL_CACHE)
 out_with_cancelpt:
 #endif
 
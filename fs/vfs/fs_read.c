@@ -34,6 +34,8 @@
 #include <errno.h>
 
 #include <nuttx/cancelpt.h>
+#include <nuttx/sched.h>
+#include <nuttx/tracepoint.h>
 
 #include "inode/inode.h"
 #include "vfs.h"
@@ -206,6 +208,18 @@ ssize_t file_readv(FAR struct file *filep,
 
   else if (inode != NULL && inode->u.i_ops)
     {
+#ifdef CONFIG_SCHED_PRESSURE
+      bool marked = INODE_IS_STORAGE(inode) && nxsched_pressure_io_begin();
+#endif
+
+#ifdef CONFIG_FS_PAGECACHE
+      ret = pagecache_readv(filep, iov, iovcnt);
+      if (ret != -ENOSYS)
+        {
+          /* The read was served by the page cache */
+        }
+      else
+#endif
       if (inode->u.i_ops->readv)
         {
           struct uio uio;
@@ -220,6 +234,10 @@ ssize_t file_readv(FAR struct file *filep,
         {
           ret = file_readv_compat(filep, iov, iovcnt);
         }
+
+#ifdef CONFIG_SCHED_PRESSURE
+      nxsched_pressure_io_end(marked);
+#endif
     }
 
   /* Return the number of bytes read (or possibly an error code) */
@@ -231,6 +249,14 @@ ssize_t file_readv(FAR struct file *filep,
     }
 #endif
 
+#ifdef CONFIG_SCHED_RUSAGE
+  if (ret > 0)
+    {
+      nxsched_self()->rchar += ret;
+    }
+#endif
+
+  tracepoint(FS_READ, NOTE_TAG_FS, "read %p %zd", filep, ret);
   return ret;
 }
 
@@ -402,6 +402,9 @@ static int mountptrename(FAR const char *oldpath, FAR struct inode *oldinode,
                    */
 
                    oldinode->u.i_mops->unlink(oldinode, newrelpath);
+#ifdef CONFIG_FS_DCACHE
+                   dcache_invalidate(oldinode, newrelpath);
+#endif
 #ifdef CONFIG_FS_NOTIFY
                    notify_unlink(newrelpath);
 #endif
@@ -428,6 +431,22 @@ static int mountptrename(FAR const char *oldpath, FAR struct inode *oldinode,
 
   ret = oldinode->u.i_mops->rename(oldinode, oldrelpath, newrelpath);
 
+#ifdef CONFIG_FS_DCACHE
+  if (ret >= 0)
+    {
+      dcache_invalidate(oldinode, oldrelpath);
+      dcache_invalidate(oldinode, newrelpath);
+    }
+#endif
+
+#ifdef CONFIG_FS_PAGECACHE
+  if (ret >= 0)
+    {
+      pagecache_invalidate(oldpath);
+      pagecache_invalidate(newpath);
+    }
+#endif
+
 #ifdef CONFIG_FS_NOTIFY
   if (ret >= 0)
     {
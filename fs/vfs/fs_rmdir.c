@@ -103,6 +103,10 @@ int rmdir(FAR const char *pathname)
               errcode = -ret;
               goto errout_with_inode;
             }
+
+#ifdef CONFIG_FS_DCACHE
+          dcache_invalidate(inode, desc.relpath);
+#endif
         }
       else
         {
@@ -35,6 +35,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/signal.h>
+#include <nuttx/waitqueue.h>
 
 #include <sys/signalfd.h>
 
@@ -56,7 +57,7 @@ struct signalfd_priv_s
   sigset_t      sigmask; /* The set of signals caller wishes */
   mutex_t       mutex;   /* Enforces device exclusive access */
   uint8_t       crefs;   /* References counts on signalfd (max: 255) */
-  FAR struct pollfd *fds[CONFIG_SIGNAL_FD_NPOLLWAITERS];
+  waitq_t       pollwq;  /* Poll waiters */
 };
 
 /****************************************************************************
@@ -110,7 +111,7 @@ static void signalfd_action(int signo, FAR siginfo_t *info,
 
   if (sigismember(&dev->sigmask, signo) > 0)
     {
-      poll_notify(dev->fds, CONFIG_SIGNAL_FD_NPOLLWAITERS, POLLIN);
+      nxwaitq_notify(&dev->pollwq, POLLIN);
     }
 }
 
@@ -227,44 +228,12 @@ static int signalfd_file_poll(FAR struct file *filep,
 {
   FAR struct signalfd_priv_s *dev = filep->f_priv;
   sigset_t mask;
-  int ret = 0;
-  int i;
+  int ret;
 
   nxmutex_lock(&dev->mutex);
-  if (!setup)
-    {
-      /* This is a request to tear down the poll. */
-
-      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
-
-      /* Remove all memory of the poll setup */
-
-      *slot     = NULL;
-      fds->priv = NULL;
-      goto out;
-    }
-
-  /* This is a request to set up the poll. Find an available
-   * slot for the poll structure reference
-   */
-
-  for (i = 0; i < CONFIG_SIGNAL_FD_NPOLLWAITERS; i++)
-    {
-      /* Find an available slot */
-
-      if (!dev->fds[i])
-        {
-          /* Bind the poll structure and this slot */
-
-          dev->fds[i] = fds;
-          fds->priv   = &dev->fds[i];
-          break;
-        }
-    }
-
-  if (i >= CONFIG_SIGNAL_FD_NPOLLWAITERS)
+  ret = nxwaitq_poll(&dev->pollwq, fds, setup);
+  if (!setup || ret < 0)
     {
-      ret = -EBUSY;
       goto out;
     }
 
@@ -351,6 +320,7 @@ int signalfd(int fd, FAR const sigset_t *mask, int flags)
         }
 
       nxmutex_init(&dev->mutex);
+      nxwaitq_init(&dev->pollwq);
 
       fd = file_allocate_from_inode(&g_signalfd_inode, O_RDOK | flags,
                                     0, dev, 0);
@@ -0,0 +1,227 @@
+/****************************************************************************
+ * fs/vfs/fs_splice.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: file_splice
+ *
+ * Description:
+ *   Equivalent to the standard splice() function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *off_in,
+                    FAR struct file *outfile, FAR off_t *off_out,
+                    size_t len, unsigned int flags)
+{
+#ifdef CONFIG_PIPES
+  bool inpipe  = file_ispipe(infile);
+  bool outpipe = file_ispipe(outfile);
+
+  /* One end must be a pipe, and a pipe cannot be spliced to itself */
+
+  if ((!inpipe && !outpipe) || infile->f_inode == outfile->f_inode)
+    {
+      return -EINVAL;
+    }
+
+  if ((inpipe && off_in != NULL) || (outpipe && off_out != NULL))
+    {
+      return -ESPIPE;
+    }
+
+  if (inpipe)
+    {
+      return pipe_splice_from(infile, outfile, off_out, len, flags, false);
+    }
+
+  return pipe_splice_to(outfile, infile, off_in, len, flags);
+#else
+  return -EINVAL;
+#endif
+}
+
+/****************************************************************************
+ * Name: file_tee
+ *
+ * Description:
+ *   Equivalent to the standard tee() function except that is accepts
+ *   struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags)
+{
+#ifdef CONFIG_PIPES
+  if (!file_ispipe(infile) || !file_ispipe(outfile) ||
+      infile->f_inode == outfile->f_inode)
+    {
+      return -EINVAL;
+    }
+
+  return pipe_splice_from(infile, outfile, NULL, len, flags, true);
+#else
+  return -EINVAL;
+#endif
+}
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves data between two file descriptors, one of which must
+ *   refer to a pipe.  The data is transferred directly between the pipe
+ *   buffer and the other file, without the intermediate user buffer that
+ *   read() plus write() would need.
+ *
+ *   NOTE: This is a Linux interface.  SPLICE_F_MOVE and SPLICE_F_MORE are
+ *   accepted but ignored; the data is copied once, there are no pages to
+ *   move.
+ *
+ * Input Parameters:
+ *   fd_in   - The descriptor to read from
+ *   off_in  - If 'fd_in' is not a pipe and 'off_in' is not NULL, the
+ *             offset to read at.  It is updated and the file position is
+ *             left unchanged.  Must be NULL if 'fd_in' is a pipe.
+ *   fd_out  - The descriptor to write to
+ *   off_out - Likewise for 'fd_out'
+ *   len     - The maximum number of bytes to transfer
+ *   flags   - SPLICE_F_* flags
+ *
+ * Returned Value:
+ *   The number of bytes transferred, zero at end of input.  On failure, -1
+ *   (ERROR) is returned and errno is set appropriately:
+ *
+ *   EAGAIN  SPLICE_F_NONBLOCK was given or the pipe is non-blocking, and
+ *           the operation would block.
+ *   EBADF   A descriptor is not valid.
+ *   EINVAL  Neither descriptor refers to a pipe, or both refer to the same
+ *           pipe.
+ *   ESPIPE  An offset was given for a pipe.
+ *   EPIPE   The pipe has no readers.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = file_get(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_get(fd_out, &outfile);
+  if (ret < 0)
+    {
+      file_put(infile);
+      goto errout;
+    }
+
+  ret = file_splice(infile, off_in, outfile, off_out, len, flags);
+  file_put(outfile);
+  file_put(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: tee
+ *
+ * Description:
+ *   tee() copies up to 'len' bytes from the pipe 'fd_in' to the pipe
+ *   'fd_out' without consuming them, so they can still be read or spliced
+ *   from 'fd_in'.
+ *
+ * Input Parameters:
+ *   fd_in  - The pipe to copy from
+ *   fd_out - The pipe to copy to
+ *   len    - The maximum number of bytes to copy
+ *   flags  - SPLICE_F_* flags
+ *
+ * Returned Value:
+ *   The number of bytes copied, zero if 'fd_in' is at end of file.  On
+ *   failure, -1 (ERROR) is returned and errno is set as for splice().
+ *
+ ****************************************************************************/
+
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags)
+{
+  FAR struct file *infile;
+  FAR struct file *outfile;
+  ssize_t ret;
+
+  ret = file_get(fd_in, &infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = file_get(fd_out, &outfile);
+  if (ret < 0)
+    {
+      file_put(infile);
+      goto errout;
+    }
+
+  ret = file_tee(infile, outfile, len, flags);
+  file_put(outfile);
+  file_put(infile);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
@@ -34,6 +34,7 @@
 #include <errno.h>
 
 #include "inode/inode.h"
+#include "vfs.h"
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/ioctl.h>
 
@@ -118,9 +119,31 @@ static int stat_recursive(FAR const char *path,
 
       if (inode->u.i_mops && inode->u.i_mops->stat)
         {
-          /* Perform the stat() operation */
+#ifdef CONFIG_FS_DCACHE
+          unsigned int gen;
 
-          ret = inode->u.i_mops->stat(inode, desc.relpath, buf);
+          ret = dcache_lookup(inode, desc.relpath, buf, &gen);
+          if (ret == -ENOSYS)
+#endif
+            {
+              /* Perform the stat() operation */
+
+              ret = inode->u.i_mops->stat(inode, desc.relpath, buf);
+#ifdef CONFIG_FS_DCACHE
+              if (ret >= 0 || ret == -ENOENT)
+                {
+                  dcache_enter(inode, desc.relpath, ret >= 0 ? buf : NULL,
+                               gen);
+                }
+#endif
+            }
+
+#ifdef CONFIG_FS_PAGECACHE
+          if (ret >= 0)
+            {
+              pagecache_stat(NULL, path, buf);
+            }
+#endif
         }
       else
         {
@@ -34,8 +34,11 @@
 #include <debug.h>
 
 #include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/mutex.h>
+#include <nuttx/waitqueue.h>
 
 #include <sys/ioctl.h>
 #include <sys/timerfd.h>
@@ -52,32 +55,23 @@
  * Private Types
  ****************************************************************************/
 
-typedef struct timerfd_waiter_sem_s
-{
-  sem_t sem;
-  FAR struct timerfd_waiter_sem_s *next;
-} timerfd_waiter_sem_t;
-
 /* This structure describes the internal state of the driver */
 
 struct timerfd_priv_s
 {
   mutex_t                   lock;    /* Enforces device exclusive access */
-  FAR timerfd_waiter_sem_t *rdsems;  /* List of blocking readers */
+  waitq_t                   rdwq;    /* Blocking readers and poll waiters */
   int                       clock;   /* Clock to use as the timing base */
+#ifdef CONFIG_HRTIMER
+  uint64_t                  period;  /* If non-zero, the period in ns */
+  hrtimer_t                 hrtimer; /* The hrtimer that provides the timing */
+#else
   int                       delay;   /* If non-zero, used to reset repetitive
                                       * timers */
   struct wdog_s             wdog;    /* The watchdog that provides the timing */
+#endif
   timerfd_t                 counter; /* timerfd counter */
   uint8_t                   crefs;   /* References counts on timerfd (max: 255) */
-
-  /* The following is a list if poll structures of threads waiting for
-   * driver events.
-   */
-
-#ifdef CONFIG_TIMER_FD_POLL
-  FAR struct pollfd *fds[CONFIG_TIMER_FD_NPOLLWAITERS];
-#endif
 };
 
 /****************************************************************************
@@ -94,14 +88,16 @@ static int timerfd_poll(FAR struct file *filep, FAR struct pollfd *fds,
                         bool setup);
 #endif
 
-static int timerfd_blocking_io(FAR struct timerfd_priv_s *dev,
-                               FAR timerfd_waiter_sem_t  *sem,
-                               FAR timerfd_waiter_sem_t **slist);
-
 static FAR struct timerfd_priv_s *timerfd_allocdev(void);
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev);
 
+static void timerfd_expired(FAR struct timerfd_priv_s *dev);
+#ifdef CONFIG_HRTIMER
+static uint64_t timerfd_hrtimeout(FAR const hrtimer_t *hrtimer,
+                                  uint64_t expired);
+#else
 static void timerfd_timeout(wdparm_t arg);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -149,8 +145,12 @@ static FAR struct timerfd_priv_s *timerfd_allocdev(void)
       /* Initialize the private structure */
 
       nxmutex_init(&dev->lock);
+      nxwaitq_init(&dev->rdwq);
       nxmutex_lock(&dev->lock);
       dev->crefs++;
+#ifdef CONFIG_HRTIMER
+      hrtimer_init(&dev->hrtimer, timerfd_hrtimeout);
+#endif
     }
 
   return dev;
@@ -158,7 +158,11 @@ static FAR struct timerfd_priv_s *timerfd_allocdev(void)
 
 static void timerfd_destroy(FAR struct timerfd_priv_s *dev)
 {
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel_sync(&dev->hrtimer);
+#else
   wd_cancel(&dev->wdog);
+#endif
   nxmutex_unlock(&dev->lock);
   nxmutex_destroy(&dev->lock);
   fs_heap_free(dev);
@@ -229,45 +233,6 @@ static int timerfd_close(FAR struct file *filep)
   return OK;
 }
 
-static int timerfd_blocking_io(FAR struct timerfd_priv_s *dev,
-                               FAR  timerfd_waiter_sem_t *sem,
-                               FAR timerfd_waiter_sem_t **slist)
-{
-  int ret;
-
-  sem->next = *slist;
-  *slist = sem;
-
-  /* Wait for timerfd to notify */
-
-  ret = nxsem_wait(&sem->sem);
-  if (ret < 0)
-    {
-      FAR timerfd_waiter_sem_t *cur_sem;
-
-      cur_sem = *slist;
-      if (cur_sem == sem)
-        {
-          *slist = sem->next;
-        }
-      else
-        {
-          while (cur_sem)
-            {
-              if (cur_sem->next == sem)
-                {
-                  cur_sem->next = sem->next;
-                  break;
-                }
-
-              cur_sem = cur_sem->next;
-            }
-        }
-    }
-
-  return ret;
-}
-
 static ssize_t timerfd_read(FAR struct file *filep, FAR char *buffer,
                             size_t len)
 {
@@ -291,28 +256,24 @@ static ssize_t timerfd_read(FAR struct file *filep, FAR char *buffer,
 
   if (dev->counter == 0)
     {
-      timerfd_waiter_sem_t sem;
-
       if (filep->f_oflags & O_NONBLOCK)
         {
           leave_critical_section(intflags);
           return -EAGAIN;
         }
 
-      nxsem_init(&sem.sem, 0, 0);
+      /* A reader takes all of the expirations, one is woken for them */
+
       do
         {
-          ret = timerfd_blocking_io(dev, &sem, &dev->rdsems);
+          ret = nxwaitq_wait(&dev->rdwq, NULL, true);
           if (ret < 0)
             {
               leave_critical_section(intflags);
-              nxsem_destroy(&sem.sem);
               return ret;
             }
         }
       while (dev->counter == 0);
-
-      nxsem_destroy(&sem.sem);
     }
 
   *(FAR timerfd_t *)buffer = dev->counter;
@@ -329,67 +290,81 @@ static int timerfd_poll(FAR struct file *filep, FAR struct pollfd *fds,
 {
   FAR struct timerfd_priv_s *dev = filep->f_priv;
   irqstate_t intflags;
-  int ret = OK;
-  int i;
+  int ret;
+
+  ret = nxwaitq_poll(&dev->rdwq, fds, setup);
+  if (!setup || ret < 0)
+    {
+      return ret;
+    }
+
+  /* Notify the POLLIN event if the counter is not zero */
 
   intflags = enter_critical_section();
-  if (!setup)
+  if (dev->counter > 0)
     {
-      /* This is a request to tear down the poll. */
+      poll_notify(&fds, 1, POLLIN);
+    }
 
-      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+  leave_critical_section(intflags);
+  return ret;
+}
+#endif
 
-      /* Remove all memory of the poll setup */
+/* Count one expiration and wake up the readers.  Called in the critical
+ * section.
+ */
 
-      *slot     = NULL;
-      fds->priv = NULL;
-      goto out;
-    }
+static void timerfd_expired(FAR struct timerfd_priv_s *dev)
+{
+  /* Increment timer expiration counter */
 
-  /* This is a request to set up the poll. Find an available
-   * slot for the poll structure reference
-   */
+  dev->counter++;
 
-  for (i = 0; i < CONFIG_TIMER_FD_NPOLLWAITERS; i++)
-    {
-      /* Find an available slot */
+#ifdef CONFIG_TIMER_FD_POLL
+  /* Notify all poll/select waiters */
 
-      if (!dev->fds[i])
-        {
-          /* Bind the poll structure and this slot */
+  nxwaitq_notify(&dev->rdwq, POLLIN);
+#endif
 
-          dev->fds[i] = fds;
-          fds->priv   = &dev->fds[i];
-          break;
-        }
-    }
+  /* Wake one of the waiting readers */
 
-  if (i >= CONFIG_TIMER_FD_NPOLLWAITERS)
-    {
-      fds->priv = NULL;
-      ret       = -EBUSY;
-      goto out;
-    }
+  nxwaitq_wake(&dev->rdwq, false);
+}
 
-  /* Notify the POLLIN event if the counter is not zero */
+#ifdef CONFIG_HRTIMER
+static uint64_t timerfd_hrtimeout(FAR const hrtimer_t *hrtimer,
+                                  uint64_t expired)
+{
+  FAR struct timerfd_priv_s *dev =
+    container_of(hrtimer, struct timerfd_priv_s, hrtimer);
+  uint64_t period = 0;
+  irqstate_t intflags;
 
-  if (dev->counter > 0)
+  intflags = enter_critical_section();
+
+  /* Skip the expiration if timerfd_settime() cancelled or restarted the
+   * timer while this callback was waiting for the critical section.
+   */
+
+  if (hrtimer->expired == expired)
     {
-#ifdef CONFIG_TIMER_FD_POLL
-      poll_notify(&fds, 1, POLLIN);
-#endif
+      timerfd_expired(dev);
+
+      /* A repetitive timer is restarted by the hrtimer core, once per
+       * period that has elapsed.
+       */
+
+      period = dev->period;
     }
 
-out:
   leave_critical_section(intflags);
-  return ret;
+  return period;
 }
-#endif
-
+#else
 static void timerfd_timeout(wdparm_t arg)
 {
   FAR struct timerfd_priv_s *dev = (FAR struct timerfd_priv_s *)arg;
-  FAR timerfd_waiter_sem_t *cur_sem;
   irqstate_t intflags;
 
   /* Disable interrupts to ensure that expiration counter is accessed
@@ -398,10 +373,6 @@ static void timerfd_timeout(wdparm_t arg)
 
   intflags = enter_critical_section();
 
-  /* Increment timer expiration counter */
-
-  dev->counter++;
-
   /* If this is a repetitive timer, then restart the watchdog */
 
   if (dev->delay > 0)
@@ -409,25 +380,11 @@ static void timerfd_timeout(wdparm_t arg)
       wd_start(&dev->wdog, dev->delay, timerfd_timeout, arg);
     }
 
-#ifdef CONFIG_TIMER_FD_POLL
-  /* Notify all poll/select waiters */
-
-  poll_notify(dev->fds, CONFIG_TIMER_FD_NPOLLWAITERS, POLLIN);
-#endif
-
-  /* Notify all of the waiting readers */
-
-  cur_sem = dev->rdsems;
-  while (cur_sem != NULL)
-    {
-      nxsem_post(&cur_sem->sem);
-      cur_sem = cur_sem->next;
-    }
-
-  dev->rdsems = NULL;
+  timerfd_expired(dev);
 
   leave_critical_section(intflags);
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -492,7 +449,9 @@ int timerfd_settime(int fd, int flags,
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
   irqstate_t intflags;
+#ifndef CONFIG_HRTIMER
   sclock_t delay;
+#endif
   int ret;
 
   /* Some sanity checks */
@@ -532,6 +491,11 @@ int timerfd_settime(int fd, int flags,
 
   if (old_value)
     {
+#ifdef CONFIG_HRTIMER
+      clock_nsec2time(&old_value->it_value,
+                      hrtimer_gettimeout(&dev->hrtimer));
+      clock_nsec2time(&old_value->it_interval, dev->period);
+#else
       /* Get the number of ticks before the underlying watchdog expires */
 
       delay = wd_gettime(&dev->wdog);
@@ -540,13 +504,18 @@ int timerfd_settime(int fd, int flags,
 
       clock_ticks2time(&old_value->it_value, delay);
       clock_ticks2time(&old_value->it_interval, dev->delay);
+#endif
     }
 
   /* Disarm the timer (in case the timer was already armed when
    * timerfd_settime() is called).
    */
 
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&dev->hrtimer);
+#else
   wd_cancel(&dev->wdog);
+#endif
 
   /* Clear expiration counter */
 
@@ -563,6 +532,27 @@ int timerfd_settime(int fd, int flags,
       return OK;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* The hrtimer expires at the exact time, or later by up to the slack
+   * to share the wakeup of another timer.
+   */
+
+  dev->period = clock_time2nsec(&new_value->it_interval);
+
+  if ((flags & TFD_TIMER_ABSTIME) != 0)
+    {
+      ret = hrtimer_start_range(&dev->hrtimer,
+                                hrtimer_abstime2ns(dev->clock,
+                                                   &new_value->it_value),
+                                HRTIMER_DEFAULT_SLACK, HRTIMER_MODE_ABS);
+    }
+  else
+    {
+      ret = hrtimer_start_range(&dev->hrtimer,
+                                clock_time2nsec(&new_value->it_value),
+                                HRTIMER_DEFAULT_SLACK, HRTIMER_MODE_REL);
+    }
+#else
   /* Setup up any repetitive timer */
 
   delay = clock_time2ticks(&new_value->it_interval);
@@ -602,6 +592,8 @@ int timerfd_settime(int fd, int flags,
   /* Then start the watchdog */
 
   ret = wd_start(&dev->wdog, delay, timerfd_timeout, (wdparm_t)dev);
+#endif
+
   if (ret < 0)
     {
       leave_critical_section(intflags);
@@ -623,7 +615,9 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 {
   FAR struct timerfd_priv_s *dev;
   FAR struct file *filep;
+#ifndef CONFIG_HRTIMER
   sclock_t ticks;
+#endif
   int ret;
 
   /* Some sanity checks */
@@ -650,6 +644,10 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 
   dev = (FAR struct timerfd_priv_s *)filep->f_priv;
 
+#ifdef CONFIG_HRTIMER
+  clock_nsec2time(&curr_value->it_value, hrtimer_gettimeout(&dev->hrtimer));
+  clock_nsec2time(&curr_value->it_interval, dev->period);
+#else
   /* Get the number of ticks before the underlying watchdog expires */
 
   ticks = wd_gettime(&dev->wdog);
@@ -658,6 +656,7 @@ int timerfd_gettime(int fd, FAR struct itimerspec *curr_value)
 
   clock_ticks2time(&curr_value->it_value, ticks);
   clock_ticks2time(&curr_value->it_interval, dev->delay);
+#endif
   file_put(filep);
   return OK;
 
@@ -54,6 +54,9 @@
 int file_truncate(FAR struct file *filep, off_t length)
 {
   struct inode *inode;
+#ifdef CONFIG_FS_PAGECACHE
+  int ret;
+#endif
 
   /* Was this file opened for write access? */
 
@@ -100,6 +103,23 @@ int file_truncate(FAR struct file *filep, off_t length)
       return -ENOSYS;
     }
 
+#ifdef CONFIG_FS_DCACHE
+  if (INODE_IS_MOUNTPT(inode))
+    {
+      dcache_modified(inode);
+    }
+#endif
+
+#ifdef CONFIG_FS_PAGECACHE
+  /* A cached file is truncated through the page cache */
+
+  ret = pagecache_truncate(filep, length);
+  if (ret != -ENOSYS)
+    {
+      return ret;
+    }
+#endif
+
   /* Yes, then tell the file system to truncate this file */
 
   return inode->u.i_ops->truncate(filep, length);
@@ -99,6 +99,13 @@ int nx_unlink(FAR const char *pathname)
             {
               goto errout_with_inode;
             }
+
+#ifdef CONFIG_FS_DCACHE
+          dcache_invalidate(inode, desc.relpath);
+#endif
+#ifdef CONFIG_FS_PAGECACHE
+          pagecache_invalidate(pathname);
+#endif
         }
       else
         {
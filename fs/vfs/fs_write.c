@@ -34,6 +34,8 @@
 #include <assert.h>
 
 #include <nuttx/cancelpt.h>
+#include <nuttx/sched.h>
+#include <nuttx/tracepoint.h>
 
 #include "inode/inode.h"
 #include "vfs.h"
@@ -188,6 +190,18 @@ ssize_t file_writev(FAR struct file *filep,
   inode = filep->f_inode;
   if (inode != NULL && inode->u.i_ops)
     {
+#ifdef CONFIG_SCHED_PRESSURE
+      bool marked = INODE_IS_STORAGE(inode) && nxsched_pressure_io_begin();
+#endif
+
+#ifdef CONFIG_FS_PAGECACHE
+      ret = pagecache_writev(filep, iov, iovcnt);
+      if (ret != -ENOSYS)
+        {
+          /* The write was absorbed by the page cache */
+        }
+      else
+#endif
       if (inode->u.i_ops->writev)
         {
           struct uio uio;
@@ -202,7 +216,18 @@ ssize_t file_writev(FAR struct file *filep,
         {
           ret = file_writev_compat(filep, iov, iovcnt);
         }
+
+#ifdef CONFIG_SCHED_PRESSURE
+      nxsched_pressure_io_end(marked);
+#endif
+    }
+
+#ifdef CONFIG_FS_DCACHE
+  if (ret > 0 && INODE_IS_MOUNTPT(inode))
+    {
+      dcache_modified(inode);
     }
+#endif
 
 #ifdef CONFIG_FS_NOTIFY
   if (ret > 0)
@@ -211,6 +236,14 @@ ssize_t file_writev(FAR struct file *filep,
     }
 #endif
 
+#ifdef CONFIG_SCHED_RUSAGE
+  if (ret > 0)
+    {
+      nxsched_self()->wchar += ret;
+    }
+#endif
+
+  tracepoint(FS_WRITE, NOTE_TAG_FS, "write %p %zd", filep, ret);
   return ret;
 }
 
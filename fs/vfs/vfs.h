@@ -123,4 +123,31 @@ void notify_rename(FAR const char *oldpath, bool oldisdir,
 void notify_initialize(void);
 #endif /* CONFIG_FS_NOTIFY */
 
+/* The page cache of the files on block-backed file systems, see
+ * fs_pagecache.c.  The functions that take a file return -ENOSYS if the
+ * file is not cached, the caller then lets the file system do the work.
+ */
+
+#ifdef CONFIG_FS_PAGECACHE
+struct stat;
+
+void pagecache_initialize(void);
+void pagecache_open(FAR struct file *filep, FAR const char *path,
+                    FAR const char *relpath);
+void pagecache_sync(FAR const char *path);
+void pagecache_dup(FAR struct file *filep1, FAR struct file *filep2);
+void pagecache_close(FAR struct file *filep);
+ssize_t pagecache_readv(FAR struct file *filep,
+                        FAR const struct iovec *iov, int iovcnt);
+ssize_t pagecache_writev(FAR struct file *filep,
+                         FAR const struct iovec *iov, int iovcnt);
+off_t pagecache_seek(FAR struct file *filep, off_t offset, int whence);
+int pagecache_truncate(FAR struct file *filep, off_t length);
+int pagecache_fsync(FAR struct file *filep);
+void pagecache_stat(FAR struct file *filep, FAR const char *path,
+                    FAR struct stat *buf);
+void pagecache_invalidate(FAR const char *path);
+void pagecache_umount(FAR struct inode *mountpt);
+#endif /* CONFIG_FS_PAGECACHE */
+
 #endif /* __FS_VFS_VFS_H */
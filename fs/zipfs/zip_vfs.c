@@ -39,6 +39,14 @@
 
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_ZIPFS_CACHE_NCHUNKS
+#  define CONFIG_ZIPFS_CACHE_NCHUNKS 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -56,11 +64,28 @@ struct zipfs_mountpt_s
   char abspath[1];
 };
 
+#if CONFIG_ZIPFS_CACHE_NCHUNKS > 0
+struct zipfs_chunk_s
+{
+  off_t pos;                /* File offset of the chunk, -1 if unused */
+  size_t len;               /* Valid bytes, short only at the end of file */
+  FAR char *data;
+};
+#endif
+
 struct zipfs_file_s
 {
   unzFile uf;
   mutex_t lock;
   FAR char *seekbuf;
+#if CONFIG_ZIPFS_CACHE_NCHUNKS > 0
+  off_t zpos;               /* File offset of the decompression stream */
+  FAR char *cachebuf;       /* Memory of all chunks */
+
+  /* Decompressed chunks, the most recently used first */
+
+  struct zipfs_chunk_s chunk[CONFIG_ZIPFS_CACHE_NCHUNKS];
+#endif
   char relpath[1];
 };
 
@@ -285,6 +310,17 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
 
   if (ret == OK)
     {
+#if CONFIG_ZIPFS_CACHE_NCHUNKS > 0
+      int i;
+
+      for (i = 0; i < CONFIG_ZIPFS_CACHE_NCHUNKS; i++)
+        {
+          fp->chunk[i].pos = -1;
+        }
+
+      fp->zpos     = 0;
+      fp->cachebuf = NULL;
+#endif
       fp->seekbuf = NULL;
       strcpy(fp->relpath, relpath);
       filep->f_priv = fp;
@@ -309,11 +345,147 @@ static int zipfs_close(FAR struct file *filep)
 
   ret = zipfs_convert_result(unzClose(fp->uf));
   nxmutex_destroy(&fp->lock);
+#if CONFIG_ZIPFS_CACHE_NCHUNKS > 0
+  fs_heap_free(fp->cachebuf);
+#endif
   fs_heap_free(fp->seekbuf);
   fs_heap_free(fp);
   return ret;
 }
 
+/* Restart the decompression of the open entry from its beginning.  The
+ * entry stays selected, so neither the archive nor the central directory
+ * has to be read again.
+ */
+
+static int zipfs_rewind(FAR struct zipfs_file_s *fp)
+{
+  int ret;
+
+  ret = zipfs_convert_result(unzCloseCurrentFile(fp->uf));
+  if (ret >= 0)
+    {
+      ret = zipfs_convert_result(unzOpenCurrentFile(fp->uf));
+    }
+
+#if CONFIG_ZIPFS_CACHE_NCHUNKS > 0
+  fp->zpos = 0;
+#endif
+  return ret;
+}
+
+#if CONFIG_ZIPFS_CACHE_NCHUNKS > 0
+/* Return the chunk containing 'pos', decompressing up to it if it is not
+ * cached.  Every chunk the stream passes on the way is cached as well, so
+ * that reading backwards after a forward scan does not inflate again.
+ * NULL is returned with *err set to zero if 'pos' is past the end of file.
+ */
+
+static FAR struct zipfs_chunk_s *zipfs_getchunk(FAR struct zipfs_file_s *fp,
+                                               off_t pos, FAR int *err)
+{
+  struct zipfs_chunk_s chunk;
+  off_t start;
+  int ret;
+  int i;
+
+  *err  = 0;
+  start = pos - pos % CONFIG_ZIPFS_CACHE_CHUNKSIZE;
+
+  for (i = 0; i < CONFIG_ZIPFS_CACHE_NCHUNKS; i++)
+    {
+      if (fp->chunk[i].pos == start)
+        {
+          goto found;
+        }
+    }
+
+  if (fp->cachebuf == NULL)
+    {
+      fp->cachebuf = fs_heap_malloc(CONFIG_ZIPFS_CACHE_NCHUNKS *
+                                    CONFIG_ZIPFS_CACHE_CHUNKSIZE);
+      if (fp->cachebuf == NULL)
+        {
+          *err = -ENOMEM;
+          return NULL;
+        }
+
+      for (i = 0; i < CONFIG_ZIPFS_CACHE_NCHUNKS; i++)
+        {
+          fp->chunk[i].data = fp->cachebuf +
+                              i * CONFIG_ZIPFS_CACHE_CHUNKSIZE;
+        }
+    }
+
+  if (fp->zpos > start)
+    {
+      ret = zipfs_rewind(fp);
+      if (ret < 0)
+        {
+          *err = ret;
+          return NULL;
+        }
+    }
+
+  /* Inflate chunk by chunk into the least recently used entry */
+
+  i = CONFIG_ZIPFS_CACHE_NCHUNKS - 1;
+  do
+    {
+      FAR struct zipfs_chunk_s *victim = &fp->chunk[i];
+
+      victim->pos = -1;
+      victim->len = 0;
+
+      while (victim->len < CONFIG_ZIPFS_CACHE_CHUNKSIZE)
+        {
+          ret = unzReadCurrentFile(fp->uf, victim->data + victim->len,
+                                   CONFIG_ZIPFS_CACHE_CHUNKSIZE -
+                                   victim->len);
+          ret = zipfs_convert_result(ret);
+          if (ret < 0)
+            {
+              *err = ret;
+              return NULL;
+            }
+          else if (ret == 0)
+            {
+              break;
+            }
+
+          victim->len += ret;
+        }
+
+      if (victim->len == 0)
+        {
+          return NULL;
+        }
+
+      victim->pos = fp->zpos;
+      fp->zpos   += victim->len;
+
+      chunk = *victim;
+      memmove(&fp->chunk[1], &fp->chunk[0], i * sizeof(chunk));
+      fp->chunk[0] = chunk;
+    }
+  while (chunk.pos != start &&
+         chunk.len == CONFIG_ZIPFS_CACHE_CHUNKSIZE);
+
+  if (chunk.pos != start)
+    {
+      return NULL;
+    }
+
+  i = 0;
+
+found:
+  chunk = fp->chunk[i];
+  memmove(&fp->chunk[1], &fp->chunk[0], i * sizeof(chunk));
+  fp->chunk[0] = chunk;
+  return &fp->chunk[0];
+}
+#endif
+
 static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen)
 {
@@ -321,11 +493,47 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t ret;
 
   nxmutex_lock(&fp->lock);
+#if CONFIG_ZIPFS_CACHE_NCHUNKS > 0
+  ret = 0;
+  while (buflen > 0)
+    {
+      FAR struct zipfs_chunk_s *chunk;
+      size_t offset;
+      size_t nbytes;
+      int err;
+
+      chunk = zipfs_getchunk(fp, filep->f_pos, &err);
+      if (chunk == NULL)
+        {
+          ret = ret > 0 ? ret : err;
+          break;
+        }
+
+      offset = filep->f_pos - chunk->pos;
+      if (offset >= chunk->len)
+        {
+          break;
+        }
+
+      nbytes = chunk->len - offset;
+      if (nbytes > buflen)
+        {
+          nbytes = buflen;
+        }
+
+      memcpy(buffer, chunk->data + offset, nbytes);
+      filep->f_pos += nbytes;
+      buffer       += nbytes;
+      buflen       -= nbytes;
+      ret          += nbytes;
+    }
+#else
   ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer, buflen));
   if (ret > 0)
     {
       filep->f_pos += ret;
     }
+#endif
 
   nxmutex_unlock(&fp->lock);
   return ret;
@@ -369,7 +577,6 @@ static off_t zipfs_skip(FAR struct zipfs_file_s *fp, off_t amount)
 static off_t zipfs_seek(FAR struct file *filep, off_t offset,
                         int whence)
 {
-  FAR struct zipfs_mountpt_s *fs = filep->f_inode->i_private;
   FAR struct zipfs_file_s *fp = filep->f_priv;
   unz_file_info64 file_info;
   off_t ret = 0;
@@ -398,32 +605,24 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
         goto err_with_lock;
     }
 
+  if (offset < 0)
+    {
+      ret = -EINVAL;
+      goto err_with_lock;
+    }
+
+#if CONFIG_ZIPFS_CACHE_NCHUNKS > 0
+  /* zipfs_read() finds or inflates the chunk at the new position */
+
+  filep->f_pos = offset;
+#else
   if (filep->f_pos == offset)
     {
       goto err_with_lock;
     }
   else if (filep->f_pos > offset)
     {
-      ret = zipfs_convert_result(unzClose(fp->uf));
-      if (ret < 0)
-        {
-          goto err_with_lock;
-        }
-
-      fp->uf = unzOpen2_64(fs->abspath, &zipfs_real_ops);
-      if (fp->uf == NULL)
-        {
-          ret = -EINVAL;
-          goto err_with_lock;
-        }
-
-      ret = zipfs_convert_result(unzLocateFile(fp->uf, fp->relpath, 0));
-      if (ret < 0)
-        {
-          goto err_with_lock;
-        }
-
-      ret = zipfs_convert_result(unzOpenCurrentFile(fp->uf));
+      ret = zipfs_rewind(fp);
       if (ret < 0)
         {
           goto err_with_lock;
@@ -442,6 +641,7 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
     {
       filep->f_pos += ret;
     }
+#endif
 
 err_with_lock:
   nxmutex_unlock(&fp->lock);
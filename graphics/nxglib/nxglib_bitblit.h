@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <string.h>
 
 #include <nuttx/nx/nxglib.h>
 
@@ -107,25 +108,11 @@
 #  define NXGL_ALIGNUP(x)          (((x) + NXGL_PIXELMASK) & ~NXGL_PIXELMASK)
 
 #  define NXGL_MEMSET(dest,value,width) \
-   { \
-     FAR uint8_t *_ptr = (FAR uint8_t*)(dest); \
-     int        _nby = NXGL_SCALEX(width); \
-     while (_nby--) \
-       { \
-         *_ptr++ = (value); \
-       } \
-   }
-
+     memset((dest), (uint8_t)(value), NXGL_SCALEX(width))
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     int        _nby  = NXGL_SCALEX(width); \
-     while (_nby--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+     memcpy((dest), (src), NXGL_SCALEX(width))
+#  define NXGL_MEMMOVE(dest,src,width) \
+     memmove((dest), (src), NXGL_SCALEX(width))
 
 #elif NXGLIB_BITSPERPIXEL == 24
 
@@ -142,17 +129,9 @@
    }
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR uint8_t *_dptr = (FAR uint8_t*)(dest); \
-     FAR uint8_t *_sptr = (FAR uint8_t*)(src); \
-     nxgl_coord_t _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+     memcpy((dest), (src), NXGL_SCALEX(width))
+#  define NXGL_MEMMOVE(dest,src,width) \
+     memmove((dest), (src), NXGL_SCALEX(width))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -171,9 +150,16 @@
    }
 
 #endif /* CONFIG_NX_ANTIALIASING */
-#else /* NXGLIB_BITSPERPIXEL == 16 || NXGLIB_BITSPERPIXEL == 32 */
-
-#  define NXGL_MEMSET(dest,value,width) \
+#else /* NXGLIB_BITSPERPIXEL == 8, 16 or 32 */
+
+#  if NXGLIB_BITSPERPIXEL == 8
+#    define NXGL_MEMSET(dest,value,width) \
+       memset((dest), (uint8_t)(value), (width))
+#  elif NXGLIB_BITSPERPIXEL == 16
+#    define NXGL_MEMSET(dest,value,width) \
+       nxgl_memset16((FAR uint16_t *)(dest), (value), (width))
+#  else
+#    define NXGL_MEMSET(dest,value,width) \
    { \
      FAR NXGL_PIXEL_T *_ptr = (FAR NXGL_PIXEL_T*)(dest); \
      nxgl_coord_t     _npix = (width); \
@@ -182,17 +168,16 @@
          *_ptr++ = (value); \
        } \
    }
+#  endif
+
+/* The C library copies a word (or more) at a time, which is better than
+ * any per pixel loop.
+ */
 
 #  define NXGL_MEMCPY(dest,src,width) \
-   { \
-     FAR NXGL_PIXEL_T *_dptr = (FAR NXGL_PIXEL_T*)(dest); \
-     FAR NXGL_PIXEL_T *_sptr = (FAR NXGL_PIXEL_T*)(src); \
-     nxgl_coord_t      _npix = (width); \
-     while (_npix--) \
-       { \
-         *_dptr++ = *_sptr++; \
-       } \
-   }
+     memcpy((dest), (src), (size_t)(width) * sizeof(NXGL_PIXEL_T))
+#  define NXGL_MEMMOVE(dest,src,width) \
+     memmove((dest), (src), (size_t)(width) * sizeof(NXGL_PIXEL_T))
 
 #ifdef CONFIG_NX_ANTIALIASING
 
@@ -224,6 +209,54 @@ extern "C"
 #define EXTERN extern
 #endif
 
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxgl_memset16
+ *
+ * Description:
+ *   Fill a run of 16-bit pixels, two pixels per 32-bit store once the run
+ *   is word aligned.
+ *
+ ****************************************************************************/
+
+#if NXGLIB_BITSPERPIXEL == 16
+static inline void nxgl_memset16(FAR uint16_t *dest, uint16_t value,
+                                 size_t npixels)
+{
+  FAR uint32_t *wdest;
+  uint32_t wide = ((uint32_t)value << 16) | value;
+
+  if (((uintptr_t)dest & 2) != 0 && npixels > 0)
+    {
+      *dest++ = value;
+      npixels--;
+    }
+
+  wdest = (FAR uint32_t *)dest;
+  for (; npixels >= 8; npixels -= 8)
+    {
+      wdest[0] = wide;
+      wdest[1] = wide;
+      wdest[2] = wide;
+      wdest[3] = wide;
+      wdest   += 4;
+    }
+
+  for (; npixels >= 2; npixels -= 2)
+    {
+      *wdest++ = wide;
+    }
+
+  if (npixels > 0)
+    {
+      *(FAR uint16_t *)wdest = value;
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -31,6 +31,8 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "nxglib_bitblit.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -144,14 +146,9 @@ static inline void nxgl_fillrun_16bpp(FAR uint16_t *run,
                                       nxgl_mxpixel_t color,
                                       size_t npixels)
 {
-  /* Fill the run with the color (it is okay to run a fractional byte overy
-   * the end
-   */
+  /* Fill the run with the color, two pixels per word */
 
-  while (npixels-- > 0)
-    {
-      *run++ = (uint16_t)color;
-    }
+  nxgl_memset16(run, (uint16_t)color, npixels);
 }
 
 #elif NXGLIB_BITSPERPIXEL == 24
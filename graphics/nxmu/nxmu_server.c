@@ -150,6 +150,80 @@ static void nxmu_event(FAR struct nxbe_window_s *wnd, enum nx_event_e event,
     }
 }
 
+/****************************************************************************
+ * Name: nxmu_batch
+ *
+ * Description:
+ *   Perform the drawing messages of a client batch in order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+static void nxmu_batch(FAR struct nxsvrmsg_batch_s *batch, int nbytes)
+{
+  FAR uint8_t *ptr = (FAR uint8_t *)batch->msgs;
+  FAR uint8_t *end;
+  size_t msglen;
+
+  nbytes -= sizeof(struct nxsvrmsg_batch_s);
+  if (nbytes < 0 || batch->nbytes > nbytes)
+    {
+      gerr("ERROR: Truncated batch: %d\n", nbytes);
+      return;
+    }
+
+  for (end = ptr + batch->nbytes; ptr < end; ptr += NX_BATCH_ALIGN(msglen))
+    {
+      FAR struct nxsvrmsg_s *msg = (FAR struct nxsvrmsg_s *)ptr;
+
+      switch (msg->msgid)
+        {
+          case NX_SVRMSG_SETPIXEL:
+            {
+              FAR struct nxsvrmsg_setpixel_s *setmsg =
+                (FAR struct nxsvrmsg_setpixel_s *)msg;
+              nxbe_setpixel(setmsg->wnd, &setmsg->pos, setmsg->color);
+              msglen = sizeof(*setmsg);
+            }
+            break;
+
+          case NX_SVRMSG_FILL:
+            {
+              FAR struct nxsvrmsg_fill_s *fillmsg =
+                (FAR struct nxsvrmsg_fill_s *)msg;
+              nxbe_fill(fillmsg->wnd, &fillmsg->rect, fillmsg->color);
+              msglen = sizeof(*fillmsg);
+            }
+            break;
+
+          case NX_SVRMSG_FILLTRAP:
+            {
+              FAR struct nxsvrmsg_filltrapezoid_s *trapmsg =
+                (FAR struct nxsvrmsg_filltrapezoid_s *)msg;
+              nxbe_filltrapezoid(trapmsg->wnd, &trapmsg->clip,
+                                 &trapmsg->trap, trapmsg->color);
+              msglen = sizeof(*trapmsg);
+            }
+            break;
+
+          case NX_SVRMSG_MOVE:
+            {
+              FAR struct nxsvrmsg_move_s *movemsg =
+                (FAR struct nxsvrmsg_move_s *)msg;
+              nxbe_move(movemsg->wnd, &movemsg->rect, &movemsg->offset);
+              msglen = sizeof(*movemsg);
+            }
+            break;
+
+          default:
+            gerr("ERROR: Unexpected msgid=%" PRId32 " in batch\n",
+                 msg->msgid);
+            return;
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: nxmu_setup
  ****************************************************************************/
@@ -271,7 +345,7 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
 {
   struct nxmu_state_s    nxmu;
   FAR struct nxsvrmsg_s *msg;
-  char                   buffer[NX_MXSVRMSGLEN];
+  char                   buffer[NX_MXSVRMSGLEN] aligned_data(8);
   int                    nbytes;
   int                    ret;
 
@@ -515,6 +589,12 @@ int nx_runinstance(FAR const char *mqname, FAR NX_DRIVERTYPE *dev)
             }
             break;
 
+#ifdef CONFIG_NX_BATCH
+          case NX_SVRMSG_BATCH: /* A number of drawing messages of a client */
+            nxmu_batch((FAR struct nxsvrmsg_batch_s *)buffer, nbytes);
+            break;
+#endif
+
           case NX_SVRMSG_BITMAP: /* Copy a rectangular bitmap into the window */
             {
               FAR struct nxsvrmsg_bitmap_s *bmpmsg =
@@ -33,20 +33,48 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/types.h>
 
 #ifndef AES_MAXROUNDS
 #  define AES_MAXROUNDS (14)
 #endif
 
+struct aes_accel_s;
+
 typedef struct aes_ctx
 {
   uint32_t sk[60];
   uint32_t sk_exp[120];
 
   unsigned num_rounds;
+#ifdef CONFIG_CRYPTO_SW_AES_ACCEL
+  FAR const struct aes_accel_s *accel;
+#endif
 } AES_CTX;
 
+#ifdef CONFIG_CRYPTO_SW_AES_ACCEL
+
+/* CPU specific block kernels.  aes_setkey() stores the plain FIPS-197
+ * round keys as bytes at the start of sk_exp[] and lets setkey() derive
+ * whatever else the kernel needs (decryption keys) in the rest of it.
+ */
+
+struct aes_accel_s
+{
+  CODE void (*setkey)(FAR AES_CTX *);
+  CODE void (*encrypt_ecb)(FAR AES_CTX *, FAR const uint8_t *,
+                           FAR uint8_t *, size_t);
+  CODE void (*decrypt_ecb)(FAR AES_CTX *, FAR const uint8_t *,
+                           FAR uint8_t *, size_t);
+};
+
+extern FAR const struct aes_accel_s *aes_accel;
+
+void aes_accel_initialize(void);
+#endif
+
 int aes_setkey(FAR AES_CTX *, FAR const uint8_t *, int);
 void aes_encrypt(FAR AES_CTX *, FAR const uint8_t *, FAR uint8_t *);
 void aes_decrypt(FAR AES_CTX *, FAR const uint8_t *, FAR uint8_t *);
@@ -223,7 +223,13 @@ struct cryptop
   FAR void *crp_opaque;            /* Opaque pointer, passed along */
   FAR struct cryptodesc *crp_desc; /* Linked list of processing descriptors */
 
-  CODE int (*crp_callback)(FAR struct cryptop *); /* Callback function */
+  /* Callback function, called by crypto_done() once the request is
+   * completed.  A driver whose cc_process() returns -EINPROGRESS for a
+   * request with a callback calls crypto_done() later, maybe from an
+   * interrupt handler.
+   */
+
+  CODE int (*crp_callback)(FAR struct cryptop *);
 
   caddr_t crp_mac;
   caddr_t crp_dst;
@@ -362,6 +368,14 @@ struct crypt_op
  * in the authentication algorithm.
  */
 
+#define COP_FLAG_ASYNC   (1 << 2) /* Queue the operation and return at once,
+                                   * the operations of one session are done
+                                   * in order.  The buffers must stay valid
+                                   * until CIOCCRYPTRET returns the result
+                                   * with the same reqid, POLLIN is raised
+                                   * when a result is ready.
+                                   */
+
   uint16_t flags;
   unsigned len;
   unsigned aadlen;
@@ -369,6 +383,38 @@ struct crypt_op
   caddr_t mac;        /* must be big enough for chosen MAC */
   caddr_t iv;
   caddr_t aad;
+  uint32_t reqid;     /* distinguish asynchronous operations */
+  int status;         /* returns: result of an asynchronous operation */
+};
+
+/* ioctl parameter to submit several operations at once */
+
+struct crypt_mop
+{
+  unsigned count;              /* in: # of operations,
+                                * returns: # of operations done or queued
+                                */
+  FAR struct crypt_op *ops;
+};
+
+/* ioctl parameter to hash (part of) a file, block or MTD device */
+
+struct crypt_img
+{
+  int fd;             /* descriptor of the image to hash */
+  uint32_t mac;       /* ie. CRYPTO_SHA2_256 */
+
+#define CIMG_FLAG_MERKLE (1 << 0) /* Return the root of an RFC 6962 Merkle
+                                   * tree with chunk sized leaves instead of
+                                   * the plain hash, the leaves are hashed
+                                   * in parallel.
+                                   */
+
+  uint32_t flags;
+  off_t offset;       /* first byte to hash */
+  size_t len;         /* # of bytes, 0 hashes up to the end of the file */
+  size_t chunk;       /* read and leaf size, 0 for the default */
+  caddr_t digest;     /* returns: the digest, hash size bytes */
 };
 
 /* hamc buffer, software & hardware need it */
@@ -392,6 +438,9 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCKEY                 104
 #define CIOCKEYRET              105
 #define CIOCASYMFEAT            106
+#define CIOCCRYPTM              107
+#define CIOCCRYPTRET            108
+#define CIOCIMGHASH             109
 
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
 int crypto_freesession(uint64_t);
@@ -404,6 +453,7 @@ int crypto_kregister(uint32_t, FAR int *,
 int crypto_unregister(uint32_t, int);
 int crypto_get_driverid(uint8_t);
 int crypto_invoke(FAR struct cryptop *);
+void crypto_done(FAR struct cryptop *);
 int crypto_kinvoke(FAR struct cryptkop *);
 int crypto_getfeat(FAR int *);
 
@@ -414,4 +464,9 @@ void crypto_freereq(FAR struct cryptop *);
 void hwcr_init(void);
 #endif
 
+#ifdef CONFIG_CRYPTO_IMGHASH
+struct file;
+int crypto_imghash(FAR struct file *, FAR struct crypt_img *);
+#endif
+
 #endif /* __INCLUDE_CRYPTO_CRYPTODEV_H */
@@ -26,9 +26,15 @@ typedef struct
   unsigned char buffer[SHA1_BLOCK_LENGTH];
 } SHA1_CTX;
 
+extern void (*sha1_blocks)(FAR uint32_t *, FAR const unsigned char *,
+                           unsigned int);
+
 void sha1init(FAR SHA1_CTX * context);
 void sha1transform(FAR uint32_t *state,
                    FAR const unsigned char *buffer);
+void sha1blocks_mi(FAR uint32_t *state,
+                   FAR const unsigned char *buffer,
+                   unsigned int nblocks);
 void sha1update(FAR SHA1_CTX *context,
                 FAR const void *data,
                 unsigned int len);
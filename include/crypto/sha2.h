@@ -40,6 +40,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <sys/types.h>
 
 /* SHA-256/384/512 Various Length Definitions */
@@ -70,6 +72,12 @@ typedef struct _SHA2_CTX
   uint8_t buffer[SHA512_BLOCK_LENGTH];
 } SHA2_CTX;
 
+extern void (*sha256_blocks)(FAR uint32_t *, FAR const uint8_t *, size_t);
+
+#ifdef CONFIG_CRYPTO_SHA_ACCEL
+void sha_accel_initialize(void);
+#endif
+
 void sha224init(FAR SHA2_CTX *);
 void sha224update(FAR SHA2_CTX *, FAR const void *, size_t);
 void sha224final(FAR uint8_t *, FAR SHA2_CTX *);
@@ -512,6 +512,13 @@ void park_transform(FAR phase_angle_f32_t *angle, FAR ab_frame_f32_t *ab,
                     FAR dq_frame_f32_t *dq);
 void inv_park_transform(FAR phase_angle_f32_t *angle, FAR dq_frame_f32_t *dq,
                         FAR ab_frame_f32_t *ab);
+void clarke_transform_n(FAR abc_frame_f32_t *abc, FAR ab_frame_f32_t *ab,
+                        size_t n);
+void park_transform_n(FAR phase_angle_f32_t *angle, FAR ab_frame_f32_t *ab,
+                      FAR dq_frame_f32_t *dq, size_t n);
+void inv_park_transform_n(FAR phase_angle_f32_t *angle,
+                          FAR dq_frame_f32_t *dq, FAR ab_frame_f32_t *ab,
+                          size_t n);
 
 /* Phase angle related functions */
 
@@ -494,6 +494,14 @@ void park_transform_b16(FAR phase_angle_b16_t *angle, FAR ab_frame_b16_t *ab,
                         FAR dq_frame_b16_t *dq);
 void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
                             FAR dq_frame_b16_t *dq, FAR ab_frame_b16_t *ab);
+void clarke_transform_n_b16(FAR abc_frame_b16_t *abc,
+                            FAR ab_frame_b16_t *ab, size_t n);
+void park_transform_n_b16(FAR phase_angle_b16_t *angle,
+                          FAR ab_frame_b16_t *ab, FAR dq_frame_b16_t *dq,
+                          size_t n);
+void inv_park_transform_n_b16(FAR phase_angle_b16_t *angle,
+                              FAR dq_frame_b16_t *dq, FAR ab_frame_b16_t *ab,
+                              size_t n);
 
 /* Phase angle related functions */
 
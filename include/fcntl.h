@@ -64,6 +64,7 @@
 #define O_NOATIME    (1 << 18)       /* Don't update the file last access time */
 #define O_RESERVE19  (1 << 19)       /* reserved and used by mount flag : MS_MANDLOCK in mount.h */
 #define O_RESERVE20  (1 << 20)       /* reserved and used by mount flag : MS_NOEXEC in mount.h */
+#define O_RESERVE21  (1 << 21)       /* reserved and used by mount flag : MS_LAZYMOUNT in mount.h */
 
 /* Unsupported, but required open flags */
 
@@ -160,6 +161,13 @@
 #define F_SEAL_WRITE        0x0008 /* Prevent writes */
 #define F_SEAL_FUTURE_WRITE 0x0010 /* Prevent future writes while mapped */
 
+/* Flags for splice() and tee() (linux) */
+
+#define SPLICE_F_MOVE       0x0001 /* Hint: move pages, ignored */
+#define SPLICE_F_NONBLOCK   0x0002 /* Do not block on the pipe */
+#define SPLICE_F_MORE       0x0004 /* Hint: more data will follow, ignored */
+#define SPLICE_F_GIFT       0x0008 /* Unused, for vmsplice() only */
+
 /* int creat(const char *path, mode_t mode);
  *
  * is equivalent to open with O_WRONLY|O_CREAT|O_TRUNC.
@@ -221,6 +229,10 @@ int fcntl(int fd, int cmd, ...);
 
 int posix_fallocate(int fd, off_t offset, off_t len);
 
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags);
+ssize_t tee(int fd_in, int fd_out, size_t len, unsigned int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,139 @@
+/****************************************************************************
+ * include/net/bpf.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NET_BPF_H
+#define __INCLUDE_NET_BPF_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Classic BPF socket filters, as attached with SO_ATTACH_FILTER.  The
+ * instruction encoding is the one of Linux and the BSDs, so that programs
+ * generated by tcpdump -dd or libpcap can be used as they are.
+ */
+
+#define BPF_MAXINSNS        4096
+#define BPF_MEMWORDS        16    /* Words of scratch memory M[] */
+
+/* Instruction classes */
+
+#define BPF_CLASS(code)     ((code) & 0x07)
+#define BPF_LD              0x00
+#define BPF_LDX             0x01
+#define BPF_ST              0x02
+#define BPF_STX             0x03
+#define BPF_ALU             0x04
+#define BPF_JMP             0x05
+#define BPF_RET             0x06
+#define BPF_MISC            0x07
+
+/* ld/ldx fields */
+
+#define BPF_SIZE(code)      ((code) & 0x18)
+#define BPF_W               0x00  /* 32-bit */
+#define BPF_H               0x08  /* 16-bit */
+#define BPF_B               0x10  /*  8-bit */
+
+#define BPF_MODE(code)      ((code) & 0xe0)
+#define BPF_IMM             0x00
+#define BPF_ABS             0x20
+#define BPF_IND             0x40
+#define BPF_MEM             0x60
+#define BPF_LEN             0x80
+#define BPF_MSH             0xa0
+
+/* alu/jmp fields */
+
+#define BPF_OP(code)        ((code) & 0xf0)
+#define BPF_ADD             0x00
+#define BPF_SUB             0x10
+#define BPF_MUL             0x20
+#define BPF_DIV             0x30
+#define BPF_OR              0x40
+#define BPF_AND             0x50
+#define BPF_LSH             0x60
+#define BPF_RSH             0x70
+#define BPF_NEG             0x80
+#define BPF_MOD             0x90
+#define BPF_XOR             0xa0
+
+#define BPF_JA              0x00
+#define BPF_JEQ             0x10
+#define BPF_JGT             0x20
+#define BPF_JGE             0x30
+#define BPF_JSET            0x40
+
+#define BPF_SRC(code)       ((code) & 0x08)
+#define BPF_K               0x00
+#define BPF_X               0x08
+
+/* ret - BPF_K and BPF_X also apply */
+
+#define BPF_RVAL(code)      ((code) & 0x18)
+#define BPF_A               0x10
+
+/* misc */
+
+#define BPF_MISCOP(code)    ((code) & 0xf8)
+#define BPF_TAX             0x00
+#define BPF_TXA             0x80
+
+/* Helpers to write a program */
+
+#define BPF_STMT(code, k) \
+  { (uint16_t)(code), 0, 0, (uint32_t)(k) }
+#define BPF_JUMP(code, k, jt, jf) \
+  { (uint16_t)(code), (uint8_t)(jt), (uint8_t)(jf), (uint32_t)(k) }
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One instruction.  A jump goes jt or jf instructions forward from the
+ * next one, k is the immediate operand or the packet offset.
+ */
+
+struct sock_filter
+{
+  uint16_t code;
+  uint8_t  jt;
+  uint8_t  jf;
+  uint32_t k;
+};
+
+/* The argument of SO_ATTACH_FILTER */
+
+struct sock_fprog
+{
+  unsigned short len;                /* Number of instructions */
+  FAR struct sock_filter *filter;
+};
+
+#endif /* __INCLUDE_NET_BPF_H */
@@ -0,0 +1,65 @@
+/****************************************************************************
+ * include/net/net_tstamp.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NET_NET_TSTAMP_H
+#define __INCLUDE_NET_NET_TSTAMP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <time.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The flags of SO_TIMESTAMPING, with the values of Linux.  The RX flags
+ * select which receive timestamps are taken, SOFTWARE and RAW_HARDWARE
+ * which of them are reported in the SCM_TIMESTAMPING control message.
+ * The TX timestamps are not supported.
+ */
+
+#define SOF_TIMESTAMPING_TX_HARDWARE  (1 << 0)
+#define SOF_TIMESTAMPING_TX_SOFTWARE  (1 << 1)
+#define SOF_TIMESTAMPING_RX_HARDWARE  (1 << 2)
+#define SOF_TIMESTAMPING_RX_SOFTWARE  (1 << 3)
+#define SOF_TIMESTAMPING_SOFTWARE     (1 << 4)
+#define SOF_TIMESTAMPING_RAW_HARDWARE (1 << 6)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The data of SCM_TIMESTAMPING: ts[0] is the software timestamp in
+ * CLOCK_REALTIME, ts[2] the hardware timestamp in the time of the PTP
+ * clock of the network device, ts[1] is unused.  The timestamps that are
+ * not available are zero.
+ */
+
+struct scm_timestamping
+{
+  struct timespec ts[3];
+};
+
+#endif /* __INCLUDE_NET_NET_TSTAMP_H */
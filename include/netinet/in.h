@@ -114,6 +114,8 @@
 #define IP_TTL                (__SO_PROTOCOL + 14) /* The IP TTL (time to live)
                                                     * of IP packets sent by the
                                                     * network stack */
+#define IP_RECVERR            (__SO_PROTOCOL + 15) /* Control message of an
+                                                    * error queue entry */
 
 /* SOL_IPV6 protocol-level socket options. */
 
@@ -136,6 +138,20 @@
                                                     * field */
 #define IPV6_RECVHOPLIMIT     (__SO_PROTOCOL + 11) /* Access the hop limit field */
 #define IPV6_HOPLIMIT         (__SO_PROTOCOL + 12) /* Hop limit */
+#define IPV6_RECVERR          (__SO_PROTOCOL + 13) /* Control message of an
+                                                    * error queue entry */
+
+/* Origin of an error queue entry (struct sock_extended_err) */
+
+#define SO_EE_ORIGIN_NONE     0
+#define SO_EE_ORIGIN_LOCAL    1
+#define SO_EE_ORIGIN_ICMP     2
+#define SO_EE_ORIGIN_ICMP6    3
+#define SO_EE_ORIGIN_ZEROCOPY 5
+
+/* ee_code of a SO_EE_ORIGIN_ZEROCOPY entry: the data was copied after all */
+
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
 
 /* Values used with SIOCSIFMCFILTER and SIOCGIFMCFILTER ioctl's */
 
@@ -314,6 +330,22 @@ struct in_pktinfo
   struct in_addr ipi_addr;          /* Header Destination address */
 };
 
+/* The data of an IP_RECVERR or IPV6_RECVERR control message.  For
+ * SO_EE_ORIGIN_ZEROCOPY, the MSG_ZEROCOPY sends ee_info through ee_data
+ * (counted from zero) have completed and their buffers may be reused.
+ */
+
+struct sock_extended_err
+{
+  uint32_t       ee_errno;          /* Error number */
+  uint8_t        ee_origin;         /* Where the error originated */
+  uint8_t        ee_type;           /* Type */
+  uint8_t        ee_code;           /* Code */
+  uint8_t        ee_pad;
+  uint32_t       ee_info;           /* Additional information */
+  uint32_t       ee_data;           /* Other data */
+};
+
 /* IPv6 Internet address */
 
 struct in6_addr
@@ -48,9 +48,28 @@
 
 #define PACKET_ADD_MEMBERSHIP  1 /* Add a multicast address to the interface */
 #define PACKET_DROP_MEMBERSHIP 2 /* Drop a multicast address from the interface */
+#define PACKET_RX_RING         5 /* Map a ring of received frames, struct tpacket_req3 */
+#define PACKET_STATISTICS      6 /* Get and reset struct tpacket_stats_v3 */
+#define PACKET_VERSION        10 /* Ring layout, only TPACKET_V3 */
 
 #define PACKET_MR_MULTICAST    0 /* Multicast address */
 
+/* Status of a ring block, owned by the kernel or by the user */
+
+#define TP_STATUS_KERNEL       0
+#define TP_STATUS_USER         (1 << 0)
+#define TP_STATUS_LOSING       (1 << 2) /* Frames were dropped */
+#define TP_STATUS_BLK_TMO      (1 << 5) /* Retired by the timeout */
+
+#define TPACKET_ALIGNMENT      16
+#define TPACKET_ALIGN(x)       (((x) + TPACKET_ALIGNMENT - 1) & \
+                                ~(TPACKET_ALIGNMENT - 1))
+
+/* The frame header is followed by the struct sockaddr_ll of the frame */
+
+#define TPACKET3_HDRLEN        (TPACKET_ALIGN(sizeof(struct tpacket3_hdr)) + \
+                                sizeof(struct sockaddr_ll))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -74,4 +93,96 @@ struct packet_mreq
   unsigned char  mr_address[8];
 };
 
+/* PACKET_RX_RING: a ring of tp_block_nr blocks of tp_block_size bytes,
+ * mapped with mmap() on the socket.  The kernel fills a block with frames
+ * and hands it to the user when it is full or after tp_retire_blk_tov
+ * milliseconds, the user gives it back by setting block_status to
+ * TP_STATUS_KERNEL.
+ */
+
+enum tpacket_versions
+{
+  TPACKET_V1,
+  TPACKET_V2,
+  TPACKET_V3
+};
+
+struct tpacket_req3
+{
+  unsigned int   tp_block_size;      /* Bytes of a block */
+  unsigned int   tp_block_nr;        /* Number of blocks, 0 to remove */
+  unsigned int   tp_frame_size;      /* Ignored, frames are packed */
+  unsigned int   tp_frame_nr;        /* Ignored */
+  unsigned int   tp_retire_blk_tov;  /* Block timeout in ms, 0 default */
+  unsigned int   tp_sizeof_priv;     /* Private area after the block header */
+  unsigned int   tp_feature_req_word;
+};
+
+struct tpacket_stats_v3
+{
+  unsigned int   tp_packets;         /* Frames received */
+  unsigned int   tp_drops;           /* Frames that did not fit */
+  unsigned int   tp_freeze_q_cnt;    /* Drops as no block was free */
+};
+
+struct tpacket_bd_ts
+{
+  unsigned int   ts_sec;
+  union
+  {
+    unsigned int ts_usec;
+    unsigned int ts_nsec;
+  };
+};
+
+struct tpacket_hdr_v1
+{
+  uint32_t       block_status;
+  uint32_t       num_pkts;
+  uint32_t       offset_to_first_pkt;
+  uint32_t       blk_len;            /* Bytes used in the block */
+  uint64_t       seq_num;
+  struct tpacket_bd_ts ts_first_pkt;
+  struct tpacket_bd_ts ts_last_pkt;
+};
+
+union tpacket_bd_header_u
+{
+  struct tpacket_hdr_v1 bh1;
+};
+
+struct tpacket_block_desc
+{
+  uint32_t       version;
+  uint32_t       offset_to_priv;
+  union tpacket_bd_header_u hdr;
+};
+
+struct tpacket_hdr_variant1
+{
+  uint32_t       tp_rxhash;
+  uint32_t       tp_vlan_tci;
+  uint16_t       tp_vlan_tpid;
+  uint16_t       tp_padding;
+};
+
+/* The header of a frame in a block */
+
+struct tpacket3_hdr
+{
+  uint32_t       tp_next_offset;     /* From this frame, 0 for the last */
+  uint32_t       tp_sec;
+  uint32_t       tp_nsec;
+  uint32_t       tp_snaplen;         /* Bytes in the ring */
+  uint32_t       tp_len;             /* Bytes of the frame on the wire */
+  uint32_t       tp_status;
+  uint16_t       tp_mac;             /* Offset of the link layer header */
+  uint16_t       tp_net;             /* Offset of the network header */
+  union
+  {
+    struct tpacket_hdr_variant1 hv1;
+  };
+  uint8_t        tp_padding[8];
+};
+
 #endif /* __INCLUDE_NETPACKET_PACKET_H */
@@ -124,6 +124,42 @@ struct adc_callback_s
    */
 
   CODE int (*au_reset)(FAR struct adc_dev_s *dev);
+
+#ifdef CONFIG_ADC_BLOCK
+  /* This method is called from the lower half in block mode to get a block
+   * of ad_blkbuf that the hardware may fill, when sampling starts.
+   *
+   * Input Parameters:
+   *   dev  - The ADC device structure that was previously registered by
+   *          adc_register()
+   *
+   * Returned Value:
+   *   The index of the block; a negated errno value if no block is free.
+   */
+
+  CODE int (*au_get_block)(FAR struct adc_dev_s *dev);
+
+  /* This method is called from the lower half in block mode when the
+   * hardware has filled a block.  The data cache over the block must have
+   * been invalidated already.
+   *
+   * Input Parameters:
+   *   dev       - The ADC device structure that was previously registered
+   *               by adc_register()
+   *   index     - The index of the block
+   *   nbytes    - Number of bytes of samples in the block
+   *   timestamp - Time of the last sample of the block in nanoseconds of
+   *               CLOCK_MONOTONIC, or zero to take the time of the call
+   *
+   * Returned Value:
+   *   The index of the block for the hardware to fill next.  This is index
+   *   itself when the reader is behind, the block is dropped then; a
+   *   negated errno value on failure.
+   */
+
+  CODE int (*au_receive_block)(FAR struct adc_dev_s *dev, int index,
+                               size_t nbytes, uint64_t timestamp);
+#endif
 };
 
 /* This describes on ADC message */
@@ -134,6 +170,29 @@ begin_packed_struct struct adc_msg_s
   int32_t      am_data;                  /* ADC convert result (4 bytes) */
 } end_packed_struct;
 
+/* This describes one block filled in block mode, read() returns these.
+ * The samples, in the format of the lower half, are at ab_offset of the
+ * buffer that mmap() maps.  The block belongs to the application until it
+ * is given back with ANIOC_RELEASE_BLOCK.
+ */
+
+struct adc_block_s
+{
+  uint32_t     ab_seq;                   /* Sequence number, gaps are blocks dropped */
+  uint32_t     ab_index;                 /* Index of the block */
+  uint32_t     ab_offset;                /* Offset of the samples in the buffer */
+  uint32_t     ab_nbytes;                /* Number of bytes of samples */
+  uint64_t     ab_timestamp;             /* Time of the last sample in ns */
+};
+
+/* The layout of the buffer of block mode, returned by ANIOC_GET_BLOCKINFO */
+
+struct adc_blockinfo_s
+{
+  uint32_t     ab_blksize;               /* Size of one block in bytes */
+  uint32_t     ab_nblocks;               /* Number of blocks */
+};
+
 /* This describes a FIFO of ADC messages */
 
 struct adc_fifo_s
@@ -198,6 +257,8 @@ struct adc_ops_s
  *
  *   The elements of 'ad_ops', and 'ad_priv'
  *
+ * and, in block mode, 'ad_blkbuf', 'ad_blksize' and 'ad_nblocks'.
+ *
  * The common logic will initialize all semaphores.
  */
 
@@ -207,6 +268,11 @@ struct adc_dev_s
 
   FAR const struct adc_ops_s *ad_ops;        /* Arch-specific operations */
   FAR void                   *ad_priv;       /* Used by the arch-specific logic */
+#ifdef CONFIG_ADC_BLOCK
+  FAR uint8_t                *ad_blkbuf;     /* Block mode buffer, NULL if not used */
+  size_t                      ad_blksize;    /* Size of one block in bytes */
+  uint8_t                     ad_nblocks;    /* Number of blocks in ad_blkbuf */
+#endif
 
 #ifdef CONFIG_ADC
   /* Fields managed by common upper half ADC logic */
@@ -218,6 +284,16 @@ struct adc_dev_s
   struct adc_fifo_s           ad_recv;       /* Describes receive FIFO */
   bool                        ad_isovr;      /* Flag to indicate an ADC overrun */
 
+#ifdef CONFIG_ADC_BLOCK
+  uint32_t                    ad_blkfree;    /* Blocks the hardware may fill */
+  uint32_t                    ad_blkuser;    /* Blocks read, not yet released */
+  uint32_t                    ad_blkseq;     /* Sequence number of the next block */
+  uint8_t                     ad_blkhead;    /* Oldest index in ad_blkready */
+  uint8_t                     ad_nready;     /* Number of blocks in ad_blkready */
+  uint8_t                     ad_blkready[CONFIG_ADC_BLOCK_MAXBLOCKS];
+  struct adc_block_s          ad_blkdesc[CONFIG_ADC_BLOCK_MAXBLOCKS];
+#endif
+
   /* The following is a list of poll structures of threads waiting for
    * driver events.  The 'struct pollfd' reference for each open is also
    * retained in the f_priv field of the 'struct file'.
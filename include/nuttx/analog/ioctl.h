@@ -65,9 +65,19 @@
                                                  * IN: None
                                                  * OUT: Number of samples
                                                  * waiting to be read */
+#define ANIOC_GET_BLOCKINFO     _ANIOC(0x0007)  /* Get the block layout of
+                                                 * the mmap() buffer
+                                                 * IN: Pointer to struct
+                                                 * adc_blockinfo_s
+                                                 * OUT: None */
+#define ANIOC_RELEASE_BLOCK     _ANIOC(0x0008)  /* Give a block returned by
+                                                 * read() back to the
+                                                 * hardware
+                                                 * IN: Block index
+                                                 * OUT: None */
 
 #define AN_FIRST          0x0001          /* First common command */
-#define AN_NCMDS          6               /* Number of common commands */
+#define AN_NCMDS          8               /* Number of common commands */
 
 /* User defined ioctl commands are also supported. These will be forwarded
  * by the upper-half driver to the lower-half driver via the ioctl()
@@ -99,6 +99,17 @@
 #define DEBUGPOINT_BREAKPOINT    0x04
 #define DEBUGPOINT_STEPPOINT     0x05
 
+/* Hardware events that up_pmu_start() may count */
+
+#define PMU_EVENT_NONE           0  /* Counter not in use */
+#define PMU_EVENT_CYCLES         1  /* CPU cycles */
+#define PMU_EVENT_INSTRUCTIONS   2  /* Instructions retired */
+#define PMU_EVENT_CACHE_MISSES   3  /* Data cache misses (refills) */
+#define PMU_EVENT_BRANCH_MISSES  4  /* Mispredicted branches */
+#define PMU_EVENT_STALL_FRONTEND 5  /* Cycles with no instruction to issue */
+#define PMU_EVENT_STALL_BACKEND  6  /* Cycles waiting on the data side */
+#define PMU_EVENT_MAX            7
+
 /* Memory barriers may be provided in arch/spinlock.h
  *
  *   DMB - Data memory barrier.  Assures writes are completed to memory.
@@ -2863,6 +2874,29 @@ clock_t up_perf_gettime(void);
 unsigned long up_perf_getfreq(void);
 void up_perf_convert(clock_t elapsed, FAR struct timespec *ts);
 
+/****************************************************************************
+ * Name: up_pmu_*
+ *
+ * Description:
+ *   The hardware event counters of the calling CPU.  up_pmu_ncounters()
+ *   returns how many counters can be programmed, up_pmu_start() makes
+ *   counter count a PMU_EVENT_* and returns the width of the counter in
+ *   bits, or -ENOTSUP if the core cannot count that event.  up_pmu_read()
+ *   returns the free running value of a started counter, the caller
+ *   handles the wrap around.
+ *
+ *   All of them act on the calling CPU only and are called with the
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_PMU
+int up_pmu_ncounters(void);
+int up_pmu_start(int counter, int event);
+void up_pmu_stop(int counter);
+uint64_t up_pmu_read(int counter);
+#endif
+
 /****************************************************************************
  * Name: up_show_cpuinfo
  *
@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
 #include <nuttx/mutex.h>
 #include <nuttx/spi/spi.h>
@@ -94,6 +95,12 @@
  * AUDIOIOC_STOP - Stop Audio streaming
  *
  *   ioctl argument:  None
+ *
+ * AUDIOIOC_GETPOSITION - Get the hardware position of a mmap()ed stream
+ *
+ *   ioctl argument:  Pointer to a uint64_t to receive the number of bytes
+ *                    the hardware has moved since the stream started.
+ *                    Modulo the ring size it is the offset in the ring.
  */
 
 #define AUDIOIOC_GETCAPS            _AUDIOIOC(1)
@@ -362,6 +369,8 @@
 #define AUDIO_MSG_SLIENCE          11
 #define AUDIO_MSG_UNDERRUN         12
 #define AUDIO_MSG_IOERR            13
+#define AUDIO_MSG_PERIOD           14  /* A period of a mmap()ed ring is done,
+                                        * u.data is the number of periods */
 #define AUDIO_MSG_USER             64
 
 /* Audio Pipeline Buffer flags */
@@ -709,6 +718,14 @@ struct audio_ops_s
 #else
   CODE int (*release)(FAR struct audio_lowerhalf_s *dev);
 #endif
+
+  /* Lower-half logic may let the application map its ring of periods and
+   * stream from it directly, without enqueueing buffers.  Each finished
+   * period is then reported with an AUDIO_MSG_PERIOD message.
+   */
+
+  CODE int (*mmap)(FAR struct audio_lowerhalf_s *dev,
+                   FAR struct mm_map_entry_s *map);
 };
 
 /* This structure is the generic form of state structure used by lower half
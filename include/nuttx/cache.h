@@ -33,6 +33,7 @@
 
 #include <stdint.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -450,6 +451,39 @@ void up_flush_dcache_all(void);
 #  define up_flush_dcache_all()
 #endif
 
+/****************************************************************************
+ * Name: up_invalidate_dcache_iov, up_clean_dcache_iov and
+ *       up_flush_dcache_iov
+ *
+ * Description:
+ *   Invalidate, clean or flush the data cache within a list of regions, as
+ *   up_invalidate_dcache(), up_clean_dcache() and up_flush_dcache() do for
+ *   each of them.  Regions that follow each other are handled as one.
+ *
+ *   If CONFIG_ARCH_DCACHE_ALL_THRESHOLD is not zero and the regions add up
+ *   to at least that many bytes, the entire data cache is cleaned or
+ *   flushed instead.  The entire data cache is flushed in place of an
+ *   invalidation, so that no dirty lines of other memory are lost.
+ *
+ * Input Parameters:
+ *   iov    - The list of regions
+ *   iovcnt - The number of regions in the list
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DCACHE
+void up_invalidate_dcache_iov(FAR const struct iovec *iov, int iovcnt);
+void up_clean_dcache_iov(FAR const struct iovec *iov, int iovcnt);
+void up_flush_dcache_iov(FAR const struct iovec *iov, int iovcnt);
+#else
+#  define up_invalidate_dcache_iov(iov, iovcnt)
+#  define up_clean_dcache_iov(iov, iovcnt)
+#  define up_flush_dcache_iov(iov, iovcnt)
+#endif
+
 /****************************************************************************
  * Name: up_lock_dcache
  *
@@ -852,6 +852,19 @@ int nxclock_gettime(clockid_t clock_id, FAR struct timespec *tp);
 int nxclock_adjtime(clockid_t clock_id, FAR struct timex *buf);
 #endif
 
+/****************************************************************************
+ * Name: nxclock_adjfreq
+ *
+ * Description:
+ *   Set the frequency offset of the system clock in parts per billion, on
+ *   top of which the slews of adjtime() are applied.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CLOCK_ADJTIME
+int nxclock_adjfreq(long ppb);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
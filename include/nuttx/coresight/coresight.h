@@ -27,6 +27,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <nuttx/clk/clk.h>
 #include <nuttx/list.h>
@@ -79,6 +80,23 @@ union coresight_dev_subtype_u
   enum coresight_dev_subtype_sink_e sink_subtype;
 };
 
+/* Instruction trace filter of the source devices that support it */
+
+enum coresight_filter_mode_e
+{
+  CORESIGHT_FILTER_NONE,         /* Trace everything */
+  CORESIGHT_FILTER_RANGE,        /* Trace only inside [start, end) */
+  CORESIGHT_FILTER_STARTSTOP,    /* Trace from start until end executes */
+};
+
+struct coresight_filter_s
+{
+  enum coresight_filter_mode_e mode;
+  uintptr_t start;
+  uintptr_t end;
+  bool cycacc;                   /* Cycle accurate trace */
+};
+
 struct coresight_dev_s;
 
 struct coresight_sink_ops_s
@@ -97,6 +115,11 @@ struct coresight_source_ops_s
 {
   int (*enable)(FAR struct coresight_dev_s *csdev);
   void (*disable)(FAR struct coresight_dev_s *csdev);
+
+  /* Optional, set the filter used by the next enable. */
+
+  int (*filter)(FAR struct coresight_dev_s *csdev,
+                FAR const struct coresight_filter_s *filter);
 };
 
 /* This structure is used to unify different operations of devices. */
@@ -0,0 +1,94 @@
+/****************************************************************************
+ * include/nuttx/coresight/coresight_capture.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CORESIGHT_CORESIGHT_CAPTURE_H
+#define __INCLUDE_NUTTX_CORESIGHT_CORESIGHT_CAPTURE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <sys/types.h>
+
+#include <nuttx/coresight/coresight.h>
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: coresight_capture_start
+ *
+ * Description:
+ *   Set the filter of the source and enable the trace path from the
+ *   source to the sink.  The ETB and TMC sinks keep the trace in a
+ *   circular buffer, the latest trace is kept until the capture is
+ *   dumped.
+ *
+ * Input Parameters:
+ *   srcdev  - The ETM of the CPU to trace.
+ *   sinkdev - The ETB or TMC sink that keeps the trace.
+ *   filter  - The trace filter, NULL to trace everything.
+ *
+ * Returned Value:
+ *   Zero on success; a negative value on failure, -ENOTSUP if the source
+ *   does not support the filter.
+ *
+ ****************************************************************************/
+
+int coresight_capture_start(FAR struct coresight_dev_s *srcdev,
+                            FAR struct coresight_dev_s *sinkdev,
+                            FAR const struct coresight_filter_s *filter);
+
+/****************************************************************************
+ * Name: coresight_capture_stop
+ *
+ * Description:
+ *   Disable the trace path of the source, the trace stays in the sink.
+ *
+ * Input Parameters:
+ *   srcdev  - The ETM of coresight_capture_start().
+ *
+ ****************************************************************************/
+
+void coresight_capture_stop(FAR struct coresight_dev_s *srcdev);
+
+/****************************************************************************
+ * Name: coresight_capture_dump
+ *
+ * Description:
+ *   Write the raw trace of the sink to a file for offline decoding, with
+ *   OpenCSD for example.
+ *
+ * Input Parameters:
+ *   sinkdev - The sink of coresight_capture_start().
+ *   path    - The file to create or truncate.
+ *
+ * Returned Value:
+ *   The number of bytes written on success; a negative value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t coresight_capture_dump(FAR struct coresight_dev_s *sinkdev,
+                               FAR const char *path);
+
+#endif /* __INCLUDE_NUTTX_CORESIGHT_CORESIGHT_CAPTURE_H */
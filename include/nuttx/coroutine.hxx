@@ -0,0 +1,542 @@
+//***************************************************************************
+// include/nuttx/coroutine.hxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+//
+//***************************************************************************
+
+#ifndef __INCLUDE_NUTTX_COROUTINE_HXX
+#define __INCLUDE_NUTTX_COROUTINE_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <coroutine>
+#include <utility>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <nuttx/mutex.h>
+#include <nuttx/wqueue.h>
+
+#if defined(CONFIG_SCHED_WORKQUEUE) || defined(CONFIG_LIBC_USRWORK)
+
+//***************************************************************************
+// Public Types
+//***************************************************************************
+
+// C++20 coroutines that run on the work queues.  A coroutine is resumed by
+// a work item of its executor, so thousands of them share the worker
+// threads instead of having a thread and a stack each.  A coroutine must
+// not block the worker: it waits with co_await on the awaitables below.
+//
+//   nuttx::coro::task handler(nuttx::coro::reactor &r, int fd)
+//   {
+//     while (co_await r.readable(fd) > 0)
+//       {
+//         ...read(fd, ...) without blocking...
+//       }
+//   }
+//
+//   exec.spawn(handler(r, fd));
+
+namespace nuttx
+{
+namespace coro
+{
+  // Resume the coroutine of a work item
+
+  inline void resume_worker(FAR void *arg)
+  {
+    std::coroutine_handle<>::from_address(arg).resume();
+  }
+
+  // A coroutine that runs once it is spawned on an executor and frees
+  // itself when it returns.  A task that is never spawned is freed with
+  // the task object.
+
+  class task
+  {
+  public:
+    struct promise_type
+    {
+      task get_return_object() noexcept
+      {
+        return task(std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+
+      std::suspend_always initial_suspend() const noexcept
+      {
+        return {};
+      }
+
+      std::suspend_never final_suspend() const noexcept
+      {
+        return {};
+      }
+
+      void return_void() const noexcept
+      {
+      }
+
+      void unhandled_exception() const noexcept
+      {
+        PANIC();
+      }
+
+      struct work_s work {};       // Starts the coroutine
+    };
+
+    task(task &&other) noexcept
+      : m_handle(std::exchange(other.m_handle, nullptr))
+    {
+    }
+
+    ~task()
+    {
+      if (m_handle)
+        {
+          m_handle.destroy();
+        }
+    }
+
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+    task &operator=(task &&) = delete;
+
+    // Give up the coroutine to whoever starts it
+
+    std::coroutine_handle<promise_type> release() noexcept
+    {
+      return std::exchange(m_handle, nullptr);
+    }
+
+  private:
+    explicit task(std::coroutine_handle<promise_type> handle) noexcept
+      : m_handle(handle)
+    {
+    }
+
+    std::coroutine_handle<promise_type> m_handle;
+  };
+
+  // Where coroutines run: the work queue qid, or the per-CPU work queue of
+  // that class served by cpu.  An executor is a value, copies of it run on
+  // the same queue.
+
+  class executor
+  {
+  public:
+    static constexpr int any_cpu = -1;
+
+    struct awaiter;
+
+    constexpr explicit executor(int qid = LPWORK, int cpu = any_cpu) noexcept
+      : m_qid(qid), m_cpu(cpu)
+    {
+    }
+
+    int qid() const noexcept
+    {
+      return m_qid;
+    }
+
+    int cpu() const noexcept
+    {
+      return m_cpu;
+    }
+
+    // Queue one work item on the queue of the executor
+
+    int post(FAR struct work_s *work, worker_t worker, FAR void *arg,
+             clock_t delay = 0) const noexcept
+    {
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      if (m_cpu != any_cpu)
+        {
+          return work_queue_cpu(m_qid, m_cpu, work, worker, arg, delay);
+        }
+#endif
+
+      return work_queue(m_qid, work, worker, arg, delay);
+    }
+
+    // Start a coroutine, it runs until its first co_await on a worker
+
+    void spawn(task &&t) const noexcept
+    {
+      std::coroutine_handle<task::promise_type> handle = t.release();
+      int ret;
+
+      ret = post(&handle.promise().work, resume_worker, handle.address());
+      DEBUGASSERT(ret >= 0);
+      UNUSED(ret);
+    }
+
+    // co_await exec.schedule() moves the coroutine onto the executor
+
+    awaiter schedule() const noexcept;
+
+    // co_await exec.sleep_for(ticks) resumes after the delay
+
+    awaiter sleep_for(clock_t ticks) const noexcept;
+
+  private:
+    int m_qid;
+    int m_cpu;
+  };
+
+  // Suspends the coroutine and resumes it on the executor after delay
+  // ticks, the work queue times the delay with a watchdog
+
+  struct executor::awaiter
+  {
+    executor exec;
+    clock_t delay;
+    struct work_s work;
+
+    bool await_ready() const noexcept
+    {
+      return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) noexcept
+    {
+      int ret = exec.post(&work, resume_worker, handle.address(), delay);
+
+      DEBUGASSERT(ret >= 0);
+      UNUSED(ret);
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+  };
+
+  inline executor::awaiter executor::schedule() const noexcept
+  {
+    return awaiter{*this, 0, {}};
+  }
+
+  inline executor::awaiter executor::sleep_for(clock_t ticks) const noexcept
+  {
+    return awaiter{*this, ticks, {}};
+  }
+
+  // A counting semaphore for coroutines.  acquire() suspends the
+  // coroutine instead of the worker until release(), the waiters are
+  // resumed on the executor in FIFO order.  release() may be called from
+  // any thread, not from interrupt handlers.
+
+  class semaphore
+  {
+  public:
+    struct awaiter
+    {
+      FAR semaphore *sem;
+      FAR awaiter *next;
+      std::coroutine_handle<> handle;
+      struct work_s work;
+
+      bool await_ready() noexcept
+      {
+        return sem->try_acquire();
+      }
+
+      bool await_suspend(std::coroutine_handle<> h) noexcept
+      {
+        return sem->enqueue(this, h);
+      }
+
+      void await_resume() const noexcept
+      {
+      }
+    };
+
+    explicit semaphore(executor exec, unsigned int count = 0) noexcept
+      : m_exec(exec), m_count(count), m_head(nullptr), m_tail(nullptr)
+    {
+      nxmutex_init(&m_lock);
+    }
+
+    ~semaphore()
+    {
+      DEBUGASSERT(m_head == nullptr);
+      nxmutex_destroy(&m_lock);
+    }
+
+    semaphore(const semaphore &) = delete;
+    semaphore &operator=(const semaphore &) = delete;
+
+    awaiter acquire() noexcept
+    {
+      return awaiter{this, nullptr, nullptr, {}};
+    }
+
+    bool try_acquire() noexcept
+    {
+      bool ret = false;
+
+      nxmutex_lock(&m_lock);
+      if (m_count > 0)
+        {
+          m_count--;
+          ret = true;
+        }
+
+      nxmutex_unlock(&m_lock);
+      return ret;
+    }
+
+    void release() noexcept
+    {
+      FAR awaiter *waiter;
+      int ret;
+
+      nxmutex_lock(&m_lock);
+      waiter = m_head;
+      if (waiter == nullptr)
+        {
+          m_count++;
+          nxmutex_unlock(&m_lock);
+          return;
+        }
+
+      m_head = waiter->next;
+      if (m_head == nullptr)
+        {
+          m_tail = nullptr;
+        }
+
+      nxmutex_unlock(&m_lock);
+
+      ret = m_exec.post(&waiter->work, resume_worker,
+                        waiter->handle.address());
+      DEBUGASSERT(ret >= 0);
+      UNUSED(ret);
+    }
+
+  private:
+    // Queue the waiter unless a release() came in since await_ready()
+
+    bool enqueue(FAR awaiter *waiter, std::coroutine_handle<> h) noexcept
+    {
+      nxmutex_lock(&m_lock);
+      if (m_count > 0)
+        {
+          m_count--;
+          nxmutex_unlock(&m_lock);
+          return false;
+        }
+
+      waiter->handle = h;
+      if (m_tail != nullptr)
+        {
+          m_tail->next = waiter;
+        }
+      else
+        {
+          m_head = waiter;
+        }
+
+      m_tail = waiter;
+      nxmutex_unlock(&m_lock);
+      return true;
+    }
+
+    executor m_exec;
+    unsigned int m_count;
+    FAR awaiter *m_head;
+    FAR awaiter *m_tail;
+    mutex_t m_lock;
+  };
+
+#ifdef CONFIG_EVENT_FD
+  // Readiness of file descriptors for coroutines.  One thread waits with
+  // epoll for the fds of all the coroutines and resumes each of them on
+  // the executor when its fd is ready.  Only one coroutine may wait for an
+  // fd at a time, forget() an fd before it is closed.  Message queues are
+  // fds too, so co_await readable(mqd) and mq_receive() with O_NONBLOCK
+  // receive without blocking the worker.
+
+  class reactor
+  {
+  public:
+    // co_await returns the ready events or a negated errno value
+
+    struct awaiter
+    {
+      FAR reactor *r;
+      int fd;
+      uint32_t events;
+      int result;
+      std::coroutine_handle<> handle;
+      struct work_s work;
+
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      bool await_suspend(std::coroutine_handle<> h) noexcept
+      {
+        int ret;
+
+        /* Once armed, the loop may resume the coroutine and destroy the
+         * awaiter, so it is not touched after a successful arm.
+         */
+
+        handle = h;
+        ret = r->arm(this);
+        if (ret < 0)
+          {
+            result = ret;
+            return false;
+          }
+
+        return true;
+      }
+
+      int await_resume() const noexcept
+      {
+        return result;
+      }
+    };
+
+    explicit reactor(executor exec, int priority = 100,
+                     size_t stacksize = 2048)
+      : m_exec(exec), m_thread()
+    {
+      struct epoll_event ev;
+      pthread_attr_t attr;
+      struct sched_param param;
+
+      m_epfd = epoll_create1(EPOLL_CLOEXEC);
+      m_evfd = eventfd(0, EFD_CLOEXEC);
+      DEBUGASSERT(m_epfd >= 0 && m_evfd >= 0);
+
+      ev.events   = EPOLLIN;
+      ev.data.ptr = nullptr;
+      epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_evfd, &ev);
+
+      pthread_attr_init(&attr);
+      pthread_attr_setstacksize(&attr, stacksize);
+      param.sched_priority = priority;
+      pthread_attr_setschedparam(&attr, &param);
+      pthread_create(&m_thread, &attr, loop, this);
+      pthread_attr_destroy(&attr);
+    }
+
+    // No coroutine may be waiting any more
+
+    ~reactor()
+    {
+      eventfd_write(m_evfd, 1);
+      pthread_join(m_thread, nullptr);
+      close(m_evfd);
+      close(m_epfd);
+    }
+
+    reactor(const reactor &) = delete;
+    reactor &operator=(const reactor &) = delete;
+
+    awaiter wait(int fd, uint32_t events) noexcept
+    {
+      return awaiter{this, fd, events, 0, nullptr, {}};
+    }
+
+    awaiter readable(int fd) noexcept
+    {
+      return wait(fd, EPOLLIN);
+    }
+
+    awaiter writable(int fd) noexcept
+    {
+      return wait(fd, EPOLLOUT);
+    }
+
+    int forget(int fd) noexcept
+    {
+      return epoll_ctl(m_epfd, EPOLL_CTL_DEL, fd, nullptr) < 0 ? -errno : 0;
+    }
+
+  private:
+    // Wait for one event of the fd, re-arming it if it was waited for
+    // before
+
+    int arm(FAR awaiter *waiter) noexcept
+    {
+      struct epoll_event ev;
+
+      ev.events   = waiter->events | EPOLLONESHOT;
+      ev.data.ptr = waiter;
+
+      if (epoll_ctl(m_epfd, EPOLL_CTL_MOD, waiter->fd, &ev) < 0 &&
+          (errno != ENOENT ||
+           epoll_ctl(m_epfd, EPOLL_CTL_ADD, waiter->fd, &ev) < 0))
+        {
+          return -errno;
+        }
+
+      return 0;
+    }
+
+    static FAR void *loop(FAR void *arg)
+    {
+      FAR reactor *self = static_cast<FAR reactor *>(arg);
+      struct epoll_event evs[8];
+      FAR awaiter *waiter;
+      int ret;
+      int i;
+
+      for (; ; )
+        {
+          ret = epoll_wait(self->m_epfd, evs, 8, -1);
+          for (i = 0; i < ret; i++)
+            {
+              waiter = static_cast<FAR awaiter *>(evs[i].data.ptr);
+              if (waiter == nullptr)
+                {
+                  return nullptr;
+                }
+
+              waiter->result = evs[i].events;
+              self->m_exec.post(&waiter->work, resume_worker,
+                                waiter->handle.address());
+            }
+        }
+    }
+
+    executor m_exec;
+    pthread_t m_thread;
+    int m_epfd;
+    int m_evfd;
+  };
+#endif // CONFIG_EVENT_FD
+} // namespace coro
+} // namespace nuttx
+
+#endif // CONFIG_SCHED_WORKQUEUE || CONFIG_LIBC_USRWORK
+#endif // __INCLUDE_NUTTX_COROUTINE_HXX
@@ -325,4 +325,81 @@ struct dma_dev_s
                         FAR struct dma_chan_s *chan);
 };
 
+#ifdef CONFIG_DMA_MEMCPY
+/* This is the type of the callback that informs the user of the completion
+ * of dma_memcpy_async().  len is the length copied or a negative error
+ * code.  It may be called from the DMA interrupt handler.
+ */
+
+typedef CODE void (*dma_memcpy_callback_t)(FAR void *arg, ssize_t len);
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_DMA_MEMCPY
+
+/****************************************************************************
+ * Name: dma_memcpy_register
+ *
+ * Description:
+ *   Give a memory to memory channel of a DMA device to the memcpy offload.
+ *   The channel is taken with DMA_GET_CHAN() and kept from then on.
+ *
+ * Input Parameters:
+ *   dev   - The DMA device
+ *   ident - Identifies the channel resource
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int dma_memcpy_register(FAR struct dma_dev_s *dev, unsigned int ident);
+
+/****************************************************************************
+ * Name: dma_memcpy_async
+ *
+ * Description:
+ *   Start copying len bytes from src to dst on a free registered channel.
+ *   The data cache is cleaned and invalidated as needed, the buffers must
+ *   not be touched until callback is called.
+ *
+ * Returned Value:
+ *   Zero (OK) if the copy was started; a negated errno value otherwise,
+ *   -EBUSY if no channel is free.
+ *
+ ****************************************************************************/
+
+int dma_memcpy_async(FAR void *dst, FAR const void *src, size_t len,
+                     dma_memcpy_callback_t callback, FAR void *arg);
+
+/****************************************************************************
+ * Name: dma_memcpy
+ *
+ * Description:
+ *   memcpy() that waits for a DMA channel to do the copy if it is at least
+ *   CONFIG_DMA_MEMCPY_THRESHOLD bytes, the CPU does it otherwise or if
+ *   no channel can.
+ *
+ ****************************************************************************/
+
+FAR void *dma_memcpy(FAR void *dst, FAR const void *src, size_t len);
+
+#endif /* CONFIG_DMA_MEMCPY */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __INCLUDE_NUTTX_DMA_DMA_H */
@@ -94,6 +94,18 @@ void devnull_register(void);
 void devascii_register(void);
 #endif
 
+/****************************************************************************
+ * Name: devkbench_register
+ *
+ * Description:
+ *   Register /dev/kbench
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DEV_KBENCH
+void devkbench_register(void);
+#endif
+
 /****************************************************************************
  * Name: devrandom_register
  *
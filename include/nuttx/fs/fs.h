@@ -145,6 +145,9 @@
 #define INODE_IS_PIPE(i)       INODE_IS_TYPE(i,FSNODEFLAG_TYPE_PIPE)
 #define INODE_IS_NAMEDEVENT(i) INODE_IS_TYPE(i,FSNODEFLAG_TYPE_NAMEDEVENT)
 
+#define INODE_IS_STORAGE(i) \
+  (INODE_IS_MOUNTPT(i) || INODE_IS_BLOCK(i) || INODE_IS_MTD(i))
+
 #define INODE_GET_TYPE(i)     ((i)->i_flags & FSNODEFLAG_TYPE_MASK)
 #define INODE_SET_TYPE(i,t) \
   do \
@@ -187,6 +190,7 @@ struct inode;
 struct stat;
 struct statfs;
 struct pollfd;
+struct tcb_s;
 struct mtd_dev_s;
 struct uio;
 
@@ -259,6 +263,16 @@ struct file_operations
  */
 
 struct inode;
+
+/* One range of sectors of a vectored block transfer and its buffer */
+
+struct blkvec_s
+{
+  FAR unsigned char *buffer;   /* nsectors * sector size bytes */
+  blkcnt_t           start;    /* First sector of the range */
+  unsigned int       nsectors; /* Number of sectors of the range */
+};
+
 struct block_operations
 {
   CODE int     (*open)(FAR struct inode *inode);
@@ -274,6 +288,17 @@ struct block_operations
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   CODE int     (*unlink)(FAR struct inode *inode);
 #endif
+
+  /* Optional vectored transfers.  'vec' is sorted by sector and adjacent
+   * ranges with contiguous buffers are merged when called through
+   * block_readv() and block_writev().  Return the number of sectors
+   * transferred or a negated errno value.
+   */
+
+  CODE ssize_t (*readv)(FAR struct inode *inode,
+                        FAR const struct blkvec_s *vec, int nvec);
+  CODE ssize_t (*writev)(FAR struct inode *inode,
+                         FAR const struct blkvec_s *vec, int nvec);
 };
 
 /* This structure is provided by a filesystem to describe a mount point.
@@ -464,6 +489,12 @@ struct file
 #if CONFIG_FS_LOCK_BUCKET_SIZE > 0
   bool              f_locked;   /* Filelock state: false - unlocked, true - locked */
 #endif
+#ifdef CONFIG_FS_PAGECACHE
+  FAR void         *f_pcache;   /* Page cache of the file, see fs_pagecache.c */
+#endif
+#ifdef CONFIG_FS_NOTIFY
+  uint32_t          f_notifygen; /* Not watched in this generation, see fs_inotify.c */
+#endif
 };
 
 struct fd
@@ -490,7 +521,7 @@ struct fd
 
 struct fdlist
 {
-  spinlock_t        fl_lock;    /* Manage access to the file descriptor list */
+  spinlock_t        fl_lock;    /* Serializes the changes of the list */
   uint8_t           fl_rows;    /* The number of rows of fl_fds array */
   FAR struct fd   **fl_fds;     /* The pointer of two layer file descriptors array */
 
@@ -738,6 +769,55 @@ int register_blockpartition(FAR const char *partition,
                             off_t firstsector, off_t nsectors);
 #endif
 
+/****************************************************************************
+ * Name: register_blocksnapshot
+ *
+ * Description:
+ *   Register a copy-on-write snapshot of a block driver.  The snapshot
+ *   reads as the origin until it is written, the changed sectors are kept
+ *   in the store and the origin is not modified.  BIOC_SNAPDROP rolls the
+ *   snapshot back, BIOC_SNAPMERGE writes the changes to the origin.
+ *
+ * Input Parameters:
+ *   snapshot - The path to the snapshot inode
+ *   mode     - The access mode of the snapshot inode
+ *   origin   - The path to the block driver the snapshot is taken of
+ *   store    - The path to the block driver that holds the changed
+ *              sectors, with the sector size of the origin
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKSNAPSHOT
+int register_blocksnapshot(FAR const char *snapshot, mode_t mode,
+                           FAR const char *origin, FAR const char *store);
+#endif
+
+/****************************************************************************
+ * Name: register_blockiosched
+ *
+ * Description:
+ *   Register a block driver that passes the requests on to another one,
+ *   scheduled by the priority of the calling threads and split in chunks
+ *   of CONFIG_FS_BLOCKIOSCHED_CHUNK sectors.
+ *
+ * Input Parameters:
+ *   path   - The path to the new inode
+ *   mode   - The access mode of the new inode
+ *   origin - The path to the block driver the requests go to
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_BLOCKIOSCHED
+int register_blockiosched(FAR const char *path, mode_t mode,
+                          FAR const char *origin);
+#endif
+
 /****************************************************************************
  * Name: unregister_driver
  *
@@ -1450,6 +1530,34 @@ int close_blockdriver(FAR struct inode *inode);
 int find_blockdriver(FAR const char *pathname, int mountflags,
                      FAR struct inode **ppinode);
 
+/****************************************************************************
+ * Name: block_readv/block_writev
+ *
+ * Description:
+ *   Transfer several ranges of sectors of a block driver as one batch.
+ *   The ranges are put in sector order, as an elevator would, and merged
+ *   when they are adjacent and their buffers are contiguous.  Then they
+ *   are passed to the readv/writev method of the driver, or to its
+ *   read/write method one range at a time if it has none.
+ *
+ * Input Parameters:
+ *   inode - The inode of the block driver
+ *   vec   - The ranges.  The array is reordered and compacted in place.
+ *   nvec  - The number of ranges
+ *
+ * Returned Value:
+ *   The number of sectors transferred, or a negated errno value if none
+ *   was.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+ssize_t block_readv(FAR struct inode *inode, FAR struct blkvec_s *vec,
+                    int nvec);
+ssize_t block_writev(FAR struct inode *inode, FAR struct blkvec_s *vec,
+                     int nvec);
+#endif
+
 /****************************************************************************
  * Name: find_mtddriver
  *
@@ -1636,6 +1744,21 @@ ssize_t file_pwrite(FAR struct file *filep, FAR const void *buf,
 ssize_t file_sendfile(FAR struct file *outfile, FAR struct file *infile,
                       FAR off_t *offset, size_t count);
 
+/****************************************************************************
+ * Name: file_splice and file_tee
+ *
+ * Description:
+ *   Equivalent to the standard splice and tee functions except that they
+ *   accept struct file instances instead of file descriptors.
+ *
+ ****************************************************************************/
+
+ssize_t file_splice(FAR struct file *infile, FAR off_t *off_in,
+                    FAR struct file *outfile, FAR off_t *off_out,
+                    size_t len, unsigned int flags);
+ssize_t file_tee(FAR struct file *infile, FAR struct file *outfile,
+                 size_t len, unsigned int flags);
+
 /****************************************************************************
  * Name: file_seek
  *
@@ -1713,6 +1836,28 @@ int file_truncate(FAR struct file *filep, off_t length);
 int file_mmap(FAR struct file *filep, FAR void *start, size_t length,
               int prot, int flags, off_t offset, FAR void **mapped);
 
+/****************************************************************************
+ * Name: filemap_fault
+ *
+ * Description:
+ *   Resolve a page fault on a demand paged file mapping of the current
+ *   process.  This is called by the page fault exception handler of the
+ *   architecture.  If the page is not resident, the current task is
+ *   stopped until the page has been read, and then retries the access.
+ *
+ * Input Parameters:
+ *   vaddr - The faulting virtual address
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the task may retry the access; a negated
+ *   errno value if the fault is fatal for the task.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_FILEMAP
+int filemap_fault(uintptr_t vaddr);
+#endif
+
 /****************************************************************************
  * Name: file_mummap
  *
@@ -1785,6 +1930,43 @@ int file_fcntl(FAR struct file *filep, int cmd, ...);
 
 int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: poll_cache_release
+ *
+ * Description:
+ *   Teardown and free the cached poll set of a thread.  This is called when
+ *   the thread exits.
+ *
+ * Input Parameters:
+ *   tcb - The thread
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+void poll_cache_release(FAR struct tcb_s *tcb);
+#endif
+
+/****************************************************************************
+ * Name: poll_cache_close
+ *
+ * Description:
+ *   Drop the cached poll set of the calling thread if it contains fd.
+ *
+ * Input Parameters:
+ *   fd - The file descriptor being closed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+void poll_cache_close(int fd);
+#endif
+
 /****************************************************************************
  * Name: file_fstat
  *
@@ -1910,6 +2092,31 @@ int nx_unlink(FAR const char *pathname);
 int file_pipe(FAR struct file *filep[2], size_t bufsize, int flags);
 #endif
 
+/****************************************************************************
+ * Name: file_ispipe, pipe_splice_from and pipe_splice_to
+ *
+ * Description:
+ *   The pipe side of splice() and tee().  file_ispipe() returns true if
+ *   'filep' is a pipe or FIFO.  pipe_splice_from() writes the data in the
+ *   pipe buffer to 'filep' and, unless 'tee' is true, removes it from the
+ *   pipe.  pipe_splice_to() reads from 'filep' straight into the pipe
+ *   buffer.
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero at end of file, or a negated errno
+ *   value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PIPES
+bool file_ispipe(FAR struct file *filep);
+ssize_t pipe_splice_from(FAR struct file *pipe, FAR struct file *filep,
+                         FAR off_t *offset, size_t len, unsigned int flags,
+                         bool tee);
+ssize_t pipe_splice_to(FAR struct file *pipe, FAR struct file *filep,
+                       FAR off_t *offset, size_t len, unsigned int flags);
+#endif
+
 /****************************************************************************
  * Name: nx_mkfifo
  *
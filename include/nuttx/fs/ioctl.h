@@ -113,6 +113,7 @@
 #define _1WIREBASE      (0x4500) /* 1WIRE ioctl commands */
 #define _EEPIOCBASE     (0x4600) /* EEPROM driver ioctl commands */
 #define _PTPBASE        (0x4700) /* PTP ioctl commands */
+#define _INPUTIOCBASE   (0x4800) /* Input event buffer ioctl commands */
 #define _WLIOCBASE      (0x8b00) /* Wireless modules ioctl network commands */
 
 /* boardctl() commands share the same number space */
@@ -366,6 +367,27 @@
                                            * IN:  None
                                            * OUT: None (ioctl return value provides
                                            *      success/failure indication). */
+#define BIOC_TRIM       _BIOC(0x0012)     /* Tell the block device that the
+                                           * content of a range of sectors is
+                                           * no longer needed.
+                                           * IN:  Pointer to struct blk_trim_s
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
+#define BIOC_SNAPINFO   _BIOC(0x0013)     /* Get the state of a block snapshot
+                                           * IN:  Pointer to writable struct
+                                           *      blk_snapinfo_s
+                                           * OUT: Data return in user-provided
+                                           *      buffer. */
+#define BIOC_SNAPDROP   _BIOC(0x0014)     /* Drop the changes of a block snapshot,
+                                           * it reads as its origin again.
+                                           * IN:  None
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
+#define BIOC_SNAPMERGE  _BIOC(0x0015)     /* Write the changes of a block snapshot
+                                           * to its origin and drop them.
+                                           * IN:  None
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -807,6 +829,13 @@
 #define _PTPIOCVALID(c)       (_IOC_TYPE(c)==_PTPBASE)
 #define _PTPIOC(nr)           _IOC(_PTPBASE,nr)
 
+/* Input event buffer ioctl definitions *************************************/
+
+/* see nuttx/include/input/input_buffer.h */
+
+#define _INPUTIOCVALID(c)     (_IOC_TYPE(c)==_INPUTIOCBASE)
+#define _INPUTIOC(nr)         _IOC(_INPUTIOCBASE,nr)
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -838,6 +867,23 @@ struct partition_info_s
   char      parent[NAME_MAX + 1];
 };
 
+/* Argument of BIOC_TRIM */
+
+struct blk_trim_s
+{
+  blkcnt_t  startsector;  /* First sector of the range */
+  blkcnt_t  nsectors;     /* Number of sectors in the range */
+};
+
+/* Argument of BIOC_SNAPINFO */
+
+struct blk_snapinfo_s
+{
+  blkcnt_t  nsectors;     /* Number of sectors of the origin */
+  blkcnt_t  nslots;       /* Number of sectors of the store */
+  blkcnt_t  nchanged;     /* Number of changed sectors held in the store */
+};
+
 struct pipe_peek_s
 {
   FAR void *buf;
@@ -0,0 +1,142 @@
+/****************************************************************************
+ * include/nuttx/ftrace.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_FTRACE_H
+#define __INCLUDE_NUTTX_FTRACE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef CONFIG_SCHED_FTRACE
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The kinds of records */
+
+enum ftrace_type_e
+{
+  FTRACE_ENTER = 0,    /* Function entry, time of the entry */
+  FTRACE_EXIT,         /* Function exit, time of the exit */
+  FTRACE_GRAPH         /* Function exit in graph mode, with the duration */
+};
+
+/* One record of the function tracer, the times are up_perf_gettime() */
+
+struct ftrace_entry_s
+{
+  uintptr_t func;      /* The function */
+  uintptr_t call_site; /* Where it was called from */
+  clock_t   time;      /* Entry or exit, the entry in graph mode */
+  clock_t   duration;  /* Graph mode, time from entry to exit */
+  pid_t     pid;       /* The running task */
+  uint8_t   type;      /* See enum ftrace_type_e */
+  uint8_t   depth;     /* Traced functions of the task entered before */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: ftrace_initialize
+ *
+ * Description:
+ *   Register the function tracer with the instrumentation.  Tracing starts
+ *   with the "on" command.
+ *
+ ****************************************************************************/
+
+void ftrace_initialize(void);
+
+/****************************************************************************
+ * Name: ftrace_command
+ *
+ * Description:
+ *   Control the tracer with one command:
+ *
+ *     on | off        Start or stop recording
+ *     function        Record each entry and exit
+ *     graph           Record each exit with the duration of the call
+ *     filter <func>   Only trace the functions of the filters
+ *     notrace <func>  Never trace the function
+ *     clear           Drop the records and the filters
+ *
+ *   <func> is a symbol name with CONFIG_ALLSYMS, or an address range
+ *   "<start> <end>", e.g. the text of a module.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int ftrace_command(FAR const char *cmd);
+
+/****************************************************************************
+ * Name: ftrace_pause
+ *
+ * Description:
+ *   Stop recording while the records are read, without changing the "on"
+ *   or "off" state.  Calls nest.
+ *
+ ****************************************************************************/
+
+void ftrace_pause(bool pause);
+
+/****************************************************************************
+ * Name: ftrace_read
+ *
+ * Description:
+ *   Read the records of cpu from the oldest on.  *pos is zero for the
+ *   first and is advanced.
+ *
+ * Returned Value:
+ *   True if a record was read, false once there are no more.
+ *
+ ****************************************************************************/
+
+bool ftrace_read(int cpu, FAR size_t *pos, FAR struct ftrace_entry_s *entry);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_SCHED_FTRACE */
+#endif /* __INCLUDE_NUTTX_FTRACE_H */
@@ -0,0 +1,171 @@
+/****************************************************************************
+ * include/nuttx/hashmap.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_HASHMAP_H
+#define __INCLUDE_NUTTX_HASHMAP_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Returns true if the entry has the key */
+
+typedef CODE bool (*hashmap_match_t)(FAR const void *entry,
+                                     FAR const void *key);
+
+/* Called for each entry by hashmap_foreach() */
+
+typedef CODE void (*hashmap_foreach_t)(FAR void *entry, FAR void *arg);
+
+/* A slot keeps the hash of its entry, the entries are only compared when
+ * the hashes are equal.
+ */
+
+struct hashmap_slot_s
+{
+  uint32_t hash;
+  FAR void *entry;                  /* NULL if the slot is free */
+};
+
+/* An open addressing hash table of entry pointers with Robin Hood probing.
+ * The table doubles before it is 7/8 full, the slots of the previous table
+ * are moved a few at a time by the following insertions and removals, so
+ * that no single operation pays for the whole table.  The entries do not
+ * move, only the pointers to them.  A zeroed hashmap_s is an uninitialized
+ * table.  The table does no locking.
+ */
+
+struct hashmap_s
+{
+  FAR struct hashmap_slot_s *slots; /* The current table */
+  FAR struct hashmap_slot_s *old;   /* The table being moved, or NULL */
+  hashmap_match_t match;
+  size_t mask;                      /* Slots of the current table - 1 */
+  size_t oldmask;                   /* Slots of the old table - 1 */
+  size_t cursor;                    /* Next slot of the old table to move */
+  size_t count;                     /* Entries in both tables */
+  size_t maxdist;                   /* Longest probe of the current table */
+  size_t oldmaxdist;                /* Longest probe of the old table */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: hashmap_init
+ *
+ * Description:
+ *   Initialize a table with room for nel entries before it grows.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOMEM if out of memory.
+ *
+ ****************************************************************************/
+
+int hashmap_init(FAR struct hashmap_s *map, size_t nel,
+                 hashmap_match_t match);
+
+/****************************************************************************
+ * Name: hashmap_deinit
+ *
+ * Description:
+ *   Free the slots of a table, not the entries.
+ *
+ ****************************************************************************/
+
+void hashmap_deinit(FAR struct hashmap_s *map);
+
+/****************************************************************************
+ * Name: hashmap_find
+ *
+ * Description:
+ *   Return the entry with the hash and the key, or NULL.
+ *
+ ****************************************************************************/
+
+FAR void *hashmap_find(FAR const struct hashmap_s *map, uint32_t hash,
+                       FAR const void *key);
+
+/****************************************************************************
+ * Name: hashmap_insert
+ *
+ * Description:
+ *   Add an entry with the hash.  The caller makes sure that no entry with
+ *   the same key is in the table.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOMEM if the table is full and cannot grow.
+ *
+ ****************************************************************************/
+
+int hashmap_insert(FAR struct hashmap_s *map, uint32_t hash,
+                   FAR void *entry);
+
+/****************************************************************************
+ * Name: hashmap_remove
+ *
+ * Description:
+ *   Remove the entry with the hash and the key and return it, or NULL if
+ *   there is none.
+ *
+ ****************************************************************************/
+
+FAR void *hashmap_remove(FAR struct hashmap_s *map, uint32_t hash,
+                         FAR const void *key);
+
+/****************************************************************************
+ * Name: hashmap_foreach
+ *
+ * Description:
+ *   Call func for each entry.  func must not change the table.
+ *
+ ****************************************************************************/
+
+void hashmap_foreach(FAR const struct hashmap_s *map,
+                     hashmap_foreach_t func, FAR void *arg);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_HASHMAP_H */
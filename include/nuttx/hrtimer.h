@@ -30,11 +30,27 @@
 #include <nuttx/config.h>
 #include <nuttx/clock.h>
 #include <nuttx/compiler.h>
-#include <nuttx/spinlock.h>
 
 #include <stdint.h>
+#include <string.h>
+#include <time.h>
 #include <sys/tree.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The default slack of the timers of nanosleep(), timerfd and POSIX
+ * timers.  A timer may expire this much later than requested, so that it
+ * shares the wakeup of another timer.
+ */
+
+#ifdef CONFIG_HRTIMER_SLACK_NSEC
+#  define HRTIMER_DEFAULT_SLACK CONFIG_HRTIMER_SLACK_NSEC
+#else
+#  define HRTIMER_DEFAULT_SLACK 0
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -87,6 +103,7 @@ struct hrtimer_s
   hrtimer_node_t node;   /* RB-tree node for sorted insertion */
   hrtimer_entry_t func;  /* Expiration callback function */
   uint64_t expired;      /* Absolute expiration time (ns) */
+  uint64_t softexpired;  /* Earliest time the timer may run (ns) */
 };
 
 /****************************************************************************
@@ -119,7 +136,7 @@ extern "C"
  ****************************************************************************/
 
 static inline_function
-void hrtimer_init(FAR hrtimer_t *hrtimer, hrtimer_cb func)
+void hrtimer_init(FAR hrtimer_t *hrtimer, hrtimer_entry_t func)
 {
   memset(hrtimer, 0, sizeof(hrtimer_t));
   hrtimer->func = func;
@@ -173,6 +190,28 @@ int hrtimer_cancel(FAR hrtimer_t *hrtimer);
 
 int hrtimer_cancel_sync(FAR hrtimer_t *hrtimer);
 
+/****************************************************************************
+ * Name: hrtimer_start_range
+ *
+ * Description:
+ *   Start a high-resolution timer that expires at any time in the range
+ *   [expired, expired + slack].  If another armed timer expires within
+ *   that range, the timer is run together with it and does not need a
+ *   wakeup of its own.
+ *
+ * Input Parameters:
+ *   hrtimer - Timer instance to start
+ *   expired - Earliest expiration time in nanoseconds
+ *   slack   - The acceptable delay of the expiration in nanoseconds
+ *   mode    - HRTIMER_MODE_ABS or HRTIMER_MODE_REL
+ *
+ * Returned Value:
+ *   OK on success; a negated errno value on failure.
+ ****************************************************************************/
+
+int hrtimer_start_range(FAR hrtimer_t *hrtimer, uint64_t expired,
+                        uint64_t slack, enum hrtimer_mode_e mode);
+
 /****************************************************************************
  * Name: hrtimer_start
  *
@@ -191,9 +230,71 @@ int hrtimer_cancel_sync(FAR hrtimer_t *hrtimer);
  *   OK on success; a negated errno value on failure.
  ****************************************************************************/
 
-int hrtimer_start(FAR hrtimer_t *hrtimer,
-                  uint64_t expired,
-                  enum hrtimer_mode_e mode);
+static inline_function
+int hrtimer_start(FAR hrtimer_t *hrtimer, uint64_t expired,
+                  enum hrtimer_mode_e mode)
+{
+  return hrtimer_start_range(hrtimer, expired, 0, mode);
+}
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Get the current high-resolution time, the time base of the absolute
+ *   expiration times, in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void);
+
+/****************************************************************************
+ * Name: hrtimer_abstime2ns
+ *
+ * Description:
+ *   Convert an absolute time of clock 'clockid' to the hrtimer time base.
+ *   A time in the past is converted to the current time.
+ *
+ * Input Parameters:
+ *   clockid - The clock the time is measured against
+ *   abstime - The absolute time to convert
+ *
+ * Returned Value:
+ *   The absolute expiration time in nanoseconds.
+ ****************************************************************************/
+
+uint64_t hrtimer_abstime2ns(clockid_t clockid,
+                            FAR const struct timespec *abstime);
+
+/****************************************************************************
+ * Name: hrtimer_gettimeout
+ *
+ * Description:
+ *   Return the time remaining until an armed timer expires, or zero if the
+ *   timer is not armed.
+ *
+ * Input Parameters:
+ *   hrtimer - Timer instance to query
+ *
+ * Returned Value:
+ *   The remaining time in nanoseconds.
+ ****************************************************************************/
+
+uint64_t hrtimer_gettimeout(FAR hrtimer_t *hrtimer);
+
+/****************************************************************************
+ * Name: hrtimer_gettimeout_next
+ *
+ * Description:
+ *   Return the time remaining until the earliest armed timer may expire,
+ *   the time an idle CPU can sleep without missing a timer.
+ *
+ * Returned Value:
+ *   The remaining time in nanoseconds, or UINT64_MAX if no timer is
+ *   armed.
+ ****************************************************************************/
+
+uint64_t hrtimer_gettimeout_next(void);
 
 #undef EXTERN
 #ifdef __cplusplus
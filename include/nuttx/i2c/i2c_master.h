@@ -33,6 +33,7 @@
 #include <stdint.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -270,6 +271,27 @@ struct i2c_transfer_s
   size_t msgc;                /* Number of messages in the array. */
 };
 
+#ifdef CONFIG_I2C_ASYNC
+/* A transfer queued with i2c_transfer_async().  callback is called from the
+ * thread of the bus queue with the result once the transfer is done.
+ */
+
+struct i2c_request_s;
+typedef CODE void (*i2c_callback_t)(FAR struct i2c_request_s *req,
+                                    int result);
+
+struct i2c_request_s
+{
+  sq_entry_t node;            /* Used by the bus queue */
+  FAR struct i2c_msg_s *msgs; /* The messages of I2C_TRANSFER() */
+  int count;                  /* Number of messages */
+  i2c_callback_t callback;    /* Called when the transfer is done */
+  FAR void *priv;             /* For use by the caller */
+};
+
+struct i2c_async_s;
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -383,6 +405,60 @@ int i2c_read(FAR struct i2c_master_s *dev,
              FAR const struct i2c_config_s *config,
              FAR uint8_t *buffer, int buflen);
 
+#ifdef CONFIG_I2C_ASYNC
+
+/****************************************************************************
+ * Name: i2c_async_initialize
+ *
+ * Description:
+ *   Create the request queue of an I2C bus, with the thread that performs
+ *   the queued transfers.
+ *
+ * Input Parameters:
+ *   dev - The I2C master the requests are sent to
+ *
+ * Returned Value:
+ *   The queue handle on success, NULL if out of memory.
+ *
+ ****************************************************************************/
+
+FAR struct i2c_async_s *i2c_async_initialize(FAR struct i2c_master_s *dev);
+
+/****************************************************************************
+ * Name: i2c_async_uninitialize
+ *
+ * Description:
+ *   Destroy a queue created by i2c_async_initialize().  The requests that
+ *   were not started yet complete with -ECANCELED.
+ *
+ * Input Parameters:
+ *   bus - The queue handle
+ *
+ ****************************************************************************/
+
+void i2c_async_uninitialize(FAR struct i2c_async_s *bus);
+
+/****************************************************************************
+ * Name: i2c_transfer_async
+ *
+ * Description:
+ *   Queue a transfer on the bus and return at once, the transfers run in
+ *   order and back to back.  May be called from an interrupt handler.
+ *
+ * Input Parameters:
+ *   bus - The queue handle
+ *   req - The request, with msgs, count and callback set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int i2c_transfer_async(FAR struct i2c_async_s *bus,
+                       FAR struct i2c_request_s *req);
+
+#endif /* CONFIG_I2C_ASYNC */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
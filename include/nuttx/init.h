@@ -30,8 +30,15 @@
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
 
+#include <sys/types.h>
+#include <stdbool.h>
 #include <stdint.h>
 
+#ifdef CONFIG_SCHED_ASYNCINIT
+#  include <nuttx/queue.h>
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -48,6 +55,11 @@
 #define OSINIT_IS_PANIC()        (g_nx_initstate >= OSINIT_PANIC)
 #define OSINIT_OS_INITIALIZING() (g_nx_initstate  < OSINIT_OSREADY)
 
+#ifndef CONFIG_SCHED_BOOTTRACE
+#  define nxboot_mark(n)
+#  define nxboot_record(n,b,e)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -76,6 +88,43 @@ enum nx_initstate_e
   OSINIT_PANIC     = 7   /* Fatal error happened. */
 };
 
+#ifdef CONFIG_SCHED_BOOTTRACE
+/* One phase of the boot, as reported by /proc/boottrace.  The times are
+ * perf_gettime() values.
+ */
+
+struct boottrace_s
+{
+  FAR const char *name;  /* Name of the phase */
+  clock_t begin;         /* When the phase began */
+  clock_t end;           /* When the phase ended */
+  uint8_t cpu;           /* CPU that ran the phase */
+};
+#endif
+
+#ifdef CONFIG_SCHED_ASYNCINIT
+/* An initialization step that may run in parallel with the rest of the
+ * boot.  The caller fills in the first four fields, the step starts on the
+ * low priority work queue once all of the steps in deps[] are done.
+ */
+
+struct nxinit_s
+{
+  FAR const char *name;              /* Name in the boot trace */
+  CODE int (*func)(FAR void *arg);   /* The initialization itself */
+  FAR void *arg;                     /* Argument of func */
+  FAR struct nxinit_s * const *deps; /* NULL terminated, NULL if none */
+
+  /* Private, set up by nxinit_async() */
+
+  sq_entry_t node;
+  struct work_s work;
+  int result;
+  bool queued;
+  bool done;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -105,6 +154,78 @@ EXTERN volatile uint8_t g_nx_initstate;  /* See enum nx_initstate_e */
 
 void nx_start(void);
 
+#ifdef CONFIG_SCHED_BOOTTRACE
+
+/****************************************************************************
+ * Name: nxboot_mark
+ *
+ * Description:
+ *   Record that the sequential boot has completed the named phase, which
+ *   began where the previous one ended.
+ *
+ ****************************************************************************/
+
+void nxboot_mark(FAR const char *name);
+
+/****************************************************************************
+ * Name: nxboot_record
+ *
+ * Description:
+ *   Record a phase with explicit begin and end times, for work that does
+ *   not run on the boot thread.
+ *
+ ****************************************************************************/
+
+void nxboot_record(FAR const char *name, clock_t begin, clock_t end);
+
+/****************************************************************************
+ * Name: nxboot_trace
+ *
+ * Description:
+ *   Return the recorded phases and their number in *count.  Phases are only
+ *   ever appended, the first *count entries stay valid.
+ *
+ ****************************************************************************/
+
+FAR const struct boottrace_s *nxboot_trace(FAR int *count);
+#endif
+
+#ifdef CONFIG_SCHED_ASYNCINIT
+
+/****************************************************************************
+ * Name: nxinit_async
+ *
+ * Description:
+ *   Submit an initialization step.  It runs on the low priority work queue
+ *   as soon as the work queues are up and all of the steps it depends on
+ *   are done, so independent steps overlap each other and the rest of the
+ *   boot.  The dependencies must have been submitted before, which also
+ *   rules out cycles.  The structure must stay valid until nxinit_wait()
+ *   returns.
+ *
+ *   This may be called from drivers_initialize(), board_early_initialize(),
+ *   board_late_initialize() or any later point.
+ *
+ ****************************************************************************/
+
+void nxinit_async(FAR struct nxinit_s *init);
+
+/****************************************************************************
+ * Name: nxinit_wait
+ *
+ * Description:
+ *   Wait until all submitted steps are done.  This is called before the
+ *   init task is started.
+ *
+ * Returned Value:
+ *   OK if all of the steps succeeded, otherwise the result of the first
+ *   step that failed.
+ *
+ ****************************************************************************/
+
+int nxinit_wait(void);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
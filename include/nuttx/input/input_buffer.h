@@ -0,0 +1,205 @@
+/****************************************************************************
+ * include/nuttx/input/input_buffer.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_INPUT_INPUT_BUFFER_H
+#define __INCLUDE_NUTTX_INPUT_INPUT_BUFFER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/fs/ioctl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* IOCTL Commands ***********************************************************/
+
+/* These are supported by the touchscreen, mouse and keyboard upper halves
+ * for the buffer of the file they are called on.
+ */
+
+#define INPUTIOC_SETBUFSIZE  _INPUTIOC(0x0001) /* arg: size_t, bytes of
+                                                * events that the buffer
+                                                * holds.  The buffered
+                                                * events are dropped */
+#define INPUTIOC_GETBUFSIZE  _INPUTIOC(0x0002) /* arg: Pointer to size_t,
+                                                * returns the bytes to
+                                                * mmap() */
+
+#define SIZEOF_INPUT_RING_S(n) (sizeof(struct input_ring_s) + (n) - 1)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct mm_map_entry_s; /* Forward reference */
+
+/* The buffer of events of one open file, this is what mmap() maps.  The
+ * events are stored as read() returns them, one after the other, and may
+ * wrap around the end of data[].  head and tail only ever grow, the events
+ * not consumed yet start at data[tail & (size - 1)].
+ *
+ * A reader that maps the buffer consumes the events by advancing tail
+ * itself.  Once the buffer is mapped, new events that do not fit are
+ * dropped, otherwise the oldest events are.
+ */
+
+struct input_ring_s
+{
+  uint32_t          size;    /* Size of data[], a power of 2 */
+  volatile uint32_t head;    /* Bytes ever written, advanced by the driver */
+  volatile uint32_t tail;    /* Bytes ever consumed */
+  uint32_t          dropped; /* Events dropped for want of space */
+  uint8_t           data[1]; /* Actual dimension is size */
+};
+
+/* Returns the size of the event that starts with the given bytes */
+
+typedef CODE size_t (*input_evsize_t)(FAR const void *event);
+
+/* The buffer state of one open file */
+
+struct input_buffer_s
+{
+  FAR struct input_ring_s *ring;
+  input_evsize_t evsize;     /* Size of variable events, or NULL */
+  uint16_t       hdrsize;    /* Size of fixed events, or what evsize needs */
+  bool           mapped;     /* The ring is mapped by the reader */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: input_buffer_init
+ *
+ * Description:
+ *   Allocate a buffer for at least size bytes of events.  The events are
+ *   hdrsize bytes each if evsize is NULL, else evsize() returns the size of
+ *   each from its first hdrsize bytes.
+ *
+ ****************************************************************************/
+
+int input_buffer_init(FAR struct input_buffer_s *buffer, size_t size,
+                      size_t hdrsize, input_evsize_t evsize);
+
+/****************************************************************************
+ * Name: input_buffer_uninit
+ ****************************************************************************/
+
+void input_buffer_uninit(FAR struct input_buffer_s *buffer);
+
+/****************************************************************************
+ * Name: input_buffer_resize
+ *
+ * Description:
+ *   Replace the ring by one for at least size bytes of events, the events
+ *   in the old ring are dropped.  A mapped ring cannot be resized.
+ *
+ ****************************************************************************/
+
+int input_buffer_resize(FAR struct input_buffer_s *buffer, size_t size);
+
+/****************************************************************************
+ * Name: input_buffer_is_empty
+ ****************************************************************************/
+
+bool input_buffer_is_empty(FAR struct input_buffer_s *buffer);
+
+/****************************************************************************
+ * Name: input_buffer_write
+ *
+ * Description:
+ *   Append one event of len bytes, dropping the oldest events to make
+ *   room, or the new one if the ring is mapped.
+ *
+ ****************************************************************************/
+
+void input_buffer_write(FAR struct input_buffer_s *buffer,
+                        FAR const void *event, size_t len);
+
+/****************************************************************************
+ * Name: input_buffer_read
+ *
+ * Description:
+ *   Move as many whole events as fit into len bytes to data.  If not even
+ *   the first one fits, its first len bytes are returned and the rest of it
+ *   is dropped.
+ *
+ * Returned Value:
+ *   The number of bytes returned.
+ *
+ ****************************************************************************/
+
+ssize_t input_buffer_read(FAR struct input_buffer_s *buffer,
+                          FAR char *data, size_t len);
+
+/****************************************************************************
+ * Name: input_buffer_ioctl
+ *
+ * Description:
+ *   Handle the INPUTIOC_* commands.
+ *
+ * Returned Value:
+ *   -ENOTTY if cmd is not one of them.
+ *
+ ****************************************************************************/
+
+int input_buffer_ioctl(FAR struct input_buffer_s *buffer, int cmd,
+                       unsigned long arg);
+
+/****************************************************************************
+ * Name: input_buffer_mmap
+ *
+ * Description:
+ *   Map the ring for the reader, see struct input_ring_s.  The mapping is
+ *   valid until the file is closed.  This is not supported in the kernel
+ *   build.
+ *
+ ****************************************************************************/
+
+int input_buffer_mmap(FAR struct input_buffer_s *buffer,
+                      FAR struct mm_map_entry_s *map);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_INPUT_INPUT_BUFFER_H */
@@ -111,6 +111,10 @@
 #  define CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION -1
 #endif
 
+#ifndef CONFIG_SCHED_CRITMONITOR_CSECTION_SITES
+#  define CONFIG_SCHED_CRITMONITOR_CSECTION_SITES 0
+#endif
+
 #ifndef CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ
 #  define CONFIG_SCHED_CRITMONITOR_MAXTIME_IRQ -1
 #endif
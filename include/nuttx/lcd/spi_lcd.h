@@ -0,0 +1,168 @@
+/****************************************************************************
+ * include/nuttx/lcd/spi_lcd.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_LCD_SPI_LCD_H
+#define __INCLUDE_NUTTX_LCD_SPI_LCD_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/spi/spi_transfer.h>
+
+#ifdef CONFIG_LCD_SPI_QUEUE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SPI_LCD_NBATCH   CONFIG_LCD_SPI_QUEUE_DEPTH
+#define SPI_LCD_NTRANS   8   /* Commands and parameters per batch */
+#define SPI_LCD_NPARAMS  16  /* Command and parameter bytes per batch */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The commands and the pixels of one batch.  The commands are sent 8 bits
+ * a word and the pixels in words of the pixel size, each as one sequence
+ * of the bus queue.
+ */
+
+struct spi_lcd_s;
+
+struct spi_lcd_batch_s
+{
+  FAR struct spi_lcd_s *lcd;
+  struct spi_request_s cmdreq;
+  struct spi_sequence_s cmdseq;
+  struct spi_trans_s cmdtrans[SPI_LCD_NTRANS];
+  uint8_t params[SPI_LCD_NPARAMS];
+  uint8_t nparams;
+  struct spi_request_s pixreq;
+  struct spi_sequence_s pixseq;
+  struct spi_trans_s pixtrans;
+};
+
+/* A queue of batches to one SPI LCD.  One batch is sent while the next is
+ * built, so the CPU renders and sets up the next region while the last
+ * one is sent by the SPI DMA.
+ */
+
+struct spi_lcd_s
+{
+  FAR struct spi_async_s *bus;    /* The bus queue */
+  sem_t free;                     /* Counts the batches not in flight */
+  int result;                     /* First error since spi_lcd_wait() */
+  uint8_t head;                   /* The batch being built */
+  bool building;                  /* The head batch is taken */
+  struct spi_lcd_batch_s batch[SPI_LCD_NBATCH];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#  define EXTERN extern "C"
+extern "C"
+{
+#else
+#  define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: spi_lcd_initialize
+ *
+ * Description:
+ *   Create the bus queue of an LCD on a 4-wire SPI bus.
+ *
+ * Input Parameters:
+ *   lcd     - The queue to initialize
+ *   spi     - The SPI bus of the LCD
+ *   config  - The device, mode, frequency and delays of the LCD.  nbits
+ *             is the size of the pixel words: 16 sends each RGB565 pixel
+ *             of a little endian frame buffer high byte first, so no CPU
+ *             loop swaps the bytes; 8 sends the pixels as they are in
+ *             memory.  ntrans and trans are not used.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_lcd_initialize(FAR struct spi_lcd_s *lcd, FAR struct spi_dev_s *spi,
+                       FAR const struct spi_sequence_s *config);
+
+/****************************************************************************
+ * Name: spi_lcd_command
+ *
+ * Description:
+ *   Add a command and its parameters to the batch being built.  A full
+ *   batch is sent first.
+ *
+ ****************************************************************************/
+
+int spi_lcd_command(FAR struct spi_lcd_s *lcd, uint8_t cmd,
+                    FAR const uint8_t *params, size_t nparams);
+
+/****************************************************************************
+ * Name: spi_lcd_pixels
+ *
+ * Description:
+ *   Add nbytes of pixels to the batch being built and send it.  This
+ *   returns before the pixels are sent, the buffer must stay valid until
+ *   spi_lcd_wait().  A frame buffer may be drawn into meanwhile.
+ *
+ ****************************************************************************/
+
+int spi_lcd_pixels(FAR struct spi_lcd_s *lcd, FAR const void *buffer,
+                   size_t nbytes);
+
+/****************************************************************************
+ * Name: spi_lcd_wait
+ *
+ * Description:
+ *   Send the commands of the batch being built and wait until every batch
+ *   is sent.  Must be called before the LCD is accessed in another way.
+ *
+ * Returned Value:
+ *   The first error of a batch since the last call, else zero (OK).
+ *
+ ****************************************************************************/
+
+int spi_lcd_wait(FAR struct spi_lcd_s *lcd);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_LCD_SPI_QUEUE */
+#endif /* __INCLUDE_NUTTX_LCD_SPI_LCD_H */
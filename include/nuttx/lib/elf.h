@@ -240,6 +240,9 @@ struct mod_loadinfo_s
                               * romfs/tmps, we can try get xipbase,
                               * skip the copy.
                               */
+  uintptr_t     filebase;    /* Address of the file if the file system maps
+                              * it, libelf_read() then copies from there.
+                              */
 
   /* Address environment.
    *
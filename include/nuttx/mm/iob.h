@@ -32,6 +32,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <sys/param.h>
+#include <time.h>
 
 #ifdef CONFIG_IOB_NOTIFIER
 #  include <nuttx/wqueue.h>
@@ -80,7 +81,7 @@
 /* IOB helpers */
 
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -101,6 +102,24 @@
 
 typedef CODE void (*iob_free_cb_t)(FAR void *data);
 
+#ifdef CONFIG_IOB_PKTMETA
+/* Offload metadata of a network packet, exchanged between the network
+ * stack and the driver.  Only valid in the I/O buffer at the head of the
+ * chain, and only if flags is non-zero.
+ */
+
+struct iob_pktmeta_s
+{
+  uint16_t flags;       /* Offload flags, NETPKT_TX_* and NETPKT_RX_* */
+  uint16_t gsosize;     /* TCP payload size of each (coalesced) segment */
+  uint16_t l4off;       /* Offset of the L4 header from the L3 header */
+  uint16_t csumoff;     /* Offset of the checksum field in the L4 header */
+#ifdef CONFIG_NET_TIMESTAMPING
+  struct timespec rxtstamp; /* Hardware receive time, NETPKT_RX_TSTAMP */
+#endif
+};
+#endif
+
 /* Represents one I/O buffer.  A packet is contained by one or more I/O
  * buffers in a chain.  The io_pktlen is only valid for the I/O buffer at
  * the head of the chain.
@@ -125,6 +144,9 @@ struct iob_s
 #  endif
 #endif
   unsigned int io_pktlen; /* Total length of the packet */
+#ifdef CONFIG_IOB_PKTMETA
+  struct iob_pktmeta_s io_meta; /* Offload metadata of the packet */
+#endif
 
 #ifdef CONFIG_IOB_ALLOC
   iob_free_cb_t io_free;  /* Custom free callback */
@@ -167,6 +189,16 @@ struct iob_stats_s
   int nfree;
   int nwait;
   int nthrottle;
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  int ncached;        /* Free I/O buffers held in the CPU caches */
+#endif
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  int nsmall;         /* Total number of small I/O buffers */
+  int nsmallfree;     /* Free small I/O buffers */
+#endif
+#if CONFIG_IOB_ELASTIC_NBUFFERS > 0
+  int nelastic;       /* I/O buffers currently allocated from the heap */
+#endif
 };
 
 /****************************************************************************
@@ -220,6 +252,18 @@ FAR struct iob_s *iob_alloc(bool throttled);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate an I/O buffer of the smallest size class that holds
+ *   'size' bytes without waiting for a buffer to become free.  If the small
+ *   I/O buffers are exhausted, a normal sized one is returned.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(bool throttled, uint16_t size);
+
 #ifdef CONFIG_IOB_ALLOC
 /****************************************************************************
  * Name: iob_alloc_dynamic
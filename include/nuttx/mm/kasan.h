@@ -36,6 +36,28 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Check a whole range once in code that is not instrumented itself, e.g.
+ * the string functions, instead of one check per access.
+ */
+
+#if defined(__SANITIZE_ADDRESS__)
+#  define KASAN_CHECK_RANGE 1
+#elif defined(__has_feature)
+#  if __has_feature(address_sanitizer)
+#    define KASAN_CHECK_RANGE 1
+#  endif
+#endif
+
+#ifdef KASAN_CHECK_RANGE
+#  define kasan_check_read(addr, size) \
+     __asan_loadN((FAR void *)(addr), size)
+#  define kasan_check_write(addr, size) \
+     __asan_storeN((FAR void *)(addr), size)
+#else
+#  define kasan_check_read(addr, size)
+#  define kasan_check_write(addr, size)
+#endif
+
 #ifndef CONFIG_MM_KASAN
 #  define kasan_poison(addr, size)
 #  define kasan_unpoison(addr, size) addr
@@ -49,6 +71,7 @@
 #  define kasan_debugpoint(t,a,s) 0
 #  define kasan_init_early()
 #  define kasan_bypass(state) ((void)state, state)
+#  define kasan_region_enable(addr, enable) 0
 #else
 
 #  define kasan_init_early() kasan_stop()
@@ -237,6 +260,24 @@ int kasan_debugpoint(int type, FAR void *addr, size_t size);
 
 bool kasan_bypass(bool state);
 
+/****************************************************************************
+ * Name: kasan_region_enable
+ *
+ * Description:
+ *   Turn the checking of the accesses to a registered region on or off.
+ *   With CONFIG_MM_KASAN_REGION_OPTIN the regions start off.
+ *
+ * Input Parameters:
+ *   addr   - Any address inside the region
+ *   enable - Whether the region is checked
+ *
+ * Returned Value:
+ *   Zero on success; -ENOENT if addr is not in a registered region.
+ *
+ ****************************************************************************/
+
+int kasan_region_enable(FAR const void *addr, bool enable);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -244,4 +285,20 @@ bool kasan_bypass(bool state);
 
 #endif /* CONFIG_MM_KASAN */
 
+#ifdef KASAN_CHECK_RANGE
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Provided by the KASan runtime, see mm/kasan/hook.c */
+
+void __asan_loadN(FAR void *addr, size_t size);
+void __asan_storeN(FAR void *addr, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 #endif /* __INCLUDE_NUTTX_MM_KASAN_H */
@@ -0,0 +1,133 @@
+//***************************************************************************
+// include/nuttx/mm/memory_resource.hxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+//
+//***************************************************************************
+
+#ifndef __INCLUDE_NUTTX_MM_MEMORY_RESOURCE_HXX
+#define __INCLUDE_NUTTX_MM_MEMORY_RESOURCE_HXX
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstddef>
+#include <memory_resource>
+
+#include <nuttx/mm/mm.h>
+#include <nuttx/mm/mempool.h>
+
+#ifdef CONFIG_LIBXX_PMR
+
+//***************************************************************************
+// Public Types
+//***************************************************************************
+
+namespace nuttx
+{
+namespace pmr
+{
+  // A std::pmr::memory_resource of fixed size blocks from a mempool_s, for
+  // the nodes of std::pmr::map, std::pmr::list and the like.  Requests
+  // that do not fit a block, as the buckets of an unordered container, go
+  // to the upstream resource.  The pool grows by expandsize bytes at a time
+  // from the upstream resource, or not at all if expandsize is zero.
+
+  class mempool_resource : public std::pmr::memory_resource
+  {
+  public:
+    explicit mempool_resource(std::size_t blocksize,
+                              std::size_t initialsize = 0,
+                              std::size_t expandsize = 1024,
+                              FAR const char *name = "pmr",
+                              FAR std::pmr::memory_resource *upstream =
+                                std::pmr::get_default_resource());
+    ~mempool_resource();
+
+    mempool_resource(const mempool_resource &) = delete;
+    mempool_resource &operator=(const mempool_resource &) = delete;
+
+    FAR std::pmr::memory_resource *upstream_resource() const
+    {
+      return m_upstream;
+    }
+
+    FAR struct mempool_s *pool()
+    {
+      return &m_pool;
+    }
+
+  protected:
+    FAR void *do_allocate(std::size_t bytes, std::size_t align) override;
+    void do_deallocate(FAR void *p, std::size_t bytes,
+                       std::size_t align) override;
+    bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override;
+
+  private:
+    static FAR void *pool_alloc(FAR struct mempool_s *pool,
+                                std::size_t size);
+    static void pool_free(FAR struct mempool_s *pool, FAR void *addr);
+
+    bool fits(std::size_t bytes, std::size_t align) const
+    {
+      return bytes <= m_pool.blocksize && align <= m_align;
+    }
+
+    struct mempool_s m_pool;
+    std::size_t m_align;           // The alignment of every block
+    FAR std::pmr::memory_resource *m_upstream;
+  };
+
+  // A std::pmr::memory_resource of the memory of one mm_heap_s, either an
+  // arena of its own from mm_initialize() over a given region or a heap
+  // that already exists, which it then does not own.
+
+  class heap_resource : public std::pmr::memory_resource
+  {
+  public:
+    heap_resource(FAR const char *name, FAR void *start, std::size_t size);
+    explicit heap_resource(FAR struct mm_heap_s *heap);
+    ~heap_resource();
+
+    heap_resource(const heap_resource &) = delete;
+    heap_resource &operator=(const heap_resource &) = delete;
+
+    FAR struct mm_heap_s *heap() const
+    {
+      return m_heap;
+    }
+
+  protected:
+    FAR void *do_allocate(std::size_t bytes, std::size_t align) override;
+    void do_deallocate(FAR void *p, std::size_t bytes,
+                       std::size_t align) override;
+    bool do_is_equal(const std::pmr::memory_resource &other)
+      const noexcept override;
+
+  private:
+    FAR struct mm_heap_s *m_heap;
+    bool m_owner;                  // The heap is uninitialized with this
+  };
+} // namespace pmr
+} // namespace nuttx
+
+#endif // CONFIG_LIBXX_PMR
+#endif // __INCLUDE_NUTTX_MM_MEMORY_RESOURCE_HXX
@@ -87,6 +87,16 @@ struct mempool_procfs_entry_s
 };
 #endif
 
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+/* This structure describes the per-CPU cache of free blocks of a pool */
+
+struct mempool_magazine_s
+{
+  size_t     count;  /* The number of cached blocks */
+  FAR void  *blks[2 * CONFIG_MM_MEMPOOL_MAGAZINE_SIZE];
+};
+#endif
+
 /* This structure describes memory buffer pool */
 
 struct mempool_s
@@ -110,6 +120,9 @@ struct mempool_s
   size_t     nalloc;  /* The number of used block in mempool */
   spinlock_t lock;    /* The protect lock to mempool */
   sem_t      waitsem; /* The semaphore of waiter get free block */
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+  struct mempool_magazine_s magazine[CONFIG_SMP_NCPUS]; /* Per-CPU cache */
+#endif
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMPOOL)
   struct mempool_procfs_entry_s procfs; /* The entry of procfs */
 #endif
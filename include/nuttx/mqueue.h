@@ -32,6 +32,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/signal.h>
 #include <nuttx/list.h>
+#include <nuttx/spinlock.h>
 
 #include <sys/types.h>
 #include <stdint.h>
@@ -128,6 +129,10 @@ struct mqueue_inode_s
   struct sigwork_s ntwork;    /* Notification work */
 #endif
   FAR struct pollfd *fds[CONFIG_FS_MQUEUE_NPOLLWAITERS];
+#ifdef CONFIG_MQ_MSGSLAB
+  struct list_node slab;      /* Free messages preallocated for the queue */
+  spinlock_t slablock;        /* Protects the slab free list */
+#endif
 };
 
 /****************************************************************************
@@ -793,6 +798,37 @@ int file_mq_setattr(FAR struct file *mq, FAR const struct mq_attr *mq_stat,
 
 int file_mq_getattr(FAR struct file *mq, FAR struct mq_attr *mq_stat);
 
+/****************************************************************************
+ * Name: file_mq_loan, file_mq_timedsend_loan, file_mq_timedreceive_loan
+ *       and file_mq_return
+ *
+ * Description:
+ *   Zero copy variants of send and receive.  file_mq_loan() lends a
+ *   message buffer of mq_msgsize bytes that the sender fills in place and
+ *   queues with file_mq_timedsend_loan().  file_mq_timedreceive_loan()
+ *   returns the received message in place instead of copying it out.
+ *   Either way the buffer is handed back with file_mq_return() once it is
+ *   no longer needed: after a failed send, or when the received message
+ *   has been consumed.  An abstime of NULL waits forever.
+ *
+ *   With CONFIG_MQ_MSGSLAB the buffers come from the messages allocated
+ *   together with the queue, otherwise from the global message pool.
+ *
+ * Returned Value:
+ *   As for file_mq_timedsend() and file_mq_timedreceive().  file_mq_loan()
+ *   returns -ENOMEM when no message is available.
+ *
+ ****************************************************************************/
+
+int file_mq_loan(FAR struct file *mq, FAR void **buf);
+int file_mq_timedsend_loan(FAR struct file *mq, FAR void *buf,
+                           size_t msglen, unsigned int prio,
+                           FAR const struct timespec *abstime);
+ssize_t file_mq_timedreceive_loan(FAR struct file *mq, FAR void **buf,
+                                  FAR unsigned int *prio,
+                                  FAR const struct timespec *abstime);
+void file_mq_return(FAR struct file *mq, FAR void *buf);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -137,10 +137,11 @@ typedef uint8_t sockcaps_t;
  * a given address family.
  */
 
-struct file;    /* Forward reference */
-struct stat;    /* Forward reference */
-struct socket;  /* Forward reference */
-struct pollfd;  /* Forward reference */
+struct file;            /* Forward reference */
+struct stat;            /* Forward reference */
+struct socket;          /* Forward reference */
+struct pollfd;          /* Forward reference */
+struct mm_map_entry_s;  /* Forward reference */
 
 struct sock_intf_s
 {
@@ -181,6 +182,8 @@ struct sock_intf_s
                     FAR struct file *infile, FAR off_t *offset,
                     size_t count);
 #endif
+  CODE int        (*si_mmap)(FAR struct socket *psock,
+                    FAR struct mm_map_entry_s *map);
 };
 
 /* Each socket refers to a connection structure of type FAR void *.  Each
@@ -227,6 +230,9 @@ struct socket_conn_s
   uint8_t       s_boundto;   /* Index of the interface we are bound to.
                               * Unbound: 0, Bound: 1-MAX_IFINDEX */
 #  endif
+#  ifdef CONFIG_NET_BUSY_POLL
+  uint32_t      s_busypoll;  /* Busy poll time (in microseconds) */
+#  endif
 #endif
 
   /* Definitions of 8-bit socket flags */
@@ -914,6 +920,27 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg and psock_recvmmsg
+ *
+ * Description:
+ *   Send or receive up to vlen messages, as that many calls of
+ *   psock_sendmsg() or psock_recvmsg() would.  These are the internal OS
+ *   interfaces of sendmmsg() and recvmmsg(), with the same differences as
+ *   psock_sendmsg() and psock_recvmsg() have with sendmsg() and recvmsg().
+ *
+ * Returned Value:
+ *   The number of messages sent or received.  An error is only returned,
+ *   as a negated errno value, if there was none.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR const struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -217,6 +217,60 @@
      (netdev_ipv6_lookup(dev, addr, true) != NULL)
 #endif
 
+#ifdef CONFIG_NETDEV_OFFLOAD
+/* Offload features of a network device, see d_features */
+
+#  define NETDEV_FEATURE_TXCSUM (1 << 0) /* Completes TCP/UDP TX checksums */
+#  define NETDEV_FEATURE_RXCSUM (1 << 1) /* Verifies TCP/UDP RX checksums */
+#  define NETDEV_FEATURE_TSO    (1 << 2) /* Segments TCP super packets */
+#  define NETDEV_FEATURE_LRO    (1 << 3) /* Coalesces received TCP segments */
+#  define NETDEV_FEATURE_USO    (1 << 4) /* Segments UDP super datagrams */
+
+/* Offload flags of one packet, see struct iob_pktmeta_s.  The TX flags are
+ * set by the network stack for the driver, the RX flags by the driver for
+ * the network stack.
+ */
+
+#  define NETPKT_TX_CSUM        (1 << 0) /* Complete the L4 checksum */
+#  define NETPKT_TX_TSO         (1 << 1) /* Segment TCP payload to gsosize */
+#  define NETPKT_TX_USO         (1 << 2) /* Cut UDP payload into gsosize */
+#  define NETPKT_RX_CSUM_OK     (1 << 8) /* L3 and L4 checksums verified */
+#  define NETPKT_RX_LRO         (1 << 9) /* Coalesced from gsosize segments */
+
+#  define NETDEV_HAS_FEATURE(dev,f) (((dev)->d_features & (f)) == (f))
+#  define NETDEV_PKTFLAGS(dev)      ((dev)->d_iob->io_meta.flags)
+
+/* The checksums of the packet in d_iob need not be verified in software if
+ * the hardware has done so, or if the packet was looped back before the
+ * hardware could complete them.
+ */
+
+#  define NETDEV_RXCSUM_OK(dev) \
+     ((dev)->d_iob != NULL && \
+      (NETDEV_PKTFLAGS(dev) & (NETPKT_RX_CSUM_OK | NETPKT_TX_CSUM)) != 0)
+#  define NETDEV_IS_TSO(dev) \
+     ((dev)->d_iob != NULL && \
+      (NETDEV_PKTFLAGS(dev) & (NETPKT_TX_TSO | NETPKT_TX_USO)) != 0)
+#else
+#  define NETDEV_HAS_FEATURE(dev,f) false
+#  define NETDEV_RXCSUM_OK(dev)     false
+#  define NETDEV_IS_TSO(dev)        false
+#endif
+
+#ifdef CONFIG_NET_TIMESTAMPING
+/* The driver attached a hardware receive timestamp to the packet, see
+ * netpkt_set_rxtstamp().  It is kept in the I/O buffer at the head of the
+ * chain as the offload flags are.
+ */
+
+#  define NETPKT_RX_TSTAMP      (1 << 10)
+
+#  define NETDEV_RXTSTAMP(dev) \
+     ((dev)->d_iob != NULL && \
+      ((dev)->d_iob->io_meta.flags & NETPKT_RX_TSTAMP) != 0 ? \
+      &(dev)->d_iob->io_meta.rxtstamp : NULL)
+#endif
+
 /* MDIO Manageable Device (MMD) support with SIOCxMIIREG ioctl commands */
 
 #define mdio_phy_id_is_c45(phy_id) \
@@ -316,6 +370,7 @@ struct netdev_rss_s
  */
 
 struct devif_callback_s; /* Forward reference */
+struct can_filter;       /* Forward reference.  See nuttx/can.h */
 
 struct net_driver_s
 {
@@ -352,6 +407,9 @@ struct net_driver_s
 #endif
 
   uint16_t d_pktsize;           /* Maximum packet size */
+#ifdef CONFIG_NETDEV_OFFLOAD
+  uint16_t d_features;          /* Offload features, NETDEV_FEATURE_* */
+#endif
 
   /* Link layer address */
 
@@ -496,6 +554,18 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  /* The checksum of the d_sndlen bytes of application data that
+   * devif_send() copied in at offset d_sndsumoff.  It is only valid while
+   * d_sndsumiob is the current d_iob, and is consumed by the upper layer
+   * checksum of the outgoing packet.
+   */
+
+  FAR struct iob_s *d_sndsumiob;
+  uint16_t d_sndsumoff;
+  uint16_t d_sndsum;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -563,6 +633,23 @@ struct net_driver_s
   CODE int (*d_ioctl)(FAR struct net_driver_s *dev, int cmd,
                       unsigned long arg);
 #endif
+#ifdef CONFIG_NET_BUSY_POLL
+  /* Receive the pending packets in the calling thread, NULL if the
+   * driver cannot.
+   */
+
+  CODE int (*d_busypoll)(FAR struct net_driver_s *dev);
+#endif
+#ifdef CONFIG_NET_CAN_HWFILTER
+  /* Program the acceptance filters of a CAN controller to pass at least
+   * the frames that pass one of the CAN_RAW filters, all frames if
+   * nfilters is 0.  NULL if the controller has no acceptance filters.
+   */
+
+  CODE int (*d_canfilter)(FAR struct net_driver_s *dev,
+                          FAR const struct can_filter *filters,
+                          int nfilters);
+#endif
 
   /* Drivers may attached device-specific, private information */
 
@@ -832,6 +919,53 @@ void netdev_carrier_off(FAR struct net_driver_s *dev);
 
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy a memory region and accumulate its checksum like chksum(), reading
+ *   the source only once.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call.
+ *   dst  - Destination of the copy.
+ *   src  - Beginning of the data to copy and include in the checksum.
+ *   len  - Length of the data.
+ *   odd  - True if the data begins on an odd byte of the running sum;
+ *          updated for the next call.  Should be false on the first call.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dst, FAR const uint8_t *src,
+                     uint16_t len, FAR bool *odd);
+
+/****************************************************************************
+ * Name: net_chksum_partial and net_chksum_copy
+ *
+ * Description:
+ *   Calculate the ones' complement sum of the 16-bit words of a memory
+ *   region in memory byte order and fold it to 16 bits.  net_chksum_copy()
+ *   also copies the region.  These are the primitives all other checksum
+ *   functions are built on; if CONFIG_NET_ARCH_CHKSUM_PARTIAL is defined,
+ *   they must be provided by architecture-specific (e.g. vectorized)
+ *   logic.
+ *
+ * Input Parameters:
+ *   dst  - Destination of the copy.
+ *   data - Beginning of the data to include in the checksum.
+ *   len  - Length of the data to include in the checksum.
+ *
+ * Returned Value:
+ *   The folded sum in memory byte order.
+ *
+ ****************************************************************************/
+
+uint16_t net_chksum_partial(FAR const void *data, size_t len);
+uint16_t net_chksum_copy(FAR void *dst, FAR const void *src, size_t len);
+
 /****************************************************************************
  * Name: chksum_iob
  *
@@ -68,6 +68,10 @@
 #define NETPKT_BUFLEN   CONFIG_IOB_BUFSIZE
 #define NETPKT_BUFNUM   CONFIG_IOB_NBUFFERS
 
+/* Number of RX/TX queues of a lower half, zero is taken as one queue */
+
+#define NETDEV_NQUEUES(dev) ((dev)->nqueues > 0 ? (dev)->nqueues : 1)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -127,6 +131,22 @@ struct netdev_lowerhalf_s
   uint8_t rxtype;
   uint8_t priority;
 
+  /* Number of RX/TX queues served by receive_batch/transmit_batch.  With
+   * NETDEV_RX_THREAD_RSS, RX queue n is polled by the thread of CPU
+   * n % CONFIG_SMP_NCPUS, and the TX queue is chosen by the sending CPU.
+   */
+
+  uint8_t nqueues;
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+  /* Offload features of the device (NETDEV_FEATURE_*), passed to the
+   * network stack on registration.  A driver advertising a feature must
+   * honour the offload metadata of each packet, see netpkt_offload().
+   */
+
+  uint16_t features;
+#endif
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -180,6 +200,41 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+  /* transmit_batch - Optional, try to send up to npkts packets on TX queue
+   *            'queue' at once, non-blocking.  Owns the packets it takes,
+   *            like transmit.  If provided, it is used instead of transmit.
+   *   Returned Value:
+   *     The number of packets taken from the start of pkts.  The packets
+   *       not taken are dropped by upper half and sending stops.
+   *     Negated errno value for failure, no packet is taken.
+   */
+
+  CODE int (*transmit_batch)(FAR struct netdev_lowerhalf_s *dev, int queue,
+                             FAR netpkt_t **pkts, int npkts);
+
+  /* receive_batch - Optional, try to receive up to npkts packets from RX
+   *            queue 'queue', non-blocking.  If provided, it is used
+   *            instead of receive.
+   *   Returned Value:
+   *     The number of packets stored in pkts, 0 if no more packets.
+   */
+
+  CODE int (*receive_batch)(FAR struct netdev_lowerhalf_s *dev, int queue,
+                            FAR netpkt_t **pkts, int npkts);
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+  /* canfilter - Optional, program the acceptance filters of a CAN
+   *            controller to pass at least the frames that pass one of the
+   *            CAN_RAW filters, all frames if nfilters is 0.
+   *   Returned Value:
+   *     OK on success.  Negated errno value if the filters do not fit, the
+   *       upper half then asks to pass all frames.
+   */
+
+  CODE int (*canfilter)(FAR struct netdev_lowerhalf_s *dev,
+                        FAR const struct can_filter *filters, int nfilters);
+#endif
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -303,6 +358,23 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer that packets are ready to read on one RX
+ *   queue.  In NETDEV_RX_THREAD_RSS mode, only the thread serving that
+ *   queue is woken up.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The RX queue
+ *
+ ****************************************************************************/
+
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue);
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -555,6 +627,62 @@ bool netpkt_is_fragmented(FAR netpkt_t *pkt);
 int netpkt_to_iov(FAR struct netdev_lowerhalf_s *dev, FAR netpkt_t *pkt,
                   FAR struct iovec *iov, int iovcnt);
 
+/****************************************************************************
+ * Name: netpkt_offload
+ *
+ * Description:
+ *   Get the offload metadata of a netpkt.
+ *
+ *   TX packets: If NETPKT_TX_CSUM is set, the checksum field at csumoff
+ *   bytes into the L4 header holds the sum of the pseudo header, and the
+ *   driver has to complete it with the sum from the L4 header, which
+ *   starts l4off bytes after the L3 header, to the end of the packet.  If
+ *   NETPKT_TX_TSO is also set, the TCP payload has to be cut into segments
+ *   of gsosize bytes, and the pseudo header sum covers the length of the
+ *   whole packet, as in Linux.  NETPKT_TX_USO is the same for a UDP
+ *   datagram, which is cut into datagrams of gsosize payload bytes, the
+ *   last one may be shorter.
+ *
+ *   RX packets: The driver sets NETPKT_RX_CSUM_OK if the hardware verified
+ *   the IP header and TCP/UDP checksums, and NETPKT_RX_LRO with gsosize if
+ *   the packet was coalesced from several TCP segments.
+ *
+ * Input Parameters:
+ *   pkt - The net packet
+ *
+ * Returned Value:
+ *   Pointer to the struct iob_pktmeta_s of the packet.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+#  define netpkt_offload(pkt) (&(pkt)->io_meta)
+#endif
+
+/****************************************************************************
+ * Name: netpkt_set_rxtstamp
+ *
+ * Description:
+ *   Attach the time at which the hardware received a packet, in the time
+ *   of the PTP clock of the device.  It is reported to the sockets that
+ *   asked for it with SO_TIMESTAMPING.
+ *
+ * Input Parameters:
+ *   pkt - The net packet
+ *   ts  - The hardware timestamp, struct timespec
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TIMESTAMPING
+#  define netpkt_set_rxtstamp(pkt, ts) \
+     do \
+       { \
+         (pkt)->io_meta.rxtstamp = *(ts); \
+         (pkt)->io_meta.flags   |= NETPKT_RX_TSTAMP; \
+       } \
+     while (0)
+#endif
+
 /****************************************************************************
  * Name: netpkt_tryadd_queue
  *
@@ -0,0 +1,117 @@
+/****************************************************************************
+ * include/nuttx/note/notemmap_driver.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NOTE_NOTEMMAP_DRIVER_H
+#define __INCLUDE_NUTTX_NOTE_NOTEMMAP_DRIVER_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Value of notemmap_page_s::magic in every valid control page */
+
+#define NOTEMMAP_MAGIC          0x4e4d4150  /* "NMAP" */
+
+/* Alignment of the control page and of the data area that follows it */
+
+#define NOTEMMAP_PAGE_ALIGN     64
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* /dev/note/mmap maps one ring per CPU, laid out back to back.  Each ring
+ * starts with this control page and is followed by data_size bytes of
+ * note data at data_offset from the start of the page.
+ *
+ * data_head and data_tail are free running byte counters; the position in
+ * the data area is the counter modulo data_size, which is a power of two.
+ * Only the kernel writes data_head, and only the reader writes data_tail:
+ *
+ *   - The kernel writes a note after data_head, provided it fits before
+ *     data_tail + data_size, and then publishes the new data_head.
+ *     Notes that do not fit are dropped and counted in 'lost'.
+ *   - The reader loads data_head, issues a read barrier, consumes the
+ *     notes up to it (a note may wrap around the end of the data area)
+ *     and then stores data_tail after a full barrier.
+ *
+ * Every note starts with a struct note_common_s whose nc_length gives its
+ * size; notes are padded to NOTE_ALIGN().
+ */
+
+struct notemmap_page_s
+{
+  uint32_t magic;               /* NOTEMMAP_MAGIC */
+  uint32_t cpu;                 /* The CPU that writes this ring */
+  uint32_t data_offset;         /* Offset of the data from this page */
+  uint32_t data_size;           /* Size of the data area in bytes */
+  volatile uint32_t data_head;  /* Written by the kernel */
+  volatile uint32_t data_tail;  /* Written by the reader */
+  volatile uint32_t lost;       /* Notes dropped on a full ring */
+  uint32_t reserved[9];
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct notemmap_driver_s;
+
+extern struct notemmap_driver_s g_notemmap_driver;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#if defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT)
+
+/****************************************************************************
+ * Name: notemmap_register
+ *
+ * Description:
+ *   Register the mmap note driver at /dev/note/mmap.  An application maps
+ *   the per-CPU rings into its address space and consumes the note data
+ *   in place, without any system call per note.
+ *
+ * Input Parameters:
+ *   None.
+ *
+ * Returned Value:
+ *   Zero on success. A negated errno value is returned on a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRIVERS_NOTEMMAP
+int notemmap_register(void);
+#endif
+
+#endif /* defined(__KERNEL__) || defined(CONFIG_BUILD_FLAT) */
+
+#endif /* __INCLUDE_NUTTX_NOTE_NOTEMMAP_DRIVER_H */
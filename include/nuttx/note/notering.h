@@ -0,0 +1,168 @@
+/****************************************************************************
+ * include/nuttx/note/notering.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_NOTE_NOTERING_H
+#define __INCLUDE_NUTTX_NOTE_NOTERING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CONFIG_DRIVERS_NOTERING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The notes that are filtered while a sink does not keep up */
+
+#define NOTERING_SHED_NONE 0 /* Pass all notes */
+#define NOTERING_SHED_DUMP 1 /* Filter the dump, printf and heap notes */
+#define NOTERING_SHED_HOT  2 /* Filter all but the task and CPU notes too */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The ring of one CPU.  Only the CPU itself adds notes, with interrupts
+ * disabled, and only the drain of the sink removes them, so no lock is
+ * taken on either side.  head and tail are free running byte counts.
+ */
+
+struct notering_cpu_s
+{
+  volatile uint32_t head;  /* Bytes added */
+  volatile uint32_t tail;  /* Bytes drained */
+  uint32_t          lost;  /* Notes dropped because the ring was full */
+  uint32_t          shed;  /* Notes filtered while the sink lagged */
+  FAR uint8_t      *data;  /* size bytes of notes */
+};
+
+/* The rings of all CPUs feeding one sink */
+
+struct notering_s
+{
+  uint32_t              size;   /* Bytes per CPU, a power of two */
+  uint8_t               level;  /* One of NOTERING_SHED_* */
+  uint8_t               next;   /* CPU that is drained first next time */
+  uint32_t              lost;   /* Lost notes seen by the last adapt */
+  struct notering_cpu_s cpu[CONFIG_SMP_NCPUS];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#  define EXTERN extern "C"
+extern "C"
+{
+#else
+#  define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: notering_init
+ *
+ * Description:
+ *   Set up the rings over CONFIG_SMP_NCPUS * size bytes of data.
+ *
+ * Input Parameters:
+ *   ring - The rings to initialize
+ *   data - The storage of the rings
+ *   size - The size of the ring of each CPU, a power of two
+ *
+ ****************************************************************************/
+
+void notering_init(FAR struct notering_s *ring, FAR uint8_t *data,
+                   size_t size);
+
+/****************************************************************************
+ * Name: notering_add
+ *
+ * Description:
+ *   Append a note to the ring of this CPU.  This never blocks, a note that
+ *   does not fit is dropped and counted.
+ *
+ * Returned Value:
+ *   True if the note was added.
+ *
+ ****************************************************************************/
+
+bool notering_add(FAR struct notering_s *ring, FAR const void *note,
+                  size_t notelen);
+
+/****************************************************************************
+ * Name: notering_read
+ *
+ * Description:
+ *   Move as many whole notes as fit into the buffer, taking from the rings
+ *   of the CPUs in turn.  This must only be called by the one drain of the
+ *   sink.
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero if the rings are empty or the first
+ *   note does not fit.
+ *
+ ****************************************************************************/
+
+size_t notering_read(FAR struct notering_s *ring, FAR uint8_t *buffer,
+                     size_t buflen);
+
+/****************************************************************************
+ * Name: notering_adapt
+ *
+ * Description:
+ *   Called by the drain when it stops.  The notes left behind tell whether
+ *   the sink keeps up: the less important notes are filtered while the
+ *   rings stay more than three quarters full or notes were lost, and are
+ *   let through again once the rings are drained below one quarter.
+ *
+ ****************************************************************************/
+
+void notering_adapt(FAR struct notering_s *ring);
+
+/****************************************************************************
+ * Name: notering_dropped
+ *
+ * Description:
+ *   Return the total of the notes that were lost and that were shed.
+ *
+ ****************************************************************************/
+
+void notering_dropped(FAR struct notering_s *ring, FAR uint32_t *lost,
+                      FAR uint32_t *shed);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_DRIVERS_NOTERING */
+#endif /* __INCLUDE_NUTTX_NOTE_NOTERING_H */
@@ -551,6 +551,28 @@ int nx_block(NXWINDOW hwnd, FAR void *arg);
 
 int nx_synch(NXWINDOW hwnd, FAR void *arg);
 
+/****************************************************************************
+ * Name: nx_batch
+ *
+ * Description:
+ *   Enable or disable batch mode of a client connection.  In batch mode
+ *   the setpixel, fill, filltrapezoid and move requests are collected and
+ *   sent to the server together.  They are sent before any other request
+ *   of the client and when batch mode is disabled, so the order is kept.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect()
+ *   enable - True to collect the drawing requests, false to send them
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nx_batch(NXHANDLE handle, bool enable);
+#endif
+
 /****************************************************************************
  * Name: nx_requestbkgd
  *
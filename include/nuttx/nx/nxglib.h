@@ -507,6 +507,28 @@ void nxgl_circletraps(FAR const struct nxgl_point_s *center,
 uint32_t nxglib_rgb24_blend(uint32_t color1, uint32_t color2, ub16_t frac1);
 uint16_t nxglib_rgb565_blend(uint16_t color1, uint16_t color2, ub16_t frac1);
 
+/****************************************************************************
+ * Name: nxglib_argb32_alphablend and nxglib_rgb565_alphablend
+ *
+ * Description:
+ *   Alpha blend color1 over the opaque color2 with the opacity alpha
+ *   (0..255), working on all the components of the pixel at once.
+ *
+ * Input Parameters:
+ *   color1 - The foreground color
+ *   color2 - The opaque, background color
+ *   alpha  - The opacity of color1
+ *
+ * Returned Value:
+ *   The blended color
+ *
+ ****************************************************************************/
+
+uint32_t nxglib_argb32_alphablend(uint32_t color1, uint32_t color2,
+                                  uint8_t alpha);
+uint16_t nxglib_rgb565_alphablend(uint16_t color1, uint16_t color2,
+                                  uint8_t alpha);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
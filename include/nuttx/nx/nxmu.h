@@ -56,7 +56,14 @@
 #define NX_CLIENT_MQNAMEFMT  "nxc%d"
 #define NX_CLIENT_MXNAMELEN  (12)
 
-#define NX_MXSVRMSGLEN       (64) /* Maximum size of a client->server command */
+#ifdef CONFIG_NX_BATCH
+#  if CONFIG_NX_BATCH_MSGLEN > CONFIG_MQ_MAXMSGSIZE
+#    error "CONFIG_NX_BATCH_MSGLEN exceeds CONFIG_MQ_MAXMSGSIZE"
+#  endif
+#  define NX_MXSVRMSGLEN     CONFIG_NX_BATCH_MSGLEN
+#else
+#  define NX_MXSVRMSGLEN     (64) /* Maximum size of a client->server command */
+#endif
 #define NX_MXEVENTLEN        (64) /* Maximum size of an event */
 #define NX_MXCLIMSGLEN       (64) /* Maximum size of a server->client message */
 
@@ -95,6 +102,11 @@ struct nxmu_conn_s
 
   mqd_t crdmq;            /* MQ to read from the server (may be non-blocking) */
   mqd_t cwrmq;            /* MQ to write to the server (blocking) */
+#ifdef CONFIG_NX_BATCH
+  bool batch;             /* Collect the drawing messages, see nx_batch() */
+  uint16_t nbatch;        /* Bytes collected in batchbuf */
+  uintptr_t batchbuf[NX_MXSVRMSGLEN / sizeof(uintptr_t)];
+#endif
 
   /* These are only usable on the server side of the connection */
 
@@ -144,7 +156,8 @@ enum nxmsg_e
   NX_SVRMSG_SETBGCOLOR,       /* Set the color of the background */
   NX_SVRMSG_MOUSEIN,          /* New mouse report from mouse client */
   NX_SVRMSG_KBDIN,            /* New keyboard report from keyboard client */
-  NX_SVRMSG_REDRAWREQ         /* Request re-drawing of rectangular region */
+  NX_SVRMSG_REDRAWREQ,        /* Request re-drawing of rectangular region */
+  NX_SVRMSG_BATCH             /* A number of drawing messages in one */
 };
 
 /* Server-to-Client Message Structures **************************************/
@@ -522,6 +535,23 @@ struct nxsvrmsg_redrawreq_s
   struct nxgl_rect_s rect;         /* Describes the rectangular region to be redrawn */
 };
 
+#ifdef CONFIG_NX_BATCH
+/* A number of SETPIXEL, FILL, FILLTRAP and MOVE messages sent together.
+ * They follow the header back to back, each one padded to
+ * NX_BATCH_ALIGN() bytes, and the server performs them in order.
+ */
+
+#define NX_BATCH_ALIGN(n) \
+  (((n) + sizeof(uintptr_t) - 1) & ~(sizeof(uintptr_t) - 1))
+
+struct nxsvrmsg_batch_s
+{
+  uint32_t msgid;                  /* NX_SVRMSG_BATCH */
+  uint32_t nbytes;                 /* Bytes of messages after the header */
+  uintptr_t msgs[0];               /* The messages */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -584,6 +614,25 @@ int nxmu_start(int display, int plane);
 int nxmu_sendserver(FAR struct nxmu_conn_s *conn,
                     FAR const void *msg, size_t msglen);
 
+/****************************************************************************
+ * Name: nxmu_flushbatch
+ *
+ * Description:
+ *   Send the drawing messages collected by a client in batch mode to the
+ *   server as one NX_SVRMSG_BATCH message.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nxmu_flushbatch(FAR struct nxmu_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: nxmu_sendwindow
  *
@@ -27,6 +27,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <sched.h>
 #include <stdint.h>
 
 #include <nuttx/list.h>
@@ -834,6 +835,31 @@ void pci_release_irq(FAR struct pci_device_s *dev, FAR int *irq, int num);
 
 int pci_connect_irq(FAR struct pci_device_s *dev, FAR int *irq, int num);
 
+/****************************************************************************
+ * Name: pci_affinity_irq
+ *
+ * Description:
+ *   Route a vector connected by pci_connect_irq() to the CPUs in cpuset.
+ *   With MSI-X only the table entry of the vector is written again.  The
+ *   vectors of MSI share one message address, all of them are routed.
+ *
+ * Input Parameters:
+ *   dev    - PCI device
+ *   irq    - connected vectors
+ *   num    - number of vectors
+ *   index  - the vector to route
+ *   cpuset - the CPUs that may take the vector
+ *
+ * Return value:
+ *   OK on success or a negative errno on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PCI_IRQ_AFFINITY
+int pci_affinity_irq(FAR struct pci_device_s *dev, FAR int *irq, int num,
+                     int index, cpu_set_t cpuset);
+#endif
+
 /****************************************************************************
  * Name: pci_register_driver
  *
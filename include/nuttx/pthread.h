@@ -40,6 +40,17 @@
 
 #define PTHREAD_DEFAULT_POLICY SCHED_NORMAL
 
+/* The state word of a read/write lock, the readers and the writer take
+ * the lock with one atomic operation if nobody waits.  The wait flags are
+ * changed with the mutex of the lock held, RWLOCK_WWAIT is set while
+ * num_writers is not zero and keeps new readers out.
+ */
+
+#define RWLOCK_WRITER   (1 << 30)           /* A writer holds the lock */
+#define RWLOCK_WWAIT    (1 << 29)           /* Writers wait for the lock */
+#define RWLOCK_RWAIT    (1 << 28)           /* Readers wait for the lock */
+#define RWLOCK_READERS  (RWLOCK_RWAIT - 1)  /* Number of readers */
+
 /* A lot of hassle to use the old-fashioned struct initializers.  But this
  * gives us backward compatibility with some very old compilers.
  */
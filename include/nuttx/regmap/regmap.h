@@ -30,6 +30,7 @@
 #include <nuttx/compiler.h>
 
 #include <stdbool.h>
+#include <stddef.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -41,6 +42,20 @@
 
 struct regmap_bus_s;
 
+/* Type of the register cache of a map. */
+
+enum regcache_type_e
+{
+  REGCACHE_NONE = 0,   /* No cache, every access goes to the device */
+  REGCACHE_FLAT,       /* One entry for each register up to max_register */
+};
+
+/* Returns true if the value of the register changes on its own, e.g. a
+ * status or a data register, so that it must never be cached.
+ */
+
+typedef CODE bool (*regmap_volatile_t)(unsigned int reg);
+
 /* Single byte register read/write. */
 
 typedef CODE int (*reg_read_t)(FAR struct regmap_bus_s *bus,
@@ -100,6 +115,22 @@ struct regmap_config_s
    */
 
   bool disable_locking;
+
+  /* The largest valid register address, mandatory with a cache. */
+
+  unsigned int max_register;
+
+  /* The register cache, REGCACHE_NONE (0) unless set.  This needs
+   * CONFIG_REGMAP_CACHE.
+   */
+
+  enum regcache_type_e cache_type;
+
+  /* The registers that are never cached.  If NULL, all registers are
+   * cached.
+   */
+
+  regmap_volatile_t volatile_reg;
 };
 
 struct regmap_s;
@@ -312,6 +343,134 @@ int regmap_read(FAR struct regmap_s *map, unsigned int reg,
 int regmap_bulk_read(FAR struct regmap_s *map, unsigned int reg,
                      FAR void *val, unsigned int val_count);
 
+/****************************************************************************
+ * Name: regmap_update_bits
+ *
+ * Description:
+ *   Read-modify-write of the bits of mask in a register.  The value comes
+ *   from the cache if the register is cached, and nothing is written if
+ *   the bits do not change.
+ *
+ * Input Parameters:
+ *   map  - regmap handler, from regmap bus init function return.
+ *   reg  - register address to be updated.
+ *   mask - the bits to be updated.
+ *   val  - the new value of these bits.
+ *
+ * Returned Value:
+ *   Zero (OK) or positive on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int regmap_update_bits(FAR struct regmap_s *map, unsigned int reg,
+                       unsigned int mask, unsigned int val);
+
+/****************************************************************************
+ * Name: regmap_raw_write
+ *
+ * Description:
+ *   Write val_len bytes in the format of the device to the registers from
+ *   reg in one bus transfer.  The cached values of these registers are
+ *   dropped.
+ *
+ * Input Parameters:
+ *   map     - regmap handler, from regmap bus init function return.
+ *   reg     - first register address to be written.
+ *   val     - the data.
+ *   val_len - the length of the data in bytes.
+ *
+ * Returned Value:
+ *   Zero (OK) or positive on success; a negated errno value on failure.
+ *   -ENOSYS if the bus has no block write.
+ *
+ ****************************************************************************/
+
+int regmap_raw_write(FAR struct regmap_s *map, unsigned int reg,
+                     FAR const void *val, size_t val_len);
+
+/****************************************************************************
+ * Name: regmap_raw_write_async
+ *
+ * Description:
+ *   As regmap_raw_write(), but the data is copied and written later from
+ *   the low priority work queue, so that the caller does not wait for the
+ *   bus.  The writes are done in order; regmap_async_complete() waits for
+ *   them.  The map must not have been created with disable_locking.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_REGMAP_ASYNC
+int regmap_raw_write_async(FAR struct regmap_s *map, unsigned int reg,
+                           FAR const void *val, size_t val_len);
+
+/****************************************************************************
+ * Name: regmap_async_complete
+ *
+ * Description:
+ *   Wait until all writes queued by regmap_raw_write_async() are done.
+ *
+ * Returned Value:
+ *   Zero (OK) if all of them succeeded, otherwise the error of the first
+ *   one that failed.
+ *
+ ****************************************************************************/
+
+int regmap_async_complete(FAR struct regmap_s *map);
+#endif
+
+#ifdef CONFIG_REGMAP_CACHE
+
+/****************************************************************************
+ * Name: regcache_cache_only
+ *
+ * Description:
+ *   While enabled, writes of the cached registers only update the cache
+ *   and are marked dirty, accesses to the device fail with -EBUSY.  This
+ *   is for the time that the device is powered down.
+ *
+ ****************************************************************************/
+
+void regcache_cache_only(FAR struct regmap_s *map, bool enable);
+
+/****************************************************************************
+ * Name: regcache_cache_bypass
+ *
+ * Description:
+ *   While enabled, all accesses go to the device and the cache is left
+ *   alone.
+ *
+ ****************************************************************************/
+
+void regcache_cache_bypass(FAR struct regmap_s *map, bool enable);
+
+/****************************************************************************
+ * Name: regcache_mark_dirty
+ *
+ * Description:
+ *   Mark all cached registers dirty, e.g. after the device lost its
+ *   state, so that regcache_sync() writes all of them back.
+ *
+ ****************************************************************************/
+
+void regcache_mark_dirty(FAR struct regmap_s *map);
+
+/****************************************************************************
+ * Name: regcache_sync
+ *
+ * Description:
+ *   Write the dirty registers of the cache to the device, e.g. on resume.
+ *   Cache only mode must be off.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure, the registers
+ *   that were not written stay dirty.
+ *
+ ****************************************************************************/
+
+int regcache_sync(FAR struct regmap_s *map);
+
+#endif /* CONFIG_REGMAP_CACHE */
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
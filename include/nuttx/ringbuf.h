@@ -0,0 +1,387 @@
+/****************************************************************************
+ * include/nuttx/ringbuf.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_RINGBUF_H
+#define __INCLUDE_NUTTX_RINGBUF_H
+
+/* A lock-free byte ring for one consumer and either one producer (SPSC) or
+ * several producers (MPSC).
+ *
+ * head, claim and tail are free running 32-bit byte counters: the ring
+ * holds head - tail bytes and the offset in the buffer is the counter
+ * masked by size - 1, so the size must be a power of two.
+ *
+ *   - A single producer uses ringbuf_write() or ringbuf_write_reserve() and
+ *     ringbuf_write_commit().  It needs no lock at all.
+ *   - Several producers claim space with ringbuf_mp_reserve(), fill it with
+ *     ringbuf_copyat() and publish it with ringbuf_mp_commit().  Claims
+ *     are made with a compare and swap and are published in claim order,
+ *     so a producer must not be preempted by another producer of the same
+ *     ring between reserve and commit.  Masking the local interrupts is
+ *     enough for that, no producer ever waits for another CPU to release a
+ *     lock.
+ *   - The single consumer uses ringbuf_read() or ringbuf_read_peek() and
+ *     ringbuf_read_commit().  Several consumers must serialize themselves.
+ *
+ * The indices written by the producers and by the consumer are in
+ * different cache lines, so that they do not bounce between the CPUs on
+ * every access.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/param.h>
+#include <sys/types.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/compiler.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The alignment of the consumer index */
+
+#ifndef RINGBUF_ALIGN
+#  define RINGBUF_ALIGN 64
+#endif
+
+#define RINGBUF_INITIALIZER(base, size) { (base), (size) - 1 }
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct ringbuf_s
+{
+  FAR uint8_t *base;  /* The buffer space */
+  uint32_t     mask;  /* The size of the buffer space minus one */
+  atomic_t     head;  /* Published by the producers */
+  atomic_t     claim; /* Claimed by the producers */
+
+  /* Written by the consumer */
+
+  atomic_t tail aligned_data(RINGBUF_ALIGN);
+};
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ringbuf_init
+ *
+ * Description:
+ *   Initialize an empty ring with the buffer space provided by the caller.
+ *
+ * Input Parameters:
+ *   ring - The ring to initialize
+ *   base - The buffer space
+ *   size - The size of the buffer space, a power of two
+ *
+ ****************************************************************************/
+
+static inline_function void ringbuf_init(FAR struct ringbuf_s *ring,
+                                         FAR void *base, size_t size)
+{
+  ring->base = base;
+  ring->mask = size - 1;
+  atomic_set(&ring->head, 0);
+  atomic_set(&ring->claim, 0);
+  atomic_set(&ring->tail, 0);
+}
+
+/****************************************************************************
+ * Name: ringbuf_size
+ *
+ * Description:
+ *   Return the size of the buffer space.
+ *
+ ****************************************************************************/
+
+static inline_function size_t ringbuf_size(FAR struct ringbuf_s *ring)
+{
+  return (size_t)ring->mask + 1;
+}
+
+/****************************************************************************
+ * Name: ringbuf_used
+ *
+ * Description:
+ *   Return the number of published bytes that have not been consumed yet.
+ *   Only the consumer sees a value that cannot shrink behind its back.
+ *
+ ****************************************************************************/
+
+static inline_function size_t ringbuf_used(FAR struct ringbuf_s *ring)
+{
+  return (uint32_t)atomic_read_acquire(&ring->head) -
+         (uint32_t)atomic_read(&ring->tail);
+}
+
+/****************************************************************************
+ * Name: ringbuf_space
+ *
+ * Description:
+ *   Return the space that may be claimed by a producer.
+ *
+ ****************************************************************************/
+
+static inline_function size_t ringbuf_space(FAR struct ringbuf_s *ring)
+{
+  return ringbuf_size(ring) -
+         ((uint32_t)atomic_read(&ring->claim) -
+          (uint32_t)atomic_read_acquire(&ring->tail));
+}
+
+/****************************************************************************
+ * Name: ringbuf_is_empty
+ ****************************************************************************/
+
+static inline_function bool ringbuf_is_empty(FAR struct ringbuf_s *ring)
+{
+  return ringbuf_used(ring) == 0;
+}
+
+/****************************************************************************
+ * Name: ringbuf_write_reserve
+ *
+ * Description:
+ *   Return the free space after the head for a single producer to fill in
+ *   place.  The data becomes visible with ringbuf_write_commit().
+ *
+ * Input Parameters:
+ *   ring - The ring
+ *   len  - Returns the size of the contiguous free space
+ *
+ * Returned Value:
+ *   The start of the free space
+ *
+ ****************************************************************************/
+
+static inline_function
+FAR void *ringbuf_write_reserve(FAR struct ringbuf_s *ring,
+                                FAR size_t *len)
+{
+  uint32_t head = atomic_read(&ring->head);
+  uint32_t off = head & ring->mask;
+  size_t space = ringbuf_space(ring);
+
+  *len = MIN(space, ringbuf_size(ring) - off);
+  return ring->base + off;
+}
+
+/****************************************************************************
+ * Name: ringbuf_write_commit
+ *
+ * Description:
+ *   Publish 'len' bytes written by a single producer after the head.
+ *
+ ****************************************************************************/
+
+static inline_function void ringbuf_write_commit(FAR struct ringbuf_s *ring,
+                                                 size_t len)
+{
+  uint32_t head = (uint32_t)atomic_read(&ring->head) + len;
+
+  atomic_set(&ring->claim, head);
+  atomic_set_release(&ring->head, head);
+}
+
+/****************************************************************************
+ * Name: ringbuf_copyat
+ *
+ * Description:
+ *   Copy data into the ring at a position owned by the producer: the head
+ *   for a single producer, or a claim made by ringbuf_mp_reserve().
+ *
+ ****************************************************************************/
+
+static inline_function void ringbuf_copyat(FAR struct ringbuf_s *ring,
+                                           uint32_t pos,
+                                           FAR const void *buf,
+                                           size_t len)
+{
+  uint32_t off = pos & ring->mask;
+  size_t n = MIN(len, ringbuf_size(ring) - off);
+
+  memcpy(ring->base + off, buf, n);
+  memcpy(ring->base, (FAR const uint8_t *)buf + n, len - n);
+}
+
+/****************************************************************************
+ * Name: ringbuf_write
+ *
+ * Description:
+ *   Copy data into the ring as its single producer.
+ *
+ * Returned Value:
+ *   The number of bytes written, which is less than 'len' if the ring
+ *   runs full.
+ *
+ ****************************************************************************/
+
+static inline_function size_t ringbuf_write(FAR struct ringbuf_s *ring,
+                                            FAR const void *buf, size_t len)
+{
+  len = MIN(len, ringbuf_space(ring));
+  ringbuf_copyat(ring, atomic_read(&ring->head), buf, len);
+  ringbuf_write_commit(ring, len);
+  return len;
+}
+
+/****************************************************************************
+ * Name: ringbuf_mp_reserve
+ *
+ * Description:
+ *   Claim 'len' bytes of the ring for one of several producers.  Nothing
+ *   is claimed unless all of them fit.
+ *
+ * Input Parameters:
+ *   ring - The ring
+ *   len  - The number of bytes to claim
+ *   pos  - Returns the position of the claimed space
+ *
+ * Returned Value:
+ *   True if the space has been claimed
+ *
+ ****************************************************************************/
+
+static inline_function bool ringbuf_mp_reserve(FAR struct ringbuf_s *ring,
+                                               size_t len,
+                                               FAR uint32_t *pos)
+{
+  int32_t claim = atomic_read(&ring->claim);
+
+  do
+    {
+      if (len > ringbuf_size(ring) -
+                ((uint32_t)claim -
+                 (uint32_t)atomic_read_acquire(&ring->tail)))
+        {
+          return false;
+        }
+    }
+  while (!atomic_try_cmpxchg_relaxed(&ring->claim, &claim,
+                                     (int32_t)((uint32_t)claim + len)));
+
+  *pos = claim;
+  return true;
+}
+
+/****************************************************************************
+ * Name: ringbuf_mp_commit
+ *
+ * Description:
+ *   Publish the space claimed by ringbuf_mp_reserve().  The claims made
+ *   earlier by other producers are published first, so this waits until
+ *   their producers, which run on other CPUs, commit them.
+ *
+ ****************************************************************************/
+
+static inline_function void ringbuf_mp_commit(FAR struct ringbuf_s *ring,
+                                              uint32_t pos, size_t len)
+{
+  while ((uint32_t)atomic_read(&ring->head) != pos)
+    {
+      /* Another CPU is still copying its claim */
+    }
+
+  atomic_set_release(&ring->head, (int32_t)(pos + len));
+}
+
+/****************************************************************************
+ * Name: ringbuf_read_peek
+ *
+ * Description:
+ *   Return the published data after the tail for the consumer to process
+ *   in place.  The space is returned with ringbuf_read_commit().
+ *
+ * Input Parameters:
+ *   ring - The ring
+ *   len  - Returns the size of the contiguous data
+ *
+ * Returned Value:
+ *   The start of the data
+ *
+ ****************************************************************************/
+
+static inline_function
+FAR void *ringbuf_read_peek(FAR struct ringbuf_s *ring, FAR size_t *len)
+{
+  uint32_t tail = atomic_read(&ring->tail);
+  uint32_t off = tail & ring->mask;
+  size_t used = ringbuf_used(ring);
+
+  *len = MIN(used, ringbuf_size(ring) - off);
+  return ring->base + off;
+}
+
+/****************************************************************************
+ * Name: ringbuf_read_commit
+ *
+ * Description:
+ *   Return 'len' bytes consumed after the tail to the producers.
+ *
+ ****************************************************************************/
+
+static inline_function void ringbuf_read_commit(FAR struct ringbuf_s *ring,
+                                                size_t len)
+{
+  atomic_set_release(&ring->tail,
+                     (int32_t)((uint32_t)atomic_read(&ring->tail) + len));
+}
+
+/****************************************************************************
+ * Name: ringbuf_read
+ *
+ * Description:
+ *   Copy data out of the ring as its consumer.
+ *
+ * Returned Value:
+ *   The number of bytes read, which is less than 'len' if the ring runs
+ *   empty.
+ *
+ ****************************************************************************/
+
+static inline_function size_t ringbuf_read(FAR struct ringbuf_s *ring,
+                                           FAR void *buf, size_t len)
+{
+  uint32_t off = (uint32_t)atomic_read(&ring->tail) & ring->mask;
+  size_t n;
+
+  len = MIN(len, ringbuf_used(ring));
+  n   = MIN(len, ringbuf_size(ring) - off);
+  memcpy(buf, ring->base + off, n);
+  memcpy((FAR uint8_t *)buf + n, ring->base, len - n);
+  ringbuf_read_commit(ring, len);
+  return len;
+}
+
+#endif /* __INCLUDE_NUTTX_RINGBUF_H */
@@ -118,6 +118,31 @@ static inline_function bool rpmsg_is_running(FAR struct rpmsg_device *rdev)
   return rpmsg_get_signals(rdev) & RPMSG_SIGNAL_RUNNING;
 }
 
+/****************************************************************************
+ * Name: rpmsg_send_tx_payload
+ *
+ * Description:
+ *   Send a message that was built in place in a buffer returned by
+ *   rpmsg_get_tx_payload_buffer(), so the payload is never copied.  On
+ *   failure the buffer is handed back to the transport, the caller must
+ *   not touch it again in either case.
+ *
+ ****************************************************************************/
+
+static inline_function int
+rpmsg_send_tx_payload(FAR struct rpmsg_endpoint *ept,
+                      FAR void *data, uint32_t len)
+{
+  int ret = rpmsg_send_nocopy(ept, data, len);
+
+  if (ret < 0)
+    {
+      rpmsg_release_tx_buffer(ept, data);
+    }
+
+  return ret;
+}
+
 int rpmsg_register_callback(FAR void *priv,
                             rpmsg_dev_cb_t device_created,
                             rpmsg_dev_cb_t device_destroy,
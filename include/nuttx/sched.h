@@ -45,6 +45,7 @@
 #include <nuttx/event.h>
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/mm/map.h>
 #include <nuttx/tls.h>
@@ -214,6 +215,12 @@
 
 #define SMP_CALL_INITIALIZER(func, arg) {(func), (arg)}
 
+/* The capacity of a CPU that runs at full speed */
+
+#ifdef CONFIG_SCHED_CPU_CAPACITY
+#  define SCHED_CAPACITY_SCALE       1024
+#endif
+
 /* These are macros to access the current CPU and the current task on a CPU.
  * These macros are intended to support a future SMP implementation.
  */
@@ -516,6 +523,7 @@ struct task_group_s
 
   sq_queue_t tg_sigactionq;         /* List of actions for signals              */
   sq_queue_t tg_sigpendingq;        /* List of pending signals                  */
+  sigset_t tg_sigpendset;           /* Signals in tg_sigpendingq                */
 #ifdef CONFIG_SIG_DEFAULT
   sigset_t tg_sigdefault;           /* Set of signals set to the default action */
 #endif
@@ -631,6 +639,9 @@ struct tcb_s
 #endif
 
   struct wdog_s waitdog;                 /* All timed waits use this timer  */
+#ifdef CONFIG_HRTIMER
+  hrtimer_t waithrtimer;                 /* Timer of the signal waits       */
+#endif
 
   /* Stack-Related Fields ***************************************************/
 
@@ -673,6 +684,12 @@ struct tcb_s
   spinlock_t mhead_lock;
 #endif
 
+  /* Poll support ***********************************************************/
+
+#ifdef CONFIG_FS_POLL_CACHE
+  FAR struct pollcache_s *pollcache;     /* Poll set of the last poll()     */
+#endif
+
   /* CPU load monitoring support ********************************************/
 
 #ifndef CONFIG_SCHED_CPULOAD_NONE
@@ -701,6 +718,35 @@ struct tcb_s
   void   *crit_max_caller;               /* Caller of max critical section  */
 #endif
 
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+  clock_t crit_wait;                     /* Time spent waiting for csection */
+#endif
+
+#ifdef CONFIG_SCHED_PMU
+  uint64_t pmu_count[CONFIG_SCHED_PMU_NCOUNTERS]; /* Hardware event counts */
+#endif
+
+  /* Resource accounting ****************************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+  clock_t  ready_time;                   /* When it last became ready       */
+#endif
+
+#ifdef CONFIG_SCHED_PRESSURE
+  uint8_t  pressure;                     /* What the task is stalled on     */
+#endif
+
+#ifdef CONFIG_SCHED_RUSAGE
+  uint32_t nvcsw;                        /* Voluntary context switches      */
+  uint32_t nivcsw;                       /* Involuntary context switches    */
+  uint64_t rchar;                        /* Bytes read from files           */
+  uint64_t wchar;                        /* Bytes written to files          */
+  uint64_t sockrx;                       /* Bytes received on sockets       */
+  uint64_t socktx;                       /* Bytes sent on sockets           */
+  size_t   heapused;                     /* Heap bytes owned by the thread  */
+  size_t   heappeak;                     /* Peak of heapused                */
+#endif
+
   /* State save areas *******************************************************/
 
   /* The form and content of these fields are platform-specific.            */
@@ -726,6 +772,12 @@ struct tcb_s
   size_t level_deepest;
   size_t level;
 #endif
+
+#ifdef CONFIG_SCHED_FTRACE
+  uint8_t ftrace_depth;
+  uintptr_t ftrace_func[CONFIG_SCHED_FTRACE_GRAPH_DEPTH];
+  clock_t ftrace_time[CONFIG_SCHED_FTRACE_GRAPH_DEPTH];
+#endif
 };
 
 /* struct pthread_tcb_s *****************************************************/
@@ -800,6 +852,72 @@ struct smp_call_data_s
 };
 #endif
 
+/* Usage of the critical section by one enter_critical_section() caller */
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+struct critmon_site_s
+{
+  FAR void *caller;                 /* Caller of enter_critical_section   */
+  uint32_t  count;                  /* Number of outermost entries        */
+  uint32_t  contended;              /* Entries that had to wait           */
+  clock_t   total;                  /* Total holding time                 */
+  clock_t   max;                    /* Max holding time                   */
+  clock_t   wait;                   /* Total time waiting for the lock    */
+};
+#endif
+
+/* One call stack seen by the sampling profiler, innermost frame first */
+
+#ifdef CONFIG_SCHED_SAMPLER
+struct sched_sample_s
+{
+  pid_t     pid;                    /* The task that was running          */
+  uint8_t   depth;                  /* Number of valid pcs[]              */
+  uint32_t  count;                  /* Times sampled, zero if unused      */
+  FAR void *pcs[CONFIG_SCHED_SAMPLER_DEPTH];
+};
+#endif
+
+/* The latency histograms kept per CPU.  Each power of two is split in
+ * 1 << SCHED_LATENCY_SUBBITS buckets, the values are clamped to 32 bits.
+ */
+
+#ifdef CONFIG_SCHED_LATENCY
+#define SCHED_LATENCY_SUBBITS   2
+#define SCHED_LATENCY_NBUCKETS  ((33 - SCHED_LATENCY_SUBBITS) << \
+                                 SCHED_LATENCY_SUBBITS)
+
+enum sched_latency_e
+{
+  SCHED_LATENCY_IRQ = 0,            /* Interrupt handler run time         */
+  SCHED_LATENCY_WAKEUP,             /* Ready to run until running         */
+  SCHED_LATENCY_WDOG,               /* Watchdog expiry lateness           */
+  SCHED_LATENCY_WORK,               /* Work queue expiry until execution  */
+  SCHED_LATENCY_NTYPES
+};
+#endif
+
+/* The resources whose stalls are tracked, and what is known of one of them:
+ * the time during which at least one task was stalled on it, and the
+ * share of the last 10, 60 and 300 seconds that were stalled.
+ */
+
+#ifdef CONFIG_SCHED_PRESSURE
+enum sched_pressure_e
+{
+  SCHED_PRESSURE_CPU = 0,           /* Ready to run but not running       */
+  SCHED_PRESSURE_IO,                /* Blocked in a storage I/O call      */
+  SCHED_PRESSURE_NET,               /* Waiting for a network buffer       */
+  SCHED_PRESSURE_NRES
+};
+
+struct sched_pressure_s
+{
+  uint64_t total;                   /* Stalled time in microseconds       */
+  uint32_t avg[3];                  /* In hundredths of a percent         */
+};
+#endif
+
 #endif /* __ASSEMBLY__ */
 
 /****************************************************************************
@@ -826,6 +944,11 @@ EXTERN clock_t g_preemp_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_CSECTION >= 0 */
 
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+EXTERN struct critmon_site_s
+g_crit_sites[CONFIG_SCHED_CRITMONITOR_CSECTION_SITES];
+#endif
+
 /* g_running_tasks[] holds a references to the running task for each CPU.
  * It is valid only when up_interrupt_context() returns true.
  */
@@ -1813,6 +1936,164 @@ void nxsched_sleep(unsigned int sec);
 int nxsched_nanosleep(FAR const struct timespec *rqtp,
                       FAR struct timespec *rmtp);
 
+/****************************************************************************
+ * Name: nxsched_sampler_start, nxsched_sampler_stop, nxsched_sampler_reset
+ *
+ * Description:
+ *   Control the system wide sampling profiler.  While it runs, the call
+ *   stack of the task running on each CPU is recorded
+ *   CONFIG_SCHED_SAMPLER_FREQ times per second.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_SAMPLER
+int nxsched_sampler_start(void);
+void nxsched_sampler_stop(void);
+void nxsched_sampler_reset(void);
+
+/****************************************************************************
+ * Name: nxsched_sampler_read
+ *
+ * Description:
+ *   Copy slot index, 0 to CONFIG_SCHED_SAMPLER_NSTACKS - 1, of the call
+ *   stacks sampled on cpu.  An unused slot has a count of zero.
+ *
+ * Returned Value:
+ *   OK, or -EINVAL for a bad cpu or index.
+ *
+ ****************************************************************************/
+
+int nxsched_sampler_read(int cpu, int index,
+                         FAR struct sched_sample_s *sample);
+uint32_t nxsched_sampler_dropped(void);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_pmu_setup
+ *
+ * Description:
+ *   Program the hardware event counters of every CPU to count events, an
+ *   array of nevents PMU_EVENT_* values, and clear the counts of all CPUs
+ *   and tasks.  Zero events stops the counting.
+ *
+ * Returned Value:
+ *   OK, -E2BIG if there are more events than counters, or -ENOTSUP if
+ *   one of them cannot be counted.  Nothing is counted after a failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PMU
+int nxsched_pmu_setup(FAR const int *events, int nevents);
+
+/****************************************************************************
+ * Name: nxsched_pmu_event, nxsched_pmu_name
+ *
+ * Description:
+ *   The event that counter 0 to CONFIG_SCHED_PMU_NCOUNTERS - 1 counts,
+ *   PMU_EVENT_NONE if it is not in use, and the name of an event.
+ *
+ ****************************************************************************/
+
+int nxsched_pmu_event(int counter);
+FAR const char *nxsched_pmu_name(int event);
+
+/****************************************************************************
+ * Name: nxsched_pmu_cpu, nxsched_pmu_task
+ *
+ * Description:
+ *   Copy the CONFIG_SCHED_PMU_NCOUNTERS event counts of a CPU, or of a
+ *   task, into counts.  The counts of a task that runs on another CPU
+ *   are those of its last context switch.
+ *
+ ****************************************************************************/
+
+int nxsched_pmu_cpu(int cpu, FAR uint64_t *counts);
+void nxsched_pmu_task(FAR struct tcb_s *tcb, FAR uint64_t *counts);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_rusage_heap
+ *
+ * Description:
+ *   Add size, negative when a chunk is freed, to the heap usage of the
+ *   task that owns the chunk.  Nothing is done if pid has exited.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_RUSAGE
+void nxsched_rusage_heap(pid_t pid, ssize_t size);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_latency_read
+ *
+ * Description:
+ *   Copy the SCHED_LATENCY_NBUCKETS counts of the histogram type, one of
+ *   enum sched_latency_e, of a CPU.  nxsched_latency_bound() gives the
+ *   lower bound of a bucket in nanoseconds.
+ *
+ * Returned Value:
+ *   OK, or -EINVAL for a bad type or cpu.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+int nxsched_latency_read(int type, int cpu, FAR uint32_t *counts);
+uint64_t nxsched_latency_bound(int type, int bucket);
+FAR const char *nxsched_latency_name(int type);
+void nxsched_latency_reset(void);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_pressure_enter, nxsched_pressure_leave
+ *
+ * Description:
+ *   Bracket a wait of the calling task for the resource type, one of
+ *   enum sched_pressure_e.  The CPU waits are tracked by the scheduler
+ *   itself, and the storage waits once nxsched_pressure_io_begin() marked
+ *   the task.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PRESSURE
+void nxsched_pressure_enter(int type);
+void nxsched_pressure_leave(int type);
+bool nxsched_pressure_io_begin(void);
+void nxsched_pressure_io_end(bool marked);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_pressure_read
+ *
+ * Description:
+ *   Bring the stall information of the resource type up to date and copy
+ *   it.
+ *
+ * Returned Value:
+ *   OK, or -EINVAL for a bad type.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_PRESSURE
+int nxsched_pressure_read(int type, FAR struct sched_pressure_s *info);
+#endif
+
+/****************************************************************************
+ * Name: nxsched_set_cpu_capacity
+ *
+ * Description:
+ *   Set the capacity of the CPU, up to SCHED_CAPACITY_SCALE.  The tasks
+ *   that become ready to run prefer the CPUs with more capacity.
+ *
+ * Returned Value:
+ *   OK, or -EINVAL for a bad CPU or capacity.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPU_CAPACITY
+int nxsched_set_cpu_capacity(int cpu, unsigned int capacity);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -632,6 +632,51 @@ extern "C"
 void sensor_remap_vector_raw16(FAR const int16_t *in, FAR int16_t *out,
                                int place);
 
+/****************************************************************************
+ * Name: sensor_batch_latency
+ *
+ * Description:
+ *   Clamp a requested batch latency for a lower half whose hardware FIFO
+ *   holds fifo_depth samples at the current interval: a latency shorter
+ *   than one sample is raised to one interval, a latency the FIFO can't
+ *   hold is cut down to fifo_depth intervals.  Zero (batch off) is kept.
+ *
+ * Input Parameters:
+ *   latency_us - The latency asked by the upper half, updated in place.
+ *   interval   - The sample interval in us.
+ *   fifo_depth - The number of samples the hardware FIFO can hold.
+ *
+ * Returned Value:
+ *   The number of samples to collect per batch, zero if not batching.
+ *
+ ****************************************************************************/
+
+uint32_t sensor_batch_latency(FAR uint32_t *latency_us, uint32_t interval,
+                              uint32_t fifo_depth);
+
+/****************************************************************************
+ * Name: sensor_batch_timestamp
+ *
+ * Description:
+ *   Give timestamps to n samples drained from a hardware FIFO in one go.
+ *   Only the time of the newest sample is known (the watermark interrupt),
+ *   the older ones are spaced back from it by the sample interval.  Every
+ *   uORB sample structure starts with its uint64_t timestamp, so the
+ *   samples can be stamped in place before calling push_event() once for
+ *   the whole batch.
+ *
+ * Input Parameters:
+ *   data     - The samples, oldest first.
+ *   esize    - The size of one sample.
+ *   n        - The number of samples.
+ *   newest   - The timestamp of the last sample.
+ *   interval - The sample interval in us.
+ *
+ ****************************************************************************/
+
+void sensor_batch_timestamp(FAR void *data, size_t esize, uint32_t n,
+                            uint64_t newest, uint32_t interval);
+
 /****************************************************************************
  * "Upper Half" Sensor Driver Interfaces
  ****************************************************************************/
@@ -546,6 +546,21 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_dmapos
+ *
+ * Description:
+ *  For a lower half running a circular DMA over the whole RX circular
+ *  buffer: account for the data up to 'pos', the offset the DMA will write
+ *  next.  Called from the half transfer, full transfer and line idle
+ *  interrupts in place of uart_recvchars_dma()/uart_recvchars_done().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_dmapos(FAR uart_dev_t *dev, size_t pos);
+#endif
+
 /****************************************************************************
  * Name: uart_reset_sem
  *
@@ -34,6 +34,7 @@
 #include <stdbool.h>
 
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/queue.h>
 #include <nuttx/spi/spi.h>
 
 #ifdef CONFIG_SPI_EXCHANGE
@@ -114,6 +115,26 @@ struct spi_sequence_s
   FAR struct spi_trans_s *trans;
 };
 
+#ifdef CONFIG_SPI_ASYNC
+/* A sequence queued with spi_transfer_async(), callback gets the result of
+ * spi_transfer() on the thread of the bus queue.
+ */
+
+struct spi_request_s;
+typedef CODE void (*spi_callback_t)(FAR struct spi_request_s *req,
+                                    int result);
+
+struct spi_request_s
+{
+  sq_entry_t node;                 /* Used by the bus queue */
+  FAR struct spi_sequence_s *seq;  /* The sequence to transfer */
+  spi_callback_t callback;         /* Called when the sequence is done */
+  FAR void *priv;                  /* For use by the caller */
+};
+
+struct spi_async_s;
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -163,6 +184,60 @@ int spi_transfer(FAR struct spi_dev_s *spi, FAR struct spi_sequence_s *seq);
 int spi_register(FAR struct spi_dev_s *spi, int bus);
 #endif
 
+#ifdef CONFIG_SPI_ASYNC
+
+/****************************************************************************
+ * Name: spi_async_initialize
+ *
+ * Description:
+ *   Create the request queue of a SPI bus and its thread.
+ *
+ * Input Parameters:
+ *   dev - The SPI bus the requests are sent to
+ *
+ * Returned Value:
+ *   The queue handle on success, NULL if out of memory.
+ *
+ ****************************************************************************/
+
+FAR struct spi_async_s *spi_async_initialize(FAR struct spi_dev_s *dev);
+
+/****************************************************************************
+ * Name: spi_async_uninitialize
+ *
+ * Description:
+ *   Destroy a queue created by spi_async_initialize(), the pending
+ *   requests complete with -ECANCELED.
+ *
+ * Input Parameters:
+ *   bus - The queue handle
+ *
+ ****************************************************************************/
+
+void spi_async_uninitialize(FAR struct spi_async_s *bus);
+
+/****************************************************************************
+ * Name: spi_transfer_async
+ *
+ * Description:
+ *   Queue a sequence for spi_transfer() and return at once, the callback
+ *   of the request gets the result.  May be called from an interrupt
+ *   handler.
+ *
+ * Input Parameters:
+ *   bus - The queue handle
+ *   req - The request, with seq and callback set
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int spi_transfer_async(FAR struct spi_async_s *bus,
+                       FAR struct spi_request_s *req);
+
+#endif /* CONFIG_SPI_ASYNC */
+
 #undef EXTERN
 #if defined(__cplusplus)
 #define EXTERN extern "C"
@@ -92,7 +92,7 @@ void sched_note_spinlock_unlock(FAR volatile spinlock_t *spinlock);
 
 #if defined(CONFIG_ARCH_HAVE_TESTSET)
 spinlock_t up_testset(FAR volatile spinlock_t *lock);
-#else
+#elif !defined(CONFIG_QUEUED_SPINLOCK)
 static inline spinlock_t up_testset(FAR volatile spinlock_t *lock)
 {
   irqstate_t flags;
@@ -113,6 +113,24 @@ static inline spinlock_t up_testset(FAR volatile spinlock_t *lock)
 }
 #endif
 
+/****************************************************************************
+ * Name: spin_lock_queued
+ *
+ * Description:
+ *   The slow path of spin_lock() with CONFIG_QUEUED_SPINLOCK.  The waiters
+ *   queue up in the order of arrival and each spins on a flag of its own
+ *   CPU, so that the release does not pull the cache line of the lock into
+ *   every waiting CPU at once.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_QUEUED_SPINLOCK
+void spin_lock_queued(FAR volatile spinlock_t *lock);
+#endif
+
 /****************************************************************************
  * Name: spin_lock_init
  *
@@ -176,6 +194,14 @@ static inline_function void rspin_lock_init(FAR rspinlock_t *lock)
 #ifdef CONFIG_SPINLOCK
 static inline_function void spin_lock_notrace(FAR volatile spinlock_t *lock)
 {
+#if defined(CONFIG_QUEUED_SPINLOCK)
+  uint32_t val = 0;
+
+  if (!atomic_cmpxchg(&lock->val, &val, SP_QUEUED_LOCKED))
+    {
+      spin_lock_queued(lock);
+    }
+#else
 #ifdef CONFIG_TICKET_SPINLOCK
   int ticket = atomic_fetch_add(&lock->next, 1);
   while (atomic_read(&lock->owner) != ticket)
@@ -186,6 +212,7 @@ static inline_function void spin_lock_notrace(FAR volatile spinlock_t *lock)
       UP_DSB();
       UP_WFE();
     }
+#endif /* CONFIG_QUEUED_SPINLOCK */
 
   UP_DMB();
 }
@@ -261,7 +288,11 @@ static inline_function void spin_lock(FAR volatile spinlock_t *lock)
 static inline_function bool
 spin_trylock_notrace(FAR volatile spinlock_t *lock)
 {
-#ifdef CONFIG_TICKET_SPINLOCK
+#if defined(CONFIG_QUEUED_SPINLOCK)
+  uint32_t val = 0;
+
+  if (!atomic_cmpxchg(&lock->val, &val, SP_QUEUED_LOCKED))
+#elif defined(CONFIG_TICKET_SPINLOCK)
   if (!atomic_cmpxchg(&lock->next, &lock->owner,
                       atomic_read(&lock->next) + 1))
 #else /* CONFIG_TICKET_SPINLOCK */
@@ -350,7 +381,9 @@ static inline_function void
 spin_unlock_notrace(FAR volatile spinlock_t *lock)
 {
   UP_DMB();
-#ifdef CONFIG_TICKET_SPINLOCK
+#if defined(CONFIG_QUEUED_SPINLOCK)
+  atomic_fetch_and(&lock->val, ~SP_QUEUED_LOCKED);
+#elif defined(CONFIG_TICKET_SPINLOCK)
   atomic_fetch_add(&lock->owner, 1);
 #else
   *lock = SP_UNLOCKED;
@@ -380,7 +413,8 @@ spin_unlock_notrace(FAR volatile spinlock_t *lock)
  ****************************************************************************/
 
 #ifdef CONFIG_SPINLOCK
-#  ifdef __SP_UNLOCK_FUNCTION
+#  if defined(__SP_UNLOCK_FUNCTION) || defined(CONFIG_TICKET_SPINLOCK) || \
+      defined(CONFIG_QUEUED_SPINLOCK)
 static inline_function void spin_unlock(FAR volatile spinlock_t *lock)
 {
   /* Unlock without trace note */
@@ -413,7 +447,10 @@ static inline_function void spin_unlock(FAR volatile spinlock_t *lock)
  ****************************************************************************/
 
 /* bool spin_islocked(FAR spinlock_t lock); */
-#ifdef CONFIG_TICKET_SPINLOCK
+#if defined(CONFIG_QUEUED_SPINLOCK)
+#  define spin_is_locked(l) \
+    ((atomic_read(&(*l).val) & SP_QUEUED_LOCKED) != 0)
+#elif defined(CONFIG_TICKET_SPINLOCK)
 #  define spin_is_locked(l) \
     (atomic_read(&(*l).owner) != atomic_read(&(*l).next))
 #else
@@ -65,6 +65,23 @@ typedef struct spinlock_s
 #  define SP_UNLOCKED (spinlock_t){0, 0}
 #  define SP_LOCKED   (spinlock_t){0, 1}
 
+#elif defined(CONFIG_QUEUED_SPINLOCK)
+
+/* Bit 0 of val is the lock, the bits above SP_QUEUED_TAIL_SHIFT hold the
+ * index plus one of the CPU at the tail of the waiters.
+ */
+
+typedef struct spinlock_s
+{
+  uint32_t val;
+} spinlock_t;
+
+#  define SP_UNLOCKED (spinlock_t){0}
+#  define SP_LOCKED   (spinlock_t){1}
+
+#  define SP_QUEUED_LOCKED     1
+#  define SP_QUEUED_TAIL_SHIFT 8
+
 #else
 
 /* The architecture specific spinlock.h header file must also provide the
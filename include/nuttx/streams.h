@@ -820,6 +820,18 @@ int lib_sprintf(FAR struct lib_outstream_s *stream,
 int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
                  FAR const void *buf);
 
+/****************************************************************************
+ * Name: lib_vbspack
+ *
+ * Description:
+ *  Pack the arguments of fmt into buf in the layout lib_bsprintf() reads,
+ *  so that they can be formatted later.  Returns the size used or -E2BIG.
+ *
+ ****************************************************************************/
+
+ssize_t lib_vbspack(FAR void *buf, size_t size, FAR const IPTR char *fmt,
+                    va_list ap);
+
 /****************************************************************************
  * Name: lib_sprintf_internal
  *
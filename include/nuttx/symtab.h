@@ -29,6 +29,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -77,7 +79,8 @@ extern "C"
  *   Find the symbol in the symbol table with the matching name.
  *   The implementation will be linear with respect to nsyms if
  *   CONFIG_SYMTAB_ORDEREDBYNAME is not selected, and logarithmic
- *   if it is.
+ *   if it is.  With CONFIG_SYMTAB_ORDEREDBYHASH the table is searched by
+ *   the hash of the name, which takes a few probes on average.
  *
  * Returned Value:
  *   A reference to the symbol table entry if an entry with the matching
@@ -121,6 +124,34 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
 
 void symtab_sortbyname(FAR struct symtab_s *symtab, int nsyms);
 
+#ifdef CONFIG_SYMTAB_ORDEREDBYHASH
+
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the 32-bit FNV-1a hash of a symbol name.  tools/mksymtab -h
+ *   orders the generated tables with the same function.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name);
+
+/****************************************************************************
+ * Name: symtab_sortbyhash
+ *
+ * Description:
+ *   Sort the symbol table by the hash of the names, names with the same
+ *   hash by name.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void symtab_sortbyhash(FAR struct symtab_s *symtab, int nsyms);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -27,6 +27,9 @@
  * Included Files
  ****************************************************************************/
 
+#include <sys/types.h>
+#include <stdint.h>
+
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/wqueue.h>
@@ -58,6 +61,7 @@
  ****************************************************************************/
 
 struct thermal_cooling_device_ops_s;
+struct thermal_dvfs_s;
 struct thermal_zone_device_ops_s;
 struct thermal_zone_device_s;
 struct thermal_zone_params_s;
@@ -202,6 +206,16 @@ thermal_zone_device_unregister(
 void
 thermal_zone_device_update  (FAR struct thermal_zone_device_s *zdev);
 
+/* DVFS Governor */
+
+#ifdef CONFIG_THERMAL_DVFS
+FAR struct thermal_dvfs_s *
+thermal_dvfs_register(FAR const char *name, FAR const char *clkname,
+                      cpu_set_t cpus, FAR const uint32_t *freqs,
+                      unsigned int nfreqs);
+void thermal_dvfs_unregister(FAR struct thermal_dvfs_s *dvfs);
+#endif
+
 /* Thermal Framework initialization */
 
 int thermal_init(void);
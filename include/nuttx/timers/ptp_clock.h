@@ -53,6 +53,14 @@
 #define PTP_CLOCK_SETSTATS       _PTPIOC(0xd)
 #define PTP_CLOCK_GETSTATS       _PTPIOC(0xe)
 
+/* Discipline CLOCK_REALTIME from this clock in the kernel, see
+ * CONFIG_PTP_CLOCK_SERVO.  arg: pointer to an int holding the offset of
+ * CLOCK_REALTIME from the PTP clock in seconds, -37 for a PTP clock that
+ * runs in TAI for example, or NULL to stop.
+ */
+
+#define PTP_CLOCK_SYNCSYSTEM     _PTPIOC(0xf)
+
 /* Maximum allowed offset measurement samples. */
 
 #define PTP_MAX_SAMPLES          25
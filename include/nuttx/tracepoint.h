@@ -0,0 +1,144 @@
+/****************************************************************************
+ * include/nuttx/tracepoint.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_TRACEPOINT_H
+#define __INCLUDE_NUTTX_TRACEPOINT_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/sched_note.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The tracepoints of the hot paths, as TRACEPOINT(id, name).  A new one is
+ * added here and placed with tracepoint(id, ...) in the code.
+ */
+
+#define TRACEPOINT_LIST(TRACEPOINT) \
+  TRACEPOINT(SCHED_SWITCH, "sched_switch") \
+  TRACEPOINT(IRQ_DISPATCH, "irq_dispatch") \
+  TRACEPOINT(NET_INPUT,    "net_input") \
+  TRACEPOINT(FS_READ,      "fs_read") \
+  TRACEPOINT(FS_WRITE,     "fs_write")
+
+/* A disabled tracepoint costs the load of its key and a branch that is
+ * predicted not taken, the note is formatted out of line.  Without
+ * CONFIG_SCHED_TRACEPOINTS the tracepoints are compiled out.
+ */
+
+#ifdef CONFIG_SCHED_TRACEPOINTS
+#  define tracepoint_enabled(id) \
+     predict_false(g_tracepoint_keys[TRACEPOINT_##id] != 0)
+#  define tracepoint(id, tag, fmt, ...) \
+     do \
+       { \
+         if (tracepoint_enabled(id)) \
+           { \
+             sched_note_printf(tag, fmt, ##__VA_ARGS__); \
+           } \
+       } \
+     while (0)
+#else
+#  define tracepoint_enabled(id) false
+#  define tracepoint(id, tag, fmt, ...)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#define TRACEPOINT_ENUM(id, name) TRACEPOINT_##id,
+
+enum tracepoint_e
+{
+  TRACEPOINT_LIST(TRACEPOINT_ENUM)
+  TRACEPOINT_NKEYS
+};
+
+#undef TRACEPOINT_ENUM
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_SCHED_TRACEPOINTS
+/* The keys are kept together so that the enabled ones share a cache line */
+
+EXTERN uint8_t g_tracepoint_keys[TRACEPOINT_NKEYS];
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_TRACEPOINTS
+
+/****************************************************************************
+ * Name: tracepoint_name
+ *
+ * Description:
+ *   Return the name of the tracepoint id.
+ *
+ ****************************************************************************/
+
+FAR const char *tracepoint_name(int id);
+
+/****************************************************************************
+ * Name: tracepoint_enable
+ *
+ * Description:
+ *   Enable or disable the tracepoint called name, or all of them if name is
+ *   "all".
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOENT if there is no such tracepoint.
+ *
+ ****************************************************************************/
+
+int tracepoint_enable(FAR const char *name, bool enable);
+
+#endif /* CONFIG_SCHED_TRACEPOINTS */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_TRACEPOINT_H */
@@ -1205,6 +1205,27 @@ struct sensor_ustate_s
   uint64_t generation;         /* The recent generation of circular buffer */
 };
 
+/* This structure is the head of a topic mapped with mmap() (see
+ * CONFIG_SENSORS_MMAP), the nbuffer elements of esize bytes follow it.
+ * Element n of the topic is stored at data + (n % nbuffer) * esize, count
+ * is the number of elements published so far.
+ *
+ * The publisher makes seq odd, stores the new elements, advances count
+ * and makes seq even again.  A reader that wants element n reads seq
+ * (retrying while it is odd), checks count - nbuffer <= n < count, copies
+ * the element and then reads seq again.  If seq changed in between the
+ * copy may be torn and is retried.  Readers never write to the mapping.
+ */
+
+struct sensor_mmap_s
+{
+  uint32_t seq;                /* Odd while elements are being stored */
+  uint32_t esize;              /* The element size */
+  uint32_t nbuffer;            /* The number of elements in the ring */
+  uint32_t count;              /* The number of elements published */
+  uint64_t data[0];            /* The elements, 8 byte aligned */
+};
+
 /* This structure describes the register info for the user sensor */
 
 #ifdef CONFIG_USENSOR
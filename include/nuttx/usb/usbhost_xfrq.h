@@ -0,0 +1,166 @@
+/****************************************************************************
+ * include/nuttx/usb/usbhost_xfrq.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_USB_USBHOST_XFRQ_H
+#define __INCLUDE_NUTTX_USB_USBHOST_XFRQ_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/usb/usbhost.h>
+
+#ifdef CONFIG_USBHOST_XFRQ
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Configuration ************************************************************/
+
+#define USBHOST_XFRQ_MAXBUFFERS 8
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Called on the low priority work queue with each buffer that was filled,
+ * in the order of the transfers.  The buffer is posted again after this
+ * returns.
+ */
+
+typedef CODE void (*usbhost_xfrq_done_t)(FAR void *arg, FAR uint8_t *buffer,
+                                         ssize_t nbytes);
+
+/* A queue of receive buffers of one IN endpoint.  The host controllers only
+ * take one transfer per endpoint, the queue posts the next buffer as soon
+ * as one completes so that the endpoint is not idle while the class driver
+ * handles the data.
+ */
+
+struct usbhost_xfrq_s
+{
+  FAR struct usbhost_driver_s *drvr; /* Host controller of the endpoint */
+  usbhost_ep_t ep;                   /* The IN endpoint */
+  usbhost_xfrq_done_t done;          /* Handles the received data */
+  FAR void *arg;                     /* Argument of done */
+  struct work_s work;                /* Posts and hands out the buffers */
+  spinlock_t lock;                   /* Protects the fields below */
+  size_t buflen;                     /* Size of each buffer */
+  uint8_t nbuffers;                  /* Number of buffers */
+  uint8_t head;                      /* Oldest filled buffer */
+  uint8_t nready;                    /* Filled buffers not handed out */
+  bool busy;                         /* A transfer is in flight */
+  bool running;                      /* Transfers are being posted */
+  FAR uint8_t *buffer[USBHOST_XFRQ_MAXBUFFERS];
+  ssize_t nbytes[USBHOST_XFRQ_MAXBUFFERS];
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#  define EXTERN extern "C"
+extern "C"
+{
+#else
+#  define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: usbhost_xfrq_initialize
+ *
+ * Description:
+ *   Allocate nbuffers I/O buffers of buflen bytes for the IN endpoint ep.
+ *   No transfer is posted before usbhost_xfrq_start().
+ *
+ * Input Parameters:
+ *   xfrq     - The queue to initialize.
+ *   drvr     - The host controller of the endpoint.
+ *   ep       - The IN endpoint.
+ *   nbuffers - The number of buffers, 1 to USBHOST_XFRQ_MAXBUFFERS.
+ *   buflen   - The size of each buffer, the length of each transfer.
+ *   done     - Handles each filled buffer.
+ *   arg      - The argument of done.
+ *
+ * Returned Value:
+ *   On success, zero (OK) is returned. On a failure, a negated errno value
+ *   is returned indicating the nature of the failure.
+ *
+ ****************************************************************************/
+
+int usbhost_xfrq_initialize(FAR struct usbhost_xfrq_s *xfrq,
+                            FAR struct usbhost_driver_s *drvr,
+                            usbhost_ep_t ep, int nbuffers, size_t buflen,
+                            usbhost_xfrq_done_t done, FAR void *arg);
+
+/****************************************************************************
+ * Name: usbhost_xfrq_uninitialize
+ *
+ * Description:
+ *   Stop the queue, wait until it is idle and free its buffers.  This must
+ *   be called before the endpoint is freed.  A queue that is zeroed or was
+ *   already uninitialized is left alone.
+ *
+ ****************************************************************************/
+
+void usbhost_xfrq_uninitialize(FAR struct usbhost_xfrq_s *xfrq);
+
+/****************************************************************************
+ * Name: usbhost_xfrq_start
+ *
+ * Description:
+ *   Begin posting the buffers to the endpoint.
+ *
+ ****************************************************************************/
+
+void usbhost_xfrq_start(FAR struct usbhost_xfrq_s *xfrq);
+
+/****************************************************************************
+ * Name: usbhost_xfrq_stop
+ *
+ * Description:
+ *   Stop posting the buffers and cancel the transfer in flight.  This does
+ *   not wait and may be called with locks held that the done callback
+ *   takes.
+ *
+ ****************************************************************************/
+
+void usbhost_xfrq_stop(FAR struct usbhost_xfrq_s *xfrq);
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* CONFIG_USBHOST_XFRQ */
+#endif /* __INCLUDE_NUTTX_USB_USBHOST_XFRQ_H */
@@ -906,7 +906,7 @@ struct rfb_srle_s
  *  indicate a palette of that size. The possible values of subencoding are:"
  */
 
-#define RFB_SUBENCODING_RAW      0   /* Raw pixel data */
+#define RFB_SUBENCODING_ZRAW     0   /* Raw pixel data */
 #define RFB_SUBENCODING_SOLID    1   /* A solid tile of a single color */
 #define RFB_SUBENCODING_PACKED1  2   /* Packed palette types */
 #define RFB_SUBENCODING_PACKED2  3
@@ -0,0 +1,148 @@
+/****************************************************************************
+ * include/nuttx/waitqueue.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_WAITQUEUE_H
+#define __INCLUDE_NUTTX_WAITQUEUE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdbool.h>
+#include <poll.h>
+
+#include <nuttx/list.h>
+#include <nuttx/mutex.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WAITQ_INITIALIZER(wq) {LIST_INITIAL_VALUE((wq).waiters), \
+                               LIST_INITIAL_VALUE((wq).pollers)}
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* The threads blocked on a condition of a driver and the poll setups that
+ * wait for it.  There is no limit on the number of either.  The queue is
+ * protected by a critical section internally, it may be woken from
+ * interrupt handlers.
+ */
+
+typedef struct
+{
+  struct list_node waiters;  /* Blocked threads, the exclusive ones last */
+  struct list_node pollers;  /* Poll setups */
+} waitq_t;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxwaitq_init
+ *
+ * Description:
+ *   Initialize an empty wait queue.
+ *
+ ****************************************************************************/
+
+void nxwaitq_init(FAR waitq_t *wq);
+
+/****************************************************************************
+ * Name: nxwaitq_wait
+ *
+ * Description:
+ *   Block the calling thread until the queue is woken.  The caller checks
+ *   its condition with lock held, lock is released once the thread is on
+ *   the queue, so that a wake-up after the check can not be missed.  With
+ *   lock NULL the caller must be in a critical section instead.
+ *
+ *   nxwaitq_wake() wakes every non-exclusive waiter but only the first
+ *   exclusive one, so an exclusive waiter that leaves some of the
+ *   condition to the others must wake the queue again.
+ *
+ * Input Parameters:
+ *   wq        - The wait queue
+ *   lock      - The lock that protects the condition, or NULL
+ *   exclusive - Whether the thread waits exclusively
+ *
+ * Returned Value:
+ *   Zero (OK) with lock held again after a wake-up.  A negated errno value
+ *   if the wait was interrupted, lock is not held in that case.
+ *
+ ****************************************************************************/
+
+int nxwaitq_wait(FAR waitq_t *wq, FAR mutex_t *lock, bool exclusive);
+
+/****************************************************************************
+ * Name: nxwaitq_wake
+ *
+ * Description:
+ *   Wake the threads blocked on the queue, all of the non-exclusive ones
+ *   and the first exclusive one, or all of them.
+ *
+ * Input Parameters:
+ *   wq  - The wait queue
+ *   all - Wake all of the exclusive waiters too
+ *
+ ****************************************************************************/
+
+void nxwaitq_wake(FAR waitq_t *wq, bool all);
+
+/****************************************************************************
+ * Name: nxwaitq_poll
+ *
+ * Description:
+ *   Add a poll setup to the queue or remove it, for the poll method of a
+ *   driver.  The driver reports the events that are already pending after
+ *   the setup itself.
+ *
+ * Input Parameters:
+ *   wq    - The wait queue
+ *   fds   - The poll structure, its priv field is used by the queue
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOMEM if the setup could not be allocated.
+ *
+ ****************************************************************************/
+
+int nxwaitq_poll(FAR waitq_t *wq, FAR struct pollfd *fds, bool setup);
+
+/****************************************************************************
+ * Name: nxwaitq_notify
+ *
+ * Description:
+ *   Report poll events to all of the poll setups of the queue.
+ *
+ * Input Parameters:
+ *   wq       - The wait queue
+ *   eventset - The events
+ *
+ ****************************************************************************/
+
+void nxwaitq_notify(FAR waitq_t *wq, pollevent_t eventset);
+
+#endif /* __INCLUDE_NUTTX_WAITQUEUE_H */
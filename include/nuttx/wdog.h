@@ -375,6 +375,26 @@ int wd_cancel(FAR struct wdog_s *wdog);
 
 sclock_t wd_gettime(FAR struct wdog_s *wdog);
 
+/****************************************************************************
+ * Name: wd_gettime_next
+ *
+ * Description:
+ *   This function returns the time remaining before the first active
+ *   watchdog timer expires, the time an idle CPU can sleep without missing
+ *   a watchdog.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the first watchdog expires,
+ *   CLOCK_MAX if no watchdog is active.  With the timer wheel this may be
+ *   shorter than the real time, never longer.
+ *
+ ****************************************************************************/
+
+clock_t wd_gettime_next(void);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -513,6 +513,45 @@ int work_cancel_sync(int qid, FAR struct work_s *work);
 int work_cancel_sync_wq(FAR struct kwork_wqueue_s *wqueue,
                         FAR struct work_s *work);
 
+/****************************************************************************
+ * Name: work_queue_cpu/work_cancel_cpu/work_cancel_sync_cpu
+ *
+ * Description:
+ *   Queue or cancel work on the per-CPU work queue of class 'qid' served by
+ *   'cpu'.  The work is performed on that CPU so that it stays cache hot,
+ *   e.g. when it is queued from the interrupt handler of a device, unless
+ *   a worker of another CPU steals it because the queue is backlogged.
+ *
+ *   Work must be cancelled on the CPU it was queued to.  Without
+ *   CONFIG_SCHED_WORKQUEUE_PERCPU these are redirected to the shared
+ *   queue 'qid'.
+ *
+ * Input Parameters:
+ *   qid    - The work queue class (must be HPWORK or LPWORK)
+ *   cpu    - The CPU to run the work on, negative for the current CPU
+ *   work   - The work structure to queue or cancel
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, clock_t delay);
+int work_cancel_cpu(int qid, int cpu, FAR struct work_s *work);
+int work_cancel_sync_cpu(int qid, int cpu, FAR struct work_s *work);
+#else
+#  define work_queue_cpu(qid, cpu, work, worker, arg, delay) \
+     work_queue(qid, work, worker, arg, delay)
+#  define work_cancel_cpu(qid, cpu, work) work_cancel(qid, work)
+#  define work_cancel_sync_cpu(qid, cpu, work) work_cancel_sync(qid, work)
+#endif
+
 /****************************************************************************
  * Name: work_available
  *
@@ -423,11 +423,11 @@ typedef struct pthread_rwlockattr_s pthread_rwlockattr_t;
 
 struct pthread_rwlock_s
 {
-  pthread_mutex_t lock;
-  pthread_cond_t  cv;
-  unsigned int num_readers;
-  unsigned int num_writers;
-  bool write_in_progress;
+  pthread_mutex_t lock;         /* Protects the waiters */
+  pthread_cond_t  cv;           /* The waiters block here */
+  unsigned int num_readers;     /* Number of waiting readers */
+  unsigned int num_writers;     /* Number of waiting writers */
+  volatile int32_t state;       /* Readers, writer and wait flags */
 };
 
 #ifndef __PTHREAD_RWLOCK_T_DEFINED
@@ -437,7 +437,7 @@ typedef struct pthread_rwlock_s pthread_rwlock_t;
 
 #define PTHREAD_RWLOCK_INITIALIZER  {PTHREAD_MUTEX_INITIALIZER, \
                                      PTHREAD_COND_INITIALIZER, \
-                                     0, 0, false}
+                                     0, 0, 0}
 
 #ifdef CONFIG_PTHREAD_SPINLOCKS
 /* This (non-standard) structure represents a pthread spinlock */
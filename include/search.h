@@ -17,6 +17,8 @@
 
 #include <sys/types.h>
 
+#include <nuttx/hashmap.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -40,8 +42,7 @@ typedef enum
 
 struct hsearch_data
 {
-  FAR struct internal_head *htable;
-  size_t htablesize;
+  struct hashmap_s map;
   CODE void (*free_entry)(FAR ENTRY *entry);
 };
 
@@ -137,7 +138,7 @@ void hforeach(hforeach_t, FAR void *);
  *   Create a new hash table.
  *
  * Input Parameters:
- *   nel - The number of elements in the hash table.
+ *   nel - The number of elements in the hash table, it grows as needed.
  *   htab - The location to return the hash table reference.
  *
  * Returned Value:
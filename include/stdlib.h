@@ -277,6 +277,11 @@ FAR char *mkdtemp(FAR char *path_template);
 
 void      qsort(FAR void *base, size_t nel, size_t width,
                 CODE int (*compar)(FAR const void *, FAR const void *));
+#ifdef CONFIG_LIBC_QSORT_PARALLEL
+void      qsort_parallel(FAR void *base, size_t nel, size_t width,
+                         CODE int (*compar)(FAR const void *,
+                                            FAR const void *));
+#endif
 
 /* Binary search */
 
@@ -0,0 +1,165 @@
+/****************************************************************************
+ * include/sys/ioring.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_SYS_IORING_H
+#define __INCLUDE_SYS_IORING_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/compiler.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <fcntl.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* ioring_setup() flags */
+
+#define IORING_SETUP_CLOEXEC    O_CLOEXEC
+
+/* Operations of a submission queue entry */
+
+#define IORING_OP_NOP           0  /* Complete with zero */
+#define IORING_OP_READ          1  /* read() or pread() */
+#define IORING_OP_WRITE         2  /* write() or pwrite() */
+#define IORING_OP_FSYNC         3  /* fsync() */
+#define IORING_OP_POLL          4  /* Wait for the events in op_flags */
+#define IORING_OP_SEND          5  /* send() with the flags in op_flags */
+#define IORING_OP_RECV          6  /* recv() with the flags in op_flags */
+
+/* Flags of a submission queue entry */
+
+#define IORING_SQE_LINK         (1 << 0) /* Start the next entry only after
+                                          * this one succeeded */
+
+/* ioring_enter() flags */
+
+#define IORING_ENTER_GETEVENTS  (1 << 0) /* Wait for min_complete entries */
+
+/****************************************************************************
+ * Public Type Definitions
+ ****************************************************************************/
+
+/* One submission queue entry, filled by the application.  A negative off
+ * reads or writes at the current file position.
+ */
+
+struct ioring_sqe
+{
+  uint8_t   opcode;    /* IORING_OP_* */
+  uint8_t   flags;     /* IORING_SQE_* */
+  uint16_t  reserved;
+  int32_t   fd;        /* The file descriptor of the operation */
+  uint32_t  len;       /* Length of the buffer */
+  uint32_t  op_flags;  /* Poll events or MSG_* flags */
+  off_t     off;       /* File offset of READ and WRITE */
+  FAR void *addr;      /* Buffer of READ, WRITE, SEND and RECV */
+  uint64_t  user_data; /* Copied to the completion queue entry */
+};
+
+/* One completion queue entry, filled by the kernel.  res is the result of
+ * the operation as the synchronous call would return it, with a negated
+ * errno value on failure.
+ */
+
+struct ioring_cqe
+{
+  uint64_t  user_data; /* From the submission queue entry */
+  int32_t   res;       /* Result of the operation */
+  uint32_t  flags;     /* Reserved */
+};
+
+/* The head and tail of one queue.  Both are free running: the entry at
+ * index (head & mask) is the next to be consumed and the queue is empty
+ * when head == tail.  The application produces the submission queue and
+ * the kernel the completion queue; each side only writes the index it
+ * owns and must use acquire and release ordering on the other one.
+ */
+
+struct ioring_queue
+{
+  volatile uint32_t head;  /* Written by the consumer */
+  volatile uint32_t tail;  /* Written by the producer */
+  uint32_t          mask;  /* entries - 1 */
+  uint32_t          entries;
+};
+
+/* The start of the memory mapped from the ring.  The arrays of submission
+ * and completion queue entries follow at params.sq_off and params.cq_off.
+ */
+
+struct ioring_rings
+{
+  struct ioring_queue sq;
+  struct ioring_queue cq;
+};
+
+/* Returned by ioring_setup() */
+
+struct ioring_params
+{
+  uint32_t  sq_entries; /* Number of submission queue entries */
+  uint32_t  cq_entries; /* Number of completion queue entries */
+  uint32_t  sq_off;     /* Offset of the struct ioring_sqe array */
+  uint32_t  cq_off;     /* Offset of the struct ioring_cqe array */
+  uint32_t  size;       /* Length to mmap() */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/* Create a ring of at least 'entries' submission queue entries.  The ring
+ * is shared with mmap(NULL, params->size, PROT_READ | PROT_WRITE,
+ * MAP_SHARED, fd, 0) of the returned file descriptor.
+ */
+
+int ioring_setup(unsigned int entries, FAR struct ioring_params *params,
+                 int flags);
+
+/* Submit up to 'to_submit' entries of the submission queue and, with
+ * IORING_ENTER_GETEVENTS, wait until at least 'min_complete' entries are
+ * in the completion queue.  Returns the number of entries submitted.
+ */
+
+int ioring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                 unsigned int flags);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_SYS_IORING_H */
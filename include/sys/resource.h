@@ -49,6 +49,8 @@
                                      * process */
 #define RUSAGE_CHILDREN 1           /* Returns information about children of
                                      * the current process */
+#define RUSAGE_THREAD   2           /* Returns information about the calling
+                                     * thread */
 
 /* Possible values for the resource argument of getrlimit() and setrlimit() */
 
@@ -125,6 +127,8 @@ struct rusage
   struct timeval ru_utime;  /* User time used */
   struct timeval ru_stime;  /* System time used */
   long           ru_maxrss; /* maximum resident set size */
+  long           ru_nvcsw;  /* Voluntary context switches */
+  long           ru_nivcsw; /* Involuntary context switches */
 };
 
 /****************************************************************************
@@ -136,10 +136,15 @@
 #define MSG_ERRQUEUE     0x002000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL     0x004000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE         0x008000 /* Sender will send more.  */
+#define MSG_WAITFORONE   0x010000 /* recvmmsg(): block until 1st packet.  */
 #define MSG_CMSG_CLOEXEC 0x100000 /* Set close_on_exit for file
                                    * descriptor received through SCM_RIGHTS.
                                    */
 
+/* Send the data in place from the user buffer, see SO_ZEROCOPY */
+
+#define MSG_ZEROCOPY     0x4000000
+
 /* Protocol levels supported by get/setsockopt(): */
 
 #define SOL_SOCKET       1 /* Only socket-level options supported */
@@ -220,9 +225,39 @@
 #define SO_PEERCRED     18 /* Return the credentials of the peer process
                             * connected to this socket.
                             */
+#define SO_REUSEPORT    19 /* Allow several sockets to bind the same local
+                            * address and port, the load is spread across
+                            * them (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
 #define SO_TIMESTAMPNS  20 /* Generates a timestamp in ns for each incoming packet
                             * arg: integer value
                             */
+#define SO_ZEROCOPY     21 /* Allow MSG_ZEROCOPY sends, whose completion is
+                            * read with recvmsg(MSG_ERRQUEUE) (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
+#define SO_BUSY_POLL    22 /* Poll the device for this long before a receive
+                            * blocks (get/set).
+                            * arg: pointer to integer containing the time in
+                            * microseconds
+                            */
+
+/* Attach a classic BPF program that filters the received packets, or
+ * remove it (set only).  arg: struct sock_fprog, see <net/bpf.h>
+ */
+
+#define SO_ATTACH_FILTER 26
+#define SO_DETACH_FILTER 27
+
+/* Report the software and hardware receive timestamps of each packet
+ * (get/set).  arg: integer of SOF_TIMESTAMPING_* flags, see
+ * <net/net_tstamp.h>
+ */
+
+#define SO_TIMESTAMPING  37
 
 /* The options are unsupported but included for compatibility
  * and portability
@@ -301,6 +336,7 @@
 #define SCM_CREDENTIALS 0x02    /* rw: struct ucred */
 #define SCM_SECURITY    0x03    /* rw: security label */
 #define SCM_TIMESTAMP   SO_TIMESTAMP
+#define SCM_TIMESTAMPING SO_TIMESTAMPING
 
 /* Desired design of maximum size and alignment (see RFC2553) */
 
@@ -377,6 +413,14 @@ struct msghdr
   unsigned int msg_flags;
 };
 
+/* One message of recvmmsg() and sendmmsg() */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* The message */
+  unsigned int msg_len;         /* Bytes received or sent */
+};
+
 struct cmsghdr
 {
   unsigned long cmsg_len;       /* Data byte count, including hdr */
@@ -464,6 +508,12 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags);
 
+struct timespec;
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #if CONFIG_FORTIFY_SOURCE > 0
 fortify_function(send) ssize_t send(int sockfd, FAR const void *buf,
                                     size_t len, int flags)
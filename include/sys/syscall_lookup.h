@@ -57,6 +57,7 @@ SYSCALL_LOOKUP(nxsched_get_stackinfo,      2)
 #endif
 
 SYSCALL_LOOKUP(sysinfo,                    1)
+SYSCALL_LOOKUP(getrusage,                  2)
 
 SYSCALL_LOOKUP(gethostname,                2)
 SYSCALL_LOOKUP(sethostname,                2)
@@ -210,6 +211,10 @@ SYSCALL_LOOKUP(pwrite,                     4)
   SYSCALL_LOOKUP(aio_write,                1)
   SYSCALL_LOOKUP(aio_fsync,                2)
   SYSCALL_LOOKUP(aio_cancel,               2)
+#endif
+#ifdef CONFIG_FS_IORING
+  SYSCALL_LOOKUP(ioring_setup,             3)
+  SYSCALL_LOOKUP(ioring_enter,             4)
 #endif
   SYSCALL_LOOKUP(poll,                     3)
   SYSCALL_LOOKUP(select,                   5)
@@ -249,6 +254,8 @@ SYSCALL_LOOKUP(fstat,                      2)
 SYSCALL_LOOKUP(statfs,                     2)
 SYSCALL_LOOKUP(fstatfs,                    2)
 SYSCALL_LOOKUP(sendfile,                   4)
+SYSCALL_LOOKUP(splice,                     6)
+SYSCALL_LOOKUP(tee,                        4)
 SYSCALL_LOOKUP(sync,                       0)
 SYSCALL_LOOKUP(fsync,                      1)
 SYSCALL_LOOKUP(chmod,                      2)
@@ -377,9 +384,11 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(recv,                     4)
   SYSCALL_LOOKUP(recvfrom,                 6)
   SYSCALL_LOOKUP(recvmsg,                  3)
+  SYSCALL_LOOKUP(recvmmsg,                 5)
   SYSCALL_LOOKUP(send,                     4)
   SYSCALL_LOOKUP(sendto,                   6)
   SYSCALL_LOOKUP(sendmsg,                  3)
+  SYSCALL_LOOKUP(sendmmsg,                 4)
   SYSCALL_LOOKUP(setsockopt,               5)
   SYSCALL_LOOKUP(shutdown,                 2)
   SYSCALL_LOOKUP(socket,                   3)
@@ -522,7 +522,9 @@ enum v4l2_buf_type
 
 #define V4L2_TYPE_IS_CAPTURE(type) (!V4L2_TYPE_IS_OUTPUT(type))
 
-/* Memory I/O method. Currently, support only V4L2_MEMORY_USERPTR. */
+/* Memory I/O method.  The capture driver supports MMAP, USERPTR and
+ * DMABUF, where m.fd is a file descriptor its driver can mmap().
+ */
 
 enum v4l2_memory
 {
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 
 #include <stdint.h>
@@ -35,6 +36,7 @@
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/lib/elf.h>
 
 #include "elf/elf.h"
@@ -126,6 +128,14 @@ int libelf_initialize(FAR const char *filename,
       return ret;
     }
 
+  /* If the file system maps the whole file, read it from memory */
+
+  if (ioctl(loadinfo->filfd, FIOC_XIPBASE,
+            (unsigned long)&loadinfo->filebase) < 0)
+    {
+      loadinfo->filebase = 0;
+    }
+
   /* Read the ELF ehdr from offset 0 */
 
   ret = libelf_read(loadinfo, (FAR uint8_t *)&loadinfo->ehdr,
@@ -84,6 +84,22 @@ int libelf_read(FAR struct mod_loadinfo_s *loadinfo, FAR uint8_t *buffer,
 
   binfo("Read %zu bytes from offset %" PRIdOFF "\n", readsize, offset);
 
+  /* A mapped file needs no system calls at all */
+
+  if (loadinfo->filebase != 0)
+    {
+      if (offset < 0 || offset + readsize > loadinfo->filelen)
+        {
+          berr("ERROR: Unexpected end of file\n");
+          return -ENODATA;
+        }
+
+      memcpy(buffer, (FAR const void *)(loadinfo->filebase + offset),
+             readsize);
+      libelf_dumpreaddata(buffer, nsize);
+      return OK;
+    }
+
   /* Loop until all of the requested data has been read. */
 
   /* Seek to the read position */
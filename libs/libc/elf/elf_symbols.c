@@ -182,6 +182,54 @@ static int libelf_symname(FAR struct mod_loadinfo_s *loadinfo,
   return OK;
 }
 
+/****************************************************************************
+ * Name: libelf_findexport
+ *
+ * Description:
+ *   Find a symbol of the base code symbol table by name, through the
+ *   lookup cache that is kept between loads.  A slot only holds a pointer
+ *   into a symbol table, so a hit is verified against the table and the
+ *   name.
+ *
+ ****************************************************************************/
+
+#if CONFIG_LIBC_ELF_EXPORT_CACHECOUNT > 0
+static FAR const struct symtab_s *
+libelf_findexport(FAR const struct symtab_s *exports,
+                  FAR const char *name, int nexports)
+{
+  static FAR const struct symtab_s *
+  g_export_cache[CONFIG_LIBC_ELF_EXPORT_CACHECOUNT];
+  FAR const struct symtab_s *symbol;
+  FAR const char *ptr;
+  uint32_t hash = 2166136261u;
+
+  for (ptr = name; *ptr != '\0'; ptr++)
+    {
+      hash = (hash ^ (uint8_t)*ptr) * 16777619u;
+    }
+
+  hash %= CONFIG_LIBC_ELF_EXPORT_CACHECOUNT;
+  symbol = g_export_cache[hash];
+
+  if (symbol != NULL && symbol >= exports && symbol < exports + nexports &&
+      strcmp(symbol->sym_name, name) == 0)
+    {
+      return symbol;
+    }
+
+  symbol = symtab_findbyname(exports, name, nexports);
+  if (symbol != NULL)
+    {
+      g_export_cache[hash] = symbol;
+    }
+
+  return symbol;
+}
+#else
+#  define libelf_findexport(e, n, c) symtab_findbyname(e, n, c)
+#endif
+
 /****************************************************************************
  * Name: libelf_symcallback
  *
@@ -408,7 +456,7 @@ int libelf_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            symbol = symtab_findbyname(exports, exportinfo.name,
+            symbol = libelf_findexport(exports, exportinfo.name,
                                        nexports);
           }
 
@@ -542,8 +590,10 @@ int libelf_insertsymtab(FAR struct module_s *modp,
                 }
             }
 
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+#if defined(CONFIG_SYMTAB_ORDEREDBYNAME)
           symtab_sortbyname(symbol, symcount);
+#elif defined(CONFIG_SYMTAB_ORDEREDBYHASH)
+          symtab_sortbyhash(symbol, symcount);
 #endif
         }
       else
@@ -24,20 +24,127 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
 #include <fixedmath.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define b16_P225       0x0000399a
-#define b16_P405284735 0x000067c1
-#define b16_1P27323954 0x000145f3
+#ifdef CONFIG_LIBC_FIXEDMATH_SINTABLE
+/* Turn a b16 angle into a 24 bit fraction of a turn: rad * 2^24 / 2PI,
+ * where 2^24 / 2PI * 2^-16 = 40.7436654 = 40 + 3046.05 / 4096.
+ */
+
+#  define SIN_TURN_INT   40
+#  define SIN_TURN_FRAC  3046
+#  define SIN_TURN_BITS  24
+#  define SIN_QUAD_BITS  (SIN_TURN_BITS - 2)
+#  define SIN_TAB_BITS   8
+#  define SIN_FRAC_BITS  (SIN_QUAD_BITS - SIN_TAB_BITS)
+#else
+#  define b16_P225       0x0000399a
+#  define b16_P405284735 0x000067c1
+#  define b16_1P27323954 0x000145f3
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_LIBC_FIXEDMATH_SINTABLE
+/* sin(i * PI / 512) in b16 for i = 0..256, one quarter wave */
+
+static const uint32_t g_b16sintab[(1 << SIN_TAB_BITS) + 1] =
+{
+  0x00000, 0x00192, 0x00324, 0x004b6, 0x00648, 0x007da, 0x0096c, 0x00afe,
+  0x00c90, 0x00e21, 0x00fb3, 0x01144, 0x012d5, 0x01466, 0x015f7, 0x01787,
+  0x01918, 0x01aa8, 0x01c38, 0x01dc7, 0x01f56, 0x020e5, 0x02274, 0x02402,
+  0x02590, 0x0271e, 0x028ab, 0x02a38, 0x02bc4, 0x02d50, 0x02edc, 0x03067,
+  0x031f1, 0x0337c, 0x03505, 0x0368e, 0x03817, 0x0399f, 0x03b27, 0x03cae,
+  0x03e34, 0x03fba, 0x0413f, 0x042c3, 0x04447, 0x045cb, 0x0474d, 0x048cf,
+  0x04a50, 0x04bd1, 0x04d50, 0x04ecf, 0x0504d, 0x051cb, 0x05348, 0x054c3,
+  0x0563e, 0x057b9, 0x05932, 0x05aaa, 0x05c22, 0x05d99, 0x05f0f, 0x06084,
+  0x061f8, 0x0636b, 0x064dd, 0x0664e, 0x067be, 0x0692d, 0x06a9b, 0x06c08,
+  0x06d74, 0x06edf, 0x07049, 0x071b2, 0x0731a, 0x07480, 0x075e6, 0x0774a,
+  0x078ad, 0x07a10, 0x07b70, 0x07cd0, 0x07e2f, 0x07f8c, 0x080e8, 0x08243,
+  0x0839c, 0x084f5, 0x0864c, 0x087a1, 0x088f6, 0x08a49, 0x08b9a, 0x08ceb,
+  0x08e3a, 0x08f88, 0x090d4, 0x0921f, 0x09368, 0x094b0, 0x095f7, 0x0973c,
+  0x09880, 0x099c2, 0x09b03, 0x09c42, 0x09d80, 0x09ebc, 0x09ff7, 0x0a130,
+  0x0a268, 0x0a39e, 0x0a4d2, 0x0a605, 0x0a736, 0x0a866, 0x0a994, 0x0aac1,
+  0x0abeb, 0x0ad14, 0x0ae3c, 0x0af62, 0x0b086, 0x0b1a8, 0x0b2c9, 0x0b3e8,
+  0x0b505, 0x0b620, 0x0b73a, 0x0b852, 0x0b968, 0x0ba7d, 0x0bb8f, 0x0bca0,
+  0x0bdaf, 0x0bebc, 0x0bfc7, 0x0c0d1, 0x0c1d8, 0x0c2de, 0x0c3e2, 0x0c4e4,
+  0x0c5e4, 0x0c6e2, 0x0c7de, 0x0c8d9, 0x0c9d1, 0x0cac7, 0x0cbbc, 0x0ccae,
+  0x0cd9f, 0x0ce8e, 0x0cf7a, 0x0d065, 0x0d14d, 0x0d234, 0x0d318, 0x0d3fb,
+  0x0d4db, 0x0d5ba, 0x0d696, 0x0d770, 0x0d848, 0x0d91e, 0x0d9f2, 0x0dac4,
+  0x0db94, 0x0dc62, 0x0dd2d, 0x0ddf7, 0x0debe, 0x0df83, 0x0e046, 0x0e107,
+  0x0e1c6, 0x0e282, 0x0e33c, 0x0e3f4, 0x0e4aa, 0x0e55e, 0x0e610, 0x0e6bf,
+  0x0e76c, 0x0e817, 0x0e8bf, 0x0e966, 0x0ea0a, 0x0eaab, 0x0eb4b, 0x0ebe8,
+  0x0ec83, 0x0ed1c, 0x0edb3, 0x0ee47, 0x0eed9, 0x0ef68, 0x0eff5, 0x0f080,
+  0x0f109, 0x0f18f, 0x0f213, 0x0f295, 0x0f314, 0x0f391, 0x0f40c, 0x0f484,
+  0x0f4fa, 0x0f56e, 0x0f5df, 0x0f64e, 0x0f6ba, 0x0f724, 0x0f78c, 0x0f7f1,
+  0x0f854, 0x0f8b4, 0x0f913, 0x0f96e, 0x0f9c8, 0x0fa1f, 0x0fa73, 0x0fac5,
+  0x0fb15, 0x0fb62, 0x0fbad, 0x0fbf5, 0x0fc3b, 0x0fc7f, 0x0fcc0, 0x0fcfe,
+  0x0fd3b, 0x0fd74, 0x0fdac, 0x0fde1, 0x0fe13, 0x0fe43, 0x0fe71, 0x0fe9c,
+  0x0fec4, 0x0feeb, 0x0ff0e, 0x0ff30, 0x0ff4e, 0x0ff6b, 0x0ff85, 0x0ff9c,
+  0x0ffb1, 0x0ffc4, 0x0ffd4, 0x0ffe1, 0x0ffec, 0x0fff5, 0x0fffb, 0x0ffff,
+  0x10000
+};
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_LIBC_FIXEDMATH_SINTABLE
+
+/****************************************************************************
+ * Name: b16sin
+ *
+ * Description:
+ *   Quarter wave table with linear interpolation, no multiply or divide
+ *   wider than 32 bits.  The error is within 2 LSB of b16 (3e-5) over the
+ *   whole period.
+ *
+ ****************************************************************************/
+
+b16_t b16sin(b16_t rad)
+{
+  uint32_t turn;
+  uint32_t pos;
+  uint32_t frac;
+  uint32_t quad;
+  b16_t val;
+
+  /* Same input range as the polynomial version: within 3PI of zero */
+
+  turn = (uint32_t)(rad * SIN_TURN_INT + ((rad * SIN_TURN_FRAC) >> 12));
+  quad = (turn >> SIN_QUAD_BITS) & 3;
+  pos  = turn & ((1 << SIN_QUAD_BITS) - 1);
+
+  /* The second and the fourth quadrant run the table backwards */
+
+  if (quad & 1)
+    {
+      pos = (1 << SIN_QUAD_BITS) - pos;
+    }
+
+  frac = pos & ((1 << SIN_FRAC_BITS) - 1);
+  pos >>= SIN_FRAC_BITS;
+  val  = g_b16sintab[pos];
+
+  if (frac != 0)
+    {
+      val += (b16_t)(((g_b16sintab[pos + 1] - g_b16sintab[pos]) * frac) >>
+                     SIN_FRAC_BITS);
+    }
+
+  return (quad & 2) ? -val : val;
+}
+
+#else
+
 /****************************************************************************
  * Name: b16sin
  * Ref:
@@ -95,3 +202,5 @@ b16_t b16sin(b16_t rad)
 
   return b16mulb16(b16_P225, (tmp1 - tmp3)) + tmp3;
 }
+
+#endif /* CONFIG_LIBC_FIXEDMATH_SINTABLE */
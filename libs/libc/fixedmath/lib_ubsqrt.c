@@ -44,29 +44,35 @@
 ub16_t ub32sqrtub16(ub32_t a)
 {
   uint64_t n = a;
-  uint64_t xk = n;
+  uint64_t xk = 0;
+  uint64_t bit = (uint64_t)1 << 62;
 
   /* Direct conversion of ub32_t to uint64_t is same operation as multiplying
    * 'a' by 2^32, therefore n = a * 2^32.
+   *
+   * Compute floor(sqrt(n)) one result bit at a time, from the top.  This
+   * takes at most 32 compare/subtract steps and, unlike Newton's method,
+   * no 64-bit division, which is a slow library call on 32-bit targets.
    */
 
-  if (xk == UINT64_MAX)
+  while (bit > n)
     {
-      /* Avoid 'xk + n / xk' overflow on first iteration. */
-
-      xk = (uint64_t)1 << 63;
+      bit >>= 2;
     }
 
-  while (xk)
+  while (bit != 0)
     {
-      uint64_t xk1 = (xk + n / xk) >> 1;
-
-      if (xk1 >= xk)
+      if (n >= xk + bit)
+        {
+          n -= xk + bit;
+          xk = (xk >> 1) + bit;
+        }
+      else
         {
-          break;
+          xk >>= 1;
         }
 
-      xk = xk1;
+      bit >>= 2;
     }
 
   /* 'xk' now holds 'sqrt(n)' => 'sqrt(a * 2^32)' => 'sqrt(a) * 2^16', thus
@@ -89,29 +95,33 @@ ub16_t ub32sqrtub16(ub32_t a)
 ub8_t ub16sqrtub8(ub16_t a)
 {
   uint32_t n = a;
-  uint32_t xk = n;
+  uint32_t xk = 0;
+  uint32_t bit = (uint32_t)1 << 30;
 
   /* Direct conversion of ub16_t to uint32_t is same operation as multiplying
    * 'a' by 2^16, therefore n = a * 2^16.
+   *
+   * Same bit by bit method as above, at most 16 steps and no division.
    */
 
-  if (xk == UINT32_MAX)
+  while (bit > n)
     {
-      /* Avoid 'xk + n / xk' overflow on first iteration. */
-
-      xk = (uint32_t)1 << 31;
+      bit >>= 2;
     }
 
-  while (xk)
+  while (bit != 0)
     {
-      uint32_t xk1 = (xk + n / xk) >> 1;
-
-      if (xk1 >= xk)
+      if (n >= xk + bit)
+        {
+          n -= xk + bit;
+          xk = (xk >> 1) + bit;
+        }
+      else
         {
-          break;
+          xk >>= 1;
         }
 
-      xk = xk1;
+      bit >>= 2;
     }
 
   /* 'xk' now holds 'sqrt(n)' => 'sqrt(a * 2^16)' => 'sqrt(a) * 2^8', thus
@@ -36,6 +36,44 @@
 
 #ifdef CONFIG_LIBC_LZF
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LZF_WORD sizeof(uintptr_t)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lzf_wordcopy
+ *
+ * Description:
+ *   Copy len octets a word at a time, rounding len up to whole words.  The
+ *   caller makes sure that up to LZF_WORD - 1 octets past the end of both
+ *   areas may be read and written, and that src is either disjunct from
+ *   dst or at least a word behind it, so every word read has already been
+ *   written.
+ *
+ ****************************************************************************/
+
+#ifndef lzf_movsb
+static inline void lzf_wordcopy(FAR uint8_t *dst, FAR const uint8_t *src,
+                                unsigned int len)
+{
+  FAR uint8_t *end = dst + len;
+
+  do
+    {
+      memcpy(dst, src, LZF_WORD);
+      dst += LZF_WORD;
+      src += LZF_WORD;
+    }
+  while (dst < end);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -96,104 +134,18 @@ unsigned int lzf_decompress (FAR const void *const in_data,
 #ifdef lzf_movsb
           lzf_movsb(op, ip, ctrl);
 #else
-          switch (ctrl)
+          if ((size_t)(out_end - op) >= ctrl + LZF_WORD - 1 &&
+              (size_t)(in_end - ip) >= ctrl + LZF_WORD - 1)
             {
-              case 32:
-                *op++ = *ip++;
-
-              case 31:
-                *op++ = *ip++;
-
-              case 30:
-                *op++ = *ip++;
-
-              case 29:
-                *op++ = *ip++;
-
-              case 28:
-                *op++ = *ip++;
-
-              case 27:
-                *op++ = *ip++;
-
-              case 26:
-                *op++ = *ip++;
-
-              case 25:
-                *op++ = *ip++;
-
-              case 24:
-                *op++ = *ip++;
-
-              case 23:
-                *op++ = *ip++;
-
-              case 22:
-                *op++ = *ip++;
-
-              case 21:
-                *op++ = *ip++;
-
-              case 20:
-                *op++ = *ip++;
-
-              case 19:
-                *op++ = *ip++;
-
-              case 18:
-                *op++ = *ip++;
-
-              case 17:
-                *op++ = *ip++;
-
-              case 16:
-                *op++ = *ip++;
-
-              case 15:
-                *op++ = *ip++;
-
-              case 14:
-                *op++ = *ip++;
-
-              case 13:
-                *op++ = *ip++;
-
-              case 12:
-                *op++ = *ip++;
-
-              case 11:
-                *op++ = *ip++;
-
-              case 10:
-                *op++ = *ip++;
-
-              case 9:
-                *op++ = *ip++;
-
-              case 8:
-                *op++ = *ip++;
-
-              case 7:
-                *op++ = *ip++;
-
-              case 6:
-                *op++ = *ip++;
-
-              case 5:
-                *op++ = *ip++;
-
-              case 4:
-                *op++ = *ip++;
-
-              case 3:
-                *op++ = *ip++;
-
-              case 2:
-                *op++ = *ip++;
-
-              case 1:
-                *op++ = *ip++;
+              lzf_wordcopy(op, ip, ctrl);
+            }
+          else
+            {
+              memcpy(op, ip, ctrl);
             }
+
+          op += ctrl;
+          ip += ctrl;
 #endif
         }
       else /* back reference */
@@ -236,68 +188,35 @@ unsigned int lzf_decompress (FAR const void *const in_data,
               return 0;
             }
 
-#ifdef lzf_movsb
           len += 2;
+
+#ifdef lzf_movsb
           lzf_movsb(op, ref, len);
 #else
-          switch (len)
+          if ((size_t)(op - ref) >= LZF_WORD &&
+              (size_t)(out_end - op) >= len + LZF_WORD - 1)
             {
-              default:
-                len += 2;
-
-                if (op >= ref + len)
-                  {
-                    /* Disjunct areas */
+              /* Disjunct areas, or a reference that is at least a word
+               * back.  Both go a word at a time.
+               */
 
-                    memcpy (op, ref, len);
-                    op += len;
-                  }
-                else
-                  {
-                    /* Overlapping, use octet by octet copying */
-
-                    do
-                      {
-                        *op++ = *ref++;
-                      }
-                    while (--len);
-                  }
-
-                break;
-
-              case 9:
-                *op++ = *ref++;
-
-              case 8:
-                *op++ = *ref++;
-
-              case 7:
-                *op++ = *ref++;
-
-              case 6:
-                *op++ = *ref++;
-
-              case 5:
-                *op++ = *ref++;
-
-              case 4:
-                *op++ = *ref++;
-
-              case 3:
-                *op++ = *ref++;
-
-              case 2:
-                *op++ = *ref++;
-
-              case 1:
-                *op++ = *ref++;
-
-              case 0:
-
-                /* Two octets more */
+              lzf_wordcopy(op, ref, len);
+              op += len;
+            }
+          else if (op >= ref + len)
+            {
+              memcpy(op, ref, len);
+              op += len;
+            }
+          else
+            {
+              /* Short distance overlap, use octet by octet copying */
 
-                *op++ = *ref++;
-                *op++ = *ref++;
+              do
+                {
+                  *op++ = *ref++;
+                }
+              while (--len);
             }
 #endif
         }
@@ -0,0 +1,426 @@
+/****************************************************************************
+ * libs/libc/misc/lib_hashmap.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/hashmap.h>
+#include <nuttx/lib/lib.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HASHMAP_MINSLOTS  8
+
+/* Slots of the old table moved by each insertion or removal.  The old table
+ * has at most 7/16 of the new slots in use, so it is empty long before the
+ * new one is 7/8 full.
+ */
+
+#define HASHMAP_MOVE      4
+
+#define HASHMAP_FULL(m)   ((m)->count + 1 > ((m)->mask + 1) / 8 * 7)
+
+/* A removed entry of the old table, where the probes must go on */
+
+#define HASHMAP_REMOVED   ((FAR void *)&g_hashmap_removed)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char g_hashmap_removed;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hashmap_dist
+ *
+ * Description:
+ *   Return how far a slot is from the first slot of its hash.
+ *
+ ****************************************************************************/
+
+static inline size_t hashmap_dist(size_t mask, size_t index, uint32_t hash)
+{
+  return (index - hash) & mask;
+}
+
+/****************************************************************************
+ * Name: hashmap_lookup
+ *
+ * Description:
+ *   Return the slot of the entry with the hash and the key in a table, or
+ *   NULL.  The slots before cursor were moved to the current table.
+ *
+ ****************************************************************************/
+
+static FAR struct hashmap_slot_s *
+hashmap_lookup(FAR const struct hashmap_s *map,
+               FAR struct hashmap_slot_s *slots, size_t mask,
+               size_t maxdist, size_t cursor, uint32_t hash,
+               FAR const void *key)
+{
+  FAR struct hashmap_slot_s *slot;
+  size_t index;
+  size_t dist;
+
+  for (dist = 0; dist <= maxdist; dist++)
+    {
+      index = (hash + dist) & mask;
+      if (index < cursor)
+        {
+          continue;
+        }
+
+      slot = &slots[index];
+      if (slot->entry == NULL ||
+          hashmap_dist(mask, index, slot->hash) < dist)
+        {
+          break;
+        }
+
+      if (slot->hash == hash && slot->entry != HASHMAP_REMOVED &&
+          map->match(slot->entry, key))
+        {
+          return slot;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: hashmap_place
+ *
+ * Description:
+ *   Put an entry in the current table, which has a free slot.  An entry
+ *   takes the slot of any entry that is closer to its first slot.
+ *
+ ****************************************************************************/
+
+static void hashmap_place(FAR struct hashmap_s *map, uint32_t hash,
+                          FAR void *entry)
+{
+  FAR struct hashmap_slot_s *slot;
+  FAR void *tmpentry;
+  uint32_t tmphash;
+  size_t index = hash & map->mask;
+  size_t dist = 0;
+  size_t slotdist;
+
+  for (; ; )
+    {
+      slot = &map->slots[index];
+      if (slot->entry == NULL)
+        {
+          slot->hash  = hash;
+          slot->entry = entry;
+          break;
+        }
+
+      slotdist = hashmap_dist(map->mask, index, slot->hash);
+      if (slotdist < dist)
+        {
+          tmphash     = slot->hash;
+          tmpentry    = slot->entry;
+          slot->hash  = hash;
+          slot->entry = entry;
+          hash        = tmphash;
+          entry       = tmpentry;
+
+          if (dist > map->maxdist)
+            {
+              map->maxdist = dist;
+            }
+
+          dist = slotdist;
+        }
+
+      index = (index + 1) & map->mask;
+      dist++;
+    }
+
+  if (dist > map->maxdist)
+    {
+      map->maxdist = dist;
+    }
+}
+
+/****************************************************************************
+ * Name: hashmap_move
+ *
+ * Description:
+ *   Move up to n slots of the old table to the current one, and free the
+ *   old table once it is all moved.
+ *
+ ****************************************************************************/
+
+static void hashmap_move(FAR struct hashmap_s *map, size_t n)
+{
+  FAR struct hashmap_slot_s *slot;
+
+  while (map->old != NULL && n-- > 0)
+    {
+      slot = &map->old[map->cursor++];
+      if (slot->entry != NULL && slot->entry != HASHMAP_REMOVED)
+        {
+          hashmap_place(map, slot->hash, slot->entry);
+        }
+
+      if (map->cursor > map->oldmask)
+        {
+          lib_free(map->old);
+          map->old = NULL;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: hashmap_grow
+ *
+ * Description:
+ *   Start moving the entries to a table twice as large.
+ *
+ ****************************************************************************/
+
+static int hashmap_grow(FAR struct hashmap_s *map)
+{
+  FAR struct hashmap_slot_s *slots;
+
+  slots = lib_zalloc(sizeof(*slots) * (map->mask + 1) * 2);
+  if (slots == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* A table that grows again so soon is rare, finish the previous move
+   * first.
+   */
+
+  hashmap_move(map, SIZE_MAX);
+
+  map->old        = map->slots;
+  map->oldmask    = map->mask;
+  map->oldmaxdist = map->maxdist;
+  map->cursor     = 0;
+  map->slots      = slots;
+  map->mask       = map->mask * 2 + 1;
+  map->maxdist    = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hashmap_foreach_slots
+ ****************************************************************************/
+
+static void hashmap_foreach_slots(FAR struct hashmap_slot_s *slots,
+                                  size_t first, size_t last,
+                                  hashmap_foreach_t func, FAR void *arg)
+{
+  size_t index;
+
+  for (index = first; index <= last; index++)
+    {
+      if (slots[index].entry != NULL &&
+          slots[index].entry != HASHMAP_REMOVED)
+        {
+          func(slots[index].entry, arg);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hashmap_init
+ ****************************************************************************/
+
+int hashmap_init(FAR struct hashmap_s *map, size_t nel,
+                 hashmap_match_t match)
+{
+  size_t nslots = HASHMAP_MINSLOTS;
+
+  while (nslots / 8 * 7 < nel && nslots < SIZE_MAX / 2)
+    {
+      nslots *= 2;
+    }
+
+  memset(map, 0, sizeof(*map));
+  map->slots = lib_zalloc(sizeof(*map->slots) * nslots);
+  if (map->slots == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  map->match = match;
+  map->mask  = nslots - 1;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hashmap_deinit
+ ****************************************************************************/
+
+void hashmap_deinit(FAR struct hashmap_s *map)
+{
+  lib_free(map->old);
+  lib_free(map->slots);
+  memset(map, 0, sizeof(*map));
+}
+
+/****************************************************************************
+ * Name: hashmap_find
+ ****************************************************************************/
+
+FAR void *hashmap_find(FAR const struct hashmap_s *map, uint32_t hash,
+                       FAR const void *key)
+{
+  FAR struct hashmap_slot_s *slot;
+
+  slot = hashmap_lookup(map, map->slots, map->mask, map->maxdist, 0,
+                        hash, key);
+  if (slot == NULL && map->old != NULL)
+    {
+      slot = hashmap_lookup(map, map->old, map->oldmask, map->oldmaxdist,
+                            map->cursor, hash, key);
+    }
+
+  return slot != NULL ? slot->entry : NULL;
+}
+
+/****************************************************************************
+ * Name: hashmap_insert
+ ****************************************************************************/
+
+int hashmap_insert(FAR struct hashmap_s *map, uint32_t hash,
+                   FAR void *entry)
+{
+  hashmap_move(map, HASHMAP_MOVE);
+
+  /* If the table cannot grow, it takes entries until all slots are used */
+
+  if (HASHMAP_FULL(map) && hashmap_grow(map) < 0)
+    {
+      hashmap_move(map, SIZE_MAX);
+      if (map->count > map->mask)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  hashmap_place(map, hash, entry);
+  map->count++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: hashmap_remove
+ ****************************************************************************/
+
+FAR void *hashmap_remove(FAR struct hashmap_s *map, uint32_t hash,
+                         FAR const void *key)
+{
+  FAR struct hashmap_slot_s *slot;
+  FAR struct hashmap_slot_s *next;
+  FAR void *entry;
+  size_t index;
+
+  hashmap_move(map, HASHMAP_MOVE);
+
+  slot = hashmap_lookup(map, map->slots, map->mask, map->maxdist, 0,
+                        hash, key);
+  if (slot != NULL)
+    {
+      entry = slot->entry;
+
+      /* Shift the following entries back, so that no probe stops early */
+
+      index = slot - map->slots;
+      for (; ; )
+        {
+          next = &map->slots[(index + 1) & map->mask];
+          if (next->entry == NULL ||
+              hashmap_dist(map->mask, (index + 1) & map->mask,
+                           next->hash) == 0)
+            {
+              break;
+            }
+
+          *slot = *next;
+          slot  = next;
+          index = (index + 1) & map->mask;
+        }
+
+      slot->entry = NULL;
+    }
+  else if (map->old != NULL &&
+           (slot = hashmap_lookup(map, map->old, map->oldmask,
+                                  map->oldmaxdist, map->cursor,
+                                  hash, key)) != NULL)
+    {
+      /* The slots of the old table cannot shift, they may move back before
+       * the cursor.
+       */
+
+      entry       = slot->entry;
+      slot->entry = HASHMAP_REMOVED;
+    }
+  else
+    {
+      return NULL;
+    }
+
+  map->count--;
+  return entry;
+}
+
+/****************************************************************************
+ * Name: hashmap_foreach
+ ****************************************************************************/
+
+void hashmap_foreach(FAR const struct hashmap_s *map,
+                     hashmap_foreach_t func, FAR void *arg)
+{
+  if (map->slots == NULL)
+    {
+      return;
+    }
+
+  hashmap_foreach_slots(map->slots, 0, map->mask, func, arg);
+  if (map->old != NULL)
+    {
+      hashmap_foreach_slots(map->old, map->cursor, map->oldmask, func, arg);
+    }
+}
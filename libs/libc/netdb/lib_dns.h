@@ -59,6 +59,10 @@
 #  define CONFIG_NETDB_DNSCLIENT_LIFESEC 3600
 #endif
 
+#ifndef CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC
+#  define CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC 0
+#endif
+
 #ifndef CONFIG_NETDB_RESOLVCONF_PATH
 #  define CONFIG_NETDB_RESOLVCONF_PATH "/etc/resolv.conf"
 #endif
@@ -218,13 +222,14 @@ bool dns_is_queryfamily(sa_family_t family);
  * Name: dns_save_answer
  *
  * Description:
- *   Save the last resolved hostname in the DNS cache
+ *   Save the last resolved hostname in the DNS cache.  With no addresses,
+ *   save that the hostname has none (a negative entry).
  *
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
- *   ttl      - The TTL of the IP addresses.
+ *   naddr    - The count of the IP addresses, zero for a negative entry.
+ *   ttl      - The TTL of the IP addresses or of the negative answer.
  *
  * Returned Value:
  *   None
@@ -270,7 +275,8 @@ void dns_clear_answer(void);
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
  *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   was not found in the cache, or -EADDRNOTAVAIL meaning that the cache
+ *   knows that the hostname has no address.
  *
  ****************************************************************************/
 
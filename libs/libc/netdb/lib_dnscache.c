@@ -82,13 +82,14 @@ static struct dns_cache_s g_dns_cache[CONFIG_NETDB_DNSCLIENT_ENTRIES];
  * Name: dns_save_answer
  *
  * Description:
- *   Save the last resolved hostname in the DNS cache
+ *   Save the last resolved hostname in the DNS cache.  With no addresses,
+ *   save that the hostname has none (a negative entry).
  *
  * Input Parameters:
  *   hostname - The hostname string to be cached.
  *   addr     - The IP addresses associated with the hostname.
- *   naddr    - The count of the IP addresses.
- *   ttl      - The TTL of the IP addresses.
+ *   naddr    - The count of the IP addresses, zero for a negative entry.
+ *   ttl      - The TTL of the IP addresses or of the negative answer.
  *
  * Returned Value:
  *   None
@@ -107,7 +108,7 @@ void dns_save_answer(FAR const char *hostname,
   int ndx;
 
   naddr = MIN(naddr, CONFIG_NETDB_MAX_IPADDR);
-  DEBUGASSERT(naddr >= 1 && naddr <= UCHAR_MAX);
+  DEBUGASSERT(naddr >= 0 && naddr <= UCHAR_MAX);
 
   /* Get exclusive access to the DNS cache */
 
@@ -202,7 +203,8 @@ void dns_clear_answer(void)
  *   If the host name was successfully found in the DNS name resolution
  *   cache, zero (OK) will be returned.  Otherwise, some negated errno
  *   value will be returned, typically -ENOENT meaning that the hostname
- *   was not found in the cache.
+ *   was not found in the cache, or -EADDRNOTAVAIL meaning that the cache
+ *   knows that the hostname has no address.
  *
  ****************************************************************************/
 
@@ -270,6 +272,14 @@ int dns_find_answer(FAR const char *hostname, FAR union dns_addr_u *addr,
           if (strncmp(hostname, entry->name,
                       CONFIG_NETDB_DNSCLIENT_NAMESIZE) == 0)
             {
+              /* A negative entry, the name is known to have no address */
+
+              if (entry->naddr == 0)
+                {
+                  dns_unlock();
+                  return -EADDRNOTAVAIL;
+                }
+
               /* We have a match.  Return the resolved host address */
 
               /* Make sure that the address will fit in the caller-provided
@@ -40,6 +40,7 @@
 
 #include <nuttx/config.h>
 
+#include <inttypes.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
@@ -75,10 +76,27 @@
 #define RECV_BUFFER_SIZE  CONFIG_NETDB_DNSCLIENT_MAXRESPONSE
 #define QUERY_BUFFER_SIZE MAX(SEND_BUFFER_SIZE, RECV_BUFFER_SIZE)
 
+/* The address families that are queried for each hostname */
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define DNS_NFAMILIES   2
+#else
+#  define DNS_NFAMILIES   1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* An address family that is queried for each hostname */
+
+struct dns_family_s
+{
+  sa_family_t family;             /* AF_INET or AF_INET6 */
+  uint16_t rectype;               /* Record type of its addresses */
+  int maxaddr;                    /* Maximum number of its addresses */
+};
+
 struct dns_query_s
 {
   int result;                     /* Explanation of the failure */
@@ -102,10 +120,26 @@ struct dns_query_info_s
 struct dns_query_data_s
 {
   struct dns_query_s query;
-  struct dns_query_info_s qinfo;
+  struct dns_query_info_s qinfo[DNS_NFAMILIES];
   uint8_t buffer[QUERY_BUFFER_SIZE]; /* Buffer to hold request & response */
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The IPv6 addresses come first in the returned list */
+
+static const struct dns_family_s g_dns_families[DNS_NFAMILIES] =
+{
+#ifdef CONFIG_NET_IPv6
+  { AF_INET6, DNS_RECTYPE_AAAA, CONFIG_NETDB_MAX_IPv6ADDR },
+#endif
+#ifdef CONFIG_NET_IPv4
+  { AF_INET,  DNS_RECTYPE_A,    CONFIG_NETDB_MAX_IPv4ADDR },
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -507,6 +541,76 @@ static int dns_send_query(int sd, FAR const char *name,
   return OK;
 }
 
+/****************************************************************************
+ * Name: dns_negative_ttl
+ *
+ * Description:
+ *   Find the SOA record in the authority section of a negative answer and
+ *   return how long the answer may be cached (RFC 2308, section 5).
+ *
+ * Input Parameters:
+ *   nameptr     - The start of the authority section.
+ *   endofbuffer - A pointer to the byte after the last byte of the response.
+ *   nauth       - The number of records in the authority section.
+ *
+ * Returned Value:
+ *   The TTL of the negative answer in seconds, zero if it may not be
+ *   cached.
+ *
+ ****************************************************************************/
+
+static uint32_t dns_negative_ttl(FAR uint8_t *nameptr,
+                                 FAR uint8_t *endofbuffer, uint16_t nauth)
+{
+  FAR struct dns_answer_s *ans;
+  FAR uint8_t *rdata;
+  FAR uint8_t *rdend;
+  uint32_t minimum;
+  uint32_t ttl;
+
+  for (; nauth > 0; nauth--)
+    {
+      nameptr = dns_parse_name(nameptr, endofbuffer);
+      if (nameptr + 10 > endofbuffer)
+        {
+          break;
+        }
+
+      ans   = (FAR struct dns_answer_s *)nameptr;
+      rdata = nameptr + 10;
+      rdend = rdata + NTOHS(ans->len);
+      if (rdend > endofbuffer)
+        {
+          break;
+        }
+
+      if (ans->type  == HTONS(DNS_RECTYPE_SOA) &&
+          ans->class == HTONS(DNS_CLASS_IN))
+        {
+          /* Skip MNAME and RNAME, MINIMUM is the last of the five 32-bit
+           * fields that follow.
+           */
+
+          rdata = dns_parse_name(rdata, rdend);
+          rdata = dns_parse_name(rdata, rdend);
+          if (rdata + 20 > rdend)
+            {
+              break;
+            }
+
+          ttl     = (NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]);
+          minimum = ((uint32_t)rdata[16] << 24) |
+                    ((uint32_t)rdata[17] << 16) |
+                    ((uint32_t)rdata[18] << 8) | rdata[19];
+          return MIN(ttl, minimum);
+        }
+
+      nameptr = rdend;
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: dns_recv_response
  *
@@ -514,8 +618,11 @@ static int dns_send_query(int sd, FAR const char *name,
  *   Called when new UDP data arrives
  *
  * Returned Value:
- *   Returns number of valid IP address responses.  Negated errno value is
- *   returned in all other cases.
+ *   Returns number of valid IP address responses, ttl is lowered to the
+ *   smallest TTL of the addresses.  -EADDRNOTAVAIL is returned if the
+ *   server answered that the name does not exist or has no address of the
+ *   queried type, ttl is then set to how long that may be cached.  Negated
+ *   errno value is returned in all other cases.
  *
  ****************************************************************************/
 
@@ -533,6 +640,8 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
   uint16_t nquestions;
   uint16_t nanswers;
   uint16_t temp;
+  uint32_t anttl;
+  bool nxdomain;
   int naddr_read;
   int ret;
 
@@ -602,7 +711,10 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
       return -EAGAIN;
     }
 
-  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0)
+  /* A name that does not exist is an answer, too */
+
+  nxdomain = (hdr->flags2 & DNS_FLAG2_ERR_MASK) == DNS_FLAG2_ERR_NAME;
+  if ((hdr->flags2 & DNS_FLAG2_ERR_MASK) != 0 && !nxdomain)
     {
       nerr("ERROR: DNS reported error: flags2=%02x\n", hdr->flags2);
       return -EPROTO;
@@ -622,7 +734,7 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
    */
 
   nquestions = NTOHS(hdr->numquestions);
-  nanswers   = NTOHS(hdr->numanswers);
+  nanswers   = nxdomain ? 0 : NTOHS(hdr->numanswers);
 
   /* We only ever send queries with one question. */
 
@@ -696,14 +808,10 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
 
       ans = (FAR struct dns_answer_s *)nameptr;
 
-      ninfo("Answer: type=%04x, class=%04x, ttl=%06x, length=%04x\n",
-            NTOHS(ans->type), NTOHS(ans->class),
-            (NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]),
-            NTOHS(ans->len));
-      if (ttl)
-        {
-          *ttl = (NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]);
-        }
+      anttl = (NTOHS(ans->ttl[0]) << 16) | NTOHS(ans->ttl[1]);
+      ninfo("Answer: type=%04x, class=%04x, ttl=%06" PRIx32
+            ", length=%04x\n",
+            NTOHS(ans->type), NTOHS(ans->class), anttl, NTOHS(ans->len));
 
       /* Check for IPv4/6 address type and Internet class. Others are
        * discarded.
@@ -730,6 +838,11 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
           inaddr->sin_port        = 0;
           inaddr->sin_addr.s_addr = ans->u.ipv4.s_addr;
 
+          if (ttl)
+            {
+              *ttl = MIN(*ttl, anttl);
+            }
+
           if (++naddr_read >= naddr)
             {
               ret = -ERANGE;
@@ -763,6 +876,11 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
           inaddr->sin6_port       = 0;
           memcpy(inaddr->sin6_addr.s6_addr, ans->u.ipv6.s6_addr, 16);
 
+          if (ttl)
+            {
+              *ttl = MIN(*ttl, anttl);
+            }
+
           if (++naddr_read >= naddr)
             {
               ret = -ERANGE;
@@ -778,6 +896,14 @@ static int dns_recv_response(int sd, FAR union dns_addr_u *addr, int naddr,
 
   if (naddr_read == 0 && ret == OK)
     {
+      /* No address, the authority section tells how long that holds */
+
+      if (ttl)
+        {
+          *ttl = dns_negative_ttl(nameptr, endofbuffer,
+                                  NTOHS(hdr->numauthrr));
+        }
+
       ret = -EADDRNOTAVAIL;
     }
 
@@ -828,7 +954,8 @@ static void dns_query_error(FAR const char *prompt, int ret,
  *
  * Description:
  *   Using the DNS information and this DNS server address, look up the
- *   hostname.
+ *   hostname.  The queries of all address families are sent before any
+ *   answer is awaited, so that they are resolved in parallel.
  *
  * Input Parameters:
  *   arg      - Query arguments
@@ -836,9 +963,10 @@ static void dns_query_error(FAR const char *prompt, int ret,
  *   addrlen  - Length of the DNS name server address.
  *
  * Returned Value:
- *   Returns one (1) if the query was successful.  Zero is returned in all
- *   other cases.  The result field of the query structure is set to a
- *   negated errno value indicate the reason for the last failure (only).
+ *   Returns one (1) if the query was successful or if the server answered
+ *   that the hostname has no address.  Zero is returned in all other cases.
+ *   The result field of the query structure is set to OK on success or to
+ *   a negated errno value indicate the reason for the last failure (only).
  *
  ****************************************************************************/
 
@@ -847,10 +975,17 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
 {
   FAR struct dns_query_data_s *qdata = arg;
   FAR struct dns_query_s      *query = &qdata->query;
-  int next = 0;
+  FAR union dns_addr_u        *uaddr = (FAR union dns_addr_u *)addr;
+  FAR const struct dns_family_s *fam;
+  int sd[DNS_NFAMILIES];
+  uint32_t negttl;
+  uint32_t ttl;
+  int nqueries;
+  int nnegative;
+  int next;
   int retries;
   int ret;
-  int sd;
+  int i;
   bool stream = false;
 
   /* Loop while receive timeout errors occur and there are remaining
@@ -865,120 +1000,110 @@ static int dns_query_callback(FAR void *arg, FAR struct sockaddr *addr,
             retries + 1, CONFIG_NETDB_DNSCLIENT_RETRIES);
 
 try_stream:
-#ifdef CONFIG_NET_IPv6
-      if (dns_is_queryfamily(AF_INET6))
+      nqueries = 0;
+      for (i = 0; i < DNS_NFAMILIES; i++)
         {
-          /* Send the IPv6 query */
+          fam   = &g_dns_families[i];
+          sd[i] = -1;
 
-          sd = dns_bind(addr->sa_family, stream, retries);
-          if (sd < 0)
+          if (!dns_is_queryfamily(fam->family))
             {
-              query->result = sd;
-              return 0;
+              continue;
             }
 
-          ret = dns_send_query(sd, query->hostname,
-                               (FAR union dns_addr_u *)addr,
-                               DNS_RECTYPE_AAAA, &qdata->qinfo,
-                               qdata->buffer, stream);
-          if (ret < 0)
-            {
-              dns_query_error("ERROR: IPv6 dns_send_query failed",
-                              ret, (FAR union dns_addr_u *)addr);
-              query->result = ret;
-            }
-          else
+          /* Send the query */
+
+          nqueries++;
+          sd[i] = dns_bind(addr->sa_family, stream, retries);
+          if (sd[i] < 0)
             {
-              /* Obtain the IPv6 response */
-
-              should_try_stream = false;
-              ret = dns_recv_response(sd, &query->addr[next],
-                                      CONFIG_NETDB_MAX_IPv6ADDR,
-                                      &qdata->qinfo,
-                                      &query->ttl, qdata->buffer,
-                                      stream, &should_try_stream);
-              if (ret >= 0)
+              query->result = sd[i];
+              while (i-- > 0)
                 {
-                  next += ret;
-                }
-              else
-                {
-                  if (!stream && should_try_stream)
+                  if (sd[i] >= 0)
                     {
-                      close(sd);  /* Close current socket before trying stream mode */
-                      stream = true;
-                      goto try_stream; /* Don't consume retry count */
+                      close(sd[i]);
                     }
-
-                  dns_query_error("ERROR: IPv6 dns_recv_response failed",
-                                  ret, (FAR union dns_addr_u *)addr);
-                  query->result = ret;
                 }
+
+              return 0;
             }
 
-          close(sd);
+          ret = dns_send_query(sd[i], query->hostname, uaddr, fam->rectype,
+                               &qdata->qinfo[i], qdata->buffer, stream);
+          if (ret < 0)
+            {
+              dns_query_error("ERROR: dns_send_query failed", ret, uaddr);
+              query->result = ret;
+              close(sd[i]);
+              sd[i] = -1;
+            }
         }
-#endif
 
-#ifdef CONFIG_NET_IPv4
-      if (dns_is_queryfamily(AF_INET))
+      /* Then collect the answers, each one has been on its way since its
+       * query was sent.
+       */
+
+      next      = 0;
+      nnegative = 0;
+      negttl    = UINT32_MAX;
+
+      for (i = 0; i < DNS_NFAMILIES; i++)
         {
-          /* Send the IPv4 query */
+          fam = &g_dns_families[i];
+          if (sd[i] < 0)
+            {
+              continue;
+            }
 
-          sd = dns_bind(addr->sa_family, stream, retries);
-          if (sd < 0)
+          if (fam->family == AF_INET && next >= *query->naddr)
             {
-              query->result = sd;
-              return 0;
+              next = *query->naddr / 2;
             }
 
-          ret = dns_send_query(sd, query->hostname,
-                               (FAR union dns_addr_u *)addr,
-                               DNS_RECTYPE_A, &qdata->qinfo, qdata->buffer,
-                               stream);
-          if (ret < 0)
+          should_try_stream = false;
+          ttl = UINT32_MAX;
+          ret = dns_recv_response(sd[i], &query->addr[next], fam->maxaddr,
+                                  &qdata->qinfo[i], &ttl, qdata->buffer,
+                                  stream, &should_try_stream);
+          close(sd[i]);
+          sd[i] = -1;
+
+          if (ret >= 0)
             {
-              dns_query_error("ERROR: IPv4 dns_send_query failed",
-                              ret, (FAR union dns_addr_u *)addr);
-              query->result = ret;
+              next += ret;
+              query->ttl = MIN(query->ttl, ttl);
             }
-          else
+          else if (!stream && should_try_stream)
             {
-              /* Obtain the IPv4 response */
+              /* Ask everything again over the stream socket, that does
+               * not consume the retry count.
+               */
 
-              if (next >= *query->naddr)
+              while (++i < DNS_NFAMILIES)
                 {
-                  next = *query->naddr / 2;
+                  if (sd[i] >= 0)
+                    {
+                      close(sd[i]);
+                    }
                 }
 
-              should_try_stream = false;
-              ret = dns_recv_response(sd, &query->addr[next],
-                                      CONFIG_NETDB_MAX_IPv4ADDR,
-                                      &qdata->qinfo,
-                                      &query->ttl, qdata->buffer,
-                                      stream, &should_try_stream);
-              if (ret >= 0)
+              stream = true;
+              goto try_stream;
+            }
+          else
+            {
+              if (ret == -EADDRNOTAVAIL)
                 {
-                  next += ret;
+                  nnegative++;
+                  negttl = MIN(negttl, ttl);
                 }
-              else
-                {
-                  if (!stream && should_try_stream)
-                    {
-                      close(sd);  /* Close current socket before trying stream mode */
-                      stream = true;
-                      goto try_stream; /* Don't consume retry count */
-                    }
 
-                  dns_query_error("ERROR: IPv4 dns_recv_response failed",
-                                  ret, (FAR union dns_addr_u *)addr);
-                  query->result = ret;
-                }
+              dns_query_error("ERROR: dns_recv_response failed",
+                              ret, uaddr);
+              query->result = ret;
             }
-
-          close(sd);
         }
-#endif /* CONFIG_NET_IPv4 */
 
       if (next > 0)
         {
@@ -992,6 +1117,27 @@ try_stream:
            */
 
           *query->naddr = next;
+          query->result = OK;
+          return 1;
+        }
+      else if (nqueries > 0 && nnegative == nqueries)
+        {
+#if CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC > 0
+          /* Remember that there is no address, for as long as the server
+           * allows.
+           */
+
+          if (negttl > 0)
+            {
+              dns_save_answer(query->hostname, query->addr, 0,
+                              MIN(negttl,
+                                  CONFIG_NETDB_DNSCLIENT_NEGATIVE_LIFESEC));
+            }
+#endif
+
+          /* The server has answered, the other servers are not asked */
+
+          query->result = -EADDRNOTAVAIL;
           return 1;
         }
       else if (query->result != -EAGAIN)
@@ -1044,22 +1190,17 @@ int dns_query(FAR const char *hostname, FAR union dns_addr_u *addr,
   qdata->query.hostname = hostname;
   qdata->query.addr     = addr;
   qdata->query.naddr    = naddr;
+  qdata->query.ttl      = UINT32_MAX;
 
   /* Perform the query. dns_foreach_nameserver() will return:
    *
-   *  1 - The query was successful.
+   *  1 - A server answered, the result tells whether with an address.
    *  0 - Look up failed
    * <0 - Some other failure (?, shouldn't happen)
    */
 
   ret = dns_foreach_nameserver(dns_query_callback, qdata);
-  if (ret > 0)
-    {
-      /* The lookup was successful */
-
-      ret = OK;
-    }
-  else if (ret == 0)
+  if (ret >= 0)
     {
       ret = qdata->query.result;
     }
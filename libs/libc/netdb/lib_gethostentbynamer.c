@@ -708,6 +708,10 @@ int gethostentbyname_r(FAR const char *name,
                        FAR struct hostent_s *host, FAR char *buf,
                        size_t buflen, FAR int *h_errnop, int flags)
 {
+#if defined(CONFIG_NETDB_DNSCLIENT) && CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
+  int ret;
+#endif
+
   DEBUGASSERT(name != NULL && host != NULL && buf != NULL);
 
   /* Make sure that the h_errno has a non-error code */
@@ -763,21 +767,27 @@ int gethostentbyname_r(FAR const char *name,
 #if CONFIG_NETDB_DNSCLIENT_ENTRIES > 0
   /* Check if we already have this hostname mapping cached */
 
-  if (lib_find_answer(name, host, buf, buflen) >= 0)
+  ret = lib_find_answer(name, host, buf, buflen);
+  if (ret >= 0)
     {
       /* Found the address mapping in the cache */
 
       return OK;
     }
-#endif
 
-  /* Try to get the host address using the DNS name server */
+  /* The cache may also know that there is no mapping */
 
-  if (lib_dns_lookup(name, host, buf, buflen) >= 0)
+  if (ret != -EADDRNOTAVAIL)
+#endif
     {
-      /* Successful DNS lookup! */
+      /* Try to get the host address using the DNS name server */
 
-      return OK;
+      if (lib_dns_lookup(name, host, buf, buflen) >= 0)
+        {
+          /* Successful DNS lookup! */
+
+          return OK;
+        }
     }
 #endif /* CONFIG_NETDB_DNSCLIENT */
 
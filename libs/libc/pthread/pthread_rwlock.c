@@ -31,6 +31,36 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/atomic.h>
+#include <nuttx/pthread.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rwlock_wakeup
+ *
+ * Description:
+ *   Wake up the waiters after the lock was released.
+ *
+ ****************************************************************************/
+
+static int rwlock_wakeup(FAR pthread_rwlock_t *rw_lock)
+{
+  int err;
+
+  err = pthread_mutex_lock(&rw_lock->lock);
+  if (err != 0)
+    {
+      return err;
+    }
+
+  err = pthread_cond_broadcast(&rw_lock->cv);
+  pthread_mutex_unlock(&rw_lock->lock);
+  return err;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -40,9 +70,9 @@ int pthread_rwlock_init(FAR pthread_rwlock_t *lock,
 {
   int err;
 
-  lock->num_readers       = 0;
-  lock->num_writers       = 0;
-  lock->write_in_progress = false;
+  lock->num_readers = 0;
+  lock->num_writers = 0;
+  lock->state       = 0;
 
   err = pthread_cond_init(&lock->cv, NULL);
   if (err != 0)
@@ -75,34 +105,38 @@ int pthread_rwlock_destroy(FAR pthread_rwlock_t *lock)
 
 int pthread_rwlock_unlock(FAR pthread_rwlock_t *rw_lock)
 {
-  int err;
-
-  err = pthread_mutex_lock(&rw_lock->lock);
-  if (err != 0)
-    {
-      return err;
-    }
+  FAR atomic_t *state = (FAR atomic_t *)&rw_lock->state;
+  int32_t old = atomic_read(state);
 
-  if (rw_lock->num_readers > 0)
+  if ((old & RWLOCK_WRITER) != 0)
     {
-      rw_lock->num_readers--;
+      /* Only the writer holds the lock, nobody else changes the state
+       * unless there are waiters.
+       */
 
-      if (rw_lock->num_readers == 0)
+      old = atomic_fetch_and_release(state, ~RWLOCK_WRITER);
+      if ((old & (RWLOCK_WWAIT | RWLOCK_RWAIT)) != 0)
         {
-          err = pthread_cond_broadcast(&rw_lock->cv);
+          return rwlock_wakeup(rw_lock);
         }
     }
-  else if (rw_lock->write_in_progress)
+  else if ((old & RWLOCK_READERS) != 0)
     {
-      rw_lock->write_in_progress = false;
+      /* The last reader wakes up the writers and the readers held off by
+       * them.
+       */
 
-      err = pthread_cond_broadcast(&rw_lock->cv);
+      old = atomic_fetch_sub_release(state, 1);
+      if ((old & RWLOCK_READERS) == 1 &&
+          (old & (RWLOCK_WWAIT | RWLOCK_RWAIT)) != 0)
+        {
+          return rwlock_wakeup(rw_lock);
+        }
     }
   else
     {
-      err = EINVAL;
+      return EINVAL;
     }
 
-  pthread_mutex_unlock(&rw_lock->lock);
-  return err;
+  return OK;
 }
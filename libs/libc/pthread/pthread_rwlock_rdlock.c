@@ -31,6 +31,9 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/atomic.h>
+#include <nuttx/pthread.h>
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -39,28 +42,43 @@ static void rdlock_cleanup(FAR void *arg)
 {
   FAR pthread_rwlock_t *rw_lock = (FAR pthread_rwlock_t *)arg;
 
+  if (--rw_lock->num_readers == 0)
+    {
+      atomic_fetch_and((FAR atomic_t *)&rw_lock->state, ~RWLOCK_RWAIT);
+    }
+
   pthread_mutex_unlock(&rw_lock->lock);
 }
 
+/****************************************************************************
+ * Name: tryrdlock
+ *
+ * Description:
+ *   Take the lock for reading unless a writer holds it or waits for it.
+ *   This is the whole of the uncontended path, a single compare and
+ *   exchange.
+ *
+ ****************************************************************************/
+
 static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
 {
-  int err;
+  FAR atomic_t *state = (FAR atomic_t *)&rw_lock->state;
+  int32_t old = atomic_read(state);
 
-  if (rw_lock->num_writers > 0 || rw_lock->write_in_progress)
+  do
     {
-      err = EBUSY;
-    }
-  else if (rw_lock->num_readers == UINT_MAX)
-    {
-      err = EAGAIN;
-    }
-  else
-    {
-      rw_lock->num_readers++;
-      err = OK;
+      if ((old & (RWLOCK_WRITER | RWLOCK_WWAIT)) != 0)
+        {
+          return EBUSY;
+        }
+      else if ((old & RWLOCK_READERS) == RWLOCK_READERS)
+        {
+          return EAGAIN;
+        }
     }
+  while (!atomic_try_cmpxchg_acquire(state, &old, old + 1));
 
-  return err;
+  return OK;
 }
 
 /****************************************************************************
@@ -85,31 +103,36 @@ static int tryrdlock(FAR pthread_rwlock_t *rw_lock)
 
 int pthread_rwlock_tryrdlock(FAR pthread_rwlock_t *rw_lock)
 {
-  int err = pthread_mutex_trylock(&rw_lock->lock);
-
-  if (err != 0)
-    {
-      return err;
-    }
-
-  err = tryrdlock(rw_lock);
-
-  pthread_mutex_unlock(&rw_lock->lock);
-  return err;
+  return tryrdlock(rw_lock);
 }
 
 int pthread_rwlock_clockrdlock(FAR pthread_rwlock_t *rw_lock,
                                clockid_t clockid,
                                FAR const struct timespec *ts)
 {
-  int err = pthread_mutex_lock(&rw_lock->lock);
+  FAR atomic_t *state = (FAR atomic_t *)&rw_lock->state;
+  int err;
 
+  err = tryrdlock(rw_lock);
+  if (err != EBUSY)
+    {
+      return err;
+    }
+
+  err = pthread_mutex_lock(&rw_lock->lock);
   if (err != 0)
     {
       return err;
     }
 
+  rw_lock->num_readers++;
+
+  /* The flag is set before the state is checked again, whoever releases
+   * the lock after that sees it and wakes us up.
+   */
+
   pthread_cleanup_push(&rdlock_cleanup, rw_lock);
+  atomic_fetch_or(state, RWLOCK_RWAIT);
   while ((err = tryrdlock(rw_lock)) == EBUSY)
     {
       if (ts != NULL)
@@ -130,6 +153,11 @@ int pthread_rwlock_clockrdlock(FAR pthread_rwlock_t *rw_lock,
 
   pthread_cleanup_pop(0);
 
+  if (--rw_lock->num_readers == 0)
+    {
+      atomic_fetch_and(state, ~RWLOCK_RWAIT);
+    }
+
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
 }
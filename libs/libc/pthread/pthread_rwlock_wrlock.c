@@ -31,6 +31,9 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/atomic.h>
+#include <nuttx/pthread.h>
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -39,10 +42,43 @@ static void wrlock_cleanup(FAR void *arg)
 {
   FAR pthread_rwlock_t *rw_lock = (FAR pthread_rwlock_t *)arg;
 
-  rw_lock->num_writers--;
+  /* Let in the readers that were held off by this writer */
+
+  if (--rw_lock->num_writers == 0)
+    {
+      atomic_fetch_and((FAR atomic_t *)&rw_lock->state, ~RWLOCK_WWAIT);
+      pthread_cond_broadcast(&rw_lock->cv);
+    }
+
   pthread_mutex_unlock(&rw_lock->lock);
 }
 
+/****************************************************************************
+ * Name: trywrlock
+ *
+ * Description:
+ *   Take the lock for writing if nobody holds it.  The wait flags are
+ *   kept.
+ *
+ ****************************************************************************/
+
+static int trywrlock(FAR pthread_rwlock_t *rw_lock)
+{
+  FAR atomic_t *state = (FAR atomic_t *)&rw_lock->state;
+  int32_t old = atomic_read(state);
+
+  do
+    {
+      if ((old & (RWLOCK_WRITER | RWLOCK_READERS)) != 0)
+        {
+          return EBUSY;
+        }
+    }
+  while (!atomic_try_cmpxchg_acquire(state, &old, old | RWLOCK_WRITER));
+
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,32 +101,23 @@ static void wrlock_cleanup(FAR void *arg)
 
 int pthread_rwlock_trywrlock(FAR pthread_rwlock_t *rw_lock)
 {
-  int err = pthread_mutex_trylock(&rw_lock->lock);
-
-  if (err != 0)
-    {
-      return err;
-    }
-
-  if (rw_lock->num_readers > 0 || rw_lock->write_in_progress)
-    {
-      err = EBUSY;
-    }
-  else
-    {
-      rw_lock->write_in_progress = true;
-    }
-
-  pthread_mutex_unlock(&rw_lock->lock);
-  return err;
+  return trywrlock(rw_lock);
 }
 
 int pthread_rwlock_clockwrlock(FAR pthread_rwlock_t *rw_lock,
                                clockid_t clockid,
                                FAR const struct timespec *ts)
 {
-  int err = pthread_mutex_lock(&rw_lock->lock);
+  FAR atomic_t *state = (FAR atomic_t *)&rw_lock->state;
+  int err;
+
+  err = trywrlock(rw_lock);
+  if (err != EBUSY)
+    {
+      return err;
+    }
 
+  err = pthread_mutex_lock(&rw_lock->lock);
   if (err != 0)
     {
       return err;
@@ -102,10 +129,18 @@ int pthread_rwlock_clockwrlock(FAR pthread_rwlock_t *rw_lock,
       goto exit_with_mutex;
     }
 
-  rw_lock->num_writers++;
+  /* Keep new readers out while we wait, the writers are preferred.  The
+   * flag is set before the state is checked again, whoever releases the
+   * lock after that sees it and wakes us up.
+   */
+
+  if (rw_lock->num_writers++ == 0)
+    {
+      atomic_fetch_or(state, RWLOCK_WWAIT);
+    }
 
   pthread_cleanup_push(&wrlock_cleanup, rw_lock);
-  while (rw_lock->write_in_progress || rw_lock->num_readers > 0)
+  while ((err = trywrlock(rw_lock)) == EBUSY)
     {
       if (ts != NULL)
         {
@@ -125,19 +160,18 @@ int pthread_rwlock_clockwrlock(FAR pthread_rwlock_t *rw_lock,
 
   pthread_cleanup_pop(0);
 
-  if (err == 0)
-    {
-      rw_lock->write_in_progress = true;
-    }
-  else
+  if (--rw_lock->num_writers == 0)
     {
+      atomic_fetch_and(state, ~RWLOCK_WWAIT);
+
       /* In case of error, notify any blocked readers. */
 
-      pthread_cond_broadcast(&rw_lock->cv);
+      if (err != 0)
+        {
+          pthread_cond_broadcast(&rw_lock->cv);
+        }
     }
 
-  rw_lock->num_writers--;
-
 exit_with_mutex:
   pthread_mutex_unlock(&rw_lock->lock);
   return err;
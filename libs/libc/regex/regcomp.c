@@ -40,6 +40,8 @@
 #include <stdint.h>
 #include <ctype.h>
 
+#include <nuttx/mutex.h>
+
 #include "tre.h"
 
 #include <assert.h>
@@ -3651,6 +3653,26 @@ static reg_errcode_t tre_ast_to_tnfa(tre_ast_node_t *node,
   return errcode;
 }
 
+/* Recently compiled patterns
+ */
+
+#if CONFIG_LIBC_REGEX_CACHE > 0
+struct tre_cache_entry
+{
+  char *regex;
+  int cflags;
+  size_t re_nsub;
+  tre_tnfa_t *tnfa;
+  unsigned int stamp;
+};
+
+static mutex_t g_tre_cache_lock = NXMUTEX_INITIALIZER;
+static struct tre_cache_entry g_tre_cache[CONFIG_LIBC_REGEX_CACHE];
+static unsigned int g_tre_cache_stamp;
+#endif
+
+static void tre_free(tre_tnfa_t *tnfa);
+
 #define ERROR_EXIT(err)      \
   do                         \
     {                        \
@@ -3660,7 +3682,8 @@ static reg_errcode_t tre_ast_to_tnfa(tre_ast_node_t *node,
     }                        \
   while (/* CONSTCOND */ 0)
 
-int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
+static int tre_compile(regex_t *restrict preg, const char *restrict regex,
+                       int cflags)
 {
   tre_stack_t           *stack;
   tre_ast_node_t        *tree, *tmp_ast_l, *tmp_ast_r;
@@ -3735,6 +3758,9 @@ int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
       ERROR_EXIT(REG_ESPACE);
     }
 
+#if CONFIG_LIBC_REGEX_CACHE > 0
+  tnfa->refs            = 1;
+#endif
   tnfa->have_backrefs   = parse_ctx.max_backref >= 0;
   tnfa->have_approx     = 0;
   tnfa->num_submatches  = parse_ctx.submatch_id;
@@ -3922,6 +3948,9 @@ int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
   tnfa->final           = transitions + offs[tree->lastpos[0].position];
   tnfa->num_states      = parse_ctx.position;
   tnfa->cflags          = cflags;
+#ifdef CONFIG_LIBC_REGEX_DFA
+  tnfa->dfa             = tre_dfa_new(tnfa);
+#endif
 
   tre_mem_destroy(mem);
   tre_stack_destroy(stack);
@@ -3956,11 +3985,132 @@ error_exit:
   return errcode;
 }
 
+#if CONFIG_LIBC_REGEX_CACHE > 0
+
+/* Drops a reference to a TNFA, returns nonzero if it was the last one.
+ *  Called with g_tre_cache_lock held.
+ */
+
+static int tre_cache_release(tre_tnfa_t *tnfa)
+{
+  return --tnfa->refs == 0;
+}
+
+static int tre_cache_lookup(regex_t *preg, const char *regex, int cflags)
+{
+  struct tre_cache_entry *entry;
+  int                    i;
+
+  for (i = 0; i < CONFIG_LIBC_REGEX_CACHE; i++)
+    {
+      entry = &g_tre_cache[i];
+      if (entry->tnfa != NULL && entry->cflags == cflags &&
+          strcmp(entry->regex, regex) == 0)
+        {
+          entry->tnfa->refs++;
+          entry->stamp            = ++g_tre_cache_stamp;
+          preg->re_nsub           = entry->re_nsub;
+          preg->TRE_REGEX_T_FIELD = (void *)entry->tnfa;
+          return 1;
+        }
+    }
+
+  return 0;
+}
+
+/* Keeps a compiled pattern in place of the least recently used one. */
+
+static void tre_cache_insert(const regex_t *preg, const char *regex,
+                             int cflags)
+{
+  struct tre_cache_entry *entry = &g_tre_cache[0];
+  tre_tnfa_t             *tnfa  = NULL;
+  char                   *copy;
+  int                    i;
+
+  copy = strdup(regex);
+  if (copy == NULL)
+    {
+      return;
+    }
+
+  for (i = 1; i < CONFIG_LIBC_REGEX_CACHE && entry->tnfa != NULL; i++)
+    {
+      if (g_tre_cache[i].tnfa == NULL ||
+          (int)(g_tre_cache[i].stamp - entry->stamp) < 0)
+        {
+          entry = &g_tre_cache[i];
+        }
+    }
+
+  if (entry->tnfa != NULL)
+    {
+      xfree(entry->regex);
+      if (tre_cache_release(entry->tnfa))
+        {
+          tnfa = entry->tnfa;
+        }
+    }
+
+  entry->regex   = copy;
+  entry->cflags  = cflags;
+  entry->re_nsub = preg->re_nsub;
+  entry->tnfa    = (void *)preg->TRE_REGEX_T_FIELD;
+  entry->stamp   = ++g_tre_cache_stamp;
+  entry->tnfa->refs++;
+
+  if (tnfa != NULL)
+    {
+      tre_free(tnfa);
+    }
+}
+#endif /* CONFIG_LIBC_REGEX_CACHE > 0 */
+
+int regcomp(regex_t *restrict preg, const char *restrict regex, int cflags)
+{
+#if CONFIG_LIBC_REGEX_CACHE > 0
+  tre_tnfa_t *tnfa;
+  int        ret;
+
+  nxmutex_lock(&g_tre_cache_lock);
+  if (tre_cache_lookup(preg, regex, cflags))
+    {
+      nxmutex_unlock(&g_tre_cache_lock);
+      return REG_OK;
+    }
+
+  nxmutex_unlock(&g_tre_cache_lock);
+
+  ret = tre_compile(preg, regex, cflags);
+  if (ret == REG_OK)
+    {
+      tnfa = (void *)preg->TRE_REGEX_T_FIELD;
+
+      nxmutex_lock(&g_tre_cache_lock);
+      if (tre_cache_lookup(preg, regex, cflags))
+        {
+          /* Another thread has compiled it in the meantime, use that one
+           *  and drop ours.
+           */
+
+          nxmutex_unlock(&g_tre_cache_lock);
+          tre_free(tnfa);
+          return REG_OK;
+        }
+
+      tre_cache_insert(preg, regex, cflags);
+      nxmutex_unlock(&g_tre_cache_lock);
+    }
+
+  return ret;
+#else
+  return tre_compile(preg, regex, cflags);
+#endif
+}
+
 void regfree(regex_t *preg)
 {
-  tre_tnfa_t            *tnfa;
-  unsigned int          i;
-  tre_tnfa_transition_t *trans;
+  tre_tnfa_t *tnfa;
 
   tnfa = (void *)preg->TRE_REGEX_T_FIELD;
   if (!tnfa)
@@ -3968,6 +4118,29 @@ void regfree(regex_t *preg)
       return;
     }
 
+#if CONFIG_LIBC_REGEX_CACHE > 0
+  nxmutex_lock(&g_tre_cache_lock);
+  if (!tre_cache_release(tnfa))
+    {
+      nxmutex_unlock(&g_tre_cache_lock);
+      return;
+    }
+
+  nxmutex_unlock(&g_tre_cache_lock);
+#endif
+
+  tre_free(tnfa);
+}
+
+static void tre_free(tre_tnfa_t *tnfa)
+{
+  unsigned int          i;
+  tre_tnfa_transition_t *trans;
+
+#ifdef CONFIG_LIBC_REGEX_DFA
+  tre_dfa_free(tnfa->dfa);
+#endif
+
   for (i = 0; i < tnfa->num_transitions; i++)
     {
       if (tnfa->transitions[i].state)
@@ -38,9 +38,12 @@
 #include <wchar.h>
 #include <wctype.h>
 #include <limits.h>
+#include <stdint.h>
 
 #include <regex.h>
 
+#include <nuttx/mutex.h>
+
 #include "tre.h"
 
 #include <assert.h>
@@ -1209,6 +1212,440 @@ static void tre_fill_pmatch(size_t nmatch, regmatch_t pmatch[], int cflags,
     }
 }
 
+/* Lazy DFA
+ */
+
+/*  Without back references, whether the TNFA matches only depends on the
+ *  set of TNFA states that the parallel matcher reaches at each position,
+ *  not on the tags.  Those sets are the states of a DFA, which is built
+ *  lazily while matching and kept with the compiled pattern.  The
+ *  characters below TRE_DFA_NCHARS that no transition tells apart share a
+ *  column of the DFA.  Where the TNFA has assertions that look at the
+ *  next character, the columns are also split by the class of that
+ *  character.  The states are all dropped when there is no room for
+ *  another one.
+ */
+
+#ifdef CONFIG_LIBC_REGEX_DFA
+
+#define TRE_DFA_NCHARS      128
+#define TRE_DFA_MAXFLUSH    8
+#define TRE_DFA_FALLBACK    (-2)
+
+/* Classes of the next character */
+
+#define TRE_LOOK_END        0   /* End of string */
+#define TRE_LOOK_END_NOTEOL 1   /* End of string with REG_NOTEOL */
+#define TRE_LOOK_NEWLINE    2
+#define TRE_LOOK_WORD       3
+#define TRE_LOOK_OTHER      4
+#define TRE_NLOOK           5
+
+#define TRE_ASSERT_LOOK     (ASSERT_AT_EOL | ASSERT_AT_BOW | ASSERT_AT_EOW | \
+                             ASSERT_AT_WB | ASSERT_AT_WB_NEG)
+
+struct tre_dfa_s
+{
+  mutex_t lock;                   /* Taken by one matcher at a time */
+  tre_tnfa_transition_t **states; /* Transitions of each TNFA state id */
+  uint32_t *sets;                 /* TNFA states of each DFA state */
+  uint32_t *scratch;              /* The set being built */
+  int16_t *next;                  /* Next state of each column, or -1 */
+  int16_t start[2][TRE_NLOOK];    /* Initial states by REG_NOTBOL */
+  int nwords;                     /* Words of a set */
+  int nlook;                      /* 1 or TRE_NLOOK */
+  int ncols;                      /* Columns of a DFA state */
+  int nused;                      /* DFA states in use */
+  int nflush;                     /* Times they were dropped by one run */
+  int final_id;                   /* TNFA state id of the final state */
+  uint8_t columns[TRE_DFA_NCHARS];
+};
+
+/* A character standing for each class of the next character */
+
+static const tre_char_t g_tre_look_char[TRE_NLOOK] =
+{
+  L'\0', L'\0', L'\n', L'a', L' '
+};
+
+/* Returns nonzero if a transition does not accept the character `prev_c',
+ *  not looking at the position.
+ */
+
+static int tre_dfa_reject(const tre_tnfa_t *tnfa,
+                          const tre_tnfa_transition_t *trans_i,
+                          tre_char_t prev_c)
+{
+  return trans_i->code_min > (tre_cint_t)prev_c ||
+         trans_i->code_max < (tre_cint_t)prev_c ||
+         ((trans_i->assertions &
+           (ASSERT_CHAR_CLASS | ASSERT_CHAR_CLASS_NEG)) &&
+          CHECK_CHAR_CLASSES(trans_i, tnfa, 0));
+}
+
+/* Returns nonzero if the assertions fail at a position after `prev_c'
+ *  (at the beginning of the string if `pos' is zero) before a character
+ *  of the class `look'.
+ */
+
+static int tre_dfa_check(const tre_tnfa_t *tnfa, int assertions, int pos,
+                         tre_char_t prev_c, int look, int eflags)
+{
+  tre_char_t next_c      = g_tre_look_char[look];
+  int        reg_notbol  = eflags & REG_NOTBOL;
+  int        reg_noteol  = look == TRE_LOOK_END_NOTEOL;
+  int        reg_newline = tnfa->cflags & REG_NEWLINE;
+
+  return CHECK_ASSERTIONS(assertions);
+}
+
+static int tre_dfa_look(const struct tre_dfa_s *dfa, tre_char_t next_c,
+                        int eflags)
+{
+  if (dfa->nlook == 1)
+    {
+      return 0;
+    }
+  else if (next_c == L'\0')
+    {
+      return (eflags & REG_NOTEOL) ? TRE_LOOK_END_NOTEOL : TRE_LOOK_END;
+    }
+  else if (next_c == L'\n')
+    {
+      return TRE_LOOK_NEWLINE;
+    }
+
+  return IS_WORD_CHAR(next_c) ? TRE_LOOK_WORD : TRE_LOOK_OTHER;
+}
+
+/* Builds in `scratch' the TNFA states reached from `set' with `prev_c',
+ *  or the initial states at the beginning of the string if `set' is NULL.
+ */
+
+static void tre_dfa_move(const tre_tnfa_t *tnfa, struct tre_dfa_s *dfa,
+                         const uint32_t *set, tre_char_t prev_c, int look,
+                         int eflags)
+{
+  tre_tnfa_transition_t *trans_i;
+  int                   pos = set != NULL;
+  int                   id;
+
+  memset(dfa->scratch, 0, sizeof(*dfa->scratch) * dfa->nwords);
+
+  for (id = 0; set != NULL && id < tnfa->num_states; id++)
+    {
+      if (!(set[id / 32] & (1u << (id % 32))))
+        {
+          continue;
+        }
+
+      for (trans_i = dfa->states[id]; trans_i && trans_i->state;
+           trans_i++)
+        {
+          if (tre_dfa_reject(tnfa, trans_i, prev_c) ||
+              (trans_i->assertions &&
+               tre_dfa_check(tnfa, trans_i->assertions, pos, prev_c, look,
+                             eflags)))
+            {
+              continue;
+            }
+
+          dfa->scratch[trans_i->state_id / 32] |=
+            1u << (trans_i->state_id % 32);
+        }
+    }
+
+  /* Until there is a match, the initial states are added at each
+   *  position.
+   */
+
+  for (trans_i = tnfa->initial; trans_i->state; trans_i++)
+    {
+      if (!trans_i->assertions ||
+          !tre_dfa_check(tnfa, trans_i->assertions, pos, prev_c, look,
+                         eflags))
+        {
+          dfa->scratch[trans_i->state_id / 32] |=
+            1u << (trans_i->state_id % 32);
+        }
+    }
+}
+
+/* Returns the DFA state of the set in `scratch', or -1 if the states were
+ *  dropped too many times.  `*flushed' is set if they were dropped.
+ */
+
+static int tre_dfa_state(struct tre_dfa_s *dfa, int *flushed)
+{
+  size_t setsize = sizeof(*dfa->sets) * dfa->nwords;
+  int    s;
+
+  for (s = 0; s < dfa->nused; s++)
+    {
+      if (memcmp(&dfa->sets[s * dfa->nwords], dfa->scratch, setsize) == 0)
+        {
+          return s;
+        }
+    }
+
+  if (dfa->nused >= CONFIG_LIBC_REGEX_DFA_STATES)
+    {
+      if (++dfa->nflush > TRE_DFA_MAXFLUSH)
+        {
+          return -1;
+        }
+
+      memset(dfa->start, 0xff, sizeof(dfa->start));
+      dfa->nused = 0;
+      *flushed   = 1;
+    }
+
+  s = dfa->nused++;
+  memcpy(&dfa->sets[s * dfa->nwords], dfa->scratch, setsize);
+  memset(&dfa->next[s * dfa->ncols], 0xff,
+         sizeof(*dfa->next) * dfa->ncols);
+  return s;
+}
+
+/* Returns REG_OK if the TNFA matches the string, REG_NOMATCH if not, or
+ *  TRE_DFA_FALLBACK if the TNFA matcher has to decide.
+ */
+
+static reg_errcode_t tre_dfa_run(const tre_tnfa_t *tnfa, const char *string,
+                                 int eflags)
+{
+  struct tre_dfa_s  *dfa      = tnfa->dfa;
+  const char        *str_byte = string;
+  tre_char_t        prev_c;
+  tre_char_t        next_c;
+  reg_errcode_t     ret;
+  int               notbol    = (eflags & REG_NOTBOL) != 0;
+  int               flushed;
+  int               look;
+  int               col       = 0;
+  int               len;
+  int               s;
+  int               t;
+
+  if (nxmutex_trylock(&dfa->lock) < 0)
+    {
+      return TRE_DFA_FALLBACK;
+    }
+
+  dfa->nflush = 0;
+
+  /* Read the characters as GET_NEXT_WCHAR() does, ASCII without
+   *  mbtowc().
+   */
+
+#define TRE_DFA_NEXT_WCHAR()                                   \
+  do                                                           \
+    {                                                          \
+      if ((unsigned char)*str_byte < 0x80)                     \
+        {                                                      \
+          next_c = (unsigned char)*str_byte++;                 \
+        }                                                      \
+      else if ((len = mbtowc(&next_c, str_byte, MB_LEN_MAX)) < 0) \
+        {                                                      \
+          ret = REG_NOMATCH;                                   \
+          goto out;                                            \
+        }                                                      \
+      else                                                     \
+        {                                                      \
+          str_byte += len;                                     \
+        }                                                      \
+    }                                                          \
+  while (0)
+
+  TRE_DFA_NEXT_WCHAR();
+  look = tre_dfa_look(dfa, next_c, eflags);
+  s    = dfa->start[notbol][look];
+  if (s < 0)
+    {
+      flushed = 0;
+      tre_dfa_move(tnfa, dfa, NULL, 0, look, eflags);
+      s = tre_dfa_state(dfa, &flushed);
+      dfa->start[notbol][look] = s;
+    }
+
+  for (; ; )
+    {
+      if (dfa->sets[s * dfa->nwords + dfa->final_id / 32] &
+          (1u << (dfa->final_id % 32)))
+        {
+          ret = REG_OK;
+          break;
+        }
+
+      if (next_c == L'\0')
+        {
+          ret = REG_NOMATCH;
+          break;
+        }
+
+      prev_c = next_c;
+      TRE_DFA_NEXT_WCHAR();
+      look = tre_dfa_look(dfa, next_c, eflags);
+
+      if ((tre_cint_t)prev_c < TRE_DFA_NCHARS)
+        {
+          col = dfa->columns[prev_c] * dfa->nlook + look;
+          t   = dfa->next[s * dfa->ncols + col];
+          if (t >= 0)
+            {
+              s = t;
+              continue;
+            }
+        }
+
+      flushed = 0;
+      tre_dfa_move(tnfa, dfa, &dfa->sets[s * dfa->nwords], prev_c, look,
+                   eflags);
+      t = tre_dfa_state(dfa, &flushed);
+      if (t < 0)
+        {
+          ret = TRE_DFA_FALLBACK;
+          break;
+        }
+
+      if (!flushed && (tre_cint_t)prev_c < TRE_DFA_NCHARS)
+        {
+          dfa->next[s * dfa->ncols + col] = t;
+        }
+
+      s = t;
+    }
+
+#undef TRE_DFA_NEXT_WCHAR
+
+out:
+  nxmutex_unlock(&dfa->lock);
+  return ret;
+}
+
+struct tre_dfa_s *tre_dfa_new(const tre_tnfa_t *tnfa)
+{
+  struct tre_dfa_s      *dfa;
+  tre_tnfa_transition_t *trans_i;
+  tre_tnfa_transition_t **states;
+  uint8_t               columns[TRE_DFA_NCHARS];
+  unsigned int          i;
+  int                   nwords;
+  int                   nlook = 1;
+  int                   ncols;
+  int                   final_id = -1;
+  int                   c;
+
+  if (tnfa->have_backrefs || tnfa->num_states <= 0)
+    {
+      return NULL;
+    }
+
+  states = xcalloc(tnfa->num_states, sizeof(*states));
+  if (states == NULL)
+    {
+      return NULL;
+    }
+
+  for (i = 0; i < tnfa->num_transitions; i++)
+    {
+      trans_i = &tnfa->transitions[i];
+      if (trans_i->state)
+        {
+          states[trans_i->state_id] = trans_i->state;
+          if (trans_i->assertions & TRE_ASSERT_LOOK)
+            {
+              nlook = TRE_NLOOK;
+            }
+        }
+    }
+
+  for (trans_i = tnfa->initial; trans_i->state; trans_i++)
+    {
+      states[trans_i->state_id] = trans_i->state;
+      if (trans_i->assertions & TRE_ASSERT_LOOK)
+        {
+          nlook = TRE_NLOOK;
+        }
+    }
+
+  for (c = 0; c < tnfa->num_states; c++)
+    {
+      if (states[c] == tnfa->final)
+        {
+          final_id = c;
+        }
+    }
+
+  if (final_id < 0)
+    {
+      xfree(states);
+      return NULL;
+    }
+
+  /* Characters that no transition and no assertion tells apart share a
+   *  column.
+   */
+
+  columns[0] = 0;
+  for (c = 1; c < TRE_DFA_NCHARS; c++)
+    {
+      int split = c == L'\n' || c - 1 == L'\n' ||
+                  IS_WORD_CHAR(c) != IS_WORD_CHAR(c - 1);
+
+      for (i = 0; !split && i < tnfa->num_transitions; i++)
+        {
+          trans_i = &tnfa->transitions[i];
+          split   = trans_i->state &&
+                    !tre_dfa_reject(tnfa, trans_i, c) !=
+                    !tre_dfa_reject(tnfa, trans_i, c - 1);
+        }
+
+      columns[c] = columns[c - 1] + split;
+    }
+
+  /* Allocate the DFA and its tables in one block. */
+
+  nwords = (tnfa->num_states + 31) / 32;
+  ncols  = (columns[TRE_DFA_NCHARS - 1] + 1) * nlook;
+  dfa    = xmalloc(sizeof(*dfa) +
+                   sizeof(uint32_t) * nwords *
+                   (CONFIG_LIBC_REGEX_DFA_STATES + 1) +
+                   sizeof(int16_t) * ncols * CONFIG_LIBC_REGEX_DFA_STATES);
+  if (dfa == NULL)
+    {
+      xfree(states);
+      return NULL;
+    }
+
+  dfa->states   = states;
+  dfa->sets     = (uint32_t *)(dfa + 1);
+  dfa->scratch  = dfa->sets + nwords * CONFIG_LIBC_REGEX_DFA_STATES;
+  dfa->next     = (int16_t *)(dfa->scratch + nwords);
+  dfa->nwords   = nwords;
+  dfa->nlook    = nlook;
+  dfa->ncols    = ncols;
+  dfa->nused    = 0;
+  dfa->nflush   = 0;
+  dfa->final_id = final_id;
+  memcpy(dfa->columns, columns, sizeof(columns));
+  memset(dfa->start, 0xff, sizeof(dfa->start));
+  nxmutex_init(&dfa->lock);
+  return dfa;
+}
+
+void tre_dfa_free(struct tre_dfa_s *dfa)
+{
+  if (dfa != NULL)
+    {
+      nxmutex_destroy(&dfa->lock);
+      xfree(dfa->states);
+      xfree(dfa);
+    }
+}
+
+#endif /* CONFIG_LIBC_REGEX_DFA */
+
 /* Wrapper functions for POSIX compatible regexp matching.
  */
 
@@ -1225,6 +1662,21 @@ int regexec(const regex_t *restrict preg, const char *restrict string,
       nmatch = 0;
     }
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+  /* The DFA tells whether there is a match, the TNFA matcher is only
+   *  needed for the submatches.
+   */
+
+  if (tnfa->dfa != NULL)
+    {
+      status = tre_dfa_run(tnfa, string, eflags);
+      if (status == REG_NOMATCH || (status == REG_OK && nmatch == 0))
+        {
+          return status;
+        }
+    }
+#endif
+
   if (tnfa->num_tags > 0 && nmatch > 0)
     {
       tags = xmalloc(sizeof(*tags) * tnfa->num_tags);
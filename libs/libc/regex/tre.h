@@ -192,6 +192,10 @@ typedef struct tre_submatch_data tre_submatch_data_t;
 
 typedef struct tnfa tre_tnfa_t;
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+struct tre_dfa_s;
+#endif
+
 struct tnfa
 {
   tre_tnfa_transition_t *transitions;
@@ -211,8 +215,29 @@ struct tnfa
   int cflags;
   int have_backrefs;
   int have_approx;
+#if CONFIG_LIBC_REGEX_CACHE > 0
+  int refs;
+#endif
+#ifdef CONFIG_LIBC_REGEX_DFA
+  struct tre_dfa_s *dfa;
+#endif
 };
 
+#ifdef CONFIG_LIBC_REGEX_DFA
+#define tre_dfa_new     __tre_dfa_new
+#define tre_dfa_free    __tre_dfa_free
+
+/* Returns the lazy DFA of a TNFA without back references, or NULL if the
+ *  TNFA cannot use one or out of memory.
+ */
+
+struct tre_dfa_s *tre_dfa_new(const tre_tnfa_t *tnfa);
+
+/* Frees a DFA returned by tre_dfa_new(). */
+
+void tre_dfa_free(struct tre_dfa_s *dfa);
+#endif
+
 /* from tre-mem.h: */
 
 #define TRE_MEM_BLOCK_SIZE  1024
@@ -43,7 +43,6 @@
  ****************************************************************************/
 
 #include <sys/types.h>
-#include <sys/queue.h>
 
 #include <errno.h>
 #include <search.h>
@@ -52,30 +51,20 @@
 
 #include "libc.h"
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-#define MIN_BUCKETS_LG2 4
-#define MIN_BUCKETS     (1 << MIN_BUCKETS_LG2)
-#define MAX_BUCKETS_LG2 (sizeof (size_t) * 8 - 1 - 5)
-#define MAX_BUCKETS     ((size_t)1 << MAX_BUCKETS_LG2)
-
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
-struct internal_entry
+struct hforeach_arg_s
 {
-  SLIST_ENTRY(internal_entry) link;
-  ENTRY ent;
+  hforeach_t handle;
+  FAR void *data;
 };
 
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-SLIST_HEAD(internal_head, internal_entry);
 extern uint32_t (*g_default_hash)(FAR const void *, size_t);
 
 /****************************************************************************
@@ -88,6 +77,26 @@ static void hfree_r(FAR ENTRY *entry)
   lib_free(entry->data);
 }
 
+static bool hmatch_r(FAR const void *entry, FAR const void *key)
+{
+  return strcmp(((FAR const ENTRY *)entry)->key, key) == 0;
+}
+
+static void hdestroy_entry(FAR void *entry, FAR void *arg)
+{
+  FAR struct hsearch_data *htab = arg;
+
+  htab->free_entry(entry);
+  lib_free(entry);
+}
+
+static void hforeach_entry(FAR void *entry, FAR void *arg)
+{
+  FAR struct hforeach_arg_s *foreach = arg;
+
+  foreach->handle(entry, foreach->data);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -99,7 +108,7 @@ static void hfree_r(FAR ENTRY *entry)
  *   Create a new hash table.
  *
  * Input Parameters:
- *   nel - The number of elements in the hash table.
+ *   nel - The number of elements in the hash table, it grows as needed.
  *   htab - The location to return the hash table reference.
  *
  * Returned Value:
@@ -109,60 +118,23 @@ static void hfree_r(FAR ENTRY *entry)
 
 int hcreate_r(size_t nel, FAR struct hsearch_data *htab)
 {
-  size_t idx;
-  unsigned int p2;
+  int ret;
 
   /* Make sure this this isn't called when a table already exists. */
 
-  if (htab->htable != NULL)
+  if (htab->map.slots != NULL)
     {
       _NX_SETERRNO(-EINVAL);
       return 0;
     }
 
-  /* If nel is too small, make it min sized. */
-
-  if (nel < MIN_BUCKETS)
-    {
-      nel = MIN_BUCKETS;
-    }
-
-  /* If it's too large, cap it. */
-
-  if (nel > MAX_BUCKETS)
+  ret = hashmap_init(&htab->map, nel, hmatch_r);
+  if (ret < 0)
     {
-      nel = MAX_BUCKETS;
-    }
-
-  /* If it's is not a power of two in size, round up. */
-
-  if ((nel & (nel - 1)) != 0)
-    {
-      for (p2 = 0; nel != 0; p2++)
-        {
-          nel >>= 1;
-        }
-
-      nel = 1 << p2;
-    }
-
-  /* Allocate the table. */
-
-  htab->htablesize = nel;
-  htab->htable = lib_malloc(htab->htablesize * sizeof htab->htable[0]);
-  if (htab->htable == NULL)
-    {
-      _NX_SETERRNO(-ENOMEM);
+      _NX_SETERRNO(ret);
       return 0;
     }
 
-  /* Initialize it. */
-
-  for (idx = 0; idx < htab->htablesize; idx++)
-    {
-      SLIST_INIT(&(htab->htable[idx]));
-    }
-
   if (htab->free_entry == NULL)
     {
       htab->free_entry = hfree_r;
@@ -187,27 +159,13 @@ int hcreate_r(size_t nel, FAR struct hsearch_data *htab)
 
 void hdestroy_r(FAR struct hsearch_data *htab)
 {
-  FAR struct internal_entry *ie;
-  size_t idx;
-
-  if (htab->htable == NULL)
+  if (htab->map.slots == NULL)
     {
       return;
     }
 
-  for (idx = 0; idx < htab->htablesize; idx++)
-    {
-      while (!SLIST_EMPTY(&(htab->htable[idx])))
-        {
-          ie = SLIST_FIRST(&(htab->htable[idx]));
-          SLIST_REMOVE_HEAD(&(htab->htable[idx]), link);
-          htab->free_entry(&ie->ent);
-          lib_free(ie);
-        }
-    }
-
-  lib_free(htab->htable);
-  htab->htable = NULL;
+  hashmap_foreach(&htab->map, hdestroy_entry, htab);
+  hashmap_deinit(&htab->map);
 }
 
 /****************************************************************************
@@ -230,41 +188,28 @@ void hdestroy_r(FAR struct hsearch_data *htab)
 int hsearch_r(ENTRY item, ACTION action, FAR ENTRY **retval,
               FAR struct hsearch_data *htab)
 {
-  FAR struct internal_head *head;
-  FAR struct internal_entry *ie;
+  FAR ENTRY *ent;
   uint32_t hashval;
-  size_t len;
 
-  len = strlen(item.key);
-  hashval = (*g_default_hash)(item.key, len);
-
-  head = &(htab->htable[hashval & (htab->htablesize - 1)]);
-  ie = SLIST_FIRST(head);
-  while (ie != NULL)
-    {
-      if (strcmp(ie->ent.key, item.key) == 0)
-        {
-          break;
-        }
-
-      ie = SLIST_NEXT(ie, link);
-    }
+  hashval = (*g_default_hash)(item.key, strlen(item.key));
 
   if (action == DELETE)
     {
-      if (ie != NULL)
+      ent = hashmap_remove(&htab->map, hashval, item.key);
+      if (ent != NULL)
         {
-          SLIST_REMOVE(head, ie, internal_entry, link);
-          htab->free_entry(&ie->ent);
-          lib_free(ie);
+          htab->free_entry(ent);
+          lib_free(ent);
           return 1;
         }
 
       return 0;
     }
-  else if (ie != NULL)
+
+  ent = hashmap_find(&htab->map, hashval, item.key);
+  if (ent != NULL)
     {
-      *retval = &ie->ent;
+      *retval = ent;
       return 1;
     }
   else if (action == FIND)
@@ -273,18 +218,23 @@ int hsearch_r(ENTRY item, ACTION action, FAR ENTRY **retval,
       return 0;
     }
 
-  ie = lib_malloc(sizeof *ie);
-  if (ie == NULL)
+  ent = lib_malloc(sizeof(*ent));
+  if (ent == NULL)
     {
       *retval = NULL;
       return 0;
     }
 
-  ie->ent.key = item.key;
-  ie->ent.data = item.data;
+  *ent = item;
+  if (hashmap_insert(&htab->map, hashval, ent) < 0)
+    {
+      lib_free(ent);
+      _NX_SETERRNO(-ENOMEM);
+      *retval = NULL;
+      return 0;
+    }
 
-  SLIST_INSERT_HEAD(head, ie, link);
-  *retval = &ie->ent;
+  *retval = ent;
   return 1;
 }
 
@@ -307,21 +257,9 @@ int hsearch_r(ENTRY item, ACTION action, FAR ENTRY **retval,
 void hforeach_r(hforeach_t handle, FAR void *data,
                 FAR struct hsearch_data *htab)
 {
-  FAR struct internal_head *head;
-  FAR struct internal_entry *ie;
-  FAR struct internal_entry *tmp;
-  size_t len;
-
-  for (len = 0; len < htab->htablesize; len++)
-    {
-      head = &htab->htable[len];
+  struct hforeach_arg_s arg;
 
-      SLIST_FOREACH_SAFE(ie, head, link, tmp)
-        {
-          if (ie != NULL && ie->ent.key != NULL)
-            {
-              handle(&ie->ent, data);
-            }
-        }
-    }
+  arg.handle = handle;
+  arg.data   = data;
+  hashmap_foreach(&htab->map, hforeach_entry, &arg);
 }
@@ -28,6 +28,8 @@
 
 #include <stdio.h>
 
+#include <sys/param.h>
+
 #include "libc.h"
 
 /****************************************************************************
@@ -165,6 +167,9 @@ ssize_t getdelim(FAR char **lineptr, size_t *n, int delimiter,
               goto errout;
             }
 
+          /* The block may have been rounded up, use all of it */
+
+          bufsize  = MAX(bufsize, lib_malloc_size(newbuffer));
           *lineptr = newbuffer;
           *n       = bufsize;
           dest     = &newbuffer[ncopied];
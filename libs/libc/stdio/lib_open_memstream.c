@@ -34,6 +34,8 @@
 #include <assert.h>
 #include <errno.h>
 
+#include <sys/param.h>
+
 #include "libc.h"
 
 /****************************************************************************
@@ -68,17 +70,22 @@ static ssize_t memstream_write(FAR void *c, FAR const char *buf,
 
   if (memstream_cookie->pos + size + 1 > memstream_cookie->size)
     {
-      /* We have to reallocate the buffer. */
+      /* We have to reallocate the buffer.  Grow it geometrically and use
+       * whatever slack the allocator rounded the block up to, so a stream
+       * written in small pieces does not realloc on every write.
+       */
 
-      new_size = memstream_cookie->pos + size + 1;
+      new_size = MAX(memstream_cookie->pos + size + 1,
+                     (size_t)memstream_cookie->size * 2);
       buf_grow = lib_realloc(*memstream_cookie->buf, new_size);
       if (buf_grow == NULL)
         {
           return -ENOMEM;
         }
 
+      new_size = MAX(new_size, lib_malloc_size(buf_grow));
       memset(buf_grow + memstream_cookie->end, 0,
-            new_size - memstream_cookie->size);
+             new_size - memstream_cookie->end);
 
       *memstream_cookie->buf = buf_grow;
       memstream_cookie->size = new_size;
@@ -43,12 +43,33 @@
 
 #include <sys/types.h>
 #include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Partitions of up to this many elements are sorted by insertion */
+
+#define QSORT_INSERTION     12
+
+/* Element moves allowed in an insertion sort of a partition that looks
+ * sorted already, before it is given up.
+ */
+
+#define QSORT_PARTIAL_MOVES 8
+
+/* The elements are swapped a long or an int at a time whenever both the
+ * base and the width are aligned to it.
+ */
+
+#define SWAP_LONG           0  /* Elements are one long */
+#define SWAP_LONGS          1  /* Elements are several longs */
+#define SWAP_INTS           2  /* Elements are several ints */
+#define SWAP_BYTES          3  /* Elements are unaligned */
+
 #define swapcode(TYPE, parmi, parmj, n) \
   { \
     long i = (n) / sizeof(TYPE); \
@@ -62,11 +83,13 @@
   }
 
 #define SWAPINIT(a, width) \
-  swaptype = (uintptr_t)a % sizeof(long) || \
-  width % sizeof(long) ? 2 : width == sizeof(long) ? 0 : 1;
+  swaptype = ((uintptr_t)(a) | (width)) % sizeof(long) == 0 ? \
+             ((width) == sizeof(long) ? SWAP_LONG : SWAP_LONGS) : \
+             ((uintptr_t)(a) | (width)) % sizeof(int) == 0 ? \
+             SWAP_INTS : SWAP_BYTES;
 
 #define swap(a, b) \
-  if (swaptype == 0) \
+  if (swaptype == SWAP_LONG) \
     { \
       long t = *(FAR long *)(a); \
       *(FAR long *)(a) = *(FAR long *)(b); \
@@ -79,25 +102,36 @@
 
 #define vecswap(a, b, n) if ((n) > 0) swapfunc(a, b, n, swaptype)
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE int (*compar_t)(FAR const void *, FAR const void *);
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
+static inline void swapfunc(FAR char *a, FAR char *b, size_t n,
+                            int swaptype);
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *));
+                             compar_t compar);
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
+static inline void swapfunc(FAR char *a, FAR char *b, size_t n,
+                            int swaptype)
 {
-  if (swaptype <= 1)
+  if (swaptype <= SWAP_LONGS)
     {
       swapcode(long, a, b, n)
     }
+  else if (swaptype == SWAP_INTS)
+    {
+      swapcode(int, a, b, n)
+    }
   else
     {
       swapcode(char, a, b, n)
@@ -105,8 +139,7 @@ static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype)
 }
 
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
-                             CODE int (*compar)(FAR const void *,
-                             FAR const void *))
+                             compar_t compar)
 {
   return compar(a, b) < 0 ?
          (compar(b, c) < 0 ? b : (compar(a, c) < 0 ? c : a)) :
@@ -114,50 +147,113 @@ static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
 }
 
 /****************************************************************************
- * Public Function
- ****************************************************************************/
-
-/****************************************************************************
- * Name: qsort
+ * Name: insertion_sort
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
+ *   Sort nel elements by insertion.  If limit is not zero this gives up
+ *   once more than limit elements were moved, the elements are left in
+ *   some order then.
  *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
+ * Returned Value:
+ *   true if the elements are sorted.
  *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
+ ****************************************************************************/
+
+static bool insertion_sort(FAR char *base, size_t nel, size_t width,
+                           int swaptype, size_t limit, compar_t compar)
+{
+  FAR char *end = base + nel * width;
+  FAR char *pm;
+  FAR char *pl;
+  size_t moves = 0;
+
+  for (pm = base + width; pm < end; pm += width)
+    {
+      for (pl = pm; pl > base && compar(pl - width, pl) > 0; pl -= width)
+        {
+          swap(pl, pl - width);
+          moves++;
+        }
+
+      if (limit > 0 && moves > limit)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: heap_sort
  *
- *   (Based on description from OpenGroup.org).
+ * Description:
+ *   Sort nel elements in O(n log n), for the partitions that keep on
+ *   splitting badly.
  *
- * Returned Value:
- *   The qsort() function will not return a value.
+ ****************************************************************************/
+
+static void heap_sort(FAR char *base, size_t nel, size_t width,
+                      int swaptype, compar_t compar)
+{
+  FAR char *parent;
+  FAR char *child;
+  size_t root;
+  size_t last;
+  size_t i;
+
+  for (last = nel, root = nel / 2; last > 1; )
+    {
+      if (root > 0)
+        {
+          /* Build the heap */
+
+          root--;
+        }
+      else
+        {
+          /* Move the largest element behind the heap */
+
+          last--;
+          swap(base, base + last * width);
+        }
+
+      /* Sift the root down */
+
+      for (i = root; (i = 2 * i + 1) < last; )
+        {
+          child = base + i * width;
+          if (i + 1 < last && compar(child, child + width) < 0)
+            {
+              child += width;
+              i++;
+            }
+
+          parent = base + ((i - 1) / 2) * width;
+          if (compar(parent, child) >= 0)
+            {
+              break;
+            }
+
+          swap(parent, child);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: introsort
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   The Bentley & McIlroy quicksort, made pattern-defeating: it only
+ *   recurses into the smaller partition, partitions that look sorted are
+ *   tried by a bounded insertion sort, the elements of badly split
+ *   partitions are shuffled, and the sort falls back to heap_sort after
+ *   too many of them.
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void introsort(FAR char *base, size_t nel, size_t width,
+                      int swaptype, int bad, compar_t compar)
 {
   FAR char *pa;
   FAR char *pb;
@@ -166,37 +262,26 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
-  int swaptype;
+  size_t nl;
+  size_t nr;
+  size_t d;
+  size_t r;
   int swap_cnt;
-  int d;
-  int r;
-
-loop:
-  SWAPINIT(base, width);
-  swap_cnt = 0;
+  int cmp;
 
-  if (nel < 7)
+  for (; ; )
     {
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
+      if (nel <= QSORT_INSERTION)
         {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
+          insertion_sort(base, nel, width, swaptype, 0, compar);
+          return;
         }
 
-      return;
-    }
+      /* Choose the pivot and move it to the front */
 
-  pm = (FAR char *)base + (nel / 2) * width;
-  if (nel > 7)
-    {
       pl = base;
-      pn = (FAR char *)base + (nel - 1) * width;
+      pm = base + (nel / 2) * width;
+      pn = base + (nel - 1) * width;
       if (nel > 40)
         {
           d  = (nel / 8) * width;
@@ -206,86 +291,182 @@ loop:
         }
 
       pm = med3(pl, pm, pn, compar);
-    }
+      swap(base, pm);
 
-  swap(base, pm);
-  pa = pb = (FAR char *)base + width;
+      /* Partition in three ways, the elements equal to the pivot are
+       * collected at both ends first.
+       */
 
-  pc = pd = (FAR char *)base + (nel - 1) * width;
-  for (; ; )
-    {
-      while (pb <= pc && (r = compar(pb, base)) <= 0)
+      swap_cnt = 0;
+      pa = pb = base + width;
+      pc = pd = base + (nel - 1) * width;
+      for (; ; )
         {
-          if (r == 0)
+          while (pb <= pc && (cmp = compar(pb, base)) <= 0)
             {
-              swap_cnt = 1;
-              swap(pa, pb);
-              pa += width;
+              if (cmp == 0)
+                {
+                  swap_cnt = 1;
+                  swap(pa, pb);
+                  pa += width;
+                }
+
+              pb += width;
             }
 
-          pb += width;
-        }
+          while (pb <= pc && (cmp = compar(pc, base)) >= 0)
+            {
+              if (cmp == 0)
+                {
+                  swap_cnt = 1;
+                  swap(pc, pd);
+                  pd -= width;
+                }
+
+              pc -= width;
+            }
 
-      while (pb <= pc && (r = compar(pc, base)) >= 0)
-        {
-          if (r == 0)
+          if (pb > pc)
             {
-              swap_cnt = 1;
-              swap(pc, pd);
-              pd -= width;
+              break;
             }
 
+          swap(pb, pc);
+          swap_cnt = 1;
+          pb += width;
           pc -= width;
         }
 
-      if (pb > pc)
+      /* Move the equal elements to the middle */
+
+      pn = base + nel * width;
+      r  = MIN(pa - base, pb - pa);
+      vecswap(base, pb - r, r);
+
+      r  = MIN(pd - pc, pn - pd - width);
+      vecswap(pb, pn - r, r);
+
+      nl = (pb - pa) / width;
+      nr = (pd - pc) / width;
+      pm = pn - nr * width;
+
+      if (swap_cnt == 0)
         {
-          break;
+          /* Nothing moved, the input may be sorted already */
+
+          if (insertion_sort(base, nl, width, swaptype,
+                             QSORT_PARTIAL_MOVES, compar) &&
+              insertion_sort(pm, nr, width, swaptype,
+                             QSORT_PARTIAL_MOVES, compar))
+            {
+              return;
+            }
         }
+      else if (MIN(nl, nr) < nel / 8)
+        {
+          /* A bad split, give up on quicksort after too many of them, or
+           * else shuffle a few elements to break the pattern.
+           */
 
-      swap(pb, pc);
-      swap_cnt = 1;
-      pb      += width;
-      pc      -= width;
-    }
+          if (--bad <= 0)
+            {
+              heap_sort(base, nl, width, swaptype, compar);
+              heap_sort(pm, nr, width, swaptype, compar);
+              return;
+            }
 
-  if (swap_cnt == 0)
-    {
-      /* Switch to insertion sort */
+          if (nl > QSORT_INSERTION)
+            {
+              swap(base, base + (nl / 4) * width);
+              swap(base + (nl - 1) * width, base + (nl - nl / 4) * width);
+            }
 
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
-        {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
+          if (nr > QSORT_INSERTION)
             {
-              swap(pl, pl - width);
+              swap(pm, pm + (nr / 4) * width);
+              swap(pm + (nr - 1) * width, pm + (nr - nr / 4) * width);
             }
         }
 
-      return;
+      /* Recurse into the smaller partition and iterate on the larger one,
+       * that keeps the stack depth logarithmic.
+       */
+
+      if (nl < nr)
+        {
+          introsort(base, nl, width, swaptype, bad, compar);
+          base = pm;
+          nel  = nr;
+        }
+      else
+        {
+          introsort(pm, nr, width, swaptype, bad, compar);
+          nel  = nl;
+        }
     }
+}
 
-  pn = (FAR char *)base + nel * width;
-  r  = MIN(pa - (FAR char *)base, pb - pa);
-  vecswap(base, pb - r, r);
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
 
-  r  = MIN(pd - pc, pn - pd - width);
-  vecswap(pb, pn - r, r);
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes from the original BSD version:
+ *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *
+ ****************************************************************************/
+
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  int swaptype;
+  int bad = 1;
 
-  if ((r = pb - pa) > width)
+  if (nel < 2 || width == 0)
     {
-      qsort(base, r / width, width, compar);
+      return;
     }
 
-  if ((r = pd - pc) > width)
-    {
-      /* Iterate rather than recurse to save stack space */
+  /* Allow about log2(nel) bad splits before the heap sort */
 
-      base = pn - r;
-      nel = r / width;
-      goto loop;
+  while ((nel >> bad) > 0)
+    {
+      bad++;
     }
+
+  SWAPINIT(base, width);
+  introsort(base, nel, width, swaptype, bad, compar);
 }
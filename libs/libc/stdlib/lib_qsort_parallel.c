@@ -0,0 +1,245 @@
+/****************************************************************************
+ * libs/libc/stdlib/lib_qsort_parallel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define QSORT_NTHREADS CONFIG_SMP_NCPUS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE int (*compar_t)(FAR const void *, FAR const void *);
+
+/* Sorts one run in place, or merges two runs that follow each other */
+
+struct qsort_job_s
+{
+  FAR char *src;     /* The run to sort, or the first of the runs to merge */
+  FAR char *dst;     /* Where the merged runs go, NULL to sort */
+  size_t    nl;      /* Elements in the first run */
+  size_t    nr;      /* Elements in the second run */
+  size_t    width;   /* Size of an element */
+  compar_t  compar;  /* The comparison function */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort_job
+ ****************************************************************************/
+
+static FAR void *qsort_job(FAR void *arg)
+{
+  FAR struct qsort_job_s *job = arg;
+  size_t width = job->width;
+  FAR char *pl;
+  FAR char *el;
+  FAR char *pr;
+  FAR char *er;
+  FAR char *pd;
+
+  if (job->dst == NULL)
+    {
+      qsort(job->src, job->nl, width, job->compar);
+      return NULL;
+    }
+
+  pl = job->src;
+  el = pl + job->nl * width;
+  pr = el;
+  er = pr + job->nr * width;
+  pd = job->dst;
+
+  while (pl < el && pr < er)
+    {
+      if (job->compar(pr, pl) < 0)
+        {
+          memcpy(pd, pr, width);
+          pr += width;
+        }
+      else
+        {
+          memcpy(pd, pl, width);
+          pl += width;
+        }
+
+      pd += width;
+    }
+
+  memcpy(pd, pl, el - pl);
+  memcpy(pd + (el - pl), pr, er - pr);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: qsort_run
+ *
+ * Description:
+ *   Run the jobs, all but the first one on threads of their own.  A job
+ *   that gets no thread is run by the caller.
+ *
+ ****************************************************************************/
+
+static void qsort_run(FAR struct qsort_job_s *jobs, int njobs)
+{
+  pthread_t threads[QSORT_NTHREADS];
+  bool started[QSORT_NTHREADS];
+  int i;
+
+  for (i = 1; i < njobs; i++)
+    {
+      started[i] = pthread_create(&threads[i], NULL, qsort_job,
+                                  &jobs[i]) == 0;
+      if (!started[i])
+        {
+          qsort_job(&jobs[i]);
+        }
+    }
+
+  qsort_job(&jobs[0]);
+
+  for (i = 1; i < njobs; i++)
+    {
+      if (started[i])
+        {
+          pthread_join(threads[i], NULL);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort_parallel
+ *
+ * Description:
+ *   Sort an array as qsort() does, on all CPUs.  The array is split into
+ *   one run per CPU, each run is sorted by qsort() on a thread of its own,
+ *   and the sorted runs are merged in pairs, the merges of a round also
+ *   running in parallel.  This needs a buffer of the size of the array,
+ *   arrays smaller than CONFIG_LIBC_QSORT_PARALLEL_MINIMUM elements or
+ *   without the buffer are sorted by qsort() alone.
+ *
+ *   compar is called from several threads at the same time.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void qsort_parallel(FAR void *base, size_t nel, size_t width,
+                    CODE int (*compar)(FAR const void *, FAR const void *))
+{
+  struct qsort_job_s jobs[QSORT_NTHREADS];
+  size_t bounds[QSORT_NTHREADS + 1];
+  FAR char *buffer = NULL;
+  FAR char *src = base;
+  FAR char *dst;
+  FAR char *tmp;
+  size_t step;
+  size_t mid;
+  size_t end;
+  int njobs;
+  int i;
+
+  if (nel >= CONFIG_LIBC_QSORT_PARALLEL_MINIMUM && nel >= QSORT_NTHREADS &&
+      width > 0 && nel <= SIZE_MAX / width)
+    {
+      buffer = lib_malloc(nel * width);
+    }
+
+  if (buffer == NULL)
+    {
+      qsort(base, nel, width, compar);
+      return;
+    }
+
+  /* Sort the runs */
+
+  for (i = 0; i < QSORT_NTHREADS; i++)
+    {
+      bounds[i]      = nel / QSORT_NTHREADS * i;
+      jobs[i].src    = src + bounds[i] * width;
+      jobs[i].dst    = NULL;
+      jobs[i].nl     = nel / QSORT_NTHREADS;
+      jobs[i].nr     = 0;
+      jobs[i].width  = width;
+      jobs[i].compar = compar;
+    }
+
+  bounds[QSORT_NTHREADS] = nel;
+  jobs[QSORT_NTHREADS - 1].nl = nel - bounds[QSORT_NTHREADS - 1];
+  qsort_run(jobs, QSORT_NTHREADS);
+
+  /* Merge them in pairs from one buffer to the other */
+
+  dst = buffer;
+  for (step = 1; step < QSORT_NTHREADS; step *= 2)
+    {
+      for (njobs = 0, i = 0; i < QSORT_NTHREADS; i += 2 * step)
+        {
+          mid = MIN(i + step, QSORT_NTHREADS);
+          end = MIN(i + 2 * step, QSORT_NTHREADS);
+
+          jobs[njobs].src = src + bounds[i] * width;
+          jobs[njobs].dst = dst + bounds[i] * width;
+          jobs[njobs].nl  = bounds[mid] - bounds[i];
+          jobs[njobs].nr  = bounds[end] - bounds[mid];
+          njobs++;
+        }
+
+      qsort_run(jobs, njobs);
+
+      tmp = src;
+      src = dst;
+      dst = tmp;
+    }
+
+  if (src != base)
+    {
+      memcpy(base, src, nel * width);
+    }
+
+  lib_free(buffer);
+}
@@ -29,38 +29,64 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <errno.h>
 
 /****************************************************************************
- * Public Functions
+ * Pre-processor Definitions
  ****************************************************************************/
 
-int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
-                 FAR const void *buf)
+/* Store the next argument as 'field' of the packed buffer */
+
+#define BSPACK(field, type) \
+  do \
+    { \
+      if (offset + sizeof(var->field) > size) \
+        { \
+          return -E2BIG; \
+        } \
+      \
+      var->field = va_arg(ap, type); \
+      offset += sizeof(var->field); \
+    } \
+  while (0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The arguments in the buffer are packed without any alignment */
+
+begin_packed_struct union bsprintf_var_u
 {
-  begin_packed_struct union
-    {
-      char c;
-      char s[1];
-      short int si;
-      int i;
-      long l;
+  char c;
+  char s[1];
+  short int si;
+  int i;
+  long l;
 #ifdef CONFIG_HAVE_LONG_LONG
-      long long ll;
+  long long ll;
 #endif
-      intmax_t im;
-      size_t sz;
-      ptrdiff_t pd;
-      uintptr_t p;
+  intmax_t im;
+  size_t sz;
+  ptrdiff_t pd;
+  uintptr_t p;
 #ifdef CONFIG_HAVE_DOUBLE
-      float f;
-      double d;
+  float f;
+  double d;
 #  ifdef CONFIG_HAVE_LONG_DOUBLE
-      long double ld;
+  long double ld;
 #  endif
 #endif
-    }
+} end_packed_struct;
 
-  end_packed_struct *var;
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
+                 FAR const void *buf)
+{
+  FAR union bsprintf_var_u *var;
   FAR const char *prec = NULL;
   FAR const char *data = buf;
   char fmtstr[64];
@@ -68,6 +94,7 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
   size_t offset = 0;
   size_t ret = 0;
   size_t len = 0;
+  int sprec = -1;
   char c;
 
   while ((c = *fmt++) != '\0')
@@ -83,12 +110,22 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
         {
           len = 0;
           infmt = true;
+          prec = NULL;
+          sprec = -1;
           memset(fmtstr, 0, sizeof(fmtstr));
         }
 
       var = (FAR void *)(data + offset);
       fmtstr[len++] = c;
 
+      if (c == '%' && len == 2)
+        {
+          lib_stream_putc(s, c);
+          ret++;
+          infmt = false;
+          continue;
+        }
+
       if (c == 'c' || c == 'd' || c == 'i' || c == 'u' ||
           c == 'o' || c == 'x' || c == 'X')
         {
@@ -167,10 +204,20 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
           sprintf(fmtstr + len - 1, "%d", var->i);
           len = strlen(fmtstr);
           offset += sizeof(var->i);
+
+          if (prec != NULL)
+            {
+              sprec = var->i;
+              prec = NULL;
+            }
         }
       else if (c == 's')
         {
-          if (prec != NULL)
+          if (sprec >= 0)
+            {
+              offset += sprec;
+            }
+          else if (prec != NULL)
             {
               offset += strtol(prec, NULL, 10);
               prec = NULL;
@@ -197,3 +244,165 @@ int lib_bsprintf(FAR struct lib_outstream_s *s, FAR const IPTR char *fmt,
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: lib_vbspack
+ *
+ * Description:
+ *   Pack the arguments of a printf format into a buffer the way that
+ *   lib_bsprintf() reads them back.  Strings are copied into the buffer,
+ *   with a precision exactly that many bytes are stored.
+ *
+ * Returned Value:
+ *   The number of bytes used, or -E2BIG if the arguments do not fit.
+ *
+ ****************************************************************************/
+
+ssize_t lib_vbspack(FAR void *buf, size_t size, FAR const IPTR char *fmt,
+                    va_list ap)
+{
+  FAR union bsprintf_var_u *var;
+  FAR const char *prec = NULL;
+  FAR char *data = buf;
+  bool infmt = false;
+  size_t offset = 0;
+  int sprec = -1;
+  char c;
+
+  while ((c = *fmt++) != '\0')
+    {
+      if (!infmt)
+        {
+          if (c == '%')
+            {
+              infmt = true;
+              prec = NULL;
+              sprec = -1;
+            }
+
+          continue;
+        }
+
+      var = (FAR void *)(data + offset);
+
+      if (c == '%' && *(fmt - 2) == '%')
+        {
+          infmt = false;
+        }
+      else if (c == 'c' || c == 'd' || c == 'i' || c == 'u' ||
+               c == 'o' || c == 'x' || c == 'X')
+        {
+          if (*(fmt - 2) == 'j')
+            {
+              BSPACK(im, intmax_t);
+            }
+#ifdef CONFIG_HAVE_LONG_LONG
+          else if (*(fmt - 2) == 'l' && *(fmt - 3) == 'l')
+            {
+              BSPACK(ll, long long);
+            }
+#endif
+          else if (*(fmt - 2) == 'l')
+            {
+              BSPACK(l, long);
+            }
+          else if (*(fmt - 2) == 'z')
+            {
+              BSPACK(sz, size_t);
+            }
+          else if (*(fmt - 2) == 't')
+            {
+              BSPACK(pd, ptrdiff_t);
+            }
+          else if (*(fmt - 2) == 'h' && *(fmt - 3) == 'h')
+            {
+              BSPACK(c, int);
+            }
+          else if (*(fmt - 2) == 'h')
+            {
+              BSPACK(si, int);
+            }
+          else
+            {
+              BSPACK(i, int);
+            }
+
+          infmt = false;
+        }
+      else if (c == 'e' || c == 'f' || c == 'g' || c == 'a' ||
+               c == 'A' || c == 'E' || c == 'F' || c == 'G')
+        {
+#ifdef CONFIG_HAVE_DOUBLE
+          if (*(fmt - 2) == 'h')
+            {
+              BSPACK(f, double);
+            }
+#  ifdef CONFIG_HAVE_LONG_DOUBLE
+          else if (*(fmt - 2) == 'L')
+            {
+              BSPACK(ld, long double);
+            }
+#  endif
+          else
+            {
+              BSPACK(d, double);
+            }
+
+          infmt = false;
+#endif
+        }
+      else if (c == '*')
+        {
+          BSPACK(i, int);
+
+          if (prec != NULL)
+            {
+              sprec = var->i;
+              prec = NULL;
+            }
+        }
+      else if (c == 's')
+        {
+          FAR const char *str = va_arg(ap, FAR const char *);
+          size_t len;
+          size_t n;
+
+          if (str == NULL)
+            {
+              str = "(null)";
+            }
+
+          if (sprec >= 0 || prec != NULL)
+            {
+              n   = sprec >= 0 ? sprec : strtol(prec, NULL, 10);
+              len = strnlen(str, n);
+            }
+          else
+            {
+              len = strlen(str);
+              n   = len + 1;
+            }
+
+          if (offset + n > size)
+            {
+              return -E2BIG;
+            }
+
+          memcpy(data + offset, str, len);
+          memset(data + offset + len, 0, n - len);
+          offset += n;
+          infmt = false;
+        }
+      else if (c == 'p')
+        {
+          BSPACK(p, uintptr_t);
+          infmt = false;
+        }
+      else if (c == '.')
+        {
+          prec = fmt;
+        }
+    }
+
+  return offset;
+}
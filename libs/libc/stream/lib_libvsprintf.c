@@ -194,6 +194,28 @@ static int vsprintf_internal(FAR struct lib_outstream_s *stream,
     {
       for (; ; )
         {
+#ifndef CONFIG_ARCH_ROMGETC
+          /* Hand the literal text up to the next conversion to the stream
+           * in one go instead of character by character.
+           */
+
+          pnt = fmt;
+          while (*fmt != '\0' && *fmt != '%')
+            {
+              fmt++;
+            }
+
+          if (fmt != pnt)
+            {
+#  ifdef CONFIG_LIBC_NUMBERED_ARGS
+              if (stream != NULL)
+#  endif
+                {
+                  stream_puts(pnt, fmt - pnt, stream);
+                }
+            }
+#endif
+
           c = fmt_char(fmt);
           if (c == '\0')
             {
@@ -28,6 +28,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "libc.h"
 
@@ -53,7 +54,7 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *self, int ch)
 
   do
     {
-      result = fputc(ch, stream->handle);
+      result = fputc_unlocked(ch, stream->handle);
       if (result != EOF)
         {
           self->nput++;
@@ -86,17 +87,29 @@ static ssize_t stdoutstream_puts(FAR struct lib_outstream_s *self,
 
   do
     {
-      result = fwrite(buffer, 1, len, stream->handle);
+      result = lib_fwrite_unlocked(buffer, len, stream->handle);
       if (result >= 0)
         {
           self->nput += result;
+
+          /* A run may now carry newlines, flush a line buffered stream
+           * the way fputc() would have.
+           */
+
+          if ((stream->handle->fs_flags & __FS_FLAG_LBF) != 0 &&
+              memchr(buffer, '\n', result) != NULL &&
+              lib_fflush_unlocked(stream->handle) < 0)
+            {
+              return -get_errno();
+            }
+
           return result;
         }
 
-      result = _NX_GETERRVAL(result);
+      result = -get_errno();
 
-      /* EINTR (meaning that fputc was interrupted by a signal) is the only
-       * recoverable error.
+      /* EINTR (meaning that the write was interrupted by a signal) is the
+       * only recoverable error.
        */
     }
   while (result == -EINTR);
@@ -127,7 +140,9 @@ static int stdoutstream_flush(FAR struct lib_outstream_s *self)
  * Name: lib_stdoutstream
  *
  * Description:
- *   Initializes a stream for use with a FILE instance.
+ *   Initializes a stream for use with a FILE instance.  The stream writes
+ *   with the _unlocked stdio functions, the caller must hold the FILE lock
+ *   (flockfile()) for as long as the stream is in use.
  *
  * Input Parameters:
  *   outstream - User allocated, uninitialized instance of struct
@@ -37,8 +37,64 @@
  * Included Files
  ****************************************************************************/
 
+#include <limits.h>
+
 #include "lib_ultoa_invert.h"
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The decimal digit pairs 00 to 99, so that each (slow) division yields
+ * two digits at a time.
+ */
+
+static const char g_dec2[200] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+static const char g_digitslower[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+static const char g_digitsupper[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static FAR char *ultoa_invert_dec(unsigned long val, FAR char *str)
+{
+  unsigned int v;
+
+  while (val >= 100)
+    {
+      v   = val % 100;
+      val = val / 100;
+
+      *str++ = g_dec2[2 * v + 1];
+      *str++ = g_dec2[2 * v];
+    }
+
+  v = val;
+  if (v >= 10)
+    {
+      *str++ = g_dec2[2 * v + 1];
+      *str++ = g_dec2[2 * v];
+    }
+  else
+    {
+      *str++ = '0' + v;
+    }
+
+  return str;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -49,34 +105,60 @@ FAR char *__ultoa_invert(unsigned long long val, FAR char *str, int base)
 FAR char *__ultoa_invert(unsigned long val, FAR char *str, int base)
 #endif
 {
-  int upper = 0;
+  FAR const char *digits = g_digitslower;
 
   if (base & XTOA_UPPER)
     {
-      upper = 1;
+      digits = g_digitsupper;
       base &= ~XTOA_UPPER;
     }
 
-  do
+  if (base == 10)
     {
-      int v;
+#if defined(CONFIG_LIBC_LONG_LONG) && ULLONG_MAX > ULONG_MAX
+      /* Peel off digit pairs with the (library call) long long division
+       * only until the value fits a native long.
+       */
+
+      while (val > ULONG_MAX)
+        {
+          unsigned int v = val % 100;
+
+          val = val / 100;
+
+          *str++ = g_dec2[2 * v + 1];
+          *str++ = g_dec2[2 * v];
+        }
+#endif
+
+      return ultoa_invert_dec((unsigned long)val, str);
+    }
 
-      v   = val % base;
-      val = val / base;
+  /* Octal, hexadecimal and binary need no division at all */
+
+  if ((base & (base - 1)) == 0)
+    {
+      int shift = 0;
 
-      if (v <= 9)
+      while ((1 << shift) < base)
         {
-          v += '0';
+          shift++;
         }
-      else
+
+      do
         {
-          if (upper)
-            v += 'A' - 10;
-          else
-            v += 'a' - 10;
+          *str++ = digits[val & (base - 1)];
+          val >>= shift;
         }
+      while (val);
+
+      return str;
+    }
 
-      *str++ = v;
+  do
+    {
+      *str++ = digits[val % base];
+      val    = val / base;
     }
   while (val);
 
@@ -21,6 +21,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/mm/kasan.h>
 #include <sys/types.h>
 #include <string.h>
 
@@ -57,7 +58,7 @@
 
 #if !defined(CONFIG_LIBC_ARCH_MEMCPY) && defined(LIBC_BUILD_MEMCPY)
 #undef memcpy
-no_builtin("memcpy")
+no_builtin("memcpy") nosanitize_address
 FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR char *pout = dest;
@@ -65,6 +66,9 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
   FAR long *paligned_out;
   FAR const long *paligned_in;
 
+  kasan_check_read(src, n);
+  kasan_check_write(dest, n);
+
   /* If the size is small, or either pin or pout is unaligned,
    * then punt into the byte copy loop.  This should be rare.
    */
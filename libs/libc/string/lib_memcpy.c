@@ -25,6 +25,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/mm/kasan.h>
 #include <sys/types.h>
 #include <string.h>
 
@@ -40,11 +41,17 @@
 
 #if !defined(CONFIG_LIBC_ARCH_MEMCPY) && defined(LIBC_BUILD_MEMCPY)
 #undef memcpy
-no_builtin("memcpy")
+no_builtin("memcpy") nosanitize_address
 FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char *)dest;
   FAR unsigned char *pin  = (FAR unsigned char *)src;
+
+  /* One check of each range instead of one per byte */
+
+  kasan_check_read(src, n);
+  kasan_check_write(dest, n);
+
   while (n-- > 0)
     {
       *pout++ = *pin++;
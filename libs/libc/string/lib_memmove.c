@@ -25,6 +25,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/mm/kasan.h>
 #include <sys/types.h>
 #include <string.h>
 
@@ -36,12 +37,15 @@
 
 #if !defined(CONFIG_LIBC_ARCH_MEMMOVE) && defined(LIBC_BUILD_MEMMOVE)
 #undef memmove
-no_builtin("memmove")
+no_builtin("memmove") nosanitize_address
 FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
 {
   FAR char *tmp;
   FAR char *s;
 
+  kasan_check_read(src, count);
+  kasan_check_write(dest, count);
+
   if (dest <= src)
     {
       memcpy(dest, src, count);
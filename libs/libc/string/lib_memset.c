@@ -25,6 +25,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/mm/kasan.h>
 
 #include <sys/types.h>
 
@@ -52,7 +53,7 @@
 
 #if !defined(CONFIG_LIBC_ARCH_MEMSET) && defined(LIBC_BUILD_MEMSET)
 #undef memset
-no_builtin("memset")
+no_builtin("memset") nosanitize_address
 FAR void *memset(FAR void *s, int c, size_t n)
 {
 #ifdef CONFIG_LIBC_MEMSET_OPTSPEED
@@ -68,6 +69,10 @@ FAR void *memset(FAR void *s, int c, size_t n)
   uint64_t  val64 = ((uint64_t)val32 << 32) | (uint64_t)val32;
 #endif
 
+  /* One check of the range instead of one per store */
+
+  kasan_check_write(s, n);
+
   /* Make sure that there is something to be cleared */
 
   if (n > 0)
@@ -198,6 +203,8 @@ FAR void *memset(FAR void *s, int c, size_t n)
   /* This version is optimized for size */
 
   FAR unsigned char *p = (FAR unsigned char *)s;
+
+  kasan_check_write(s, n);
   while (n-- > 0) *p++ = c;
 #endif
   return s;
@@ -32,6 +32,7 @@
 
 #include <nuttx/config.h>
 #include <nuttx/compiler.h>
+#include <nuttx/mm/kasan.h>
 
 #include <stddef.h>
 #include <stdint.h>
@@ -284,12 +285,19 @@ typedef uint32_t            uintn;
  *
  ****************************************************************************/
 
-no_builtin("memcpy")
+no_builtin("memcpy") nosanitize_address
 FAR void *memcpy(FAR void *dest, FAR const void *src, size_t count)
 {
   FAR uint8_t *dst8 = (FAR uint8_t *)dest;
   FAR uint8_t *src8 = (FAR uint8_t *)src;
 
+  /* The shifted copy reads whole aligned words of src, possibly past its
+   * ends, only the range that is really copied is checked.
+   */
+
+  kasan_check_read(src, count);
+  kasan_check_write(dest, count);
+
   if (count < 8)
     {
       COPY_REMAINING(count);
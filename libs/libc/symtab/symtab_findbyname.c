@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 #include <debug.h>
 #include <assert.h>
@@ -55,7 +56,15 @@ FAR const struct symtab_s *
 symtab_findbyname(FAR const struct symtab_s *symtab,
                   FAR const char *name, int nsyms)
 {
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+#if defined(CONFIG_SYMTAB_ORDEREDBYHASH)
+  uint64_t hlow  = 0;
+  uint64_t hhigh = (uint64_t)UINT32_MAX + 1;
+  uint32_t hash;
+  uint32_t h;
+  int low  = 0;
+  int high = nsyms;
+  int mid;
+#elif defined(CONFIG_SYMTAB_ORDEREDBYNAME)
   int low  = 0;
   int high = nsyms - 1;
   int mid;
@@ -77,7 +86,54 @@ symtab_findbyname(FAR const struct symtab_s *symtab,
 
   DEBUGASSERT(name != NULL);
 
-#ifdef CONFIG_SYMTAB_ORDEREDBYNAME
+#if defined(CONFIG_SYMTAB_ORDEREDBYHASH)
+  /* The hashes of symtab[low..high-1] lie in [hlow, hhigh) and so does
+   * the hash of name.  They are spread evenly, so the position of name
+   * is interpolated from its hash rather than halving the range.
+   */
+
+  hash = symtab_hash(name);
+  while (low < high)
+    {
+      mid = low + (int)((hash - hlow) * (uint64_t)(high - low) /
+                        (hhigh - hlow));
+      h   = symtab_hash(symtab[mid].sym_name);
+      if (h < hash)
+        {
+          low  = mid + 1;
+          hlow = (uint64_t)h + 1;
+        }
+      else if (h > hash)
+        {
+          high  = mid;
+          hhigh = h;
+        }
+      else
+        {
+          /* Names with the same hash sit next to each other, sorted by
+           * name.
+           */
+
+          while (mid > 0 && symtab_hash(symtab[mid - 1].sym_name) == hash)
+            {
+              mid--;
+            }
+
+          for (; mid < nsyms && symtab_hash(symtab[mid].sym_name) == hash;
+               mid++)
+            {
+              if (strcmp(name, symtab[mid].sym_name) == 0)
+                {
+                  return &symtab[mid];
+                }
+            }
+
+          break;
+        }
+    }
+
+  return NULL;
+#elif defined(CONFIG_SYMTAB_ORDEREDBYNAME)
   while (low < high)
     {
       /* Compare the name to the one in the middle.  (or just below
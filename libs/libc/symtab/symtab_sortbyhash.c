@@ -0,0 +1,97 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_sortbyhash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/symtab.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int symtab_comparehash(FAR const void *arg1, FAR const void *arg2)
+{
+  FAR const struct symtab_s *symtab1 = arg1;
+  FAR const struct symtab_s *symtab2 = arg2;
+  uint32_t hash1 = symtab_hash(symtab1->sym_name);
+  uint32_t hash2 = symtab_hash(symtab2->sym_name);
+
+  if (hash1 != hash2)
+    {
+      return hash1 < hash2 ? -1 : 1;
+    }
+
+  return strcmp(symtab1->sym_name, symtab2->sym_name);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash
+ *
+ * Description:
+ *   Return the 32-bit FNV-1a hash of a symbol name.  tools/mksymtab -h
+ *   orders the generated tables with the same function.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: symtab_sortbyhash
+ *
+ * Description:
+ *   Sort the symbol table by the hash of the names, names with the same
+ *   hash by name.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void symtab_sortbyhash(FAR struct symtab_s *symtab, int nsyms)
+{
+  DEBUGASSERT(symtab != NULL && nsyms != 0);
+  qsort(symtab, nsyms, sizeof(symtab[0]), symtab_comparehash);
+}
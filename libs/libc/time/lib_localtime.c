@@ -310,6 +310,22 @@ static rmutex_t g_gmt_lock = NXRMUTEX_INITIALIZER;
 
 static struct tm g_tm;
 
+/* The local time of the last localsub() stays valid up to the next
+ * transition or the end of its day, whichever is first.  Within that
+ * window only the time of day changes, so the following calls copy the
+ * date and add the seconds.  The window is shared and protected by
+ * g_lcl_lock which localsub() holds anyway, a copy per thread would not
+ * save the lock.  An empty window has start == end.
+ */
+
+static struct
+{
+  time_t start;          /* First second of the window */
+  time_t end;            /* First second after the window */
+  time_t day;            /* The window's day starts here at its offset */
+  struct tm tm;          /* The date of the window, at 00:00:00 */
+} g_lcl_cache;
+
 static const int g_mon_lengths[2][MONSPERYEAR] =
 {
   {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},
@@ -1918,6 +1934,9 @@ static FAR struct tm *localsub(FAR const time_t *timep,
   int i;
   FAR struct tm *result;
   const time_t t = *timep;
+  time_t start;
+  time_t end;
+  time_t day;
 
   sp = g_lcl_ptr;
   if (sp == NULL)
@@ -1931,6 +1950,20 @@ static FAR struct tm *localsub(FAR const time_t *timep,
     }
 
   tz_lock(&g_lcl_lock);
+  if (t >= g_lcl_cache.start && t < g_lcl_cache.end)
+    {
+      time_t secs = t - g_lcl_cache.day;
+
+      *tmp = g_lcl_cache.tm;
+      tmp->tm_hour = secs / SECSPERHOUR;
+      tmp->tm_min  = secs / SECSPERMIN % MINSPERHOUR;
+      tmp->tm_sec  = secs % SECSPERMIN;
+      tzname[tmp->tm_isdst] = (FAR char *)tmp->tm_zone;
+
+      tz_unlock(&g_lcl_lock);
+      return tmp;
+    }
+
   if ((sp->goback && t < sp->ats[0]) ||
       (sp->goahead && t > sp->ats[sp->timecnt - 1]))
     {
@@ -2001,7 +2034,9 @@ static FAR struct tm *localsub(FAR const time_t *timep,
 
   if (sp->timecnt == 0 || t < sp->ats[0])
     {
-      i = sp->defaulttype;
+      i     = sp->defaulttype;
+      start = TIME_T_MIN;
+      end   = sp->timecnt == 0 ? TIME_T_MAX : sp->ats[0];
     }
   else
     {
@@ -2022,7 +2057,19 @@ static FAR struct tm *localsub(FAR const time_t *timep,
             }
         }
 
-      i = sp->types[lo - 1];
+      i     = sp->types[lo - 1];
+      start = sp->ats[lo - 1];
+
+      /* Past the last transition, goahead must still see the times */
+
+      if (lo < sp->timecnt)
+        {
+          end = sp->ats[lo];
+        }
+      else
+        {
+          end = sp->goahead ? sp->ats[lo - 1] + 1 : TIME_T_MAX;
+        }
     }
 
   ttisp = &sp->ttis[i];
@@ -2039,6 +2086,22 @@ static FAR struct tm *localsub(FAR const time_t *timep,
       result->tm_isdst = ttisp->tt_isdst;
       tzname[result->tm_isdst] = &sp->chars[ttisp->tt_desigidx];
       result->tm_zone = tzname[result->tm_isdst];
+
+      /* Leap seconds would move the time of day within the window */
+
+      day = t - (result->tm_hour * SECSPERHOUR +
+                 result->tm_min * SECSPERMIN + result->tm_sec);
+      if (sp->leapcnt == 0 && day <= TIME_T_MAX - SECSPERDAY)
+        {
+          g_lcl_cache.start      = start > day ? start : day;
+          g_lcl_cache.end        = end < day + SECSPERDAY ?
+                                   end : day + SECSPERDAY;
+          g_lcl_cache.day        = day;
+          g_lcl_cache.tm         = *result;
+          g_lcl_cache.tm.tm_hour = 0;
+          g_lcl_cache.tm.tm_min  = 0;
+          g_lcl_cache.tm.tm_sec  = 0;
+        }
     }
 
   tz_unlock(&g_lcl_lock);
@@ -2810,6 +2873,7 @@ void tzset(void)
 
 tzname:
   settzname();
+  g_lcl_cache.end = g_lcl_cache.start;
   g_lcl_isset = 1;
   tz_unlock(&g_lcl_lock);
 }
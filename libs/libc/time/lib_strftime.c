@@ -29,6 +29,7 @@
 
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <debug.h>
 
 #include <nuttx/clock.h>
@@ -102,6 +103,79 @@ static bool is_leap(int year)
   return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
 }
 
+/****************************************************************************
+ * Name: put_fields
+ *
+ * Description:
+ *   Put up to three zero padded, non-negative numbers separated by sep,
+ *   like snprintf() with "%0*d<sep>%02d<sep>%02d" but without parsing a
+ *   format.  The numbers of the timestamps are done this way.
+ *
+ * Returned Value:
+ *   The length of the full output, as snprintf() returns it.
+ *
+ ****************************************************************************/
+
+static int put_fields(FAR char *dest, int chleft, int width0, int value0,
+                      int value1, int value2, int nfields, char sep)
+{
+  char buf[16];
+  int values[3];
+  int len = 0;
+  int width;
+  int value;
+  int i;
+  int j;
+
+  values[0] = value0;
+  values[1] = value1;
+  values[2] = value2;
+
+  for (i = 0; i < nfields; i++)
+    {
+      width = i == 0 ? width0 : 2;
+      if (values[i] < 0 || values[i] >= (width == 4 ? 10000 : 100))
+        {
+          /* Out of range, leave it to snprintf() */
+
+          switch (nfields)
+            {
+              case 1:
+                return snprintf(dest, chleft, "%0*d", width0, value0);
+
+              case 2:
+                return snprintf(dest, chleft, "%0*d%c%02d", width0, value0,
+                                sep, value1);
+
+              default:
+                return snprintf(dest, chleft, "%0*d%c%02d%c%02d", width0,
+                                value0, sep, value1, sep, value2);
+            }
+        }
+
+      if (i > 0)
+        {
+          buf[len++] = sep;
+        }
+
+      value = values[i];
+      for (j = width - 1; j >= 0; j--)
+        {
+          buf[len + j] = '0' + value % 10;
+          value /= 10;
+        }
+
+      len += width;
+    }
+
+  /* Like snprintf(), the output may be cut short.  The counts of the
+   * caller then tell that it did not fit.
+   */
+
+  memcpy(dest, buf, len < chleft ? len : chleft);
+  return len;
+}
+
 /****************************************************************************
  * Name: get_week_num
  *
@@ -365,7 +439,7 @@ process_next:
 
            case 'd':
              {
-               len = snprintf(dest, chleft, "%02d", tm->tm_mday);
+               len = put_fields(dest, chleft, 2, tm->tm_mday, 0, 0, 1, 0);
              }
              break;
 
@@ -401,9 +475,8 @@ process_next:
 
             case 'F':
               {
-                len = snprintf(dest, chleft, "%04d-%02d-%02d",
-                              tm->tm_year + TM_YEAR_BASE, tm->tm_mon + 1,
-                              tm->tm_mday);
+                len = put_fields(dest, chleft, 4, tm->tm_year + TM_YEAR_BASE,
+                                 tm->tm_mon + 1, tm->tm_mday, 3, '-');
               }
               break;
 
@@ -430,7 +503,7 @@ process_next:
 
            case 'H':
              {
-               len = snprintf(dest, chleft, "%02d", tm->tm_hour);
+               len = put_fields(dest, chleft, 2, tm->tm_hour, 0, 0, 1, 0);
              }
              break;
 
@@ -487,7 +560,7 @@ process_next:
 
            case 'm':
              {
-               len = snprintf(dest, chleft, "%02d", tm->tm_mon + 1);
+               len = put_fields(dest, chleft, 2, tm->tm_mon + 1, 0, 0, 1, 0);
              }
              break;
 
@@ -495,7 +568,7 @@ process_next:
 
            case 'M':
              {
-               len = snprintf(dest, chleft, "%02d", tm->tm_min);
+               len = put_fields(dest, chleft, 2, tm->tm_min, 0, 0, 1, 0);
              }
              break;
 
@@ -568,8 +641,8 @@ process_next:
 
            case 'R':
              {
-               len = snprintf(dest, chleft, "%02d:%02d",
-                              tm->tm_hour, tm->tm_min);
+               len = put_fields(dest, chleft, 2, tm->tm_hour, tm->tm_min, 0,
+                                2, ':');
              }
              break;
 
@@ -591,7 +664,7 @@ process_next:
 
            case 'S':
              {
-               len = snprintf(dest, chleft, "%02d", tm->tm_sec);
+               len = put_fields(dest, chleft, 2, tm->tm_sec, 0, 0, 1, 0);
              }
              break;
 
@@ -608,8 +681,8 @@ process_next:
 
            case 'T':
              {
-               len = snprintf(dest, chleft, "%02d:%02d:%02d",
-                              tm->tm_hour, tm->tm_min, tm->tm_sec);
+               len = put_fields(dest, chleft, 2, tm->tm_hour, tm->tm_min,
+                                tm->tm_sec, 3, ':');
              }
              break;
 
@@ -701,8 +774,8 @@ process_next:
 
            case 'Y':
              {
-               len = snprintf(dest, chleft, "%04d",
-                              tm->tm_year + TM_YEAR_BASE);
+               len = put_fields(dest, chleft, 4, tm->tm_year + TM_YEAR_BASE,
+                                0, 0, 1, 0);
              }
              break;
 
@@ -149,3 +149,106 @@ void inv_park_transform(FAR phase_angle_f32_t *angle,
   ab->a = angle->cos * dq->d - angle->sin * dq->q;
   ab->b = angle->cos * dq->q + angle->sin * dq->d;
 }
+
+/****************************************************************************
+ * Name: clarke_transform_n
+ *
+ * Description:
+ *   Clarke transform of n independent axes, abc[i] -> ab[i].  The loops of
+ *   the _n transforms have no data dependent branches, so with
+ *   -ftree-vectorize (or -O3) the compiler vectorizes them across the axes
+ *   on targets with SIMD such as NEON or Helium.
+ *
+ * Input Parameters:
+ *   abc - (in) array of n abc frames
+ *   ab  - (out) array of n alpha-beta frames
+ *   n   - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_n(FAR abc_frame_f32_t *abc,
+                        FAR ab_frame_f32_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(abc != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      ab[i].a = abc[i].a;
+      ab[i].b = ONE_BY_SQRT3_F*abc[i].a + TWO_BY_SQRT3_F*abc[i].b;
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_n
+ *
+ * Description:
+ *   Park transform of n independent axes, ab[i] -> dq[i] with angle[i].
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   ab    - (in) array of n alpha-beta frames
+ *   dq    - (out) array of n direct-quadrature frames
+ *   n     - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_n(FAR phase_angle_f32_t *angle,
+                      FAR ab_frame_f32_t *ab,
+                      FAR dq_frame_f32_t *dq, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      dq[i].d = angle[i].cos * ab[i].a + angle[i].sin * ab[i].b;
+      dq[i].q = angle[i].cos * ab[i].b - angle[i].sin * ab[i].a;
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_n
+ *
+ * Description:
+ *   Inverse Park transform of n independent axes, dq[i] -> ab[i] with
+ *   angle[i].
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   dq    - (in) array of n direct-quadrature frames
+ *   ab    - (out) array of n alpha-beta frames
+ *   n     - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_n(FAR phase_angle_f32_t *angle,
+                          FAR dq_frame_f32_t *dq,
+                          FAR ab_frame_f32_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      ab[i].a = angle[i].cos * dq[i].d - angle[i].sin * dq[i].q;
+      ab[i].b = angle[i].cos * dq[i].q + angle[i].sin * dq[i].d;
+    }
+}
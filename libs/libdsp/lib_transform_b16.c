@@ -151,3 +151,108 @@ void inv_park_transform_b16(FAR phase_angle_b16_t *angle,
   ab->a = b16mulb16(angle->cos, dq->d) - b16mulb16(angle->sin, dq->q);
   ab->b = b16mulb16(angle->cos, dq->q) + b16mulb16(angle->sin, dq->d);
 }
+
+/****************************************************************************
+ * Name: clarke_transform_n_b16
+ *
+ * Description:
+ *   Clarke transform of n independent axes, abc[i] -> ab[i].
+ *
+ * Input Parameters:
+ *   abc - (in) array of n abc frames
+ *   ab  - (out) array of n alpha-beta frames
+ *   n   - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void clarke_transform_n_b16(FAR abc_frame_b16_t *abc,
+                            FAR ab_frame_b16_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(abc != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      ab[i].a = abc[i].a;
+      ab[i].b = (b16mulb16(ONE_BY_SQRT3_B16, abc[i].a) +
+                 b16mulb16(TWO_BY_SQRT3_B16, abc[i].b));
+    }
+}
+
+/****************************************************************************
+ * Name: park_transform_n_b16
+ *
+ * Description:
+ *   Park transform of n independent axes, ab[i] -> dq[i] with angle[i].
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   ab    - (in) array of n alpha-beta frames
+ *   dq    - (out) array of n direct-quadrature frames
+ *   n     - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void park_transform_n_b16(FAR phase_angle_b16_t *angle,
+                          FAR ab_frame_b16_t *ab,
+                          FAR dq_frame_b16_t *dq, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      dq[i].d = (b16mulb16(angle[i].cos, ab[i].a) +
+                 b16mulb16(angle[i].sin, ab[i].b));
+      dq[i].q = (b16mulb16(angle[i].cos, ab[i].b) -
+                 b16mulb16(angle[i].sin, ab[i].a));
+    }
+}
+
+/****************************************************************************
+ * Name: inv_park_transform_n_b16
+ *
+ * Description:
+ *   Inverse Park transform of n independent axes, dq[i] -> ab[i] with
+ *   angle[i].
+ *
+ * Input Parameters:
+ *   angle - (in) array of n phase angles
+ *   dq    - (in) array of n direct-quadrature frames
+ *   ab    - (out) array of n alpha-beta frames
+ *   n     - (in) number of axes
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void inv_park_transform_n_b16(FAR phase_angle_b16_t *angle,
+                              FAR dq_frame_b16_t *dq,
+                              FAR ab_frame_b16_t *ab, size_t n)
+{
+  size_t i;
+
+  LIBDSP_DEBUGASSERT(angle != NULL);
+  LIBDSP_DEBUGASSERT(dq != NULL);
+  LIBDSP_DEBUGASSERT(ab != NULL);
+
+  for (i = 0; i < n; i++)
+    {
+      ab[i].a = (b16mulb16(angle[i].cos, dq[i].d) -
+                 b16mulb16(angle[i].sin, dq[i].q));
+      ab[i].b = (b16mulb16(angle[i].cos, dq[i].q) +
+                 b16mulb16(angle[i].sin, dq[i].d));
+    }
+}
@@ -217,7 +217,62 @@ uint16_t nxglib_rgb565_blend(uint16_t color1, uint16_t color2, ub16_t frac1)
 
   /* Recombine and return the blended value */
 
-  return RGBTO24(r, g, b);
+  return RGBTO16(r, g, b);
+}
+
+#endif
+
+/****************************************************************************
+ * Name: nxglib_argb32_alphablend and nxglib_rgb565_alphablend
+ *
+ * Description:
+ *   Draw color1 with the given opacity over the opaque color2, all the
+ *   components at once: red and blue share one multiply, green (and the
+ *   alpha byte of ARGB8888) the other.  In RGB565 the green component is
+ *   moved to the upper half word so that the three fit in 32 bits with
+ *   room for a 5-bit alpha, so RGB565 blends in 32 steps of opacity.
+ *
+ * Input Parameters:
+ *   color1 - The foreground color
+ *   color2 - The opaque, background color
+ *   alpha  - The opacity of color1, 0 (transparent) to 255 (opaque)
+ *
+ * Returned Value:
+ *   The blended color, encoded as color1 and color2
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NX_DISABLE_24BPP) || !defined(CONFIG_NX_DISABLE_32BPP)
+
+uint32_t nxglib_argb32_alphablend(uint32_t color1, uint32_t color2,
+                                  uint8_t alpha)
+{
+  uint32_t a = alpha + (alpha >> 7);  /* 0..256 */
+  uint32_t rb;
+  uint32_t ag;
+
+  rb = ((color1 & 0x00ff00ff) * a +
+        (color2 & 0x00ff00ff) * (256 - a) + 0x00800080) >> 8;
+  ag = ((color1 >> 8) & 0x00ff00ff) * a +
+       ((color2 >> 8) & 0x00ff00ff) * (256 - a) + 0x00800080;
+
+  return (rb & 0x00ff00ff) | (ag & 0xff00ff00);
+}
+
+#endif
+
+#ifndef CONFIG_NX_DISABLE_16BPP
+
+uint16_t nxglib_rgb565_alphablend(uint16_t color1, uint16_t color2,
+                                  uint8_t alpha)
+{
+  uint32_t a = (alpha + 4) >> 3;  /* 0..32 */
+  uint32_t fg = (color1 | ((uint32_t)color1 << 16)) & 0x07e0f81f;
+  uint32_t bg = (color2 | ((uint32_t)color2 << 16)) & 0x07e0f81f;
+  uint32_t blend;
+
+  blend = ((((fg - bg) * a) >> 5) + bg) & 0x07e0f81f;
+  return (uint16_t)(blend | (blend >> 16));
 }
 
 #endif
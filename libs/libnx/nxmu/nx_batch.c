@@ -0,0 +1,77 @@
+/****************************************************************************
+ * libs/libnx/nxmu/nx_batch.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nx/nx.h>
+#include <nuttx/nx/nxbe.h>
+#include <nuttx/nx/nxmu.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nx_batch
+ *
+ * Description:
+ *   Enable or disable batch mode of a client connection.  In batch mode
+ *   nx_setpixel(), nx_fill(), nx_filltrapezoid() and nx_move() requests are
+ *   collected and sent to the server together in single messages of up to
+ *   CONFIG_NX_BATCH_MSGLEN bytes, which saves a message queue round trip
+ *   and a server wake-up for most of them.
+ *
+ *   The collected requests are sent when the buffer is full, before any
+ *   other request of the client and when batch mode is disabled, so they
+ *   are always performed in the order they were made.
+ *
+ * Input Parameters:
+ *   handle - The handle returned by nx_connect()
+ *   enable - True to collect the drawing requests, false to send them
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+int nx_batch(NXHANDLE handle, bool enable)
+{
+  FAR struct nxmu_conn_s *conn = (FAR struct nxmu_conn_s *)handle;
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (conn == NULL)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+#endif
+
+  conn->batch = enable;
+  return enable ? OK : nxmu_flushbatch(conn);
+}
@@ -30,6 +30,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <string.h>
+
 #include <nuttx/mqueue.h>
 #include <nuttx/nx/nxmu.h>
 
@@ -56,6 +58,10 @@
 int nxmu_sendserver(FAR struct nxmu_conn_s *conn, FAR const void *msg,
                     size_t msglen)
 {
+#ifdef CONFIG_NX_BATCH
+  FAR struct nxsvrmsg_batch_s *batch;
+  uint32_t msgid = *(FAR const uint32_t *)msg;
+#endif
   int ret;
 
   /* Sanity checking */
@@ -68,6 +74,38 @@ int nxmu_sendserver(FAR struct nxmu_conn_s *conn, FAR const void *msg,
     }
 #endif
 
+#ifdef CONFIG_NX_BATCH
+  /* Drawing messages of a client in batch mode are only collected, any
+   * other message first sends what was collected to keep the order.
+   */
+
+  if (conn->batch &&
+      (msgid == NX_SVRMSG_SETPIXEL || msgid == NX_SVRMSG_FILL ||
+       msgid == NX_SVRMSG_FILLTRAP || msgid == NX_SVRMSG_MOVE))
+    {
+      if (sizeof(struct nxsvrmsg_batch_s) + conn->nbatch +
+          NX_BATCH_ALIGN(msglen) > NX_MXSVRMSGLEN)
+        {
+          ret = nxmu_flushbatch(conn);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      batch = (FAR struct nxsvrmsg_batch_s *)conn->batchbuf;
+      memcpy((FAR uint8_t *)batch->msgs + conn->nbatch, msg, msglen);
+      conn->nbatch += NX_BATCH_ALIGN(msglen);
+      return OK;
+    }
+
+  ret = nxmu_flushbatch(conn);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Send the message to the server */
 
   ret = _MQ_SEND(conn->cwrmq, msg, msglen, NX_SVRMSG_PRIO);
@@ -80,3 +118,48 @@ int nxmu_sendserver(FAR struct nxmu_conn_s *conn, FAR const void *msg,
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxmu_flushbatch
+ *
+ * Description:
+ *   Send the drawing messages collected by a client in batch mode to the
+ *   server as one NX_SVRMSG_BATCH message.
+ *
+ * Input Parameters:
+ *   conn   - A pointer to the server connection structure
+ *
+ * Returned Value:
+ *   OK on success; ERROR on failure with errno set appropriately
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NX_BATCH
+int nxmu_flushbatch(FAR struct nxmu_conn_s *conn)
+{
+  FAR struct nxsvrmsg_batch_s *batch =
+    (FAR struct nxsvrmsg_batch_s *)conn->batchbuf;
+  int ret;
+
+  if (conn->nbatch == 0)
+    {
+      return OK;
+    }
+
+  batch->msgid  = NX_SVRMSG_BATCH;
+  batch->nbytes = conn->nbatch;
+  conn->nbatch  = 0;
+
+  ret = _MQ_SEND(conn->cwrmq, (FAR const char *)batch,
+                 sizeof(struct nxsvrmsg_batch_s) + batch->nbytes,
+                 NX_SVRMSG_PRIO);
+  if (ret < 0)
+    {
+      _NX_SETERRNO(ret);
+      gerr("ERROR: _MQ_SEND failed: %d\n", _NX_GETERRNO(ret));
+      ret = ERROR;
+    }
+
+  return ret;
+}
+#endif
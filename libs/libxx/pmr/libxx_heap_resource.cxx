@@ -0,0 +1,129 @@
+//***************************************************************************
+// libs/libxx/pmr/libxx_heap_resource.cxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <new>
+#include <assert.h>
+
+#include <nuttx/mm/memory_resource.hxx>
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx
+{
+namespace pmr
+{
+  //*************************************************************************
+  // Name: heap_resource::heap_resource
+  //
+  // Description:
+  //   A new heap named name over size bytes at start.  The region must
+  //   outlive the resource.
+  //
+  //*************************************************************************
+
+  heap_resource::heap_resource(FAR const char *name, FAR void *start,
+                               std::size_t size)
+    : m_heap(mm_initialize(name, start, size)), m_owner(true)
+  {
+    if (m_heap == nullptr)
+      {
+#ifdef CONFIG_CXX_EXCEPTION
+        throw std::bad_alloc();
+#else
+        PANIC();
+#endif
+      }
+  }
+
+  heap_resource::heap_resource(FAR struct mm_heap_s *heap)
+    : m_heap(heap), m_owner(false)
+  {
+    DEBUGASSERT(heap != nullptr);
+  }
+
+  //*************************************************************************
+  // Name: heap_resource::~heap_resource
+  //*************************************************************************
+
+  heap_resource::~heap_resource()
+  {
+    if (m_owner)
+      {
+        mm_uninitialize(m_heap);
+      }
+  }
+
+  //*************************************************************************
+  // Name: heap_resource::do_allocate
+  //*************************************************************************
+
+  FAR void *heap_resource::do_allocate(std::size_t bytes, std::size_t align)
+  {
+    FAR void *p = align > MM_ALIGN ?
+                  mm_memalign(m_heap, align, bytes) :
+                  mm_malloc(m_heap, bytes);
+
+    if (p == nullptr)
+      {
+#ifdef CONFIG_CXX_EXCEPTION
+        throw std::bad_alloc();
+#else
+        PANIC();
+#endif
+      }
+
+    return p;
+  }
+
+  //*************************************************************************
+  // Name: heap_resource::do_deallocate
+  //*************************************************************************
+
+  void heap_resource::do_deallocate(FAR void *p, std::size_t bytes,
+                                    std::size_t align)
+  {
+    mm_free(m_heap, p);
+  }
+
+  //*************************************************************************
+  // Name: heap_resource::do_is_equal
+  //
+  // Description:
+  //   Without RTTI another resource of the same heap cannot be told apart,
+  //   only the resource itself is equal.
+  //
+  //*************************************************************************
+
+  bool heap_resource::do_is_equal(const std::pmr::memory_resource &other)
+    const noexcept
+  {
+    return this == &other;
+  }
+} // namespace pmr
+} // namespace nuttx
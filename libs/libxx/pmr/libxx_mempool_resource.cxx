@@ -0,0 +1,195 @@
+//***************************************************************************
+// libs/libxx/pmr/libxx_mempool_resource.cxx
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed to the Apache Software Foundation (ASF) under one or more
+// contributor license agreements.  See the NOTICE file distributed with
+// this work for additional information regarding copyright ownership.  The
+// ASF licenses this file to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance with the
+// License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+// License for the specific language governing permissions and limitations
+//
+//***************************************************************************
+
+//***************************************************************************
+// Included Files
+//***************************************************************************
+
+#include <nuttx/config.h>
+
+#include <cstring>
+#include <new>
+#include <assert.h>
+
+#include <nuttx/mm/memory_resource.hxx>
+
+//***************************************************************************
+// Public Functions
+//***************************************************************************
+
+namespace nuttx
+{
+namespace pmr
+{
+  //*************************************************************************
+  // Name: mempool_resource::mempool_resource
+  //*************************************************************************
+
+  mempool_resource::mempool_resource(std::size_t blocksize,
+                                     std::size_t initialsize,
+                                     std::size_t expandsize,
+                                     FAR const char *name,
+                                     FAR std::pmr::memory_resource *upstream)
+    : m_upstream(upstream)
+  {
+    std::size_t realsize;
+    int ret;
+
+    std::memset(&m_pool, 0, sizeof(m_pool));
+    m_pool.blocksize   = blocksize;
+    m_pool.initialsize = initialsize;
+    m_pool.expandsize  = expandsize;
+    m_pool.priv        = this;
+    m_pool.alloc       = pool_alloc;
+    m_pool.free        = pool_free;
+
+    // The blocks follow each other from a base of this alignment, so they
+    // are aligned to the lowest bit of their real size as well
+
+    realsize = MEMPOOL_REALBLOCKSIZE(&m_pool);
+    m_align  = alignof(std::max_align_t);
+    while (m_align > 1 && realsize % m_align != 0)
+      {
+        m_align >>= 1;
+      }
+
+    ret = mempool_init(&m_pool, name);
+    if (ret < 0)
+      {
+#ifdef CONFIG_CXX_EXCEPTION
+        throw std::bad_alloc();
+#else
+        PANIC();
+#endif
+      }
+  }
+
+  //*************************************************************************
+  // Name: mempool_resource::~mempool_resource
+  //*************************************************************************
+
+  mempool_resource::~mempool_resource()
+  {
+    int ret = mempool_deinit(&m_pool);
+
+    // Blocks that are still allocated are leaked with their expansions
+
+    DEBUGASSERT(ret >= 0);
+    UNUSED(ret);
+  }
+
+  //*************************************************************************
+  // Name: mempool_resource::pool_alloc
+  //*************************************************************************
+
+  FAR void *mempool_resource::pool_alloc(FAR struct mempool_s *pool,
+                                         std::size_t size)
+  {
+    FAR mempool_resource *self =
+      static_cast<FAR mempool_resource *>(pool->priv);
+
+#ifdef CONFIG_CXX_EXCEPTION
+    try
+      {
+        return self->m_upstream->allocate(size, alignof(std::max_align_t));
+      }
+    catch (...)
+      {
+        return nullptr;
+      }
+#else
+    return self->m_upstream->allocate(size, alignof(std::max_align_t));
+#endif
+  }
+
+  //*************************************************************************
+  // Name: mempool_resource::pool_free
+  //
+  // Description:
+  //   The pool does not pass the size of what it frees, the upstream
+  //   resources of NuttX do not need it.
+  //
+  //*************************************************************************
+
+  void mempool_resource::pool_free(FAR struct mempool_s *pool,
+                                   FAR void *addr)
+  {
+    FAR mempool_resource *self =
+      static_cast<FAR mempool_resource *>(pool->priv);
+
+    self->m_upstream->deallocate(addr, 0, alignof(std::max_align_t));
+  }
+
+  //*************************************************************************
+  // Name: mempool_resource::do_allocate
+  //*************************************************************************
+
+  FAR void *mempool_resource::do_allocate(std::size_t bytes,
+                                          std::size_t align)
+  {
+    FAR void *p;
+
+    if (!fits(bytes, align))
+      {
+        return m_upstream->allocate(bytes, align);
+      }
+
+    p = mempool_allocate(&m_pool);
+    if (p == nullptr)
+      {
+#ifdef CONFIG_CXX_EXCEPTION
+        throw std::bad_alloc();
+#else
+        PANIC();
+#endif
+      }
+
+    return p;
+  }
+
+  //*************************************************************************
+  // Name: mempool_resource::do_deallocate
+  //*************************************************************************
+
+  void mempool_resource::do_deallocate(FAR void *p, std::size_t bytes,
+                                       std::size_t align)
+  {
+    if (fits(bytes, align))
+      {
+        mempool_release(&m_pool, p);
+      }
+    else
+      {
+        m_upstream->deallocate(p, bytes, align);
+      }
+  }
+
+  //*************************************************************************
+  // Name: mempool_resource::do_is_equal
+  //*************************************************************************
+
+  bool mempool_resource::do_is_equal(const std::pmr::memory_resource &other)
+    const noexcept
+  {
+    return this == &other;
+  }
+} // namespace pmr
+} // namespace nuttx
@@ -0,0 +1,163 @@
+/****************************************************************************
+ * mm/cache/mm_dcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include <nuttx/cache.h>
+
+#ifdef CONFIG_ARCH_DCACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_DCACHE_ALL_THRESHOLD
+#  define DCACHE_ALL_THRESHOLD CONFIG_ARCH_DCACHE_ALL_THRESHOLD
+#else
+#  define DCACHE_ALL_THRESHOLD 0
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef CODE void (*dcache_range_t)(uintptr_t start, uintptr_t end);
+typedef CODE void (*dcache_all_t)(void);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: dcache_iov
+ *
+ * Description:
+ *   Apply range to each run of regions that follow each other, or all to
+ *   the entire cache if the regions are large enough.
+ *
+ ****************************************************************************/
+
+static void dcache_iov(FAR const struct iovec *iov, int iovcnt,
+                       dcache_range_t range, dcache_all_t all)
+{
+  uintptr_t start = 0;
+  uintptr_t end = 0;
+  uintptr_t base;
+  int i;
+
+#if DCACHE_ALL_THRESHOLD > 0
+  size_t total = 0;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      total += iov[i].iov_len;
+    }
+
+  if (total >= DCACHE_ALL_THRESHOLD)
+    {
+      all();
+      return;
+    }
+#else
+  UNUSED(all);
+#endif
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      if (iov[i].iov_len == 0)
+        {
+          continue;
+        }
+
+      base = (uintptr_t)iov[i].iov_base;
+      if (base != end)
+        {
+          if (start != end)
+            {
+              range(start, end);
+            }
+
+          start = base;
+        }
+
+      end = base + iov[i].iov_len;
+    }
+
+  if (start != end)
+    {
+      range(start, end);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_invalidate_dcache_iov
+ *
+ * Description:
+ *   Invalidate the data cache within a list of regions.  The entire data
+ *   cache is flushed above the threshold, as invalidating it would lose
+ *   the dirty lines of other memory.
+ *
+ ****************************************************************************/
+
+void up_invalidate_dcache_iov(FAR const struct iovec *iov, int iovcnt)
+{
+  dcache_iov(iov, iovcnt, up_invalidate_dcache, up_flush_dcache_all);
+}
+
+/****************************************************************************
+ * Name: up_clean_dcache_iov
+ *
+ * Description:
+ *   Clean the data cache within a list of regions.
+ *
+ ****************************************************************************/
+
+void up_clean_dcache_iov(FAR const struct iovec *iov, int iovcnt)
+{
+  dcache_iov(iov, iovcnt, up_clean_dcache, up_clean_dcache_all);
+}
+
+/****************************************************************************
+ * Name: up_flush_dcache_iov
+ *
+ * Description:
+ *   Flush the data cache within a list of regions.
+ *
+ ****************************************************************************/
+
+void up_flush_dcache_iov(FAR const struct iovec *iov, int iovcnt)
+{
+  dcache_iov(iov, iovcnt, up_flush_dcache, up_flush_dcache_all);
+}
+
+#endif /* CONFIG_ARCH_DCACHE */
@@ -51,6 +51,35 @@
 #  define iobinfo                _none
 #endif /* CONFIG_DEBUG_FEATURES && CONFIG_IOB_DEBUG */
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* Number of I/O buffers moved between a CPU cache and the free list */
+
+#  define IOB_CACHE_BATCH        ((CONFIG_IOB_PERCPU_CACHE + 1) / 2)
+#endif
+
+/* Clear the offload metadata of a newly allocated I/O buffer */
+
+#ifdef CONFIG_IOB_PKTMETA
+#  define IOB_PKTMETA_RESET(iob) ((iob)->io_meta.flags = 0)
+#else
+#  define IOB_PKTMETA_RESET(iob)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* The private cache of free I/O buffers of one CPU */
+
+struct iob_cache_s
+{
+  spinlock_t lock;              /* Protects the cache */
+  int16_t count;                /* Number of I/O buffers in the cache */
+  FAR struct iob_s *head;       /* List of cached I/O buffers */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -98,6 +127,28 @@ extern int16_t g_qentry_wait;
 
 extern volatile spinlock_t g_iob_lock;
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+/* A list of all free, unallocated small I/O buffers */
+
+extern FAR struct iob_s *g_iob_smallfreelist;
+
+/* Counts free small I/O buffers */
+
+extern int16_t g_iob_smallcount;
+#endif
+
+#if CONFIG_IOB_ELASTIC_NBUFFERS > 0
+/* Counts I/O buffers currently allocated from the heap */
+
+extern int16_t g_iob_nelastic;
+#endif
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/* The per-CPU caches of free I/O buffers */
+
+extern struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -137,6 +188,17 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 
+/****************************************************************************
+ * Name: iob_tryalloc_internal
+ *
+ * Description:
+ *   Take an I/O buffer from the head of the global free list.  The caller
+ *   must hold g_iob_lock.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_internal(bool throttled);
+
 /****************************************************************************
  * Name: iob_notifier_signal
  *
@@ -161,5 +223,74 @@ FAR struct iob_qentry_s *iob_free_qentry(FAR struct iob_qentry_s *iobq);
 void iob_notifier_signal(void);
 #endif
 
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return a preallocated I/O buffer to the global free list, or commit it
+ *   to a thread that is waiting for an I/O buffer.
+ *
+ ****************************************************************************/
+
+void iob_free_pool(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_is_small
+ *
+ * Description:
+ *   Return true if the I/O buffer belongs to the small size class.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+bool iob_is_small(FAR struct iob_s *iob);
+#endif
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the global free list if it is empty.  Returns NULL if no
+ *   I/O buffer is available without waiting.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(bool throttled);
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put a free I/O buffer into the cache of the current CPU.  Returns false
+ *   if the I/O buffer must go to the global free list instead because a
+ *   thread is waiting for it.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob);
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the I/O buffers of all CPU caches to the global free list.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void);
+
+/****************************************************************************
+ * Name: iob_cache_count
+ *
+ * Description:
+ *   Return the number of I/O buffers held in all CPU caches.
+ *
+ ****************************************************************************/
+
+int iob_cache_count(void);
+#endif
+
 #endif /* CONFIG_MM_IOB */
 #endif /* __MM_IOB_IOB_H */
@@ -96,13 +96,138 @@ static FAR struct iob_s *iob_alloc_committed(void)
       iob->io_len    = 0;    /* Length of the data in the entry */
       iob->io_offset = 0;    /* Offset to the beginning of data */
       iob->io_pktlen = 0;    /* Total length of the packet */
+      IOB_PKTMETA_RESET(iob);
     }
 
   spin_unlock_irqrestore(&g_iob_lock, flags);
   return iob;
 }
 
-static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
+#ifdef CONFIG_IOB_ALLOC
+/****************************************************************************
+ * Name: iob_free_dynamic
+ *
+ * Description:
+ *   Free the I/O buffer and payload to the heap
+ *
+ * Input Parameters:
+ *   data -
+ *
+ ****************************************************************************/
+
+static void iob_free_dynamic(FAR void *data)
+{
+  kmm_free(data);
+}
+#endif
+
+#if CONFIG_IOB_ELASTIC_NBUFFERS > 0
+/****************************************************************************
+ * Name: iob_free_elastic
+ *
+ * Description:
+ *   Return an I/O buffer allocated by iob_alloc_elastic() to the heap.
+ *
+ ****************************************************************************/
+
+static void iob_free_elastic(FAR void *data)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+  g_iob_nelastic--;
+  DEBUGASSERT(g_iob_nelastic >= 0);
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  kmm_free(data);
+}
+
+/****************************************************************************
+ * Name: iob_alloc_elastic
+ *
+ * Description:
+ *   Grow the pool by allocating an I/O buffer from the heap, unless the
+ *   high-water mark CONFIG_IOB_ELASTIC_NBUFFERS has been reached.  The
+ *   heap cannot be used from interrupt context or the IDLE task.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_alloc_elastic(void)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+  if (up_interrupt_context() || sched_idletask())
+    {
+      return NULL;
+    }
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+  if (g_iob_nelastic >= CONFIG_IOB_ELASTIC_NBUFFERS)
+    {
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+      return NULL;
+    }
+
+  g_iob_nelastic++;
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+
+  iob = iob_alloc_dynamic(CONFIG_IOB_BUFSIZE);
+  if (iob == NULL)
+    {
+      flags = spin_lock_irqsave(&g_iob_lock);
+      g_iob_nelastic--;
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+      return NULL;
+    }
+
+  iob->io_free = iob_free_elastic;
+  return iob;
+}
+#endif
+
+/****************************************************************************
+ * Name: iob_tryalloc_pool
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of this CPU or the global free list
+ *   without waiting.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *iob_tryalloc_pool(bool throttled)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  iob = iob_cache_alloc(throttled);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+#endif
+
+  /* We don't know what context we are called from so we use extreme measures
+   * to protect the free list:  We disable interrupts very briefly.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+  iob = iob_tryalloc_internal(throttled);
+  spin_unlock_irqrestore(&g_iob_lock, flags);
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_internal
+ *
+ * Description:
+ *   Take an I/O buffer from the head of the global free list.  The caller
+ *   must hold g_iob_lock.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_internal(bool throttled)
 {
   FAR struct iob_s *iob;
 #if CONFIG_IOB_THROTTLE > 0
@@ -135,6 +260,7 @@ static FAR struct iob_s *iob_tryalloc_internal(bool throttled)
           iob->io_len    = 0;    /* Length of the data in the entry */
           iob->io_offset = 0;    /* Offset to the beginning of data */
           iob->io_pktlen = 0;    /* Total length of the packet */
+          IOB_PKTMETA_RESET(iob);
           return iob;
         }
     }
@@ -159,6 +285,16 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   clock_t start;
   int ret = OK;
 
+#if CONFIG_IOB_PERCPU_CACHE > 0 || CONFIG_IOB_ELASTIC_NBUFFERS > 0
+  /* Try the CPU cache and the heap before we register as a waiter */
+
+  iob = iob_tryalloc(throttled);
+  if (iob != NULL)
+    {
+      return iob;
+    }
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
   /* Select the semaphore to wait. */
 
@@ -193,6 +329,16 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
 
       spin_unlock_irqrestore(&g_iob_lock, flags);
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+      /* Free I/O buffers held in the CPU caches are committed to us now */
+
+      iob_cache_drain();
+#endif
+
+#ifdef CONFIG_SCHED_PRESSURE
+      nxsched_pressure_enter(SCHED_PRESSURE_NET);
+#endif
+
       if (timeout == UINT_MAX)
         {
           ret = nxsem_wait_uninterruptible(sem);
@@ -204,6 +350,10 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
                                    iob_allocwait_gettimeout(start, timeout));
         }
 
+#ifdef CONFIG_SCHED_PRESSURE
+      nxsched_pressure_leave(SCHED_PRESSURE_NET);
+#endif
+
       if (ret >= 0)
         {
           /* When we wake up from wait successfully, an I/O buffer was
@@ -221,24 +371,6 @@ static FAR struct iob_s *iob_allocwait(bool throttled, unsigned int timeout)
   return iob;
 }
 
-#ifdef CONFIG_IOB_ALLOC
-/****************************************************************************
- * Name: iob_free_dynamic
- *
- * Description:
- *   Free the I/O buffer and payload to the heap
- *
- * Input Parameters:
- *   data -
- *
- ****************************************************************************/
-
-static void iob_free_dynamic(FAR void *data)
-{
-  kmm_free(data);
-}
-#endif
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -299,18 +431,66 @@ FAR struct iob_s *iob_alloc(bool throttled)
 FAR struct iob_s *iob_tryalloc(bool throttled)
 {
   FAR struct iob_s *iob;
-  irqstate_t flags;
 
-  /* We don't know what context we are called from so we use extreme measures
-   * to protect the free list:  We disable interrupts very briefly.
-   */
+  iob = iob_tryalloc_pool(throttled);
+
+#if CONFIG_IOB_ELASTIC_NBUFFERS > 0
+  /* The preallocated I/O buffers are exhausted, grow the pool */
+
+  if (iob == NULL)
+    {
+      iob = iob_alloc_elastic();
+    }
+#endif
 
-  flags = spin_lock_irqsave(&g_iob_lock);
-  iob = iob_tryalloc_internal(throttled);
-  spin_unlock_irqrestore(&g_iob_lock, flags);
   return iob;
 }
 
+/****************************************************************************
+ * Name: iob_tryalloc_size
+ *
+ * Description:
+ *   Try to allocate an I/O buffer of the smallest size class that holds
+ *   'size' bytes without waiting for a buffer to become free.  If the small
+ *   I/O buffers are exhausted, a normal sized one is returned.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_size(bool throttled, uint16_t size)
+{
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  FAR struct iob_s *iob = NULL;
+  irqstate_t flags;
+
+  if (size <= CONFIG_IOB_SMALL_BUFSIZE)
+    {
+      flags = spin_lock_irqsave(&g_iob_lock);
+      iob = g_iob_smallfreelist;
+      if (iob != NULL)
+        {
+          g_iob_smallfreelist = iob->io_flink;
+          g_iob_smallcount--;
+        }
+
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+    }
+
+  if (iob != NULL)
+    {
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+      IOB_PKTMETA_RESET(iob);
+      return iob;
+    }
+#endif
+
+  return iob_tryalloc(throttled);
+}
+
 #ifdef CONFIG_IOB_ALLOC
 
 /****************************************************************************
@@ -345,6 +525,7 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
       iob->io_offset  = 0;                /* Offset to the beginning of data */
       iob->io_bufsize = size;             /* Total length of the iob buffer */
       iob->io_pktlen  = 0;                /* Total length of the packet */
+      IOB_PKTMETA_RESET(iob);
       iob->io_free    = iob_free_dynamic; /* Customer free callback */
       iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
                                                 IOB_ALIGNMENT);
@@ -391,6 +572,7 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
       iob->io_offset  = 0;       /* Offset to the beginning of data */
       iob->io_bufsize = size;    /* Total length of the iob buffer */
       iob->io_pktlen  = 0;       /* Total length of the packet */
+      IOB_PKTMETA_RESET(iob);
       iob->io_free    = free_cb; /* Customer free callback */
       iob->io_data    = data;
     }
@@ -430,6 +612,7 @@ FAR struct iob_s *iob_init_with_data(FAR void *data, uint16_t size,
   iob->io_len     = 0;       /* Length of the data in the entry */
   iob->io_offset  = 0;       /* Offset to the beginning of data */
   iob->io_pktlen  = 0;       /* Total length of the packet */
+  IOB_PKTMETA_RESET(iob);
   iob->io_free    = free_cb; /* Customer free callback */
   iob->io_data    = (FAR uint8_t *)ALIGN_UP((uintptr_t)(iob + 1),
                                             IOB_ALIGNMENT);
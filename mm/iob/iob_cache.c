@@ -0,0 +1,264 @@
+/****************************************************************************
+ * mm/iob/iob_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mm/iob.h>
+
+#include "iob.h"
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The per-CPU caches of free I/O buffers */
+
+struct iob_cache_s g_iob_cache[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_release
+ *
+ * Description:
+ *   Return a list of I/O buffers taken out of a cache to the global free
+ *   list.
+ *
+ ****************************************************************************/
+
+static void iob_cache_release(FAR struct iob_s *iob)
+{
+  FAR struct iob_s *next;
+
+  while (iob != NULL)
+    {
+      next = iob->io_flink;
+      iob_free_pool(iob);
+      iob  = next;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_cache_alloc
+ *
+ * Description:
+ *   Take an I/O buffer from the cache of the current CPU, refilling the
+ *   cache from the global free list if it is empty.  Returns NULL if no
+ *   I/O buffer is available without waiting.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_cache_alloc(bool throttled)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int i;
+
+  /* Interrupts stay disabled so that we are not migrated to another CPU */
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[this_cpu()];
+  spin_lock(&cache->lock);
+
+#if CONFIG_IOB_THROTTLE > 0
+  /* The throttled reserve is accounted on the global free list only, so
+   * count the local cache as part of it.
+   */
+
+  if (throttled && g_iob_count + cache->count <= CONFIG_IOB_THROTTLE)
+    {
+      spin_unlock(&cache->lock);
+      up_irq_restore(flags);
+      return NULL;
+    }
+#endif
+
+  if (cache->head == NULL)
+    {
+      /* Refill a batch of I/O buffers from the global free list */
+
+      spin_lock(&g_iob_lock);
+      for (i = 0; i < IOB_CACHE_BATCH; i++)
+        {
+          iob = iob_tryalloc_internal(throttled);
+          if (iob == NULL)
+            {
+              break;
+            }
+
+          iob->io_flink = cache->head;
+          cache->head   = iob;
+          cache->count++;
+        }
+
+      spin_unlock(&g_iob_lock);
+    }
+
+  iob = cache->head;
+  if (iob != NULL)
+    {
+      cache->head = iob->io_flink;
+      cache->count--;
+
+      /* Put the I/O buffer in a known state */
+
+      iob->io_flink  = NULL; /* Not in a chain */
+      iob->io_len    = 0;    /* Length of the data in the entry */
+      iob->io_offset = 0;    /* Offset to the beginning of data */
+      iob->io_pktlen = 0;    /* Total length of the packet */
+      IOB_PKTMETA_RESET(iob);
+    }
+
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+  return iob;
+}
+
+/****************************************************************************
+ * Name: iob_cache_free
+ *
+ * Description:
+ *   Put a free I/O buffer into the cache of the current CPU.  Returns false
+ *   if the I/O buffer must go to the global free list instead because a
+ *   thread is waiting for it.
+ *
+ ****************************************************************************/
+
+bool iob_cache_free(FAR struct iob_s *iob)
+{
+  FAR struct iob_cache_s *cache;
+  FAR struct iob_s *flush = NULL;
+  irqstate_t flags;
+  int i;
+
+  flags = up_irq_save();
+  cache = &g_iob_cache[this_cpu()];
+  spin_lock(&cache->lock);
+
+  /* A waiter registers itself before it drains the caches under their
+   * locks, so it either sees this I/O buffer in the cache or we see it
+   * here.
+   */
+
+  if (g_iob_count < 0
+#if CONFIG_IOB_THROTTLE > 0
+      || g_throttle_wait > 0
+#endif
+     )
+    {
+      spin_unlock(&cache->lock);
+      up_irq_restore(flags);
+      return false;
+    }
+
+  iob->io_flink = cache->head;
+  cache->head   = iob;
+  cache->count++;
+
+  /* Flush a batch back to the global free list if the cache is full */
+
+  if (cache->count > CONFIG_IOB_PERCPU_CACHE)
+    {
+      for (i = 0; i < IOB_CACHE_BATCH; i++)
+        {
+          iob           = cache->head;
+          cache->head   = iob->io_flink;
+          iob->io_flink = flush;
+          flush         = iob;
+        }
+
+      cache->count -= IOB_CACHE_BATCH;
+    }
+
+  spin_unlock(&cache->lock);
+  up_irq_restore(flags);
+
+  iob_cache_release(flush);
+  return true;
+}
+
+/****************************************************************************
+ * Name: iob_cache_drain
+ *
+ * Description:
+ *   Return the I/O buffers of all CPU caches to the global free list.
+ *
+ ****************************************************************************/
+
+void iob_cache_drain(void)
+{
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      flags = spin_lock_irqsave(&g_iob_cache[cpu].lock);
+      iob   = g_iob_cache[cpu].head;
+      g_iob_cache[cpu].head  = NULL;
+      g_iob_cache[cpu].count = 0;
+      spin_unlock_irqrestore(&g_iob_cache[cpu].lock, flags);
+
+      iob_cache_release(iob);
+    }
+}
+
+/****************************************************************************
+ * Name: iob_cache_count
+ *
+ * Description:
+ *   Return the number of I/O buffers held in all CPU caches.
+ *
+ ****************************************************************************/
+
+int iob_cache_count(void)
+{
+  int count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += g_iob_cache[cpu].count;
+    }
+
+  return count;
+}
+
+#endif /* CONFIG_IOB_PERCPU_CACHE > 0 */
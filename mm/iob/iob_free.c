@@ -68,6 +68,63 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: iob_free_pool
+ *
+ * Description:
+ *   Return a preallocated I/O buffer to the global free list, or commit it
+ *   to a thread that is waiting for an I/O buffer.
+ *
+ ****************************************************************************/
+
+void iob_free_pool(FAR struct iob_s *iob)
+{
+  irqstate_t flags;
+
+  /* Free the I/O buffer by adding it to the head of the free or the
+   * committed list. We don't know what context we are called from so
+   * we use extreme measures to protect the free list:  We disable
+   * interrupts very briefly.
+   */
+
+  flags = spin_lock_irqsave(&g_iob_lock);
+
+  /* Which list?  If there is a task waiting for an IOB, then put
+   * the IOB on either the free list or on the committed list where
+   * it is reserved for that allocation (and not available to
+   * iob_tryalloc()). This is true for both throttled and non-throttled
+   * cases.
+   */
+
+  if (g_iob_count < 0)
+    {
+      g_iob_count++;
+      iob->io_flink   = g_iob_committed;
+      g_iob_committed = iob;
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+      nxsem_post(&g_iob_sem);
+    }
+#if CONFIG_IOB_THROTTLE > 0
+  else if (g_throttle_wait > 0 && g_iob_count >= CONFIG_IOB_THROTTLE)
+    {
+      iob->io_flink   = g_iob_committed;
+      g_iob_committed = iob;
+      g_throttle_wait--;
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+      nxsem_post(&g_throttle_sem);
+    }
+#endif
+  else
+    {
+      g_iob_count++;
+      iob->io_flink   = g_iob_freelist;
+      g_iob_freelist  = iob;
+      spin_unlock_irqrestore(&g_iob_lock, flags);
+    }
+
+  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
+}
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -80,7 +137,9 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
   irqstate_t flags;
+#endif
 #ifdef CONFIG_IOB_NOTIFIER
   int16_t navail;
 #endif
@@ -114,6 +173,10 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
           next->io_pktlen = 0;
         }
 
+#ifdef CONFIG_IOB_PKTMETA
+      next->io_meta = iob->io_meta;
+#endif
+
       iobinfo("next=%p io_pktlen=%u io_len=%u\n",
               next, next->io_pktlen, next->io_len);
     }
@@ -137,49 +200,29 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
     }
 #endif
 
-  /* Free the I/O buffer by adding it to the head of the free or the
-   * committed list. We don't know what context we are called from so
-   * we use extreme measures to protect the free list:  We disable
-   * interrupts very briefly.
-   */
-
-  flags = spin_lock_irqsave(&g_iob_lock);
-
-  /* Which list?  If there is a task waiting for an IOB, then put
-   * the IOB on either the free list or on the committed list where
-   * it is reserved for that allocation (and not available to
-   * iob_tryalloc()). This is true for both throttled and non-throttled
-   * cases.
-   */
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  /* Small I/O buffers have their own free list and no waiters */
 
-  if (g_iob_count < 0)
+  if (iob_is_small(iob))
     {
-      g_iob_count++;
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(&g_iob_sem);
-    }
-#if CONFIG_IOB_THROTTLE > 0
-  else if (g_throttle_wait > 0 && g_iob_count >= CONFIG_IOB_THROTTLE)
-    {
-      iob->io_flink   = g_iob_committed;
-      g_iob_committed = iob;
-      g_throttle_wait--;
+      flags = spin_lock_irqsave(&g_iob_lock);
+      iob->io_flink       = g_iob_smallfreelist;
+      g_iob_smallfreelist = iob;
+      g_iob_smallcount++;
       spin_unlock_irqrestore(&g_iob_lock, flags);
-      nxsem_post(&g_throttle_sem);
+      return next;
     }
 #endif
-  else
+
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* Keep the I/O buffer in the cache of this CPU if nobody waits for it */
+
+  if (!iob_cache_free(iob))
+#endif
     {
-      g_iob_count++;
-      iob->io_flink   = g_iob_freelist;
-      g_iob_freelist  = iob;
-      spin_unlock_irqrestore(&g_iob_lock, flags);
+      iob_free_pool(iob);
     }
 
-  DEBUGASSERT(g_iob_count <= CONFIG_IOB_NBUFFERS);
-
 #ifdef CONFIG_IOB_NOTIFIER
   /* Check if the IOB was claimed by a thread that is blocked waiting
    * for an IOB.
@@ -49,6 +49,13 @@
 #define IOB_BUFFER_SIZE   (IOB_ALIGN_SIZE * CONFIG_IOB_NBUFFERS + \
                            IOB_ALIGNMENT - 1)
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+#  define IOB_SMALL_ALIGN_SIZE \
+     ALIGN_UP(sizeof(struct iob_s) + CONFIG_IOB_SMALL_BUFSIZE, IOB_ALIGNMENT)
+#  define IOB_SMALL_BUFFER_SIZE \
+     (IOB_SMALL_ALIGN_SIZE * CONFIG_IOB_SMALL_NBUFFERS + IOB_ALIGNMENT - 1)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -64,6 +71,17 @@ static uint8_t g_iob_buffer[IOB_BUFFER_SIZE] locate_data(IOB_SECTION);
 static uint8_t g_iob_buffer[IOB_BUFFER_SIZE];
 #endif
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+/* The raw buffer of the small I/O buffer size class */
+
+#ifdef IOB_SECTION
+static uint8_t g_iob_smallbuffer[IOB_SMALL_BUFFER_SIZE]
+               locate_data(IOB_SECTION);
+#else
+static uint8_t g_iob_smallbuffer[IOB_SMALL_BUFFER_SIZE];
+#endif
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
 /* This is a pool of pre-allocated iob_qentry_s buffers */
 
@@ -117,6 +135,22 @@ int16_t g_qentry_wait = 0;
 
 volatile spinlock_t g_iob_lock = SP_UNLOCKED;
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+/* A list of all free, unallocated small I/O buffers */
+
+FAR struct iob_s *g_iob_smallfreelist;
+
+/* Counts free small I/O buffers */
+
+int16_t g_iob_smallcount = CONFIG_IOB_SMALL_NBUFFERS;
+#endif
+
+#if CONFIG_IOB_ELASTIC_NBUFFERS > 0
+/* Counts I/O buffers currently allocated from the heap */
+
+int16_t g_iob_nelastic;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -159,6 +193,25 @@ void iob_initialize(void)
       g_iob_freelist  = iob;
     }
 
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  /* Divide the raw buffer of the small size class the same way */
+
+  buf = ALIGN_UP((uintptr_t)g_iob_smallbuffer +
+                 offsetof(struct iob_s, io_data), IOB_ALIGNMENT) -
+        offsetof(struct iob_s, io_data);
+
+  for (i = 0; i < CONFIG_IOB_SMALL_NBUFFERS; i++)
+    {
+      FAR struct iob_s *iob =
+        (FAR struct iob_s *)(buf + i * IOB_SMALL_ALIGN_SIZE);
+
+      iob->io_flink       = g_iob_smallfreelist;
+      iob->io_bufsize     = CONFIG_IOB_SMALL_BUFSIZE;
+      iob->io_data        = (FAR uint8_t *)(iob + 1);
+      g_iob_smallfreelist = iob;
+    }
+#endif
+
 #if CONFIG_IOB_NCHAINS > 0
   /* Add each I/O buffer chain queue container to the free list */
 
@@ -175,3 +228,19 @@ void iob_initialize(void)
     }
 #endif
 }
+
+/****************************************************************************
+ * Name: iob_is_small
+ *
+ * Description:
+ *   Return true if the I/O buffer belongs to the small size class.
+ *
+ ****************************************************************************/
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+bool iob_is_small(FAR struct iob_s *iob)
+{
+  return (FAR uint8_t *)iob >= g_iob_smallbuffer &&
+         (FAR uint8_t *)iob < g_iob_smallbuffer + IOB_SMALL_BUFFER_SIZE;
+}
+#endif
@@ -51,6 +51,12 @@ int iob_navail(bool throttled)
 #if CONFIG_IOB_NBUFFERS > 0
   ret = g_iob_count;
 
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  /* The I/O buffers in the CPU caches are free, too */
+
+  ret += iob_cache_count();
+#endif
+
 #if CONFIG_IOB_THROTTLE > 0
   /* Subtract the throttle value is so requested */
 
@@ -57,6 +57,14 @@ void iob_getstats(FAR struct iob_stats_s *stats)
   stats->ntotal = CONFIG_IOB_NBUFFERS;
 
   stats->nfree = g_iob_count;
+#if CONFIG_IOB_PERCPU_CACHE > 0
+  stats->ncached = iob_cache_count();
+  if (stats->nfree >= 0)
+    {
+      stats->nfree += stats->ncached;
+    }
+#endif
+
   if (stats->nfree < 0)
     {
       stats->nwait = -stats->nfree;
@@ -74,6 +82,15 @@ void iob_getstats(FAR struct iob_stats_s *stats)
     {
       stats->nthrottle = 0;
     }
+
+#if CONFIG_IOB_SMALL_NBUFFERS > 0
+  stats->nsmall     = CONFIG_IOB_SMALL_NBUFFERS;
+  stats->nsmallfree = g_iob_smallcount;
+#endif
+
+#if CONFIG_IOB_ELASTIC_NBUFFERS > 0
+  stats->nelastic   = g_iob_nelastic;
+#endif
 }
 
 #endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
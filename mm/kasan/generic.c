@@ -30,6 +30,7 @@
 #include <nuttx/spinlock.h>
 
 #include <assert.h>
+#include <errno.h>
 #include <stdint.h>
 
 /****************************************************************************
@@ -59,6 +60,7 @@ struct kasan_region_s
 {
   uintptr_t begin;
   uintptr_t end;
+  bool      enabled;                 /* Accesses to the region are checked */
   uintptr_t shadow[1];
 };
 
@@ -68,82 +70,110 @@ struct kasan_region_s
 
 static FAR struct kasan_region_s *g_region[CONFIG_MM_KASAN_REGIONS];
 static size_t g_region_count;
+static size_t g_region_last;
 static spinlock_t g_lock;
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline_function FAR uintptr_t *
-kasan_mem_to_shadow(FAR const void *ptr, size_t size,
-                    FAR unsigned int *bit)
+static inline_function FAR struct kasan_region_s *
+kasan_find_region(uintptr_t addr)
 {
-  uintptr_t addr = (uintptr_t)ptr;
-  size_t i;
+  FAR struct kasan_region_s *region;
+  size_t i = g_region_last;
+
+  /* Most accesses hit the same region as the previous one */
+
+  if (i < g_region_count)
+    {
+      region = g_region[i];
+      if (addr >= region->begin && addr < region->end)
+        {
+          return region;
+        }
+    }
 
   for (i = 0; i < g_region_count; i++)
     {
-      if (addr >= g_region[i]->begin && addr < g_region[i]->end)
+      region = g_region[i];
+      if (addr >= region->begin && addr < region->end)
         {
-          DEBUGASSERT(addr + size <= g_region[i]->end);
-          addr -= g_region[i]->begin;
-          addr /= KASAN_SHADOW_SCALE;
-          *bit  = addr % KASAN_BITS_PER_WORD;
-          return &g_region[i]->shadow[addr / KASAN_BITS_PER_WORD];
+          g_region_last = i;
+          return region;
         }
     }
 
   return NULL;
 }
 
+static inline_function FAR uintptr_t *
+kasan_mem_to_shadow(FAR const void *ptr, size_t size,
+                    FAR unsigned int *bit)
+{
+  FAR struct kasan_region_s *region;
+  uintptr_t addr = (uintptr_t)ptr;
+
+  region = kasan_find_region(addr);
+  if (region == NULL)
+    {
+      return NULL;
+    }
+
+  DEBUGASSERT(addr + size <= region->end);
+  addr -= region->begin;
+  addr /= KASAN_SHADOW_SCALE;
+  *bit  = addr % KASAN_BITS_PER_WORD;
+  return &region->shadow[addr / KASAN_BITS_PER_WORD];
+}
+
 static inline_function bool
 kasan_is_poisoned(FAR const void *addr, size_t size)
 {
+  FAR struct kasan_region_s *region;
   FAR uintptr_t *p;
-  unsigned int bit;
-  unsigned int nbit;
+  uintptr_t first;
+  uintptr_t last;
   uintptr_t mask;
+  size_t nword;
 
-  p = kasan_mem_to_shadow(addr, size, &bit);
-  if (p == NULL)
+  region = kasan_find_region((uintptr_t)addr);
+  if (region == NULL)
     {
       return kasan_global_is_poisoned(addr, size);
     }
 
-  if (size <= KASAN_SHADOW_SCALE)
+  if (!region->enabled || size == 0)
     {
-      return ((*p >> bit) & 1);
+      return false;
     }
 
-  nbit = KASAN_BITS_PER_WORD - bit % KASAN_BITS_PER_WORD;
-  mask = KASAN_FIRST_WORD_MASK(bit);
-  size = ALIGN_UP(size, KASAN_SHADOW_SCALE);
-  size /= KASAN_SHADOW_SCALE;
+  DEBUGASSERT((uintptr_t)addr + size <= region->end);
 
-  while (size >= nbit)
+  /* The shadow bits of the first and the last word touched.  A scalar
+   * access, aligned or not, and most short ranges stay within one shadow
+   * word and take a single test; longer ranges are checked a shadow word,
+   * KASAN_BITS_PER_WORD words of memory, at a time.
+   */
+
+  first = ((uintptr_t)addr - region->begin) / KASAN_SHADOW_SCALE;
+  last  = ((uintptr_t)addr + size - 1 - region->begin) / KASAN_SHADOW_SCALE;
+  p     = &region->shadow[first / KASAN_BITS_PER_WORD];
+  mask  = KASAN_FIRST_WORD_MASK(first);
+
+  for (nword = last / KASAN_BITS_PER_WORD - first / KASAN_BITS_PER_WORD;
+       nword > 0; nword--)
     {
       if ((*p++ & mask) != 0)
         {
           return true;
         }
 
-      bit  += nbit;
-      size -= nbit;
-
-      nbit = KASAN_BITS_PER_WORD;
       mask = UINTPTR_MAX;
     }
 
-  if (size)
-    {
-      mask &= KASAN_LAST_WORD_MASK(bit + size);
-      if ((*p & mask) != 0)
-        {
-          return true;
-        }
-    }
-
-  return false;
+  mask &= KASAN_LAST_WORD_MASK(last + 1);
+  return (*p & mask) != 0;
 }
 
 static void kasan_set_poison(FAR const void *addr, size_t size,
@@ -235,6 +265,22 @@ bool kasan_bypass(bool state)
   return false;
 }
 
+int kasan_region_enable(FAR const void *addr, bool enable)
+{
+  FAR struct kasan_region_s *region;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_lock);
+  region = kasan_find_region((uintptr_t)addr);
+  if (region != NULL)
+    {
+      region->enabled = enable;
+    }
+
+  spin_unlock_irqrestore(&g_lock, flags);
+  return region != NULL ? OK : -ENOENT;
+}
+
 void kasan_register(FAR void *addr, FAR size_t *size)
 {
   FAR struct kasan_region_s *region;
@@ -243,8 +289,13 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   region = (FAR struct kasan_region_s *)
     ((FAR char *)addr + *size - KASAN_REGION_SIZE(*size));
 
-  region->begin = (uintptr_t)addr;
-  region->end   = region->begin + *size;
+  region->begin   = (uintptr_t)addr;
+  region->end     = region->begin + *size;
+#ifdef CONFIG_MM_KASAN_REGION_OPTIN
+  region->enabled = false;
+#else
+  region->enabled = true;
+#endif
 
   flags = spin_lock_irqsave(&g_lock);
 
@@ -270,6 +321,7 @@ void kasan_unregister(FAR void *addr)
         {
           size_t size = g_region[i]->end - g_region[i]->begin;
           g_region_count--;
+          g_region_last = 0;
           memmove(&g_region[i], &g_region[i + 1],
                   (g_region_count - i) * sizeof(g_region[0]));
           spin_unlock_irqrestore(&g_lock, flags);
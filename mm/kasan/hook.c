@@ -231,9 +231,9 @@ static void kasan_check_watchpoint(FAR const void *addr, size_t size,
 }
 #endif
 
-static inline void kasan_check_report(FAR const void *addr, size_t size,
-                                      bool is_write,
-                                      FAR void *return_address)
+static inline_function void
+kasan_check_report(FAR const void *addr, size_t size, bool is_write,
+                   FAR void *return_address)
 {
 #ifdef CONFIG_MM_KASAN
   if (predict_false(size == 0 || g_region_init != KASAN_INIT_VALUE))
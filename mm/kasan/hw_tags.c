@@ -23,6 +23,9 @@
  ****************************************************************************/
 
 #include <nuttx/arch.h>
+#include <nuttx/mm/kasan.h>
+
+#include <errno.h>
 
 /****************************************************************************
  * Private Function
@@ -92,3 +95,10 @@ void kasan_register(FAR void *addr, FAR size_t *size)
 void kasan_unregister(FAR void *addr)
 {
 }
+
+int kasan_region_enable(FAR const void *addr, bool enable)
+{
+  /* The tags are checked by the hardware on every access */
+
+  return -ENOTSUP;
+}
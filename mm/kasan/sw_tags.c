@@ -27,6 +27,7 @@
 #include <nuttx/spinlock.h>
 
 #include <assert.h>
+#include <errno.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -53,6 +54,7 @@ struct kasan_region_s
 {
   uintptr_t begin;
   uintptr_t end;
+  bool      enabled;                 /* Accesses to the region are checked */
   uint8_t   shadow[1];
 };
 
@@ -62,36 +64,65 @@ struct kasan_region_s
 
 static FAR struct kasan_region_s *g_region[CONFIG_MM_KASAN_REGIONS];
 static int g_region_count;
+static int g_region_last;
 static spinlock_t g_lock;
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static inline_function FAR uint8_t *
-kasan_mem_to_shadow(FAR const void *ptr, size_t size)
+static inline_function FAR struct kasan_region_s *
+kasan_find_region(uintptr_t addr)
 {
-  uintptr_t addr;
-  int i;
+  FAR struct kasan_region_s *region;
+  int i = g_region_last;
 
-  addr = (uintptr_t)kasan_clear_tag(ptr);
+  /* Try the region of the previous access first */
+
+  if (i < g_region_count)
+    {
+      region = g_region[i];
+      if (addr >= region->begin && addr < region->end)
+        {
+          return region;
+        }
+    }
 
   for (i = 0; i < g_region_count; i++)
     {
-      if (addr >= g_region[i]->begin && addr < g_region[i]->end)
+      region = g_region[i];
+      if (addr >= region->begin && addr < region->end)
         {
-          DEBUGASSERT(addr + size <= g_region[i]->end);
-          addr -= g_region[i]->begin;
-          return &g_region[i]->shadow[addr / KASAN_SHADOW_SCALE];
+          g_region_last = i;
+          return region;
         }
     }
 
   return NULL;
 }
 
+static inline_function FAR uint8_t *
+kasan_mem_to_shadow(FAR const void *ptr, size_t size)
+{
+  FAR struct kasan_region_s *region;
+  uintptr_t addr;
+
+  addr = (uintptr_t)kasan_clear_tag(ptr);
+  region = kasan_find_region(addr);
+  if (region == NULL)
+    {
+      return NULL;
+    }
+
+  DEBUGASSERT(addr + size <= region->end);
+  addr -= region->begin;
+  return &region->shadow[addr / KASAN_SHADOW_SCALE];
+}
+
 static inline_function bool
 kasan_is_poisoned(FAR const void *addr, size_t size)
 {
+  FAR struct kasan_region_s *region;
   FAR uint8_t *p;
   uint8_t tag;
 
@@ -104,12 +135,17 @@ kasan_is_poisoned(FAR const void *addr, size_t size)
     }
 #endif
 
-  p = kasan_mem_to_shadow(addr, size);
-  if (p == NULL)
+  region = kasan_find_region((uintptr_t)kasan_clear_tag(addr));
+  if (region == NULL)
     {
       return kasan_global_is_poisoned(addr, size);
     }
+  else if (!region->enabled)
+    {
+      return false;
+    }
 
+  p = kasan_mem_to_shadow(addr, size);
   size = KASAN_SHADOW_SIZE(size);
   while (size--)
     {
@@ -176,6 +212,22 @@ bool kasan_bypass(bool state)
   return false;
 }
 
+int kasan_region_enable(FAR const void *addr, bool enable)
+{
+  FAR struct kasan_region_s *region;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_lock);
+  region = kasan_find_region((uintptr_t)kasan_clear_tag(addr));
+  if (region != NULL)
+    {
+      region->enabled = enable;
+    }
+
+  spin_unlock_irqrestore(&g_lock, flags);
+  return region != NULL ? OK : -ENOENT;
+}
+
 FAR void *kasan_unpoison(FAR const void *addr, size_t size)
 {
   uint8_t tag = kasan_random_tag();
@@ -192,8 +244,13 @@ void kasan_register(FAR void *addr, FAR size_t *size)
   region = (FAR struct kasan_region_s *)
     ((FAR char *)addr + *size - KASAN_REGION_SIZE(*size));
 
-  region->begin = (uintptr_t)addr;
-  region->end   = region->begin + *size;
+  region->begin   = (uintptr_t)addr;
+  region->end     = region->begin + *size;
+#ifdef CONFIG_MM_KASAN_REGION_OPTIN
+  region->enabled = false;
+#else
+  region->enabled = true;
+#endif
 
   flags = spin_lock_irqsave(&g_lock);
 
@@ -219,6 +276,7 @@ void kasan_unregister(FAR void *addr)
         {
           size_t size = g_region[i]->end - g_region[i]->begin;
           g_region_count--;
+          g_region_last = 0;
           memmove(&g_region[i], &g_region[i + 1],
                   (g_region_count - i) * sizeof(g_region[0]));
           spin_unlock_irqrestore(&g_lock, flags);
@@ -60,13 +60,23 @@ FAR void *vm_alloc_region(FAR struct mm_map_s *mm, FAR void *vaddr,
 
   if (mm->mm_map_vpages != NULL)
     {
-      if (vaddr == NULL)
+      if (vaddr != NULL)
         {
-          ret = gran_alloc(mm->mm_map_vpages, size);
+          ret = gran_reserve(mm->mm_map_vpages, (uintptr_t)vaddr, size);
+        }
+#if CONFIG_ARCH_ADDRENV_CONTIG_NPAGES > 0
+      else if (size >= CONFIG_ARCH_ADDRENV_CONTIG_NPAGES * MM_PGSIZE)
+        {
+          /* Align regions that can hold a contiguous mapping to it */
+
+          ret = gran_alloc_align(mm->mm_map_vpages, size,
+                                 CONFIG_ARCH_ADDRENV_CONTIG_NPAGES *
+                                 MM_PGSIZE);
         }
+#endif
       else
         {
-          ret = gran_reserve(mm->mm_map_vpages, (uintptr_t)vaddr, size);
+          ret = gran_alloc(mm->mm_map_vpages, size);
         }
     }
 
@@ -106,6 +116,11 @@ FAR void *vm_map_region(uintptr_t paddr, size_t size)
   uintptr_t tpaddr = MM_PGALIGNDOWN(paddr);
   uint      i      = 0;
   int       ret    = OK;
+#if CONFIG_ARCH_ADDRENV_CONTIG_NPAGES > 0
+  uintptr_t pages[CONFIG_ARCH_ADDRENV_CONTIG_NPAGES];
+  uint      n;
+  uint      j;
+#endif
 
   DEBUGASSERT(paddr);
 
@@ -117,6 +132,36 @@ FAR void *vm_map_region(uintptr_t paddr, size_t size)
   if (vaddr)
     {
       tvaddr = (uintptr_t)vaddr;
+#if CONFIG_ARCH_ADDRENV_CONTIG_NPAGES > 0
+      /* Map up to the next aligned run at a time, so that up_shmat() sees
+       * the runs that are contiguous.
+       */
+
+      while (i < npages)
+        {
+          n = CONFIG_ARCH_ADDRENV_CONTIG_NPAGES -
+              (tvaddr / MM_PGSIZE) % CONFIG_ARCH_ADDRENV_CONTIG_NPAGES;
+          if (n > npages - i)
+            {
+              n = npages - i;
+            }
+
+          for (j = 0; j < n; j++)
+            {
+              pages[j] = tpaddr + j * MM_PGSIZE;
+            }
+
+          ret = up_shmat(pages, n, tvaddr);
+          if (ret)
+            {
+              goto error;
+            }
+
+          i      += n;
+          tvaddr += n * MM_PGSIZE;
+          tpaddr += n * MM_PGSIZE;
+        }
+#else
       for (; i < npages; i++, tvaddr += MM_PGSIZE, tpaddr += MM_PGSIZE)
         {
           ret = up_shmat(&tpaddr, 1, tvaddr);
@@ -125,6 +170,7 @@ FAR void *vm_map_region(uintptr_t paddr, size_t size)
               goto error;
             }
         }
+#endif
     }
 
   return (FAR void *)((uintptr_t)vaddr + (MM_PGMASK & paddr));
@@ -28,8 +28,11 @@
 #include <execinfo.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <syslog.h>
+#include <sys/param.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mm/kasan.h>
 #include <nuttx/mm/mempool.h>
@@ -100,6 +103,151 @@ static inline void mempool_add_queue(FAR struct mempool_s *pool,
     }
 }
 
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+/* Pools that block waiters rely on every release posting the semaphore,
+ * they always use the shared free list.
+ */
+
+#  define mempool_magazine_enabled(pool) \
+     (!(pool)->wait || (pool)->expandsize != 0)
+
+static FAR void *mempool_magazine_alloc(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_magazine_s *mag;
+  FAR void *blk = NULL;
+  irqstate_t flags;
+
+  if (!mempool_magazine_enabled(pool))
+    {
+      return NULL;
+    }
+
+  flags = up_irq_save();
+  mag = &pool->magazine[this_cpu()];
+  if (mag->count == 0)
+    {
+      /* The magazine is empty, refill one batch from the shared list */
+
+      spin_lock(&pool->lock);
+      while (mag->count < CONFIG_MM_MEMPOOL_MAGAZINE_SIZE &&
+             (blk = mempool_remove_queue(pool, &pool->queue)) != NULL)
+        {
+          mag->blks[mag->count++] = blk;
+        }
+
+      pool->nalloc += mag->count;
+      spin_unlock(&pool->lock);
+    }
+
+  blk = mag->count > 0 ? mag->blks[--mag->count] : NULL;
+  up_irq_restore(flags);
+  return blk;
+}
+
+static bool mempool_magazine_release(FAR struct mempool_s *pool,
+                                     FAR void *blk)
+{
+  FAR struct mempool_magazine_s *mag;
+#if CONFIG_MM_BACKTRACE >= 0
+  FAR struct mempool_backtrace_s *buf;
+#endif
+  irqstate_t flags;
+  size_t i;
+
+  if (!mempool_magazine_enabled(pool) ||
+      (pool->ibase != NULL && (FAR char *)blk >= pool->ibase &&
+       (FAR char *)blk < pool->ibase + pool->interruptsize))
+    {
+      return false;
+    }
+
+#if CONFIG_MM_BACKTRACE >= 0
+  buf = (FAR struct mempool_backtrace_s *)((FAR char *)blk +
+                                           pool->blocksize);
+
+  /* Check double free or out of out of bounds */
+
+  DEBUGASSERT(buf->magic == MEMPOOL_MAGIC_ALLOC);
+  buf->magic = MEMPOOL_MAGIC_FREE;
+#endif
+
+#ifdef CONFIG_MM_FILL_ALLOCATIONS
+  memset(blk, MM_FREE_MAGIC, pool->blocksize);
+#endif
+
+  kasan_poison(blk, pool->blocksize);
+
+  flags = up_irq_save();
+  mag = &pool->magazine[this_cpu()];
+  if (mag->count == nitems(mag->blks))
+    {
+      /* The magazine is full, return the older batch to the shared list
+       * and keep the recently released (cache hot) blocks.
+       */
+
+      spin_lock(&pool->lock);
+      for (i = 0; i < CONFIG_MM_MEMPOOL_MAGAZINE_SIZE; i++)
+        {
+          sq_addlast(mag->blks[i], &pool->queue);
+        }
+
+      pool->nalloc -= CONFIG_MM_MEMPOOL_MAGAZINE_SIZE;
+      spin_unlock(&pool->lock);
+
+      mag->count -= CONFIG_MM_MEMPOOL_MAGAZINE_SIZE;
+      memmove(mag->blks, mag->blks + CONFIG_MM_MEMPOOL_MAGAZINE_SIZE,
+              mag->count * sizeof(mag->blks[0]));
+    }
+
+  mag->blks[mag->count++] = blk;
+  up_irq_restore(flags);
+  return true;
+}
+
+/* Return the number of free blocks currently held by the magazines.  This
+ * is only a snapshot, the other CPUs may change them at any time.
+ */
+
+static size_t mempool_magazine_count(FAR struct mempool_s *pool)
+{
+  size_t count = 0;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      count += pool->magazine[cpu].count;
+    }
+
+  return count;
+}
+
+/* Give the blocks cached by all magazines back to the shared free list */
+
+static void mempool_magazine_flush(FAR struct mempool_s *pool)
+{
+  FAR struct mempool_magazine_s *mag;
+  irqstate_t flags;
+  int cpu;
+
+  flags = spin_lock_irqsave(&pool->lock);
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      mag = &pool->magazine[cpu];
+      while (mag->count > 0)
+        {
+          sq_addlast(mag->blks[--mag->count], &pool->queue);
+          pool->nalloc--;
+        }
+    }
+
+  spin_unlock_irqrestore(&pool->lock, flags);
+}
+#else
+#  define mempool_magazine_alloc(pool)        NULL
+#  define mempool_magazine_release(pool, blk) false
+#  define mempool_magazine_count(pool)        0
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static inline void mempool_add_backtrace(FAR struct mempool_s *pool,
                                          FAR struct mempool_backtrace_s *buf)
@@ -315,6 +463,10 @@ int mempool_init(FAR struct mempool_s *pool, FAR const char *name)
     }
 
   spin_lock_init(&pool->lock);
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+  memset(pool->magazine, 0, sizeof(pool->magazine));
+#endif
+
   if (pool->wait && pool->expandsize == 0)
     {
       nxsem_init(&pool->waitsem, 0, 0);
@@ -354,6 +506,12 @@ FAR void *mempool_allocate(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   irqstate_t flags;
 
+  blk = mempool_magazine_alloc(pool);
+  if (blk != NULL)
+    {
+      goto out;
+    }
+
 retry:
   flags = spin_lock_irqsave(&pool->lock);
   blk = mempool_remove_queue(pool, &pool->queue);
@@ -408,6 +566,7 @@ retry:
   pool->nalloc++;
   spin_unlock_irqrestore(&pool->lock, flags);
 
+out:
 #if CONFIG_MM_BACKTRACE >= 0
   mempool_add_backtrace(pool, (FAR struct mempool_backtrace_s *)
                               ((FAR char *)blk + pool->blocksize));
@@ -434,10 +593,19 @@ retry:
 
 void mempool_release(FAR struct mempool_s *pool, FAR void *blk)
 {
-  irqstate_t flags = spin_lock_irqsave(&pool->lock);
+  irqstate_t flags;
 #if CONFIG_MM_BACKTRACE >= 0
   FAR struct mempool_backtrace_s *buf =
     (FAR struct mempool_backtrace_s *)((FAR char *)blk + pool->blocksize);
+#endif
+
+  if (mempool_magazine_release(pool, blk))
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&pool->lock);
+#if CONFIG_MM_BACKTRACE >= 0
 
   /* Check double free or out of out of bounds */
 
@@ -505,9 +673,9 @@ int mempool_info(FAR struct mempool_s *pool, FAR struct mempoolinfo_s *info)
   DEBUGASSERT(pool != NULL && info != NULL);
 
   flags = spin_lock_irqsave(&pool->lock);
-  info->ordblks = sq_count(&pool->queue);
+  info->ordblks = sq_count(&pool->queue) + mempool_magazine_count(pool);
   info->iordblks = sq_count(&pool->iqueue);
-  info->aordblks = pool->nalloc;
+  info->aordblks = pool->nalloc - mempool_magazine_count(pool);
   info->arena = sq_count(&pool->equeue) * MEMPOOL_HEADER_SIZE +
     (info->aordblks + info->ordblks + info->iordblks) * blocksize;
   spin_unlock_irqrestore(&pool->lock, flags);
@@ -545,7 +713,8 @@ mempool_info_task(FAR struct mempool_s *pool,
     {
       irqstate_t flags = spin_lock_irqsave(&pool->lock);
       size_t count = sq_count(&pool->queue) +
-                     sq_count(&pool->iqueue);
+                     sq_count(&pool->iqueue) +
+                     mempool_magazine_count(pool);
 
       spin_unlock_irqrestore(&pool->lock, flags);
       info.aordblks += count;
@@ -553,8 +722,10 @@ mempool_info_task(FAR struct mempool_s *pool,
     }
   else if (task->pid == PID_MM_ALLOC)
     {
-      info.aordblks += pool->nalloc;
-      info.uordblks += pool->nalloc * blocksize;
+      size_t count = pool->nalloc - mempool_magazine_count(pool);
+
+      info.aordblks += count;
+      info.uordblks += count * blocksize;
     }
 #if CONFIG_MM_BACKTRACE >= 0
   else
@@ -624,6 +795,10 @@ int mempool_deinit(FAR struct mempool_s *pool)
   FAR sq_entry_t *blk;
   size_t count = 0;
 
+#ifdef CONFIG_MM_MEMPOOL_MAGAZINE
+  mempool_magazine_flush(pool);
+#endif
+
   if (pool->nalloc != 0)
     {
       return -EBUSY;
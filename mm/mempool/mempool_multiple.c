@@ -564,6 +564,8 @@ FAR void *mempool_multiple_alloc(FAR struct mempool_multiple_s *mpool,
  *
  * Description:
  *   Change the size of the block memory pointed to by oldblk to size bytes.
+ *   The block is kept as long as the new size still fits and maps to the
+ *   same pool, so growing within a size class never copies.
  *
  * Input Parameters:
  *   mpool  - The handle of multiple memory pool to be used.
@@ -579,7 +581,9 @@ FAR void *mempool_multiple_realloc(FAR struct mempool_multiple_s *mpool,
                                    FAR void *oldblk, size_t size)
 {
   FAR struct mpool_dict_s *dict;
+  FAR struct mempool_s *pool;
   FAR void *blk;
+  size_t offset;
 
   if (oldblk == NULL)
     {
@@ -592,6 +596,19 @@ FAR void *mempool_multiple_realloc(FAR struct mempool_multiple_s *mpool,
       return NULL;
     }
 
+  /* A memalign'ed block does not start at the beginning of its slot */
+
+  offset = ((FAR char *)kasan_clear_tag(oldblk) -
+            ((FAR char *)kasan_clear_tag(dict->addr) + mpool->minpoolsize)) %
+           MEMPOOL_REALBLOCKSIZE(dict->pool);
+
+  pool = mempool_multiple_find(mpool, size);
+  if (pool != NULL && pool >= dict->pool &&
+      size <= dict->pool->blocksize - offset)
+    {
+      return oldblk;
+    }
+
   blk = mempool_multiple_alloc(mpool, size);
   if (blk != NULL && oldblk != NULL)
     {
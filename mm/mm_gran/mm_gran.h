@@ -44,8 +44,17 @@
 
 #define SIZEOF_GAT(n) \
   ((n + 31) >> 5)
+#define SIZEOF_GATS(n) \
+  SIZEOF_GAT(SIZEOF_GAT(n))
 #define SIZEOF_GRAN_S(n) \
-  (sizeof(struct gran_s) + sizeof(uint32_t) * (SIZEOF_GAT(n) - 1))
+  (sizeof(struct gran_s) + \
+   sizeof(uint32_t) * (SIZEOF_GAT(n) + SIZEOF_GATS(n) - 1))
+
+/* Number of next-fit hints, hint[k] serves the allocations of at least
+ * 2**k granules.
+ */
+
+#define GRAN_NHINTS 8
 
 /* Debug */
 
@@ -77,7 +86,16 @@ struct gran_s
   mutex_t    lock;       /* For exclusive access to the GAT */
 #endif
   uintptr_t  heapstart; /* The aligned start of the granule heap */
-  uint32_t   gat[1];    /* Start of the granule allocation table */
+
+  /* No run of 2**k free granules starts below hint[k] */
+
+  uint16_t   hint[GRAN_NHINTS];
+
+  /* Start of the granule allocation table, it is followed by a summary
+   * with one bit per GAT cell that is full.
+   */
+
+  uint32_t   gat[1];
 };
 
 /****************************************************************************
@@ -61,7 +61,7 @@ FAR void *gran_alloc(GRAN_HANDLE handle, size_t size)
       return NULL;
     }
 
-  posi = gran_search(gran, ngran);
+  posi = gran_search(gran, ngran, 1);
   if (posi >= 0)
     {
       gran_set(gran, posi, ngran);
@@ -87,7 +87,6 @@ FAR void *gran_alloc_align(GRAN_HANDLE handle, size_t size, size_t align)
   uintptr_t retp;
   size_t nalign;
   size_t ngran;
-  size_t naligned_up;
   int posi;
   int ret;
 
@@ -95,22 +94,25 @@ FAR void *gran_alloc_align(GRAN_HANDLE handle, size_t size, size_t align)
   nalign = NGRANULE(gran, align);
   ngran = NGRANULE(gran, size);
 
-  naligned_up = ngran + (nalign - 1);
-  if (!naligned_up || naligned_up > gran->ngranules)
+  if (!ngran || ngran > gran->ngranules)
     {
       return NULL;
     }
 
+  if (nalign == 0)
+    {
+      nalign = 1;
+    }
+
   ret = gran_enter_critical(gran);
   if (ret < 0)
     {
       return NULL;
     }
 
-  posi = gran_search(gran, naligned_up);
+  posi = gran_search(gran, ngran, nalign);
   if (posi >= 0)
     {
-      posi = (posi + nalign - 1) & ~(nalign - 1);
       gran_set(gran, posi, ngran);
     }
 
@@ -90,18 +90,154 @@ uint32_t lsb_mask(uint32_t n)
   return (-n & n) & GATCFULL;
 }
 
-/* set or clear a GAT cell with given bit mask */
+/* return offset of the lowest set bit in n */
+
+static inline unsigned int cell_lsb(uint32_t n)
+{
+#ifdef CONFIG_HAVE_BUILTIN_CTZ
+  return __builtin_ctz(n);
+#else
+  return DEBRUJIN_LUT[(uint32_t)(lsb_mask(n) * DEBRUJIN_NUM) >> 27];
+#endif
+}
+
+/* return offset of the highest set bit in n */
+
+static inline unsigned int cell_msb(uint32_t n)
+{
+#ifdef CONFIG_HAVE_BUILTIN_CLZ
+  return 31 - __builtin_clz(n);
+#else
+  return DEBRUJIN_LUT[(uint32_t)(msb_mask(n) * DEBRUJIN_NUM) >> 27];
+#endif
+}
+
+/* set or clear a GAT cell with given bit mask, the summary bit of the
+ * cell is kept in sync.
+ */
 
 static void cell_set(gran_t *gran, uint32_t cell, uint32_t mask, bool val)
 {
+  FAR uint32_t *full = GATSUMMARY(gran);
+  uint32_t bit = BIT(cell % GATC_BITS(gran));
+
   if (val)
     {
       gran->gat[cell] |= mask;
+      if (gran->gat[cell] == GATCFULL)
+        {
+          full[cell / GATC_BITS(gran)] |= bit;
+        }
     }
   else
     {
       gran->gat[cell] &= ~mask;
+      full[cell / GATC_BITS(gran)] &= ~bit;
+    }
+}
+
+/* returns index of the first GAT cell at or after cell that is not full,
+ * or the number of cells if there is none.
+ */
+
+static size_t cell_next(const gran_t *gran, size_t cell)
+{
+  FAR const uint32_t *full = GATSUMMARY(gran);
+  size_t ncells = GATCELLS(gran);
+  size_t s = cell / GATC_BITS(gran);
+  uint32_t v;
+
+  if (cell >= ncells)
+    {
+      return ncells;
+    }
+
+  v = ~full[s] & ~(uint32_t)(BIT(cell % GATC_BITS(gran)) - 1);
+  while (v == 0)
+    {
+      if (++s >= SIZEOF_GAT(ncells))
+        {
+          return ncells;
+        }
+
+      v = ~full[s];
+    }
+
+  cell = s * GATC_BITS(gran) + cell_lsb(v);
+  return cell < ncells ? cell : ncells;
+}
+
+/* returns the first free granule at or after posi, or ngranules */
+
+static size_t gran_nextfree(const gran_t *gran, size_t posi)
+{
+  size_t c = posi / GATC_BITS(gran);
+  uint32_t v;
+
+  v = ~gran->gat[c] & ~(uint32_t)(BIT(posi % GATC_BITS(gran)) - 1);
+  if (v == 0)
+    {
+      c = cell_next(gran, c + 1);
+      if (c >= GATCELLS(gran))
+        {
+          return gran->ngranules;
+        }
+
+      v = ~gran->gat[c];
     }
+
+  posi = c * GATC_BITS(gran) + cell_lsb(v);
+  return posi < gran->ngranules ? posi : gran->ngranules;
+}
+
+/* returns the first used granule at or after posi and before end, or end */
+
+static size_t gran_nextused(const gran_t *gran, size_t posi, size_t end)
+{
+  size_t c = posi / GATC_BITS(gran);
+  uint32_t v;
+
+  v = gran->gat[c] & ~(uint32_t)(BIT(posi % GATC_BITS(gran)) - 1);
+  while (v == 0)
+    {
+      if (++c * GATC_BITS(gran) >= end)
+        {
+          return end;
+        }
+
+      v = gran->gat[c];
+    }
+
+  posi = c * GATC_BITS(gran) + cell_lsb(v);
+  return posi < end ? posi : end;
+}
+
+/* returns the start of the free range that ends right before posi */
+
+static size_t gran_runstart(const gran_t *gran, size_t posi)
+{
+  size_t c = posi / GATC_BITS(gran);
+  uint32_t v;
+
+  v = gran->gat[c] & (uint32_t)(BIT(posi % GATC_BITS(gran)) - 1);
+  while (v == 0)
+    {
+      if (c == 0)
+        {
+          return 0;
+        }
+
+      v = gran->gat[--c];
+    }
+
+  return c * GATC_BITS(gran) + cell_msb(v) + 1;
+}
+
+/* returns index of the hint that serves allocations of size granules */
+
+static int gran_hint(size_t size)
+{
+  return size >= BIT(GRAN_NHINTS - 1) ? GRAN_NHINTS - 1 : cell_msb(size);
 }
 
 /* set or clear a range of GAT bits */
@@ -228,24 +364,9 @@ failure:
       v = gran->gat[c];
       DEBUGASSERT(v);
 
-      if (v == GATCFULL)
-        {
-          /* Handle full GAT quickly */
+      /* offset of last used when matching for free */
 
-          tmp = 31;
-        }
-      else
-        {
-          /* offset of last used when matching for free */
-
-#ifdef CONFIG_HAVE_BUILTIN_CLZ
-          tmp = 31 - __builtin_clz(v);
-#else
-          tmp = (uint32_t)((msb_mask(v)) * DEBRUJIN_NUM) >> 27;
-          DEBUGASSERT(tmp < sizeof(DEBRUJIN_LUT));
-          tmp = DEBRUJIN_LUT[tmp];
-#endif
-        }
+      tmp = cell_msb(v);
 
       /* return the last used position to caller */
 
@@ -255,28 +376,66 @@ failure:
   return false;
 }
 
-/* returns granule number of free range or negative error */
+/* returns granule number of free range or negative error.  The GAT is
+ * scanned one cell at a time, the full cells are skipped through the
+ * summary, and the search starts at the hint for the size.
+ */
 
-int gran_search(const gran_t *gran, size_t size)
+int gran_search(gran_t *gran, size_t size, size_t align)
 {
-  int ret = -EINVAL;
+  size_t posi;
+  size_t next;
+  int k;
 
-  if (gran == NULL || gran->ngranules < size)
+  if (gran == NULL || size == 0 || gran->ngranules < size)
     {
-      return ret;
+      return -EINVAL;
     }
 
-  ret = -ENOMEM;
-  for (size_t i = 0; i <= gran->ngranules - size; i++)
+  DEBUGASSERT(align > 0 && (align & (align - 1)) == 0);
+
+  k    = gran_hint(size);
+  posi = (gran->hint[k] + align - 1) & ~(align - 1);
+
+  while (posi + size <= gran->ngranules)
     {
-      if (gran_match(gran, i, size, 0, &i))
+      next = gran_nextfree(gran, posi);
+      if (next == posi)
         {
-          ret = i;
-          break;
+          next = gran_nextused(gran, posi, posi + size);
+          if (next == posi + size)
+            {
+              break;
+            }
+
+          next++;
         }
+
+      posi = (next + align - 1) & ~(align - 1);
     }
 
-  return ret;
+  /* Nothing below posi fits size unaligned granules, that is true for
+   * the hints of all allocations that are not smaller.
+   */
+
+  if (align == 1)
+    {
+      if (BIT(k) < size)
+        {
+          k++;
+        }
+
+      posi = posi < gran->ngranules ? posi : gran->ngranules;
+      for (; k < GRAN_NHINTS; k++)
+        {
+          if (gran->hint[k] < posi)
+            {
+              gran->hint[k] = posi;
+            }
+        }
+    }
+
+  return posi + size <= gran->ngranules ? (int)posi : -ENOMEM;
 }
 
 /* set a range of granules */
@@ -300,10 +459,22 @@ int gran_clear(gran_t *gran, size_t posi, size_t size)
 {
   gatr_t rang;
   int ret = gran_range(gran, posi, size, &rang);
+  int k;
 
   if (ret == OK)
     {
       gran_set_(gran, &rang, false);
+
+      /* The freed granules may join the free range before them */
+
+      posi = gran_runstart(gran, posi);
+      for (k = 0; k < GRAN_NHINTS; k++)
+        {
+          if (gran->hint[k] > posi)
+            {
+              gran->hint[k] = posi;
+            }
+        }
     }
 
   return ret;
@@ -58,6 +58,8 @@
 /* GAT table related */
 
 #define GATC_BITS(g)        (sizeof(g->gat[0]) << 3)
+#define GATCELLS(g)         SIZEOF_GAT(g->ngranules)
+#define GATSUMMARY(g)       (&g->gat[GATCELLS(g)])
 
 /****************************************************************************
  * Public Types
@@ -129,17 +131,19 @@ bool gran_match(const gran_t *gran, size_t posi, size_t size, bool used,
  * Name: gran_search
  *
  * Description:
- *   search for continuous range of free granules
+ *   search for the first continuous range of free granules that starts
+ *   at a multiple of align
  *
  * Input Parameters:
- *   gran - Pointer to the gran state
- *   size - Length of range
+ *   gran  - Pointer to the gran state
+ *   size  - Length of range
+ *   align - Alignment of range in granules, a power of 2
  *
  * Return value:
  *   position of negative error number.
  ****************************************************************************/
 
-int gran_search(const gran_t *gran, size_t size);
+int gran_search(gran_t *gran, size_t size, size_t align);
 
 /****************************************************************************
  * Name: gran_set, gran_clear
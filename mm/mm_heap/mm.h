@@ -31,6 +31,7 @@
 
 #include <nuttx/mutex.h>
 #include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/lib/math32.h>
 #include <nuttx/mm/mempool.h>
@@ -109,12 +110,40 @@
 #  define MM_ADD_BACKTRACE(heap, ptr)
 #endif
 
+/* Add size to the heap usage of the task that owns the chunk */
+
+#if defined(CONFIG_SCHED_RUSAGE) && CONFIG_MM_BACKTRACE >= 0
+#  define MM_RUSAGE(ptr, size) \
+     nxsched_rusage_heap(((FAR struct mm_allocnode_s *)(ptr))->pid, size)
+#else
+#  define MM_RUSAGE(ptr, size)
+#endif
+
 /* All other definitions derive from these two */
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
 
+/* With CONFIG_MM_HEAP_BITMAP each of the MM_NNODES size classes is split
+ * again into MM_NSUBNODES bins by the next MM_SL_SHIFT bits of the size.
+ */
+
+#ifdef CONFIG_MM_HEAP_BITMAP
+#  define MM_SL_SHIFT    3
+#  define MM_NSUBNODES   (1 << MM_SL_SHIFT)
+#endif
+
+/* The multiple mempool in front of the heap is split into one arena per
+ * CPU with CONFIG_MM_HEAP_MEMPOOL_ARENA.
+ */
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_ARENA
+#  define MM_NARENAS     CONFIG_SMP_NCPUS
+#else
+#  define MM_NARENAS     1
+#endif
+
 #define MM_GRAN_MASK     (MM_ALIGN - 1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
@@ -245,12 +274,23 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_HEAP_BITMAP
+  /* The free nodes of each bin are kept in a NULL terminated doubly
+   * linked list.  Bit n of mm_flbitmap tells that one of the bins of size
+   * class n is not empty, bit m of mm_slbitmap[n] which one.
+   */
+
+  FAR struct mm_freenode_s *mm_freelist[MM_NNODES][MM_NSUBNODES];
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_NNODES];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed up searching of free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
 
   /* Free delay list, as sometimes we can't do free immdiately. */
 
@@ -260,11 +300,17 @@ struct mm_heap_s
   size_t mm_delaycount[CONFIG_SMP_NCPUS];
 #endif
 
-  /* The is a multiple mempool of the heap */
+  /* The is a multiple mempool of the heap, and the blocks other CPUs freed
+   * back to each arena of it.
+   */
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   size_t                         mm_threshold;
-  FAR struct mempool_multiple_s *mm_mpool;
+  FAR struct mempool_multiple_s *mm_mpool[MM_NARENAS];
+#  ifdef CONFIG_MM_HEAP_MEMPOOL_ARENA
+  spinlock_t                     mm_arenalock;
+  FAR struct mm_delaynode_s     *mm_arenafree[MM_NARENAS];
+#  endif
 #endif
 
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
@@ -302,6 +348,36 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
 
+/* Functions contained in mm_heapprof.c *************************************/
+
+#ifdef CONFIG_MM_HEAPPROF
+void mm_heapprof_malloc(FAR void *mem, size_t size);
+void mm_heapprof_free(FAR void *mem);
+#else
+#  define mm_heapprof_malloc(mem, size)
+#  define mm_heapprof_free(mem)
+#endif
+
+/* Functions contained in mm_arena.c ****************************************/
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+void mm_arena_uninitialize(FAR struct mm_heap_s *heap);
+FAR void *mm_arena_malloc(FAR struct mm_heap_s *heap, size_t size);
+FAR void *mm_arena_memalign(FAR struct mm_heap_s *heap, size_t alignment,
+                            size_t size);
+FAR void *mm_arena_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
+                           size_t size);
+int mm_arena_free(FAR struct mm_heap_s *heap, FAR void *mem);
+ssize_t mm_arena_size(FAR struct mm_heap_s *heap, FAR void *mem);
+void mm_arena_foreach(FAR struct mm_heap_s *heap,
+                      mempool_multiple_foreach_t handle, FAR void *arg);
+struct mallinfo mm_arena_mallinfo(FAR struct mm_heap_s *heap);
+struct mallinfo_task mm_arena_info_task(FAR struct mm_heap_s *heap,
+                                        FAR const struct malltask *task);
+void mm_arena_memdump(FAR struct mm_heap_s *heap,
+                      FAR const struct mm_memdump_s *dump);
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -318,6 +394,159 @@ static inline_function int mm_size2ndx(size_t size)
   return flsl(size) - 1;
 }
 
+#ifdef CONFIG_MM_HEAP_BITMAP
+
+/* Return the bin of a free node of the given size, sizes from MM_MAX_CHUNK
+ * on all share the last bin.
+ */
+
+static inline_function void mm_size2bin(size_t size, FAR int *fl,
+                                        FAR int *sl)
+{
+  int shift;
+
+  DEBUGASSERT(size >= MM_MIN_CHUNK);
+  if (size >= MM_MAX_CHUNK)
+    {
+      *fl = MM_NNODES - 1;
+      *sl = MM_NSUBNODES - 1;
+      return;
+    }
+
+  shift = flsl(size) - 1;
+  *fl   = shift - MM_MIN_SHIFT;
+  *sl   = (size >> (shift - MM_SL_SHIFT)) & (MM_NSUBNODES - 1);
+}
+
+/* Find a free node of at least the given size.  The size is rounded up to
+ * the next bin boundary first, so that any node of the first non-empty bin
+ * from there fits.  Only the last bin, which has no upper bound, and the
+ * bin of the unrounded size, when all larger ones are empty, need to be
+ * searched.
+ */
+
+static inline_function FAR struct mm_freenode_s *
+mm_findfreechunk(FAR struct mm_heap_s *heap, size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  uint32_t bitmap;
+  size_t rsize;
+  int fl;
+  int sl;
+
+  rsize = size;
+  if (size < MM_MAX_CHUNK)
+    {
+      rsize += ((size_t)1 << (flsl(size) - 1 - MM_SL_SHIFT)) - 1;
+    }
+
+  mm_size2bin(rsize, &fl, &sl);
+
+  bitmap = heap->mm_slbitmap[fl] & (UINT32_MAX << sl);
+  if (bitmap == 0)
+    {
+      bitmap = heap->mm_flbitmap & (UINT32_MAX << fl << 1);
+      if (bitmap != 0)
+        {
+          fl     = ffs(bitmap) - 1;
+          bitmap = heap->mm_slbitmap[fl];
+        }
+    }
+
+  if (bitmap != 0)
+    {
+      sl = ffs(bitmap) - 1;
+      node = heap->mm_freelist[fl][sl];
+      if (fl < MM_NNODES - 1 || sl < MM_NSUBNODES - 1)
+        {
+          return node;
+        }
+    }
+  else
+    {
+      /* Nothing larger, but there may be a large enough node in the bin
+       * of the size itself.
+       */
+
+      mm_size2bin(size, &fl, &sl);
+      node = heap->mm_freelist[fl][sl];
+    }
+
+  for (; node != NULL; node = node->flink)
+    {
+      if (MM_SIZEOF_NODE(node) >= size)
+        {
+          break;
+        }
+    }
+
+  return node;
+}
+
+static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
+                                            FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_freenode_s **head;
+  size_t nodesize = MM_SIZEOF_NODE(node);
+  int fl;
+  int sl;
+
+  DEBUGASSERT(nodesize >= MM_MIN_CHUNK);
+  DEBUGASSERT(MM_NODE_IS_FREE(node));
+
+  /* Push the node on its bin, the bins are not sorted */
+
+  mm_size2bin(nodesize, &fl, &sl);
+  head = &heap->mm_freelist[fl][sl];
+
+  node->blink = NULL;
+  node->flink = *head;
+  if (*head != NULL)
+    {
+      (*head)->blink = node;
+    }
+
+  *head = node;
+  heap->mm_flbitmap     |= 1u << fl;
+  heap->mm_slbitmap[fl] |= 1u << sl;
+}
+
+static inline_function void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                                            FAR struct mm_freenode_s *node)
+{
+  int fl;
+  int sl;
+
+  if (node->blink != NULL)
+    {
+      node->blink->flink = node->flink;
+    }
+  else
+    {
+      /* The first node of its bin, the bin may become empty */
+
+      mm_size2bin(MM_SIZEOF_NODE(node), &fl, &sl);
+      DEBUGASSERT(heap->mm_freelist[fl][sl] == node);
+
+      heap->mm_freelist[fl][sl] = node->flink;
+      if (node->flink == NULL)
+        {
+          heap->mm_slbitmap[fl] &= ~(1u << sl);
+          if (heap->mm_slbitmap[fl] == 0)
+            {
+              heap->mm_flbitmap &= ~(1u << fl);
+            }
+        }
+    }
+
+  if (node->flink != NULL)
+    {
+      node->flink->blink = node->blink;
+    }
+}
+
+#else /* CONFIG_MM_HEAP_BITMAP */
+
 static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
                                             FAR struct mm_freenode_s *node)
 {
@@ -354,4 +583,19 @@ static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
     }
 }
 
+static inline_function void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                                            FAR struct mm_freenode_s *node)
+{
+  /* There must be a predecessor, but there may not be a successor node */
+
+  DEBUGASSERT(node->blink);
+  node->blink->flink = node->flink;
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+}
+
+#endif /* CONFIG_MM_HEAP_BITMAP */
+
 #endif /* __MM_MM_HEAP_MM_H */
@@ -0,0 +1,410 @@
+/****************************************************************************
+ * mm/mm_heap/mm_arena.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <string.h>
+
+#include <sys/param.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/mm.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The arena of the calling CPU, the allocations it makes come from there */
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_ARENA
+#  define mm_arena_this()      this_cpu()
+#else
+#  define mm_arena_this()      0
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_arena_owner
+ *
+ * Description:
+ *   Return the index of the arena that mem was allocated from, or a
+ *   negative value if it did not come from any of them.  The arena of the
+ *   calling CPU is tried first, it is the common case.
+ *
+ ****************************************************************************/
+
+static int mm_arena_owner(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  int self = mm_arena_this();
+  int i;
+
+  if (heap->mm_mpool[0] == NULL)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < MM_NARENAS; i++)
+    {
+      int index = (self + i) % MM_NARENAS;
+
+      if (mempool_multiple_alloc_size(heap->mm_mpool[index], mem) >= 0)
+        {
+          return index;
+        }
+    }
+
+  return -EINVAL;
+}
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_ARENA
+
+/****************************************************************************
+ * Name: mm_arena_defer
+ *
+ * Description:
+ *   Queue a block freed by another CPU on the list of its own arena.  It
+ *   goes back to the pools the next time the owner allocates, so the free
+ *   lists and counters of an arena are only touched by its own CPU in the
+ *   common case.
+ *
+ ****************************************************************************/
+
+static void mm_arena_defer(FAR struct mm_heap_s *heap, int index,
+                           FAR void *mem)
+{
+  FAR struct mm_delaynode_s *tmp = mem;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&heap->mm_arenalock);
+  tmp->flink = heap->mm_arenafree[index];
+  heap->mm_arenafree[index] = tmp;
+  spin_unlock_irqrestore(&heap->mm_arenalock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_arena_drain
+ *
+ * Description:
+ *   Give the blocks that other CPUs freed back to the pools of arena index.
+ *
+ ****************************************************************************/
+
+static void mm_arena_drain(FAR struct mm_heap_s *heap, int index)
+{
+  FAR struct mm_delaynode_s *tmp;
+  irqstate_t flags;
+
+  if (heap->mm_arenafree[index] == NULL)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&heap->mm_arenalock);
+  tmp = heap->mm_arenafree[index];
+  heap->mm_arenafree[index] = NULL;
+  spin_unlock_irqrestore(&heap->mm_arenalock, flags);
+
+  while (tmp != NULL)
+    {
+      FAR void *address = tmp;
+
+      tmp = tmp->flink;
+      DEBUGVERIFY(mempool_multiple_free(heap->mm_mpool[index], address));
+    }
+}
+
+/* Drain every arena before the pools are walked, so the statistics do not
+ * count the deferred blocks as used.
+ */
+
+static void mm_arena_drain_all(FAR struct mm_heap_s *heap)
+{
+  int i;
+
+  for (i = 0; i < MM_NARENAS; i++)
+    {
+      mm_arena_drain(heap, i);
+    }
+}
+#else
+#  define mm_arena_drain(heap, index)
+#  define mm_arena_drain_all(heap)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_arena_uninitialize
+ ****************************************************************************/
+
+void mm_arena_uninitialize(FAR struct mm_heap_s *heap)
+{
+  int i;
+
+  mm_arena_drain_all(heap);
+  for (i = 0; i < MM_NARENAS; i++)
+    {
+      mempool_multiple_deinit(heap->mm_mpool[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: mm_arena_malloc
+ *
+ * Description:
+ *   Allocate from the arena of the calling CPU, NULL if the size is above
+ *   the pool threshold or the arena is out of memory.
+ *
+ ****************************************************************************/
+
+FAR void *mm_arena_malloc(FAR struct mm_heap_s *heap, size_t size)
+{
+  int self = mm_arena_this();
+
+  if (heap->mm_mpool[self] == NULL)
+    {
+      return NULL;
+    }
+
+  mm_arena_drain(heap, self);
+  return mempool_multiple_alloc(heap->mm_mpool[self], size);
+}
+
+/****************************************************************************
+ * Name: mm_arena_memalign
+ ****************************************************************************/
+
+FAR void *mm_arena_memalign(FAR struct mm_heap_s *heap, size_t alignment,
+                            size_t size)
+{
+  int self = mm_arena_this();
+
+  if (heap->mm_mpool[self] == NULL)
+    {
+      return NULL;
+    }
+
+  mm_arena_drain(heap, self);
+  return mempool_multiple_memalign(heap->mm_mpool[self], alignment, size);
+}
+
+/****************************************************************************
+ * Name: mm_arena_realloc
+ *
+ * Description:
+ *   Move oldmem, which must belong to one of the arenas, into a block of
+ *   the arena of the calling CPU.  NULL if oldmem is not an arena block or
+ *   no block of that size is available, oldmem is left untouched then.
+ *
+ ****************************************************************************/
+
+FAR void *mm_arena_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
+                           size_t size)
+{
+  FAR void *newmem;
+  ssize_t oldsize;
+  int index;
+
+  index = mm_arena_owner(heap, oldmem);
+  if (index < 0)
+    {
+      return NULL;
+    }
+
+  if (index == mm_arena_this())
+    {
+      return mempool_multiple_realloc(heap->mm_mpool[index], oldmem, size);
+    }
+
+  newmem = mm_arena_malloc(heap, size);
+  if (newmem != NULL)
+    {
+      oldsize = mempool_multiple_alloc_size(heap->mm_mpool[index], oldmem);
+      memcpy(newmem, oldmem, MIN(size, oldsize));
+      mm_arena_free(heap, oldmem);
+    }
+
+  return newmem;
+}
+
+/****************************************************************************
+ * Name: mm_arena_free
+ *
+ * Description:
+ *   Release a block of one of the arenas.  A block of another CPU's arena
+ *   is deferred to that CPU.
+ *
+ * Returned Value:
+ *   Zero if mem was an arena block; a negated errno value otherwise, the
+ *   caller must then free it to the heap.
+ *
+ ****************************************************************************/
+
+int mm_arena_free(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  int index;
+
+  index = mm_arena_owner(heap, mem);
+  if (index < 0)
+    {
+      return index;
+    }
+
+#ifdef CONFIG_MM_HEAP_MEMPOOL_ARENA
+  if (index != mm_arena_this())
+    {
+      mm_arena_defer(heap, index, mem);
+      return 0;
+    }
+#endif
+
+  return mempool_multiple_free(heap->mm_mpool[index], mem);
+}
+
+/****************************************************************************
+ * Name: mm_arena_size
+ *
+ * Returned Value:
+ *   The block size of mem if it belongs to one of the arenas; a negated
+ *   errno value otherwise.
+ *
+ ****************************************************************************/
+
+ssize_t mm_arena_size(FAR struct mm_heap_s *heap, FAR void *mem)
+{
+  int index;
+
+  index = mm_arena_owner(heap, mem);
+  if (index < 0)
+    {
+      return index;
+    }
+
+  return mempool_multiple_alloc_size(heap->mm_mpool[index], mem);
+}
+
+/****************************************************************************
+ * Name: mm_arena_foreach
+ ****************************************************************************/
+
+void mm_arena_foreach(FAR struct mm_heap_s *heap,
+                      mempool_multiple_foreach_t handle, FAR void *arg)
+{
+  int i;
+
+  for (i = 0; i < MM_NARENAS; i++)
+    {
+      if (heap->mm_mpool[i] != NULL)
+        {
+          mempool_multiple_foreach(heap->mm_mpool[i], handle, arg);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_arena_mallinfo
+ *
+ * Description:
+ *   The sum of the statistics of all arenas.
+ *
+ ****************************************************************************/
+
+struct mallinfo mm_arena_mallinfo(FAR struct mm_heap_s *heap)
+{
+  struct mallinfo info;
+  struct mallinfo tmp;
+  int i;
+
+  memset(&info, 0, sizeof(info));
+  mm_arena_drain_all(heap);
+
+  for (i = 0; i < MM_NARENAS; i++)
+    {
+      tmp = mempool_multiple_mallinfo(heap->mm_mpool[i]);
+      info.arena    += tmp.arena;
+      info.ordblks  += tmp.ordblks;
+      info.aordblks += tmp.aordblks;
+      info.uordblks += tmp.uordblks;
+      info.fordblks += tmp.fordblks;
+      info.mxordblk  = MAX(info.mxordblk, tmp.mxordblk);
+    }
+
+  return info;
+}
+
+/****************************************************************************
+ * Name: mm_arena_info_task
+ ****************************************************************************/
+
+struct mallinfo_task mm_arena_info_task(FAR struct mm_heap_s *heap,
+                                        FAR const struct malltask *task)
+{
+  struct mallinfo_task info =
+    {
+      0, 0
+    };
+
+  struct mallinfo_task tmp;
+  int i;
+
+  mm_arena_drain_all(heap);
+
+  for (i = 0; i < MM_NARENAS; i++)
+    {
+      tmp = mempool_multiple_info_task(heap->mm_mpool[i], task);
+      info.aordblks += tmp.aordblks;
+      info.uordblks += tmp.uordblks;
+    }
+
+  return info;
+}
+
+/****************************************************************************
+ * Name: mm_arena_memdump
+ ****************************************************************************/
+
+void mm_arena_memdump(FAR struct mm_heap_s *heap,
+                      FAR const struct mm_memdump_s *dump)
+{
+  int i;
+
+  for (i = 0; i < MM_NARENAS; i++)
+    {
+      mempool_multiple_memdump(heap->mm_mpool[i], dump);
+    }
+}
+
+#endif /* CONFIG_MM_HEAP_MEMPOOL */
@@ -141,6 +141,7 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
 
   heap->mm_curused -= nodesize;
   sched_note_heap(NOTE_HEAP_FREE, heap, mem, nodesize, heap->mm_curused);
+  MM_RUSAGE(node, -(ssize_t)nodesize);
 
   /* Check if the following node is free and, if so, merge it */
 
@@ -160,16 +161,9 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
       DEBUGASSERT(MM_PREVNODE_IS_FREE(andbeyond) &&
                   andbeyond->preceding == nextsize);
 
-      /* Remove the next node.  There must be a predecessor,
-       * but there may not be a successor node.
-       */
+      /* Remove the next node from the free list */
 
-      DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_delfreechunk(heap, next);
 
       /* Then merge the two chunks */
 
@@ -195,16 +189,9 @@ void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay)
       prevsize = MM_SIZEOF_NODE(prev);
       DEBUGASSERT(MM_NODE_IS_FREE(prev) && node->preceding == prevsize);
 
-      /* Remove the node.  There must be a predecessor, but there may
-       * not be a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
+      mm_delfreechunk(heap, prev);
 
       /* Then merge the two chunks */
 
@@ -241,14 +228,12 @@ void mm_free(FAR struct mm_heap_s *heap, FAR void *mem)
     }
 
   DEBUGASSERT(mm_heapmember(heap, mem));
+  mm_heapprof_free(mem);
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
-  if (heap->mm_mpool)
+  if (mm_arena_free(heap, mem) >= 0)
     {
-      if (mempool_multiple_free(heap->mm_mpool, mem) >= 0)
-        {
-          return;
-        }
+      return;
     }
 #endif
 
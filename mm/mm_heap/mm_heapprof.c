@@ -0,0 +1,566 @@
+/****************************************************************************
+ * mm/mm_heap/mm_heapprof.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/fs/procfs.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef CONFIG_MM_HEAPPROF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HEAPPROF_DEPTH      CONFIG_MM_HEAPPROF_DEPTH
+#define HEAPPROF_NSTACKS    CONFIG_MM_HEAPPROF_NSTACKS
+#define HEAPPROF_NSAMPLES   CONFIG_MM_HEAPPROF_NSAMPLES
+#define HEAPPROF_INTERVAL   CONFIG_MM_HEAPPROF_INTERVAL
+
+/* The longest line: four counters and one address per frame */
+
+#define HEAPPROF_LINELEN    (96 + HEAPPROF_DEPTH * 20)
+
+/* The home slot of a pointer in the table of live samples */
+
+#define HEAPPROF_HOME(mem)  \
+  ((((uintptr_t)(mem) >> 4) * 2654435761u) % HEAPPROF_NSAMPLES)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One call stack and what was sampled from it */
+
+struct heapprof_stack_s
+{
+  FAR void *pcs[HEAPPROF_DEPTH];
+  int       depth;                /* Zero for a free slot */
+  size_t    alloc_objs;           /* Sampled allocations since boot */
+  size_t    alloc_bytes;
+  size_t    inuse_objs;           /* Sampled allocations not freed yet */
+  size_t    inuse_bytes;
+};
+
+/* One sampled allocation that is still alive */
+
+struct heapprof_sample_s
+{
+  FAR void *mem;                  /* NULL for a free slot */
+  size_t    size;
+  size_t    stack;                /* Index in g_heapprof_stacks */
+};
+
+/* This structure describes one open "file" */
+
+struct heapprof_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[HEAPPROF_LINELEN];    /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                             int oflags, mode_t mode);
+static int     heapprof_close(FAR struct file *filep);
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+static int     heapprof_dup(FAR const struct file *oldp,
+                            FAR struct file *newp);
+static int     heapprof_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static spinlock_t g_heapprof_lock = SP_UNLOCKED;
+static struct heapprof_stack_s g_heapprof_stacks[HEAPPROF_NSTACKS];
+static struct heapprof_sample_s g_heapprof_samples[HEAPPROF_NSAMPLES];
+
+/* The number of live samples whose home slot is each slot.  A free checks
+ * it without the lock, so that freeing an allocation that was not sampled,
+ * the common case, costs one load.
+ */
+
+static uint8_t g_heapprof_home[HEAPPROF_NSAMPLES];
+
+/* Bytes left until the next sample on each CPU, and the state of the
+ * generator that jitters the interval.
+ */
+
+static ssize_t g_heapprof_countdown[CONFIG_SMP_NCPUS];
+static uint32_t g_heapprof_seed = 2463534242u;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct procfs_operations g_heapprof_operations =
+{
+  heapprof_open,  /* open */
+  heapprof_close, /* close */
+  heapprof_read,  /* read */
+  NULL,           /* write */
+  NULL,           /* poll */
+  heapprof_dup,   /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  heapprof_stat   /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapprof_interval
+ *
+ * Description:
+ *   The distance to the next sample, uniform in [interval / 2,
+ *   interval * 3 / 2) so that a program allocating in a fixed pattern is
+ *   not always sampled at the same spot.  Must be called with the lock
+ *   held.
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_interval(void)
+{
+  uint32_t x = g_heapprof_seed;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  g_heapprof_seed = x;
+
+  return HEAPPROF_INTERVAL / 2 + x % HEAPPROF_INTERVAL;
+}
+
+/****************************************************************************
+ * Name: heapprof_find_stack
+ *
+ * Description:
+ *   Return the slot of the call stack, taking a free one if it is new, or
+ *   -1 if the table is full.  Must be called with the lock held.
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_find_stack(FAR void **pcs, int depth)
+{
+  FAR struct heapprof_stack_s *stack;
+  uintptr_t hash = depth;
+  size_t index;
+  size_t i;
+  int j;
+
+  for (j = 0; j < depth; j++)
+    {
+      hash = (hash ^ (uintptr_t)pcs[j]) * 16777619u;
+    }
+
+  index = hash % HEAPPROF_NSTACKS;
+  for (i = 0; i < HEAPPROF_NSTACKS; i++)
+    {
+      stack = &g_heapprof_stacks[index];
+      if (stack->depth == 0)
+        {
+          memcpy(stack->pcs, pcs, depth * sizeof(FAR void *));
+          stack->depth = depth;
+          return index;
+        }
+      else if (stack->depth == depth &&
+               memcmp(stack->pcs, pcs, depth * sizeof(FAR void *)) == 0)
+        {
+          return index;
+        }
+
+      index = (index + 1) % HEAPPROF_NSTACKS;
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: heapprof_insert
+ *
+ * Description:
+ *   Remember a live sample so that its free can be charged back.  Return
+ *   false if the table is full.  Must be called with the lock held.
+ *
+ ****************************************************************************/
+
+static bool heapprof_insert(FAR void *mem, size_t size, size_t stack)
+{
+  size_t home = HEAPPROF_HOME(mem);
+  size_t index = home;
+  size_t i;
+
+  if (g_heapprof_home[home] == UINT8_MAX)
+    {
+      return false;
+    }
+
+  for (i = 0; i < HEAPPROF_NSAMPLES; i++)
+    {
+      if (g_heapprof_samples[index].mem == NULL)
+        {
+          g_heapprof_samples[index].mem   = mem;
+          g_heapprof_samples[index].size  = size;
+          g_heapprof_samples[index].stack = stack;
+          g_heapprof_home[home]++;
+          return true;
+        }
+
+      index = (index + 1) % HEAPPROF_NSAMPLES;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: heapprof_remove
+ *
+ * Description:
+ *   Forget a live sample, and move the following ones of the same probe
+ *   sequence back so that lookups never meet a hole.  Must be called with
+ *   the lock held.
+ *
+ ****************************************************************************/
+
+static void heapprof_remove(size_t index)
+{
+  size_t next = index;
+
+  g_heapprof_home[HEAPPROF_HOME(g_heapprof_samples[index].mem)]--;
+  g_heapprof_samples[index].mem = NULL;
+
+  for (; ; )
+    {
+      size_t home;
+
+      next = (next + 1) % HEAPPROF_NSAMPLES;
+      if (g_heapprof_samples[next].mem == NULL)
+        {
+          break;
+        }
+
+      /* Move it to the hole unless its home lies cyclically in
+       * (index, next], where the hole does not cut its probe sequence.
+       */
+
+      home = HEAPPROF_HOME(g_heapprof_samples[next].mem);
+      if (index <= next ? (index < home && home <= next) :
+                          (index < home || home <= next))
+        {
+          continue;
+        }
+
+      g_heapprof_samples[index] = g_heapprof_samples[next];
+      g_heapprof_samples[next].mem = NULL;
+      index = next;
+    }
+}
+
+/****************************************************************************
+ * Name: heapprof_open
+ ****************************************************************************/
+
+static int heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct heapprof_file_s *procfile;
+
+  procfile = kmm_zalloc(sizeof(struct heapprof_file_s));
+  if (procfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = procfile;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: heapprof_close
+ ****************************************************************************/
+
+static int heapprof_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: heapprof_read
+ *
+ * Description:
+ *   Print the profile in the text format of the gperftools heap profiler,
+ *   which pprof reads directly:
+ *
+ *   heap profile: <inuse objs>: <inuse bytes> [<alloc objs>: <alloc bytes>]
+ *     @ heap_v2/<interval>
+ *   <inuse objs>: <inuse bytes> [<alloc objs>: <alloc bytes>] @ <pc> ...
+ *
+ *   The numbers are those of the samples.  pprof scales them back to the
+ *   estimated totals from the interval.
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct heapprof_file_s *procfile = filep->f_priv;
+  struct heapprof_stack_s total;
+  struct heapprof_stack_s stack;
+  irqstate_t flags;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int i;
+  int j;
+
+  memset(&total, 0, sizeof(total));
+  flags = spin_lock_irqsave(&g_heapprof_lock);
+  for (i = 0; i < HEAPPROF_NSTACKS; i++)
+    {
+      total.alloc_objs  += g_heapprof_stacks[i].alloc_objs;
+      total.alloc_bytes += g_heapprof_stacks[i].alloc_bytes;
+      total.inuse_objs  += g_heapprof_stacks[i].inuse_objs;
+      total.inuse_bytes += g_heapprof_stacks[i].inuse_bytes;
+    }
+
+  spin_unlock_irqrestore(&g_heapprof_lock, flags);
+
+  offset    = filep->f_pos;
+  linesize  = procfs_snprintf(procfile->line, HEAPPROF_LINELEN,
+                              "heap profile: %zu: %zu [%zu: %zu] "
+                              "@ heap_v2/%d\n",
+                              total.inuse_objs, total.inuse_bytes,
+                              total.alloc_objs, total.alloc_bytes,
+                              HEAPPROF_INTERVAL);
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  for (i = 0; i < HEAPPROF_NSTACKS && totalsize < buflen; i++)
+    {
+      flags = spin_lock_irqsave(&g_heapprof_lock);
+      stack = g_heapprof_stacks[i];
+      spin_unlock_irqrestore(&g_heapprof_lock, flags);
+
+      if (stack.depth == 0)
+        {
+          continue;
+        }
+
+      buffer   += copysize;
+      buflen   -= copysize;
+      linesize  = procfs_snprintf(procfile->line, HEAPPROF_LINELEN,
+                                  "%zu: %zu [%zu: %zu] @",
+                                  stack.inuse_objs, stack.inuse_bytes,
+                                  stack.alloc_objs, stack.alloc_bytes);
+      for (j = 0; j < stack.depth; j++)
+        {
+          linesize += procfs_snprintf(procfile->line + linesize,
+                                      HEAPPROF_LINELEN - linesize,
+                                      " %p", stack.pcs[j]);
+        }
+
+      linesize += procfs_snprintf(procfile->line + linesize,
+                                  HEAPPROF_LINELEN - linesize, "\n");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: heapprof_dup
+ ****************************************************************************/
+
+static int heapprof_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heapprof_file_s *newattr;
+
+  newattr = kmm_malloc(sizeof(struct heapprof_file_s));
+  if (newattr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldp->f_priv, sizeof(struct heapprof_file_s));
+  newp->f_priv = newattr;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: heapprof_stat
+ ****************************************************************************/
+
+static int heapprof_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_heapprof_malloc
+ *
+ * Description:
+ *   Account an allocation of size bytes at mem.  About one allocation per
+ *   CONFIG_MM_HEAPPROF_INTERVAL bytes gets its call stack recorded, larger
+ *   ones proportionally more often.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_malloc(FAR void *mem, size_t size)
+{
+  FAR struct heapprof_stack_s *stack;
+  FAR ssize_t *countdown;
+  FAR void *pcs[HEAPPROF_DEPTH];
+  irqstate_t flags;
+  ssize_t index;
+  int depth;
+
+  if (mem == NULL || up_interrupt_context())
+    {
+      return;
+    }
+
+  countdown = &g_heapprof_countdown[this_cpu()];
+  *countdown -= size;
+  if (*countdown > 0)
+    {
+      return;
+    }
+
+  depth = sched_backtrace(_SCHED_GETTID(), pcs, HEAPPROF_DEPTH,
+                          CONFIG_MM_HEAPPROF_SKIP);
+  if (depth <= 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_heapprof_lock);
+
+  do
+    {
+      *countdown += heapprof_interval();
+    }
+  while (*countdown <= 0);
+
+  index = heapprof_find_stack(pcs, depth);
+  if (index >= 0)
+    {
+      stack = &g_heapprof_stacks[index];
+      stack->alloc_objs++;
+      stack->alloc_bytes += size;
+
+      /* Without room to follow it to its free, the sample would look
+       * leaked forever, so it only counts as allocated.
+       */
+
+      if (heapprof_insert(mem, size, index))
+        {
+          stack->inuse_objs++;
+          stack->inuse_bytes += size;
+        }
+    }
+
+  spin_unlock_irqrestore(&g_heapprof_lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_heapprof_free
+ *
+ * Description:
+ *   Charge the release of mem back to its call stack if it was sampled.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_free(FAR void *mem)
+{
+  FAR struct heapprof_sample_s *sample;
+  FAR struct heapprof_stack_s *stack;
+  size_t home = HEAPPROF_HOME(mem);
+  size_t index = home;
+  irqstate_t flags;
+  size_t i;
+
+  if (g_heapprof_home[home] == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_heapprof_lock);
+
+  for (i = 0; i < HEAPPROF_NSAMPLES; i++)
+    {
+      sample = &g_heapprof_samples[index];
+      if (sample->mem == NULL)
+        {
+          break;
+        }
+      else if (sample->mem == mem)
+        {
+          stack = &g_heapprof_stacks[sample->stack];
+          stack->inuse_objs--;
+          stack->inuse_bytes -= sample->size;
+          heapprof_remove(index);
+          break;
+        }
+
+      index = (index + 1) % HEAPPROF_NSAMPLES;
+    }
+
+  spin_unlock_irqrestore(&g_heapprof_lock, flags);
+}
+
+#endif /* CONFIG_MM_HEAPPROF */
@@ -235,7 +235,9 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 {
   FAR struct mm_heap_s *heap;
   uintptr_t             heap_adj;
+#ifndef CONFIG_MM_HEAP_BITMAP
   int                   i;
+#endif
 
   minfo("Heap: name=%s, start=%p size=%zu\n", name, heapstart, heapsize);
 
@@ -257,13 +259,17 @@ FAR struct mm_heap_s *mm_initialize(FAR const char *name,
 
   memset(heap, 0, sizeof(struct mm_heap_s));
 
-  /* Initialize the node array */
+#ifndef CONFIG_MM_HEAP_BITMAP
+  /* Initialize the node array, the bins of CONFIG_MM_HEAP_BITMAP start
+   * out empty from the memset() above.
+   */
 
   for (i = 1; i < MM_NNODES; i++)
     {
       heap->mm_nodelist[i - 1].flink = &heap->mm_nodelist[i];
       heap->mm_nodelist[i].blink     = &heap->mm_nodelist[i - 1];
     }
+#endif
 
   /* Initialize the malloc mutex to one (to support one-at-
    * a-time access to private data sets).
@@ -339,14 +345,23 @@ mm_initialize_pool(FAR const char *name,
 
   if (init != NULL && init->poolsize != NULL && init->npools != 0)
     {
+      int i;
+
+      /* One multiple mempool per arena, all of them carve their chunks
+       * out of this heap.
+       */
+
       heap->mm_threshold = init->threshold;
-      heap->mm_mpool     = mempool_multiple_init(name, init->poolsize,
-                               init->npools,
-                               (mempool_multiple_alloc_t)mempool_memalign,
-                               (mempool_multiple_alloc_size_t)mm_malloc_size,
-                               (mempool_multiple_free_t)mm_free, heap,
-                               init->chunksize, init->expandsize,
-                               init->dict_expendsize);
+      for (i = 0; i < MM_NARENAS; i++)
+        {
+          heap->mm_mpool[i] = mempool_multiple_init(name, init->poolsize,
+                              init->npools,
+                              (mempool_multiple_alloc_t)mempool_memalign,
+                              (mempool_multiple_alloc_size_t)mm_malloc_size,
+                              (mempool_multiple_free_t)mm_free, heap,
+                              init->chunksize, init->expandsize,
+                              init->dict_expendsize);
+        }
     }
 
   return heap;
@@ -372,7 +387,7 @@ void mm_uninitialize(FAR struct mm_heap_s *heap)
   int i;
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
-  mempool_multiple_deinit(heap->mm_mpool);
+  mm_arena_uninitialize(heap);
 #endif
 
   for (i = 0; i < CONFIG_MM_REGIONS; i++)
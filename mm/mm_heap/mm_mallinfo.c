@@ -69,6 +69,12 @@ static void mallinfo_handler(FAR struct mm_allocnode_s *node, FAR void *arg)
       FAR struct mm_freenode_s *fnode = (FAR void *)node;
 
       DEBUGASSERT(nodesize >= MM_MIN_CHUNK);
+#ifdef CONFIG_MM_HEAP_BITMAP
+      DEBUGASSERT(fnode->blink == NULL ||
+                  fnode->blink->flink == fnode);
+      DEBUGASSERT(fnode->flink == NULL ||
+                  fnode->flink->blink == fnode);
+#else
       DEBUGASSERT(fnode->blink->flink == fnode);
       DEBUGASSERT(MM_SIZEOF_NODE(fnode->blink) <= nodesize);
       DEBUGASSERT(fnode->flink == NULL ||
@@ -76,6 +82,7 @@ static void mallinfo_handler(FAR struct mm_allocnode_s *node, FAR void *arg)
       DEBUGASSERT(fnode->flink == NULL ||
                   MM_SIZEOF_NODE(fnode->flink) == 0 ||
                   MM_SIZEOF_NODE(fnode->flink) >= nodesize);
+#endif
 
       info->ordblks++;
       info->fordblks += nodesize;
@@ -140,7 +147,7 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
   info.usmblks = heap->mm_maxused + sizeof(struct mm_heap_s);
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
-  poolinfo = mempool_multiple_mallinfo(heap->mm_mpool);
+  poolinfo = mm_arena_mallinfo(heap);
 
   info.uordblks -= poolinfo.fordblks;
   info.fordblks += poolinfo.fordblks;
@@ -170,7 +177,7 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
     };
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
-  info = mempool_multiple_info_task(heap->mm_mpool, task);
+  info = mm_arena_info_task(heap, task);
 #endif
 
   handle.task = task;
@@ -204,6 +211,30 @@ size_t mm_heapfree(FAR struct mm_heap_s *heap)
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
 {
   FAR struct mm_freenode_s *node;
+#ifdef CONFIG_MM_HEAP_BITMAP
+  size_t largest = 0;
+  int fl;
+  int sl;
+
+  /* The largest node is in the highest non-empty bin, which is unsorted */
+
+  if (heap->mm_flbitmap == 0)
+    {
+      return 0;
+    }
+
+  fl = flsl(heap->mm_flbitmap) - 1;
+  sl = flsl(heap->mm_slbitmap[fl]) - 1;
+  for (node = heap->mm_freelist[fl][sl]; node; node = node->flink)
+    {
+      if (MM_SIZEOF_NODE(node) > largest)
+        {
+          largest = MM_SIZEOF_NODE(node);
+        }
+    }
+
+  return largest;
+#else
   for (node = heap->mm_nodelist[MM_NNODES - 1].blink; node;
        node = node->blink)
     {
@@ -215,4 +246,5 @@ size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
     }
 
   return 0;
+#endif
 }
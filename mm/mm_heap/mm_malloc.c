@@ -173,20 +173,20 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   size_t alignsize;
   size_t nodesize;
   FAR void *ret = NULL;
+#ifndef CONFIG_MM_HEAP_BITMAP
   int ndx;
+#endif
 
   /* Free the delay list first */
 
   free_delaylist(heap, false);
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
-  if (heap->mm_mpool)
+  ret = mm_arena_malloc(heap, size);
+  if (ret != NULL)
     {
-      ret = mempool_multiple_alloc(heap->mm_mpool, size);
-      if (ret != NULL)
-        {
-          return ret;
-        }
+      mm_heapprof_malloc(ret, size);
+      return ret;
     }
 #endif
 
@@ -214,6 +214,15 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 
   DEBUGVERIFY(mm_lock(heap));
 
+#ifdef CONFIG_MM_HEAP_BITMAP
+  /* Take a chunk from the first non-empty bin whose chunks all fit */
+
+  node = mm_findfreechunk(heap, alignsize);
+  if (node)
+    {
+      nodesize = MM_SIZEOF_NODE(node);
+    }
+#else
   /* Convert the request size into a nodelist index */
 
   ndx = mm_size2ndx(alignsize);
@@ -232,10 +241,11 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
           break;
         }
     }
+#endif
 
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that it must be the best fitting chunk
-   * available.
+   * available (a good fitting one with the bitmap indexed bins).
    */
 
   if (node)
@@ -244,16 +254,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Get a pointer to the next node in physical memory */
 
@@ -333,6 +336,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   if (ret)
     {
       MM_ADD_BACKTRACE(heap, node);
+      MM_RUSAGE(node, nodesize);
       ret = kasan_unpoison(ret, nodesize - MM_ALLOCNODE_OVERHEAD);
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
       memset(ret, MM_ALLOC_MAGIC, alignsize - MM_ALLOCNODE_OVERHEAD);
@@ -382,8 +386,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       mwarn("%11s%9s%9s%9s%9s%9s\n",
             "bsize", "total", "nused",
             "nfree", "nifree", "nwaiter");
-      mempool_multiple_foreach(heap->mm_mpool,
-                               mm_mempool_dump_handle, NULL);
+      mm_arena_foreach(heap, mm_mempool_dump_handle, NULL);
 #  endif
 #  ifdef CONFIG_MM_DUMP_DETAILS_ON_FAILURE
       mm_memdump(heap, &dump);
@@ -409,5 +412,6 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
 #endif
 
   DEBUGASSERT(ret == NULL || ((uintptr_t)ret) % MM_ALIGN == 0);
+  mm_heapprof_malloc(ret, size);
   return ret;
 }
@@ -46,14 +46,11 @@ size_t mm_malloc_size(FAR struct mm_heap_s *heap, FAR void *mem)
 
   flag = kasan_bypass(true);
 #ifdef CONFIG_MM_HEAP_MEMPOOL
-  if (heap->mm_mpool)
+  size = mm_arena_size(heap, mem);
+  if (size >= 0)
     {
-      size = mempool_multiple_alloc_size(heap->mm_mpool, mem);
-      if (size >= 0)
-        {
-          kasan_bypass(flag);
-          return size;
-        }
+      kasan_bypass(flag);
+      return size;
     }
 #endif
 
@@ -77,13 +77,11 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
     }
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
-  if (heap->mm_mpool)
+  node = mm_arena_memalign(heap, alignment, size);
+  if (node != NULL)
     {
-      node = mempool_multiple_memalign(heap->mm_mpool, alignment, size);
-      if (node != NULL)
-        {
-          return node;
-        }
+      mm_heapprof_malloc(node, size);
+      return node;
     }
 #endif
 
@@ -209,16 +207,9 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
           FAR struct mm_freenode_s *prev =
             (FAR struct mm_freenode_s *)((FAR char *)node - node->preceding);
 
-          /* Remove the node.  There must be a predecessor, but there may
-           * not be a successor node.
-           */
+          /* Remove the node from the free list */
 
-          DEBUGASSERT(prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           precedingsize += MM_SIZEOF_NODE(prev);
           node = (FAR struct mm_allocnode_s *)prev;
@@ -284,11 +275,14 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
   mm_unlock(heap);
 
   MM_ADD_BACKTRACE(heap, node);
+  MM_RUSAGE(node, size);
 
   alignedchunk = (uintptr_t)kasan_unpoison((FAR const void *)alignedchunk,
                                            size - MM_ALLOCNODE_OVERHEAD);
   DEBUGASSERT(alignedchunk % alignment == 0);
   minfo("Aligned %"PRIxPTR" to %"PRIxPTR", size %zu\n",
         rawchunk, alignedchunk, size);
+  mm_heapprof_malloc((FAR void *)alignedchunk,
+                     size - MM_ALLOCNODE_OVERHEAD);
   return (FAR void *)alignedchunk;
 }
@@ -151,7 +151,7 @@ static inline_function
 void memdump_info_pool(FAR struct mm_memdump_priv_s *priv,
                        FAR struct mm_heap_s *heap)
 {
-  priv->info = mempool_multiple_info_task(heap->mm_mpool, priv->dump);
+  priv->info = mm_arena_info_task(heap, priv->dump);
 }
 
 static inline_function
@@ -160,7 +160,7 @@ void memdump_dump_pool(FAR struct mm_memdump_priv_s *priv,
 {
   if (priv->info.aordblks > 0)
     {
-      mempool_multiple_memdump(heap->mm_mpool, priv->dump);
+      mm_arena_memdump(heap, priv->dump);
     }
 }
 #else
@@ -207,6 +207,12 @@ static void memdump_handler(FAR struct mm_allocnode_s *node, FAR void *arg)
       FAR struct mm_freenode_s *fnode = (FAR void *)node;
 
       DEBUGASSERT(nodesize >= MM_MIN_CHUNK);
+#ifdef CONFIG_MM_HEAP_BITMAP
+      DEBUGASSERT(fnode->blink == NULL ||
+                  fnode->blink->flink == fnode);
+      DEBUGASSERT(fnode->flink == NULL ||
+                  fnode->flink->blink == fnode);
+#else
       DEBUGASSERT(fnode->blink->flink == fnode);
       DEBUGASSERT(MM_SIZEOF_NODE(fnode->blink) <= nodesize);
       DEBUGASSERT(fnode->flink == NULL ||
@@ -214,6 +220,7 @@ static void memdump_handler(FAR struct mm_allocnode_s *node, FAR void *arg)
       DEBUGASSERT(fnode->flink == NULL ||
                   MM_SIZEOF_NODE(fnode->flink) == 0 ||
                   MM_SIZEOF_NODE(fnode->flink) >= nodesize);
+#endif
 
       priv->info.aordblks++;
       priv->info.uordblks += nodesize;
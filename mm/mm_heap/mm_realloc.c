@@ -87,15 +87,17 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   DEBUGASSERT(mm_heapmember(heap, oldmem));
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
-  if (heap->mm_mpool)
+  if (heap->mm_mpool[0])
     {
-      newmem = mempool_multiple_realloc(heap->mm_mpool, oldmem, size);
+      newmem = mm_arena_realloc(heap, oldmem, size);
       if (newmem != NULL)
         {
+          mm_heapprof_free(oldmem);
+          mm_heapprof_malloc(newmem, size);
           return newmem;
         }
       else if (size <= heap->mm_threshold ||
-               mempool_multiple_alloc_size(heap->mm_mpool, oldmem) >= 0)
+               mm_arena_size(heap, oldmem) >= 0)
         {
           newmem = mm_malloc(heap, size);
           if (newmem != NULL)
@@ -160,7 +162,11 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       /* Then return the original address */
 
       mm_unlock(heap);
+      MM_RUSAGE(oldnode, -(ssize_t)oldsize);
       MM_ADD_BACKTRACE(heap, oldnode);
+      MM_RUSAGE(oldnode, MM_SIZEOF_NODE(oldnode));
+      mm_heapprof_free(oldmem);
+      mm_heapprof_malloc(oldmem, size);
 
       return oldmem;
     }
@@ -194,57 +200,31 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size_t takeprev;
       size_t takenext;
 
-      /* Check if we can extend into the previous chunk and if the
-       * previous chunk is smaller than the next chunk.
+      /* Growing into the next chunk leaves the data where it is, while
+       * growing into the previous one means moving it down.  So take all
+       * we can from the next chunk and only the rest from the previous.
        */
 
-      if (nextsize > prevsize)
+      if (needed > nextsize)
         {
-          /* Can we get everything we need from the previous chunk? */
-
-          if (needed > prevsize)
-            {
-              /* No, take the whole previous chunk and get the
-               * rest that we need from the next chunk.
-               */
-
-              takeprev = prevsize;
-              takenext = needed - prevsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
+          /* Take the whole next chunk and get the rest that we need from
+           * the previous chunk.
+           */
 
-              takeprev = needed;
-              takenext = 0;
-            }
+          takeprev = needed - nextsize;
+          takenext = nextsize;
         }
-
-      /* Check if we can extend into the next chunk and if we still need
-       * more memory.
-       */
-
       else
         {
-          /* Can we get everything we need from the next chunk? */
+          /* Take what we need from the next chunk */
 
-          if (needed > nextsize)
-            {
-              /* No, take the whole next chunk and get the rest that we
-               * need from the previous chunk.
-               */
+          takeprev = 0;
+          takenext = needed;
+        }
 
-              takeprev = needed - nextsize;
-              takenext = nextsize;
-            }
-          else
-            {
-              /* Yes, take what we need from the previous chunk */
+      /* Uncharge the owner while its pid is still in the header */
 
-              takeprev = 0;
-              takenext = needed;
-            }
-        }
+      MM_RUSAGE(oldnode, -(ssize_t)oldsize);
 
       /* Extend into the previous free chunk */
 
@@ -253,16 +233,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         {
           FAR struct mm_allocnode_s *newnode;
 
-          /* Remove the previous node.  There must be a predecessor, but
-           * there may not be a successor node.
-           */
+          /* Remove the previous node from the free list */
 
-          DEBUGASSERT(prev && prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           /* Make sure the new previous node has enough space */
 
@@ -327,16 +300,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
           andbeyond = (FAR struct mm_allocnode_s *)
                       ((FAR char *)next + nextsize);
 
-          /* Remove the next node.  There must be a predecessor, but there
-           * may not be a successor node.
-           */
+          /* Remove the next node from the free list */
 
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
+          mm_delfreechunk(heap, next);
 
           /* Make sure the new next node has enough space */
 
@@ -392,19 +358,24 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size = MM_SIZEOF_NODE(oldnode);
       mm_unlock(heap);
       MM_ADD_BACKTRACE(heap, (FAR char *)newmem - MM_SIZEOF_ALLOCNODE);
+      MM_RUSAGE((FAR char *)newmem - MM_SIZEOF_ALLOCNODE, size);
+      mm_heapprof_free(oldmem);
 
       newmem = kasan_unpoison(newmem, size - MM_ALLOCNODE_OVERHEAD);
 
       oldmem = kasan_set_tag(oldmem, kasan_get_tag(newmem));
       if (newmem != oldmem)
         {
-          /* Now we have to move the user contents 'down' in memory.  memcpy
-           * should be safe for this.
+          /* Now we have to move the user contents 'down' in memory.  The
+           * ranges overlap when less than the old size was taken from the
+           * previous chunk.
            */
 
-          memcpy(newmem, oldmem, oldsize - MM_ALLOCNODE_OVERHEAD);
+          memmove(newmem, oldmem, oldsize - MM_ALLOCNODE_OVERHEAD);
         }
 
+      mm_heapprof_malloc(newmem, size - MM_ALLOCNODE_OVERHEAD);
+
       return newmem;
     }
 
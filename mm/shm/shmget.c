@@ -179,6 +179,36 @@ static int shm_extend(int shmid, size_t size)
 
   while (pgalloc < pgneeded && pgalloc < CONFIG_ARCH_SHM_NPAGES)
     {
+#if CONFIG_ARCH_ADDRENV_CONTIG_NPAGES > 0
+      /* Allocate an aligned run of pages that is mapped with one TLB
+       * entry, if there is room for one.
+       */
+
+      if (pgalloc % CONFIG_ARCH_ADDRENV_CONTIG_NPAGES == 0 &&
+          pgneeded - pgalloc >= CONFIG_ARCH_ADDRENV_CONTIG_NPAGES &&
+          CONFIG_ARCH_SHM_NPAGES - pgalloc >=
+          CONFIG_ARCH_ADDRENV_CONTIG_NPAGES)
+        {
+          uintptr_t paddr;
+          int i;
+
+          paddr = mm_pgalloc_align(CONFIG_ARCH_ADDRENV_CONTIG_NPAGES,
+                                   CONFIG_ARCH_ADDRENV_CONTIG_NPAGES);
+          if (paddr != 0)
+            {
+              memset((FAR void *)paddr, 0,
+                     CONFIG_ARCH_ADDRENV_CONTIG_NPAGES * MM_PGSIZE);
+
+              for (i = 0; i < CONFIG_ARCH_ADDRENV_CONTIG_NPAGES; i++)
+                {
+                  region->sr_pages[pgalloc++] = paddr + i * MM_PGSIZE;
+                }
+
+              continue;
+            }
+        }
+#endif
+
       /* Allocate one more physical page */
 
       region->sr_pages[pgalloc] = mm_pgalloc(1);
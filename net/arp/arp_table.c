@@ -63,6 +63,7 @@
 
 #include "netdev/netdev.h"
 #include "netlink/netlink.h"
+#include "utils/utils.h"
 #include "arp/arp.h"
 
 #ifdef CONFIG_NET_ARP
@@ -75,6 +76,18 @@
 #define ARP_MAXAGE_UNREACHABLE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE_UNREACHABLE)
 #define ARP_INPROGRESS_TICK MSEC2TICK(CONFIG_ARP_SEND_MAXTRIES * CONFIG_ARP_SEND_DELAYMSEC)
 
+#ifdef CONFIG_NET_ARP_HASH
+#  ifndef CONFIG_NET_ARP_MAX_ENTRIES
+#    define CONFIG_NET_ARP_MAX_ENTRIES 0
+#  endif
+
+/* NTOHL puts the host part of the address, that differs most between the
+ * entries, into the low bits.
+ */
+
+#  define ARP_HASH_KEY(ipaddr) NTOHL(ipaddr)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -91,7 +104,19 @@ struct arp_table_info_s
 
 /* The table of known address mappings */
 
+#ifdef CONFIG_NET_ARP_HASH
+NET_BUFPOOL_DECLARE(g_arp_entries, sizeof(struct arp_entry_s),
+                    CONFIG_NET_ARPTAB_SIZE, CONFIG_NET_ARP_ALLOC_ENTRIES,
+                    CONFIG_NET_ARP_MAX_ENTRIES);
+
+static DECLARE_HASHTABLE(g_arp_hash, CONFIG_NET_ARP_HASH_BITS);
+
+/* The entries in use, the most recently used first */
+
+static dq_queue_t g_arp_lru;
+#else
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+#endif
 
 static const struct ether_addr g_zero_ethaddr =
 {
@@ -158,6 +183,7 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NET_ARP_HASH
 static FAR struct arp_entry_s *
 arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 {
@@ -182,6 +208,155 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
       return e2;
     }
 }
+#endif
+
+/****************************************************************************
+ * Name: arp_search
+ *
+ * Description:
+ *   Find the ARP entry of this IP address and device, expired or not.
+ *
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_search(in_addr_t ipaddr,
+                                          FAR struct net_driver_s *dev)
+{
+  FAR struct arp_entry_s *tabptr;
+#ifdef CONFIG_NET_ARP_HASH
+  FAR hash_node_t *node;
+
+  hashtable_for_every_possible(g_arp_hash, node, ARP_HASH_KEY(ipaddr))
+    {
+      tabptr = container_of(node, struct arp_entry_s, at_hnode);
+      if (tabptr->at_dev == dev &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
+    }
+#else
+  int i;
+
+  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+    {
+      tabptr = &g_arptable[i];
+      if (tabptr->at_dev == dev && tabptr->at_ipaddr != 0 &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+        {
+          return tabptr;
+        }
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: arp_next
+ *
+ * Description:
+ *   Walk the ARP table: return the entry after tabptr, or the first one if
+ *   tabptr is NULL.  NULL is returned after the last entry.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_next(FAR struct arp_entry_s *tabptr)
+{
+#ifdef CONFIG_NET_ARP_HASH
+  FAR dq_entry_t *node;
+
+  node = tabptr == NULL ? dq_peek(&g_arp_lru) : dq_next(&tabptr->at_lnode);
+  return node != NULL ? container_of(node, struct arp_entry_s, at_lnode) :
+                        NULL;
+#else
+  tabptr = tabptr == NULL ? g_arptable : tabptr + 1;
+  return tabptr < &g_arptable[CONFIG_NET_ARPTAB_SIZE] ? tabptr : NULL;
+#endif
+}
+
+/****************************************************************************
+ * Name: arp_alloc
+ *
+ * Description:
+ *   Get an entry for a new address mapping: a free one if there is any,
+ *   else the one to be replaced.  That is the least recently used (hashed
+ *   table) or least recently updated entry, and a permanent entry only if
+ *   all entries are.  The caller tells them apart by at_ipaddr, which is
+ *   zero for a free entry.
+ *
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_entry_s *arp_alloc(void)
+{
+  FAR struct arp_entry_s *tabptr;
+#ifdef CONFIG_NET_ARP_HASH
+  FAR dq_entry_t *node;
+
+  tabptr = NET_BUFPOOL_TRYALLOC(g_arp_entries);
+  if (tabptr != NULL)
+    {
+      memset(tabptr, 0, sizeof(*tabptr));
+      return tabptr;
+    }
+
+  for (node = dq_tail(&g_arp_lru); node != NULL; node = dq_prev(node))
+    {
+      tabptr = container_of(node, struct arp_entry_s, at_lnode);
+      if ((tabptr->at_flags & ATF_PERM) == 0)
+        {
+          return tabptr;
+        }
+    }
+
+  node = dq_tail(&g_arp_lru);
+  return node != NULL ? container_of(node, struct arp_entry_s, at_lnode) :
+                        NULL;
+#else
+  int i;
+
+  tabptr = &g_arptable[0];
+  for (i = 1; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+    {
+      tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
+    }
+
+  return tabptr;
+#endif
+}
+
+/****************************************************************************
+ * Name: arp_free
+ *
+ * Description:
+ *   Drop an entry from the ARP table, with the packets that wait for it.
+ *
+ * Assumptions:
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+static void arp_free(FAR struct arp_entry_s *tabptr)
+{
+#ifdef CONFIG_NET_ARP_SEND_QUEUE
+  work_cancel_sync(LPWORK, &tabptr->at_work);
+  iob_free_queue(&tabptr->at_queue);
+#endif
+
+#ifdef CONFIG_NET_ARP_HASH
+  hashtable_delete(g_arp_hash, &tabptr->at_hnode,
+                   ARP_HASH_KEY(tabptr->at_ipaddr));
+  dq_rem(&tabptr->at_lnode, &g_arp_lru);
+  NET_BUFPOOL_FREE(g_arp_entries, tabptr);
+#else
+  memset(tabptr, 0, sizeof(*tabptr));
+#endif
+}
 
 /****************************************************************************
  * Name: arp_lookup
@@ -203,29 +378,29 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_search(ipaddr, dev);
+  if (tabptr == NULL)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_dev == dev &&
-          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-        {
-          if ((tabptr->at_flags & ATF_PERM) != 0 ||
-              clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-            {
-              return tabptr;
-            }
+      return NULL;  /* Not found */
+    }
 
-          return NULL;  /* Expired */
-        }
+  if ((tabptr->at_flags & ATF_PERM) == 0 &&
+      clock_systime_ticks() - tabptr->at_time > ARP_MAXAGE_TICK)
+    {
+      return NULL;  /* Expired */
     }
 
-  /* Not found */
+#ifdef CONFIG_NET_ARP_HASH
+  /* A use moves the entry to the front, it is the last to be replaced */
 
-  return NULL;
+  dq_rem(&tabptr->at_lnode, &g_arp_lru);
+  dq_addfirst(&tabptr->at_lnode, &g_arp_lru);
+#endif
+
+  return tabptr;
 }
 
 /****************************************************************************
@@ -295,44 +470,26 @@ static void arp_unreach_work(FAR void *param)
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr, uint8_t flags)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr;
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
   bool new_entry;
 #endif
-#if defined(CONFIG_NETLINK_ROUTE) || defined(CONFIG_NET_ARP_SEND_QUEUE)
-  bool found = false;
-#endif
-  int i;
+  bool found;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Try to find an entry to update.  If none is found, the IP -> MAC
+   * address mapping is inserted in the ARP table, replacing the oldest
+   * entry if the table is full.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_search(ipaddr, dev);
+  found  = tabptr != NULL;
+  if (!found)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
-#if defined(CONFIG_NETLINK_ROUTE) || defined(CONFIG_NET_ARP_SEND_QUEUE)
-          found = true;
-#endif
-          break;
-        }
-      else
+      tabptr = arp_alloc();
+      if (tabptr == NULL)
         {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
+          return -ENOSPC;
         }
     }
 
@@ -377,15 +534,30 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
 #endif
 
   /* Now, tabptr is the ARP table entry which we will fill with the new
-   * information.
+   * information.  A hashed entry that is in use goes to the bucket of the
+   * new address and to the front of the LRU list.
    */
 
+#ifdef CONFIG_NET_ARP_HASH
+  if (tabptr->at_dev != NULL)
+    {
+      hashtable_delete(g_arp_hash, &tabptr->at_hnode,
+                       ARP_HASH_KEY(tabptr->at_ipaddr));
+      dq_rem(&tabptr->at_lnode, &g_arp_lru);
+    }
+#endif
+
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_ipaddr = ipaddr;
   tabptr->at_time   = clock_systime_ticks();
   tabptr->at_flags  = flags;
   tabptr->at_dev    = dev;
 
+#ifdef CONFIG_NET_ARP_HASH
+  hashtable_add(g_arp_hash, &tabptr->at_hnode, ARP_HASH_KEY(ipaddr));
+  dq_addfirst(&tabptr->at_lnode, &g_arp_lru);
+#endif
+
   /* Notify the new entry */
 
 #ifdef CONFIG_NETLINK_ROUTE
@@ -573,9 +745,7 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
       netlink_neigh_notify(&arp_notify, RTM_DELNEIGH, AF_INET);
 #endif
 
-      /* Yes.. Set the IP address to zero to "delete" it */
-
-      tabptr->at_ipaddr = 0;
+      arp_free(tabptr);
       return OK;
     }
 
@@ -598,18 +768,15 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
 void arp_cleanup(FAR struct net_driver_s *dev)
 {
-  int i;
+  FAR struct arp_entry_s *tabptr;
+  FAR struct arp_entry_s *next;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (tabptr = arp_next(NULL); tabptr != NULL; tabptr = next)
     {
-      if (dev == g_arptable[i].at_dev)
+      next = arp_next(tabptr);
+      if (dev == tabptr->at_dev)
         {
-#ifdef CONFIG_NET_ARP_SEND_QUEUE
-          work_cancel_sync(LPWORK, &g_arptable[i].at_work);
-          iob_free_queue(&g_arptable[i].at_queue);
-#endif
-
-          memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
+          arp_free(tabptr);
         }
     }
 }
@@ -641,15 +808,13 @@ unsigned int arp_snapshot(FAR struct arpreq *snapshot,
   FAR struct arp_entry_s *tabptr;
   clock_t now;
   unsigned int ncopied;
-  int i;
 
   /* Copy all non-empty, non-expired entries in the ARP table. */
 
-  for (i = 0, now = clock_systime_ticks(), ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
-       i++)
+  for (tabptr = arp_next(NULL), now = clock_systime_ticks(), ncopied = 0;
+       nentries > ncopied && tabptr != NULL;
+       tabptr = arp_next(tabptr))
     {
-      tabptr = &g_arptable[i];
       if (tabptr->at_ipaddr != 0 && ((tabptr->at_flags & ATF_PERM) != 0 ||
           now - tabptr->at_time <= ARP_MAXAGE_TICK))
         {
@@ -129,6 +129,16 @@ struct can_conn_s
 #ifdef CONFIG_NET_CANPROTO_OPTIONS
   struct can_filter filters[CONFIG_NET_CAN_RAW_FILTER_MAX];
   int32_t filter_count;
+
+  /* The filters that pass one identifier only are looked up by it in
+   * filter_ids, which is sorted.  The others are in filter_masks, as
+   * indexes in filters, and are tried one by one.
+   */
+
+  canid_t  filter_ids[CONFIG_NET_CAN_RAW_FILTER_MAX];
+  uint16_t filter_masks[CONFIG_NET_CAN_RAW_FILTER_MAX];
+  int16_t  filter_nids;
+  int16_t  filter_nmasks;
 #  ifdef CONFIG_NET_CAN_ERRORS
   can_err_mask_t err_mask;
 #  endif
@@ -223,6 +233,33 @@ void can_conn_list_unlock(void);
 FAR struct can_conn_s *can_active(FAR struct net_driver_s *dev,
                                   FAR struct can_conn_s *conn);
 
+/****************************************************************************
+ * Name: can_filter_update()
+ *
+ * Description:
+ *   Rebuild the lookup of the CAN_RAW filters after conn->filters or
+ *   conn->filter_count changed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+void can_filter_update(FAR struct can_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: can_hwfilter_update()
+ *
+ * Description:
+ *   Pass the union of the filters of the sockets that receive from dev to
+ *   its driver, after they changed.  If dev is NULL, do it for all CAN
+ *   devices.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+void can_hwfilter_update(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: can_callback
  *
@@ -107,6 +107,7 @@ FAR struct can_conn_s *can_alloc(void)
        */
 
       conn->filter_count = 1;
+      can_filter_update(conn);
 #endif
 
       /* Enqueue the connection into the active list */
@@ -168,6 +169,63 @@ void can_free(FAR struct can_conn_s *conn)
   NET_BUFPOOL_UNLOCK(g_can_connections);
 }
 
+/****************************************************************************
+ * Name: can_filter_match
+ *
+ * Description:
+ *   Whether the CAN identifier id passes one filter.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+static bool can_filter_match(FAR const struct can_filter *filter,
+                             canid_t id)
+{
+  if (filter->can_id & CAN_INV_FILTER)
+    {
+      return (id & filter->can_mask) !=
+             ((filter->can_id & ~CAN_INV_FILTER) & filter->can_mask);
+    }
+  else
+    {
+      return (id & filter->can_mask) ==
+             (filter->can_id & filter->can_mask);
+    }
+}
+
+/****************************************************************************
+ * Name: can_filter_exact
+ *
+ * Description:
+ *   Whether a filter passes the identifier *id of a data or remote frame
+ *   only.  That is when the mask covers the flags and all identifier bits
+ *   of its frame format and the other masked bits are zero.
+ *
+ ****************************************************************************/
+
+static bool can_filter_exact(FAR const struct can_filter *filter,
+                             FAR canid_t *id)
+{
+  canid_t bits;
+
+  if (filter->can_id & CAN_INV_FILTER)
+    {
+      return false;
+    }
+
+  bits = CAN_EFF_FLAG | CAN_RTR_FLAG |
+         ((filter->can_id & CAN_EFF_FLAG) ? CAN_EFF_MASK : CAN_SFF_MASK);
+
+  if ((filter->can_mask & bits) != bits ||
+      (filter->can_id & filter->can_mask & ~bits) != 0)
+    {
+      return false;
+    }
+
+  *id = filter->can_id & bits;
+  return true;
+}
+
 /****************************************************************************
  * Name: can_recv_filter
  *
@@ -182,38 +240,59 @@ void can_free(FAR struct can_conn_s *conn)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_CANPROTO_OPTIONS
 static int can_recv_filter(FAR struct can_conn_s *conn, canid_t id)
 {
-  uint32_t i;
+  int low;
+  int high;
+  int mid;
+  int i;
 
-#ifdef CONFIG_NET_CAN_ERRORS
   /* error message frame */
 
   if ((id & CAN_ERR_FLAG) != 0)
     {
+#ifdef CONFIG_NET_CAN_ERRORS
       return id & conn->err_mask ? 1 : 0;
-    }
-#endif
+#else
+      /* The identifier lookup does not cover it, try all filters */
 
-  for (i = 0; i < conn->filter_count; i++)
-    {
-      if (conn->filters[i].can_id & CAN_INV_FILTER)
+      for (i = 0; i < conn->filter_count; i++)
         {
-          if ((id & conn->filters[i].can_mask) !=
-                ((conn->filters[i].can_id & ~CAN_INV_FILTER) &
-                 conn->filters[i].can_mask))
+          if (can_filter_match(&conn->filters[i], id))
             {
               return 1;
             }
         }
+
+      return 0;
+#endif
+    }
+
+  low  = 0;
+  high = conn->filter_nids - 1;
+
+  while (low <= high)
+    {
+      mid = (low + high) / 2;
+      if (conn->filter_ids[mid] == id)
+        {
+          return 1;
+        }
+      else if (conn->filter_ids[mid] < id)
+        {
+          low = mid + 1;
+        }
       else
         {
-          if ((id & conn->filters[i].can_mask) ==
-                (conn->filters[i].can_id & conn->filters[i].can_mask))
-            {
-              return 1;
-            }
+          high = mid - 1;
+        }
+    }
+
+  for (i = 0; i < conn->filter_nmasks; i++)
+    {
+      if (can_filter_match(&conn->filters[conn->filter_masks[i]], id))
+        {
+          return 1;
         }
     }
 
@@ -221,6 +300,46 @@ static int can_recv_filter(FAR struct can_conn_s *conn, canid_t id)
 }
 #endif
 
+/****************************************************************************
+ * Name: can_filter_update()
+ *
+ * Description:
+ *   Rebuild the lookup of the CAN_RAW filters after conn->filters or
+ *   conn->filter_count changed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CANPROTO_OPTIONS
+void can_filter_update(FAR struct can_conn_s *conn)
+{
+  canid_t id;
+  int i;
+  int j;
+
+  conn->filter_nids   = 0;
+  conn->filter_nmasks = 0;
+
+  for (i = 0; i < conn->filter_count; i++)
+    {
+      if (!can_filter_exact(&conn->filters[i], &id))
+        {
+          conn->filter_masks[conn->filter_nmasks++] = i;
+          continue;
+        }
+
+      /* Insertion sort, there are few filters and they rarely change */
+
+      for (j = conn->filter_nids++; j > 0 && conn->filter_ids[j - 1] > id;
+           j--)
+        {
+          conn->filter_ids[j] = conn->filter_ids[j - 1];
+        }
+
+      conn->filter_ids[j] = id;
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: can_nextconn()
  *
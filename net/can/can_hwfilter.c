@@ -0,0 +1,160 @@
+/****************************************************************************
+ * net/can/can_hwfilter.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+
+#include <nuttx/can.h>
+#include <nuttx/mutex.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "can/can.h"
+
+#ifdef CONFIG_NET_CAN_HWFILTER
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The union of the filters of a device being built */
+
+static struct can_filter g_can_hwfilters[CONFIG_NET_CAN_HWFILTER_MAX];
+static mutex_t g_can_hwfilter_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_hwfilter_collect
+ *
+ * Description:
+ *   Copy the filters of the sockets that receive from dev, return their
+ *   number or 0 if the device must pass all frames.
+ *
+ ****************************************************************************/
+
+static int can_hwfilter_collect(FAR struct net_driver_s *dev)
+{
+  FAR struct can_conn_s *conn = NULL;
+  int nfilters = 0;
+  int i;
+
+  can_conn_list_lock();
+
+  while ((conn = can_nextconn(conn)) != NULL)
+    {
+      if (conn->dev != NULL && conn->dev != dev)
+        {
+          continue;
+        }
+
+      for (i = 0; i < conn->filter_count; i++)
+        {
+          /* An inverted filter passes nearly everything */
+
+          if ((conn->filters[i].can_id & CAN_INV_FILTER) != 0 ||
+              nfilters >= CONFIG_NET_CAN_HWFILTER_MAX)
+            {
+              can_conn_list_unlock();
+              return 0;
+            }
+
+          g_can_hwfilters[nfilters++] = conn->filters[i];
+        }
+    }
+
+  can_conn_list_unlock();
+  return nfilters;
+}
+
+/****************************************************************************
+ * Name: can_hwfilter_dev
+ ****************************************************************************/
+
+static int can_hwfilter_dev(FAR struct net_driver_s *dev, FAR void *arg)
+{
+  int nfilters;
+  int ret;
+
+  UNUSED(arg);
+
+  if (dev->d_lltype != NET_LL_CAN || dev->d_canfilter == NULL)
+    {
+      return 0;
+    }
+
+  nxmutex_lock(&g_can_hwfilter_lock);
+
+  /* The connection list is not held while the device is locked, the input
+   * path takes them the other way round.
+   */
+
+  nfilters = can_hwfilter_collect(dev);
+
+  netdev_lock(dev);
+  ret = dev->d_canfilter(dev, g_can_hwfilters, nfilters);
+  if (ret < 0 && nfilters > 0)
+    {
+      nwarn("WARNING: %s cannot filter, receiving all frames: %d\n",
+            dev->d_ifname, ret);
+      dev->d_canfilter(dev, NULL, 0);
+    }
+
+  netdev_unlock(dev);
+  nxmutex_unlock(&g_can_hwfilter_lock);
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: can_hwfilter_update()
+ *
+ * Description:
+ *   Pass the union of the filters of the sockets that receive from dev to
+ *   its driver, after they changed.  If dev is NULL, do it for all CAN
+ *   devices.
+ *
+ ****************************************************************************/
+
+void can_hwfilter_update(FAR struct net_driver_s *dev)
+{
+  if (dev != NULL)
+    {
+      can_hwfilter_dev(dev, NULL);
+    }
+  else
+    {
+      netdev_foreach(can_hwfilter_dev, NULL);
+    }
+}
+
+#endif /* CONFIG_NET_CAN_HWFILTER */
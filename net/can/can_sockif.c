@@ -345,6 +345,12 @@ static int can_bind(FAR struct socket *psock,
   conn->dev = netdev_findbyname((const char *)&netdev_name);
 #endif
 
+#ifdef CONFIG_NET_CAN_HWFILTER
+  /* The socket no longer receives from the other devices */
+
+  can_hwfilter_update(NULL);
+#endif
+
   return conn->dev == NULL && canaddr->can_ifindex != 0 ? -ENODEV : OK;
 }
 
@@ -515,6 +521,9 @@ errout_with_lock:
 static int can_close(FAR struct socket *psock)
 {
   FAR struct can_conn_s *conn = psock->s_conn;
+#ifdef CONFIG_NET_CAN_HWFILTER
+  FAR struct net_driver_s *dev;
+#endif
   int ret = OK;
 
   /* Perform some pre-close operations for the CAN socket type. */
@@ -539,9 +548,16 @@ static int can_close(FAR struct socket *psock)
 
       /* Free the connection structure */
 
+#ifdef CONFIG_NET_CAN_HWFILTER
+      dev = conn->dev;
+#endif
       conn->crefs = 0;
       can_free(psock->s_conn);
 
+#ifdef CONFIG_NET_CAN_HWFILTER
+      can_hwfilter_update(dev);
+#endif
+
       if (ret < 0)
         {
           /* Return with error code, but free resources. */
@@ -485,6 +485,25 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *buf,
                    unsigned int target_offset);
 #endif
 
+/****************************************************************************
+ * Name: devif_iob_refsend
+ *
+ * Description:
+ *   Like devif_iob_send(), but reference the data in place behind the
+ *   headers.  This only works if the data is in one I/O buffer of the
+ *   chain, the caller falls back to devif_iob_send() otherwise.
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_ALLOC
+int devif_iob_refsend(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
+                      unsigned int len, unsigned int offset,
+                      unsigned int target_offset);
+#endif
+
 /****************************************************************************
  * Name: devif_file_send
  *
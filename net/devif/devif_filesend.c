@@ -31,12 +31,112 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <sys/stat.h>
+
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netdev.h>
 
 #ifdef CONFIG_MM_IOB
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+/****************************************************************************
+ * Name: devif_file_release
+ *
+ * Description:
+ *   Release callback of an I/O buffer referencing memory mapped file data.
+ *   The data belongs to the file system image, so there is nothing to free.
+ *
+ ****************************************************************************/
+
+static void devif_file_release(FAR void *data)
+{
+}
+
+/****************************************************************************
+ * Name: devif_file_xipsend
+ *
+ * Description:
+ *   Link an I/O buffer that references the file data in place behind the
+ *   headers, instead of copying the data.  This only works if the file is
+ *   memory mapped (FIOC_XIPBASE).
+ *
+ * Returned Value:
+ *   The number of bytes to send on success.  A negated errno value if the
+ *   file cannot be sent this way; the caller falls back to copying.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int devif_file_xipsend(FAR struct net_driver_s *dev,
+                              FAR struct file *file, unsigned int len,
+                              unsigned int offset,
+                              unsigned int target_offset)
+{
+  FAR struct iob_s *iob;
+  FAR struct iob_s *tail;
+  struct stat st;
+  uintptr_t xipbase;
+  int ret;
+
+  ret = file_ioctl(file, FIOC_XIPBASE, (unsigned long)((uintptr_t)&xipbase));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_fstat(file, &st);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (len > UINT16_MAX || offset > st.st_size || len > st.st_size - offset)
+    {
+      return -EINVAL;
+    }
+
+  if (netdev_iob_prepare(dev, false, 0) != OK)
+    {
+      return -ENOMEM;
+    }
+
+  iob = iob_alloc_with_data((FAR uint8_t *)xipbase + offset, len,
+                            devif_file_release);
+  if (iob == NULL)
+    {
+      netdev_iob_release(dev);
+      return -ENOMEM;
+    }
+
+  iob->io_len = len;
+
+  /* Keep only the header room in the device buffer and append the data */
+
+  iob_update_pktlen(dev->d_iob, target_offset, false);
+  for (tail = dev->d_iob; tail->io_flink != NULL; tail = tail->io_flink);
+  tail->io_flink = iob;
+  dev->d_iob->io_pktlen = target_offset + len;
+
+  /* Leave the file position where a read of the data would leave it */
+
+  file_seek(file, offset + len, SEEK_SET);
+
+  dev->d_sndlen = len;
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumiob = NULL;
+#endif
+  return len;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -85,6 +185,16 @@ int devif_file_send(FAR struct net_driver_s *dev, FAR struct file *file,
     }
 #endif
 
+#ifdef CONFIG_NET_SENDFILE_ZEROCOPY
+  /* Reference memory mapped file data in place if possible */
+
+  ret = devif_file_xipsend(dev, file, len, offset, target_offset);
+  if (ret >= 0)
+    {
+      return ret;
+    }
+#endif
+
   /* Append the send buffer after device buffer */
 
   if (len > iob_navail(false) * CONFIG_IOB_BUFSIZE ||
@@ -147,6 +257,9 @@ int devif_file_send(FAR struct net_driver_s *dev, FAR struct file *file,
   iob_update_pktlen(dev->d_iob, target_offset + len, false);
 
   dev->d_sndlen = len;
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumiob = NULL;
+#endif
   return len;
 
 errout:
@@ -36,6 +36,25 @@
 
 #ifdef CONFIG_MM_IOB
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_ALLOC
+/****************************************************************************
+ * Name: devif_iob_refrelease
+ *
+ * Description:
+ *   Release callback of an I/O buffer referencing the data of another one,
+ *   the data stays with its owner.
+ *
+ ****************************************************************************/
+
+static void devif_iob_refrelease(FAR void *data)
+{
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -74,7 +93,8 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
     }
 
 #ifndef CONFIG_NET_IPFRAG
-  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset &&
+      !NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TSO))
     {
       ret = -EMSGSIZE;
       goto errout;
@@ -100,6 +120,9 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
     }
 
   dev->d_sndlen = len;
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumiob = NULL;
+#endif
 
 #ifdef CONFIG_NET_TCP_WRBUFFER_DUMP
   /* Dump the outgoing device buffer */
@@ -114,4 +137,74 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: devif_iob_refsend
+ *
+ * Description:
+ *   Like devif_iob_send(), but link an I/O buffer that references the data
+ *   in place behind the headers instead of copying it.  The data must not
+ *   change or go away while the driver may still be sending it.
+ *
+ * Returned Value:
+ *   The number of bytes to send on success.  -EINVAL if the data is not
+ *   in one I/O buffer of the chain, or another negated errno value; the
+ *   caller falls back to devif_iob_send().
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_ALLOC
+int devif_iob_refsend(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
+                      unsigned int len, unsigned int offset,
+                      unsigned int target_offset)
+{
+  FAR struct iob_s *ref;
+  FAR struct iob_s *tail;
+
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  if (dev == NULL || dev->d_iob == NULL || iob == NULL || len == 0 ||
+      len > iob->io_len - offset)
+    {
+      return -EINVAL;
+    }
+
+#ifndef CONFIG_NET_IPFRAG
+  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset &&
+      !NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TSO))
+    {
+      return -EMSGSIZE;
+    }
+#endif
+
+  ref = iob_alloc_with_data(IOB_DATA(iob) + offset, len,
+                            devif_iob_refrelease);
+  if (ref == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ref->io_len = len;
+
+  /* Keep only the header room in the device buffer and append the data */
+
+  iob_update_pktlen(dev->d_iob, target_offset, false);
+  for (tail = dev->d_iob; tail->io_flink != NULL; tail = tail->io_flink);
+  tail->io_flink = ref;
+  dev->d_iob->io_pktlen = target_offset + len;
+
+  dev->d_sndlen = len;
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumiob = NULL;
+#endif
+  return len;
+}
+#endif
+
 #endif /* CONFIG_MM_IOB */
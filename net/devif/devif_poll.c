@@ -656,6 +656,25 @@ devif_poll_tcp_connections(FAR struct net_driver_s *dev,
 {
   FAR struct tcp_conn_s *conn  = NULL;
   int bstop = 0;
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+  int npending;
+
+  /* Only visit the connections that asked for this poll.  A connection
+   * that queues itself again while it is polled waits for the next poll.
+   */
+
+  tcp_conn_list_lock();
+  npending = tcp_npending();
+  while (!bstop && npending-- > 0 && (conn = tcp_nextpending(dev)))
+    {
+      tcp_poll(dev, conn);
+      devif_packet_conversion(dev, DEVIF_TCP);
+      bstop = devif_poll_local_out(dev, callback);
+    }
+
+  tcp_conn_list_unlock();
+  return bstop;
+#else
 
   /* Traverse all of the active TCP connections and perform the poll action */
 
@@ -682,6 +701,7 @@ devif_poll_tcp_connections(FAR struct net_driver_s *dev,
 
   tcp_conn_list_unlock();
   return bstop;
+#endif
 }
 #else
 #  define devif_poll_tcp_connections(dev, callback) (0)
@@ -48,10 +48,68 @@
 #include <debug.h>
 #include <errno.h>
 
+#include <nuttx/nuttx.h>
 #include <nuttx/net/netdev.h>
 
 #include "devif/devif.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: devif_send_chksum
+ *
+ * Description:
+ *   Copy the application data into the device buffer and sum it in the
+ *   same pass.  The sum is kept in the device for the upper layer checksum
+ *   so that the data is read only once.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+static int devif_send_chksum(FAR struct net_driver_s *dev,
+                             FAR const uint8_t *buf, int len, int offset)
+{
+  FAR struct iob_s *iob;
+  unsigned int skip = offset;
+  unsigned int ncopy;
+  uint16_t sum = 0;
+  bool odd = false;
+  int remain = len;
+
+  if (iob_update_pktlen(dev->d_iob, offset + len, false) != offset + len)
+    {
+      return -ENOMEM;
+    }
+
+  iob = dev->d_iob;
+  while (iob != NULL && skip >= iob->io_len)
+    {
+      skip -= iob->io_len;
+      iob   = iob->io_flink;
+    }
+
+  while (iob != NULL && remain > 0)
+    {
+      ncopy   = MIN(iob->io_len - skip, remain);
+      sum     = chksum_copy(sum, iob->io_data + iob->io_offset + skip, buf,
+                            ncopy, &odd);
+      buf    += ncopy;
+      remain -= ncopy;
+      skip    = 0;
+      iob     = iob->io_flink;
+    }
+
+  DEBUGASSERT(remain == 0);
+
+  dev->d_sndsumiob = dev->d_iob;
+  dev->d_sndsumoff = offset;
+  dev->d_sndsum    = sum;
+  return len;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -106,7 +164,18 @@ int devif_send(FAR struct net_driver_s *dev, FAR const void *buf,
 
   iob_update_pktlen(dev->d_iob, offset < 0 ? 0 : offset, false);
 
-  ret = iob_trycopyin(dev->d_iob, buf, len, offset, false);
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumiob = NULL;
+  if (offset >= 0)
+    {
+      ret = devif_send_chksum(dev, buf, len, offset);
+    }
+  else
+#endif
+    {
+      ret = iob_trycopyin(dev->d_iob, buf, len, offset, false);
+    }
+
   if (ret != len)
     {
       netdev_iob_release(dev);
@@ -94,6 +94,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/tracepoint.h>
 
 #include "arp/arp.h"
 #include "inet/inet.h"
@@ -388,7 +389,7 @@ static int ipv4_in(FAR struct net_driver_s *dev)
 #endif
 
 #ifdef CONFIG_NET_IPV4_CHECKSUMS
-  if (ipv4_chksum(IPv4BUF) != 0xffff)
+  if (!NETDEV_RXCSUM_OK(dev) && ipv4_chksum(IPv4BUF) != 0xffff)
     {
       /* Compute and check the IP header checksum. */
 
@@ -514,6 +515,9 @@ int ipv4_input(FAR struct net_driver_s *dev)
   FAR uint8_t *buf;
   int ret;
 
+  tracepoint(NET_INPUT, NOTE_TAG_NET, "ipv4 %s %u", dev->d_ifname,
+             dev->d_len);
+
   netdev_lock(dev);
 
   /* Store reception timestamp if enabled and not provided by hardware. */
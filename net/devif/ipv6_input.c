@@ -39,6 +39,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/tracepoint.h>
 #include <nuttx/net/ipv6ext.h>
 
 #include "neighbor/neighbor.h"
@@ -677,6 +678,9 @@ int ipv6_input(FAR struct net_driver_s *dev)
   FAR uint8_t *buf;
   int ret;
 
+  tracepoint(NET_INPUT, NOTE_TAG_NET, "ipv6 %s %u", dev->d_ifname,
+             dev->d_len);
+
   netdev_lock(dev);
 
   /* Store reception timestamp if enabled and not provided by hardware. */
@@ -206,7 +206,7 @@ FAR struct igmp_group_s *igmp_grpallocfind(FAR struct net_driver_s *dev,
  *   Release a previously allocated group.
  *
  * Assumptions:
- *   The network is locked.
+ *   The caller may hold the device lock.
  *
  ****************************************************************************/
 
@@ -222,13 +222,15 @@ void igmp_grpfree(FAR struct net_driver_s *dev,
 
   wd_cancel(&group->wdog);
 
-  /* Cancel the workqueue */
+  /* Cancel the workqueue.  The work takes the device lock to send its
+   * report, so release the device lock while waiting for it to finish.
+   */
 
-  blresult = net_breaklock(&count);
+  blresult = nxrmutex_breaklock(&dev->d_lock, &count);
   work_cancel_sync(LPWORK, &group->work);
   if (blresult >= 0)
     {
-      net_restorelock(count);
+      nxrmutex_restorelock(&dev->d_lock, count);
     }
 
   /* Remove the group structure from the group list in the device structure */
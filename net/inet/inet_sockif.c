@@ -28,6 +28,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <net/net_tstamp.h>
 #include <stdbool.h>
 #include <assert.h>
 #include <errno.h>
@@ -736,6 +737,27 @@ static int inet_get_socketlevel_option(FAR struct socket *psock, int option,
         break;
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+      case SO_TIMESTAMPING:
+        {
+          if (*value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type == SOCK_DGRAM)
+            {
+              FAR struct udp_conn_s *conn = psock->s_conn;
+              *(FAR int *)value = conn->timestamping;
+            }
+          else
+            {
+              return -ENOPROTOOPT;
+            }
+        }
+        break;
+#endif
+
       default:
         return -ENOPROTOOPT;
     }
@@ -783,6 +805,11 @@ static int inet_getsockopt(FAR struct socket *psock, int level, int option,
         return tcp_getsockopt(psock, option, value, value_len);
 #endif
 
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+      case IPPROTO_UDP:
+        return udp_getsockopt(psock, option, value, value_len);
+#endif
+
 #ifdef CONFIG_NET_IPv4
       case IPPROTO_IP:/* IPv4 protocol socket options (see include/netinet/in.h) */
         return ipv4_getsockopt(psock, option, value, value_len);
@@ -932,6 +959,9 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
               /* Save the receive buffer size */
 
               tcp->rcv_bufs = buffersize;
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+              tcp->at_flags |= TCP_AUTOTUNE_RCVLOCK;
+#endif
             }
           else
 #endif
@@ -993,6 +1023,9 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
               /* Save the send buffer size */
 
               tcp->snd_bufs = buffersize;
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+              tcp->at_flags |= TCP_AUTOTUNE_SNDLOCK;
+#endif
             }
           else
 #endif
@@ -1030,9 +1063,8 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
             {
               conn_lock(psock->s_conn);
 
-              /* For now the timestamp enable is just boolean.
-               * If SO_TIMESTAMPING support is added in future, it can be
-               * expanded to flags field for rx/tx timestamps.
+              /* The timestamp enable is just boolean, the flags of the
+               * hardware timestamps are set with SO_TIMESTAMPING.
                */
 
               FAR struct udp_conn_s *conn = psock->s_conn;
@@ -1049,6 +1081,36 @@ static int inet_set_socketlevel_option(FAR struct socket *psock, int option,
         break;
   #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+      case SO_TIMESTAMPING: /* Report hardware receive timestamps as cmsg */
+        {
+          FAR struct udp_conn_s *conn = psock->s_conn;
+          int flags;
+
+          if (value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          if (psock->s_type != SOCK_DGRAM)
+            {
+              return -ENOPROTOOPT;
+            }
+
+          flags = *(FAR const int *)value;
+          if ((flags & (SOF_TIMESTAMPING_TX_HARDWARE |
+                        SOF_TIMESTAMPING_TX_SOFTWARE)) != 0)
+            {
+              return -EOPNOTSUPP;
+            }
+
+          conn_lock(psock->s_conn);
+          conn->timestamping = flags;
+          conn_unlock(psock->s_conn);
+        }
+        break;
+#endif
+
       default:
         return -ENOPROTOOPT;
     }
@@ -1171,7 +1233,7 @@ static int inet_listen(FAR struct socket *psock, int backlog)
 
           conn->lport = tcp_selectport(PF_INET,
                                 (FAR const union ip_addr_u *)
-                                &conn->u.ipv4.laddr, 0);
+                                &conn->u.ipv4.laddr, 0, 0);
         }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -1186,7 +1248,7 @@ static int inet_listen(FAR struct socket *psock, int backlog)
 
           conn->lport = tcp_selectport(PF_INET6,
                                 (FAR const union ip_addr_u *)
-                                conn->u.ipv6.laddr, 0);
+                                conn->u.ipv6.laddr, 0, 0);
         }
 #endif /* CONFIG_NET_IPv6 */
     }
@@ -1884,6 +1946,42 @@ static ssize_t inet_sendmsg(FAR struct socket *psock,
     }
 
   end = &msg->msg_iov[msg->msg_iovlen];
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* The vectors cannot be gathered into a temporary buffer if they are
+   * referenced until the send completes.  Each one is sent in place as a
+   * MSG_ZEROCOPY send of its own.
+   */
+
+  if ((flags & MSG_ZEROCOPY) != 0 && psock->s_type == SOCK_STREAM)
+    {
+      ssize_t nsent = 0;
+      ssize_t n;
+
+      for (iov = msg->msg_iov; iov != end; iov++)
+        {
+          if (iov->iov_len == 0)
+            {
+              continue;
+            }
+
+          n = inet_send(psock, iov->iov_base, iov->iov_len, flags);
+          if (n < 0)
+            {
+              return nsent > 0 ? nsent : n;
+            }
+
+          nsent += n;
+          if ((size_t)n < iov->iov_len)
+            {
+              break;
+            }
+        }
+
+      return nsent;
+    }
+#endif
+
   for (len = 0, iov = msg->msg_iov; iov != end; iov++)
     {
       len += iov->iov_len;
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <debug.h>
+#include <string.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/icmpv6.h>
@@ -65,15 +66,104 @@
 #define IPv6_L4HDR(ipv6, proto) \
   ((FAR void *)(net_ipv6_payload((FAR struct ipv6_hdr_s *)(ipv6), &(proto))))
 
+#define IPFILTER_FLOWCACHE CONFIG_NET_IPFILTER_FLOWCACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The rules of a chain are also split by the protocol of the packets they
+ * may match, so that a packet is only compared with the rules of its own
+ * class.  Each class keeps the rules in the order of the chain.
+ */
+
+enum ipfilter_class_e
+{
+  IPFILTER_CLASS_TCP = 0,
+  IPFILTER_CLASS_UDP,
+  IPFILTER_CLASS_ICMP,              /* ICMP or ICMPv6 */
+  IPFILTER_CLASS_OTHER,
+  IPFILTER_CLASS_MAX
+};
+
+struct ipfilter_index_s
+{
+  FAR struct ipfilter_entry_s **rules[IPFILTER_CLASS_MAX];
+  unsigned int nrules[IPFILTER_CLASS_MAX];
+  unsigned int size[IPFILTER_CLASS_MAX];
+  bool invalid;                     /* Out of memory, walk the whole chain */
+};
+
+/* The filter is stateless, so the target of a packet only depends on the
+ * fields below: the targets of the recent flows are cached, until the
+ * rules change.
+ */
+
+#if IPFILTER_FLOWCACHE > 0
+#ifdef CONFIG_NET_IPv4
+struct ipv4_flow_s
+{
+  FAR const struct net_driver_s *indev;
+  FAR const struct net_driver_s *outdev;
+  in_addr_t srcip;
+  in_addr_t dstip;
+  uint16_t  sport;                  /* Or the ICMP type */
+  uint16_t  dport;
+  uint8_t   proto;
+  uint8_t   chain;
+};
+
+struct ipv4_flowcache_s
+{
+  struct ipv4_flow_s flow;
+  uint32_t gen;                     /* g_ipfilter_gen when it was cached */
+  int8_t   target;
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+struct ipv6_flow_s
+{
+  FAR const struct net_driver_s *indev;
+  FAR const struct net_driver_s *outdev;
+  net_ipv6addr_t srcip;
+  net_ipv6addr_t dstip;
+  uint16_t  sport;                  /* Or the ICMPv6 type */
+  uint16_t  dport;
+  uint8_t   proto;
+  uint8_t   chain;
+};
+
+struct ipv6_flowcache_s
+{
+  struct ipv6_flow_s flow;
+  uint32_t gen;                     /* g_ipfilter_gen when it was cached */
+  int8_t   target;
+};
+#endif
+#endif /* IPFILTER_FLOWCACHE > 0 */
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
 static sq_queue_t g_ipv4_filters[IPFILTER_CHAIN_MAX];
+static struct ipfilter_index_s g_ipv4_index[IPFILTER_CHAIN_MAX];
 #endif
 #ifdef CONFIG_NET_IPv6
 static sq_queue_t g_ipv6_filters[IPFILTER_CHAIN_MAX];
+static struct ipfilter_index_s g_ipv6_index[IPFILTER_CHAIN_MAX];
+#endif
+
+#if IPFILTER_FLOWCACHE > 0
+static uint32_t g_ipfilter_gen = 1;
+#  ifdef CONFIG_NET_IPv4
+static struct ipv4_flowcache_s g_ipv4_flowcache[IPFILTER_FLOWCACHE];
+#  endif
+#  ifdef CONFIG_NET_IPv6
+static struct ipv6_flowcache_s g_ipv6_flowcache[IPFILTER_FLOWCACHE];
+#  endif
 #endif
 
 /****************************************************************************
@@ -188,6 +278,369 @@ static bool ipfilter_match_proto(FAR const struct ipfilter_entry_s *entry,
     }
 }
 
+/****************************************************************************
+ * Name: ipfilter_class
+ *
+ * Description:
+ *   The class of the packets of a protocol.
+ *
+ ****************************************************************************/
+
+static int ipfilter_class(uint8_t proto)
+{
+  switch (proto)
+    {
+      case IP_PROTO_TCP:
+        return IPFILTER_CLASS_TCP;
+
+      case IP_PROTO_UDP:
+        return IPFILTER_CLASS_UDP;
+
+      case IP_PROTO_ICMP:
+      case IP_PROTO_ICMP6:
+        return IPFILTER_CLASS_ICMP;
+
+      default:
+        return IPFILTER_CLASS_OTHER;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_add
+ *
+ * Description:
+ *   Append an entry to the classes of the packets it may match.  If memory
+ *   runs out, the index is given up until the chain is cleared.
+ *
+ ****************************************************************************/
+
+static void ipfilter_index_add(FAR struct ipfilter_index_s *index,
+                               FAR struct ipfilter_entry_s *entry)
+{
+  FAR struct ipfilter_entry_s **rules;
+  unsigned int size;
+  int cls = ipfilter_class(entry->proto);
+  int i;
+
+  if (index->invalid)
+    {
+      return;
+    }
+
+  for (i = 0; i < IPFILTER_CLASS_MAX; i++)
+    {
+      /* A negated protocol matches the other classes, and the other
+       * protocols of its own class if that is IPFILTER_CLASS_OTHER.
+       */
+
+      if (entry->proto != 0 &&
+          (entry->inv_proto ? cls == i && i != IPFILTER_CLASS_OTHER :
+                              cls != i))
+        {
+          continue;
+        }
+
+      if (index->nrules[i] == index->size[i])
+        {
+          size  = index->size[i] ? index->size[i] * 2 : 8;
+          rules = kmm_realloc(index->rules[i], size * sizeof(*rules));
+          if (rules == NULL)
+            {
+              nwarn("WARNING: No memory for the filter index\n");
+              index->invalid = true;
+              return;
+            }
+
+          index->rules[i] = rules;
+          index->size[i]  = size;
+        }
+
+      index->rules[i][index->nrules[i]++] = entry;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_index_clear
+ ****************************************************************************/
+
+static void ipfilter_index_clear(FAR struct ipfilter_index_s *index)
+{
+  int i;
+
+  for (i = 0; i < IPFILTER_CLASS_MAX; i++)
+    {
+      kmm_free(index->rules[i]);
+    }
+
+  memset(index, 0, sizeof(*index));
+}
+
+#if IPFILTER_FLOWCACHE > 0
+/****************************************************************************
+ * Name: ipfilter_flow_ports
+ *
+ * Description:
+ *   The fields of the L4 header the rules may compare.
+ *
+ ****************************************************************************/
+
+static void ipfilter_flow_ports(FAR const void *l4hdr, uint8_t proto,
+                                FAR uint16_t *sport, FAR uint16_t *dport)
+{
+  switch (proto)
+    {
+      case IP_PROTO_TCP:
+      case IP_PROTO_UDP:
+        {
+          FAR const struct udp_hdr_s *udp = l4hdr;
+
+          *sport = udp->srcport;
+          *dport = udp->destport;
+        }
+        break;
+
+      case IP_PROTO_ICMP:
+      case IP_PROTO_ICMP6:
+        *sport = *(FAR const uint8_t *)l4hdr;
+        break;
+
+      default:
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_hash
+ ****************************************************************************/
+
+static unsigned int ipfilter_flow_hash(FAR const void *flow, size_t len)
+{
+  FAR const uint8_t *ptr = flow;
+  uint32_t hash = 2166136261u;
+
+  while (len-- > 0)
+    {
+      hash = (hash ^ *ptr++) * 16777619u;
+    }
+
+  return hash % IPFILTER_FLOWCACHE;
+}
+
+/****************************************************************************
+ * Name: ipfilter_flow_flush
+ *
+ * Description:
+ *   Forget all the cached targets, the rules changed.
+ *
+ ****************************************************************************/
+
+static void ipfilter_flow_flush(void)
+{
+  if (++g_ipfilter_gen == 0)
+    {
+#ifdef CONFIG_NET_IPv4
+      memset(g_ipv4_flowcache, 0, sizeof(g_ipv4_flowcache));
+#endif
+#ifdef CONFIG_NET_IPv6
+      memset(g_ipv6_flowcache, 0, sizeof(g_ipv6_flowcache));
+#endif
+      g_ipfilter_gen = 1;
+    }
+}
+#else
+#  define ipfilter_flow_flush()
+#endif /* IPFILTER_FLOWCACHE > 0 */
+
+/****************************************************************************
+ * Name: ipv4_filter_match_entry / ipv6_filter_match_entry
+ *
+ * Description:
+ *   Match the packet with one filter entry.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static bool
+ipv4_filter_match_entry(FAR const struct ipv4_filter_entry_s *filter,
+                        FAR const struct net_driver_s *indev,
+                        FAR const struct net_driver_s *outdev,
+                        FAR const struct ipv4_hdr_s *ipv4,
+                        FAR const void *l4hdr)
+{
+  in_addr_t ipaddr;
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
+  matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto);
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static bool
+ipv6_filter_match_entry(FAR const struct ipv6_filter_entry_s *filter,
+                        FAR const struct net_driver_s *indev,
+                        FAR const struct net_driver_s *outdev,
+                        FAR const struct ipv6_hdr_s *ipv6,
+                        FAR const void *l4hdr, uint8_t proto)
+{
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
+                                 filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
+                                 filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, l4hdr, proto);
+}
+#endif
+
+/****************************************************************************
+ * Name: ipv4_filter_walk / ipv6_filter_walk
+ *
+ * Description:
+ *   Find the first entry of the chain that matches the packet, among the
+ *   entries of its class if the index is usable.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int ipv4_filter_walk(FAR const struct net_driver_s *indev,
+                            FAR const struct net_driver_s *outdev,
+                            FAR const struct ipv4_hdr_s *ipv4,
+                            FAR const void *l4hdr,
+                            enum ipfilter_chain_e chain)
+{
+  FAR const struct ipfilter_index_s *index = &g_ipv4_index[chain];
+  FAR const struct ipv4_filter_entry_s *filter;
+  FAR const sq_entry_t *entry;
+  unsigned int i;
+  int cls;
+
+  if (!index->invalid)
+    {
+      cls = ipfilter_class(ipv4->proto);
+      for (i = 0; i < index->nrules[cls]; i++)
+        {
+          filter = (FAR struct ipv4_filter_entry_s *)index->rules[cls][i];
+          if (ipv4_filter_match_entry(filter, indev, outdev, ipv4, l4hdr))
+            {
+              return filter->common.target;
+            }
+        }
+    }
+  else
+    {
+      sq_for_every(&g_ipv4_filters[chain], entry)
+        {
+          filter = (FAR struct ipv4_filter_entry_s *)entry;
+          if (ipv4_filter_match_entry(filter, indev, outdev, ipv4, l4hdr))
+            {
+              return filter->common.target;
+            }
+        }
+    }
+
+  /* Normally there should be a default rule in chain, won't reach here. */
+
+  ninfo("No filter matched, maybe uninitialized.\n");
+  return IPFILTER_TARGET_ACCEPT;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int ipv6_filter_walk(FAR const struct net_driver_s *indev,
+                            FAR const struct net_driver_s *outdev,
+                            FAR const struct ipv6_hdr_s *ipv6,
+                            FAR const void *l4hdr, uint8_t proto,
+                            enum ipfilter_chain_e chain)
+{
+  FAR const struct ipfilter_index_s *index = &g_ipv6_index[chain];
+  FAR const struct ipv6_filter_entry_s *filter;
+  FAR const sq_entry_t *entry;
+  unsigned int i;
+  int cls;
+
+  if (!index->invalid)
+    {
+      cls = ipfilter_class(proto);
+      for (i = 0; i < index->nrules[cls]; i++)
+        {
+          filter = (FAR struct ipv6_filter_entry_s *)index->rules[cls][i];
+          if (ipv6_filter_match_entry(filter, indev, outdev, ipv6, l4hdr,
+                                      proto))
+            {
+              return filter->common.target;
+            }
+        }
+    }
+  else
+    {
+      sq_for_every(&g_ipv6_filters[chain], entry)
+        {
+          filter = (FAR struct ipv6_filter_entry_s *)entry;
+          if (ipv6_filter_match_entry(filter, indev, outdev, ipv6, l4hdr,
+                                      proto))
+            {
+              return filter->common.target;
+            }
+        }
+    }
+
+  /* Normally there should be a default rule in chain, won't reach here. */
+
+  ninfo("No filter matched, maybe uninitialized.\n");
+  return IPFILTER_TARGET_ACCEPT;
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_filter_match / ipv6_filter_match
  *
@@ -213,12 +666,12 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
                              FAR const struct ipv4_hdr_s *ipv4,
                              enum ipfilter_chain_e chain)
 {
-  FAR const struct ipv4_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv4_filters[chain];
-  FAR const sq_entry_t *entry;
+#if IPFILTER_FLOWCACHE > 0
+  FAR struct ipv4_flowcache_s *cache;
+  struct ipv4_flow_s flow;
+#endif
   FAR const void *l4hdr;
-  in_addr_t ipaddr;
-  bool matched;
+  int target;
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -229,51 +682,33 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv4_L4HDR(ipv4);
 
-  sq_for_every(queue, entry)
+#if IPFILTER_FLOWCACHE > 0
+  memset(&flow, 0, sizeof(flow));
+  flow.indev  = indev;
+  flow.outdev = outdev;
+  flow.srcip  = net_ip4addr_conv32(ipv4->srcipaddr);
+  flow.dstip  = net_ip4addr_conv32(ipv4->destipaddr);
+  flow.proto  = ipv4->proto;
+  flow.chain  = chain;
+  ipfilter_flow_ports(l4hdr, ipv4->proto, &flow.sport, &flow.dport);
+
+  cache = &g_ipv4_flowcache[ipfilter_flow_hash(&flow, sizeof(flow))];
+  if (cache->gen == g_ipfilter_gen &&
+      memcmp(&cache->flow, &flow, sizeof(flow)) == 0)
     {
-      filter = (FAR struct ipv4_filter_entry_s *)entry;
-
-      /* Match device */
-
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
-        {
-          continue;
-        }
-
-      /* Match addresses */
-
-      ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
-      matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
-
-      ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
-      matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
-        {
-          continue;
-        }
-
-      /* Match protocol */
-
-      if (!ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto))
-        {
-          continue;
-        }
-
-      /* Return the target action if matched. */
-
-      return filter->common.target;
+      return cache->target;
     }
+#endif
 
-  /* Normally there should be a default rule in chain, won't reach here. */
+  target = ipv4_filter_walk(indev, outdev, ipv4, l4hdr, chain);
 
-  ninfo("No filter matched, maybe uninitialized.\n");
-  return IPFILTER_TARGET_ACCEPT;
+#if IPFILTER_FLOWCACHE > 0
+  cache->flow   = flow;
+  cache->gen    = g_ipfilter_gen;
+  cache->target = target;
+#endif
+
+  return target;
 }
 #endif
 
@@ -283,12 +718,13 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
                              FAR const struct ipv6_hdr_s *ipv6,
                              enum ipfilter_chain_e chain)
 {
-  FAR const struct ipv6_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv6_filters[chain];
-  FAR const sq_entry_t *entry;
+#if IPFILTER_FLOWCACHE > 0
+  FAR struct ipv6_flowcache_s *cache;
+  struct ipv6_flow_s flow;
+#endif
   FAR const void *l4hdr;
   uint8_t proto;
-  bool matched;
+  int target;
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -299,51 +735,33 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
 
   l4hdr = IPv6_L4HDR(ipv6, proto);
 
-  sq_for_every(queue, entry)
+#if IPFILTER_FLOWCACHE > 0
+  memset(&flow, 0, sizeof(flow));
+  flow.indev  = indev;
+  flow.outdev = outdev;
+  net_ipv6addr_copy(flow.srcip, ipv6->srcipaddr);
+  net_ipv6addr_copy(flow.dstip, ipv6->destipaddr);
+  flow.proto  = proto;
+  flow.chain  = chain;
+  ipfilter_flow_ports(l4hdr, proto, &flow.sport, &flow.dport);
+
+  cache = &g_ipv6_flowcache[ipfilter_flow_hash(&flow, sizeof(flow))];
+  if (cache->gen == g_ipfilter_gen &&
+      memcmp(&cache->flow, &flow, sizeof(flow)) == 0)
     {
-      filter = (FAR struct ipv6_filter_entry_s *)entry;
-
-      /* Match device */
-
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
-        {
-          continue;
-        }
-
-      /* Match addresses */
-
-      matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
-                                     filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
-
-      matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
-                                     filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
-        {
-          continue;
-        }
-
-      /* Match protocol */
-
-      if (!ipfilter_match_proto(&filter->common, l4hdr, proto))
-        {
-          continue;
-        }
-
-      /* Return the target action if matched. */
-
-      return filter->common.target;
+      return cache->target;
     }
+#endif
 
-  /* Normally there should be a default rule in chain, won't reach here. */
+  target = ipv6_filter_walk(indev, outdev, ipv6, l4hdr, proto, chain);
 
-  ninfo("No filter matched, maybe uninitialized.\n");
-  return IPFILTER_TARGET_ACCEPT;
+#if IPFILTER_FLOWCACHE > 0
+  cache->flow   = flow;
+  cache->gen    = g_ipfilter_gen;
+  cache->target = target;
+#endif
+
+  return target;
 }
 #endif
 
@@ -411,6 +829,7 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
   if (family == PF_INET)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv4_filters[chain]);
+      ipfilter_index_add(&g_ipv4_index[chain], entry);
     }
 #endif
 
@@ -418,8 +837,11 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
   if (family == PF_INET6)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv6_filters[chain]);
+      ipfilter_index_add(&g_ipv6_index[chain], entry);
     }
 #endif
+
+  ipfilter_flow_flush();
 }
 
 /****************************************************************************
@@ -444,6 +866,8 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
   if (family == PF_INET)
     {
       FAR sq_queue_t *queue = &g_ipv4_filters[chain];
+
+      ipfilter_index_clear(&g_ipv4_index[chain]);
       while (!sq_empty(queue))
         {
           kmm_free(sq_remfirst(queue));
@@ -455,12 +879,16 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
   if (family == PF_INET6)
     {
       FAR sq_queue_t *queue = &g_ipv6_filters[chain];
+
+      ipfilter_index_clear(&g_ipv6_index[chain]);
       while (!sq_empty(queue))
         {
           kmm_free(sq_remfirst(queue));
         }
     }
 #endif
+
+  ipfilter_flow_flush();
 }
 
 /****************************************************************************
@@ -32,6 +32,8 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <nuttx/net/ip.h>
+
 #undef HAVE_FWDALLOC
 #ifdef CONFIG_NET_IPFORWARD
 
@@ -41,6 +43,10 @@
 
 #define HAVE_FWDALLOC 1
 
+#ifndef CONFIG_NET_IPFORWARD_FLOWCACHE
+#  define CONFIG_NET_IPFORWARD_FLOWCACHE 0
+#endif
+
 #ifndef CONFIG_NET_IPFORWARD_NSTRUCT
 #  define CONFIG_NET_IPFORWARD_NSTRUCT 4
 #endif
@@ -355,5 +361,49 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #  define ipv4_dropstats(ipv4)
 #endif
 
+/****************************************************************************
+ * Name: ipv4_fwd_finddev / ipv6_fwd_finddev
+ *
+ * Description:
+ *   Find the device that forwards a packet from srcip to destip.  The
+ *   devices of the recent flows are cached if
+ *   CONFIG_NET_IPFORWARD_FLOWCACHE > 0.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+#  ifdef CONFIG_NET_IPv4
+FAR struct net_driver_s *ipv4_fwd_finddev(in_addr_t srcip,
+                                          in_addr_t destip);
+#  endif
+#  ifdef CONFIG_NET_IPv6
+FAR struct net_driver_s *ipv6_fwd_finddev(const net_ipv6addr_t srcip,
+                                          const net_ipv6addr_t destip);
+#  endif
+#else
+#  define ipv4_fwd_finddev(s,d) netdev_findby_ripv4addr(s,d)
+#  define ipv6_fwd_finddev(s,d) netdev_findby_ripv6addr(s,d)
+#endif
+
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_flush
+ *
+ * Description:
+ *   Forget the cached forwarding devices, called when a route or a device
+ *   changes.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPFORWARD_FLOWCACHE) && \
+    CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+void ipfwd_flowcache_flush(void);
+#else
+#  define ipfwd_flowcache_flush()
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
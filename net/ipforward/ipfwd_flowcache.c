@@ -0,0 +1,200 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flowcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
+
+#if defined(CONFIG_NET_IPFORWARD) && CONFIG_NET_IPFORWARD_FLOWCACHE > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define IPFWD_FLOWCACHE     CONFIG_NET_IPFORWARD_FLOWCACHE
+
+/* Not every change of the device addresses flushes the cache, an entry is
+ * looked up again after this time anyway.
+ */
+
+#define IPFWD_FLOW_TIMEOUT  SEC2TICK(1)
+
+#define IPFWD_FLOW_HASH(h)  (((uint32_t)(h) * 2654435761u >> 16) % \
+                             IPFWD_FLOWCACHE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The forwarding device of one recent pair of addresses */
+
+#ifdef CONFIG_NET_IPv4
+struct ipv4_fwdflow_s
+{
+  FAR struct net_driver_s *dev;     /* NULL if the entry is unused */
+  in_addr_t srcip;
+  in_addr_t destip;
+  clock_t   time;                   /* When the device was looked up */
+  int       gen;                    /* g_ipfwd_flowgen at that time */
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+struct ipv6_fwdflow_s
+{
+  FAR struct net_driver_s *dev;     /* NULL if the entry is unused */
+  net_ipv6addr_t srcip;
+  net_ipv6addr_t destip;
+  clock_t   time;                   /* When the device was looked up */
+  int       gen;                    /* g_ipfwd_flowgen at that time */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The tables are only used with the network locked, the generation may be
+ * bumped from anywhere.
+ */
+
+static atomic_t g_ipfwd_flowgen;
+
+#ifdef CONFIG_NET_IPv4
+static struct ipv4_fwdflow_s g_ipv4_fwdflows[IPFWD_FLOWCACHE];
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct ipv6_fwdflow_s g_ipv6_fwdflows[IPFWD_FLOWCACHE];
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_fwd_finddev
+ *
+ * Description:
+ *   Find the device that forwards a packet from srcip to destip, as
+ *   netdev_findby_ripv4addr() does, from the cache of recent flows if it
+ *   is there.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+FAR struct net_driver_s *ipv4_fwd_finddev(in_addr_t srcip,
+                                          in_addr_t destip)
+{
+  FAR struct ipv4_fwdflow_s *flow;
+  clock_t now = clock_systime_ticks();
+  int gen = atomic_read(&g_ipfwd_flowgen);
+
+  flow = &g_ipv4_fwdflows[IPFWD_FLOW_HASH(srcip ^ destip)];
+  if (flow->dev != NULL && flow->gen == gen &&
+      now - flow->time < IPFWD_FLOW_TIMEOUT &&
+      net_ipv4addr_cmp(flow->srcip, srcip) &&
+      net_ipv4addr_cmp(flow->destip, destip))
+    {
+      return flow->dev;
+    }
+
+  flow->dev    = netdev_findby_ripv4addr(srcip, destip);
+  flow->srcip  = srcip;
+  flow->destip = destip;
+  flow->time   = now;
+  flow->gen    = gen;
+  return flow->dev;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipv6_fwd_finddev
+ *
+ * Description:
+ *   Find the device that forwards a packet from srcip to destip, as
+ *   netdev_findby_ripv6addr() does, from the cache of recent flows if it
+ *   is there.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+FAR struct net_driver_s *ipv6_fwd_finddev(const net_ipv6addr_t srcip,
+                                          const net_ipv6addr_t destip)
+{
+  FAR struct ipv6_fwdflow_s *flow;
+  clock_t now = clock_systime_ticks();
+  int gen = atomic_read(&g_ipfwd_flowgen);
+  uint32_t hash = 0;
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      hash = (hash << 5) + hash + (srcip[i] ^ destip[i]);
+    }
+
+  flow = &g_ipv6_fwdflows[IPFWD_FLOW_HASH(hash)];
+  if (flow->dev != NULL && flow->gen == gen &&
+      now - flow->time < IPFWD_FLOW_TIMEOUT &&
+      net_ipv6addr_cmp(flow->srcip, srcip) &&
+      net_ipv6addr_cmp(flow->destip, destip))
+    {
+      return flow->dev;
+    }
+
+  flow->dev  = netdev_findby_ripv6addr(srcip, destip);
+  net_ipv6addr_copy(flow->srcip, srcip);
+  net_ipv6addr_copy(flow->destip, destip);
+  flow->time = now;
+  flow->gen  = gen;
+  return flow->dev;
+}
+#endif
+
+/****************************************************************************
+ * Name: ipfwd_flowcache_flush
+ ****************************************************************************/
+
+void ipfwd_flowcache_flush(void)
+{
+  atomic_fetch_add(&g_ipfwd_flowgen, 1);
+}
+
+#endif /* CONFIG_NET_IPFORWARD && CONFIG_NET_IPFORWARD_FLOWCACHE > 0 */
@@ -143,8 +143,7 @@ static int ipv4_hdrsize(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 {
-  uint16_t iphdrlen;
-  uint16_t sum;
+  uint32_t sum;
   int ttl;
 
   /* Check time-to-live (TTL) */
@@ -161,27 +160,18 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
   ipv4->ttl = ttl;
 
-  /* Get the IP header length (accounting for possible options). */
-
-  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
-
-  /* Re-calculate the IPv4 checksum.  This checksum is the Internet checksum
-   * of the 20 bytes of the IPv4 header.  This checksum will be different
-   * because we just modify the IPv4 TTL.
+  /* Update the IPv4 checksum for the one header word that changed, the
+   * TTL and protocol word went down by 0x0100 (RFC 1624, equation 3):
+   * HC' = ~(~HC + ~m + m').
    */
 
-  ipv4->ipchksum = 0;
-  sum            = chksum(0, (FAR const uint8_t *)ipv4, iphdrlen);
-  if (sum == 0)
-    {
-      sum = 0xffff;
-    }
-  else
-    {
-      sum = HTONS(sum);
-    }
+  sum = (uint16_t)~NTOHS(ipv4->ipchksum) +
+        (uint16_t)~(((ttl + 1) << 8) | ipv4->proto) +
+        (uint16_t)((ttl << 8) | ipv4->proto);
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
 
-  ipv4->ipchksum = ~sum;
+  ipv4->ipchksum = HTONS((uint16_t)~sum);
   return ttl;
 }
 
@@ -470,7 +460,7 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
   srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
 
-  fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+  fwddev     = ipv4_fwd_finddev(srcipaddr, destipaddr);
   if (fwddev == NULL)
     {
       nwarn("WARNING: Not routable\n");
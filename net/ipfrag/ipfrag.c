@@ -29,6 +29,7 @@
     defined(CONFIG_NET_IPFRAG)
 
 #include <sys/ioctl.h>
+#include <sys/param.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <debug.h>
@@ -87,6 +88,10 @@ do  \
 
 #define IPFRAGWORK                      LPWORK
 
+#define IPFRAG_HASHSIZE                 CONFIG_NET_IPFRAG_HASHSIZE
+#define IPFRAG_HASH(h)                  (((uint32_t)(h) * 2654435761u >> 16) \
+                                         % IPFRAG_HASHSIZE)
+
 /* Helper macro to count I/O buffer count for a given I/O buffer chain */
 
 #define IOBUF_CNT(ptr)    (((ptr)->io_pktlen + CONFIG_IOB_BUFSIZE - 1)/ \
@@ -119,11 +124,11 @@ static struct work_s g_wkfragtimeout;
 
 static uint8_t       g_bufoccupy;
 
-/* Queue header definition, it links all fragments of all NICs by ascending
- * ipid.
+/* Queue header definitions, each links the fragments of all NICs whose
+ * addresses, protocol and ipid hash to it.
  */
 
-static sq_queue_t    g_assemblyhead_ipid;
+static sq_queue_t    g_assemblyhead_hash[IPFRAG_HASHSIZE];
 
 /* Queue header definition, which connects all fragments of all NICs in order
  * of addition time.
@@ -135,7 +140,7 @@ static sq_queue_t    g_assemblyhead_time;
  * Public Data
  ****************************************************************************/
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
+/* Only one thread can access g_assemblyhead_hash and g_assemblyhead_time
  * at a time.
  */
 
@@ -158,6 +163,76 @@ ip_fragout_allocfragbuf(FAR struct iob_queue_s *fragq);
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: ip_frag_hash
+ *
+ * Description:
+ *   The hash bucket of the datagram that a fragment belongs to.
+ *
+ ****************************************************************************/
+
+static uint16_t ip_frag_hash(FAR const struct ip_fraglink_s *fraglink)
+{
+  uint32_t hash = fraglink->ipid ^ fraglink->proto;
+#ifdef CONFIG_NET_IPv6
+  int i;
+#endif
+
+#ifdef CONFIG_NET_IPv4
+  if (fraglink->isipv4)
+    {
+      hash ^= fraglink->srcaddr.ipv4 ^ fraglink->destaddr.ipv4;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (!fraglink->isipv4)
+    {
+      for (i = 0; i < 8; i++)
+        {
+          hash = (hash << 5) + hash + (fraglink->srcaddr.ipv6[i] ^
+                                       fraglink->destaddr.ipv6[i]);
+        }
+    }
+#endif
+
+  return IPFRAG_HASH(hash);
+}
+
+/****************************************************************************
+ * Name: ip_frag_match
+ *
+ * Description:
+ *   Whether a fragment received by dev belongs to the datagram of node.
+ *
+ ****************************************************************************/
+
+static bool ip_frag_match(FAR const struct ip_fragsnode_s *node,
+                          FAR const struct net_driver_s *dev,
+                          FAR const struct ip_fraglink_s *fraglink)
+{
+  if (node->dev != dev || node->ipid != fraglink->ipid ||
+      node->isipv4 != fraglink->isipv4 || node->proto != fraglink->proto)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (fraglink->isipv4)
+    {
+      return net_ipv4addr_cmp(node->srcaddr.ipv4, fraglink->srcaddr.ipv4) &&
+             net_ipv4addr_cmp(node->destaddr.ipv4, fraglink->destaddr.ipv4);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  return net_ipv6addr_cmp(node->srcaddr.ipv6, fraglink->srcaddr.ipv6) &&
+         net_ipv6addr_cmp(node->destaddr.ipv6, fraglink->destaddr.ipv6);
+#else
+  return false;
+#endif
+}
+
 /****************************************************************************
  * Name: ip_fragin_timerout_expiry
  *
@@ -530,7 +605,7 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
   g_bufoccupy -= node->bufcnt;
   ASSERT(g_bufoccupy < CONFIG_IOB_NBUFFERS);
 
-  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
+  sq_rem((FAR sq_entry_t *)node, &g_assemblyhead_hash[node->hash]);
   sq_rem((FAR sq_entry_t *)&node->flinkat, &g_assemblyhead_time);
 
   return node->bufcnt;
@@ -543,7 +618,8 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
  *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   organized in upper-level linked lists, hashed by the source and
+ *   destination addresses, the protocol and the IP ID.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -558,35 +634,30 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node)
 bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
                        FAR struct ip_fraglink_s *curfraglink)
 {
-  FAR struct ip_fragsnode_s *node;
+  FAR struct ip_fragsnode_s *node = NULL;
   FAR sq_entry_t            *entry;
-  FAR sq_entry_t            *entrylast = NULL;
+  uint16_t                   hash;
   bool                       empty;
 
-  /* The linked list is ordered by IP ID value, walk through it and try to
-   * find a node that has the same IP ID value, otherwise need to create a
-   * new node and insert it into the linked list.
+  /* Walk through the bucket of the datagram and try to find its node,
+   * otherwise need to create a new node and insert it into the bucket.
    */
 
-  entry = sq_peek(&g_assemblyhead_ipid);
-  empty = (entry == NULL) ? true : false;
+  hash  = ip_frag_hash(curfraglink);
+  empty = sq_peek(&g_assemblyhead_time) == NULL;
 
-  while (entry != NULL)
+  for (entry = sq_peek(&g_assemblyhead_hash[hash]); entry != NULL;
+       entry = sq_next(entry))
     {
-      node = (struct ip_fragsnode_s *)entry;
-
-      if (dev == node->dev && curfraglink->ipid <= node->ipid)
+      if (ip_frag_match((FAR struct ip_fragsnode_s *)entry, dev,
+                        curfraglink))
         {
+          node = (FAR struct ip_fragsnode_s *)entry;
           break;
         }
-
-      entrylast = entry;
-      entry = sq_next(entry);
     }
 
-  node = (FAR struct ip_fragsnode_s *)entry;
-
-  if (node != NULL && curfraglink->ipid == node->ipid)
+  if (node != NULL)
     {
       FAR struct ip_fraglink_s *fraglink;
       FAR struct ip_fraglink_s *lastlink = NULL;
@@ -689,6 +760,11 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       node->flinkat    = NULL;
       node->dev        = dev;
       node->ipid       = curfraglink->ipid;
+      node->isipv4     = curfraglink->isipv4;
+      node->proto      = curfraglink->proto;
+      node->hash       = hash;
+      node->srcaddr    = curfraglink->srcaddr;
+      node->destaddr   = curfraglink->destaddr;
       node->frags      = curfraglink;
       node->tick       = clock_systime_ticks();
       node->bufcnt     = IOBUF_CNT(curfraglink->frag);
@@ -696,19 +772,9 @@ bool ip_fragin_enqueue(FAR struct net_driver_s *dev,
       node->verifyflag = 0;
       node->outgoframe = NULL;
 
-      /* Insert this new node into linked list identified by
-       * g_assemblyhead_ipid with correct position
-       */
+      /* Insert this new node into its hash bucket */
 
-      if (sq_peek(&g_assemblyhead_ipid) == NULL || entrylast == NULL)
-        {
-          sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_ipid);
-        }
-      else
-        {
-          sq_addafter(entrylast, (FAR sq_entry_t *)node,
-                      &g_assemblyhead_ipid);
-        }
+      sq_addfirst((FAR sq_entry_t *)node, &g_assemblyhead_hash[hash]);
 
       /* Add this new node to the tail of linked list identified by
        * g_assemblyhead_time
@@ -791,8 +857,9 @@ int32_t ip_fragout_slice(FAR struct iob_s *iob, uint8_t domain, uint16_t mtu,
   uint16_t          ncopy;
   uint16_t          navail;
   uint32_t          nfrags = 0;
-  bool              expand = false;
   FAR struct iob_s *orig = NULL;
+  FAR struct iob_s *next;
+  FAR struct iob_s *tail;
   FAR struct iob_s *reorg = NULL;
   FAR struct iob_s *head = NULL;
 
@@ -952,71 +1019,74 @@ int32_t ip_fragout_slice(FAR struct iob_s *iob, uint8_t domain, uint16_t mtu,
     }
 #endif
 
-  /* Copy data from original I/O buffer chain 'orig' to new reorganized
-   * I/O buffer chain 'reorg'
+  /* Move data from original I/O buffer chain 'orig' to new reorganized
+   * I/O buffer chain 'reorg'.  When a fragment does not fit in one I/O
+   * buffer anyway, the original I/O buffers that fit in the fragment are
+   * linked to it, only the data across the fragment boundaries is copied.
+   * Otherwise each fragment is copied to a single I/O buffer, as drivers
+   * may send it from d_buf.
    */
 
   while (orig != NULL)
     {
-      leftstart = orig->io_data + orig->io_offset;
-      leftlen = orig->io_len;
+      if (orig->io_len == 0)
+        {
+          orig = iob_free(orig);
+          continue;
+        }
 
-      /* For each I/O buffer data of the 'orig' chain */
+      /* Calculate target area size */
 
-      while (leftlen > 0)
+      navail = mtu - reorg->io_pktlen;
+
+      if (navail == 0)
         {
-          /* Calculate target area size */
+          /* Target area is full, need expand the destination chain */
 
-          navail = mtu - reorg->io_pktlen;
+          reorg = ip_fragout_allocfragbuf(fragq);
+          GOTO_IF(reorg == NULL, allocfail);
 
-          if (navail > 0)
-            {
-              if (leftlen > navail)
-                {
-                  /* Target area is too small, need expand the destination
-                   * chain
-                   */
+          nfrags++;
 
-                  expand = true;
-                  ncopy  = navail;
-                }
-              else
-                {
-                  ncopy = leftlen;
-                }
+          /* This is a new fragment buffer, reserve L2&L3 header space
+           * in the front of this buffer
+           */
 
-              if (iob_trycopyin(reorg, leftstart, ncopy,
-                                reorg->io_pktlen, false) < 0)
-                {
-                  goto allocfail;
-                }
+          UPDATE_IOB(reorg, CONFIG_NET_LL_GUARDSIZE, unfraglen);
+        }
+      else if (orig->io_len <= navail && mtu > IOB_BUFSIZE(reorg))
+        {
+          /* Link the whole I/O buffer to the end of the fragment */
 
-              leftlen   -= ncopy;
-              leftstart += ncopy;
-            }
-          else
+          next = orig->io_flink;
+          if (next != NULL)
             {
-              expand = true;
+              next->io_pktlen = orig->io_pktlen - orig->io_len;
             }
 
-          if (expand)
+          tail = reorg;
+          while (tail->io_flink != NULL)
             {
-              reorg = ip_fragout_allocfragbuf(fragq);
-              GOTO_IF(reorg == NULL, allocfail);
-
-              nfrags++;
-
-              /* This is a new fragment buffer, reserve L2&L3 header space
-               * in the front of this buffer
-               */
+              tail = tail->io_flink;
+            }
 
-              UPDATE_IOB(reorg, CONFIG_NET_LL_GUARDSIZE, unfraglen);
+          orig->io_flink    = NULL;
+          tail->io_flink    = orig;
+          reorg->io_pktlen += orig->io_len;
+          orig              = next;
+        }
+      else
+        {
+          ncopy = MIN(orig->io_len, navail);
 
-              expand = false;
+          if (iob_trycopyin(reorg, orig->io_data + orig->io_offset, ncopy,
+                            reorg->io_pktlen, false) < 0)
+            {
+              goto allocfail;
             }
-        }
 
-      orig = iob_free(orig);
+          orig = iob_trimhead(orig, ncopy);
+        }
     }
 
   return nfrags;
@@ -1117,13 +1187,14 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop those unassembled incoming fragments belonging to this NIC */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (dev == node->dev)
@@ -1139,7 +1210,7 @@ void ip_frag_stop(FAR struct net_driver_s *dev)
             }
 
           ip_frag_remnode(node);
-          kmm_free(entry);
+          kmm_free(node);
         }
 
       entry = entrynext;
@@ -1169,16 +1240,18 @@ void ip_frag_remallfrags(void)
   FAR sq_entry_t *entry = NULL;
   FAR sq_entry_t *entrynext;
   FAR struct net_driver_s *dev;
+  int i;
 
   nxmutex_lock(&g_ipfrag_lock);
 
-  entry = sq_peek(&g_assemblyhead_ipid);
+  entry = sq_peek(&g_assemblyhead_time);
 
   /* Drop all unassembled incoming fragments */
 
   while (entry != NULL)
     {
-      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)entry;
+      FAR struct ip_fragsnode_s *node = (FAR struct ip_fragsnode_s *)
+        container_of(entry, FAR struct ip_fragsnode_s, flinkat);
       entrynext = sq_next(entry);
 
       if (node->frags != NULL)
@@ -1191,17 +1264,20 @@ void ip_frag_remallfrags(void)
             }
         }
 
-      /* Because nodes managed by the two queues are the same,
-       * and g_assemblyhead_ipid will be cleared after this loop ends,
-       * so only reset g_assemblyhead_time is needed after this loop ends
+      /* Because nodes managed by the queues are the same, they are all
+       * reset after this loop ends
        */
 
-      sq_rem(entry, &g_assemblyhead_ipid);
-      kmm_free(entry);
+      kmm_free(node);
 
       entry = entrynext;
     }
 
+  for (i = 0; i < IPFRAG_HASHSIZE; i++)
+    {
+      sq_init(&g_assemblyhead_hash[i]);
+    }
+
   sq_init(&g_assemblyhead_time);
   g_bufoccupy = 0;
 
@@ -1246,7 +1322,7 @@ int32_t ip_fragout(FAR struct net_driver_s *dev)
       return -EINVAL;
     }
 
-  if (dev->d_iob->io_pktlen <= mtu)
+  if (dev->d_iob->io_pktlen <= mtu || NETDEV_IS_TSO(dev))
     {
       return OK;
     }
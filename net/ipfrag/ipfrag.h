@@ -81,6 +81,7 @@ struct ip_fraglink_s
   FAR struct ip_fragsnode_s *fragsnode; /* Point to parent struct */
   FAR struct iob_s          *frag;      /* Point to fragment data */
   uint8_t                    isipv4;    /* IPv4 or IPv6 */
+  uint8_t                    proto;     /* IPv4 protocol, 0 for IPv6 */
   uint16_t                   fragoff;   /* Fragment offset */
   uint16_t                   fraglen;   /* Payload length */
   uint16_t                   morefrags; /* The more frag flag */
@@ -90,6 +91,13 @@ struct ip_fraglink_s
    */
 
   uint32_t                   ipid;
+
+  /* The addresses that identify the datagram together with the protocol
+   * and the IP ID
+   */
+
+  union ip_addr_u            srcaddr;
+  union ip_addr_u            destaddr;
 };
 
 struct ip_fragsnode_s
@@ -116,6 +124,16 @@ struct ip_fragsnode_s
 
   uint32_t                   ipid;
 
+  /* The rest of the key of the datagram, see ip_fraglink_s, and the hash
+   * bucket of the node
+   */
+
+  uint8_t                    isipv4;
+  uint8_t                    proto;
+  uint16_t                   hash;
+  union ip_addr_u            srcaddr;
+  union ip_addr_u            destaddr;
+
   /* Count ticks, used by ressembly timer */
 
   clock_t                    tick;
@@ -149,7 +167,7 @@ extern "C"
 #  define EXTERN extern
 #endif
 
-/* Only one thread can access g_assemblyhead_ipid and g_assemblyhead_time
+/* Only one thread can access g_assemblyhead_hash and g_assemblyhead_time
  * at a time
  */
 
@@ -183,7 +201,8 @@ uint32_t ip_frag_remnode(FAR struct ip_fragsnode_s *node);
  *   Enqueue one fragment.
  *   All fragments belonging to one IP frame are organized in a linked list
  *   form, that is a ip_fragsnode_s node. All ip_fragsnode_s nodes are also
- *   organized in an upper-level linked list.
+ *   organized in upper-level linked lists, hashed by the source and
+ *   destination addresses, the protocol and the IP ID.
  *
  * Input Parameters:
  *   dev         - NIC Device instance
@@ -99,8 +99,14 @@ ipv4_fragin_getinfo(FAR struct iob_s *iob,
 
   fraglink->fraglen   = (ipv4->len[0] << 8) + ipv4->len[1] - IPv4_HDRLEN;
   fraglink->ipid      = (ipv4->ipid[0] << 8) + ipv4->ipid[1];
+  fraglink->proto     = ipv4->proto;
   fraglink->frag      = iob;
 
+  net_ipv4addr_copy(fraglink->srcaddr.ipv4,
+                    net_ip4addr_conv32(ipv4->srcipaddr));
+  net_ipv4addr_copy(fraglink->destaddr.ipv4,
+                    net_ip4addr_conv32(ipv4->destipaddr));
+
   return OK;
 }
 
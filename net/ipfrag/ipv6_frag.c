@@ -146,8 +146,12 @@ static int32_t ipv6_fragin_getinfo(FAR struct iob_s *iob,
         ((uint32_t)(*(FAR uint16_t *)(&fraghdr->id[0])) << 16) +
          (uint32_t)(*(FAR uint16_t *)(&fraghdr->id[2])));
 
+      fraglink->proto     = 0;
       fraglink->frag      = iob;
 
+      net_ipv6addr_copy(fraglink->srcaddr.ipv6, ipv6->srcipaddr);
+      net_ipv6addr_copy(fraglink->destaddr.ipv6, ipv6->destipaddr);
+
       return OK;
     }
   else
@@ -31,6 +31,7 @@
 
 #include <net/ethernet.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/net/ip.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/sixlowpan.h>
@@ -38,6 +39,39 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+/* The interface identifier of the address differs most between the
+ * neighbors on a link.
+ */
+
+#  define NEIGHBOR_HASH_KEY(ipaddr) \
+     ((((uint32_t)(ipaddr)[6] << 16) | (ipaddr)[7]) ^ (ipaddr)[5])
+
+#  define NEIGHBOR_NODE(neighbor) \
+     container_of(neighbor, struct neighbor_node_s, nn_entry)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+/* An entry of the hashed Neighbor Table.  The links stay out of struct
+ * neighbor_entry_s, which is copied out to the user by neighbor_snapshot().
+ */
+
+struct neighbor_node_s
+{
+  hash_node_t             nn_hnode;  /* Node in the bucket of the address */
+  dq_entry_t              nn_lnode;  /* Node in the LRU list */
+  struct neighbor_entry_s nn_entry;
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -46,7 +80,15 @@
  * this table.
  */
 
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+extern DECLARE_HASHTABLE(g_neighbor_hash, CONFIG_NET_IPv6_NCONF_HASH_BITS);
+
+/* The entries in use, the most recently used first */
+
+extern dq_queue_t g_neighbor_lru;
+#else
 extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -72,6 +114,23 @@ struct net_driver_s; /* Forward reference */
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr);
 
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Get a free entry of the hashed Neighbor Table, or the least recently
+ *   used one if the table cannot grow.  A free entry is zeroed, that one
+ *   is still in the table.
+ *
+ * Returned Value:
+ *   The entry; NULL if the table has no entries at all.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+FAR struct neighbor_entry_s *neighbor_alloc(void);
+#endif
+
 /****************************************************************************
  * Name: neighbor_add
  *
@@ -29,6 +29,8 @@
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/nuttx.h>
+
 #include "neighbor/neighbor.h"
 
 /****************************************************************************
@@ -53,6 +55,26 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  FAR struct neighbor_node_s *node;
+  FAR hash_node_t *hnode;
+
+  hashtable_for_every_possible(g_neighbor_hash, hnode,
+                               NEIGHBOR_HASH_KEY(ipaddr))
+    {
+      node = container_of(hnode, struct neighbor_node_s, nn_hnode);
+      if (net_ipv6addr_cmp(node->nn_entry.ne_ipaddr, ipaddr))
+        {
+          /* A use moves the entry to the front, the last to be replaced */
+
+          dq_rem(&node->nn_lnode, &g_neighbor_lru);
+          dq_addfirst(&node->nn_lnode, &g_neighbor_lru);
+
+          neighbor_dumpentry("Entry found", &node->nn_entry);
+          return &node->nn_entry;
+        }
+    }
+#else
   int i;
 
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
@@ -65,6 +87,7 @@ FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
           return neighbor;
         }
     }
+#endif
 
   neighbor_dumpipaddr("Not found", ipaddr);
   return NULL;
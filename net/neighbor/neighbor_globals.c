@@ -26,8 +26,33 @@
 
 #include <nuttx/config.h>
 
+#include <string.h>
+
+#include <nuttx/nuttx.h>
+
+#include "utils/utils.h"
 #include "neighbor/neighbor.h"
 
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_IPv6_NCONF_MAX_ENTRIES
+#  define CONFIG_NET_IPv6_NCONF_MAX_ENTRIES 0
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+NET_BUFPOOL_DECLARE(g_neighbor_entries, sizeof(struct neighbor_node_s),
+                    CONFIG_NET_IPv6_NCONF_ENTRIES,
+                    CONFIG_NET_IPv6_NCONF_ALLOC_ENTRIES,
+                    CONFIG_NET_IPv6_NCONF_MAX_ENTRIES);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -36,8 +61,48 @@
  * this table.
  */
 
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+DECLARE_HASHTABLE(g_neighbor_hash, CONFIG_NET_IPv6_NCONF_HASH_BITS);
+dq_queue_t g_neighbor_lru;
+#else
 struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_alloc
+ *
+ * Description:
+ *   Get a free entry of the hashed Neighbor Table, or the least recently
+ *   used one if the table cannot grow.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+FAR struct neighbor_entry_s *neighbor_alloc(void)
+{
+  FAR struct neighbor_node_s *node;
+
+  node = NET_BUFPOOL_TRYALLOC(g_neighbor_entries);
+  if (node != NULL)
+    {
+      memset(node, 0, sizeof(*node));
+      return &node->nn_entry;
+    }
+
+  if (dq_tail(&g_neighbor_lru) == NULL)
+    {
+      return NULL;
+    }
+
+  node = container_of(dq_tail(&g_neighbor_lru), struct neighbor_node_s,
+                      nn_lnode);
+  return &node->nn_entry;
+}
+#endif
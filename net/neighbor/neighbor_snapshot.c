@@ -29,6 +29,7 @@
 #include <string.h>
 #include <debug.h>
 
+#include <nuttx/nuttx.h>
 #include <nuttx/net/ip.h>
 
 #include "inet/inet.h"
@@ -64,6 +65,22 @@ unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
                                unsigned int nentries)
 {
   unsigned int ncopied;
+#ifdef CONFIG_NET_IPv6_NCONF_HASH
+  FAR struct neighbor_node_s *node;
+  FAR dq_entry_t *lnode;
+
+  /* Copy all entries in the hashed Neighbor table, they are all in use */
+
+  for (lnode = dq_peek(&g_neighbor_lru), ncopied = 0;
+       nentries > ncopied && lnode != NULL;
+       lnode = dq_next(lnode))
+    {
+      node = container_of(lnode, struct neighbor_node_s, nn_lnode);
+      memcpy(&snapshot[ncopied], &node->nn_entry,
+             sizeof(struct neighbor_entry_s));
+      ncopied++;
+    }
+#else
   int i;
 
   /* Copy all non-empty entries in the Neighbor table. */
@@ -86,6 +103,7 @@ unsigned int neighbor_snapshot(FAR struct neighbor_entry_s *snapshot,
           ncopied++;
         }
     }
+#endif
 
   /* Return the number of entries copied into the user buffer */
 
@@ -531,6 +531,49 @@ void netdev_ipv6_removemcastmac(FAR struct net_driver_s *dev,
 #  define netdev_ipv6_removemcastmac(dev,addr)
 #endif
 
+/****************************************************************************
+ * Name: netdev_txcsum_offload
+ *
+ * Description:
+ *   Leave the TCP or UDP checksum of the outgoing packet in d_iob to the
+ *   network device, if it supports checksum offload.
+ *
+ * Input Parameters:
+ *   dev   - The network device that will send the packet
+ *   proto - IP_PROTO_TCP or IP_PROTO_UDP
+ *   iplen - The length of the IP header, including IPv6 extension headers
+ *
+ * Returned Value:
+ *   True if the checksum is offloaded; false if the caller has to compute
+ *   it in software.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+bool netdev_txcsum_offload(FAR struct net_driver_s *dev, uint8_t proto,
+                           unsigned int iplen);
+#else
+#  define netdev_txcsum_offload(dev,proto,iplen) false
+#endif
+
+/****************************************************************************
+ * Name: netdev_busypoll
+ *
+ * Description:
+ *   Run the receive path of the device in the calling thread until ready()
+ *   returns true or usec microseconds have passed.  Returns true if ready()
+ *   did.
+ *
+ * Assumptions:
+ *   Called with neither the device nor the connection locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+bool netdev_busypoll(FAR struct net_driver_s *dev, uint32_t usec,
+                     CODE bool (*ready)(FAR void *arg), FAR void *arg);
+#endif
+
 #ifdef CONFIG_NETDEV_RSS
 void netdev_notify_recvcpu(FAR struct net_driver_s *dev,
                            int cpu, uint8_t domain,
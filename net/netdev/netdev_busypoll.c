@@ -0,0 +1,92 @@
+/****************************************************************************
+ * net/netdev/netdev_busypoll.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+#ifdef CONFIG_NET_BUSY_POLL
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_busypoll
+ *
+ * Description:
+ *   Run the receive path of the device in the calling thread until ready()
+ *   returns true or usec microseconds have passed.
+ *
+ * Input Parameters:
+ *   dev   - The device to poll, may be NULL
+ *   usec  - The busy poll time of the socket
+ *   ready - Tells whether the data the caller waits for has arrived
+ *   arg   - The argument of ready()
+ *
+ * Returned Value:
+ *   true if ready() returned true; false if the time ran out or the device
+ *   cannot be polled.
+ *
+ * Assumptions:
+ *   Called with neither the device nor the connection locked.
+ *
+ ****************************************************************************/
+
+bool netdev_busypoll(FAR struct net_driver_s *dev, uint32_t usec,
+                     CODE bool (*ready)(FAR void *arg), FAR void *arg)
+{
+  clock_t start;
+  clock_t limit;
+
+  if (dev == NULL || dev->d_busypoll == NULL || usec == 0)
+    {
+      return false;
+    }
+
+  limit = (clock_t)((uint64_t)usec * perf_getfreq() / USEC_PER_SEC);
+  start = perf_gettime();
+
+  do
+    {
+      dev->d_busypoll(dev);
+      if (ready(arg))
+        {
+          return true;
+        }
+    }
+  while (perf_gettime() - start < limit);
+
+  return false;
+}
+
+#endif /* CONFIG_NET_BUSY_POLL */
@@ -194,6 +194,9 @@ void netdev_iob_clear(FAR struct net_driver_s *dev)
   dev->d_iob = NULL;
   dev->d_buf = NULL;
   dev->d_len = 0;
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumiob = NULL;
+#endif
 }
 
 /****************************************************************************
@@ -218,6 +221,9 @@ void netdev_iob_release(FAR struct net_driver_s *dev)
     }
 
   dev->d_buf = NULL;
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumiob = NULL;
+#endif
 }
 
 /****************************************************************************
@@ -85,6 +85,7 @@
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "utils/utils.h"
 
@@ -2052,6 +2053,7 @@ int netdev_ifup(FAR struct net_driver_s *dev)
               /* Mark the interface as up */
 
               dev->d_flags |= IFF_UP;
+              ipfwd_flowcache_flush();
 
               /* Update the driver status */
 
@@ -2086,6 +2088,7 @@ int netdev_ifdown(FAR struct net_driver_s *dev)
               /* Mark the interface as down */
 
               dev->d_flags &= ~(IFF_UP | IFF_RUNNING);
+              ipfwd_flowcache_flush();
 
               /* Update the driver status */
 
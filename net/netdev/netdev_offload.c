@@ -0,0 +1,138 @@
+/****************************************************************************
+ * net/netdev/netdev_offload.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
+
+#include "netdev/netdev.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NETDEV_OFFLOAD
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_txcsum_offload
+ *
+ * Description:
+ *   Leave the TCP or UDP checksum of the outgoing packet in d_iob to the
+ *   network device, if it has NETDEV_FEATURE_TXCSUM.  The checksum field
+ *   is set to the sum of the pseudo header, which the hardware completes
+ *   with the sum of the L4 header and payload, and the offsets needed for
+ *   that are recorded in the packet metadata.
+ *
+ *   Any offload flags left in the packet, e.g. by the driver when the
+ *   buffer of a received packet is reused for the reply, are cleared.
+ *
+ * Input Parameters:
+ *   dev   - The network device that will send the packet
+ *   proto - IP_PROTO_TCP or IP_PROTO_UDP
+ *   iplen - The length of the IP header, including IPv6 extension headers
+ *
+ * Returned Value:
+ *   True if the checksum is offloaded; false if the caller has to compute
+ *   it in software.
+ *
+ * Assumptions:
+ *   The IP header of the packet has been built.
+ *
+ ****************************************************************************/
+
+bool netdev_txcsum_offload(FAR struct net_driver_s *dev, uint8_t proto,
+                           unsigned int iplen)
+{
+  FAR struct iob_pktmeta_s *meta;
+  FAR uint16_t *chksum_field;
+  uint16_t upperlen;
+  uint16_t sum;
+
+  DEBUGASSERT(dev->d_iob != NULL);
+
+  meta        = &dev->d_iob->io_meta;
+  meta->flags = 0;
+
+  if (!NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TXCSUM))
+    {
+      return false;
+    }
+
+  /* Sum the pseudo-header: IP protocol, upper layer length and the IP
+   * source and destination addresses.
+   */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      upperlen = (((uint16_t)ipv6->len[0] << 8) + ipv6->len[1]) -
+                 (iplen - IPv6_HDRLEN);
+      sum      = chksum(upperlen + proto, (FAR uint8_t *)ipv6->srcipaddr,
+                        2 * sizeof(net_ipv6addr_t));
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      upperlen = (((uint16_t)ipv4->len[0] << 8) + ipv4->len[1]) - iplen;
+      sum      = chksum(upperlen + proto, (FAR uint8_t *)ipv4->srcipaddr,
+                        2 * sizeof(in_addr_t));
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  meta->flags   = NETPKT_TX_CSUM;
+  meta->l4off   = iplen;
+  meta->csumoff = proto == IP_PROTO_TCP ?
+                  offsetof(struct tcp_hdr_s, tcpchksum) :
+                  offsetof(struct udp_hdr_s, udpchksum);
+
+  /* The hardware sums the L4 header including this field, so it must hold
+   * the uncomplemented pseudo-header sum.
+   */
+
+  chksum_field  = IPBUF(iplen + meta->csumoff);
+  *chksum_field = HTONS(sum);
+  return true;
+}
+
+#endif /* CONFIG_NETDEV_OFFLOAD */
@@ -37,6 +37,7 @@
 #include <net/ethernet.h>
 #include <nuttx/net/netdev.h>
 
+#include "ipforward/ipforward.h"
 #include "mld/mld.h"
 #include "utils/utils.h"
 #include "netdev/netdev.h"
@@ -163,6 +164,10 @@ int netdev_unregister(FAR struct net_driver_s *dev)
 
       netdev_list_unlock();
 
+      /* No cached forwarding decision may refer to the device any more */
+
+      ipfwd_flowcache_flush();
+
       nxrmutex_destroy(&dev->d_lock);
 
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
@@ -54,6 +54,9 @@
 
 struct devif_callback_s; /* Forward reference */
 struct pollfd;           /* Forward reference */
+struct pkt_ring_s;       /* Forward reference */
+struct pkt_filter_s;     /* Forward reference */
+struct mm_map_entry_s;   /* Forward reference */
 
 /* This is a container that holds the poll-related information */
 
@@ -98,12 +101,24 @@ struct pkt_conn_s
    *
    *   readahead - A singly linked list of type struct iob_qentry_s
    *               where the PKT read-ahead data is retained.
-   *
-   * TODO: Maybe support PACKET_MMAP for further optimize.
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
 
+#ifdef CONFIG_NET_PKT_RING
+  /* With a PACKET_RX_RING the frames go to the ring instead of the
+   * read-ahead queue.  The ring is set and cleared with both the list of
+   * connections and the connection locked.
+   */
+
+  FAR struct pkt_ring_s *ring;
+  uint8_t    tpversion;           /* PACKET_VERSION */
+#endif
+
+#ifdef CONFIG_NET_PKT_FILTER
+  FAR struct pkt_filter_s *filter; /* SO_ATTACH_FILTER, under the list lock */
+#endif
+
   FAR struct iob_s  *pendiob;     /* The iob currently being sent */
 
   /* The following is a list of poll structures of threads waiting for
@@ -463,6 +478,100 @@ int pkt_setsockopt(FAR struct socket *psock, int level, int option,
 
 #endif
 
+#ifdef CONFIG_NET_PKT_RING
+/****************************************************************************
+ * Name: pkt_ring_setsockopt / pkt_ring_getsockopt
+ *
+ * Description:
+ *   Handle the PACKET_VERSION, PACKET_RX_RING and PACKET_STATISTICS
+ *   options of a packet socket.
+ *
+ ****************************************************************************/
+
+int pkt_ring_setsockopt(FAR struct pkt_conn_s *conn, int option,
+                        FAR const void *value, socklen_t value_len);
+int pkt_ring_getsockopt(FAR struct pkt_conn_s *conn, int option,
+                        FAR void *value, FAR socklen_t *value_len);
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ *
+ * Description:
+ *   Map the receive ring of a packet socket into the caller.
+ *
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map);
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ *
+ * Description:
+ *   Copy the first snaplen bytes of the received frame into the ring of
+ *   the connection.  The frame is dropped if the ring is full.
+ *
+ * Assumptions:
+ *   Called from pkt_input() with the list of connections locked.
+ *
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn, unsigned int snaplen);
+
+/****************************************************************************
+ * Name: pkt_ring_ready
+ *
+ * Description:
+ *   Return true if a block of the ring is ready to be read.
+ *
+ * Assumptions:
+ *   The connection is locked.
+ *
+ ****************************************************************************/
+
+bool pkt_ring_ready(FAR struct pkt_conn_s *conn);
+
+/****************************************************************************
+ * Name: pkt_ring_detach
+ *
+ * Description:
+ *   Take the ring off a connection that is being closed.  The memory stays
+ *   until the last mapping of the ring is gone.
+ *
+ ****************************************************************************/
+
+void pkt_ring_detach(FAR struct pkt_conn_s *conn);
+#endif
+
+#ifdef CONFIG_NET_PKT_FILTER
+/****************************************************************************
+ * Name: pkt_filter_setsockopt
+ *
+ * Description:
+ *   Attach (SO_ATTACH_FILTER) or remove (SO_DETACH_FILTER) the socket
+ *   filter of a connection.
+ *
+ ****************************************************************************/
+
+int pkt_filter_setsockopt(FAR struct pkt_conn_s *conn, int option,
+                          FAR const void *value, socklen_t value_len);
+
+/****************************************************************************
+ * Name: pkt_filter_run
+ *
+ * Description:
+ *   Run the filter of the connection on the received frame.  Returns the
+ *   number of bytes of the frame to keep, 0 to drop it.
+ *
+ * Assumptions:
+ *   Called from pkt_input() with the list of connections locked.
+ *
+ ****************************************************************************/
+
+unsigned int pkt_filter_run(FAR struct net_driver_s *dev,
+                            FAR struct pkt_conn_s *conn);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
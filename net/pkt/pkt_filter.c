@@ -0,0 +1,541 @@
+/****************************************************************************
+ * net/pkt/pkt_filter.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <net/bpf.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_PKT_FILTER
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A validated copy of the program attached to a connection */
+
+struct pkt_filter_s
+{
+  uint16_t len;
+  struct sock_filter insns[1];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_filter_check
+ *
+ * Description:
+ *   Validate a program the way Linux does for classic BPF: every
+ *   instruction is known, jumps only go forward and stay in the program,
+ *   the scratch memory indexes are in range, no constant divides by zero
+ *   and the program ends with a return.  A valid program always stops.
+ *
+ ****************************************************************************/
+
+static int pkt_filter_check(FAR const struct sock_filter *insns, int len)
+{
+  FAR const struct sock_filter *insn;
+  int pc;
+
+  for (pc = 0; pc < len; pc++)
+    {
+      insn = &insns[pc];
+
+      switch (insn->code)
+        {
+          case BPF_LD | BPF_W | BPF_ABS:
+          case BPF_LD | BPF_H | BPF_ABS:
+          case BPF_LD | BPF_B | BPF_ABS:
+          case BPF_LD | BPF_W | BPF_IND:
+          case BPF_LD | BPF_H | BPF_IND:
+          case BPF_LD | BPF_B | BPF_IND:
+          case BPF_LD | BPF_W | BPF_LEN:
+          case BPF_LD | BPF_IMM:
+          case BPF_LDX | BPF_W | BPF_LEN:
+          case BPF_LDX | BPF_W | BPF_IMM:
+          case BPF_LDX | BPF_B | BPF_MSH:
+          case BPF_ALU | BPF_ADD | BPF_K:
+          case BPF_ALU | BPF_ADD | BPF_X:
+          case BPF_ALU | BPF_SUB | BPF_K:
+          case BPF_ALU | BPF_SUB | BPF_X:
+          case BPF_ALU | BPF_MUL | BPF_K:
+          case BPF_ALU | BPF_MUL | BPF_X:
+          case BPF_ALU | BPF_DIV | BPF_X:
+          case BPF_ALU | BPF_MOD | BPF_X:
+          case BPF_ALU | BPF_AND | BPF_K:
+          case BPF_ALU | BPF_AND | BPF_X:
+          case BPF_ALU | BPF_OR | BPF_K:
+          case BPF_ALU | BPF_OR | BPF_X:
+          case BPF_ALU | BPF_XOR | BPF_K:
+          case BPF_ALU | BPF_XOR | BPF_X:
+          case BPF_ALU | BPF_LSH | BPF_X:
+          case BPF_ALU | BPF_RSH | BPF_X:
+          case BPF_ALU | BPF_NEG:
+          case BPF_RET | BPF_K:
+          case BPF_RET | BPF_A:
+          case BPF_MISC | BPF_TAX:
+          case BPF_MISC | BPF_TXA:
+            break;
+
+          case BPF_ALU | BPF_DIV | BPF_K:
+          case BPF_ALU | BPF_MOD | BPF_K:
+            if (insn->k == 0)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_ALU | BPF_LSH | BPF_K:
+          case BPF_ALU | BPF_RSH | BPF_K:
+            if (insn->k >= 32)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_LD | BPF_MEM:
+          case BPF_LDX | BPF_MEM:
+          case BPF_ST:
+          case BPF_STX:
+            if (insn->k >= BPF_MEMWORDS)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_JMP | BPF_JA:
+            if (insn->k >= (uint32_t)(len - pc - 1))
+              {
+                return -EINVAL;
+              }
+            break;
+
+          case BPF_JMP | BPF_JEQ | BPF_K:
+          case BPF_JMP | BPF_JEQ | BPF_X:
+          case BPF_JMP | BPF_JGT | BPF_K:
+          case BPF_JMP | BPF_JGT | BPF_X:
+          case BPF_JMP | BPF_JGE | BPF_K:
+          case BPF_JMP | BPF_JGE | BPF_X:
+          case BPF_JMP | BPF_JSET | BPF_K:
+          case BPF_JMP | BPF_JSET | BPF_X:
+            if (pc + 1 + insn->jt >= len || pc + 1 + insn->jf >= len)
+              {
+                return -EINVAL;
+              }
+            break;
+
+          default:
+            return -EINVAL;
+        }
+    }
+
+  return BPF_CLASS(insns[len - 1].code) == BPF_RET ? OK : -EINVAL;
+}
+
+/****************************************************************************
+ * Name: pkt_filter_load
+ *
+ * Description:
+ *   Load size bytes at offset off of the frame, in network order.  Most
+ *   loads are in the first I/O buffer, which holds the headers.  Returns
+ *   false if the bytes are past the end of the frame.
+ *
+ ****************************************************************************/
+
+static bool pkt_filter_load(FAR struct net_driver_s *dev, uint32_t off,
+                            unsigned int size, FAR uint32_t *value)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  unsigned int llhdrlen = NET_LL_HDRLEN(dev);
+  FAR const uint8_t *p;
+  uint8_t buf[4];
+
+  if (off >= dev->d_len || size > dev->d_len - off)
+    {
+      return false;
+    }
+
+  if (off + size <= iob->io_len + llhdrlen)
+    {
+      p = &iob->io_data[iob->io_offset - llhdrlen + off];
+    }
+  else if (iob_copyout(buf, iob, size, (int)off - (int)llhdrlen) ==
+           (int)size)
+    {
+      p = buf;
+    }
+  else
+    {
+      return false;
+    }
+
+  switch (size)
+    {
+      case 1:
+        *value = p[0];
+        break;
+
+      case 2:
+        *value = (uint32_t)p[0] << 8 | p[1];
+        break;
+
+      default:
+        *value = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 |
+                 (uint32_t)p[2] << 8 | p[3];
+        break;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_filter_setsockopt
+ ****************************************************************************/
+
+int pkt_filter_setsockopt(FAR struct pkt_conn_s *conn, int option,
+                          FAR const void *value, socklen_t value_len)
+{
+  FAR const struct sock_fprog *fprog = value;
+  FAR struct pkt_filter_s *filter = NULL;
+  FAR struct pkt_filter_s *old;
+  int ret;
+
+  if (option == SO_ATTACH_FILTER)
+    {
+      if (value == NULL || value_len < sizeof(struct sock_fprog) ||
+          fprog->filter == NULL || fprog->len == 0 ||
+          fprog->len > BPF_MAXINSNS)
+        {
+          return -EINVAL;
+        }
+
+      filter = kmm_malloc(offsetof(struct pkt_filter_s, insns) +
+                          fprog->len * sizeof(struct sock_filter));
+      if (filter == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      /* Check the copy, the caller might still change the original */
+
+      filter->len = fprog->len;
+      memcpy(filter->insns, fprog->filter,
+             fprog->len * sizeof(struct sock_filter));
+
+      ret = pkt_filter_check(filter->insns, filter->len);
+      if (ret < 0)
+        {
+          nerr("ERROR: Invalid socket filter\n");
+          kmm_free(filter);
+          return ret;
+        }
+    }
+
+  /* pkt_input() runs the filter with the list locked */
+
+  pkt_conn_list_lock();
+  old          = conn->filter;
+  conn->filter = filter;
+  pkt_conn_list_unlock();
+
+  if (old == NULL && option == SO_DETACH_FILTER)
+    {
+      return -ENOENT;
+    }
+
+  kmm_free(old);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_filter_run
+ ****************************************************************************/
+
+unsigned int pkt_filter_run(FAR struct net_driver_s *dev,
+                            FAR struct pkt_conn_s *conn)
+{
+  FAR const struct pkt_filter_s *filter = conn->filter;
+  FAR const struct sock_filter *insn;
+  uint32_t a = 0;
+  uint32_t x = 0;
+  uint32_t v;
+  int pc;
+  uint32_t mem[BPF_MEMWORDS] =
+  {
+    0
+  };
+
+  if (filter == NULL)
+    {
+      return dev->d_len;
+    }
+
+  for (pc = 0; pc < filter->len; pc++)
+    {
+      insn = &filter->insns[pc];
+
+      switch (insn->code)
+        {
+          case BPF_LD | BPF_W | BPF_ABS:
+          case BPF_LD | BPF_H | BPF_ABS:
+          case BPF_LD | BPF_B | BPF_ABS:
+          case BPF_LD | BPF_W | BPF_IND:
+          case BPF_LD | BPF_H | BPF_IND:
+          case BPF_LD | BPF_B | BPF_IND:
+            v = insn->k;
+            if (BPF_MODE(insn->code) == BPF_IND)
+              {
+                v += x;
+              }
+
+            /* A load past the end of the frame rejects it */
+
+            if (!pkt_filter_load(dev, v,
+                                 BPF_SIZE(insn->code) == BPF_W ? 4 :
+                                 BPF_SIZE(insn->code) == BPF_H ? 2 : 1,
+                                 &a))
+              {
+                return 0;
+              }
+            break;
+
+          case BPF_LD | BPF_W | BPF_LEN:
+            a = dev->d_len;
+            break;
+
+          case BPF_LD | BPF_IMM:
+            a = insn->k;
+            break;
+
+          case BPF_LD | BPF_MEM:
+            a = mem[insn->k];
+            break;
+
+          case BPF_LDX | BPF_W | BPF_LEN:
+            x = dev->d_len;
+            break;
+
+          case BPF_LDX | BPF_W | BPF_IMM:
+            x = insn->k;
+            break;
+
+          case BPF_LDX | BPF_MEM:
+            x = mem[insn->k];
+            break;
+
+          case BPF_LDX | BPF_B | BPF_MSH:
+            if (!pkt_filter_load(dev, insn->k, 1, &v))
+              {
+                return 0;
+              }
+
+            x = (v & 0xf) << 2;
+            break;
+
+          case BPF_ST:
+            mem[insn->k] = a;
+            break;
+
+          case BPF_STX:
+            mem[insn->k] = x;
+            break;
+
+          case BPF_ALU | BPF_ADD | BPF_K:
+            a += insn->k;
+            break;
+
+          case BPF_ALU | BPF_ADD | BPF_X:
+            a += x;
+            break;
+
+          case BPF_ALU | BPF_SUB | BPF_K:
+            a -= insn->k;
+            break;
+
+          case BPF_ALU | BPF_SUB | BPF_X:
+            a -= x;
+            break;
+
+          case BPF_ALU | BPF_MUL | BPF_K:
+            a *= insn->k;
+            break;
+
+          case BPF_ALU | BPF_MUL | BPF_X:
+            a *= x;
+            break;
+
+          case BPF_ALU | BPF_DIV | BPF_K:
+            a /= insn->k;
+            break;
+
+          case BPF_ALU | BPF_DIV | BPF_X:
+            if (x == 0)
+              {
+                return 0;
+              }
+
+            a /= x;
+            break;
+
+          case BPF_ALU | BPF_MOD | BPF_K:
+            a %= insn->k;
+            break;
+
+          case BPF_ALU | BPF_MOD | BPF_X:
+            if (x == 0)
+              {
+                return 0;
+              }
+
+            a %= x;
+            break;
+
+          case BPF_ALU | BPF_AND | BPF_K:
+            a &= insn->k;
+            break;
+
+          case BPF_ALU | BPF_AND | BPF_X:
+            a &= x;
+            break;
+
+          case BPF_ALU | BPF_OR | BPF_K:
+            a |= insn->k;
+            break;
+
+          case BPF_ALU | BPF_OR | BPF_X:
+            a |= x;
+            break;
+
+          case BPF_ALU | BPF_XOR | BPF_K:
+            a ^= insn->k;
+            break;
+
+          case BPF_ALU | BPF_XOR | BPF_X:
+            a ^= x;
+            break;
+
+          case BPF_ALU | BPF_LSH | BPF_K:
+            a <<= insn->k;
+            break;
+
+          case BPF_ALU | BPF_LSH | BPF_X:
+            a = x < 32 ? a << x : 0;
+            break;
+
+          case BPF_ALU | BPF_RSH | BPF_K:
+            a >>= insn->k;
+            break;
+
+          case BPF_ALU | BPF_RSH | BPF_X:
+            a = x < 32 ? a >> x : 0;
+            break;
+
+          case BPF_ALU | BPF_NEG:
+            a = -a;
+            break;
+
+          case BPF_JMP | BPF_JA:
+            pc += insn->k;
+            break;
+
+          case BPF_JMP | BPF_JEQ | BPF_K:
+            pc += a == insn->k ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JEQ | BPF_X:
+            pc += a == x ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JGT | BPF_K:
+            pc += a > insn->k ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JGT | BPF_X:
+            pc += a > x ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JGE | BPF_K:
+            pc += a >= insn->k ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JGE | BPF_X:
+            pc += a >= x ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JSET | BPF_K:
+            pc += (a & insn->k) != 0 ? insn->jt : insn->jf;
+            break;
+
+          case BPF_JMP | BPF_JSET | BPF_X:
+            pc += (a & x) != 0 ? insn->jt : insn->jf;
+            break;
+
+          case BPF_RET | BPF_K:
+            return MIN(insn->k, dev->d_len);
+
+          case BPF_RET | BPF_A:
+            return MIN(a, dev->d_len);
+
+          case BPF_MISC | BPF_TAX:
+            x = a;
+            break;
+
+          case BPF_MISC | BPF_TXA:
+            a = x;
+            break;
+
+          default:
+            return 0;
+        }
+    }
+
+  /* Not reached, a checked program ends with a return */
+
+  return 0;
+}
+
+#endif /* CONFIG_NET_PKT_FILTER */
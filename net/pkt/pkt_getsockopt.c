@@ -32,6 +32,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <netpacket/packet.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/pkt.h>
 
@@ -113,6 +114,13 @@ int pkt_getsockopt(FAR struct socket *psock, int level, int option,
           }
 #endif
 
+#ifdef CONFIG_NET_PKT_RING
+      case PACKET_VERSION:
+      case PACKET_STATISTICS:
+        ret = pkt_ring_getsockopt(psock->s_conn, option, value, value_len);
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized RAW PKT socket option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -160,6 +160,7 @@ static int pkt_in(FAR struct net_driver_s *dev)
   conn = pkt_active(dev);
   if (conn)
     {
+      uint16_t len = dev->d_len;
       uint32_t flags;
 
       if (conn->pendiob == dev->d_iob)
@@ -181,6 +182,34 @@ static int pkt_in(FAR struct net_driver_s *dev)
         }
 #endif /* CONFIG_NET_TIMESTAMP */
 
+#ifdef CONFIG_NET_PKT_FILTER
+      /* The frames that the socket filter rejects are dropped here, the
+       * others are seen truncated to the length that it returned.
+       */
+
+      dev->d_len = pkt_filter_run(dev, conn);
+      if (dev->d_len == 0)
+        {
+          dev->d_len = len;
+          pkt_conn_list_unlock();
+          return OK;
+        }
+#endif
+
+#ifdef CONFIG_NET_PKT_RING
+      /* With a receive ring the frame is copied into it, recvmsg() and
+       * poll() do not see it as new data.
+       */
+
+      if (conn->ring != NULL)
+        {
+          pkt_ring_input(dev, conn, dev->d_len);
+          dev->d_len = len;
+          pkt_conn_list_unlock();
+          return OK;
+        }
+#endif
+
       /* Setup for the application callback */
 
       dev->d_appdata = dev->d_buf;
@@ -208,6 +237,10 @@ static int pkt_in(FAR struct net_driver_s *dev)
               ret = -EAGAIN;
             }
         }
+
+      /* The rest of the network sees the whole frame */
+
+      dev->d_len = len;
     }
   else
     {
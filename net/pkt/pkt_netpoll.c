@@ -252,6 +252,15 @@ int pkt_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       eventset |= POLLRDNORM;
     }
 
+#ifdef CONFIG_NET_PKT_RING
+  /* Or a block of the receive ring is waiting to be read */
+
+  if (pkt_ring_ready(conn))
+    {
+      eventset |= POLLRDNORM;
+    }
+#endif
+
   /* Check for write data availability now */
 
   if (psock_pkt_cansend(conn) >= 0)
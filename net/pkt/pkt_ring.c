@@ -0,0 +1,715 @@
+/****************************************************************************
+ * net/pkt/pkt_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <debug.h>
+
+#include <sys/param.h>
+#include <sys/socket.h>
+#include <net/ethernet.h>
+#include <net/if_arp.h>
+#include <netpacket/packet.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/mm/map.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+
+#include "socket/socket.h"
+#include "utils/utils.h"
+#include "pkt/pkt.h"
+
+#ifdef CONFIG_NET_PKT_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The block header, then the private area of the application, then the
+ * frames.  A frame is its header, its struct sockaddr_ll and the data from
+ * the link layer header on.
+ */
+
+#define RING_BLKHDRLEN   ALIGN_UP(sizeof(struct tpacket_block_desc), 8)
+#define RING_SLLOFF      TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+#define RING_MACOFF      TPACKET_ALIGN(TPACKET3_HDRLEN)
+
+/* Retire a block that is partly filled after this long by default */
+
+#define RING_DEFAULT_TOV 8
+
+#define RING_BLOCK(r, n) \
+  ((FAR struct tpacket_block_desc *)((r)->base + \
+                                     (size_t)(n) * (r)->blocksize))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct pkt_ring_s
+{
+  FAR uint8_t *base;             /* nblocks blocks of blocksize bytes */
+  size_t       size;
+  uint32_t     blocksize;
+  uint32_t     nblocks;
+  uint32_t     firstoff;         /* Offset of the first frame of a block */
+
+  /* The block being filled, under the list lock */
+
+  uint32_t     block;
+  uint32_t     offset;           /* Where its next frame goes */
+  uint32_t     last;             /* Offset of its last frame, 0 if none */
+  bool         open;             /* A frame is in it */
+  bool         losing;           /* Frames were dropped since the last one */
+  clock_t      start;            /* When its first frame came */
+  clock_t      tov;
+  uint64_t     seq;
+  struct tpacket_stats_v3 stats;
+
+  FAR struct pkt_conn_s *conn;
+  struct work_s work;            /* Retires the block after tov */
+
+  /* The ring is freed when it is off the connection and no longer mapped */
+
+  spinlock_t   lock;
+  uint16_t     nmaps;
+  bool         detached;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ETHERNET
+static const uint8_t g_pkt_ring_bcast[ETHER_ADDR_LEN] =
+{
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_put
+ *
+ * Description:
+ *   Drop a mapping (nmaps) or the connection (detached) from the ring and
+ *   free it with the last of them.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_put(FAR struct pkt_ring_s *ring, bool detach)
+{
+  irqstate_t flags;
+  bool release;
+
+  flags = spin_lock_irqsave(&ring->lock);
+  if (detach)
+    {
+      ring->detached = true;
+    }
+  else
+    {
+      ring->nmaps--;
+    }
+
+  release = ring->detached && ring->nmaps == 0;
+  spin_unlock_irqrestore(&ring->lock, flags);
+
+  if (release)
+    {
+      kumm_free(ring->base);
+      kmm_free(ring);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_munmap
+ ****************************************************************************/
+
+static int pkt_ring_munmap(FAR struct task_group_s *group,
+                           FAR struct mm_map_entry_s *entry,
+                           FAR void *start, size_t length)
+{
+  FAR struct pkt_ring_s *ring = entry->priv.p;
+  int ret;
+
+  /* The ring cannot be unmapped piecewise */
+
+  if (start != entry->vaddr || length < entry->length)
+    {
+      return -EINVAL;
+    }
+
+  ret = mm_map_remove(get_group_mm(group), entry);
+  pkt_ring_put(ring, false);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_notify
+ *
+ * Description:
+ *   Tell the pollers of the connection that a block is ready.  Called
+ *   with the list of connections locked.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_notify(FAR struct pkt_conn_s *conn)
+{
+  int i;
+
+  conn_lock(&conn->sconn);
+  for (i = 0; i < CONFIG_NET_PKT_NPOLLWAITERS; i++)
+    {
+      if (conn->pollinfo[i].conn != NULL)
+        {
+          poll_notify(&conn->pollinfo[i].fds, 1, POLLIN);
+        }
+    }
+
+  conn_unlock(&conn->sconn);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_retire
+ *
+ * Description:
+ *   Hand the block being filled to the application.  Called with the list
+ *   of connections locked.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_retire(FAR struct pkt_ring_s *ring, uint32_t status)
+{
+  FAR struct tpacket_hdr_v1 *bh1 = &RING_BLOCK(ring, ring->block)->hdr.bh1;
+
+  bh1->blk_len = ring->offset;
+  bh1->seq_num = ring->seq++;
+  if (ring->losing)
+    {
+      status |= TP_STATUS_LOSING;
+      ring->losing = false;
+    }
+
+  /* The frames must be visible before the block is */
+
+  SMP_MB();
+  bh1->block_status = TP_STATUS_USER | status;
+
+  ring->block = (ring->block + 1) % ring->nblocks;
+  ring->open  = false;
+  pkt_ring_notify(ring->conn);
+}
+
+/****************************************************************************
+ * Name: pkt_ring_timeout
+ *
+ * Description:
+ *   Retire the block being filled once it is tov old, so that a slow
+ *   stream of frames does not wait in a block for long.
+ *
+ ****************************************************************************/
+
+static void pkt_ring_timeout(FAR void *arg)
+{
+  FAR struct pkt_ring_s *ring = arg;
+  clock_t elapsed;
+
+  pkt_conn_list_lock();
+
+  /* The ring may have been taken off the connection meanwhile */
+
+  if (ring->conn->ring == ring && ring->open)
+    {
+      elapsed = clock_systime_ticks() - ring->start;
+      if (elapsed >= ring->tov)
+        {
+          pkt_ring_retire(ring, TP_STATUS_BLK_TMO);
+        }
+      else
+        {
+          work_queue(LPWORK, &ring->work, pkt_ring_timeout, ring,
+                     ring->tov - elapsed);
+        }
+    }
+
+  pkt_conn_list_unlock();
+}
+
+/****************************************************************************
+ * Name: pkt_ring_open
+ *
+ * Description:
+ *   Start to fill the next block, if the application gave it back.
+ *
+ ****************************************************************************/
+
+static bool pkt_ring_open(FAR struct pkt_ring_s *ring)
+{
+  FAR struct tpacket_hdr_v1 *bh1 = &RING_BLOCK(ring, ring->block)->hdr.bh1;
+
+  if (bh1->block_status != TP_STATUS_KERNEL)
+    {
+      return false;
+    }
+
+  /* Do not touch the block before the application is done with it */
+
+  SMP_MB();
+  bh1->num_pkts            = 0;
+  bh1->offset_to_first_pkt = ring->firstoff;
+  ring->offset             = ring->firstoff;
+  ring->last               = 0;
+  ring->open               = true;
+  ring->start              = clock_systime_ticks();
+
+  if (work_available(&ring->work))
+    {
+      work_queue(LPWORK, &ring->work, pkt_ring_timeout, ring, ring->tov);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_create
+ *
+ * Description:
+ *   Allocate the ring described by a PACKET_RX_RING request.
+ *
+ ****************************************************************************/
+
+static int pkt_ring_create(FAR struct pkt_conn_s *conn,
+                           FAR const struct tpacket_req3 *req,
+                           FAR struct pkt_ring_s **pring)
+{
+  FAR struct tpacket_block_desc *bd;
+  FAR struct pkt_ring_s *ring;
+  uint32_t firstoff;
+  uint32_t i;
+
+  firstoff = RING_BLKHDRLEN + ALIGN_UP(req->tp_sizeof_priv, 8);
+
+  /* A block must hold at least one frame with some data */
+
+  if (req->tp_block_size % TPACKET_ALIGNMENT != 0 ||
+      req->tp_sizeof_priv > req->tp_block_size ||
+      req->tp_block_size < firstoff + RING_MACOFF + TPACKET_ALIGNMENT ||
+      req->tp_block_nr > SIZE_MAX / req->tp_block_size)
+    {
+      return -EINVAL;
+    }
+
+  ring = kmm_zalloc(sizeof(*ring));
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ring->size = (size_t)req->tp_block_size * req->tp_block_nr;
+  ring->base = kumm_memalign(TPACKET_ALIGNMENT, ring->size);
+  if (ring->base == NULL)
+    {
+      kmm_free(ring);
+      return -ENOMEM;
+    }
+
+  memset(ring->base, 0, ring->size);
+  ring->blocksize = req->tp_block_size;
+  ring->nblocks   = req->tp_block_nr;
+  ring->firstoff  = firstoff;
+  ring->conn      = conn;
+  ring->tov       = MAX(MSEC2TICK(req->tp_retire_blk_tov != 0 ?
+                                  req->tp_retire_blk_tov :
+                                  RING_DEFAULT_TOV), 1);
+  spin_lock_init(&ring->lock);
+
+  for (i = 0; i < ring->nblocks; i++)
+    {
+      bd = RING_BLOCK(ring, i);
+      bd->version                     = TPACKET_V3;
+      bd->offset_to_priv              = RING_BLKHDRLEN;
+      bd->hdr.bh1.block_status        = TP_STATUS_KERNEL;
+      bd->hdr.bh1.offset_to_first_pkt = firstoff;
+    }
+
+  *pring = ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_swap
+ *
+ * Description:
+ *   Replace the ring of a connection, the old one is returned.
+ *
+ ****************************************************************************/
+
+static FAR struct pkt_ring_s *pkt_ring_swap(FAR struct pkt_conn_s *conn,
+                                            FAR struct pkt_ring_s *ring)
+{
+  FAR struct pkt_ring_s *old;
+
+  pkt_conn_list_lock();
+  conn_lock(&conn->sconn);
+  old        = conn->ring;
+  conn->ring = ring;
+  conn_unlock(&conn->sconn);
+  pkt_conn_list_unlock();
+
+  if (old != NULL)
+    {
+      /* pkt_ring_timeout() takes the list lock and finds the ring gone */
+
+      work_cancel_sync(LPWORK, &old->work);
+    }
+
+  return old;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pkt_ring_setsockopt
+ ****************************************************************************/
+
+int pkt_ring_setsockopt(FAR struct pkt_conn_s *conn, int option,
+                        FAR const void *value, socklen_t value_len)
+{
+  FAR const struct tpacket_req3 *req = value;
+  FAR struct pkt_ring_s *ring = NULL;
+  FAR struct pkt_ring_s *old;
+  int ret;
+
+  switch (option)
+    {
+      case PACKET_VERSION:
+        if (value_len < sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        /* Only the block based layout of TPACKET_V3 is supported */
+
+        if (*(FAR const int *)value != TPACKET_V3)
+          {
+            return -EINVAL;
+          }
+
+        if (conn->ring != NULL)
+          {
+            return -EBUSY;
+          }
+
+        conn->tpversion = TPACKET_V3;
+        return OK;
+
+      case PACKET_RX_RING:
+        if (value_len < sizeof(struct tpacket_req3) ||
+            conn->tpversion != TPACKET_V3)
+          {
+            return -EINVAL;
+          }
+
+        /* The blocks of a mapped ring cannot go away */
+
+        old = conn->ring;
+        if (old != NULL && old->nmaps > 0)
+          {
+            return -EBUSY;
+          }
+
+        if (req->tp_block_nr > 0)
+          {
+            ret = pkt_ring_create(conn, req, &ring);
+            if (ret < 0)
+              {
+                return ret;
+              }
+          }
+
+        old = pkt_ring_swap(conn, ring);
+        if (old != NULL)
+          {
+            pkt_ring_put(old, true);
+          }
+
+        return OK;
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_getsockopt
+ ****************************************************************************/
+
+int pkt_ring_getsockopt(FAR struct pkt_conn_s *conn, int option,
+                        FAR void *value, FAR socklen_t *value_len)
+{
+  FAR struct tpacket_stats_v3 *stats = value;
+
+  switch (option)
+    {
+      case PACKET_VERSION:
+        if (*value_len < sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        *(FAR int *)value = conn->tpversion;
+        *value_len = sizeof(int);
+        return OK;
+
+      case PACKET_STATISTICS:
+        if (*value_len < sizeof(struct tpacket_stats_v3))
+          {
+            return -EINVAL;
+          }
+
+        /* The counts start over after each read, as on Linux */
+
+        pkt_conn_list_lock();
+        if (conn->ring != NULL)
+          {
+            *stats = conn->ring->stats;
+            memset(&conn->ring->stats, 0, sizeof(conn->ring->stats));
+          }
+        else
+          {
+            memset(stats, 0, sizeof(*stats));
+          }
+
+        pkt_conn_list_unlock();
+        *value_len = sizeof(struct tpacket_stats_v3);
+        return OK;
+
+      default:
+        return -ENOPROTOOPT;
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_mmap
+ ****************************************************************************/
+
+int pkt_ring_mmap(FAR struct socket *psock, FAR struct mm_map_entry_s *map)
+{
+  FAR struct pkt_conn_s *conn = psock->s_conn;
+  FAR struct pkt_ring_s *ring;
+  irqstate_t flags;
+  int ret = -EINVAL;
+
+  pkt_conn_list_lock();
+  ring = conn->ring;
+  if (ring != NULL && map->offset == 0 && map->length == ring->size)
+    {
+      map->vaddr  = ring->base;
+      map->priv.p = ring;
+      map->munmap = pkt_ring_munmap;
+
+      ret = mm_map_add(get_current_mm(), map);
+      if (ret >= 0)
+        {
+          flags = spin_lock_irqsave(&ring->lock);
+          ring->nmaps++;
+          spin_unlock_irqrestore(&ring->lock, flags);
+        }
+    }
+
+  pkt_conn_list_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_input
+ ****************************************************************************/
+
+void pkt_ring_input(FAR struct net_driver_s *dev,
+                    FAR struct pkt_conn_s *conn, unsigned int snaplen)
+{
+  FAR struct pkt_ring_s *ring = conn->ring;
+  FAR struct tpacket_block_desc *bd;
+  FAR struct tpacket3_hdr *hdr;
+  FAR struct sockaddr_ll *sll;
+  FAR uint8_t *data;
+  struct timespec ts;
+  uint32_t room;
+
+  /* Find room for the frame, a frame that cannot fit even in an empty
+   * block is truncated.
+   */
+
+  for (; ; )
+    {
+      if (!ring->open && !pkt_ring_open(ring))
+        {
+          ring->stats.tp_drops++;
+          ring->stats.tp_freeze_q_cnt++;
+          ring->losing = true;
+          return;
+        }
+
+      bd   = RING_BLOCK(ring, ring->block);
+      room = ring->blocksize - ring->offset - RING_MACOFF;
+      if (snaplen <= room || bd->hdr.bh1.num_pkts == 0)
+        {
+          break;
+        }
+
+      pkt_ring_retire(ring, 0);
+    }
+
+  snaplen = MIN(snaplen, room);
+  hdr     = (FAR struct tpacket3_hdr *)((FAR uint8_t *)bd + ring->offset);
+  sll     = (FAR struct sockaddr_ll *)((FAR uint8_t *)hdr + RING_SLLOFF);
+  data    = (FAR uint8_t *)hdr + RING_MACOFF;
+
+  memset(hdr, 0, RING_MACOFF);
+  iob_copyout(data, dev->d_iob, snaplen, -NET_LL_HDRLEN(dev));
+
+  clock_gettime(CLOCK_REALTIME, &ts);
+  hdr->tp_sec     = ts.tv_sec;
+  hdr->tp_nsec    = ts.tv_nsec;
+  hdr->tp_snaplen = snaplen;
+  hdr->tp_len     = dev->d_len;
+  hdr->tp_status  = ring->losing ? TP_STATUS_LOSING : 0;
+  hdr->tp_mac     = RING_MACOFF;
+  hdr->tp_net     = RING_MACOFF + NET_LL_HDRLEN(dev);
+
+  sll->sll_family   = AF_PACKET;
+  sll->sll_ifindex  = dev->d_ifindex;
+  sll->sll_protocol = conn->type;
+
+#ifdef CONFIG_NET_ETHERNET
+  if (dev->d_lltype == NET_LL_ETHERNET && snaplen >= ETH_HDRLEN)
+    {
+      FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)data;
+
+      sll->sll_protocol = eth->type;
+      sll->sll_hatype   = ARPHRD_ETHER;
+      sll->sll_halen    = ETHER_ADDR_LEN;
+      memcpy(sll->sll_addr, eth->src, ETHER_ADDR_LEN);
+
+      if ((eth->dest[0] & 1) == 0)
+        {
+          sll->sll_pkttype =
+            memcmp(eth->dest, dev->d_mac.ether.ether_addr_octet,
+                   ETHER_ADDR_LEN) == 0 ? PACKET_HOST : PACKET_OTHERHOST;
+        }
+      else
+        {
+          sll->sll_pkttype =
+            memcmp(eth->dest, g_pkt_ring_bcast, ETHER_ADDR_LEN) == 0 ?
+            PACKET_BROADCAST : PACKET_MULTICAST;
+        }
+    }
+#endif
+
+  /* Link the frame after the previous one of the block */
+
+  if (ring->last != 0)
+    {
+      ((FAR struct tpacket3_hdr *)((FAR uint8_t *)bd + ring->last))->
+        tp_next_offset = ring->offset - ring->last;
+    }
+  else
+    {
+      bd->hdr.bh1.ts_first_pkt.ts_sec  = ts.tv_sec;
+      bd->hdr.bh1.ts_first_pkt.ts_nsec = ts.tv_nsec;
+    }
+
+  bd->hdr.bh1.ts_last_pkt.ts_sec  = ts.tv_sec;
+  bd->hdr.bh1.ts_last_pkt.ts_nsec = ts.tv_nsec;
+  bd->hdr.bh1.num_pkts++;
+  ring->last    = ring->offset;
+  ring->offset += TPACKET_ALIGN(RING_MACOFF + snaplen);
+  ring->stats.tp_packets++;
+
+  /* Retire the block now if no other frame fits in it */
+
+  if (ring->offset + RING_MACOFF >= ring->blocksize)
+    {
+      pkt_ring_retire(ring, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: pkt_ring_ready
+ ****************************************************************************/
+
+bool pkt_ring_ready(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = conn->ring;
+  uint32_t prev;
+
+  if (ring == NULL)
+    {
+      return false;
+    }
+
+  /* The block retired last is the one before the block being filled */
+
+  prev = (ring->block + ring->nblocks - 1) % ring->nblocks;
+  return (RING_BLOCK(ring, prev)->hdr.bh1.block_status &
+          TP_STATUS_USER) != 0;
+}
+
+/****************************************************************************
+ * Name: pkt_ring_detach
+ ****************************************************************************/
+
+void pkt_ring_detach(FAR struct pkt_conn_s *conn)
+{
+  FAR struct pkt_ring_s *ring = pkt_ring_swap(conn, NULL);
+
+  if (ring != NULL)
+    {
+      pkt_ring_put(ring, true);
+    }
+}
+
+#endif /* CONFIG_NET_PKT_RING */
@@ -79,6 +79,15 @@ int pkt_setsockopt(FAR struct socket *psock, int level, int option,
 
   DEBUGASSERT(value_len == 0 || value != NULL);
 
+#ifdef CONFIG_NET_PKT_FILTER
+  if (level == SOL_SOCKET &&
+      (option == SO_ATTACH_FILTER || option == SO_DETACH_FILTER))
+    {
+      return pkt_filter_setsockopt(psock->s_conn, option, value,
+                                   value_len);
+    }
+#endif
+
   if (level != SOL_PACKET)
     {
       return -ENOPROTOOPT;
@@ -123,6 +132,13 @@ int pkt_setsockopt(FAR struct socket *psock, int level, int option,
         }
 #endif
 
+#ifdef CONFIG_NET_PKT_RING
+      case PACKET_VERSION:
+      case PACKET_RX_RING:
+        ret = pkt_ring_setsockopt(psock->s_conn, option, value, value_len);
+        break;
+#endif
+
 #ifdef CONFIG_NET_MCASTGROUP
       case PACKET_ADD_MEMBERSHIP:
       case PACKET_DROP_MEMBERSHIP:
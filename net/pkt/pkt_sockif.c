@@ -83,9 +83,20 @@ const struct sock_intf_s g_pkt_sockif =
   NULL,            /* si_ioctl */
   NULL,            /* si_socketpair */
   NULL             /* si_shutdown */
-#if defined(CONFIG_NET_SOCKOPTS) && defined(CONFIG_NET_PKTPROTO_OPTIONS)
+#ifdef CONFIG_NET_SOCKOPTS
+#  ifdef CONFIG_NET_PKTPROTO_OPTIONS
   , pkt_getsockopt /* si_getsockopt */
   , pkt_setsockopt /* si_setsockopt */
+#  else
+  , NULL           /* si_getsockopt */
+  , NULL           /* si_setsockopt */
+#  endif
+#endif
+#ifdef CONFIG_NET_SENDFILE
+  , NULL           /* si_sendfile */
+#endif
+#ifdef CONFIG_NET_PKT_RING
+  , pkt_ring_mmap  /* si_mmap */
 #endif
 };
 
@@ -362,6 +373,13 @@ static int pkt_close(FAR struct socket *psock)
 
           if (conn->crefs <= 1)
             {
+#ifdef CONFIG_NET_PKT_FILTER
+              pkt_filter_setsockopt(conn, SO_DETACH_FILTER, NULL, 0);
+#endif
+#ifdef CONFIG_NET_PKT_RING
+              pkt_ring_detach(conn);
+#endif
+
               conn_dev_lock(&conn->sconn, dev);
 
               /* Yes... free any read-ahead data */
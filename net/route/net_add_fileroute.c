@@ -35,6 +35,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/route.h"
@@ -88,6 +89,8 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_closeroute_ipv4(&fshandle);
 
+  net_lpmroute_changed_ipv4();
+  ipfwd_flowcache_flush();
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
@@ -124,6 +127,8 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   net_closeroute_ipv6(&fshandle);
 
+  net_lpmroute_changed_ipv6();
+  ipfwd_flowcache_flush();
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET6);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
@@ -48,10 +48,12 @@
 
 #ifdef CONFIG_ROUTE_IPv4_RAMROUTE
 FAR struct net_route_ipv4_queue_s g_ipv4_routes;
+rw_semaphore_t g_ipv4_routelock = RWSEM_INITIALIZER;
 #endif
 
 #ifdef CONFIG_ROUTE_IPv6_RAMROUTE
 FAR struct net_route_ipv6_queue_s g_ipv6_routes;
+rw_semaphore_t g_ipv6_routelock = RWSEM_INITIALIZER;
 #endif
 
 /****************************************************************************
@@ -152,15 +154,15 @@ FAR struct net_route_ipv4_s *net_allocroute_ipv4(void)
 {
   FAR struct net_route_ipv4_entry_s *route;
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  down_write(&g_ipv4_routelock);
 
   /* Then add the remove the first entry from the table */
 
   route = ramroute_ipv4_remfirst(&g_free_ipv4routes);
 
-  net_unlock();
+  up_write(&g_ipv4_routelock);
   if (!route)
     {
       return NULL;
@@ -175,15 +177,15 @@ FAR struct net_route_ipv6_s *net_allocroute_ipv6(void)
 {
   FAR struct net_route_ipv6_entry_s *route;
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  down_write(&g_ipv6_routelock);
 
   /* Then add the remove the first entry from the table */
 
   route = ramroute_ipv6_remfirst(&g_free_ipv6routes);
 
-  net_unlock();
+  up_write(&g_ipv6_routelock);
   if (!route)
     {
       return NULL;
@@ -212,15 +214,15 @@ void net_freeroute_ipv4(FAR struct net_route_ipv4_s *route)
 {
   DEBUGASSERT(route);
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  down_write(&g_ipv4_routelock);
 
   /* Then add the new entry to the table */
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_free_ipv4routes);
-  net_unlock();
+  up_write(&g_ipv4_routelock);
 }
 #endif
 
@@ -229,15 +231,15 @@ void net_freeroute_ipv6(FAR struct net_route_ipv6_s *route)
 {
   DEBUGASSERT(route);
 
-  /* Get exclusive address to the networking data structures */
+  /* Get exclusive access to the routing table */
 
-  net_lock();
+  down_write(&g_ipv6_routelock);
 
   /* Then add the new entry to the table */
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_free_ipv6routes);
-  net_unlock();
+  up_write(&g_ipv6_routelock);
 }
 #endif
 
@@ -38,6 +38,7 @@
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
@@ -316,6 +317,8 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   filesize = (nentries - 1) * sizeof(struct net_route_ipv4_s);
   ret = file_truncate(&fshandle, filesize);
 
+  net_lpmroute_changed_ipv4();
+  ipfwd_flowcache_flush();
   netlink_route_notify(&match, RTM_DELROUTE, AF_INET);
 
 errout_with_fshandle:
@@ -469,6 +472,8 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
   filesize = (nentries - 1) * sizeof(struct net_route_ipv6_s);
   ret = file_truncate(&fshandle, filesize);
 
+  net_lpmroute_changed_ipv6();
+  ipfwd_flowcache_flush();
   netlink_route_notify(&match, RTM_DELROUTE, AF_INET6);
 
 errout_with_fshandle:
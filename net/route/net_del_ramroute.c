@@ -34,6 +34,7 @@
 #include <arpa/inet.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
 #include "route/route.h"
@@ -113,6 +114,8 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
           ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
+      net_lpmroute_changed_ipv4();
+      ipfwd_flowcache_flush();
       netlink_route_notify(route, RTM_DELROUTE, AF_INET);
 
       /* And free the routing table entry by adding it to the free list */
@@ -171,6 +174,8 @@ static int net_del_ipv6route(FAR struct net_route_ipv6_s *route,
           ramroute_ipv6_remfirst(&g_ipv6_routes);
         }
 
+      net_lpmroute_changed_ipv6();
+      ipfwd_flowcache_flush();
       netlink_route_notify(route, RTM_DELROUTE, AF_INET6);
 
       /* And free the routing table entry by adding it to the free list */
@@ -210,6 +215,7 @@ static int net_del_ipv6route(FAR struct net_route_ipv6_s *route,
 int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 {
   struct route_match_ipv4_s match;
+  int ret;
 
   /* Set up the comparison structure */
 
@@ -217,9 +223,15 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   net_ipv4addr_copy(match.target, target);
   net_ipv4addr_copy(match.netmask, netmask);
 
-  /* Then remove the entry from the routing table */
+  /* Then remove the entry from the routing table.  The write lock is held
+   * across the traversal because the handler modifies the table.
+   */
+
+  down_write(&g_ipv4_routelock);
+  ret = net_foreachroute_ipv4(net_del_ipv4route, &match) ? OK : -ENOENT;
+  up_write(&g_ipv4_routelock);
 
-  return net_foreachroute_ipv4(net_del_ipv4route, &match) ? OK : -ENOENT;
+  return ret;
 }
 #endif
 
@@ -227,6 +239,7 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 {
   struct route_match_ipv6_s match;
+  int ret;
 
   /* Set up the comparison structure */
 
@@ -234,9 +247,15 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
   net_ipv6addr_copy(match.target, target);
   net_ipv6addr_copy(match.netmask, netmask);
 
-  /* Then remove the entry from the routing table */
+  /* Then remove the entry from the routing table.  The write lock is held
+   * across the traversal because the handler modifies the table.
+   */
+
+  down_write(&g_ipv6_routelock);
+  ret = net_foreachroute_ipv6(net_del_ipv6route, &match) ? OK : -ENOENT;
+  up_write(&g_ipv6_routelock);
 
-  return net_foreachroute_ipv6(net_del_ipv6route, &match) ? OK : -ENOENT;
+  return ret;
 }
 #endif
 
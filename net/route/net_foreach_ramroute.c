@@ -66,9 +66,12 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg)
   FAR struct net_route_ipv4_entry_s *next;
   int ret = 0;
 
-  /* Prevent concurrent access to the routing table */
+  /* Prevent concurrent modification of the routing table.  Lookups may
+   * proceed in parallel.  A handler that modifies the table must be called
+   * with the write lock held, see net_delroute_ipv4().
+   */
 
-  net_lock();
+  down_read(&g_ipv4_routelock);
 
   /* Visit each entry in the routing table */
 
@@ -82,9 +85,9 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg)
       ret  = handler(&route->entry, arg);
     }
 
-  /* Unlock the network */
+  /* Unlock the routing table */
 
-  net_unlock();
+  up_read(&g_ipv4_routelock);
   return ret;
 }
 #endif
@@ -96,9 +99,12 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
   FAR struct net_route_ipv6_entry_s *next;
   int ret = 0;
 
-  /* Prevent concurrent access to the routing table */
+  /* Prevent concurrent modification of the routing table.  Lookups may
+   * proceed in parallel.  A handler that modifies the table must be called
+   * with the write lock held, see net_delroute_ipv6().
+   */
 
-  net_lock();
+  down_read(&g_ipv6_routelock);
 
   /* Visit each entry in the routing table */
 
@@ -112,9 +118,9 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
       ret  = handler(&route->entry, arg);
     }
 
-  /* Unlock the network */
+  /* Unlock the routing table */
 
-  net_unlock();
+  up_read(&g_ipv6_routelock);
   return ret;
 }
 #endif
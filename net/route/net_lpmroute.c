@@ -0,0 +1,582 @@
+/****************************************************************************
+ * net/route/net_lpmroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/rwsem.h>
+#include <nuttx/net/ip.h>
+
+#include "route/route.h"
+
+#if defined(CONFIG_NET_ROUTE) && defined(CONFIG_ROUTE_LPM)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Keys are addresses in host order, as 32-bit words from the most
+ * significant bit down.
+ */
+
+#define LPM_KEYWORDS        4
+
+#define LPM_BIT(key, n)     (((key)[(n) >> 5] >> (31 - ((n) & 31))) & 1)
+
+#define LPM_ROUTE(entry)    ((FAR void *)((entry) + 1))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A copy of one route, the route itself follows the link */
+
+struct lpm_route_s
+{
+  FAR struct lpm_route_s *flink;
+};
+
+/* One prefix of the trie.  Only the prefixes of the routes and the ones
+ * where two of them branch off have a node, a node without routes is
+ * such a branch point.
+ */
+
+struct lpm_node_s
+{
+  FAR struct lpm_node_s *child[2];  /* Longer prefixes, by the next bit */
+  FAR struct lpm_route_s *routes;   /* Routes of this prefix, table order */
+  uint32_t key[LPM_KEYWORDS];       /* The prefix, zero past plen */
+  uint8_t plen;                     /* Prefix length */
+};
+
+struct lpm_trie_s
+{
+  FAR struct lpm_node_s *root;
+  rw_semaphore_t lock;
+  atomic_t gen;                     /* Bumped for each route change */
+  int built;                        /* The gen the trie was built at */
+  bool usable;                      /* False if the table must be walked */
+  uint8_t nbits;                    /* Address length */
+  uint16_t routesize;               /* Size of one route */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static struct lpm_trie_s g_lpm_ipv4 =
+{
+  NULL, RWSEM_INITIALIZER, 0, -1, false, 32,
+  sizeof(struct net_route_ipv4_s)
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct lpm_trie_s g_lpm_ipv6 =
+{
+  NULL, RWSEM_INITIALIZER, 0, -1, false, 128,
+  sizeof(struct net_route_ipv6_s)
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   The number of leading bits that two keys have in common, up to max.
+ *
+ ****************************************************************************/
+
+static uint8_t lpm_common(FAR const uint32_t *key1,
+                          FAR const uint32_t *key2, uint8_t max)
+{
+  uint32_t diff;
+  int bits;
+  int i;
+
+  for (i = 0; i * 32 < max; i++)
+    {
+      diff = key1[i] ^ key2[i];
+      if (diff != 0)
+        {
+          bits = i * 32 + 32 - fls((int)diff);
+          return bits < max ? bits : max;
+        }
+    }
+
+  return max;
+}
+
+/****************************************************************************
+ * Name: lpm_prefixlen
+ *
+ * Description:
+ *   The prefix length of a netmask in key form, or -EINVAL if its bits are
+ *   not contiguous.
+ *
+ ****************************************************************************/
+
+static int lpm_prefixlen(FAR const uint32_t *mask, int nwords)
+{
+  int plen = 0;
+  int i;
+
+  for (i = 0; i < nwords && mask[i] == UINT32_MAX; i++)
+    {
+      plen += 32;
+    }
+
+  if (i < nwords)
+    {
+      /* A mask of ones then zeros is the complement of 2^n - 1 */
+
+      if ((~mask[i] & (~mask[i] + 1)) != 0)
+        {
+          return -EINVAL;
+        }
+
+      plen += mask[i] != 0 ? 32 - ffs((int)mask[i]) + 1 : 0;
+
+      while (++i < nwords)
+        {
+          if (mask[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: lpm_newnode
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_newnode(FAR const uint32_t *key,
+                                          uint8_t plen)
+{
+  FAR struct lpm_node_s *node;
+  int i;
+
+  node = kmm_zalloc(sizeof(struct lpm_node_s));
+  if (node != NULL)
+    {
+      node->plen = plen;
+      for (i = 0; i * 32 < plen; i++)
+        {
+          node->key[i] = key[i];
+        }
+
+      if ((plen & 31) != 0)
+        {
+          node->key[plen >> 5] &= UINT32_MAX << (32 - (plen & 31));
+        }
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: lpm_insert
+ *
+ * Description:
+ *   Add a copy of route under the prefix key/plen, after the routes of the
+ *   same prefix that are already there.
+ *
+ ****************************************************************************/
+
+static int lpm_insert(FAR struct lpm_trie_s *trie, FAR const uint32_t *key,
+                      uint8_t plen, FAR const void *route)
+{
+  FAR struct lpm_node_s **link = &trie->root;
+  FAR struct lpm_route_s **tail;
+  FAR struct lpm_route_s *entry;
+  FAR struct lpm_node_s *split;
+  FAR struct lpm_node_s *node;
+  FAR struct lpm_node_s *new;
+  uint8_t common = 0;
+
+  entry = kmm_malloc(sizeof(struct lpm_route_s) + trie->routesize);
+  if (entry == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  entry->flink = NULL;
+  memcpy(LPM_ROUTE(entry), route, trie->routesize);
+
+  /* Go down while the nodes are prefixes of the new one */
+
+  while ((node = *link) != NULL)
+    {
+      common = lpm_common(node->key, key, MIN(node->plen, plen));
+      if (common < node->plen)
+        {
+          break;
+        }
+
+      if (node->plen == plen)
+        {
+          for (tail = &node->routes; *tail != NULL; tail = &(*tail)->flink)
+            {
+            }
+
+          *tail = entry;
+          return OK;
+        }
+
+      link = &node->child[LPM_BIT(key, node->plen)];
+    }
+
+  new = lpm_newnode(key, plen);
+  if (new == NULL)
+    {
+      kmm_free(entry);
+      return -ENOMEM;
+    }
+
+  new->routes = entry;
+
+  if (node == NULL)
+    {
+      *link = new;
+    }
+  else if (common == plen)
+    {
+      /* The new prefix covers the node, it goes in between */
+
+      new->child[LPM_BIT(node->key, plen)] = node;
+      *link = new;
+    }
+  else
+    {
+      /* The two branch off after their common bits */
+
+      split = lpm_newnode(key, common);
+      if (split == NULL)
+        {
+          kmm_free(new);
+          kmm_free(entry);
+          return -ENOMEM;
+        }
+
+      split->child[LPM_BIT(key, common)] = new;
+      split->child[LPM_BIT(node->key, common)] = node;
+      *link = split;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_clear
+ *
+ * Description:
+ *   Free all nodes and routes of the trie.  The left subtrees are rotated
+ *   to the right first, so that no stack is needed.
+ *
+ ****************************************************************************/
+
+static void lpm_clear(FAR struct lpm_trie_s *trie)
+{
+  FAR struct lpm_node_s *node = trie->root;
+  FAR struct lpm_route_s *entry;
+  FAR struct lpm_node_s *next;
+
+  while (node != NULL)
+    {
+      if (node->child[0] != NULL)
+        {
+          next = node->child[0];
+          node->child[0] = next->child[1];
+          next->child[1] = node;
+        }
+      else
+        {
+          next = node->child[1];
+          while ((entry = node->routes) != NULL)
+            {
+              node->routes = entry->flink;
+              kmm_free(entry);
+            }
+
+          kmm_free(node);
+        }
+
+      node = next;
+    }
+
+  trie->root = NULL;
+}
+
+/****************************************************************************
+ * Name: lpm_next
+ *
+ * Description:
+ *   The next node on the path of key that is a prefix of key, the first
+ *   one if node is NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_next(FAR struct lpm_trie_s *trie,
+                                       FAR struct lpm_node_s *node,
+                                       FAR const uint32_t *key)
+{
+  if (node == NULL)
+    {
+      node = trie->root;
+    }
+  else if (node->plen < trie->nbits)
+    {
+      node = node->child[LPM_BIT(key, node->plen)];
+    }
+  else
+    {
+      return NULL;
+    }
+
+  if (node != NULL && lpm_common(node->key, key, node->plen) < node->plen)
+    {
+      return NULL;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: lpm_lock
+ *
+ * Description:
+ *   Lock the trie for a lookup, rebuilding it first if the routing table
+ *   changed since it was built.
+ *
+ * Returned Value:
+ *   True with the trie locked for reading, or false if the routing table
+ *   must be walked instead.
+ *
+ ****************************************************************************/
+
+static bool lpm_lock(FAR struct lpm_trie_s *trie,
+                     CODE bool (*build)(FAR struct lpm_trie_s *trie))
+{
+  int gen;
+
+  down_read(&trie->lock);
+  if (trie->built != atomic_read(&trie->gen))
+    {
+      up_read(&trie->lock);
+      down_write(&trie->lock);
+
+      /* Changes while the table is read are caught by the next lookup */
+
+      gen = atomic_read(&trie->gen);
+      if (trie->built != gen)
+        {
+          lpm_clear(trie);
+          trie->usable = build(trie);
+          trie->built  = gen;
+          if (!trie->usable)
+            {
+              lpm_clear(trie);
+              nwarn("WARNING: Route lookups walk the table\n");
+            }
+        }
+
+      up_write(&trie->lock);
+      down_read(&trie->lock);
+    }
+
+  if (!trie->usable)
+    {
+      up_read(&trie->lock);
+      return false;
+    }
+
+  return true;
+}
+
+#ifdef CONFIG_NET_IPv4
+static int lpm_add_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
+{
+  uint32_t mask = NTOHL(route->netmask);
+  uint32_t key = NTOHL(route->target);
+  int plen;
+
+  plen = lpm_prefixlen(&mask, 1);
+  if (plen < 0 || lpm_insert(&g_lpm_ipv4, &key, plen, route) < 0)
+    {
+      return 1;
+    }
+
+  return 0;
+}
+
+static bool lpm_build_ipv4(FAR struct lpm_trie_s *trie)
+{
+  return net_foreachroute_ipv4(lpm_add_ipv4, NULL) == 0;
+}
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+static void lpm_key_ipv6(FAR const uint16_t *addr, FAR uint32_t *key)
+{
+  int i;
+
+  for (i = 0; i < LPM_KEYWORDS; i++)
+    {
+      key[i] = ((uint32_t)NTOHS(addr[2 * i]) << 16) | NTOHS(addr[2 * i + 1]);
+    }
+}
+
+static int lpm_add_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
+{
+  uint32_t mask[LPM_KEYWORDS];
+  uint32_t key[LPM_KEYWORDS];
+  int plen;
+
+  lpm_key_ipv6(route->netmask, mask);
+  lpm_key_ipv6(route->target, key);
+
+  plen = lpm_prefixlen(mask, LPM_KEYWORDS);
+  if (plen < 0 || lpm_insert(&g_lpm_ipv6, key, plen, route) < 0)
+    {
+      return 1;
+    }
+
+  return 0;
+}
+
+static bool lpm_build_ipv6(FAR struct lpm_trie_s *trie)
+{
+  return net_foreachroute_ipv6(lpm_add_ipv6, NULL) == 0;
+}
+#endif /* CONFIG_NET_IPv6 */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv4
+ *
+ * Description:
+ *   Traverse the routes whose prefix covers target.  See route.h.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lpmroute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                      FAR void *arg)
+{
+  FAR struct lpm_route_s *entry;
+  FAR struct lpm_node_s *node = NULL;
+  uint32_t key = NTOHL(target);
+  int ret = 0;
+
+  if (!lpm_lock(&g_lpm_ipv4, lpm_build_ipv4))
+    {
+      return net_foreachroute_ipv4(handler, arg);
+    }
+
+  while (ret == 0 && (node = lpm_next(&g_lpm_ipv4, node, &key)) != NULL)
+    {
+      for (entry = node->routes; entry != NULL && ret == 0;
+           entry = entry->flink)
+        {
+          ret = handler(LPM_ROUTE(entry), arg);
+        }
+    }
+
+  up_read(&g_lpm_ipv4.lock);
+  return ret;
+}
+
+void net_lpmroute_changed_ipv4(void)
+{
+  atomic_fetch_add(&g_lpm_ipv4.gen, 1);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpmroute_ipv6
+ *
+ * Description:
+ *   Traverse the routes whose prefix covers target.  See route.h.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+int net_lpmroute_ipv6(FAR const net_ipv6addr_t target,
+                      route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR struct lpm_route_s *entry;
+  FAR struct lpm_node_s *node = NULL;
+  uint32_t key[LPM_KEYWORDS];
+  int ret = 0;
+
+  if (!lpm_lock(&g_lpm_ipv6, lpm_build_ipv6))
+    {
+      return net_foreachroute_ipv6(handler, arg);
+    }
+
+  lpm_key_ipv6(target, key);
+
+  while (ret == 0 && (node = lpm_next(&g_lpm_ipv6, node, key)) != NULL)
+    {
+      for (entry = node->routes; entry != NULL && ret == 0;
+           entry = entry->flink)
+        {
+          ret = handler(LPM_ROUTE(entry), arg);
+        }
+    }
+
+  up_read(&g_lpm_ipv6.lock);
+  return ret;
+}
+
+void net_lpmroute_changed_ipv6(void)
+{
+  atomic_fetch_add(&g_lpm_ipv6.gen, 1);
+}
+#endif
+
+#endif /* CONFIG_NET_ROUTE && CONFIG_ROUTE_LPM */
@@ -283,7 +283,11 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_LPM
+      ret = net_lpmroute_ipv4(target, net_ipv4_match, &match);
+#else
       ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -377,7 +381,11 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_LPM
+      ret = net_lpmroute_ipv6(target, net_ipv6_match, &match);
+#else
       ret = net_foreachroute_ipv6(net_ipv6_match, &match);
+#endif
     }
 
   /* Did we find a route? */
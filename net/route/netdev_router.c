@@ -284,7 +284,11 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_LPM
+      ret = net_lpmroute_ipv4(target, net_ipv4_devmatch, &match);
+#else
       ret = net_foreachroute_ipv4(net_ipv4_devmatch, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -371,7 +375,11 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
        * routing table that can forward to this address
        */
 
+#ifdef CONFIG_ROUTE_LPM
+      ret = net_lpmroute_ipv6(target, net_ipv6_devmatch, &match);
+#else
       ret = net_foreachroute_ipv6(net_ipv6_devmatch, &match);
+#endif
     }
 
   /* Did we find a route? */
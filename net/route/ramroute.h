@@ -29,6 +29,8 @@
 
 #include <nuttx/config.h>
 
+#include <nuttx/rwsem.h>
+
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -107,12 +109,24 @@ struct net_route_ipv6_queue_s
 /* The in-memory routing tables are represented as singly linked lists. */
 
 extern struct net_route_ipv4_queue_s g_ipv4_routes;
+
+/* Lookups are far more frequent than modifications, so the table and its
+ * free list are protected by a read-write lock.
+ */
+
+extern rw_semaphore_t g_ipv4_routelock;
 #endif
 
 #if defined(CONFIG_ROUTE_IPv6_RAMROUTE)
 /* The in-memory routing tables are represented as singly linked lists. */
 
 extern struct net_route_ipv6_queue_s g_ipv6_routes;
+
+/* Lookups are far more frequent than modifications, so the table and its
+ * free list are protected by a read-write lock.
+ */
+
+extern rw_semaphore_t g_ipv6_routelock;
 #endif
 
 /****************************************************************************
@@ -283,6 +283,57 @@ int net_foreachroute_ipv4(route_handler_ipv4_t handler, FAR void *arg);
 int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: net_lpmroute_ipv4/net_lpmroute_ipv6
+ *
+ * Description:
+ *   Traverse the routes whose prefix covers target, from the shortest
+ *   prefix to the longest one and in table order for the same prefix.  The
+ *   whole table is traversed if the prefix trie cannot be used.
+ *
+ * Input Parameters:
+ *   target  - The destination address
+ *   handler - Will be called for each route that covers target.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   As for net_foreachroute_ipv4/net_foreachroute_ipv6.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_LPM
+#ifdef CONFIG_NET_IPv4
+int net_lpmroute_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                      FAR void *arg);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lpmroute_ipv6(FAR const net_ipv6addr_t target,
+                      route_handler_ipv6_t handler, FAR void *arg);
+#endif
+#endif
+
+/****************************************************************************
+ * Name: net_lpmroute_changed_ipv4/net_lpmroute_changed_ipv6
+ *
+ * Description:
+ *   Called when a route is added or deleted, the prefix trie is rebuilt on
+ *   the next lookup.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_ROUTE_LPM) && defined(CONFIG_NET_IPv4)
+void net_lpmroute_changed_ipv4(void);
+#else
+#  define net_lpmroute_changed_ipv4()
+#endif
+
+#if defined(CONFIG_ROUTE_LPM) && defined(CONFIG_NET_IPv6)
+void net_lpmroute_changed_ipv6(void);
+#else
+#  define net_lpmroute_changed_ipv6()
+#endif
+
 /****************************************************************************
  * Name: net_ipv4_dumproute and net_ipv6_dumproute
  *
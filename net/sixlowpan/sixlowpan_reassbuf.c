@@ -46,6 +46,19 @@
 
 #define NET_6LOWPAN_TIMEOUT SEC2TICK(CONFIG_NET_6LOWPAN_MAXAGE)
 
+/* The active reassembly buffers are hashed by the reassembly tag and the
+ * source address, so that a gateway that reassembles for many nodes does
+ * not search all of them for each fragment.
+ */
+
+#define REASS_HASHSIZE      16
+
+/* The expired buffers are looked for at most once in this period, only a
+ * small part of the timeout.
+ */
+
+#define REASS_EXPIRE_PERIOD (NET_6LOWPAN_TIMEOUT / 8)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -57,9 +70,13 @@
 
 static FAR struct sixlowpan_reassbuf_s *g_free_reass;
 
-/* This is a list of active, allocated reassemby buffers */
+/* These are the lists of active, allocated reassemby buffers */
+
+static FAR struct sixlowpan_reassbuf_s *g_active_reass[REASS_HASHSIZE];
 
-static FAR struct sixlowpan_reassbuf_s *g_active_reass;
+/* The time when the expired buffers were last freed */
+
+static clock_t g_reass_expired;
 
 /* Pool of pre-allocated reassembly buffer structures */
 
@@ -102,6 +119,44 @@ static bool sixlowpan_compare_fragsrc(FAR struct sixlowpan_reassbuf_s *reass,
   return false;
 }
 
+/****************************************************************************
+ * Name: sixlowpan_reass_hash
+ *
+ * Description:
+ *   Return the list of active reassembly buffers for a reassembly tag and
+ *   a source address.
+ *
+ ****************************************************************************/
+
+static FAR struct sixlowpan_reassbuf_s **
+  sixlowpan_reass_hash(uint16_t reasstag,
+                       FAR const struct netdev_varaddr_s *fragsrc)
+{
+  uint32_t hash = reasstag;
+  int i;
+
+  for (i = 0; i < fragsrc->nv_addrlen; i++)
+    {
+      hash = hash * 31 + fragsrc->nv_addr[i];
+    }
+
+  return &g_active_reass[hash % REASS_HASHSIZE];
+}
+
+/****************************************************************************
+ * Name: sixlowpan_reass_expired
+ *
+ * Description:
+ *   Return true if a reassembly buffer is inactive or has timed out.
+ *
+ ****************************************************************************/
+
+static bool sixlowpan_reass_expired(FAR struct sixlowpan_reassbuf_s *reass,
+                                    clock_t now)
+{
+  return !reass->rb_active || now - reass->rb_time >= NET_6LOWPAN_TIMEOUT;
+}
+
 /****************************************************************************
  * Name: sixlowpan_reass_expire
  *
@@ -123,35 +178,31 @@ static void sixlowpan_reass_expire(void)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
   FAR struct sixlowpan_reassbuf_s *next;
-  clock_t elapsed;
+  clock_t now = clock_systime_ticks();
+  int i;
 
-  /* If reassembly timed out, cancel it */
+  g_reass_expired = now;
 
-  for (reass = g_active_reass; reass != NULL; reass = next)
+  for (i = 0; i < REASS_HASHSIZE; i++)
     {
-      /* Needed if 'reass' is freed */
-
-      next = reass->rb_flink;
-
-      /* Free any inactive reassembly buffers.  This is done because the life
-       * the reassembly buffer is not certain.
-       */
-
-      if (!reass->rb_active)
-        {
-          sixlowpan_reass_free(reass);
-        }
-      else
+      for (reass = g_active_reass[i]; reass != NULL; reass = next)
         {
-          /* Get the elpased time of the reassembly */
+          /* Needed if 'reass' is freed */
 
-          elapsed = clock_systime_ticks() - reass->rb_time;
+          next = reass->rb_flink;
 
-          /* If the reassembly has expired, then free the reassembly buffer */
+          /* Free any inactive reassembly buffers.  This is done because
+           * the life the reassembly buffer is not certain.  If reassembly
+           * timed out, cancel it.
+           */
 
-          if (elapsed >= NET_6LOWPAN_TIMEOUT)
+          if (sixlowpan_reass_expired(reass, now))
             {
-              nwarn("WARNING: Reassembly timed out\n");
+              if (reass->rb_active)
+                {
+                  nwarn("WARNING: Reassembly timed out\n");
+                }
+
               sixlowpan_reass_free(reass);
             }
         }
@@ -177,12 +228,14 @@ static void sixlowpan_reass_expire(void)
 
 static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *curr;
   FAR struct sixlowpan_reassbuf_s *prev;
 
   /* Find the reassembly buffer in the list of active reassembly buffers */
 
-  for (prev = NULL, curr = g_active_reass;
+  head = sixlowpan_reass_hash(reass->rb_reasstag, &reass->rb_fragsrc);
+  for (prev = NULL, curr = *head;
        curr != NULL && curr != reass;
        prev = curr, curr = curr->rb_flink)
     {
@@ -196,7 +249,7 @@ static void sixlowpan_remove_active(FAR struct sixlowpan_reassbuf_s *reass)
 
       if (prev == NULL)
         {
-          g_active_reass = reass->rb_flink;
+          *head = reass->rb_flink;
         }
       else
         {
@@ -281,6 +334,7 @@ FAR struct sixlowpan_reassbuf_s *
   sixlowpan_reass_allocate(uint16_t reasstag,
                            FAR const struct netdev_varaddr_s *fragsrc)
 {
+  FAR struct sixlowpan_reassbuf_s **head;
   FAR struct sixlowpan_reassbuf_s *reass;
   uint8_t pool;
 
@@ -288,7 +342,11 @@ FAR struct sixlowpan_reassbuf_s *
    * free up a pre-allocated buffer for this allocation.
    */
 
-  sixlowpan_reass_expire();
+  if (g_free_reass == NULL ||
+      clock_systime_ticks() - g_reass_expired >= REASS_EXPIRE_PERIOD)
+    {
+      sixlowpan_reass_expire();
+    }
 
   /* Now, try the free list first */
 
@@ -328,8 +386,9 @@ FAR struct sixlowpan_reassbuf_s *
 
       /* Add the reassembly buffer to the list of active reassembly buffers */
 
-      reass->rb_flink   = g_active_reass;
-      g_active_reass    = reass;
+      head              = sixlowpan_reass_hash(reasstag, fragsrc);
+      reass->rb_flink   = *head;
+      *head             = reass;
     }
 
   return reass;
@@ -359,18 +418,19 @@ FAR struct sixlowpan_reassbuf_s *
                        FAR const struct netdev_varaddr_s *fragsrc)
 {
   FAR struct sixlowpan_reassbuf_s *reass;
+  clock_t now = clock_systime_ticks();
 
-  /* First, removed any expired or inactive reassembly buffers (we don't want
-   * to return old reassembly buffer with the same tag)
-   */
-
-  sixlowpan_reass_expire();
+  if (now - g_reass_expired >= REASS_EXPIRE_PERIOD)
+    {
+      sixlowpan_reass_expire();
+    }
 
   /* Now search for the matching reassembly buffer in the remainng, active
    * reassembly buffers.
    */
 
-  for (reass = g_active_reass; reass != NULL; reass = reass->rb_flink)
+  for (reass = *sixlowpan_reass_hash(reasstag, fragsrc); reass != NULL;
+       reass = reass->rb_flink)
     {
       /* In order to be a match, it must have the same reassembly tag as
        * well as source address (different sources might use the same
@@ -380,6 +440,16 @@ FAR struct sixlowpan_reassbuf_s *
       if (reass->rb_reasstag == reasstag &&
           sixlowpan_compare_fragsrc(reass, fragsrc))
         {
+          /* We don't want to return an old reassembly buffer with the
+           * same tag.
+           */
+
+          if (sixlowpan_reass_expired(reass, now))
+            {
+              sixlowpan_reass_free(reass);
+              return NULL;
+            }
+
           return reass;
         }
     }
@@ -640,6 +640,7 @@ static int sixlowpan_send_packet(FAR struct socket *psock,
 
           /* Notify the IEEE802.15.4 MAC that we have data to send. */
 
+          tcp_txpending(conn);
           netdev_txnotify_dev(dev, TCP_POLL);
 
           /* Wait for the send to complete or an error to occur.
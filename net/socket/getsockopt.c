@@ -147,9 +147,13 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
                             * periodic transmission of probes */
       case SO_OOBINLINE:   /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:   /* Allow reuse of local addresses */
+      case SO_REUSEPORT:   /* Spread the load of a port across sockets */
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP:   /* Generates a timestamp in us for each incoming packet */
       case SO_TIMESTAMPNS: /* Generates a timestamp in ns for each incoming packet */
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      case SO_ZEROCOPY:    /* Allow MSG_ZEROCOPY sends */
 #endif
         {
           sockopt_t optionset;
@@ -205,6 +209,20 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
         break;
 
+#ifdef CONFIG_NET_BUSY_POLL
+      case SO_BUSY_POLL:  /* Poll the device before a receive blocks */
+        {
+          if (*value_len < sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          *(FAR int *)value = (int)conn->s_busypoll;
+          *value_len        = sizeof(int);
+        }
+        break;
+#endif
+
       default:
         return -ENOPROTOOPT;
     }
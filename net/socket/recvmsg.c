@@ -32,6 +32,7 @@
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
+#include <nuttx/sched.h>
 
 #include "socket/socket.h"
 
@@ -114,6 +115,13 @@ ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   msg->msg_control    = msg_control;
   msg->msg_controllen = msg_controllen - msg->msg_controllen;
 
+#ifdef CONFIG_SCHED_RUSAGE
+  if (ret > 0)
+    {
+      nxsched_self()->sockrx += ret;
+    }
+#endif
+
   return ret;
 }
 
@@ -32,6 +32,7 @@
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
+#include <nuttx/sched.h>
 
 #include "socket/socket.h"
 
@@ -72,6 +73,8 @@
 ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                        int flags)
 {
+  ssize_t ret;
+
   /* Verify that non-NULL pointers were passed */
 
   if (msg == NULL || msg->msg_iov == NULL ||
@@ -94,7 +97,16 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   DEBUGASSERT(psock->s_sockif != NULL &&
               psock->s_sockif->si_sendmsg != NULL);
 
-  return psock->s_sockif->si_sendmsg(psock, msg, flags);
+  ret = psock->s_sockif->si_sendmsg(psock, msg, flags);
+
+#ifdef CONFIG_SCHED_RUSAGE
+  if (ret > 0)
+    {
+      nxsched_self()->socktx += ret;
+    }
+#endif
+
+  return ret;
 }
 
 /****************************************************************************
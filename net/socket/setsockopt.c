@@ -137,9 +137,13 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
                             * periodic transmission of probes */
       case SO_OOBINLINE:   /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:   /* Allow reuse of local addresses */
+      case SO_REUSEPORT:   /* Spread the load of a port across sockets */
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP:   /* Generates a timestamp in us for each incoming packet */
       case SO_TIMESTAMPNS: /* Generates a timestamp in ns for each incoming packet */
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      case SO_ZEROCOPY:    /* Allow MSG_ZEROCOPY sends */
 #endif
         {
           int setting;
@@ -239,6 +243,24 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
 #endif
 
+#ifdef CONFIG_NET_BUSY_POLL
+      case SO_BUSY_POLL:   /* Poll the device before a receive blocks */
+        {
+          if (value == NULL || value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          if (*(FAR int *)value < 0)
+            {
+              return -EINVAL;
+            }
+
+          conn->s_busypoll = *(FAR int *)value;
+        }
+        break;
+#endif
+
       /* There options are only valid when used with getopt */
 
       case SO_ACCEPTCONN: /* Reports whether socket listening is enabled */
@@ -60,6 +60,7 @@
 #define _SO_RCVLOWAT     _SO_BIT(SO_RCVLOWAT)
 #define _SO_RCVTIMEO     _SO_BIT(SO_RCVTIMEO)
 #define _SO_REUSEADDR    _SO_BIT(SO_REUSEADDR)
+#define _SO_REUSEPORT    _SO_BIT(SO_REUSEPORT)
 #define _SO_SNDBUF       _SO_BIT(SO_SNDBUF)
 #define _SO_SNDLOWAT     _SO_BIT(SO_SNDLOWAT)
 #define _SO_SNDTIMEO     _SO_BIT(SO_SNDTIMEO)
@@ -67,10 +68,12 @@
 #define _SO_TIMESTAMP    _SO_BIT(SO_TIMESTAMP)
 #define _SO_TIMESTAMPNS  _SO_BIT(SO_TIMESTAMPNS)
 #define _SO_BINDTODEVICE _SO_BIT(SO_BINDTODEVICE)
+#define _SO_ZEROCOPY     _SO_BIT(SO_ZEROCOPY)
+#define _SO_BUSY_POLL    _SO_BIT(SO_BUSY_POLL)
 
 /* This is the largest option value.  REVISIT: belongs in sys/socket.h */
 
-#define _SO_MAXOPT       (18)
+#define _SO_MAXOPT       (22)
 
 /* Macros to set, test, clear options */
 
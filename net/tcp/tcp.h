@@ -32,6 +32,7 @@
 #include <sys/types.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
@@ -82,6 +83,12 @@
 #  define TCP_WBTRIM(wrb,n) \
      do { (wrb)->wb_iob = iob_trimhead((wrb)->wb_iob,(n)); } while (0)
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+#  define TCP_WBZEROCOPY(wrb)        ((wrb)->wb_zcconn != NULL)
+#else
+#  define TCP_WBZEROCOPY(wrb)        (false)
+#endif
+
 #ifdef CONFIG_DEBUG_FEATURES
 #  define TCP_WBDUMP(msg,wrb,len,offset) \
      tcp_wrbuffer_dump(msg,wrb,len,offset)
@@ -127,6 +134,16 @@
 #define TCP_RTO_MAX 240 /* 120s,The unit is half a second */
 #define TCP_RTO_MIN 1   /* 0.5s */
 
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+/* The buffers whose size was set by SO_RCVBUF or SO_SNDBUF, and whether a
+ * receive round trip is being timed.
+ */
+
+#  define TCP_AUTOTUNE_RCVLOCK (1 << 0)
+#  define TCP_AUTOTUNE_SNDLOCK (1 << 1)
+#  define TCP_AUTOTUNE_TIMING  (1 << 2)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -149,6 +166,7 @@ struct net_driver_s;      /* Forward reference */
 struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
+struct tcp_cc_ops_s;      /* Forward reference */
 
 /* This is a container that holds the poll-related information */
 
@@ -208,6 +226,14 @@ struct tcp_conn_s
 
   /* TCP-specific content follows */
 
+#ifdef CONFIG_NET_TCP_HASH
+  hash_node_t hnode;      /* Node in the hashtable of active connections */
+  hash_node_t lnode;      /* Node in the hashtable of listeners */
+#endif
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+  dq_entry_t pnode;       /* Node in the list of connections to poll */
+  bool     pending;       /* On the list of connections to poll */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -225,7 +251,13 @@ struct tcp_conn_s
                            * variable */
   uint8_t  rto;           /* Retransmission time-out */
   uint8_t  tcpstateflags; /* TCP state and flags */
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+  dq_entry_t tnode;       /* Node in the TCP timer wheel */
+  clock_t  tdeadline;     /* When the TCP timer expires */
+  bool     tarmed;        /* The TCP timer is in the wheel */
+#else
   struct   work_s work;   /* TCP timer handle */
+#endif
   bool     timeout;       /* Trigger from timer expiry */
   uint8_t  timer;         /* The retransmission timer (units: half-seconds) */
   uint8_t  nrtx;          /* The number of retransmissions for the last
@@ -251,6 +283,52 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  /* The congestion control algorithm of the connection */
+
+  FAR const struct tcp_cc_ops_s *cc;
+#endif
+#ifdef CONFIG_NET_TCP_PACING
+  dq_entry_t pace_node;   /* Node in the list of paced connections */
+  uint64_t pace_next;     /* Departure time of the next segment (ns) */
+  uint64_t pace_srtt;     /* Smoothed round trip time (ns) */
+  uint64_t pace_rttstart; /* When the timed segment was sent (ns) */
+  uint32_t pace_rttseq;   /* The ACK that ends the timed round trip */
+  bool     pace_wait;     /* Waiting for the departure time */
+  bool     pace_timing;   /* A round trip is being timed */
+#endif
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+  uint32_t at_rttseq;     /* rcvseq that ends the receive round trip */
+  clock_t  at_rttstart;   /* When that round trip started */
+  clock_t  at_rtt;        /* Receive round trip time (ticks) */
+  clock_t  at_copystart;  /* Start of the current copied count */
+  uint32_t at_copied;     /* Bytes read by the application since then */
+  uint32_t at_space;      /* Bytes read in the last round trip counted */
+  uint8_t  at_flags;      /* See TCP_AUTOTUNE_* */
+#endif
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY sends are numbered from zero.  Their completions are
+   * reported in order, the range zc_lo..zc_hi is waiting to be read from
+   * the error queue if zc_ready is set.
+   */
+
+  /* The last write buffer queued */
+
+  FAR struct tcp_wrbuffer_s *zc_lastwrb;
+  uint32_t zc_next;       /* Number of the current or next send */
+  uint32_t zc_lo;         /* First completed send not yet reported */
+  uint32_t zc_hi;         /* Last completed send not yet reported */
+  bool     zc_busy;       /* A send is queueing write buffers */
+  bool     zc_copied;     /* The current send copied some data */
+  bool     zc_ready;      /* zc_lo..zc_hi are valid */
+  bool     zc_rcopied;    /* Some of zc_lo..zc_hi were copied */
+#endif
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  uint32_t cubic_wmax;    /* The window before the last loss */
+  uint32_t cubic_origin;  /* The plateau of the cubic function */
+  uint32_t cubic_west;    /* The window Reno would have */
+  uint32_t cubic_k;       /* Time to reach the plateau (milliseconds) */
+  clock_t  cubic_epoch;   /* Start of the congestion avoidance, or 0 */
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -403,6 +481,12 @@ struct tcp_conn_s
 /* This structure supports TCP write buffering */
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+#  define TCP_WBZC_REF    (1 << 0) /* The data is the user buffer in place */
+#  define TCP_WBZC_LAST   (1 << 1) /* Last write buffer of its send */
+#  define TCP_WBZC_COPIED (1 << 2) /* The send copied some data */
+#endif
+
 struct tcp_wrbuffer_s
 {
   sq_entry_t wb_node;      /* Supports a singly linked list */
@@ -414,6 +498,13 @@ struct tcp_wrbuffer_s
   uint8_t    wb_nack;      /* The number of ack count */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* The connection of a MSG_ZEROCOPY send, its number and TCP_WBZC_* */
+
+  FAR struct tcp_conn_s *wb_zcconn;
+  uint32_t   wb_zcid;
+  uint8_t    wb_zcflags;
+#endif
 };
 #endif
 
@@ -536,6 +627,41 @@ FAR struct tcp_conn_s *tcp_active(FAR struct net_driver_s *dev,
 
 FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_txpending
+ *
+ * Description:
+ *   Queue a connection for the next TX poll of its device.  Called before
+ *   the device is notified with TCP_POLL on behalf of the connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+void tcp_txpending(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_txpending(conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_npending / tcp_nextpending
+ *
+ * Description:
+ *   tcp_nextpending() dequeues the first queued connection bound to dev,
+ *   or returns NULL if there is none.  tcp_npending() is the number of
+ *   queued connections of all devices, it bounds a walk that would
+ *   otherwise meet again the connections that queue themselves while
+ *   they are polled.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+int tcp_npending(void);
+FAR struct tcp_conn_s *tcp_nextpending(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: tcp_local_ipv4_device
  *
@@ -643,7 +769,8 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
  * Description:
  *   If the port number is zero; select an unused port for the connection.
  *   If the port number is non-zero, verify that no other connection has
- *   been created with this port number.
+ *   been created with this port number, unless the sockets all have
+ *   SO_REUSEPORT in opt.
  *
  * Returned Value:
  *   Selected or verified port number in network order on success, a negated
@@ -656,7 +783,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 
 int tcp_selectport(uint8_t domain,
                    FAR const union ip_addr_u *ipaddr,
-                   uint16_t portno);
+                   uint16_t portno, sockopt_t opt);
 
 /****************************************************************************
  * Name: tcp_bind
@@ -1094,6 +1221,20 @@ void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout);
 
 void tcp_stop_timer(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_timer_available
+ *
+ * Description:
+ *   True if the TCP timer of the connection is not armed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+#  define tcp_timer_available(conn) (!(conn)->tarmed)
+#else
+#  define tcp_timer_available(conn) work_available(&(conn)->work)
+#endif
+
 /****************************************************************************
  * Name: tcp_findlistener
  *
@@ -1158,6 +1299,36 @@ bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno,
 bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno);
 #endif
 
+/****************************************************************************
+ * Name: tcp_reuseport_conflict
+ *
+ * Description:
+ *   Return a listener without SO_REUSEPORT on this address and port, one
+ *   that keeps a socket with SO_REUSEPORT from binding them.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct tcp_conn_s *
+tcp_reuseport_conflict(uint8_t domain, FAR union ip_binding_u *uaddr,
+                       uint16_t portno);
+
+/****************************************************************************
+ * Name: tcp_reuseport_select
+ *
+ * Description:
+ *   Choose the listener that accepts a connection from the source of the
+ *   packet in dev among the listeners with SO_REUSEPORT that share the
+ *   port of listener.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *
+tcp_reuseport_select(FAR struct net_driver_s *dev,
+                     FAR struct tcp_conn_s *listener,
+                     FAR union ip_binding_u *uaddr, uint16_t srcport);
+#endif
+
 /****************************************************************************
  * Name: tcp_accept_connection
  *
@@ -1256,6 +1427,26 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 
 uint16_t tcp_rx_mss(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * Name: tcp_max_sndlen
+ *
+ * Description:
+ *   Return the maximum payload of one outgoing TCP packet on the device.
+ *   This is the MSS, or a multiple of it if the device does TCP
+ *   segmentation offload.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Returned Value:
+ *   The maximum payload length.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_max_sndlen(FAR struct net_driver_s *dev,
+                        FAR struct tcp_conn_s *conn);
+
 /****************************************************************************
  * Name: tcp_synack
  *
@@ -2356,6 +2547,103 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables on a retransmission timeout
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_pacing_allow / tcp_pacing_sent / tcp_pacing_ack /
+ *       tcp_pacing_rexmit / tcp_pacing_free
+ *
+ * Description:
+ *   Spread the segments of the buffered send path over the round trip at
+ *   the rate cwnd / srtt, instead of sending them back to back on every
+ *   poll.  tcp_pacing_allow() tells whether the next segment may leave
+ *   now, otherwise the connection is polled again at its departure time.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_PACING
+bool tcp_pacing_allow(FAR struct tcp_conn_s *conn);
+void tcp_pacing_sent(FAR struct tcp_conn_s *conn, uint32_t seq,
+                     uint32_t sndlen);
+void tcp_pacing_ack(FAR struct tcp_conn_s *conn, uint32_t ackno);
+void tcp_pacing_rexmit(FAR struct tcp_conn_s *conn);
+void tcp_pacing_free(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_pacing_allow(conn)          (true)
+#  define tcp_pacing_sent(conn, seq, len)
+#  define tcp_pacing_ack(conn, ackno)
+#  define tcp_pacing_rexmit(conn)
+#  define tcp_pacing_free(conn)
+#endif
+
+/****************************************************************************
+ * Name: tcp_autotune_rcvdata / tcp_autotune_copied / tcp_autotune_ack
+ *
+ * Description:
+ *   Auto-tune the socket buffers.  tcp_autotune_rcvdata() times the
+ *   receive round trip with the new data of each segment,
+ *   tcp_autotune_copied() counts what the application reads and grows
+ *   rcv_bufs from that once per round trip.  tcp_autotune_ack() grows
+ *   snd_bufs from the window that may be in flight.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+void tcp_autotune_rcvdata(FAR struct tcp_conn_s *conn, uint32_t len);
+void tcp_autotune_copied(FAR struct tcp_conn_s *conn, size_t len);
+void tcp_autotune_ack(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_zerocopy_*
+ *
+ * Description:
+ *   MSG_ZEROCOPY sends.  tcp_zerocopy_fill() makes a new write buffer
+ *   reference the user data, tcp_zerocopy_queued() accounts each write
+ *   buffer of the send as it is queued and tcp_zerocopy_end() closes the
+ *   send.  tcp_wrbuffer_release() calls tcp_zerocopy_release(), the send
+ *   completes with the release of its last write buffer.
+ *   tcp_zerocopy_recverr() reads the completions for MSG_ERRQUEUE.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+int tcp_zerocopy_fill(FAR struct tcp_wrbuffer_s *wrb,
+                      FAR const uint8_t *buf, unsigned int len);
+void tcp_zerocopy_queued(FAR struct tcp_conn_s *conn,
+                         FAR struct tcp_wrbuffer_s *wrb);
+void tcp_zerocopy_end(FAR struct tcp_conn_s *conn);
+void tcp_zerocopy_release(FAR struct tcp_wrbuffer_s *wrb);
+ssize_t tcp_zerocopy_recverr(FAR struct tcp_conn_s *conn,
+                             FAR struct msghdr *msg);
 #endif
 
 #ifdef __cplusplus
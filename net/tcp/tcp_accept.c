@@ -35,6 +35,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/sched.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 
@@ -228,6 +229,12 @@ int psock_tcp_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
   conn_lock(&conn->sconn);
 
+#ifdef CONFIG_NETDEV_RSS
+  /* Listeners with SO_REUSEPORT prefer the SYNs of the CPU that accepts */
+
+  conn->rcvcpu = this_cpu();
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   state.acpt_newconn = tcp_backlogremove(conn);
   if (state.acpt_newconn)
@@ -215,7 +215,7 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
        * MSS (the minimum of the MSS and the available window).
        */
 
-      DEBUGASSERT(dev->d_sndlen <= conn->mss);
+      DEBUGASSERT(dev->d_sndlen <= tcp_max_sndlen(dev, conn));
 
 #if !defined(CONFIG_NET_TCP_WRITE_BUFFERS) || defined(CONFIG_NET_SENDFILE)
 
@@ -0,0 +1,232 @@
+/****************************************************************************
+ * net/tcp/tcp_autotune.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <sys/param.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/iob.h>
+
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* A buffer grows to no more than half of the pool, it stops growing and
+ * shrinks back while less than a quarter of the pool is free.
+ */
+
+#define AUTOTUNE_POOL     ((CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE) * \
+                           CONFIG_IOB_BUFSIZE)
+#define AUTOTUNE_LOWIOBS  (CONFIG_IOB_NBUFFERS / 4)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_autotune_size
+ *
+ * Description:
+ *   The new size of a buffer of bufs bytes that would like to be target
+ *   bytes and holds inuse bytes now.  It only grows, up to max if that is
+ *   not zero, unless the IOB pool runs low.  Then it gives back what it
+ *   grew beyond its initial size dflt and does not hold.
+ *
+ ****************************************************************************/
+
+static int32_t tcp_autotune_size(int32_t bufs, uint32_t target,
+                                 uint32_t inuse, uint32_t dflt,
+                                 uint32_t max)
+{
+  if (iob_navail(false) < AUTOTUNE_LOWIOBS)
+    {
+      if ((uint32_t)bufs > dflt)
+        {
+          bufs = MAX(dflt, inuse);
+        }
+
+      return bufs;
+    }
+
+  if (max > 0)
+    {
+      target = MIN(target, max);
+    }
+
+  target = MIN(target, AUTOTUNE_POOL / 2);
+  return MAX((uint32_t)bufs, target);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_autotune_rcvdata
+ *
+ * Description:
+ *   Time the receive round trip with a segment of len new bytes that was
+ *   just received, before rcvseq moves past them.  The peer sends no more
+ *   than the advertised window per round trip, so the time until what was
+ *   advertised at the start arrives is an upper bound of the round trip.
+ *   The smallest of these bounds is kept, rising slowly.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_autotune_rcvdata(FAR struct tcp_conn_s *conn, uint32_t len)
+{
+#if CONFIG_NET_RECV_BUFSIZE > 0
+  uint32_t rcvseq = tcp_getsequence(conn->rcvseq);
+  clock_t now = clock_systime_ticks();
+  uint32_t win;
+  clock_t rtt;
+
+  if ((conn->at_flags & TCP_AUTOTUNE_TIMING) != 0 &&
+      TCP_SEQ_GTE(rcvseq + len, conn->at_rttseq))
+    {
+      rtt = MAX(now - conn->at_rttstart, 1);
+      if (conn->at_rtt == 0 || rtt < conn->at_rtt)
+        {
+          conn->at_rtt = rtt;
+        }
+      else
+        {
+          conn->at_rtt = (7 * conn->at_rtt + rtt + 7) / 8;
+        }
+
+      conn->at_flags &= ~TCP_AUTOTUNE_TIMING;
+    }
+
+  if ((conn->at_flags & TCP_AUTOTUNE_TIMING) == 0)
+    {
+      win = TCP_SEQ_GT(conn->rcv_adv, rcvseq) ?
+            TCP_SEQ_SUB(conn->rcv_adv, rcvseq) : 0;
+
+      conn->at_rttseq   = rcvseq + MAX(win, conn->mss);
+      conn->at_rttstart = now;
+      conn->at_flags   |= TCP_AUTOTUNE_TIMING;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_autotune_copied
+ *
+ * Description:
+ *   Count len bytes read by the application.  Once per receive round trip
+ *   what was read in it measures the bandwidth-delay product, the receive
+ *   buffer grows to twice the largest one so that the window keeps ahead
+ *   of the sender.  Nothing grows for a connection that is not read.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_autotune_copied(FAR struct tcp_conn_s *conn, size_t len)
+{
+#if CONFIG_NET_RECV_BUFSIZE > 0
+  clock_t now = clock_systime_ticks();
+  uint32_t target = 0;
+
+  if ((conn->at_flags & TCP_AUTOTUNE_RCVLOCK) != 0)
+    {
+      return;
+    }
+
+  conn->at_copied += len;
+  if (conn->at_rtt == 0 || now - conn->at_copystart < conn->at_rtt)
+    {
+      return;
+    }
+
+  if (conn->at_copied > conn->at_space)
+    {
+      conn->at_space = conn->at_copied;
+      target = 2 * conn->at_copied;
+    }
+
+  conn->rcv_bufs = tcp_autotune_size(conn->rcv_bufs, target,
+                                     conn->readahead != NULL ?
+                                     conn->readahead->io_pktlen : 0,
+                                     CONFIG_NET_RECV_BUFSIZE,
+                                     CONFIG_NET_MAX_RECV_BUFSIZE);
+
+  ninfo("rcv_bufs=%" PRId32 " rtt=%u copied=%" PRIu32 "\n",
+        conn->rcv_bufs, (unsigned int)conn->at_rtt, conn->at_copied);
+
+  conn->at_copied    = 0;
+  conn->at_copystart = now;
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_autotune_ack
+ *
+ * Description:
+ *   Called for each ACK, grow the send buffer to twice the window that may
+ *   be in flight.  That holds what is unacknowledged together with the
+ *   next window, so that the sender never waits on the buffer.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_autotune_ack(FAR struct tcp_conn_s *conn)
+{
+#if CONFIG_NET_SEND_BUFSIZE > 0
+  uint32_t inflight = conn->snd_wnd;
+
+  if ((conn->at_flags & TCP_AUTOTUNE_SNDLOCK) != 0)
+    {
+      return;
+    }
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+  inflight = MIN(inflight, conn->cwnd);
+#endif
+
+  conn->snd_bufs = tcp_autotune_size(conn->snd_bufs, 2 * inflight,
+                                     tcp_wrbuffer_inqueue_size(conn),
+                                     CONFIG_NET_SEND_BUFSIZE,
+                                     CONFIG_NET_MAX_SEND_BUFSIZE);
+#endif
+}
+
+#endif /* CONFIG_NET_TCP_AUTOTUNE */
@@ -24,8 +24,11 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+
 #include "tcp/tcp.h"
 
 /****************************************************************************
@@ -74,10 +77,258 @@
     } \
  } while(0)
 
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* CUBIC constants of RFC 9438: C = 0.4, beta = 0.7 and the alpha of the
+ * Reno-friendly region, 3 * (1 - beta) / (1 + beta), the fractions are
+ * over 1024.
+ */
+
+#  define CUBIC_BETA        717
+#  define CUBIC_CONVERGE    870  /* (1 + beta) / 2 */
+#  define CUBIC_ALPHA       542
+
+/* The window grows by (t - K)^3 * C segments for t in seconds, which is
+ * (t - K)^3 / CUBIC_CMS segments for t in milliseconds.
+ */
+
+#  define CUBIC_CMS         2500000000ull
+#  define CUBIC_MAXDELTA    (1 << 20)    /* Keeps (t - K)^3 in 64 bits */
+#endif
+
+/* The algorithm of the new connections */
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+#  define TCP_CC_DEFAULT    (&g_tcp_cubic)
+#else
+#  define TCP_CC_DEFAULT    (&g_tcp_newreno)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A congestion control algorithm.  The loss recovery (fast retransmit,
+ * fast recovery and retransmission timeout) and slow start are common,
+ * the algorithm decides how the window grows past the slow start
+ * threshold and where that threshold goes after a loss.
+ */
+
+struct tcp_cc_ops_s
+{
+  /* Reset the state of the algorithm for a new connection, optional */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* Grow the window for acked bytes in congestion avoidance */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+  /* Return the slow start threshold after a loss */
+
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                                   uint32_t acked);
+static uint32_t tcp_newreno_ssthresh(FAR struct tcp_conn_s *conn);
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn);
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked);
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct tcp_cc_ops_s g_tcp_newreno =
+{
+  NULL,
+  tcp_newreno_cong_avoid,
+  tcp_newreno_ssthresh
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+static const struct tcp_cc_ops_s g_tcp_cubic =
+{
+  tcp_cubic_init,
+  tcp_cubic_cong_avoid,
+  tcp_cubic_ssthresh
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_newreno_cong_avoid / tcp_newreno_ssthresh
+ *
+ * Description:
+ *   NewReno, RFC 5681 and RFC 6582.
+ *
+ ****************************************************************************/
+
+static void tcp_newreno_cong_avoid(FAR struct tcp_conn_s *conn,
+                                   uint32_t acked)
+{
+  /* cong avoid (RFC 5681):
+   * Grow cwnd linearly by approximately maxseg per RTT using
+   * maxseg^2 / cwnd per ACK as the increment.
+   * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+   * avoid capping cwnd.
+   */
+
+  uint32_t increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+  CC_CWND_INC(conn->cwnd, increase);
+  conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+  ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+}
+
+static uint32_t tcp_newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  return MAX(conn->tx_unacked / 2, 2 * conn->mss);
+}
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/****************************************************************************
+ * Name: tcp_cubic_cbrt
+ *
+ * Description:
+ *   The integer cube root of x, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_cubic_cbrt(uint64_t x)
+{
+  uint64_t y = 0;
+  int shift;
+
+  for (shift = 63; shift >= 0; shift -= 3)
+    {
+      y <<= 1;
+      if ((x >> shift) >= 3 * y * (y + 1) + 1)
+        {
+          x -= (3 * y * (y + 1) + 1) << shift;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: tcp_cubic_init / tcp_cubic_cong_avoid / tcp_cubic_ssthresh
+ *
+ * Description:
+ *   CUBIC, RFC 9438.  After a loss the window follows
+ *   W(t) = C * (t - K)^3 + Wmax, flat around the window of the loss and
+ *   steep far from it, so it recovers a large window in a few round trips
+ *   whatever the RTT.  It never grows slower than Reno would.  The RTT is
+ *   the smoothed RTT of the retransmission timer, in half-seconds.
+ *
+ ****************************************************************************/
+
+static void tcp_cubic_init(FAR struct tcp_conn_s *conn)
+{
+  conn->cubic_wmax  = 0;
+  conn->cubic_epoch = 0;
+}
+
+static void tcp_cubic_cong_avoid(FAR struct tcp_conn_s *conn,
+                                 uint32_t acked)
+{
+  clock_t now = clock_systime_ticks();
+  uint32_t increase;
+  int64_t target;
+  int64_t delta;
+
+  if (conn->cubic_epoch == 0)
+    {
+      /* First ACK in congestion avoidance since the loss, K is the time
+       * the window needs to climb back to the window of the loss.
+       */
+
+      conn->cubic_epoch = now;
+      conn->cubic_west  = conn->cwnd;
+
+      if (conn->cwnd < conn->cubic_wmax)
+        {
+          delta              = conn->cubic_wmax - conn->cwnd;
+          conn->cubic_k      = tcp_cubic_cbrt((uint64_t)delta * CUBIC_CMS /
+                                              conn->mss);
+          conn->cubic_origin = conn->cubic_wmax;
+        }
+      else
+        {
+          conn->cubic_k      = 0;
+          conn->cubic_origin = conn->cwnd;
+        }
+    }
+
+  /* The window the cubic function wants one RTT from now */
+
+  delta = (int64_t)TICK2MSEC(now - conn->cubic_epoch) +
+          (conn->sa >> 3) * MSEC_PER_HSEC - conn->cubic_k;
+  delta = MIN(MAX(delta, -CUBIC_MAXDELTA), CUBIC_MAXDELTA);
+
+  target = (int64_t)conn->cubic_origin +
+           delta * delta * delta / (int64_t)(CUBIC_CMS / 1000) *
+           conn->mss / 1000;
+  target = MIN(target, (int64_t)conn->cwnd + conn->cwnd / 2);
+
+  if (target > conn->cwnd)
+    {
+      increase = (uint32_t)((target - conn->cwnd) * conn->mss /
+                            conn->cwnd);
+    }
+  else
+    {
+      increase = conn->mss / 100;
+    }
+
+  /* The Reno-friendly region: never grow slower than Reno would */
+
+  conn->cubic_west += (uint32_t)((uint64_t)acked * CUBIC_ALPHA / 1024 *
+                                 conn->mss / conn->cwnd);
+  if (conn->cubic_west > conn->cwnd + increase)
+    {
+      increase = conn->cubic_west - conn->cwnd;
+    }
+
+  CC_CWND_INC(conn->cwnd, MAX(increase, 1));
+  ninfo("update cubic cwnd to %u\n", conn->cwnd);
+}
+
+static uint32_t tcp_cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  /* Fast convergence: a window that is lost below the previous loss
+   * leaves room to newer connections.
+   */
+
+  if (conn->cwnd < conn->cubic_wmax)
+    {
+      conn->cubic_wmax = (uint32_t)((uint64_t)conn->cwnd *
+                                    CUBIC_CONVERGE / 1024);
+    }
+  else
+    {
+      conn->cubic_wmax = conn->cwnd;
+    }
+
+  conn->cubic_epoch = 0;
+  return MAX((uint32_t)((uint64_t)conn->cwnd * CUBIC_BETA / 1024),
+             2 * conn->mss);
+}
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -117,6 +368,12 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
   conn->ssthresh = 2 * TCP_IPV4_DEFAULT_MSS;
   conn->dupacks = 0;
+
+  conn->cc = TCP_CC_DEFAULT;
+  if (conn->cc->init != NULL)
+    {
+      conn->cc->init(conn);
+    }
 }
 
 /****************************************************************************
@@ -148,7 +405,7 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+      conn->ssthresh = conn->cc->ssthresh(conn);
       conn->cwnd = conn->ssthresh + 3 * conn->mss;
 
       conn->flags &= ~TCP_INFT;
@@ -284,19 +541,42 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
             }
           else
             {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
-
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
-
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
-              ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+              conn->cc->cong_avoid(conn, acked);
             }
         }
     }
 }
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Update the congestion control variables on a retransmission timeout,
+ *   the connection goes back to slow start from one segment.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
+
+  conn->flags &= ~TCP_INFR;
+
+  /* update the max_cwnd */
+
+  conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  conn->ssthresh = conn->cc->ssthresh(conn);
+  conn->cwnd = conn->mss;
+}
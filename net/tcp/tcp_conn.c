@@ -58,6 +58,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -71,6 +72,7 @@
 #include "icmpv6/icmpv6.h"
 #include "nat/nat.h"
 #include "netdev/netdev.h"
+#include "socket/socket.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -81,6 +83,19 @@
 #  define CONFIG_NET_TCP_MAX_CONNS 0
 #endif
 
+/* The list of connections that may match a segment.  With the hashtable
+ * only the bucket of the (remote address, remote port, local port) key has
+ * to be searched.  The local address is not part of the key because a
+ * connection bound to the wildcard address matches any destination.
+ */
+
+#ifdef CONFIG_NET_TCP_HASH
+#  define TCP_CONN_BUCKET(key) \
+     (&g_tcp_conn_hash[HASH(key, CONFIG_NET_TCP_HASH_BITS)])
+#else
+#  define TCP_CONN_BUCKET(key) (&g_active_tcp_connections)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -95,10 +110,112 @@ NET_BUFPOOL_DECLARE(g_tcp_connections, sizeof(struct tcp_conn_s),
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_TCP_HASH
+/* The active TCP connections hashed by their remote address and ports */
+
+static DECLARE_HASHTABLE(g_tcp_conn_hash, CONFIG_NET_TCP_HASH_BITS);
+#endif
+
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+/* The connections that wait for a TX poll.  The timer and the send paths
+ * queue connections without holding the connection list lock, so the list
+ * has a lock of its own.
+ */
+
+static dq_queue_t g_pending_tcp_connections;
+static int g_tcp_npending;
+static spinlock_t g_tcp_pending_lock = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_ipv4_hash_key / tcp_ipv6_hash_key
+ *
+ * Description:
+ *   Create the hash key of a connection from its remote address, its
+ *   remote port and its local port.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static inline uint32_t tcp_ipv4_hash_key(in_addr_t raddr, uint16_t rport,
+                                         uint16_t lport)
+{
+  return (uint32_t)raddr ^ ((uint32_t)rport << 16) ^ lport;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_hash_key(const net_ipv6addr_t raddr,
+                                         uint16_t rport, uint16_t lport)
+{
+  uint32_t key = (((uint32_t)raddr[0] << 16) | raddr[1]) ^
+                 (((uint32_t)raddr[2] << 16) | raddr[3]) ^
+                 (((uint32_t)raddr[4] << 16) | raddr[5]) ^
+                 (((uint32_t)raddr[6] << 16) | raddr[7]);
+
+  return key ^ ((uint32_t)rport << 16) ^ lport;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_conn_hash_key
+ *
+ * Description:
+ *   Create the hash key of an active connection.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_HASH
+static uint32_t tcp_conn_hash_key(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_ipv4_hash_key(conn->u.ipv4.raddr, conn->rport,
+                               conn->lport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_ipv6_hash_key(conn->u.ipv6.raddr, conn->rport,
+                               conn->lport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+#endif /* CONFIG_NET_TCP_HASH */
+
+/****************************************************************************
+ * Name: tcp_addconn
+ *
+ * Description:
+ *   Add the connection to the list of active TCP connections.  The caller
+ *   holds the TCP connection list lock.
+ *
+ ****************************************************************************/
+
+static void tcp_addconn(FAR struct tcp_conn_s *conn)
+{
+  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+
+#ifdef CONFIG_NET_TCP_HASH
+  /* Append rather than prepend so that connections of one bucket are
+   * still searched in the order they became active.
+   */
+
+  dq_addlast(&conn->hnode, TCP_CONN_BUCKET(tcp_conn_hash_key(conn)));
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_listener
  *
@@ -113,9 +230,12 @@ static dq_queue_t g_active_tcp_connections;
 
 static FAR struct tcp_conn_s *
   tcp_listener(uint8_t domain, FAR const union ip_addr_u *ipaddr,
-               uint16_t portno)
+               uint16_t portno, sockopt_t opt)
 {
   FAR struct tcp_conn_s *conn = NULL;
+#ifdef CONFIG_NET_SOCKOPTS
+  bool reuseport = _SO_GETOPT(opt, SO_REUSEPORT);
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
@@ -133,6 +253,15 @@ static FAR struct tcp_conn_s *
 #endif
          )
         {
+#ifdef CONFIG_NET_SOCKOPTS
+          /* Sockets that both have SO_REUSEPORT share the port */
+
+          if (reuseport && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+            {
+              continue;
+            }
+#endif
+
           return conn;
         }
     }
@@ -142,6 +271,14 @@ static FAR struct tcp_conn_s *
  * 0 in the ip_binding_u union, ipaddr can be passed in through directly.
  */
 
+#ifdef CONFIG_NET_SOCKOPTS
+  if (reuseport)
+    {
+      return tcp_reuseport_conflict(domain, (FAR union ip_binding_u *)ipaddr,
+                                    portno);
+    }
+#endif
+
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
   return tcp_findlistener((FAR union ip_binding_u *)ipaddr,
                           portno, domain);
@@ -168,14 +305,17 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct tcp_conn_s *conn;
+  FAR dq_entry_t *node;
   in_addr_t srcipaddr;
   in_addr_t destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
+  node       = dq_peek(TCP_CONN_BUCKET(tcp_ipv4_hash_key(srcipaddr,
+                                                         tcp->srcport,
+                                                         tcp->destport)));
 
-  while (conn)
+  for (; node != NULL; node = dq_next(node))
     {
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
@@ -194,6 +334,11 @@ static inline FAR struct tcp_conn_s *
        * is destined for this TCP connection.
        */
 
+#ifdef CONFIG_NET_TCP_HASH
+      conn = container_of(node, struct tcp_conn_s, hnode);
+#else
+      conn = container_of(node, struct tcp_conn_s, sconn.node);
+#endif
       if (conn->tcpstateflags != TCP_CLOSED &&
           tcp->destport == conn->lport &&
           tcp->srcport  == conn->rport &&
@@ -201,19 +346,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv4addr_cmp(destipaddr, conn->u.ipv4.laddr)) &&
           net_ipv4addr_cmp(srcipaddr, conn->u.ipv4.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -235,14 +374,17 @@ static inline FAR struct tcp_conn_s *
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct tcp_conn_s *conn;
+  FAR dq_entry_t *node;
   net_ipv6addr_t *srcipaddr;
   net_ipv6addr_t *destipaddr;
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
+  node       = dq_peek(TCP_CONN_BUCKET(tcp_ipv6_hash_key(*srcipaddr,
+                                                         tcp->srcport,
+                                                         tcp->destport)));
 
-  while (conn)
+  for (; node != NULL; node = dq_next(node))
     {
       /* Find an open connection matching the TCP input. The following
        * checks are performed:
@@ -261,6 +403,11 @@ static inline FAR struct tcp_conn_s *
        * is destined for this TCP connection.
        */
 
+#ifdef CONFIG_NET_TCP_HASH
+      conn = container_of(node, struct tcp_conn_s, hnode);
+#else
+      conn = container_of(node, struct tcp_conn_s, sconn.node);
+#endif
       if (conn->tcpstateflags != TCP_CLOSED &&
           tcp->destport == conn->lport &&
           tcp->srcport  == conn->rport &&
@@ -268,19 +415,13 @@ static inline FAR struct tcp_conn_s *
            net_ipv6addr_cmp(*destipaddr, conn->u.ipv6.laddr)) &&
           net_ipv6addr_cmp(*srcipaddr, conn->u.ipv6.raddr))
         {
-          /* Matching connection found.. break out of the loop and return a
-           * reference to it.
-           */
+          /* Matching connection found.. return a reference to it. */
 
-          break;
+          return conn;
         }
-
-      /* Look at the next active connection */
-
-      conn = (FAR struct tcp_conn_s *)conn->sconn.node.flink;
     }
 
-  return conn;
+  return NULL;
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -343,7 +484,13 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   port = tcp_selectport(PF_INET,
                        (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
-                       addr->sin_port);
+                       addr->sin_port,
+#ifdef CONFIG_NET_SOCKOPTS
+                       conn->sconn.s_options
+#else
+                       0
+#endif
+                       );
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -439,7 +586,13 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   port = tcp_selectport(PF_INET6,
                 (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
-                addr->sin6_port);
+                addr->sin6_port,
+#ifdef CONFIG_NET_SOCKOPTS
+                conn->sconn.s_options
+#else
+                0
+#endif
+                );
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -487,6 +640,8 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
  * Input Parameters:
  *   portno -- the selected port number in network order. Zero means no port
  *     selected.
+ *   opt    -- The socket options of the connection, a port that is given
+ *     may be shared by sockets that all have SO_REUSEPORT.
  *
  * Returned Value:
  *   Selected or verified port number in network order on success, a negated
@@ -504,7 +659,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
 int tcp_selectport(uint8_t domain,
                    FAR const union ip_addr_u *ipaddr,
-                   uint16_t portno)
+                   uint16_t portno, sockopt_t opt)
 {
   static uint16_t g_last_tcp_port;
 
@@ -539,7 +694,7 @@ int tcp_selectport(uint8_t domain,
               return -EADDRINUSE;
             }
         }
-      while (tcp_listener(domain, ipaddr, portno)
+      while (tcp_listener(domain, ipaddr, portno, 0)
 #ifdef CONFIG_NET_NAT
              || nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno)
 #endif
@@ -551,7 +706,7 @@ int tcp_selectport(uint8_t domain,
        * connection is using this local port.
        */
 
-      if (tcp_listener(domain, ipaddr, portno)
+      if (tcp_listener(domain, ipaddr, portno, opt)
 #ifdef CONFIG_NET_NAT
           || nat_port_inuse(domain, IP_PROTO_TCP, ipaddr, portno)
 #endif
@@ -773,6 +928,9 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   FAR struct tcp_wrbuffer_s *wrbuffer;
 #endif
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+  irqstate_t flags;
+#endif
 
   DEBUGASSERT(conn->crefs == 0);
 
@@ -812,13 +970,30 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       tcp_conn_list_lock();
-      dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_removeconn(conn);
       tcp_conn_list_unlock();
     }
 
   /* Cancel tcp timer */
 
   tcp_stop_timer(conn);
+  tcp_pacing_free(conn);
+
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+  /* Nothing is left to poll, the timers cannot queue the connection
+   * again
+   */
+
+  flags = spin_lock_irqsave(&g_tcp_pending_lock);
+  if (conn->pending)
+    {
+      dq_rem(&conn->pnode, &g_pending_tcp_connections);
+      conn->pending = false;
+      g_tcp_npending--;
+    }
+
+  spin_unlock_irqrestore(&g_tcp_pending_lock, flags);
+#endif
 
   nxrmutex_destroy(&conn->sconn.s_lock);
   tcp_free_rx_buffers(conn);
@@ -999,6 +1174,74 @@ FAR struct tcp_conn_s *tcp_nextconn(FAR struct tcp_conn_s *conn)
     }
 }
 
+#ifdef CONFIG_NET_TCP_POLL_PENDING
+/****************************************************************************
+ * Name: tcp_txpending
+ *
+ * Description:
+ *   Queue a connection for the next TX poll of its device.
+ *
+ ****************************************************************************/
+
+void tcp_txpending(FAR struct tcp_conn_s *conn)
+{
+  irqstate_t flags = spin_lock_irqsave(&g_tcp_pending_lock);
+
+  if (!conn->pending)
+    {
+      dq_addlast(&conn->pnode, &g_pending_tcp_connections);
+      conn->pending = true;
+      g_tcp_npending++;
+    }
+
+  spin_unlock_irqrestore(&g_tcp_pending_lock, flags);
+}
+
+/****************************************************************************
+ * Name: tcp_npending
+ ****************************************************************************/
+
+int tcp_npending(void)
+{
+  return g_tcp_npending;
+}
+
+/****************************************************************************
+ * Name: tcp_nextpending
+ *
+ * Description:
+ *   Dequeue the first queued connection bound to dev.  The connections of
+ *   the other devices stay queued for the polls of their own device.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_nextpending(FAR struct net_driver_s *dev)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+  FAR dq_entry_t *node;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_tcp_pending_lock);
+  for (node = dq_peek(&g_pending_tcp_connections); node != NULL;
+       node = dq_next(node))
+    {
+      conn = container_of(node, struct tcp_conn_s, pnode);
+      if (conn->dev == dev)
+        {
+          dq_rem(node, &g_pending_tcp_connections);
+          conn->pending = false;
+          g_tcp_npending--;
+          break;
+        }
+
+      conn = NULL;
+    }
+
+  spin_unlock_irqrestore(&g_tcp_pending_lock, flags);
+  return conn;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_alloc_accept
  *
@@ -1118,6 +1361,8 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #ifdef CONFIG_NET_SOCKOPTS
       conn->sconn.s_rcvtimeo = listener->sconn.s_rcvtimeo;
       conn->sconn.s_sndtimeo = listener->sconn.s_sndtimeo;
+      conn->sconn.s_options |= listener->sconn.s_options &
+                               _SO_BIT(SO_REUSEPORT);
 #  ifdef CONFIG_NET_BINDTODEVICE
       conn->sconn.s_boundto  = listener->sconn.s_boundto;
 #  endif
@@ -1130,6 +1375,10 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #endif
 #if CONFIG_NET_SEND_BUFSIZE > 0
       conn->snd_bufs         = listener->snd_bufs;
+#endif
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+      conn->at_flags         = listener->at_flags &
+                               (TCP_AUTOTUNE_RCVLOCK | TCP_AUTOTUNE_SNDLOCK);
 #endif
       conn->mss              = listener->mss;
 
@@ -1181,7 +1430,7 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       tcp_conn_list_lock();
-      dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+      tcp_addconn(conn);
       tcp_conn_list_unlock();
 
       tcp_update_retrantimer(conn, TCP_RTO);
@@ -1298,7 +1547,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
           port = tcp_selectport(PF_INET,
                                 (FAR const union ip_addr_u *)
-                                &conn->u.ipv4.laddr, 0);
+                                &conn->u.ipv4.laddr, 0, 0);
         }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -1313,7 +1562,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
 
           port = tcp_selectport(PF_INET6,
                                 (FAR const union ip_addr_u *)
-                                conn->u.ipv6.laddr, 0);
+                                conn->u.ipv6.laddr, 0, 0);
         }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -1490,7 +1739,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   tcp_conn_list_lock();
-  dq_addlast(&conn->sconn.node, &g_active_tcp_connections);
+  tcp_addconn(conn);
   tcp_conn_list_unlock();
 
   return OK;
@@ -1536,6 +1785,9 @@ void tcp_conn_list_unlock(void)
 void tcp_removeconn(FAR struct tcp_conn_s *conn)
 {
   dq_rem(&conn->sconn.node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_HASH
+  dq_rem(&conn->hnode, TCP_CONN_BUCKET(tcp_conn_hash_key(conn)));
+#endif
 }
 
 /****************************************************************************
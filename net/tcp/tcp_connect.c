@@ -379,6 +379,7 @@ int psock_tcp_connect(FAR struct socket *psock,
 
               /* Notify the device driver that new connection is available. */
 
+              tcp_txpending(conn);
               netdev_txnotify_dev(conn->dev, TCP_POLL);
 
               /* Wait for either the connect to complete or for an
@@ -443,6 +444,7 @@ int psock_tcp_connect(FAR struct socket *psock,
 
           /* Notify the device driver that new connection is available. */
 
+          tcp_txpending(conn);
           netdev_txnotify_dev(conn->dev, TCP_POLL);
         }
     }
@@ -726,7 +726,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #ifdef CONFIG_NET_TCP_CHECKSUMS
   /* Start of TCP input header processing code. */
 
-  if (tcp_chksum(dev) != 0xffff)
+  if (!NETDEV_RXCSUM_OK(dev) && tcp_chksum(dev) != 0xffff)
     {
       /* Compute and check the TCP checksum. */
 
@@ -915,6 +915,12 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   if ((conn = tcp_findlistener(&uaddr, tmp16)) != NULL)
 #endif
     {
+#ifdef CONFIG_NET_SOCKOPTS
+      /* Spread the connections over the listeners sharing the port */
+
+      conn = tcp_reuseport_select(dev, conn, &uaddr, tcp->srcport);
+#endif
+
       /* According rfc793 p65&66, In LISTEN state, first ignore packet
        * contains RST flag, second reset packet contains ACK flag,
        * finally if the packet is not a SYN, ignore it.
@@ -1367,6 +1373,10 @@ skip_rtt:
 
           flags |= TCP_ACKDATA;
         }
+
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+      tcp_autotune_ack(conn);
+#endif
     }
 
   /* Do different things depending on in what state the connection is. */
@@ -1654,6 +1664,9 @@ skip_rtt:
         if (dev->d_len > 0 && (conn->tcpstateflags & TCP_STOPPED) == 0)
           {
             flags |= TCP_NEWDATA;
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+            tcp_autotune_rcvdata(conn, dev->d_len);
+#endif
           }
 
         /* If this packet constitutes an ACK for outstanding data (flagged
@@ -50,25 +50,150 @@
 #include <stdbool.h>
 #include <debug.h>
 
+#include <nuttx/sched.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_HASH
+#  define TCP_LISTEN_BUCKET(portno) \
+     (&g_tcp_listen_hash[HASH(portno, CONFIG_NET_TCP_HASH_BITS)])
+#endif
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+#  define TCP_LISTENER_CMP(d,a,p,c) \
+     tcp_conn_cmp(d, (FAR const union ip_addr_u *)(a), p, c)
+#  define TCP_DOMAIN(c) ((c)->domain)
+#else
+#  define TCP_LISTENER_CMP(d,a,p,c) \
+     tcp_conn_cmp((FAR const union ip_addr_u *)(a), p, c)
+#  define TCP_DOMAIN(c) 0
+#endif
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
+#ifdef CONFIG_NET_TCP_HASH
+/* The listening connections hashed by their local port.  The local address
+ * is not part of the key because a listener may be bound to the wildcard
+ * address.
+ */
+
+static DECLARE_HASHTABLE(g_tcp_listen_hash, CONFIG_NET_TCP_HASH_BITS);
+static int g_tcp_nlisteners;
+#else
 /* The tcp_listenports list all currently listening ports. */
 
 static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_nextlistener
+ *
+ * Description:
+ *   Return the next listener after prev (the first one if prev is NULL)
+ *   for connections on this address and port.  The caller holds the TCP
+ *   connection list lock.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_conn_s *
+tcp_nextlistener(FAR struct tcp_conn_s *prev, FAR union ip_binding_u *uaddr,
+                 uint16_t portno, uint8_t domain)
+{
+  FAR struct tcp_conn_s *conn;
+#ifdef CONFIG_NET_TCP_HASH
+  FAR dq_entry_t *node;
+
+  /* Examine each connection listening on a port of the same bucket */
+
+  node = prev != NULL ? dq_next(&prev->lnode) :
+                        dq_peek(TCP_LISTEN_BUCKET(portno));
+  for (; node != NULL; node = dq_next(node))
+    {
+      conn = container_of(node, struct tcp_conn_s, lnode);
+      if (TCP_LISTENER_CMP(domain, uaddr, portno, conn))
+        {
+          return conn;
+        }
+    }
+#else
+  int ndx = 0;
+
+  /* Continue after the slot of prev */
+
+  while (prev != NULL && ndx < CONFIG_NET_MAX_LISTENPORTS &&
+         tcp_listenports[ndx++] != prev)
+    {
+    }
+
+  /* Examine each connection structure in each slot of the listener list */
+
+  for (; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      /* Is this slot assigned?  If so, does the connection have the same
+       * local port number?
+       */
+
+      conn = tcp_listenports[ndx];
+      if (TCP_LISTENER_CMP(domain, uaddr, portno, conn))
+        {
+          return conn;
+        }
+    }
+#endif
+
+  /* No more listeners for this port */
+
+  UNUSED(domain);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: tcp_listen_inuse
+ *
+ * Description:
+ *   Return true if conn may not listen because another listener has its
+ *   address and port, unless both have SO_REUSEPORT.  The caller holds the
+ *   TCP connection list lock.
+ *
+ ****************************************************************************/
+
+static bool tcp_listen_inuse(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s *other = NULL;
+
+  while ((other = tcp_nextlistener(other, &conn->u, conn->lport,
+                                   TCP_DOMAIN(conn))) != NULL)
+    {
+#ifdef CONFIG_NET_SOCKOPTS
+      if (_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) &&
+          _SO_GETOPT(other->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
+#endif
+
+      return true;
+    }
+
+  return false;
+}
+
 /****************************************************************************
  * Name: tcp_findlistener
  *
@@ -89,34 +214,16 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
                                         uint16_t portno)
 #endif
 {
-  int ndx;
-
-  /* Examine each connection structure in each slot of the listener list */
+  FAR struct tcp_conn_s *conn;
 
   tcp_conn_list_lock();
-  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
-    {
-      /* Is this slot assigned?  If so, does the connection have the same
-       * local port number?
-       */
-
-      FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if (tcp_conn_cmp(domain, (FAR const union ip_addr_u *)uaddr, portno,
-                       conn))
+  conn = tcp_nextlistener(NULL, uaddr, portno, domain);
 #else
-      if (tcp_conn_cmp((FAR const union ip_addr_u *)uaddr, portno, conn))
+  conn = tcp_nextlistener(NULL, uaddr, portno, 0);
 #endif
-        {
-          tcp_conn_list_unlock();
-          return conn;
-        }
-    }
-
-  /* No listener for this port */
-
   tcp_conn_list_unlock();
-  return NULL;
+  return conn;
 }
 
 /****************************************************************************
@@ -136,20 +243,45 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
 
 int tcp_unlisten(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_HASH
+  FAR dq_entry_t *node;
+#else
   int ndx;
+#endif
   int ret = -EINVAL;
 
   tcp_conn_list_lock();
+#ifdef CONFIG_NET_TCP_HASH
+  for (node = dq_peek(TCP_LISTEN_BUCKET(conn->lport)); node != NULL;
+       node = dq_next(node))
+    {
+      if (node == &conn->lnode)
+        {
+          dq_rem(node, TCP_LISTEN_BUCKET(conn->lport));
+          g_tcp_nlisteners--;
+          ret = OK;
+          break;
+        }
+    }
+#else
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
     {
       if (tcp_listenports[ndx] == conn)
         {
           tcp_listenports[ndx] = NULL;
-          tcp_remove_syn_backlog(conn);
           ret = OK;
           break;
         }
     }
+#endif
+
+  /* The pending connections stay for the other listeners of the port */
+
+  if (ret == OK && tcp_nextlistener(NULL, &conn->u, conn->lport,
+                                    TCP_DOMAIN(conn)) == NULL)
+    {
+      tcp_remove_syn_backlog(conn);
+    }
 
   tcp_conn_list_unlock();
   return ret;
@@ -168,7 +300,9 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+#ifndef CONFIG_NET_TCP_HASH
   int ndx;
+#endif
   int ret;
 
   /* This must be done with network locked because the listener table
@@ -179,11 +313,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
   /* First, check if there is already a socket listening on this port */
 
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(&conn->u, conn->lport, conn->domain))
-#else
-  if (tcp_islistener(&conn->u, conn->lport))
-#endif
+  if (tcp_listen_inuse(conn))
     {
       /* Yes, then we must refuse this request */
 
@@ -197,6 +327,14 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 
       ret = -ENOBUFS; /* Assume failure */
 
+#ifdef CONFIG_NET_TCP_HASH
+      if (g_tcp_nlisteners < CONFIG_NET_MAX_LISTENPORTS)
+        {
+          dq_addlast(&conn->lnode, TCP_LISTEN_BUCKET(conn->lport));
+          g_tcp_nlisteners++;
+          ret = OK;
+        }
+#else
       /* Search all slots until an available slot is found */
 
       for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -212,6 +350,7 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
               break;
             }
         }
+#endif
     }
 
   tcp_conn_list_unlock();
@@ -242,6 +381,112 @@ bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno)
 }
 #endif
 
+/****************************************************************************
+ * Name: tcp_reuseport_conflict
+ *
+ * Description:
+ *   Return a listener without SO_REUSEPORT on this address and port, one
+ *   that keeps a socket with SO_REUSEPORT from binding them.
+ *
+ * Assumptions:
+ *   The TCP connection list is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct tcp_conn_s *
+tcp_reuseport_conflict(uint8_t domain, FAR union ip_binding_u *uaddr,
+                       uint16_t portno)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+
+  while ((conn = tcp_nextlistener(conn, uaddr, portno, domain)) != NULL)
+    {
+      if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          break;
+        }
+    }
+
+  return conn;
+}
+
+/****************************************************************************
+ * Name: tcp_reuseport_select
+ *
+ * Description:
+ *   listener is the first listener that tcp_findlistener() found for a SYN
+ *   to uaddr.  If it has SO_REUSEPORT, choose the listener that accepts
+ *   the connection among all those with SO_REUSEPORT on the address and
+ *   port, by the hash of the source of the SYN.  With CONFIG_NETDEV_RSS,
+ *   the listeners that last accepted on this CPU come first.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *
+tcp_reuseport_select(FAR struct net_driver_s *dev,
+                     FAR struct tcp_conn_s *listener,
+                     FAR union ip_binding_u *uaddr, uint16_t srcport)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+  uint32_t hash;
+  int nlocal = 0;
+  int pick;
+  int n = 0;
+#ifdef CONFIG_NETDEV_RSS
+  int cpu = this_cpu();
+#endif
+
+  if (!_SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT))
+    {
+      return listener;
+    }
+
+  tcp_conn_list_lock();
+  while ((conn = tcp_nextlistener(conn, uaddr, listener->lport,
+                                  TCP_DOMAIN(listener))) != NULL)
+    {
+      if (_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          n++;
+#ifdef CONFIG_NETDEV_RSS
+          nlocal += conn->rcvcpu == cpu;
+#endif
+        }
+    }
+
+  if (n < 2)
+    {
+      tcp_conn_list_unlock();
+      return listener;
+    }
+
+  /* Pick the hash modulo the listeners of this CPU if there are any */
+
+  hash = net_flowhash(dev, srcport);
+  pick = nlocal > 0 ? hash % nlocal : hash % n;
+
+  while ((conn = tcp_nextlistener(conn, uaddr, listener->lport,
+                                  TCP_DOMAIN(listener))) != NULL)
+    {
+      if (_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) &&
+#ifdef CONFIG_NETDEV_RSS
+          (nlocal == 0 || conn->rcvcpu == cpu) &&
+#endif
+          pick-- == 0)
+        {
+          break;
+        }
+    }
+
+  tcp_conn_list_unlock();
+  return conn != NULL ? conn : listener;
+}
+#endif /* CONFIG_NET_SOCKOPTS */
+
 /****************************************************************************
  * Name: tcp_accept_connection
  *
@@ -269,6 +514,16 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
 #else
   listener = tcp_findlistener(&conn->u, portno);
 #endif
+
+#ifdef CONFIG_NET_SOCKOPTS
+  /* The same hash of the peer picks the listener that took the SYN */
+
+  if (listener != NULL)
+    {
+      listener = tcp_reuseport_select(dev, listener, &conn->u, conn->rport);
+    }
+#endif
+
   if (listener != NULL)
     {
       /* Yes, there is a listener.  Is it accepting connections now? */
@@ -0,0 +1,324 @@
+/****************************************************************************
+ * net/tcp/tcp_pacing.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
+#include "tcp/tcp.h"
+
+#ifdef CONFIG_NET_TCP_PACING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The pacing rate is cwnd / srtt times a gain in percent, twice the
+ * window in slow start so that it can still double every round trip.
+ */
+
+#define PACING_GAIN_SS      200
+#define PACING_GAIN_CA      120
+
+/* A segment may leave up to one clock tick early, the timer cannot do
+ * better and the rate still averages out.
+ */
+
+#define PACING_SLACK        TICK2NSEC(1)
+
+#define PACING_NOW()        TICK2NSEC((uint64_t)clock_systime_ticks())
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void tcp_pacing_work(FAR void *arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The connections that wait for their next departure time, one work wakes
+ * them up.
+ */
+
+static dq_queue_t g_pacing_wait;
+static struct work_s g_pacing_work;
+static spinlock_t g_pacing_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_pacing_schedule
+ *
+ * Description:
+ *   Run the wakeup work at the earliest departure time of the waiting
+ *   connections.  Called with g_pacing_lock held.
+ *
+ ****************************************************************************/
+
+static void tcp_pacing_schedule(uint64_t now)
+{
+  FAR struct tcp_conn_s *conn;
+  FAR dq_entry_t *node;
+  uint64_t next = UINT64_MAX;
+
+  dq_for_every(&g_pacing_wait, node)
+    {
+      conn = container_of(node, struct tcp_conn_s, pace_node);
+      next = MIN(next, conn->pace_next);
+    }
+
+  if (next != UINT64_MAX)
+    {
+      work_queue(LPWORK, &g_pacing_work, tcp_pacing_work, NULL,
+                 next > now ? NSEC2TICK(next - now + TICK2NSEC(1) - 1) : 0);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_work
+ *
+ * Description:
+ *   Poll the connections whose departure time has come.  A connection
+ *   leaves the wait list with the lock held, so tcp_pacing_free() either
+ *   takes it off first or finds it gone.
+ *
+ ****************************************************************************/
+
+static void tcp_pacing_work(FAR void *arg)
+{
+  FAR struct net_driver_s *dev;
+  FAR struct tcp_conn_s *conn;
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *next;
+  irqstate_t flags;
+  uint64_t now;
+
+  flags = spin_lock_irqsave(&g_pacing_lock);
+  now   = PACING_NOW();
+
+  for (node = dq_peek(&g_pacing_wait); node != NULL; node = next)
+    {
+      next = dq_next(node);
+      conn = container_of(node, struct tcp_conn_s, pace_node);
+      if (conn->pace_next <= now + PACING_SLACK)
+        {
+          dq_rem(node, &g_pacing_wait);
+          conn->pace_wait = false;
+
+          tcp_txpending(conn);
+          dev = conn->dev;
+
+          spin_unlock_irqrestore(&g_pacing_lock, flags);
+          netdev_lock(dev);
+          netdev_txnotify_dev(dev, TCP_POLL);
+          netdev_unlock(dev);
+          flags = spin_lock_irqsave(&g_pacing_lock);
+
+          /* The list may have changed while it was unlocked */
+
+          next = dq_peek(&g_pacing_wait);
+        }
+    }
+
+  tcp_pacing_schedule(now);
+  spin_unlock_irqrestore(&g_pacing_lock, flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_pacing_allow
+ *
+ * Description:
+ *   Return true if the connection may send a segment now.  Otherwise the
+ *   connection waits for its departure time, when it will be polled
+ *   again.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_pacing_allow(FAR struct tcp_conn_s *conn)
+{
+  irqstate_t flags;
+  uint64_t now;
+
+  /* Nothing to pace by before the first round trip was measured */
+
+  if (conn->pace_srtt == 0)
+    {
+      return true;
+    }
+
+  now = PACING_NOW();
+  if (conn->pace_next <= now + PACING_SLACK)
+    {
+      return true;
+    }
+
+  flags = spin_lock_irqsave(&g_pacing_lock);
+  if (!conn->pace_wait)
+    {
+      dq_addlast(&conn->pace_node, &g_pacing_wait);
+      conn->pace_wait = true;
+      tcp_pacing_schedule(now);
+    }
+
+  spin_unlock_irqrestore(&g_pacing_lock, flags);
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_sent
+ *
+ * Description:
+ *   Account a segment of sndlen bytes starting at seq that was just sent:
+ *   push the departure time of the next one and time a round trip if none
+ *   is being timed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_sent(FAR struct tcp_conn_s *conn, uint32_t seq,
+                     uint32_t sndlen)
+{
+  uint64_t now = PACING_NOW();
+  uint32_t gain;
+
+  if (!conn->pace_timing)
+    {
+      conn->pace_rttseq   = seq + sndlen;
+      conn->pace_rttstart = now;
+      conn->pace_timing   = true;
+    }
+
+  if (conn->pace_srtt == 0 || conn->cwnd == 0)
+    {
+      return;
+    }
+
+  /* An idle connection does not save up departures for a burst */
+
+  if (conn->pace_next < now)
+    {
+      conn->pace_next = now;
+    }
+
+  gain = conn->cwnd < conn->ssthresh ? PACING_GAIN_SS : PACING_GAIN_CA;
+  conn->pace_next += (uint64_t)sndlen * conn->pace_srtt * 100 /
+                     ((uint64_t)conn->cwnd * gain);
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_ack
+ *
+ * Description:
+ *   Update the smoothed round trip time when ackno covers the segment that
+ *   is being timed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_ack(FAR struct tcp_conn_s *conn, uint32_t ackno)
+{
+  uint64_t rtt;
+
+  if (!conn->pace_timing || TCP_SEQ_LT(ackno, conn->pace_rttseq))
+    {
+      return;
+    }
+
+  conn->pace_timing = false;
+  rtt = MAX(PACING_NOW() - conn->pace_rttstart, TICK2NSEC(1));
+
+  if (conn->pace_srtt == 0)
+    {
+      conn->pace_srtt = rtt;
+    }
+  else
+    {
+      conn->pace_srtt = conn->pace_srtt - (conn->pace_srtt >> 3) +
+                        (rtt >> 3);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_rexmit
+ *
+ * Description:
+ *   A retransmission makes the round trip that is being timed ambiguous,
+ *   drop it (Karn's algorithm).
+ *
+ ****************************************************************************/
+
+void tcp_pacing_rexmit(FAR struct tcp_conn_s *conn)
+{
+  conn->pace_timing = false;
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_free
+ *
+ * Description:
+ *   Take a connection that is being freed off the wait list.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_free(FAR struct tcp_conn_s *conn)
+{
+  irqstate_t flags = spin_lock_irqsave(&g_pacing_lock);
+
+  if (conn->pace_wait)
+    {
+      dq_rem(&conn->pace_node, &g_pacing_wait);
+      conn->pace_wait = false;
+    }
+
+  spin_unlock_irqrestore(&g_pacing_lock, flags);
+}
+
+#endif /* CONFIG_NET_TCP_PACING */
@@ -834,8 +834,16 @@ static ssize_t tcp_recvfrom_one(FAR struct tcp_conn_s *conn, FAR void *buf,
    * system, not only this particular connection.
    */
 
+#ifdef CONFIG_NET_TCP_AUTOTUNE
+  if (ret > 0 && (flags & MSG_PEEK) == 0)
+    {
+      tcp_autotune_copied(conn, ret);
+    }
+#endif
+
   if (tcp_should_send_recvwindow(conn))
     {
+      tcp_txpending(conn);
       netdev_txnotify_dev(conn->dev, TCP_POLL);
     }
 
@@ -879,6 +887,18 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   conn = psock->s_conn;
   conn_dev_lock(&conn->sconn, conn->dev);
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* The error queue only holds the completions of MSG_ZEROCOPY sends */
+
+  if ((flags & MSG_ERRQUEUE) != 0)
+    {
+      ret = tcp_zerocopy_recverr(conn, msg);
+      conn_dev_unlock(&conn->sconn, conn->dev);
+      return ret;
+    }
+#endif
+
   for (i = 0; i < msg->msg_iovlen; i++)
     {
       FAR void *buf = msg->msg_iov[i].iov_base;
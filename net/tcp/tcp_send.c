@@ -149,7 +149,7 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
   else
     {
-      if (work_available(&conn->work) && conn->tx_unacked != 0)
+      if (tcp_timer_available(conn) && conn->tx_unacked != 0)
         {
           conn->timeout = false;
           tcp_update_retrantimer(conn, conn->rto);
@@ -200,7 +200,10 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!netdev_txcsum_offload(dev, IP_PROTO_TCP, IPv6_HDRLEN))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -224,7 +227,10 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!netdev_txcsum_offload(dev, IP_PROTO_TCP, IPv4_HDRLEN))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -233,6 +239,21 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
 #endif /* CONFIG_NET_IPv4 */
 
+#if defined(CONFIG_NETDEV_OFFLOAD) && defined(CONFIG_NET_TCP_CHECKSUMS)
+  /* A payload larger than the MSS was allowed by tcp_max_sndlen(), let the
+   * hardware cut it into segments.
+   */
+
+  if ((NETDEV_PKTFLAGS(dev) & NETPKT_TX_CSUM) != 0 &&
+      dev->d_len - dev->d_iob->io_meta.l4off -
+      ((tcp->tcpoffset >> 4) << 2) > conn->mss)
+    {
+      DEBUGASSERT(NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TSO));
+      NETDEV_PKTFLAGS(dev)        |= NETPKT_TX_TSO;
+      dev->d_iob->io_meta.gsosize  = conn->mss;
+    }
+#endif
+
   ninfo("Outgoing TCP packet length: %d bytes\n", dev->d_len);
 #ifdef CONFIG_NET_STATISTICS
   g_netstats.tcp.sent++;
@@ -507,7 +528,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+      if (!netdev_txcsum_offload(dev, IP_PROTO_TCP, IPv6_HDRLEN))
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv6 */
@@ -527,7 +551,10 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+      if (!netdev_txcsum_offload(dev, IP_PROTO_TCP, IPv4_HDRLEN))
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
     }
 #endif /* CONFIG_NET_IPv4 */
@@ -572,6 +599,38 @@ uint16_t tcp_rx_mss(FAR struct net_driver_s *dev)
   return tcp_mss;
 }
 
+/****************************************************************************
+ * Name: tcp_max_sndlen
+ *
+ * Description:
+ *   Return the maximum payload of one outgoing TCP packet on the device.
+ *   This is the MSS, or a multiple of it if the device does TCP
+ *   segmentation offload.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Returned Value:
+ *   The maximum payload length.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_max_sndlen(FAR struct net_driver_s *dev,
+                        FAR struct tcp_conn_s *conn)
+{
+#if defined(CONFIG_NETDEV_OFFLOAD) && defined(CONFIG_NET_TCP_CHECKSUMS)
+  if (conn->mss > 0 &&
+      NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_TXCSUM | NETDEV_FEATURE_TSO))
+    {
+      return MAX(conn->mss, CONFIG_NETDEV_TSO_MAXSIZE -
+                            CONFIG_NETDEV_TSO_MAXSIZE % conn->mss);
+    }
+#endif
+
+  return conn->mss;
+}
+
 /****************************************************************************
  * Name: tcp_synack
  *
@@ -688,6 +747,8 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 void tcp_send_txnotify(FAR struct socket *psock,
                        FAR struct tcp_conn_s *conn)
 {
+  tcp_txpending(conn);
+
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
   /* If both IPv4 and IPv6 support are enabled, then we will need to select
@@ -207,6 +207,7 @@ static void retransmit_segment(FAR struct tcp_conn_s *conn,
     {
       uint16_t sent;
 
+      tcp_pacing_rexmit(conn);
       sent = TCP_WBSENT(wrb);
 
       ninfo("REXMIT: wrb=%p sent=%u, "
@@ -248,6 +249,39 @@ static void retransmit_segment(FAR struct tcp_conn_s *conn,
     }
 }
 
+/****************************************************************************
+ * Name: psock_wrb_send
+ *
+ * Description:
+ *   Set up to send sndlen bytes at offset of the write buffer.  The data
+ *   of a MSG_ZEROCOPY send is referenced in place if possible.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static int psock_wrb_send(FAR struct net_driver_s *dev,
+                          FAR struct tcp_conn_s *conn,
+                          FAR struct tcp_wrbuffer_s *wrb,
+                          unsigned int sndlen, unsigned int offset)
+{
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  if ((wrb->wb_zcflags & TCP_WBZC_REF) != 0)
+    {
+      int ret = devif_iob_refsend(dev, TCP_WBIOB(wrb), sndlen, offset,
+                                  tcpip_hdrsize(conn));
+      if (ret > 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  return devif_iob_send(dev, TCP_WBIOB(wrb), sndlen, offset,
+                        tcpip_hdrsize(conn));
+}
+
 /****************************************************************************
  * Name: psock_lost_connection
  *
@@ -507,6 +541,8 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       ackno = tcp_getsequence(tcp->ackno);
       ninfo("ACK: ackno=%" PRIu32 " flags=%" PRIx32 "\n", ackno, flags);
 
+      tcp_pacing_ack(conn, ackno);
+
       /* Look at every write buffer in the unacked_q.  The unacked_q
        * holds write buffers that have been entirely sent, but which
        * have not yet been ACKed.
@@ -626,6 +662,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                        */
 
                       conn->timeout = true;
+                      tcp_txpending(conn);
                       netdev_txnotify_dev(conn->dev, TCP_POLL);
                       netdev_iob_replace(dev, iob);
                       dev->d_buf = buf;
@@ -790,8 +827,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
-          ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
-                               0, tcpip_hdrsize(conn));
+          ret = psock_wrb_send(dev, conn, wrb, sndlen, 0);
           if (ret <= 0)
             {
               return flags;
@@ -1056,15 +1092,21 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 #else
       snd_wnd_edge = conn->snd_wl2 + conn->snd_wnd;
 #endif
-      if (TCP_SEQ_LT(seq, snd_wnd_edge))
+      if (TCP_SEQ_LT(seq, snd_wnd_edge) && tcp_pacing_allow(conn))
         {
           uint32_t remaining_snd_wnd;
+          uint32_t maxlen;
           int ret;
 
+          /* With TCP segmentation offload, several MSS may go out in one
+           * packet.
+           */
+
+          maxlen = tcp_max_sndlen(dev, conn);
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > maxlen)
             {
-              sndlen = conn->mss;
+              sndlen = maxlen;
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1128,8 +1170,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
-          ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
-                               TCP_WBSENT(wrb), tcpip_hdrsize(conn));
+          ret = psock_wrb_send(dev, conn, wrb, sndlen, TCP_WBSENT(wrb));
           if (ret <= 0)
             {
               return flags;
@@ -1143,6 +1184,7 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
           conn->tx_unacked += sndlen;
           conn->sent       += sndlen;
+          tcp_pacing_sent(conn, seq, sndlen);
 
           /* Below prediction will become true,
            * unless retransmission occurrence
@@ -1339,6 +1381,7 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   FAR const uint8_t *cp;
   unsigned int timeout;
   ssize_t    result = 0;
+  bool       zerocopy = false;
   bool       nonblock;
   int        ret = OK;
   clock_t    start;
@@ -1403,6 +1446,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   start    = clock_systime_ticks();
   timeout  = _SO_TIMEOUT(conn->sconn.s_sndtimeo);
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* MSG_ZEROCOPY is ignored unless the socket has SO_ZEROCOPY */
+
+  zerocopy = (flags & MSG_ZEROCOPY) != 0 &&
+             _SO_GETOPT(conn->sconn.s_options, SO_ZEROCOPY);
+#endif
+
   /* Dump the incoming buffer */
 
   BUF_DUMP("psock_tcp_send", buf, len);
@@ -1514,7 +1564,8 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
           max_wrb_size = tcp_max_wrb_size(conn);
           wrb = (FAR struct tcp_wrbuffer_s *)sq_tail(&conn->write_q);
-          if (wrb != NULL && TCP_WBSENT(wrb) == 0 && TCP_WBNRTX(wrb) == 0 &&
+          if (!zerocopy && wrb != NULL && !TCP_WBZEROCOPY(wrb) &&
+              TCP_WBSENT(wrb) == 0 && TCP_WBNRTX(wrb) == 0 &&
               TCP_WBPKTLEN(wrb) < max_wrb_size &&
               (TCP_WBPKTLEN(wrb) % conn->mss) != 0)
             {
@@ -1561,6 +1612,18 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
           TCP_WBNRTX(wrb)  = 0;
 
           off = TCP_WBPKTLEN(wrb);
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+          /* A write buffer referencing the user data needs no I/O buffer
+           * space, it is only limited by the 16-bit sent count.
+           */
+
+          if (zerocopy)
+            {
+              max_wrb_size = UINT16_MAX - UINT16_MAX % conn->mss;
+            }
+#endif
+
           if (off + chunk_len > max_wrb_size)
             {
               chunk_len = max_wrb_size - off;
@@ -1578,7 +1641,27 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            * remaining data.
            */
 
-          chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+          chunk_result = -ENOMEM;
+          if (zerocopy)
+            {
+              chunk_result = tcp_zerocopy_fill(wrb, cp, chunk_len);
+              if (chunk_result < 0)
+                {
+                  /* Fall back to copying as much as a write buffer of the
+                   * copying path holds.
+                   */
+
+                  chunk_len = MIN(chunk_len, tcp_max_wrb_size(conn));
+                }
+            }
+
+          if (chunk_result < 0)
+#endif
+            {
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+            }
+
           if (chunk_result == -ENOMEM)
             {
               if (TCP_WBPKTLEN(wrb) > 0)
@@ -1656,6 +1739,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
        * conn->write_q
        */
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+      if (zerocopy)
+        {
+          tcp_zerocopy_queued(conn, wrb);
+        }
+#endif
+
       sq_addlast(&wrb->wb_node, &conn->write_q);
       ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
             wrb, TCP_WBPKTLEN(wrb),
@@ -1695,6 +1785,15 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
       result += chunk_result;
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  if (zerocopy)
+    {
+      conn_dev_lock(&conn->sconn, conn->dev);
+      tcp_zerocopy_end(conn);
+      conn_dev_unlock(&conn->sconn, conn->dev);
+    }
+#endif
+
   /* Check for errors.  Errors are signaled by negative errno values
    * for the send length
    */
@@ -1710,6 +1809,13 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   return result;
 
 errout_with_lock:
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  if (zerocopy)
+    {
+      tcp_zerocopy_end(conn);
+    }
+#endif
+
   conn_dev_unlock(&conn->sconn, conn->dev);
 
 errout:
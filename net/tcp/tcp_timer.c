@@ -58,6 +58,7 @@
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
 #include <nuttx/net/tcp.h>
+#include <nuttx/spinlock.h>
 
 #include "netdev/netdev.h"
 #include "devif/devif.h"
@@ -79,6 +80,41 @@
 
 #define ACK_DELAY (1)
 
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+/* The wheel has one slot per half-second, the resolution of the timers */
+
+#  define WHEEL_NSLOTS      CONFIG_NET_TCP_TIMER_WHEEL_SLOTS
+#  define WHEEL_TICK        HSEC2TICK(1)
+#  define WHEEL_SLOT(t)     (&g_tcp_wheel[((t) / WHEEL_TICK) % WHEEL_NSLOTS])
+#  define WHEEL_BEFORE(a,b) ((sclock_t)((a) - (b)) < 0)
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+static void tcp_wheel_expiry(FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+/* The armed timers of all connections, each in the slot of its deadline.
+ * A slot holds the deadlines of every lap of the wheel, one work drives
+ * the wheel and only runs when a deadline is due.
+ */
+
+static dq_queue_t g_tcp_wheel[WHEEL_NSLOTS];
+static struct work_s g_tcp_wheel_work;
+static clock_t g_tcp_wheel_due;    /* When g_tcp_wheel_work runs */
+static clock_t g_tcp_wheel_clock;  /* The first slot not yet expired */
+static unsigned int g_tcp_wheel_narmed;
+static spinlock_t g_tcp_wheel_lock = SP_UNLOCKED;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -123,6 +159,195 @@ static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
   return timeout;
 }
 
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+/****************************************************************************
+ * Name: tcp_wheel_next
+ *
+ * Description:
+ *   The earliest deadline in the lap of the wheel that starts at now.  The
+ *   wheel is checked again one lap later if all deadlines are further.
+ *   Called with g_tcp_wheel_lock held.
+ *
+ ****************************************************************************/
+
+static clock_t tcp_wheel_next(clock_t now)
+{
+  FAR struct tcp_conn_s *conn;
+  FAR dq_entry_t *node;
+  clock_t slot = now - now % WHEEL_TICK;
+  clock_t next;
+  bool found;
+  int i;
+
+  for (i = 0; i < WHEEL_NSLOTS; i++, slot += WHEEL_TICK)
+    {
+      found = false;
+      next  = 0;
+
+      dq_for_every(WHEEL_SLOT(slot), node)
+        {
+          conn = container_of(node, struct tcp_conn_s, tnode);
+          if (WHEEL_BEFORE(conn->tdeadline, slot + WHEEL_TICK) &&
+              (!found || WHEEL_BEFORE(conn->tdeadline, next)))
+            {
+              next  = conn->tdeadline;
+              found = true;
+            }
+        }
+
+      if (found)
+        {
+          return next;
+        }
+    }
+
+  return now + WHEEL_NSLOTS * WHEEL_TICK;
+}
+
+/****************************************************************************
+ * Name: tcp_wheel_schedule
+ *
+ * Description:
+ *   Run the wheel at due.  Called with g_tcp_wheel_lock held.
+ *
+ ****************************************************************************/
+
+static void tcp_wheel_schedule(clock_t now, clock_t due)
+{
+  g_tcp_wheel_due = due;
+  work_queue(LPWORK, &g_tcp_wheel_work, tcp_wheel_expiry, NULL,
+             WHEEL_BEFORE(now, due) ? due - now : 0);
+}
+
+/****************************************************************************
+ * Name: tcp_wheel_expiry
+ *
+ * Description:
+ *   Expire the timers that are due, in the slots from the last run up to
+ *   now.  Each connection is polled through its device as with the
+ *   per-connection timers.  A connection leaves the wheel with the lock
+ *   held, so tcp_free() either takes it off first or finds it gone.
+ *
+ ****************************************************************************/
+
+static void tcp_wheel_expiry(FAR void *arg)
+{
+  FAR struct net_driver_s *dev;
+  FAR struct tcp_conn_s *conn;
+  FAR dq_entry_t *node;
+  FAR dq_entry_t *next;
+  irqstate_t flags;
+  clock_t now;
+  int i;
+
+  flags = spin_lock_irqsave(&g_tcp_wheel_lock);
+  now   = clock_systime_ticks();
+
+  for (i = 0; i < WHEEL_NSLOTS &&
+              !WHEEL_BEFORE(now, g_tcp_wheel_clock); i++)
+    {
+      node = dq_peek(WHEEL_SLOT(g_tcp_wheel_clock));
+      while (node != NULL)
+        {
+          next = dq_next(node);
+          conn = container_of(node, struct tcp_conn_s, tnode);
+          if (!WHEEL_BEFORE(now, conn->tdeadline))
+            {
+              dq_rem(node, WHEEL_SLOT(conn->tdeadline));
+              conn->tarmed = false;
+              g_tcp_wheel_narmed--;
+
+              conn->timeout = true;
+              tcp_txpending(conn);
+              dev = conn->dev;
+
+              spin_unlock_irqrestore(&g_tcp_wheel_lock, flags);
+              netdev_lock(dev);
+              netdev_txnotify_dev(dev, TCP_POLL);
+              netdev_unlock(dev);
+              flags = spin_lock_irqsave(&g_tcp_wheel_lock);
+
+              /* The slot may have changed while it was unlocked */
+
+              next = dq_peek(WHEEL_SLOT(g_tcp_wheel_clock));
+            }
+
+          node = next;
+        }
+
+      g_tcp_wheel_clock += WHEEL_TICK;
+    }
+
+  g_tcp_wheel_clock = now - now % WHEEL_TICK;
+  if (g_tcp_wheel_narmed > 0)
+    {
+      tcp_wheel_schedule(now, tcp_wheel_next(now));
+    }
+
+  spin_unlock_irqrestore(&g_tcp_wheel_lock, flags);
+}
+
+/****************************************************************************
+ * Name: tcp_wheel_arm
+ *
+ * Description:
+ *   Arm the timer of a connection to expire ticks from now, in place of
+ *   any earlier deadline.
+ *
+ ****************************************************************************/
+
+static void tcp_wheel_arm(FAR struct tcp_conn_s *conn, clock_t ticks)
+{
+  irqstate_t flags = spin_lock_irqsave(&g_tcp_wheel_lock);
+  clock_t now = clock_systime_ticks();
+
+  if (conn->tarmed)
+    {
+      dq_rem(&conn->tnode, WHEEL_SLOT(conn->tdeadline));
+    }
+  else
+    {
+      conn->tarmed = true;
+      if (g_tcp_wheel_narmed++ == 0)
+        {
+          g_tcp_wheel_clock = now - now % WHEEL_TICK;
+          g_tcp_wheel_due   = now + ticks + 1;
+        }
+    }
+
+  conn->tdeadline = now + ticks;
+  dq_addlast(&conn->tnode, WHEEL_SLOT(conn->tdeadline));
+
+  if (WHEEL_BEFORE(conn->tdeadline, g_tcp_wheel_due))
+    {
+      tcp_wheel_schedule(now, conn->tdeadline);
+    }
+
+  spin_unlock_irqrestore(&g_tcp_wheel_lock, flags);
+}
+
+/****************************************************************************
+ * Name: tcp_wheel_cancel
+ ****************************************************************************/
+
+static void tcp_wheel_cancel(FAR struct tcp_conn_s *conn)
+{
+  irqstate_t flags = spin_lock_irqsave(&g_tcp_wheel_lock);
+
+  if (conn->tarmed)
+    {
+      dq_rem(&conn->tnode, WHEEL_SLOT(conn->tdeadline));
+      conn->tarmed = false;
+      if (--g_tcp_wheel_narmed == 0)
+        {
+          work_cancel(LPWORK, &g_tcp_wheel_work);
+        }
+    }
+
+  spin_unlock_irqrestore(&g_tcp_wheel_lock, flags);
+}
+#else
+
 /****************************************************************************
  * Name: tcp_timer_expiry
  *
@@ -154,6 +379,7 @@ static void tcp_timer_expiry(FAR void *arg)
         {
           tcp_conn_list_unlock();
           conn->timeout = true;
+          tcp_txpending(conn);
           netdev_lock(conn->dev);
           netdev_txnotify_dev(conn->dev, TCP_POLL);
           netdev_unlock(conn->dev);
@@ -163,6 +389,7 @@ static void tcp_timer_expiry(FAR void *arg)
 
   tcp_conn_list_unlock();
 }
+#endif /* CONFIG_NET_TCP_TIMER_WHEEL */
 
 /****************************************************************************
  * Name: tcp_xmit_probe
@@ -255,16 +482,24 @@ void tcp_update_timer(FAR struct tcp_conn_s *conn)
         }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+      if (!conn->tarmed ||
+          TICK2HSEC(conn->tdeadline - clock_systime_ticks()) != timeout)
+        {
+          tcp_wheel_arm(conn, HSEC2TICK(timeout));
+        }
+#else
       if (work_available(&conn->work) ||
           TICK2HSEC(work_timeleft(&conn->work)) != timeout)
         {
           work_queue(LPWORK, &conn->work, tcp_timer_expiry,
                      conn, HSEC2TICK(timeout));
         }
+#endif
     }
   else
     {
-      work_cancel(LPWORK, &conn->work);
+      tcp_stop_timer(conn);
     }
 }
 
@@ -342,7 +577,11 @@ void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout)
 
 void tcp_stop_timer(FAR struct tcp_conn_s *conn)
 {
+#ifdef CONFIG_NET_TCP_TIMER_WHEEL
+  tcp_wheel_cancel(conn);
+#else
   work_cancel(LPWORK, &conn->work);
+#endif
 }
 
 /****************************************************************************
@@ -628,22 +867,7 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                     tcp_rexmit(dev, conn, result);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-                    /* If conn is TCP_INFR, it should enter to slow start */
-
-                    if (conn->flags & TCP_INFR)
-                      {
-                        conn->flags &= ~TCP_INFR;
-                      }
-
-                    /* update the max_cwnd */
-
-                    conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
-
-                    /* reset cwnd and ssthresh, refers to RFC5861. */
-
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
-                    conn->cwnd = conn->mss;
+                    tcp_cc_timeout(conn);
 #endif
                     goto done;
 
@@ -186,6 +186,15 @@ void tcp_wrbuffer_release(FAR struct tcp_wrbuffer_s *wrb)
       iob_free_chain(wrb->wb_iob);
     }
 
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+  /* The user buffer of a MSG_ZEROCOPY send is no longer referenced */
+
+  if (TCP_WBZEROCOPY(wrb))
+    {
+      tcp_zerocopy_release(wrb);
+    }
+#endif
+
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   /* Reset the ack counter */
 
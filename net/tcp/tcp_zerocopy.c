@@ -0,0 +1,285 @@
+/****************************************************************************
+ * net/tcp/tcp_zerocopy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <poll.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_TCP_ZEROCOPY
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zerocopy_iobfree
+ *
+ * Description:
+ *   Release callback of an I/O buffer referencing user data.  The data
+ *   belongs to the application, so there is nothing to free.
+ *
+ ****************************************************************************/
+
+static void tcp_zerocopy_iobfree(FAR void *data)
+{
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_complete
+ *
+ * Description:
+ *   Record the completion of the send number id and wake up poll() with
+ *   POLLERR.  The sends complete in order, so the pending range grows by
+ *   one.
+ *
+ ****************************************************************************/
+
+static void tcp_zerocopy_complete(FAR struct tcp_conn_s *conn, uint32_t id,
+                                  bool copied)
+{
+  int i;
+
+  if (!conn->zc_ready)
+    {
+      conn->zc_lo      = id;
+      conn->zc_ready   = true;
+      conn->zc_rcopied = false;
+    }
+
+  conn->zc_hi       = id;
+  conn->zc_rcopied |= copied;
+
+  for (i = 0; i < CONFIG_NET_TCP_NPOLLWAITERS; i++)
+    {
+      if (conn->pollinfo[i].fds != NULL)
+        {
+          poll_notify(&conn->pollinfo[i].fds, 1, POLLERR);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_zerocopy_fill
+ *
+ * Description:
+ *   Make the new, empty write buffer wrb reference len bytes of user data
+ *   at buf instead of copying them.
+ *
+ * Returned Value:
+ *   len on success or -ENOMEM; the caller copies the data then.
+ *
+ ****************************************************************************/
+
+int tcp_zerocopy_fill(FAR struct tcp_wrbuffer_s *wrb,
+                      FAR const uint8_t *buf, unsigned int len)
+{
+  FAR struct iob_s *iob;
+
+  DEBUGASSERT(TCP_WBPKTLEN(wrb) == 0 && len <= UINT16_MAX);
+
+  iob = iob_alloc_with_data((FAR void *)buf, len, tcp_zerocopy_iobfree);
+  if (iob == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  iob->io_len    = len;
+  iob->io_pktlen = len;
+
+  iob_free_chain(wrb->wb_iob);
+  wrb->wb_iob      = iob;
+  wrb->wb_zcflags |= TCP_WBZC_REF;
+  return len;
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_queued
+ *
+ * Description:
+ *   wrb, which holds data of the current MSG_ZEROCOPY send of conn either
+ *   in place or copied, is being queued.  It replaces the previous write
+ *   buffer of the send as the one whose release completes the send.
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_queued(FAR struct tcp_conn_s *conn,
+                         FAR struct tcp_wrbuffer_s *wrb)
+{
+  FAR struct tcp_wrbuffer_s *last = conn->zc_lastwrb;
+
+  if (!conn->zc_busy)
+    {
+      conn->zc_busy   = true;
+      conn->zc_copied = false;
+    }
+
+  if ((wrb->wb_zcflags & TCP_WBZC_REF) == 0)
+    {
+      conn->zc_copied = true;
+    }
+
+  if (last != NULL && last->wb_zcid == conn->zc_next)
+    {
+      last->wb_zcflags &= ~(TCP_WBZC_LAST | TCP_WBZC_COPIED);
+    }
+
+  wrb->wb_zcconn   = conn;
+  wrb->wb_zcid     = conn->zc_next;
+  wrb->wb_zcflags |= TCP_WBZC_LAST;
+  if (conn->zc_copied)
+    {
+      wrb->wb_zcflags |= TCP_WBZC_COPIED;
+    }
+
+  conn->zc_lastwrb = wrb;
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_end
+ *
+ * Description:
+ *   The current MSG_ZEROCOPY send of conn has queued all its data.  If its
+ *   write buffers have all been released already, it completes now.
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_end(FAR struct tcp_conn_s *conn)
+{
+  uint32_t id = conn->zc_next;
+
+  if (!conn->zc_busy)
+    {
+      return;
+    }
+
+  conn->zc_busy = false;
+  conn->zc_next++;
+
+  if (conn->zc_lastwrb == NULL || conn->zc_lastwrb->wb_zcid != id)
+    {
+      tcp_zerocopy_complete(conn, id, conn->zc_copied);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_release
+ *
+ * Description:
+ *   A write buffer of a MSG_ZEROCOPY send is being released.  If it is the
+ *   last one of a send that has queued all its data, the send completes.
+ *
+ ****************************************************************************/
+
+void tcp_zerocopy_release(FAR struct tcp_wrbuffer_s *wrb)
+{
+  FAR struct tcp_conn_s *conn = wrb->wb_zcconn;
+
+  if (conn->zc_lastwrb == wrb)
+    {
+      conn->zc_lastwrb = NULL;
+    }
+
+  if ((wrb->wb_zcflags & TCP_WBZC_LAST) != 0 &&
+      !(conn->zc_busy && wrb->wb_zcid == conn->zc_next))
+    {
+      tcp_zerocopy_complete(conn, wrb->wb_zcid,
+                            (wrb->wb_zcflags & TCP_WBZC_COPIED) != 0);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_zerocopy_recverr
+ *
+ * Description:
+ *   recvmsg(MSG_ERRQUEUE): report the completed MSG_ZEROCOPY sends as an
+ *   IP_RECVERR or IPV6_RECVERR control message.
+ *
+ * Returned Value:
+ *   Zero (no data) on success, -EAGAIN if no send has completed since the
+ *   last call.
+ *
+ ****************************************************************************/
+
+ssize_t tcp_zerocopy_recverr(FAR struct tcp_conn_s *conn,
+                             FAR struct msghdr *msg)
+{
+  struct sock_extended_err ee;
+  int level = IPPROTO_IP;
+  int type = IP_RECVERR;
+
+  if (!conn->zc_ready)
+    {
+      return -EAGAIN;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#endif
+    {
+      level = IPPROTO_IPV6;
+      type  = IPV6_RECVERR;
+    }
+#endif
+
+  memset(&ee, 0, sizeof(ee));
+  ee.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+  ee.ee_code   = conn->zc_rcopied ? SO_EE_CODE_ZEROCOPY_COPIED : 0;
+  ee.ee_info   = conn->zc_lo;
+  ee.ee_data   = conn->zc_hi;
+
+  if (cmsg_append(msg, level, type, &ee, sizeof(ee)) == NULL)
+    {
+      /* Keep the completions for a call with room for them */
+
+      msg->msg_flags |= MSG_CTRUNC;
+      return 0;
+    }
+
+  conn->zc_ready  = false;
+  msg->msg_flags |= MSG_ERRQUEUE;
+  return 0;
+}
+
+#endif /* CONFIG_NET_TCP_ZEROCOPY */
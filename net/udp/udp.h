@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 
+#include <nuttx/hashtable.h>
 #include <nuttx/queue.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/ip.h>
@@ -78,6 +79,18 @@
 #define UDPIPv4BUF ((FAR struct udp_hdr_s *)IPBUF(IPv4_HDRLEN))
 #define UDPIPv6BUF ((FAR struct udp_hdr_s *)IPBUF(IPv6_HDRLEN))
 
+/* A UDP_SEGMENT send is cut into at most this many datagrams, as in Linux.
+ * A device with NETDEV_FEATURE_USO gets them as one packet, which needs the
+ * checksum to be offloaded too.
+ */
+
+#ifdef CONFIG_NET_UDP_SEGMENT
+#  define UDP_MAX_SEGMENTS 64
+#  if defined(CONFIG_NETDEV_OFFLOAD) && defined(CONFIG_NET_UDP_CHECKSUMS)
+#    define NEED_UDP_USO
+#  endif
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -110,6 +123,10 @@ struct udp_conn_s
 
   /* UDP-specific content follows */
 
+#ifdef CONFIG_NET_UDP_HASH
+  hash_node_t hnode;      /* Node in the hashtable of bound connections */
+  uint32_t seq;           /* Allocation order, keeps the lookup precedence */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
@@ -149,6 +166,14 @@ struct udp_conn_s
   FAR struct devif_callback_s *sndcb;
 #endif
 
+#ifdef CONFIG_NET_UDP_SEGMENT
+  uint16_t gsosize;       /* UDP_SEGMENT size, 0 if sends are not cut */
+  bool     gro;           /* UDP_GRO: coalesce buffered datagrams */
+#endif
+#ifdef NEED_UDP_USO
+  uint16_t txgsosize;     /* Segment size of the packet being sent */
+#endif
+
 #if defined(CONFIG_NET_IGMP) || defined(CONFIG_NET_MLD)
   struct ip_mreqn mreq;
 #endif
@@ -161,6 +186,9 @@ struct udp_conn_s
 
 #ifdef CONFIG_NET_TIMESTAMP
   int timestamp; /* Nonzero when SO_TIMESTAMP is enabled */
+#endif
+#ifdef CONFIG_NET_TIMESTAMPING
+  int timestamping; /* SOF_TIMESTAMPING_* flags of SO_TIMESTAMPING */
 #endif
   FAR sem_t *txdrain_sem;
 };
@@ -175,6 +203,9 @@ struct udp_wrbuffer_s
   sq_entry_t wb_node;              /* Supports a singly linked list */
   struct sockaddr_storage wb_dest; /* Destination address */
   FAR struct iob_s *wb_iob;        /* Head of the I/O buffer chain */
+#ifdef NEED_UDP_USO
+  uint16_t wb_gsosize;             /* Segment size for the device, or 0 */
+#endif
 };
 #endif
 
@@ -253,6 +284,27 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 
 FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   Choose the receiver of a packet among the unconnected sockets that
+ *   share its port with SO_REUSEPORT, conn is the first one of them that
+ *   udp_active() found.
+ *
+ * Assumptions:
+ *   The UDP connection list is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct udp_conn_s *udp_reuseport_select(FAR struct net_driver_s *dev,
+                                            FAR struct udp_conn_s *conn,
+                                            FAR struct udp_hdr_s *udp);
+#else
+#  define udp_reuseport_select(dev, conn, udp) (conn)
+#endif
+
 /****************************************************************************
  * Name: udp_conn_list_lock
  *
@@ -298,6 +350,26 @@ void udp_conn_list_unlock(void);
 
 uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u);
 
+/****************************************************************************
+ * Name: udp_conn_setport
+ *
+ * Description:
+ *   Set the local port of a UDP connection.  All changes to the local port
+ *   must go through this function so that the connection is kept in the
+ *   right bucket of the connection hashtable.
+ *
+ * Input Parameters:
+ *   conn  - A reference to UDP connection structure
+ *   lport - The local port in network byte order, 0 to unbind
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_HASH
+void udp_conn_setport(FAR struct udp_conn_s *conn, uint16_t lport);
+#else
+#  define udp_conn_setport(conn, port) ((conn)->lport = (port))
+#endif
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -496,6 +568,31 @@ int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len);
 #endif
 
+/****************************************************************************
+ * Name: udp_getsockopt
+ *
+ * Description:
+ *   udp_getsockopt() retrieves the value for the UDP-protocol option
+ *   specified by the 'option' argument for the socket specified by the
+ *   'psock' argument.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+int udp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+#endif
+
 /****************************************************************************
  * Name: udp_wrbuffer_alloc
  *
@@ -74,6 +74,13 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
   };
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  struct timespec hwtstamp =
+  {
+    0
+  };
+#endif
+
   uint8_t src_addr_size;
   FAR void *src_addr;
   int offset;
@@ -155,7 +162,8 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IPv4 */
 
   /* Copy the meta info into the I/O buffer chain, just before data.
-   * Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data|
+   * Layout:
+   *   |datalen|ifindex|src_addr_size|src_addr|[hwtstamp]|[timestamp]|data|
    */
 
   offset = (dev->d_appdata - iob->io_data) - iob->io_offset;
@@ -175,6 +183,26 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev,
     }
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+  /* The hardware timestamp, zero if the driver attached none.  It is
+   * stored with the data as the metadata of the I/O buffer does not
+   * survive the concatenation into the read-ahead queue.
+   */
+
+  if (NETDEV_RXTSTAMP(dev) != NULL)
+    {
+      hwtstamp = *NETDEV_RXTSTAMP(dev);
+    }
+
+  offset -= sizeof(struct timespec);
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)&hwtstamp,
+                      sizeof(struct timespec), offset, true);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+#endif
+
   offset -= src_addr_size;
   ret = iob_trycopyin(iob, src_addr, src_addr_size, offset, true);
   if (ret < 0)
@@ -59,6 +59,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/sched.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -82,6 +83,22 @@
 #  define CONFIG_NET_UDP_MAX_CONNS 0
 #endif
 
+/* The list of connections that may be bound to a local port.  With the
+ * hashtable only the bucket of the port has to be searched.
+ */
+
+#ifdef CONFIG_NET_UDP_HASH
+#  define UDP_CONN_BUCKET(portno) \
+     (&g_udp_conn_hash[HASH(portno, CONFIG_NET_UDP_HASH_BITS)])
+#  define UDP_CONN_NODE(conn)     (&(conn)->hnode)
+#  define UDP_CONN_ENTRY(node)    container_of(node, struct udp_conn_s, hnode)
+#else
+#  define UDP_CONN_BUCKET(portno) (&g_active_udp_connections)
+#  define UDP_CONN_NODE(conn)     (&(conn)->sconn.node)
+#  define UDP_CONN_ENTRY(node) \
+     container_of(node, struct udp_conn_s, sconn.node)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -96,10 +113,53 @@ NET_BUFPOOL_DECLARE(g_udp_connections, sizeof(struct udp_conn_s),
 
 static dq_queue_t g_active_udp_connections;
 
+#ifdef CONFIG_NET_UDP_HASH
+/* The bound UDP connections hashed by their local port */
+
+static DECLARE_HASHTABLE(g_udp_conn_hash, CONFIG_NET_UDP_HASH_BITS);
+
+/* The allocation sequence number of the next UDP connection */
+
+static uint32_t g_udp_conn_seq;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: udp_nextport
+ *
+ * Description:
+ *   Traverse the UDP connections that may be bound to the local port
+ *   'portno'.  Without the hashtable these are all allocated connections.
+ *
+ * Input Parameters:
+ *   conn   - The previous connection, NULL to start the traversal
+ *   portno - The local port in network byte order
+ *
+ * Assumptions:
+ *   This function must be called with the network locked.
+ *
+ ****************************************************************************/
+
+static FAR struct udp_conn_s *udp_nextport(FAR struct udp_conn_s *conn,
+                                           uint16_t portno)
+{
+  FAR dq_entry_t *node;
+
+  if (conn == NULL)
+    {
+      node = dq_peek(UDP_CONN_BUCKET(portno));
+    }
+  else
+    {
+      node = dq_next(UDP_CONN_NODE(conn));
+    }
+
+  return node != NULL ? UDP_CONN_ENTRY(node) : NULL;
+}
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -112,6 +172,7 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never conflict.
+ *              SO_REUSEPORT: The same.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -125,12 +186,13 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
   FAR struct udp_conn_s *conn = NULL;
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
+  bool skip_reuseport = _SO_GETOPT(opt, SO_REUSEPORT);
 #endif
 
   /* Now search each connection structure. */
 
   udp_conn_list_lock();
-  while ((conn = udp_nextconn(conn)) != NULL)
+  while ((conn = udp_nextport(conn, portno)) != NULL)
     {
       /* With SO_REUSEADDR set for both sockets, we do not need to check its
        * address and port.
@@ -141,6 +203,12 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
         {
           continue;
         }
+
+      if (skip_reuseport &&
+          _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
 #endif
 
       /* If the port local port number assigned to the connections matches
@@ -204,7 +272,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextport(conn, udp->destport);
 
   while (conn)
     {
@@ -318,7 +386,7 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = udp_nextconn(conn);
+      conn = udp_nextport(conn, udp->destport);
     }
 
   return conn;
@@ -344,7 +412,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
 
-  conn = udp_nextconn(conn);
+  conn = udp_nextport(conn, udp->destport);
 
   while (conn != NULL)
     {
@@ -458,7 +526,7 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
-      conn = udp_nextconn(conn);
+      conn = udp_nextport(conn, udp->destport);
     }
 
   return conn;
@@ -580,6 +648,9 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
       /* Enqueue the connection into the active list */
 
       dq_addlast(&conn->sconn.node, &g_active_udp_connections);
+#ifdef CONFIG_NET_UDP_HASH
+      conn->seq = g_udp_conn_seq++;
+#endif
     }
 
   NET_BUFPOOL_UNLOCK(g_udp_connections);
@@ -606,7 +677,7 @@ void udp_free(FAR struct udp_conn_s *conn)
   DEBUGASSERT(conn->crefs == 0);
 
   NET_BUFPOOL_LOCK(g_udp_connections);
-  conn->lport = 0;
+  udp_conn_setport(conn, 0);
 
   /* Remove the connection from the active list */
 
@@ -680,6 +751,80 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   conn is the first connection that udp_active() found for the received
+ *   packet.  If it is an unconnected socket with SO_REUSEPORT, choose the
+ *   receiver among all such sockets that match the packet by the hash of
+ *   its source, so that a flow always goes to the same socket.  With
+ *   CONFIG_NETDEV_RSS, the sockets last read on this CPU come first.
+ *
+ * Assumptions:
+ *   The UDP connection list is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+FAR struct udp_conn_s *udp_reuseport_select(FAR struct net_driver_s *dev,
+                                            FAR struct udp_conn_s *conn,
+                                            FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *cand;
+  uint32_t hash;
+  int nlocal = 0;
+  int pick;
+  int n = 0;
+#ifdef CONFIG_NETDEV_RSS
+  int cpu = this_cpu();
+#endif
+
+  if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) ||
+      _UDP_ISCONNECTMODE(conn->flags))
+    {
+      return conn;
+    }
+
+  for (cand = conn; cand != NULL; cand = udp_active(dev, cand, udp))
+    {
+      if (_SO_GETOPT(cand->sconn.s_options, SO_REUSEPORT) &&
+          !_UDP_ISCONNECTMODE(cand->flags))
+        {
+          n++;
+#ifdef CONFIG_NETDEV_RSS
+          nlocal += cand->rcvcpu == cpu;
+#endif
+        }
+    }
+
+  if (n < 2)
+    {
+      return conn;
+    }
+
+  /* Pick the hash modulo the sockets of this CPU if there are any */
+
+  hash = net_flowhash(dev, udp->srcport);
+  pick = nlocal > 0 ? hash % nlocal : hash % n;
+
+  for (cand = conn; cand != NULL; cand = udp_active(dev, cand, udp))
+    {
+      if (_SO_GETOPT(cand->sconn.s_options, SO_REUSEPORT) &&
+          !_UDP_ISCONNECTMODE(cand->flags) &&
+#ifdef CONFIG_NETDEV_RSS
+          (nlocal == 0 || cand->rcvcpu == cpu) &&
+#endif
+          pick-- == 0)
+        {
+          break;
+        }
+    }
+
+  return cand != NULL ? cand : conn;
+}
+#endif
+
 /****************************************************************************
  * Name: udp_conn_list_lock
  *
@@ -735,6 +880,63 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn)
     }
 }
 
+/****************************************************************************
+ * Name: udp_conn_setport
+ *
+ * Description:
+ *   Set the local port of a UDP connection and move the connection to the
+ *   bucket of the new port.
+ *
+ * Input Parameters:
+ *   conn  - A reference to UDP connection structure
+ *   lport - The local port in network byte order, 0 to unbind
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_HASH
+void udp_conn_setport(FAR struct udp_conn_s *conn, uint16_t lport)
+{
+  FAR dq_queue_t *bucket;
+  FAR dq_entry_t *node;
+
+  udp_conn_list_lock();
+
+  if (conn->lport != 0)
+    {
+      dq_rem(&conn->hnode, UDP_CONN_BUCKET(conn->lport));
+    }
+
+  conn->lport = lport;
+  if (lport != 0)
+    {
+      /* Keep the bucket in allocation order, the order of the list of all
+       * connections, so that the first match of a lookup is the same as
+       * without the hashtable.
+       */
+
+      bucket = UDP_CONN_BUCKET(lport);
+      for (node = dq_peek(bucket); node != NULL; node = dq_next(node))
+        {
+          if ((int32_t)(UDP_CONN_ENTRY(node)->seq - conn->seq) > 0)
+            {
+              break;
+            }
+        }
+
+      if (node != NULL)
+        {
+          dq_addbefore(node, &conn->hnode, bucket);
+        }
+      else
+        {
+          dq_addlast(&conn->hnode, bucket);
+        }
+    }
+
+  udp_conn_list_unlock();
+}
+#endif
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -876,7 +1078,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
       else
         {
-          conn->lport = portno;
+          udp_conn_setport(conn, portno);
           ret         = OK;
         }
     }
@@ -901,7 +1103,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
+          udp_conn_setport(conn, portno);
           ret         = OK;
         }
       else
@@ -953,7 +1155,8 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_conn_setport(conn, HTONS(udp_select_port(conn->domain,
+                                                   &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
@@ -0,0 +1,105 @@
+/****************************************************************************
+ * net/udp/udp_getsockopt.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <netinet/udp.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/udp.h>
+
+#include "udp/udp.h"
+
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: udp_getsockopt
+ *
+ * Description:
+ *   udp_getsockopt() retrieves the value for the UDP-protocol option
+ *   specified by the 'option' argument for the socket specified by the
+ *   'psock' argument.
+ *
+ *   See <netinet/udp.h> for the a complete list of values of UDP protocol
+ *   options.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_getsockopt() for
+ *   the complete list of appropriate return error codes.
+ *
+ ****************************************************************************/
+
+int udp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+#ifdef CONFIG_NET_UDP_SEGMENT
+  FAR struct udp_conn_s *conn = psock->s_conn;
+
+  DEBUGASSERT(value != NULL && value_len != NULL);
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case UDP_SEGMENT:
+      case UDP_GRO:
+        if (*value_len < sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        *(FAR int *)value = option == UDP_GRO ? conn->gro : conn->gsosize;
+        *value_len        = sizeof(int);
+        return OK;
+
+      default:
+        break;
+    }
+#endif
+
+  return -ENOPROTOOPT;
+}
+
+#endif /* CONFIG_NET_UDPPROTO_OPTIONS */
@@ -256,7 +256,7 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   dev->d_appdata = IPBUF(udpiplen);
 
 #ifdef CONFIG_NET_UDP_CHECKSUMS
-  chksum = udp->udpchksum;
+  chksum = NETDEV_RXCSUM_OK(dev) ? 0 : udp->udpchksum;
   if (chksum != 0)
     {
 #ifdef CONFIG_NET_IPv6
@@ -338,6 +338,17 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
             }
 #endif
 
+          /* A unicast packet goes to one of the sockets that share the
+           * port with SO_REUSEPORT.
+           */
+
+#ifdef CONFIG_NET_BROADCAST
+          if (!udp_is_broadcast(dev))
+#endif
+            {
+              conn = udp_reuseport_select(dev, conn, udp);
+            }
+
           /* We can deliver the packet directly to the last listener. */
 
           ret = udp_input_conn(dev, conn, udpiplen);
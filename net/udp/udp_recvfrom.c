@@ -41,6 +41,8 @@
 #include <nuttx/net/udp.h>
 #include <nuttx/tls.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
+#include <net/net_tstamp.h>
 
 #include "netdev/netdev.h"
 #include "devif/devif.h"
@@ -80,6 +82,33 @@ static void udp_store_cmsg_timestamp(FAR struct udp_recvfrom_s *pstate,
 }
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+static void udp_store_cmsg_timestamping(FAR struct udp_recvfrom_s *pstate,
+                                        FAR const struct timespec *timestamp,
+                                        FAR const struct timespec *hwtstamp)
+{
+  int flags = pstate->ir_conn->timestamping;
+  struct scm_timestamping tss;
+
+  memset(&tss, 0, sizeof(tss));
+
+  if ((flags & SOF_TIMESTAMPING_SOFTWARE) != 0 &&
+      (flags & SOF_TIMESTAMPING_RX_SOFTWARE) != 0)
+    {
+      tss.ts[0] = *timestamp;
+    }
+
+  if ((flags & SOF_TIMESTAMPING_RAW_HARDWARE) != 0 &&
+      (flags & SOF_TIMESTAMPING_RX_HARDWARE) != 0)
+    {
+      tss.ts[2] = *hwtstamp;
+    }
+
+  cmsg_append(pstate->ir_msg, SOL_SOCKET, SCM_TIMESTAMPING,
+              &tss, sizeof(tss));
+}
+#endif
+
 #ifdef CONFIG_NET_SOCKOPTS
 static void udp_recvpktinfo(FAR struct udp_recvfrom_s *pstate,
                             FAR void *srcaddr, uint8_t ifindex)
@@ -170,6 +199,135 @@ static inline size_t udp_recvfrom_newdata(FAR struct net_driver_s *dev,
   return recvlen;
 }
 
+/****************************************************************************
+ * Name: udp_readahead_header
+ *
+ * Description:
+ *   Unflatten the connection information saved in front of the datagram at
+ *   the head of the read-ahead buffer.
+ *
+ * Returned Value:
+ *   The offset of the timestamp, or of the data if there is none.
+ *
+ ****************************************************************************/
+
+static int udp_readahead_header(FAR struct iob_s *iob,
+                                FAR uint16_t *datalen,
+                                FAR uint8_t *ifindex,
+                                FAR uint8_t *srcaddr,
+                                FAR uint8_t *src_addr_size)
+{
+  int recvlen;
+  int offset = 0;
+
+  /* Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data| */
+
+  recvlen = iob_copyout((FAR uint8_t *)datalen, iob,
+                        sizeof(*datalen), offset);
+  offset += sizeof(*datalen);
+  DEBUGASSERT(recvlen == sizeof(*datalen));
+
+#ifdef CONFIG_NETDEV_IFINDEX
+  recvlen = iob_copyout(ifindex, iob, sizeof(*ifindex), offset);
+  offset += sizeof(*ifindex);
+  DEBUGASSERT(recvlen == sizeof(*ifindex));
+#else
+  *ifindex = 1;
+#endif
+  recvlen = iob_copyout(src_addr_size, iob,
+                        sizeof(*src_addr_size), offset);
+  offset += sizeof(*src_addr_size);
+  DEBUGASSERT(recvlen == sizeof(*src_addr_size));
+
+  recvlen = iob_copyout(srcaddr, iob, *src_addr_size, offset);
+  offset += *src_addr_size;
+  DEBUGASSERT(recvlen == *src_addr_size);
+
+  UNUSED(recvlen);
+  return offset;
+}
+
+/****************************************************************************
+ * Name: udp_readahead_gro
+ *
+ * Description:
+ *   With UDP_GRO, append the datagrams that follow in the read-ahead buffer
+ *   to the one just received, as long as they come from the same sender
+ *   with segsize bytes and fit in the user buffer.  A shorter datagram ends
+ *   the train, as it would in a UDP_SEGMENT send.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_SEGMENT
+static void udp_readahead_gro(FAR struct udp_recvfrom_s *pstate,
+                              FAR const uint8_t *srcaddr,
+                              uint8_t src_addr_size, uint8_t ifindex,
+                              uint16_t segsize)
+{
+  FAR struct udp_conn_s *conn = pstate->ir_conn;
+  FAR struct iovec *iov = pstate->ir_msg->msg_iov;
+  FAR struct iob_s *iob;
+#ifdef CONFIG_NET_IPv6
+  uint8_t nextaddr[sizeof(struct sockaddr_in6)];
+#else
+  uint8_t nextaddr[sizeof(struct sockaddr_in)];
+#endif
+  uint16_t datalen;
+  uint8_t nextsize;
+  uint8_t nextif;
+  int nsegs = 1;
+  int offset;
+  int gsosize;
+
+  while ((iob = conn->readahead) != NULL)
+    {
+      offset = udp_readahead_header(iob, &datalen, &nextif, nextaddr,
+                                    &nextsize);
+#ifdef CONFIG_NET_TIMESTAMPING
+      offset += sizeof(struct timespec);
+#endif
+#ifdef CONFIG_NET_TIMESTAMP
+      offset += sizeof(struct timespec);
+#endif
+
+      if (datalen == 0 || datalen > segsize || nextif != ifindex ||
+          pstate->ir_recvlen + datalen > iov->iov_len ||
+          nextsize != src_addr_size ||
+          memcmp(nextaddr, srcaddr, nextsize) != 0)
+        {
+          break;
+        }
+
+      pstate->ir_recvlen += iob_copyout((FAR uint8_t *)iov->iov_base +
+                                        pstate->ir_recvlen,
+                                        iob, datalen, offset);
+      nsegs++;
+
+      if (offset + datalen >= iob->io_pktlen)
+        {
+          iob_free_chain(iob);
+          conn->readahead = NULL;
+        }
+      else
+        {
+          conn->readahead = iob_trimhead(iob, offset + datalen);
+        }
+
+      if (datalen < segsize)
+        {
+          break;
+        }
+    }
+
+  if (nsegs > 1)
+    {
+      gsosize = segsize;
+      cmsg_append(pstate->ir_msg, SOL_UDP, UDP_GRO,
+                  &gsosize, sizeof(gsosize));
+    }
+}
+#endif
+
 static inline void udp_readahead(struct udp_recvfrom_s *pstate)
 {
   FAR struct udp_conn_s *conn = pstate->ir_conn;
@@ -194,30 +352,26 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
       uint8_t srcaddr[sizeof(struct sockaddr_in)];
 #endif
 
-      /* Unflatten saved connection information
-       * Layout: |datalen|ifindex|src_addr_size|src_addr|[timestamp]|data|
-       */
+      /* Unflatten saved connection information */
 
-      recvlen = iob_copyout((FAR uint8_t *)&datalen, iob,
-                            sizeof(datalen), offset);
-      offset += sizeof(datalen);
-      DEBUGASSERT(recvlen == sizeof(datalen));
+      offset = udp_readahead_header(iob, &datalen, &ifindex, srcaddr,
+                                    &src_addr_size);
 
-#ifdef CONFIG_NETDEV_IFINDEX
-      recvlen = iob_copyout(&ifindex, iob, sizeof(ifindex), offset);
-      offset += sizeof(ifindex);
-      DEBUGASSERT(recvlen == sizeof(ifindex));
-#else
-      ifindex = 1;
-#endif
-      recvlen = iob_copyout(&src_addr_size, iob,
-                            sizeof(src_addr_size), offset);
-      offset += sizeof(src_addr_size);
-      DEBUGASSERT(recvlen == sizeof(src_addr_size));
+#ifdef CONFIG_NET_TIMESTAMPING
+      /* Unpack the hardware and software timestamps for SO_TIMESTAMPING */
 
-      recvlen = iob_copyout(srcaddr, iob, src_addr_size, offset);
-      offset += src_addr_size;
-      DEBUGASSERT(recvlen == src_addr_size);
+      if (conn->timestamping != 0)
+        {
+          struct timespec ts[2];
+
+          recvlen = iob_copyout((FAR uint8_t *)ts, iob, sizeof(ts), offset);
+          DEBUGASSERT(recvlen == sizeof(ts));
+
+          udp_store_cmsg_timestamping(pstate, &ts[1], &ts[0]);
+        }
+
+      offset += sizeof(struct timespec);
+#endif
 
 #ifdef CONFIG_NET_TIMESTAMP
       /* Unpack stored timestamp if SO_TIMESTAMP socket option is enabled */
@@ -273,6 +427,14 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
             {
               conn->readahead = iob_trimhead(iob, offset + datalen);
             }
+
+#ifdef CONFIG_NET_UDP_SEGMENT
+          if (conn->gro && datalen > 0 && recvlen == datalen)
+            {
+              udp_readahead_gro(pstate, srcaddr, src_addr_size, ifindex,
+                                datalen);
+            }
+#endif
         }
     }
 }
@@ -476,6 +638,24 @@ static uint32_t udp_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NET_TIMESTAMPING
+          if (pstate->ir_conn->timestamping != 0)
+            {
+              struct timespec hwtstamp =
+              {
+                0
+              };
+
+              if (NETDEV_RXTSTAMP(dev) != NULL)
+                {
+                  hwtstamp = *NETDEV_RXTSTAMP(dev);
+                }
+
+              udp_store_cmsg_timestamping(pstate, &dev->d_rxtime,
+                                          &hwtstamp);
+            }
+#endif
+
           /* Save the sender's address in the caller's 'from' location */
 
           udp_sender(dev, pstate);
@@ -652,6 +832,70 @@ static void udp_notify_recvcpu(FAR struct udp_conn_s *conn)
 #  define udp_notify_recvcpu(c)
 #endif /* CONFIG_NETDEV_RSS */
 
+/****************************************************************************
+ * Name: udp_busypoll_ready
+ *
+ * Description:
+ *   Check for a datagram in the read-ahead buffer while busy polling.  It
+ *   is only a hint, the caller checks again with the connection locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+static bool udp_busypoll_ready(FAR void *arg)
+{
+  FAR struct udp_conn_s *conn = arg;
+
+  return conn->readahead != NULL;
+}
+
+/****************************************************************************
+ * Name: udp_busypoll
+ *
+ * Description:
+ *   Run the receive path of the device of the socket in this thread for the
+ *   SO_BUSY_POLL time, instead of sleeping until the driver's worker
+ *   delivers a datagram.
+ *
+ * Input Parameters:
+ *   conn - A reference to UDP connection structure.
+ *   dev  - The device of the local address, may be NULL.
+ *
+ * Returned Value:
+ *   true if a datagram has arrived.
+ *
+ * Assumptions:
+ *   Called with the connection and dev locked, they are unlocked while
+ *   polling.
+ *
+ ****************************************************************************/
+
+static bool udp_busypoll(FAR struct udp_conn_s *conn,
+                         FAR struct net_driver_s *dev)
+{
+  FAR struct net_driver_s *polldev = dev;
+  bool ready;
+
+  if (conn->sconn.s_busypoll == 0)
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_BINDTODEVICE
+  if (polldev == NULL && conn->sconn.s_boundto != 0)
+    {
+      polldev = netdev_findbyindex(conn->sconn.s_boundto);
+    }
+#endif
+
+  conn_dev_unlock(&conn->sconn, dev);
+  ready = netdev_busypoll(polldev, conn->sconn.s_busypoll,
+                          udp_busypoll_ready, conn);
+  conn_dev_lock(&conn->sconn, dev);
+  return ready;
+}
+#endif /* CONFIG_NET_BUSY_POLL */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -709,6 +953,19 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
 
   udp_readahead(&state);
 
+#ifdef CONFIG_NET_BUSY_POLL
+  /* Nothing has arrived yet.  A blocking receive may poll the device for
+   * the datagram itself before it sleeps.
+   */
+
+  if (state.ir_recvlen < 0 &&
+      !_SS_ISNONBLOCK(conn->sconn.s_flags) && (flags & MSG_DONTWAIT) == 0 &&
+      udp_busypoll(conn, dev))
+    {
+      udp_readahead(&state);
+    }
+#endif
+
   /* The default return value is the number of bytes that we just copied
    * into the user buffer.  We will return this if the socket has become
    * disconnected or if the user request was completely satisfied with
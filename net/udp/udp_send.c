@@ -60,6 +60,7 @@
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "netdev/netdev.h"
 #include "socket/socket.h"
 #include "utils/utils.h"
 #include "udp/udp.h"
@@ -255,7 +256,10 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       if (IFF_IS_IPv4(dev->d_flags))
 #endif
         {
-          udp->udpchksum = ~udp_ipv4_chksum(dev);
+          if (!netdev_txcsum_offload(dev, IP_PROTO_UDP, IPv4_HDRLEN))
+            {
+              udp->udpchksum = ~udp_ipv4_chksum(dev);
+            }
         }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -264,7 +268,10 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
       else
 #endif
         {
-          udp->udpchksum = ~udp_ipv6_chksum(dev);
+          if (!netdev_txcsum_offload(dev, IP_PROTO_UDP, IPv6_HDRLEN))
+            {
+              udp->udpchksum = ~udp_ipv6_chksum(dev);
+            }
         }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -274,6 +281,23 @@ void udp_send(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn)
         }
 #endif /* CONFIG_NET_UDP_CHECKSUMS */
 
+#ifdef NEED_UDP_USO
+      /* A UDP_SEGMENT datagram that was queued whole for a device that
+       * cuts it itself.
+       */
+
+      if (conn->txgsosize > 0 &&
+          (NETDEV_PKTFLAGS(dev) & NETPKT_TX_CSUM) != 0 &&
+          dev->d_sndlen > conn->txgsosize)
+        {
+          DEBUGASSERT(NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_USO));
+          NETDEV_PKTFLAGS(dev)        |= NETPKT_TX_USO;
+          dev->d_iob->io_meta.gsosize  = conn->txgsosize;
+        }
+
+      conn->txgsosize = 0;
+#endif
+
       ninfo("Outgoing UDP packet length: %d\n", dev->d_len);
 
 #ifdef CONFIG_NET_STATISTICS
@@ -269,7 +269,8 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
        * connection structure.
        */
 
-      conn->lport = HTONS(udp_select_port(conn->domain, &conn->u));
+      udp_conn_setport(conn, HTONS(udp_select_port(conn->domain,
+                                                   &conn->u)));
       if (!conn->lport)
         {
           nerr("ERROR: Failed to get a local port!\n");
@@ -304,7 +305,13 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
 #ifndef CONFIG_NET_IPFRAG
   /* Sanity check if the packet len (with IP hdr) is greater than the MTU */
 
-  if (wrb->wb_iob->io_pktlen > devif_get_mtu(dev))
+  if (wrb->wb_iob->io_pktlen > devif_get_mtu(dev)
+#ifdef NEED_UDP_USO
+      && (wrb->wb_gsosize == 0 ||
+          !NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_USO |
+                                   NETDEV_FEATURE_TXCSUM))
+#endif
+     )
     {
       nerr("ERROR: Packet too long to send!\n");
       return -EMSGSIZE;
@@ -473,6 +480,12 @@ static uint32_t sendto_eventhandler(FAR struct net_driver_s *dev,
       dev->d_sndlen = wrb->wb_iob->io_pktlen - udpiplen;
       ninfo("wrb=%p sndlen=%d\n", wrb, dev->d_sndlen);
 
+#ifdef NEED_UDP_USO
+      /* udp_send() leaves the segmentation to the device */
+
+      conn->txgsosize = wrb->wb_gsosize;
+#endif
+
       /* Do not need to release wb_iob, the life cycle of wb_iob is
        * handed over to the network device
        */
@@ -535,6 +548,162 @@ static unsigned int udp_send_gettimeout(clock_t start, unsigned int timeout)
   return timeout;
 }
 
+/****************************************************************************
+ * Name: sendto_wrbuffer_fill
+ *
+ * Description:
+ *   Allocate a write buffer for one datagram of len bytes from buf to the
+ *   connected peer or to 'to', and copy the data into it.  gsosize is the
+ *   segment size of a datagram that the device will cut, or 0.
+ *
+ * Returned Value:
+ *   OK with the write buffer in *pwrb, or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int sendto_wrbuffer_fill(FAR struct udp_conn_s *conn,
+                                FAR const void *buf, size_t len,
+                                uint16_t gsosize, bool nonblock,
+                                clock_t start, unsigned int timeout,
+                                FAR const struct sockaddr *to,
+                                socklen_t tolen,
+                                FAR struct udp_wrbuffer_s **pwrb)
+{
+  FAR struct udp_wrbuffer_s *wrb;
+  uint16_t udpiplen;
+  int ret;
+
+  /* Allocate a write buffer.  Careful, the network will be momentarily
+   * unlocked here.
+   */
+
+#ifdef CONFIG_NET_JUMBO_FRAME
+
+  /* alloc iob of gso pkt for udp data */
+
+  wrb = udp_wrbuffer_tryalloc(len + udpip_hdrsize(conn) +
+                              CONFIG_NET_LL_GUARDSIZE);
+#else
+  if (nonblock)
+    {
+      wrb = udp_wrbuffer_tryalloc();
+    }
+  else
+    {
+      wrb = udp_wrbuffer_timedalloc(udp_send_gettimeout(start, timeout));
+    }
+#endif
+
+  if (wrb == NULL)
+    {
+      /* A buffer allocation error occurred */
+
+      nerr("ERROR: Failed to allocate write buffer\n");
+
+      if (nonblock || timeout != UINT_MAX)
+        {
+          ret = -EAGAIN;
+        }
+      else
+        {
+          ret = -ENOMEM;
+        }
+
+      return ret;
+    }
+
+#ifdef NEED_UDP_USO
+  wrb->wb_gsosize = gsosize;
+#else
+  UNUSED(gsosize);
+#endif
+
+  /* Initialize the write buffer
+   *
+   * Check if the socket is connected
+   */
+
+  if (_SS_ISCONNECTED(conn->sconn.s_flags))
+    {
+      /* Yes.. get the connection address from the connection structure */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (conn->domain == PF_INET)
+#endif
+        {
+          FAR struct sockaddr_in *addr4 =
+            (FAR struct sockaddr_in *)&wrb->wb_dest;
+
+          addr4->sin_family = AF_INET;
+          addr4->sin_port   = conn->rport;
+          net_ipv4addr_copy(addr4->sin_addr.s_addr, conn->u.ipv4.raddr);
+          memset(addr4->sin_zero, 0, sizeof(addr4->sin_zero));
+        }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif
+        {
+          FAR struct sockaddr_in6 *addr6 =
+            (FAR struct sockaddr_in6 *)&wrb->wb_dest;
+
+          addr6->sin6_family = AF_INET6;
+          addr6->sin6_port   = conn->rport;
+          net_ipv6addr_copy(addr6->sin6_addr.s6_addr, conn->u.ipv6.raddr);
+        }
+#endif /* CONFIG_NET_IPv6 */
+    }
+
+  /* Not connected.  Use the provided destination address */
+
+  else
+    {
+      memcpy(&wrb->wb_dest, to, tolen);
+      udp_connect(conn, to);
+    }
+
+  /* Skip l2/l3/l4 offset before copy */
+
+  udpiplen = udpip_hdrsize(conn);
+
+  iob_reserve(wrb->wb_iob, CONFIG_NET_LL_GUARDSIZE);
+  iob_update_pktlen(wrb->wb_iob, udpiplen, false);
+
+  /* Copy the user data into the write buffer.  We cannot wait for
+   * buffer space if the socket was opened non-blocking.
+   */
+
+  if (len > 0)
+    {
+      if (nonblock)
+        {
+          ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf,
+                              len, udpiplen, false);
+        }
+      else
+        {
+          ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf,
+                           len, udpiplen, false);
+        }
+
+      if (ret < 0)
+        {
+          udp_wrbuffer_release(wrb);
+          return ret;
+        }
+    }
+
+  /* Dump I/O buffer chain */
+
+  UDP_WBDUMP("I/O buffer chain", wrb, wrb->wb_iob->io_pktlen, 0);
+
+  *pwrb = wrb;
+  return OK;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -570,8 +739,15 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 {
   FAR struct udp_wrbuffer_s *wrb;
   FAR struct udp_conn_s *conn;
+#ifdef NEED_UDP_USO
+  FAR struct net_driver_s *dev;
+#endif
   unsigned int timeout;
-  uint16_t udpiplen;
+  uint16_t gsosize = 0;
+  sq_queue_t queue;
+  size_t segsize;
+  size_t seglen;
+  size_t offset;
   bool nonblock;
   bool empty;
   int ret = OK;
@@ -741,125 +917,58 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
   conn_unlock(&conn->sconn);
 #endif /* CONFIG_NET_SEND_BUFSIZE */
 
-  /* Allocate a write buffer.  Careful, the network will be momentarily
-   * unlocked here.
+  /* With UDP_SEGMENT, a large send is cut into datagrams of gsosize bytes
+   * here, or left whole to a device that can cut it.
    */
 
-#ifdef CONFIG_NET_JUMBO_FRAME
-
-  /* alloc iob of gso pkt for udp data */
-
-  wrb = udp_wrbuffer_tryalloc(len + udpip_hdrsize(conn) +
-                              CONFIG_NET_LL_GUARDSIZE);
-#else
-  if (nonblock)
+  segsize = len;
+#ifdef CONFIG_NET_UDP_SEGMENT
+  if (conn->gsosize > 0 && len > conn->gsosize)
     {
-      wrb = udp_wrbuffer_tryalloc();
-    }
-  else
-    {
-      wrb = udp_wrbuffer_timedalloc(udp_send_gettimeout(start, timeout));
-    }
-#endif
-
-  if (wrb == NULL)
-    {
-      /* A buffer allocation error occurred */
-
-      nerr("ERROR: Failed to allocate write buffer\n");
-
-      if (nonblock || timeout != UINT_MAX)
+      if (len > (size_t)conn->gsosize * UDP_MAX_SEGMENTS)
         {
-          ret = -EAGAIN;
-        }
-      else
-        {
-          ret = -ENOMEM;
+          return -EINVAL;
         }
 
-      return ret;
-    }
-
-  /* Initialize the write buffer
-   *
-   * Check if the socket is connected
-   */
-
-  if (_SS_ISCONNECTED(conn->sconn.s_flags))
-    {
-      /* Yes.. get the connection address from the connection structure */
-
-#ifdef CONFIG_NET_IPv4
-#ifdef CONFIG_NET_IPv6
-      if (conn->domain == PF_INET)
-#endif
+#ifdef NEED_UDP_USO
+      dev = udp_find_raddr_device(conn,
+                                  (FAR struct sockaddr_storage *)to);
+      if (dev != NULL &&
+          NETDEV_HAS_FEATURE(dev, NETDEV_FEATURE_USO |
+                                  NETDEV_FEATURE_TXCSUM))
         {
-          FAR struct sockaddr_in *addr4 =
-            (FAR struct sockaddr_in *)&wrb->wb_dest;
-
-          addr4->sin_family = AF_INET;
-          addr4->sin_port   = conn->rport;
-          net_ipv4addr_copy(addr4->sin_addr.s_addr, conn->u.ipv4.raddr);
-          memset(addr4->sin_zero, 0, sizeof(addr4->sin_zero));
+          gsosize = conn->gsosize;
         }
-#endif /* CONFIG_NET_IPv4 */
-
-#ifdef CONFIG_NET_IPv6
-#ifdef CONFIG_NET_IPv4
       else
 #endif
         {
-          FAR struct sockaddr_in6 *addr6 =
-            (FAR struct sockaddr_in6 *)&wrb->wb_dest;
-
-          addr6->sin6_family = AF_INET6;
-          addr6->sin6_port   = conn->rport;
-          net_ipv6addr_copy(addr6->sin6_addr.s6_addr, conn->u.ipv6.raddr);
+          segsize = conn->gsosize;
         }
-#endif /* CONFIG_NET_IPv6 */
-    }
-
-  /* Not connected.  Use the provided destination address */
-
-  else
-    {
-      memcpy(&wrb->wb_dest, to, tolen);
-      udp_connect(conn, to);
     }
+#endif
 
-  /* Skip l2/l3/l4 offset before copy */
-
-  udpiplen = udpip_hdrsize(conn);
-
-  iob_reserve(wrb->wb_iob, CONFIG_NET_LL_GUARDSIZE);
-  iob_update_pktlen(wrb->wb_iob, udpiplen, false);
-
-  /* Copy the user data into the write buffer.  We cannot wait for
-   * buffer space if the socket was opened non-blocking.
+  /* Allocate the write buffers.  Careful, the network will be momentarily
+   * unlocked here.  The datagrams are queued together or not at all.
    */
 
-  if (len > 0)
-    {
-      if (nonblock)
-        {
-          ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf,
-                              len, udpiplen, false);
-        }
-      else
-        {
-          ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf,
-                           len, udpiplen, false);
-        }
+  sq_init(&queue);
+  offset = 0;
 
+  do
+    {
+      seglen = MIN(len - offset, segsize);
+      ret    = sendto_wrbuffer_fill(conn, (FAR const uint8_t *)buf + offset,
+                                    seglen, gsosize, nonblock, start,
+                                    timeout, to, tolen, &wrb);
       if (ret < 0)
         {
-          goto errout_with_wrb;
+          goto errout_with_queue;
         }
-    }
-
-  /* Dump I/O buffer chain */
 
-  UDP_WBDUMP("I/O buffer chain", wrb, wrb->wb_iob->io_pktlen, 0);
+      sq_addlast(&wrb->wb_node, &queue);
+      offset += seglen;
+    }
+  while (offset < len);
 
   /* sendto_eventhandler() will send data in FIFO order from the
    * conn->write_q.
@@ -875,14 +984,14 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
   conn_lock(&conn->sconn);
   empty = sq_empty(&conn->write_q);
 
-  sq_addlast(&wrb->wb_node, &conn->write_q);
+  sq_cat(&queue, &conn->write_q);
   ninfo("Queued WRB=%p pktlen=%u write_q(%p,%p)\n",
         wrb, wrb->wb_iob->io_pktlen,
         conn->write_q.head, conn->write_q.tail);
 
   if (empty)
     {
-      /* The new write buffer lies at the head of the write queue.  Set
+      /* The new write buffers lie at the head of the write queue.  Set
        * up for the next packet transfer by setting the connection
        * address to the address of the next packet now at the header of
        * the write buffer queue.
@@ -891,9 +1000,9 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       ret = sendto_next_transfer(conn);
       if (ret < 0)
         {
-          sq_remlast(&conn->write_q);
+          sq_move(&conn->write_q, &queue);
           conn_unlock(&conn->sconn);
-          goto errout_with_wrb;
+          goto errout_with_queue;
         }
 
       conn_unlock(&conn->sconn);
@@ -903,8 +1012,11 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
   return len;
 
-errout_with_wrb:
-  udp_wrbuffer_release(wrb);
+errout_with_queue:
+  while ((wrb = (FAR struct udp_wrbuffer_s *)sq_remfirst(&queue)) != NULL)
+    {
+      udp_wrbuffer_release(wrb);
+    }
 
   return ret;
 }
@@ -76,6 +76,47 @@
 int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
+#ifdef CONFIG_NET_UDP_SEGMENT
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  int optval;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  switch (option)
+    {
+      case UDP_SEGMENT:
+      case UDP_GRO:
+        if (value == NULL || value_len < sizeof(int))
+          {
+            return -EINVAL;
+          }
+
+        optval = *(FAR const int *)value;
+
+        if (option == UDP_GRO)
+          {
+            conn->gro = optval != 0;
+            return OK;
+          }
+
+        /* Zero turns segmentation off again */
+
+        if (optval < 0 || optval > UINT16_MAX - udpip_hdrsize(conn))
+          {
+            return -EINVAL;
+          }
+
+        conn->gsosize = optval;
+        return OK;
+
+      default:
+        break;
+    }
+#endif
+
   return -ENOPROTOOPT;
 }
 
@@ -85,6 +85,9 @@ struct usrsock_conn_s
   bool       connected;              /* Socket has been connected */
   int16_t    usockid;                /* Connection number used for kernel<->daemon */
   uint16_t   flags;                  /* Socket state flags */
+#ifdef CONFIG_NET_USRSOCK_BATCH
+  uint16_t   batchevents;            /* Events pending in the current batch */
+#endif
 
   struct
   {
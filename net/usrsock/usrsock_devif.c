@@ -62,6 +62,13 @@ struct usrsock_req_s
   /* Connection instance to receive data buffers. */
 
   FAR struct usrsock_conn_s *datain_conn;
+
+#ifdef CONFIG_NET_USRSOCK_BATCH
+  /* Connections with events pending in the current batch */
+
+  FAR struct usrsock_conn_s *batch[CONFIG_NET_USRSOCK_BATCH_NEVENTS];
+  int nbatch;
+#endif
 };
 
 /****************************************************************************
@@ -83,6 +90,13 @@ static struct usrsock_req_s g_usrsock_req =
   NULL
 };
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static ssize_t usrsock_response_one(FAR const char *buffer, size_t len,
+                                    FAR bool *req_done);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -190,6 +204,62 @@ out:
   return total;
 }
 
+/****************************************************************************
+ * Name: usrsock_batch_flush
+ *
+ * Description:
+ *   Deliver the events coalesced in the current batch.  Called with
+ *   usrsock_lock() held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_USRSOCK_BATCH
+static void usrsock_batch_flush(void)
+{
+  FAR struct usrsock_req_s *req = &g_usrsock_req;
+  FAR struct usrsock_conn_s *conn;
+  int i;
+
+  for (i = 0; i < req->nbatch; i++)
+    {
+      conn = req->batch[i];
+      conn->resp.events = conn->batchevents;
+      conn->batchevents = 0;
+      usrsock_event(conn);
+    }
+
+  req->nbatch = 0;
+}
+
+/****************************************************************************
+ * Name: usrsock_batch_event
+ *
+ * Description:
+ *   Add events to those of the connection in the current batch.  Called
+ *   with usrsock_lock() held, so that the connection stays around until
+ *   the batch is flushed.
+ *
+ ****************************************************************************/
+
+static void usrsock_batch_event(FAR struct usrsock_conn_s *conn,
+                                uint16_t events)
+{
+  FAR struct usrsock_req_s *req = &g_usrsock_req;
+
+  if (conn->batchevents == 0)
+    {
+      if (req->nbatch == CONFIG_NET_USRSOCK_BATCH_NEVENTS)
+        {
+          usrsock_batch_flush();
+        }
+
+      req->batch[req->nbatch++] = conn;
+    }
+
+  conn->batchevents |= events;
+}
+#endif
+
 /****************************************************************************
  * Name: usrsock_handle_event
  ****************************************************************************/
@@ -204,7 +274,9 @@ static ssize_t usrsock_handle_event(FAR const void *buffer, size_t len)
       {
         FAR const struct usrsock_message_socket_event_s *hdr = buffer;
         FAR struct usrsock_conn_s *conn;
+#ifndef CONFIG_NET_USRSOCK_BATCH
         int ret;
+#endif
 
         if (len < sizeof(*hdr))
           {
@@ -237,12 +309,20 @@ static ssize_t usrsock_handle_event(FAR const void *buffer, size_t len)
 
         /* Handle event. */
 
+#ifdef CONFIG_NET_USRSOCK_BATCH
+        if (hdr->head.events & ~USRSOCK_EVENT_INTERNAL_MASK)
+          {
+            usrsock_batch_event(conn, hdr->head.events &
+                                      ~USRSOCK_EVENT_INTERNAL_MASK);
+          }
+#else
         conn->resp.events = hdr->head.events & ~USRSOCK_EVENT_INTERNAL_MASK;
         ret = usrsock_event(conn);
         if (ret < 0)
           {
             return ret;
           }
+#endif
       }
       break;
 
@@ -523,6 +603,11 @@ static ssize_t usrsock_handle_message(FAR const void *buffer, size_t len,
 
   if (USRSOCK_MESSAGE_IS_REQ_RESPONSE(common->flags))
     {
+#ifdef CONFIG_NET_USRSOCK_BATCH
+      /* The events sent ahead of the response are delivered first */
+
+      usrsock_batch_flush();
+#endif
       return usrsock_handle_req_response(buffer, len, req_done);
     }
 
@@ -531,15 +616,11 @@ static ssize_t usrsock_handle_message(FAR const void *buffer, size_t len,
 }
 
 /****************************************************************************
- * Public Functions
+ * Name: usrsock_response_one() - handle one message of the daemon
  ****************************************************************************/
 
-/****************************************************************************
- * Name: usrsock_response() - handle usrsock request's ack/response
- ****************************************************************************/
-
-ssize_t usrsock_response(FAR const char *buffer, size_t len,
-                         FAR bool *req_done)
+static ssize_t usrsock_response_one(FAR const char *buffer, size_t len,
+                                    FAR bool *req_done)
 {
   FAR struct usrsock_req_s *req = &g_usrsock_req;
   FAR struct usrsock_conn_s *conn;
@@ -610,6 +691,51 @@ ssize_t usrsock_response(FAR const char *buffer, size_t len,
   return ret;
 }
 
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: usrsock_response() - handle usrsock request's ack/response
+ *
+ * Description:
+ *   Handle what the daemon sent.  With CONFIG_NET_USRSOCK_BATCH this may
+ *   be several messages back to back, the result is then the length of
+ *   those that were handled, or the error of the first one.
+ *
+ ****************************************************************************/
+
+ssize_t usrsock_response(FAR const char *buffer, size_t len,
+                         FAR bool *req_done)
+{
+#ifdef CONFIG_NET_USRSOCK_BATCH
+  size_t origlen = len;
+  ssize_t ret;
+
+  usrsock_lock();
+
+  do
+    {
+      ret = usrsock_response_one(buffer, len, req_done);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      buffer += ret;
+      len    -= ret;
+    }
+  while (len > 0);
+
+  usrsock_batch_flush();
+  usrsock_unlock();
+
+  return len < origlen ? (ssize_t)(origlen - len) : ret;
+#else
+  return usrsock_response_one(buffer, len, req_done);
+#endif
+}
+
 /****************************************************************************
  * Name: usrsock_iovec_get() - copy from iovec to buffer.
  ****************************************************************************/
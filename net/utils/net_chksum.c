@@ -27,92 +27,328 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CHKSUM_SWAP16(s) ((uint16_t)(((s) << 8) | ((s) >> 8)))
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: checksum
+ * Name: chksum_generic
  *
  * Description:
- *   Calculate the raw change sum over the memory region described by
- *   data and len.
+ *   Sum the 16-bit words of the memory region in memory byte order, 32 bits
+ *   at a time, and optionally copy the region while doing so.  This is the
+ *   portable implementation of net_chksum_partial() and net_chksum_copy().
  *
  * Input Parameters:
- *   sum  - Partial calculations carried over from a previous call to
- *          chksum().  This should be zero on the first time that check
- *          sum is called.
- *   data - Beginning of the data to include in the checksum.
+ *   dst  - Destination of the copy, NULL to only sum.  Must have the same
+ *          alignment modulo 4 as src.
+ *   src  - Beginning of the data to include in the checksum.
  *   len  - Length of the data to include in the checksum.
- *   odd  - the flag of the Calculated data sum
  *
  * Returned Value:
- *   The updated checksum value.
+ *   The folded sum in memory byte order.
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
-uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
-                    uint16_t len, bool *odd)
+#ifndef CONFIG_NET_ARCH_CHKSUM_PARTIAL
+static always_inline_function uint16_t
+chksum_generic(FAR uint8_t *dst, FAR const uint8_t *src, size_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  uint64_t acc = 0;
+  uint32_t w;
+  bool odd;
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  /* An odd start address shifts all words by one byte, which is undone by
+   * swapping the result.
+   */
+
+  odd = ((uintptr_t)src & 1) != 0;
+  if (odd)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc = *src;
+#else
+      acc = (uint32_t)*src << 8;
+#endif
+      if (dst != NULL)
+        {
+          *dst++ = *src;
+        }
 
-  dataptr = data;
-  last_byte = data + len - 1;
+      src++;
+      len--;
+    }
 
-  if (*odd == true)
+  if (len >= 2 && ((uintptr_t)src & 2) != 0)
     {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
+      w = *(FAR const uint16_t *)src;
+      if (dst != NULL)
         {
-          sum++; /* carry */
+          *(FAR uint16_t *)dst = (uint16_t)w;
+          dst += 2;
         }
 
-      dataptr += 1;
+      acc += w;
+      src += 2;
+      len -= 2;
     }
 
-  while (dataptr < last_byte)
+  /* The main loop.  A 64-bit accumulator makes the carries free. */
+
+  while (len >= 16)
     {
-      /* At least two more bytes */
+      FAR const uint32_t *s = (FAR const uint32_t *)src;
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
+      if (dst != NULL)
         {
-          sum++; /* carry */
+          FAR uint32_t *d = (FAR uint32_t *)dst;
+
+          d[0] = s[0];
+          d[1] = s[1];
+          d[2] = s[2];
+          d[3] = s[3];
+          dst += 16;
         }
 
-      dataptr += 2;
+      acc += (uint64_t)s[0] + s[1] + s[2] + s[3];
+      src += 16;
+      len -= 16;
     }
 
-  *odd = false;
+  while (len >= 4)
+    {
+      w = *(FAR const uint32_t *)src;
+      if (dst != NULL)
+        {
+          *(FAR uint32_t *)dst = w;
+          dst += 4;
+        }
 
-  if (dataptr == last_byte)
+      acc += w;
+      src += 4;
+      len -= 4;
+    }
+
+  if (len >= 2)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
+      w = *(FAR const uint16_t *)src;
+      if (dst != NULL)
         {
-          sum++; /* carry */
+          *(FAR uint16_t *)dst = (uint16_t)w;
+          dst += 2;
         }
 
-      *odd = true;
+      acc += w;
+      src += 2;
+      len -= 2;
+    }
+
+  if (len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc += (uint32_t)*src << 8;
+#else
+      acc += *src;
+#endif
+      if (dst != NULL)
+        {
+          *dst = *src;
+        }
     }
 
-  /* Return sum in host byte order. */
+  /* Fold the accumulator to 16 bits */
 
-  return sum;
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  return odd ? CHKSUM_SWAP16((uint16_t)acc) : (uint16_t)acc;
+}
+#endif
+
+/****************************************************************************
+ * Name: checksum_add
+ *
+ * Description:
+ *   Add a partial sum in memory byte order to the running checksum, which
+ *   is kept as host order sum of the big endian 16-bit words.
+ *
+ * Input Parameters:
+ *   sum     - The running checksum.
+ *   partial - The result of net_chksum_partial() or net_chksum_copy().
+ *   len     - Length of the data summed in partial.
+ *   odd     - True if the data began on an odd byte of the running sum;
+ *             updated for the next call.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+static uint16_t checksum_add(uint16_t sum, uint16_t partial, size_t len,
+                             FAR bool *odd)
+{
+  uint32_t t = partial;
+
+#ifdef CONFIG_ENDIAN_BIG
+  if (*odd)
+#else
+  if (!*odd)
+#endif
+    {
+      t = CHKSUM_SWAP16(partial);
+    }
+
+  if ((len & 1) != 0)
+    {
+      *odd = !*odd;
+    }
+
+  t += sum;
+  return (uint16_t)((t & 0xffff) + (t >> 16));
+}
+
+/****************************************************************************
+ * Name: checksum
+ *
+ * Description:
+ *   Calculate the raw change sum over the memory region described by
+ *   data and len.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum().  This should be zero on the first time that check
+ *          sum is called.
+ *   data - Beginning of the data to include in the checksum.
+ *   len  - Length of the data to include in the checksum.
+ *   odd  - the flag of the Calculated data sum
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+static uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
+                         uint16_t len, FAR bool *odd)
+{
+  if (len == 0)
+    {
+      return sum;
+    }
+
+  return checksum_add(sum, net_chksum_partial(data, len), len, odd);
 }
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: net_chksum_partial
+ *
+ * Description:
+ *   Calculate the ones' complement sum of the 16-bit words of a memory
+ *   region in memory byte order.  The portable version sums 32 bits at a
+ *   time; an architecture may provide a vectorized one by selecting
+ *   CONFIG_NET_ARCH_CHKSUM_PARTIAL.
+ *
+ * Input Parameters:
+ *   data - Beginning of the data to include in the checksum.
+ *   len  - Length of the data to include in the checksum.
+ *
+ * Returned Value:
+ *   The folded 16-bit sum in memory byte order.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARCH_CHKSUM_PARTIAL
+uint16_t net_chksum_partial(FAR const void *data, size_t len)
+{
+  return chksum_generic(NULL, data, len);
+}
+
+/****************************************************************************
+ * Name: net_chksum_copy
+ *
+ * Description:
+ *   Copy a memory region and return net_chksum_partial() of it, reading the
+ *   source only once.
+ *
+ * Input Parameters:
+ *   dst  - Destination of the copy.
+ *   src  - Beginning of the data to copy and include in the checksum.
+ *   len  - Length of the data.
+ *
+ * Returned Value:
+ *   The folded 16-bit sum in memory byte order.
+ *
+ ****************************************************************************/
+
+uint16_t net_chksum_copy(FAR void *dst, FAR const void *src, size_t len)
+{
+  /* The word loop needs both buffers at the same alignment.  Otherwise sum
+   * the destination right after the copy while it is still in the cache.
+   */
+
+  if ((((uintptr_t)dst ^ (uintptr_t)src) & 3) != 0)
+    {
+      memcpy(dst, src, len);
+      return chksum_generic(NULL, dst, len);
+    }
+
+  return chksum_generic(dst, src, len);
+}
+#endif /* CONFIG_NET_ARCH_CHKSUM_PARTIAL */
+
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy a memory region and accumulate its checksum like chksum().
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call.
+ *   dst  - Destination of the copy.
+ *   src  - Beginning of the data to copy and include in the checksum.
+ *   len  - Length of the data.
+ *   odd  - True if the data begins on an odd byte of the running sum;
+ *          updated for the next call.  Should be false on the first call.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dst, FAR const uint8_t *src,
+                     uint16_t len, FAR bool *odd)
+{
+  if (len == 0)
+    {
+      return sum;
+    }
+
+  return checksum_add(sum, net_chksum_copy(dst, src, len), len, odd);
+}
+
 /****************************************************************************
  * Name: chksum
  *
@@ -132,13 +368,13 @@ uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
   bool odd = false;
 
   return checksum(sum, data, len, &odd);
 }
-
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
 /****************************************************************************
@@ -186,6 +422,77 @@ uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
 
   return sum;
 }
+
+/****************************************************************************
+ * Name: chksum_iob_sndsum
+ *
+ * Description:
+ *   Calculate the checksum over the packet in d_iob starting at offset like
+ *   chksum_iob().  If devif_send() already summed the application data
+ *   while copying it in, only the headers in front of it are read.
+ *
+ * Input Parameters:
+ *   dev    - The network device holding the packet.
+ *   sum    - Partial calculations carried over from a previous call.
+ *   offset - Specifies the byte offset of the start of valid data.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+uint16_t chksum_iob_sndsum(FAR struct net_driver_s *dev, uint16_t sum,
+                           uint16_t offset)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  unsigned int hdrlen;
+  unsigned int len;
+  bool odd = false;
+  uint32_t t;
+
+  if (iob == NULL || dev->d_sndsumiob != iob || dev->d_sndlen == 0 ||
+      dev->d_sndsumoff < offset ||
+      dev->d_sndsumoff + dev->d_sndlen != iob->io_pktlen)
+    {
+      return chksum_iob(sum, iob, offset);
+    }
+
+  /* The stored sum is only used once */
+
+  dev->d_sndsumiob = NULL;
+
+  /* Sum the headers in front of the application data */
+
+  hdrlen = dev->d_sndsumoff - offset;
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  while (iob != NULL && hdrlen > 0)
+    {
+      len    = MIN(iob->io_len - offset, hdrlen);
+      sum    = checksum(sum, iob->io_data + iob->io_offset + offset,
+                        len, &odd);
+      hdrlen -= len;
+      offset = 0;
+      iob    = iob->io_flink;
+    }
+
+  /* And add the sum of the application data */
+
+  t = dev->d_sndsum;
+  if (odd)
+    {
+      t = CHKSUM_SWAP16(t);
+    }
+
+  t += sum;
+  return (uint16_t)((t & 0xffff) + (t >> 16));
+}
+#endif /* CONFIG_NET_CHKSUM_COPY */
 #endif /* CONFIG_MM_IOB */
 
 /****************************************************************************
@@ -0,0 +1,100 @@
+/****************************************************************************
+ * net/utils/net_flowhash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+
+#include "utils/utils.h"
+
+#if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_flowhash
+ *
+ * Description:
+ *   Hash the source address of the IP packet in d_iob together with the
+ *   source port of its transport header.  All the packets of one flow get
+ *   the same value, which spreads the flows evenly over the sockets that
+ *   share a port with SO_REUSEPORT.
+ *
+ * Input Parameters:
+ *   dev     - The device that received the packet
+ *   srcport - The source port (network byte order)
+ *
+ * Returned Value:
+ *   The hash value.
+ *
+ ****************************************************************************/
+
+uint32_t net_flowhash(FAR struct net_driver_s *dev, uint16_t srcport)
+{
+  FAR const uint16_t *srcaddr;
+  uint32_t hash = srcport;
+  int nwords;
+  int i;
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      srcaddr = IPv6BUF->srcipaddr;
+      nwords  = 8;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      srcaddr = IPv4BUF->srcipaddr;
+      nwords  = 2;
+    }
+#endif
+
+  for (i = 0; i < nwords; i++)
+    {
+      hash = (hash << 5) + hash + srcaddr[i];
+    }
+
+  /* Mix the high bits down since the result is taken modulo a small
+   * number of sockets.
+   */
+
+  hash *= 2654435761u;
+  return hash ^ (hash >> 16);
+}
+
+#endif /* CONFIG_NET_IPv4 || CONFIG_NET_IPv6 */
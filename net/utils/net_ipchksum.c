@@ -119,7 +119,7 @@ uint16_t ipv4_upperlayer_payload_chksum(FAR struct net_driver_s *dev,
 
   /* Sum IP payload data. */
 
-  return chksum_iob(sum, dev->d_iob, iphdrlen);
+  return chksum_iob_sndsum(dev, sum, iphdrlen);
 }
 
 /****************************************************************************
@@ -236,7 +236,7 @@ uint16_t ipv6_upperlayer_payload_chksum(FAR struct net_driver_s *dev,
 {
   /* Sum IP payload data. */
 
-  return chksum_iob(sum, dev->d_iob, iplen);
+  return chksum_iob_sndsum(dev, sum, iplen);
 }
 
 /****************************************************************************
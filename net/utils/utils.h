@@ -420,6 +420,26 @@ void net_ipv6_pref2mask(net_ipv6addr_t mask, uint8_t preflen);
 FAR void *net_ipv6_payload(FAR struct ipv6_hdr_s *ipv6, FAR uint8_t *proto);
 #endif
 
+/****************************************************************************
+ * Name: net_flowhash
+ *
+ * Description:
+ *   Hash the source address of the IP packet in d_iob together with the
+ *   source port of its transport header.
+ *
+ * Input Parameters:
+ *   dev     - The device that received the packet
+ *   srcport - The source port (network byte order)
+ *
+ * Returned Value:
+ *   The hash value, the same for all the packets of a flow.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv4) || defined(CONFIG_NET_IPv6)
+uint32_t net_flowhash(FAR struct net_driver_s *dev, uint16_t srcport);
+#endif
+
 /****************************************************************************
  * Name: net_iob_concat
  *
@@ -642,6 +662,24 @@ uint16_t icmp_chksum_iob(FAR struct iob_s *iob);
 uint16_t icmpv6_chksum(FAR struct net_driver_s *dev, unsigned int iplen);
 #endif
 
+/****************************************************************************
+ * Name: chksum_iob_sndsum
+ *
+ * Description:
+ *   Calculate the checksum over the packet in d_iob starting at offset like
+ *   chksum_iob().  If devif_send() already summed the application data
+ *   while copying it in, only the headers in front of it are read.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+uint16_t chksum_iob_sndsum(FAR struct net_driver_s *dev, uint16_t sum,
+                           uint16_t offset);
+#else
+#  define chksum_iob_sndsum(dev, sum, offset) \
+     chksum_iob(sum, (dev)->d_iob, offset)
+#endif
+
 /****************************************************************************
  * Name: cmsg_append
  *
@@ -52,30 +52,43 @@
 
 static struct wdog_s g_adjtime_wdog;
 static long g_adjtime_ppb;
+static long g_adjtime_freq;
 static spinlock_t g_adjtime_lock = SP_UNLOCKED;
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-/* Restore default rate after adjustment period expires */
+/* Set the rate of the system clock: the frequency offset of
+ * nxclock_adjfreq() plus the slew of adjtime().
+ */
 
-static void adjtime_wdog_callback(wdparm_t arg)
+static int adjtime_apply(long ppb)
 {
-  irqstate_t flags;
-
-  UNUSED(arg);
-
-  flags = spin_lock_irqsave(&g_adjtime_lock);
+  int ret = OK;
 
 #ifdef CONFIG_ARCH_HAVE_ADJTIME
-  up_adjtime(0);
+  up_adjtime(ppb);
 #endif
 
 #ifdef CONFIG_RTC_ADJTIME
-  up_rtc_adjtime(0);
+  ret = up_rtc_adjtime(ppb);
 #endif
 
+  UNUSED(ppb);
+  return ret;
+}
+
+/* Restore default rate after adjustment period expires */
+
+static void adjtime_wdog_callback(wdparm_t arg)
+{
+  irqstate_t flags;
+
+  UNUSED(arg);
+
+  flags = spin_lock_irqsave(&g_adjtime_lock);
+  adjtime_apply(g_adjtime_freq);
   g_adjtime_ppb = 0;
   spin_unlock_irqrestore(&g_adjtime_lock, flags);
 }
@@ -122,14 +135,7 @@ static int adjtime_start(long long adjust_usec)
   /* Set new adjustment */
 
   g_adjtime_ppb = ppb;
-
-#ifdef CONFIG_ARCH_HAVE_ADJTIME
-  up_adjtime(g_adjtime_ppb);
-#endif
-
-#ifdef CONFIG_RTC_ADJTIME
-  ret = up_rtc_adjtime(g_adjtime_ppb);
-#endif
+  ret = adjtime_apply(g_adjtime_freq + g_adjtime_ppb);
 
   /* Queue cancellation of adjustment after configured period */
 
@@ -217,6 +223,45 @@ int adjtime(FAR const struct timeval *delta, FAR struct timeval *olddelta)
     }
 }
 
+/****************************************************************************
+ * Name: nxclock_adjfreq
+ *
+ * Description:
+ *   Run the system clock ppb parts per billion faster than nominal until
+ *   this is called again.  The slews of adjtime() are applied on top of
+ *   this rate, which is limited to CONFIG_CLOCK_ADJTIME_SLEWLIMIT_PPM.
+ *
+ * Input Parameters:
+ *   ppb - The frequency offset, negative to run slower.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxclock_adjfreq(long ppb)
+{
+  long ppb_limit = CONFIG_CLOCK_ADJTIME_SLEWLIMIT_PPM * 1000L;
+  irqstate_t flags;
+  int ret;
+
+  if (ppb > ppb_limit)
+    {
+      ppb = ppb_limit;
+    }
+  else if (ppb < -ppb_limit)
+    {
+      ppb = -ppb_limit;
+    }
+
+  flags = spin_lock_irqsave_nopreempt(&g_adjtime_lock);
+  g_adjtime_freq = ppb;
+  ret = adjtime_apply(g_adjtime_freq + g_adjtime_ppb);
+  spin_unlock_irqrestore_nopreempt(&g_adjtime_lock, flags);
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: nxclock_adjtime
  *
@@ -248,6 +293,17 @@ int nxclock_adjtime(clockid_t clock_id, FAR struct timex *buf)
 {
   int ret = -EINVAL;
 
+#if defined(CONFIG_ARCH_HAVE_ADJTIME) || defined(CONFIG_RTC_ADJTIME)
+  /* The frequency of the system clock, freq is in ppm with a 16 bit
+   * fraction.
+   */
+
+  if (clock_id == CLOCK_REALTIME && buf->modes == ADJ_FREQUENCY)
+    {
+      return nxclock_adjfreq(((int64_t)buf->freq * 125) >> 13);
+    }
+#endif
+
 #ifdef CONFIG_PTP_CLOCK
   if ((clock_id & CLOCK_MASK) == CLOCK_FD)
     {
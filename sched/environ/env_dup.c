@@ -49,7 +49,9 @@
  * Description:
  *   Copy the internal environment structure of a task.  This is the action
  *   that is performed when a new task is created: The new task has a
- *   private, exact duplicate of the parent task's environment.
+ *   private, exact duplicate of the parent task's environment.  With
+ *   CONFIG_SCHED_ENVIRON_HASH the parent's own environment is shared
+ *   instead and copied when either group changes it.
  *
  * Input Parameters:
  *   group - The child task group to receive the newly allocated copy of
@@ -83,6 +85,12 @@ int env_dup(FAR struct task_group_s *group, FAR char * const *envcp)
 
       flags = enter_critical_section();
 
+      if (env_share(group, envcp))
+        {
+          leave_critical_section(flags);
+          return OK;
+        }
+
       /* Count the strings */
 
       while (envcp[envc] != NULL)
@@ -102,7 +110,7 @@ int env_dup(FAR struct task_group_s *group, FAR char * const *envcp)
         {
           /* There is an environment, duplicate it */
 
-          envp = group_malloc(group, sizeof(*envp) * group->tg_envpc);
+          envp = env_alloc(group, group->tg_envpc);
           if (envp == NULL)
             {
               /* The parent's environment can not be inherited due to a
@@ -114,6 +122,7 @@ int env_dup(FAR struct task_group_s *group, FAR char * const *envcp)
           else
             {
               envp[envc] = NULL;
+              group->tg_envp = envp;
 
               /* Duplicate the parent environment. */
 
@@ -121,20 +130,26 @@ int env_dup(FAR struct task_group_s *group, FAR char * const *envcp)
                 {
                   size = strlen(envcp[envc]) + 1;
                   envp[envc] = group_malloc(group, size);
-                  if (envp[envc] == NULL)
+                  if (envp[envc] != NULL)
                     {
-                      while (envp[++envc] != NULL)
+                      strlcpy(envp[envc], envcp[envc], size);
+                      if (env_hashadd(group, envc) >= 0)
                         {
-                          group_free(group, envp[envc]);
+                          continue;
                         }
 
-                      group_free(group, envp);
-                      envp = NULL;
-                      ret = -ENOMEM;
-                      break;
+                      envc--;
+                    }
+
+                  while (envp[++envc] != NULL)
+                    {
+                      group_free(group, envp[envc]);
                     }
 
-                  strlcpy(envp[envc], envcp[envc], size);
+                  env_free(group, envp);
+                  envp = NULL;
+                  ret = -ENOMEM;
+                  break;
                 }
             }
         }
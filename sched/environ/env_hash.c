@@ -0,0 +1,369 @@
+/****************************************************************************
+ * sched/environ/env_hash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_SCHED_ENVIRON_HASH
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/hashmap.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
+
+#include "sched/sched.h"
+#include "environ/environ.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ENV_BLOCK(p) container_of(p, struct env_block_s, envp)
+#define ENV_BLOCKSIZE(envpc) \
+  (offsetof(struct env_block_s, envp) + sizeof(FAR char *) * (envpc))
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The environment array of a group is the tail of this block.  The hash
+ * table maps each name to the index + 1 of its name=value string, so that
+ * the entries stay valid when the array is reallocated.  A child group
+ * shares the block of its parent until either of them changes it.
+ */
+
+struct env_block_s
+{
+  int refs;                         /* Number of groups using the block */
+  struct hashmap_s hash;            /* Index + 1 of each name */
+  FAR char *envp[1];                /* The environment array */
+};
+
+/* The key of a lookup, a name that is not terminated by '=' */
+
+struct env_key_s
+{
+  FAR char **envp;
+  FAR const char *name;
+  size_t len;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_hashname
+ ****************************************************************************/
+
+static uint32_t env_hashname(FAR const char *name, size_t len)
+{
+  uint32_t hash = 2166136261u;
+
+  while (len-- > 0)
+    {
+      hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: env_match
+ ****************************************************************************/
+
+static bool env_match(FAR const void *entry, FAR const void *key)
+{
+  FAR const struct env_key_s *k = key;
+  FAR const char *pvar = k->envp[(uintptr_t)entry - 1];
+
+  return strncmp(pvar, k->name, k->len) == 0 && pvar[k->len] == '=';
+}
+
+/****************************************************************************
+ * Name: env_key
+ ****************************************************************************/
+
+static uint32_t env_key(FAR struct env_key_s *key, FAR char **envp,
+                        FAR const char *name, size_t len)
+{
+  key->envp = envp;
+  key->name = name;
+  key->len  = len;
+  return env_hashname(name, len);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: env_alloc
+ *
+ * Description:
+ *   Allocate an environment array of envpc entries with an empty hash
+ *   table.
+ *
+ ****************************************************************************/
+
+FAR char **env_alloc(FAR struct task_group_s *group, ssize_t envpc)
+{
+  FAR struct env_block_s *blk;
+
+  blk = group_malloc(group, ENV_BLOCKSIZE(envpc));
+  if (blk == NULL)
+    {
+      return NULL;
+    }
+
+  if (hashmap_init(&blk->hash, envpc, env_match) < 0)
+    {
+      group_free(group, blk);
+      return NULL;
+    }
+
+  blk->refs = 1;
+  return blk->envp;
+}
+
+/****************************************************************************
+ * Name: env_realloc
+ *
+ * Description:
+ *   Resize an environment array that is not shared.
+ *
+ ****************************************************************************/
+
+FAR char **env_realloc(FAR struct task_group_s *group, FAR char **envp,
+                       ssize_t envpc)
+{
+  FAR struct env_block_s *blk = ENV_BLOCK(envp);
+
+  DEBUGASSERT(blk->refs == 1);
+
+  blk = group_realloc(group, blk, ENV_BLOCKSIZE(envpc));
+  return blk != NULL ? blk->envp : NULL;
+}
+
+/****************************************************************************
+ * Name: env_free
+ *
+ * Description:
+ *   Free an environment array and its hash table, not the strings.
+ *
+ ****************************************************************************/
+
+void env_free(FAR struct task_group_s *group, FAR char **envp)
+{
+  FAR struct env_block_s *blk = ENV_BLOCK(envp);
+
+  hashmap_deinit(&blk->hash);
+  group_free(group, blk);
+}
+
+/****************************************************************************
+ * Name: env_hashadd
+ *
+ * Description:
+ *   Add the name=value string at index of the environment to the hash
+ *   table.
+ *
+ ****************************************************************************/
+
+int env_hashadd(FAR struct task_group_s *group, ssize_t index)
+{
+  FAR char *pvar = group->tg_envp[index];
+  uint32_t hash = env_hashname(pvar, strcspn(pvar, "="));
+
+  return hashmap_insert(&ENV_BLOCK(group->tg_envp)->hash, hash,
+                        (FAR void *)(uintptr_t)(index + 1));
+}
+
+/****************************************************************************
+ * Name: env_hashdel
+ *
+ * Description:
+ *   Remove the name=value string at index of the environment from the hash
+ *   table.
+ *
+ ****************************************************************************/
+
+void env_hashdel(FAR struct task_group_s *group, ssize_t index)
+{
+  FAR char *pvar = group->tg_envp[index];
+  FAR void *entry;
+  struct env_key_s key;
+  uint32_t hash;
+
+  hash  = env_key(&key, group->tg_envp, pvar, strcspn(pvar, "="));
+  entry = hashmap_remove(&ENV_BLOCK(group->tg_envp)->hash, hash, &key);
+  DEBUGASSERT(entry == (FAR void *)(uintptr_t)(index + 1));
+  UNUSED(entry);
+}
+
+/****************************************************************************
+ * Name: env_findvar
+ *
+ * Description:
+ *   Look up the variable of the specified name in the hash table of the
+ *   environment, this replaces the linear search of env_findvar.c.
+ *
+ * Returned Value:
+ *   A index to the name=value string in the environment, or -ENOENT.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+ssize_t env_findvar(FAR struct task_group_s *group, FAR const char *pname)
+{
+  FAR void *entry;
+  struct env_key_s key;
+  uint32_t hash;
+
+  DEBUGASSERT(group != NULL && pname != NULL);
+
+  if (group->tg_envp == NULL)
+    {
+      return -ENOENT;
+    }
+
+  hash  = env_key(&key, group->tg_envp, pname, strlen(pname));
+  entry = hashmap_find(&ENV_BLOCK(group->tg_envp)->hash, hash, &key);
+  return entry != NULL ? (ssize_t)(uintptr_t)entry - 1 : -ENOENT;
+}
+
+/****************************************************************************
+ * Name: env_share
+ *
+ * Description:
+ *   Let the new group share the environment of the current group, if envcp
+ *   is that environment and both groups allocate from the same heap.
+ *
+ * Returned Value:
+ *   true if the environment is shared, false if it must be copied.
+ *
+ * Assumptions:
+ *   Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+bool env_share(FAR struct task_group_s *group, FAR char * const *envcp)
+{
+#ifndef CONFIG_BUILD_KERNEL
+  FAR struct task_group_s *parent = this_task()->group;
+
+  if (parent == NULL || parent == group || envcp != parent->tg_envp ||
+      ((parent->tg_flags ^ group->tg_flags) & GROUP_FLAG_PRIVILEGED) != 0)
+    {
+      return false;
+    }
+
+  ENV_BLOCK(parent->tg_envp)->refs++;
+  group->tg_envp  = parent->tg_envp;
+  group->tg_envpc = parent->tg_envpc;
+  group->tg_envc  = parent->tg_envc;
+  return true;
+#else
+  /* Each process has its own address environment */
+
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Give the group a private copy of its environment before it is changed.
+ *
+ * Returned Value:
+ *   Zero on success, -ENOMEM if the copy cannot be allocated.
+ *
+ * Assumptions:
+ *   Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+int env_unshare(FAR struct task_group_s *group)
+{
+  FAR char **envp = group->tg_envp;
+  ssize_t envpc = group->tg_envpc;
+  ssize_t envc = group->tg_envc;
+  int ret;
+
+  if (envp == NULL || ENV_BLOCK(envp)->refs == 1)
+    {
+      return OK;
+    }
+
+  group->tg_envp = NULL;
+  ret = env_dup(group, envp);
+  if (ret < 0)
+    {
+      group->tg_envp  = envp;
+      group->tg_envpc = envpc;
+      group->tg_envc  = envc;
+      return ret;
+    }
+
+  ENV_BLOCK(envp)->refs--;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: env_unref
+ *
+ * Description:
+ *   Drop the reference of a group that leaves its environment.
+ *
+ * Returned Value:
+ *   true if other groups still use the environment, its strings must not
+ *   be freed then.
+ *
+ ****************************************************************************/
+
+bool env_unref(FAR struct task_group_s *group)
+{
+  FAR struct env_block_s *blk = ENV_BLOCK(group->tg_envp);
+  irqstate_t flags;
+  bool shared;
+
+  flags  = enter_critical_section();
+  shared = --blk->refs > 0;
+  leave_critical_section(flags);
+  return shared;
+}
+
+#endif /* CONFIG_SCHED_ENVIRON_HASH */
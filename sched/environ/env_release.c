@@ -67,9 +67,11 @@ void env_release(FAR struct task_group_s *group)
 
   DEBUGASSERT(group != NULL);
 
-  if (group->tg_envp)
+  if (group->tg_envp && !env_unref(group))
     {
-      /* Free any allocate environment strings */
+      /* Free any allocate environment strings, unless the environment is
+       * still shared with other groups.
+       */
 
       for (i = 0; group->tg_envp[i] != NULL; i++)
         {
@@ -78,7 +80,7 @@ void env_release(FAR struct task_group_s *group)
 
       /* Free the environment */
 
-      group_free(group, group->tg_envp);
+      env_free(group, group->tg_envp);
     }
 
   /* In any event, make sure that all environment-related variables in the
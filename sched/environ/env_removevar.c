@@ -67,6 +67,7 @@ void env_removevar(FAR struct task_group_s *group, ssize_t index)
 
   /* Free the allocate environment string */
 
+  env_hashdel(group, index);
   group_free(group, group->tg_envp[index]);
 
   /* Exchange the last env and the index env */
@@ -78,15 +79,20 @@ void env_removevar(FAR struct task_group_s *group, ssize_t index)
     }
   else
     {
+      env_hashdel(group, group->tg_envc);
       group->tg_envp[index] = group->tg_envp[group->tg_envc];
       group->tg_envp[group->tg_envc] = NULL;
+
+      /* There is room for the moved string, one was just removed */
+
+      DEBUGVERIFY(env_hashadd(group, index));
     }
 
   /* Free the old environment (if there was one) */
 
   if (group->tg_envc == 0)
     {
-      group_free(group, group->tg_envp);
+      env_free(group, group->tg_envp);
       group->tg_envp = NULL;
       group->tg_envpc = 0;
     }
@@ -97,8 +103,8 @@ void env_removevar(FAR struct task_group_s *group, ssize_t index)
 
       group->tg_envpc = group->tg_envc + SCHED_ENVIRON_RESERVED + 1;
 
-      group->tg_envp = group_realloc(group, group->tg_envp,
-         sizeof(*group->tg_envp) * group->tg_envpc);
+      group->tg_envp = env_realloc(group, group->tg_envp,
+                                   group->tg_envpc);
       DEBUGASSERT(group->tg_envp != NULL);
     }
 }
@@ -135,8 +135,21 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
        * the environment buffer; this will happen below.
        */
 
+      if (env_unshare(group) < 0)
+        {
+          ret = ENOMEM;
+          goto errout_with_lock;
+        }
+
       env_removevar(group, ret);
     }
+  else if (env_unshare(group) < 0)
+    {
+      /* A shared environment is copied before it is changed */
+
+      ret = ENOMEM;
+      goto errout_with_lock;
+    }
 
   /* Check current envirments count */
 
@@ -163,7 +176,7 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
     {
       envpc = SCHED_ENVIRON_RESERVED + 2;
 
-      envp = group_malloc(group, sizeof(*envp) * envpc);
+      envp = env_alloc(group, envpc);
       if (envp == NULL)
         {
           ret = ENOMEM;
@@ -177,7 +190,7 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
     {
       envpc = envc + SCHED_ENVIRON_RESERVED + 2;
 
-      envp = group_realloc(group, group->tg_envp, sizeof(*envp) * envpc);
+      envp = env_realloc(group, group->tg_envp, envpc);
       if (envp == NULL)
         {
           ret = ENOMEM;
@@ -188,15 +201,22 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
       group->tg_envpc = envpc;
     }
 
-  /* Save the new buffer and count */
-
-  group->tg_envp[envc++] = pvar;
-  group->tg_envp[envc]   = NULL;
-  group->tg_envc = envc;
-
   /* Now, put the new name=value string into the environment buffer */
 
   snprintf(pvar, varlen, "%s=%s", name, value);
+
+  /* Save the new buffer and count */
+
+  group->tg_envp[envc] = pvar;
+  if (env_hashadd(group, envc) < 0)
+    {
+      group->tg_envp[envc] = NULL;
+      ret = ENOMEM;
+      goto errout_with_var;
+    }
+
+  group->tg_envp[++envc] = NULL;
+  group->tg_envc = envc;
   leave_critical_section(flags);
   return OK;
 
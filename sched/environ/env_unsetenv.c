@@ -81,7 +81,16 @@ int unsetenv(FAR const char *name)
   flags = enter_critical_section();
   if (group && (idx = env_findvar(group, name)) >= 0)
     {
-      /* It does!  Remove the name=value pair from the environment. */
+      /* It does!  Remove the name=value pair from the environment, from
+       * a private copy if the environment is shared.
+       */
+
+      if (env_unshare(group) < 0)
+        {
+          leave_critical_section(flags);
+          set_errno(ENOMEM);
+          return ERROR;
+        }
 
       env_removevar(group, idx);
     }
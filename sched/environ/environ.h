@@ -28,6 +28,10 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdbool.h>
+
+#include <nuttx/kmalloc.h>
 #include <nuttx/sched.h>
 
 /****************************************************************************
@@ -41,6 +45,21 @@
 
 #  define SCHED_ENVIRON_RESERVED (4)
 
+/* Without the hash table the environment is a plain array */
+
+#  ifndef CONFIG_SCHED_ENVIRON_HASH
+#    define env_alloc(group, envpc) \
+       group_malloc(group, sizeof(FAR char *) * (envpc))
+#    define env_realloc(group, envp, envpc) \
+       group_realloc(group, envp, sizeof(FAR char *) * (envpc))
+#    define env_free(group, envp)      group_free(group, envp)
+#    define env_hashadd(group, index)  (0)
+#    define env_hashdel(group, index)  ((void)0)
+#    define env_share(group, envcp)    (false)
+#    define env_unshare(group)         (0)
+#    define env_unref(group)           (false)
+#  endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -149,6 +168,83 @@ ssize_t env_findvar(FAR struct task_group_s *group, FAR const char *pname);
 
 void env_removevar(FAR struct task_group_s *group, ssize_t index);
 
+#ifdef CONFIG_SCHED_ENVIRON_HASH
+
+/****************************************************************************
+ * Name: env_alloc, env_realloc and env_free
+ *
+ * Description:
+ *   Allocate, resize and free the environment array of a group together
+ *   with the hash table of its names.  The strings are not freed.
+ *
+ ****************************************************************************/
+
+FAR char **env_alloc(FAR struct task_group_s *group, ssize_t envpc);
+FAR char **env_realloc(FAR struct task_group_s *group, FAR char **envp,
+                       ssize_t envpc);
+void env_free(FAR struct task_group_s *group, FAR char **envp);
+
+/****************************************************************************
+ * Name: env_hashadd and env_hashdel
+ *
+ * Description:
+ *   Add or remove the name=value string at index of the environment of the
+ *   group to or from the hash table.  The string must be in place.
+ *
+ ****************************************************************************/
+
+int env_hashadd(FAR struct task_group_s *group, ssize_t index);
+void env_hashdel(FAR struct task_group_s *group, ssize_t index);
+
+/****************************************************************************
+ * Name: env_share
+ *
+ * Description:
+ *   Let a new group share the environment of the current group instead of
+ *   copying it, if envcp is that environment.
+ *
+ * Returned Value:
+ *   true if the environment is shared.
+ *
+ * Assumptions:
+ *   Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+bool env_share(FAR struct task_group_s *group, FAR char * const *envcp);
+
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Give the group of the current task a private copy of its environment
+ *   if it is shared.  This must be done before the environment is changed.
+ *
+ * Returned Value:
+ *   Zero on success, -ENOMEM if the copy cannot be allocated.
+ *
+ * Assumptions:
+ *   Pre-emption is disabled by caller
+ *
+ ****************************************************************************/
+
+int env_unshare(FAR struct task_group_s *group);
+
+/****************************************************************************
+ * Name: env_unref
+ *
+ * Description:
+ *   Drop the reference of a group that leaves its environment.
+ *
+ * Returned Value:
+ *   true if other groups still use the environment.
+ *
+ ****************************************************************************/
+
+bool env_unref(FAR struct task_group_s *group);
+
+#endif /* CONFIG_SCHED_ENVIRON_HASH */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
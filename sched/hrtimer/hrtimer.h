@@ -31,6 +31,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/hrtimer.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_HRTIMER
 
@@ -91,37 +92,14 @@ void hrtimer_process(uint64_t now);
  * Inline Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: hrtimer_gettime
- *
- * Description:
- *   Get the current high-resolution time in nanoseconds.
- *
- * Returned Value:
- *   Current time in nanoseconds.
- ****************************************************************************/
-
-static inline_function
-uint64_t hrtimer_gettime(void)
-{
-  struct timespec ts;
-
-  /* Get current time from platform-specific timer */
-
-  clock_systime_timespec(&ts);
-
-  /* Convert timespec to nanoseconds */
-
-  return clock_time2nsec(&ts);
-}
-
 /****************************************************************************
  * Name: hrtimer_starttimer
  *
  * Description:
  *   Start the hardware timer to expire at a specified nanosecond time.
  *   Converts the nanosecond time to timespec and calls the platform-specific
- *   timer start function.
+ *   timer start function.  The hrtimer owns the timer of the tickless OS,
+ *   the watchdogs are run by one hrtimer of their own.
  *
  * Input Parameters:
  *   ns - Expiration time in nanoseconds.
@@ -134,19 +112,20 @@ static inline_function
 int hrtimer_starttimer(uint64_t ns)
 {
   struct timespec ts;
-  int ret;
 
+#ifdef CONFIG_SCHED_TICKLESS_ALARM
   /* Convert nanoseconds to timespec */
 
   clock_nsec2time(&ts, ns);
+  return up_alarm_start(&ts);
+#else
+  uint64_t now = hrtimer_gettime();
 
-#ifdef CONFIG_ALARM_ARCH
-  ret = up_alarm_start(&ts);
-#elif defined(CONFIG_TIMER_ARCH)
-  ret = up_timer_start(&ts);
-#endif
+  /* The interval timer takes the time relative to now */
 
-  return ret;
+  clock_nsec2time(&ts, ns > now ? ns - now : 0);
+  return up_timer_start(&ts);
+#endif
 }
 
 /****************************************************************************
@@ -255,8 +234,9 @@ static inline_function FAR hrtimer_t *hrtimer_get_first(void)
  *   expiring timer in the RB-tree.
  *
  *   In a red-black tree ordered by expiration time, the earliest timer
- *   is represented by the left-most node. Therefore, a timer is the
- *   earliest one if it has no left child.
+ *   is represented by the left-most node.  A node without a left child
+ *   may still be the right child of an earlier one, so the minimum is
+ *   compared explicitly.
  *
  * Input Parameters:
  *   hrtimer - Pointer to the high-resolution timer to be tested.
@@ -268,7 +248,7 @@ static inline_function FAR hrtimer_t *hrtimer_get_first(void)
 
 static inline_function bool hrtimer_is_first(FAR hrtimer_t *hrtimer)
 {
-  return RB_LEFT(&hrtimer->node, entry) == NULL;
+  return hrtimer_get_first() == hrtimer;
 }
 
 #endif /* CONFIG_HRTIMER */
@@ -119,6 +119,7 @@ int hrtimer_cancel(FAR hrtimer_t *hrtimer)
 {
   FAR hrtimer_t *first;
   irqstate_t flags;
+  bool rearm = false;
   int ret = OK;
 
   DEBUGASSERT(hrtimer != NULL);
@@ -129,6 +130,7 @@ int hrtimer_cancel(FAR hrtimer_t *hrtimer)
 
   if (hrtimer_is_armed(hrtimer))
     {
+      rearm = hrtimer_is_first(hrtimer);
       hrtimer_remove(hrtimer);
     }
 
@@ -140,7 +142,7 @@ int hrtimer_cancel(FAR hrtimer_t *hrtimer)
 
   /* If the canceled timer was the earliest one, update the hardware timer */
 
-  if (hrtimer_is_first(hrtimer))
+  if (rearm)
     {
       first = hrtimer_get_first();
       if (first != NULL)
@@ -0,0 +1,167 @@
+/****************************************************************************
+ * sched/hrtimer/hrtimer_gettime.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#include <nuttx/clock.h>
+
+#include "hrtimer/hrtimer.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_gettime
+ *
+ * Description:
+ *   Get the current high-resolution time in nanoseconds.
+ *
+ * Returned Value:
+ *   Current time in nanoseconds.
+ ****************************************************************************/
+
+uint64_t hrtimer_gettime(void)
+{
+  struct timespec ts;
+
+  /* Get current time from platform-specific timer */
+
+  clock_systime_timespec(&ts);
+
+  /* Convert timespec to nanoseconds */
+
+  return clock_time2nsec(&ts);
+}
+
+/****************************************************************************
+ * Name: hrtimer_abstime2ns
+ *
+ * Description:
+ *   Convert an absolute time of clock 'clockid' to the hrtimer time base.
+ *   The time is converted through its distance from the current time of
+ *   the clock, so that it works for CLOCK_REALTIME as well.
+ *
+ * Input Parameters:
+ *   clockid - The clock the time is measured against
+ *   abstime - The absolute time to convert
+ *
+ * Returned Value:
+ *   The absolute expiration time in nanoseconds.  A time in the past is
+ *   converted to the current time.
+ *
+ * Assumptions:
+ *   Interrupts should be disabled so that the time is not changing during
+ *   the calculation
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_abstime2ns(clockid_t clockid,
+                            FAR const struct timespec *abstime)
+{
+  struct timespec reltime;
+  uint64_t now = hrtimer_gettime();
+
+  nxclock_gettime(clockid, &reltime);
+  if (clock_timespec_compare(abstime, &reltime) <= 0)
+    {
+      return now;
+    }
+
+  clock_timespec_subtract(abstime, &reltime, &reltime);
+  return now + clock_time2nsec(&reltime);
+}
+
+/****************************************************************************
+ * Name: hrtimer_gettimeout
+ *
+ * Description:
+ *   Return the time remaining until an armed timer expires.
+ *
+ * Input Parameters:
+ *   hrtimer - Timer instance to query
+ *
+ * Returned Value:
+ *   The remaining time in nanoseconds, or zero if the timer is not armed
+ *   or is already due.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettimeout(FAR hrtimer_t *hrtimer)
+{
+  irqstate_t flags;
+  uint64_t expired = 0;
+  uint64_t now;
+
+  flags = spin_lock_irqsave(&g_hrtimer_spinlock);
+
+  if (hrtimer_is_armed(hrtimer))
+    {
+      expired = hrtimer->softexpired;
+    }
+
+  spin_unlock_irqrestore(&g_hrtimer_spinlock, flags);
+
+  now = hrtimer_gettime();
+  return clock_compare(expired, now) ? 0 : expired - now;
+}
+
+/****************************************************************************
+ * Name: hrtimer_gettimeout_next
+ *
+ * Description:
+ *   Return the time remaining until the earliest armed timer may expire.
+ *
+ * Returned Value:
+ *   The remaining time in nanoseconds, zero if that timer is already due
+ *   or UINT64_MAX if no timer is armed.
+ *
+ ****************************************************************************/
+
+uint64_t hrtimer_gettimeout_next(void)
+{
+  FAR hrtimer_t *first;
+  irqstate_t flags;
+  uint64_t expired = 0;
+  uint64_t now;
+
+  flags = spin_lock_irqsave(&g_hrtimer_spinlock);
+
+  first = hrtimer_get_first();
+  if (first != NULL)
+    {
+      expired = first->softexpired;
+    }
+
+  spin_unlock_irqrestore(&g_hrtimer_spinlock, flags);
+
+  if (first == NULL)
+    {
+      return UINT64_MAX;
+    }
+
+  now = hrtimer_gettime();
+  return clock_compare(expired, now) ? 0 : expired - now;
+}
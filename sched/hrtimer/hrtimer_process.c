@@ -42,7 +42,9 @@
  *   Process all expired high-resolution timers. This function repeatedly
  *   retrieves the earliest timer from the active timer RB-tree, checks if it
  *   has expired relative to the current time, removes it from the tree,
- *   and invokes its callback function. Processing continues until:
+ *   and invokes its callback function.  A timer started with a slack has
+ *   expired as soon as its earliest expiration time is reached, so it runs
+ *   in the wakeup of an earlier timer.  Processing continues until:
  *
  *     1. No additional timers have expired, or
  *     2. The active timer set is empty.
@@ -98,7 +100,7 @@ void hrtimer_process(uint64_t now)
 
       /* Check if the timer has expired */
 
-      if (!clock_compare(expired, now))
+      if (!clock_compare(hrtimer->softexpired, now))
         {
           break;
         }
@@ -133,7 +135,8 @@ void hrtimer_process(uint64_t now)
 
       if (period > 0 && hrtimer->expired == expired)
         {
-          hrtimer->expired += period;
+          hrtimer->expired     += period;
+          hrtimer->softexpired += period;
 
           /* Ensure no overflow occurs */
 
@@ -31,21 +31,60 @@
 
 #include "hrtimer/hrtimer.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: hrtimer_coalesce
+ *
+ * Description:
+ *   Return the expiration time of the earliest armed timer that expires in
+ *   [softexpired, expired], or 'expired' if there is none.  Expiring at the
+ *   same time as that timer lets both share one wakeup.
+ *
+ ****************************************************************************/
+
+static inline_function uint64_t hrtimer_coalesce(uint64_t softexpired,
+                                                 uint64_t expired)
+{
+  FAR hrtimer_t *next;
+  hrtimer_t key;
+
+  if (softexpired == expired)
+    {
+      return expired;
+    }
+
+  key.expired = softexpired;
+  next = (FAR hrtimer_t *)RB_NFIND(hrtimer_tree_s, &g_hrtimer_tree,
+                                   &key.node);
+  if (next != NULL && clock_compare(next->expired, expired))
+    {
+      return next->expired;
+    }
+
+  return expired;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: hrtimer_start
+ * Name: hrtimer_start_range
  *
  * Description:
  *   Start a high-resolution timer to expire after a specified duration
- *   in nanoseconds, either as an absolute or relative time.
+ *   in nanoseconds, either as an absolute or relative time.  The timer
+ *   may expire up to 'slack' nanoseconds late, which is used to run it
+ *   together with another timer.
  *
  * Input Parameters:
  *   hrtimer - Pointer to the hrtimer structure.
  *   expired - Expiration time in nanoseconds. Interpretation
  *             depends on mode.
+ *   slack   - The acceptable delay of the expiration in nanoseconds.
  *   mode    - Timer mode (HRTIMER_MODE_ABS or HRTIMER_MODE_REL).
  *
  * Returned Value:
@@ -59,9 +98,8 @@
  *     nanoseconds from the current time.
  ****************************************************************************/
 
-int hrtimer_start(FAR hrtimer_t *hrtimer,
-                  uint64_t expired,
-                  enum hrtimer_mode_e mode)
+int hrtimer_start_range(FAR hrtimer_t *hrtimer, uint64_t expired,
+                        uint64_t slack, enum hrtimer_mode_e mode)
 {
   irqstate_t flags;
   int ret = OK;
@@ -81,16 +119,24 @@ int hrtimer_start(FAR hrtimer_t *hrtimer,
 
   if (mode == HRTIMER_MODE_ABS)
     {
-      hrtimer->expired = expired;
+      hrtimer->softexpired = expired;
     }
   else
     {
-      hrtimer->expired = hrtimer_gettime() + expired;
+      hrtimer->softexpired = hrtimer_gettime() + expired;
     }
 
   /* Ensure expiration time does not overflow */
 
-  DEBUGASSERT(hrtimer->expired >= expired);
+  DEBUGASSERT(hrtimer->softexpired >= expired);
+  DEBUGASSERT(hrtimer->softexpired + slack >= slack);
+
+  /* The timer is queued by the latest time it may expire, but it is run
+   * by any wakeup after its earliest time.
+   */
+
+  hrtimer->expired = hrtimer_coalesce(hrtimer->softexpired,
+                                      hrtimer->softexpired + slack);
 
   /* Insert the timer into the RB-tree */
 
@@ -121,4 +121,24 @@ void nx_idle_trampoline(void);
 
 int nx_bringup(void);
 
+/****************************************************************************
+ * Name: nxinit_start
+ *
+ * Description:
+ *   Start the asynchronous initialization steps submitted so far with
+ *   nxinit_async().  Called by nx_bringup() once the low priority work
+ *   queue is running, the steps submitted later start right away.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_ASYNCINIT
+void nxinit_start(void);
+#endif
+
 #endif /* __SCHED_INIT_INIT_H */
@@ -0,0 +1,232 @@
+/****************************************************************************
+ * sched/init/nx_asyncinit.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/wqueue.h>
+
+#include "init/init.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sq_queue_t g_initpending;        /* Submitted, waiting for deps */
+static int g_initactive;                /* Submitted and not yet done */
+static int g_initresult;                /* First failure */
+static bool g_initstarted;              /* The work queues are up */
+static spinlock_t g_initlock = SP_UNLOCKED;
+static sem_t g_initsem = SEM_INITIALIZER(0);
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void nxinit_worker(FAR void *arg);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static bool nxinit_ready(FAR struct nxinit_s *init)
+{
+  FAR struct nxinit_s * const *dep;
+
+  for (dep = init->deps; dep != NULL && *dep != NULL; dep++)
+    {
+      if (!(*dep)->done)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/* Move every step whose dependencies are done to the work queue */
+
+static void nxinit_kick(void)
+{
+  FAR struct nxinit_s *init;
+  FAR sq_entry_t *node;
+  FAR sq_entry_t *next;
+  sq_queue_t ready;
+  irqstate_t flags;
+
+  sq_init(&ready);
+
+  flags = spin_lock_irqsave(&g_initlock);
+  if (g_initstarted)
+    {
+      for (node = sq_peek(&g_initpending); node != NULL; node = next)
+        {
+          next = sq_next(node);
+          init = container_of(node, struct nxinit_s, node);
+          if (nxinit_ready(init))
+            {
+              sq_rem(node, &g_initpending);
+              sq_addlast(node, &ready);
+            }
+        }
+    }
+
+  spin_unlock_irqrestore(&g_initlock, flags);
+
+  while ((node = sq_remfirst(&ready)) != NULL)
+    {
+      init = container_of(node, struct nxinit_s, node);
+      work_queue(LPWORK, &init->work, nxinit_worker, init, 0);
+    }
+}
+
+static void nxinit_worker(FAR void *arg)
+{
+  FAR struct nxinit_s *init = arg;
+  irqstate_t flags;
+  clock_t begin;
+
+  sinfo("Starting %s\n", init->name);
+
+  begin        = perf_gettime();
+  init->result = init->func(init->arg);
+  nxboot_record(init->name, begin, perf_gettime());
+
+  if (init->result < 0)
+    {
+      serr("ERROR: %s failed: %d\n", init->name, init->result);
+    }
+
+  flags = spin_lock_irqsave(&g_initlock);
+  init->done = true;
+  g_initactive--;
+  if (init->result < 0 && g_initresult == OK)
+    {
+      g_initresult = init->result;
+    }
+
+  spin_unlock_irqrestore(&g_initlock, flags);
+
+  /* Start what was waiting for this step, then tell nxinit_wait() */
+
+  nxinit_kick();
+  nxsem_post(&g_initsem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxinit_async
+ *
+ * Description:
+ *   Submit an initialization step and start it as soon as the work queues
+ *   are up and its dependencies are done.
+ *
+ ****************************************************************************/
+
+void nxinit_async(FAR struct nxinit_s *init)
+{
+  FAR struct nxinit_s * const *dep;
+  irqstate_t flags;
+
+  DEBUGASSERT(init != NULL && init->func != NULL && !init->queued);
+
+  for (dep = init->deps; dep != NULL && *dep != NULL; dep++)
+    {
+      DEBUGASSERT((*dep)->queued);
+    }
+
+  init->result = OK;
+  init->done   = false;
+  init->queued = true;
+
+  flags = spin_lock_irqsave(&g_initlock);
+  sq_addlast(&init->node, &g_initpending);
+  g_initactive++;
+  spin_unlock_irqrestore(&g_initlock, flags);
+
+  nxinit_kick();
+}
+
+/****************************************************************************
+ * Name: nxinit_start
+ *
+ * Description:
+ *   Start the steps submitted so far, called once the low priority work
+ *   queue is running.
+ *
+ ****************************************************************************/
+
+void nxinit_start(void)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_initlock);
+  g_initstarted = true;
+  spin_unlock_irqrestore(&g_initlock, flags);
+
+  nxinit_kick();
+}
+
+/****************************************************************************
+ * Name: nxinit_wait
+ *
+ * Description:
+ *   Wait until all submitted steps are done.
+ *
+ ****************************************************************************/
+
+int nxinit_wait(void)
+{
+  irqstate_t flags;
+  int ret;
+
+  DEBUGASSERT(g_initstarted);
+
+  for (; ; )
+    {
+      flags = spin_lock_irqsave(&g_initlock);
+      if (g_initactive == 0)
+        {
+          ret = g_initresult;
+          spin_unlock_irqrestore(&g_initlock, flags);
+          return ret;
+        }
+
+      spin_unlock_irqrestore(&g_initlock, flags);
+      nxsem_wait_uninterruptible(&g_initsem);
+    }
+}
@@ -0,0 +1,112 @@
+/****************************************************************************
+ * sched/init/nx_boottrace.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/init.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct boottrace_s g_boottrace[CONFIG_SCHED_BOOTTRACE_NENTRIES];
+static int g_nboottrace;
+static clock_t g_bootlast;
+static spinlock_t g_bootlock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxboot_record
+ *
+ * Description:
+ *   Record a phase with explicit begin and end times, for work that does
+ *   not run on the boot thread.
+ *
+ ****************************************************************************/
+
+void nxboot_record(FAR const char *name, clock_t begin, clock_t end)
+{
+  FAR struct boottrace_s *entry;
+  irqstate_t flags;
+
+  /* The entry is filled in before it is counted, so that a reader never
+   * sees a half written one.  Phases that do not fit are dropped.
+   */
+
+  flags = spin_lock_irqsave(&g_bootlock);
+  if (g_nboottrace < CONFIG_SCHED_BOOTTRACE_NENTRIES)
+    {
+      entry        = &g_boottrace[g_nboottrace];
+      entry->name  = name;
+      entry->begin = begin;
+      entry->end   = end;
+      entry->cpu   = this_cpu();
+      g_nboottrace++;
+    }
+
+  spin_unlock_irqrestore(&g_bootlock, flags);
+}
+
+/****************************************************************************
+ * Name: nxboot_mark
+ *
+ * Description:
+ *   Record that the sequential boot has completed the named phase, which
+ *   began where the previous one ended.
+ *
+ ****************************************************************************/
+
+void nxboot_mark(FAR const char *name)
+{
+  clock_t now = perf_gettime();
+
+  nxboot_record(name, g_bootlast, now);
+  g_bootlast = now;
+}
+
+/****************************************************************************
+ * Name: nxboot_trace
+ *
+ * Description:
+ *   Return the recorded phases and their number in *count.
+ *
+ ****************************************************************************/
+
+FAR const struct boottrace_s *nxboot_trace(FAR int *count)
+{
+  irqstate_t flags;
+
+  flags  = spin_lock_irqsave(&g_bootlock);
+  *count = g_nboottrace;
+  spin_unlock_irqrestore(&g_bootlock, flags);
+  return g_boottrace;
+}
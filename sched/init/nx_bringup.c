@@ -319,6 +319,19 @@ static inline void nx_start_application(void)
    */
 
   board_late_initialize();
+  nxboot_mark("board_late");
+#endif
+
+#ifdef CONFIG_SCHED_ASYNCINIT
+  /* The application may rely on anything initialized in the background */
+
+  ret = nxinit_wait();
+  if (ret < 0)
+    {
+      serr("ERROR: Asynchronous initialization failed: %d\n", ret);
+    }
+
+  nxboot_mark("async_wait");
 #endif
 
 #ifdef CONFIG_COREDUMP
@@ -385,6 +398,7 @@ static inline void nx_start_application(void)
 #endif
   posix_spawnattr_destroy(&attr);
   DEBUGASSERT(ret > 0);
+  nxboot_mark("init");
 #endif /* CONFIG_INIT_NONE */
 }
 
@@ -529,6 +543,14 @@ int nx_bringup(void)
 
   nx_workqueues();
 
+#ifdef CONFIG_SCHED_ASYNCINIT
+  /* Now the initialization steps submitted so far can run */
+
+  nxinit_start();
+#endif
+
+  nxboot_mark("bringup");
+
   /* Once the operating system has been initialized, the system must be
    * started by spawning the user initialization thread of execution.  This
    * will be the first user-mode thread.
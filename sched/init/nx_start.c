@@ -117,6 +117,14 @@ FAR struct tcb_s *g_assignedtasks[CONFIG_SMP_NCPUS];
 enum task_deliver_e g_delivertasks[CONFIG_SMP_NCPUS];
 #endif
 
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+/* With CONFIG_SMP_PERCPU_RUNQUEUE, each CPU keeps the ready-to-run tasks
+ * that are not running in its own run queue instead of g_readytorun.
+ */
+
+struct runqueue_s g_runqueue[CONFIG_SMP_NCPUS];
+#endif
+
 /* g_running_tasks[] holds a references to the running task for each CPU.
  * It is valid only when up_interrupt_context() returns true.
  */
@@ -617,6 +625,7 @@ void nx_start(void)
   /* The memory manager is available */
 
   g_nx_initstate = OSINIT_MEMORY;
+  nxboot_mark("memory");
 
   /* Initialize tasking data structures */
 
@@ -629,6 +638,7 @@ void nx_start(void)
   /* Initialize the file system (needed to support device drivers) */
 
   fs_initialize();
+  nxboot_mark("fs");
 
   /* Initialize the interrupt handling subsystem (if included) */
 
@@ -652,10 +662,13 @@ void nx_start(void)
   nxmq_initialize();
 #endif
 
+  nxboot_mark("ipc");
+
 #ifdef CONFIG_NET
   /* Initialize the networking system */
 
   net_initialize();
+  nxboot_mark("net");
 #endif
 
 #ifndef CONFIG_BINFMT_DISABLE
@@ -673,10 +686,12 @@ void nx_start(void)
    */
 
   up_initialize();
+  nxboot_mark("arch");
 
   /* Initialize common drivers */
 
   drivers_initialize();
+  nxboot_mark("drivers");
 
 #ifdef CONFIG_BOARD_EARLY_INITIALIZE
   /* Call the board-specific up_initialize() extension to support
@@ -685,6 +700,7 @@ void nx_start(void)
    */
 
   board_early_initialize();
+  nxboot_mark("board_early");
 #endif
 
   /* Hardware resources are now available */
@@ -728,6 +744,7 @@ void nx_start(void)
   /* Then start the other CPUs */
 
   DEBUGVERIFY(nx_smp_start());
+  nxboot_mark("smp");
 
 #endif /* CONFIG_SMP */
 
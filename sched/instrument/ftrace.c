@@ -0,0 +1,418 @@
+/****************************************************************************
+ * sched/instrument/ftrace.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/allsyms.h>
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/ftrace.h>
+#include <nuttx/instrument.h>
+#include <nuttx/irq.h>
+#include <nuttx/mutex.h>
+#include <nuttx/symtab.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_FTRACE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FTRACE_NENTRIES  CONFIG_SCHED_FTRACE_NENTRIES
+#define FTRACE_NFILTERS  CONFIG_SCHED_FTRACE_FILTERS
+#define FTRACE_DEPTH     CONFIG_SCHED_FTRACE_GRAPH_DEPTH
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The records of one CPU.  Only that CPU writes them, with its interrupts
+ * disabled, the oldest ones are overwritten.
+ */
+
+struct ftrace_cpu_s
+{
+  size_t head;                                /* Records written */
+  bool   busy;                                /* Recording, not reentered */
+  struct ftrace_entry_s entries[FTRACE_NENTRIES];
+};
+
+/* An address range that is traced, or never traced */
+
+struct ftrace_filter_s
+{
+  uintptr_t start;
+  uintptr_t end;
+  bool      notrace;
+};
+
+struct ftrace_s
+{
+  volatile bool on;
+  volatile bool graph;
+  atomic_t      paused;
+  volatile int  nfilters;                     /* Published filters */
+  bool          include;                      /* Some are not notrace */
+  mutex_t       lock;                         /* Serializes the commands */
+  struct ftrace_filter_s filters[FTRACE_NFILTERS];
+  struct ftrace_cpu_s cpus[CONFIG_SMP_NCPUS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void ftrace_enter(FAR void *this_fn, FAR void *call_site,
+                         FAR void *arg) noinstrument_function;
+static void ftrace_leave(FAR void *this_fn, FAR void *call_site,
+                         FAR void *arg) noinstrument_function;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct ftrace_s g_ftrace =
+{
+  .lock = NXMUTEX_INITIALIZER,
+};
+
+static struct instrument_s g_ftrace_instrument =
+{
+  .enter = ftrace_enter,
+  .leave = ftrace_leave,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftrace_traced
+ ****************************************************************************/
+
+static inline_function noinstrument_function
+bool ftrace_traced(uintptr_t func)
+{
+  FAR struct ftrace_filter_s *filter;
+  bool traced = !g_ftrace.include;
+  int i;
+
+  for (i = 0; i < g_ftrace.nfilters; i++)
+    {
+      filter = &g_ftrace.filters[i];
+      if (func >= filter->start && func < filter->end)
+        {
+          if (filter->notrace)
+            {
+              return false;
+            }
+
+          traced = true;
+        }
+    }
+
+  return traced;
+}
+
+/****************************************************************************
+ * Name: ftrace_record
+ ****************************************************************************/
+
+static inline_function noinstrument_function
+void ftrace_record(uintptr_t func, uintptr_t call_site, bool enter)
+{
+  FAR struct ftrace_entry_s *entry;
+  FAR struct ftrace_cpu_s *cpu;
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  clock_t now;
+  uint8_t depth;
+
+  if (!g_ftrace.on || atomic_read(&g_ftrace.paused) != 0 ||
+      !ftrace_traced(func))
+    {
+      return;
+    }
+
+  flags = up_irq_save();
+  cpu   = &g_ftrace.cpus[this_cpu()];
+  tcb   = running_task();
+
+  if (cpu->busy || tcb == NULL)
+    {
+      up_irq_restore(flags);
+      return;
+    }
+
+  cpu->busy = true;
+  now       = up_perf_gettime();
+
+  /* The depth counts the traced functions the task is in, the stack of
+   * their entries gives the durations in graph mode.  An exit that does
+   * not match the stack was entered before tracing started.
+   */
+
+  if (enter)
+    {
+      depth = tcb->ftrace_depth;
+      if (depth < FTRACE_DEPTH)
+        {
+          tcb->ftrace_func[depth] = func;
+          tcb->ftrace_time[depth] = now;
+        }
+
+      if (depth < UINT8_MAX)
+        {
+          tcb->ftrace_depth++;
+        }
+    }
+  else
+    {
+      depth = tcb->ftrace_depth;
+      if (depth == 0)
+        {
+          goto out;
+        }
+
+      tcb->ftrace_depth = --depth;
+    }
+
+  if (g_ftrace.graph)
+    {
+      /* Only the exits are recorded, with the time of their entry */
+
+      if (enter || depth >= FTRACE_DEPTH || tcb->ftrace_func[depth] != func)
+        {
+          goto out;
+        }
+
+      entry           = &cpu->entries[cpu->head++ % FTRACE_NENTRIES];
+      entry->type     = FTRACE_GRAPH;
+      entry->time     = tcb->ftrace_time[depth];
+      entry->duration = now - tcb->ftrace_time[depth];
+    }
+  else
+    {
+      entry           = &cpu->entries[cpu->head++ % FTRACE_NENTRIES];
+      entry->type     = enter ? FTRACE_ENTER : FTRACE_EXIT;
+      entry->time     = now;
+      entry->duration = 0;
+    }
+
+  entry->func      = func;
+  entry->call_site = call_site;
+  entry->pid       = tcb->pid;
+  entry->depth     = depth;
+
+out:
+  cpu->busy = false;
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: ftrace_enter
+ ****************************************************************************/
+
+static void ftrace_enter(FAR void *this_fn, FAR void *call_site,
+                         FAR void *arg)
+{
+  ftrace_record((uintptr_t)this_fn, (uintptr_t)call_site, true);
+}
+
+/****************************************************************************
+ * Name: ftrace_leave
+ ****************************************************************************/
+
+static void ftrace_leave(FAR void *this_fn, FAR void *call_site,
+                         FAR void *arg)
+{
+  ftrace_record((uintptr_t)this_fn, (uintptr_t)call_site, false);
+}
+
+/****************************************************************************
+ * Name: ftrace_addfilter
+ ****************************************************************************/
+
+static int ftrace_addfilter(FAR const char *arg, bool notrace)
+{
+  FAR struct ftrace_filter_s *filter;
+  FAR char *end;
+  uintptr_t start;
+  uintptr_t stop;
+
+  if (g_ftrace.nfilters >= FTRACE_NFILTERS)
+    {
+      return -ENOSPC;
+    }
+
+  start = strtoul(arg, &end, 0);
+  if (end != arg)
+    {
+      stop = strtoul(end, &end, 0);
+      if (stop <= start)
+        {
+          return -EINVAL;
+        }
+    }
+  else
+    {
+#ifdef CONFIG_ALLSYMS
+      FAR const struct symtab_s *sym;
+      size_t size;
+
+      sym = allsyms_findbyname(arg, &size);
+      if (sym == NULL)
+        {
+          return -ENOENT;
+        }
+
+      start = (uintptr_t)sym->sym_value;
+      stop  = start + MAX(size, 1);
+#else
+      return -EINVAL;
+#endif
+    }
+
+  /* The filter is complete before the tracer sees it */
+
+  filter          = &g_ftrace.filters[g_ftrace.nfilters];
+  filter->start   = start;
+  filter->end     = stop;
+  filter->notrace = notrace;
+
+  if (!notrace)
+    {
+      g_ftrace.include = true;
+    }
+
+  g_ftrace.nfilters++;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ftrace_initialize
+ ****************************************************************************/
+
+void ftrace_initialize(void)
+{
+  instrument_register(&g_ftrace_instrument);
+}
+
+/****************************************************************************
+ * Name: ftrace_command
+ ****************************************************************************/
+
+int ftrace_command(FAR const char *cmd)
+{
+  int ret = OK;
+  int cpu;
+
+  nxmutex_lock(&g_ftrace.lock);
+
+  if (strcmp(cmd, "on") == 0)
+    {
+      g_ftrace.on = true;
+    }
+  else if (strcmp(cmd, "off") == 0)
+    {
+      g_ftrace.on = false;
+    }
+  else if (strcmp(cmd, "function") == 0 || strcmp(cmd, "graph") == 0)
+    {
+      g_ftrace.graph = cmd[0] == 'g';
+    }
+  else if (strncmp(cmd, "filter ", 7) == 0)
+    {
+      ret = ftrace_addfilter(cmd + 7, false);
+    }
+  else if (strncmp(cmd, "notrace ", 8) == 0)
+    {
+      ret = ftrace_addfilter(cmd + 8, true);
+    }
+  else if (strcmp(cmd, "clear") == 0)
+    {
+      g_ftrace.nfilters = 0;
+      g_ftrace.include  = false;
+
+      for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+        {
+          g_ftrace.cpus[cpu].head = 0;
+        }
+    }
+  else
+    {
+      ret = -EINVAL;
+    }
+
+  nxmutex_unlock(&g_ftrace.lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: ftrace_pause
+ ****************************************************************************/
+
+void ftrace_pause(bool pause)
+{
+  atomic_fetch_add(&g_ftrace.paused, pause ? 1 : -1);
+}
+
+/****************************************************************************
+ * Name: ftrace_read
+ ****************************************************************************/
+
+bool ftrace_read(int cpu, FAR size_t *pos, FAR struct ftrace_entry_s *entry)
+{
+  FAR struct ftrace_cpu_s *buf = &g_ftrace.cpus[cpu];
+  size_t head = buf->head;
+  size_t first = head > FTRACE_NENTRIES ? head - FTRACE_NENTRIES : 0;
+
+  if (*pos < first)
+    {
+      *pos = first;
+    }
+
+  if (*pos >= head)
+    {
+      return false;
+    }
+
+  *entry = buf->entries[(*pos)++ % FTRACE_NENTRIES];
+  return true;
+}
+
+#endif /* CONFIG_SCHED_FTRACE */
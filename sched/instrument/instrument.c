@@ -24,6 +24,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/ftrace.h>
 #include <nuttx/instrument.h>
 
 /****************************************************************************
@@ -57,4 +58,8 @@ void instrument_initialize(void)
 #if CONFIG_SCHED_STACK_RECORD > 0
   instrument_register(&g_stack_monitor);
 #endif
+
+#ifdef CONFIG_SCHED_FTRACE
+  ftrace_initialize();
+#endif
 }
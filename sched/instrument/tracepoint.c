@@ -0,0 +1,91 @@
+/****************************************************************************
+ * sched/instrument/tracepoint.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/tracepoint.h>
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#define TRACEPOINT_NAME(id, name) name,
+
+static FAR const char * const g_tracepoint_names[TRACEPOINT_NKEYS] =
+{
+  TRACEPOINT_LIST(TRACEPOINT_NAME)
+};
+
+#undef TRACEPOINT_NAME
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+uint8_t g_tracepoint_keys[TRACEPOINT_NKEYS];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tracepoint_name
+ ****************************************************************************/
+
+FAR const char *tracepoint_name(int id)
+{
+  return id >= 0 && id < TRACEPOINT_NKEYS ? g_tracepoint_names[id] : NULL;
+}
+
+/****************************************************************************
+ * Name: tracepoint_enable
+ *
+ * Description:
+ *   A key is a single byte, a tracepoint that races with the change sees
+ *   either state.
+ *
+ ****************************************************************************/
+
+int tracepoint_enable(FAR const char *name, bool enable)
+{
+  bool all = strcmp(name, "all") == 0;
+  int ret = -ENOENT;
+  int i;
+
+  for (i = 0; i < TRACEPOINT_NKEYS; i++)
+    {
+      if (all || strcmp(name, g_tracepoint_names[i]) == 0)
+        {
+          g_tracepoint_keys[i] = enable;
+          ret = OK;
+        }
+    }
+
+  return ret;
+}
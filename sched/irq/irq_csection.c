@@ -231,7 +231,20 @@ irqstate_t enter_critical_section_wo_note(void)
 
           DEBUGASSERT((g_cpu_irqset & (1 << cpu)) == 0);
 
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+          /* Measure the wait only when the lock is really contended */
+
+          rtcb->crit_wait = 0;
+          if (!spin_trylock_notrace(&g_cpu_irqlock))
+            {
+              clock_t start = perf_gettime();
+
+              spin_lock_notrace(&g_cpu_irqlock);
+              rtcb->crit_wait = perf_gettime() - start;
+            }
+#else
           spin_lock_notrace(&g_cpu_irqlock);
+#endif
 
           /* Then set the lock count to 1.
            *
@@ -32,6 +32,7 @@
 #include <nuttx/mm/mm.h>
 #include <nuttx/random.h>
 #include <nuttx/sched_note.h>
+#include <nuttx/tracepoint.h>
 
 #include "irq/irq.h"
 #include "clock/clock.h"
@@ -47,6 +48,14 @@
 #  define NUSER_IRQS NR_IRQS
 #endif
 
+/* IRQ_LATENCY - Count the run time of a handler in the latency histogram */
+
+#ifdef CONFIG_SCHED_LATENCY
+#  define IRQ_LATENCY(elapsed) nxsched_latency_add(SCHED_LATENCY_IRQ, elapsed)
+#else
+#  define IRQ_LATENCY(elapsed)
+#endif
+
 /* CALL_VECTOR - Call the interrupt service routine attached to this
  * interrupt request
  */
@@ -60,6 +69,7 @@
          start = perf_gettime(); \
          vector(irq, context, arg); \
          elapsed = perf_gettime() - start; \
+         IRQ_LATENCY(elapsed); \
          if (ndx < NUSER_IRQS) \
            { \
              g_irqvector[ndx].count++; \
@@ -76,6 +86,15 @@
            } \
        } \
      while (0)
+#elif defined(CONFIG_SCHED_LATENCY)
+#  define CALL_VECTOR(ndx, vector, irq, context, arg) \
+     do \
+       { \
+         clock_t start = perf_gettime(); \
+         vector(irq, context, arg); \
+         IRQ_LATENCY(perf_gettime() - start); \
+       } \
+     while (0)
 #else
 #  define CALL_VECTOR(ndx, vector, irq, context, arg) \
      vector(irq, context, arg)
@@ -139,6 +158,8 @@ void irq_dispatch(int irq, FAR void *context)
   sched_note_irqhandler(irq, vector, true);
 #endif
 
+  tracepoint(IRQ_DISPATCH, NOTE_TAG_SCHED, "irq %d", irq);
+
   /* Then dispatch to the interrupt handler */
 
   CALL_VECTOR(ndx, vector, irq, context, arg);
@@ -35,6 +35,32 @@
 
 #if defined(CONFIG_SPINLOCK)
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_QUEUED_SPINLOCK
+
+/* The place in the queue of a CPU that waits for a queued spinlock.  Each
+ * is on a cache line of its own, the spinning CPU only reads its node.
+ */
+
+struct spin_qnode_s
+{
+  FAR struct spin_qnode_s *volatile next  /* The next waiter */
+                          aligned_data(64);
+  volatile uint32_t locked;               /* The previous waiter is done */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_QUEUED_SPINLOCK
+static struct spin_qnode_s g_spin_qnodes[CONFIG_SMP_NCPUS];
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -43,6 +69,108 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: spin_lock_queued
+ *
+ * Description:
+ *   The slow path of spin_lock() with CONFIG_QUEUED_SPINLOCK, the lock was
+ *   found taken.  Append the node of this CPU to the waiters, wait until
+ *   the previous waiter hands over the head of the queue and then until
+ *   the owner releases the lock.
+ *
+ *   The interrupts are disabled until the lock is taken, so that each CPU
+ *   waits for one lock at a time and one node per CPU is enough.
+ *
+ * Input Parameters:
+ *   lock - A reference to the spinlock object to lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_QUEUED_SPINLOCK
+void spin_lock_queued(FAR volatile spinlock_t *lock)
+{
+  FAR struct spin_qnode_s *node;
+  FAR struct spin_qnode_s *next;
+  irqstate_t flags;
+  uint32_t tail;
+  uint32_t val;
+  int cpu;
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+  node  = &g_spin_qnodes[cpu];
+  tail  = (uint32_t)(cpu + 1) << SP_QUEUED_TAIL_SHIFT;
+
+  node->next   = NULL;
+  node->locked = 0;
+
+  /* Become the tail of the queue, unless the lock was released meanwhile */
+
+  val = atomic_read(&lock->val);
+  for (; ; )
+    {
+      if (val == 0)
+        {
+          if (atomic_cmpxchg(&lock->val, &val, SP_QUEUED_LOCKED))
+            {
+              up_irq_restore(flags);
+              return;
+            }
+        }
+      else if (atomic_cmpxchg(&lock->val, &val,
+                              (val & SP_QUEUED_LOCKED) | tail))
+        {
+          break;
+        }
+    }
+
+  /* Link behind the previous tail and wait until it is done */
+
+  val >>= SP_QUEUED_TAIL_SHIFT;
+  if (val != 0)
+    {
+      UP_DMB();
+      g_spin_qnodes[val - 1].next = node;
+
+      while (node->locked == 0)
+        {
+          UP_DSB();
+          UP_WFE();
+        }
+
+      UP_DMB();
+    }
+
+  /* This CPU is at the head of the queue, only it waits for the lock */
+
+  while (((val = atomic_read(&lock->val)) & SP_QUEUED_LOCKED) != 0)
+    {
+      UP_DSB();
+      UP_WFE();
+    }
+
+  /* Take the lock and leave the queue if no one is behind, otherwise pass
+   * the head of the queue to the next waiter.
+   */
+
+  if (val != tail || !atomic_cmpxchg(&lock->val, &val, SP_QUEUED_LOCKED))
+    {
+      atomic_fetch_or(&lock->val, SP_QUEUED_LOCKED);
+
+      while ((next = node->next) == NULL)
+        {
+          UP_DMB();
+        }
+
+      next->locked = 1;
+      UP_DSB();
+      UP_SEV();
+    }
+
+  up_irq_restore(flags);
+}
+#endif /* CONFIG_QUEUED_SPINLOCK */
+
 #ifdef CONFIG_RW_SPINLOCK
 
 /****************************************************************************
@@ -251,6 +251,46 @@ static int elf_get_ntcb(void)
   return count;
 }
 
+/****************************************************************************
+ * Name: elf_next_tcb
+ *
+ * Description:
+ *   Iterate over the dumped tasks, index starts at -1.  The faulting task
+ *   goes first, a dump that is cut short by a full device or a
+ *   reset still has its registers and stack.
+ *
+ ****************************************************************************/
+
+static FAR struct tcb_s *elf_next_tcb(FAR struct elf_dumpinfo_s *cinfo,
+                                      FAR int *index)
+{
+  FAR struct tcb_s *rtcb = running_task();
+  FAR struct tcb_s *tcb;
+
+  if (*index < 0)
+    {
+      *index = 0;
+      return cinfo->pid == INVALID_PROCESS_ID ? rtcb :
+             nxsched_get_tcb(cinfo->pid);
+    }
+
+  if (cinfo->pid != INVALID_PROCESS_ID)
+    {
+      return NULL;
+    }
+
+  while (*index < g_npidhash)
+    {
+      tcb = g_pidhash[(*index)++];
+      if (tcb != NULL && tcb != rtcb)
+        {
+          return tcb;
+        }
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Name: elf_get_note_size
  *
@@ -364,21 +404,12 @@ static void elf_emit_tcb_note(FAR struct elf_dumpinfo_s *cinfo,
 
 static void elf_emit_note(FAR struct elf_dumpinfo_s *cinfo)
 {
-  int i;
+  FAR struct tcb_s *tcb;
+  int i = -1;
 
-  if (cinfo->pid == INVALID_PROCESS_ID)
+  while ((tcb = elf_next_tcb(cinfo, &i)) != NULL)
     {
-      for (i = 0; i < g_npidhash; i++)
-        {
-          if (g_pidhash[i] != NULL)
-            {
-              elf_emit_tcb_note(cinfo, g_pidhash[i]);
-            }
-        }
-    }
-  else
-    {
-      elf_emit_tcb_note(cinfo, nxsched_get_tcb(cinfo->pid));
+      elf_emit_tcb_note(cinfo, tcb);
     }
 }
 
@@ -446,21 +477,12 @@ static void elf_emit_tcb_stack(FAR struct elf_dumpinfo_s *cinfo,
 
 static void elf_emit_stack(FAR struct elf_dumpinfo_s *cinfo)
 {
-  int i;
+  FAR struct tcb_s *tcb;
+  int i = -1;
 
-  if (cinfo->pid == INVALID_PROCESS_ID)
-    {
-      for (i = 0; i < g_npidhash; i++)
-        {
-          if (g_pidhash[i] != NULL)
-            {
-              elf_emit_tcb_stack(cinfo, g_pidhash[i]);
-            }
-        }
-    }
-  else
+  while ((tcb = elf_next_tcb(cinfo, &i)) != NULL)
     {
-      elf_emit_tcb_stack(cinfo, nxsched_get_tcb(cinfo->pid));
+      elf_emit_tcb_stack(cinfo, tcb);
     }
 }
 
@@ -618,8 +640,9 @@ static void elf_emit_phdr(FAR struct elf_dumpinfo_s *cinfo,
 {
   off_t offset = cinfo->stream->nput +
                  (stksegs + memsegs + 1 + 1) * sizeof(Elf_Phdr);
+  FAR struct tcb_s *tcb;
   Elf_Phdr phdr;
-  int i;
+  int i = -1;
 
   memset(&phdr, 0, sizeof(Elf_Phdr));
 
@@ -631,20 +654,9 @@ static void elf_emit_phdr(FAR struct elf_dumpinfo_s *cinfo,
   elf_emit(cinfo, &phdr, sizeof(phdr));
 
   phdr.p_align  = ELF_PAGESIZE;
-  if (cinfo->pid == INVALID_PROCESS_ID)
-    {
-      for (i = 0; i < g_npidhash; i++)
-        {
-          if (g_pidhash[i] != NULL)
-            {
-              elf_emit_tcb_phdr(cinfo, g_pidhash[i], &phdr, &offset);
-            }
-        }
-    }
-  else
+  while ((tcb = elf_next_tcb(cinfo, &i)) != NULL)
     {
-      elf_emit_tcb_phdr(cinfo, nxsched_get_tcb(cinfo->pid),
-                        &phdr, &offset);
+      elf_emit_tcb_phdr(cinfo, tcb, &phdr, &offset);
     }
 
   /* Write program headers for segments dump */
@@ -31,6 +31,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/spinlock.h>
 
 #include "mqueue/mqueue.h"
@@ -48,6 +49,7 @@
  *   allocated dynamically it will be deallocated.
  *
  * Input Parameters:
+ *   msgq  - The message queue that the message was allocated for
  *   mqmsg - message to free
  *
  * Returned Value:
@@ -55,10 +57,23 @@
  *
  ****************************************************************************/
 
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg)
 {
   irqstate_t flags;
 
+#ifdef CONFIG_MQ_MSGSLAB
+  /* Messages of the queue's own slab go back to the queue */
+
+  if (mqmsg->type == MQ_ALLOC_SLAB)
+    {
+      flags = spin_lock_irqsave(&msgq->slablock);
+      list_add_tail(&msgq->slab, &mqmsg->node);
+      spin_unlock_irqrestore(&msgq->slablock, flags);
+      return;
+    }
+#endif
+
   /* If this is a generally available pre-allocated message,
    * then just put it back in the free list.
    */
@@ -103,3 +118,27 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
       DEBUGPANIC();
     }
 }
+
+/****************************************************************************
+ * Name: file_mq_return
+ *
+ * Description:
+ *   Hand back a buffer obtained by file_mq_loan() that was not sent, or a
+ *   message received by file_mq_timedreceive_loan() once it has been
+ *   consumed.  This must be done before the queue is closed.
+ *
+ * Input Parameters:
+ *   mq  - Message queue descriptor
+ *   buf - The loaned buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void file_mq_return(FAR struct file *mq, FAR void *buf)
+{
+  DEBUGASSERT(mq != NULL && mq->f_inode != NULL && buf != NULL);
+  nxmq_free_msg(mq->f_inode->i_private,
+                container_of(buf, struct mqueue_msg_s, mail));
+}
@@ -30,12 +30,57 @@
 #include <assert.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/sched.h>
 #include <nuttx/mqueue.h>
 
 #include "sched/sched.h"
 #include "mqueue/mqueue.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of one message of the per queue slab */
+
+#define MQ_SLAB_SIZE(n) ALIGN_UP(MQ_MSG_SIZE(n), sizeof(FAR void *))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_alloc_slab
+ *
+ * Description:
+ *   Put the messages preallocated behind the queue structure on its slab
+ *   free list.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_MSGSLAB
+static void nxmq_alloc_slab(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  FAR uint8_t *block;
+  int i;
+
+  list_initialize(&msgq->slab);
+  spin_lock_init(&msgq->slablock);
+
+  block = (FAR uint8_t *)msgq +
+          ALIGN_UP(sizeof(struct mqueue_inode_s), sizeof(FAR void *));
+
+  for (i = 0; i < msgq->maxmsgs; i++)
+    {
+      mqmsg       = (FAR struct mqueue_msg_s *)block;
+      mqmsg->type = MQ_ALLOC_SLAB;
+      list_add_tail(&msgq->slab, &mqmsg->node);
+      block      += MQ_SLAB_SIZE(msgq->maxmsgsize);
+    }
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -68,6 +113,7 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
                     FAR struct mqueue_inode_s **pmsgq)
 {
   FAR struct mqueue_inode_s *msgq;
+  size_t size = sizeof(struct mqueue_inode_s);
 
   /* Check if the caller is attempting to allocate a message for messages
    * larger than the configured maximum message size.
@@ -79,10 +125,19 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
       return -EINVAL;
     }
 
+#ifdef CONFIG_MQ_MSGSLAB
+  /* The slab holds mq_maxmsg messages of mq_msgsize bytes, so that a full
+   * queue never needs the global message pool or the heap.
+   */
+
+  size  = ALIGN_UP(size, sizeof(FAR void *));
+  size += (attr ? attr->mq_maxmsg : MQ_MAX_MSGS) *
+          MQ_SLAB_SIZE(attr ? attr->mq_msgsize : MQ_MAX_BYTES);
+#endif
+
   /* Allocate memory for the new message queue. */
 
-  msgq = (FAR struct mqueue_inode_s *)
-    kmm_zalloc(sizeof(struct mqueue_inode_s));
+  msgq = (FAR struct mqueue_inode_s *)kmm_zalloc(size);
 
   if (msgq)
     {
@@ -106,6 +161,10 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
 
       dq_init(&msgq->cmn.waitfornotempty);
       dq_init(&msgq->cmn.waitfornotfull);
+
+#ifdef CONFIG_MQ_MSGSLAB
+      nxmq_alloc_slab(msgq);
+#endif
     }
   else
     {
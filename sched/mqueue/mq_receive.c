@@ -37,6 +37,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/mqueue.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/cancelpt.h>
 
 #include "mqueue/mqueue.h"
@@ -104,6 +105,72 @@ static int nxmq_verify_receive(FAR struct file *mq,
 }
 #endif
 
+/****************************************************************************
+ * Name: nxmq_receive_msg
+ *
+ * Description:
+ *   Take the oldest of the highest priority messages off the queue,
+ *   waiting for one if the queue is empty.  The caller then owns the
+ *   message and has to free it.
+ *
+ ****************************************************************************/
+
+static int nxmq_receive_msg(FAR struct file *mq,
+                            FAR struct mqueue_inode_s *msgq,
+                            FAR struct mqueue_msg_s **rcvmsg,
+                            FAR const struct timespec *abstime,
+                            sclock_t ticks)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  irqstate_t flags;
+  int ret;
+
+  /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
+   * because messages can be sent from interrupt level.
+   */
+
+  flags = enter_critical_section();
+
+  /* Get the message from the message queue */
+
+  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msglist);
+  if (mqmsg == NULL)
+    {
+      if ((mq->f_oflags & O_NONBLOCK) != 0)
+        {
+          leave_critical_section(flags);
+          return -EAGAIN;
+        }
+
+      /* Wait & get the message from the message queue */
+
+      ret = nxmq_wait_receive(msgq, &mqmsg, abstime, ticks);
+      if (ret < 0)
+        {
+          leave_critical_section(flags);
+          return ret;
+        }
+    }
+
+  /* If we got message, then decrement the number of messages in
+   * the queue while we are still in the critical section
+   */
+
+  if (msgq->nmsgs-- == msgq->maxmsgs)
+    {
+      nxmq_pollnotify(msgq, POLLOUT);
+    }
+
+  /* Notify all threads waiting for a message in the message queue */
+
+  nxmq_notify_receive(msgq);
+
+  leave_critical_section(flags);
+
+  *rcvmsg = mqmsg;
+  return OK;
+}
+
 /****************************************************************************
  * Name: file_mq_timedreceive_internal
  *
@@ -142,7 +209,6 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 {
   FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *mqmsg;
-  irqstate_t flags;
   ssize_t ret = 0;
 
   DEBUGASSERT(up_interrupt_context() == false);
@@ -173,48 +239,12 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 
   msgq = mq->f_inode->i_private;
 
-  /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
-   * because messages can be sent from interrupt level.
-   */
-
-  flags = enter_critical_section();
-
-  /* Get the message from the message queue */
-
-  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msglist);
-  if (mqmsg == NULL)
-    {
-      if ((mq->f_oflags & O_NONBLOCK) != 0)
-        {
-          leave_critical_section(flags);
-          return -EAGAIN;
-        }
-
-      /* Wait & get the message from the message queue */
-
-      ret = nxmq_wait_receive(msgq, &mqmsg, abstime, ticks);
-      if (ret < 0)
-        {
-          leave_critical_section(flags);
-          return ret;
-        }
-    }
-
-  /* If we got message, then decrement the number of messages in
-   * the queue while we are still in the critical section
-   */
-
-  if (msgq->nmsgs-- == msgq->maxmsgs)
+  ret = nxmq_receive_msg(mq, msgq, &mqmsg, abstime, ticks);
+  if (ret < 0)
     {
-      nxmq_pollnotify(msgq, POLLOUT);
+      return ret;
     }
 
-  /* Notify all threads waiting for a message in the message queue */
-
-  nxmq_notify_receive(msgq);
-
-  leave_critical_section(flags);
-
   /* Return the message to the caller */
 
   if (prio)
@@ -227,7 +257,7 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 
   /* Free the message structure */
 
-  nxmq_free_msg(mqmsg);
+  nxmq_free_msg(msgq, mqmsg);
 
   return ret;
 }
@@ -591,3 +621,65 @@ ssize_t mq_receive(mqd_t mqdes, FAR char *msg, size_t msglen,
   leave_cancellation_point();
   return ret;
 }
+
+/****************************************************************************
+ * Name: file_mq_timedreceive_loan
+ *
+ * Description:
+ *   Receive a message like file_mq_timedreceive(), forever if abstime is
+ *   NULL, but without copying it: *buf is set to the message in the queue
+ *   buffer, which the caller reads in place and then hands back with
+ *   file_mq_return().
+ *
+ * Input Parameters:
+ *   mq      - Message Queue Descriptor
+ *   buf     - The location to return the message
+ *   prio    - If not NULL, the location to store message priority.
+ *   abstime - the absolute time to wait until a timeout is declared.
+ *
+ * Returned Value:
+ *   The length of the message on success, or a negated errno as for
+ *   file_mq_timedreceive().
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_timedreceive_loan(FAR struct file *mq, FAR void **buf,
+                                  FAR unsigned int *prio,
+                                  FAR const struct timespec *abstime)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  ssize_t ret;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  if (abstime && (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000))
+    {
+      return -EINVAL;
+    }
+
+  if (mq == NULL || buf == NULL)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_DEBUG_FEATURES
+  if (mq->f_inode == NULL || (mq->f_oflags & O_RDOK) == 0)
+    {
+      return -EBADF;
+    }
+#endif
+
+  ret = nxmq_receive_msg(mq, mq->f_inode->i_private, &mqmsg, abstime, -1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (prio)
+    {
+      *prio = mqmsg->priority;
+    }
+
+  *buf = mqmsg->mail;
+  return mqmsg->msglen;
+}
@@ -36,6 +36,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/irq.h>
 
@@ -123,20 +124,35 @@ static int nxmq_verify_send(FAR FAR struct file *mq, FAR const char *msg,
  *   the g_msgfreeirq list.  If this is unsuccessful, the calling interrupt
  *   handler will be notified.
  *
+ *   With CONFIG_MQ_MSGSLAB the messages preallocated for the queue itself
+ *   are used first, the lists above only once all of them are in use.
+ *
  * Input Parameters:
- *   None
+ *   msgq    - The message queue the message is for
+ *   msgsize - The payload size needed
  *
  * Returned Value:
- *   A reference to the allocated msg structure.  On a failure to allocate,
- *   this function PANICs.
+ *   A reference to the allocated msg structure, or NULL if no message is
+ *   available.
  *
  ****************************************************************************/
 
-static FAR struct mqueue_msg_s *nxmq_alloc_msg(uint16_t msgsize)
+static FAR struct mqueue_msg_s *
+nxmq_alloc_msg(FAR struct mqueue_inode_s *msgq, uint16_t msgsize)
 {
   FAR struct mqueue_msg_s *mqmsg;
   irqstate_t flags;
 
+#ifdef CONFIG_MQ_MSGSLAB
+  flags = spin_lock_irqsave(&msgq->slablock);
+  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->slab);
+  spin_unlock_irqrestore(&msgq->slablock, flags);
+  if (mqmsg != NULL)
+    {
+      return mqmsg;
+    }
+#endif
+
   /* Try to get the message from the generally available free list. */
 
   flags = spin_lock_irqsave(&g_msgfreelock);
@@ -207,36 +223,93 @@ static void nxmq_add_queue(FAR struct mqueue_inode_s *msgq,
                            FAR struct mqueue_msg_s *mqmsg,
                            unsigned int prio)
 {
-  FAR struct mqueue_msg_s *prev = NULL;
-  FAR struct mqueue_msg_s *next;
+  FAR struct mqueue_msg_s *prev;
 
-  /* Insert the new message in the message queue
-   * Search the message list to find the location to insert the new
-   * message. Each is list is maintained in ascending priority order.
+  /* Insert the new message in the message queue.  The list is kept in
+   * descending priority order, oldest first within one priority, so the
+   * message goes after the last one whose priority is not lower.  Search
+   * from the tail: a message no more urgent than the last queued one, the
+   * usual case, is then added without walking the list.
    */
 
-  list_for_every_entry(&msgq->msglist, next, struct mqueue_msg_s, node)
+  list_for_every_entry_reverse(&msgq->msglist, prev,
+                               struct mqueue_msg_s, node)
     {
-      if (prio > next->priority)
+      if (prev->priority >= prio)
         {
           break;
         }
-      else
-        {
-          prev = next;
-        }
     }
 
-  /* Add the message at the right place */
+  /* If all queued messages have a lower priority, prev is the list head
+   * itself and the message becomes the first one.
+   */
+
+  list_add_after(&prev->node, &mqmsg->node);
+}
+
+/****************************************************************************
+ * Name: nxmq_send_msg
+ *
+ * Description:
+ *   Queue a message that is filled in already, waiting for the queue to
+ *   become non-full if necessary.  The message stays owned by the caller
+ *   on failure.
+ *
+ ****************************************************************************/
+
+static int nxmq_send_msg(FAR struct file *mq,
+                         FAR struct mqueue_inode_s *msgq,
+                         FAR struct mqueue_msg_s *mqmsg,
+                         FAR const struct timespec *abstime,
+                         sclock_t ticks)
+{
+  irqstate_t flags;
+  int ret = OK;
+
+  /* Disable interruption */
+
+  flags = enter_critical_section();
 
-  if (prev)
+  if (msgq->nmsgs >= msgq->maxmsgs)
     {
-      list_add_after(&prev->node, &mqmsg->node);
+      /* Verify that the message is full and we can't wait */
+
+      if ((up_interrupt_context() || (mq->f_oflags & O_NONBLOCK) != 0))
+        {
+          ret = -EAGAIN;
+          goto out;
+        }
+
+      /* The message queue is full.  We will need to wait for the message
+       * queue to become non-full.
+       */
+
+      ret = nxmq_wait_send(msgq, abstime, ticks);
+      if (ret < 0)
+        {
+          goto out;
+        }
     }
-  else
+
+  /* Add the message to the message queue */
+
+  nxmq_add_queue(msgq, mqmsg, mqmsg->priority);
+
+  /* Increment the count of messages in the queue */
+
+  if (msgq->nmsgs++ == 0)
     {
-      list_add_head(&msgq->msglist, &mqmsg->node);
+      nxmq_pollnotify(msgq, POLLIN);
     }
+
+  /* Notify any tasks that are waiting for a message to become available */
+
+  nxmq_notify_send(msgq);
+
+out:
+  leave_critical_section(flags);
+  return ret;
 }
 
 /****************************************************************************
@@ -279,7 +352,6 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 {
   FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *mqmsg;
-  irqstate_t flags;
   int ret = 0;
 
   /* Verify the input parameters */
@@ -308,7 +380,7 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 
   /* Pre-allocate a message structure */
 
-  mqmsg = nxmq_alloc_msg(msglen);
+  mqmsg = nxmq_alloc_msg(msgq, msglen);
   if (!mqmsg)
     {
       return -ENOMEM;
@@ -318,52 +390,10 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
   mqmsg->priority = prio;
   mqmsg->msglen   = msglen;
 
-  /* Disable interruption */
-
-  flags = enter_critical_section();
-
-  if (msgq->nmsgs >= msgq->maxmsgs)
-    {
-      /* Verify that the message is full and we can't wait */
-
-      if ((up_interrupt_context() || (mq->f_oflags & O_NONBLOCK) != 0))
-        {
-          ret = -EAGAIN;
-          goto out;
-        }
-
-      /* The message queue is full.  We will need to wait for the message
-       * queue to become non-full.
-       */
-
-      ret = nxmq_wait_send(msgq, abstime, ticks);
-      if (ret < 0)
-        {
-          goto out;
-        }
-    }
-
-  /* Add the message to the message queue */
-
-  nxmq_add_queue(msgq, mqmsg, prio);
-
-  /* Increment the count of messages in the queue */
-
-  if (msgq->nmsgs++ == 0)
-    {
-      nxmq_pollnotify(msgq, POLLIN);
-    }
-
-  /* Notify any tasks that are waiting for a message to become available */
-
-  nxmq_notify_send(msgq);
-
-out:
-  leave_critical_section(flags);
-
+  ret = nxmq_send_msg(mq, msgq, mqmsg, abstime, ticks);
   if (ret < 0)
     {
-      nxmq_free_msg(mqmsg);
+      nxmq_free_msg(msgq, mqmsg);
     }
 
   return ret;
@@ -744,3 +774,97 @@ int mq_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
   leave_cancellation_point();
   return ret;
 }
+
+/****************************************************************************
+ * Name: file_mq_loan
+ *
+ * Description:
+ *   Borrow a message buffer of the queue's mq_msgsize bytes, so that the
+ *   message can be built in place and queued by file_mq_timedsend_loan()
+ *   without being copied.  A buffer that is not sent must be handed back
+ *   with file_mq_return().
+ *
+ * Input Parameters:
+ *   mq  - Message queue descriptor
+ *   buf - The location to return the buffer
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -EINVAL for bad arguments or -ENOMEM when no
+ *   message is available.
+ *
+ ****************************************************************************/
+
+int file_mq_loan(FAR struct file *mq, FAR void **buf)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+
+  if (mq == NULL || mq->f_inode == NULL || buf == NULL)
+    {
+      return -EINVAL;
+    }
+
+  msgq  = mq->f_inode->i_private;
+  mqmsg = nxmq_alloc_msg(msgq, msgq->maxmsgsize);
+  if (mqmsg == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *buf = mqmsg->mail;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: file_mq_timedsend_loan
+ *
+ * Description:
+ *   Queue the first msglen bytes of a buffer obtained by file_mq_loan().
+ *   It blocks like file_mq_timedsend(), forever if abstime is NULL.
+ *
+ * Input Parameters:
+ *   mq      - Message queue descriptor
+ *   buf     - The loaned buffer holding the message
+ *   msglen  - The length of the message in bytes
+ *   prio    - The priority of the message
+ *   abstime - The absolute time to wait until a timeout is declared
+ *
+ * Returned Value:
+ *   Zero (OK) on success, the buffer then belongs to the queue.  On failure
+ *   a negated errno as for file_mq_timedsend() is returned and the buffer
+ *   is still loaned to the caller, who may retry or return it.
+ *
+ ****************************************************************************/
+
+int file_mq_timedsend_loan(FAR struct file *mq, FAR void *buf,
+                           size_t msglen, unsigned int prio,
+                           FAR const struct timespec *abstime)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  int ret;
+
+  if (abstime && (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000))
+    {
+      return -EINVAL;
+    }
+
+  if (mq == NULL || buf == NULL)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_DEBUG_FEATURES
+  ret = nxmq_verify_send(mq, buf, msglen, prio);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
+  mqmsg = container_of(buf, struct mqueue_msg_s, mail);
+  mqmsg->priority = prio;
+  mqmsg->msglen   = msglen;
+
+  ret = nxmq_send_msg(mq, mq->f_inode->i_private, mqmsg, abstime, -1);
+  return ret;
+}
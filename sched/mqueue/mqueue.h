@@ -60,7 +60,8 @@ enum mqalloc_e
 {
   MQ_ALLOC_FIXED = 0,  /* Pre-allocated; never freed */
   MQ_ALLOC_DYN,        /* Dynamically allocated; free when unused */
-  MQ_ALLOC_IRQ         /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_IRQ,        /* Preallocated, reserved for interrupt handling */
+  MQ_ALLOC_SLAB        /* Preallocated with the queue, freed with it */
 };
 
 /* This structure describes one buffered POSIX message. */
@@ -117,7 +118,8 @@ void nxmq_initialize(void);
 
 /* mq_msgfree.c *************************************************************/
 
-void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg);
+void nxmq_free_msg(FAR struct mqueue_inode_s *msgq,
+                   FAR struct mqueue_msg_s *mqmsg);
 
 /* mq_waitirq.c *************************************************************/
 
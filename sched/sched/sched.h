@@ -44,6 +44,10 @@
 
 #define PIDHASH(pid)             ((pid) & (g_npidhash - 1))
 
+#ifndef CONFIG_SCHED_TCBCACHE
+#  define CONFIG_SCHED_TCBCACHE  0
+#endif
+
 /* The state of a task is indicated both by the task_state field of the TCB
  * and by a series of task lists.  All of these tasks lists are declared
  * below. Although it is not always necessary, most of these lists are
@@ -144,6 +148,22 @@ enum task_deliver_e
                       */
 };
 
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+/* This structure defines the ready-to-run queue of one CPU.  There is one
+ * FIFO per priority level and a bitmap of the non-empty FIFOs so that the
+ * highest priority ready task can be found without walking a list.
+ */
+
+#define RUNQUEUE_NWORDS ((SCHED_PRIORITY_MAX + 32) / 32)
+
+struct runqueue_s
+{
+  uint32_t   bitmap[RUNQUEUE_NWORDS];           /* Non-empty FIFOs */
+  dq_queue_t queue[SCHED_PRIORITY_MAX + 1];     /* One FIFO per priority */
+  uint16_t   nready;                            /* Number of queued tasks */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -189,6 +209,14 @@ extern dq_queue_t g_readytorun;
 
 extern FAR struct tcb_s *g_assignedtasks[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_SCHED_CPU_CAPACITY
+/* The capacity that each CPU lost to throttling, zero at full speed.  See
+ * nxsched_set_cpu_capacity().
+ */
+
+extern volatile uint16_t g_cpu_throttle[CONFIG_SMP_NCPUS];
+#endif
+
 /* g_delivertasks is used to indicate that a task switch is scheduled for
  * another cpu to be processed.
  */
@@ -199,6 +227,15 @@ extern enum task_deliver_e g_delivertasks[CONFIG_SMP_NCPUS];
 
 extern struct tcb_s g_idletcb[CONFIG_SMP_NCPUS];
 
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+/* With CONFIG_SMP_PERCPU_RUNQUEUE, the g_readytorun list is not used.  The
+ * tasks that are ready to run but not running are kept in the run queue of
+ * the CPU given by tcb->cpu instead.
+ */
+
+extern struct runqueue_s g_runqueue[CONFIG_SMP_NCPUS];
+#endif
+
 #endif
 
 /* This is the list of all tasks that are ready-to-run, but cannot be placed
@@ -388,6 +425,17 @@ void nxsched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 void nxsched_suspend(FAR struct tcb_s *tcb);
 #endif
 
+/* TCB allocation, cached TCBs keep their stacks */
+
+#if CONFIG_SCHED_TCBCACHE > 0
+FAR struct tcb_s *nxsched_alloc_tcb(size_t size, uint8_t ttype);
+void nxsched_free_tcb(FAR struct tcb_s *tcb, uint8_t ttype);
+#else
+#  define nxsched_alloc_tcb(size, ttype) \
+     ((FAR struct tcb_s *)kmm_zalloc(size))
+#  define nxsched_free_tcb(tcb, ttype)   kmm_free(tcb)
+#endif
+
 #if defined(up_this_task)
 #  define this_task()            up_this_task()
 #elif !defined(CONFIG_SMP)
@@ -427,6 +475,11 @@ void nxsched_checkstackoverflow(FAR struct tcb_s *tcb);
 #ifdef CONFIG_SMP
 bool nxsched_switch_running(int cpu, bool switch_equal);
 void nxsched_process_delivered(int cpu);
+#  ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+void nxsched_runq_add(FAR struct tcb_s *tcb, int cpu);
+void nxsched_runq_remove(FAR struct tcb_s *tcb);
+FAR struct tcb_s *nxsched_runq_peek(int cpu, int priority);
+#  endif
 #else
 #  define nxsched_select_cpu(a)     (0)
 #endif
@@ -451,6 +504,22 @@ void nxsched_switch_critmon(FAR struct tcb_s *from, FAR struct tcb_s *to);
 void nxsched_update_critmon(FAR struct tcb_s *tcb);
 #endif
 
+#ifdef CONFIG_SCHED_PMU
+void nxsched_switch_pmu(FAR struct tcb_s *from);
+#endif
+
+#ifdef CONFIG_SCHED_LATENCY
+void nxsched_latency_add(int type, clock_t value);
+void nxsched_latency_ready(FAR struct tcb_s *tcb);
+void nxsched_switch_latency(FAR struct tcb_s *to);
+#endif
+
+#ifdef CONFIG_SCHED_PRESSURE
+void nxsched_pressure_ready(FAR struct tcb_s *tcb);
+void nxsched_pressure_remove(FAR struct tcb_s *tcb);
+void nxsched_switch_pressure(FAR struct tcb_s *from, FAR struct tcb_s *to);
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
 void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
                                 FAR void *caller);
@@ -558,6 +627,45 @@ static inline_function bool nxsched_add_prioritized(FAR struct tcb_s *tcb,
 
 #  ifdef CONFIG_SMP
 
+#    ifndef CONFIG_SMP_PERCPU_RUNQUEUE
+/* Without per-CPU run queues, all tasks that are ready to run but not
+ * running are kept in the single prioritized g_readytorun list.
+ */
+
+#      define nxsched_runq_add(tcb, cpu) \
+         ((void)nxsched_add_prioritized(tcb, list_readytorun()))
+#      define nxsched_runq_remove(tcb) \
+         dq_rem((FAR dq_entry_t *)(tcb), list_readytorun())
+
+/* Return the highest priority task in g_readytorun which is allowed to run
+ * on "cpu" and has higher priority than "priority".
+ */
+
+static inline_function FAR struct tcb_s *
+nxsched_runq_peek(int cpu, int priority)
+{
+  FAR struct tcb_s *btcb;
+
+  for (btcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
+       btcb && btcb->sched_priority > priority;
+       btcb = btcb->flink)
+    {
+      /* TCB_FLAG_CPU_LOCKED may be used to override affinity. If the flag
+       * is set, assume that btcb->cpu is valid, and it is the only CPU on
+       * which the btcb can run.
+       */
+
+      if (CPU_ISSET(cpu, &btcb->affinity) &&
+          ((btcb->flags & TCB_FLAG_CPU_LOCKED) == 0 || btcb->cpu == cpu))
+        {
+          return btcb;
+        }
+    }
+
+  return NULL;
+}
+#    endif
+
 /* Try to switch the head of the ready-to-run list to active on "target_cpu".
  * "cpu" is "this_cpu()", and passed only for optimization.
  */
@@ -569,7 +677,8 @@ nxsched_deliver_task(int cpu, int target_cpu,
   bool ret = false;
 
   /* If there is already a schedule interrupt pending, there is
-   * no need to do anything now.
+   * no need to send another one.  The pending one handles the most
+   * permissive rule that was requested (SWITCH_EQUAL over SWITCH_HIGHER).
    */
 
   if (g_delivertasks[target_cpu] != priority)
@@ -578,11 +687,15 @@ nxsched_deliver_task(int cpu, int target_cpu,
         {
           ret = nxsched_switch_running(cpu, priority == SWITCH_EQUAL);
         }
-      else
+      else if (g_delivertasks[target_cpu] == SWITCH_NONE)
         {
           g_delivertasks[target_cpu] = priority;
           up_send_smp_sched(target_cpu);
         }
+      else if (priority > g_delivertasks[target_cpu])
+        {
+          g_delivertasks[target_cpu] = priority;
+        }
     }
 
   return ret;
@@ -593,6 +706,9 @@ static inline_function int nxsched_select_cpu(cpu_set_t affinity)
   uint8_t minprio;
   int cpu;
   int i;
+#ifdef CONFIG_SCHED_CPU_CAPACITY
+  int idle = CONFIG_SMP_NCPUS;
+#endif
 
   minprio = SCHED_PRIORITY_MAX;
   cpu     = CONFIG_SMP_NCPUS;
@@ -616,18 +732,52 @@ static inline_function int nxsched_select_cpu(cpu_set_t affinity)
                */
 
               DEBUGASSERT(rtcb->sched_priority == 0);
+#ifdef CONFIG_SCHED_CPU_CAPACITY
+              /* Of the idle CPUs, use the one with the most capacity */
+
+              if (g_cpu_throttle[i] == 0)
+                {
+                  return i;
+                }
+              else if (idle == CONFIG_SMP_NCPUS ||
+                       g_cpu_throttle[i] < g_cpu_throttle[idle])
+                {
+                  idle = i;
+                }
+#else
               return i;
+#endif
             }
           else if (rtcb->sched_priority <= minprio &&
                    !nxsched_islocked_tcb(rtcb))
             {
               DEBUGASSERT(rtcb->sched_priority > 0);
+#ifdef CONFIG_SCHED_CPU_CAPACITY
+              /* Of the CPUs that run the same priority, preempt the one
+               * with the most capacity.
+               */
+
+              if (rtcb->sched_priority == minprio &&
+                  cpu < CONFIG_SMP_NCPUS &&
+                  g_cpu_throttle[i] > g_cpu_throttle[cpu])
+                {
+                  continue;
+                }
+#endif
+
               minprio = rtcb->sched_priority;
               cpu = i;
             }
         }
     }
 
+#ifdef CONFIG_SCHED_CPU_CAPACITY
+  if (idle < CONFIG_SMP_NCPUS)
+    {
+      return idle;
+    }
+#endif
+
   return cpu;
 }
 #  endif
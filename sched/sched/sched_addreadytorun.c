@@ -71,6 +71,14 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   FAR struct tcb_s *rtcb = this_task();
   bool ret;
 
+#ifdef CONFIG_SCHED_LATENCY
+  nxsched_latency_ready(btcb);
+#endif
+
+#ifdef CONFIG_SCHED_PRESSURE
+  nxsched_pressure_ready(btcb);
+#endif
+
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * preempted.  NOTE that IRQs disabled implies that pre-emption is
@@ -168,43 +176,31 @@ bool nxsched_switch_running(int cpu, bool switch_equal)
    * switch the current task to that one.
    */
 
-  for (btcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
-       btcb && btcb->sched_priority > sched_priority;
-       btcb = btcb->flink)
+  btcb = nxsched_runq_peek(cpu, sched_priority);
+  if (btcb != NULL)
     {
-      /* Check if the task found in ready-to-run list is allowed to run on
-       * this CPU. TCB_FLAG_CPU_LOCKED may be used to override affinity. If
-       * the flag is set, assume that btcb->cpu is valid, and it is the only
-       * CPU on which the btcb can run.
-       */
-
-      if (CPU_ISSET(cpu, &btcb->affinity) &&
-          ((btcb->flags & TCB_FLAG_CPU_LOCKED) == 0 || btcb->cpu == cpu))
-        {
-          /* Found a task, remove it from ready-to-run list */
+      /* Found a task, remove it from ready-to-run list */
 
-          dq_rem((FAR struct dq_entry_s *)btcb, list_readytorun());
+      nxsched_runq_remove(btcb);
 
-          if (!is_idle_task(rtcb))
-            {
-              /* Put currently running task back to ready-to-run list */
+      if (!is_idle_task(rtcb))
+        {
+          /* Put currently running task back to ready-to-run list */
 
-              rtcb->task_state = TSTATE_TASK_READYTORUN;
-              nxsched_add_prioritized(rtcb, list_readytorun());
-            }
-          else
-            {
-              rtcb->task_state = TSTATE_TASK_ASSIGNED;
-            }
+          rtcb->task_state = TSTATE_TASK_READYTORUN;
+          nxsched_runq_add(rtcb, cpu);
+        }
+      else
+        {
+          rtcb->task_state = TSTATE_TASK_ASSIGNED;
+        }
 
-          g_assignedtasks[cpu] = btcb;
-          up_update_task(btcb);
+      g_assignedtasks[cpu] = btcb;
+      up_update_task(btcb);
 
-          btcb->cpu = cpu;
-          btcb->task_state = TSTATE_TASK_RUNNING;
-          ret = true;
-          break;
-        }
+      btcb->cpu = cpu;
+      btcb->task_state = TSTATE_TASK_RUNNING;
+      ret = true;
     }
 
   return ret;
@@ -251,12 +247,20 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   int target_cpu = btcb->flags & TCB_FLAG_CPU_LOCKED ? btcb->cpu :
     nxsched_select_cpu(btcb->affinity);
 
+#ifdef CONFIG_SCHED_LATENCY
+  nxsched_latency_ready(btcb);
+#endif
+
+#ifdef CONFIG_SCHED_PRESSURE
+  nxsched_pressure_ready(btcb);
+#endif
+
   /* Add the btcb to the ready to run list, and try to run it on the target
    * CPU
    */
 
   btcb->task_state = TSTATE_TASK_READYTORUN;
-  nxsched_add_prioritized(btcb, list_readytorun());
+  nxsched_runq_add(btcb, target_cpu);
 
   if (target_cpu < CONFIG_SMP_NCPUS)
     {
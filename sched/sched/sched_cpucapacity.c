@@ -1,5 +1,5 @@
 /****************************************************************************
- * libs/libc/unistd/lib_getrusage.c
+ * sched/sched/sched_cpucapacity.c
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -26,45 +26,49 @@
 
 #include <nuttx/config.h>
 
-#include <string.h>
+#include <stdint.h>
 #include <errno.h>
 
-#include <sys/resource.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+volatile uint16_t g_cpu_throttle[CONFIG_SMP_NCPUS];
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: getrusage
+ * Name: nxsched_set_cpu_capacity
  *
  * Description:
- *   The getrusage() function shall provide measures of the resources used
- *   by the current process or its terminated and waited-for child processes.
- *   If the value of the who argument is RUSAGE_SELF, information shall be
- *   returned about resources used by the current process. If the value of
- *   the who argument is RUSAGE_CHILDREN, information shall be returned
- *   about resources used by the terminated and waited-for children of the
- *   current process. If the child is never waited for (for example, if the
- *   parent has SA_NOCLDWAIT set or sets SIGCHLD to SIG_IGN), the resource
- *   information for the child process is discarded and not included in the
- *   resource information provided by getrusage().
+ *   Set the capacity of the CPU, up to SCHED_CAPACITY_SCALE.  The tasks
+ *   that become ready to run prefer the CPUs with more capacity.
+ *
+ * Input Parameters:
+ *   cpu      - The CPU index.
+ *   capacity - The capacity of the CPU, SCHED_CAPACITY_SCALE at full speed.
  *
- *   Note: This is currently a dummy implementation and as such does not
- *   honor the 'who' parameter.
+ * Returned Value:
+ *   OK, or -EINVAL for a bad CPU or capacity.
  *
  ****************************************************************************/
 
-int getrusage(int who, FAR struct rusage *r_usage)
+int nxsched_set_cpu_capacity(int cpu, unsigned int capacity)
 {
-  UNUSED(who);
-
-  if (r_usage == NULL)
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS || capacity == 0 ||
+      capacity > SCHED_CAPACITY_SCALE)
     {
-      set_errno(EINVAL);
-      return ERROR;
+      return -EINVAL;
     }
 
-  memset(r_usage, 0, sizeof(*r_usage));
+  /* A single store, nxsched_select_cpu() reads it without a lock */
+
+  g_cpu_throttle[cpu] = SCHED_CAPACITY_SCALE - capacity;
   return OK;
 }
@@ -100,6 +100,14 @@ clock_t g_preemp_max[CONFIG_SMP_NCPUS];
 clock_t g_crit_max[CONFIG_SMP_NCPUS];
 #endif
 
+/* Critical section usage of each caller, an open addressed hash table
+ * keyed by the return address of enter_critical_section().
+ */
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+struct critmon_site_s g_crit_sites[CONFIG_SCHED_CRITMONITOR_CSECTION_SITES];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -153,6 +161,57 @@ static void nxsched_critmon_cpuload(FAR struct tcb_s *tcb, clock_t current,
 }
 #endif
 
+/****************************************************************************
+ * Name: nxsched_critmon_site
+ *
+ * Description:
+ *   Find the statistics of a critical section caller, and allocate them
+ *   if 'create' is true and the caller is not in the table yet.  Callers
+ *   that no longer fit in the table are not recorded.
+ *
+ * Assumptions:
+ *   Called within the critical section, which also protects the table.
+ *
+ ****************************************************************************/
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+static FAR struct critmon_site_s *nxsched_critmon_site(FAR void *caller,
+                                                       bool create)
+{
+  FAR struct critmon_site_s *site;
+  unsigned int index;
+  unsigned int i;
+
+  index = ((uintptr_t)caller >> 1) % CONFIG_SCHED_CRITMONITOR_CSECTION_SITES;
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_CSECTION_SITES; i++)
+    {
+      site = &g_crit_sites[index];
+      if (site->caller == caller)
+        {
+          return site;
+        }
+      else if (site->caller == NULL)
+        {
+          if (!create)
+            {
+              break;
+            }
+
+          site->caller = caller;
+          return site;
+        }
+
+      if (++index >= CONFIG_SCHED_CRITMONITOR_CSECTION_SITES)
+        {
+          index = 0;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -226,6 +285,9 @@ void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
 void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
                               FAR void *caller)
 {
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+  FAR struct critmon_site_s *site;
+#endif
   clock_t current = perf_gettime();
 
   /* Are we entering or leaving the critical section? */
@@ -236,6 +298,19 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
 
       tcb->crit_start  = current;
       tcb->crit_caller = caller;
+
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+      site = nxsched_critmon_site(caller, true);
+      if (site != NULL)
+        {
+          site->count++;
+          if (tcb->crit_wait > 0)
+            {
+              site->contended++;
+              site->wait += tcb->crit_wait;
+            }
+        }
+#endif
     }
   else
     {
@@ -251,6 +326,20 @@ void nxsched_critmon_csection(FAR struct tcb_s *tcb, bool state,
           CHECK_CSECTION(tcb->pid, elapsed);
         }
 
+#if CONFIG_SCHED_CRITMONITOR_CSECTION_SITES > 0
+      /* The time is charged to the caller that entered the section */
+
+      site = nxsched_critmon_site(tcb->crit_caller, false);
+      if (site != NULL)
+        {
+          site->total += elapsed;
+          if (elapsed > site->max)
+            {
+              site->max = elapsed;
+            }
+        }
+#endif
+
       /* Check for the global max elapsed time */
 
       if (elapsed > g_crit_max[cpu])
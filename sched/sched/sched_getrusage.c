@@ -0,0 +1,180 @@
+/****************************************************************************
+ * sched/sched/sched_getrusage.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+
+#include <sys/resource.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rusage_add
+ *
+ * Description:
+ *   Add what the thread tcb used to usage, and its run time to runtime.
+ *
+ ****************************************************************************/
+
+static void rusage_add(FAR struct rusage *usage, FAR clock_t *runtime,
+                       FAR struct tcb_s *tcb)
+{
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+  *runtime         += tcb->run_time;
+#endif
+
+#ifdef CONFIG_SCHED_RUSAGE
+  usage->ru_maxrss += tcb->heappeak / 1024;
+  usage->ru_nvcsw  += tcb->nvcsw;
+  usage->ru_nivcsw += tcb->nivcsw;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_rusage_heap
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_RUSAGE
+void nxsched_rusage_heap(pid_t pid, ssize_t size)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  tcb = nxsched_get_tcb(pid);
+  if (tcb != NULL)
+    {
+      /* The pid may have been reused since the chunk was allocated */
+
+      if (size < 0 && (size_t)-size > tcb->heapused)
+        {
+          tcb->heapused = 0;
+        }
+      else
+        {
+          tcb->heapused += size;
+        }
+
+      if (tcb->heapused > tcb->heappeak)
+        {
+          tcb->heappeak = tcb->heapused;
+        }
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
+/****************************************************************************
+ * Name: getrusage
+ *
+ * Description:
+ *   The getrusage() function shall provide measures of the resources used
+ *   by the current process or its terminated and waited-for child processes.
+ *   If the value of the who argument is RUSAGE_SELF, information shall be
+ *   returned about resources used by the current process. If the value of
+ *   the who argument is RUSAGE_CHILDREN, information shall be returned
+ *   about resources used by the terminated and waited-for children of the
+ *   current process. If the child is never waited for (for example, if the
+ *   parent has SA_NOCLDWAIT set or sets SIGCHLD to SIG_IGN), the resource
+ *   information for the child process is discarded and not included in the
+ *   resource information provided by getrusage().
+ *
+ *   RUSAGE_THREAD reports the calling thread only.  Nothing is kept of the
+ *   children, RUSAGE_CHILDREN always reports zeros.  The CPU time is all
+ *   reported as user time, it is only known with
+ *   CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0; the context switches and
+ *   the peak heap use (ru_maxrss) need CONFIG_SCHED_RUSAGE.
+ *
+ ****************************************************************************/
+
+int getrusage(int who, FAR struct rusage *r_usage)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  clock_t runtime = 0;
+#ifdef HAVE_GROUP_MEMBERS
+  FAR struct task_group_s *group = rtcb->group;
+  FAR sq_entry_t *curr;
+  irqstate_t flags;
+#endif
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+  struct timespec ts;
+#endif
+
+  if (r_usage == NULL ||
+      (who != RUSAGE_SELF && who != RUSAGE_CHILDREN && who != RUSAGE_THREAD))
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  memset(r_usage, 0, sizeof(*r_usage));
+  if (who == RUSAGE_CHILDREN)
+    {
+      return OK;
+    }
+
+#ifdef HAVE_GROUP_MEMBERS
+  if (who == RUSAGE_SELF)
+    {
+      flags = spin_lock_irqsave(&group->tg_lock);
+      sq_for_every(&group->tg_members, curr)
+        {
+          rusage_add(r_usage, &runtime,
+                     container_of(curr, struct tcb_s, member));
+        }
+
+      spin_unlock_irqrestore(&group->tg_lock, flags);
+    }
+  else
+#endif
+    {
+      rusage_add(r_usage, &runtime, rtcb);
+    }
+
+#if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
+  up_perf_convert(runtime, &ts);
+  r_usage->ru_utime.tv_sec  = ts.tv_sec;
+  r_usage->ru_utime.tv_usec = ts.tv_nsec / NSEC_PER_USEC;
+#endif
+
+  return OK;
+}
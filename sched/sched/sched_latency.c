@@ -0,0 +1,224 @@
+/****************************************************************************
+ * sched/sched/sched_latency.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_LATENCY
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LATENCY_SUB (1 << SCHED_LATENCY_SUBBITS)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Only the CPU itself adds to its histograms, with the interrupts off */
+
+static uint32_t g_latency[CONFIG_SMP_NCPUS][SCHED_LATENCY_NTYPES]
+                         [SCHED_LATENCY_NBUCKETS];
+
+static FAR const char * const g_latency_names[SCHED_LATENCY_NTYPES] =
+{
+  "irq",
+  "wakeup",
+  "wdog",
+  "work"
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: latency_bucket
+ *
+ * Description:
+ *   The bucket of value.  Each power of two is split in LATENCY_SUB linear
+ *   buckets, so the width of a bucket is a fixed fraction of its bound.
+ *
+ ****************************************************************************/
+
+static inline_function unsigned int latency_bucket(clock_t value)
+{
+  uint32_t v = value > UINT32_MAX ? UINT32_MAX : (uint32_t)value;
+  unsigned int shift;
+
+  if (v < LATENCY_SUB)
+    {
+      return v;
+    }
+
+  shift = fls((int)v) - 1 - SCHED_LATENCY_SUBBITS;
+  return ((shift + 1) << SCHED_LATENCY_SUBBITS) |
+         ((v >> shift) & (LATENCY_SUB - 1));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_latency_add
+ *
+ * Description:
+ *   Count one latency of the calling CPU.  The value is in perf_gettime()
+ *   units for SCHED_LATENCY_IRQ and SCHED_LATENCY_WAKEUP, in clock ticks
+ *   for SCHED_LATENCY_WDOG and SCHED_LATENCY_WORK.
+ *
+ ****************************************************************************/
+
+void nxsched_latency_add(int type, clock_t value)
+{
+  irqstate_t flags = up_irq_save();
+
+  g_latency[this_cpu()][type][latency_bucket(value)]++;
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: nxsched_latency_ready
+ *
+ * Description:
+ *   Stamp a task that becomes ready to run, unless it already waits for
+ *   the CPU since an earlier stamp.
+ *
+ ****************************************************************************/
+
+void nxsched_latency_ready(FAR struct tcb_s *tcb)
+{
+  if (tcb->ready_time == 0)
+    {
+      tcb->ready_time = perf_gettime();
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_switch_latency
+ *
+ * Description:
+ *   Called at each context switch, count the time the task that is being
+ *   switched in waited since it became ready.
+ *
+ ****************************************************************************/
+
+void nxsched_switch_latency(FAR struct tcb_s *to)
+{
+  if (to->ready_time != 0)
+    {
+      nxsched_latency_add(SCHED_LATENCY_WAKEUP,
+                          perf_gettime() - to->ready_time);
+      to->ready_time = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_latency_read
+ *
+ * Description:
+ *   Copy the SCHED_LATENCY_NBUCKETS counts of one histogram of a CPU.
+ *
+ ****************************************************************************/
+
+int nxsched_latency_read(int type, int cpu, FAR uint32_t *counts)
+{
+  if (type < 0 || type >= SCHED_LATENCY_NTYPES ||
+      cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  memcpy(counts, g_latency[cpu][type], sizeof(g_latency[cpu][type]));
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_latency_bound
+ *
+ * Description:
+ *   The lower bound of a bucket of the histograms of type, in nanoseconds.
+ *
+ ****************************************************************************/
+
+uint64_t nxsched_latency_bound(int type, int bucket)
+{
+  clock_t value = bucket;
+  struct timespec ts;
+
+  if (bucket >= LATENCY_SUB)
+    {
+      value = (clock_t)(LATENCY_SUB | (bucket & (LATENCY_SUB - 1))) <<
+              ((bucket >> SCHED_LATENCY_SUBBITS) - 1);
+    }
+
+  if (type == SCHED_LATENCY_WDOG || type == SCHED_LATENCY_WORK)
+    {
+      return TICK2NSEC((uint64_t)value);
+    }
+
+  up_perf_convert(value, &ts);
+  return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: nxsched_latency_name
+ ****************************************************************************/
+
+FAR const char *nxsched_latency_name(int type)
+{
+  if (type < 0 || type >= SCHED_LATENCY_NTYPES)
+    {
+      return NULL;
+    }
+
+  return g_latency_names[type];
+}
+
+/****************************************************************************
+ * Name: nxsched_latency_reset
+ ****************************************************************************/
+
+void nxsched_latency_reset(void)
+{
+  irqstate_t flags = enter_critical_section();
+
+  memset(g_latency, 0, sizeof(g_latency));
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_SCHED_LATENCY */
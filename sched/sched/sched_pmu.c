@@ -0,0 +1,365 @@
+/****************************************************************************
+ * sched/sched/sched_pmu.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mutex.h>
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PMU
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PMU_NCOUNTERS CONFIG_SCHED_PMU_NCOUNTERS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The hardware counters of one CPU.  The counters run freely, each update
+ * adds what they moved since the previous one to the CPU and to the task
+ * that was running.
+ */
+
+struct pmu_cpu_s
+{
+  uint64_t mask[PMU_NCOUNTERS];    /* Width of each counter */
+  uint64_t last[PMU_NCOUNTERS];    /* Counter values at the last update */
+  uint64_t total[PMU_NCOUNTERS];   /* Events counted on this CPU */
+};
+
+struct pmu_setup_s
+{
+  FAR const int *events;
+  int nevents;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pmu_cpu_s g_pmu_cpu[CONFIG_SMP_NCPUS];
+static int g_pmu_event[PMU_NCOUNTERS];
+static volatile int g_pmu_nevents;
+static mutex_t g_pmu_lock = NXMUTEX_INITIALIZER;
+
+static FAR const char * const g_pmu_names[PMU_EVENT_MAX] =
+{
+  "none",
+  "cycles",
+  "instructions",
+  "cache-misses",
+  "branch-misses",
+  "stalls-frontend",
+  "stalls-backend"
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pmu_update
+ *
+ * Description:
+ *   Account the events since the last update of the calling CPU to it and
+ *   to tcb, which must be the task that ran in between.  Called with the
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void pmu_update(FAR struct tcb_s *tcb)
+{
+  FAR struct pmu_cpu_s *cpu = &g_pmu_cpu[this_cpu()];
+  int nevents = g_pmu_nevents;
+  uint64_t delta;
+  uint64_t now;
+  int i;
+
+  for (i = 0; i < nevents; i++)
+    {
+      now           = up_pmu_read(i);
+      delta         = (now - cpu->last[i]) & cpu->mask[i];
+      cpu->last[i]  = now;
+      cpu->total[i] += delta;
+      tcb->pmu_count[i] += delta;
+    }
+}
+
+/****************************************************************************
+ * Name: pmu_setup_cpu
+ *
+ * Description:
+ *   Reprogram the counters of the calling CPU, this runs on every CPU.
+ *
+ ****************************************************************************/
+
+static int pmu_setup_cpu(FAR void *arg)
+{
+  FAR struct pmu_setup_s *setup = arg;
+  FAR struct pmu_cpu_s *cpu;
+  irqstate_t flags;
+  int ret = OK;
+  int i;
+
+  flags = up_irq_save();
+  cpu = &g_pmu_cpu[this_cpu()];
+
+  for (i = 0; i < MIN(up_pmu_ncounters(), PMU_NCOUNTERS); i++)
+    {
+      up_pmu_stop(i);
+    }
+
+  for (i = 0; i < setup->nevents; i++)
+    {
+      ret = up_pmu_start(i, setup->events[i]);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      cpu->mask[i]  = ret >= 64 ? UINT64_MAX : (UINT64_C(1) << ret) - 1;
+      cpu->last[i]  = up_pmu_read(i);
+      ret           = OK;
+    }
+
+  if (ret < 0)
+    {
+      while (i-- > 0)
+        {
+          up_pmu_stop(i);
+        }
+    }
+
+  memset(cpu->total, 0, sizeof(cpu->total));
+  up_irq_restore(flags);
+  return ret;
+}
+
+static void pmu_clear_task(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  UNUSED(arg);
+  memset(tcb->pmu_count, 0, sizeof(tcb->pmu_count));
+}
+
+#ifdef CONFIG_SMP
+static int pmu_update_cpu(FAR void *arg)
+{
+  irqstate_t flags = up_irq_save();
+
+  UNUSED(arg);
+  pmu_update(this_task());
+  up_irq_restore(flags);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_switch_pmu
+ *
+ * Description:
+ *   Called at each context switch, charge the task that is being switched
+ *   out with the events since it was switched in.
+ *
+ ****************************************************************************/
+
+void nxsched_switch_pmu(FAR struct tcb_s *from)
+{
+  if (g_pmu_nevents > 0)
+    {
+      pmu_update(from);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_pmu_setup
+ ****************************************************************************/
+
+int nxsched_pmu_setup(FAR const int *events, int nevents)
+{
+  struct pmu_setup_s setup;
+  int ret;
+  int i;
+
+  if (nevents < 0 || nevents > PMU_NCOUNTERS)
+    {
+      return -E2BIG;
+    }
+
+  for (i = 0; i < nevents; i++)
+    {
+      if (events[i] <= PMU_EVENT_NONE || events[i] >= PMU_EVENT_MAX)
+        {
+          return -EINVAL;
+        }
+    }
+
+  ret = nxmutex_lock(&g_pmu_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Stop the accounting first, no CPU reads the counters while they are
+   * being reprogrammed or while the task counts are cleared.
+   */
+
+  g_pmu_nevents = 0;
+  SMP_MB();
+
+  setup.events  = events;
+  setup.nevents = nevents;
+
+#ifdef CONFIG_SMP
+  ret = nxsched_smp_call((1 << CONFIG_SMP_NCPUS) - 1, pmu_setup_cpu,
+                         &setup);
+#else
+  ret = pmu_setup_cpu(&setup);
+#endif
+
+  if (ret < 0)
+    {
+      /* Some CPUs may have started their counters, stop them all */
+
+      setup.nevents = 0;
+#ifdef CONFIG_SMP
+      nxsched_smp_call((1 << CONFIG_SMP_NCPUS) - 1, pmu_setup_cpu, &setup);
+#else
+      pmu_setup_cpu(&setup);
+#endif
+      nevents = 0;
+    }
+
+  nxsched_foreach(pmu_clear_task, NULL);
+
+  for (i = 0; i < PMU_NCOUNTERS; i++)
+    {
+      g_pmu_event[i] = i < nevents ? events[i] : PMU_EVENT_NONE;
+    }
+
+  SMP_MB();
+  g_pmu_nevents = nevents;
+
+  nxmutex_unlock(&g_pmu_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxsched_pmu_event
+ ****************************************************************************/
+
+int nxsched_pmu_event(int counter)
+{
+  if (counter < 0 || counter >= g_pmu_nevents)
+    {
+      return PMU_EVENT_NONE;
+    }
+
+  return g_pmu_event[counter];
+}
+
+/****************************************************************************
+ * Name: nxsched_pmu_name
+ ****************************************************************************/
+
+FAR const char *nxsched_pmu_name(int event)
+{
+  if (event < 0 || event >= PMU_EVENT_MAX)
+    {
+      return NULL;
+    }
+
+  return g_pmu_names[event];
+}
+
+/****************************************************************************
+ * Name: nxsched_pmu_cpu
+ *
+ * Description:
+ *   The counts of a CPU, brought up to date first.
+ *
+ ****************************************************************************/
+
+int nxsched_pmu_cpu(int cpu, FAR uint64_t *counts)
+{
+  irqstate_t flags;
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  if (g_pmu_nevents > 0)
+    {
+#ifdef CONFIG_SMP
+      nxsched_smp_call_single(cpu, pmu_update_cpu, NULL);
+#else
+      flags = up_irq_save();
+      pmu_update(this_task());
+      up_irq_restore(flags);
+#endif
+    }
+
+  flags = up_irq_save();
+  memcpy(counts, g_pmu_cpu[cpu].total, sizeof(g_pmu_cpu[cpu].total));
+  up_irq_restore(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_pmu_task
+ ****************************************************************************/
+
+void nxsched_pmu_task(FAR struct tcb_s *tcb, FAR uint64_t *counts)
+{
+  irqstate_t flags = up_irq_save();
+
+  /* The calling task has been counting since it was switched in */
+
+  if (tcb == this_task() && g_pmu_nevents > 0)
+    {
+      pmu_update(tcb);
+    }
+
+  memcpy(counts, tcb->pmu_count, sizeof(tcb->pmu_count));
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_SCHED_PMU */
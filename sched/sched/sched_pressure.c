@@ -0,0 +1,392 @@
+/****************************************************************************
+ * sched/sched/sched_pressure.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRESSURE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The averages are updated every two seconds as in Linux, in fixed point
+ * with PRESSURE_FSHIFT bits of fraction.
+ */
+
+#define PRESSURE_PERIOD    2
+#define PRESSURE_FSHIFT    11
+#define PRESSURE_FIXED_1   (1 << PRESSURE_FSHIFT)
+#define PRESSURE_FIXED_100 (100 << PRESSURE_FSHIFT)
+
+/* Bits of tcb->pressure */
+
+#define PRESSURE_CPU_WAIT  (1 << 0)   /* Ready to run but not running */
+#define PRESSURE_IO_WAIT   (1 << 1)   /* Blocked in a storage I/O call */
+#define PRESSURE_IO        (1 << 2)   /* Inside a storage I/O call */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The stall state of one resource.  The time is in perf_gettime() units. */
+
+struct pressure_res_s
+{
+  uint32_t nstalled;               /* Tasks stalled on the resource now */
+  clock_t  last;                   /* Last time total was brought up to date */
+  uint64_t total;                  /* Time with at least one task stalled */
+  clock_t  avg_time;               /* Start of the current period */
+  uint64_t avg_total;              /* total at avg_time */
+  uint32_t avg[3];                 /* Fixed point percents */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct pressure_res_s g_pressure[SCHED_PRESSURE_NRES];
+static spinlock_t g_pressure_lock = SP_UNLOCKED;
+
+/* exp(-2 / 10), exp(-2 / 60) and exp(-2 / 300) in fixed point */
+
+static const uint32_t g_pressure_exp[3] =
+{
+  1677, 1981, 2034
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pressure_power
+ *
+ * Description:
+ *   x to the n, in fixed point.
+ *
+ ****************************************************************************/
+
+static uint32_t pressure_power(uint32_t x, uint64_t n)
+{
+  uint32_t result = PRESSURE_FIXED_1;
+
+  while (n != 0 && result != 0)
+    {
+      if (n & 1)
+        {
+          result = (result * x) >> PRESSURE_FSHIFT;
+        }
+
+      x = (x * x) >> PRESSURE_FSHIFT;
+      n >>= 1;
+    }
+
+  return result;
+}
+
+/****************************************************************************
+ * Name: pressure_average
+ *
+ * Description:
+ *   Fold n periods that were each stalled pct percent into the averages.
+ *
+ ****************************************************************************/
+
+static void pressure_average(FAR struct pressure_res_s *res, uint32_t pct,
+                             uint64_t n)
+{
+  uint32_t e;
+  int i;
+
+  for (i = 0; i < 3; i++)
+    {
+      e = pressure_power(g_pressure_exp[i], n);
+      res->avg[i] = ((uint64_t)res->avg[i] * e +
+                     (uint64_t)pct * (PRESSURE_FIXED_1 - e)) >>
+                    PRESSURE_FSHIFT;
+    }
+}
+
+/****************************************************************************
+ * Name: pressure_update
+ *
+ * Description:
+ *   Bring the total and the averages of res up to now.  This is done
+ *   before each change of nstalled, so that it has been constant since
+ *   res->last: the periods that ended in between are either fully stalled
+ *   or not at all, and are folded in at once.
+ *
+ ****************************************************************************/
+
+static void pressure_update(FAR struct pressure_res_s *res, clock_t now)
+{
+  clock_t period = PRESSURE_PERIOD * perf_getfreq();
+  uint64_t stall;
+  uint64_t n;
+
+  if (res->nstalled > 0)
+    {
+      res->total += now - res->last;
+    }
+
+  res->last = now;
+
+  if (now - res->avg_time < period)
+    {
+      return;
+    }
+
+  /* The first period that ended may have seen changes */
+
+  res->avg_time += period;
+  stall = res->total - res->avg_total;
+  if (res->nstalled > 0)
+    {
+      stall -= now - res->avg_time;
+    }
+
+  pressure_average(res, stall * PRESSURE_FIXED_100 / period, 1);
+  res->avg_total += stall;
+
+  /* The others did not */
+
+  n = (now - res->avg_time) / period;
+  if (n > 0)
+    {
+      pressure_average(res, res->nstalled > 0 ? PRESSURE_FIXED_100 : 0, n);
+      res->avg_time += n * period;
+      if (res->nstalled > 0)
+        {
+          res->avg_total += n * period;
+        }
+    }
+}
+
+static void pressure_change(int type, int delta)
+{
+  FAR struct pressure_res_s *res = &g_pressure[type];
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+  pressure_update(res, perf_gettime());
+  res->nstalled += delta;
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_pressure_ready
+ *
+ * Description:
+ *   A task became ready to run: it stops waiting for storage, if it did,
+ *   and starts waiting for a CPU.  The IDLE tasks are not counted.
+ *
+ ****************************************************************************/
+
+void nxsched_pressure_ready(FAR struct tcb_s *tcb)
+{
+  if (tcb->pressure & PRESSURE_IO_WAIT)
+    {
+      tcb->pressure &= ~PRESSURE_IO_WAIT;
+      pressure_change(SCHED_PRESSURE_IO, -1);
+    }
+
+  if (!is_idle_task(tcb) && !(tcb->pressure & PRESSURE_CPU_WAIT))
+    {
+      tcb->pressure |= PRESSURE_CPU_WAIT;
+      pressure_change(SCHED_PRESSURE_CPU, 1);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_pressure_remove
+ *
+ * Description:
+ *   The task left the ready-to-run list or is being released, it does not
+ *   wait for anything anymore.
+ *
+ ****************************************************************************/
+
+void nxsched_pressure_remove(FAR struct tcb_s *tcb)
+{
+  if (tcb->pressure & PRESSURE_CPU_WAIT)
+    {
+      tcb->pressure &= ~PRESSURE_CPU_WAIT;
+      pressure_change(SCHED_PRESSURE_CPU, -1);
+    }
+
+  if (tcb->pressure & PRESSURE_IO_WAIT)
+    {
+      tcb->pressure &= ~PRESSURE_IO_WAIT;
+      pressure_change(SCHED_PRESSURE_IO, -1);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_switch_pressure
+ *
+ * Description:
+ *   Called at each context switch.  A task that is switched out while
+ *   still ready to run was preempted and waits for a CPU again, one that
+ *   blocks inside a storage I/O call waits for the storage.
+ *
+ ****************************************************************************/
+
+void nxsched_switch_pressure(FAR struct tcb_s *from, FAR struct tcb_s *to)
+{
+  if (from == to)
+    {
+      return;
+    }
+
+  if (from->task_state != TSTATE_TASK_INVALID &&
+      from->task_state < FIRST_BLOCKED_STATE)
+    {
+      nxsched_pressure_ready(from);
+    }
+  else if (from->pressure & PRESSURE_IO)
+    {
+      from->pressure |= PRESSURE_IO_WAIT;
+      pressure_change(SCHED_PRESSURE_IO, 1);
+    }
+
+  if (to->pressure & PRESSURE_CPU_WAIT)
+    {
+      to->pressure &= ~PRESSURE_CPU_WAIT;
+      pressure_change(SCHED_PRESSURE_CPU, -1);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_pressure_enter
+ *
+ * Description:
+ *   The calling task starts to wait for the resource type.  Each call must
+ *   be paired with nxsched_pressure_leave().
+ *
+ ****************************************************************************/
+
+void nxsched_pressure_enter(int type)
+{
+  pressure_change(type, 1);
+}
+
+/****************************************************************************
+ * Name: nxsched_pressure_leave
+ ****************************************************************************/
+
+void nxsched_pressure_leave(int type)
+{
+  pressure_change(type, -1);
+}
+
+/****************************************************************************
+ * Name: nxsched_pressure_io_begin
+ *
+ * Description:
+ *   Mark the calling task as being inside a storage I/O call, the time it
+ *   spends blocked until nxsched_pressure_io_end() is an I/O stall.  The
+ *   wait bits are always clear while the task runs, so they cannot be
+ *   lost by this update.
+ *
+ * Returned Value:
+ *   true if the task was marked, false if an outer call already did so.
+ *   It is to be passed to nxsched_pressure_io_end().
+ *
+ ****************************************************************************/
+
+bool nxsched_pressure_io_begin(void)
+{
+  FAR struct tcb_s *tcb = this_task();
+
+  if (tcb->pressure & PRESSURE_IO)
+    {
+      return false;
+    }
+
+  tcb->pressure |= PRESSURE_IO;
+  return true;
+}
+
+/****************************************************************************
+ * Name: nxsched_pressure_io_end
+ ****************************************************************************/
+
+void nxsched_pressure_io_end(bool marked)
+{
+  if (marked)
+    {
+      this_task()->pressure &= ~PRESSURE_IO;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_pressure_read
+ ****************************************************************************/
+
+int nxsched_pressure_read(int type, FAR struct sched_pressure_s *info)
+{
+  FAR struct pressure_res_s *res;
+  struct timespec ts;
+  irqstate_t flags;
+  uint64_t total;
+  int i;
+
+  if (type < 0 || type >= SCHED_PRESSURE_NRES)
+    {
+      return -EINVAL;
+    }
+
+  res = &g_pressure[type];
+  flags = spin_lock_irqsave(&g_pressure_lock);
+  pressure_update(res, perf_gettime());
+
+  total = res->total;
+  for (i = 0; i < 3; i++)
+    {
+      info->avg[i] = ((uint64_t)res->avg[i] * 100) >> PRESSURE_FSHIFT;
+    }
+
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+
+  perf_convert(total, &ts);
+  info->total = (uint64_t)ts.tv_sec * USEC_PER_SEC +
+                ts.tv_nsec / NSEC_PER_USEC;
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_PRESSURE */
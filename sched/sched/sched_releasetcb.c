@@ -108,6 +108,12 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       DEBUGASSERT(tcb->flink == NULL && tcb->blink == NULL);
 
+#ifdef CONFIG_SCHED_PRESSURE
+      /* It may have been killed while it was waiting for storage */
+
+      nxsched_pressure_remove(tcb);
+#endif
+
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
       /* Release any timers that the task might hold.  We do this
        * before release the PID because it may still be trying to
@@ -129,9 +135,15 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
           nxsched_releasepid(tcb->pid);
         }
 
-      /* Delete the thread's stack if one has been allocated */
+      /* Delete the thread's stack if one has been allocated, a freed TCB
+       * may keep it in the cache.
+       */
 
+#if CONFIG_SCHED_TCBCACHE > 0
+      if (tcb->stack_alloc_ptr && (tcb->flags & TCB_FLAG_FREE_TCB) == 0)
+#else
       if (tcb->stack_alloc_ptr)
+#endif
         {
           up_release_stack(tcb, ttype);
         }
@@ -178,7 +190,7 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
 
       if (tcb->flags & TCB_FLAG_FREE_TCB)
         {
-          kmm_free(tcb);
+          nxsched_free_tcb(tcb, ttype);
         }
     }
 
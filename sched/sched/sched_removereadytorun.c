@@ -69,6 +69,10 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *rtcb)
 
   tasklist = TLIST_HEAD(rtcb);
 
+#ifdef CONFIG_SCHED_PRESSURE
+  nxsched_pressure_remove(rtcb);
+#endif
+
   /* Check if the TCB to be removed is at the head of the ready to run list.
    * There is only one list, g_readytorun, and it always contains the
    * currently running task.  If we are removing the head of this list,
@@ -172,6 +176,10 @@ void nxsched_remove_self(FAR struct tcb_s *tcb)
 
 bool nxsched_remove_readytorun(FAR struct tcb_s *tcb)
 {
+#ifdef CONFIG_SCHED_PRESSURE
+  nxsched_pressure_remove(tcb);
+#endif
+
   if (tcb->task_state == TSTATE_TASK_RUNNING)
     {
       nxsched_remove_running(tcb);
@@ -179,13 +187,18 @@ bool nxsched_remove_readytorun(FAR struct tcb_s *tcb)
     }
   else
     {
-      FAR dq_queue_t *tasklist;
-
-      tasklist = TLIST_HEAD(tcb, tcb->cpu);
-
       /* The task is not running.  Just remove its TCB from the task list */
 
-      dq_rem((FAR dq_entry_t *)tcb, tasklist);
+#ifdef CONFIG_SMP_PERCPU_RUNQUEUE
+      if (tcb->task_state == TSTATE_TASK_READYTORUN)
+        {
+          nxsched_runq_remove(tcb);
+        }
+      else
+#endif
+        {
+          dq_rem((FAR dq_entry_t *)tcb, TLIST_HEAD(tcb, tcb->cpu));
+        }
 
       /* Since the TCB is no longer in any list, it is now invalid */
 
@@ -0,0 +1,277 @@
+/****************************************************************************
+ * sched/sched/sched_runqueue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/queue.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_runq_top
+ *
+ * Description:
+ *   Return the highest priority below 'below' that has a non-empty FIFO in
+ *   the run queue, or -1 if there is none.
+ *
+ ****************************************************************************/
+
+static int nxsched_runq_top(FAR struct runqueue_s *rq, int below)
+{
+  uint32_t bits;
+  int word;
+
+  if (below <= 0)
+    {
+      return -1;
+    }
+
+  word = (below - 1) >> 5;
+  bits = rq->bitmap[word] & (UINT32_MAX >> (31 - ((below - 1) & 31)));
+
+  for (; ; )
+    {
+      if (bits != 0)
+        {
+          return (word << 5) + fls((int)bits) - 1;
+        }
+
+      if (--word < 0)
+        {
+          return -1;
+        }
+
+      bits = rq->bitmap[word];
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_runq_eligible
+ *
+ * Description:
+ *   Return true if the ready-to-run task may be run on 'cpu'.
+ *   TCB_FLAG_CPU_LOCKED overrides the affinity: if it is set, btcb->cpu is
+ *   the only CPU on which the task can run.
+ *
+ ****************************************************************************/
+
+static inline_function bool nxsched_runq_eligible(FAR struct tcb_s *tcb,
+                                                  int cpu)
+{
+  return CPU_ISSET(cpu, &tcb->affinity) &&
+         ((tcb->flags & TCB_FLAG_CPU_LOCKED) == 0 || tcb->cpu == cpu);
+}
+
+/****************************************************************************
+ * Name: nxsched_runq_select
+ *
+ * Description:
+ *   Select the run queue for a task that cannot preempt any CPU right now.
+ *   The current CPU is preferred so that no IPI is needed and the task
+ *   stays cache hot;  otherwise the permitted CPU with the fewest queued
+ *   tasks is used.
+ *
+ ****************************************************************************/
+
+static int nxsched_runq_select(FAR struct tcb_s *tcb)
+{
+  int cpu = this_cpu();
+  int best = CONFIG_SMP_NCPUS;
+  int i;
+
+  if (nxsched_runq_eligible(tcb, cpu))
+    {
+      return cpu;
+    }
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (nxsched_runq_eligible(tcb, i) &&
+          (best == CONFIG_SMP_NCPUS ||
+           g_runqueue[i].nready < g_runqueue[best].nready))
+        {
+          best = i;
+        }
+    }
+
+  DEBUGASSERT(best < CONFIG_SMP_NCPUS);
+  return best;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_runq_add
+ *
+ * Description:
+ *   Append a ready-to-run task to the FIFO of its priority in the run queue
+ *   of 'cpu'.  If 'cpu' is CONFIG_SMP_NCPUS or the task may not run there,
+ *   a suitable run queue is selected.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the ready-to-run task
+ *   cpu - The preferred CPU
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_runq_add(FAR struct tcb_s *tcb, int cpu)
+{
+  FAR struct runqueue_s *rq;
+  int prio = tcb->sched_priority;
+
+  if (cpu >= CONFIG_SMP_NCPUS || !nxsched_runq_eligible(tcb, cpu))
+    {
+      cpu = nxsched_runq_select(tcb);
+    }
+
+  rq = &g_runqueue[cpu];
+  dq_addlast((FAR dq_entry_t *)tcb, &rq->queue[prio]);
+  rq->bitmap[prio >> 5] |= (uint32_t)1 << (prio & 31);
+  rq->nready++;
+
+  tcb->cpu = cpu;
+}
+
+/****************************************************************************
+ * Name: nxsched_runq_remove
+ *
+ * Description:
+ *   Remove a ready-to-run task from its run queue.  The task must still
+ *   have the priority with which it was queued.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the ready-to-run task
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_runq_remove(FAR struct tcb_s *tcb)
+{
+  FAR struct runqueue_s *rq = &g_runqueue[tcb->cpu];
+  int prio = tcb->sched_priority;
+
+  DEBUGASSERT(rq->nready > 0);
+
+  dq_rem((FAR dq_entry_t *)tcb, &rq->queue[prio]);
+  if (dq_empty(&rq->queue[prio]))
+    {
+      rq->bitmap[prio >> 5] &= ~((uint32_t)1 << (prio & 31));
+    }
+
+  rq->nready--;
+}
+
+/****************************************************************************
+ * Name: nxsched_runq_peek
+ *
+ * Description:
+ *   Return the highest priority ready-to-run task that may run on 'cpu'
+ *   and whose priority is above 'priority'.  The run queue of 'cpu' is
+ *   consulted first, then the run queues of the other CPUs are searched
+ *   for a higher priority task that may be pulled over to this CPU.  This
+ *   way an idle CPU steals work from the busy ones, and no ready task is
+ *   left waiting behind a lower priority one on another CPU.
+ *
+ * Input Parameters:
+ *   cpu      - The CPU that will run the task
+ *   priority - Only tasks of higher priority are considered
+ *
+ * Returned Value:
+ *   The TCB of the task, or NULL if there is none.  The task is not
+ *   removed from its run queue.
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_runq_peek(int cpu, int priority)
+{
+  FAR struct tcb_s *btcb = NULL;
+  FAR struct tcb_s *tcb;
+  FAR struct runqueue_s *rq;
+  int prio;
+  int i;
+
+  /* Every task in the local run queue may run on this CPU */
+
+  rq   = &g_runqueue[cpu];
+  prio = nxsched_runq_top(rq, SCHED_PRIORITY_MAX + 1);
+  if (prio > priority)
+    {
+      btcb     = (FAR struct tcb_s *)dq_peek(&rq->queue[prio]);
+      priority = prio;
+    }
+
+  /* Pull from the other run queues only if they hold something better */
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (i == cpu || g_runqueue[i].nready == 0)
+        {
+          continue;
+        }
+
+      rq = &g_runqueue[i];
+      for (prio = nxsched_runq_top(rq, SCHED_PRIORITY_MAX + 1);
+           prio > priority; prio = nxsched_runq_top(rq, prio))
+        {
+          for (tcb = (FAR struct tcb_s *)dq_peek(&rq->queue[prio]);
+               tcb != NULL; tcb = tcb->flink)
+            {
+              if (nxsched_runq_eligible(tcb, cpu))
+                {
+                  btcb     = tcb;
+                  priority = prio;
+                  break;
+                }
+            }
+        }
+    }
+
+  return btcb;
+}
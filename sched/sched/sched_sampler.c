@@ -0,0 +1,278 @@
+/****************************************************************************
+ * sched/sched/sched_sampler.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+
+#include <sys/param.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/wdog.h>
+#include <nuttx/spinlock.h>
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_SAMPLER
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SAMPLER_TICK \
+  MAX(NSEC2TICK(NSEC_PER_SEC / CONFIG_SCHED_SAMPLER_FREQ), 1)
+
+#define SAMPLER_NSTACKS CONFIG_SCHED_SAMPLER_NSTACKS
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The call stacks seen on one CPU.  Only that CPU adds to them, from the
+ * sampling interrupt, the lock is there for the readers.
+ */
+
+struct sampler_cpu_s
+{
+  spinlock_t lock;
+  uint32_t dropped;                /* Samples that found the table full */
+  struct sched_sample_s stacks[SAMPLER_NSTACKS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP
+static int sampler_handler_cpu(FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct sampler_cpu_s g_sampler[CONFIG_SMP_NCPUS];
+static struct wdog_s g_sampler_timer;
+
+#ifdef CONFIG_SMP
+static struct smp_call_data_s g_sampler_call =
+SMP_CALL_INITIALIZER(sampler_handler_cpu, NULL);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sampler_handler_cpu
+ *
+ * Description:
+ *   Take one sample on the calling CPU: unwind the task that was
+ *   interrupted and count its call stack.
+ *
+ ****************************************************************************/
+
+static int sampler_handler_cpu(FAR void *arg)
+{
+  FAR struct sampler_cpu_s *cpu = &g_sampler[this_cpu()];
+  FAR struct tcb_s *tcb = this_task();
+  FAR struct sched_sample_s *stack;
+  FAR void *pcs[CONFIG_SCHED_SAMPLER_DEPTH];
+  uintptr_t hash;
+  size_t index;
+  size_t i;
+  int depth;
+  int j;
+
+  UNUSED(arg);
+
+  depth = up_backtrace(tcb, pcs, CONFIG_SCHED_SAMPLER_DEPTH, 0);
+  if (depth < 0)
+    {
+      depth = 0;
+    }
+
+  hash = tcb->pid;
+  for (j = 0; j < depth; j++)
+    {
+      hash = (hash ^ (uintptr_t)pcs[j]) * 16777619u;
+    }
+
+  spin_lock(&cpu->lock);
+
+  index = hash % SAMPLER_NSTACKS;
+  for (i = 0; i < SAMPLER_NSTACKS; i++)
+    {
+      stack = &cpu->stacks[index];
+      if (stack->count == 0)
+        {
+          stack->pid   = tcb->pid;
+          stack->depth = depth;
+          memcpy(stack->pcs, pcs, depth * sizeof(FAR void *));
+          break;
+        }
+      else if (stack->pid == tcb->pid && stack->depth == depth &&
+               memcmp(stack->pcs, pcs, depth * sizeof(FAR void *)) == 0)
+        {
+          break;
+        }
+
+      index = (index + 1) % SAMPLER_NSTACKS;
+    }
+
+  if (i < SAMPLER_NSTACKS)
+    {
+      stack->count++;
+    }
+  else
+    {
+      cpu->dropped++;
+    }
+
+  spin_unlock(&cpu->lock);
+  return OK;
+}
+
+static void sampler_handler(wdparm_t arg)
+{
+#ifdef CONFIG_SMP
+  cpu_set_t cpus = (1 << CONFIG_SMP_NCPUS) - 1;
+  CPU_CLR(this_cpu(), &cpus);
+  nxsched_smp_call_async(cpus, &g_sampler_call);
+#endif
+
+  sampler_handler_cpu(NULL);
+  wd_start_next(&g_sampler_timer, SAMPLER_TICK, sampler_handler, arg);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_sampler_start
+ *
+ * Description:
+ *   Start sampling the call stack of the running task on every CPU,
+ *   CONFIG_SCHED_SAMPLER_FREQ times per second.  The counts of a previous
+ *   run are kept.
+ *
+ ****************************************************************************/
+
+int nxsched_sampler_start(void)
+{
+  return wd_start(&g_sampler_timer, SAMPLER_TICK, sampler_handler, 0);
+}
+
+/****************************************************************************
+ * Name: nxsched_sampler_stop
+ ****************************************************************************/
+
+void nxsched_sampler_stop(void)
+{
+  wd_cancel(&g_sampler_timer);
+}
+
+/****************************************************************************
+ * Name: nxsched_sampler_reset
+ *
+ * Description:
+ *   Forget all call stacks sampled so far.
+ *
+ ****************************************************************************/
+
+void nxsched_sampler_reset(void)
+{
+  irqstate_t flags;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      flags = spin_lock_irqsave(&g_sampler[i].lock);
+      memset(g_sampler[i].stacks, 0, sizeof(g_sampler[i].stacks));
+      g_sampler[i].dropped = 0;
+      spin_unlock_irqrestore(&g_sampler[i].lock, flags);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_sampler_read
+ *
+ * Description:
+ *   Copy the index'th call stack slot of a CPU.
+ *
+ * Input Parameters:
+ *   cpu    - The CPU
+ *   index  - The slot, from zero up
+ *   sample - Where the call stack goes, a count of zero for an empty slot
+ *
+ * Returned Value:
+ *   OK, or -EINVAL once index is past the last slot.
+ *
+ ****************************************************************************/
+
+int nxsched_sampler_read(int cpu, int index,
+                         FAR struct sched_sample_s *sample)
+{
+  FAR struct sampler_cpu_s *sampler;
+  irqstate_t flags;
+
+  if (cpu < 0 || cpu >= CONFIG_SMP_NCPUS || index < 0 ||
+      index >= SAMPLER_NSTACKS)
+    {
+      return -EINVAL;
+    }
+
+  sampler = &g_sampler[cpu];
+  flags = spin_lock_irqsave(&sampler->lock);
+  *sample = sampler->stacks[index];
+  spin_unlock_irqrestore(&sampler->lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxsched_sampler_dropped
+ *
+ * Description:
+ *   The number of samples of all CPUs that were dropped because the table
+ *   of their CPU was full.
+ *
+ ****************************************************************************/
+
+uint32_t nxsched_sampler_dropped(void)
+{
+  uint32_t dropped = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      dropped += g_sampler[i].dropped;
+    }
+
+  return dropped;
+}
+
+#endif /* CONFIG_SCHED_SAMPLER */
@@ -70,7 +70,9 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
   /* Get the TCB of the next highest priority, ready to run task */
 
-#ifdef CONFIG_SMP
+#if defined(CONFIG_SMP_PERCPU_RUNQUEUE)
+  nxttcb = nxsched_runq_peek(tcb->cpu, sched_priority - 1);
+#elif defined(CONFIG_SMP)
   nxttcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
 #else
   nxttcb = tcb->flink;
@@ -162,7 +164,7 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
   rtcb = this_task();
 
 #ifdef CONFIG_SMP
-  dq_rem((FAR struct dq_entry_s *)tcb, list_readytorun());
+  nxsched_runq_remove(tcb);
   tcb->sched_priority = sched_priority;
   if (nxsched_add_readytorun(tcb))
 #else
@@ -50,8 +50,13 @@ struct smp_call_cookie_s
  * Private Data
  ****************************************************************************/
 
+/* The calls pending on each CPU.  A CPU gets an interrupt only when a call
+ * is added to its empty queue, the handler takes the calls until the queue
+ * is empty again.
+ */
+
 static sq_queue_t g_smp_call_queue[CONFIG_SMP_NCPUS];
-static spinlock_t g_smp_call_lock;
+static spinlock_t g_smp_call_lock[CONFIG_SMP_NCPUS];
 
 /****************************************************************************
  * Private Functions
@@ -64,26 +69,31 @@ static spinlock_t g_smp_call_lock;
  *   Add call data to other processors
  *
  * Input Parameters:
- *   cpu        - Target cpu id
+ *   cpu   - Target cpu id
  *   data  - Call data
  *
  * Returned Value:
- *   None
+ *   True if the queue was empty and the cpu must be interrupted, false if
+ *   an interrupt is pending already or its handler is still running.
  *
  ****************************************************************************/
 
-static void nxsched_smp_call_add(int cpu,
+static bool nxsched_smp_call_add(int cpu,
                                  FAR struct smp_call_data_s *data)
 {
+  FAR sq_queue_t *call_queue = &g_smp_call_queue[cpu];
   irqstate_t flags;
+  bool empty;
 
-  flags = spin_lock_irqsave(&g_smp_call_lock);
-  if (!sq_inqueue(&data->node[cpu], &g_smp_call_queue[cpu]))
+  flags = spin_lock_irqsave(&g_smp_call_lock[cpu]);
+  empty = sq_empty(call_queue);
+  if (!sq_inqueue(&data->node[cpu], call_queue))
     {
-      sq_addlast(&data->node[cpu], &g_smp_call_queue[cpu]);
+      sq_addlast(&data->node[cpu], call_queue);
     }
 
-  spin_unlock_irqrestore(&g_smp_call_lock, flags);
+  spin_unlock_irqrestore(&g_smp_call_lock[cpu], flags);
+  return empty;
 }
 
 /****************************************************************************
@@ -109,41 +119,43 @@ static void nxsched_smp_call_add(int cpu,
 int nxsched_smp_call_handler(int irq, FAR void *context,
                              FAR void *arg)
 {
+  FAR struct smp_call_cookie_s *cookie;
+  FAR struct smp_call_data_s *data;
   FAR sq_queue_t *call_queue;
   FAR sq_entry_t *curr;
-  FAR sq_entry_t *next;
   int cpu = this_cpu();
-
-  irqstate_t flags = spin_lock_irqsave(&g_smp_call_lock);
+  irqstate_t flags;
+  int ret;
 
   call_queue = &g_smp_call_queue[cpu];
 
-  sq_for_every_safe(call_queue, curr, next)
-    {
-      FAR struct smp_call_data_s *data =
-        container_of(curr, struct smp_call_data_s, node[cpu]);
-      int ret;
-
-      sq_rem(&data->node[cpu], call_queue);
+  /* Take the calls until the queue is empty, including those added while
+   * a call runs, no interrupt was sent for them.
+   */
 
-      spin_unlock_irqrestore(&g_smp_call_lock, flags);
+  flags = spin_lock_irqsave(&g_smp_call_lock[cpu]);
+  while ((curr = sq_remfirst(call_queue)) != NULL)
+    {
+      data = container_of(curr, struct smp_call_data_s, node[cpu]);
+      spin_unlock_irqrestore(&g_smp_call_lock[cpu], flags);
 
+      cookie = data->cookie;
       ret = data->func(data->arg);
 
-      flags = spin_lock_irqsave(&g_smp_call_lock);
-
-      if (data->cookie != NULL)
+      if (cookie != NULL)
         {
           if (ret < 0)
             {
-              data->cookie->error = ret;
+              cookie->error = ret;
             }
 
-          nxsem_post(&data->cookie->sem);
+          nxsem_post(&cookie->sem);
         }
+
+      flags = spin_lock_irqsave(&g_smp_call_lock[cpu]);
     }
 
-  spin_unlock_irqrestore(&g_smp_call_lock, flags);
+  spin_unlock_irqrestore(&g_smp_call_lock[cpu], flags);
   return OK;
 }
 
@@ -303,6 +315,7 @@ int nxsched_smp_call_single_async(int cpuid,
 int nxsched_smp_call_async(cpu_set_t cpuset,
                            FAR struct smp_call_data_s *data)
 {
+  cpu_set_t ipiset;
   int cpucnt;
   int ret = OK;
   int i;
@@ -336,11 +349,16 @@ int nxsched_smp_call_async(cpu_set_t cpuset,
       goto out;
     }
 
+  CPU_ZERO(&ipiset);
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
     {
       if (CPU_ISSET(i, &cpuset))
         {
-          nxsched_smp_call_add(i, data);
+          if (nxsched_smp_call_add(i, data))
+            {
+              CPU_SET(i, &ipiset);
+            }
+
           if (--cpucnt == 0)
             {
               break;
@@ -348,7 +366,10 @@ int nxsched_smp_call_async(cpu_set_t cpuset,
         }
     }
 
-  up_send_smp_call(cpuset);
+  if (CPU_COUNT(&ipiset) > 0)
+    {
+      up_send_smp_call(ipiset);
+    }
 
 out:
   if (!up_interrupt_context())
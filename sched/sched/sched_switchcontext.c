@@ -27,6 +27,7 @@
 #include "sched/sched.h"
 
 #include <nuttx/sched_note.h>
+#include <nuttx/tracepoint.h>
 
 /****************************************************************************
  * Public Functions
@@ -71,8 +72,41 @@ void nxsched_switch_context(FAR struct tcb_s *from, FAR struct tcb_s *to)
   nxsched_switch_critmon(from, to);
 #endif
 
+#ifdef CONFIG_SCHED_PMU
+  nxsched_switch_pmu(from);
+#endif
+
+#ifdef CONFIG_SCHED_LATENCY
+  nxsched_switch_latency(to);
+#endif
+
+#ifdef CONFIG_SCHED_PRESSURE
+  nxsched_switch_pressure(from, to);
+#endif
+
+#ifdef CONFIG_SCHED_RUSAGE
+  /* A task that is still ready to run was preempted, a blocked one gave
+   * up the CPU itself.
+   */
+
+  if (from != to)
+    {
+      if (from->task_state < FIRST_BLOCKED_STATE)
+        {
+          from->nivcsw++;
+        }
+      else
+        {
+          from->nvcsw++;
+        }
+    }
+#endif
+
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_suspend(from);
   sched_note_resume(to);
 #endif
+
+  tracepoint(SCHED_SWITCH, NOTE_TAG_SCHED, "switch %d %d",
+             from->pid, to->pid);
 }
@@ -0,0 +1,173 @@
+/****************************************************************************
+ * sched/sched/sched_tcbcache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#if CONFIG_SCHED_TCBCACHE > 0
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* TCBs released by exiting threads, each one keeps its stack if it had one
+ * allocated by up_create_stack().  Only used in a critical section.
+ */
+
+static FAR struct tcb_s *g_tcbcache[CONFIG_SCHED_TCBCACHE];
+static int g_ntcbcache;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_alloc_tcb
+ *
+ * Description:
+ *   Allocate a zeroed TCB of size bytes, from the cache of released TCBs
+ *   if one is large enough.  A cached TCB keeps its stack,
+ *   up_create_stack() uses it again if it has the requested size.
+ *
+ * Input Parameters:
+ *   size  - The size of the TCB
+ *   ttype - The type of the thread that gets the TCB
+ *
+ * Returned Value:
+ *   The TCB or NULL if there is no memory.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsched_alloc_tcb(size_t size, uint8_t ttype)
+{
+  FAR struct tcb_s *tcb = NULL;
+  FAR void *stack_alloc_ptr;
+  size_t adj_stack_size;
+  irqstate_t flags;
+  uint8_t stype;
+  int i;
+
+  flags = enter_critical_section();
+  for (i = g_ntcbcache - 1; i >= 0; i--)
+    {
+      if (kmm_malloc_size(g_tcbcache[i]) >= size)
+        {
+          tcb = g_tcbcache[i];
+          g_tcbcache[i] = g_tcbcache[--g_ntcbcache];
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  if (tcb == NULL)
+    {
+      return kmm_zalloc(size);
+    }
+
+  /* Kernel threads and the others may have their stacks in different
+   * heaps, the stack of the other kind is not used.
+   */
+
+  stype = tcb->flags & TCB_FLAG_TTYPE_MASK;
+  if (tcb->stack_alloc_ptr != NULL &&
+      (stype == TCB_FLAG_TTYPE_KERNEL) != (ttype == TCB_FLAG_TTYPE_KERNEL))
+    {
+      up_release_stack(tcb, stype);
+    }
+
+  stack_alloc_ptr = tcb->stack_alloc_ptr;
+  adj_stack_size  = tcb->adj_stack_size;
+
+  memset(tcb, 0, size);
+  if (stack_alloc_ptr != NULL)
+    {
+      tcb->stack_alloc_ptr = stack_alloc_ptr;
+      tcb->stack_base_ptr  = stack_alloc_ptr;
+      tcb->adj_stack_size  = adj_stack_size;
+      tcb->flags           = TCB_FLAG_FREE_STACK;
+    }
+
+  return tcb;
+}
+
+/****************************************************************************
+ * Name: nxsched_free_tcb
+ *
+ * Description:
+ *   Put a TCB allocated by nxsched_alloc_tcb() and all that has been
+ *   released in the cache, together with its stack.  The TCB and the stack
+ *   are freed if the cache is full.
+ *
+ * Input Parameters:
+ *   tcb   - The TCB to be freed
+ *   ttype - The type of the thread that had the TCB
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsched_free_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
+{
+  irqstate_t flags;
+
+  /* A stack that the thread did not allocate is not kept */
+
+  if (tcb->stack_alloc_ptr != NULL &&
+      (tcb->flags & TCB_FLAG_FREE_STACK) == 0)
+    {
+      tcb->stack_alloc_ptr = NULL;
+    }
+
+  flags = enter_critical_section();
+  if (g_ntcbcache < CONFIG_SCHED_TCBCACHE)
+    {
+      tcb->flags = (tcb->flags & ~TCB_FLAG_TTYPE_MASK) | ttype;
+      g_tcbcache[g_ntcbcache++] = tcb;
+      leave_critical_section(flags);
+      return;
+    }
+
+  leave_critical_section(flags);
+
+  if (tcb->stack_alloc_ptr != NULL)
+    {
+      up_release_stack(tcb, ttype);
+    }
+
+  kmm_free(tcb);
+}
+
+#endif /* CONFIG_SCHED_TCBCACHE > 0 */
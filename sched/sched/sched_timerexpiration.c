@@ -40,6 +40,7 @@
 #include "sched/sched.h"
 #include "wdog/wdog.h"
 #include "clock/clock.h"
+#include "hrtimer/hrtimer.h"
 
 #ifdef CONFIG_CLOCK_TIMEKEEPING
 #  include "clock/clock_timekeeping.h"
@@ -380,6 +381,9 @@ static clock_t nxsched_timer_start(clock_t ticks, clock_t interval)
  *   the RTOS base code and called from platform-specific code when the
  *   interval timer used to implement the tick-less OS expires.
  *
+ *   With CONFIG_HRTIMER the timer is armed for the first hrtimer, which
+ *   are processed here; the watchdogs are run by one of them.
+ *
  * Input Parameters:
  *
  * Returned Value:
@@ -390,6 +394,9 @@ static clock_t nxsched_timer_start(clock_t ticks, clock_t interval)
 
 void nxsched_tick_expiration(void)
 {
+#ifdef CONFIG_HRTIMER
+  hrtimer_process(hrtimer_gettime());
+#else
   irqstate_t flags;
   clock_t ticks;
 
@@ -400,6 +407,7 @@ void nxsched_tick_expiration(void)
   wd_timer(ticks);
 
   leave_critical_section(flags);
+#endif
 }
 
 /****************************************************************************
@@ -89,7 +89,11 @@ void sched_unlock(void)
            * this task to be switched out!
            */
 
-#ifdef CONFIG_SMP
+#if defined(CONFIG_SMP_PERCPU_RUNQUEUE)
+          ptcb = nxsched_runq_peek(rtcb->cpu, rtcb->sched_priority);
+          if (ptcb &&
+              nxsched_deliver_task(rtcb->cpu, rtcb->cpu, SWITCH_HIGHER))
+#elif defined(CONFIG_SMP)
           ptcb = (FAR struct tcb_s *)dq_peek(list_readytorun());
           if (ptcb && ptcb->sched_priority > rtcb->sched_priority &&
               nxsched_deliver_task(rtcb->cpu, rtcb->cpu, SWITCH_HIGHER))
@@ -38,6 +38,88 @@
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#if defined(CONFIG_SEM_ADAPTIVE_SPIN) && CONFIG_SEM_ADAPTIVE_SPIN > 0
+
+/****************************************************************************
+ * Name: nxsem_holder_running
+ *
+ * Description:
+ *   Return true if the holder of a mutex runs on another CPU right now.
+ *   The running tasks are looked at without a lock, a stale answer only
+ *   makes the caller spin or block a little early.
+ *
+ ****************************************************************************/
+
+static bool nxsem_holder_running(pid_t holder)
+{
+  int me = this_cpu();
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      FAR struct tcb_s *tcb = current_task(cpu);
+
+      if (cpu != me && tcb != NULL && tcb->pid == holder)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_spin
+ *
+ * Description:
+ *   Spin on a held mutex while its holder runs on another CPU, a short
+ *   critical section is over long before a block and wake up would be.
+ *   Stop as soon as the holder is not running, somebody is already
+ *   blocked on the mutex (so the waiters keep their order), or after
+ *   CONFIG_SEM_ADAPTIVE_SPIN polls.
+ *
+ * Returned Value:
+ *   True if the mutex was taken.
+ *
+ ****************************************************************************/
+
+static bool nxsem_spin(FAR sem_t *sem)
+{
+  FAR atomic_t *val = NXSEM_MHOLDER(sem);
+  int32_t old;
+  int i;
+
+#ifdef CONFIG_PRIORITY_PROTECT
+  if ((sem->flags & SEM_PRIO_MASK) == SEM_PRIO_PROTECT)
+    {
+      return false;
+    }
+#endif
+
+  for (i = 0; i < CONFIG_SEM_ADAPTIVE_SPIN; i++)
+    {
+      old = atomic_read(val);
+      if (old == NXSEM_NO_MHOLDER)
+        {
+          if (atomic_try_cmpxchg_acquire(val, &old, nxsched_gettid()))
+            {
+              return true;
+            }
+        }
+      else if (NXSEM_MBLOCKING(old) || !nxsem_holder_running(old))
+        {
+          break;
+        }
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -78,6 +160,15 @@ int nxsem_wait_slow(FAR sem_t *sem)
   FAR struct tcb_s *htcb = NULL;
   bool mutex = NXSEM_IS_MUTEX(sem);
 
+#if defined(CONFIG_SEM_ADAPTIVE_SPIN) && CONFIG_SEM_ADAPTIVE_SPIN > 0
+  /* A mutex held by a task on another CPU is likely released soon */
+
+  if (mutex && !up_interrupt_context() && nxsem_spin(sem))
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -0,0 +1,256 @@
+/****************************************************************************
+ * sched/semaphore/sem_waitqueue.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/waitqueue.h>
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A thread blocked on the queue, on its own stack */
+
+struct waitq_waiter_s
+{
+  struct list_node node;
+  sem_t            sem;
+  bool             exclusive;
+};
+
+/* A poll setup on the queue */
+
+struct waitq_poller_s
+{
+  struct list_node   node;
+  FAR struct pollfd *fds;
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxwaitq_init
+ *
+ * Description:
+ *   Initialize an empty wait queue.
+ *
+ ****************************************************************************/
+
+void nxwaitq_init(FAR waitq_t *wq)
+{
+  list_initialize(&wq->waiters);
+  list_initialize(&wq->pollers);
+}
+
+/****************************************************************************
+ * Name: nxwaitq_wait
+ *
+ * Description:
+ *   Block the calling thread until the queue is woken.  The caller checks
+ *   its condition with lock held, lock is released once the thread is on
+ *   the queue.  With lock NULL the caller must be in a critical section.
+ *
+ * Input Parameters:
+ *   wq        - The wait queue
+ *   lock      - The lock that protects the condition, or NULL
+ *   exclusive - Whether the thread waits exclusively
+ *
+ * Returned Value:
+ *   Zero (OK) with lock held again after a wake-up.  A negated errno value
+ *   if the wait was interrupted, lock is not held in that case.
+ *
+ ****************************************************************************/
+
+int nxwaitq_wait(FAR waitq_t *wq, FAR mutex_t *lock, bool exclusive)
+{
+  struct waitq_waiter_s waiter;
+  irqstate_t flags;
+  int ret;
+
+  nxsem_init(&waiter.sem, 0, 0);
+  waiter.exclusive = exclusive;
+
+  flags = enter_critical_section();
+  if (exclusive)
+    {
+      list_add_tail(&wq->waiters, &waiter.node);
+    }
+  else
+    {
+      list_add_head(&wq->waiters, &waiter.node);
+    }
+
+  if (lock != NULL)
+    {
+      nxmutex_unlock(lock);
+    }
+
+  ret = nxsem_wait(&waiter.sem);
+  if (ret < 0)
+    {
+      if (list_in_list(&waiter.node))
+        {
+          list_delete(&waiter.node);
+        }
+      else if (exclusive)
+        {
+          /* Woken but interrupted, hand the wake-up to the next one */
+
+          nxwaitq_wake(wq, false);
+        }
+    }
+
+  leave_critical_section(flags);
+  nxsem_destroy(&waiter.sem);
+
+  if (ret >= 0 && lock != NULL)
+    {
+      ret = nxmutex_lock(lock);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: nxwaitq_wake
+ *
+ * Description:
+ *   Wake the threads blocked on the queue, all of the non-exclusive ones
+ *   and the first exclusive one, or all of them.
+ *
+ * Input Parameters:
+ *   wq  - The wait queue
+ *   all - Wake all of the exclusive waiters too
+ *
+ ****************************************************************************/
+
+void nxwaitq_wake(FAR waitq_t *wq, bool all)
+{
+  FAR struct waitq_waiter_s *waiter;
+  FAR struct waitq_waiter_s *tmp;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  list_for_every_entry_safe(&wq->waiters, waiter, tmp,
+                            struct waitq_waiter_s, node)
+    {
+      list_delete(&waiter->node);
+      nxsem_post(&waiter->sem);
+      if (waiter->exclusive && !all)
+        {
+          break;
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: nxwaitq_poll
+ *
+ * Description:
+ *   Add a poll setup to the queue or remove it.
+ *
+ * Input Parameters:
+ *   wq    - The wait queue
+ *   fds   - The poll structure, its priv field is used by the queue
+ *   setup - true: Setup up the poll; false: Teardown the poll
+ *
+ * Returned Value:
+ *   Zero (OK) on success, -ENOMEM if the setup could not be allocated.
+ *
+ ****************************************************************************/
+
+int nxwaitq_poll(FAR waitq_t *wq, FAR struct pollfd *fds, bool setup)
+{
+  FAR struct waitq_poller_s *poller;
+  irqstate_t flags;
+
+  if (setup)
+    {
+      poller = kmm_malloc(sizeof(struct waitq_poller_s));
+      if (poller == NULL)
+        {
+          fds->priv = NULL;
+          return -ENOMEM;
+        }
+
+      poller->fds = fds;
+      fds->priv   = poller;
+
+      flags = enter_critical_section();
+      list_add_tail(&wq->pollers, &poller->node);
+      leave_critical_section(flags);
+    }
+  else
+    {
+      poller = fds->priv;
+      if (poller != NULL)
+        {
+          flags = enter_critical_section();
+          list_delete(&poller->node);
+          leave_critical_section(flags);
+
+          fds->priv = NULL;
+          kmm_free(poller);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxwaitq_notify
+ *
+ * Description:
+ *   Report poll events to all of the poll setups of the queue.
+ *
+ * Input Parameters:
+ *   wq       - The wait queue
+ *   eventset - The events
+ *
+ ****************************************************************************/
+
+void nxwaitq_notify(FAR waitq_t *wq, pollevent_t eventset)
+{
+  FAR struct waitq_poller_s *poller;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  list_for_every_entry(&wq->pollers, poller, struct waitq_poller_s, node)
+    {
+      poll_notify(&poller->fds, 1, eventset);
+    }
+
+  leave_critical_section(flags);
+}
@@ -98,4 +98,6 @@ void nxsig_release(FAR struct task_group_s *group)
     {
       nxsig_release_pendingsignal(sigpend);
     }
+
+  sigemptyset(&group->tg_sigpendset);
 }
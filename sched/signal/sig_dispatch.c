@@ -249,6 +249,13 @@ nxsig_find_pendingsignal(FAR struct task_group_s *group, int signo)
       return sigpend;
     }
 
+  /* There is no need to search the list if the signal is not pending */
+
+  if (nxsig_ismember(&group->tg_sigpendset, signo) != 1)
+    {
+      return sigpend;
+    }
+
   /* Search the list for a action pending on this signal */
 
   for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
@@ -332,6 +339,7 @@ static FAR sigpendq_t *nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
           /* Add the structure to the group pending signal list */
 
           sq_addlast((FAR sq_entry_t *)sigpend, &group->tg_sigpendingq);
+          nxsig_addset(&group->tg_sigpendset, info->si_signo);
         }
     }
 
@@ -340,6 +348,73 @@ static FAR sigpendq_t *nxsig_add_pendingsignal(FAR struct tcb_s *stcb,
   return sigpend;
 }
 
+/****************************************************************************
+ * Name: nxsig_wakeup
+ *
+ * Description:
+ *   Wake up a task that is blocked in TSTATE_WAIT_SIG with the signal info.
+ *
+ * Assumptions:
+ *   Called in critical section
+ *
+ ****************************************************************************/
+
+static void nxsig_wakeup(FAR struct tcb_s *stcb, FAR siginfo_t *info)
+{
+  FAR struct tcb_s *rtcb = this_task();
+
+  if (stcb->sigunbinfo != NULL)
+    {
+      memcpy(stcb->sigunbinfo, info, sizeof(siginfo_t));
+    }
+
+  sigemptyset(&stcb->sigwaitmask);
+  wd_cancel(&stcb->waitdog);
+
+  /* Remove the task from waiting list */
+
+  dq_rem((FAR dq_entry_t *)stcb, list_waitingforsignal());
+
+  /* Add the task to ready-to-run task list and
+   * perform the context switch if one is needed
+   */
+
+  if (nxsched_add_readytorun(stcb))
+    {
+      up_switch_context(this_task(), rtcb);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsig_handoff
+ *
+ * Description:
+ *   Hand the signal directly to a task that waits for it with the signal
+ *   blocked, in sigwaitinfo(), sigtimedwait() or the read of a signalfd.
+ *   Nothing is queued then, so no pending signal structure is needed and
+ *   no signal action looked up.
+ *
+ * Returned Value:
+ *   True if the signal was handed to the task.
+ *
+ * Assumptions:
+ *   Called in critical section
+ *
+ ****************************************************************************/
+
+static bool nxsig_handoff(FAR struct tcb_s *stcb, FAR siginfo_t *info)
+{
+  if (stcb->task_state != TSTATE_WAIT_SIG ||
+      nxsig_ismember(&stcb->sigprocmask, info->si_signo) != 1 ||
+      nxsig_ismember(&stcb->sigwaitmask, info->si_signo) != 1)
+    {
+      return false;
+    }
+
+  nxsig_wakeup(stcb, info);
+  return true;
+}
+
 /****************************************************************************
  * Name: nxsig_alloc_dyn_pending
  *
@@ -458,7 +533,6 @@ static int nxsig_alloc_dyn_pending(FAR irqstate_t *flags)
 int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info,
                       bool group_dispatch)
 {
-  FAR struct tcb_s *rtcb = this_task();
   FAR sigactq_t *sigact;
   irqstate_t flags;
   int masked;
@@ -486,14 +560,22 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info,
       return OK;
     }
 
+  flags = enter_critical_section();
+
+  /* The fast path: the task is blocked waiting for this signal */
+
+  if (nxsig_handoff(stcb, info))
+    {
+      leave_critical_section(flags);
+      return OK;
+    }
+
   /************************** MASKED SIGNAL ACTIONS *************************/
 
   /* Find if there is a group sigaction associated with this signal */
 
   sigact = nxsig_find_action(stcb->group, info->si_signo);
 
-  flags = enter_critical_section();
-
   /* Make sure that there is always at least one sigpednq and sigq structure
    * available, in case one needs to be queued later. Note that this breaks
    * the critical section if it needs to allocate any new structures. So it
@@ -552,26 +634,7 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info,
           (masked == 0 ||
            (nxsig_ismember(&stcb->sigwaitmask, info->si_signo) == 1)))
         {
-          if (stcb->sigunbinfo != NULL)
-            {
-              memcpy(stcb->sigunbinfo, info, sizeof(siginfo_t));
-            }
-
-          sigemptyset(&stcb->sigwaitmask);
-          wd_cancel(&stcb->waitdog);
-
-          /* Remove the task from waiting list */
-
-          dq_rem((FAR dq_entry_t *)stcb, list_waitingforsignal());
-
-          /* Add the task to ready-to-run task list and
-           * perform the context switch if one is needed
-           */
-
-          if (nxsched_add_readytorun(stcb))
-            {
-              up_switch_context(this_task(), rtcb);
-            }
+          nxsig_wakeup(stcb, info);
 
 #ifdef CONFIG_LIB_SYSCALL
           /* Must also add signal action if in system call */
@@ -610,26 +673,7 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info,
 
       if (stcb->task_state == TSTATE_WAIT_SIG)
         {
-          if (stcb->sigunbinfo != NULL)
-            {
-              memcpy(stcb->sigunbinfo, info, sizeof(siginfo_t));
-            }
-
-          sigemptyset(&stcb->sigwaitmask);
-          wd_cancel(&stcb->waitdog);
-
-          /* Remove the task from waiting list */
-
-          dq_rem((FAR dq_entry_t *)stcb, list_waitingforsignal());
-
-          /* Add the task to ready-to-run task list and
-           * perform the context switch if one is needed
-           */
-
-          if (nxsched_add_readytorun(stcb))
-            {
-              up_switch_context(this_task(), rtcb);
-            }
+          nxsig_wakeup(stcb, info);
         }
 
       /* If the task neither was waiting for the signal nor had a signal
@@ -678,6 +722,8 @@ int nxsig_tcbdispatch(FAR struct tcb_s *stcb, siginfo_t *info,
 #ifdef HAVE_GROUP_MEMBERS
           group_continue(stcb);
 #else
+          FAR struct tcb_s *rtcb = this_task();
+
           /* Remove the task from waiting list */
 
           dq_rem((FAR dq_entry_t *)stcb, list_stoppedtasks());
@@ -94,6 +94,13 @@ sigset_t nxsig_pendingset(FAR struct tcb_s *stcb)
 
   sigemptyset(&sigpendset);
 
+  /* Most of the time nothing is pending at all */
+
+  if (sigisemptyset(&group->tg_sigpendset))
+    {
+      return sigpendset;
+    }
+
   flags = enter_critical_section();
   for (sigpend = (FAR sigpendq_t *)group->tg_sigpendingq.head;
        (sigpend); sigpend = sigpend->flink)
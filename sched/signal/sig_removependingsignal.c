@@ -37,6 +37,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/signal.h>
 
 #include "signal/signal.h"
 
@@ -83,6 +84,21 @@ FAR sigpendq_t *nxsig_remove_pendingsignal(FAR struct tcb_s *stcb, int signo)
         {
           sq_remfirst(&group->tg_sigpendingq);
         }
+
+      /* Only the real time signals may be pending more than once */
+
+      prevsig = NULL;
+      if (SIGRTMIN <= signo && signo <= SIGRTMAX)
+        {
+          for (prevsig = (FAR sigpendq_t *)group->tg_sigpendingq.head;
+               prevsig && prevsig->info.si_signo != signo;
+               prevsig = prevsig->flink);
+        }
+
+      if (prevsig == NULL)
+        {
+          nxsig_delset(&group->tg_sigpendset, signo);
+        }
     }
 
   leave_critical_section(flags);
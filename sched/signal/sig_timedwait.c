@@ -38,7 +38,9 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/signal.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/queue.h>
@@ -91,6 +93,38 @@ static void nxsig_timeout(wdparm_t arg)
   leave_critical_section(flags);
 }
 
+/****************************************************************************
+ * Name: nxsig_hrtimeout
+ *
+ * Description:
+ *   The hrtimer counterpart of nxsig_timeout().  hrtimer callbacks do not
+ *   run in the critical section, so the wait may have ended, and the timer
+ *   been cancelled or restarted for the next wait, while this callback was
+ *   waiting for it.  hrtimer_cancel() and hrtimer_start() both change the
+ *   expiration time, which is used to detect that.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static uint64_t nxsig_hrtimeout(FAR const hrtimer_t *hrtimer,
+                                uint64_t expired)
+{
+  FAR struct tcb_s *wtcb = container_of(hrtimer, struct tcb_s,
+                                        waithrtimer);
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  if (hrtimer->expired == expired && wtcb->task_state == TSTATE_WAIT_SIG)
+    {
+      nxsig_wait_irq(wtcb, SIG_WAIT_TIMEOUT, SI_TIMER, ETIMEDOUT);
+    }
+
+  leave_critical_section(flags);
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -186,8 +220,13 @@ int nxsig_clockwait(int clockid, int flags,
 {
   FAR struct tcb_s *rtcb;
   irqstate_t        iflags;
+#ifdef CONFIG_HRTIMER
+  uint64_t expect = 0;
+  uint64_t stop;
+#else
   clock_t expect = 0;
   clock_t stop;
+#endif
 
   if (rqtp && (rqtp->tv_nsec < 0 || rqtp->tv_nsec >= 1000000000))
     {
@@ -233,6 +272,24 @@ int nxsig_clockwait(int clockid, int flags,
 
   if (rqtp)
     {
+#ifdef CONFIG_HRTIMER
+      /* Start the hrtimer, it may share the wakeup of another timer
+       * that expires within the slack.
+       */
+
+      if ((flags & TIMER_ABSTIME) == 0)
+        {
+          expect = hrtimer_gettime() + clock_time2nsec(rqtp);
+        }
+      else
+        {
+          expect = hrtimer_abstime2ns(clockid, rqtp);
+        }
+
+      rtcb->waithrtimer.func = nxsig_hrtimeout;
+      hrtimer_start_range(&rtcb->waithrtimer, expect,
+                          HRTIMER_DEFAULT_SLACK, HRTIMER_MODE_ABS);
+#else
       /* Start the watchdog timer */
 
       if ((flags & TIMER_ABSTIME) == 0)
@@ -257,6 +314,7 @@ int nxsig_clockwait(int clockid, int flags,
 
         wd_start_abstick(&rtcb->waitdog, expect,
                          nxsig_timeout, (uintptr_t)rtcb);
+#endif
     }
 
   /* Remove the tcb task from the ready-to-run list. */
@@ -276,15 +334,24 @@ int nxsig_clockwait(int clockid, int flags,
 
   if (rqtp)
     {
+#ifdef CONFIG_HRTIMER
+      hrtimer_cancel(&rtcb->waithrtimer);
+      stop = hrtimer_gettime();
+#else
       stop = clock_systime_ticks();
+#endif
     }
 
   leave_critical_section(iflags);
 
   if (rqtp && rmtp && expect)
     {
+#ifdef CONFIG_HRTIMER
+      clock_nsec2time(rmtp, clock_compare(stop, expect) ? 0 : expect - stop);
+#else
       clock_ticks2time(rmtp,
                        clock_compare(stop, expect) ? expect - stop : 0);
+#endif
     }
 
   return 0;
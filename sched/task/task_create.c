@@ -84,7 +84,7 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = kmm_zalloc(sizeof(struct tcb_s));
+  tcb = nxsched_alloc_tcb(sizeof(struct tcb_s), ttype);
   if (!tcb)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -93,7 +93,7 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
 
   /* Setup the task type */
 
-  tcb->flags = ttype | TCB_FLAG_FREE_TCB;
+  tcb->flags |= ttype | TCB_FLAG_FREE_TCB;
 
   /* Initialize the task */
 
@@ -101,7 +101,7 @@ int nxthread_create(FAR const char *name, uint8_t ttype, int priority,
                     stack_addr, stack_size, entry, argv, envp, NULL);
   if (ret < OK)
     {
-      kmm_free(tcb);
+      nxsched_free_tcb(tcb, ttype);
       return ret;
     }
 
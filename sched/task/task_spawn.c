@@ -92,7 +92,7 @@ static int nxtask_spawn_create(FAR const char *name, int priority,
 
   /* Allocate a TCB for the new task. */
 
-  tcb = kmm_zalloc(sizeof(struct tcb_s));
+  tcb = nxsched_alloc_tcb(sizeof(struct tcb_s), TCB_FLAG_TTYPE_TASK);
   if (tcb == NULL)
     {
       serr("ERROR: Failed to allocate TCB\n");
@@ -101,7 +101,7 @@ static int nxtask_spawn_create(FAR const char *name, int priority,
 
   /* Setup the task type */
 
-  tcb->flags = TCB_FLAG_TTYPE_TASK | TCB_FLAG_FREE_TCB;
+  tcb->flags |= TCB_FLAG_TTYPE_TASK | TCB_FLAG_FREE_TCB;
 
   /* Initialize the task */
 
@@ -109,7 +109,7 @@ static int nxtask_spawn_create(FAR const char *name, int priority,
                     entry, argv, envp, actions);
   if (ret < OK)
     {
-      kmm_free(tcb);
+      nxsched_free_tcb(tcb, TCB_FLAG_TTYPE_TASK);
       return ret;
     }
 
@@ -35,6 +35,7 @@
 #include <nuttx/compiler.h>
 #include <nuttx/signal.h>
 #include <nuttx/wdog.h>
+#include <nuttx/hrtimer.h>
 #include <nuttx/spinlock.h>
 
 #ifndef CONFIG_DISABLE_POSIX_TIMERS
@@ -60,9 +61,14 @@ struct posix_timer_s
   uint8_t          pt_crefs;       /* Reference count */
   pid_t            pt_owner;       /* Creator of timer */
   int              pt_overrun;     /* Overrun time */
+#ifdef CONFIG_HRTIMER
+  uint64_t         pt_interval;    /* If non-zero, the period (ns) of repetitive timers */
+  hrtimer_t        pt_hrtimer;     /* The hrtimer that provides the timing */
+#else
   sclock_t         pt_delay;       /* If non-zero, used to reset repetitive timers */
   clock_t          pt_expected;    /* Expected absolute time */
   struct wdog_s    pt_wdog;        /* The watchdog that provides the timing */
+#endif
   struct sigevent  pt_event;       /* Notification information */
 #ifdef CONFIG_SIG_EVTHREAD
   struct sigwork_s pt_work;
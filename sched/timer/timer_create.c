@@ -186,8 +186,13 @@ int timer_create(clockid_t clockid, FAR struct sigevent *evp,
   ret->pt_clock = clockid;
   ret->pt_crefs = 1;
   ret->pt_owner = tcb->pid;
+#ifdef CONFIG_HRTIMER
+  ret->pt_interval = 0;
+  hrtimer_init(&ret->pt_hrtimer, NULL);
+#else
   ret->pt_delay = 0;
   ret->pt_expected = 0;
+#endif
 
   /* Was a struct sigevent provided? */
 
@@ -124,7 +124,11 @@ int timer_release(FAR struct posix_timer_s *timer)
 
   /* Cancel the underlying watchdog instance */
 
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel_sync(&timer->pt_hrtimer);
+#else
   wd_cancel(&timer->pt_wdog);
+#endif
 
   /* Cancel any pending notification */
 
@@ -33,6 +33,7 @@
 #include <errno.h>
 
 #include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
 
 #include "clock/clock.h"
 #include "timer/timer.h"
@@ -44,9 +45,14 @@
  ****************************************************************************/
 
 static inline void timer_signotify(FAR struct posix_timer_s *timer);
+#ifdef CONFIG_HRTIMER
+static uint64_t timer_hrtimeout(FAR const hrtimer_t *hrtimer,
+                                uint64_t expired);
+#else
 static inline void timer_restart(FAR struct posix_timer_s *timer,
                                  wdparm_t itimer);
 static void timer_timeout(wdparm_t itimer);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -81,6 +87,62 @@ static inline void timer_signotify(FAR struct posix_timer_s *timer)
 #endif
 }
 
+/****************************************************************************
+ * Name: timer_hrtimeout
+ *
+ * Description:
+ *   This function is called when the hrtimer of a POSIX timer expires.  It
+ *   sends the signal and, for a repetitive timer, returns the time to its
+ *   next expiration.  Periods that have passed unnoticed are counted as
+ *   overruns instead of being signalled one by one.
+ *
+ * Input Parameters:
+ *   hrtimer - The hrtimer of the POSIX timer
+ *   expired - The expiration time the callback was run for
+ *
+ * Returned Value:
+ *   The time until the next expiration, zero for a one-shot timer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static uint64_t timer_hrtimeout(FAR const hrtimer_t *hrtimer,
+                                uint64_t expired)
+{
+  FAR struct posix_timer_s *timer =
+    container_of(hrtimer, struct posix_timer_s, pt_hrtimer);
+  uint64_t period = 0;
+  uint64_t frame;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+
+  /* Skip the expiration if timer_settime() cancelled or restarted the
+   * timer while this callback was waiting for the critical section.
+   */
+
+  if (hrtimer->expired == expired)
+    {
+      /* Hold a reference so that the timer is not deleted until after
+       * the signal is sent.
+       */
+
+      timer->pt_crefs++;
+      timer_signotify(timer);
+
+      if (timer_release(timer) && timer->pt_interval > 0)
+        {
+          frame = (hrtimer_gettime() - hrtimer->softexpired) /
+                  timer->pt_interval + 1;
+          timer->pt_overrun = frame - 1;
+          period = frame * timer->pt_interval;
+        }
+    }
+
+  leave_critical_section(flags);
+  return period;
+}
+#else
 /****************************************************************************
  * Name: timer_restart
  *
@@ -182,6 +244,7 @@ static void timer_timeout(wdparm_t itimer)
       timer_restart(timer, itimer);
     }
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -256,7 +319,9 @@ int timer_settime(timer_t timerid, int flags,
                   FAR struct itimerspec *ovalue)
 {
   FAR struct posix_timer_s *timer = timer_gethandle(timerid);
+#ifndef CONFIG_HRTIMER
   sclock_t delay;
+#endif
   int ret = OK;
 
   /* Some sanity checks */
@@ -269,6 +334,11 @@ int timer_settime(timer_t timerid, int flags,
 
   if (ovalue)
     {
+#ifdef CONFIG_HRTIMER
+      clock_nsec2time(&ovalue->it_value,
+                      hrtimer_gettimeout(&timer->pt_hrtimer));
+      clock_nsec2time(&ovalue->it_interval, timer->pt_interval);
+#else
       /* Get the number of ticks before the underlying watchdog expires */
 
       delay = wd_gettime(&timer->pt_wdog);
@@ -277,13 +347,18 @@ int timer_settime(timer_t timerid, int flags,
 
       clock_ticks2time(&ovalue->it_value, delay);
       clock_ticks2time(&ovalue->it_interval, timer->pt_delay);
+#endif
     }
 
   /* Disarm the timer (in case the timer was already armed when
    * timer_settime() is called).
    */
 
+#ifdef CONFIG_HRTIMER
+  hrtimer_cancel(&timer->pt_hrtimer);
+#else
   wd_cancel(&timer->pt_wdog);
+#endif
 
   /* Cancel any pending notification */
 
@@ -298,6 +373,28 @@ int timer_settime(timer_t timerid, int flags,
       return OK;
     }
 
+#ifdef CONFIG_HRTIMER
+  /* The hrtimer expires at the exact time, or later by up to the slack
+   * to share the wakeup of another timer.
+   */
+
+  timer->pt_interval     = clock_time2nsec(&value->it_interval);
+  timer->pt_hrtimer.func = timer_hrtimeout;
+
+  if ((flags & TIMER_ABSTIME) != 0)
+    {
+      ret = hrtimer_start_range(&timer->pt_hrtimer,
+                                hrtimer_abstime2ns(timer->pt_clock,
+                                                   &value->it_value),
+                                HRTIMER_DEFAULT_SLACK, HRTIMER_MODE_ABS);
+    }
+  else
+    {
+      ret = hrtimer_start_range(&timer->pt_hrtimer,
+                                clock_time2nsec(&value->it_value),
+                                HRTIMER_DEFAULT_SLACK, HRTIMER_MODE_REL);
+    }
+#else
   /* Setup up any repetitive timer */
 
   if (value->it_interval.tv_sec > 0 || value->it_interval.tv_nsec > 0)
@@ -334,6 +431,7 @@ int timer_settime(timer_t timerid, int flags,
 
   ret = wd_start_abstick(&timer->pt_wdog, timer->pt_expected,
                          timer_timeout, (wdparm_t)timer);
+#endif
 
   if (ret < 0)
     {
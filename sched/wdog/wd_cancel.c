@@ -60,7 +60,9 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
   FAR struct wdog_s *first;
+#endif
   irqstate_t         flags;
   int                  ret = -EINVAL;
 
@@ -74,6 +76,20 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
       /* Make sure that the watchdog is valid and still active. */
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+      if (WDOG_ISACTIVE(wdog))
+        {
+          /* Remove the watchdog from its timer wheel bucket and mark it
+           * inactive.  There is no list head to reassess.
+           */
+
+          list_delete_fast(&wdog->node);
+          wdog->func = NULL;
+          g_wdwheelcount--;
+
+          ret = OK;
+        }
+#else
       if (WDOG_ISACTIVE(wdog))
         {
           first = list_first_entry(&g_wdactivelist, struct wdog_s, node);
@@ -105,6 +121,7 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
           ret = OK;
         }
+#endif
 
       leave_critical_section(flags);
       sched_note_wdog(NOTE_WDOG_CANCEL, (FAR void *)wdog->func,
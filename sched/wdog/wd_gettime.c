@@ -75,3 +75,68 @@ sclock_t wd_gettime(FAR struct wdog_s *wdog)
 
   return delay;
 }
+
+/****************************************************************************
+ * Name: wd_gettime_next
+ *
+ * Description:
+ *   This function returns the time remaining before the first active
+ *   watchdog timer expires.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   The time in system ticks remaining until the first watchdog expires,
+ *   CLOCK_MAX if no watchdog is active.  With the timer wheel, the time
+ *   to the end of its first level if no watchdog expires before that.
+ *
+ ****************************************************************************/
+
+clock_t wd_gettime_next(void)
+{
+  irqstate_t flags;
+  clock_t    expired = 0;
+  bool       is_active;
+  sclock_t   delay;
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  clock_t    bound;
+  clock_t    i;
+#endif
+
+  flags = enter_critical_section();
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  /* The watchdogs above the first level expire after its end */
+
+  is_active = g_wdwheelcount > 0;
+  bound     = WDOG_WHEEL_SIZE - (g_wdwheelbase & WDOG_WHEEL_MASK);
+  expired   = g_wdwheelbase + bound;
+
+  for (i = 0; is_active && i < bound; i++)
+    {
+      if (!list_is_empty(
+            &g_wdwheel[0][(g_wdwheelbase + i) & WDOG_WHEEL_MASK]))
+        {
+          expired = g_wdwheelbase + i;
+          break;
+        }
+    }
+#else
+  is_active = !list_is_empty(&g_wdactivelist);
+  if (is_active)
+    {
+      expired = wd_next_expire();
+    }
+#endif
+
+  leave_critical_section(flags);
+
+  if (!is_active)
+    {
+      return CLOCK_MAX;
+    }
+
+  delay = (sclock_t)(expired - clock_systime_ticks());
+  return delay >= 0 ? delay : 0;
+}
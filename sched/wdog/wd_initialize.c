@@ -39,7 +39,17 @@
  * this linked list are removed and the function is called.
  */
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* The buckets of the timer wheel.  They are zeroed here and initialized on
+ * first use, see wd_wheel_initialize().
+ */
+
+struct list_node g_wdwheel[WDOG_WHEEL_LEVELS][WDOG_WHEEL_SIZE];
+clock_t g_wdwheelbase;
+unsigned int g_wdwheelcount;
+#else
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#endif
 
 #ifdef CONFIG_SCHED_TICKLESS
 bool g_wdtimernested;
@@ -85,10 +85,310 @@
 #define wdparm_to_ptr(type, arg) ((type)arg)
 #define ptr_to_wdparm(ptr)       wdparm_to_ptr(wdparm_t, ptr)
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+#  ifdef CONFIG_SYSTEM_TIME64
+#    define WDOG_CLOCK_BITS 64
+#  else
+#    define WDOG_CLOCK_BITS 32
+#  endif
+
+/* The longest delay that the timer wheel can represent.  Watchdogs with a
+ * longer delay are parked in the highest level and cascaded again until
+ * they come into range.
+ */
+
+#  if WDOG_WHEEL_BITS * WDOG_WHEEL_LEVELS < WDOG_CLOCK_BITS
+#    define WDOG_WHEEL_MAXDELAY \
+       (((clock_t)1 << (WDOG_WHEEL_BITS * WDOG_WHEEL_LEVELS)) - 1)
+#  else
+#    define WDOG_WHEEL_MAXDELAY WDOG_MAX_DELAY
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static uint64_t wd_hrtimer_expired(FAR const hrtimer_t *hrtimer,
+                                   uint64_t expired);
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+hrtimer_t g_wdhrtimer =
+{
+  .func = wd_hrtimer_expired
+};
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Name: wd_wheel_initialize
+ *
+ * Description:
+ *   Initialize the buckets of the timer wheel.  This is done on the first
+ *   wd_start() so that watchdogs may be used before any explicit
+ *   initialization has been performed.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_initialize(void)
+{
+  int level;
+  int index;
+
+  for (level = 0; level < WDOG_WHEEL_LEVELS; level++)
+    {
+      for (index = 0; index < WDOG_WHEEL_SIZE; index++)
+        {
+          list_initialize(&g_wdwheel[level][index]);
+        }
+    }
+
+  g_wdwheelbase = clock_systime_ticks();
+}
+
+/****************************************************************************
+ * Name: wd_wheel_bucket
+ *
+ * Description:
+ *   Return the timer wheel bucket that holds a watchdog expiring at the
+ *   absolute time 'expired'.  The level is selected by the distance from
+ *   the wheel base, the bucket within the level by the matching bits of
+ *   the expiration time.  Watchdogs that have already expired go to the
+ *   bucket that will be processed next.
+ *
+ * Input Parameters:
+ *   expired - expired absolute time in clock ticks
+ *
+ * Returned Value:
+ *   The list head of the selected bucket.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct list_node *wd_wheel_bucket(clock_t expired)
+{
+  sclock_t delta = (sclock_t)(expired - g_wdwheelbase);
+  int      level = 0;
+
+  if (delta < 0)
+    {
+      return &g_wdwheel[0][g_wdwheelbase & WDOG_WHEEL_MASK];
+    }
+
+  if ((clock_t)delta > WDOG_WHEEL_MAXDELAY)
+    {
+      delta = WDOG_WHEEL_MAXDELAY;
+    }
+
+  while (level < WDOG_WHEEL_LEVELS - 1 &&
+         WDOG_WHEEL_BITS * (level + 1) < WDOG_CLOCK_BITS &&
+         ((clock_t)delta >> (WDOG_WHEEL_BITS * (level + 1))) != 0)
+    {
+      level++;
+    }
+
+  expired = g_wdwheelbase + delta;
+  return &g_wdwheel[level][(expired >> (WDOG_WHEEL_BITS * level)) &
+                           WDOG_WHEEL_MASK];
+}
+
+/****************************************************************************
+ * Name: wd_wheel_splice
+ *
+ * Description:
+ *   Move all entries of the bucket 'from' to the (uninitialized) list head
+ *   'to', leaving 'from' empty.
+ *
+ ****************************************************************************/
+
+static inline_function void wd_wheel_splice(FAR struct list_node *to,
+                                            FAR struct list_node *from)
+{
+  if (list_is_empty(from))
+    {
+      list_initialize(to);
+    }
+  else
+    {
+      to->next       = from->next;
+      to->prev       = from->prev;
+      to->next->prev = to;
+      to->prev->next = to;
+      list_initialize(from);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Redistribute the watchdogs of one higher level bucket into the buckets
+ *   matching their remaining delay.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(int level, int index)
+{
+  FAR struct wdog_s *wdog;
+  struct list_node   pending;
+
+  wd_wheel_splice(&pending, &g_wdwheel[level][index]);
+
+  while ((wdog = list_remove_head_type(&pending, struct wdog_s, node))
+         != NULL)
+    {
+      list_add_tail(wd_wheel_bucket(wdog->expired), &wdog->node);
+    }
+}
+
+/****************************************************************************
+ * Name: wd_expiration
+ *
+ * Description:
+ *   Advance the timer wheel up to 'ticks', cascading the higher levels as
+ *   their buckets are reached, and execute every watchdog found in the
+ *   level 0 buckets passed on the way.
+ *
+ * Input Parameters:
+ *   ticks - current time in ticks
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline_function void wd_expiration(clock_t ticks)
+{
+  FAR struct wdog_s *wdog;
+  struct list_node   expired;
+  irqstate_t         flags;
+  wdentry_t          func;
+  wdparm_t           arg;
+  int                level;
+  int                index;
+
+  flags = enter_critical_section();
+
+  wd_set_nested(true);
+
+  while (clock_compare(g_wdwheelbase, ticks))
+    {
+      if (g_wdwheelcount == 0)
+        {
+          /* Nothing is armed, just catch up with the current time */
+
+          g_wdwheelbase = ticks + 1;
+          break;
+        }
+
+      /* When level 0 wraps, pull the next bucket of the level above down,
+       * and so on up the wheel.
+       */
+
+      index = g_wdwheelbase & WDOG_WHEEL_MASK;
+      if (index == 0)
+        {
+          for (level = 1; level < WDOG_WHEEL_LEVELS &&
+                          WDOG_WHEEL_BITS * level < WDOG_CLOCK_BITS; level++)
+            {
+              int next = (g_wdwheelbase >> (WDOG_WHEEL_BITS * level)) &
+                         WDOG_WHEEL_MASK;
+
+              wd_wheel_cascade(level, next);
+              if (next != 0)
+                {
+                  break;
+                }
+            }
+        }
+
+      /* Everything in the current level 0 bucket expires now.  Detach the
+       * bucket first so that watchdogs restarted by the callbacks go to the
+       * buckets ahead.
+       */
+
+      wd_wheel_splice(&expired, &g_wdwheel[0][index]);
+      g_wdwheelbase++;
+
+      while ((wdog = list_remove_head_type(&expired, struct wdog_s, node))
+             != NULL)
+        {
+          /* Indicate that the watchdog is no longer active. */
+
+          func = wdog->func;
+          arg  = wdog->arg;
+          wdog->func = NULL;
+          g_wdwheelcount--;
+
+#ifdef CONFIG_SCHED_LATENCY
+          nxsched_latency_add(SCHED_LATENCY_WDOG, ticks - wdog->expired);
+#endif
+
+          /* Execute the watchdog function */
+
+          up_setpicbase(wdog->picbase);
+          CALL_FUNC(func, arg);
+        }
+    }
+
+  wd_set_nested(false);
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: wd_insert
+ *
+ * Description:
+ *   Insert the timer into the timer wheel bucket matching its expiration
+ *   time.
+ *
+ * Input Parameters:
+ *   wdog     - Watchdog ID
+ *   expired  - expired absolute time in clock ticks
+ *   wdentry  - Function to call on timeout
+ *   arg      - Parameter to pass to wdentry
+ *
+ * Assumptions:
+ *   wdog and wdentry is not NULL.
+ *
+ * Returned Value:
+ *   Always false, there is no list head to reassess.
+ *
+ ****************************************************************************/
+
+static inline_function
+bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
+               wdentry_t wdentry, wdparm_t arg)
+{
+  if (list_is_clear(&g_wdwheel[0][0]))
+    {
+      wd_wheel_initialize();
+    }
+
+  list_add_tail(wd_wheel_bucket(expired), &wdog->node);
+  g_wdwheelcount++;
+
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+  wdog->expired = expired;
+
+  return false;
+}
+
+#else /* CONFIG_WDOG_TIMER_WHEEL */
+
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -144,6 +444,10 @@ static inline_function void wd_expiration(clock_t ticks)
       arg  = wdog->arg;
       wdog->func = NULL;
 
+#ifdef CONFIG_SCHED_LATENCY
+      nxsched_latency_add(SCHED_LATENCY_WDOG, ticks - wdog->expired);
+#endif
+
       /* Execute the watchdog function */
 
       up_setpicbase(wdog->picbase);
@@ -221,6 +525,32 @@ bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
   return head == curr;
 }
 
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
+
+/****************************************************************************
+ * Name: wd_hrtimer_expired
+ *
+ * Description:
+ *   The callback of g_wdhrtimer, armed for the expiration time of the
+ *   first watchdog.  It runs the watchdogs as the timer interrupt of the
+ *   tickless OS would without the hrtimer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_HRTIMER
+static uint64_t wd_hrtimer_expired(FAR const hrtimer_t *hrtimer,
+                                   uint64_t expired)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  wd_timer(clock_systime_ticks());
+  leave_critical_section(flags);
+
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -312,6 +642,9 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
       if (WDOG_ISACTIVE(wdog))
         {
           list_delete_fast(&wdog->node);
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+          g_wdwheelcount--;
+#endif
         }
 
       wd_insert(wdog, ticks, wdentry, arg);
@@ -37,11 +37,19 @@
 #include <nuttx/queue.h>
 #include <nuttx/wdog.h>
 #include <nuttx/arch.h>
+#include <nuttx/hrtimer.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+#  define WDOG_WHEEL_BITS    CONFIG_WDOG_TIMER_WHEEL_BITS
+#  define WDOG_WHEEL_LEVELS  CONFIG_WDOG_TIMER_WHEEL_LEVELS
+#  define WDOG_WHEEL_SIZE    (1 << WDOG_WHEEL_BITS)
+#  define WDOG_WHEEL_MASK    (WDOG_WHEEL_SIZE - 1)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -59,12 +67,36 @@ extern "C"
  * this linked list are removed and the function is called.
  */
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* When the timer wheel is used, the active watchdogs are kept in the
+ * buckets of g_wdwheel instead.  Level 0 has one bucket per tick; a bucket
+ * at level n covers 2^(n * WDOG_WHEEL_BITS) ticks and is cascaded into
+ * the lower levels when g_wdwheelbase reaches it.
+ */
+
+extern struct list_node g_wdwheel[WDOG_WHEEL_LEVELS][WDOG_WHEEL_SIZE];
+
+/* The next tick to be processed by the timer wheel */
+
+extern clock_t g_wdwheelbase;
+
+/* The number of watchdogs currently held by the timer wheel */
+
+extern unsigned int g_wdwheelcount;
+#else
 extern struct list_node g_wdactivelist;
+#endif
 
 #ifdef CONFIG_SCHED_TICKLESS
 extern bool g_wdtimernested;
 #endif
 
+#ifdef CONFIG_HRTIMER
+/* The hrtimer that runs the watchdogs when the hrtimer owns the timer */
+
+extern hrtimer_t g_wdhrtimer;
+#endif
+
 /****************************************************************************
  * Inline functions
  ****************************************************************************/
@@ -77,7 +109,12 @@ extern bool g_wdtimernested;
 #  define wd_set_nested(f)
 #endif
 
-#ifdef CONFIG_SCHED_TICKLESS
+#ifdef CONFIG_HRTIMER
+#  define wd_timer_start(next_tick) \
+     hrtimer_start(&g_wdhrtimer, (uint64_t)(next_tick) * NSEC_PER_TICK, \
+                   HRTIMER_MODE_ABS)
+#  define wd_timer_cancel() hrtimer_cancel(&g_wdhrtimer)
+#elif defined(CONFIG_SCHED_TICKLESS)
 static inline_function void wd_timer_start(clock_t next_tick)
 {
 #ifdef CONFIG_SCHED_TICKLESS_ALARM
@@ -115,10 +152,12 @@ static inline_function void wd_timer_cancel(void)
 #  define wd_timer_cancel()
 #endif
 
+#ifndef CONFIG_WDOG_TIMER_WHEEL
 static inline_function clock_t wd_next_expire(void)
 {
   return list_first_entry(&g_wdactivelist, struct wdog_s, node)->expired;
 }
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -93,6 +93,23 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, bool sync,
               break;
             }
         }
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      /* The work may have been stolen by the worker of another CPU, which
+       * marks itself busy and idle again under the lock of this queue.
+       */
+
+      for (wndx = 0; sync_wait == NULL && wqueue->percpu != NULL &&
+                     wndx < CONFIG_SMP_NCPUS; wndx++)
+        {
+          worker = wqueue->percpu[wndx].worker;
+          if (worker->work == work && worker->pid != pid)
+            {
+              worker->wait_count++;
+              sync_wait = &worker->wait;
+            }
+        }
+#endif
     }
 
   spin_unlock_irqrestore(&wqueue->lock, flags);
@@ -174,4 +191,33 @@ int work_cancel_sync_wq(FAR struct kwork_wqueue_s *wqueue,
   return work_qcancel(wqueue, true, work);
 }
 
+/****************************************************************************
+ * Name: work_cancel_cpu/work_cancel_sync_cpu
+ *
+ * Description:
+ *   Cancel work queued by work_queue_cpu(), without or with waiting for a
+ *   worker that is already running it.
+ *
+ * Input Parameters:
+ *   qid    - The work queue class (must be HPWORK or LPWORK)
+ *   cpu    - The CPU the work was queued to, negative for the current CPU
+ *   work   - The previously queued work structure to cancel
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+int work_cancel_cpu(int qid, int cpu, FAR struct work_s *work)
+{
+  return work_qcancel(work_qid2wq_cpu(qid, cpu), false, work);
+}
+
+int work_cancel_sync_cpu(int qid, int cpu, FAR struct work_s *work)
+{
+  return work_qcancel(work_qid2wq_cpu(qid, cpu), true, work);
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
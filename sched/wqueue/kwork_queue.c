@@ -113,6 +113,7 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
       /* Immediately wake up the worker thread. */
 
       nxsem_post(&wqueue->sem);
+      work_percpu_kick(wqueue);
     }
 
   return 0;
@@ -218,6 +219,7 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
       /* Immediately wake up the worker thread. */
 
       nxsem_post(&wqueue->sem);
+      work_percpu_kick(wqueue);
     }
 
   return 0;
@@ -229,4 +231,36 @@ int work_queue(int qid, FAR struct work_s *work, worker_t worker,
   return work_queue_wq(work_qid2wq(qid), work, worker, arg, delay);
 }
 
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Queue work to be performed on the per-CPU work queue of class 'qid'
+ *   served by 'cpu'.
+ *
+ * Input Parameters:
+ *   qid    - The work queue class (must be HPWORK or LPWORK)
+ *   cpu    - The CPU to run the work on, negative for the current CPU
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will be
+ *            invoked on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+int work_queue_cpu(int qid, int cpu, FAR struct work_s *work,
+                   worker_t worker, FAR void *arg, clock_t delay)
+{
+  return work_queue_wq(work_qid2wq_cpu(qid, cpu), work, worker, arg,
+                       delay);
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
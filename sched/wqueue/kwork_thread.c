@@ -112,6 +112,17 @@ struct lp_wqueue_s g_lpwork =
 
 #endif /* CONFIG_SCHED_LPWORK */
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+/* The per-CPU work queues, initialized when the worker threads start */
+
+#  ifdef CONFIG_SCHED_HPWORK
+struct kwork_percpu_s g_hpwork_percpu[CONFIG_SMP_NCPUS];
+#  endif
+#  ifdef CONFIG_SCHED_LPWORK
+struct kwork_percpu_s g_lpwork_percpu[CONFIG_SMP_NCPUS];
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -161,6 +172,93 @@ void work_dispatch(FAR struct kwork_wqueue_s *wq)
     }
 }
 
+/****************************************************************************
+ * Name: work_steal
+ *
+ * Description:
+ *   Run one expired work of another per-CPU queue of the same class whose
+ *   worker is busy.  The stealing worker marks itself busy and idle again
+ *   under the lock of the queue the work was taken from, so that
+ *   work_cancel_sync() on that queue finds and waits for it.
+ *
+ * Input Parameters:
+ *   wqueue  - The per-CPU queue of the stealing worker
+ *   kworker - The stealing worker
+ *
+ * Returned Value:
+ *   True if a work was run.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+static bool work_steal(FAR struct kwork_wqueue_s *wqueue,
+                       FAR struct kworker_s *kworker)
+{
+  FAR struct kwork_wqueue_s *victim;
+  FAR struct work_s *work;
+  worker_t worker;
+  irqstate_t flags;
+  FAR void *arg;
+  int i;
+
+  for (i = 1; i < CONFIG_SMP_NCPUS; i++)
+    {
+      victim = &wqueue->percpu[(wqueue->cpu + i) % CONFIG_SMP_NCPUS].wq;
+
+      /* An idle worker will soon run its own work */
+
+      if (victim->percpu[victim->cpu].worker[0].work == NULL ||
+          list_is_empty(&victim->expired))
+        {
+          continue;
+        }
+
+      flags = spin_lock_irqsave_nopreempt(&victim->lock);
+      if (victim->percpu[victim->cpu].worker[0].work == NULL ||
+          list_is_empty(&victim->expired))
+        {
+          spin_unlock_irqrestore_nopreempt(&victim->lock, flags);
+          continue;
+        }
+
+      work = list_first_entry(&victim->expired, struct work_s, node);
+      list_delete(&work->node);
+
+#ifdef CONFIG_SCHED_LATENCY
+      nxsched_latency_add(SCHED_LATENCY_WORK,
+                          clock_systime_ticks() - work->qtime);
+#endif
+
+      worker        = work->worker;
+      arg           = work->arg;
+      work->worker  = NULL;
+      kworker->work = work;
+
+      /* The victim was posted for this work, its worker will find the
+       * queue empty and simply wait again.
+       */
+
+      spin_unlock_irqrestore_nopreempt(&victim->lock, flags);
+
+      CALL_WORKER(worker, arg);
+
+      flags = spin_lock_irqsave_nopreempt(&victim->lock);
+      kworker->work = NULL;
+
+      while (kworker->wait_count > 0)
+        {
+          kworker->wait_count--;
+          nxsem_post(&kworker->wait);
+        }
+
+      spin_unlock_irqrestore_nopreempt(&victim->lock, flags);
+      return true;
+    }
+
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Name: work_thread
  *
@@ -228,6 +326,11 @@ static int work_thread(int argc, FAR char *argv[])
 
           list_delete(&work->node);
 
+#ifdef CONFIG_SCHED_LATENCY
+          nxsched_latency_add(SCHED_LATENCY_WORK,
+                              clock_systime_ticks() - work->qtime);
+#endif
+
           /* Extract the work description from the entry (in case the
            * work instance will be reused after it has been de-queued).
            */
@@ -267,6 +370,24 @@ static int work_thread(int argc, FAR char *argv[])
               nxsem_post(&kworker->wait);
             }
         }
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      else if (wqueue->percpu != NULL)
+        {
+          spin_unlock_irqrestore_nopreempt(&wqueue->lock, flags);
+
+          /* Nothing to do here, help the busy workers of the other CPUs
+           * and look at the own queue again before sleeping.
+           */
+
+          if (work_steal(wqueue, kworker))
+            {
+              continue;
+            }
+
+          nxsem_wait_uninterruptible(&wqueue->sem);
+          continue;
+        }
+#endif
 
       spin_unlock_irqrestore_nopreempt(&wqueue->lock, flags);
 
@@ -343,6 +464,75 @@ static int work_thread_create(FAR const char *name, int priority,
   return OK;
 }
 
+/****************************************************************************
+ * Name: work_start_percpu
+ *
+ * Description:
+ *   Initialize the per-CPU queues of one work queue class and start their
+ *   worker threads, each bound to its CPU.
+ *
+ * Input Parameters:
+ *   percpu     - The per-CPU queues of the class
+ *   name       - The name of the class, the CPU number is appended
+ *   priority   - Priority of the worker threads
+ *   stack_size - Stack size of the worker threads
+ *
+ * Returned Value:
+ *   A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+static int work_start_percpu(FAR struct kwork_percpu_s *percpu,
+                             FAR const char *name, int priority,
+                             int stack_size)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  cpu_set_t cpuset;
+  char wqname[CONFIG_TASK_NAME_SIZE + 1];
+  int ret;
+  int cpu;
+
+  /* Keep the threads from running on the wrong CPU before they are bound */
+
+  sched_lock();
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      wqueue = &percpu[cpu].wq;
+
+      list_initialize(&wqueue->expired);
+      list_initialize(&wqueue->pending);
+      nxsem_init(&wqueue->sem, 0, 0);
+      nxsem_init(&wqueue->exsem, 0, 0);
+      spin_lock_init(&wqueue->lock);
+      wqueue->nthreads = 1;
+      wqueue->percpu   = percpu;
+      wqueue->cpu      = cpu;
+
+      snprintf(wqname, sizeof(wqname), "%s%d", name, cpu);
+      ret = work_thread_create(wqname, priority, NULL, stack_size, wqueue);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+      ret = nxsched_set_affinity(percpu[cpu].worker[0].pid,
+                                 sizeof(cpu_set_t), &cpuset);
+      if (ret < 0)
+        {
+          serr("ERROR: binding %s to CPU%d failed: %d\n", wqname, cpu, ret);
+          break;
+        }
+    }
+
+  sched_unlock();
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -546,10 +736,24 @@ int work_queue_priority(int qid)
 #ifdef CONFIG_SCHED_HPWORK
 int work_start_highpri(void)
 {
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  int ret;
+#endif
+
   /* Start the high-priority, kernel mode worker thread(s) */
 
   sinfo("Starting high-priority kernel worker thread(s)\n");
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  ret = work_start_percpu(g_hpwork_percpu, HPWORKNAME,
+                          CONFIG_SCHED_HPWORKPRIORITY,
+                          CONFIG_SCHED_HPWORKSTACKSIZE);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   return work_thread_create(HPWORKNAME, CONFIG_SCHED_HPWORKPRIORITY, NULL,
                             CONFIG_SCHED_HPWORKSTACKSIZE,
                             (FAR struct kwork_wqueue_s *)&g_hpwork);
@@ -574,10 +778,24 @@ int work_start_highpri(void)
 #ifdef CONFIG_SCHED_LPWORK
 int work_start_lowpri(void)
 {
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  int ret;
+#endif
+
   /* Start the low-priority, kernel mode worker thread(s) */
 
   sinfo("Starting low-priority kernel worker thread(s)\n");
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  ret = work_start_percpu(g_lpwork_percpu, LPWORKNAME,
+                          CONFIG_SCHED_LPWORKPRIORITY,
+                          CONFIG_SCHED_LPWORKSTACKSIZE);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   return work_thread_create(LPWORKNAME, CONFIG_SCHED_LPWORKPRIORITY, NULL,
                             CONFIG_SCHED_LPWORKSTACKSIZE,
                             (FAR struct kwork_wqueue_s *)&g_lpwork);
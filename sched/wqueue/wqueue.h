@@ -36,6 +36,8 @@
 #include <nuttx/list.h>
 #include <nuttx/wqueue.h>
 #include <nuttx/spinlock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/sched.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -81,6 +83,13 @@ struct kwork_wqueue_s
   uint8_t          nthreads;  /* Number of worker threads */
   bool             exit;      /* A flag to request the thread to exit */
   struct wdog_s    timer;     /* Timer to pending. */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  uint8_t          cpu;       /* The CPU served by the per-CPU queue */
+
+  /* All per-CPU queues of the class, NULL if this is a shared queue */
+
+  FAR struct kwork_percpu_s *percpu;
+#endif
 };
 
 /* This structure defines the state of one high-priority work queue.  This
@@ -113,6 +122,19 @@ struct lp_wqueue_s
 };
 #endif
 
+/* This structure defines the state of one per-CPU work queue, served by
+ * one worker thread bound to the CPU.  It must be cast compatible with
+ * kwork_wqueue_s.
+ */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+struct kwork_percpu_s
+{
+  struct kwork_wqueue_s wq;
+  struct kworker_s      worker[1];
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -129,6 +151,17 @@ extern struct hp_wqueue_s g_hpwork;
 extern struct lp_wqueue_s g_lpwork;
 #endif
 
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+/* The per-CPU work queues of each class */
+
+#  ifdef CONFIG_SCHED_HPWORK
+extern struct kwork_percpu_s g_hpwork_percpu[CONFIG_SMP_NCPUS];
+#  endif
+#  ifdef CONFIG_SCHED_LPWORK
+extern struct kwork_percpu_s g_lpwork_percpu[CONFIG_SMP_NCPUS];
+#  endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -154,6 +187,83 @@ static inline_function FAR struct kwork_wqueue_s *work_qid2wq(int qid)
     }
 }
 
+/****************************************************************************
+ * Name: work_qid2wq_cpu
+ *
+ * Description:
+ *   Get the per-CPU work queue of class 'qid' served by 'cpu'.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+static inline_function
+FAR struct kwork_wqueue_s *work_qid2wq_cpu(int qid, int cpu)
+{
+  if (cpu < 0)
+    {
+      cpu = this_cpu();
+    }
+  else if (cpu >= CONFIG_SMP_NCPUS)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_SCHED_HPWORK
+  if (qid == HPWORK)
+    {
+      return &g_hpwork_percpu[cpu].wq;
+    }
+  else
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+  if (qid == LPWORK)
+    {
+      return &g_lpwork_percpu[cpu].wq;
+    }
+  else
+#endif
+    {
+      return NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: work_percpu_kick
+ *
+ * Description:
+ *   New work was queued to 'wqueue'.  If it is a per-CPU queue whose worker
+ *   is busy, wake up the idle worker of another CPU to steal the work.
+ *   The state of the workers is read without locking, so this is only a
+ *   hint.
+ *
+ ****************************************************************************/
+
+static inline_function
+void work_percpu_kick(FAR struct kwork_wqueue_s *wqueue)
+{
+  FAR struct kwork_percpu_s *sibling;
+  int i;
+
+  if (wqueue->percpu == NULL ||
+      wqueue->percpu[wqueue->cpu].worker[0].work == NULL)
+    {
+      return;
+    }
+
+  for (i = 1; i < CONFIG_SMP_NCPUS; i++)
+    {
+      sibling = &wqueue->percpu[(wqueue->cpu + i) % CONFIG_SMP_NCPUS];
+      if (sibling->worker[0].work == NULL)
+        {
+          nxsem_post(&sibling->wq.sem);
+          break;
+        }
+    }
+}
+#else
+#  define work_percpu_kick(wqueue)
+#endif
+
 /****************************************************************************
  * Name: work_insert_pending
  *
@@ -25,6 +25,7 @@
  ****************************************************************************/
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -45,12 +46,22 @@
  * Private Types
  ****************************************************************************/
 
+struct symbol_s
+{
+  char *name;
+  char *cond;
+  bool parm1;
+  uint32_t hash;
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 static const char *g_hdrfiles[MAX_HEADER_FILES];
 static int nhdrfiles;
+static struct symbol_s *g_symbols;
+static int g_nsyms;
 
 /****************************************************************************
  * Private Functions
@@ -61,7 +72,8 @@ static void show_usage(const char *progname)
   fprintf(stderr,
     "USAGE:\n");
   fprintf(stderr,
-    "%s [-d] <cvs-file> <symtab-file> [<symtab-name> [<nsymbols-name>]]\n\n",
+    "%s [-d] [-h] <cvs-file> <symtab-file> "
+    "[<symtab-name> [<nsymbols-name>]]\n\n",
     progname);
   fprintf(stderr,
     "Where:\n\n");
@@ -81,6 +93,10 @@ static void show_usage(const char *progname)
     "                   Default: \"%s\"\n", NSYMBOLS_NAME);
   fprintf(stderr,
     "  -d              : Enable debug output\n");
+  fprintf(stderr,
+    "  -h              : Order the table by name hash, for\n");
+  fprintf(stderr,
+    "                    CONFIG_SYMTAB_ORDEREDBYHASH\n");
   exit(EXIT_FAILURE);
 }
 
@@ -118,6 +134,53 @@ static void add_hdrfile(const char *hdrfile)
     }
 }
 
+/* Must match symtab_hash() in libs/libc/symtab/symtab_sortbyhash.c */
+
+static uint32_t symbol_hash(const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+static int compare_hash(const void *arg1, const void *arg2)
+{
+  const struct symbol_s *sym1 = arg1;
+  const struct symbol_s *sym2 = arg2;
+
+  if (sym1->hash != sym2->hash)
+    {
+      return sym1->hash < sym2->hash ? -1 : 1;
+    }
+
+  return strcmp(sym1->name, sym2->name);
+}
+
+static void add_symbol(void)
+{
+  struct symbol_s *sym;
+
+  sym = realloc(g_symbols, (g_nsyms + 1) * sizeof(struct symbol_s));
+  if (sym == NULL)
+    {
+      fprintf(stderr, "ERROR:  Out of memory\n");
+      exit(EXIT_FAILURE);
+    }
+
+  g_symbols  = sym;
+  sym        = &g_symbols[g_nsyms++];
+  sym->name  = strdup(g_parm[NAME_INDEX]);
+  sym->cond  = strdup(g_parm[COND_INDEX]);
+  sym->parm1 = strlen(g_parm[PARM1_INDEX]) > 0;
+  sym->hash  = symbol_hash(sym->name);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -131,8 +194,8 @@ int main(int argc, char **argv, char **envp)
   char *nextterm;
   char *finalterm;
   char *ptr;
+  bool byhash;
   bool cond;
-  bool parm1;
   FILE *instream;
   FILE *outstream;
   int ch;
@@ -143,8 +206,9 @@ int main(int argc, char **argv, char **envp)
   symtab   = SYMTAB_NAME;
   nsymbols = NSYMBOLS_NAME;
   g_debug  = false;
+  byhash   = false;
 
-  while ((ch = getopt(argc, argv, ":d")) > 0)
+  while ((ch = getopt(argc, argv, ":dh")) > 0)
     {
       switch (ch)
         {
@@ -152,6 +216,10 @@ int main(int argc, char **argv, char **envp)
             g_debug = true;
             break;
 
+          case 'h' :
+            byhash = true;
+            break;
+
           case '?' :
             fprintf(stderr, "Unrecognized option: %c\n", optopt);
             show_usage(argv[0]);
@@ -264,9 +332,6 @@ int main(int argc, char **argv, char **envp)
 
   /* Parse each line in the CVS file */
 
-  nextterm  = "";
-  finalterm = "";
-
   while ((ptr = read_line(instream)) != NULL)
     {
       /* Parse the line from the CVS file */
@@ -284,27 +349,43 @@ int main(int argc, char **argv, char **envp)
           exit(EXIT_FAILURE);
         }
 
+      add_symbol();
+    }
+
+  /* The entries removed by their conditions leave the order intact, so
+   * the run time lookup needs no separate hash table.
+   */
+
+  if (byhash && g_nsyms > 0)
+    {
+      qsort(g_symbols, g_nsyms, sizeof(struct symbol_s), compare_hash);
+    }
+
+  nextterm  = "";
+  finalterm = "";
+
+  for (i = 0; i < g_nsyms; i++)
+    {
       /* Output any conditional compilation */
 
-      cond = strlen(g_parm[COND_INDEX]) > 0;
+      cond = strlen(g_symbols[i].cond) > 0;
       if (cond)
         {
-          fprintf(outstream, "%s#if %s\n", nextterm, g_parm[COND_INDEX]);
+          fprintf(outstream, "%s#if %s\n", nextterm, g_symbols[i].cond);
           nextterm  = "";
         }
 
       /* Output the symbol table entry */
 
-      parm1 = strlen(g_parm[PARM1_INDEX]) > 0;
-      if (parm1)
+      if (g_symbols[i].parm1)
         {
           fprintf(outstream, "%s  { \"%s\", (FAR const void *)%s }",
-                  nextterm, g_parm[NAME_INDEX], g_parm[NAME_INDEX]);
+                  nextterm, g_symbols[i].name, g_symbols[i].name);
         }
       else
         {
           fprintf(outstream, "%s  { \"%s\", (FAR const void *)&%s }",
-                  nextterm, g_parm[NAME_INDEX], g_parm[NAME_INDEX]);
+                  nextterm, g_symbols[i].name, g_symbols[i].name);
         }
 
       if (cond)
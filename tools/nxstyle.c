@@ -368,6 +368,8 @@ static const char *g_white_content_list[] =
   "MKDIR3resok",
   "RMDIR3args",
   "RMDIR3resok",
+  "COMMIT3args",
+  "COMMIT3resok",
   "READDIR3args",
   "READDIR3resok",
   "SETATTR3args",
@@ -632,6 +634,7 @@ static const char *g_white_content_list[] =
   "unzLocateFile",
   "unzOpenCurrentFile",
   "unzClose",
+  "unzCloseCurrentFile",
   "unzReadCurrentFile",
   "unzGetCurrentFileInfo64",
   "unzGoToNextFile",